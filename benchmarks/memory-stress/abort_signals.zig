@@ -0,0 +1,115 @@
+//! AbortSignal churn stress test
+//!
+//! Models a fetch layer: every request gets its own AbortController, and
+//! its signal is composed with a long-lived shutdown signal through
+//! `AbortSignal.any()`. Each request registers a cleanup abort algorithm
+//! on its composite and removes it when it completes. Requests are kept in
+//! a fixed window and completed in random order (so composites unlink from
+//! the middle of the shutdown signal's dependents), and one in `--abort-every`
+//! is aborted instead of completing.
+//!
+//! The run fails if the shutdown signal's dependents ever outgrow the
+//! window, if any remain once every request is done, or if anything leaks.
+//!
+//! ```bash
+//! zig build abort-stress -Doptimize=ReleaseFast -- --signals 1000000
+//! ```
+
+const std = @import("std");
+const dom = @import("dom");
+const AbortController = dom.AbortController;
+const AbortSignal = dom.AbortSignal;
+
+const Request = struct {
+    controller: *AbortController,
+    composite: *AbortSignal,
+};
+
+pub fn main() !void {
+    var gpa = std.heap.GeneralPurposeAllocator(.{}){};
+    defer if (gpa.deinit() == .leak) @panic("abort-stress leaked memory");
+    const allocator = gpa.allocator();
+
+    var args = try std.process.argsWithAllocator(allocator);
+    defer args.deinit();
+    _ = args.skip();
+
+    var signals: usize = 1_000_000;
+    var window: usize = 1_000;
+    var abort_every: usize = 64;
+    while (args.next()) |arg| {
+        const target: *usize = if (std.mem.eql(u8, arg, "--signals"))
+            &signals
+        else if (std.mem.eql(u8, arg, "--in-flight"))
+            &window
+        else if (std.mem.eql(u8, arg, "--abort-every"))
+            &abort_every
+        else {
+            std.debug.print("Usage: abort-stress [--signals <count>] [--in-flight <count>] [--abort-every <n>]\n", .{});
+            return;
+        };
+        const value = args.next() orelse {
+            std.debug.print("Error: {s} requires a value\n", .{arg});
+            return error.InvalidArgument;
+        };
+        target.* = try std.fmt.parseInt(usize, value, 10);
+    }
+    if (window == 0 or abort_every == 0) return error.InvalidArgument;
+
+    const shutdown = try AbortController.init(allocator);
+    defer shutdown.deinit();
+
+    const in_flight = try allocator.alloc(?Request, window);
+    defer allocator.free(in_flight);
+    @memset(in_flight, null);
+
+    var prng = std.Random.DefaultPrng.init(0x5eed);
+    var aborted: usize = 0;
+    var peak_dependents: usize = 0;
+
+    var timer = try std.time.Timer.start();
+    for (0..signals) |i| {
+        const slot = prng.random().uintLessThan(usize, window);
+        if (in_flight[slot]) |done| complete(done);
+
+        const controller = try AbortController.init(allocator);
+        const composite = try AbortSignal.any(allocator, &[_]*AbortSignal{ controller.signal, shutdown.signal });
+        try composite.addAlgorithm(.{ .callback = onAbort, .context = @ptrCast(composite) });
+        if (i % abort_every == 0) {
+            try controller.abort(null);
+            aborted += 1;
+        }
+        in_flight[slot] = .{ .controller = controller, .composite = composite };
+
+        const dependents = shutdown.signal.dependentSignalCount();
+        peak_dependents = @max(peak_dependents, dependents);
+        if (dependents > window) return error.DependentsGrew;
+    }
+    for (in_flight) |entry| {
+        if (entry) |done| complete(done);
+    }
+    const elapsed = timer.read();
+
+    if (shutdown.signal.dependentSignalCount() != 0) return error.DependentsLeft;
+
+    const per_signal = @as(f64, @floatFromInt(elapsed)) / @as(f64, @floatFromInt(@max(signals, 1)));
+    std.debug.print("{d} composite signals ({d} aborted), {d} in flight\n", .{ signals, aborted, window });
+    std.debug.print("{d:.1} ns per request, peak shutdown dependents {d}, {d} left\n", .{
+        per_signal,
+        peak_dependents,
+        shutdown.signal.dependentSignalCount(),
+    });
+}
+
+fn onAbort(signal: *AbortSignal, context: *anyopaque) void {
+    _ = signal;
+    _ = context;
+}
+
+/// Completes a request: its cleanup algorithm comes off (a no-op if it
+/// aborted) and both of its signals go away.
+fn complete(request: Request) void {
+    request.composite.removeAlgorithm(onAbort, @ptrCast(request.composite));
+    request.composite.release();
+    request.controller.deinit();
+}
@@ -0,0 +1,233 @@
+//! Cache miss benchmark for traversal-heavy operations
+//!
+//! Builds a document of rows of elements with text, then counts hardware
+//! cache misses and references (Linux perf counters, user space only) for
+//! operations that mostly read node links:
+//! - a firstChild/nextSibling walk that checks nodeType
+//! - querySelectorAll() for a class and for an attribute selector
+//! - the same queries with the document's compact layout enabled
+//!
+//! Results are reported per visited node. Where perf counters are not
+//! available (no Linux, or perf_event_paranoid forbids them), only times
+//! are reported.
+//!
+//! ```bash
+//! zig build cache-misses -Doptimize=ReleaseFast -- --elements 200000
+//! ```
+
+const std = @import("std");
+const builtin = @import("builtin");
+const dom = @import("dom");
+const Document = dom.Document;
+const Node = dom.Node;
+
+const iterations = 20;
+
+pub fn main() !void {
+    var gpa = std.heap.GeneralPurposeAllocator(.{}){};
+    defer _ = gpa.deinit();
+    const allocator = gpa.allocator();
+
+    var args = try std.process.argsWithAllocator(allocator);
+    defer args.deinit();
+    _ = args.skip();
+
+    var elements: usize = 100_000;
+    while (args.next()) |arg| {
+        if (std.mem.eql(u8, arg, "--elements")) {
+            const value = args.next() orelse {
+                std.debug.print("Error: --elements requires a value\n", .{});
+                return error.InvalidArgument;
+            };
+            elements = try std.fmt.parseInt(usize, value, 10);
+        } else {
+            std.debug.print("Usage: cache-misses [--elements <count>]\n", .{});
+            return;
+        }
+    }
+
+    std.debug.print("Node: {d} bytes; parent_node at {d}, first_child at {d}, next_sibling at {d}, node_type at {d}\n", .{
+        @sizeOf(Node),
+        @offsetOf(Node, "parent_node"),
+        @offsetOf(Node, "first_child"),
+        @offsetOf(Node, "next_sibling"),
+        @offsetOf(Node, "node_type"),
+    });
+
+    const doc = try build(allocator, elements);
+    defer doc.release();
+
+    var counters = Counters.open();
+    defer counters.close();
+    if (!counters.available) {
+        std.debug.print("Perf counters unavailable; reporting times only\n", .{});
+    }
+
+    const nodes = countNodes(doc);
+    std.debug.print("{d} elements, {d} nodes, {d} iterations per operation\n\n", .{ elements, nodes, iterations });
+    std.debug.print("{s:<40} {s:>12} {s:>14} {s:>14}\n", .{ "operation", "ns/node", "misses/node", "refs/node" });
+
+    try measure(&counters, "walk (firstChild/nextSibling)", doc, nodes, walk);
+    try measure(&counters, "querySelectorAll .target", doc, nodes, queryClass);
+    try measure(&counters, "querySelectorAll [data-x]", doc, nodes, queryAttribute);
+
+    try doc.enableCompactLayout();
+    try queryClass(doc); // builds the table
+    try measure(&counters, "querySelectorAll .target (compact)", doc, nodes, queryClass);
+    try measure(&counters, "querySelectorAll [data-x] (compact)", doc, nodes, queryAttribute);
+}
+
+/// Rows of 9 cells, each with a Text child; every 100th cell is a .target
+/// with a data-x attribute.
+fn build(allocator: std.mem.Allocator, elements: usize) !*Document {
+    const doc = try Document.init(allocator);
+    errdefer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+
+    var count: usize = 0;
+    while (count < elements) {
+        const row = try doc.createElement("row");
+        _ = try root.prototype.appendChild(&row.prototype);
+        count += 1;
+        for (0..9) |_| {
+            const cell = try doc.createElement("cell");
+            if (count % 100 == 0) {
+                try cell.setAttribute("class", "target");
+                try cell.setAttribute("data-x", "1");
+            }
+            _ = try row.prototype.appendChild(&cell.prototype);
+            _ = try cell.prototype.appendChild(&(try doc.createTextNode("line")).prototype);
+            count += 1;
+        }
+    }
+    return doc;
+}
+
+fn countNodes(doc: *Document) usize {
+    var count: usize = 0;
+    var node: ?*Node = doc.prototype.first_child;
+    while (node) |n| {
+        count += 1;
+        node = nextInPreorder(n, &doc.prototype);
+    }
+    return count;
+}
+
+fn nextInPreorder(node: *Node, root: *Node) ?*Node {
+    if (node.first_child) |child| return child;
+    var current = node;
+    while (current != root) {
+        if (current.next_sibling) |next| return next;
+        current = current.parent_node orelse return null;
+    }
+    return null;
+}
+
+var elements_seen: usize = 0;
+
+fn walk(doc: *Document) !void {
+    var node: ?*Node = doc.prototype.first_child;
+    while (node) |n| {
+        if (n.node_type == .element) elements_seen += 1;
+        node = nextInPreorder(n, &doc.prototype);
+    }
+}
+
+fn queryClass(doc: *Document) !void {
+    const results = try doc.querySelectorAll(".target");
+    doc.prototype.allocator.free(results);
+}
+
+fn queryAttribute(doc: *Document) !void {
+    const results = try doc.querySelectorAll("[data-x]");
+    doc.prototype.allocator.free(results);
+}
+
+fn measure(
+    counters: *Counters,
+    name: []const u8,
+    doc: *Document,
+    nodes: usize,
+    func: *const fn (*Document) anyerror!void,
+) !void {
+    try func(doc); // warm up
+
+    counters.start();
+    var timer = try std.time.Timer.start();
+    for (0..iterations) |_| try func(doc);
+    const elapsed = timer.read();
+    const counts = counters.stop();
+
+    const visited: f64 = @floatFromInt(nodes * iterations);
+    const ns_per_node = @as(f64, @floatFromInt(elapsed)) / visited;
+    if (counters.available) {
+        std.debug.print("{s:<40} {d:>12.2} {d:>14.4} {d:>14.4}\n", .{
+            name,
+            ns_per_node,
+            @as(f64, @floatFromInt(counts.misses)) / visited,
+            @as(f64, @floatFromInt(counts.references)) / visited,
+        });
+    } else {
+        std.debug.print("{s:<40} {d:>12.2} {s:>14} {s:>14}\n", .{ name, ns_per_node, "-", "-" });
+    }
+}
+
+/// Hardware cache miss and reference counters for this thread.
+const Counters = struct {
+    misses_fd: i32 = -1,
+    references_fd: i32 = -1,
+    available: bool = false,
+
+    const Counts = struct { misses: u64 = 0, references: u64 = 0 };
+
+    fn open() Counters {
+        if (builtin.os.tag != .linux) return .{};
+        const misses = openCounter(.CACHE_MISSES) orelse return .{};
+        const references = openCounter(.CACHE_REFERENCES) orelse {
+            std.posix.close(misses);
+            return .{};
+        };
+        return .{ .misses_fd = misses, .references_fd = references, .available = true };
+    }
+
+    fn openCounter(comptime event: std.os.linux.PERF.COUNT.HW) ?i32 {
+        const PERF = std.os.linux.PERF;
+        var attr: std.os.linux.perf_event_attr = .{
+            .type = PERF.TYPE.HARDWARE,
+            .config = @intFromEnum(event),
+            .flags = .{ .disabled = true, .exclude_kernel = true, .exclude_hv = true },
+        };
+        return std.posix.perf_event_open(&attr, 0, -1, -1, PERF.FLAG.FD_CLOEXEC) catch null;
+    }
+
+    fn close(self: *Counters) void {
+        if (!self.available) return;
+        std.posix.close(self.misses_fd);
+        std.posix.close(self.references_fd);
+    }
+
+    fn start(self: *Counters) void {
+        if (!self.available) return;
+        const PERF = std.os.linux.PERF;
+        for ([_]i32{ self.misses_fd, self.references_fd }) |fd| {
+            _ = std.os.linux.ioctl(fd, PERF.EVENT_IOC.RESET, 0);
+            _ = std.os.linux.ioctl(fd, PERF.EVENT_IOC.ENABLE, 0);
+        }
+    }
+
+    fn stop(self: *Counters) Counts {
+        if (!self.available) return .{};
+        const PERF = std.os.linux.PERF;
+        _ = std.os.linux.ioctl(self.misses_fd, PERF.EVENT_IOC.DISABLE, 0);
+        _ = std.os.linux.ioctl(self.references_fd, PERF.EVENT_IOC.DISABLE, 0);
+        return .{ .misses = readCounter(self.misses_fd), .references = readCounter(self.references_fd) };
+    }
+
+    fn readCounter(fd: i32) u64 {
+        var value: u64 = 0;
+        _ = std.posix.read(fd, std.mem.asBytes(&value)) catch return 0;
+        return value;
+    }
+};
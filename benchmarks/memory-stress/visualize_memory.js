@@ -7,13 +7,18 @@
  * - Memory leak detection (linear growth = leak)
  * - Per-cycle leak rate
  * - Pass/Fail status
+ * - Live nodes and wrappers, for runs of the V8 bindings driver
+ *   (v8-bindings/bench/memory_stress.cpp)
+ *
+ * Usage: node visualize_memory.js [samples.json]
+ * (default: benchmark_results/memory_stress/memory_samples_latest.json)
  */
 
 const fs = require('fs');
 const path = require('path');
 
 const RESULTS_DIR = 'benchmark_results/memory_stress';
-const LATEST_FILE = path.join(RESULTS_DIR, 'memory_samples_latest.json');
+const LATEST_FILE = process.argv[2] || path.join(RESULTS_DIR, 'memory_samples_latest.json');
 const CHART_JS_CDN = 'https://cdn.jsdelivr.net/npm/chart.js@4.4.0/dist/chart.umd.min.js';
 
 function formatBytes(bytes) {
@@ -50,6 +55,11 @@ function generateHTML(results) {
   const timestamps = samples.map(s => (s.timestamp_ms / 1000).toFixed(1));
   const memoryMB = samples.map(s => s.bytes_used / (1024 * 1024));
   
+  // Bindings runs also sample Zig-side live nodes and the wrapper cache
+  const hasObjectCounts = samples[0].live_nodes !== undefined;
+  const liveNodes = samples.map(s => s.live_nodes);
+  const liveWrappers = samples.map(s => s.wrappers_live);
+  
   // For persistent Document: Check if memory stabilized (not growing continuously)
   // Growth < 5KB/cycle indicates stable memory (HashMap capacity growth only)
   const STABLE_THRESHOLD = 5000; // 5KB per cycle is acceptable for HashMap growth
@@ -241,6 +251,13 @@ function generateHTML(results) {
         <canvas id="memoryChart"></canvas>
       </div>
     </div>
+    ${hasObjectCounts ? `
+    <div class="chart-container">
+      <h2>🔗 Live Nodes and Wrappers (after forced GC)</h2>
+      <div class="chart-wrapper">
+        <canvas id="objectChart"></canvas>
+      </div>
+    </div>` : ''}
     
     <div class="info-box">
       <h2>🔍 Test Methodology</h2>
@@ -296,6 +313,36 @@ function generateHTML(results) {
         }
       }
     });
+    ${hasObjectCounts ? `
+    new Chart(document.getElementById('objectChart').getContext('2d'), {
+      type: 'line',
+      data: {
+        labels: ${JSON.stringify(timestamps.map(t => `${t}s`))},
+        datasets: [{
+          label: 'Live nodes (Zig)',
+          data: ${JSON.stringify(liveNodes)},
+          borderColor: 'rgb(102, 126, 234)',
+          tension: 0.4,
+          pointRadius: 4,
+          borderWidth: 3,
+        }, {
+          label: 'Live wrappers (V8)',
+          data: ${JSON.stringify(liveWrappers)},
+          borderColor: 'rgb(237, 137, 54)',
+          tension: 0.4,
+          pointRadius: 4,
+          borderWidth: 3,
+        }]
+      },
+      options: {
+        responsive: true,
+        maintainAspectRatio: false,
+        scales: {
+          y: { beginAtZero: true, title: { display: true, text: 'Objects' } },
+          x: { title: { display: true, text: 'Time (seconds)' } }
+        }
+      }
+    });` : ''}
   </script>
 </body>
 </html>`;
@@ -312,7 +359,9 @@ function main() {
   console.log(`✓ Cycles: ${formatNumber(results.final_state.cycles_completed)}`);
   
   const html = generateHTML(results);
-  const outputFile = path.join(RESULTS_DIR, 'memory_report_latest.html');
+  // memory_samples_X.json -> memory_report_X.html, next to the samples
+  const reportName = path.basename(LATEST_FILE).replace('samples', 'report').replace(/\.json$/, '.html');
+  const outputFile = path.join(path.dirname(LATEST_FILE), reportName);
   fs.writeFileSync(outputFile, html, 'utf8');
   
   console.log(`✓ HTML report: ${outputFile}\n`);
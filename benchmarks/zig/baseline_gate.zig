@@ -0,0 +1,105 @@
+//! Baseline gate for result files of other runners
+//!
+//! Compares or records results written in the single-run shape of
+//! baselines.zig, e.g. by v8-bindings' bench/bindings_bench:
+//!
+//! ```bash
+//! ./v8-bindings/bench/bindings_bench --out v8.json
+//! zig build baselines -- compare v8.json   # exit 1 on >10% regressions
+//! zig build baselines -- record v8.json    # store as this machine's baseline
+//! ```
+//!
+//! The machine class is --machine if given, else the file's "machine" if
+//! set, else the class of this build.
+
+const std = @import("std");
+const baselines = @import("baselines.zig");
+
+pub fn main() !void {
+    var gpa = std.heap.GeneralPurposeAllocator(.{}){};
+    defer _ = gpa.deinit();
+    const allocator = gpa.allocator();
+
+    var args = try std.process.argsWithAllocator(allocator);
+    defer args.deinit();
+    _ = args.skip();
+
+    const command = args.next() orelse {
+        printHelp();
+        return error.InvalidArgument;
+    };
+    const record = std.mem.eql(u8, command, "record");
+    if (!record and !std.mem.eql(u8, command, "compare")) {
+        printHelp();
+        if (std.mem.eql(u8, command, "--help")) return;
+        return error.InvalidArgument;
+    }
+
+    var paths: std.ArrayList([]const u8) = .empty;
+    defer paths.deinit(allocator);
+    var baselines_path: []const u8 = baselines.default_path;
+    var machine_override: ?[]const u8 = null;
+    var threshold_override: ?f64 = null;
+
+    while (args.next()) |arg| {
+        if (std.mem.eql(u8, arg, "--baselines")) {
+            baselines_path = args.next() orelse return missingValue(arg);
+        } else if (std.mem.eql(u8, arg, "--machine")) {
+            machine_override = args.next() orelse return missingValue(arg);
+        } else if (std.mem.eql(u8, arg, "--threshold")) {
+            const value = args.next() orelse return missingValue(arg);
+            threshold_override = try std.fmt.parseFloat(f64, value);
+        } else if (std.mem.startsWith(u8, arg, "--")) {
+            printHelp();
+            return error.InvalidArgument;
+        } else {
+            try paths.append(allocator, arg);
+        }
+    }
+    if (paths.items.len == 0) {
+        printHelp();
+        return error.InvalidArgument;
+    }
+
+    var file = try baselines.File.load(allocator, baselines_path);
+    defer file.deinit();
+    const threshold = threshold_override orelse file.baselines.threshold_percent;
+
+    var date_buffer: [10]u8 = undefined;
+    const date = baselines.today(&date_buffer);
+
+    var regressions: usize = 0;
+    for (paths.items) |path| {
+        const results = try file.loadResults(path);
+        const machine = machine_override orelse if (results.machine.len > 0) results.machine else baselines.machine_class;
+
+        std.debug.print("{s}:\n", .{path});
+        if (record) {
+            try file.record(machine, date, results);
+            std.debug.print("Recorded {d} benchmarks for {s}\n", .{ results.benchmarks.map.count(), machine });
+        } else {
+            regressions += file.compare(machine, results, threshold).regressions;
+        }
+    }
+
+    if (record) {
+        try file.save(allocator, baselines_path);
+    } else if (regressions > 0) {
+        std.process.exit(1);
+    }
+}
+
+fn missingValue(arg: []const u8) error{InvalidArgument} {
+    std.debug.print("Error: {s} requires a value\n", .{arg});
+    return error.InvalidArgument;
+}
+
+fn printHelp() void {
+    std.debug.print(
+        \\Usage: baselines <compare|record> <results.json>... [options]
+        \\  --baselines <path>  Baselines file (default {s})
+        \\  --machine <class>   Machine class (default: the results' "machine", else {s})
+        \\  --threshold <pct>   Regression threshold (default: the file's)
+        \\
+    , .{ baselines.default_path, baselines.machine_class });
+}
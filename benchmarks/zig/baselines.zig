@@ -0,0 +1,313 @@
+//! Performance baselines (memory/performance_baselines.json)
+//!
+//! Benchmark results are recorded per machine class, and a run is only
+//! compared against the baseline recorded for its own class: numbers from
+//! a laptop say nothing about a CI runner. The class defaults to
+//! `<os>-<arch>-<cpu model>` of the build target (e.g.
+//! `linux-x86_64-znver3`) and can be named explicitly with `--machine`.
+//!
+//! File layout:
+//!
+//! ```json
+//! {
+//!   "version": "0.2.0",
+//!   "threshold_percent": 10,
+//!   "notes": "...",
+//!   "machines": {
+//!     "linux-x86_64-znver3": {
+//!       "baseline_date": "2025-10-17",
+//!       "benchmarks": {
+//!         "Core: createElement": { "ns_per_op": 21.37, "description": "..." }
+//!       }
+//!     }
+//!   }
+//! }
+//! ```
+//!
+//! A single run (the output of `bench -- --json` or of v8-bindings'
+//! bench/bindings_bench) has the shape of one machine entry plus `version`,
+//! `machine` and `notes`.
+
+const std = @import("std");
+const builtin = @import("builtin");
+
+pub const default_path = "memory/performance_baselines.json";
+pub const default_threshold_percent: f64 = 10;
+pub const format_version = "0.2.0";
+
+/// Machine class of this build: `<os>-<arch>-<cpu model>`.
+pub const machine_class = @tagName(builtin.os.tag) ++ "-" ++ @tagName(builtin.cpu.arch) ++ "-" ++ builtin.cpu.model.name;
+
+pub const Entry = struct {
+    ns_per_op: ?f64 = null,
+    description: []const u8 = "",
+};
+
+/// Results of one run, or the baseline of one machine class
+pub const Results = struct {
+    version: []const u8 = "",
+    baseline_date: []const u8 = "",
+    machine: []const u8 = "",
+    benchmarks: std.json.ArrayHashMap(Entry) = .{},
+    notes: []const u8 = "",
+};
+
+pub const Baselines = struct {
+    version: []const u8 = format_version,
+    threshold_percent: f64 = default_threshold_percent,
+    notes: []const u8 = "",
+    machines: std.json.ArrayHashMap(Results) = .{},
+};
+
+pub const Comparison = struct {
+    /// Benchmarks present in both the run and the baseline
+    compared: usize = 0,
+    /// Of those, slower than the baseline by more than the threshold
+    regressions: usize = 0,
+    /// Benchmarks of the run without a baseline value
+    missing: usize = 0,
+    /// False if the machine class has no baseline at all
+    has_baseline: bool = false,
+};
+
+/// The baselines file, with an arena owning all of its strings.
+pub const File = struct {
+    arena: std.heap.ArenaAllocator,
+    baselines: Baselines,
+
+    /// Load `path`; a missing file is an empty set of baselines.
+    pub fn load(allocator: std.mem.Allocator, path: []const u8) !File {
+        var arena = std.heap.ArenaAllocator.init(allocator);
+        errdefer arena.deinit();
+
+        const bytes = std.fs.cwd().readFileAlloc(arena.allocator(), path, 16 * 1024 * 1024) catch |err| switch (err) {
+            error.FileNotFound => return .{ .arena = arena, .baselines = .{} },
+            else => return err,
+        };
+        const baselines = try std.json.parseFromSliceLeaky(Baselines, arena.allocator(), bytes, .{
+            .ignore_unknown_fields = true,
+            .allocate = .alloc_always,
+        });
+        return .{ .arena = arena, .baselines = baselines };
+    }
+
+    pub fn deinit(self: *File) void {
+        self.arena.deinit();
+    }
+
+    /// Load a results file of a single run into this file's arena.
+    pub fn loadResults(self: *File, path: []const u8) !Results {
+        const allocator = self.arena.allocator();
+        const bytes = try std.fs.cwd().readFileAlloc(allocator, path, 16 * 1024 * 1024);
+        return std.json.parseFromSliceLeaky(Results, allocator, bytes, .{
+            .ignore_unknown_fields = true,
+            .allocate = .alloc_always,
+        });
+    }
+
+    /// Store the results of a run as the baseline of `machine`. Benchmarks
+    /// of the class that the run does not cover (e.g. the other runner's)
+    /// are kept.
+    pub fn record(self: *File, machine: []const u8, date: []const u8, results: Results) !void {
+        const allocator = self.arena.allocator();
+        const slot = try self.baselines.machines.map.getOrPut(allocator, machine);
+        if (!slot.found_existing) {
+            slot.key_ptr.* = try allocator.dupe(u8, machine);
+            slot.value_ptr.* = .{};
+        }
+        slot.value_ptr.baseline_date = try allocator.dupe(u8, date);
+
+        var it = results.benchmarks.map.iterator();
+        while (it.next()) |result| {
+            if (result.value_ptr.ns_per_op == null) continue;
+            const entry = try slot.value_ptr.benchmarks.map.getOrPut(allocator, result.key_ptr.*);
+            if (!entry.found_existing) {
+                entry.key_ptr.* = try allocator.dupe(u8, result.key_ptr.*);
+            }
+            entry.value_ptr.* = .{
+                .ns_per_op = result.value_ptr.ns_per_op,
+                .description = try allocator.dupe(u8, result.value_ptr.description),
+            };
+        }
+    }
+
+    /// Compare a run against the baseline of `machine`, printing one line
+    /// per benchmark that moved by more than the threshold.
+    pub fn compare(self: *const File, machine: []const u8, results: Results, threshold_percent: f64) Comparison {
+        var comparison: Comparison = .{};
+        const baseline = self.baselines.machines.map.get(machine) orelse {
+            std.debug.print("No baseline for machine class {s}; record one with --record\n", .{machine});
+            return comparison;
+        };
+        comparison.has_baseline = true;
+
+        var it = results.benchmarks.map.iterator();
+        while (it.next()) |result| {
+            const now = result.value_ptr.ns_per_op orelse continue;
+            const base_entry = baseline.benchmarks.map.get(result.key_ptr.*) orelse {
+                comparison.missing += 1;
+                continue;
+            };
+            const base = base_entry.ns_per_op orelse {
+                comparison.missing += 1;
+                continue;
+            };
+            if (base <= 0) continue;
+
+            comparison.compared += 1;
+            const change = (now - base) / base * 100;
+            if (change > threshold_percent) {
+                comparison.regressions += 1;
+                std.debug.print("REGRESSION {s}: {d:.2} -> {d:.2} ns/op (+{d:.1}%)\n", .{ result.key_ptr.*, base, now, change });
+            } else if (change < -threshold_percent) {
+                std.debug.print("improved   {s}: {d:.2} -> {d:.2} ns/op ({d:.1}%)\n", .{ result.key_ptr.*, base, now, change });
+            }
+        }
+
+        std.debug.print("{d} compared against {s} ({s}), {d} regressed by more than {d:.0}%, {d} without baseline\n", .{
+            comparison.compared,
+            machine,
+            baseline.baseline_date,
+            comparison.regressions,
+            threshold_percent,
+            comparison.missing,
+        });
+        return comparison;
+    }
+
+    pub fn save(self: *const File, allocator: std.mem.Allocator, path: []const u8) !void {
+        var json: std.ArrayList(u8) = .empty;
+        defer json.deinit(allocator);
+        const writer = json.writer(allocator);
+
+        try writer.writeAll("{\n");
+        try writer.writeAll("  \"version\": ");
+        try writeString(writer, format_version);
+        try writer.print(",\n  \"threshold_percent\": {d},\n", .{self.baselines.threshold_percent});
+        try writer.writeAll("  \"notes\": ");
+        try writeString(writer, self.baselines.notes);
+        try writer.writeAll(",\n  \"machines\": {");
+
+        var machines = self.baselines.machines.map.iterator();
+        var first_machine = true;
+        while (machines.next()) |machine| {
+            try writer.writeAll(if (first_machine) "\n    " else ",\n    ");
+            first_machine = false;
+            try writeString(writer, machine.key_ptr.*);
+            try writer.writeAll(": {\n      \"baseline_date\": ");
+            try writeString(writer, machine.value_ptr.baseline_date);
+            try writer.writeAll(",\n      \"benchmarks\": {");
+
+            var benchmarks = machine.value_ptr.benchmarks.map.iterator();
+            var first = true;
+            while (benchmarks.next()) |entry| {
+                try writer.writeAll(if (first) "\n        " else ",\n        ");
+                first = false;
+                try writeString(writer, entry.key_ptr.*);
+                if (entry.value_ptr.ns_per_op) |ns| {
+                    try writer.print(": {{ \"ns_per_op\": {d:.2}, \"description\": ", .{ns});
+                } else {
+                    try writer.writeAll(": { \"ns_per_op\": null, \"description\": ");
+                }
+                try writeString(writer, entry.value_ptr.description);
+                try writer.writeAll(" }");
+            }
+            try writer.writeAll(if (first) "}\n    }" else "\n      }\n    }");
+        }
+        try writer.writeAll(if (first_machine) "}\n}\n" else "\n  }\n}\n");
+
+        const file = try std.fs.cwd().createFile(path, .{});
+        defer file.close();
+        try file.writeAll(json.items);
+    }
+};
+
+/// Write the results of one run in the single-run shape (see top).
+pub fn writeResults(allocator: std.mem.Allocator, path: []const u8, machine: []const u8, date: []const u8, results: Results) !void {
+    var json: std.ArrayList(u8) = .empty;
+    defer json.deinit(allocator);
+    const writer = json.writer(allocator);
+
+    try writer.writeAll("{\n  \"version\": ");
+    try writeString(writer, format_version);
+    try writer.writeAll(",\n  \"baseline_date\": ");
+    try writeString(writer, date);
+    try writer.writeAll(",\n  \"machine\": ");
+    try writeString(writer, machine);
+    try writer.writeAll(",\n  \"benchmarks\": {");
+    var it = results.benchmarks.map.iterator();
+    var first = true;
+    while (it.next()) |entry| {
+        try writer.writeAll(if (first) "\n    " else ",\n    ");
+        first = false;
+        try writeString(writer, entry.key_ptr.*);
+        try writer.print(": {{ \"ns_per_op\": {d:.2}, \"description\": ", .{entry.value_ptr.ns_per_op orelse 0});
+        try writeString(writer, entry.value_ptr.description);
+        try writer.writeAll(" }");
+    }
+    try writer.writeAll(if (first) "},\n" else "\n  },\n");
+    try writer.writeAll("  \"notes\": ");
+    try writeString(writer, results.notes);
+    try writer.writeAll("\n}\n");
+
+    const file = try std.fs.cwd().createFile(path, .{});
+    defer file.close();
+    try file.writeAll(json.items);
+}
+
+/// Today's date (UTC) as YYYY-MM-DD.
+pub fn today(buffer: *[10]u8) []const u8 {
+    const seconds: u64 = @intCast(@max(std.time.timestamp(), 0));
+    const day = (std.time.epoch.EpochSeconds{ .secs = seconds }).getEpochDay();
+    const year_day = day.calculateYearDay();
+    const month_day = year_day.calculateMonthDay();
+    return std.fmt.bufPrint(buffer, "{d:0>4}-{d:0>2}-{d:0>2}", .{
+        year_day.year,
+        month_day.month.numeric(),
+        month_day.day_index + 1,
+    }) catch unreachable;
+}
+
+fn writeString(writer: anytype, value: []const u8) !void {
+    try writer.writeByte('"');
+    for (value) |c| switch (c) {
+        '"' => try writer.writeAll("\\\""),
+        '\\' => try writer.writeAll("\\\\"),
+        '\n' => try writer.writeAll("\\n"),
+        0x00...0x09, 0x0b...0x1f => try writer.print("\\u{x:0>4}", .{c}),
+        else => try writer.writeByte(c),
+    };
+    try writer.writeByte('"');
+}
+
+test "record keeps other benchmarks and compare flags regressions" {
+    const allocator = std.testing.allocator;
+    var file: File = .{ .arena = std.heap.ArenaAllocator.init(allocator), .baselines = .{} };
+    defer file.deinit();
+    const arena = file.arena.allocator();
+
+    var first: Results = .{};
+    try first.benchmarks.map.put(arena, "a", .{ .ns_per_op = 100 });
+    try first.benchmarks.map.put(arena, "b", .{ .ns_per_op = 50 });
+    try file.record("test-machine", "2025-01-01", first);
+
+    var second: Results = .{};
+    try second.benchmarks.map.put(arena, "b", .{ .ns_per_op = 40 });
+    try file.record("test-machine", "2025-01-02", second);
+
+    const baseline = file.baselines.machines.map.get("test-machine").?;
+    try std.testing.expectEqual(@as(usize, 2), baseline.benchmarks.map.count());
+    try std.testing.expectEqual(@as(?f64, 40), baseline.benchmarks.map.get("b").?.ns_per_op);
+
+    var run: Results = .{};
+    try run.benchmarks.map.put(arena, "a", .{ .ns_per_op = 111 });
+    try run.benchmarks.map.put(arena, "b", .{ .ns_per_op = 41 });
+    try run.benchmarks.map.put(arena, "c", .{ .ns_per_op = 1 });
+    const comparison = file.compare("test-machine", run, 10);
+    try std.testing.expect(comparison.has_baseline);
+    try std.testing.expectEqual(@as(usize, 2), comparison.compared);
+    try std.testing.expectEqual(@as(usize, 1), comparison.regressions);
+    try std.testing.expectEqual(@as(usize, 1), comparison.missing);
+
+    try std.testing.expect(!file.compare("other-machine", run, 10).has_baseline);
+}
@@ -4,6 +4,8 @@ const std = @import("std");
 const dom = @import("dom");
 const Document = dom.Document;
 const Element = dom.Element;
+const Event = dom.Event;
+const Range = dom.Range;
 const Tokenizer = dom.selector.Tokenizer;
 const Parser = dom.selector.Parser;
 const Matcher = dom.selector.Matcher;
@@ -18,6 +20,8 @@ pub const BenchmarkResult = struct {
     bytes_allocated: u64,
     bytes_per_op: u64,
     peak_memory: u64,
+    /// Bytes scanned per operation (throughput benchmarks only)
+    bytes_per_iteration: u64 = 0,
 };
 
 /// Run a benchmark function multiple times and collect statistics
@@ -143,11 +147,67 @@ pub fn benchmarkWithSetup(
     };
 }
 
+/// Run a byte scanning kernel over one buffer multiple times; the result
+/// carries the buffer size so the runner can report throughput.
+pub fn benchmarkThroughput(
+    allocator: std.mem.Allocator,
+    comptime name: []const u8,
+    iterations: usize,
+    size: usize,
+    fill: *const fn ([]u8) void,
+    func: *const fn ([]const u8) void,
+) !BenchmarkResult {
+    const buffer = try allocator.alloc(u8, size);
+    defer allocator.free(buffer);
+    fill(buffer);
+
+    // Warmup
+    var i: usize = 0;
+    while (i < 10) : (i += 1) {
+        func(buffer);
+    }
+
+    const start = std.time.nanoTimestamp();
+    i = 0;
+    while (i < iterations) : (i += 1) {
+        func(buffer);
+    }
+    const end = std.time.nanoTimestamp();
+
+    const total_ns: u64 = @intCast(end - start);
+    const ns_per_op = total_ns / iterations;
+    const ops_per_sec = if (ns_per_op > 0)
+        (1_000_000_000 / ns_per_op)
+    else
+        0;
+
+    return BenchmarkResult{
+        .name = name,
+        .operations = iterations,
+        .total_ns = total_ns,
+        .ns_per_op = ns_per_op,
+        .ops_per_sec = ops_per_sec,
+        .bytes_allocated = 0,
+        .bytes_per_op = 0,
+        .peak_memory = 0,
+        .bytes_per_iteration = size,
+    };
+}
+
 /// Run all benchmarks and return results
 pub fn runAllBenchmarks(allocator: std.mem.Allocator) ![]BenchmarkResult {
     var results: std.ArrayList(BenchmarkResult) = .empty;
     errdefer results.deinit(allocator);
 
+    // The operations tracked in memory/performance_baselines.json, on the
+    // same 1000-element tree as the v8-bindings benchmarks
+    std.debug.print("Running core benchmarks...\n", .{});
+    try results.append(allocator, try benchmarkWithSetup(allocator, "Core: createElement", 1000000, setupEmptyDocument, benchCreateElement));
+    try results.append(allocator, try benchmarkWithSetup(allocator, "Core: appendChild (move to end)", 1000000, setupCoreTree, benchAppendChild));
+    try results.append(allocator, try benchmarkWithSetup(allocator, "Core: querySelector .target (1000 elem)", 100000, setupCoreTree, benchCoreQuerySimple));
+    try results.append(allocator, try benchmarkWithSetup(allocator, "Core: querySelector row > cell[data-x] (1000 elem)", 100000, setupCoreTree, benchCoreQueryComplex));
+    try results.append(allocator, try benchmarkWithSetup(allocator, "Core: tree traversal (1000 elem)", 10000, setupCoreTree, benchCoreTraversal));
+
     std.debug.print("Running tokenizer benchmarks...\n", .{});
     try results.append(allocator, try benchmarkFn(allocator, "Tokenizer: Simple ID (#main)", 10000, tokenizeSimpleId));
     try results.append(allocator, try benchmarkFn(allocator, "Tokenizer: Simple Class (.button)", 10000, tokenizeSimpleClass));
@@ -158,6 +218,15 @@ pub fn runAllBenchmarks(allocator: std.mem.Allocator) ![]BenchmarkResult {
     try results.append(allocator, try benchmarkFn(allocator, "Parser: Simple Class (.button)", 10000, parseSimpleClass));
     try results.append(allocator, try benchmarkFn(allocator, "Parser: Complex", 10000, parseComplex));
 
+    // Node-by-node against single-allocation parsing, at typical lengths
+    inline for (.{ "#main", ".row.active", "list > item.active[data-state^=on]:not(.hidden)", "root item:has(> cell.selected), list > row:nth-child(2n+1) cell[data-x], leaf ~ item:is(.a, .b)" }) |selector| {
+        inline for (.{ false, true }) |compact| {
+            const mode = if (compact) "compact" else "parse";
+            const name = std.fmt.comptimePrint("Parser ({s}): {d} chars", .{ mode, selector.len });
+            try results.append(allocator, try benchmarkFn(allocator, name, 10000, ParseSelector(selector, compact).run));
+        }
+    }
+
     std.debug.print("Running matcher benchmarks...\n", .{});
     try results.append(allocator, try benchmarkFn(allocator, "Matcher: Simple ID", 10000, matchSimpleId));
     try results.append(allocator, try benchmarkFn(allocator, "Matcher: Simple Class", 10000, matchSimpleClass));
@@ -213,6 +282,42 @@ pub fn runAllBenchmarks(allocator: std.mem.Allocator) ![]BenchmarkResult {
     try results.append(allocator, try benchmarkWithSetup(allocator, "Complex: Type + class (div.active)", 100000, setupTypeClass, benchTypeClass));
     try results.append(allocator, try benchmarkWithSetup(allocator, "Complex: Attribute selector (div[data-id])", 100000, setupAttributeSelector, benchAttributeSelector));
     try results.append(allocator, try benchmarkWithSetup(allocator, "Complex: Multi-component (article#main > header h1.title)", 100000, setupComplexMultiComponent, benchComplexMultiComponent));
+    try results.append(allocator, try benchmarkWithSetup(allocator, "Complex: Deep tree querySelectorAll (.a .b leaf)", 100, setupDeepTree, benchDeepTreeDescendant));
+
+    // The same queries over linked nodes and over the compact element table
+    std.debug.print("Running compact layout benchmarks...\n", .{});
+    inline for (.{ false, true }) |compact| {
+        const mode = if (compact) " (compact)" else " (linked)";
+        try results.append(allocator, try benchmarkWithSetup(allocator, "Layout: querySelectorAll .target (10000 elem)" ++ mode, 1000, Layout(compact).setup, Layout(compact).benchClassAll));
+        try results.append(allocator, try benchmarkWithSetup(allocator, "Layout: querySelectorAll cell (10000 elem)" ++ mode, 1000, Layout(compact).setup, Layout(compact).benchTagAll));
+        try results.append(allocator, try benchmarkWithSetup(allocator, "Layout: querySelectorAll [data-x] (10000 elem)" ++ mode, 1000, Layout(compact).setup, Layout(compact).benchGenericAll));
+        try results.append(allocator, try benchmarkWithSetup(allocator, "Layout: querySelector .last (10000 elem)" ++ mode, 1000, Layout(compact).setup, Layout(compact).benchClassLast));
+    }
+
+    // One traversal for the whole list, alternatives dispatched by key
+    std.debug.print("Running selector list benchmarks...\n", .{});
+    inline for (.{ 1, 5, 20 }) |alternatives| {
+        const name = std.fmt.comptimePrint("Selector list: querySelector, {d} alternatives (9000 cells)", .{alternatives});
+        try results.append(allocator, try benchmarkWithSetup(allocator, name, 1000, SelectorAlternatives(alternatives).setup, SelectorAlternatives(alternatives).benchFirst));
+    }
+
+    // :has() answers shared between candidates and queries
+    std.debug.print("Running :has() benchmarks...\n", .{});
+    try results.append(allocator, try benchmarkWithSetup(allocator, ":has: querySelectorAll row:has(leaf) (10000 rows)", 100, setupHasRows, benchHasRows));
+    try results.append(allocator, try benchmarkWithSetup(allocator, ":has: querySelectorAll item:has(leaf) (nested depth 500)", 100, setupHasNested, benchHasNested));
+
+    std.debug.print("Running event dispatch benchmarks...\n", .{});
+    try results.append(allocator, try benchmarkWithSetup(allocator, "Event: bubbling dispatch (depth 50, 10k)", 10000, setupEventTree, benchBubblingDispatch));
+    try results.append(allocator, try benchmarkWithSetup(allocator, "Event: unobserved type dispatch (depth 50, 10k)", 10000, setupEventTree, benchUnobservedDispatch));
+
+    std.debug.print("Running live range benchmarks...\n", .{});
+    try results.append(allocator, try benchmarkWithSetup(allocator, "Range: typing with 10k live ranges", 100000, setupLiveRanges, benchTypingWithLiveRanges));
+    try results.append(allocator, try benchmarkWithSetup(allocator, "Range: insert/remove sibling with 10k live ranges", 100000, setupLiveRanges, benchSiblingWithLiveRanges));
+    _ = range_arena.reset(.free_all);
+    try results.append(allocator, try benchmarkWithSetup(allocator, "Text: typing into a 1MB text node", 100000, setupLargeText, benchTypingLargeText));
+    try results.append(allocator, try benchmarkWithSetup(allocator, "Text: split into 100k text nodes and normalize", 10, setupSplitText, benchSplitAndNormalize));
+    try results.append(allocator, try benchmarkWithSetup(allocator, "Range: extract and reinsert 10k rows", 100, setupExtractRows, benchExtractRows));
+    try results.append(allocator, try benchmarkWithSetup(allocator, "Markup: replace children with 1k rows", 100, setupMarkupRows, benchMarkupRows));
 
     // Phase 15: Attribute benchmarks
     std.debug.print("Running attribute benchmarks (Phase 15)...\n", .{});
@@ -227,6 +332,26 @@ pub fn runAllBenchmarks(allocator: std.mem.Allocator) ![]BenchmarkResult {
     try results.append(allocator, try benchmarkWithSetup(allocator, "Attribute: hasAttribute", 1000000, setupAttributeFew, benchHasAttribute));
     try results.append(allocator, try benchmarkWithSetup(allocator, "Attribute: removeAttribute", 1000000, setupAttributeFew, benchRemoveAttribute));
     try results.append(allocator, try benchmarkWithSetup(allocator, "Attribute: cloneNode with attrs", 100000, setupAttributeModerate, benchCloneNodeWithAttrs));
+    // Lookups of the last attribute, and a miss, as the count grows past the
+    // name index threshold
+    inline for (.{ 1, 8, 64 }) |n| {
+        const count = std.fmt.comptimePrint("{d} attrs", .{n});
+        try results.append(allocator, try benchmarkWithSetup(allocator, "Attribute: getAttribute last (" ++ count ++ ")", 1000000, AttributeCount(n).setup, AttributeCount(n).benchGetLast));
+        try results.append(allocator, try benchmarkWithSetup(allocator, "Attribute: hasAttribute miss (" ++ count ++ ")", 1000000, AttributeCount(n).setup, AttributeCount(n).benchHasMiss));
+        try results.append(allocator, try benchmarkWithSetup(allocator, "Attribute: setAttribute last (" ++ count ++ ")", 1000000, AttributeCount(n).setup, AttributeCount(n).benchSetLast));
+    }
+
+    // Byte scanning kernels (string_utils), over buffers that are scanned to the end
+    std.debug.print("Running text scanning benchmarks...\n", .{});
+    try results.append(allocator, try benchmarkThroughput(allocator, "Text scan: escape bytes (1KB)", 1000000, 1024, fillText, benchScanEscape));
+    try results.append(allocator, try benchmarkThroughput(allocator, "Text scan: escape bytes (64KB)", 20000, 64 * 1024, fillText, benchScanEscape));
+    try results.append(allocator, try benchmarkThroughput(allocator, "Text scan: escape bytes (1MB)", 1000, 1024 * 1024, fillText, benchScanEscape));
+    try results.append(allocator, try benchmarkThroughput(allocator, "Text scan: isAscii (1KB)", 1000000, 1024, fillText, benchIsAscii));
+    try results.append(allocator, try benchmarkThroughput(allocator, "Text scan: isAscii (64KB)", 20000, 64 * 1024, fillText, benchIsAscii));
+    try results.append(allocator, try benchmarkThroughput(allocator, "Text scan: isAscii (1MB)", 1000, 1024 * 1024, fillText, benchIsAscii));
+    try results.append(allocator, try benchmarkThroughput(allocator, "Text scan: trim whitespace (1KB)", 1000000, 1024, fillWhitespace, benchTrimWhitespace));
+    try results.append(allocator, try benchmarkThroughput(allocator, "Text scan: trim whitespace (64KB)", 20000, 64 * 1024, fillWhitespace, benchTrimWhitespace));
+    try results.append(allocator, try benchmarkThroughput(allocator, "Text scan: trim whitespace (1MB)", 1000, 1024 * 1024, fillWhitespace, benchTrimWhitespace));
 
     return results.toOwnedSlice(allocator);
 }
@@ -275,6 +400,19 @@ fn parseComplex(allocator: std.mem.Allocator) !void {
     defer list.deinit();
 }
 
+/// Parses `selector` with parse() or, with `compact`, parseCompact()
+fn ParseSelector(comptime selector: []const u8, comptime compact: bool) type {
+    return struct {
+        fn run(allocator: std.mem.Allocator) !void {
+            var tokenizer = Tokenizer.init(allocator, selector);
+            var parser = try Parser.init(allocator, &tokenizer);
+            defer parser.deinit();
+            var list = if (compact) try parser.parseCompact() else try parser.parse();
+            defer list.deinit();
+        }
+    };
+}
+
 fn matchSimpleId(allocator: std.mem.Allocator) !void {
     const doc = try Document.init(allocator);
     defer doc.release();
@@ -735,6 +873,83 @@ fn benchQuerySelectorClass(doc: *Document) !void {
     _ = result;
 }
 
+// Core benchmarks (performance baselines)
+
+fn setupEmptyDocument(allocator: std.mem.Allocator) !*Document {
+    return Document.init(allocator);
+}
+
+/// root > 100 rows > 9 cells > Text; every 10th cell has class "target"
+/// and a data-x attribute.
+fn setupCoreTree(allocator: std.mem.Allocator) !*Document {
+    const doc = try Document.init(allocator);
+    errdefer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+
+    var count: usize = 0;
+    for (0..100) |_| {
+        const row = try doc.createElement("row");
+        _ = try root.prototype.appendChild(&row.prototype);
+        for (0..9) |column| {
+            const cell = try doc.createElement("cell");
+            if (count % 10 == 0) {
+                const value = [_]u8{'0' + @as(u8, @intCast(column))};
+                try cell.setAttribute("class", "target");
+                try cell.setAttribute("data-x", &value);
+            }
+            _ = try row.prototype.appendChild(&cell.prototype);
+            _ = try cell.prototype.appendChild(&(try doc.createTextNode("line")).prototype);
+            count += 1;
+        }
+    }
+
+    return doc;
+}
+
+fn benchCreateElement(doc: *Document) !void {
+    const element = try doc.createElement("item");
+    element.prototype.release();
+}
+
+fn benchAppendChild(doc: *Document) !void {
+    // Moving the first row to the end keeps the tree the same size
+    const root = doc.prototype.first_child.?;
+    _ = try root.appendChild(root.first_child.?);
+}
+
+fn benchCoreQuerySimple(doc: *Document) !void {
+    _ = try doc.querySelector(".target");
+}
+
+fn benchCoreQueryComplex(doc: *Document) !void {
+    _ = try doc.querySelector("row > cell[data-x=\"8\"]");
+}
+
+var core_nodes_seen: usize = 0;
+
+fn benchCoreTraversal(doc: *Document) !void {
+    const root = &doc.prototype;
+    var node: ?*dom.Node = root.first_child;
+    while (node) |current| {
+        core_nodes_seen += 1;
+        if (current.first_child) |child| {
+            node = child;
+            continue;
+        }
+        var next: ?*dom.Node = current;
+        node = null;
+        while (next) |n| : (next = n.parent_node) {
+            if (n == root) break;
+            if (n.next_sibling) |sibling| {
+                node = sibling;
+                break;
+            }
+        }
+    }
+}
+
 // DOM Construction benchmarks (Phase 1.2)
 
 fn constructSmallDom(allocator: std.mem.Allocator) !void {
@@ -904,6 +1119,401 @@ fn setupComplexMultiComponent(allocator: std.mem.Allocator) !*Document {
     return doc;
 }
 
+fn setupDeepTree(allocator: std.mem.Allocator) !*Document {
+    const doc = try Document.init(allocator);
+    errdefer doc.release();
+
+    // Build: root > (item.a > item > ... > leaf) * 64, 256 levels deep;
+    // only every 8th chain has an item.b, so most leaves are rejected by
+    // the ancestor filter without walking their 256 ancestors
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+
+    var chain: usize = 0;
+    while (chain < 64) : (chain += 1) {
+        var parent = try doc.createElement("item");
+        try parent.setAttribute("class", "a");
+        _ = try root.prototype.appendChild(&parent.prototype);
+
+        var depth: usize = 0;
+        while (depth < 256) : (depth += 1) {
+            const child = try doc.createElement("item");
+            if (depth == 128 and chain % 8 == 0) try child.setAttribute("class", "b");
+            _ = try parent.prototype.appendChild(&child.prototype);
+
+            // A leaf hangs off every level
+            const leaf = try doc.createElement("leaf");
+            _ = try child.prototype.appendChild(&leaf.prototype);
+            parent = child;
+        }
+    }
+
+    return doc;
+}
+
+fn benchDeepTreeDescendant(doc: *Document) !void {
+    const results = try doc.querySelectorAll(".a .b leaf");
+    doc.prototype.allocator.free(results);
+}
+
+/// querySelector() with a list of `alternatives` generic selectors, only
+/// the last of which matches, and only the last cell
+fn SelectorAlternatives(comptime alternatives: usize) type {
+    return struct {
+        // Alternate class- and tag-keyed alternatives that never match
+        const selectors = blk: {
+            var list: []const u8 = "";
+            for (0..alternatives - 1) |i| {
+                const alternative = if (i % 2 == 0)
+                    std.fmt.comptimePrint("row > cell.k{d}, ", .{i})
+                else
+                    std.fmt.comptimePrint("kind{d}[data-x], ", .{i});
+                list = list ++ alternative;
+            }
+            break :blk list ++ "row > cell.last";
+        };
+
+        fn setup(allocator: std.mem.Allocator) !*Document {
+            const doc = try Document.init(allocator);
+            errdefer doc.release();
+
+            const root = try doc.createElement("root");
+            _ = try doc.prototype.appendChild(&root.prototype);
+
+            var count: usize = 0;
+            for (0..1000) |_| {
+                const row = try doc.createElement("row");
+                _ = try root.prototype.appendChild(&row.prototype);
+                for (0..9) |_| {
+                    const cell = try doc.createElement("cell");
+                    if (count % 10 == 0) try cell.setAttribute("class", "wide");
+                    if (count == 8999) try cell.setAttribute("class", "last");
+                    _ = try row.prototype.appendChild(&cell.prototype);
+                    count += 1;
+                }
+            }
+
+            _ = try doc.querySelector(selectors);
+            return doc;
+        }
+
+        fn benchFirst(doc: *Document) !void {
+            const result = try doc.querySelector(selectors);
+            std.mem.doNotOptimizeAway(result);
+        }
+    };
+}
+
+/// :has() over many flat candidates, and over nested candidates whose
+/// answers depend on each other
+fn setupHasRows(allocator: std.mem.Allocator) !*Document {
+    const doc = try Document.init(allocator);
+    errdefer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+
+    // Every tenth row holds a leaf below its cell
+    for (0..10000) |i| {
+        const row = try doc.createElement("row");
+        _ = try root.prototype.appendChild(&row.prototype);
+        const cell = try doc.createElement("cell");
+        _ = try row.prototype.appendChild(&cell.prototype);
+        if (i % 10 == 0) {
+            const leaf = try doc.createElement("leaf");
+            _ = try cell.prototype.appendChild(&leaf.prototype);
+        }
+    }
+    return doc;
+}
+
+fn benchHasRows(doc: *Document) !void {
+    const results = try doc.querySelectorAll("row:has(leaf)");
+    defer doc.prototype.allocator.free(results);
+    std.mem.doNotOptimizeAway(results.len);
+}
+
+fn setupHasNested(allocator: std.mem.Allocator) !*Document {
+    const doc = try Document.init(allocator);
+    errdefer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+
+    // A chain of nested items with the only leaf at the bottom
+    var parent = root;
+    for (0..500) |_| {
+        const item = try doc.createElement("item");
+        _ = try parent.prototype.appendChild(&item.prototype);
+        parent = item;
+    }
+    const leaf = try doc.createElement("leaf");
+    _ = try parent.prototype.appendChild(&leaf.prototype);
+    return doc;
+}
+
+fn benchHasNested(doc: *Document) !void {
+    const results = try doc.querySelectorAll("item:has(leaf)");
+    defer doc.prototype.allocator.free(results);
+    std.mem.doNotOptimizeAway(results.len);
+}
+
+/// Rows of cells with text, 10000 elements in all; every 100th cell is a
+/// .target with a data-x attribute and the last one is .last. With
+/// `compact`, the document keeps a compact layout, built by a first query.
+fn Layout(comptime compact: bool) type {
+    return struct {
+        fn setup(allocator: std.mem.Allocator) !*Document {
+            const doc = try Document.init(allocator);
+            errdefer doc.release();
+            if (compact) try doc.enableCompactLayout();
+
+            const root = try doc.createElement("root");
+            _ = try doc.prototype.appendChild(&root.prototype);
+
+            var count: usize = 0;
+            for (0..1000) |_| {
+                const row = try doc.createElement("row");
+                _ = try root.prototype.appendChild(&row.prototype);
+                for (0..9) |_| {
+                    const cell = try doc.createElement("cell");
+                    if (count % 100 == 0) {
+                        try cell.setAttribute("class", "target");
+                        try cell.setAttribute("data-x", "1");
+                    }
+                    if (count == 8999) try cell.setAttribute("class", "last");
+                    _ = try row.prototype.appendChild(&cell.prototype);
+                    _ = try cell.prototype.appendChild(&(try doc.createTextNode("line")).prototype);
+                    count += 1;
+                }
+            }
+
+            _ = try doc.querySelector(".last");
+            return doc;
+        }
+
+        fn benchClassAll(doc: *Document) !void {
+            const results = try doc.querySelectorAll(".target");
+            doc.prototype.allocator.free(results);
+        }
+
+        fn benchTagAll(doc: *Document) !void {
+            const results = try doc.querySelectorAll("cell");
+            doc.prototype.allocator.free(results);
+        }
+
+        fn benchGenericAll(doc: *Document) !void {
+            const results = try doc.querySelectorAll("[data-x]");
+            doc.prototype.allocator.free(results);
+        }
+
+        fn benchClassLast(doc: *Document) !void {
+            const result = try doc.querySelector(".last");
+            std.mem.doNotOptimizeAway(result);
+        }
+    };
+}
+
+/// Listener invocations, so the listener body cannot be optimized out
+var dispatch_count: usize = 0;
+
+fn countDispatch(_: *Event, _: *anyopaque) void {
+    dispatch_count += 1;
+}
+
+fn setupEventTree(allocator: std.mem.Allocator) !*Document {
+    const doc = try Document.init(allocator);
+    errdefer doc.release();
+
+    // Build: root > item > ... > leaf#target, 50 levels deep, with a
+    // bubble listener on every level
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    try root.prototype.addEventListener("ping", countDispatch, @ptrCast(&dispatch_count), false, false, false, null);
+
+    var parent = root;
+    var depth: usize = 1;
+    while (depth < 50) : (depth += 1) {
+        const child = try doc.createElement(if (depth == 49) "leaf" else "item");
+        _ = try parent.prototype.appendChild(&child.prototype);
+        try child.prototype.addEventListener("ping", countDispatch, @ptrCast(&dispatch_count), false, false, false, null);
+        parent = child;
+    }
+    try parent.setAttribute("id", "target");
+
+    return doc;
+}
+
+fn benchBubblingDispatch(doc: *Document) !void {
+    const target = doc.getElementById("target") orelse return error.MissingTarget;
+    var event = Event.init("ping", .{ .bubbles = true });
+    _ = try target.prototype.dispatchEvent(&event);
+}
+
+fn benchUnobservedDispatch(doc: *Document) !void {
+    // Every level listens for "ping" only
+    const target = doc.getElementById("target") orelse return error.MissingTarget;
+    var event = Event.init("pointermove", .{ .bubbles = true });
+    _ = try target.prototype.dispatchEvent(&event);
+}
+
+/// Ranges outlive their benchmark's document (they are uncoupled when it
+/// is released), so they come from their own arena
+var range_arena = std.heap.ArenaAllocator.init(std.heap.page_allocator);
+
+fn setupLiveRanges(allocator: std.mem.Allocator) !*Document {
+    const doc = try Document.init(allocator);
+    errdefer doc.release();
+
+    // Build: root > 100 x line > text, with 100 ranges in every text node
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+
+    var line_index: usize = 0;
+    while (line_index < 100) : (line_index += 1) {
+        const line = try doc.createElement("line");
+        _ = try root.prototype.appendChild(&line.prototype);
+        if (line_index == 50) try line.setAttribute("id", "target");
+
+        const text = try doc.createTextNode("ranges are anchored along this line of text, one hundred per node....");
+        _ = try line.prototype.appendChild(&text.prototype);
+
+        var range_index: u32 = 0;
+        while (range_index < 100) : (range_index += 1) {
+            const range = try Range.init(range_arena.allocator(), doc);
+            const offset = range_index % 60;
+            try range.setStart(&text.prototype, offset);
+            try range.setEnd(&text.prototype, offset + 10);
+        }
+    }
+
+    return doc;
+}
+
+fn benchTypingWithLiveRanges(doc: *Document) !void {
+    // Only the 100 ranges in the edited text node are visited
+    const line = doc.getElementById("target") orelse return error.MissingTarget;
+    const text: *dom.Text = @fieldParentPtr("prototype", line.prototype.first_child.?);
+    try text.insertData(30, "x");
+    try text.deleteData(30, 1);
+}
+
+fn benchSiblingWithLiveRanges(doc: *Document) !void {
+    const line = doc.getElementById("target") orelse return error.MissingTarget;
+    const root = line.prototype.parent_node.?;
+    const sibling = try doc.createElement("line");
+    _ = try root.insertBefore(&sibling.prototype, &line.prototype);
+    _ = try root.removeChild(&sibling.prototype);
+    sibling.prototype.release();
+}
+
+fn setupLargeText(allocator: std.mem.Allocator) !*Document {
+    const doc = try Document.init(allocator);
+    errdefer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    try root.setAttribute("id", "target");
+
+    const content = try allocator.alloc(u8, 1024 * 1024);
+    defer allocator.free(content);
+    @memset(content, 'a');
+    const text = try doc.createTextNode(content);
+    _ = try root.prototype.appendChild(&text.prototype);
+
+    return doc;
+}
+
+fn benchTypingLargeText(doc: *Document) !void {
+    // Long data is edited in place (character_data.zig)
+    const root = doc.getElementById("target") orelse return error.MissingTarget;
+    const text: *dom.Text = @fieldParentPtr("prototype", root.prototype.first_child.?);
+    try text.insertData(512 * 1024, "x");
+    try text.deleteData(512 * 1024, 1);
+}
+
+const split_text_nodes = 100_000;
+const split_piece_len = 8;
+
+fn setupSplitText(allocator: std.mem.Allocator) !*Document {
+    const doc = try Document.init(allocator);
+    errdefer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    try root.setAttribute("id", "target");
+
+    const content = try allocator.alloc(u8, split_text_nodes * split_piece_len);
+    defer allocator.free(content);
+    @memset(content, 'a');
+    const text = try doc.createTextNode(content);
+    _ = try root.prototype.appendChild(&text.prototype);
+
+    return doc;
+}
+
+fn benchSplitAndNormalize(doc: *Document) !void {
+    // Editing leaves the data in 100k adjacent text nodes; normalize()
+    // merges them back with one append and one unlink
+    const root = doc.getElementById("target") orelse return error.MissingTarget;
+    const text: *dom.Text = @fieldParentPtr("prototype", root.prototype.first_child.?);
+    var i: usize = 1;
+    while (i < split_text_nodes) : (i += 1) {
+        _ = try text.splitText(text.data.len - split_piece_len);
+    }
+    try root.prototype.normalize();
+}
+
+fn setupExtractRows(allocator: std.mem.Allocator) !*Document {
+    const doc = try Document.init(allocator);
+    errdefer doc.release();
+
+    // Build: root > 10k x row > text
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    try root.setAttribute("id", "target");
+
+    var i: usize = 0;
+    while (i < 10_000) : (i += 1) {
+        const row = try doc.createElement("row");
+        _ = try root.prototype.appendChild(&row.prototype);
+        const text = try doc.createTextNode("row");
+        _ = try row.prototype.appendChild(&text.prototype);
+    }
+
+    return doc;
+}
+
+fn benchExtractRows(doc: *Document) !void {
+    // The contained rows leave and come back as one sibling chain
+    const root = doc.getElementById("target") orelse return error.MissingTarget;
+    const range = try doc.createRange();
+    defer range.deinit();
+    try range.selectNodeContents(&root.prototype);
+
+    const fragment = try range.extractContents();
+    defer fragment.prototype.release();
+    _ = try root.prototype.appendChild(&fragment.prototype);
+}
+
+fn setupMarkupRows(allocator: std.mem.Allocator) !*Document {
+    const doc = try Document.init(allocator);
+    errdefer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    try root.setAttribute("id", "target");
+    return doc;
+}
+
+const markup_rows = "<row class=\"item\"><cell>first &amp; second</cell></row>" ** 1000;
+
+fn benchMarkupRows(doc: *Document) !void {
+    // One parse into a fragment, one removal run, one insertion
+    const root = doc.getElementById("target") orelse return error.MissingTarget;
+    try root.setInnerMarkup(markup_rows);
+}
+
 fn benchChildCombinator(doc: *Document) !void {
     const result = try doc.querySelector("div > p");
     _ = result;
@@ -1080,3 +1690,65 @@ fn benchCloneNodeWithAttrs(doc: *Document) !void {
     const clone = try elem.cloneNode(false);
     clone.release();
 }
+
+/// Element with `n` data attributes (data-0 ... data-{n-1}).
+fn AttributeCount(comptime n: usize) type {
+    return struct {
+        const last = std.fmt.comptimePrint("data-{d}", .{n - 1});
+
+        fn setup(allocator: std.mem.Allocator) !*Document {
+            const doc = try Document.init(allocator);
+            const root = try doc.createElement("root");
+            _ = try doc.prototype.appendChild(&root.prototype);
+
+            const elem = try doc.createElement("element");
+            for (0..n) |i| {
+                var name: [16]u8 = undefined;
+                try elem.setAttribute(try std.fmt.bufPrint(&name, "data-{d}", .{i}), "value");
+            }
+            _ = try root.prototype.appendChild(&elem.prototype);
+            return doc;
+        }
+
+        fn element(doc: *Document) *Element {
+            return @fieldParentPtr("prototype", doc.prototype.first_child.?.first_child.?);
+        }
+
+        fn benchGetLast(doc: *Document) !void {
+            std.mem.doNotOptimizeAway(element(doc).getAttribute(last));
+        }
+
+        fn benchHasMiss(doc: *Document) !void {
+            std.mem.doNotOptimizeAway(element(doc).hasAttribute("data-missing"));
+        }
+
+        fn benchSetLast(doc: *Document) !void {
+            try element(doc).setAttribute(last, "changed");
+        }
+    };
+}
+
+// Text scanning benchmarks
+
+fn fillText(buffer: []u8) void {
+    // ASCII prose without markup characters, so every scan runs to the end
+    const words = "the quick brown fox jumps over the lazy dog, again and again. ";
+    for (buffer, 0..) |*c, i| c.* = words[i % words.len];
+}
+
+fn fillWhitespace(buffer: []u8) void {
+    // Whitespace only: trimming scans forward through the whole buffer
+    for (buffer, 0..) |*c, i| c.* = dom.string_utils.ascii_whitespace[i % dom.string_utils.ascii_whitespace.len];
+}
+
+fn benchScanEscape(buffer: []const u8) void {
+    std.mem.doNotOptimizeAway(dom.string_utils.indexOfAnyPos(buffer, 0, "&<>\"\xC2"));
+}
+
+fn benchIsAscii(buffer: []const u8) void {
+    std.mem.doNotOptimizeAway(dom.string_utils.isAscii(buffer));
+}
+
+fn benchTrimWhitespace(buffer: []const u8) void {
+    std.mem.doNotOptimizeAway(dom.string_utils.trimAsciiWhitespace(buffer).len);
+}
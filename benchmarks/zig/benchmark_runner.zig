@@ -1,13 +1,57 @@
 //! Benchmark runner executable
+//!
+//! ```bash
+//! zig build bench -Doptimize=ReleaseFast                 # print results
+//! zig build bench -Doptimize=ReleaseFast -- --compare    # fail on >10% regressions
+//! zig build bench -Doptimize=ReleaseFast -- --record     # store as this machine's baseline
+//! ```
+//!
+//! See baselines.zig for how results are tagged by machine class.
 
 const std = @import("std");
 const benchmark = @import("benchmark.zig");
+const baselines = @import("baselines.zig");
+
+const Options = struct {
+    record: bool = false,
+    compare: bool = false,
+    json_path: ?[]const u8 = null,
+    baselines_path: []const u8 = baselines.default_path,
+    machine: []const u8 = baselines.machine_class,
+    threshold_percent: ?f64 = null,
+};
 
 pub fn main() !void {
     var gpa = std.heap.GeneralPurposeAllocator(.{}){};
     defer _ = gpa.deinit();
     const allocator = gpa.allocator();
 
+    var args = try std.process.argsWithAllocator(allocator);
+    defer args.deinit();
+    _ = args.skip();
+
+    var options: Options = .{};
+    while (args.next()) |arg| {
+        if (std.mem.eql(u8, arg, "--record")) {
+            options.record = true;
+        } else if (std.mem.eql(u8, arg, "--compare")) {
+            options.compare = true;
+        } else if (std.mem.eql(u8, arg, "--json")) {
+            options.json_path = args.next() orelse return missingValue(arg);
+        } else if (std.mem.eql(u8, arg, "--baselines")) {
+            options.baselines_path = args.next() orelse return missingValue(arg);
+        } else if (std.mem.eql(u8, arg, "--machine")) {
+            options.machine = args.next() orelse return missingValue(arg);
+        } else if (std.mem.eql(u8, arg, "--threshold")) {
+            const value = args.next() orelse return missingValue(arg);
+            options.threshold_percent = try std.fmt.parseFloat(f64, value);
+        } else {
+            printHelp();
+            if (std.mem.eql(u8, arg, "--help")) return;
+            return error.InvalidArgument;
+        }
+    }
+
     std.debug.print("DOM Selector Benchmark Suite\n", .{});
     std.debug.print("=============================\n\n", .{});
 
@@ -20,6 +64,8 @@ pub fn main() !void {
     // Define category detection
     const Category = struct {
         fn getCategory(name: []const u8) ?[]const u8 {
+            if (std.mem.startsWith(u8, name, "Core:"))
+                return "Core Operations (tracked baselines)";
             if (std.mem.startsWith(u8, name, "Tokenizer:") or
                 std.mem.startsWith(u8, name, "Parser:") or
                 std.mem.startsWith(u8, name, "Matcher:"))
@@ -44,6 +90,12 @@ pub fn main() !void {
                 return "SPA Patterns";
             if (std.mem.startsWith(u8, name, "Attribute:"))
                 return "Attribute Operations (Phase 15)";
+            if (std.mem.startsWith(u8, name, "Range:"))
+                return "Live Ranges";
+            if (std.mem.startsWith(u8, name, "Text:"))
+                return "Character Data";
+            if (std.mem.startsWith(u8, name, "Text scan:"))
+                return "Text Scanning (throughput)";
             return null;
         }
     };
@@ -61,6 +113,14 @@ pub fn main() !void {
             }
         }
 
+        if (result.bytes_per_iteration > 0) {
+            // Throughput: bytes per nanosecond is GB/s
+            const bytes_total: f64 = @floatFromInt(result.bytes_per_iteration * result.operations);
+            const ns_total: f64 = @floatFromInt(@max(result.total_ns, 1));
+            std.debug.print("{s}: {d:.2} GB/s ({d}ns/op)\n", .{ result.name, bytes_total / ns_total, result.ns_per_op });
+            continue;
+        }
+
         const ns = result.ns_per_op;
         const bytes = result.bytes_per_op; // Show baseline memory (after warmup)
 
@@ -102,4 +162,67 @@ pub fn main() !void {
     }
 
     std.debug.print("\nBenchmark complete!\n", .{});
+
+    if (options.record or options.compare or options.json_path != null) {
+        if (!try saveResults(allocator, options, results)) {
+            std.process.exit(1);
+        }
+    }
+}
+
+/// Write, compare and/or record the results; false if the comparison
+/// found regressions.
+fn saveResults(allocator: std.mem.Allocator, options: Options, results: []const benchmark.BenchmarkResult) !bool {
+    var file = try baselines.File.load(allocator, options.baselines_path);
+    defer file.deinit();
+    const arena = file.arena.allocator();
+
+    // Per-op times from the totals; ns_per_op is truncated to whole ns
+    var run: baselines.Results = .{};
+    for (results) |result| {
+        if (result.operations == 0) continue;
+        const ns: f64 = @as(f64, @floatFromInt(result.total_ns)) / @as(f64, @floatFromInt(result.operations));
+        try run.benchmarks.map.put(arena, result.name, .{ .ns_per_op = ns });
+    }
+
+    var date_buffer: [10]u8 = undefined;
+    const date = baselines.today(&date_buffer);
+
+    if (options.json_path) |path| {
+        try baselines.writeResults(allocator, path, options.machine, date, run);
+        std.debug.print("Results written to {s}\n", .{path});
+    }
+
+    var passed = true;
+    if (options.compare) {
+        std.debug.print("\nComparing with {s}\n", .{options.baselines_path});
+        const threshold = options.threshold_percent orelse file.baselines.threshold_percent;
+        passed = file.compare(options.machine, run, threshold).regressions == 0;
+    }
+
+    if (options.record) {
+        try file.record(options.machine, date, run);
+        try file.save(allocator, options.baselines_path);
+        std.debug.print("Recorded baseline for {s} in {s}\n", .{ options.machine, options.baselines_path });
+    }
+    return passed;
+}
+
+fn missingValue(arg: []const u8) error{InvalidArgument} {
+    std.debug.print("Error: {s} requires a value\n", .{arg});
+    return error.InvalidArgument;
+}
+
+fn printHelp() void {
+    std.debug.print(
+        \\Usage: benchmark [options]
+        \\  --compare           Fail if any benchmark is slower than this machine's
+        \\                      baseline by more than the threshold
+        \\  --record            Store the results as this machine's baseline
+        \\  --json <path>       Also write the results of this run to <path>
+        \\  --baselines <path>  Baselines file (default {s})
+        \\  --machine <class>   Machine class (default {s})
+        \\  --threshold <pct>   Regression threshold (default: the file's, {d}%)
+        \\
+    , .{ baselines.default_path, baselines.machine_class, baselines.default_threshold_percent });
 }
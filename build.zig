@@ -177,10 +177,32 @@ pub fn build(b: *std.Build) void {
         }),
     });
 
-    const bench_step = b.step("bench", "Run benchmarks");
+    const bench_step = b.step("bench", "Run benchmarks (-- --compare / --record against memory/performance_baselines.json)");
     const bench_run = b.addRunArtifact(bench_exe);
+    bench_run.setCwd(b.path("."));
+    if (b.args) |args| {
+        bench_run.addArgs(args);
+    }
     bench_step.dependOn(&bench_run.step);
 
+    // Baseline gate for results of other runners (v8-bindings bench)
+    const baselines_exe = b.addExecutable(.{
+        .name = "baselines",
+        .root_module = b.createModule(.{
+            .root_source_file = b.path("benchmarks/zig/baseline_gate.zig"),
+            .target = target,
+            .optimize = optimize,
+        }),
+    });
+
+    const baselines_step = b.step("baselines", "Compare or record benchmark result files against memory/performance_baselines.json");
+    const baselines_run = b.addRunArtifact(baselines_exe);
+    baselines_run.setCwd(b.path("."));
+    if (b.args) |args| {
+        baselines_run.addArgs(args);
+    }
+    baselines_step.dependOn(&baselines_run.step);
+
     // Benchmark-all: Run Zig + Browser benchmarks + Generate visualization
     const bench_all_step = b.step("benchmark-all", "Run all benchmarks (Zig + Browsers) and generate visualization");
     const bench_all_script = b.addSystemCommand(&.{
@@ -228,6 +250,46 @@ pub fn build(b: *std.Build) void {
     stress_visualize.step.dependOn(&stress_run.step);
     stress_step.dependOn(&stress_visualize.step);
 
+    // Cache miss benchmark executable
+    const cache_exe = b.addExecutable(.{
+        .name = "cache-misses",
+        .root_module = b.createModule(.{
+            .root_source_file = b.path("benchmarks/memory-stress/cache_misses.zig"),
+            .target = target,
+            .optimize = optimize,
+            .imports = &.{
+                .{ .name = "dom", .module = mod },
+            },
+        }),
+    });
+
+    const cache_step = b.step("cache-misses", "Count cache misses of tree walks and queries (use -Doptimize=ReleaseFast)");
+    const cache_run = b.addRunArtifact(cache_exe);
+    if (b.args) |args| {
+        cache_run.addArgs(args);
+    }
+    cache_step.dependOn(&cache_run.step);
+
+    // AbortSignal churn stress executable
+    const abort_exe = b.addExecutable(.{
+        .name = "abort-stress",
+        .root_module = b.createModule(.{
+            .root_source_file = b.path("benchmarks/memory-stress/abort_signals.zig"),
+            .target = target,
+            .optimize = optimize,
+            .imports = &.{
+                .{ .name = "dom", .module = mod },
+            },
+        }),
+    });
+
+    const abort_step = b.step("abort-stress", "Churn AbortSignal.any() composites over a long-lived signal (use -Doptimize=ReleaseFast)");
+    const abort_run = b.addRunArtifact(abort_exe);
+    if (b.args) |args| {
+        abort_run.addArgs(args);
+    }
+    abort_step.dependOn(&abort_run.step);
+
     // WebIDL parser module (standalone, reusable)
     const webidl_parser_mod = b.addModule("webidl-parser", .{
         .root_source_file = b.path("tools/webidl-parser/root.zig"),
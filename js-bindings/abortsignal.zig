@@ -5,6 +5,10 @@
 //!
 //! ## Exported Functions
 //! - dom_abortsignal_abort() - Static factory for pre-aborted signal
+//! - dom_abortsignal_any() - Static factory for a composite signal
+//! - dom_abortsignal_timeout() - Static factory for a timeout signal
+//! - dom_abortsignal_set_timerhost() - Install the embedder's timer
+//! - dom_abortsignal_run_timeouts() - Fire expired timeouts
 //! - dom_abortsignal_get_aborted() - Check if aborted
 //! - dom_abortsignal_throwifaborted() - Throw if aborted (returns error code)
 //! - dom_abortsignal_acquire() - Increment reference count
@@ -18,6 +22,36 @@ const dom_types = @import("dom_types.zig");
 /// Opaque AbortSignal handle for C
 pub const DOMAbortSignal = opaque {};
 
+/// The embedder's timer (see dom.h): a monotonic millisecond clock and ONE
+/// timer that every timeout signal shares.
+pub const DOMTimerHost = extern struct {
+    context: ?*anyopaque,
+    now: *const fn (context: ?*anyopaque) callconv(.c) u64,
+    arm: *const fn (context: ?*anyopaque, deadline: u64) callconv(.c) void,
+    disarm: *const fn (context: ?*anyopaque) callconv(.c) void,
+};
+
+/// Timeout queue over the installed host (null until one is installed)
+var timeout_queue: ?dom.TimeoutQueue = null;
+var timer_host: DOMTimerHost = undefined;
+
+const timer_host_adapter = struct {
+    fn now(context: ?*anyopaque) u64 {
+        _ = context;
+        return timer_host.now(timer_host.context);
+    }
+
+    fn arm(context: ?*anyopaque, deadline: u64) void {
+        _ = context;
+        timer_host.arm(timer_host.context, deadline);
+    }
+
+    fn disarm(context: ?*anyopaque) void {
+        _ = context;
+        timer_host.disarm(timer_host.context);
+    }
+};
+
 /// Create a pre-aborted signal (static factory).
 ///
 /// Returns a signal that's already aborted with optional reason.
@@ -59,6 +93,120 @@ pub export fn dom_abortsignal_abort(reason: ?*anyopaque) *DOMAbortSignal {
     return @ptrCast(signal);
 }
 
+/// Create a signal that aborts when any of `signals` aborts (static factory).
+///
+/// Composite signals follow their sources through weak links: neither side
+/// holds a reference, and whichever is released (or aborts) first unlinks
+/// from the other in O(1). A composite that never aborts costs its sources
+/// nothing once it is released, however long they live.
+///
+/// ## Parameters
+/// - `signals`: Source signals (can be NULL when `count` is 0)
+/// - `count`: Number of source signals
+///
+/// ## Returns
+/// AbortSignal handle (never NULL; already aborted if a source is)
+///
+/// ## Memory Management
+/// Returned signal has ref_count = 1. Caller MUST call release() when done.
+/// The sources are not acquired.
+///
+/// ## Example
+/// ```c
+/// DOMAbortSignal* sources[2] = { request_signal, shutdown_signal };
+/// DOMAbortSignal* signal = dom_abortsignal_any(sources, 2);
+///
+/// fetch_with_abort(url, signal);
+/// dom_abortsignal_release(signal);
+/// ```
+///
+/// ## WebIDL
+/// ```webidl
+/// [NewObject] static AbortSignal _any(sequence<AbortSignal> signals);
+/// ```
+pub export fn dom_abortsignal_any(signals: ?[*]const *DOMAbortSignal, count: u32) *DOMAbortSignal {
+    const allocator = std.heap.c_allocator;
+    const handles: []const *DOMAbortSignal = if (signals) |ptr| ptr[0..count] else &.{};
+    const signal = AbortSignal.any(allocator, @ptrCast(handles)) catch {
+        @panic("Failed to allocate AbortSignal");
+    };
+    return @ptrCast(signal);
+}
+
+/// Create a signal that aborts with a "TimeoutError" DOMException after
+/// `milliseconds` (static factory).
+///
+/// The timeout runs on the timer installed with
+/// dom_abortsignal_set_timerhost(). Pending timeouts are kept in coalesced
+/// timer wheels, so any number of them costs the embedder one timer, and
+/// no closure or timer handle is allocated per signal. A timeout never
+/// fires early; it may fire up to 1/8 of its delay late.
+///
+/// ## Parameters
+/// - `milliseconds`: Delay before the signal aborts
+///
+/// ## Returns
+/// AbortSignal handle, or NULL if no timer host is installed
+///
+/// ## Memory Management
+/// Returned signal has ref_count = 1. Caller MUST call release() when done.
+/// The timer holds its own reference until the timeout fires.
+///
+/// ## Example
+/// ```c
+/// DOMAbortSignal* signal = dom_abortsignal_timeout(5000);
+/// fetch_with_abort(url, signal);
+/// dom_abortsignal_release(signal);
+/// ```
+///
+/// ## WebIDL
+/// ```webidl
+/// [NewObject] static AbortSignal timeout([EnforceRange] unsigned long long milliseconds);
+/// ```
+pub export fn dom_abortsignal_timeout(milliseconds: u64) ?*DOMAbortSignal {
+    const queue = if (timeout_queue) |*q| q else return null;
+    const signal = AbortSignal.timeout(std.heap.c_allocator, queue, milliseconds) catch {
+        @panic("Failed to allocate AbortSignal");
+    };
+    return @ptrCast(signal);
+}
+
+/// Install (or, with NULL, remove) the embedder's timer.
+///
+/// The host is copied. Removing or replacing a host releases the signals
+/// still pending on the old one without aborting them.
+///
+/// ## Parameters
+/// - `host`: Timer host, or NULL
+pub export fn dom_abortsignal_set_timerhost(host: ?*const DOMTimerHost) void {
+    if (timeout_queue) |*queue| {
+        queue.deinit();
+        timeout_queue = null;
+    }
+    const new_host = host orelse return;
+    timer_host = new_host.*;
+    timeout_queue = dom.TimeoutQueue.init(std.heap.c_allocator, .{
+        .now = timer_host_adapter.now,
+        .arm = timer_host_adapter.arm,
+        .disarm = timer_host_adapter.disarm,
+    });
+}
+
+/// Abort every signal whose timeout has expired, then re-arm the host
+/// timer. Call it when the armed timer fires (calling it early is harmless).
+///
+/// ## Returns
+/// - 0 on success (or if no timer host is installed)
+/// - QuotaExceededError (22) if a signal could not be aborted; the host is
+///   re-armed to retry at once
+pub export fn dom_abortsignal_run_timeouts() i32 {
+    const queue = if (timeout_queue) |*q| q else return 0;
+    queue.run() catch |err| {
+        return @intFromEnum(dom_types.zigErrorToDOMError(err));
+    };
+    return 0;
+}
+
 /// Check if signal has been aborted.
 ///
 /// ## Parameters
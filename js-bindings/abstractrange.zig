@@ -72,6 +72,7 @@ const AbstractRange = dom.AbstractRange;
 const Node = dom.Node;
 const DOMAbstractRange = types.DOMAbstractRange;
 const DOMNode = types.DOMNode;
+const toDomOffset = dom.character_data.toDomOffset;
 
 // ============================================================================
 // Properties
@@ -116,7 +117,7 @@ pub export fn dom_abstractrange_get_startcontainer(range: *DOMAbstractRange) *DO
 ///
 /// ## Returns
 /// Offset within start container (0-based)
-/// - For Text/Comment: Character offset
+/// - For Text/Comment: UTF-16 code unit offset
 /// - For Element/DocumentFragment: Child index
 ///
 /// ## Spec References
@@ -130,7 +131,7 @@ pub export fn dom_abstractrange_get_startcontainer(range: *DOMAbstractRange) *DO
 /// ```
 pub export fn dom_abstractrange_get_startoffset(range: *DOMAbstractRange) u32 {
     const abstract_range: *const AbstractRange = @ptrCast(@alignCast(range));
-    return abstract_range.start_offset;
+    return toDomOffset(abstract_range.start_container, abstract_range.start_offset);
 }
 
 /// Gets the end container node.
@@ -172,7 +173,7 @@ pub export fn dom_abstractrange_get_endcontainer(range: *DOMAbstractRange) *DOMN
 ///
 /// ## Returns
 /// Offset within end container (0-based)
-/// - For Text/Comment: Character offset
+/// - For Text/Comment: UTF-16 code unit offset
 /// - For Element/DocumentFragment: Child index
 ///
 /// ## Spec References
@@ -186,7 +187,7 @@ pub export fn dom_abstractrange_get_endcontainer(range: *DOMAbstractRange) *DOMN
 /// ```
 pub export fn dom_abstractrange_get_endoffset(range: *DOMAbstractRange) u32 {
     const abstract_range: *const AbstractRange = @ptrCast(@alignCast(range));
-    return abstract_range.end_offset;
+    return toDomOffset(abstract_range.end_container, abstract_range.end_offset);
 }
 
 /// Gets whether the range is collapsed (start == end).
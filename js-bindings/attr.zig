@@ -62,10 +62,12 @@ const Attr = dom.Attr;
 const Element = dom.Element;
 const DOMAttr = types.DOMAttr;
 const DOMElement = types.DOMElement;
+const DOMStringView = types.DOMStringView;
 const zigStringToCString = types.zigStringToCString;
 const zigStringToCStringOptional = types.zigStringToCStringOptional;
 const cStringToZigString = types.cStringToZigString;
 const zigErrorToDOMError = types.zigErrorToDOMError;
+const zigStringToStringView = types.zigStringToStringView;
 
 // ============================================================================
 // Properties (Readonly)
@@ -271,6 +273,7 @@ pub export fn dom_attr_set_value(attr: *DOMAttr, value: [*:0]const u8) c_int {
     const attr_node: *Attr = @ptrCast(@alignCast(attr));
     const value_slice = cStringToZigString(value);
 
+    // Set an existing attribute value: an attached Attr changes its element
     attr_node.setValue(value_slice) catch |err| {
         return @intFromEnum(zigErrorToDOMError(err));
     };
@@ -349,6 +352,67 @@ pub export fn dom_attr_get_specified(attr: *DOMAttr) u8 {
     return 1; // Always true per spec
 }
 
+// ============================================================================
+// String Views
+// ============================================================================
+// Attr strings are not null-terminated, so bindings read them as views.
+// Views are valid until the attribute's value (or the Attr) changes.
+
+/// Get name as a string view (no copy)
+///
+/// WebIDL: `readonly attribute DOMString name;`
+pub export fn dom_attr_get_name_view(attr: *DOMAttr, out: *DOMStringView) void {
+    const attr_node: *const Attr = @ptrCast(@alignCast(attr));
+    out.* = zigStringToStringView(attr_node.name(), false);
+}
+
+/// Get localName as a string view (no copy)
+///
+/// WebIDL: `readonly attribute DOMString localName;`
+pub export fn dom_attr_get_localname_view(attr: *DOMAttr, out: *DOMStringView) void {
+    const attr_node: *const Attr = @ptrCast(@alignCast(attr));
+    out.* = zigStringToStringView(attr_node.local_name, false);
+}
+
+/// Get namespaceURI as a string view; false when it is null
+///
+/// WebIDL: `readonly attribute DOMString? namespaceURI;`
+pub export fn dom_attr_get_namespaceuri_view(attr: *DOMAttr, out: *DOMStringView) bool {
+    const attr_node: *const Attr = @ptrCast(@alignCast(attr));
+    const namespace_uri = attr_node.namespace_uri orelse return false;
+    out.* = zigStringToStringView(namespace_uri, false);
+    return true;
+}
+
+/// Get prefix as a string view; false when it is null
+///
+/// WebIDL: `readonly attribute DOMString? prefix;`
+pub export fn dom_attr_get_prefix_view(attr: *DOMAttr, out: *DOMStringView) bool {
+    const attr_node: *const Attr = @ptrCast(@alignCast(attr));
+    const prefix = attr_node.prefix orelse return false;
+    out.* = zigStringToStringView(prefix, false);
+    return true;
+}
+
+/// Get value as a string view (no copy)
+///
+/// WebIDL: `[CEReactions] attribute DOMString value;`
+pub export fn dom_attr_get_value_view(attr: *DOMAttr, out: *DOMStringView) void {
+    const attr_node: *const Attr = @ptrCast(@alignCast(attr));
+    // An attached Attr reads its element, which is the source of truth
+    if (attr_node.owner_element) |owner| {
+        const live = if (attr_node.namespace_uri) |namespace_uri|
+            owner.attributes.getNS(attr_node.local_name, namespace_uri)
+        else
+            owner.getAttribute(attr_node.name());
+        if (live) |current| {
+            out.* = zigStringToStringView(current, false);
+            return;
+        }
+    }
+    out.* = zigStringToStringView(attr_node.value(), false);
+}
+
 // ============================================================================
 // Node API Delegation (Convenience Methods)
 // ============================================================================
@@ -36,19 +36,24 @@
 //!
 //! Spec reference: https://dom.spec.whatwg.org/#characterdata (WebIDL: dom.idl:430-438)
 //!
-//! ## Exported Functions (7 total)
+//! ## Exported Functions
 //!
 //! ### Properties
 //! - `dom_characterdata_get_data()` - Get text content
-//! - `dom_characterdata_set_data()` - Set text content
-//! - `dom_characterdata_get_length()` - Get text length
+//! - `dom_characterdata_set_data()` / `_set_data_n()` - Set text content
+//! - `dom_characterdata_get_length()` - Get text length (UTF-16 code units)
 //!
 //! ### Methods
-//! - `dom_characterdata_substringdata()` - Extract substring
-//! - `dom_characterdata_appenddata()` - Append text
-//! - `dom_characterdata_insertdata()` - Insert text at offset
+//! - `dom_characterdata_substringdata()` - Extract substring (as a view)
+//! - `dom_characterdata_appenddata()` / `_appenddata_n()` - Append text
+//! - `dom_characterdata_insertdata()` / `_insertdata_n()` - Insert text at offset
 //! - `dom_characterdata_deletedata()` - Delete text range
-//! - `dom_characterdata_replacedata()` - Replace text range
+//! - `dom_characterdata_replacedata()` / `_replacedata_n()` - Replace text range
+//!
+//! Offsets and counts are UTF-16 code units, as in JavaScript. Each node
+//! caches its UTF-16 length and last converted offset (see
+//! character_data.zig), so `length` and edits near the previous one don't
+//! rescan the data, and substringData returns a view instead of a copy.
 //!
 //! ## Note on Abstract Interface
 //!
@@ -166,16 +171,17 @@
 //! Accessing `data` field works identically for all three types.
 //!
 //! ### Error Handling
-//! - substringData: Returns empty string on error (index out of bounds)
-//! - Other methods: Return error code (0 = success, non-zero = DOM error)
+//! - Methods return an error code (0 = success, non-zero = DOM error)
 //! - Typical errors: IndexSizeError (offset > length)
 
 const std = @import("std");
 const types = @import("dom_types.zig");
 const dom = @import("dom");
 
+const Node = dom.Node;
 const Text = dom.Text;
 const Comment = dom.Comment;
+const character_data = dom.character_data;
 const ProcessingInstruction = dom.ProcessingInstruction;
 const DOMCharacterData = types.DOMText; // CharacterData is abstract, use Text as representative type
 
@@ -239,9 +245,13 @@ pub export fn dom_characterdata_get_data(cdata: *DOMCharacterData) [*:0]const u8
 /// dom_characterdata_set_data((DOMCharacterData*)text, "New content");
 /// ```
 pub export fn dom_characterdata_set_data(cdata: *DOMCharacterData, data: [*:0]const u8) c_int {
-    const text: *Text = @ptrCast(@alignCast(cdata));
-    const data_str = types.cStringToZigString(data);
-    text.prototype.setNodeValue(data_str) catch |err| {
+    return dom_characterdata_set_data_n(cdata, data, std.mem.len(data));
+}
+
+/// Sets the text content of a CharacterData node, with a length-carrying value
+pub export fn dom_characterdata_set_data_n(cdata: *DOMCharacterData, data: [*]const u8, data_len: usize) c_int {
+    const node: *Node = @ptrCast(@alignCast(cdata));
+    node.setNodeValue(types.cLenStringToZigString(data, data_len)) catch |err| {
         return @intFromEnum(types.zigErrorToDOMError(err));
     };
     return 0;
@@ -258,7 +268,8 @@ pub export fn dom_characterdata_set_data(cdata: *DOMCharacterData, data: [*:0]co
 /// - `cdata`: CharacterData handle
 ///
 /// ## Returns
-/// Length of text content in code units
+/// Length of text content in UTF-16 code units (cached on the node, so
+/// repeated reads don't rescan the data)
 ///
 /// ## Spec References
 /// - Attribute: https://dom.spec.whatwg.org/#dom-characterdata-length
@@ -270,13 +281,18 @@ pub export fn dom_characterdata_set_data(cdata: *DOMCharacterData, data: [*:0]co
 /// printf("Length: %u\n", len);
 /// ```
 pub export fn dom_characterdata_get_length(cdata: *DOMCharacterData) u32 {
-    const text: *const Text = @ptrCast(@alignCast(cdata));
-    return @intCast(text.length());
+    return switch (ownerOf(cdata)) {
+        inline else => |owner| @intCast(character_data.utf16Length(owner)),
+    };
 }
 
 // ============================================================================
 // Methods
 // ============================================================================
+//
+// Offsets and counts are UTF-16 code units, as in JavaScript; the node's
+// UTF-16 index converts them to byte offsets without rescanning the data
+// (see character_data.zig).
 
 /// Extracts a substring from the text content.
 ///
@@ -288,10 +304,12 @@ pub export fn dom_characterdata_get_length(cdata: *DOMCharacterData) u32 {
 /// ## Parameters
 /// - `cdata`: CharacterData handle
 /// - `offset`: Starting position (0-based)
-/// - `count`: Number of characters to extract
+/// - `count`: Number of code units to extract (clamped to the end)
+/// - `out`: Receives the substring, a view of the node's data (valid until
+///   the next mutation; nothing is copied)
 ///
 /// ## Returns
-/// Substring (borrowed string - do NOT free), or empty string on error
+/// 0 on success, error code on failure (IndexSizeError if offset > length)
 ///
 /// ## Spec References
 /// - Method: https://dom.spec.whatwg.org/#dom-characterdata-substringdata
@@ -300,22 +318,23 @@ pub export fn dom_characterdata_get_length(cdata: *DOMCharacterData) u32 {
 /// ## Example
 /// ```c
 /// // text.data = "Hello World"
-/// const char* sub = dom_characterdata_substringdata((DOMCharacterData*)text, 0, 5);
-/// printf("%s\n", sub); // "Hello"
+/// DOMStringView sub;
+/// dom_characterdata_substringdata((DOMCharacterData*)text, 0, 5, &sub);
+/// printf("%.*s\n", (int)sub.length, sub.data); // "Hello"
 /// ```
 pub export fn dom_characterdata_substringdata(
     cdata: *DOMCharacterData,
     offset: u32,
     count: u32,
-) [*:0]const u8 {
-    const text: *Text = @ptrCast(@alignCast(cdata));
-    const allocator = std.heap.page_allocator;
-    const result = text.substringData(allocator, offset, count) catch return "";
-    // WARNING: This leaks memory! For proper implementation, need to cache result
-    // For now, return empty string on error
-    _ = result;
-    // TODO: Implement proper substring caching or use arena allocator
-    return "";
+    out: *types.DOMStringView,
+) c_int {
+    const slice = switch (ownerOf(cdata)) {
+        inline else => |owner| character_data.sliceUtf16(owner, offset, count),
+    } catch |err| {
+        return @intFromEnum(types.zigErrorToDOMError(err));
+    };
+    out.* = types.zigStringToStringView(slice, false);
+    return 0;
 }
 
 /// Appends text to the end of the content.
@@ -343,12 +362,12 @@ pub export fn dom_characterdata_substringdata(
 /// // text.data = "Hello World"
 /// ```
 pub export fn dom_characterdata_appenddata(cdata: *DOMCharacterData, data: [*:0]const u8) c_int {
-    const text: *Text = @ptrCast(@alignCast(cdata));
-    const data_str = types.cStringToZigString(data);
-    text.appendData(data_str) catch |err| {
-        return @intFromEnum(types.zigErrorToDOMError(err));
-    };
-    return 0;
+    return dom_characterdata_appenddata_n(cdata, data, std.mem.len(data));
+}
+
+/// Appends text to the end of the content, with a length-carrying value
+pub export fn dom_characterdata_appenddata_n(cdata: *DOMCharacterData, data: [*]const u8, data_len: usize) c_int {
+    return replaceData(cdata, null, 0, types.cLenStringToZigString(data, data_len));
 }
 
 /// Inserts text at a specific position.
@@ -381,12 +400,17 @@ pub export fn dom_characterdata_insertdata(
     offset: u32,
     data: [*:0]const u8,
 ) c_int {
-    const text: *Text = @ptrCast(@alignCast(cdata));
-    const data_str = types.cStringToZigString(data);
-    text.insertData(offset, data_str) catch |err| {
-        return @intFromEnum(types.zigErrorToDOMError(err));
-    };
-    return 0;
+    return dom_characterdata_insertdata_n(cdata, offset, data, std.mem.len(data));
+}
+
+/// Inserts text at a specific position, with a length-carrying value
+pub export fn dom_characterdata_insertdata_n(
+    cdata: *DOMCharacterData,
+    offset: u32,
+    data: [*]const u8,
+    data_len: usize,
+) c_int {
+    return replaceData(cdata, offset, 0, types.cLenStringToZigString(data, data_len));
 }
 
 /// Deletes a range of text.
@@ -399,7 +423,7 @@ pub export fn dom_characterdata_insertdata(
 /// ## Parameters
 /// - `cdata`: CharacterData handle
 /// - `offset`: Starting position (0-based)
-/// - `count`: Number of characters to delete
+/// - `count`: Number of code units to delete (clamped to the end)
 ///
 /// ## Returns
 /// 0 on success, error code on failure (IndexSizeError if offset > length)
@@ -419,11 +443,7 @@ pub export fn dom_characterdata_deletedata(
     offset: u32,
     count: u32,
 ) c_int {
-    const text: *Text = @ptrCast(@alignCast(cdata));
-    text.deleteData(offset, count) catch |err| {
-        return @intFromEnum(types.zigErrorToDOMError(err));
-    };
-    return 0;
+    return replaceData(cdata, offset, count, "");
 }
 
 /// Replaces a range of text with new content.
@@ -436,7 +456,7 @@ pub export fn dom_characterdata_deletedata(
 /// ## Parameters
 /// - `cdata`: CharacterData handle
 /// - `offset`: Starting position (0-based)
-/// - `count`: Number of characters to replace
+/// - `count`: Number of code units to replace (clamped to the end)
 /// - `data`: New text to insert
 ///
 /// ## Returns
@@ -458,11 +478,35 @@ pub export fn dom_characterdata_replacedata(
     count: u32,
     data: [*:0]const u8,
 ) c_int {
-    const text: *Text = @ptrCast(@alignCast(cdata));
-    const data_str = types.cStringToZigString(data);
-    text.replaceData(offset, count, data_str) catch |err| {
-        return @intFromEnum(types.zigErrorToDOMError(err));
-    };
+    return dom_characterdata_replacedata_n(cdata, offset, count, data, std.mem.len(data));
+}
+
+/// Replaces a range of text with new content, with a length-carrying value
+pub export fn dom_characterdata_replacedata_n(
+    cdata: *DOMCharacterData,
+    offset: u32,
+    count: u32,
+    data: [*]const u8,
+    data_len: usize,
+) c_int {
+    return replaceData(cdata, offset, count, types.cLenStringToZigString(data, data_len));
+}
+
+/// The Text or Comment that stores a CharacterData node's data
+fn ownerOf(cdata: *DOMCharacterData) character_data.Owner {
+    return character_data.ownerOf(@ptrCast(@alignCast(cdata))).?;
+}
+
+/// "replace data" with UTF-16 offsets (a null offset is the end)
+fn replaceData(cdata: *DOMCharacterData, offset: ?u32, count: u32, data: []const u8) c_int {
+    switch (ownerOf(cdata)) {
+        inline else => |owner| {
+            const at = offset orelse character_data.utf16Length(owner);
+            character_data.replaceUtf16(owner, at, count, data) catch |err| {
+                return @intFromEnum(types.zigErrorToDOMError(err));
+            };
+        },
+    }
     return 0;
 }
 
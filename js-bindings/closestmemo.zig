@@ -0,0 +1,96 @@
+//! ClosestMemo C-ABI Bindings (non-standard)
+//!
+//! Exposes the closest() memo (closest_memo.zig) to bindings. Event
+//! delegation calls closest() with the same few selectors for every event
+//! target; a memo kept for one dispatch lets each listener's call stop at
+//! the first ancestor another call already answered. Answers are dropped
+//! automatically when the document's mutation version changes.
+//!
+//! ## Usage Example (C)
+//!
+//! ```c
+//! DOMClosestMemo* memo = dom_closestmemo_new();
+//! DOMSelector* sel = dom_selector_compile(doc, ".row", 4);
+//! DOMElement* row = dom_element_closest_memoized(target, memo, sel);
+//! dom_closestmemo_clear(memo);   // next dispatch
+//! dom_selector_release(sel);
+//! dom_closestmemo_release(memo);
+//! ```
+//!
+//! ## Exported Functions
+//! - dom_closestmemo_new() - Create an empty memo
+//! - dom_closestmemo_clear() - Forget every answer
+//! - dom_closestmemo_count() - Number of remembered answers
+//! - dom_closestmemo_release() - Release the memo
+//! - dom_element_closest_memoized() - closest() through a memo
+
+const std = @import("std");
+const dom = @import("dom");
+const Element = dom.Element;
+const ClosestMemo = dom.ClosestMemo;
+const dom_types = @import("dom_types.zig");
+
+pub const DOMElement = dom_types.DOMElement;
+pub const DOMSelector = dom_types.DOMSelector;
+pub const DOMClosestMemo = dom_types.DOMClosestMemo;
+
+fn memoOf(handle: *DOMClosestMemo) *ClosestMemo {
+    return @ptrCast(@alignCast(handle));
+}
+
+/// Create an empty closest() memo.
+///
+/// ## Returns
+/// Memo handle, or NULL if it could not be allocated
+pub export fn dom_closestmemo_new() ?*DOMClosestMemo {
+    const memo = std.heap.c_allocator.create(ClosestMemo) catch return null;
+    memo.* = ClosestMemo.init(std.heap.c_allocator);
+    return @ptrCast(memo);
+}
+
+/// Forget every answer and release the memo's selector references.
+///
+/// ## Parameters
+/// - `memo`: ClosestMemo handle
+pub export fn dom_closestmemo_clear(memo: *DOMClosestMemo) void {
+    memoOf(memo).clear();
+}
+
+/// Get the number of remembered answers.
+///
+/// ## Parameters
+/// - `memo`: ClosestMemo handle
+pub export fn dom_closestmemo_count(memo: *DOMClosestMemo) u32 {
+    return @intCast(memoOf(memo).count());
+}
+
+/// Release a ClosestMemo.
+///
+/// ## Parameters
+/// - `memo`: ClosestMemo handle
+pub export fn dom_closestmemo_release(memo: *DOMClosestMemo) void {
+    const self = memoOf(memo);
+    self.deinit();
+    std.heap.c_allocator.destroy(self);
+}
+
+/// closest() with a selector from dom_selector_compile(), answered from
+/// and recorded in `memo`.
+///
+/// ## Parameters
+/// - `handle`: Element to start from
+/// - `memo`: ClosestMemo handle
+/// - `selector`: Compiled selector (the memo takes its own reference)
+///
+/// ## Returns
+/// Closest inclusive ancestor matching the selector, or NULL
+pub export fn dom_element_closest_memoized(handle: *DOMElement, memo: *DOMClosestMemo, selector: *DOMSelector) ?*DOMElement {
+    const element: *Element = @ptrCast(@alignCast(handle));
+    const parsed: *dom.ParsedSelector = @ptrCast(@alignCast(selector));
+
+    const result = memoOf(memo).closest(element, parsed) catch {
+        return null; // On error, return null
+    };
+
+    return if (result) |elem| @ptrCast(elem) else null;
+}
@@ -0,0 +1,257 @@
+//! CustomElementRegistry C-ABI Bindings
+//!
+//! Provides C-compatible bindings for the CustomElementRegistry interface.
+//! A definition's lifecycle callbacks are C function pointers sharing one
+//! embedder context (for a script engine: the constructor and its
+//! prototype's callbacks).
+//!
+//! Definitions are looked up by the interned local name of each new element,
+//! so createElement() pays one pointer hash whatever the number of
+//! definitions. Upgrades of existing elements are custom element reactions:
+//! define() and upgrade() enqueue one per element and run them in a single
+//! pass before returning, calling the constructor once per element.
+//!
+//! ## Exported Functions
+//! - dom_document_get_customelementregistry() - Get (or create) the registry
+//! - dom_element_get_customelementregistry() - Registry of an element's document
+//! - dom_customelementregistry_define() - Define a custom element
+//! - dom_customelementregistry_get() - Get the context of a definition
+//! - dom_customelementregistry_upgrade() - Upgrade the elements of a tree
+//! - dom_element_get_customelementcontext() - Context of a custom element's definition
+
+const std = @import("std");
+const dom = @import("dom");
+const Document = dom.Document;
+const Element = dom.Element;
+const Node = dom.Node;
+const CustomElementRegistry = dom.CustomElementRegistry;
+const CustomElementCallbacks = dom.CustomElementCallbacks;
+const dom_types = @import("dom_types.zig");
+const DOMStringView = dom_types.DOMStringView;
+const elementStringView = @import("element.zig").elementStringView;
+
+pub const DOMCustomElementRegistry = dom_types.DOMCustomElementRegistry;
+pub const DOMElement = dom_types.DOMElement;
+pub const DOMDocument = dom_types.DOMDocument;
+pub const DOMNode = dom_types.DOMNode;
+
+/// Lifecycle callbacks of a definition (see dom.h). Every callback may be
+/// NULL; each receives `context`.
+pub const DOMCustomElementCallbacks = extern struct {
+    context: ?*anyopaque,
+    constructor: ?*const fn (element: *DOMElement, context: ?*anyopaque) callconv(.c) c_int,
+    connected: ?*const fn (element: *DOMElement, context: ?*anyopaque) callconv(.c) void,
+    disconnected: ?*const fn (element: *DOMElement, context: ?*anyopaque) callconv(.c) void,
+    adopted: ?*const fn (
+        element: *DOMElement,
+        old_document: *DOMDocument,
+        new_document: *DOMDocument,
+        context: ?*anyopaque,
+    ) callconv(.c) void,
+    attribute_changed: ?*const fn (
+        element: *DOMElement,
+        name: *const DOMStringView,
+        old_value: ?*const DOMStringView,
+        new_value: ?*const DOMStringView,
+        namespace_uri: ?*const DOMStringView,
+        context: ?*anyopaque,
+    ) callconv(.c) void,
+    release: ?*const fn (context: ?*anyopaque) callconv(.c) void,
+};
+
+/// Copy of the C callbacks, installed as the Zig definition's context.
+const Host = struct {
+    callbacks: DOMCustomElementCallbacks,
+
+    fn of(element: *Element) *const DOMCustomElementCallbacks {
+        const context = element.getCustomElementDefinition().?.callbacks.context;
+        const host: *const Host = @ptrCast(@alignCast(context.?));
+        return &host.callbacks;
+    }
+
+    fn release(context: ?*anyopaque) void {
+        const host: *Host = @ptrCast(@alignCast(context.?));
+        if (host.callbacks.release) |callback| callback(host.callbacks.context);
+        std.heap.c_allocator.destroy(host);
+    }
+
+    fn construct(element: *Element, allocator: std.mem.Allocator) anyerror!void {
+        _ = allocator;
+        const c = of(element);
+        if (c.constructor.?(@ptrCast(element), c.context) != 0) return error.ConstructorThrew;
+    }
+
+    fn connected(element: *Element) anyerror!void {
+        const c = of(element);
+        c.connected.?(@ptrCast(element), c.context);
+    }
+
+    fn disconnected(element: *Element) anyerror!void {
+        const c = of(element);
+        c.disconnected.?(@ptrCast(element), c.context);
+    }
+
+    fn adopted(element: *Element, old_document: *Document, new_document: *Document) anyerror!void {
+        const c = of(element);
+        c.adopted.?(@ptrCast(element), @ptrCast(old_document), @ptrCast(new_document), c.context);
+    }
+
+    fn attributeChanged(
+        element: *Element,
+        name: []const u8,
+        old_value: ?[]const u8,
+        new_value: ?[]const u8,
+        namespace_uri: ?[]const u8,
+    ) anyerror!void {
+        const c = of(element);
+        const name_view = elementStringView(element, name);
+        const old_view = if (old_value) |v| elementStringView(element, v) else undefined;
+        const new_view = if (new_value) |v| elementStringView(element, v) else undefined;
+        const ns_view = if (namespace_uri) |v| elementStringView(element, v) else undefined;
+        c.attribute_changed.?(
+            @ptrCast(element),
+            &name_view,
+            if (old_value != null) &old_view else null,
+            if (new_value != null) &new_view else null,
+            if (namespace_uri != null) &ns_view else null,
+            c.context,
+        );
+    }
+
+    /// Zig callbacks forwarding to the non-NULL C callbacks
+    fn callbacksFor(self: *Host) CustomElementCallbacks {
+        const c = &self.callbacks;
+        return .{
+            .context = self,
+            .release_context = release,
+            .constructor_fn = if (c.constructor != null) construct else null,
+            .connected_callback = if (c.connected != null) connected else null,
+            .disconnected_callback = if (c.disconnected != null) disconnected else null,
+            .adopted_callback = if (c.adopted != null) adopted else null,
+            .attribute_changed_callback = if (c.attribute_changed != null) attributeChanged else null,
+        };
+    }
+};
+
+/// Get the custom element registry of a document (window.customElements),
+/// creating it on first use. The document owns it.
+///
+/// ## Returns
+/// Registry handle, or NULL if it could not be allocated
+pub export fn dom_document_get_customelementregistry(handle: *DOMDocument) ?*DOMCustomElementRegistry {
+    const doc: *Document = @ptrCast(@alignCast(handle));
+    const registry = doc.getCustomElementRegistry() catch return null;
+    return @ptrCast(registry);
+}
+
+/// Get customElementRegistry attribute
+///
+/// WebIDL: `readonly attribute CustomElementRegistry? customElementRegistry;`
+///
+/// The registry of the element's node document, or NULL if that document
+/// never created one.
+pub export fn dom_element_get_customelementregistry(handle: *DOMElement) ?*DOMCustomElementRegistry {
+    const element: *const Element = @ptrCast(@alignCast(handle));
+    const owner = element.prototype.owner_document orelse return null;
+    if (owner.node_type != .document) return null;
+    const doc: *Document = @fieldParentPtr("prototype", owner);
+    return @ptrCast(doc.custom_element_registry orelse return null);
+}
+
+/// Define a custom element.
+///
+/// WebIDL: `[CEReactions] undefined define(DOMString name, CustomElementConstructor constructor, optional ElementDefinitionOptions options = {});`
+///
+/// The callbacks are copied. On success the registry owns `callbacks.context`
+/// and calls `callbacks.release` when the document is destroyed; on failure
+/// the caller keeps it. Existing elements with the name are upgraded before
+/// this returns.
+///
+/// ## Parameters
+/// - `name`: Custom element name
+/// - `callbacks`: Lifecycle callbacks
+/// - `observed_attributes`: Names for attribute_changed (may be NULL when count is 0)
+/// - `observed_count`: Number of observed attributes
+///
+/// ## Returns
+/// 0 on success, SyntaxError (12) for an invalid or reserved name,
+/// NotSupportedError (9) if the name is defined or define() is running
+pub export fn dom_customelementregistry_define(
+    handle: *DOMCustomElementRegistry,
+    name: [*:0]const u8,
+    callbacks: *const DOMCustomElementCallbacks,
+    observed_attributes: ?[*]const [*:0]const u8,
+    observed_count: u32,
+) c_int {
+    const registry: *CustomElementRegistry = @ptrCast(@alignCast(handle));
+    const allocator = std.heap.c_allocator;
+    const name_slice = std.mem.span(name);
+
+    const observed = allocator.alloc([]const u8, observed_count) catch {
+        return @intFromEnum(dom_types.DOMErrorCode.QuotaExceededError);
+    };
+    defer allocator.free(observed);
+    for (observed, 0..) |*slot, i| slot.* = std.mem.span(observed_attributes.?[i]);
+
+    const host = allocator.create(Host) catch {
+        return @intFromEnum(dom_types.DOMErrorCode.QuotaExceededError);
+    };
+    host.* = .{ .callbacks = callbacks.* };
+
+    registry.define(name_slice, host.callbacksFor(), .{ .observed_attributes = observed }) catch |err| {
+        // Registered before failing (upgrades could not be enqueued): the
+        // registry owns the host now
+        const owned = if (registry.get(name_slice)) |definition|
+            definition.callbacks.context == @as(?*anyopaque, host)
+        else
+            false;
+        if (!owned) allocator.destroy(host);
+
+        return switch (err) {
+            error.InvalidCustomElementName, error.ReservedCustomElementName => @intFromEnum(dom_types.DOMErrorCode.SyntaxError),
+            error.CustomElementAlreadyDefined, error.RegistryDefinitionRunning => @intFromEnum(dom_types.DOMErrorCode.NotSupportedError),
+            else => @intFromEnum(dom_types.zigErrorToDOMError(err)),
+        };
+    };
+    return 0;
+}
+
+/// Get the context a name was defined with.
+///
+/// WebIDL: `(CustomElementConstructor or undefined) get(DOMString name);`
+///
+/// ## Returns
+/// `callbacks.context` of the definition, or NULL if the name is not defined
+pub export fn dom_customelementregistry_get(handle: *DOMCustomElementRegistry, name: [*:0]const u8) ?*anyopaque {
+    const registry: *CustomElementRegistry = @ptrCast(@alignCast(handle));
+    const definition = registry.get(std.mem.span(name)) orelse return null;
+    const host: *const Host = @ptrCast(@alignCast(definition.callbacks.context.?));
+    return host.callbacks.context;
+}
+
+/// Upgrade the undefined elements of a tree whose names are defined.
+///
+/// WebIDL: `[CEReactions] undefined upgrade(Node root);`
+///
+/// ## Returns
+/// 0 on success, or an error code if the upgrades could not be enqueued
+pub export fn dom_customelementregistry_upgrade(handle: *DOMCustomElementRegistry, root: *DOMNode) c_int {
+    const registry: *CustomElementRegistry = @ptrCast(@alignCast(handle));
+    const node: *Node = @ptrCast(@alignCast(root));
+    registry.upgrade(node) catch |err| return @intFromEnum(dom_types.zigErrorToDOMError(err));
+    return 0;
+}
+
+/// Get the context of a custom element's definition.
+///
+/// Lets bindings give a new wrapper of an upgraded element its class again.
+///
+/// ## Returns
+/// `callbacks.context` of the definition if the element is "custom", else NULL
+pub export fn dom_element_get_customelementcontext(handle: *DOMElement) ?*anyopaque {
+    const element: *const Element = @ptrCast(@alignCast(handle));
+    if (!element.isCustomElement()) return null;
+    const definition = element.getCustomElementDefinition() orelse return null;
+    const host: *const Host = @ptrCast(@alignCast(definition.callbacks.context orelse return null));
+    return host.callbacks.context;
+}
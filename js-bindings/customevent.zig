@@ -94,8 +94,12 @@ const dom = @import("dom");
 const Event = dom.Event;
 const CustomEvent = dom.CustomEvent;
 const CustomEventInit = dom.CustomEventInit;
+const PooledEvent = dom.PooledEvent;
 const DOMCustomEvent = types.DOMCustomEvent;
 
+/// CustomEvents share the Event records (and pool) of event.zig
+const event_bindings = @import("event.zig");
+
 // ============================================================================
 // Constructor
 // ============================================================================
@@ -115,7 +119,7 @@ const DOMCustomEvent = types.DOMCustomEvent;
 /// - `detail`: Optional pointer to custom data (borrowed - must outlive event)
 ///
 /// ## Returns
-/// Heap-allocated CustomEvent pointer, or NULL on allocation failure
+/// CustomEvent pointer with one reference, or NULL on allocation failure
 /// - **IMPORTANT**: Caller must call `dom_customevent_release()` to free
 /// - **IMPORTANT**: `detail` pointer is borrowed - caller must keep data alive
 ///
@@ -165,26 +169,15 @@ pub export fn dom_customevent_new(
     composed: u8,
     detail: ?*anyopaque,
 ) ?*DOMCustomEvent {
-    const allocator = std.heap.page_allocator;
-    const type_str = types.cStringToZigString(event_type);
-
-    // Duplicate the string so it persists (event stores pointer, not copy)
-    const type_copy = allocator.dupeZ(u8, type_str) catch return null;
-
-    const event_ptr = allocator.create(CustomEvent) catch {
-        allocator.free(type_copy);
-        return null;
-    };
-    event_ptr.* = CustomEvent.init(type_copy, .{
+    const record = event_bindings.event_pool.acquire(types.cStringToZigString(event_type), .{
         .event_options = .{
             .bubbles = bubbles != 0,
             .cancelable = cancelable != 0,
             .composed = composed != 0,
         },
         .detail = if (detail) |d| @ptrCast(d) else null,
-    });
-
-    return @ptrCast(event_ptr);
+    }) catch return null;
+    return @ptrCast(record.customEvent());
 }
 
 // ============================================================================
@@ -261,7 +254,11 @@ pub export fn dom_customevent_initcustomevent(
     detail: ?*anyopaque,
 ) void {
     const evt: *CustomEvent = @ptrCast(@alignCast(event));
-    const event_type = types.cStringToZigString(type_str);
+    if (evt.event.dispatch_flag) return;
+
+    // Keep a copy: the caller's string may not outlive the event
+    const record = PooledEvent.fromEvent(&evt.event);
+    const event_type = record.storeType(event_bindings.event_pool.allocator, types.cStringToZigString(type_str)) catch return;
     const bubbles_bool = (bubbles != 0);
     const cancelable_bool = (cancelable != 0);
     evt.initCustomEvent(event_type, bubbles_bool, cancelable_bool, detail);
@@ -278,29 +275,18 @@ pub export fn dom_customevent_initcustomevent(
 /// ## Parameters
 /// - `event`: CustomEvent handle
 pub export fn dom_customevent_addref(event: *DOMCustomEvent) void {
-    const allocator = std.heap.page_allocator;
-    // CustomEvents are value types in Zig, in C-ABI we heap-allocate
-    // For now, this is a no-op as events are typically short-lived
-    _ = event;
-    _ = allocator;
+    const evt: *CustomEvent = @ptrCast(@alignCast(event));
+    event_bindings.event_pool.retain(PooledEvent.fromEvent(&evt.event));
 }
 
 /// Decrement the reference count of a CustomEvent.
 ///
-/// When count reaches 0, frees the event.
+/// When count reaches 0, the event returns to the event pool (or is freed
+/// when the pool is full or disabled).
 ///
 /// ## Parameters
 /// - `event`: CustomEvent handle
-///
-/// ## Note
-/// This currently leaks the event_type string. TODO: Track string ownership.
 pub export fn dom_customevent_release(event: *DOMCustomEvent) void {
-    const allocator = std.heap.page_allocator;
     const evt: *CustomEvent = @ptrCast(@alignCast(event));
-
-    // TODO: Free the event_type string (requires tracking ownership)
-    // For now, we leak it to avoid alignment issues
-
-    // Free the CustomEvent struct
-    allocator.destroy(evt);
+    event_bindings.event_pool.release(PooledEvent.fromEvent(&evt.event));
 }
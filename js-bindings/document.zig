@@ -4,12 +4,14 @@
 
 const std = @import("std");
 const dom_types = @import("dom_types.zig");
+const nodefilter = @import("nodefilter.zig");
 const DOMErrorCode = dom_types.DOMErrorCode;
 const zigErrorToDOMError = dom_types.zigErrorToDOMError;
 const zigStringToCString = dom_types.zigStringToCString;
 const zigStringToCStringOptional = dom_types.zigStringToCStringOptional;
 const cStringToZigString = dom_types.cStringToZigString;
 const cStringToZigStringOptional = dom_types.cStringToZigStringOptional;
+const cLenStringToZigString = dom_types.cLenStringToZigString;
 
 // Import opaque types from dom_types
 pub const DOMDocument = dom_types.DOMDocument;
@@ -24,17 +26,20 @@ pub const DOMDocumentFragment = dom_types.DOMDocumentFragment;
 pub const DOMDocumentType = dom_types.DOMDocumentType;
 pub const DOMDOMImplementation = dom_types.DOMDOMImplementation;
 pub const DOMRange = dom_types.DOMRange;
+pub const DOMNodeIterator = dom_types.DOMNodeIterator;
+pub const DOMTreeWalker = dom_types.DOMTreeWalker;
+pub const DOMNodeFilter = dom_types.DOMNodeFilter;
+pub const DOMElementFilter = dom_types.DOMElementFilter;
+pub const DOMSharedNames = dom_types.DOMSharedNames;
 
 // Forward declarations for types not yet in dom_types
 pub const DOMHTMLCollection = opaque {};
-pub const DOMNodeIterator = opaque {};
 pub const DOMEvent = opaque {};
-pub const DOMTreeWalker = opaque {};
-pub const DOMNodeFilter = opaque {};
 
 // Import actual DOM implementation
 const dom = @import("dom");
 const Document = dom.Document;
+const SharedNames = dom.SharedNames;
 const Element = dom.Element;
 const Node = dom.Node;
 const Text = dom.Text;
@@ -422,6 +427,270 @@ pub export fn dom_document_getelementsbyclassname(handle: *DOMDocument, classNam
     return @ptrCast(collection_ptr);
 }
 
+/// Enable the document's class token index.
+///
+/// Once enabled, live document-wide getElementsByClassName collections
+/// answer `length` and `item()` from the index instead of walking the tree.
+/// Calling it again does nothing.
+///
+/// ## Returns
+/// 0 on success, error code on failure
+pub export fn dom_document_enable_class_index(handle: *DOMDocument) c_int {
+    const doc: *Document = @ptrCast(@alignCast(handle));
+    doc.enableClassIndex() catch |err| {
+        return @intFromEnum(zigErrorToDOMError(err));
+    };
+    return 0;
+}
+
+/// Enable structural hashes for the document's nodes.
+///
+/// Once enabled, dom_node_get_structural_hash caches each node's hash until
+/// its subtree changes, and dom_node_isequalnode returns 0 on a hash
+/// mismatch without comparing the subtrees. Calling it again does nothing.
+///
+/// ## Returns
+/// 0 on success, error code on failure
+pub export fn dom_document_enable_structural_hashes(handle: *DOMDocument) c_int {
+    const doc: *Document = @ptrCast(@alignCast(handle));
+    doc.enableStructuralHashes() catch |err| {
+        return @intFromEnum(zigErrorToDOMError(err));
+    };
+    return 0;
+}
+
+/// Enable the document's matches() cache.
+///
+/// Once enabled, dom_element_matches and dom_element_matches_compiled
+/// remember each element's last answers per selector, so repeated checks
+/// on unchanged elements skip matching (see
+/// dom_document_get_match_cache_stats). Calling it again does nothing.
+///
+/// ## Returns
+/// 0 on success, error code on failure
+pub export fn dom_document_enable_match_cache(handle: *DOMDocument) c_int {
+    const doc: *Document = @ptrCast(@alignCast(handle));
+    doc.enableMatchCache() catch |err| {
+        return @intFromEnum(zigErrorToDOMError(err));
+    };
+    return 0;
+}
+
+/// Enable the document's document order index.
+///
+/// Once enabled, compareDocumentPosition, contains and Range comparisons
+/// between nodes of the document tree answer from a lazily built preorder
+/// numbering instead of walking ancestor chains. Calling it again does
+/// nothing.
+///
+/// ## Returns
+/// 0 on success, error code on failure
+pub export fn dom_document_enable_document_order_index(handle: *DOMDocument) c_int {
+    const doc: *Document = @ptrCast(@alignCast(handle));
+    doc.enableDocumentOrderIndex() catch |err| {
+        return @intFromEnum(zigErrorToDOMError(err));
+    };
+    return 0;
+}
+
+/// Let textContent reuse a sole Text child of the document's nodes.
+///
+/// Not spec-conformant: once enabled, a non-empty textContent replaces the
+/// data of a node's only Text child in place, so observers get one
+/// characterData record instead of a childList record. Calling it again
+/// does nothing.
+pub export fn dom_document_enable_inplace_textcontent(handle: *DOMDocument) void {
+    const doc: *Document = @ptrCast(@alignCast(handle));
+    doc.enableInPlaceTextContent();
+}
+
+/// Begin a mutation batch (batches nest).
+///
+/// Until the matching dom_document_end_batch(), mutation records are
+/// coalesced for every observer of the document and class index upkeep is
+/// deferred to the end of the batch.
+pub export fn dom_document_begin_batch(handle: *DOMDocument) void {
+    const doc: *Document = @ptrCast(@alignCast(handle));
+    doc.beginBatch();
+}
+
+/// End a mutation batch started with dom_document_begin_batch().
+///
+/// ## Returns
+/// 0 on success, DOM_ERROR_INVALID_STATE if no batch is open
+pub export fn dom_document_end_batch(handle: *DOMDocument) c_int {
+    const doc: *Document = @ptrCast(@alignCast(handle));
+    doc.endBatch() catch |err| {
+        return @intFromEnum(zigErrorToDOMError(err));
+    };
+    return 0;
+}
+
+/// Apply a binary patch (the dom_node_diff() format) in one call.
+///
+/// See src/tree_diff.zig for the layout and tree_diff.replay() for the
+/// semantics: `target` and `before` index `targets`, `source` and
+/// `before_source` index `sources`, and inserted nodes are copies of their
+/// sources. The ops run inside one mutation batch.
+///
+/// ## Returns
+/// 0 on success, DOM_ERROR_SYNTAX if `bytes` is not a valid patch,
+/// DOM_ERROR_INDEX_SIZE if an index is outside its table, or the error of
+/// the first failing op (the ops before it stay applied)
+pub export fn dom_document_apply_patch(
+    handle: *DOMDocument,
+    bytes: [*]const u8,
+    length: usize,
+    targets: [*]const *dom_types.DOMNode,
+    target_count: usize,
+    sources: ?[*]const *dom_types.DOMNode,
+    source_count: usize,
+) c_int {
+    const doc: *Document = @ptrCast(@alignCast(handle));
+    const allocator = std.heap.c_allocator;
+
+    // Records are read in place; copy buffers that are not 4-byte aligned
+    var copy: ?[]align(4) u8 = null;
+    defer if (copy) |buffer| allocator.free(buffer);
+    const buffer: []align(4) const u8 = if (std.mem.isAligned(@intFromPtr(bytes), 4))
+        @alignCast(bytes[0..length])
+    else blk: {
+        copy = allocator.alignedAlloc(u8, dom.tree_diff.buffer_alignment, length) catch {
+            return @intFromEnum(DOMErrorCode.QuotaExceededError);
+        };
+        @memcpy(copy.?, bytes[0..length]);
+        break :blk copy.?;
+    };
+
+    const target_nodes: []const *Node = @ptrCast(targets[0..target_count]);
+    const source_nodes: []const *Node = if (sources) |s| @ptrCast(s[0..source_count]) else &.{};
+    dom.tree_diff.validate(buffer) catch |err| {
+        return @intFromEnum(zigErrorToDOMError(err));
+    };
+    dom.tree_diff.replay(allocator, doc, buffer, target_nodes, source_nodes) catch |err| {
+        return @intFromEnum(zigErrorToDOMError(err));
+    };
+    return 0;
+}
+
+/// Queue a patch for the thread that owns the document
+///
+/// Callable from any thread. The patch and both node tables are copied;
+/// the nodes must stay alive until the patch is drained. See
+/// Document.submitPatch().
+///
+/// ## Returns
+/// 0 on success, DOM_ERROR_SYNTAX if `bytes` is not a valid patch, or
+/// DOM_ERROR_QUOTA_EXCEEDED if the copy could not be allocated.
+/// `should_wake` (optional) is set to 1 if the queue was empty.
+pub export fn dom_document_submit_patch(
+    handle: *DOMDocument,
+    bytes: [*]const u8,
+    length: usize,
+    targets: [*]const *dom_types.DOMNode,
+    target_count: usize,
+    sources: ?[*]const *dom_types.DOMNode,
+    source_count: usize,
+    should_wake: ?*u8,
+) c_int {
+    const doc: *Document = @ptrCast(@alignCast(handle));
+    const target_nodes: []const *Node = @ptrCast(targets[0..target_count]);
+    const source_nodes: []const *Node = if (sources) |s| @ptrCast(s[0..source_count]) else &.{};
+    const first = doc.submitPatch(std.heap.c_allocator, bytes[0..length], target_nodes, source_nodes) catch |err| {
+        return @intFromEnum(zigErrorToDOMError(err));
+    };
+    if (should_wake) |wake| wake.* = @intFromBool(first);
+    return 0;
+}
+
+/// Apply every patch submitted with dom_document_submit_patch()
+///
+/// Owning thread only. Patches run in submission order inside one
+/// mutation batch; a failing patch stops at its failing op and the rest
+/// still run.
+///
+/// ## Returns
+/// Number of patches drained. `first_error` (optional) gets the DOM
+/// error code of the first failing patch, or 0.
+pub export fn dom_document_drain_patches(handle: *DOMDocument, first_error: ?*c_int) usize {
+    const doc: *Document = @ptrCast(@alignCast(handle));
+    const result = doc.drainPatches(std.heap.c_allocator);
+    if (first_error) |code| {
+        code.* = if (result.first_error) |err| @intFromEnum(zigErrorToDOMError(err)) else 0;
+    }
+    return result.drained;
+}
+
+/// Bring the document's enabled lazy indices up to date for up to
+/// `budget_ns` nanoseconds.
+///
+/// Meant for the embedder's idle callbacks (e.g. V8 idle tasks). Each call
+/// resumes where the previous one stopped, most needed index first (class
+/// index, compact layout, document order index, structural hashes), so
+/// queries find them built instead of rebuilding them on first use.
+///
+/// ## Returns
+/// 1 if work remains for another call, 0 once every index is current (or
+/// if an index could not be allocated; its next query rebuilds it)
+pub export fn dom_document_run_idle_work(handle: *DOMDocument, budget_ns: u64) u8 {
+    const doc: *Document = @ptrCast(@alignCast(handle));
+    const more = doc.runIdleWork(budget_ns) catch return 0;
+    return @intFromBool(more);
+}
+
+/// Check whether dom_document_run_idle_work() has work to do.
+///
+/// ## Returns
+/// 1 if an enabled index is out of date, 0 otherwise
+pub export fn dom_document_has_idle_work(handle: *DOMDocument) u8 {
+    const doc: *const Document = @ptrCast(@alignCast(handle));
+    return @intFromBool(doc.hasIdleWork());
+}
+
+/// Make the document immutable, for concurrent read-only queries.
+///
+/// Builds the enabled lazy indices; afterwards mutations and node creation
+/// fail with DOM_ERROR_NO_MODIFICATION_ALLOWED, and
+/// dom_document_queryselectorall(), dom_document_queryselectorall_many()
+/// and dom_element_matches() may be called from several threads at once.
+///
+/// ## Returns
+/// 0 on success, DOM_ERROR_INVALID_STATE if a batch is open
+pub export fn dom_document_freeze(handle: *DOMDocument) c_int {
+    const doc: *Document = @ptrCast(@alignCast(handle));
+    doc.freeze() catch |err| {
+        return @intFromEnum(zigErrorToDOMError(err));
+    };
+    return 0;
+}
+
+/// Let a frozen document be referenced from several threads at once.
+///
+/// Afterwards dom_node_addref(), dom_node_release() and the document's
+/// addref and release are atomic for its nodes, and their wrapper slots
+/// are claimed, so one JS engine isolate per thread can wrap the same
+/// tree. Nodes of unshared documents keep plain reference counting.
+///
+/// ## Returns
+/// 0 on success, DOM_ERROR_INVALID_STATE if the document is not frozen
+pub export fn dom_document_share(handle: *DOMDocument) c_int {
+    const doc: *Document = @ptrCast(@alignCast(handle));
+    doc.share() catch |err| {
+        return @intFromEnum(zigErrorToDOMError(err));
+    };
+    return 0;
+}
+
+/// Get the document's mutation version.
+///
+/// The value changes whenever a child list or attribute of a node owned by
+/// the document changes, so bindings can keep a copy of a live collection
+/// and refill it only when this differs from the version they copied at.
+pub export fn dom_document_get_mutation_version(handle: *DOMDocument) u64 {
+    const doc: *const Document = @ptrCast(@alignCast(handle));
+    return doc.mutation_version;
+}
+
 /// Get element by ID.
 ///
 /// ## WebIDL
@@ -457,8 +726,13 @@ pub export fn dom_document_getelementsbyclassname(handle: *DOMDocument, classNam
 /// }
 /// ```
 pub export fn dom_document_getelementbyid(handle: *DOMDocument, elementId: [*:0]const u8) ?*DOMElement {
+    return dom_document_getelementbyid_n(handle, elementId, std.mem.len(elementId));
+}
+
+/// getElementById method, with a length-carrying id
+pub export fn dom_document_getelementbyid_n(handle: *DOMDocument, elementId: [*]const u8, elementId_len: usize) ?*DOMElement {
     const doc: *Document = @ptrCast(@alignCast(handle));
-    const id = cStringToZigString(elementId);
+    const id = cLenStringToZigString(elementId, elementId_len);
     const elem_opt = doc.getElementById(id);
     if (elem_opt) |elem| {
         return @ptrCast(elem);
@@ -475,14 +749,32 @@ pub export fn dom_document_getelementbyid(handle: *DOMDocument, elementId: [*:0]
 ///
 /// WebIDL: `Element createElement(DOMString localName);`
 pub export fn dom_document_createelement(handle: *DOMDocument, localName: [*:0]const u8) *DOMElement {
+    return dom_document_createelement_n(handle, localName, std.mem.len(localName));
+}
+
+/// createElement method, with a length-carrying name
+pub export fn dom_document_createelement_n(handle: *DOMDocument, localName: [*]const u8, localName_len: usize) *DOMElement {
     const doc: *Document = @ptrCast(@alignCast(handle));
-    const name = cStringToZigString(localName);
+    const name = cLenStringToZigString(localName, localName_len);
     const elem = doc.createElement(name) catch {
         @panic("createElement failed - cannot return error via C-ABI");
     };
     return @ptrCast(elem);
 }
 
+/// Intern a tag or attribute name in the document's string pool
+///
+/// The returned atom is valid until the document is destroyed; the
+/// element *_atom functions compare it by pointer.
+///
+/// ## Returns
+/// Interned, null-terminated copy of the name, or null on allocation failure
+pub export fn dom_document_intern_name(handle: *DOMDocument, name: [*]const u8, name_len: usize) ?[*:0]const u8 {
+    const doc: *Document = @ptrCast(@alignCast(handle));
+    const interned = doc.string_pool.internName(cLenStringToZigString(name, name_len)) catch return null;
+    return @ptrCast(interned.ptr);
+}
+
 // SKIPPED: createElementNS() - Contains complex types not supported in C-ABI v1
 // WebIDL: Element createElementNS(DOMString namespace, DOMString qualifiedName, (DOMString or ElementCreationOptions) options);
 // Reason: Union type '(DOMString or ElementCreationOptions)'
@@ -514,8 +806,13 @@ export fn dom_document_createdocumentfragment(handle: *DOMDocument) *DOMDocument
 ///
 /// WebIDL: `Text createTextNode(DOMString data);`
 pub export fn dom_document_createtextnode(handle: *DOMDocument, data: [*:0]const u8) *DOMText {
+    return dom_document_createtextnode_n(handle, data, std.mem.len(data));
+}
+
+/// createTextNode method, with length-carrying data
+pub export fn dom_document_createtextnode_n(handle: *DOMDocument, data: [*]const u8, data_len: usize) *DOMText {
     const doc: *Document = @ptrCast(@alignCast(handle));
-    const text_data = cStringToZigString(data);
+    const text_data = cLenStringToZigString(data, data_len);
     const text_node = doc.createTextNode(text_data) catch {
         @panic("createTextNode failed - cannot return error via C-ABI");
     };
@@ -758,14 +1055,30 @@ pub export fn dom_document_createrange(handle: *DOMDocument) *DOMRange {
 /// createNodeIterator method
 ///
 /// WebIDL: `NodeIterator createNodeIterator(Node root, unsigned long whatToShow, NodeFilter filter);`
-export fn dom_document_createnodeiterator(handle: *DOMDocument, root: *DOMNode, whatToShow: u32, filter: ?*DOMNodeFilter) *DOMNodeIterator {
+///
+/// `filter` (may be NULL) is called for every node whatToShow lets
+/// through and must outlive the iterator. Without one, whatToShow is
+/// applied natively.
+pub export fn dom_document_createnodeiterator(handle: *DOMDocument, root: *DOMNode, whatToShow: u32, filter: ?*const DOMNodeFilter) *DOMNodeIterator {
     const doc: *Document = @ptrCast(@alignCast(handle));
     const root_node: *dom.Node = @ptrCast(@alignCast(root));
 
-    // Note: filter parameter ignored for now (NodeFilter C-ABI not yet implemented)
-    _ = filter;
+    const iterator = doc.createNodeIterator(root_node, whatToShow, nodefilter.callbackFilter(filter)) catch {
+        @panic("NodeIterator creation failed");
+    };
+
+    return @ptrCast(iterator);
+}
 
-    const iterator = doc.createNodeIterator(root_node, whatToShow, null) catch {
+/// createNodeIterator with a native element filter (non-standard).
+///
+/// The filter is evaluated in Zig and must outlive the iterator.
+pub export fn dom_document_createnodeiterator_native(handle: *DOMDocument, root: *DOMNode, whatToShow: u32, filter: *const DOMElementFilter) *DOMNodeIterator {
+    const doc: *Document = @ptrCast(@alignCast(handle));
+    const root_node: *dom.Node = @ptrCast(@alignCast(root));
+    const element_filter: *const dom.ElementFilter = @ptrCast(@alignCast(filter));
+
+    const iterator = doc.createNodeIterator(root_node, whatToShow, element_filter.nodeFilter()) catch {
         @panic("NodeIterator creation failed");
     };
 
@@ -775,25 +1088,47 @@ export fn dom_document_createnodeiterator(handle: *DOMDocument, root: *DOMNode,
 /// createTreeWalker method
 ///
 /// WebIDL: `TreeWalker createTreeWalker(Node root, unsigned long whatToShow, NodeFilter filter);`
-export fn dom_document_createtreewalker(handle: *DOMDocument, root: *DOMNode, whatToShow: u32, filter: ?*DOMNodeFilter) *DOMTreeWalker {
+///
+/// `filter` (may be NULL) is called for every node whatToShow lets
+/// through and must outlive the walker. Without one, whatToShow is
+/// applied natively.
+pub export fn dom_document_createtreewalker(handle: *DOMDocument, root: *DOMNode, whatToShow: u32, filter: ?*const DOMNodeFilter) *DOMTreeWalker {
     const doc: *Document = @ptrCast(@alignCast(handle));
     const root_node: *dom.Node = @ptrCast(@alignCast(root));
 
-    // Note: filter parameter ignored for now (NodeFilter C-ABI not yet implemented)
-    _ = filter;
+    const walker = doc.createTreeWalker(root_node, whatToShow, nodefilter.callbackFilter(filter)) catch {
+        @panic("TreeWalker creation failed");
+    };
+
+    return @ptrCast(walker);
+}
+
+/// createTreeWalker with a native element filter (non-standard).
+///
+/// The filter is evaluated in Zig and must outlive the walker.
+pub export fn dom_document_createtreewalker_native(handle: *DOMDocument, root: *DOMNode, whatToShow: u32, filter: *const DOMElementFilter) *DOMTreeWalker {
+    const doc: *Document = @ptrCast(@alignCast(handle));
+    const root_node: *dom.Node = @ptrCast(@alignCast(root));
+    const element_filter: *const dom.ElementFilter = @ptrCast(@alignCast(filter));
 
-    const walker = doc.createTreeWalker(root_node, whatToShow, null) catch {
+    const walker = doc.createTreeWalker(root_node, whatToShow, element_filter.nodeFilter()) catch {
         @panic("TreeWalker creation failed");
     };
 
     return @ptrCast(walker);
 }
+
 /// querySelector method
 ///
 /// WebIDL: `Element? querySelector(DOMString selectors);`
 pub export fn dom_document_queryselector(handle: *DOMDocument, selectors: [*:0]const u8) ?*DOMElement {
+    return dom_document_queryselector_n(handle, selectors, std.mem.len(selectors));
+}
+
+/// querySelector method, with a length-carrying selector
+pub export fn dom_document_queryselector_n(handle: *DOMDocument, selectors: [*]const u8, selectors_len: usize) ?*DOMElement {
     const doc: *Document = @ptrCast(@alignCast(handle));
-    const selector_string = cStringToZigString(selectors);
+    const selector_string = cLenStringToZigString(selectors, selectors_len);
 
     const result = doc.querySelector(selector_string) catch {
         return null; // On error, return null
@@ -847,6 +1182,14 @@ pub export fn dom_document_queryselectorall(handle: *DOMDocument, selectors: [*:
         return null;
     };
 
+    return toStaticNodeList(doc, results);
+}
+
+/// Moves query results into a StaticNodeList (null when empty or on
+/// allocation failure).
+fn toStaticNodeList(doc: *Document, results: []const *Element) ?*dom_types.DOMNodeList {
+    defer doc.prototype.allocator.free(results);
+
     if (results.len == 0) {
         return null;
     }
@@ -873,12 +1216,171 @@ pub export fn dom_document_queryselectorall(handle: *DOMDocument, selectors: [*:
     return @ptrCast(wrapper);
 }
 
+/// Worker threads of dom_document_queryselectorall_many(), started by its
+/// first call
+var query_pool: std.Thread.Pool = undefined;
+var query_pool_error: ?anyerror = null;
+var query_pool_once = std.once(initQueryPool);
+
+fn initQueryPool() void {
+    query_pool.init(.{ .allocator = std.heap.c_allocator }) catch |err| {
+        query_pool_error = err;
+    };
+}
+
+/// Query all matching elements for several selectors in parallel.
+///
+/// Not in WebIDL - C-ABI specific. Runs the queries on a process-wide
+/// thread pool (one worker per CPU) and stores the matches of
+/// `selectors[i]` in `results[i]`, NULL when nothing matches; release each
+/// list with dom_nodelist_static_release().
+///
+/// ## Returns
+/// 0 on success, DOM_ERROR_INVALID_STATE if the document is not frozen
+/// (see dom_document_freeze()), or the error of the first invalid
+/// selector; every entry of `results` is NULL on error
+pub export fn dom_document_queryselectorall_many(
+    handle: *DOMDocument,
+    selectors: [*]const [*:0]const u8,
+    count: usize,
+    results: [*]?*dom_types.DOMNodeList,
+) c_int {
+    const doc: *Document = @ptrCast(@alignCast(handle));
+    @memset(results[0..count], null);
+
+    query_pool_once.call();
+    if (query_pool_error) |err| {
+        return @intFromEnum(zigErrorToDOMError(err));
+    }
+
+    const allocator = doc.prototype.allocator;
+    const selector_strings = allocator.alloc([]const u8, count) catch {
+        return @intFromEnum(DOMErrorCode.QuotaExceededError);
+    };
+    defer allocator.free(selector_strings);
+    const matches = allocator.alloc([]const *Element, count) catch {
+        return @intFromEnum(DOMErrorCode.QuotaExceededError);
+    };
+    defer allocator.free(matches);
+
+    for (selector_strings, selectors[0..count]) |*string, selector| {
+        string.* = cStringToZigString(selector);
+    }
+
+    doc.querySelectorAllMany(&query_pool, selector_strings, matches) catch |err| {
+        return @intFromEnum(zigErrorToDOMError(err));
+    };
+
+    for (matches, results[0..count]) |elements, *result| {
+        result.* = toStaticNodeList(doc, elements);
+    }
+    return 0;
+}
+
+/// Split querySelectorAll() of a large frozen document across threads.
+///
+/// Not in WebIDL - C-ABI specific. Uses the process-wide pool of
+/// dom_document_queryselectorall_many(); once the document is frozen and
+/// holds at least `min_nodes` nodes, dom_document_queryselectorall()
+/// matches partitions of the tree on it. Results are unchanged.
+///
+/// ## Returns
+/// 0 on success, or an error code if the pool could not be started
+pub export fn dom_document_enable_parallel_queries(handle: *DOMDocument, min_nodes: usize) c_int {
+    const doc: *Document = @ptrCast(@alignCast(handle));
+
+    query_pool_once.call();
+    if (query_pool_error) |err| {
+        return @intFromEnum(zigErrorToDOMError(err));
+    }
+
+    doc.enableParallelQueries(&query_pool, min_nodes);
+    return 0;
+}
+
+// ============================================================================
+// Compiled Selectors
+// ============================================================================
+
+/// Compile a selector through the document's selector cache.
+///
+/// The handle stays valid after the cache evicts the entry; free it with
+/// dom_selector_release(). Use it with dom_element_matches_compiled(),
+/// dom_element_closest_compiled() and dom_element_queryselector_compiled()
+/// to skip the per-call string lookup.
+///
+/// ## Returns
+/// Selector handle, or null if the selector is invalid
+pub export fn dom_selector_compile(handle: *DOMDocument, selectors: [*]const u8, selectors_len: usize) ?*dom_types.DOMSelector {
+    const doc: *Document = @ptrCast(@alignCast(handle));
+    const selector_string = cLenStringToZigString(selectors, selectors_len);
+    if (selector_string.len == 0) {
+        return null;
+    }
+
+    const parsed = doc.selector_cache.acquire(selector_string) catch {
+        return null;
+    };
+    return @ptrCast(parsed);
+}
+
+/// Release a selector handle from dom_selector_compile().
+pub export fn dom_selector_release(selector: *dom_types.DOMSelector) void {
+    const parsed: *dom.ParsedSelector = @ptrCast(@alignCast(selector));
+    parsed.release();
+}
+
+/// Get selector cache statistics
+pub export fn dom_document_get_selector_cache_stats(handle: *DOMDocument, out: *dom_types.DOMSelectorCacheStats) void {
+    const doc: *Document = @ptrCast(@alignCast(handle));
+    const cache = &doc.selector_cache;
+    out.* = .{
+        .hits = cache.hits,
+        .misses = cache.misses,
+        .size = @intCast(cache.count()),
+        .capacity = @intCast(cache.max_size),
+    };
+}
+
+/// Get matches() cache statistics (all zero unless enabled)
+pub export fn dom_document_get_match_cache_stats(handle: *DOMDocument, out: *dom_types.DOMMatchCacheStats) void {
+    const doc: *Document = @ptrCast(@alignCast(handle));
+    const cache = doc.match_cache orelse {
+        out.* = .{ .hits = 0, .misses = 0, .elements = 0, .enabled = 0 };
+        return;
+    };
+    out.* = .{
+        .hits = cache.hits,
+        .misses = cache.misses,
+        .elements = @intCast(cache.count()),
+        .enabled = 1,
+    };
+}
+
+/// Get per-kind querySelector fast path counts
+pub export fn dom_document_get_fast_path_stats(handle: *DOMDocument, out: *dom_types.DOMFastPathStats) void {
+    const doc: *Document = @ptrCast(@alignCast(handle));
+    const stats = &doc.selector_cache.fast_path_stats;
+    out.* = .{
+        .simple_id = stats.get(.simple_id),
+        .simple_class = stats.get(.simple_class),
+        .simple_tag = stats.get(.simple_tag),
+        .attribute_equals = stats.get(.attribute_equals),
+        .tag_class = stats.get(.tag_class),
+        .child_tag = stats.get(.child_tag),
+        .id_filtered = stats.get(.id_filtered),
+        .generic = stats.get(.generic),
+    };
+}
+
 // ============================================================================
 // Static NodeList structure (for querySelectorAll results)
 // ============================================================================
 
 /// Static NodeList wrapper for querySelectorAll results
-const StaticNodeList = struct {
+///
+/// Shared by Document, Element and DocumentFragment querySelectorAll.
+pub const StaticNodeList = struct {
     elements: [*]*Element,
     count: usize,
 
@@ -923,6 +1425,28 @@ pub export fn dom_nodelist_static_item(list: *dom_types.DOMNodeList, index: u32)
     return null;
 }
 
+/// Copy node pointers from a static NodeList into a caller-provided array.
+///
+/// Lets bindings read the whole result in one call instead of one
+/// dom_nodelist_static_item() per index. Pointers are borrowed (no addref).
+///
+/// ## Parameters
+/// - `list`: NodeList handle from querySelectorAll
+/// - `out`: Array to fill (may be NULL when `capacity` is 0)
+/// - `capacity`: Size of `out`
+///
+/// ## Returns
+/// Total number of nodes in the list (may exceed `capacity`)
+pub export fn dom_nodelist_static_items(list: *dom_types.DOMNodeList, out: ?[*]*DOMNode, capacity: u32) u32 {
+    const static_list: *StaticNodeList = @ptrCast(@alignCast(list));
+    const count = static_list.length();
+    const n = @min(count, capacity);
+    for (0..n) |i| {
+        out.?[i] = @ptrCast(&static_list.elements[i].prototype);
+    }
+    return count;
+}
+
 /// Release static NodeList from querySelectorAll.
 ///
 /// ## Parameters
@@ -1011,6 +1535,9 @@ pub export fn dom_document_get_lastchild(handle: *DOMDocument) ?*DOMNode {
 ///
 /// Note: Requires an allocator. For now, uses a global page allocator.
 /// Future: Add dom_document_new_with_allocator() variant.
+///
+/// The document keeps no thread-local state, so it can be built on one
+/// thread and handed to another (one thread at a time).
 pub export fn dom_document_new() *DOMDocument {
     const allocator = std.heap.page_allocator;
     const doc = Document.init(allocator) catch {
@@ -1019,6 +1546,150 @@ pub export fn dom_document_new() *DOMDocument {
     return @ptrCast(doc);
 }
 
+/// Create a new Document whose nodes are bump-allocated from one arena
+/// (not in WebIDL - C-ABI specific)
+///
+/// For request-scoped documents: releasing a node frees nothing, and
+/// dom_document_release() frees the whole tree at once. Nodes cannot be
+/// inserted into or adopted by other documents (copy them with
+/// dom_document_importnode()), and node handles must not outlive the
+/// document.
+///
+/// ## Parameters
+/// - `initial_bytes`: Arena capacity to reserve up front (0 for none)
+///
+/// ## Returns
+/// New document, or null on allocation failure
+pub export fn dom_document_new_with_arena(initial_bytes: usize) ?*DOMDocument {
+    const doc = Document.initWithArena(std.heap.page_allocator, initial_bytes) catch return null;
+    return @ptrCast(doc);
+}
+
+/// Copy a document for a variant that changes a few nodes
+/// (not in WebIDL - C-ABI specific)
+///
+/// See Document.fork(): the copy is an arena document that shares the
+/// source's interned strings and keeps the source alive until it is
+/// released. The source is only read and may be frozen.
+///
+/// ## Returns
+/// New document, or null on allocation failure
+pub export fn dom_document_fork(handle: *DOMDocument) ?*DOMDocument {
+    const doc: *Document = @ptrCast(@alignCast(handle));
+    const copy = doc.fork() catch return null;
+    return @ptrCast(copy);
+}
+
+/// Create a pool of common names shared by documents
+/// (not in WebIDL - C-ABI specific)
+///
+/// See SharedNames: documents created with
+/// dom_document_new_with_sharednames() return its strings instead of
+/// interning their own copies.
+///
+/// ## Parameters
+/// - `names`: Null-terminated names (may be null when `count` is 0)
+/// - `count`: Number of names
+///
+/// ## Returns
+/// New pool with one reference, or null on allocation failure
+pub export fn dom_sharednames_new(names: ?[*]const [*:0]const u8, count: usize) ?*DOMSharedNames {
+    const allocator = std.heap.page_allocator;
+    const slices = allocator.alloc([]const u8, count) catch return null;
+    defer allocator.free(slices);
+    for (slices, 0..) |*slice, i| slice.* = std.mem.span(names.?[i]);
+
+    const shared = SharedNames.init(allocator, slices) catch return null;
+    return @ptrCast(shared);
+}
+
+/// Add a reference to a shared name pool
+pub export fn dom_sharednames_acquire(handle: *DOMSharedNames) void {
+    const shared: *SharedNames = @ptrCast(@alignCast(handle));
+    shared.acquire();
+}
+
+/// Drop a reference to a shared name pool; the last one frees it
+pub export fn dom_sharednames_release(handle: *DOMSharedNames) void {
+    const shared: *SharedNames = @ptrCast(@alignCast(handle));
+    shared.release();
+}
+
+/// Create a new Document whose string pool falls back to `shared`
+/// (not in WebIDL - C-ABI specific)
+///
+/// ## Returns
+/// New document, or null on allocation failure
+pub export fn dom_document_new_with_sharednames(handle: *DOMSharedNames) ?*DOMDocument {
+    const shared: *SharedNames = @ptrCast(@alignCast(handle));
+    const doc = Document.initWithSharedNames(std.heap.page_allocator, shared) catch return null;
+    return @ptrCast(doc);
+}
+
+/// Save the document's tree to a binary image file.
+///
+/// See document_image.zig for the format; load it with
+/// dom_document_load_mmap().
+///
+/// ## Returns
+/// 0 on success, DOM_ERROR_NOT_SUPPORTED if the tree holds a node type
+/// images cannot store, or another error code if writing fails
+pub export fn dom_document_save(handle: *DOMDocument, path: [*:0]const u8) c_int {
+    const doc: *const Document = @ptrCast(@alignCast(handle));
+    dom.document_image.saveFile(std.heap.page_allocator, doc, std.fs.cwd(), std.mem.span(path)) catch |err| {
+        return @intFromEnum(zigErrorToDOMError(err));
+    };
+    return 0;
+}
+
+/// Load a document from an image file written by dom_document_save().
+///
+/// The file is mapped read-only and stays mapped until the document is
+/// released; names and attribute values are used in place.
+///
+/// ## Returns
+/// New arena document, or null if the file cannot be read or is not a
+/// valid image
+pub export fn dom_document_load_mmap(path: [*:0]const u8) ?*DOMDocument {
+    const doc = dom.document_image.loadFile(std.heap.page_allocator, std.fs.cwd(), std.mem.span(path)) catch return null;
+    return @ptrCast(doc);
+}
+
+/// Pre-size the document's storage for content about to be added
+/// (not in WebIDL - C-ABI specific)
+///
+/// See Document.reserve(): `strings_bytes` sizes one buffer for new
+/// interned names and values; `nodes` sizes the arena of documents from
+/// dom_document_new_with_arena().
+///
+/// ## Returns
+/// 0 on success, error code on failure
+pub export fn dom_document_reserve(handle: *DOMDocument, nodes: usize, strings_bytes: usize) c_int {
+    const doc: *Document = @ptrCast(@alignCast(handle));
+    doc.reserve(.{ .nodes = nodes, .string_bytes = strings_bytes }) catch |err| {
+        return @intFromEnum(zigErrorToDOMError(err));
+    };
+    return 0;
+}
+
+/// Estimate of the memory the document keeps alive, in bytes
+///
+/// See Document.allocatedBytes(); meant for reporting DOM memory to a
+/// JavaScript engine's garbage collector.
+pub export fn dom_document_get_allocated_bytes(handle: *DOMDocument) usize {
+    const doc: *const Document = @ptrCast(@alignCast(handle));
+    return doc.allocatedBytes();
+}
+
+/// Number of live nodes owned by the document (excluding itself).
+///
+/// Nodes stay live while anything holds a reference: their tree, a
+/// wrapper, a snapshot list. Leak checks watch this across GCs.
+pub export fn dom_document_get_live_node_count(handle: *DOMDocument) usize {
+    const doc: *const Document = @ptrCast(@alignCast(handle));
+    return doc.node_ref_count.load(.monotonic);
+}
+
 /// Increase reference count
 pub export fn dom_document_addref(handle: *DOMDocument) void {
     const doc: *Document = @ptrCast(@alignCast(handle));
@@ -21,6 +21,7 @@
 extern "C" {
 #endif
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -51,10 +52,99 @@ typedef struct DOMRange DOMRange;
 typedef struct DOMStaticRange DOMStaticRange;
 typedef struct DOMTreeWalker DOMTreeWalker;
 typedef struct DOMNodeIterator DOMNodeIterator;
+typedef struct DOMElementIterator DOMElementIterator;
+typedef struct DOMElementFilter DOMElementFilter;
 typedef struct DOMHTMLCollection DOMHTMLCollection;
 typedef struct DOMNodeList DOMNodeList;
+typedef struct DOMSelector DOMSelector;
+typedef struct DOMClosestMemo DOMClosestMemo;
+typedef struct DOMQuery DOMQuery;
 typedef struct DOMAbortController DOMAbortController;
 typedef struct DOMAbortSignal DOMAbortSignal;
+typedef struct DOMCustomElementRegistry DOMCustomElementRegistry;
+typedef struct DOMSharedNames DOMSharedNames;
+
+/* ============================================================================
+ * Reference Ownership
+ *
+ * Every function returning an object says which of two kinds it is:
+ *
+ * - Owned ("+1 reference", "must be released"): the caller holds a new
+ *   reference and releases it with the matching dom_*_release. Factories
+ *   (create*, clone*), removed or replaced children and Attr getters that
+ *   may create the Attr return owned references.
+ * - Borrowed ("do NOT release", "borrowed"): no reference changes hands
+ *   and no reference count is written. Tree accessors (parentNode,
+ *   firstChild, nextSibling, ownerDocument, ...) are borrowed: the node
+ *   is kept alive by the tree it is in, so the pointer stays valid until
+ *   the caller next mutates that tree. Take a reference with
+ *   dom_*_addref to keep it longer.
+ *
+ * Traversal-only code therefore does no reference counting at all; only
+ * objects the caller keeps (a binding's wrapper, say) need one reference
+ * each, taken once.
+ * ========================================================================= */
+
+/* ============================================================================
+ * Node Filters
+ * ========================================================================= */
+
+/**
+ * NodeFilter.acceptNode as a C callback.
+ * 
+ * Returns DOM_NODEFILTER_FILTER_ACCEPT, _REJECT or _SKIP; any other value
+ * counts as skip. Only called for nodes whatToShow lets through.
+ */
+typedef uint16_t (*DOMNodeFilterCallback)(DOMNode* node, void* user_data);
+
+/**
+ * A caller-supplied NodeFilter for createTreeWalker / createNodeIterator.
+ * 
+ * Read on every call: it must outlive the walker or iterator.
+ */
+typedef struct DOMNodeFilter {
+    DOMNodeFilterCallback accept_node;
+    void* user_data;
+} DOMNodeFilter;
+
+/* ============================================================================
+ * String Views
+ * ========================================================================= */
+
+/**
+ * Borrowed DOM string with its length and storage flags.
+ * 
+ * Returned by the *_view getters so bindings can skip strlen and, for
+ * interned strings, skip copying altogether.
+ * 
+ * - data: UTF-8 bytes (do NOT free); use length instead of strlen()
+ * - length: Length in bytes
+ * - is_latin1: All bytes are ASCII (the bytes are also valid Latin-1)
+ * - is_interned: Owned by the owner document's string pool; immutable and
+ *   valid until that document is destroyed (hold a document reference to
+ *   keep it alive). Otherwise valid only until the next DOM mutation.
+ * - fits_latin1: Valid UTF-8 with every code point at most U+00FF, so it
+ *   fits a one-byte engine string (set whenever is_latin1 is); unless
+ *   is_latin1, the bytes must be transcoded first. The string pool records
+ *   this once per interned string.
+ */
+typedef struct DOMStringView {
+    const char* data;
+    uint32_t length;
+    bool is_latin1;
+    bool is_interned;
+    bool fits_latin1;
+} DOMStringView;
+
+/**
+ * Interned name: the canonical, null-terminated copy of a tag or attribute
+ * name in a document's string pool (see dom_document_intern_name).
+ * 
+ * Immutable and valid until that document is destroyed. Passing the same
+ * atom repeatedly to the *_atom functions of that document's elements
+ * turns the name comparisons into pointer comparisons.
+ */
+typedef const char* DOMAtom;
 
 /* ============================================================================
  * Constants
@@ -70,6 +160,15 @@ typedef struct DOMAbortSignal DOMAbortSignal;
 #define DOM_DOCUMENT_NODE               9
 #define DOM_DOCUMENT_TYPE_NODE          10
 #define DOM_DOCUMENT_FRAGMENT_NODE      11
+#define DOM_SHADOW_ROOT_NODE            12  /* dom_node_get_nodetype() only */
+
+/* Document Position Flags (compareDocumentPosition) */
+#define DOM_DOCUMENT_POSITION_DISCONNECTED            0x01
+#define DOM_DOCUMENT_POSITION_PRECEDING               0x02
+#define DOM_DOCUMENT_POSITION_FOLLOWING               0x04
+#define DOM_DOCUMENT_POSITION_CONTAINS                0x08
+#define DOM_DOCUMENT_POSITION_CONTAINED_BY            0x10
+#define DOM_DOCUMENT_POSITION_IMPLEMENTATION_SPECIFIC 0x20
 
 /* Error Codes */
 #define DOM_ERROR_SUCCESS                      0
@@ -139,6 +238,13 @@ const char* dom_error_code_message(int32_t code);
  * The document is created with ref_count = 1.
  * Call dom_document_release() when done.
  * 
+ * A document is not tied to the thread that created it: it and its nodes
+ * belong to one thread at a time. Build it on a worker thread (the create
+ * functions, dom_builder_*()) and pass it to another thread through
+ * something that synchronizes, such as a queue or a thread join. In JS
+ * engine bindings, hand it over before it is first wrapped
+ * (v8_dom::AdoptDocument()).
+ * 
  * @return New document (never NULL)
  * 
  * Example:
@@ -148,6 +254,128 @@ const char* dom_error_code_message(int32_t code);
  */
 DOMDocument* dom_document_new(void);
 
+/**
+ * Create a new Document whose nodes are bump-allocated from one arena.
+ * 
+ * Meant for request-scoped documents (build, serialize, discard): creating
+ * a node is a pointer bump, dom_node_release() and friends free nothing,
+ * and dom_document_release() frees every node at once without walking the
+ * tree.
+ * 
+ * Nodes cannot move between this document and any other one: inserting or
+ * adopting them across documents fails (NotSupportedError), so copy them
+ * with dom_document_importnode(). Node handles, ranges and observers on
+ * its nodes must not outlive the document.
+ * 
+ * @param initial_bytes Arena capacity to reserve up front (0 for none)
+ * @return New document, or NULL on allocation failure
+ */
+DOMDocument* dom_document_new_with_arena(size_t initial_bytes);
+
+/**
+ * Copy a document, for variants that each change a few nodes.
+ * 
+ * Faster and smaller than cloning the tree node by node: the copy is an
+ * arena document (see dom_document_new_with_arena()) with room reserved
+ * for every node, it reuses the source's interned tag names, attribute
+ * names and values instead of copying them, and each subtree is linked
+ * without per-insertion checks. Character data is copied; shadow roots
+ * are not. The copy keeps the source alive until it is released, and
+ * changes to either document do not show in the other. The source may be
+ * frozen (see dom_document_freeze()).
+ * 
+ * @param doc Source document (only read)
+ * @return New document, or NULL on allocation failure
+ * 
+ * Example:
+ *   DOMDocument* variant = dom_document_fork(base);
+ *   // ... change a few nodes, render ...
+ *   dom_document_release(variant);
+ */
+DOMDocument* dom_document_fork(DOMDocument* doc);
+
+/**
+ * Create an immutable pool of common names shared by many documents.
+ * 
+ * Meant to be created once per isolate or process: documents made with
+ * dom_document_new_with_sharednames() return its copy of a tag name,
+ * attribute name or value instead of interning their own, so these
+ * strings are stored once, compare equal by pointer across documents, and
+ * are not copied when nodes move between them. The standard namespaces
+ * are always included. The pool never changes, so documents on different
+ * threads may share it.
+ * 
+ * Each document keeps a reference until it is destroyed; release the
+ * caller's reference with dom_sharednames_release() when done creating
+ * documents.
+ * 
+ * @param names Null-terminated UTF-8 names (may be NULL when count is 0)
+ * @param count Number of names
+ * @return New pool with one reference, or NULL on allocation failure
+ * 
+ * Example:
+ *   const char* names[] = {"item", "row", "class", "id"};
+ *   DOMSharedNames* shared = dom_sharednames_new(names, 4);
+ *   DOMDocument* doc = dom_document_new_with_sharednames(shared);
+ *   dom_sharednames_release(shared);
+ *   // ... use doc ...
+ *   dom_document_release(doc);
+ */
+DOMSharedNames* dom_sharednames_new(const char* const* names, size_t count);
+
+/**
+ * Add a reference to a shared name pool.
+ */
+void dom_sharednames_acquire(DOMSharedNames* shared);
+
+/**
+ * Drop a reference to a shared name pool; the last one frees it.
+ */
+void dom_sharednames_release(DOMSharedNames* shared);
+
+/**
+ * Create a new Document whose string pool falls back to a shared name pool.
+ * 
+ * @param shared Pool from dom_sharednames_new() (the document references it)
+ * @return New document, or NULL on allocation failure
+ */
+DOMDocument* dom_document_new_with_sharednames(DOMSharedNames* shared);
+
+/**
+ * Save a document's tree to a binary image file.
+ * 
+ * Not in WebIDL. Writes the document's children and their descendants
+ * once, so later processes can load the tree with dom_document_load_mmap()
+ * instead of rebuilding it node by node. Shadow roots are not saved.
+ * Images are only readable on machines with the same byte order.
+ * 
+ * @param doc Document to save (only read)
+ * @param path File to write (replaced if it exists)
+ * @return 0 on success, DOM_ERROR_NOT_SUPPORTED for node types images
+ *         cannot store, or another error code if writing fails
+ */
+int dom_document_save(DOMDocument* doc, const char* path);
+
+/**
+ * Load a document from an image written by dom_document_save().
+ * 
+ * Not in WebIDL. The file is mapped read-only and validated, then the tree
+ * is built in one pass: tag names, attribute names and values are used in
+ * place from the mapping, which stays mapped until the document is
+ * released. Character data is copied. The result is an arena document
+ * (see dom_document_new_with_arena()) and can be changed like any other.
+ * 
+ * @param path Image file
+ * @return New document, or NULL if the file cannot be read or mapped, or
+ *         is not a valid image
+ * 
+ * Example:
+ *   dom_document_save(template_doc, "template.domi");
+ *   // ... in each worker ...
+ *   DOMDocument* doc = dom_document_load_mmap("template.domi");
+ */
+DOMDocument* dom_document_load_mmap(const char* path);
+
 /**
  * Increment document reference count.
  * 
@@ -167,6 +395,50 @@ void dom_document_addref(DOMDocument* doc);
  */
 void dom_document_release(DOMDocument* doc);
 
+/**
+ * Pre-size a document's storage for content about to be added.
+ * 
+ * Not in WebIDL. Builders and clones that know the size of what they
+ * add (a template stamped n times, a source document) call this first,
+ * so storage is allocated once instead of growing step by step. New
+ * interned names and attribute values are copied into one buffer of
+ * strings_bytes (terminators included); for arena documents (see
+ * dom_document_new_with_arena()) the arena makes room for nodes nodes.
+ * Other documents allocate each node on its own and ignore nodes. Hints
+ * are not limits.
+ * 
+ * @param doc Document
+ * @param nodes Nodes about to be created
+ * @param strings_bytes Bytes of distinct names and values about to be interned
+ * @return 0 on success, DOM_ERROR_QUOTA_EXCEEDED if allocation failed
+ */
+int dom_document_reserve(DOMDocument* doc, size_t nodes, size_t strings_bytes);
+
+/**
+ * Estimate the memory a document keeps alive.
+ * 
+ * Counts the document's nodes (as elements), its arena, interned strings
+ * and indices; character data and attribute storage are not counted.
+ * Embedders report this to their garbage collector so that a few small
+ * wrappers holding a large tree still make it collect.
+ * 
+ * @param doc Document
+ * @return Estimated bytes
+ */
+size_t dom_document_get_allocated_bytes(DOMDocument* doc);
+
+/**
+ * Count the live nodes owned by a document.
+ * 
+ * A node stays live while its tree, a wrapper or a snapshot list holds a
+ * reference, so a count that keeps growing across garbage collections
+ * points at a leaked reference.
+ * 
+ * @param doc Document
+ * @return Live nodes, not counting the document itself
+ */
+size_t dom_document_get_live_node_count(DOMDocument* doc);
+
 /**
  * Get document compat mode.
  * 
@@ -265,6 +537,24 @@ DOMDocumentType* dom_document_get_doctype(DOMDocument* doc);
  */
 DOMElement* dom_document_createelement(DOMDocument* doc, const char* localName);
 
+/**
+ * Create an element from a length-carrying name (see dom_element_setattribute_n).
+ */
+DOMElement* dom_document_createelement_n(DOMDocument* doc, const char* localName, size_t localName_len);
+
+/**
+ * Intern a tag or attribute name in the document's string pool.
+ * 
+ * Bindings can intern the names they use most once per document and pass
+ * the atoms instead of strings.
+ * 
+ * @param doc Document
+ * @param name Name bytes (UTF-8, need not be null-terminated)
+ * @param name_len Length of name in bytes
+ * @return Atom (do NOT free), or NULL on allocation failure
+ */
+DOMAtom dom_document_intern_name(DOMDocument* doc, const char* name, size_t name_len);
+
 /**
  * Create an element with namespace.
  * 
@@ -284,6 +574,11 @@ DOMElement* dom_document_createelementns(DOMDocument* doc, const char* ns, const
  */
 DOMText* dom_document_createtextnode(DOMDocument* doc, const char* data);
 
+/**
+ * Create a text node from length-carrying data.
+ */
+DOMText* dom_document_createtextnode_n(DOMDocument* doc, const char* data, size_t data_len);
+
 /**
  * Create a comment node.
  * 
@@ -372,6 +667,11 @@ DOMNode* dom_document_adoptnode(DOMDocument* doc, DOMNode* node);
  */
 DOMElement* dom_document_queryselector(DOMDocument* doc, const char* selectors);
 
+/**
+ * Find the first matching element, with a length-carrying selector.
+ */
+DOMElement* dom_document_queryselector_n(DOMDocument* doc, const char* selectors, size_t selectors_len);
+
 /**
  * Find all elements matching a CSS selector.
  * 
@@ -395,6 +695,149 @@ DOMElement* dom_document_queryselector(DOMDocument* doc, const char* selectors);
  */
 DOMNodeList* dom_document_queryselectorall(DOMDocument* doc, const char* selectors);
 
+/**
+ * Find all elements matching each of several CSS selectors, in parallel.
+ * 
+ * Not in WebIDL. Runs the queries on a process-wide thread pool (one worker
+ * per CPU, started by the first call) and stores the matches of
+ * selectors[i] in results[i], NULL when nothing matches. The document must
+ * be frozen (see dom_document_freeze()).
+ * 
+ * @param doc Frozen document
+ * @param selectors Array of n CSS selector strings
+ * @param n Number of selectors
+ * @param results Array of n lists, each released with dom_nodelist_static_release()
+ * @return 0 on success, DOM_ERROR_INVALID_STATE if the document is not
+ *         frozen, or the error of the first invalid selector (all results NULL)
+ * 
+ * Example:
+ *   const char* selectors[] = {".item", "row > cell", "[data-id]"};
+ *   DOMNodeList* results[3];
+ *   dom_document_freeze(doc);
+ *   if (dom_document_queryselectorall_many(doc, selectors, 3, results) == 0) {
+ *       for (int i = 0; i < 3; i++) {
+ *           if (results[i]) dom_nodelist_static_release(results[i]);
+ *       }
+ *   }
+ */
+int dom_document_queryselectorall_many(DOMDocument* doc, const char* const* selectors, size_t n, DOMNodeList** results);
+
+/**
+ * Split dom_document_queryselectorall() of a large document across threads.
+ * 
+ * Not in WebIDL. Once the document is frozen (see dom_document_freeze())
+ * and holds at least min_nodes nodes, its queries match partitions of the
+ * tree on the pool of dom_document_queryselectorall_many(). Results and
+ * their order are unchanged. Call before freezing.
+ * 
+ * @param doc Document
+ * @param min_nodes Smallest node count worth splitting
+ * @return 0 on success, or an error code if the pool could not be started
+ */
+int dom_document_enable_parallel_queries(DOMDocument* doc, size_t min_nodes);
+
+/* ============================================================================
+ * Compiled Selectors
+ * ========================================================================= */
+
+/**
+ * Selector cache statistics.
+ */
+typedef struct DOMSelectorCacheStats {
+    uint64_t hits;
+    uint64_t misses;
+    uint32_t size;
+    uint32_t capacity;
+} DOMSelectorCacheStats;
+
+/**
+ * Compile a selector through the document's selector cache.
+ * 
+ * Parsed selectors are cached per document (LRU) and shared with
+ * querySelector(), matches() and closest(). The returned handle stays
+ * valid after eviction until released, and may be used and released after
+ * the document itself is gone: it owns its memory and frees it through the
+ * allocator of the document that compiled it.
+ * 
+ * @param doc Document whose cache to use
+ * @param selectors Selector string (UTF-8, need not be null-terminated)
+ * @param selectors_len Length of selectors in bytes
+ * @return Selector handle (release with dom_selector_release()), or NULL
+ *         if the selector is invalid
+ * 
+ * Example:
+ *   DOMSelector* sel = dom_selector_compile(doc, ".item", 5);
+ *   if (sel) {
+ *       DOMElement* hit = dom_element_closest_compiled(target, sel);
+ *       dom_selector_release(sel);
+ *   }
+ */
+DOMSelector* dom_selector_compile(DOMDocument* doc, const char* selectors, size_t selectors_len);
+
+/**
+ * Release a compiled selector.
+ * 
+ * @param selector Handle from dom_selector_compile()
+ */
+void dom_selector_release(DOMSelector* selector);
+
+/**
+ * Get a document's selector cache statistics.
+ * 
+ * @param doc Document
+ * @param out Receives hit/miss counts and current size
+ */
+void dom_document_get_selector_cache_stats(DOMDocument* doc, DOMSelectorCacheStats* out);
+
+/**
+ * querySelector fast path counts.
+ * 
+ * One count per query (querySelector, querySelectorAll) by the shape its
+ * selector was recognized as; `generic` and `id_filtered` queries ran the
+ * full matcher.
+ */
+typedef struct DOMFastPathStats {
+    uint64_t simple_id;
+    uint64_t simple_class;
+    uint64_t simple_tag;
+    uint64_t attribute_equals;
+    uint64_t tag_class;
+    uint64_t child_tag;
+    uint64_t id_filtered;
+    uint64_t generic;
+} DOMFastPathStats;
+
+/**
+ * Get a document's querySelector fast path counts.
+ * 
+ * @param doc Document
+ * @param out Receives the per-kind counts
+ */
+void dom_document_get_fast_path_stats(DOMDocument* doc, DOMFastPathStats* out);
+
+/**
+ * matches() cache statistics.
+ * 
+ * Counts of dom_element_matches() and dom_element_matches_compiled()
+ * calls answered by the cache (hits) and matched (misses), and the number
+ * of elements with remembered answers.
+ */
+typedef struct DOMMatchCacheStats {
+    uint64_t hits;
+    uint64_t misses;
+    uint32_t elements;
+    uint32_t enabled;
+} DOMMatchCacheStats;
+
+/**
+ * Get a document's matches() cache statistics.
+ * 
+ * @param doc Document
+ * @param out Receives the counts; all zero (enabled 0) unless
+ *        dom_document_enable_match_cache() was called
+ */
+void dom_document_get_match_cache_stats(DOMDocument* doc, DOMMatchCacheStats* out);
+
 /**
  * Get all elements with the specified tag name.
  * 
@@ -453,6 +896,254 @@ DOMHTMLCollection* dom_document_getelementsbytagnamens(DOMDocument* doc, const c
  */
 DOMHTMLCollection* dom_document_getelementsbyclassname(DOMDocument* doc, const char* classNames);
 
+/**
+ * Enable the document's class token index.
+ * 
+ * Keeps an index from each class token to the connected elements carrying
+ * it, so live document-wide getElementsByClassName() collections answer
+ * length and item() without walking the tree. Worth it when collections
+ * are polled (e.g. every frame). Calling it again does nothing.
+ * 
+ * @param doc Document
+ * @return 0 on success, error code on failure
+ */
+int dom_document_enable_class_index(DOMDocument* doc);
+
+/**
+ * Enable structural hashes for the document's nodes.
+ * 
+ * Caches each node's dom_node_get_structural_hash() result until its
+ * subtree changes; a mutation drops the hashes of the changed node and its
+ * ancestors only. dom_node_isequalnode() between nodes of documents that
+ * both enable it returns 0 on a hash mismatch without comparing the
+ * subtrees. Calling it again does nothing.
+ * 
+ * @param doc Document
+ * @return 0 on success, error code on failure
+ */
+int dom_document_enable_structural_hashes(DOMDocument* doc);
+
+/**
+ * Enable the document's matches() cache.
+ * 
+ * Each element remembers its last few dom_element_matches() answers per
+ * selector. Selectors that only test the element itself (names, ids,
+ * classes, attributes) stay cached until the element's attributes change,
+ * so they survive unrelated mutations; selectors with combinators or
+ * structural pseudo-classes are cached until the document next changes.
+ * Worth it when the same checks run repeatedly against mostly unchanged
+ * elements. Calling it again does nothing.
+ * 
+ * @param doc Document
+ * @return 0 on success, error code on failure
+ */
+int dom_document_enable_match_cache(DOMDocument* doc);
+
+/**
+ * Enable the document's document order index.
+ * 
+ * Numbers the document tree in preorder (lazily, on the first comparison),
+ * so dom_node_comparedocumentposition(), dom_node_contains() and Range
+ * boundary point comparisons between its nodes take constant time. Removing
+ * or moving a node only drops its subtree's numbers; inserted nodes are
+ * numbered on a later rebuild. Calling it again does nothing.
+ * 
+ * @param doc Document
+ * @return 0 on success, error code on failure
+ */
+int dom_document_enable_document_order_index(DOMDocument* doc);
+
+/**
+ * Let textContent reuse a sole Text child of the document's nodes.
+ * 
+ * Not spec-conformant, hence opt-in: a non-empty dom_node_set_textcontent()
+ * or dom_node_set_textcontent_n() on a node whose only child is a Text node
+ * replaces that node's data in place (one characterData mutation record
+ * instead of a childList record) rather than replacing the child. Calling
+ * it again does nothing.
+ * 
+ * @param doc Document
+ */
+void dom_document_enable_inplace_textcontent(DOMDocument* doc);
+
+/**
+ * Begin a mutation batch.
+ * 
+ * Until the matching dom_document_end_batch(), mutation records are
+ * coalesced for every observer of the document (as with the coalesce
+ * observer option), and the class index is rebuilt once at the end of the
+ * batch instead of being updated on every class change. Tree reads,
+ * getElementById and live collections stay current inside the batch.
+ * Batches nest; only the outermost end finishes the batch.
+ * 
+ * @param doc Document
+ */
+void dom_document_begin_batch(DOMDocument* doc);
+
+/**
+ * End a mutation batch started with dom_document_begin_batch().
+ * 
+ * @param doc Document
+ * @return 0 on success, DOM_ERROR_INVALID_STATE if no batch is open
+ */
+int dom_document_end_batch(DOMDocument* doc);
+
+/**
+ * Apply a binary patch in one call.
+ * 
+ * Not in WebIDL. bytes holds a patch in the dom_node_diff() format, e.g.
+ * received from a server. Node fields index caller-supplied tables:
+ * target and before index targets, source and before_source index
+ * sources. Inserted and replacing nodes are deep copies of their sources;
+ * the sources are not changed. The patch and every index are checked
+ * before the first op runs, and all ops run inside one mutation batch
+ * (see dom_document_begin_batch()), so observers get one coalesced set
+ * of records.
+ * 
+ * @param doc Document owning the target nodes
+ * @param bytes Patch bytes (copied first if not 4-byte aligned)
+ * @param length Patch length in bytes
+ * @param targets Nodes the target and before fields index
+ * @param target_count Number of targets
+ * @param sources Nodes the source and before_source fields index (may be
+ *        NULL with source_count 0)
+ * @param source_count Number of sources
+ * @return 0 on success, DOM_ERROR_SYNTAX for a malformed patch,
+ *         DOM_ERROR_INDEX_SIZE for an index outside its table, or the
+ *         error of the first failing op (earlier ops stay applied)
+ */
+int dom_document_apply_patch(DOMDocument* doc, const uint8_t* bytes, size_t length,
+                             DOMNode* const* targets, size_t target_count,
+                             DOMNode* const* sources, size_t source_count);
+
+/**
+ * Queue a patch for the thread that owns the document.
+ * 
+ * Not in WebIDL. Safe to call from any thread, without locks: the patch
+ * (same format and tables as dom_document_apply_patch()) is validated,
+ * copied with both node tables and pushed onto the document's lock-free
+ * queue. The owning thread applies it with dom_document_drain_patches().
+ * No references are taken: every node in the tables must stay alive
+ * until the patch is drained.
+ * 
+ * should_wake is set to 1 when the queue was empty, 0 otherwise. Only the
+ * producer that gets 1 needs to wake the owning thread; patches submitted
+ * before it drains join the same drain.
+ * 
+ * @param doc Document owning the target nodes
+ * @param bytes Patch bytes (any alignment)
+ * @param length Patch length in bytes
+ * @param targets Nodes the target and before fields index
+ * @param target_count Number of targets
+ * @param sources Nodes the source and before_source fields index (may be
+ *        NULL with source_count 0)
+ * @param source_count Number of sources
+ * @param should_wake Set to 1 if the owning thread must be woken (may be NULL)
+ * @return 0 on success, DOM_ERROR_SYNTAX for a malformed patch (nothing is
+ *         queued), DOM_ERROR_QUOTA_EXCEEDED if the copy failed
+ */
+int dom_document_submit_patch(DOMDocument* doc, const uint8_t* bytes, size_t length,
+                              DOMNode* const* targets, size_t target_count,
+                              DOMNode* const* sources, size_t source_count,
+                              uint8_t* should_wake);
+
+/**
+ * Apply every patch queued with dom_document_submit_patch().
+ * 
+ * Owning thread only. Patches run in submission order, all inside one
+ * mutation batch. A failing patch stops at its failing op (its earlier
+ * ops stay applied) and the patches after it still run. Checking an
+ * empty queue is one atomic load.
+ * 
+ * @param doc Document
+ * @param first_error Set to the error of the first failing patch, or 0
+ *        (may be NULL)
+ * @return Number of patches taken from the queue
+ */
+size_t dom_document_drain_patches(DOMDocument* doc, int* first_error);
+
+/**
+ * Bring the document's enabled lazy indices up to date within a time budget.
+ * 
+ * Not in WebIDL. Meant for the embedder's idle callbacks (e.g. V8 idle
+ * tasks, with the time left until their deadline). The class index,
+ * compact layout, document order index and structural hashes are otherwise
+ * rebuilt by the first query after a change, in one pass; this builds them
+ * ahead of time in that priority order, a slice per call, each call
+ * resuming where the previous one stopped. A change to the document since
+ * the previous call restarts the index being built. Work in progress does
+ * not affect queries, which still rebuild an unfinished index themselves.
+ * Frozen documents have no idle work.
+ * 
+ * The clock is read every few hundred nodes, so a call may overrun a
+ * tiny budget slightly.
+ * 
+ * @param doc Document
+ * @param budget_ns Time budget in nanoseconds
+ * @return 1 if work remains (schedule another idle callback), 0 once every
+ *         index is current or if an index could not be allocated (its next
+ *         query rebuilds it)
+ */
+uint8_t dom_document_run_idle_work(DOMDocument* doc, uint64_t budget_ns);
+
+/**
+ * Check whether dom_document_run_idle_work() has work to do.
+ * 
+ * Costs a few field reads, so embedders can check after each task whether
+ * to request an idle callback.
+ * 
+ * @param doc Document
+ * @return 1 if an enabled index is out of date, 0 otherwise
+ */
+uint8_t dom_document_has_idle_work(DOMDocument* doc);
+
+/**
+ * Make the document immutable, for concurrent read-only queries.
+ * 
+ * Builds the enabled lazy indices (class index, document order index,
+ * compact layout). Afterwards every mutation of the document's nodes fails
+ * with DOM_ERROR_NO_MODIFICATION_ALLOWED (removeattribute does nothing),
+ * and creating nodes in it is an error (the create functions without an
+ * error code abort), while dom_document_queryselectorall(),
+ * dom_document_queryselectorall_many() and dom_element_matches() may be
+ * called from several threads at once. Other reads stay single-threaded.
+ * Freezing cannot be undone; calling it again does nothing.
+ * 
+ * @param doc Document
+ * @return 0 on success, DOM_ERROR_INVALID_STATE if a batch is open
+ */
+int dom_document_freeze(DOMDocument* doc);
+
+/**
+ * Let a frozen document be referenced from several threads at once.
+ * 
+ * Not in WebIDL. Meant for one large immutable document used by several
+ * JS engine isolates, one per thread, without copying it. Afterwards the
+ * reference counts of the document and of every node in its tree and
+ * shadow trees are updated atomically, and each node's wrapper slot holds
+ * a claimed value that dom_node_set_wrapper_slot() cannot change, so
+ * every isolate caches the wrappers in its own map. Call it before any
+ * wrapper is created. Nodes of unshared documents keep plain reference
+ * counting. Sharing cannot be undone; calling it again does nothing.
+ * 
+ * @param doc Frozen document
+ * @return 0 on success, DOM_ERROR_INVALID_STATE if the document is not frozen
+ */
+int dom_document_share(DOMDocument* doc);
+
+/**
+ * Get the document's mutation version.
+ * 
+ * Changes whenever a child list or attribute of any node owned by the
+ * document changes. Bindings can cache a collection's elements (see
+ * dom_htmlcollection_get_items()) and refill them only when the version
+ * differs from the one they copied at.
+ * 
+ * @param doc Document
+ * @return Current mutation version
+ */
+uint64_t dom_document_get_mutation_version(DOMDocument* doc);
+
 /**
  * Get element by ID.
  * 
@@ -471,6 +1162,11 @@ DOMHTMLCollection* dom_document_getelementsbyclassname(DOMDocument* doc, const c
  */
 DOMElement* dom_document_getelementbyid(DOMDocument* doc, const char* elementId);
 
+/**
+ * Find an element by ID, with a length-carrying ID.
+ */
+DOMElement* dom_document_getelementbyid_n(DOMDocument* doc, const char* elementId, size_t elementId_len);
+
 /**
  * Create a new Range.
  * 
@@ -493,7 +1189,8 @@ DOMRange* dom_document_createrange(DOMDocument* doc);
  * @param doc Document
  * @param root Root node for traversal
  * @param whatToShow Bitmask of node types to show (use DOM_NODEFILTER_SHOW_* constants)
- * @param filter Custom node filter (currently must be NULL)
+ * @param filter Node filter, or NULL to apply whatToShow alone (natively).
+ *               Must outlive the walker.
  * @return TreeWalker
  * 
  * Example:
@@ -506,7 +1203,20 @@ DOMRange* dom_document_createrange(DOMDocument* doc);
  *   DOMNode* child = dom_treewalker_firstchild(walker);
  *   dom_treewalker_release(walker);
  */
-DOMTreeWalker* dom_document_createtreewalker(DOMDocument* doc, DOMNode* root, uint32_t whatToShow, void* filter);
+DOMTreeWalker* dom_document_createtreewalker(DOMDocument* doc, DOMNode* root, uint32_t whatToShow, const DOMNodeFilter* filter);
+
+/**
+ * Create a TreeWalker with a native element filter (non-standard).
+ * 
+ * The filter is evaluated without any callback; it must outlive the walker.
+ * 
+ * @param doc Document
+ * @param root Root node for traversal
+ * @param whatToShow Bitmask of node types to show
+ * @param filter Element filter (see dom_elementfilter_new)
+ * @return TreeWalker
+ */
+DOMTreeWalker* dom_document_createtreewalker_native(DOMDocument* doc, DOMNode* root, uint32_t whatToShow, const DOMElementFilter* filter);
 
 /**
  * Create a NodeIterator.
@@ -514,7 +1224,8 @@ DOMTreeWalker* dom_document_createtreewalker(DOMDocument* doc, DOMNode* root, ui
  * @param doc Document
  * @param root Root node for iteration
  * @param whatToShow Bitmask of node types to show (use DOM_NODEFILTER_SHOW_* constants)
- * @param filter Custom node filter (currently must be NULL)
+ * @param filter Node filter, or NULL to apply whatToShow alone (natively).
+ *               Must outlive the iterator.
  * @return NodeIterator
  * 
  * Example:
@@ -531,16 +1242,29 @@ DOMTreeWalker* dom_document_createtreewalker(DOMDocument* doc, DOMNode* root, ui
  *   }
  *   dom_nodeiterator_release(iterator);
  */
-DOMNodeIterator* dom_document_createnodeiterator(DOMDocument* doc, DOMNode* root, uint32_t whatToShow, void* filter);
-
-/* ============================================================================
- * DOMImplementation Interface
- * ========================================================================= */
+DOMNodeIterator* dom_document_createnodeiterator(DOMDocument* doc, DOMNode* root, uint32_t whatToShow, const DOMNodeFilter* filter);
 
 /**
- * Create a DocumentType node.
+ * Create a NodeIterator with a native element filter (non-standard).
  * 
- * Creates a DocumentType node (<!DOCTYPE>) with the specified properties.
+ * The filter is evaluated without any callback; it must outlive the iterator.
+ * 
+ * @param doc Document
+ * @param root Root node for iteration
+ * @param whatToShow Bitmask of node types to show
+ * @param filter Element filter (see dom_elementfilter_new)
+ * @return NodeIterator
+ */
+DOMNodeIterator* dom_document_createnodeiterator_native(DOMDocument* doc, DOMNode* root, uint32_t whatToShow, const DOMElementFilter* filter);
+
+/* ============================================================================
+ * DOMImplementation Interface
+ * ========================================================================= */
+
+/**
+ * Create a DocumentType node.
+ * 
+ * Creates a DocumentType node (<!DOCTYPE>) with the specified properties.
  * 
  * @param impl DOMImplementation handle
  * @param qualifiedName Document type name (e.g., "html")
@@ -589,6 +1313,30 @@ DOMDocument* dom_domimplementation_createdocument(
     DOMDocumentType* doctype
 );
 
+/**
+ * Create a Document with storage pre-sized for known content.
+ * 
+ * Not in WebIDL. Same as dom_domimplementation_createdocument(), then
+ * dom_document_reserve(doc, nodes, strings_bytes) before the document
+ * element is added.
+ * 
+ * @param impl DOMImplementation handle
+ * @param namespace_ Namespace URI (NULL for none)
+ * @param qualifiedName Qualified element name for document element
+ * @param doctype DocumentType to associate (NULL for none)
+ * @param nodes Nodes about to be created
+ * @param strings_bytes Bytes of distinct names and values about to be interned
+ * @return New Document (must be released), or NULL on error
+ */
+DOMDocument* dom_domimplementation_createdocument_with_capacity(
+    DOMDOMImplementation* impl,
+    const char* namespace_,
+    const char* qualifiedName,
+    DOMDocumentType* doctype,
+    size_t nodes,
+    size_t strings_bytes
+);
+
 /**
  * Check if feature is supported (legacy, always returns 1).
  * 
@@ -667,6 +1415,11 @@ uint8_t dom_abstractrange_get_collapsed(DOMAbstractRange* range);
  * Range Interface
  * ========================================================================= */
 
+/*
+ * Offsets in Text, Comment, CDATASection and ProcessingInstruction nodes are
+ * UTF-16 code units, like their length; other nodes use child indices.
+ */
+
 /**
  * Get the start container node.
  * 
@@ -735,6 +1488,23 @@ int32_t dom_range_setstart(DOMRange* range, DOMNode* node, uint32_t offset);
  */
 int32_t dom_range_setend(DOMRange* range, DOMNode* node, uint32_t offset);
 
+/**
+ * Set both boundary points at once (non-standard).
+ * 
+ * Equivalent to dom_range_setstart() then dom_range_setend(), but both
+ * points are validated first: on error the range is unchanged. If the end
+ * is before the start, the range collapses to the end.
+ * 
+ * @param range Range
+ * @param start_node Container node for start boundary
+ * @param start_offset Offset within start_node
+ * @param end_node Container node for end boundary
+ * @param end_offset Offset within end_node
+ * @return 0 on success, error code on failure
+ */
+int32_t dom_range_setbaseandextent(DOMRange* range, DOMNode* start_node, uint32_t start_offset,
+                                   DOMNode* end_node, uint32_t end_offset);
+
 /**
  * Set start before a node.
  * 
@@ -803,7 +1573,8 @@ int32_t dom_range_selectnode(DOMRange* range, DOMNode* node);
  * @param range Range
  * @param how Comparison type (DOM_RANGE_START_TO_START, etc.)
  * @param source_range Range to compare with
- * @return -1, 0, or 1, or error code (>= 8) on failure
+ * @return -1, 0, or 1, or error code (DOM_ERROR_NOT_SUPPORTED for an
+ *         unknown how, DOM_ERROR_WRONG_DOCUMENT) on failure
  */
 int16_t dom_range_compareboundarypoints(DOMRange* range, uint16_t how, DOMRange* source_range);
 
@@ -813,7 +1584,8 @@ int16_t dom_range_compareboundarypoints(DOMRange* range, uint16_t how, DOMRange*
  * @param range Range
  * @param node Node
  * @param offset Offset
- * @return -1, 0, or 1, or error code (>= 8) on failure
+ * @return -1, 0, or 1, or error code on failure. DOM_ERROR_INDEX_SIZE is
+ *         also 1; dom_range_ispointinrange() reports it as an error.
  */
 int16_t dom_range_comparepoint(DOMRange* range, DOMNode* node, uint32_t offset);
 
@@ -920,6 +1692,35 @@ void dom_range_detach(DOMRange* range);
  */
 const char* dom_range_tostring(DOMRange* range);
 
+/**
+ * Callback receiving one piece of a range's string.
+ * 
+ * data points into the Text node's own storage (UTF-8, not NUL-terminated)
+ * and is only valid during the call. The callback must not mutate the
+ * document.
+ */
+typedef void (*DOMRangeTextSegment)(const char* data, uint32_t length, void* user_data);
+
+/**
+ * Stream the range's string to a callback without building it.
+ * 
+ * Calls segment once per non-empty piece, in order; the pieces concatenate
+ * to dom_range_tostring()'s result. Nothing is allocated, so bindings can
+ * copy the text straight into their own string type.
+ * 
+ * @param range Range handle
+ * @param segment Called with each piece
+ * @param user_data Passed through to segment
+ * 
+ * Example:
+ *   static void append(const char* data, uint32_t length, void* user_data) {
+ *       fwrite(data, 1, length, (FILE*)user_data);
+ *   }
+ *   
+ *   dom_range_foreach_text(range, append, stdout);
+ */
+void dom_range_foreach_text(DOMRange* range, DOMRangeTextSegment segment, void* user_data);
+
 /**
  * Free string returned by dom_range_tostring().
  * 
@@ -990,6 +1791,36 @@ DOMElement* dom_element_insertadjacentelement(DOMElement* target, const char* wh
  */
 int32_t dom_element_insertadjacenttext(DOMElement* target, const char* where, const char* data);
 
+/**
+ * Parse markup and insert the nodes at a position relative to the target.
+ * 
+ * The nodes are built into a fragment and inserted in one step (one
+ * mutation record). See src/markup_parser.zig for the syntax.
+ * 
+ * @param target Element to insert relative to
+ * @param where Position: "beforebegin", "afterbegin", "beforeend", "afterend"
+ * @param markup UTF-8 markup (not null-terminated)
+ * @param length Length of markup in bytes
+ * @return 0 on success, error code on failure (DOM_ERROR_SYNTAX for an
+ *         invalid position, DOM_ERROR_NO_MODIFICATION_ALLOWED for
+ *         "beforebegin"/"afterend" without a parent element)
+ */
+int32_t dom_element_insertadjacentmarkup(DOMElement* target, const char* where, const uint8_t* markup, size_t length);
+
+/**
+ * Parse markup and replace the element's children with the nodes
+ * (innerHTML-style setter).
+ * 
+ * The old children are removed as one run and the new ones inserted in one
+ * step. Running out of memory while parsing leaves the children in place.
+ * 
+ * @param elem Element whose children to replace
+ * @param markup UTF-8 markup (not null-terminated)
+ * @param length Length of markup in bytes (0 removes the children)
+ * @return 0 on success, error code on failure
+ */
+int32_t dom_element_setinnermarkup(DOMElement* elem, const uint8_t* markup, size_t length);
+
 /* ============================================================================
  * DOMTokenList Interface (Element.classList)
  * ========================================================================= */
@@ -1075,6 +1906,35 @@ int32_t dom_element_set_classname(DOMElement* elem, const char* className);
  */
 const char* dom_element_getattribute(DOMElement* elem, const char* qualifiedName);
 
+/**
+ * Get element tag name as a string view.
+ * 
+ * @param elem Element
+ * @param out Receives the tag name (usually interned)
+ */
+void dom_element_get_tagname_view(DOMElement* elem, DOMStringView* out);
+
+/**
+ * Get an attribute value as a string view.
+ * 
+ * @param elem Element
+ * @param qualifiedName Attribute name
+ * @param out Receives the value (left untouched if not present)
+ * @return true if the attribute is present, false otherwise
+ * 
+ * Example:
+ *   DOMStringView view;
+ *   if (dom_element_getattribute_view(elem, "id", &view)) {
+ *     printf("ID: %.*s\n", (int)view.length, view.data);
+ *   }
+ */
+bool dom_element_getattribute_view(DOMElement* elem, const char* qualifiedName, DOMStringView* out);
+
+/**
+ * Get an attribute value as a string view, with a length-carrying name.
+ */
+bool dom_element_getattribute_view_n(DOMElement* elem, const char* qualifiedName, size_t qualifiedName_len, DOMStringView* out);
+
 /**
  * Set an attribute value.
  * 
@@ -1091,6 +1951,41 @@ const char* dom_element_getattribute(DOMElement* elem, const char* qualifiedName
  */
 int32_t dom_element_setattribute(DOMElement* elem, const char* qualifiedName, const char* value);
 
+/**
+ * Set an attribute value from length-carrying strings.
+ * 
+ * The _n variants take (pointer, length) pairs that need not be
+ * null-terminated, so callers holding sized buffers (JS engine strings)
+ * skip both the terminator and the strlen() on the DOM side. The strings
+ * are copied or interned; they only need to live for the call.
+ * 
+ * @param elem Element
+ * @param qualifiedName Attribute name bytes (UTF-8)
+ * @param qualifiedName_len Length of qualifiedName in bytes
+ * @param value Attribute value bytes (UTF-8)
+ * @param value_len Length of value in bytes
+ * @return 0 on success, error code on failure
+ */
+int32_t dom_element_setattribute_n(DOMElement* elem, const char* qualifiedName, size_t qualifiedName_len, const char* value, size_t value_len);
+
+/**
+ * Set several attributes in one call (non-standard).
+ * 
+ * Same as calling dom_element_setattribute_n() for each pair in order
+ * (one mutation record per attribute), with the attribute storage
+ * reserved once for all of them.
+ * 
+ * @param elem Element
+ * @param names Attribute name bytes (UTF-8), count entries
+ * @param name_lens Lengths of names in bytes
+ * @param values Attribute value bytes (UTF-8), count entries
+ * @param value_lens Lengths of values in bytes
+ * @param count Number of attributes
+ * @return 0 on success, error code on failure (the attributes before the
+ *         failing one are set)
+ */
+int32_t dom_element_setattributes(DOMElement* elem, const char* const* names, const size_t* name_lens, const char* const* values, const size_t* value_lens, uint32_t count);
+
 /**
  * Remove an attribute.
  * 
@@ -1100,6 +1995,11 @@ int32_t dom_element_setattribute(DOMElement* elem, const char* qualifiedName, co
  */
 int32_t dom_element_removeattribute(DOMElement* elem, const char* qualifiedName);
 
+/**
+ * Remove an attribute, with a length-carrying name.
+ */
+int32_t dom_element_removeattribute_n(DOMElement* elem, const char* qualifiedName, size_t qualifiedName_len);
+
 /**
  * Check if element has an attribute.
  * 
@@ -1109,6 +2009,39 @@ int32_t dom_element_removeattribute(DOMElement* elem, const char* qualifiedName)
  */
 uint8_t dom_element_hasattribute(DOMElement* elem, const char* qualifiedName);
 
+/**
+ * Check if an attribute exists, with a length-carrying name.
+ */
+uint8_t dom_element_hasattribute_n(DOMElement* elem, const char* qualifiedName, size_t qualifiedName_len);
+
+/**
+ * Get an attribute value as a string view, by atom.
+ * 
+ * @param elem Element
+ * @param name Atom from dom_document_intern_name() for elem's document
+ * @param out Receives the value (left untouched if not present)
+ * @return true if the attribute is present, false otherwise
+ */
+bool dom_element_getattribute_atom_view(DOMElement* elem, DOMAtom name, DOMStringView* out);
+
+/**
+ * Set an attribute value, by atom.
+ * 
+ * @param elem Element
+ * @param name Atom from dom_document_intern_name() for elem's document
+ * @param value Attribute value bytes (UTF-8)
+ * @param value_len Length of value in bytes
+ * @return 0 on success, error code on failure
+ */
+int32_t dom_element_setattribute_atom(DOMElement* elem, DOMAtom name, const char* value, size_t value_len);
+
+/**
+ * Check if an attribute exists, by atom.
+ * 
+ * @return 1 if present, 0 if not present
+ */
+uint8_t dom_element_hasattribute_atom(DOMElement* elem, DOMAtom name);
+
 /**
  * Toggle an attribute.
  * 
@@ -1196,6 +2129,54 @@ uint8_t dom_element_hasattributes(DOMElement* elem);
  */
 const char** dom_element_getattributenames(DOMElement* elem, uint32_t* count);
 
+/**
+ * Get attribute names as string views, without allocating.
+ * 
+ * @param elem Element
+ * @param out Array receiving up to capacity views (may be NULL)
+ * @param capacity Size of out
+ * @return Total number of attributes (retry with a larger array if > capacity)
+ * 
+ * Example:
+ *   DOMStringView names[16];
+ *   uint32_t count = dom_element_getattributenames_view(elem, names, 16);
+ */
+uint32_t dom_element_getattributenames_view(DOMElement* elem, DOMStringView* out, uint32_t capacity);
+
+/**
+ * Callback receiving one attribute name (only valid during the call).
+ */
+typedef void (*DOMAttributeNameCallback)(const DOMStringView* name, void* user_data);
+
+/**
+ * Hand each attribute name to a callback, in order, without allocating.
+ * 
+ * The callback must not mutate the element.
+ * 
+ * @param elem Element
+ * @param callback Called once per attribute
+ * @param user_data Passed through to callback
+ */
+void dom_element_foreach_attributename(DOMElement* elem, DOMAttributeNameCallback callback, void* user_data);
+
+/**
+ * Callback for dom_element_foreach_attribute(); name and value are only
+ * valid during the call.
+ */
+typedef void (*DOMAttributeCallback)(const DOMStringView* name, const DOMStringView* value, void* user_data);
+
+/**
+ * Hand each attribute name and value to a callback, in order.
+ * 
+ * Reads the attribute storage directly: no allocation and no Attr nodes.
+ * The callback must not mutate the element.
+ * 
+ * @param elem Element
+ * @param callback Called once per attribute
+ * @param user_data Passed through to callback
+ */
+void dom_element_foreach_attribute(DOMElement* elem, DOMAttributeCallback callback, void* user_data);
+
 /**
  * Free attribute names array.
  * 
@@ -1273,6 +2254,33 @@ int32_t dom_element_set_slot(DOMElement* elem, const char* value);
  */
 DOMElement* dom_element_get_assignedslot(DOMElement* elem);
 
+/**
+ * Get the number of nodes assigned to a slot element.
+ * 
+ * Read from the shadow root's cached assignments, which are rebuilt only
+ * after the host's children or an assignment change.
+ * 
+ * @param slot Slot element handle
+ * @return Number of assigned nodes (0 if not a slot in a shadow tree)
+ * 
+ * Example:
+ *   uint32_t n = dom_element_get_assignednodecount(slot);
+ *   for (uint32_t i = 0; i < n; i++) {
+ *       DOMNode* node = dom_element_get_assignednode(slot, i);
+ *       // ...
+ *   }
+ */
+uint32_t dom_element_get_assignednodecount(DOMElement* slot);
+
+/**
+ * Get a node assigned to a slot element, in tree order.
+ * 
+ * @param slot Slot element handle
+ * @param index Index (0-based)
+ * @return Assigned node or NULL if out of range (do NOT release)
+ */
+DOMNode* dom_element_get_assignednode(DOMElement* slot, uint32_t index);
+
 /**
  * Test if element matches a CSS selector.
  * 
@@ -1289,6 +2297,11 @@ DOMElement* dom_element_get_assignedslot(DOMElement* elem);
  */
 uint8_t dom_element_matches(DOMElement* elem, const char* selectors);
 
+/**
+ * Test an element against a length-carrying selector.
+ */
+uint8_t dom_element_matches_n(DOMElement* elem, const char* selectors, size_t selectors_len);
+
 /**
  * Find closest ancestor element matching a selector.
  * 
@@ -1307,6 +2320,11 @@ uint8_t dom_element_matches(DOMElement* elem, const char* selectors);
  */
 DOMElement* dom_element_closest(DOMElement* elem, const char* selectors);
 
+/**
+ * Find the closest matching ancestor, with a length-carrying selector.
+ */
+DOMElement* dom_element_closest_n(DOMElement* elem, const char* selectors, size_t selectors_len);
+
 /**
  * Webkit prefixed version of matches() for compatibility.
  * 
@@ -1333,6 +2351,11 @@ uint8_t dom_element_webkitmatchesselector(DOMElement* elem, const char* selector
  */
 DOMElement* dom_element_queryselector(DOMElement* elem, const char* selectors);
 
+/**
+ * Find the first matching descendant, with a length-carrying selector.
+ */
+DOMElement* dom_element_queryselector_n(DOMElement* elem, const char* selectors, size_t selectors_len);
+
 /**
  * Find all descendant elements matching a CSS selector.
  * 
@@ -1356,6 +2379,40 @@ DOMElement* dom_element_queryselector(DOMElement* elem, const char* selectors);
  */
 DOMNodeList* dom_element_queryselectorall(DOMElement* elem, const char* selectors);
 
+/**
+ * Find all matching descendants, with a length-carrying selector.
+ */
+DOMNodeList* dom_element_queryselectorall_n(DOMElement* elem, const char* selectors, size_t selectors_len);
+
+/**
+ * Test an element against a compiled selector (see dom_selector_compile()).
+ * 
+ * @return 1 if the element matches, 0 otherwise
+ */
+uint8_t dom_element_matches_compiled(DOMElement* elem, DOMSelector* selector);
+
+/**
+ * Find the closest inclusive ancestor matching a compiled selector.
+ * 
+ * @return Matching element or NULL
+ */
+DOMElement* dom_element_closest_compiled(DOMElement* elem, DOMSelector* selector);
+
+/**
+ * closest() with a compiled selector, answered from and recorded in a
+ * memo (see dom_closestmemo_new()).
+ * 
+ * @return Matching element or NULL
+ */
+DOMElement* dom_element_closest_memoized(DOMElement* elem, DOMClosestMemo* memo, DOMSelector* selector);
+
+/**
+ * Find the first matching descendant for a compiled selector.
+ * 
+ * @return Matching element or NULL
+ */
+DOMElement* dom_element_queryselector_compiled(DOMElement* elem, DOMSelector* selector);
+
 /**
  * Increment element reference count.
  * 
@@ -1536,6 +2593,10 @@ void dom_domtokenlist_release(DOMDOMTokenList* list);
 /**
  * Get node type.
  * 
+ * Shadow roots report DOM_SHADOW_ROOT_NODE, so bindings can tell them
+ * from plain document fragments; their Node.nodeType is
+ * DOM_DOCUMENT_FRAGMENT_NODE.
+ * 
  * @param node Node
  * @return Node type constant (DOM_ELEMENT_NODE, etc.)
  */
@@ -1664,10 +2725,68 @@ const char* dom_node_get_textcontent(DOMNode* node);
  */
 int32_t dom_node_set_textcontent(DOMNode* node, const char* value);
 
+/**
+ * Set textContent from a length-carrying UTF-8 string.
+ * 
+ * In documents that enable it (see
+ * dom_document_enable_inplace_textcontent()), a non-empty value keeps a
+ * sole Text child and replaces its data in place.
+ * 
+ * @param node Node
+ * @param value Text content (UTF-8, need not be null-terminated)
+ * @param length Length of value in bytes
+ * @return 0 on success, error code on failure
+ */
+int32_t dom_node_set_textcontent_n(DOMNode* node, const char* value, size_t length);
+
+/**
+ * Get textContent as a string view, if it is stored in one place.
+ * 
+ * Succeeds for character data nodes (their data) and for nodes whose text
+ * is in at most one non-empty Text descendant; the view borrows that
+ * node's storage until the next mutation.
+ * 
+ * @param node Node
+ * @param out Receives the text (left untouched on false)
+ * @return false if the text spans several Text nodes or textContent is
+ *         null; use dom_node_get_textcontent_length() and
+ *         dom_node_copy_textcontent() then
+ */
+bool dom_node_get_textcontent_view(DOMNode* node, DOMStringView* out);
+
+/**
+ * Get the length of textContent in UTF-8 bytes.
+ * 
+ * @param node Node
+ * @param out Receives the length (left untouched on false)
+ * @return false if textContent is null (Document, DocumentType)
+ */
+bool dom_node_get_textcontent_length(DOMNode* node, size_t* out);
+
+/**
+ * Copy textContent into a caller-provided buffer.
+ * 
+ * Example:
+ *   size_t length;
+ *   if (dom_node_get_textcontent_length(node, &length)) {
+ *     uint8_t* text = malloc(length);
+ *     dom_node_copy_textcontent(node, text, length);
+ *   }
+ * 
+ * @param node Node
+ * @param buffer Destination (UTF-8, not null-terminated), may be NULL
+ * @param capacity Size of buffer in bytes
+ * @return Full textContent length (0 if null); if larger than capacity,
+ *         buffer holds a prefix
+ */
+size_t dom_node_copy_textcontent(DOMNode* node, uint8_t* buffer, size_t capacity);
+
 /**
  * Get the root node of the tree.
  * 
- * Returns the root of the tree containing this node.
+ * Returns the root of the tree containing this node. O(1) for connected
+ * nodes, whose root is their document (or, with composed zero, their
+ * shadow root when in a shadow tree); disconnected nodes walk up.
  * 
  * @param node Node
  * @param composed If non-zero, pierces shadow boundaries; if zero, stops at shadow root
@@ -1690,6 +2809,16 @@ DOMNode* dom_node_getrootnode(DOMNode* node, uint8_t composed);
  */
 uint8_t dom_node_haschildnodes(DOMNode* node);
 
+/**
+ * Compare the tree position of two nodes.
+ * 
+ * @param node Node
+ * @param other Node to compare with
+ * @return Bitmask of DOM_DOCUMENT_POSITION_* flags describing other
+ *         relative to node (0 if they are the same node)
+ */
+uint16_t dom_node_comparedocumentposition(DOMNode* node, DOMNode* other);
+
 /**
  * Check if this node contains another node.
  * 
@@ -1749,81 +2878,700 @@ DOMNode* dom_node_removechild(DOMNode* parent, DOMNode* child);
  * @param child Old node to replace
  * @return The replaced child (must be released by caller)
  */
-DOMNode* dom_node_replacechild(DOMNode* parent, DOMNode* node, DOMNode* child);
+DOMNode* dom_node_replacechild(DOMNode* parent, DOMNode* node, DOMNode* child);
+
+/**
+ * Clone a node.
+ * 
+ * @param node Node to clone
+ * @param deep If 1, clone descendants too; if 0, shallow clone
+ * @return Cloned node (must be released by caller)
+ */
+DOMNode* dom_node_clonenode(DOMNode* node, uint8_t deep);
+
+/**
+ * Check if two nodes are the same (identity check).
+ * 
+ * @param node First node
+ * @param other Second node
+ * @return 1 if same, 0 if not
+ */
+uint8_t dom_node_issamenode(DOMNode* node, DOMNode* other);
+
+/**
+ * Check if two nodes are equal (value check).
+ * 
+ * @param node First node
+ * @param other Second node
+ * @return 1 if equal, 0 if not
+ */
+uint8_t dom_node_isequalnode(DOMNode* node, DOMNode* other);
+
+/**
+ * Get the structural hash of a node's subtree.
+ * 
+ * Not in WebIDL. Hashes what dom_node_isequalnode() compares (type, names,
+ * attributes in any order, data, children in order): equal nodes have equal
+ * hashes, so it serves as a cheap fingerprint for cache keys. Different
+ * hashes mean different nodes; equal hashes almost always mean equal nodes.
+ * Cached when the document enables structural hashes
+ * (see dom_document_enable_structural_hashes()).
+ * 
+ * @param node Node
+ * @param out Receives the hash on success
+ * @return 0 on success, error code on failure
+ */
+int dom_node_get_structural_hash(DOMNode* node, uint64_t* out);
+
+/**
+ * Normalize the node tree.
+ * 
+ * Merges adjacent text nodes and removes empty text nodes.
+ * 
+ * @param node Node
+ * @return 0 on success, error code on failure
+ */
+int32_t dom_node_normalize(DOMNode* node);
+
+// ============================================================================
+// NamedNodeMap
+// ============================================================================
+
+/**
+ * Get the element's attributes as a NamedNodeMap.
+ * 
+ * The handle is a view of the element (do NOT release it); it is valid as
+ * long as the element is.
+ * 
+ * @param elem Element
+ * @return NamedNodeMap handle
+ */
+DOMNamedNodeMap* dom_element_get_attributes(DOMElement* elem);
+
+/**
+ * Number of attributes.
+ * 
+ * @param map NamedNodeMap handle
+ * @return Attribute count
+ */
+uint32_t dom_namednodemap_get_length(DOMNamedNodeMap* map);
+
+/**
+ * Attr node at an index, in insertion order.
+ * 
+ * Attr nodes are created on first access and cached by the element, so the
+ * same index returns the same node until the attribute changes.
+ * 
+ * @param map NamedNodeMap handle
+ * @param index Zero-based index
+ * @return Attr (+1 reference, release with dom_attr_release), or NULL if out of range
+ */
+DOMAttr* dom_namednodemap_item(DOMNamedNodeMap* map, uint32_t index);
+
+/**
+ * Attr node with a qualified name.
+ * 
+ * @param map NamedNodeMap handle
+ * @param name Qualified name
+ * @return Attr (+1 reference, release with dom_attr_release), or NULL if not found
+ */
+DOMAttr* dom_namednodemap_getnameditem(DOMNamedNodeMap* map, const char* name);
+
+/**
+ * Borrowed variants of dom_namednodemap_item / _getnameditem.
+ * 
+ * Same Attr, without a reference for the caller: do NOT release it. It is
+ * valid while it is the element's attribute node (until the attribute is
+ * removed or replaced, or the element is destroyed), and reading a cached
+ * Attr writes no reference count. Namespaced lookups have no borrowed
+ * variant: those Attr nodes are not cached.
+ * 
+ * @return Attr (borrowed), or NULL if not found
+ */
+DOMAttr* dom_namednodemap_item_borrowed(DOMNamedNodeMap* map, uint32_t index);
+DOMAttr* dom_namednodemap_getnameditem_borrowed(DOMNamedNodeMap* map, const char* name);
+
+/**
+ * Attr node with a namespace and local name.
+ * 
+ * @param map NamedNodeMap handle
+ * @param ns Namespace URI (NULL for none)
+ * @param localName Local name
+ * @return Attr (+1 reference, release with dom_attr_release), or NULL if not found
+ */
+DOMAttr* dom_namednodemap_getnameditemns(DOMNamedNodeMap* map, const char* ns, const char* localName);
+
+// ============================================================================
+// Attr
+// ============================================================================
+
+/**
+ * Attr strings are not null-terminated; read them as views. A view is valid
+ * until the attribute's value (or the Attr) changes.
+ */
+void dom_attr_get_name_view(DOMAttr* attr, DOMStringView* out);
+void dom_attr_get_localname_view(DOMAttr* attr, DOMStringView* out);
+void dom_attr_get_value_view(DOMAttr* attr, DOMStringView* out);
+
+/**
+ * Nullable Attr strings as views.
+ * 
+ * @return false when the value is null (out is untouched)
+ */
+bool dom_attr_get_namespaceuri_view(DOMAttr* attr, DOMStringView* out);
+bool dom_attr_get_prefix_view(DOMAttr* attr, DOMStringView* out);
+
+/**
+ * Set the attribute's value.
+ * 
+ * @param attr Attribute node
+ * @param value New value (null-terminated)
+ * @return 0 on success, error code on failure
+ */
+int dom_attr_set_value(DOMAttr* attr, const char* value);
+
+/**
+ * Element the attribute belongs to.
+ * 
+ * @param attr Attribute node
+ * @return Owner element (borrowed), or NULL if detached
+ */
+DOMElement* dom_attr_get_ownerelement(DOMAttr* attr);
+
+// ============================================================================
+// Attr Reference Counting
+// ============================================================================
+
+/**
+ * Increment attribute reference count.
+ * 
+ * @param attr Attribute node
+ */
+void dom_attr_addref(DOMAttr* attr);
+
+/**
+ * Decrement attribute reference count.
+ * Frees the attribute if reference count reaches zero.
+ * 
+ * @param attr Attribute node
+ */
+void dom_attr_release(DOMAttr* attr);
+
+// ============================================================================
+// Node Reference Counting
+// ============================================================================
+
+/**
+ * Increment node reference count.
+ * 
+ * Not thread-safe, except for nodes of shared documents (see
+ * dom_document_share()), whose counts are updated atomically.
+ * 
+ * @param node Node
+ */
+void dom_node_addref(DOMNode* node);
+
+/**
+ * Decrement node reference count.
+ * 
+ * Atomic for nodes of shared documents, like dom_node_addref().
+ * 
+ * @param node Node
+ */
+void dom_node_release(DOMNode* node);
+
+/**
+ * Increment the reference count of a batch of nodes.
+ * 
+ * Same as dom_node_addref() on each entry, in a single call. Meant for
+ * bindings that keep copied node pointers (see dom_nodelist_static_items);
+ * drop them with dom_node_release_many().
+ * 
+ * @param nodes Nodes to reference (not documents)
+ * @param count Number of entries in nodes
+ */
+void dom_node_addref_many(DOMNode* const* nodes, size_t count);
+
+/**
+ * Release a batch of node references.
+ * 
+ * Same as releasing each entry in order with its release function
+ * (dom_document_release() for documents, dom_node_release() otherwise),
+ * in a single call. Meant for embedders that collect releases and apply
+ * them later, outside a GC pause.
+ * 
+ * @param nodes Nodes to release
+ * @param count Number of entries in nodes
+ */
+void dom_node_release_many(DOMNode* const* nodes, size_t count);
+
+/**
+ * Get the bytes a node holds by itself.
+ * 
+ * Counts the node's struct, character data, attribute storage and rare
+ * data; children and strings interned by the document are not included,
+ * so the sum over a subtree is what freeing it releases. A document
+ * counts its string pool and id index instead. Heap profilers
+ * use it to attribute DOM memory to the wrappers that keep it alive.
+ * 
+ * @param node Node
+ * @return Size in bytes
+ */
+size_t dom_node_get_self_bytes(DOMNode* node);
+
+// ============================================================================
+// Node Embedder Wrapper Slot
+// ============================================================================
+
+/**
+ * Get the embedder wrapper slot of a node.
+ * 
+ * The slot is an opaque 32-bit value reserved for JS engine bindings
+ * (e.g. an index into a per-isolate wrapper table). The DOM never reads it.
+ * Nodes of shared documents (see dom_document_share()) hold 0xFFFFFFFF.
+ * 
+ * @param node Node
+ * @return Value last stored with dom_node_set_wrapper_slot(), or 0 if none
+ */
+uint32_t dom_node_get_wrapper_slot(DOMNode* node);
+
+/**
+ * Set the embedder wrapper slot of a node.
+ * 
+ * Only one embedder may own the slot of a given node. Pass 0 to clear.
+ * 
+ * @param node Node
+ * @param slot Opaque embedder value
+ */
+void dom_node_set_wrapper_slot(DOMNode* node, uint32_t slot);
+
+// ============================================================================
+// Node Subtree Snapshot
+// ============================================================================
+
+/* Snapshot flags */
+#define DOM_SNAPSHOT_INCLUDE_NAMES  (1u << 0)
+#define DOM_SNAPSHOT_INCLUDE_TEXT   (1u << 1)
+
+/* Snapshot index meaning "no node" / "no name" */
+#define DOM_SNAPSHOT_NONE           0xFFFFFFFFu
+
+/**
+ * Snapshot buffer (free with dom_snapshot_free()).
+ * 
+ * Layout (native-endian, 4-byte aligned sections):
+ *   DOMSnapshotHeader
+ *   DOMSnapshotNode[node_count]       preorder, root first
+ *   DOMSnapshotName[name_count]       with DOM_SNAPSHOT_INCLUDE_NAMES
+ *   string bytes[strings_length]      UTF-8, not null-terminated
+ */
+typedef struct DOMSnapshotBuffer {
+    uint8_t* data;
+    size_t length;
+} DOMSnapshotBuffer;
+
+typedef struct DOMSnapshotHeader {
+    uint32_t magic;            /* 0x534D4F44 ("DOMS") */
+    uint16_t version;          /* 1 */
+    uint16_t flags;
+    uint32_t node_count;
+    uint32_t name_count;
+    uint32_t records_offset;
+    uint32_t names_offset;
+    uint32_t strings_offset;
+    uint32_t strings_length;
+} DOMSnapshotHeader;
+
+typedef struct DOMSnapshotNode {
+    uint8_t node_type;         /* nodeType */
+    uint8_t reserved[3];
+    uint32_t parent;           /* record index or DOM_SNAPSHOT_NONE */
+    uint32_t next_sibling;     /* record index or DOM_SNAPSHOT_NONE */
+    uint32_t name_id;          /* name table index or DOM_SNAPSHOT_NONE */
+    uint32_t text_offset;      /* character data, relative to strings_offset */
+    uint32_t text_length;
+} DOMSnapshotNode;
+
+typedef struct DOMSnapshotName {
+    uint32_t offset;           /* relative to strings_offset */
+    uint32_t length;
+} DOMSnapshotName;
+
+/**
+ * Serialize a subtree (root inclusive) into one flat buffer.
+ * 
+ * Walkers, serializers and diffing passes can read the records instead of
+ * crossing into the DOM for every node and property. Names are
+ * deduplicated per snapshot, so elements sharing a tag name share a name_id.
+ * 
+ * @param root Subtree root (record 0)
+ * @param flags DOM_SNAPSHOT_INCLUDE_NAMES | DOM_SNAPSHOT_INCLUDE_TEXT
+ * @param out Receives the buffer on success
+ * @return 0 on success, error code on failure
+ * 
+ * Example:
+ *   DOMSnapshotBuffer snap;
+ *   if (dom_node_snapshot_subtree(root, DOM_SNAPSHOT_INCLUDE_NAMES, &snap) == 0) {
+ *       const DOMSnapshotHeader* header = (const DOMSnapshotHeader*)snap.data;
+ *       printf("%u nodes\n", header->node_count);
+ *       dom_snapshot_free(snap.data, snap.length);
+ *   }
+ */
+int32_t dom_node_snapshot_subtree(DOMNode* root, uint32_t flags, DOMSnapshotBuffer* out);
+
+/**
+ * Free a snapshot buffer.
+ * 
+ * @param data DOMSnapshotBuffer.data
+ * @param length DOMSnapshotBuffer.length
+ */
+void dom_snapshot_free(uint8_t* data, size_t length);
+
+// ============================================================================
+// Node Tree Diff
+// ============================================================================
+
+/* Patch operations (DOMPatchRecord.op) */
+#define DOM_PATCH_INSERT            1  /* copy of source into target, before the ref */
+#define DOM_PATCH_REMOVE            2  /* target leaves its parent */
+#define DOM_PATCH_MOVE              3  /* target moves before the ref */
+#define DOM_PATCH_REPLACE           4  /* copy of source replaces target */
+#define DOM_PATCH_SET_ATTRIBUTE     5  /* name is the qualified name */
+#define DOM_PATCH_REMOVE_ATTRIBUTE  6  /* name is the local name */
+#define DOM_PATCH_SET_TEXT          7  /* value is the new data */
+
+/**
+ * Patch buffer layout (native-endian, 4-byte aligned sections), in a
+ * DOMSnapshotBuffer:
+ *   DOMPatchHeader
+ *   DOMPatchRecord[op_count]          in application order
+ *   DOMSnapshotName[string_count]     string table
+ *   string bytes[strings_length]      UTF-8, not null-terminated
+ * 
+ * Nodes are preorder indices, root 0, as in dom_node_snapshot_subtree():
+ * target and before index the old tree before the patch, source and
+ * before_source the new tree. The reference sibling of insert and move is
+ * old node before or the node inserted for before_source; with both
+ * DOM_SNAPSHOT_NONE the node is appended. String fields index the string
+ * table (DOM_SNAPSHOT_NONE if absent).
+ */
+typedef struct DOMPatchHeader {
+    uint32_t magic;            /* 0x504D4F44 ("DOMP") */
+    uint16_t version;          /* 1 */
+    uint16_t reserved;
+    uint32_t op_count;
+    uint32_t string_count;
+    uint32_t strings_length;
+    uint32_t old_node_count;
+    uint32_t new_node_count;
+    uint32_t reserved2;
+} DOMPatchHeader;
+
+typedef struct DOMPatchRecord {
+    uint8_t op;                /* DOM_PATCH_* */
+    uint8_t reserved[3];
+    uint32_t target;           /* old node changed (parent for insert) */
+    uint32_t source;           /* new node copied by insert and replace */
+    uint32_t before;           /* old reference sibling */
+    uint32_t before_source;    /* new index of an inserted reference sibling */
+    uint32_t name;             /* attribute name */
+    uint32_t namespace_uri;    /* attribute namespace */
+    uint32_t value;            /* attribute value or character data */
+} DOMPatchRecord;
+
+/**
+ * Compute the patch that turns the subtree of old into that of new.
+ * 
+ * Children are matched per child list: with key, element children
+ * carrying that attribute match the old child with the same value; other
+ * children match by position. Matched nodes need the same type and name;
+ * their attribute and character data changes become set ops, and
+ * children out of order become move ops. Neither tree is changed.
+ * 
+ * @param old Old subtree root
+ * @param new_root New subtree root (may be in another document)
+ * @param key Key attribute name, or NULL
+ * @param out Receives the buffer on success
+ * @return 0 on success, error code on failure
+ */
+int32_t dom_node_diff(DOMNode* old, DOMNode* new_root, const char* key, DOMSnapshotBuffer* out);
+
+/**
+ * Free a patch buffer.
+ * 
+ * @param data DOMSnapshotBuffer.data
+ * @param length DOMSnapshotBuffer.length
+ */
+void dom_patch_free(uint8_t* data, size_t length);
+
+// ============================================================================
+// Node Serialization
+// ============================================================================
+
+/* Serialization flags */
+#define DOM_SERIALIZE_CHILDREN_ONLY (1u << 0)  /* innerHTML-style */
+#define DOM_SERIALIZE_XML           (1u << 1)  /* <empty/>, <?pi ?>, no &nbsp; */
+
+/**
+ * Callback receiving one chunk of serialized markup.
+ * 
+ * data is UTF-8, not null-terminated, and only valid during the call. The
+ * callback must not mutate the document.
+ */
+typedef void (*DOMMarkupChunk)(const char* data, uint32_t length, void* user_data);
+
+/**
+ * Stream the markup of node (outerHTML-style) to a callback.
+ * 
+ * Markup is assembled in fixed-size chunks straight from the nodes'
+ * interned names and own data; nothing is allocated. Elements always get an
+ * end tag (no element is special-cased by name) unless DOM_SERIALIZE_XML
+ * closes empty ones as <name/>.
+ * 
+ * @param node Node to serialize
+ * @param flags DOM_SERIALIZE_CHILDREN_ONLY | DOM_SERIALIZE_XML
+ * @param chunk Called with each chunk, in order
+ * @param user_data Passed through to chunk
+ * 
+ * Example:
+ *   static void write_chunk(const char* data, uint32_t length, void* user_data) {
+ *       fwrite(data, 1, length, (FILE*)user_data);
+ *   }
+ * 
+ *   dom_node_serialize(root, 0, write_chunk, stdout);
+ */
+void dom_node_serialize(DOMNode* node, uint32_t flags, DOMMarkupChunk chunk, void* user_data);
+
+/**
+ * Serialize the markup of node into a caller-provided buffer.
+ * 
+ * @param node Node to serialize
+ * @param flags DOM_SERIALIZE_CHILDREN_ONLY | DOM_SERIALIZE_XML
+ * @param buffer Destination (may be NULL to measure)
+ * @param capacity Size of buffer
+ * @return Full markup length; if larger than capacity, buffer holds a
+ *         prefix and the call can be repeated with a larger buffer
+ */
+size_t dom_node_serialize_into(DOMNode* node, uint32_t flags, uint8_t* buffer, size_t capacity);
+
+/**
+ * Get the child list generation.
+ * 
+ * Changes whenever a child of node is inserted or removed. Bindings can
+ * cache a child array and refill it only when the generation differs.
+ * 
+ * @param node Parent node
+ * @return Current generation
+ */
+uint32_t dom_node_get_child_generation(DOMNode* node);
+
+/**
+ * Copy child node pointers into an array.
+ * 
+ * Fills out with up to capacity children in tree order. Pointers are
+ * borrowed (not addref'd).
+ * 
+ * @param node Parent node
+ * @param out Array to fill (may be NULL when capacity is 0)
+ * @param capacity Size of out
+ * @return Total number of children (may exceed capacity)
+ * 
+ * Example:
+ *   DOMNode* stack[32];
+ *   uint32_t count = dom_node_get_children_array(parent, stack, 32);
+ *   if (count > 32) { ... allocate count entries and call again ... }
+ */
+uint32_t dom_node_get_children_array(DOMNode* node, DOMNode** out, uint32_t capacity);
+
+/**
+ * Copy element child pointers into an array.
+ * 
+ * Same as dom_node_get_children_array(), restricted to Element children.
+ * 
+ * @param node Parent node
+ * @param out Array to fill (may be NULL when capacity is 0)
+ * @param capacity Size of out
+ * @return Total number of element children (may exceed capacity)
+ */
+uint32_t dom_node_get_element_children_array(DOMNode* node, DOMNode** out, uint32_t capacity);
+
+// ============================================================================
+// Tree Builder
+// ============================================================================
+
+typedef struct DOMTreeBuilder DOMTreeBuilder;
+
+/* Builder instruction opcodes (see dom_builder_write()) */
+#define DOM_BUILDER_OPEN            1
+#define DOM_BUILDER_TEXT            2
+#define DOM_BUILDER_CLOSE           3
+
+/**
+ * One attribute for dom_builder_open() (null-terminated UTF-8).
+ */
+typedef struct DOMBuilderAttribute {
+    const char* name;
+    const char* value;
+} DOMBuilderAttribute;
+
+/**
+ * Create a push-style tree builder.
+ * 
+ * The builder creates nodes in document order and links each one straight
+ * into a private DocumentFragment, skipping the per-node insertion steps
+ * (validation, adoption, range updates, mutation records) that nothing can
+ * observe yet. Insert the finished fragment once: it is one insertion
+ * however many nodes it holds.
+ * 
+ * The builder holds a reference on the document, and is used on the
+ * document's current thread (see dom_document_new()).
+ * 
+ * @param doc Document that owns the built nodes
+ * @return Builder, or NULL on allocation failure (release with
+ *         dom_builder_release())
+ */
+DOMTreeBuilder* dom_builder_new(DOMDocument* doc);
+
+/**
+ * Open an element as the last child of the current element.
+ * 
+ * @param builder Builder
+ * @param tag_name Tag name
+ * @param attributes Attributes (may be NULL when count is 0)
+ * @param count Number of attributes
+ * @return 0 on success, error code on failure
+ */
+int dom_builder_open(DOMTreeBuilder* builder, const char* tag_name,
+                     const DOMBuilderAttribute* attributes, uint32_t count);
 
 /**
- * Clone a node.
+ * Append text to the current element.
  * 
- * @param node Node to clone
- * @param deep If 1, clone descendants too; if 0, shallow clone
- * @return Cloned node (must be released by caller)
+ * Text that directly follows other text joins its Text node.
+ * 
+ * @param builder Builder
+ * @param data UTF-8 text (not null-terminated)
+ * @param length Length in bytes
+ * @return 0 on success, error code on failure
  */
-DOMNode* dom_node_clonenode(DOMNode* node, uint8_t deep);
+int dom_builder_text(DOMTreeBuilder* builder, const char* data, uint32_t length);
 
 /**
- * Check if two nodes are the same (identity check).
+ * Close the current element.
  * 
- * @param node First node
- * @param other Second node
- * @return 1 if same, 0 if not
+ * @param builder Builder
+ * @return 0 on success, DOM_ERROR_INVALID_STATE if no element is open
  */
-uint8_t dom_node_issamenode(DOMNode* node, DOMNode* other);
+int dom_builder_close(DOMTreeBuilder* builder);
 
 /**
- * Check if two nodes are equal (value check).
+ * Run a chunk of encoded instructions in one call.
  * 
- * @param node First node
- * @param other Second node
- * @return 1 if equal, 0 if not
+ * Lengths are little-endian uint32; strings are UTF-8, not terminated:
+ *   DOM_BUILDER_OPEN   u8, u32 tag_len, tag, u32 attr_count,
+ *                      attr_count * (u32 name_len, name, u32 value_len, value)
+ *   DOM_BUILDER_TEXT   u8, u32 len, data
+ *   DOM_BUILDER_CLOSE  u8
+ * 
+ * A chunk holds whole instructions; open elements carry over to the next
+ * chunk.
+ * 
+ * @param builder Builder
+ * @param instructions Encoded instructions
+ * @param length Length in bytes
+ * @return 0 on success, DOM_ERROR_SYNTAX for a truncated instruction or
+ *         unknown opcode (earlier instructions have run), or the error of
+ *         the failing instruction
  */
-uint8_t dom_node_isequalnode(DOMNode* node, DOMNode* other);
+int dom_builder_write(DOMTreeBuilder* builder, const uint8_t* instructions, size_t length);
 
 /**
- * Normalize the node tree.
+ * Close every open element and take the built fragment.
  * 
- * Merges adjacent text nodes and removes empty text nodes.
+ * The builder starts a new fragment on its next node.
  * 
- * @param node Node
- * @return 0 on success, error code on failure
+ * @param builder Builder
+ * @return Fragment (possibly empty; release with
+ *         dom_documentfragment_release()), or NULL on allocation failure
+ * 
+ * Example:
+ *   DOMTreeBuilder* builder = dom_builder_new(doc);
+ *   DOMBuilderAttribute attrs[] = {{"class", "rows"}};
+ *   dom_builder_open(builder, "list", attrs, 1);
+ *   dom_builder_text(builder, "first", 5);
+ *   dom_builder_close(builder);
+ *   DOMDocumentFragment* fragment = dom_builder_finish(builder);
+ *   dom_node_appendchild(parent, (DOMNode*)fragment);
+ *   dom_documentfragment_release(fragment);
+ *   dom_builder_release(builder);
  */
-int32_t dom_node_normalize(DOMNode* node);
+DOMDocumentFragment* dom_builder_finish(DOMTreeBuilder* builder);
+
+/**
+ * Release a builder, any unfinished tree and its document reference.
+ * 
+ * @param builder Builder
+ */
+void dom_builder_release(DOMTreeBuilder* builder);
 
 // ============================================================================
-// Attr Reference Counting
+// Template
 // ============================================================================
 
+typedef struct DOMTemplate DOMTemplate;
+
 /**
- * Increment attribute reference count.
+ * Compile a subtree into a template.
  * 
- * @param attr Attribute node
+ * The subtree is flattened once; every instance is then created in one
+ * call, linking nodes directly instead of inserting them one by one. Holes
+ * are nodes of the subtree whose copies each instance hands back, so they
+ * can be filled in without walking child paths. The template copies what
+ * it needs; the source may change afterwards.
+ * 
+ * @param root Element or DocumentFragment; descendants must be elements,
+ *             Text or Comment nodes
+ * @param holes Nodes of the subtree (may be NULL when hole_count is 0)
+ * @param hole_count Number of holes
+ * @return Template (release with dom_template_release()), or NULL for an
+ *         unsupported node, a hole outside the subtree or allocation failure
  */
-void dom_attr_addref(DOMAttr* attr);
+DOMTemplate* dom_template_compile(DOMNode* root, DOMNode* const* holes, uint32_t hole_count);
 
 /**
- * Decrement attribute reference count.
- * Frees the attribute if reference count reaches zero.
+ * Get the number of holes of a template.
  * 
- * @param attr Attribute node
+ * @param tmpl Template
+ * @return Number of entries dom_template_instantiate() writes
  */
-void dom_attr_release(DOMAttr* attr);
-
-// ============================================================================
-// Node Reference Counting
-// ============================================================================
+uint32_t dom_template_get_holecount(DOMTemplate* tmpl);
 
 /**
- * Increment node reference count.
+ * Create an instance of a template.
  * 
- * @param node Node
+ * @param tmpl Template
+ * @param doc Document that owns the new nodes
+ * @param holes_out Receives the copy of each hole, in compile order (may be
+ *                  NULL when the template has no holes); borrowed from the
+ *                  instance
+ * @return Root of the instance (release with dom_node_release()), or NULL
+ *         on allocation failure
+ * 
+ * Example:
+ *   DOMNode* holes[1];
+ *   DOMNode* row = dom_template_instantiate(tmpl, doc, holes);
+ *   dom_node_set_textcontent(holes[0], "first");
+ *   dom_node_appendchild(list, row);
+ *   dom_node_release(row);
  */
-void dom_node_addref(DOMNode* node);
+DOMNode* dom_template_instantiate(DOMTemplate* tmpl, DOMDocument* doc, DOMNode** holes_out);
 
 /**
- * Decrement node reference count.
+ * Release a template (instances are independent of it).
  * 
- * @param node Node
+ * @param tmpl Template
  */
-void dom_node_release(DOMNode* node);
+void dom_template_release(DOMTemplate* tmpl);
 
 // ============================================================================
 // MutationObserver
@@ -1831,6 +3579,7 @@ void dom_node_release(DOMNode* node);
 
 typedef struct DOMMutationObserver DOMMutationObserver;
 typedef struct DOMMutationRecord DOMMutationRecord;
+typedef struct DOMMutationBatch DOMMutationBatch;
 
 /**
  * C callback function type for MutationObserver.
@@ -1854,6 +3603,12 @@ typedef void (*DOMMutationCallback)(
  * 
  * Corresponds to MutationObserverInit dictionary in WebIDL.
  * Use 255 for undefined boolean values.
+ *
+ * Extension: with coalesce=1 the registration queues at most one attributes
+ * record per (target, attribute) until the queue is taken, keeping the first
+ * oldValue, and merges a childList mutation into the last queued record when
+ * it continues that record's run of insertions (after its last added node)
+ * or removals (of the node after its last removed one) on the same parent.
  */
 typedef struct {
     uint8_t child_list;              /* 0=false, 1=true */
@@ -1862,6 +3617,7 @@ typedef struct {
     uint8_t subtree;                 /* 0=false, 1=true */
     uint8_t attribute_old_value;     /* 0=false, 1=true, 255=undefined */
     uint8_t character_data_old_value; /* 0=false, 1=true, 255=undefined */
+    uint8_t coalesce;                /* 0=false, 1=true (extension, see below) */
     const char** attribute_filter;   /* null-terminated array of strings, or NULL */
 } DOMMutationObserverInit;
 
@@ -1909,6 +3665,36 @@ DOMMutationRecord** dom_mutationobserver_takerecords(
     uint32_t* out_count
 );
 
+/**
+ * Callback type for pending-record notifications.
+ * 
+ * @param observer The MutationObserver whose record queue became non-empty
+ * @param context User-provided context pointer
+ */
+typedef void (*DOMMutationNotify)(DOMMutationObserver* observer, void* context);
+
+/**
+ * Set (or clear, with NULL) the pending-records notification.
+ * 
+ * notify runs when a record is queued while the record queue is empty,
+ * in the middle of the DOM mutation that queued it. It must not touch the
+ * DOM; use it to schedule delivery (e.g. a microtask that takes a batch).
+ * 
+ * @param observer MutationObserver handle
+ * @param notify Function to call, or NULL
+ * @param context User-provided context pointer (passed to notify)
+ */
+void dom_mutationobserver_set_notify(DOMMutationObserver* observer, DOMMutationNotify notify, void* context);
+
+/**
+ * Take all pending mutation records as one packed batch.
+ * 
+ * @param observer MutationObserver handle
+ * @return Batch (possibly empty), or NULL on allocation failure, in which
+ *         case the records stay queued. Release with dom_mutationbatch_release.
+ */
+DOMMutationBatch* dom_mutationobserver_takebatch(DOMMutationObserver* observer);
+
 /**
  * Release a MutationObserver.
  * 
@@ -1999,6 +3785,102 @@ const char* dom_mutationrecord_get_oldvalue(const DOMMutationRecord* record);
  */
 void dom_mutationrecord_release(DOMMutationRecord* record);
 
+// MutationRecord batches
+//
+// A batch packs a record queue into integer rows of DOM_MUTATION_BATCH_STRIDE
+// values. Node fields are indexes into the batch's node table, and
+// addedNodes / removedNodes are ranges of the batch's node lists.
+
+#define DOM_MUTATION_BATCH_STRIDE          8
+#define DOM_MUTATION_BATCH_NONE            0xFFFFFFFF  /* No node */
+
+#define DOM_MUTATION_FIELD_TYPE            0  /* DOM_MUTATION_TYPE_* */
+#define DOM_MUTATION_FIELD_TARGET          1  /* Node index */
+#define DOM_MUTATION_FIELD_ADDED_OFFSET    2  /* Index into node lists */
+#define DOM_MUTATION_FIELD_ADDED_COUNT     3
+#define DOM_MUTATION_FIELD_REMOVED_OFFSET  4  /* Index into node lists */
+#define DOM_MUTATION_FIELD_REMOVED_COUNT   5
+#define DOM_MUTATION_FIELD_PREVIOUS_SIBLING 6 /* Node index or NONE */
+#define DOM_MUTATION_FIELD_NEXT_SIBLING    7  /* Node index or NONE */
+
+#define DOM_MUTATION_TYPE_ATTRIBUTES       0
+#define DOM_MUTATION_TYPE_CHARACTER_DATA   1
+#define DOM_MUTATION_TYPE_CHILD_LIST       2
+
+/**
+ * Get the number of records in a batch.
+ * 
+ * @param batch Batch handle
+ * @return Number of records
+ */
+uint32_t dom_mutationbatch_get_count(const DOMMutationBatch* batch);
+
+/**
+ * Get the packed records (count * DOM_MUTATION_BATCH_STRIDE values).
+ * 
+ * @param batch Batch handle
+ * @return Rows of DOM_MUTATION_FIELD_* values, or NULL if empty.
+ *         Valid until the batch is released.
+ */
+const uint32_t* dom_mutationbatch_get_entries(const DOMMutationBatch* batch);
+
+/**
+ * Get the node indexes of every addedNodes / removedNodes list.
+ * 
+ * @param batch Batch handle
+ * @param out_count Pointer to store the number of indexes
+ * @return Node indexes, or NULL if none. Valid until the batch is released.
+ */
+const uint32_t* dom_mutationbatch_get_nodelists(const DOMMutationBatch* batch, uint32_t* out_count);
+
+/**
+ * Get the node table: every node the records reference, each once.
+ * 
+ * The batch holds a reference on each node.
+ * 
+ * @param batch Batch handle
+ * @param out_count Pointer to store the number of nodes
+ * @return Node pointers, or NULL if none. Valid until the batch is released.
+ */
+DOMNode* const* dom_mutationbatch_get_nodes(const DOMMutationBatch* batch, uint32_t* out_count);
+
+/**
+ * Get the attributeName of a record.
+ * 
+ * @param batch Batch handle
+ * @param index Record index
+ * @param out View to fill (valid until the batch is released)
+ * @return false if the record has none or index is out of range
+ */
+bool dom_mutationbatch_get_attributename(const DOMMutationBatch* batch, uint32_t index, DOMStringView* out);
+
+/**
+ * Get the attributeNamespace of a record.
+ * 
+ * @param batch Batch handle
+ * @param index Record index
+ * @param out View to fill (valid until the batch is released)
+ * @return false if the record has none or index is out of range
+ */
+bool dom_mutationbatch_get_attributenamespace(const DOMMutationBatch* batch, uint32_t index, DOMStringView* out);
+
+/**
+ * Get the oldValue of a record.
+ * 
+ * @param batch Batch handle
+ * @param index Record index
+ * @param out View to fill (valid until the batch is released)
+ * @return false if the record has none or index is out of range
+ */
+bool dom_mutationbatch_get_oldvalue(const DOMMutationBatch* batch, uint32_t index, DOMStringView* out);
+
+/**
+ * Release a batch, its records and its node references.
+ * 
+ * @param batch Batch handle
+ */
+void dom_mutationbatch_release(DOMMutationBatch* batch);
+
 // ============================================================================
 // TreeWalker & NodeFilter Constants
 // ============================================================================
@@ -2020,6 +3902,44 @@ typedef struct DOMTreeWalker DOMTreeWalker;
 #define DOM_NODEFILTER_SHOW_DOCUMENT_FRAGMENT    0x400
 #define DOM_NODEFILTER_SHOW_NOTATION             0x800
 
+// NodeFilter.FILTER_* results
+#define DOM_NODEFILTER_FILTER_ACCEPT             1
+#define DOM_NODEFILTER_FILTER_REJECT             2
+#define DOM_NODEFILTER_FILTER_SKIP               3
+
+// Native element filters (non-standard)
+
+/**
+ * Create a native element filter.
+ * 
+ * Accepts elements whose tag name is in the filter's set (if any names
+ * were added) and that carry its class (if one was set). Every other node
+ * gets miss_result. Evaluated in Zig, with no callback per node.
+ * 
+ * @param miss_result DOM_NODEFILTER_FILTER_SKIP or DOM_NODEFILTER_FILTER_REJECT
+ * @return New filter (release with dom_elementfilter_release), or NULL
+ */
+DOMElementFilter* dom_elementfilter_new(uint16_t miss_result);
+
+/**
+ * Add a tag name to the accepted set (compared exactly).
+ * 
+ * @return 0 on success, error code on failure
+ */
+int32_t dom_elementfilter_add_tagname(DOMElementFilter* filter, const char* name, size_t name_len);
+
+/**
+ * Require matching elements to carry a class (replaces any previous one).
+ * 
+ * @return 0 on success, error code on failure
+ */
+int32_t dom_elementfilter_set_classname(DOMElementFilter* filter, const char* name, size_t name_len);
+
+/**
+ * Release an element filter, after every walker or iterator using it.
+ */
+void dom_elementfilter_release(DOMElementFilter* filter);
+
 // TreeWalker properties
 
 /**
@@ -2112,6 +4032,19 @@ DOMNode* dom_treewalker_previousnode(DOMTreeWalker* walker);
  */
 DOMNode* dom_treewalker_nextnode(DOMTreeWalker* walker);
 
+/**
+ * Navigate forward by up to max nodes in one call (non-standard).
+ * 
+ * Equivalent to calling dom_treewalker_nextnode() until it returns NULL
+ * or max nodes have been returned; currentNode ends on the last one.
+ * 
+ * @param walker TreeWalker handle
+ * @param out Buffer receiving the nodes, in tree order
+ * @param max Capacity of out
+ * @return Number of nodes written (less than max once the walk is exhausted)
+ */
+uint32_t dom_treewalker_nextnodes(DOMTreeWalker* walker, DOMNode** out, uint32_t max);
+
 /**
  * Release a TreeWalker.
  * 
@@ -2163,6 +4096,19 @@ uint32_t dom_nodeiterator_get_whattoshow(const DOMNodeIterator* iterator);
  */
 DOMNode* dom_nodeiterator_nextnode(DOMNodeIterator* iterator);
 
+/**
+ * Navigate forward by up to max nodes in one call (non-standard).
+ * 
+ * Equivalent to calling dom_nodeiterator_nextnode() until it returns NULL
+ * or max nodes have been returned.
+ * 
+ * @param iterator NodeIterator handle
+ * @param out Buffer receiving the nodes, in iteration order
+ * @param max Capacity of out
+ * @return Number of nodes written (less than max once iteration is exhausted)
+ */
+uint32_t dom_nodeiterator_nextnodes(DOMNodeIterator* iterator, DOMNode** out, uint32_t max);
+
 /**
  * Navigate to previous node.
  * 
@@ -2185,6 +4131,259 @@ void dom_nodeiterator_detach(DOMNodeIterator* iterator);
  */
 void dom_nodeiterator_release(DOMNodeIterator* iterator);
 
+// ============================================================================
+// ElementIterator (non-standard)
+// ============================================================================
+
+/**
+ * Create an iterator over the element descendants of root, in tree order
+ * (root excluded). Non-element nodes are skipped natively.
+ * 
+ * The iterator references root and the node it resumes from; a batch
+ * resumed from a node no longer under root returns 0.
+ * 
+ * @param root Node whose descendants are iterated
+ * @return New iterator (release with dom_elementiterator_release), or NULL
+ */
+DOMElementIterator* dom_elementiterator_new(DOMNode* root);
+
+/**
+ * Get up to max next elements in one call.
+ * 
+ * @param iterator ElementIterator handle
+ * @param out Buffer receiving the elements, in tree order
+ * @param max Capacity of out
+ * @return Number of elements written (0 once iteration is exhausted)
+ */
+uint32_t dom_elementiterator_nextbatch(DOMElementIterator* iterator, DOMElement** out, uint32_t max);
+
+/**
+ * Continue after node, from its current position in the tree.
+ * 
+ * Elements of a batch are only valid while the document is unchanged
+ * (see dom_document_get_mutation_version()). A caller buffering a batch
+ * seeks after the last element it used once the version changes.
+ * 
+ * @param iterator ElementIterator handle
+ * @param node Node to continue after (root restarts; a node not under
+ *             root ends iteration)
+ */
+void dom_elementiterator_seek(DOMElementIterator* iterator, DOMNode* node);
+
+/**
+ * Release an ElementIterator and its node references.
+ * 
+ * @param iterator ElementIterator handle
+ */
+void dom_elementiterator_release(DOMElementIterator* iterator);
+
+// ============================================================================
+// Sliced Query (non-standard)
+// ============================================================================
+
+/* Query states (dom_query_get_state) */
+#define DOM_QUERY_RUNNING     0
+#define DOM_QUERY_DONE        1
+#define DOM_QUERY_INVALIDATED 2
+
+/**
+ * Start a querySelectorAll() over doc that runs in time-budgeted steps.
+ * 
+ * The query references doc. Once doc mutates, the next step returns 0
+ * and the query becomes DOM_QUERY_INVALIDATED; start a new one.
+ * 
+ * @param doc Document to query
+ * @param selectors Selector string (UTF-8, need not be null-terminated)
+ * @param selectors_len Length of selectors in bytes
+ * @return New query (release with dom_query_release), or NULL if the
+ *         selector is invalid
+ */
+DOMQuery* dom_query_begin(DOMDocument* doc, const char* selectors, size_t selectors_len);
+
+/**
+ * Visit elements for about budget_ns nanoseconds (or until max matches)
+ * and write the matches, in tree order.
+ * 
+ * Each step visits at least 256 elements unless out fills up, so a
+ * budget of 0 still makes progress. Matches are valid until doc mutates.
+ * 
+ * @param query Query handle
+ * @param budget_ns Time budget of this step
+ * @param out Buffer receiving the matches
+ * @param max Capacity of out
+ * @return Number of matches written (check dom_query_get_state() to
+ *         know whether to step again)
+ */
+uint32_t dom_query_step(DOMQuery* query, uint64_t budget_ns, DOMElement** out, uint32_t max);
+
+/**
+ * Get the state of a query.
+ * 
+ * @param query Query handle
+ * @return DOM_QUERY_RUNNING, DOM_QUERY_DONE or DOM_QUERY_INVALIDATED
+ */
+uint8_t dom_query_get_state(DOMQuery* query);
+
+/**
+ * Release a query and its references.
+ * 
+ * @param query Query handle
+ */
+void dom_query_release(DOMQuery* query);
+
+// ============================================================================
+// ClosestMemo (non-standard)
+// ============================================================================
+
+/**
+ * Create a closest() memo for event delegation.
+ * 
+ * dom_element_closest_memoized() remembers each connected element's
+ * answer per selector, so calls from nearby targets stop at the first
+ * ancestor already answered. Answers are dropped when the document's
+ * mutation version changes; clear the memo between dispatches to bound
+ * its size.
+ * 
+ * @return New memo (release with dom_closestmemo_release), or NULL
+ */
+DOMClosestMemo* dom_closestmemo_new(void);
+
+/**
+ * Forget every answer and release the memo's selector references.
+ * 
+ * @param memo ClosestMemo handle
+ */
+void dom_closestmemo_clear(DOMClosestMemo* memo);
+
+/**
+ * Get the number of remembered answers.
+ * 
+ * @param memo ClosestMemo handle
+ */
+uint32_t dom_closestmemo_count(DOMClosestMemo* memo);
+
+/**
+ * Release a ClosestMemo.
+ * 
+ * @param memo ClosestMemo handle
+ */
+void dom_closestmemo_release(DOMClosestMemo* memo);
+
+// ============================================================================
+// NodeTable (non-standard)
+// ============================================================================
+
+/*
+ * Integer handles for a document's nodes, for script algorithms that visit
+ * many nodes (layout prototypes, diffing) without a wrapper per node read.
+ * Ids are numbered per document on first use, fit in 30 bits and are never
+ * reused: once a node is destroyed or adopted by another document, its id
+ * names nothing. 0 is never a node. Tag names are numbered the same way
+ * (atoms), so element names compare as integers.
+ *
+ * Example:
+ *   uint32_t row = dom_nodetable_atom(doc, "row", 3);
+ *   uint32_t id = dom_nodetable_related(doc, dom_nodetable_id(root),
+ *                                       DOM_NODE_RELATION_FIRST_CHILD);
+ *   for (; id != 0; id = dom_nodetable_related(doc, id, DOM_NODE_RELATION_NEXT_SIBLING)) {
+ *       if (dom_nodetable_tag_atom(doc, id) == row) visit(dom_nodetable_node(doc, id));
+ *   }
+ */
+
+/* Relations of dom_nodetable_related() */
+#define DOM_NODE_RELATION_PARENT           0
+#define DOM_NODE_RELATION_FIRST_CHILD      1
+#define DOM_NODE_RELATION_LAST_CHILD       2
+#define DOM_NODE_RELATION_PREVIOUS_SIBLING 3
+#define DOM_NODE_RELATION_NEXT_SIBLING     4
+
+/**
+ * Get the id of a node in its owner document's table, numbering the node
+ * on first use (the first call enables the table).
+ * 
+ * @param node Node (a document gets an id in its own table)
+ * @return Id, or 0 for attributes, nodes without a document, nodes outside
+ *         the tree of a frozen document, or on allocation failure
+ */
+uint32_t dom_nodetable_id(DOMNode* node);
+
+/**
+ * Get the node of an id.
+ * 
+ * @param doc Document the id belongs to
+ * @param id Id from dom_nodetable_id() or dom_nodetable_related()
+ * @return Node (borrowed), or NULL if the id names no node
+ */
+DOMNode* dom_nodetable_node(DOMDocument* doc, uint32_t id);
+
+/**
+ * Get the id of a node's parent, first or last child, or previous or next
+ * sibling, numbering it if needed.
+ * 
+ * @param doc Document the id belongs to
+ * @param id Node id
+ * @param relation DOM_NODE_RELATION_*
+ * @return Id, or 0 if there is no such node
+ */
+uint32_t dom_nodetable_related(DOMDocument* doc, uint32_t id, uint8_t relation);
+
+/**
+ * Get the nodeType of an id.
+ * 
+ * @param doc Document the id belongs to
+ * @param id Node id
+ * @return nodeType, or 0 if the id names no node
+ */
+uint16_t dom_nodetable_nodetype(DOMDocument* doc, uint32_t id);
+
+/**
+ * Get the atom of an element's tag name.
+ * 
+ * @param doc Document the id belongs to
+ * @param id Node id
+ * @return Atom, or 0 if the id names no element
+ */
+uint32_t dom_nodetable_tag_atom(DOMDocument* doc, uint32_t id);
+
+/**
+ * Get the atom of a tag name (the first call enables the table).
+ * 
+ * Names compare exactly, as tagName does.
+ * 
+ * @param doc Document
+ * @param name Tag name (UTF-8, need not be null-terminated)
+ * @param name_len Length of name in bytes
+ * @return Atom, or 0 if a frozen document's table has none or on
+ *         allocation failure
+ */
+uint32_t dom_nodetable_atom(DOMDocument* doc, const char* name, size_t name_len);
+
+/**
+ * Get the tag name of an atom.
+ * 
+ * @param doc Document the atom belongs to
+ * @param atom Atom
+ * @param out Receives the name (interned, valid while doc lives)
+ * @return true, or false if there is no such atom
+ */
+bool dom_nodetable_atom_name(DOMDocument* doc, uint32_t atom, DOMStringView* out);
+
+/**
+ * Drop every id of a document's table; ids given out before never name a
+ * node again. Atoms are kept. Does nothing for frozen documents.
+ * 
+ * @param doc Document
+ */
+void dom_nodetable_clear(DOMDocument* doc);
+
+/**
+ * Get the number of a document's nodes with an id.
+ * 
+ * @param doc Document
+ * @return Node count
+ */
+uint32_t dom_nodetable_count(DOMDocument* doc);
+
 // ============================================================================
 // ChildNode Mixin
 // ============================================================================
@@ -2323,7 +4522,25 @@ DOMElement* dom_htmlcollection_item(DOMHTMLCollection* collection, uint32_t inde
  *   }
  *   dom_htmlcollection_release(children);
  */
-DOMElement* dom_htmlcollection_nameditem(DOMHTMLCollection* collection, const char* name);
+DOMElement* dom_htmlcollection_nameditem(DOMHTMLCollection* collection, const char* name);
+
+/**
+ * Copy the elements of an HTMLCollection into an array.
+ * 
+ * Fills out with up to capacity elements in collection order, in a single
+ * traversal. Pointers are borrowed (not addref'd).
+ * 
+ * @param collection HTMLCollection handle
+ * @param out Array to fill (may be NULL when capacity is 0)
+ * @param capacity Size of out
+ * @return Total number of elements (may exceed capacity)
+ * 
+ * Example:
+ *   DOMElement* stack[32];
+ *   uint32_t count = dom_htmlcollection_get_items(collection, stack, 32);
+ *   if (count > 32) { ... allocate count entries and call again ... }
+ */
+uint32_t dom_htmlcollection_get_items(DOMHTMLCollection* collection, DOMElement** out, uint32_t capacity);
 
 /**
  * Release an HTMLCollection.
@@ -2492,6 +4709,40 @@ bool dom_shadowroot_get_serializable(DOMShadowRoot* shadow);
  */
 DOMElement* dom_shadowroot_get_host(DOMShadowRoot* shadow);
 
+/**
+ * Find the element with the given id in the shadow tree.
+ * 
+ * Uses the shadow root's own id index (built on first use, then kept up
+ * to date by shadow-tree mutations only).
+ * 
+ * @param shadow Shadow root handle
+ * @param element_id Id to look up
+ * @return First element with the id in tree order or NULL (do NOT release)
+ */
+DOMElement* dom_shadowroot_getelementbyid(DOMShadowRoot* shadow, const char* element_id);
+
+/**
+ * Find the first element in the shadow tree matching a CSS selector.
+ * 
+ * Only the shadow tree is searched: not the host's children, and not
+ * shadow trees nested inside it.
+ * 
+ * @param shadow Shadow root handle
+ * @param selectors CSS selector string
+ * @return First matching element or NULL (do NOT release)
+ */
+DOMElement* dom_shadowroot_queryselector(DOMShadowRoot* shadow, const char* selectors);
+
+/**
+ * Find all elements in the shadow tree matching a CSS selector.
+ * 
+ * @param shadow Shadow root handle
+ * @param selectors CSS selector string
+ * @return Static NodeList or NULL if none match
+ *         (release with dom_nodelist_static_release())
+ */
+DOMNodeList* dom_shadowroot_queryselectorall(DOMShadowRoot* shadow, const char* selectors);
+
 // ============================================================================
 // AbortController & AbortSignal
 // ============================================================================
@@ -2594,6 +4845,84 @@ void dom_abortcontroller_release(DOMAbortController* controller);
  */
 DOMAbortSignal* dom_abortsignal_abort(void* reason);
 
+/**
+ * Create a signal that aborts when any of the given signals aborts
+ * (static factory, AbortSignal.any()).
+ * 
+ * The composite follows its sources through weak links: neither side holds
+ * a reference, and whichever is released (or aborts) first unlinks from
+ * the other in O(1), so composites that never abort don't accumulate on
+ * long-lived sources. The returned signal has ref_count = 1 - caller MUST
+ * call dom_abortsignal_release(). The sources are not acquired.
+ * 
+ * @param signals Source signals (can be NULL when count is 0)
+ * @param count Number of source signals
+ * @return AbortSignal handle (never NULL, already aborted if a source is)
+ * 
+ * Example:
+ *   DOMAbortSignal* sources[2] = { request_signal, shutdown_signal };
+ *   DOMAbortSignal* signal = dom_abortsignal_any(sources, 2);
+ *   fetch_with_abort(url, signal);
+ *   dom_abortsignal_release(signal);
+ */
+DOMAbortSignal* dom_abortsignal_any(DOMAbortSignal* const* signals, uint32_t count);
+
+/**
+ * The embedder's timer, behind every dom_abortsignal_timeout() signal.
+ * 
+ * now returns the time in milliseconds on a monotonic clock. arm asks for
+ * dom_abortsignal_run_timeouts() to be called at deadline (a time on that
+ * clock, possibly already past), replacing any deadline armed before;
+ * disarm cancels it. Pending timeouts are kept in coalesced timer wheels,
+ * so however many there are, only one timer is ever armed.
+ */
+typedef struct DOMTimerHost {
+    void* context;
+    uint64_t (*now)(void* context);
+    void (*arm)(void* context, uint64_t deadline);
+    void (*disarm)(void* context);
+} DOMTimerHost;
+
+/**
+ * Install (or, with NULL, remove) the timer host. The struct is copied.
+ * 
+ * Removing or replacing a host releases the signals still pending on the
+ * old one without aborting them.
+ * 
+ * @param host Timer host, or NULL
+ */
+void dom_abortsignal_set_timerhost(const DOMTimerHost* host);
+
+/**
+ * Abort every signal whose timeout has expired, then re-arm the host.
+ * Call it when the armed timer fires; calling it early is harmless.
+ * 
+ * @return 0 on success, or QuotaExceededError (22) if a signal could not
+ *         be aborted, in which case the host is re-armed to retry at once
+ */
+int32_t dom_abortsignal_run_timeouts(void);
+
+/**
+ * Create a signal that aborts with a "TimeoutError" DOMException after
+ * milliseconds, on the installed timer host (AbortSignal.timeout()).
+ * 
+ * No closure or timer handle is allocated per signal. A timeout never
+ * fires early; it may fire up to 1/8 of its delay late.
+ * 
+ * The returned signal has ref_count = 1 - caller MUST call
+ * dom_abortsignal_release(). The timer keeps its own reference until the
+ * timeout fires.
+ * 
+ * Example:
+ *   DOMAbortSignal* signal = dom_abortsignal_timeout(5000);
+ *   fetch_with_abort(url, signal);
+ *   dom_abortsignal_release(signal);
+ * 
+ * @param milliseconds Delay before the signal aborts
+ * @return Signal, or NULL if no timer host is installed
+ */
+DOMAbortSignal* dom_abortsignal_timeout(uint64_t milliseconds);
+
 /**
  * Check if signal has been aborted.
  * 
@@ -2715,6 +5044,39 @@ DOMStaticRange* dom_staticrange_new(
     uint32_t end_offset
 );
 
+/**
+ * Create many StaticRanges at once from a document's range pool.
+ * 
+ * Range i spans (containers[2i], offsets[2i]) to (containers[2i + 1],
+ * offsets[2i + 1]). The ranges come from contiguous slabs owned by the
+ * document and are reused once released, so highlight sets can be built
+ * and dropped cheaply. Release each with dom_staticrange_release(); until
+ * the last one is released they keep the document alive.
+ * 
+ * @param doc Document whose pool the ranges come from
+ * @param containers 2 * count boundary nodes (start, end per range)
+ * @param offsets 2 * count boundary offsets (UTF-16 code units in character data)
+ * @param count Number of ranges
+ * @param out Receives count range handles
+ * @return 0 on success, or a DOM error code (no range is created on error)
+ * 
+ * Example:
+ *   DOMNode* containers[4] = { text, text, text, text };
+ *   uint32_t offsets[4] = { 0, 4, 6, 9 };
+ *   DOMStaticRange* ranges[2];
+ *   if (dom_staticrange_new_many(doc, containers, offsets, 2, ranges) == 0) {
+ *       dom_staticrange_release(ranges[0]);
+ *       dom_staticrange_release(ranges[1]);
+ *   }
+ */
+int dom_staticrange_new_many(
+    DOMDocument* doc,
+    DOMNode* const* containers,
+    const uint32_t* offsets,
+    size_t count,
+    DOMStaticRange** out
+);
+
 /**
  * Get the start container node.
  * 
@@ -2945,6 +5307,28 @@ DOMText* dom_text_splittext(DOMText* text, uint32_t offset);
  */
 const char* dom_text_get_wholetext(DOMText* text);
 
+/**
+ * Write the concatenated text of this and adjacent Text nodes into a
+ * caller-provided buffer, without allocating.
+ * 
+ * @param text Text node
+ * @param buffer Receives the UTF-8 bytes, not null-terminated (may be NULL
+ *               if capacity is 0)
+ * @param capacity Size of buffer in bytes
+ * @return Length of the text in bytes; it is only written if it fits
+ *         (length <= capacity), so a too-small buffer doubles as a length
+ *         query
+ * 
+ * Example:
+ *   char stack[256];
+ *   size_t length = dom_text_get_wholetext_into(text, stack, sizeof(stack));
+ *   if (length > sizeof(stack)) {
+ *       char* heap = malloc(length);
+ *       dom_text_get_wholetext_into(text, heap, length);
+ *   }
+ */
+size_t dom_text_get_wholetext_into(DOMText* text, char* buffer, size_t capacity);
+
 /**
  * Free wholeText string allocated by dom_text_get_wholetext.
  * 
@@ -2958,9 +5342,85 @@ const char* dom_text_get_wholetext(DOMText* text);
 void dom_text_free_wholetext(const char* str);
 
 /* ============================================================================
- * CharacterData Interface (NonDocumentTypeChildNode mixin)
+ * CharacterData Interface
  * ========================================================================= */
 
+/*
+ * Offsets and counts are UTF-16 code units (DOMString offsets), converted
+ * with a per-node index: length is cached, ASCII data needs no conversion,
+ * and an edit near the previous one scans only the distance between them.
+ * The handle is any Text, Comment, CDATASection or ProcessingInstruction.
+ */
+
+/**
+ * Get the data (borrowed, valid until the next mutation).
+ */
+const char* dom_characterdata_get_data(DOMCharacterData* cdata);
+
+/**
+ * Set the data (data attribute setter).
+ * 
+ * @return 0 on success, error code on failure
+ */
+int dom_characterdata_set_data(DOMCharacterData* cdata, const char* data);
+
+/**
+ * Set the data from length-carrying data.
+ */
+int dom_characterdata_set_data_n(DOMCharacterData* cdata, const char* data, size_t data_len);
+
+/**
+ * Get the length of the data in UTF-16 code units.
+ */
+uint32_t dom_characterdata_get_length(DOMCharacterData* cdata);
+
+/**
+ * substringData(offset, count) as a view of the node's data (no copy).
+ * 
+ * The view is valid until the next mutation of the node.
+ * 
+ * @param count Code units to read (clamped to the end)
+ * @return 0 on success, 1 (IndexSizeError) if offset > length
+ * 
+ * Example:
+ *   DOMStringView sub;
+ *   if (dom_characterdata_substringdata(cdata, 0, 5, &sub) == 0) {
+ *       printf("%.*s\n", (int)sub.length, sub.data);
+ *   }
+ */
+int dom_characterdata_substringdata(DOMCharacterData* cdata, uint32_t offset, uint32_t count, DOMStringView* out);
+
+/**
+ * appendData(data).
+ * 
+ * @return 0 on success, error code on failure
+ */
+int dom_characterdata_appenddata(DOMCharacterData* cdata, const char* data);
+int dom_characterdata_appenddata_n(DOMCharacterData* cdata, const char* data, size_t data_len);
+
+/**
+ * insertData(offset, data).
+ * 
+ * @return 0 on success, 1 (IndexSizeError) if offset > length
+ */
+int dom_characterdata_insertdata(DOMCharacterData* cdata, uint32_t offset, const char* data);
+int dom_characterdata_insertdata_n(DOMCharacterData* cdata, uint32_t offset, const char* data, size_t data_len);
+
+/**
+ * deleteData(offset, count); count is clamped to the end.
+ * 
+ * @return 0 on success, 1 (IndexSizeError) if offset > length
+ */
+int dom_characterdata_deletedata(DOMCharacterData* cdata, uint32_t offset, uint32_t count);
+
+/**
+ * replaceData(offset, count, data); count is clamped to the end.
+ * 
+ * @return 0 on success, 1 (IndexSizeError) if offset > length
+ */
+int dom_characterdata_replacedata(DOMCharacterData* cdata, uint32_t offset, uint32_t count, const char* data);
+int dom_characterdata_replacedata_n(DOMCharacterData* cdata, uint32_t offset, uint32_t count, const char* data, size_t data_len);
+
 /**
  * Get previous element sibling (CharacterData).
  * 
@@ -3030,6 +5490,20 @@ uint32_t dom_nodelist_static_get_length(DOMNodeList* list);
  */
 DOMNode* dom_nodelist_static_item(DOMNodeList* list, uint32_t index);
 
+/**
+ * Copy all node pointers from a static NodeList into an array.
+ * 
+ * Reads the whole list in one call instead of one
+ * dom_nodelist_static_item() per index. Pointers are borrowed; reference
+ * them with dom_node_addref_many() to keep them past the list.
+ * 
+ * @param list NodeList handle from querySelectorAll
+ * @param out Array to fill (may be NULL when capacity is 0)
+ * @param capacity Size of out
+ * @return Total number of nodes in the list (may exceed capacity)
+ */
+uint32_t dom_nodelist_static_items(DOMNodeList* list, DOMNode** out, uint32_t capacity);
+
 /**
  * Release static NodeList from querySelectorAll.
  * 
@@ -3044,10 +5518,183 @@ DOMNode* dom_nodelist_static_item(DOMNodeList* list, uint32_t index);
  */
 void dom_nodelist_static_release(DOMNodeList* list);
 
+/* ============================================================================
+ * EventTarget Interface
+ * ========================================================================= */
+
+/**
+ * Event listener callback.
+ * 
+ * @param event Event being dispatched (borrowed)
+ * @param user_data Context pointer given when the listener was added
+ */
+typedef void (*DOMEventListener)(DOMEvent* event, void* user_data);
+
+/**
+ * Release callback for a listener's user_data.
+ * 
+ * Called once the listener is removed (removeEventListener, or after the
+ * invocation of a "once" listener) or its target is destroyed. A listener
+ * may remove itself while it runs, so it must not touch its user_data after
+ * calling dom_eventtarget_removeeventlistener().
+ * 
+ * @param user_data Context pointer given when the listener was added
+ */
+typedef void (*DOMEventListenerRelease)(void* user_data);
+
+/**
+ * Match callback for dom_eventtarget_findeventlistener().
+ * 
+ * @param user_data A registered listener's context pointer
+ * @param key Key passed to dom_eventtarget_findeventlistener()
+ * @return Non-zero if user_data corresponds to key
+ */
+typedef uint8_t (*DOMEventListenerMatch)(void* user_data, void* key);
+
+/**
+ * Add an event listener.
+ * 
+ * Adding the same callback, user_data and capture twice does nothing.
+ * 
+ * @param target Event target (Node, Element or Document)
+ * @param type Event type (e.g. "click")
+ * @param callback Listener callback (NULL does nothing)
+ * @param user_data Context pointer passed to callback
+ * @param capture 1 for a capture listener, 0 for a bubble listener
+ * @param once 1 to remove the listener after its first invocation
+ * @param passive 1 for a passive listener (preventDefault is ignored)
+ * @return 0 on success, error code on failure
+ */
+int dom_eventtarget_addeventlistener(DOMEventTarget* target, const char* type,
+                                     DOMEventListener callback, void* user_data,
+                                     uint8_t capture, uint8_t once, uint8_t passive);
+
+/**
+ * Add an event listener that owns its user_data.
+ * 
+ * Like dom_eventtarget_addeventlistener(), but release(user_data) is called
+ * once the listener is removed or the target is destroyed. If the same
+ * callback, user_data and capture are already registered, nothing is added
+ * and release is not called.
+ * 
+ * @param target Event target (Node, Element or Document)
+ * @param type Event type (e.g. "click")
+ * @param callback Listener callback (NULL does nothing)
+ * @param user_data Context pointer passed to callback and release
+ * @param capture 1 for a capture listener, 0 for a bubble listener
+ * @param once 1 to remove the listener after its first invocation
+ * @param passive 1 for a passive listener (preventDefault is ignored)
+ * @param release Called with user_data when the listener goes away (may be NULL)
+ * @return 0 on success, error code on failure (release is not called)
+ */
+int dom_eventtarget_addeventlistener_owned(DOMEventTarget* target, const char* type,
+                                           DOMEventListener callback, void* user_data,
+                                           uint8_t capture, uint8_t once, uint8_t passive,
+                                           DOMEventListenerRelease release);
+
+/**
+ * Remove the listener added with callback, user_data and capture.
+ * 
+ * Runs the listener's release callback, if it has one. Does nothing if no
+ * such listener is registered.
+ * 
+ * @param target Event target
+ * @param type Event type
+ * @param callback Listener callback
+ * @param user_data Context pointer the listener was added with
+ * @param capture 1 for a capture listener, 0 for a bubble listener
+ */
+void dom_eventtarget_removeeventlistener(DOMEventTarget* target, const char* type,
+                                         DOMEventListener callback, void* user_data,
+                                         uint8_t capture);
+
+/**
+ * Find a listener by predicate.
+ * 
+ * Bindings that add every listener through one callback use this to find
+ * the registration of a given script function.
+ * 
+ * @param target Event target
+ * @param type Event type
+ * @param callback Listener callback the listener was added with
+ * @param capture 1 for capture listeners, 0 for bubble listeners
+ * @param match Called with each candidate's user_data and key
+ * @param key Passed through to match
+ * @return user_data of the first listener match accepts, or NULL
+ */
+void* dom_eventtarget_findeventlistener(DOMEventTarget* target, const char* type,
+                                        DOMEventListener callback, uint8_t capture,
+                                        DOMEventListenerMatch match, void* key);
+
+/**
+ * Dispatch an event.
+ * 
+ * Listeners run synchronously, capture phase first, then at target, then
+ * bubbling (if the event bubbles).
+ * 
+ * @param target Event target
+ * @param event Event to dispatch (not being dispatched, initialized)
+ * @return 0 if a listener cancelled the event (or dispatch failed), 1 otherwise
+ */
+uint8_t dom_eventtarget_dispatchevent(DOMEventTarget* target, DOMEvent* event);
+
+/**
+ * Increment event target reference count.
+ * 
+ * @param target Event target
+ */
+void dom_eventtarget_addref(DOMEventTarget* target);
+
+/**
+ * Decrement event target reference count.
+ * 
+ * @param target Event target
+ */
+void dom_eventtarget_release(DOMEventTarget* target);
+
 /* ============================================================================
  * Event Interface
  * ========================================================================= */
 
+/**
+ * Create an event.
+ * 
+ * @param type Event type string
+ * @param bubbles Non-zero if the event bubbles
+ * @param cancelable Non-zero if the event is cancelable
+ * @param composed Non-zero if the event crosses shadow boundaries
+ * @return New event (caller owns one reference) or NULL on allocation failure
+ */
+DOMEvent* dom_event_new(const char* type, uint8_t bubbles, uint8_t cancelable, uint8_t composed);
+
+/**
+ * Get event type.
+ * 
+ * @param event Event handle
+ * @return Type string (borrowed, valid while the event is alive)
+ */
+const char* dom_event_get_type(DOMEvent* event);
+
+/**
+ * Get event flags.
+ * 
+ * @param event Event handle
+ * @return 1 if set, 0 otherwise
+ */
+uint8_t dom_event_get_bubbles(DOMEvent* event);
+uint8_t dom_event_get_cancelable(DOMEvent* event);
+uint8_t dom_event_get_defaultprevented(DOMEvent* event);
+uint8_t dom_event_get_composed(DOMEvent* event);
+uint8_t dom_event_get_istrusted(DOMEvent* event);
+
+/**
+ * Get event creation time.
+ * 
+ * @param event Event handle
+ * @return Milliseconds timestamp
+ */
+double dom_event_get_timestamp(DOMEvent* event);
+
 /**
  * Get event target.
  * 
@@ -3083,6 +5730,26 @@ DOMEventTarget* dom_event_get_currenttarget(DOMEvent* event);
  */
 DOMEventTarget* dom_event_get_srcelement(DOMEvent* event);
 
+/**
+ * Get event phase.
+ * 
+ * @param event Event handle
+ * @return 0 (none), 1 (capturing), 2 (at target) or 3 (bubbling);
+ *         non-zero only while the event is being dispatched
+ */
+uint16_t dom_event_get_eventphase(DOMEvent* event);
+
+/**
+ * Get event dispatch counter.
+ * 
+ * Incremented when each dispatch of the event starts; together with a
+ * non-zero event phase it identifies the dispatch in progress.
+ * 
+ * @param event Event handle
+ * @return Number of dispatches started for this event (wrapping)
+ */
+uint32_t dom_event_get_dispatchid(DOMEvent* event);
+
 /**
  * Stop event propagation.
  * 
@@ -3229,10 +5896,57 @@ void dom_event_addref(DOMEvent* event);
  */
 void dom_event_release(DOMEvent* event);
 
+/**
+ * Event pool statistics.
+ * 
+ * `pooled` records wait on the free list; `live` are acquired and not yet
+ * released. Shared by Event and CustomEvent.
+ */
+typedef struct DOMEventPoolStats {
+    uint64_t hits;
+    uint64_t misses;
+    uint32_t pooled;
+    uint32_t live;
+    uint32_t capacity;
+} DOMEventPoolStats;
+
+/**
+ * Set how many released events this thread keeps for reuse.
+ * 
+ * 0 (the default) disables pooling. Once enabled, an Event or CustomEvent
+ * whose last reference is released (e.g. one no script wrapper retains)
+ * is reused by the next dom_event_new() / dom_customevent_new().
+ * 
+ * @param capacity Most released events kept
+ */
+void dom_event_pool_set_capacity(uint32_t capacity);
+
+/**
+ * Get this thread's event pool statistics.
+ * 
+ * @param out Receives hit/miss counts and occupancy
+ */
+void dom_event_pool_get_stats(DOMEventPoolStats* out);
+
 /* ============================================================================
  * CustomEvent Interface
  * ========================================================================= */
 
+/**
+ * Create a custom event.
+ * 
+ * The event shares its handle with DOMEvent, so every dom_event_*
+ * function accepts it.
+ * 
+ * @param type Event type string
+ * @param bubbles Non-zero if the event bubbles
+ * @param cancelable Non-zero if the event is cancelable
+ * @param composed Non-zero if the event crosses shadow boundaries
+ * @param detail Custom data pointer (borrowed) or NULL
+ * @return New event (caller owns one reference) or NULL on allocation failure
+ */
+DOMCustomEvent* dom_customevent_new(const char* type, uint8_t bubbles, uint8_t cancelable, uint8_t composed, void* detail);
+
 /**
  * Get custom event detail.
  * 
@@ -3284,6 +5998,104 @@ void dom_customevent_addref(DOMCustomEvent* event);
  */
 void dom_customevent_release(DOMCustomEvent* event);
 
+// ============================================================================
+// CustomElementRegistry
+// ============================================================================
+
+/**
+ * Lifecycle callbacks of a custom element definition. Every callback may be
+ * NULL and receives context. String views are only valid during the call;
+ * NULL views stand for null values.
+ * 
+ * constructor returns non-zero if it threw: the element is then "failed"
+ * and gets no further callbacks. release is called once, with context,
+ * when the registry's document is destroyed.
+ */
+typedef struct DOMCustomElementCallbacks {
+    void* context;
+    int (*constructor)(DOMElement* element, void* context);
+    void (*connected)(DOMElement* element, void* context);
+    void (*disconnected)(DOMElement* element, void* context);
+    void (*adopted)(DOMElement* element, DOMDocument* old_document, DOMDocument* new_document, void* context);
+    void (*attribute_changed)(DOMElement* element, const DOMStringView* name,
+                              const DOMStringView* old_value, const DOMStringView* new_value,
+                              const DOMStringView* namespace_uri, void* context);
+    void (*release)(void* context);
+} DOMCustomElementCallbacks;
+
+/**
+ * Get the custom element registry of a document (window.customElements),
+ * creating it on first use. The document owns it.
+ * 
+ * @param doc Document
+ * @return Registry, or NULL if it could not be allocated
+ */
+DOMCustomElementRegistry* dom_document_get_customelementregistry(DOMDocument* doc);
+
+/**
+ * Get the registry of an element's node document.
+ * 
+ * @param elem Element
+ * @return Registry, or NULL if the document never created one
+ */
+DOMCustomElementRegistry* dom_element_get_customelementregistry(DOMElement* elem);
+
+/**
+ * Define a custom element.
+ * 
+ * Definitions are keyed by the interned name, so looking one up for each
+ * new element (dom_document_createelement) costs one pointer hash. The
+ * undefined elements of the document with this name are upgraded before
+ * this returns, in one pass: one upgrade reaction per element, each
+ * calling constructor once, followed by its attribute_changed and
+ * connected callbacks.
+ * 
+ * The callbacks are copied. On success the registry owns callbacks->context;
+ * on failure the caller keeps it and release is not called.
+ * 
+ * @param registry Registry
+ * @param name Custom element name
+ * @param callbacks Lifecycle callbacks
+ * @param observed_attributes Attribute names reported to attribute_changed
+ *        (may be NULL when observed_count is 0)
+ * @param observed_count Number of observed attributes
+ * @return 0 on success, SyntaxError (12) for an invalid or reserved name,
+ *         NotSupportedError (9) if the name is already defined or a define
+ *         is running
+ */
+int dom_customelementregistry_define(DOMCustomElementRegistry* registry, const char* name,
+                                     const DOMCustomElementCallbacks* callbacks,
+                                     const char* const* observed_attributes, uint32_t observed_count);
+
+/**
+ * Get the context a name was defined with (CustomElementRegistry.get()).
+ * 
+ * @param registry Registry
+ * @param name Custom element name
+ * @return callbacks->context of the definition, or NULL if not defined
+ */
+void* dom_customelementregistry_get(DOMCustomElementRegistry* registry, const char* name);
+
+/**
+ * Upgrade the undefined elements of a tree whose names are defined
+ * (CustomElementRegistry.upgrade()), in one pass.
+ * 
+ * @param registry Registry
+ * @param root Root of the tree (inclusive)
+ * @return 0 on success, or QuotaExceededError (22) if allocation failed
+ */
+int dom_customelementregistry_upgrade(DOMCustomElementRegistry* registry, DOMNode* root);
+
+/**
+ * Get the context of a custom element's definition, e.g. to give a new
+ * script wrapper of an upgraded element its class.
+ * 
+ * @param elem Element
+ * @return callbacks->context of its definition if the element is custom,
+ *         NULL otherwise (including while it is being upgraded)
+ */
+void* dom_element_get_customelementcontext(DOMElement* elem);
+
 #ifdef __cplusplus
 }
 #endif
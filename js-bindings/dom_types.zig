@@ -42,6 +42,7 @@
 //! ```
 
 const std = @import("std");
+const dom = @import("dom");
 
 // ============================================================================
 // Opaque Type Definitions (C-ABI)
@@ -92,12 +93,18 @@ pub const DOMNodeList = opaque {};
 /// Opaque handle for DOM HTMLCollection
 pub const DOMHTMLCollection = opaque {};
 
+/// Opaque handle for a compiled (parsed) selector
+pub const DOMSelector = opaque {};
+
 /// Opaque handle for DOM DocumentType
 pub const DOMDocumentType = opaque {};
 
 /// Opaque handle for DOM DOMImplementation
 pub const DOMDOMImplementation = opaque {};
 
+/// Opaque handle for a pool of names shared by documents (SharedNames)
+pub const DOMSharedNames = opaque {};
+
 /// Opaque handle for DOM EventTarget
 pub const DOMEventTarget = opaque {};
 
@@ -122,12 +129,108 @@ pub const DOMMutationObserver = opaque {};
 /// Opaque handle for DOM MutationRecord
 pub const DOMMutationRecord = opaque {};
 
+/// Opaque handle for a packed batch of mutation records
+pub const DOMMutationBatch = opaque {};
+
 /// Opaque handle for DOM TreeWalker
 pub const DOMTreeWalker = opaque {};
 
 /// Opaque handle for DOM NodeIterator
 pub const DOMNodeIterator = opaque {};
 
+/// Opaque handle for an element-only iterator (non-standard)
+pub const DOMElementIterator = opaque {};
+
+/// Opaque handle for a closest() memo (non-standard)
+pub const DOMClosestMemo = opaque {};
+
+/// Opaque handle for a time-sliced query (non-standard)
+pub const DOMQuery = opaque {};
+
+/// Opaque handle for a native (declarative) element filter
+pub const DOMElementFilter = opaque {};
+
+/// Opaque handle for a push-style tree builder
+pub const DOMTreeBuilder = opaque {};
+
+/// Opaque handle for a precompiled subtree template
+pub const DOMTemplate = opaque {};
+
+/// NodeFilter.acceptNode as a C callback: returns FILTER_ACCEPT (1),
+/// FILTER_REJECT (2) or FILTER_SKIP (3); any other value counts as skip.
+pub const DOMNodeFilterCallback = *const fn (node: *DOMNode, user_data: ?*anyopaque) callconv(.c) u16;
+
+/// A caller-supplied NodeFilter. Must outlive the walker or iterator.
+pub const DOMNodeFilter = extern struct {
+    accept_node: DOMNodeFilterCallback,
+    user_data: ?*anyopaque,
+};
+
+// ============================================================================
+// String Views (C-ABI)
+// ============================================================================
+
+/// Borrowed string with the metadata bindings need to avoid copying it.
+///
+/// - `is_latin1`: every byte is ASCII, so the UTF-8 bytes are also valid
+///   Latin-1 and can back a one-byte engine string as-is
+/// - `is_interned`: owned by the owner document's string pool, immutable and
+///   valid until that document is destroyed
+/// - `fits_latin1`: valid UTF-8 whose code points are all at most U+00FF,
+///   so the engine string is one-byte (set whenever `is_latin1` is); the
+///   bytes need transcoding unless `is_latin1`
+pub const DOMStringView = extern struct {
+    data: [*]const u8,
+    length: u32,
+    is_latin1: bool,
+    is_interned: bool,
+    fits_latin1: bool,
+};
+
+/// Selector cache statistics (dom_document_get_selector_cache_stats).
+pub const DOMSelectorCacheStats = extern struct {
+    hits: u64,
+    misses: u64,
+    size: u32,
+    capacity: u32,
+};
+
+/// matches() cache statistics (dom_document_get_match_cache_stats).
+pub const DOMMatchCacheStats = extern struct {
+    hits: u64,
+    misses: u64,
+    elements: u32,
+    enabled: u32,
+};
+
+/// querySelector fast path counts (dom_document_get_fast_path_stats).
+pub const DOMFastPathStats = extern struct {
+    simple_id: u64,
+    simple_class: u64,
+    simple_tag: u64,
+    attribute_equals: u64,
+    tag_class: u64,
+    child_tag: u64,
+    id_filtered: u64,
+    generic: u64,
+};
+
+/// Event pool occupancy (dom_event_pool_get_stats).
+pub const DOMEventPoolStats = extern struct {
+    hits: u64,
+    misses: u64,
+    pooled: u32,
+    live: u32,
+    capacity: u32,
+};
+
+/// Buffer returned by dom_node_snapshot_subtree (free with dom_snapshot_free)
+/// and dom_node_diff (free with dom_patch_free).
+pub const DOMSnapshotBuffer = extern struct {
+    data: ?[*]u8,
+    length: usize,
+};
+
 // ============================================================================
 // DOM Error Codes
 // ============================================================================
@@ -446,6 +549,25 @@ pub inline fn zigStringToCString(slice: []const u8) [*:0]const u8 {
     return @ptrCast(slice.ptr);
 }
 
+/// Builds a DOMStringView for a DOM string.
+///
+/// `interned` must only be true if the slice is owned by a document's string pool.
+pub fn zigStringToStringView(slice: []const u8, interned: bool) DOMStringView {
+    return encodedStringView(slice, dom.string_utils.encodingOf(slice), interned);
+}
+
+/// Builds a DOMStringView for a DOM string whose encoding is already known
+/// (recorded by the string pool, see `StringPool.ownedEncoding()`).
+pub fn encodedStringView(slice: []const u8, encoding: dom.string_utils.Encoding, interned: bool) DOMStringView {
+    return .{
+        .data = slice.ptr,
+        .length = @intCast(slice.len),
+        .is_latin1 = encoding == .ascii,
+        .is_interned = interned,
+        .fits_latin1 = encoding != .utf8,
+    };
+}
+
 /// Converts a C null-terminated string to a Zig string slice.
 ///
 /// Uses std.mem.span to find the null terminator and create a slice.
@@ -461,6 +583,13 @@ pub inline fn cStringToZigString(c_str: [*:0]const u8) []const u8 {
     return std.mem.span(c_str);
 }
 
+/// Converts a C (pointer, length) string to a Zig string slice.
+///
+/// Used by the `_n` entry points, whose arguments are not null-terminated.
+pub inline fn cLenStringToZigString(ptr: [*]const u8, len: usize) []const u8 {
+    return ptr[0..len];
+}
+
 /// Converts an optional Zig string to an optional C string.
 ///
 /// Returns null if the input is null, otherwise converts the string.
@@ -427,6 +427,35 @@ pub export fn dom_domimplementation_createdocument(
     return documentToHandle(doc);
 }
 
+/// Create a Document with storage pre-sized for known content
+/// (not in WebIDL - C-ABI specific)
+///
+/// See DOMImplementation.createDocumentWithCapacity(): as
+/// dom_domimplementation_createdocument(), with the hints of
+/// dom_document_reserve() applied first.
+///
+/// ## Returns
+/// New Document (caller must release), or null on error
+pub export fn dom_domimplementation_createdocument_with_capacity(
+    impl: *types.DOMDOMImplementation,
+    namespace: ?[*:0]const u8,
+    qualified_name: [*:0]const u8,
+    doctype: ?*types.DOMDocumentType,
+    nodes: usize,
+    strings_bytes: usize,
+) ?*types.DOMDocument {
+    const zig_impl = handleToImpl(impl);
+    const zig_namespace = if (namespace) |ns| types.cStringToZigString(ns) else null;
+    const zig_qualified_name = types.cStringToZigString(qualified_name);
+    const zig_doctype = if (doctype) |dt| handleToDocumentType(dt) else null;
+
+    const doc = zig_impl.createDocumentWithCapacity(zig_namespace, zig_qualified_name, zig_doctype, .{
+        .nodes = nodes,
+        .string_bytes = strings_bytes,
+    }) catch return null;
+    return documentToHandle(doc);
+}
+
 // ============================================================================
 // Feature Detection (Deprecated)
 // ============================================================================
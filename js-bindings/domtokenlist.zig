@@ -65,7 +65,9 @@ const dom = @import("dom");
 const types = @import("dom_types.zig");
 
 const DOMTokenList = dom.DOMTokenList;
+const Element = dom.Element;
 const DOMDOMTokenList = types.DOMDOMTokenList;
+const DOMElement = types.DOMElement;
 const DOMErrorCode = types.DOMErrorCode;
 const zigErrorToDOMError = types.zigErrorToDOMError;
 const zigStringToCString = types.zigStringToCString;
@@ -86,6 +88,36 @@ pub const TokenListWrapper = struct {
     next_buffer_index: usize = 0,
 };
 
+// ============================================================================
+// Element.classList
+// ============================================================================
+
+/// Get the classList (DOMTokenList) for an element.
+///
+/// Returns a live view of the element's class tokens. Each call allocates a
+/// new handle; release it with `dom_domtokenlist_release()`.
+///
+/// ## WebIDL
+/// ```webidl
+/// [SameObject, PutForwards=value] readonly attribute DOMTokenList classList;
+/// ```
+///
+/// ## Parameters
+/// - `elem`: Element handle
+///
+/// ## Returns
+/// DOMTokenList handle, or null if allocation failed
+///
+/// ## Spec
+/// - https://dom.spec.whatwg.org/#dom-element-classlist
+/// - https://developer.mozilla.org/en-US/docs/Web/API/Element/classList
+pub export fn dom_element_get_classlist(elem: *DOMElement) ?*DOMDOMTokenList {
+    const element: *Element = @ptrCast(@alignCast(elem));
+    const wrapper = std.heap.c_allocator.create(TokenListWrapper) catch return null;
+    wrapper.* = .{ .token_list = element.classList() };
+    return @ptrCast(wrapper);
+}
+
 // ============================================================================
 // Properties
 // ============================================================================
@@ -359,17 +391,12 @@ pub export fn dom_domtokenlist_supports(list: *DOMDOMTokenList, token: [*:0]cons
 /// - https://developer.mozilla.org/en-US/docs/Web/API/DOMTokenList/add
 pub export fn dom_domtokenlist_add(list: *DOMDOMTokenList, tokens: [*]const [*:0]const u8, count: u32) c_int {
     const wrapper: *TokenListWrapper = @ptrCast(@alignCast(list));
-    const allocator = std.heap.page_allocator;
 
-    // Convert C string array to Zig slice array
-    const token_slices = allocator.alloc([]const u8, count) catch {
+    var slices: TokenSlices = .{};
+    const token_slices = slices.init(tokens, count) catch {
         return @intFromEnum(DOMErrorCode.QuotaExceededError);
     };
-    defer allocator.free(token_slices);
-
-    for (0..count) |i| {
-        token_slices[i] = cStringToZigString(tokens[i]);
-    }
+    defer slices.deinit();
 
     wrapper.token_list.add(token_slices) catch |err| {
         return @intFromEnum(zigErrorToDOMError(err));
@@ -412,17 +439,12 @@ pub export fn dom_domtokenlist_add(list: *DOMDOMTokenList, tokens: [*]const [*:0
 /// - https://developer.mozilla.org/en-US/docs/Web/API/DOMTokenList/remove
 pub export fn dom_domtokenlist_remove(list: *DOMDOMTokenList, tokens: [*]const [*:0]const u8, count: u32) c_int {
     const wrapper: *TokenListWrapper = @ptrCast(@alignCast(list));
-    const allocator = std.heap.page_allocator;
 
-    // Convert C string array to Zig slice array
-    const token_slices = allocator.alloc([]const u8, count) catch {
+    var slices: TokenSlices = .{};
+    const token_slices = slices.init(tokens, count) catch {
         return @intFromEnum(DOMErrorCode.QuotaExceededError);
     };
-    defer allocator.free(token_slices);
-
-    for (0..count) |i| {
-        token_slices[i] = cStringToZigString(tokens[i]);
-    }
+    defer slices.deinit();
 
     wrapper.token_list.remove(token_slices) catch |err| {
         return @intFromEnum(zigErrorToDOMError(err));
@@ -528,6 +550,29 @@ pub export fn dom_domtokenlist_replace(list: *DOMDOMTokenList, token: [*:0]const
     return if (result) 1 else 0;
 }
 
+/// Zig slices for a C token array; small arrays stay on the stack.
+const TokenSlices = struct {
+    inline_slices: [16][]const u8 = undefined,
+    heap_slices: ?[][]const u8 = null,
+
+    fn init(self: *TokenSlices, tokens: [*]const [*:0]const u8, count: u32) ![]const []const u8 {
+        const slices = if (count <= self.inline_slices.len)
+            self.inline_slices[0..count]
+        else blk: {
+            self.heap_slices = try std.heap.c_allocator.alloc([]const u8, count);
+            break :blk self.heap_slices.?;
+        };
+        for (slices, 0..) |*slice, i| {
+            slice.* = cStringToZigString(tokens[i]);
+        }
+        return slices;
+    }
+
+    fn deinit(self: *TokenSlices) void {
+        if (self.heap_slices) |slices| std.heap.c_allocator.free(slices);
+    }
+};
+
 // ============================================================================
 // Memory Management
 // ============================================================================
@@ -551,7 +596,7 @@ pub export fn dom_domtokenlist_replace(list: *DOMDOMTokenList, token: [*:0]const
 /// DOMTokenList doesn't own the element or attribute. Releasing the list
 /// does NOT affect the element's class attribute.
 pub export fn dom_domtokenlist_release(list: *DOMDOMTokenList) void {
-    const allocator = std.heap.page_allocator;
+    const allocator = std.heap.c_allocator;
     const wrapper: *TokenListWrapper = @ptrCast(@alignCast(list));
     allocator.destroy(wrapper);
 }
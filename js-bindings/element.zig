@@ -10,6 +10,9 @@ const zigStringToCString = dom_types.zigStringToCString;
 const zigStringToCStringOptional = dom_types.zigStringToCStringOptional;
 const cStringToZigString = dom_types.cStringToZigString;
 const cStringToZigStringOptional = dom_types.cStringToZigStringOptional;
+const cLenStringToZigString = dom_types.cLenStringToZigString;
+const zigStringToStringView = dom_types.zigStringToStringView;
+const DOMStringView = dom_types.DOMStringView;
 
 // Import opaque types from dom_types
 pub const DOMElement = dom_types.DOMElement;
@@ -27,6 +30,7 @@ pub const DOMShadowRootInit = opaque {};
 const dom = @import("dom");
 const Element = dom.Element;
 const Node = dom.Node;
+const Document = dom.Document;
 const Attr = dom.Attr;
 const DOMTokenList = dom.DOMTokenList;
 
@@ -34,6 +38,9 @@ const DOMTokenList = dom.DOMTokenList;
 const domtokenlist_mod = @import("domtokenlist.zig");
 const TokenListWrapper = domtokenlist_mod.TokenListWrapper;
 
+// Static NodeList shared with Document querySelectorAll
+const StaticNodeList = @import("document.zig").StaticNodeList;
+
 /// Get namespaceURI attribute
 ///
 /// WebIDL: `readonly attribute DOMString? namespaceURI;`
@@ -231,6 +238,33 @@ pub export fn dom_element_get_assignedslot(handle: *DOMElement) ?*DOMElement {
     return if (slot) |s| @ptrCast(s) else null;
 }
 
+/// Get the number of nodes assigned to a slot element.
+///
+/// Not in WebIDL (HTMLSlotElement.assignedNodes() without a copy). Answered
+/// from the shadow root's cached assignment lists, rebuilt only after the
+/// host's children or an assignment change.
+///
+/// ## Returns
+/// Number of assigned nodes (0 for non-slot elements, slots outside a
+/// shadow tree, or on allocation failure)
+pub export fn dom_element_get_assignednodecount(handle: *DOMElement) u32 {
+    const element: *const Element = @ptrCast(@alignCast(handle));
+    const nodes = element.assignedNodesCached() catch return 0;
+    return @intCast(nodes.len);
+}
+
+/// Get a node assigned to a slot element, in tree order.
+///
+/// ## Returns
+/// The node at `index` (borrowed reference - do NOT release), or NULL if
+/// out of range
+pub export fn dom_element_get_assignednode(handle: *DOMElement, index: u32) ?*dom_types.DOMNode {
+    const element: *const Element = @ptrCast(@alignCast(handle));
+    const nodes = element.assignedNodesCached() catch return null;
+    if (index >= nodes.len) return null;
+    return @ptrCast(nodes[index]);
+}
+
 /// Get attributes as NamedNodeMap.
 ///
 /// ## WebIDL
@@ -276,15 +310,6 @@ pub export fn dom_element_get_shadowroot(handle: *DOMElement) ?*DOMShadowRoot {
     return @ptrCast(shadow);
 }
 
-/// Get customElementRegistry attribute
-///
-/// WebIDL: `readonly attribute CustomElementRegistry? customElementRegistry;`
-pub export fn dom_element_get_customelementregistry(handle: *DOMElement) ?*DOMCustomElementRegistry {
-    _ = handle;
-    // TODO: Implement getter
-    return null;
-}
-
 /// hasAttributes method
 ///
 /// WebIDL: `boolean hasAttributes();`
@@ -360,6 +385,61 @@ pub export fn dom_element_getattributenames(handle: *DOMElement, count: *u32) ?[
     return c_array.ptr;
 }
 
+/// getAttributeNames as string views (no allocation)
+///
+/// Writes up to `capacity` views into `out` and returns the total number of
+/// attributes; call again with a larger buffer if the result exceeds `capacity`.
+pub export fn dom_element_getattributenames_view(handle: *DOMElement, out: ?[*]DOMStringView, capacity: u32) u32 {
+    const element: *const Element = @ptrCast(@alignCast(handle));
+
+    var count: u32 = 0;
+    var iter = element.attributes.iterator();
+    while (iter.next()) |attr| : (count += 1) {
+        if (out) |views| {
+            if (count < capacity) {
+                views[count] = elementStringView(element, attr.name.local_name);
+            }
+        }
+    }
+    return count;
+}
+
+/// Callback for dom_element_foreach_attributename(); `name` is only valid
+/// during the call.
+pub const DOMAttributeNameCallback = *const fn (name: *const DOMStringView, user_data: ?*anyopaque) callconv(.c) void;
+
+/// getAttributeNames as a callback per name, in order (no allocation, one pass)
+///
+/// The callback must not mutate the element.
+pub export fn dom_element_foreach_attributename(handle: *DOMElement, callback: DOMAttributeNameCallback, user_data: ?*anyopaque) void {
+    const element: *const Element = @ptrCast(@alignCast(handle));
+
+    var iter = element.attributes.iterator();
+    while (iter.next()) |attr| {
+        const view = elementStringView(element, attr.name.local_name);
+        callback(&view, user_data);
+    }
+}
+
+/// Callback for dom_element_foreach_attribute(); `name` and `value` are
+/// only valid during the call.
+pub const DOMAttributeCallback = *const fn (name: *const DOMStringView, value: *const DOMStringView, user_data: ?*anyopaque) callconv(.c) void;
+
+/// Every attribute name and value as a callback per attribute, in order
+///
+/// Reads the attribute storage directly, so no Attr node is created. The
+/// callback must not mutate the element.
+pub export fn dom_element_foreach_attribute(handle: *DOMElement, callback: DOMAttributeCallback, user_data: ?*anyopaque) void {
+    const element: *const Element = @ptrCast(@alignCast(handle));
+
+    var iter = element.attributes.iterator();
+    while (iter.next()) |attr| {
+        const name = elementStringView(element, attr.name.local_name);
+        const value = elementStringView(element, attr.value);
+        callback(&name, &value, user_data);
+    }
+}
+
 /// Free getAttributeNames array.
 ///
 /// ## Parameters
@@ -391,6 +471,52 @@ pub export fn dom_element_getattribute(handle: *DOMElement, qualifiedName: [*:0]
     return zigStringToCStringOptional(value);
 }
 
+/// Builds a string view, flagging strings owned by the owner document's pool
+/// (whose encoding the pool recorded, so they are not scanned again).
+pub fn elementStringView(element: *const Element, value: []const u8) DOMStringView {
+    if (element.prototype.owner_document) |owner| {
+        if (owner.node_type == .document) {
+            const doc: *Document = @fieldParentPtr("prototype", owner);
+            if (doc.string_pool.ownedEncoding(value)) |encoding| {
+                return dom_types.encodedStringView(value, encoding, true);
+            }
+        }
+    }
+    return zigStringToStringView(value, false);
+}
+
+/// Get tagName as a string view (no copy)
+///
+/// WebIDL: `readonly attribute DOMString tagName;`
+pub export fn dom_element_get_tagname_view(handle: *DOMElement, out: *DOMStringView) void {
+    const element: *const Element = @ptrCast(@alignCast(handle));
+    out.* = elementStringView(element, element.tag_name);
+}
+
+/// getAttribute as a string view (no copy)
+///
+/// Returns false (and leaves `out` untouched) if the attribute is not present.
+pub export fn dom_element_getattribute_view(handle: *DOMElement, qualifiedName: [*:0]const u8, out: *DOMStringView) bool {
+    return dom_element_getattribute_view_n(handle, qualifiedName, std.mem.len(qualifiedName), out);
+}
+
+/// getAttribute as a string view, with a length-carrying name
+pub export fn dom_element_getattribute_view_n(handle: *DOMElement, qualifiedName: [*]const u8, qualifiedName_len: usize, out: *DOMStringView) bool {
+    const element: *const Element = @ptrCast(@alignCast(handle));
+    const name = cLenStringToZigString(qualifiedName, qualifiedName_len);
+    const value = element.getAttribute(name) orelse return false;
+    out.* = elementStringView(element, value);
+    return true;
+}
+
+/// getAttribute as a string view, with an atom from dom_document_intern_name()
+pub export fn dom_element_getattribute_atom_view(handle: *DOMElement, name: [*:0]const u8, out: *DOMStringView) bool {
+    const element: *const Element = @ptrCast(@alignCast(handle));
+    const value = element.getAttribute(std.mem.span(name)) orelse return false;
+    out.* = elementStringView(element, value);
+    return true;
+}
+
 /// getAttributeNS method
 ///
 /// WebIDL: `DOMString getAttributeNS(DOMString namespace, DOMString localName);`
@@ -406,15 +532,71 @@ pub export fn dom_element_getattributens(handle: *DOMElement, namespace: ?[*:0]c
 ///
 /// WebIDL: `undefined setAttribute(DOMString qualifiedName, DOMString value);`
 pub export fn dom_element_setattribute(handle: *DOMElement, qualifiedName: [*:0]const u8, value: [*:0]const u8) c_int {
+    return dom_element_setattribute_n(handle, qualifiedName, std.mem.len(qualifiedName), value, std.mem.len(value));
+}
+
+/// setAttribute method, with length-carrying strings
+pub export fn dom_element_setattribute_n(handle: *DOMElement, qualifiedName: [*]const u8, qualifiedName_len: usize, value: [*]const u8, value_len: usize) c_int {
     const element: *Element = @ptrCast(@alignCast(handle));
-    const name = cStringToZigString(qualifiedName);
-    const val = cStringToZigString(value);
+    const name = cLenStringToZigString(qualifiedName, qualifiedName_len);
+    const val = cLenStringToZigString(value, value_len);
     element.setAttribute(name, val) catch |err| {
         return @intFromEnum(zigErrorToDOMError(err));
     };
     return 0; // Success
 }
 
+/// setAttribute method, with an atom from dom_document_intern_name()
+///
+/// The name is already the pool's copy, so interning it again is one
+/// pointer comparison when the same atom is set repeatedly.
+pub export fn dom_element_setattribute_atom(handle: *DOMElement, name: [*:0]const u8, value: [*]const u8, value_len: usize) c_int {
+    const element: *Element = @ptrCast(@alignCast(handle));
+    element.setAttribute(std.mem.span(name), cLenStringToZigString(value, value_len)) catch |err| {
+        return @intFromEnum(zigErrorToDOMError(err));
+    };
+    return 0; // Success
+}
+
+/// Set several attributes in one call (non-standard)
+///
+/// Same as calling dom_element_setattribute_n() for each pair in order,
+/// with the attribute storage reserved once.
+///
+/// ## Returns
+/// 0 on success, error code on failure (the attributes before the failing
+/// one are set)
+pub export fn dom_element_setattributes(
+    handle: *DOMElement,
+    names: [*]const [*]const u8,
+    name_lens: [*]const usize,
+    values: [*]const [*]const u8,
+    value_lens: [*]const usize,
+    count: u32,
+) c_int {
+    const element: *Element = @ptrCast(@alignCast(handle));
+
+    var buffer: [16]dom.AttributeInit = undefined;
+    const attributes = if (count <= buffer.len)
+        buffer[0..count]
+    else
+        element.prototype.allocator.alloc(dom.AttributeInit, count) catch |err| {
+            return @intFromEnum(zigErrorToDOMError(err));
+        };
+    defer if (count > buffer.len) element.prototype.allocator.free(attributes);
+
+    for (attributes, 0..) |*attr, i| {
+        attr.* = .{
+            .name = cLenStringToZigString(names[i], name_lens[i]),
+            .value = cLenStringToZigString(values[i], value_lens[i]),
+        };
+    }
+    element.setAttributes(attributes) catch |err| {
+        return @intFromEnum(zigErrorToDOMError(err));
+    };
+    return 0; // Success
+}
+
 /// setAttributeNS method
 ///
 /// WebIDL: `undefined setAttributeNS(DOMString namespace, DOMString qualifiedName, DOMString value);`
@@ -433,8 +615,13 @@ pub export fn dom_element_setattributens(handle: *DOMElement, namespace: ?[*:0]c
 ///
 /// WebIDL: `undefined removeAttribute(DOMString qualifiedName);`
 pub export fn dom_element_removeattribute(handle: *DOMElement, qualifiedName: [*:0]const u8) c_int {
+    return dom_element_removeattribute_n(handle, qualifiedName, std.mem.len(qualifiedName));
+}
+
+/// removeAttribute method, with a length-carrying name
+pub export fn dom_element_removeattribute_n(handle: *DOMElement, qualifiedName: [*]const u8, qualifiedName_len: usize) c_int {
     const element: *Element = @ptrCast(@alignCast(handle));
-    const name = cStringToZigString(qualifiedName);
+    const name = cLenStringToZigString(qualifiedName, qualifiedName_len);
     element.removeAttribute(name);
     return 0; // Success
 }
@@ -467,11 +654,22 @@ pub export fn dom_element_toggleattribute(handle: *DOMElement, qualifiedName: [*
 ///
 /// WebIDL: `boolean hasAttribute(DOMString qualifiedName);`
 pub export fn dom_element_hasattribute(handle: *DOMElement, qualifiedName: [*:0]const u8) u8 {
+    return dom_element_hasattribute_n(handle, qualifiedName, std.mem.len(qualifiedName));
+}
+
+/// hasAttribute method, with a length-carrying name
+pub export fn dom_element_hasattribute_n(handle: *DOMElement, qualifiedName: [*]const u8, qualifiedName_len: usize) u8 {
     const element: *const Element = @ptrCast(@alignCast(handle));
-    const name = cStringToZigString(qualifiedName);
+    const name = cLenStringToZigString(qualifiedName, qualifiedName_len);
     return if (element.hasAttribute(name)) 1 else 0;
 }
 
+/// hasAttribute method, with an atom from dom_document_intern_name()
+pub export fn dom_element_hasattribute_atom(handle: *DOMElement, name: [*:0]const u8) u8 {
+    const element: *const Element = @ptrCast(@alignCast(handle));
+    return if (element.hasAttribute(std.mem.span(name))) 1 else 0;
+}
+
 /// hasAttributeNS method
 ///
 /// WebIDL: `boolean hasAttributeNS(DOMString namespace, DOMString localName);`
@@ -498,7 +696,7 @@ pub export fn dom_element_hasattributens(handle: *DOMElement, namespace: ?[*:0]c
 /// - `qualifiedName`: Attribute name to lookup
 ///
 /// ## Returns
-/// Attr node if found, NULL otherwise (borrowed reference - do NOT release)
+/// Attr node if found (+1 reference, release with dom_attr_release), NULL otherwise
 ///
 /// ## Spec References
 /// - Algorithm: https://dom.spec.whatwg.org/#dom-element-getattributenode
@@ -515,7 +713,7 @@ pub export fn dom_element_hasattributens(handle: *DOMElement, namespace: ?[*:0]c
 ///     const char* name = dom_attr_get_name(attr);
 ///     const char* value = dom_attr_get_value(attr);
 ///     printf("%s='%s'\n", name, value); // id='foo'
-///     // Do NOT call dom_attr_release(attr) - borrowed reference!
+///     dom_attr_release(attr);
 /// }
 /// ```
 pub export fn dom_element_getattributenode(handle: *DOMElement, qualifiedName: [*:0]const u8) ?*DOMAttr {
@@ -545,7 +743,7 @@ pub export fn dom_element_getattributenode(handle: *DOMElement, qualifiedName: [
 /// - `localName`: Local name without prefix
 ///
 /// ## Returns
-/// Attr node if found, NULL otherwise (borrowed reference - do NOT release)
+/// Attr node if found (+1 reference, release with dom_attr_release), NULL otherwise
 ///
 /// ## Spec References
 /// - Algorithm: https://dom.spec.whatwg.org/#dom-element-getattributenodens
@@ -562,6 +760,7 @@ pub export fn dom_element_getattributenode(handle: *DOMElement, qualifiedName: [
 ///     const char* localName = dom_attr_get_localname(attr);
 ///     const char* value = dom_attr_get_value(attr);
 ///     printf("%s='%s'\n", localName, value); // lang='en'
+///     dom_attr_release(attr);
 /// }
 /// ```
 pub export fn dom_element_getattributenodens(handle: *DOMElement, namespace: ?[*:0]const u8, localName: [*:0]const u8) ?*DOMAttr {
@@ -737,8 +936,13 @@ pub export fn dom_element_removeattributenode(handle: *DOMElement, attr: *DOMAtt
 ///
 /// WebIDL: `Element? closest(DOMString selectors);`
 pub export fn dom_element_closest(handle: *DOMElement, selectors: [*:0]const u8) ?*DOMElement {
+    return dom_element_closest_n(handle, selectors, std.mem.len(selectors));
+}
+
+/// closest method, with a length-carrying selector
+pub export fn dom_element_closest_n(handle: *DOMElement, selectors: [*]const u8, selectors_len: usize) ?*DOMElement {
     const element: *Element = @ptrCast(@alignCast(handle));
-    const selector_string = cStringToZigString(selectors);
+    const selector_string = cLenStringToZigString(selectors, selectors_len);
 
     // closest() requires an allocator for selector parsing
     const allocator = std.heap.page_allocator;
@@ -754,8 +958,13 @@ pub export fn dom_element_closest(handle: *DOMElement, selectors: [*:0]const u8)
 ///
 /// WebIDL: `boolean matches(DOMString selectors);`
 pub export fn dom_element_matches(handle: *DOMElement, selectors: [*:0]const u8) u8 {
+    return dom_element_matches_n(handle, selectors, std.mem.len(selectors));
+}
+
+/// matches method, with a length-carrying selector
+pub export fn dom_element_matches_n(handle: *DOMElement, selectors: [*]const u8, selectors_len: usize) u8 {
     const element: *Element = @ptrCast(@alignCast(handle));
-    const selector_string = cStringToZigString(selectors);
+    const selector_string = cLenStringToZigString(selectors, selectors_len);
 
     // matches() requires an allocator for selector parsing
     // Use page_allocator (should be optimized to use arena in future)
@@ -780,8 +989,13 @@ pub export fn dom_element_webkitmatchesselector(handle: *DOMElement, selectors:
 ///
 /// WebIDL: `Element? querySelector(DOMString selectors);`
 pub export fn dom_element_queryselector(handle: *DOMElement, selectors: [*:0]const u8) ?*DOMElement {
+    return dom_element_queryselector_n(handle, selectors, std.mem.len(selectors));
+}
+
+/// querySelector method, with a length-carrying selector
+pub export fn dom_element_queryselector_n(handle: *DOMElement, selectors: [*]const u8, selectors_len: usize) ?*DOMElement {
     const element: *Element = @ptrCast(@alignCast(handle));
-    const selector_string = cStringToZigString(selectors);
+    const selector_string = cLenStringToZigString(selectors, selectors_len);
     const allocator = std.heap.page_allocator;
 
     const result = element.querySelector(allocator, selector_string) catch {
@@ -791,16 +1005,78 @@ pub export fn dom_element_queryselector(handle: *DOMElement, selectors: [*:0]con
     return if (result) |elem| @ptrCast(elem) else null;
 }
 
+/// matches() with a selector from dom_selector_compile()
+pub export fn dom_element_matches_compiled(handle: *DOMElement, selector: *dom_types.DOMSelector) u8 {
+    const element: *Element = @ptrCast(@alignCast(handle));
+    const parsed: *const dom.ParsedSelector = @ptrCast(@alignCast(selector));
+
+    const result = element.matchesParsed(std.heap.page_allocator, parsed) catch {
+        return 0; // On error, return false
+    };
+
+    return if (result) 1 else 0;
+}
+
+/// closest() with a selector from dom_selector_compile()
+pub export fn dom_element_closest_compiled(handle: *DOMElement, selector: *dom_types.DOMSelector) ?*DOMElement {
+    const element: *Element = @ptrCast(@alignCast(handle));
+    const parsed: *const dom.ParsedSelector = @ptrCast(@alignCast(selector));
+
+    const result = element.closestParsed(std.heap.page_allocator, parsed) catch {
+        return null; // On error, return null
+    };
+
+    return if (result) |elem| @ptrCast(elem) else null;
+}
+
+/// querySelector() with a selector from dom_selector_compile()
+pub export fn dom_element_queryselector_compiled(handle: *DOMElement, selector: *dom_types.DOMSelector) ?*DOMElement {
+    const element: *Element = @ptrCast(@alignCast(handle));
+    const parsed: *const dom.ParsedSelector = @ptrCast(@alignCast(selector));
+
+    const result = element.querySelectorParsed(std.heap.page_allocator, parsed) catch {
+        return null; // On error, return null
+    };
+
+    return if (result) |elem| @ptrCast(elem) else null;
+}
+
 /// querySelectorAll method
 ///
-/// Note: This returns the first element only for now (C-ABI limitation).
-/// Full implementation requires NodeList binding.
+/// Returns a static snapshot of matching descendants, or null if there are
+/// no matches or the selector is invalid. Free with dom_nodelist_static_release().
 ///
-/// WebIDL: `NodeList querySelectorAll(DOMString selectors);`
-pub export fn dom_element_queryselectorall_first(handle: *DOMElement, selectors: [*:0]const u8) ?*DOMElement {
-    // For now, just return the first match (same as querySelector)
-    // Full implementation needs NodeList binding
-    return dom_element_queryselector(handle, selectors);
+/// WebIDL: `[NewObject] NodeList querySelectorAll(DOMString selectors);`
+pub export fn dom_element_queryselectorall(handle: *DOMElement, selectors: [*:0]const u8) ?*dom_types.DOMNodeList {
+    return dom_element_queryselectorall_n(handle, selectors, std.mem.len(selectors));
+}
+
+/// querySelectorAll method, with a length-carrying selector
+pub export fn dom_element_queryselectorall_n(handle: *DOMElement, selectors: [*]const u8, selectors_len: usize) ?*dom_types.DOMNodeList {
+    const element: *Element = @ptrCast(@alignCast(handle));
+    const selector_string = cLenStringToZigString(selectors, selectors_len);
+    const allocator = std.heap.c_allocator;
+
+    const results = element.querySelectorAll(allocator, selector_string) catch {
+        return null;
+    };
+
+    if (results.len == 0) {
+        return null;
+    }
+
+    // The result slice is already owned by c_allocator; hand it to the list
+    const wrapper = allocator.create(StaticNodeList) catch {
+        allocator.free(results);
+        return null;
+    };
+
+    wrapper.* = StaticNodeList{
+        .elements = @constCast(results.ptr),
+        .count = results.len,
+    };
+
+    return @ptrCast(wrapper);
 }
 
 /// getElementsByTagName method
@@ -909,6 +1185,51 @@ pub export fn dom_element_insertadjacenttext(handle: *DOMElement, where: [*:0]co
 
     return 0; // Success
 }
+
+/// Parse markup and insert the nodes at a position relative to this element.
+///
+/// The nodes are built into a fragment and inserted in one step (one
+/// mutation record). See src/markup_parser.zig for the syntax.
+///
+/// ## Parameters
+/// - `handle`: Element to insert relative to
+/// - `where`: Position ("beforebegin", "afterbegin", "beforeend", "afterend")
+/// - `markup`: UTF-8 markup (not terminated)
+/// - `length`: Length of markup in bytes
+///
+/// ## Returns
+/// 0 on success, error code on failure (DOM_ERROR_SYNTAX for an invalid
+/// position, DOM_ERROR_NO_MODIFICATION_ALLOWED for "beforebegin" or
+/// "afterend" without a parent element)
+pub export fn dom_element_insertadjacentmarkup(handle: *DOMElement, where: [*:0]const u8, markup: [*]const u8, length: usize) c_int {
+    const target_elem: *Element = @ptrCast(@alignCast(handle));
+    target_elem.insertAdjacentMarkup(cStringToZigString(where), markup[0..length]) catch |err| {
+        return @intFromEnum(zigErrorToDOMError(err));
+    };
+    return 0;
+}
+
+/// Parse markup and replace the element's children with the nodes
+/// (innerHTML-style setter).
+///
+/// The old children are removed as one run and the new ones inserted in
+/// one step. Running out of memory while parsing leaves the children in
+/// place.
+///
+/// ## Parameters
+/// - `handle`: Element whose children to replace
+/// - `markup`: UTF-8 markup (not terminated)
+/// - `length`: Length of markup in bytes (0 removes the children)
+///
+/// ## Returns
+/// 0 on success, error code on failure
+pub export fn dom_element_setinnermarkup(handle: *DOMElement, markup: [*]const u8, length: usize) c_int {
+    const elem: *Element = @ptrCast(@alignCast(handle));
+    elem.setInnerMarkup(markup[0..length]) catch |err| {
+        return @intFromEnum(zigErrorToDOMError(err));
+    };
+    return 0;
+}
 // ============================================================================
 // ParentNode Mixin - Element Traversal
 // ============================================================================
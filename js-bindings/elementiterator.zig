@@ -0,0 +1,131 @@
+//! ElementIterator C-ABI Bindings (non-standard)
+//!
+//! Exposes the internal element-only traversal (element_iterator.zig) to
+//! bindings. Callers walking every element under a root otherwise loop over
+//! firstChild/nextSibling, visiting text and comment nodes one ABI call at a
+//! time, or build a querySelectorAll('*') list. The iterator skips
+//! non-element nodes natively and hands out elements in caller-sized
+//! batches, one ABI crossing per batch.
+//!
+//! ## Mutations
+//!
+//! The iterator references its root and the node it resumes from, so both
+//! stay valid between batches. Each batch resumes from that node's current
+//! position; once it is no longer under the root, iteration ends.
+//!
+//! ## Usage Example (C)
+//!
+//! ```c
+//! DOMElementIterator* it = dom_elementiterator_new(root);
+//! DOMElement* batch[64];
+//! uint32_t count;
+//! while ((count = dom_elementiterator_nextbatch(it, batch, 64)) > 0) {
+//!     for (uint32_t i = 0; i < count; i++) visit(batch[i]);
+//! }
+//! dom_elementiterator_release(it);
+//! ```
+//!
+//! ## Exported Functions
+//! - dom_elementiterator_new() - Iterate the element descendants of a node
+//! - dom_elementiterator_nextbatch() - Next elements, in tree order
+//! - dom_elementiterator_seek() - Continue after a node
+//! - dom_elementiterator_release() - Release the iterator
+
+const std = @import("std");
+const dom = @import("dom");
+const Node = dom.Node;
+const ElementIterator = dom.ElementIterator;
+const dom_types = @import("dom_types.zig");
+
+pub const DOMNode = dom_types.DOMNode;
+pub const DOMElement = dom_types.DOMElement;
+pub const DOMElementIterator = dom_types.DOMElementIterator;
+
+const State = struct {
+    iterator: ElementIterator,
+
+    fn of(handle: *DOMElementIterator) *State {
+        return @ptrCast(@alignCast(handle));
+    }
+
+    /// Move the reference from `old` to the new resume point; acquire
+    /// first, as the old node may own the new one
+    fn moveReference(self: *State, old: ?*Node) void {
+        if (self.iterator.current == old) return;
+        if (self.iterator.current) |current| current.acquire();
+        if (old) |node| node.release();
+    }
+};
+
+/// Create an iterator over the element descendants of `root` (tree order,
+/// root excluded).
+///
+/// ## Parameters
+/// - `root`: Node whose descendants are iterated (referenced until release)
+///
+/// ## Returns
+/// Iterator handle, or NULL if it could not be allocated
+pub export fn dom_elementiterator_new(root: *DOMNode) ?*DOMElementIterator {
+    const node: *Node = @ptrCast(@alignCast(root));
+    const state = std.heap.c_allocator.create(State) catch return null;
+    state.* = .{ .iterator = ElementIterator.init(node) };
+
+    node.acquire();
+    if (state.iterator.current) |current| current.acquire();
+    return @ptrCast(state);
+}
+
+/// Get up to `max` next elements in one call.
+///
+/// ## Parameters
+/// - `iterator`: ElementIterator handle
+/// - `out`: Buffer receiving the elements, in tree order
+/// - `max`: Capacity of `out`
+///
+/// ## Returns
+/// Number of elements written (0 once iteration is exhausted)
+pub export fn dom_elementiterator_nextbatch(iterator: *DOMElementIterator, out: [*]*DOMElement, max: u32) u32 {
+    const state = State.of(iterator);
+    const resumed_from = state.iterator.current;
+
+    // Removed from under the root since the last batch
+    if (resumed_from) |node| {
+        if (!state.iterator.root.contains(node)) state.iterator.current = null;
+    }
+
+    var count: u32 = 0;
+    while (count < max) : (count += 1) {
+        const element = state.iterator.next() orelse break;
+        out[count] = @ptrCast(element);
+    }
+
+    state.moveReference(resumed_from);
+    return count;
+}
+
+/// Continue after `node`, from its current position in the tree.
+///
+/// For callers buffering a batch: if the document mutated before the
+/// buffer was consumed, seek after the last element used and fetch again.
+///
+/// ## Parameters
+/// - `iterator`: ElementIterator handle
+/// - `node`: Node to continue after (the root restarts iteration; a node
+///   not under the root ends it)
+pub export fn dom_elementiterator_seek(iterator: *DOMElementIterator, node: *DOMNode) void {
+    const state = State.of(iterator);
+    const old = state.iterator.current;
+    state.iterator.seekAfter(@ptrCast(@alignCast(node)));
+    state.moveReference(old);
+}
+
+/// Release an ElementIterator and its node references.
+///
+/// ## Parameters
+/// - `iterator`: ElementIterator handle
+pub export fn dom_elementiterator_release(iterator: *DOMElementIterator) void {
+    const state = State.of(iterator);
+    if (state.iterator.current) |current| current.release();
+    state.iterator.root.release();
+    std.heap.c_allocator.destroy(state);
+}
@@ -57,10 +57,10 @@
 //!
 //! Spec reference: https://dom.spec.whatwg.org/#event (WebIDL: dom.idl:39-65)
 //!
-//! ## Exported Functions (18 total)
+//! ## Exported Functions (20 total)
 //!
 //! ### Constructor
-//! - `dom_event_new()` - Create new Event (heap-allocated)
+//! - `dom_event_new()` - Create new Event (from the event pool)
 //!
 //! ### Properties
 //! - `dom_event_get_type()` - Event type string
@@ -86,6 +86,10 @@
 //! - `dom_event_addref()` - Increment reference count
 //! - `dom_event_release()` - Decrement reference count
 //!
+//! ### Event Pool
+//! - `dom_event_pool_set_capacity()` - Enable / size event reuse
+//! - `dom_event_pool_get_stats()` - Pool hits, misses and occupancy
+//!
 //! ## Usage Example (C)
 //!
 //! ```c
@@ -123,10 +127,18 @@ const dom = @import("dom");
 
 const Event = dom.Event;
 const EventInit = dom.EventInit;
+const EventPool = dom.EventPool;
+const PooledEvent = dom.PooledEvent;
 const EventTarget = dom.EventTarget;
 const DOMEvent = types.DOMEvent;
 const DOMEventTarget = types.DOMEventTarget;
 
+/// Records behind every Event and CustomEvent handle of this thread.
+///
+/// Capacity 0 keeps nothing, so pooling is off until the embedder calls
+/// `dom_event_pool_set_capacity()`.
+pub threadlocal var event_pool: EventPool = .{ .allocator = std.heap.c_allocator };
+
 // ============================================================================
 // Constructor
 // ============================================================================
@@ -145,8 +157,10 @@ const DOMEventTarget = types.DOMEventTarget;
 /// - `composed`: 1 if event crosses shadow boundaries, 0 otherwise
 ///
 /// ## Returns
-/// Heap-allocated Event pointer, or NULL on allocation failure
+/// Event pointer with one reference, or NULL on allocation failure
 /// - **IMPORTANT**: Caller must call `dom_event_release()` to free
+/// - The type string is copied; `event_type` need not outlive the event
+/// - With pooling enabled the record may be a recycled one
 ///
 /// ## Spec References
 /// - Constructor: https://dom.spec.whatwg.org/#dom-event-event
@@ -174,23 +188,14 @@ pub export fn dom_event_new(
     cancelable: u8,
     composed: u8,
 ) ?*DOMEvent {
-    const allocator = std.heap.page_allocator;
-    const type_str = types.cStringToZigString(event_type);
-
-    // Duplicate the string so it persists (event stores pointer, not copy)
-    const type_copy = allocator.dupeZ(u8, type_str) catch return null;
-
-    const event_ptr = allocator.create(Event) catch {
-        allocator.free(type_copy);
-        return null;
-    };
-    event_ptr.* = Event.init(type_copy, .{
-        .bubbles = bubbles != 0,
-        .cancelable = cancelable != 0,
-        .composed = composed != 0,
-    });
-
-    return @ptrCast(event_ptr);
+    const record = event_pool.acquire(types.cStringToZigString(event_type), .{
+        .event_options = .{
+            .bubbles = bubbles != 0,
+            .cancelable = cancelable != 0,
+            .composed = composed != 0,
+        },
+    }) catch return null;
+    return @ptrCast(record.event());
 }
 
 // ============================================================================
@@ -266,6 +271,19 @@ pub export fn dom_event_get_eventphase(event: *DOMEvent) u16 {
     return @intFromEnum(evt.event_phase);
 }
 
+/// Gets the event's dispatch counter.
+///
+/// Not part of the DOM interface. Incremented when each dispatch of the
+/// event starts, so together with a non-zero eventPhase it identifies the
+/// dispatch in progress (bindings cache composedPath() per dispatch).
+///
+/// ## Returns
+/// Number of dispatches started for this event (wrapping)
+pub export fn dom_event_get_dispatchid(event: *DOMEvent) u32 {
+    const evt: *const Event = @ptrCast(@alignCast(event));
+    return evt.dispatch_id;
+}
+
 /// Gets whether the event bubbles.
 ///
 /// ## WebIDL
@@ -656,7 +674,11 @@ pub export fn dom_event_free_composedpath(path: [*]?*DOMEventTarget, count: u32)
 /// ```
 pub export fn dom_event_initevent(event: *DOMEvent, type_str: [*:0]const u8, bubbles: u8, cancelable: u8) void {
     const evt: *Event = @ptrCast(@alignCast(event));
-    const event_type = types.cStringToZigString(type_str);
+    if (evt.dispatch_flag) return;
+
+    // Keep a copy: the caller's string may not outlive the event
+    const record = PooledEvent.fromEvent(evt);
+    const event_type = record.storeType(event_pool.allocator, types.cStringToZigString(type_str)) catch return;
     const bubbles_bool = (bubbles != 0);
     const cancelable_bool = (cancelable != 0);
     evt.initEvent(event_type, bubbles_bool, cancelable_bool);
@@ -765,29 +787,48 @@ pub export fn dom_event_set_returnvalue(event: *DOMEvent, value: u8) void {
 /// ## Parameters
 /// - `event`: Event handle
 pub export fn dom_event_addref(event: *DOMEvent) void {
-    const allocator = std.heap.page_allocator;
-    // Events are value types in Zig, in C-ABI we heap-allocate
-    // For now, this is a no-op as events are typically short-lived
-    _ = event;
-    _ = allocator;
+    const evt: *Event = @ptrCast(@alignCast(event));
+    event_pool.retain(PooledEvent.fromEvent(evt));
 }
 
 /// Decrement the reference count of an Event.
 ///
-/// When count reaches 0, frees the event.
+/// When count reaches 0, the event returns to the event pool (or is freed
+/// when the pool is full or disabled).
 ///
 /// ## Parameters
 /// - `event`: Event handle
-///
-/// ## Note
-/// This currently leaks the event_type string. TODO: Track string ownership.
 pub export fn dom_event_release(event: *DOMEvent) void {
-    const allocator = std.heap.page_allocator;
     const evt: *Event = @ptrCast(@alignCast(event));
+    event_pool.release(PooledEvent.fromEvent(evt));
+}
+
+// ============================================================================
+// Event Pool
+// ============================================================================
 
-    // TODO: Free the event_type string (requires tracking ownership)
-    // For now, we leak it to avoid alignment issues
+/// Set how many released events this thread keeps for reuse.
+///
+/// Shared by Event and CustomEvent. 0 (the default) disables pooling;
+/// lowering the capacity frees the records beyond it.
+///
+/// ## Parameters
+/// - `capacity`: Most released events kept
+pub export fn dom_event_pool_set_capacity(capacity: u32) void {
+    event_pool.setCapacity(capacity);
+}
 
-    // Free the Event struct
-    allocator.destroy(evt);
+/// Get this thread's event pool statistics.
+///
+/// ## Parameters
+/// - `out`: Receives hit/miss counts and occupancy
+pub export fn dom_event_pool_get_stats(out: *types.DOMEventPoolStats) void {
+    const stats = event_pool.stats();
+    out.* = .{
+        .hits = stats.hits,
+        .misses = stats.misses,
+        .pooled = @intCast(stats.pooled),
+        .live = @intCast(stats.live),
+        .capacity = @intCast(stats.capacity),
+    };
 }
@@ -27,11 +27,13 @@
 //!
 //! Spec reference: https://dom.spec.whatwg.org/#eventtarget (WebIDL: dom.idl:67-73)
 //!
-//! ## Exported Functions (5 total)
+//! ## Exported Functions (7 total)
 //!
 //! ### Methods
 //! - `dom_eventtarget_addeventlistener()` - Add event listener
+//! - `dom_eventtarget_addeventlistener_owned()` - Add event listener that owns its user_data
 //! - `dom_eventtarget_removeeventlistener()` - Remove event listener
+//! - `dom_eventtarget_findeventlistener()` - Find a listener's user_data
 //! - `dom_eventtarget_dispatchevent()` - Dispatch an event
 //!
 //! ### Memory Management
@@ -66,7 +68,7 @@ const Event = dom.Event;
 const EventTarget = dom.EventTarget;
 const EventCallback = dom.EventTarget.EventCallback;
 const DOMEvent = types.DOMEvent;
-const DOMEventTarget = opaque {}; // EventTarget is a mixin, represented by Node/Document/Element
+pub const DOMEventTarget = opaque {}; // EventTarget is a mixin, represented by Node/Document/Element
 
 /// C-compatible event listener callback.
 ///
@@ -92,6 +94,123 @@ const DOMEventTarget = opaque {}; // EventTarget is a mixin, represented by Node
 /// ```
 pub const DOMEventListener = *const fn (event: *DOMEvent, user_data: ?*anyopaque) callconv(.c) void;
 
+/// Release callback for a listener's user_data.
+///
+/// Called once the listener is removed (removeEventListener, "once" after
+/// its invocation) or its target is destroyed. A listener may remove itself
+/// while it runs, so a callback must not touch its user_data after calling
+/// dom_eventtarget_removeeventlistener().
+pub const DOMEventListenerRelease = *const fn (user_data: ?*anyopaque) callconv(.c) void;
+
+/// Match callback for dom_eventtarget_findeventlistener().
+///
+/// Returns non-zero if the listener's user_data corresponds to `key`.
+pub const DOMEventListenerMatch = *const fn (user_data: ?*anyopaque, key: ?*anyopaque) callconv(.c) u8;
+
+/// Adapts a C listener to the Zig EventCallback.
+///
+/// Every C listener is registered with the shared `invoke` callback and its
+/// own CListener as context, which is how removal tells them apart.
+const CListener = struct {
+    allocator: std.mem.Allocator,
+    callback: DOMEventListener,
+    user_data: ?*anyopaque,
+    release_fn: ?DOMEventListenerRelease,
+
+    fn invoke(event: *Event, context: *anyopaque) void {
+        const self: *CListener = @ptrCast(@alignCast(context));
+        self.callback(@ptrCast(event), self.user_data);
+    }
+
+    fn release(context: *anyopaque) void {
+        const self: *CListener = @ptrCast(@alignCast(context));
+        if (self.release_fn) |release_fn| release_fn(self.user_data);
+        self.allocator.destroy(self);
+    }
+
+    /// Returns the CListener behind a registered listener, or null if the
+    /// listener was not added through the C-ABI.
+    fn of(listener: dom.EventListener) ?*CListener {
+        if (listener.callback != &invoke) return null;
+        return @ptrCast(@alignCast(listener.context));
+    }
+};
+
+/// Finds the C listener added with `callback` and `capture` whose user_data
+/// is `user_data` (or satisfies `match`, when given).
+fn findCListener(
+    node: *dom.Node,
+    event_type: []const u8,
+    callback: DOMEventListener,
+    capture: bool,
+    user_data: ?*anyopaque,
+    match: ?DOMEventListenerMatch,
+) ?*CListener {
+    const rare = node.rare_data orelse return null;
+    for (rare.getEventListeners(event_type)) |listener| {
+        if (listener.capture != capture) continue;
+        const c_listener = CListener.of(listener) orelse continue;
+        if (c_listener.callback != callback) continue;
+
+        const matches = if (match) |match_fn|
+            match_fn(c_listener.user_data, user_data) != 0
+        else
+            c_listener.user_data == user_data;
+        if (matches) return c_listener;
+    }
+    return null;
+}
+
+/// Interns an event type in the target's document, since listeners keep
+/// the type string for as long as they are registered.
+fn internEventType(node: *dom.Node, event_type: []const u8) ![]const u8 {
+    const doc_node = node.owner_document orelse node;
+    if (doc_node.node_type != .document) return error.InvalidStateError;
+    const doc: *dom.Document = @fieldParentPtr("prototype", doc_node);
+    return doc.string_pool.intern(event_type);
+}
+
+fn addCListener(
+    handle: *DOMEventTarget,
+    event_type: [*:0]const u8,
+    callback: DOMEventListener,
+    user_data: ?*anyopaque,
+    capture: bool,
+    once: bool,
+    passive: bool,
+    release_fn: ?DOMEventListenerRelease,
+) !void {
+    const node: *dom.Node = @ptrCast(@alignCast(handle));
+    const type_str = try internEventType(node, types.cStringToZigString(event_type));
+
+    // Adding the same callback, user_data and capture again does nothing
+    if (findCListener(node, type_str, callback, capture, user_data, null) != null) return;
+
+    const rare = try node.ensureRareData();
+
+    // Allocate the adapter on heap (lives until removed or the target is destroyed)
+    const allocator = node.allocator;
+    const c_listener = try allocator.create(CListener);
+    errdefer allocator.destroy(c_listener);
+    c_listener.* = .{
+        .allocator = allocator,
+        .callback = callback,
+        .user_data = user_data,
+        .release_fn = release_fn,
+    };
+
+    try rare.addEventListener(.{
+        .event_type = type_str,
+        .callback = CListener.invoke,
+        .context = @ptrCast(c_listener),
+        .capture = capture,
+        .once = once,
+        .passive = passive,
+        .signal = null, // AbortSignal not supported in C-ABI yet
+        .release_context = CListener.release,
+    });
+}
+
 // ============================================================================
 // Methods
 // ============================================================================
@@ -148,48 +267,51 @@ pub export fn dom_eventtarget_addeventlistener(
     passive: u8,
 ) c_int {
     // Early return if callback is null
-    if (callback == null) return 0;
+    const cb = callback orelse return 0;
 
-    const node: *dom.Node = @ptrCast(@alignCast(handle));
-    const type_str = types.cStringToZigString(event_type);
-
-    // Create a wrapper that adapts C callback to Zig EventCallback
-    const Wrapper = struct {
-        c_callback: DOMEventListener,
-        c_user_data: ?*anyopaque,
-
-        fn zigCallback(event: *Event, context: *anyopaque) void {
-            const wrapper: *@This() = @ptrCast(@alignCast(context));
-            const dom_event: *DOMEvent = @ptrCast(event);
-            wrapper.c_callback(dom_event, wrapper.c_user_data);
-        }
-    };
-
-    // Allocate wrapper on heap (lives until removeEventListener)
-    const allocator = node.allocator;
-    const wrapper = allocator.create(Wrapper) catch |err| {
+    addCListener(handle, event_type, cb, user_data, capture != 0, once != 0, passive != 0, null) catch |err| {
         return @intFromEnum(types.zigErrorToDOMError(err));
     };
-    wrapper.* = .{
-        .c_callback = callback.?,
-        .c_user_data = user_data,
-    };
+    return 0; // Success
+}
 
-    // Register listener with Zig callback
-    node.prototype.addEventListener(
-        type_str,
-        Wrapper.zigCallback,
-        @ptrCast(wrapper),
-        capture != 0,
-        once != 0,
-        passive != 0,
-        null, // AbortSignal not supported in C-ABI yet
-    ) catch |err| {
-        allocator.destroy(wrapper);
+/// Adds an event listener that owns its user_data.
+///
+/// Same as dom_eventtarget_addeventlistener(), but `release` is called with
+/// `user_data` once the listener is removed or the target is destroyed, so
+/// bindings can keep per-listener state (e.g. a JS function handle) alive
+/// exactly as long as the listener. If the same callback, user_data and
+/// capture are already registered, nothing is added and `release` is not
+/// called.
+///
+/// ## Parameters
+/// - `handle`: EventTarget handle (Node, Document, or Element)
+/// - `event_type`: Event type string (e.g., "click", "load")
+/// - `callback`: C function pointer for event handler
+/// - `user_data`: User context pointer (passed to callback and release)
+/// - `capture`: 1 to listen in capture phase, 0 for bubble phase
+/// - `once`: 1 to remove listener after first invocation, 0 otherwise
+/// - `passive`: 1 for passive listener (can't preventDefault), 0 otherwise
+/// - `release`: Called with user_data when the listener goes away (may be NULL)
+///
+/// ## Returns
+/// 0 on success, non-zero error code on failure (release is not called)
+pub export fn dom_eventtarget_addeventlistener_owned(
+    handle: *DOMEventTarget,
+    event_type: [*:0]const u8,
+    callback: ?DOMEventListener,
+    user_data: ?*anyopaque,
+    capture: u8,
+    once: u8,
+    passive: u8,
+    release: ?DOMEventListenerRelease,
+) c_int {
+    const cb = callback orelse return 0;
+
+    addCListener(handle, event_type, cb, user_data, capture != 0, once != 0, passive != 0, release) catch |err| {
         return @intFromEnum(types.zigErrorToDOMError(err));
     };
-
-    return 0; // Success
+    return 0;
 }
 
 /// Removes an event listener from the EventTarget.
@@ -233,23 +355,50 @@ pub export fn dom_eventtarget_removeeventlistener(
     capture: u8,
 ) void {
     // Early return if callback is null
-    if (callback == null) return;
+    const cb = callback orelse return;
+
+    const node: *dom.Node = @ptrCast(@alignCast(handle));
+    const type_str = types.cStringToZigString(event_type);
+
+    const c_listener = findCListener(node, type_str, cb, capture != 0, user_data, null) orelse return;
+    const rare = node.rare_data.?;
+    if (rare.takeEventListener(type_str, CListener.invoke, @ptrCast(c_listener), capture != 0)) |removed| {
+        removed.release();
+    }
+}
+
+/// Finds a listener added through the C-ABI.
+///
+/// Returns the user_data of the first listener registered for `event_type`
+/// with `callback` and `capture` for which `match(user_data, key)` returns
+/// non-zero. Bindings that register every listener through one callback
+/// use this to find the registration of a given script function.
+///
+/// ## Parameters
+/// - `handle`: EventTarget handle (Node, Document, or Element)
+/// - `event_type`: Event type string
+/// - `callback`: C function pointer the listener was added with
+/// - `capture`: 1 for capture listeners, 0 for bubble listeners
+/// - `match`: Predicate called with each candidate's user_data and `key`
+/// - `key`: Passed through to `match`
+///
+/// ## Returns
+/// Matching listener's user_data, or NULL if none matches
+pub export fn dom_eventtarget_findeventlistener(
+    handle: *DOMEventTarget,
+    event_type: [*:0]const u8,
+    callback: ?DOMEventListener,
+    capture: u8,
+    match: DOMEventListenerMatch,
+    key: ?*anyopaque,
+) ?*anyopaque {
+    const cb = callback orelse return null;
 
     const node: *dom.Node = @ptrCast(@alignCast(handle));
     const type_str = types.cStringToZigString(event_type);
 
-    // NOTE: We can't actually remove the listener because we don't have
-    // the wrapper pointer. This is a known limitation.
-    //
-    // WORKAROUND: JavaScript engines typically manage listeners themselves
-    // and don't rely on C-ABI removeEventListener.
-    //
-    // TODO: Store wrapper pointers in a map keyed by (type, callback, user_data, capture)
-    // so we can look them up and remove them properly.
-
-    // For now, this is a no-op
-    // Real implementation would require a registry of wrapper pointers
-    _ = .{ node, type_str, callback, user_data, capture };
+    const c_listener = findCListener(node, type_str, cb, capture != 0, key, match) orelse return null;
+    return c_listener.user_data;
 }
 
 /// Dispatches an event at this EventTarget.
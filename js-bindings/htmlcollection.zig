@@ -13,6 +13,7 @@
 //! uint32_t dom_htmlcollection_get_length(DOMHTMLCollection* collection);
 //! DOMElement* dom_htmlcollection_item(DOMHTMLCollection* collection, uint32_t index);
 //! DOMElement* dom_htmlcollection_nameditem(DOMHTMLCollection* collection, const char* name);
+//! uint32_t dom_htmlcollection_get_items(DOMHTMLCollection* collection, DOMElement** out, uint32_t capacity);
 //!
 //! // Release
 //! void dom_htmlcollection_release(DOMHTMLCollection* collection);
@@ -179,6 +180,25 @@ pub export fn dom_htmlcollection_nameditem(collection: *DOMHTMLCollection, name:
     return null;
 }
 
+/// Copy the elements of an HTMLCollection into a caller-provided array.
+///
+/// Fills `out` with up to `capacity` elements in collection order and
+/// returns the total count, which may exceed `capacity`. One traversal
+/// regardless of the collection kind; pointers are borrowed.
+///
+/// ## Parameters
+/// - `collection`: HTMLCollection handle
+/// - `out`: Array to fill (may be NULL when capacity is 0)
+/// - `capacity`: Size of out
+///
+/// ## Returns
+/// Number of elements in the collection
+pub export fn dom_htmlcollection_get_items(collection: *DOMHTMLCollection, out: ?[*]*DOMElement, capacity: u32) u32 {
+    const html_collection: *HTMLCollection = @ptrCast(@alignCast(collection));
+    const buffer: []*Element = if (out) |ptr| @ptrCast(ptr[0..capacity]) else &.{};
+    return @intCast(html_collection.copyItems(buffer));
+}
+
 // ============================================================================
 // Memory Management
 // ============================================================================
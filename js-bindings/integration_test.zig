@@ -10,6 +10,31 @@ const testing = std.testing;
 const node_bindings = @import("node.zig");
 const element_bindings = @import("element.zig");
 const document_bindings = @import("document.zig");
+const domimplementation_bindings = @import("domimplementation.zig");
+const tokenlist_bindings = @import("domtokenlist.zig");
+const event_bindings = @import("event.zig");
+const eventtarget_bindings = @import("eventtarget.zig");
+const mutationobserver_bindings = @import("mutationobserver.zig");
+const range_bindings = @import("range.zig");
+const treewalker_bindings = @import("treewalker.zig");
+const nodeiterator_bindings = @import("nodeiterator.zig");
+const elementiterator_bindings = @import("elementiterator.zig");
+const closestmemo_bindings = @import("closestmemo.zig");
+const nodetable_bindings = @import("nodetable.zig");
+const query_bindings = @import("query.zig");
+const nodefilter_bindings = @import("nodefilter.zig");
+const parentnode_bindings = @import("parentnode.zig");
+const documentfragment_bindings = @import("documentfragment.zig");
+const treebuilder_bindings = @import("treebuilder.zig");
+const template_bindings = @import("template.zig");
+const shadowroot_bindings = @import("shadowroot.zig");
+const abortcontroller_bindings = @import("abortcontroller.zig");
+const abortsignal_bindings = @import("abortsignal.zig");
+const namednodemap_bindings = @import("namednodemap.zig");
+const attr_bindings = @import("attr.zig");
+const characterdata_bindings = @import("characterdata.zig");
+const text_bindings = @import("text.zig");
+const customelementregistry_bindings = @import("customelementregistry.zig");
 const dom_types = @import("dom_types.zig");
 
 // Type aliases for convenience
@@ -156,6 +181,167 @@ test "Element: removeAttribute" {
     try testing.expectEqual(@as(u8, 0), element_bindings.dom_element_hasattribute(elem, "id"));
 }
 
+test "Element: attributes by atom" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    const elem = document_bindings.dom_document_createelement(doc, "element");
+    defer element_bindings.dom_element_release(elem);
+
+    const name = "data-row";
+    const atom = document_bindings.dom_document_intern_name(doc, name, name.len).?;
+    try testing.expectEqual(atom, document_bindings.dom_document_intern_name(doc, name, name.len).?);
+
+    try testing.expectEqual(@as(u8, 0), element_bindings.dom_element_hasattribute_atom(elem, atom));
+    try testing.expectEqual(@as(c_int, 0), element_bindings.dom_element_setattribute_atom(elem, atom, "7", 1));
+    try testing.expectEqual(@as(u8, 1), element_bindings.dom_element_hasattribute_atom(elem, atom));
+    try testing.expectEqual(@as(u8, 1), element_bindings.dom_element_hasattribute(elem, "data-row"));
+
+    var view: dom_types.DOMStringView = undefined;
+    try testing.expect(element_bindings.dom_element_getattribute_atom_view(elem, atom, &view));
+    try testing.expectEqualStrings("7", view.data[0..view.length]);
+
+    // The stored name is the atom itself
+    var names: [1]dom_types.DOMStringView = undefined;
+    try testing.expectEqual(@as(u32, 1), element_bindings.dom_element_getattributenames_view(elem, &names, names.len));
+    try testing.expectEqual(@intFromPtr(atom), @intFromPtr(names[0].data));
+    try testing.expect(names[0].is_interned);
+}
+
+test "Element: attribute names through a callback" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    const elem = document_bindings.dom_document_createelement(doc, "element");
+    defer element_bindings.dom_element_release(elem);
+
+    _ = element_bindings.dom_element_setattribute(elem, "first", "1");
+    _ = element_bindings.dom_element_setattribute(elem, "second", "2");
+    _ = element_bindings.dom_element_setattribute(elem, "third", "3");
+
+    const Collect = struct {
+        names: [4][]const u8 = undefined,
+        count: usize = 0,
+
+        fn add(name: *const dom_types.DOMStringView, user_data: ?*anyopaque) callconv(.c) void {
+            const self: *@This() = @ptrCast(@alignCast(user_data.?));
+            self.names[self.count] = name.data[0..name.length];
+            self.count += 1;
+        }
+    };
+
+    var collected = Collect{};
+    element_bindings.dom_element_foreach_attributename(elem, Collect.add, &collected);
+    try testing.expectEqual(@as(usize, 3), collected.count);
+    try testing.expectEqualStrings("first", collected.names[0]);
+    try testing.expectEqualStrings("second", collected.names[1]);
+    try testing.expectEqualStrings("third", collected.names[2]);
+}
+
+test "Element: attribute names and values without Attr nodes" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    const elem = document_bindings.dom_document_createelement(doc, "element");
+    defer element_bindings.dom_element_release(elem);
+
+    _ = element_bindings.dom_element_setattribute(elem, "first", "1");
+    _ = element_bindings.dom_element_setattribute(elem, "second", "two");
+
+    const Collect = struct {
+        names: [4][]const u8 = undefined,
+        values: [4][]const u8 = undefined,
+        count: usize = 0,
+
+        fn add(name: *const dom_types.DOMStringView, value: *const dom_types.DOMStringView, user_data: ?*anyopaque) callconv(.c) void {
+            const self: *@This() = @ptrCast(@alignCast(user_data.?));
+            self.names[self.count] = name.data[0..name.length];
+            self.values[self.count] = value.data[0..value.length];
+            self.count += 1;
+        }
+    };
+
+    var collected = Collect{};
+    element_bindings.dom_element_foreach_attribute(elem, Collect.add, &collected);
+    try testing.expectEqual(@as(usize, 2), collected.count);
+    try testing.expectEqualStrings("first", collected.names[0]);
+    try testing.expectEqualStrings("1", collected.values[0]);
+    try testing.expectEqualStrings("second", collected.names[1]);
+    try testing.expectEqualStrings("two", collected.values[1]);
+}
+
+test "NamedNodeMap: item hands out the same attached Attr" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    const elem = document_bindings.dom_document_createelement(doc, "element");
+    defer element_bindings.dom_element_release(elem);
+
+    _ = element_bindings.dom_element_setattribute(elem, "id", "before");
+
+    const map = element_bindings.dom_element_get_attributes(elem);
+    try testing.expectEqual(@as(u32, 1), namednodemap_bindings.dom_namednodemap_get_length(map));
+    const attr = namednodemap_bindings.dom_namednodemap_item(map, 0).?;
+    defer attr_bindings.dom_attr_release(attr);
+    const again = namednodemap_bindings.dom_namednodemap_item(map, 0).?;
+    defer attr_bindings.dom_attr_release(again);
+    try testing.expectEqual(attr, again);
+    try testing.expect(namednodemap_bindings.dom_namednodemap_item(map, 1) == null);
+
+    // Writing the Attr writes the element, and the Attr stays attached
+    try testing.expectEqual(@as(c_int, 0), attr_bindings.dom_attr_set_value(attr, "after"));
+    try testing.expectEqualStrings("after", std.mem.span(element_bindings.dom_element_getattribute(elem, "id").?));
+    try testing.expect(attr_bindings.dom_attr_get_ownerelement(attr) != null);
+
+    var view: dom_types.DOMStringView = undefined;
+    attr_bindings.dom_attr_get_value_view(attr, &view);
+    try testing.expectEqualStrings("after", view.data[0..view.length]);
+    attr_bindings.dom_attr_get_name_view(attr, &view);
+    try testing.expectEqualStrings("id", view.data[0..view.length]);
+    try testing.expect(!attr_bindings.dom_attr_get_namespaceuri_view(attr, &view));
+}
+
+test "NamedNodeMap: borrowed lookups return the cached Attr" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    const elem = document_bindings.dom_document_createelement(doc, "element");
+    defer element_bindings.dom_element_release(elem);
+
+    _ = element_bindings.dom_element_setattribute(elem, "id", "main");
+
+    const map = element_bindings.dom_element_get_attributes(elem);
+    const borrowed = namednodemap_bindings.dom_namednodemap_item_borrowed(map, 0).?;
+    try testing.expectEqual(borrowed, namednodemap_bindings.dom_namednodemap_getnameditem_borrowed(map, "id").?);
+    try testing.expect(namednodemap_bindings.dom_namednodemap_item_borrowed(map, 1) == null);
+    try testing.expect(namednodemap_bindings.dom_namednodemap_getnameditem_borrowed(map, "missing") == null);
+
+    // Owned lookups hand out the same Attr
+    const owned = namednodemap_bindings.dom_namednodemap_item(map, 0).?;
+    defer attr_bindings.dom_attr_release(owned);
+    try testing.expectEqual(borrowed, owned);
+}
+
+test "Element: setAttributes in one call" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    const elem = document_bindings.dom_document_createelement(doc, "element");
+    defer element_bindings.dom_element_release(elem);
+
+    const names = [_][*]const u8{ "first", "second-name", "first" };
+    const name_lens = [_]usize{ 5, 6, 5 };
+    const values = [_][*]const u8{ "1", "2", "3" };
+    const value_lens = [_]usize{ 1, 1, 1 };
+    try testing.expectEqual(@as(c_int, 0), element_bindings.dom_element_setattributes(elem, &names, &name_lens, &values, &value_lens, names.len));
+
+    // Later pairs win; lengths are honored
+    try testing.expectEqual(@as(u8, 1), element_bindings.dom_element_hasattribute(elem, "second"));
+    try testing.expectEqual(@as(u8, 0), element_bindings.dom_element_hasattribute(elem, "second-name"));
+    try testing.expectEqualStrings("3", std.mem.span(element_bindings.dom_element_getattribute(elem, "first").?));
+    try testing.expectEqual(@as(u32, 2), element_bindings.dom_element_getattributenames_view(elem, null, 0));
+}
+
 test "Element: id convenience property" {
     const doc = document_bindings.dom_document_new();
     defer document_bindings.dom_document_release(doc);
@@ -288,6 +474,26 @@ test "Node: contains" {
     element_bindings.dom_element_release(unrelated);
 }
 
+test "Node: getRootNode" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    const root = document_bindings.dom_document_createelement(doc, "root");
+    const leaf = document_bindings.dom_document_createelement(doc, "leaf");
+
+    const doc_node = @as(*DOMNode, @ptrCast(doc));
+    const root_node = @as(*DOMNode, @ptrCast(root));
+    const leaf_node = @as(*DOMNode, @ptrCast(leaf));
+
+    _ = node_bindings.dom_node_appendchild(root_node, leaf_node);
+    try testing.expectEqual(root_node, node_bindings.dom_node_getrootnode(leaf_node, 0));
+
+    _ = node_bindings.dom_node_appendchild(doc_node, root_node);
+    try testing.expectEqual(doc_node, node_bindings.dom_node_getrootnode(leaf_node, 0));
+    try testing.expectEqual(doc_node, node_bindings.dom_node_getrootnode(leaf_node, 1));
+    try testing.expectEqual(doc_node, node_bindings.dom_node_getrootnode(doc_node, 0));
+}
+
 test "Complex: build document tree" {
     const doc = document_bindings.dom_document_new();
     defer document_bindings.dom_document_release(doc);
@@ -363,3 +569,1519 @@ test "Memory: no leaks with complex tree" {
 
     // If we reach here without leaks, test passes
 }
+
+test "Element: querySelectorAll with batched item copy" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    const root = document_bindings.dom_document_createelement(doc, "root");
+    defer element_bindings.dom_element_release(root);
+    const root_node = @as(*DOMNode, @ptrCast(root));
+
+    var i: usize = 0;
+    while (i < 3) : (i += 1) {
+        const item = document_bindings.dom_document_createelement(doc, "item");
+        _ = node_bindings.dom_node_appendchild(root_node, @ptrCast(item));
+    }
+
+    const list = element_bindings.dom_element_queryselectorall(root, "item") orelse return error.NoMatches;
+    defer document_bindings.dom_nodelist_static_release(list);
+
+    var out: [2]*DOMNode = undefined;
+    const total = document_bindings.dom_nodelist_static_items(list, &out, out.len);
+    try testing.expectEqual(@as(u32, 3), total);
+    try testing.expectEqual(node_bindings.dom_node_get_firstchild(root_node).?, out[0]);
+    try testing.expectEqual(document_bindings.dom_nodelist_static_item(list, 1).?, out[1]);
+
+    // No matches
+    try testing.expect(element_bindings.dom_element_queryselectorall(root, "missing") == null);
+}
+
+test "DOMTokenList: classList batched add and remove" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    const elem = document_bindings.dom_document_createelement(doc, "item");
+    defer element_bindings.dom_element_release(elem);
+
+    const list = tokenlist_bindings.dom_element_get_classlist(@ptrCast(elem)) orelse return error.OutOfMemory;
+    defer tokenlist_bindings.dom_domtokenlist_release(list);
+
+    const added = [_][*:0]const u8{ "row", "wide", "row" };
+    try testing.expectEqual(@as(c_int, 0), tokenlist_bindings.dom_domtokenlist_add(list, &added, added.len));
+    try testing.expectEqual(@as(u32, 2), tokenlist_bindings.dom_domtokenlist_get_length(list));
+    try testing.expectEqual(@as(u8, 1), tokenlist_bindings.dom_domtokenlist_contains(list, "wide"));
+
+    const removed = [_][*:0]const u8{"row"};
+    try testing.expectEqual(@as(c_int, 0), tokenlist_bindings.dom_domtokenlist_remove(list, &removed, removed.len));
+    try testing.expectEqual(@as(u8, 0), tokenlist_bindings.dom_domtokenlist_contains(list, "row"));
+
+    // Invalid tokens are rejected
+    const invalid = [_][*:0]const u8{""};
+    try testing.expect(tokenlist_bindings.dom_domtokenlist_add(list, &invalid, invalid.len) != 0);
+}
+
+const ListenerState = struct {
+    calls: u32 = 0,
+    released: u32 = 0,
+
+    fn invoke(_: *dom_types.DOMEvent, user_data: ?*anyopaque) callconv(.c) void {
+        const self: *ListenerState = @ptrCast(@alignCast(user_data.?));
+        self.calls += 1;
+    }
+
+    fn release(user_data: ?*anyopaque) callconv(.c) void {
+        const self: *ListenerState = @ptrCast(@alignCast(user_data.?));
+        self.released += 1;
+    }
+
+    fn matches(user_data: ?*anyopaque, key: ?*anyopaque) callconv(.c) u8 {
+        return if (user_data == key) 1 else 0;
+    }
+};
+
+test "EventTarget: owned listeners are found, removed and released" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    const root = document_bindings.dom_document_createelement(doc, "root");
+    const leaf = document_bindings.dom_document_createelement(doc, "leaf");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(doc), @ptrCast(root));
+    _ = node_bindings.dom_node_appendchild(@ptrCast(root), @ptrCast(leaf));
+
+    var first = ListenerState{};
+    var second = ListenerState{};
+    const target: *eventtarget_bindings.DOMEventTarget = @ptrCast(root);
+    try testing.expectEqual(@as(c_int, 0), eventtarget_bindings.dom_eventtarget_addeventlistener_owned(
+        target, "ping", ListenerState.invoke, &first, 0, 0, 0, ListenerState.release));
+    try testing.expectEqual(@as(c_int, 0), eventtarget_bindings.dom_eventtarget_addeventlistener_owned(
+        target, "ping", ListenerState.invoke, &second, 0, 0, 0, ListenerState.release));
+
+    // Same callback, user_data and capture: not added twice
+    try testing.expectEqual(@as(c_int, 0), eventtarget_bindings.dom_eventtarget_addeventlistener_owned(
+        target, "ping", ListenerState.invoke, &first, 0, 0, 0, ListenerState.release));
+
+    const found = eventtarget_bindings.dom_eventtarget_findeventlistener(target, "ping", ListenerState.invoke, 0, ListenerState.matches, &second);
+    try testing.expectEqual(@as(?*anyopaque, @ptrCast(&second)), found);
+    try testing.expect(eventtarget_bindings.dom_eventtarget_findeventlistener(target, "ping", ListenerState.invoke, 1, ListenerState.matches, &second) == null);
+
+    // Bubbles from the leaf to both listeners on root
+    const event = event_bindings.dom_event_new("ping", 1, 0, 0) orelse return error.OutOfMemory;
+    defer event_bindings.dom_event_release(event);
+    try testing.expectEqual(@as(u8, 1), eventtarget_bindings.dom_eventtarget_dispatchevent(@ptrCast(leaf), event));
+    try testing.expectEqual(@as(u32, 1), first.calls);
+    try testing.expectEqual(@as(u32, 1), second.calls);
+
+    // Removing the first leaves the second registered
+    eventtarget_bindings.dom_eventtarget_removeeventlistener(target, "ping", ListenerState.invoke, &first, 0);
+    try testing.expectEqual(@as(u32, 1), first.released);
+    try testing.expectEqual(@as(u32, 0), second.released);
+}
+
+test "Event pool: released events are reused once enabled" {
+    event_bindings.dom_event_pool_set_capacity(4);
+    defer event_bindings.dom_event_pool_set_capacity(0);
+
+    var before: dom_types.DOMEventPoolStats = undefined;
+    event_bindings.dom_event_pool_get_stats(&before);
+
+    const first = event_bindings.dom_event_new("ping", 1, 0, 0) orelse return error.OutOfMemory;
+    // A wrapper's reference keeps the event out of the pool
+    event_bindings.dom_event_addref(first);
+    event_bindings.dom_event_release(first);
+    var stats: dom_types.DOMEventPoolStats = undefined;
+    event_bindings.dom_event_pool_get_stats(&stats);
+    try testing.expectEqual(before.live + 1, stats.live);
+
+    event_bindings.dom_event_release(first);
+    event_bindings.dom_event_pool_get_stats(&stats);
+    try testing.expectEqual(before.pooled + 1, stats.pooled);
+
+    // initEvent copies the type, so a temporary string is fine
+    const second = event_bindings.dom_event_new("pong", 0, 0, 0) orelse return error.OutOfMemory;
+    defer event_bindings.dom_event_release(second);
+    try testing.expectEqual(first, second);
+    var type_buffer = [_:0]u8{ 'r', 'e', 's', 'e', 't' };
+    event_bindings.dom_event_initevent(second, &type_buffer, 1, 1);
+    type_buffer[0] = 'x';
+    try testing.expectEqualStrings("reset", std.mem.span(event_bindings.dom_event_get_type(second)));
+
+    event_bindings.dom_event_pool_get_stats(&stats);
+    try testing.expectEqual(before.hits + 1, stats.hits);
+    try testing.expectEqual(@as(u32, 4), stats.capacity);
+}
+
+const NotifyState = struct {
+    calls: u32 = 0,
+
+    fn notify(_: *dom_types.DOMMutationObserver, context: ?*anyopaque) callconv(.c) void {
+        const self: *NotifyState = @ptrCast(@alignCast(context.?));
+        self.calls += 1;
+    }
+
+    fn ignoreRecords(_: [*]const *dom_types.DOMMutationRecord, _: u32, _: *dom_types.DOMMutationObserver, _: ?*anyopaque) callconv(.c) void {}
+};
+
+test "MutationObserver: notify and packed record batch" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    const root = document_bindings.dom_document_createelement(doc, "root");
+    defer element_bindings.dom_element_release(root);
+    const item = document_bindings.dom_document_createelement(doc, "item");
+
+    const observer = mutationobserver_bindings.dom_mutationobserver_new(NotifyState.ignoreRecords, null) orelse return error.OutOfMemory;
+    defer mutationobserver_bindings.dom_mutationobserver_release(observer);
+    var state = NotifyState{};
+    mutationobserver_bindings.dom_mutationobserver_set_notify(observer, NotifyState.notify, &state);
+
+    var options = std.mem.zeroes(mutationobserver_bindings.DOMMutationObserverInit);
+    options.child_list = 1;
+    options.attributes = 1;
+    options.attribute_old_value = 1;
+    try testing.expectEqual(dom_types.DOMErrorCode.Success, mutationobserver_bindings.dom_mutationobserver_observe(observer, @ptrCast(root), &options));
+
+    _ = node_bindings.dom_node_appendchild(@ptrCast(root), @ptrCast(item));
+    _ = element_bindings.dom_element_setattribute(root, "state", "open");
+    _ = element_bindings.dom_element_setattribute(root, "state", "closed");
+    try testing.expectEqual(@as(u32, 1), state.calls);
+
+    const batch = mutationobserver_bindings.dom_mutationobserver_takebatch(observer) orelse return error.OutOfMemory;
+    defer mutationobserver_bindings.dom_mutationbatch_release(batch);
+    try testing.expectEqual(@as(u32, 3), mutationobserver_bindings.dom_mutationbatch_get_count(batch));
+
+    var node_count: u32 = 0;
+    const nodes = mutationobserver_bindings.dom_mutationbatch_get_nodes(batch, &node_count).?;
+    try testing.expectEqual(@as(u32, 2), node_count);
+
+    const entries = mutationobserver_bindings.dom_mutationbatch_get_entries(batch).?;
+    const stride = 8; // DOM_MUTATION_BATCH_STRIDE
+    try testing.expectEqual(@as(u32, 2), entries[0]); // childList
+    try testing.expectEqual(@as(*DOMNode, @ptrCast(root)), nodes[entries[1]]);
+    var list_count: u32 = 0;
+    const lists = mutationobserver_bindings.dom_mutationbatch_get_nodelists(batch, &list_count).?;
+    try testing.expectEqual(@as(u32, 1), list_count);
+    try testing.expectEqual(@as(*DOMNode, @ptrCast(item)), nodes[lists[entries[2]]]);
+
+    try testing.expectEqual(@as(u32, 0), entries[2 * stride]); // attributes
+    var view: dom_types.DOMStringView = undefined;
+    try testing.expect(mutationobserver_bindings.dom_mutationbatch_get_attributename(batch, 2, &view));
+    try testing.expectEqualStrings("state", view.data[0..view.length]);
+    try testing.expect(mutationobserver_bindings.dom_mutationbatch_get_oldvalue(batch, 2, &view));
+    try testing.expectEqualStrings("open", view.data[0..view.length]);
+    try testing.expect(!mutationobserver_bindings.dom_mutationbatch_get_oldvalue(batch, 1, &view));
+}
+
+test "ParentNode: append batch is one childList record" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    const root = document_bindings.dom_document_createelement(doc, "root");
+    defer element_bindings.dom_element_release(root);
+
+    const observer = mutationobserver_bindings.dom_mutationobserver_new(NotifyState.ignoreRecords, null) orelse return error.OutOfMemory;
+    defer mutationobserver_bindings.dom_mutationobserver_release(observer);
+
+    var options = std.mem.zeroes(mutationobserver_bindings.DOMMutationObserverInit);
+    options.child_list = 1;
+    try testing.expectEqual(dom_types.DOMErrorCode.Success, mutationobserver_bindings.dom_mutationobserver_observe(observer, @ptrCast(root), &options));
+
+    var nodes: [3]*DOMNode = undefined;
+    for (&nodes) |*node| {
+        node.* = @ptrCast(document_bindings.dom_document_createelement(doc, "item"));
+    }
+    try testing.expectEqual(dom_types.DOMErrorCode.Success, parentnode_bindings.dom_parentnode_append(@ptrCast(root), &nodes, nodes.len));
+    try testing.expectEqual(@as(*DOMNode, nodes[2]), node_bindings.dom_node_get_lastchild(@ptrCast(root)).?);
+
+    const batch = mutationobserver_bindings.dom_mutationobserver_takebatch(observer) orelse return error.OutOfMemory;
+    defer mutationobserver_bindings.dom_mutationbatch_release(batch);
+    try testing.expectEqual(@as(u32, 1), mutationobserver_bindings.dom_mutationbatch_get_count(batch));
+
+    var list_count: u32 = 0;
+    _ = mutationobserver_bindings.dom_mutationbatch_get_nodelists(batch, &list_count);
+    try testing.expectEqual(@as(u32, 3), list_count);
+}
+
+test "TreeBuilder: builds a fragment through the C-ABI" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    const builder = treebuilder_bindings.dom_builder_new(doc) orelse return error.OutOfMemory;
+    defer treebuilder_bindings.dom_builder_release(builder);
+
+    const attrs = [_]treebuilder_bindings.DOMBuilderAttribute{.{ .name = "class", .value = "rows" }};
+    try testing.expectEqual(@as(c_int, 0), treebuilder_bindings.dom_builder_open(builder, "list", &attrs, attrs.len));
+    try testing.expectEqual(@as(c_int, 0), treebuilder_bindings.dom_builder_text(builder, "line", 4));
+
+    // One encoded chunk: open "item", close, close
+    const chunk = [_]u8{ 1, 4, 0, 0, 0, 'i', 't', 'e', 'm', 0, 0, 0, 0, 3, 3 };
+    try testing.expectEqual(@as(c_int, 0), treebuilder_bindings.dom_builder_write(builder, &chunk, chunk.len));
+    try testing.expectEqual(@as(c_int, @intFromEnum(dom_types.DOMErrorCode.InvalidStateError)), treebuilder_bindings.dom_builder_close(builder));
+    try testing.expectEqual(@as(c_int, @intFromEnum(dom_types.DOMErrorCode.SyntaxError)), treebuilder_bindings.dom_builder_write(builder, &[_]u8{9}, 1));
+
+    const fragment = treebuilder_bindings.dom_builder_finish(builder) orelse return error.OutOfMemory;
+    defer documentfragment_bindings.dom_documentfragment_release(fragment);
+
+    const list = node_bindings.dom_node_get_firstchild(@ptrCast(fragment)).?;
+    try testing.expectEqualStrings("rows", std.mem.span(element_bindings.dom_element_getattribute(@ptrCast(list), "class").?));
+    const item = node_bindings.dom_node_get_lastchild(list).?;
+    try testing.expectEqual(@as(u16, 1), node_bindings.dom_node_get_nodetype(item));
+    try testing.expectEqual(@as(u16, 3), node_bindings.dom_node_get_nodetype(node_bindings.dom_node_get_firstchild(list).?));
+}
+
+test "Element: markup insertion through the C-ABI" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    const root = document_bindings.dom_document_createelement(doc, "root");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(doc), @ptrCast(root));
+
+    const rows = "<row id=\"first\">one</row><row>two</row>";
+    try testing.expectEqual(@as(c_int, 0), element_bindings.dom_element_setinnermarkup(root, rows, rows.len));
+    const first = node_bindings.dom_node_get_firstchild(@ptrCast(root)).?;
+    const tail = "<!--end-->";
+    try testing.expectEqual(@as(c_int, 0), element_bindings.dom_element_insertadjacentmarkup(@ptrCast(first), "afterend", tail, tail.len));
+
+    var buffer: [128]u8 = undefined;
+    const len = node_bindings.dom_node_serialize_into(@ptrCast(root), 1, &buffer, buffer.len);
+    try testing.expectEqualStrings("<row id=\"first\">one</row><!--end--><row>two</row>", buffer[0..len]);
+
+    try testing.expectEqual(
+        @as(c_int, @intFromEnum(dom_types.DOMErrorCode.SyntaxError)),
+        element_bindings.dom_element_insertadjacentmarkup(root, "inside", tail, tail.len),
+    );
+    try testing.expectEqual(
+        @as(c_int, @intFromEnum(dom_types.DOMErrorCode.NoModificationAllowedError)),
+        element_bindings.dom_element_insertadjacentmarkup(root, "beforebegin", tail, tail.len),
+    );
+
+    try testing.expectEqual(@as(c_int, 0), element_bindings.dom_element_setinnermarkup(root, "", 0));
+    try testing.expect(node_bindings.dom_node_get_firstchild(@ptrCast(root)) == null);
+}
+
+test "Document: arena documents through the C-ABI" {
+    const arena_doc = document_bindings.dom_document_new_with_arena(4096) orelse return error.OutOfMemory;
+    defer document_bindings.dom_document_release(arena_doc);
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    const list = document_bindings.dom_document_createelement(arena_doc, "list");
+    _ = element_bindings.dom_element_setattribute(list, "class", "rows");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(list), @ptrCast(document_bindings.dom_document_createelement(arena_doc, "item")));
+
+    // A copy can leave the arena document; the original stays where it is
+    const copy = document_bindings.dom_document_importnode(doc, @ptrCast(list), 1);
+    defer node_bindings.dom_node_release(copy);
+    try testing.expectEqual(@as(*dom_types.DOMDocument, arena_doc), node_bindings.dom_node_get_ownerdocument(@ptrCast(list)).?);
+    try testing.expectEqual(@as(*dom_types.DOMDocument, doc), node_bindings.dom_node_get_ownerdocument(copy).?);
+    try testing.expect(node_bindings.dom_node_get_firstchild(copy) != null);
+
+    // Releasing an arena node is a no-op
+    element_bindings.dom_element_release(list);
+}
+
+test "Document: allocated bytes grow with the tree" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    const empty = document_bindings.dom_document_get_allocated_bytes(doc);
+    const root = document_bindings.dom_document_createelement(doc, "root");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(doc), @ptrCast(root));
+    for (0..8) |_| {
+        _ = node_bindings.dom_node_appendchild(@ptrCast(root), @ptrCast(document_bindings.dom_document_createelement(doc, "item")));
+    }
+    try testing.expect(document_bindings.dom_document_get_allocated_bytes(doc) > empty);
+}
+
+test "Document: capacity hints reserve storage up front" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    const before = document_bindings.dom_document_get_allocated_bytes(doc);
+    try testing.expectEqual(@as(c_int, 0), document_bindings.dom_document_reserve(doc, 1024, 4096));
+    try testing.expect(document_bindings.dom_document_get_allocated_bytes(doc) >= before + 4096);
+
+    const impl = document_bindings.dom_document_get_implementation(doc);
+    const sized = domimplementation_bindings.dom_domimplementation_createdocument_with_capacity(impl, null, "root", null, 1024, 4096).?;
+    defer document_bindings.dom_document_release(sized);
+    const root = document_bindings.dom_document_get_documentelement(sized).?;
+    try testing.expectEqualStrings("root", std.mem.span(element_bindings.dom_element_get_tagname(root)));
+}
+
+test "Document: live node count follows node lifetimes" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    const before = document_bindings.dom_document_get_live_node_count(doc);
+    const item = document_bindings.dom_document_createelement(doc, "item");
+    try testing.expectEqual(before + 1, document_bindings.dom_document_get_live_node_count(doc));
+
+    element_bindings.dom_element_release(item);
+    try testing.expectEqual(before, document_bindings.dom_document_get_live_node_count(doc));
+}
+
+test "Node: release_many drops node and document references" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    const list = document_bindings.dom_document_createelement(doc, "list");
+    defer element_bindings.dom_element_release(list);
+    const item = document_bindings.dom_document_createelement(doc, "item");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(list), @ptrCast(item));
+
+    // One extra reference each, as a wrapper cache would hold
+    element_bindings.dom_element_addref(list);
+    node_bindings.dom_node_addref(@ptrCast(item));
+    document_bindings.dom_document_addref(doc);
+
+    const batch = [_]*dom_types.DOMNode{ @ptrCast(item), @ptrCast(doc), @ptrCast(list) };
+    node_bindings.dom_node_release_many(&batch, batch.len);
+
+    // The document and the tree are still held by their first references
+    try testing.expectEqual(@as(*dom_types.DOMDocument, doc), node_bindings.dom_node_get_ownerdocument(@ptrCast(item)).?);
+    try testing.expectEqual(@as(*dom_types.DOMNode, @ptrCast(item)), node_bindings.dom_node_get_firstchild(@ptrCast(list)).?);
+    node_bindings.dom_node_release_many(&batch, 0);
+}
+
+test "Node: addref_many keeps removed nodes alive" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    const list = document_bindings.dom_document_createelement(doc, "list");
+    defer element_bindings.dom_element_release(list);
+    const item = document_bindings.dom_document_createelement(doc, "item");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(list), @ptrCast(item));
+
+    // A copied list holds the only reference once the item is removed
+    const batch = [_]*dom_types.DOMNode{@ptrCast(item)};
+    node_bindings.dom_node_addref_many(&batch, batch.len);
+    element_bindings.dom_element_release(item);
+    const before = document_bindings.dom_document_get_live_node_count(doc);
+    _ = node_bindings.dom_node_removechild(@ptrCast(list), @ptrCast(item));
+    try testing.expectEqual(before, document_bindings.dom_document_get_live_node_count(doc));
+
+    node_bindings.dom_node_release_many(&batch, batch.len);
+    try testing.expectEqual(before - 1, document_bindings.dom_document_get_live_node_count(doc));
+}
+
+test "Node: self bytes grow with character data, not children" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    const short = document_bindings.dom_document_createtextnode(doc, "leaf");
+    defer node_bindings.dom_node_release(@ptrCast(short));
+    const long = document_bindings.dom_document_createtextnode(doc, "leaf leaf leaf leaf leaf leaf leaf leaf");
+    defer node_bindings.dom_node_release(@ptrCast(long));
+    try testing.expect(node_bindings.dom_node_get_self_bytes(@ptrCast(long)) > node_bindings.dom_node_get_self_bytes(@ptrCast(short)));
+
+    const list = document_bindings.dom_document_createelement(doc, "list");
+    defer element_bindings.dom_element_release(list);
+    const empty = node_bindings.dom_node_get_self_bytes(@ptrCast(list));
+    _ = node_bindings.dom_node_appendchild(@ptrCast(list), @ptrCast(document_bindings.dom_document_createelement(doc, "item")));
+    try testing.expectEqual(empty, node_bindings.dom_node_get_self_bytes(@ptrCast(list)));
+}
+
+test "Template: instances and holes through the C-ABI" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    const row = document_bindings.dom_document_createelement(doc, "row");
+    defer element_bindings.dom_element_release(row);
+    const cell = document_bindings.dom_document_createelement(doc, "cell");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(row), @ptrCast(cell));
+    _ = element_bindings.dom_element_setattribute(cell, "class", "value");
+
+    const holes = [_]*dom_types.DOMNode{@ptrCast(cell)};
+    const template = template_bindings.dom_template_compile(@ptrCast(row), &holes, holes.len) orelse return error.OutOfMemory;
+    defer template_bindings.dom_template_release(template);
+    try testing.expectEqual(@as(u32, 1), template_bindings.dom_template_get_holecount(template));
+
+    var out: [1]*dom_types.DOMNode = undefined;
+    const instance = template_bindings.dom_template_instantiate(template, doc, &out) orelse return error.OutOfMemory;
+    defer node_bindings.dom_node_release(instance);
+    try testing.expectEqual(node_bindings.dom_node_get_firstchild(instance).?, out[0]);
+    try testing.expect(out[0] != @as(*dom_types.DOMNode, @ptrCast(cell)));
+    try testing.expectEqualStrings("value", std.mem.span(element_bindings.dom_element_getattribute(@ptrCast(out[0]), "class").?));
+
+    // A hole outside the subtree
+    const other = document_bindings.dom_document_createelement(doc, "other");
+    defer element_bindings.dom_element_release(other);
+    const outside = [_]*dom_types.DOMNode{@ptrCast(other)};
+    try testing.expect(template_bindings.dom_template_compile(@ptrCast(row), &outside, outside.len) == null);
+}
+
+const SegmentSink = struct {
+    buffer: [64]u8 = undefined,
+    len: usize = 0,
+    calls: u32 = 0,
+
+    fn append(data: [*]const u8, length: u32, user_data: ?*anyopaque) callconv(.c) void {
+        const sink: *SegmentSink = @ptrCast(@alignCast(user_data.?));
+        @memcpy(sink.buffer[sink.len..][0..length], data[0..length]);
+        sink.len += length;
+        sink.calls += 1;
+    }
+};
+
+test "Node: serialize streams markup and fills a caller buffer" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    const root = document_bindings.dom_document_createelement(doc, "root");
+    defer element_bindings.dom_element_release(root);
+    _ = element_bindings.dom_element_setattribute(root, "class", "a&b");
+    const text = document_bindings.dom_document_createtextnode(doc, "x<y");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(root), @ptrCast(text));
+
+    const expected = "<root class=\"a&amp;b\">x&lt;y</root>";
+
+    var sink = SegmentSink{};
+    node_bindings.dom_node_serialize(@ptrCast(root), 0, SegmentSink.append, &sink);
+    try testing.expectEqualStrings(expected, sink.buffer[0..sink.len]);
+
+    // Too small: a prefix, and the full length to retry with
+    var small: [8]u8 = undefined;
+    try testing.expectEqual(expected.len, node_bindings.dom_node_serialize_into(@ptrCast(root), 0, &small, small.len));
+    try testing.expectEqualStrings(expected[0..8], &small);
+
+    var full: [64]u8 = undefined;
+    const length = node_bindings.dom_node_serialize_into(@ptrCast(root), 0, &full, full.len);
+    try testing.expectEqualStrings(expected, full[0..length]);
+    try testing.expectEqual(@as(usize, "x&lt;y".len), node_bindings.dom_node_serialize_into(@ptrCast(root), 1, null, 0));
+}
+
+test "Node: textContent as a view or a two-pass copy" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    const root = document_bindings.dom_document_createelement(doc, "root");
+    defer element_bindings.dom_element_release(root);
+    const item = document_bindings.dom_document_createelement(doc, "item");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(root), @ptrCast(item));
+    const first = document_bindings.dom_document_createtextnode(doc, "alpha");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(item), @ptrCast(first));
+
+    // One Text descendant: its storage is returned in place
+    var view: dom_types.DOMStringView = undefined;
+    try testing.expect(node_bindings.dom_node_get_textcontent_view(@ptrCast(root), &view));
+    try testing.expectEqualStrings("alpha", view.data[0..view.length]);
+    const stored = node_bindings.dom_node_get_nodevalue(@ptrCast(first)).?;
+    try testing.expectEqual(@intFromPtr(stored), @intFromPtr(view.data));
+
+    const second = document_bindings.dom_document_createtextnode(doc, " beta");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(root), @ptrCast(second));
+    try testing.expect(!node_bindings.dom_node_get_textcontent_view(@ptrCast(root), &view));
+
+    var length: usize = 0;
+    try testing.expect(node_bindings.dom_node_get_textcontent_length(@ptrCast(root), &length));
+    try testing.expectEqual(@as(usize, 10), length);
+
+    var buffer: [10]u8 = undefined;
+    try testing.expectEqual(length, node_bindings.dom_node_copy_textcontent(@ptrCast(root), &buffer, buffer.len));
+    try testing.expectEqualStrings("alpha beta", &buffer);
+    try testing.expectEqual(length, node_bindings.dom_node_copy_textcontent(@ptrCast(root), &buffer, 3));
+    try testing.expectEqualStrings("alp", buffer[0..3]);
+
+    // Null for documents
+    try testing.expect(!node_bindings.dom_node_get_textcontent_view(@ptrCast(doc), &view));
+    try testing.expect(!node_bindings.dom_node_get_textcontent_length(@ptrCast(doc), &length));
+    try testing.expectEqual(@as(usize, 0), node_bindings.dom_node_copy_textcontent(@ptrCast(doc), &buffer, buffer.len));
+}
+
+test "Element: string views carry the pool's encoding" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    const elem = document_bindings.dom_document_createelement(doc, "item");
+    defer element_bindings.dom_element_release(elem);
+    _ = element_bindings.dom_element_setattribute(elem, "title", "caf\u{00E9}");
+    _ = element_bindings.dom_element_setattribute(elem, "label", "\u{1F600}");
+
+    var view: dom_types.DOMStringView = undefined;
+    element_bindings.dom_element_get_tagname_view(elem, &view);
+    try testing.expect(view.is_latin1 and view.fits_latin1);
+
+    // Latin-1 beyond ASCII is one-byte after transcoding
+    try testing.expect(element_bindings.dom_element_getattribute_view(elem, "title", &view));
+    try testing.expect(!view.is_latin1 and view.fits_latin1);
+    try testing.expect(element_bindings.dom_element_getattribute_view(elem, "label", &view));
+    try testing.expect(!view.is_latin1 and !view.fits_latin1);
+}
+
+test "CharacterData: UTF-16 offsets and substring views" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    const root = document_bindings.dom_document_createelement(doc, "root");
+    defer element_bindings.dom_element_release(root);
+    // "é" is one code unit, "𝄞" a surrogate pair
+    const text = document_bindings.dom_document_createtextnode(doc, "héllo 𝄞");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(root), @ptrCast(text));
+    const cdata: *dom_types.DOMText = text;
+
+    try testing.expectEqual(@as(u32, 8), characterdata_bindings.dom_characterdata_get_length(cdata));
+
+    // substringData reads the node's storage in place
+    var view: dom_types.DOMStringView = undefined;
+    try testing.expectEqual(@as(c_int, 0), characterdata_bindings.dom_characterdata_substringdata(cdata, 1, 4, &view));
+    try testing.expectEqualStrings("éllo", view.data[0..view.length]);
+    try testing.expectEqual(@as(c_int, 0), characterdata_bindings.dom_characterdata_substringdata(cdata, 6, 100, &view));
+    try testing.expectEqualStrings("𝄞", view.data[0..view.length]);
+    try testing.expectEqual(@as(c_int, 1), characterdata_bindings.dom_characterdata_substringdata(cdata, 9, 0, &view));
+
+    // Edits take code unit offsets
+    try testing.expectEqual(@as(c_int, 0), characterdata_bindings.dom_characterdata_insertdata_n(cdata, 2, "x", 1));
+    try testing.expectEqual(@as(c_int, 0), characterdata_bindings.dom_characterdata_replacedata(cdata, 7, 2, "♪"));
+    try testing.expectEqual(@as(c_int, 0), characterdata_bindings.dom_characterdata_deletedata(cdata, 0, 1));
+    try testing.expectEqual(@as(c_int, 0), characterdata_bindings.dom_characterdata_appenddata(cdata, "!"));
+    try testing.expect(node_bindings.dom_node_get_textcontent_view(@ptrCast(text), &view));
+    try testing.expectEqualStrings("éxllo ♪!", view.data[0..view.length]);
+    try testing.expectEqual(@as(u32, 8), characterdata_bindings.dom_characterdata_get_length(cdata));
+    try testing.expectEqual(@as(c_int, 1), characterdata_bindings.dom_characterdata_insertdata(cdata, 9, "?"));
+
+    // Comments too
+    const comment = document_bindings.dom_document_createcomment(doc, "ü");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(root), @ptrCast(comment));
+    const comment_data: *dom_types.DOMText = @ptrCast(comment);
+    try testing.expectEqual(@as(c_int, 0), characterdata_bindings.dom_characterdata_insertdata(comment_data, 1, "ber"));
+    try testing.expectEqual(@as(u32, 4), characterdata_bindings.dom_characterdata_get_length(comment_data));
+    try testing.expectEqual(@as(c_int, 0), characterdata_bindings.dom_characterdata_set_data_n(comment_data, "ab", 2));
+    try testing.expectEqual(@as(u32, 2), characterdata_bindings.dom_characterdata_get_length(comment_data));
+}
+
+test "Text: wholeText into a caller buffer and splitText" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    const root = document_bindings.dom_document_createelement(doc, "root");
+    defer element_bindings.dom_element_release(root);
+    const text = document_bindings.dom_document_createtextnode(doc, "first second");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(root), @ptrCast(text));
+
+    const second = text_bindings.dom_text_splittext(text, 6).?;
+    try testing.expectEqual(@as(?*DOMNode, @ptrCast(second)), node_bindings.dom_node_get_nextsibling(@ptrCast(text)));
+
+    // A short buffer only measures; a large enough one is written
+    var small: [4]u8 = undefined;
+    try testing.expectEqual(@as(usize, 12), text_bindings.dom_text_get_wholetext_into(second, &small, small.len));
+    try testing.expectEqual(@as(usize, 12), text_bindings.dom_text_get_wholetext_into(second, null, 0));
+    var buffer: [32]u8 = undefined;
+    const length = text_bindings.dom_text_get_wholetext_into(text, &buffer, buffer.len);
+    try testing.expectEqualStrings("first second", buffer[0..length]);
+}
+
+test "Range: setBaseAndExtent and streamed text segments" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    const root = document_bindings.dom_document_createelement(doc, "root");
+    defer element_bindings.dom_element_release(root);
+    const first = document_bindings.dom_document_createtextnode(doc, "alpha");
+    const second = document_bindings.dom_document_createtextnode(doc, "beta");
+    const third = document_bindings.dom_document_createtextnode(doc, "gamma");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(root), @ptrCast(first));
+    _ = node_bindings.dom_node_appendchild(@ptrCast(root), @ptrCast(second));
+    _ = node_bindings.dom_node_appendchild(@ptrCast(root), @ptrCast(third));
+
+    const range = document_bindings.dom_document_createrange(doc);
+    defer range_bindings.dom_range_release(range);
+
+    try testing.expectEqual(@as(c_int, 0), range_bindings.dom_range_setbaseandextent(range, @ptrCast(first), 2, @ptrCast(third), 3));
+
+    var sink = SegmentSink{};
+    range_bindings.dom_range_foreach_text(range, SegmentSink.append, &sink);
+    try testing.expectEqual(@as(u32, 3), sink.calls);
+    try testing.expectEqualStrings("phabetagam", sink.buffer[0..sink.len]);
+
+    // An invalid end offset leaves the range unchanged
+    const index_size: c_int = @intFromEnum(dom_types.DOMErrorCode.IndexSizeError);
+    try testing.expectEqual(index_size, range_bindings.dom_range_setbaseandextent(range, @ptrCast(first), 0, @ptrCast(third), 9));
+    try testing.expectEqual(@as(u32, 2), range_bindings.dom_range_get_startoffset(range));
+
+    // An end before the start collapses to the end
+    try testing.expectEqual(@as(c_int, 0), range_bindings.dom_range_setbaseandextent(range, @ptrCast(third), 1, @ptrCast(first), 4));
+    try testing.expectEqual(@as(u8, 1), range_bindings.dom_range_get_collapsed(range));
+    try testing.expectEqual(@as(*DOMNode, @ptrCast(first)), range_bindings.dom_range_get_startcontainer(range));
+}
+
+test "Range: UTF-16 boundary offsets in character data" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    const root = document_bindings.dom_document_createelement(doc, "root");
+    defer element_bindings.dom_element_release(root);
+    // "é" is one code unit in two bytes, "𝄞" two code units in four bytes
+    const text = document_bindings.dom_document_createtextnode(doc, "héllo 𝄞!");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(root), @ptrCast(text));
+
+    const range = document_bindings.dom_document_createrange(doc);
+    defer range_bindings.dom_range_release(range);
+
+    try testing.expectEqual(@as(c_int, 0), range_bindings.dom_range_setstart(range, @ptrCast(text), 1));
+    try testing.expectEqual(@as(c_int, 0), range_bindings.dom_range_setend(range, @ptrCast(text), 8));
+    try testing.expectEqual(@as(u32, 1), range_bindings.dom_range_get_startoffset(range));
+    try testing.expectEqual(@as(u32, 8), range_bindings.dom_range_get_endoffset(range));
+
+    var sink = SegmentSink{};
+    range_bindings.dom_range_foreach_text(range, SegmentSink.append, &sink);
+    try testing.expectEqualStrings("éllo 𝄞", sink.buffer[0..sink.len]);
+
+    // The length is 9 code units, not 12 bytes
+    const index_size: c_int = @intFromEnum(dom_types.DOMErrorCode.IndexSizeError);
+    try testing.expectEqual(index_size, range_bindings.dom_range_setend(range, @ptrCast(text), 10));
+    try testing.expectEqual(@as(i16, 0), range_bindings.dom_range_comparepoint(range, @ptrCast(text), 7));
+    try testing.expectEqual(@as(i16, 1), range_bindings.dom_range_comparepoint(range, @ptrCast(text), 9));
+
+    // Boundaries follow edits in code units
+    try testing.expectEqual(@as(c_int, 0), characterdata_bindings.dom_characterdata_insertdata(text, 0, "ü"));
+    try testing.expectEqual(@as(u32, 2), range_bindings.dom_range_get_startoffset(range));
+    try testing.expectEqual(@as(u32, 9), range_bindings.dom_range_get_endoffset(range));
+    try testing.expectEqual(@as(u8, 0), range_bindings.dom_range_ispointinrange(range, @ptrCast(text), 1));
+}
+
+test "StaticRange: batch construction from the document pool" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    const root = document_bindings.dom_document_createelement(doc, "root");
+    defer element_bindings.dom_element_release(root);
+    const text = document_bindings.dom_document_createtextnode(doc, "héllo wörld");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(root), @ptrCast(text));
+
+    const text_node: *DOMNode = @ptrCast(text);
+    const root_node: *DOMNode = @ptrCast(root);
+    const containers = [_]*DOMNode{ text_node, text_node, text_node, root_node };
+    const offsets = [_]u32{ 1, 5, 7, 1 };
+    var ranges: [2]*staticrange.DOMStaticRange = undefined;
+    try testing.expectEqual(@as(c_int, 0), staticrange.dom_staticrange_new_many(doc, &containers, &offsets, 2, &ranges));
+
+    // Offsets stay in UTF-16 code units across the call
+    try testing.expectEqual(@as(u32, 1), staticrange.dom_staticrange_get_startoffset(ranges[0]));
+    try testing.expectEqual(@as(u32, 5), staticrange.dom_staticrange_get_endoffset(ranges[0]));
+    try testing.expectEqual(@as(u32, 7), staticrange.dom_staticrange_get_startoffset(ranges[1]));
+    try testing.expect(staticrange.dom_staticrange_get_endcontainer(ranges[1]) == root_node);
+
+    staticrange.dom_staticrange_release(ranges[0]);
+    staticrange.dom_staticrange_release(ranges[1]);
+
+    // An Attr container fails the whole batch
+    const attr = document_bindings.dom_document_createattribute(doc, "name");
+    defer attr_bindings.dom_attr_release(attr);
+    const bad = [_]*DOMNode{ text_node, @ptrCast(attr) };
+    const invalid_node_type: c_int = @intFromEnum(dom_types.DOMErrorCode.InvalidNodeTypeError);
+    try testing.expectEqual(invalid_node_type, staticrange.dom_staticrange_new_many(doc, &bad, &offsets, 1, &ranges));
+}
+
+/// Callback filter that rejects one node and counts its calls.
+const RejectOne = struct {
+    rejected: *DOMNode,
+    calls: u32 = 0,
+
+    fn accept(node: *DOMNode, user_data: ?*anyopaque) callconv(.c) u16 {
+        const self: *RejectOne = @ptrCast(@alignCast(user_data.?));
+        self.calls += 1;
+        return if (node == self.rejected) 2 else 1;
+    }
+};
+
+test "NodeFilter: callback and native element filters" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    const root = document_bindings.dom_document_createelement(doc, "root");
+    defer element_bindings.dom_element_release(root);
+    const list = document_bindings.dom_document_createelement(doc, "list");
+    const item = document_bindings.dom_document_createelement(doc, "item");
+    const row = document_bindings.dom_document_createelement(doc, "row");
+    const text = document_bindings.dom_document_createtextnode(doc, "leaf");
+    _ = element_bindings.dom_element_setattribute(row, "class", "visible");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(root), @ptrCast(list));
+    _ = node_bindings.dom_node_appendchild(@ptrCast(list), @ptrCast(item));
+    _ = node_bindings.dom_node_appendchild(@ptrCast(root), @ptrCast(row));
+    _ = node_bindings.dom_node_appendchild(@ptrCast(row), @ptrCast(text));
+
+    // Callback filter: only nodes whatToShow lets through reach it; a
+    // rejected node prunes its subtree
+    var reject_list = RejectOne{ .rejected = @ptrCast(list) };
+    const callback = dom_types.DOMNodeFilter{ .accept_node = RejectOne.accept, .user_data = &reject_list };
+    const walker = document_bindings.dom_document_createtreewalker(doc, @ptrCast(root), 0x1, &callback);
+    defer treewalker_bindings.dom_treewalker_release(walker);
+    try testing.expectEqual(@as(?*DOMNode, @ptrCast(row)), treewalker_bindings.dom_treewalker_nextnode(walker));
+    try testing.expectEqual(@as(?*DOMNode, null), treewalker_bindings.dom_treewalker_nextnode(walker));
+    try testing.expectEqual(@as(u32, 2), reject_list.calls);
+
+    // Native filter: class predicate, misses skipped
+    const filter = nodefilter_bindings.dom_elementfilter_new(3).?;
+    defer nodefilter_bindings.dom_elementfilter_release(filter);
+    try testing.expectEqual(@as(c_int, 0), nodefilter_bindings.dom_elementfilter_set_classname(filter, "visible", 7));
+
+    const iterator = document_bindings.dom_document_createnodeiterator_native(doc, @ptrCast(root), 0xFFFFFFFF, filter);
+    defer nodeiterator_bindings.dom_nodeiterator_release(iterator);
+    try testing.expectEqual(@as(?*DOMNode, @ptrCast(row)), nodeiterator_bindings.dom_nodeiterator_nextnode(iterator));
+    try testing.expectEqual(@as(?*DOMNode, null), nodeiterator_bindings.dom_nodeiterator_nextnode(iterator));
+}
+
+test "TreeWalker: nextnodes returns nodes in batches" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    const root = document_bindings.dom_document_createelement(doc, "root");
+    defer element_bindings.dom_element_release(root);
+    var items: [5]*DOMElement = undefined;
+    for (&items) |*item| {
+        item.* = document_bindings.dom_document_createelement(doc, "item");
+        _ = node_bindings.dom_node_appendchild(@ptrCast(root), @ptrCast(item.*));
+    }
+
+    const walker = document_bindings.dom_document_createtreewalker(doc, @ptrCast(root), 0xFFFFFFFF, null);
+    defer treewalker_bindings.dom_treewalker_release(walker);
+
+    var out: [3]*DOMNode = undefined;
+    try testing.expectEqual(@as(u32, 3), treewalker_bindings.dom_treewalker_nextnodes(walker, &out, 3));
+    try testing.expectEqual(@as(*DOMNode, @ptrCast(items[2])), out[2]);
+    try testing.expectEqual(@as(*DOMNode, @ptrCast(items[2])), treewalker_bindings.dom_treewalker_get_currentnode(walker));
+
+    // A short count marks the end of the walk
+    try testing.expectEqual(@as(u32, 2), treewalker_bindings.dom_treewalker_nextnodes(walker, &out, 3));
+    try testing.expectEqual(@as(*DOMNode, @ptrCast(items[4])), out[1]);
+    try testing.expectEqual(@as(u32, 0), treewalker_bindings.dom_treewalker_nextnodes(walker, &out, 3));
+
+    const iterator = document_bindings.dom_document_createnodeiterator(doc, @ptrCast(root), 0x1, null);
+    defer nodeiterator_bindings.dom_nodeiterator_release(iterator);
+    var all: [8]*DOMNode = undefined;
+    try testing.expectEqual(@as(u32, 6), nodeiterator_bindings.dom_nodeiterator_nextnodes(iterator, &all, 8));
+    try testing.expectEqual(@as(*DOMNode, @ptrCast(root)), all[0]);
+}
+
+test "ElementIterator: batches skip non-element nodes" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    const root = document_bindings.dom_document_createelement(doc, "root");
+    defer element_bindings.dom_element_release(root);
+    const list = document_bindings.dom_document_createelement(doc, "list");
+    const item = document_bindings.dom_document_createelement(doc, "item");
+    const text = document_bindings.dom_document_createtextnode(doc, "content");
+    const row = document_bindings.dom_document_createelement(doc, "row");
+    const leaf = document_bindings.dom_document_createelement(doc, "leaf");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(root), @ptrCast(list));
+    _ = node_bindings.dom_node_appendchild(@ptrCast(list), @ptrCast(item));
+    _ = node_bindings.dom_node_appendchild(@ptrCast(list), @ptrCast(text));
+    _ = node_bindings.dom_node_appendchild(@ptrCast(list), @ptrCast(row));
+    _ = node_bindings.dom_node_appendchild(@ptrCast(root), @ptrCast(leaf));
+
+    // Descendants only, in tree order, text skipped
+    const all = elementiterator_bindings.dom_elementiterator_new(@ptrCast(root)).?;
+    defer elementiterator_bindings.dom_elementiterator_release(all);
+    var out: [8]*DOMElement = undefined;
+    try testing.expectEqual(@as(u32, 4), elementiterator_bindings.dom_elementiterator_nextbatch(all, &out, 8));
+    try testing.expectEqual(list, out[0]);
+    try testing.expectEqual(item, out[1]);
+    try testing.expectEqual(row, out[2]);
+    try testing.expectEqual(leaf, out[3]);
+    try testing.expectEqual(@as(u32, 0), elementiterator_bindings.dom_elementiterator_nextbatch(all, &out, 8));
+
+    // Resuming from a node removed from under the root ends iteration
+    const partial = elementiterator_bindings.dom_elementiterator_new(@ptrCast(root)).?;
+    defer elementiterator_bindings.dom_elementiterator_release(partial);
+    try testing.expectEqual(@as(u32, 2), elementiterator_bindings.dom_elementiterator_nextbatch(partial, &out, 2));
+    try testing.expectEqual(item, out[1]);
+
+    const removed = node_bindings.dom_node_removechild(@ptrCast(root), @ptrCast(list));
+    node_bindings.dom_node_release(removed);
+    try testing.expectEqual(@as(u32, 0), elementiterator_bindings.dom_elementiterator_nextbatch(partial, &out, 2));
+
+    // Seeking after the root restarts
+    elementiterator_bindings.dom_elementiterator_seek(partial, @ptrCast(root));
+    try testing.expectEqual(@as(u32, 1), elementiterator_bindings.dom_elementiterator_nextbatch(partial, &out, 2));
+    try testing.expectEqual(leaf, out[0]);
+}
+
+test "Query: steps return the matches in order until done or mutated" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    const root = document_bindings.dom_document_createelement(doc, "root");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(doc), @ptrCast(root));
+    const first = document_bindings.dom_document_createelement(doc, "row");
+    const item = document_bindings.dom_document_createelement(doc, "item");
+    const second = document_bindings.dom_document_createelement(doc, "row");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(root), @ptrCast(first));
+    _ = node_bindings.dom_node_appendchild(@ptrCast(root), @ptrCast(item));
+    _ = node_bindings.dom_node_appendchild(@ptrCast(root), @ptrCast(second));
+
+    try testing.expect(query_bindings.dom_query_begin(doc, "", 0) == null);
+
+    // A full buffer ends the step
+    const query = query_bindings.dom_query_begin(doc, "row", 3).?;
+    defer query_bindings.dom_query_release(query);
+    var out: [8]*DOMElement = undefined;
+    try testing.expectEqual(@as(u32, 1), query_bindings.dom_query_step(query, 0, &out, 1));
+    try testing.expectEqual(first, out[0]);
+    try testing.expectEqual(@as(u8, 0), query_bindings.dom_query_get_state(query));
+    try testing.expectEqual(@as(u32, 1), query_bindings.dom_query_step(query, 0, &out, 8));
+    try testing.expectEqual(second, out[0]);
+    try testing.expectEqual(@as(u8, 1), query_bindings.dom_query_get_state(query));
+
+    // A mutation invalidates a running query
+    const stale = query_bindings.dom_query_begin(doc, "row", 3).?;
+    defer query_bindings.dom_query_release(stale);
+    _ = element_bindings.dom_element_setattribute(item, "class", "row");
+    try testing.expectEqual(@as(u32, 0), query_bindings.dom_query_step(stale, 0, &out, 8));
+    try testing.expectEqual(@as(u8, 2), query_bindings.dom_query_get_state(stale));
+}
+
+test "ClosestMemo: answers from nearby targets and drops them on mutation" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    const root = document_bindings.dom_document_createelement(doc, "root");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(doc), @ptrCast(root));
+    const list = document_bindings.dom_document_createelement(doc, "list");
+    const row = document_bindings.dom_document_createelement(doc, "row");
+    const first = document_bindings.dom_document_createelement(doc, "leaf");
+    const second = document_bindings.dom_document_createelement(doc, "leaf");
+    _ = element_bindings.dom_element_setattribute(list, "class", "target");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(root), @ptrCast(list));
+    _ = node_bindings.dom_node_appendchild(@ptrCast(list), @ptrCast(row));
+    _ = node_bindings.dom_node_appendchild(@ptrCast(row), @ptrCast(first));
+    _ = node_bindings.dom_node_appendchild(@ptrCast(row), @ptrCast(second));
+
+    const memo = closestmemo_bindings.dom_closestmemo_new().?;
+    defer closestmemo_bindings.dom_closestmemo_release(memo);
+    const selector = document_bindings.dom_selector_compile(doc, ".target", 7).?;
+    defer document_bindings.dom_selector_release(selector);
+
+    // first, row and list answered by one walk
+    try testing.expectEqual(list, closestmemo_bindings.dom_element_closest_memoized(first, memo, selector).?);
+    try testing.expectEqual(@as(u32, 3), closestmemo_bindings.dom_closestmemo_count(memo));
+
+    // A sibling target stops at the answered row
+    try testing.expectEqual(list, closestmemo_bindings.dom_element_closest_memoized(second, memo, selector).?);
+    try testing.expectEqual(@as(u32, 4), closestmemo_bindings.dom_closestmemo_count(memo));
+
+    // An attribute change invalidates every answer
+    _ = element_bindings.dom_element_setattribute(row, "class", "target");
+    try testing.expectEqual(row, closestmemo_bindings.dom_element_closest_memoized(second, memo, selector).?);
+    try testing.expectEqual(@as(u32, 2), closestmemo_bindings.dom_closestmemo_count(memo));
+
+    closestmemo_bindings.dom_closestmemo_clear(memo);
+    try testing.expectEqual(@as(u32, 0), closestmemo_bindings.dom_closestmemo_count(memo));
+}
+
+test "Document: compiled selectors outlive their document" {
+    const doc = document_bindings.dom_document_new();
+    const selector = document_bindings.dom_selector_compile(doc, ".selected", 9).?;
+    document_bindings.dom_document_release(doc);
+    defer document_bindings.dom_selector_release(selector);
+
+    const other = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(other);
+    const item = document_bindings.dom_document_createelement(other, "item");
+    defer element_bindings.dom_element_release(item);
+    try testing.expectEqual(@as(u8, 0), element_bindings.dom_element_matches_compiled(item, selector));
+    _ = element_bindings.dom_element_setattribute(item, "class", "selected");
+    try testing.expectEqual(@as(u8, 1), element_bindings.dom_element_matches_compiled(item, selector));
+}
+
+test "Document: match cache answers repeated matches and reports hits" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    var stats: dom_types.DOMMatchCacheStats = undefined;
+    document_bindings.dom_document_get_match_cache_stats(doc, &stats);
+    try testing.expectEqual(@as(u32, 0), stats.enabled);
+    try testing.expectEqual(@as(c_int, 0), document_bindings.dom_document_enable_match_cache(doc));
+
+    const root = document_bindings.dom_document_createelement(doc, "root");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(doc), @ptrCast(root));
+    const item = document_bindings.dom_document_createelement(doc, "item");
+    const other = document_bindings.dom_document_createelement(doc, "item");
+    _ = element_bindings.dom_element_setattribute(item, "class", "selected");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(root), @ptrCast(item));
+    _ = node_bindings.dom_node_appendchild(@ptrCast(root), @ptrCast(other));
+
+    const selector = document_bindings.dom_selector_compile(doc, ".selected", 9).?;
+    defer document_bindings.dom_selector_release(selector);
+    try testing.expectEqual(@as(u8, 1), element_bindings.dom_element_matches_compiled(item, selector));
+    try testing.expectEqual(@as(u8, 1), element_bindings.dom_element_matches(item, ".selected"));
+
+    // A change elsewhere keeps the answer; one to the element drops it
+    _ = element_bindings.dom_element_setattribute(other, "class", "selected");
+    try testing.expectEqual(@as(u8, 1), element_bindings.dom_element_matches_compiled(item, selector));
+    _ = element_bindings.dom_element_setattribute(item, "class", "plain");
+    try testing.expectEqual(@as(u8, 0), element_bindings.dom_element_matches_compiled(item, selector));
+
+    document_bindings.dom_document_get_match_cache_stats(doc, &stats);
+    try testing.expectEqual(@as(u32, 1), stats.enabled);
+    try testing.expectEqual(@as(u64, 2), stats.hits);
+    try testing.expectEqual(@as(u64, 2), stats.misses);
+    try testing.expectEqual(@as(u32, 1), stats.elements);
+}
+
+test "NodeTable: ids walk the tree without wrappers" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    const root = document_bindings.dom_document_createelement(doc, "root");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(doc), @ptrCast(root));
+    const first = document_bindings.dom_document_createelement(doc, "row");
+    const gap = document_bindings.dom_document_createtextnode(doc, "gap");
+    const last = document_bindings.dom_document_createelement(doc, "row");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(root), @ptrCast(first));
+    _ = node_bindings.dom_node_appendchild(@ptrCast(root), @ptrCast(gap));
+    _ = node_bindings.dom_node_appendchild(@ptrCast(root), @ptrCast(last));
+
+    const row = nodetable_bindings.dom_nodetable_atom(doc, "row", 3);
+    try testing.expect(row != 0);
+    const root_id = nodetable_bindings.dom_nodetable_id(@ptrCast(root));
+    try testing.expect(root_id != 0);
+
+    var rows: u32 = 0;
+    var id = nodetable_bindings.dom_nodetable_related(doc, root_id, 1); // DOM_NODE_RELATION_FIRST_CHILD
+    while (id != 0) : (id = nodetable_bindings.dom_nodetable_related(doc, id, 4)) { // DOM_NODE_RELATION_NEXT_SIBLING
+        if (nodetable_bindings.dom_nodetable_tag_atom(doc, id) == row) rows += 1;
+    }
+    try testing.expectEqual(@as(u32, 2), rows);
+    try testing.expectEqual(@as(u32, 4), nodetable_bindings.dom_nodetable_count(doc));
+    try testing.expectEqual(@as(u32, 0), nodetable_bindings.dom_nodetable_related(doc, root_id, 99));
+
+    const gap_id = nodetable_bindings.dom_nodetable_id(@ptrCast(gap));
+    try testing.expectEqual(@as(u16, 3), nodetable_bindings.dom_nodetable_nodetype(doc, gap_id));
+    try testing.expectEqual(@as(u32, 0), nodetable_bindings.dom_nodetable_tag_atom(doc, gap_id));
+    try testing.expectEqual(@as(?*DOMNode, @ptrCast(last)), nodetable_bindings.dom_nodetable_node(doc, nodetable_bindings.dom_nodetable_related(doc, root_id, 2)));
+
+    var name: dom_types.DOMStringView = undefined;
+    try testing.expect(nodetable_bindings.dom_nodetable_atom_name(doc, row, &name));
+    try testing.expectEqualStrings("row", name.data[0..name.length]);
+    try testing.expect(!nodetable_bindings.dom_nodetable_atom_name(doc, 0, &name));
+
+    // Destroyed nodes and cleared tables name nothing
+    const removed = node_bindings.dom_node_removechild(@ptrCast(root), @ptrCast(gap));
+    node_bindings.dom_node_release(removed);
+    try testing.expect(nodetable_bindings.dom_nodetable_node(doc, gap_id) == null);
+    nodetable_bindings.dom_nodetable_clear(doc);
+    try testing.expect(nodetable_bindings.dom_nodetable_node(doc, root_id) == null);
+    try testing.expect(nodetable_bindings.dom_nodetable_id(@ptrCast(root)) > root_id);
+}
+
+test "Document: frozen document answers queries in parallel" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    const root = document_bindings.dom_document_createelement(doc, "root");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(doc), @ptrCast(root));
+    var rows: [4]*DOMElement = undefined;
+    for (&rows) |*row| {
+        row.* = document_bindings.dom_document_createelement(doc, "row");
+        _ = node_bindings.dom_node_appendchild(@ptrCast(root), @ptrCast(row.*));
+    }
+    try testing.expectEqual(@as(c_int, 0), element_bindings.dom_element_setattribute(rows[1], "class", "odd"));
+
+    const selectors = [_][*:0]const u8{ "row", ".odd", "list" };
+    var results: [selectors.len]?*dom_types.DOMNodeList = undefined;
+
+    // Not frozen yet
+    try testing.expectEqual(
+        @as(c_int, @intFromEnum(dom_types.DOMErrorCode.InvalidStateError)),
+        document_bindings.dom_document_queryselectorall_many(doc, &selectors, selectors.len, &results),
+    );
+
+    try testing.expectEqual(@as(c_int, 0), document_bindings.dom_document_freeze(doc));
+    try testing.expectEqual(
+        @as(c_int, @intFromEnum(dom_types.DOMErrorCode.NoModificationAllowedError)),
+        element_bindings.dom_element_setattribute(rows[0], "class", "odd"),
+    );
+
+    try testing.expectEqual(@as(c_int, 0), document_bindings.dom_document_queryselectorall_many(doc, &selectors, selectors.len, &results));
+    const all = results[0] orelse return error.NoMatches;
+    defer document_bindings.dom_nodelist_static_release(all);
+    const odd = results[1] orelse return error.NoMatches;
+    defer document_bindings.dom_nodelist_static_release(odd);
+    try testing.expectEqual(@as(u32, 4), document_bindings.dom_nodelist_static_get_length(all));
+    try testing.expectEqual(@as(?*DOMNode, @ptrCast(rows[1])), document_bindings.dom_nodelist_static_item(odd, 0));
+    try testing.expect(results[2] == null);
+
+    // An invalid selector fails the whole call
+    const invalid = [_][*:0]const u8{ "row", "[" };
+    try testing.expect(document_bindings.dom_document_queryselectorall_many(doc, &invalid, invalid.len, &results) != 0);
+    try testing.expect(results[0] == null and results[1] == null);
+}
+
+test "Document: parallel queries of a large frozen document" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+    try testing.expectEqual(@as(c_int, 0), document_bindings.dom_document_enable_parallel_queries(doc, 1));
+
+    const root = document_bindings.dom_document_createelement(doc, "root");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(doc), @ptrCast(root));
+    var rows: [16]*DOMElement = undefined;
+    for (&rows, 0..) |*row, i| {
+        row.* = document_bindings.dom_document_createelement(doc, "row");
+        _ = node_bindings.dom_node_appendchild(@ptrCast(root), @ptrCast(row.*));
+        const cell = document_bindings.dom_document_createelement(doc, "cell");
+        _ = node_bindings.dom_node_appendchild(@ptrCast(row.*), @ptrCast(cell));
+        if (i % 2 == 1) _ = element_bindings.dom_element_setattribute(row.*, "class", "odd");
+    }
+    try testing.expectEqual(@as(c_int, 0), document_bindings.dom_document_freeze(doc));
+
+    const odd = document_bindings.dom_document_queryselectorall(doc, ".odd") orelse return error.NoMatches;
+    defer document_bindings.dom_nodelist_static_release(odd);
+    try testing.expectEqual(@as(u32, 8), document_bindings.dom_nodelist_static_get_length(odd));
+    for (0..8) |i| {
+        try testing.expectEqual(
+            @as(?*DOMNode, @ptrCast(rows[2 * i + 1])),
+            document_bindings.dom_nodelist_static_item(odd, @intCast(i)),
+        );
+    }
+}
+
+test "Document: shared document keeps claimed wrapper slots" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    const root = document_bindings.dom_document_createelement(doc, "root");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(doc), @ptrCast(root));
+    try testing.expectEqual(
+        @as(c_int, @intFromEnum(dom_types.DOMErrorCode.InvalidStateError)),
+        document_bindings.dom_document_share(doc),
+    );
+
+    try testing.expectEqual(@as(c_int, 0), document_bindings.dom_document_freeze(doc));
+    try testing.expectEqual(@as(c_int, 0), document_bindings.dom_document_share(doc));
+
+    node_bindings.dom_node_set_wrapper_slot(@ptrCast(root), 3);
+    try testing.expectEqual(@as(u32, 0xFFFF_FFFF), node_bindings.dom_node_get_wrapper_slot(@ptrCast(root)));
+
+    node_bindings.dom_node_addref(@ptrCast(root));
+    node_bindings.dom_node_release(@ptrCast(root));
+    try testing.expect(node_bindings.dom_node_get_parentnode(@ptrCast(root)) != null);
+}
+
+test "Document: fork copies the tree and keeps the source alive" {
+    const base = document_bindings.dom_document_new();
+    const root = document_bindings.dom_document_createelement(base, "root");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(base), @ptrCast(root));
+    const row = document_bindings.dom_document_createelement(base, "row");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(root), @ptrCast(row));
+    try testing.expectEqual(@as(c_int, 0), element_bindings.dom_element_setattribute(row, "id", "first"));
+
+    const variant = document_bindings.dom_document_fork(base) orelse return error.OutOfMemory;
+    defer document_bindings.dom_document_release(variant);
+    document_bindings.dom_document_release(base);
+
+    const copy = document_bindings.dom_document_getelementbyid(variant, "first") orelse return error.NotFound;
+    try testing.expect(copy != row);
+    try testing.expectEqual(@as(c_int, 0), element_bindings.dom_element_setattribute(copy, "class", "selected"));
+}
+
+test "Document: documents with shared names intern common names once" {
+    const names = [_][*:0]const u8{ "item", "class" };
+    const shared = document_bindings.dom_sharednames_new(&names, names.len) orelse return error.OutOfMemory;
+    const doc1 = document_bindings.dom_document_new_with_sharednames(shared) orelse return error.OutOfMemory;
+    defer document_bindings.dom_document_release(doc1);
+    const doc2 = document_bindings.dom_document_new_with_sharednames(shared) orelse return error.OutOfMemory;
+    defer document_bindings.dom_document_release(doc2);
+
+    // The documents keep the pool alive
+    document_bindings.dom_sharednames_release(shared);
+
+    const first = document_bindings.dom_document_createelement(doc1, "item");
+    defer node_bindings.dom_node_release(@ptrCast(first));
+    const second = document_bindings.dom_document_createelement(doc2, "item");
+    defer node_bindings.dom_node_release(@ptrCast(second));
+    try testing.expectEqual(element_bindings.dom_element_get_tagname(first), element_bindings.dom_element_get_tagname(second));
+
+    // Other names are still each document's own
+    const row1 = document_bindings.dom_document_createelement(doc1, "row");
+    defer node_bindings.dom_node_release(@ptrCast(row1));
+    const row2 = document_bindings.dom_document_createelement(doc2, "row");
+    defer node_bindings.dom_node_release(@ptrCast(row2));
+    try testing.expect(element_bindings.dom_element_get_tagname(row1) != element_bindings.dom_element_get_tagname(row2));
+}
+
+test "Document: save and load_mmap round trip an image" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+    const root = document_bindings.dom_document_createelement(doc, "root");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(doc), @ptrCast(root));
+    const row = document_bindings.dom_document_createelement(doc, "row");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(root), @ptrCast(row));
+    try testing.expectEqual(@as(c_int, 0), element_bindings.dom_element_setattribute(row, "id", "first"));
+
+    var tmp = testing.tmpDir(.{});
+    defer tmp.cleanup();
+    var dir_buffer: [std.fs.max_path_bytes]u8 = undefined;
+    const dir_path = try tmp.dir.realpath(".", &dir_buffer);
+    var path_buffer: [std.fs.max_path_bytes]u8 = undefined;
+    const path = try std.fmt.bufPrintZ(&path_buffer, "{s}/tree.domi", .{dir_path});
+
+    try testing.expectEqual(@as(c_int, 0), document_bindings.dom_document_save(doc, path));
+    const loaded = document_bindings.dom_document_load_mmap(path) orelse return error.NotFound;
+    defer document_bindings.dom_document_release(loaded);
+
+    const copy = document_bindings.dom_document_getelementbyid(loaded, "first") orelse return error.NotFound;
+    try testing.expect(copy != row);
+    try testing.expect(document_bindings.dom_document_load_mmap("missing.domi") == null);
+}
+
+test "Node: diff emits a patch between two subtrees" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    var roots: [2]*DOMElement = undefined;
+    for (&roots, [_][]const [*:0]const u8{ &.{ "a", "b" }, &.{ "b", "a", "c" } }) |*root, keys| {
+        root.* = document_bindings.dom_document_createelement(doc, "list");
+        for (keys) |key| {
+            const row = document_bindings.dom_document_createelement(doc, "row");
+            try testing.expectEqual(@as(c_int, 0), element_bindings.dom_element_setattribute(row, "key", key));
+            _ = node_bindings.dom_node_appendchild(@ptrCast(root.*), @ptrCast(row));
+        }
+    }
+    defer for (roots) |root| node_bindings.dom_node_release(@ptrCast(root));
+
+    var patch: dom_types.DOMSnapshotBuffer = undefined;
+    try testing.expectEqual(@as(c_int, 0), node_bindings.dom_node_diff(@ptrCast(roots[0]), @ptrCast(roots[1]), "key", &patch));
+    defer node_bindings.dom_patch_free(patch.data, patch.length);
+
+    // One row moves and one is inserted
+    const buffer: dom.tree_diff.PatchBuffer = @alignCast(patch.data.?[0..patch.length]);
+    const records = dom.tree_diff.recordsOf(buffer);
+    try testing.expectEqual(@as(usize, 2), records.len);
+    try testing.expectEqual(dom.tree_diff.PatchOp.insert, records[0].op);
+    try testing.expectEqual(dom.tree_diff.PatchOp.move, records[1].op);
+}
+
+test "Document: apply_patch replays a diff on node tables" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    const list = document_bindings.dom_document_createelement(doc, "list");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(doc), @ptrCast(list));
+    const next = document_bindings.dom_document_createelement(doc, "list");
+    defer node_bindings.dom_node_release(@ptrCast(next));
+    var sources: [3]*dom_types.DOMNode = undefined;
+    sources[0] = @ptrCast(next);
+    for (sources[1..]) |*source| {
+        const row = document_bindings.dom_document_createelement(doc, "row");
+        _ = node_bindings.dom_node_appendchild(@ptrCast(next), @ptrCast(row));
+        source.* = @ptrCast(row);
+    }
+
+    var patch: dom_types.DOMSnapshotBuffer = undefined;
+    try testing.expectEqual(@as(c_int, 0), node_bindings.dom_node_diff(@ptrCast(list), @ptrCast(next), null, &patch));
+    defer node_bindings.dom_patch_free(patch.data, patch.length);
+
+    const targets = [_]*dom_types.DOMNode{@ptrCast(list)};
+    try testing.expectEqual(@as(c_int, 0), document_bindings.dom_document_apply_patch(doc, patch.data.?, patch.length, &targets, targets.len, &sources, sources.len));
+    try testing.expectEqual(@as(u32, 2), element_bindings.dom_element_get_childelementcount(list));
+
+    // Indices outside the tables are rejected before anything changes
+    try testing.expectEqual(@as(c_int, @intFromEnum(dom_types.DOMErrorCode.IndexSizeError)), document_bindings.dom_document_apply_patch(doc, patch.data.?, patch.length, &targets, targets.len, null, 0));
+    try testing.expectEqual(@as(c_int, @intFromEnum(dom_types.DOMErrorCode.SyntaxError)), document_bindings.dom_document_apply_patch(doc, patch.data.?, 8, &targets, targets.len, null, 0));
+}
+
+test "Document: submitted patches apply on drain" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    const list = document_bindings.dom_document_createelement(doc, "list");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(doc), @ptrCast(list));
+    const next = document_bindings.dom_document_createelement(doc, "list");
+    defer node_bindings.dom_node_release(@ptrCast(next));
+    const row = document_bindings.dom_document_createelement(doc, "row");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(next), @ptrCast(row));
+    const sources = [_]*dom_types.DOMNode{ @ptrCast(next), @ptrCast(row) };
+
+    var patch: dom_types.DOMSnapshotBuffer = undefined;
+    try testing.expectEqual(@as(c_int, 0), node_bindings.dom_node_diff(@ptrCast(list), @ptrCast(next), null, &patch));
+    defer node_bindings.dom_patch_free(patch.data, patch.length);
+
+    // The first submission asks for a wakeup, the second joins its drain
+    const targets = [_]*dom_types.DOMNode{@ptrCast(list)};
+    var wake: u8 = 0;
+    try testing.expectEqual(@as(c_int, 0), document_bindings.dom_document_submit_patch(doc, patch.data.?, patch.length, &targets, targets.len, &sources, sources.len, &wake));
+    try testing.expectEqual(@as(u8, 1), wake);
+    try testing.expectEqual(@as(c_int, 0), document_bindings.dom_document_submit_patch(doc, patch.data.?, patch.length, &targets, targets.len, &sources, sources.len, &wake));
+    try testing.expectEqual(@as(u8, 0), wake);
+    try testing.expectEqual(@as(c_int, @intFromEnum(dom_types.DOMErrorCode.SyntaxError)), document_bindings.dom_document_submit_patch(doc, patch.data.?, 8, &targets, targets.len, null, 0, null));
+    try testing.expectEqual(@as(u32, 0), element_bindings.dom_element_get_childelementcount(list));
+
+    var first_error: c_int = -1;
+    try testing.expectEqual(@as(usize, 2), document_bindings.dom_document_drain_patches(doc, &first_error));
+    try testing.expectEqual(@as(c_int, 0), first_error);
+    try testing.expectEqual(@as(u32, 2), element_bindings.dom_element_get_childelementcount(list));
+    try testing.expectEqual(@as(usize, 0), document_bindings.dom_document_drain_patches(doc, null));
+}
+
+test "Document: idle work builds the enabled indices" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+    try testing.expectEqual(@as(u8, 0), document_bindings.dom_document_has_idle_work(doc));
+    try testing.expectEqual(@as(c_int, 0), document_bindings.dom_document_enable_document_order_index(doc));
+    try testing.expectEqual(@as(c_int, 0), document_bindings.dom_document_enable_structural_hashes(doc));
+
+    const root = document_bindings.dom_document_createelement(doc, "root");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(doc), @ptrCast(root));
+    for (0..1000) |_| {
+        const item = document_bindings.dom_document_createelement(doc, "item");
+        _ = node_bindings.dom_node_appendchild(@ptrCast(root), @ptrCast(item));
+    }
+    try testing.expectEqual(@as(u8, 1), document_bindings.dom_document_has_idle_work(doc));
+
+    // An exhausted budget still makes progress every call
+    var calls: usize = 1;
+    while (document_bindings.dom_document_run_idle_work(doc, 0) != 0) calls += 1;
+    try testing.expect(calls > 1);
+    try testing.expectEqual(@as(u8, 0), document_bindings.dom_document_has_idle_work(doc));
+}
+
+test "Node: structural hash tracks equality and mutations" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+    try testing.expectEqual(@as(c_int, 0), document_bindings.dom_document_enable_structural_hashes(doc));
+
+    const lists = [_]*dom_types.DOMElement{
+        document_bindings.dom_document_createelement(doc, "list"),
+        document_bindings.dom_document_createelement(doc, "list"),
+    };
+    defer for (lists) |list| node_bindings.dom_node_release(@ptrCast(list));
+    for (lists) |list| {
+        const row = document_bindings.dom_document_createelement(doc, "row");
+        _ = element_bindings.dom_element_setattribute(row, "class", "even");
+        _ = node_bindings.dom_node_appendchild(@ptrCast(list), @ptrCast(row));
+    }
+
+    var hashes: [2]u64 = undefined;
+    for (lists, &hashes) |list, *hash| {
+        try testing.expectEqual(@as(c_int, 0), node_bindings.dom_node_get_structural_hash(@ptrCast(list), hash));
+    }
+    try testing.expectEqual(hashes[0], hashes[1]);
+    try testing.expectEqual(@as(u8, 1), node_bindings.dom_node_isequalnode(@ptrCast(lists[0]), @ptrCast(lists[1])));
+
+    // Changing a descendant changes its ancestors' hashes
+    const first = element_bindings.dom_element_get_firstelementchild(lists[1]).?;
+    _ = element_bindings.dom_element_setattribute(first, "class", "odd");
+    try testing.expectEqual(@as(c_int, 0), node_bindings.dom_node_get_structural_hash(@ptrCast(lists[1]), &hashes[1]));
+    try testing.expect(hashes[0] != hashes[1]);
+    try testing.expectEqual(@as(u8, 0), node_bindings.dom_node_isequalnode(@ptrCast(lists[0]), @ptrCast(lists[1])));
+}
+
+test "ShadowRoot: scoped queries and cached slot assignment" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    const host = document_bindings.dom_document_createelement(doc, "host");
+    defer node_bindings.dom_node_release(@ptrCast(host));
+    const shadow = element_bindings.dom_element_attachshadow(host, 0, false).?;
+
+    const slot = document_bindings.dom_document_createelement(doc, "slot");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(shadow), @ptrCast(slot));
+    const light = document_bindings.dom_document_createelement(doc, "item");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(host), @ptrCast(light));
+
+    // Only the shadow tree is searched
+    try testing.expectEqual(slot, shadowroot_bindings.dom_shadowroot_queryselector(shadow, "slot").?);
+    try testing.expect(shadowroot_bindings.dom_shadowroot_queryselector(shadow, "item") == null);
+    const all = shadowroot_bindings.dom_shadowroot_queryselectorall(shadow, "slot").?;
+    defer document_bindings.dom_nodelist_static_release(all);
+    try testing.expectEqual(@as(u32, 1), document_bindings.dom_nodelist_static_get_length(all));
+
+    try testing.expectEqual(slot, element_bindings.dom_element_get_assignedslot(light).?);
+    try testing.expectEqual(@as(u32, 1), element_bindings.dom_element_get_assignednodecount(slot));
+    try testing.expectEqual(@as(*DOMNode, @ptrCast(light)), element_bindings.dom_element_get_assignednode(slot, 0).?);
+    try testing.expect(element_bindings.dom_element_get_assignednode(slot, 1) == null);
+}
+
+test "ShadowRoot: getElementById reads the shadow tree's own index" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    const host = document_bindings.dom_document_createelement(doc, "host");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(doc), @ptrCast(host));
+    const shadow = element_bindings.dom_element_attachshadow(host, 0, false).?;
+
+    const item = document_bindings.dom_document_createelement(doc, "item");
+    _ = element_bindings.dom_element_setattribute(item, "id", "inner");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(shadow), @ptrCast(item));
+
+    try testing.expectEqual(item, shadowroot_bindings.dom_shadowroot_getelementbyid(shadow, "inner").?);
+    try testing.expect(document_bindings.dom_document_getelementbyid(doc, "inner") == null);
+    try testing.expect(shadowroot_bindings.dom_shadowroot_getelementbyid(shadow, "missing") == null);
+}
+
+test "ShadowRoot: reported with its own node type" {
+    const doc = document_bindings.dom_document_new();
+    defer document_bindings.dom_document_release(doc);
+
+    const host = document_bindings.dom_document_createelement(doc, "host");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(doc), @ptrCast(host));
+    const shadow = element_bindings.dom_element_attachshadow(host, 0, false).?;
+    const item = document_bindings.dom_document_createelement(doc, "item");
+    _ = node_bindings.dom_node_appendchild(@ptrCast(shadow), @ptrCast(item));
+
+    // DOM_SHADOW_ROOT_NODE: bindings wrap it as a ShadowRoot, not a fragment
+    try testing.expectEqual(@as(u16, 12), node_bindings.dom_node_get_nodetype(@ptrCast(shadow)));
+    try testing.expectEqual(@as(*DOMNode, @ptrCast(shadow)), node_bindings.dom_node_get_parentnode(@ptrCast(item)).?);
+}
+
+test "AbortSignal: any() follows its sources without holding them" {
+    const request = abortcontroller_bindings.dom_abortcontroller_new();
+    const shutdown = abortcontroller_bindings.dom_abortcontroller_new();
+    defer abortcontroller_bindings.dom_abortcontroller_release(shutdown);
+
+    const sources = [_]*abortsignal_bindings.DOMAbortSignal{
+        @ptrCast(abortcontroller_bindings.dom_abortcontroller_get_signal(request)),
+        @ptrCast(abortcontroller_bindings.dom_abortcontroller_get_signal(shutdown)),
+    };
+    const composite = abortsignal_bindings.dom_abortsignal_any(&sources, sources.len);
+    try testing.expectEqual(@as(u8, 0), abortsignal_bindings.dom_abortsignal_get_aborted(composite));
+
+    // Releasing the request's controller only unlinks it
+    abortcontroller_bindings.dom_abortcontroller_release(request);
+    abortcontroller_bindings.dom_abortcontroller_abort(shutdown, null);
+    try testing.expectEqual(@as(u8, 1), abortsignal_bindings.dom_abortsignal_get_aborted(composite));
+    abortsignal_bindings.dom_abortsignal_release(composite);
+
+    const empty = abortsignal_bindings.dom_abortsignal_any(null, 0);
+    defer abortsignal_bindings.dom_abortsignal_release(empty);
+    try testing.expectEqual(@as(u8, 0), abortsignal_bindings.dom_abortsignal_get_aborted(empty));
+}
+
+test "AbortSignal: timeout() runs on the installed timer host" {
+    const Host = struct {
+        var time: u64 = 0;
+        var armed: ?u64 = null;
+
+        fn now(context: ?*anyopaque) callconv(.c) u64 {
+            _ = context;
+            return time;
+        }
+
+        fn arm(context: ?*anyopaque, deadline: u64) callconv(.c) void {
+            _ = context;
+            armed = deadline;
+        }
+
+        fn disarm(context: ?*anyopaque) callconv(.c) void {
+            _ = context;
+            armed = null;
+        }
+    };
+
+    try testing.expect(abortsignal_bindings.dom_abortsignal_timeout(10) == null);
+
+    const host = abortsignal_bindings.DOMTimerHost{
+        .context = null,
+        .now = Host.now,
+        .arm = Host.arm,
+        .disarm = Host.disarm,
+    };
+    abortsignal_bindings.dom_abortsignal_set_timerhost(&host);
+    defer abortsignal_bindings.dom_abortsignal_set_timerhost(null);
+
+    const signals = [_]*abortsignal_bindings.DOMAbortSignal{
+        abortsignal_bindings.dom_abortsignal_timeout(10).?,
+        abortsignal_bindings.dom_abortsignal_timeout(20).?,
+        abortsignal_bindings.dom_abortsignal_timeout(30).?,
+    };
+    defer for (signals) |signal| abortsignal_bindings.dom_abortsignal_release(signal);
+
+    // One timer for all three, armed for the first deadline
+    try testing.expectEqual(@as(?u64, 10), Host.armed);
+    Host.time = 20;
+    try testing.expectEqual(@as(i32, 0), abortsignal_bindings.dom_abortsignal_run_timeouts());
+    try testing.expectEqual(@as(u8, 1), abortsignal_bindings.dom_abortsignal_get_aborted(signals[0]));
+    try testing.expectEqual(@as(u8, 1), abortsignal_bindings.dom_abortsignal_get_aborted(signals[1]));
+    try testing.expectEqual(@as(u8, 0), abortsignal_bindings.dom_abortsignal_get_aborted(signals[2]));
+    try testing.expectEqual(@as(?u64, 30), Host.armed);
+}
+
+test "CustomElementRegistry: define upgrades existing elements once each" {
+    const Host = struct {
+        var constructed: u32 = 0;
+        var connected: u32 = 0;
+        var changed: u32 = 0;
+        var released: bool = false;
+
+        fn construct(element: *DOMElement, context: ?*anyopaque) callconv(.c) c_int {
+            _ = element;
+            _ = context;
+            constructed += 1;
+            return 0;
+        }
+
+        fn connect(element: *DOMElement, context: ?*anyopaque) callconv(.c) void {
+            _ = element;
+            _ = context;
+            connected += 1;
+        }
+
+        fn attributeChanged(
+            element: *DOMElement,
+            name: *const dom_types.DOMStringView,
+            old_value: ?*const dom_types.DOMStringView,
+            new_value: ?*const dom_types.DOMStringView,
+            namespace_uri: ?*const dom_types.DOMStringView,
+            context: ?*anyopaque,
+        ) callconv(.c) void {
+            _ = element;
+            _ = namespace_uri;
+            _ = context;
+            std.debug.assert(std.mem.eql(u8, name.data[0..name.length], "label"));
+            std.debug.assert(old_value == null and new_value != null);
+            changed += 1;
+        }
+
+        fn release(context: ?*anyopaque) callconv(.c) void {
+            _ = context;
+            released = true;
+        }
+    };
+
+    var context: u8 = 0;
+    {
+        const doc = document_bindings.dom_document_new();
+        defer document_bindings.dom_document_release(doc);
+
+        const root = document_bindings.dom_document_createelement(doc, "root");
+        _ = node_bindings.dom_node_appendchild(@ptrCast(doc), @ptrCast(root));
+        for (0..3) |_| {
+            const item = document_bindings.dom_document_createelement(doc, "x-item");
+            _ = element_bindings.dom_element_setattribute(item, "label", "one");
+            _ = node_bindings.dom_node_appendchild(@ptrCast(root), @ptrCast(item));
+        }
+
+        try testing.expect(customelementregistry_bindings.dom_element_get_customelementregistry(root) == null);
+        const registry = customelementregistry_bindings.dom_document_get_customelementregistry(doc).?;
+        try testing.expectEqual(@as(?*customelementregistry_bindings.DOMCustomElementRegistry, registry), customelementregistry_bindings.dom_element_get_customelementregistry(root));
+
+        const callbacks = customelementregistry_bindings.DOMCustomElementCallbacks{
+            .context = &context,
+            .constructor = Host.construct,
+            .connected = Host.connect,
+            .disconnected = null,
+            .adopted = null,
+            .attribute_changed = Host.attributeChanged,
+            .release = Host.release,
+        };
+        const observed = [_][*:0]const u8{"label"};
+        try testing.expectEqual(@as(c_int, 0), customelementregistry_bindings.dom_customelementregistry_define(registry, "x-item", &callbacks, &observed, observed.len));
+        try testing.expectEqual(@as(u32, 3), Host.constructed);
+        try testing.expectEqual(@as(u32, 3), Host.connected);
+        try testing.expectEqual(@as(u32, 3), Host.changed);
+        try testing.expectEqual(@as(?*anyopaque, &context), customelementregistry_bindings.dom_customelementregistry_get(registry, "x-item"));
+        try testing.expect(customelementregistry_bindings.dom_customelementregistry_get(registry, "x-other") == null);
+
+        // Errors leave the caller's context alone
+        try testing.expectEqual(@as(c_int, 9), customelementregistry_bindings.dom_customelementregistry_define(registry, "x-item", &callbacks, null, 0));
+        try testing.expectEqual(@as(c_int, 12), customelementregistry_bindings.dom_customelementregistry_define(registry, "item", &callbacks, null, 0));
+        try testing.expect(!Host.released);
+
+        // New elements are upgraded on creation
+        const created = document_bindings.dom_document_createelement(doc, "x-item");
+        defer element_bindings.dom_element_release(created);
+        try testing.expectEqual(@as(u32, 4), Host.constructed);
+    }
+    try testing.expect(Host.released);
+}
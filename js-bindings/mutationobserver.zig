@@ -84,10 +84,14 @@ const dom = @import("dom");
 const MutationObserver = dom.MutationObserver;
 const MutationRecord = dom.MutationRecord;
 const MutationObserverInit = dom.MutationObserverInit;
+const MutationRecordBatch = dom.MutationRecordBatch;
 const Node = dom.Node;
 const DOMNode = root.DOMNode;
 const DOMMutationObserver = root.DOMMutationObserver;
 const DOMMutationRecord = root.DOMMutationRecord;
+const dom_types = @import("dom_types.zig");
+const DOMMutationBatch = dom_types.DOMMutationBatch;
+const DOMStringView = dom_types.DOMStringView;
 const DOMErrorCode = root.DOMErrorCode;
 const zigErrorToDOMError = root.zigErrorToDOMError;
 
@@ -109,11 +113,30 @@ pub const MutationCallbackFn = *const fn (
     context: ?*anyopaque,
 ) callconv(std.builtin.CallingConvention.c) void;
 
+/// C-compatible notification that records are pending.
+///
+/// ## Parameters
+/// - `observer`: The MutationObserver whose record queue became non-empty
+/// - `context`: User-provided context pointer
+pub const MutationNotifyFn = *const fn (
+    observer: *DOMMutationObserver,
+    context: ?*anyopaque,
+) callconv(std.builtin.CallingConvention.c) void;
+
 /// Wrapper to adapt C callback to Zig MutationObserver callback.
 const MutationObserverWrapper = struct {
     c_callback: MutationCallbackFn,
     c_context: ?*anyopaque,
     zig_observer: *MutationObserver,
+    notify: ?MutationNotifyFn = null,
+    notify_context: ?*anyopaque = null,
+
+    fn onRecords(observer: *MutationObserver) void {
+        const wrapper: *MutationObserverWrapper = @ptrCast(@alignCast(observer.context.?));
+        if (wrapper.notify) |notify| {
+            notify(@ptrCast(observer), wrapper.notify_context);
+        }
+    }
 
     fn zigCallback(
         records: []const *MutationRecord,
@@ -164,6 +187,7 @@ pub const DOMMutationObserverInit = extern struct {
     subtree: u8, // 0=false, 1=true
     attribute_old_value: u8, // 0=false, 1=true, 255=undefined
     character_data_old_value: u8, // 0=false, 1=true, 255=undefined
+    coalesce: u8, // 0=false, 1=true (extension)
     attribute_filter: ?[*]const ?[*:0]const u8, // null-terminated array of null-terminated strings (null pointer = end)
 };
 
@@ -180,6 +204,7 @@ fn cOptionsToZig(
         .attribute_old_value = if (c_opts.attribute_old_value == 255) null else c_opts.attribute_old_value != 0,
         .character_data_old_value = if (c_opts.character_data_old_value == 255) null else c_opts.character_data_old_value != 0,
         .attribute_filter = null,
+        .coalesce = c_opts.coalesce != 0,
     };
 
     // Convert attribute filter
@@ -232,8 +257,11 @@ pub export fn dom_mutationobserver_new(
 
     // Create wrapper
     const wrapper = allocator.create(MutationObserverWrapper) catch return null;
-    wrapper.c_callback = callback;
-    wrapper.c_context = context;
+    wrapper.* = .{
+        .c_callback = callback,
+        .c_context = context,
+        .zig_observer = undefined,
+    };
 
     // Create Zig observer
     const observer = MutationObserver.init(
@@ -341,6 +369,55 @@ pub export fn dom_mutationobserver_takerecords(
     return @ptrCast(records.ptr);
 }
 
+/// Set (or clear, with null) the pending-records notification.
+///
+/// `notify` runs when a record is queued while the observer's record queue
+/// is empty, in the middle of the DOM mutation that queued it. It must not
+/// touch the DOM; it is meant for scheduling delivery (e.g. a microtask
+/// that calls `dom_mutationobserver_takebatch()`).
+///
+/// ## Parameters
+/// - `observer`: MutationObserver handle
+/// - `notify`: Function to call, or null
+/// - `context`: User-provided context pointer passed to `notify`
+pub export fn dom_mutationobserver_set_notify(
+    observer: *DOMMutationObserver,
+    notify: ?MutationNotifyFn,
+    context: ?*anyopaque,
+) void {
+    const obs: *MutationObserver = @ptrCast(@alignCast(observer));
+    const wrapper: *MutationObserverWrapper = @ptrCast(@alignCast(obs.context.?));
+    wrapper.notify = notify;
+    wrapper.notify_context = context;
+    obs.on_records = if (notify != null) MutationObserverWrapper.onRecords else null;
+}
+
+/// Take all pending mutation records as one packed batch.
+///
+/// The records are flattened into integer tables (see
+/// `dom_mutationbatch_get_entries()`), so a binding can hand the whole
+/// queue over in one crossing and create node wrappers only on demand.
+///
+/// ## Parameters
+/// - `observer`: MutationObserver handle
+///
+/// ## Returns
+/// Batch handle (possibly with zero records), or null on allocation
+/// failure (the records then stay queued)
+///
+/// ## Memory
+/// Caller must call `dom_mutationbatch_release()` when done
+pub export fn dom_mutationobserver_takebatch(observer: *DOMMutationObserver) ?*DOMMutationBatch {
+    const obs: *MutationObserver = @ptrCast(@alignCast(observer));
+
+    const batch = obs.allocator.create(MutationRecordBatch) catch return null;
+    batch.* = MutationRecordBatch.take(obs) catch {
+        obs.allocator.destroy(batch);
+        return null;
+    };
+    return @ptrCast(batch);
+}
+
 /// Release a MutationObserver and free its memory.
 ///
 /// ## Parameters
@@ -590,3 +667,118 @@ pub export fn dom_mutationrecord_release(record: *DOMMutationRecord) void {
     const rec: *MutationRecord = @ptrCast(@alignCast(record));
     rec.deinit();
 }
+
+// ============================================================================
+// MutationRecord Batches
+// ============================================================================
+
+/// Get the number of records in a batch.
+pub export fn dom_mutationbatch_get_count(batch: *const DOMMutationBatch) u32 {
+    const b: *const MutationRecordBatch = @ptrCast(@alignCast(batch));
+    return @intCast(b.count());
+}
+
+/// Get the packed records of a batch.
+///
+/// ## Returns
+/// `count * DOM_MUTATION_BATCH_STRIDE` integers, one row of
+/// DOM_MUTATION_FIELD_* values per record (null if the batch is empty).
+/// Valid until the batch is released.
+pub export fn dom_mutationbatch_get_entries(batch: *const DOMMutationBatch) ?[*]const u32 {
+    const b: *const MutationRecordBatch = @ptrCast(@alignCast(batch));
+    if (b.entries.len == 0) return null;
+    return b.entries.ptr;
+}
+
+/// Get the node indexes of every addedNodes / removedNodes list.
+///
+/// ## Parameters
+/// - `batch`: Batch handle
+/// - `out_count`: Pointer to store the number of indexes
+///
+/// ## Returns
+/// Node indexes, addressed by the *_OFFSET / *_COUNT fields of the
+/// entries (null if none). Valid until the batch is released.
+pub export fn dom_mutationbatch_get_nodelists(
+    batch: *const DOMMutationBatch,
+    out_count: *u32,
+) ?[*]const u32 {
+    const b: *const MutationRecordBatch = @ptrCast(@alignCast(batch));
+    out_count.* = @intCast(b.node_lists.len);
+    if (b.node_lists.len == 0) return null;
+    return b.node_lists.ptr;
+}
+
+/// Get the node table of a batch.
+///
+/// ## Parameters
+/// - `batch`: Batch handle
+/// - `out_count`: Pointer to store the number of nodes
+///
+/// ## Returns
+/// Every node the records reference, each once (null if none). The batch
+/// holds a reference on each; valid until the batch is released.
+pub export fn dom_mutationbatch_get_nodes(
+    batch: *const DOMMutationBatch,
+    out_count: *u32,
+) ?[*]const *DOMNode {
+    const b: *const MutationRecordBatch = @ptrCast(@alignCast(batch));
+    out_count.* = @intCast(b.nodes.len);
+    if (b.nodes.len == 0) return null;
+    return @ptrCast(b.nodes.ptr);
+}
+
+fn batchString(batch: *const DOMMutationBatch, index: u32, comptime field: []const u8, out: *DOMStringView) bool {
+    const b: *const MutationRecordBatch = @ptrCast(@alignCast(batch));
+    if (index >= b.count()) return false;
+    const value = @field(b.record(index), field) orelse return false;
+    out.* = dom_types.zigStringToStringView(value, false);
+    return true;
+}
+
+/// Get the attributeName of record `index`.
+///
+/// ## Returns
+/// false if the record has none (or `index` is out of range). The view is
+/// valid until the batch is released.
+pub export fn dom_mutationbatch_get_attributename(
+    batch: *const DOMMutationBatch,
+    index: u32,
+    out: *DOMStringView,
+) bool {
+    return batchString(batch, index, "attribute_name", out);
+}
+
+/// Get the attributeNamespace of record `index`.
+///
+/// ## Returns
+/// false if the record has none (or `index` is out of range). The view is
+/// valid until the batch is released.
+pub export fn dom_mutationbatch_get_attributenamespace(
+    batch: *const DOMMutationBatch,
+    index: u32,
+    out: *DOMStringView,
+) bool {
+    return batchString(batch, index, "attribute_namespace", out);
+}
+
+/// Get the oldValue of record `index`.
+///
+/// ## Returns
+/// false if the record has none (or `index` is out of range). The view is
+/// valid until the batch is released.
+pub export fn dom_mutationbatch_get_oldvalue(
+    batch: *const DOMMutationBatch,
+    index: u32,
+    out: *DOMStringView,
+) bool {
+    return batchString(batch, index, "old_value", out);
+}
+
+/// Release a batch, its records and its node references.
+pub export fn dom_mutationbatch_release(batch: *DOMMutationBatch) void {
+    const b: *MutationRecordBatch = @ptrCast(@alignCast(batch));
+    const allocator = b.allocator;
+    b.deinit();
+    allocator.destroy(b);
+}
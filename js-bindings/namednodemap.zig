@@ -160,6 +160,30 @@ pub export fn dom_namednodemap_getnameditem(map: *DOMNamedNodeMap, name: [*:0]co
     return null;
 }
 
+/// Get an attribute at a specific index, borrowed.
+///
+/// Same Attr as dom_namednodemap_item(), without a reference for the
+/// caller: do NOT release it. Valid while it is the element's attribute
+/// node (until the attribute is removed or replaced, or the element is
+/// destroyed); addref it to keep it longer.
+pub export fn dom_namednodemap_item_borrowed(map: *DOMNamedNodeMap, index: u32) ?*DOMAttr {
+    const element: *dom.Element = @ptrCast(@alignCast(map));
+    var named_node_map = element.getAttributes();
+    const attr = (&named_node_map).itemBorrowed(index) catch return null;
+    return @ptrCast(@alignCast(attr));
+}
+
+/// Get an attribute by name, borrowed.
+///
+/// Same Attr as dom_namednodemap_getnameditem(), without a reference for
+/// the caller (see dom_namednodemap_item_borrowed).
+pub export fn dom_namednodemap_getnameditem_borrowed(map: *DOMNamedNodeMap, name: [*:0]const u8) ?*DOMAttr {
+    const element: *dom.Element = @ptrCast(@alignCast(map));
+    var named_node_map = element.getAttributes();
+    const attr = (&named_node_map).getNamedItemBorrowed(cStringToZigString(name)) catch return null;
+    return @ptrCast(@alignCast(attr));
+}
+
 /// Get an attribute by namespace and local name.
 ///
 /// Returns the Attr node with the specified namespace and local name, or null if not found.
@@ -200,12 +200,83 @@ pub export fn dom_node_get_textcontent(handle: *DOMNode) ?[*:0]const u8 {
 ///
 /// WebIDL: `attribute DOMString? textContent;`
 pub export fn dom_node_set_textcontent(handle: *DOMNode, value: ?[*:0]const u8) c_int {
-    _ = handle;
-    _ = value;
-    // TODO: Setter implementation pending textContent getter strategy
+    const node: *Node = @ptrCast(@alignCast(handle));
+    node.setTextContent(cStringToZigStringOptional(value)) catch |err| {
+        return @intFromEnum(zigErrorToDOMError(err));
+    };
     return 0; // Success
 }
 
+/// Set textContent from a length-carrying UTF-8 string
+///
+/// In documents that enable it (dom_document_enable_inplace_textcontent),
+/// a sole Text child keeps its node and takes the new data in place.
+pub export fn dom_node_set_textcontent_n(handle: *DOMNode, value: [*]const u8, length: usize) c_int {
+    const node: *Node = @ptrCast(@alignCast(handle));
+    node.setTextContent(value[0..length]) catch |err| {
+        return @intFromEnum(zigErrorToDOMError(err));
+    };
+    return 0; // Success
+}
+
+/// The data of a character data node (its textContent), or null for
+/// other node types.
+fn characterData(node: *const Node) ?[]const u8 {
+    return switch (node.node_type) {
+        .text, .cdata_section, .comment, .processing_instruction => node.nodeValue() orelse "",
+        else => null,
+    };
+}
+
+/// Get textContent as a string view (no copy), if it is stored in one place
+///
+/// That is the case for character data nodes and for nodes whose text is
+/// in at most one non-empty Text descendant. Returns false (and leaves
+/// `out` untouched) otherwise, or if textContent is null; use
+/// dom_node_get_textcontent_length() and dom_node_copy_textcontent() then.
+pub export fn dom_node_get_textcontent_view(handle: *DOMNode, out: *types.DOMStringView) bool {
+    const node: *const Node = @ptrCast(@alignCast(handle));
+    const value = characterData(node) orelse switch (node.node_type) {
+        .document, .document_type => return false,
+        else => dom.tree_helpers.descendantTextContentSlice(node) orelse return false,
+    };
+    out.* = types.zigStringToStringView(value, false);
+    return true;
+}
+
+/// Get the length of textContent in UTF-8 bytes
+///
+/// Returns false (and leaves `out` untouched) if textContent is null
+/// (Document and DocumentType nodes).
+pub export fn dom_node_get_textcontent_length(handle: *DOMNode, out: *usize) bool {
+    const node: *const Node = @ptrCast(@alignCast(handle));
+    if (characterData(node)) |data| {
+        out.* = data.len;
+        return true;
+    }
+    if (node.node_type == .document or node.node_type == .document_type) return false;
+    out.* = dom.tree_helpers.descendantTextContentLength(node);
+    return true;
+}
+
+/// Copy textContent into a caller-provided buffer
+///
+/// Writes at most `capacity` bytes of UTF-8 (not NUL-terminated) and
+/// returns the full length; size the buffer with
+/// dom_node_get_textcontent_length() to copy it in one call. Writes
+/// nothing and returns 0 if textContent is null.
+pub export fn dom_node_copy_textcontent(handle: *DOMNode, buffer: ?[*]u8, capacity: usize) usize {
+    const node: *const Node = @ptrCast(@alignCast(handle));
+    const out: []u8 = if (buffer) |b| b[0..capacity] else &.{};
+    if (characterData(node)) |data| {
+        const n = @min(data.len, out.len);
+        @memcpy(out[0..n], data[0..n]);
+        return data.len;
+    }
+    if (node.node_type == .document or node.node_type == .document_type) return 0;
+    return dom.tree_helpers.copyDescendantTextContent(node, out);
+}
+
 // SKIPPED: getRootNode() - Contains complex types not supported in C-ABI v1
 // WebIDL: Node getRootNode(GetRootNodeOptions options);
 // Reason: Dictionary type 'GetRootNodeOptions'
@@ -218,6 +289,16 @@ pub export fn dom_node_haschildnodes(handle: *DOMNode) u8 {
     return if (node.first_child != null) 1 else 0;
 }
 
+/// getRootNode method
+///
+/// WebIDL: `Node getRootNode(optional GetRootNodeOptions options = {});`
+///
+/// O(1) for connected nodes (see Node.getRootNode()).
+pub export fn dom_node_getrootnode(handle: *DOMNode, composed: u8) *DOMNode {
+    const node: *const Node = @ptrCast(@alignCast(handle));
+    return @ptrCast(node.getRootNode(composed != 0));
+}
+
 /// normalize method
 ///
 /// WebIDL: `undefined normalize();`
@@ -255,6 +336,22 @@ pub export fn dom_node_isequalnode(handle: *DOMNode, otherNode: ?*DOMNode) u8 {
     return if (node.isEqualNode(other)) 1 else 0;
 }
 
+/// Get the structural hash of a node's subtree.
+///
+/// Not in WebIDL. Equal nodes (isEqualNode) have equal hashes, so the hash
+/// works as a cheap fingerprint for cache keys. Cached per node when the
+/// document enables structural hashes.
+///
+/// ## Returns
+/// 0 on success, error code on failure
+pub export fn dom_node_get_structural_hash(handle: *DOMNode, out: *u64) c_int {
+    const node: *const Node = @ptrCast(@alignCast(handle));
+    out.* = node.structuralHash() catch |err| {
+        return @intFromEnum(zigErrorToDOMError(err));
+    };
+    return 0;
+}
+
 /// isSameNode method
 ///
 /// WebIDL: `boolean isSameNode(Node otherNode);`
@@ -385,3 +482,213 @@ pub export fn dom_node_release(handle: *DOMNode) void {
     const node: *Node = @ptrCast(@alignCast(handle));
     node.release();
 }
+
+/// Increase the reference count of a batch of nodes
+///
+/// Same as calling dom_node_addref() on each entry, in a single call.
+pub export fn dom_node_addref_many(handles: [*]const *DOMNode, count: usize) void {
+    for (handles[0..count]) |handle| {
+        const node: *Node = @ptrCast(@alignCast(handle));
+        node.acquire();
+    }
+}
+
+/// Release a batch of node references (documents included)
+///
+/// Same as calling the matching release function on each entry, in order,
+/// in a single call.
+pub export fn dom_node_release_many(handles: [*]const *DOMNode, count: usize) void {
+    for (handles[0..count]) |handle| {
+        const node: *Node = @ptrCast(@alignCast(handle));
+        if (node.node_type == .document) {
+            const doc: *Document = @fieldParentPtr("prototype", node);
+            doc.release();
+        } else {
+            node.release();
+        }
+    }
+}
+
+/// Bytes the node holds by itself (struct, character data, attribute
+/// storage, rare data), excluding its children
+///
+/// See Node.selfBytes(); meant for attributing DOM memory in heap
+/// snapshots.
+pub export fn dom_node_get_self_bytes(handle: *DOMNode) usize {
+    const node: *const Node = @ptrCast(@alignCast(handle));
+    return node.selfBytes();
+}
+
+// ============================================================================
+// Embedder Wrapper Slot
+// ============================================================================
+
+/// Get the embedder wrapper slot
+///
+/// Returns the opaque value last stored with dom_node_set_wrapper_slot(),
+/// or 0 if none. JS engine bindings use this to find a node's wrapper with
+/// a single load instead of a hash lookup. The DOM never interprets it.
+pub export fn dom_node_get_wrapper_slot(handle: *DOMNode) u32 {
+    const node: *const Node = @ptrCast(@alignCast(handle));
+    return node.wrapper_slot;
+}
+
+/// Set the embedder wrapper slot
+///
+/// Pass 0 to clear. Only one embedder may own the slot per node. Nodes of
+/// shared documents keep their claimed slot (see dom_document_share()).
+pub export fn dom_node_set_wrapper_slot(handle: *DOMNode, slot: u32) void {
+    const node: *Node = @ptrCast(@alignCast(handle));
+    if (node.isShared()) return;
+    node.wrapper_slot = slot;
+}
+
+/// Serialize a subtree into a flat preorder record buffer
+///
+/// See src/tree_snapshot.zig for the layout. On success `out` receives a
+/// buffer that must be freed with dom_snapshot_free().
+pub export fn dom_node_snapshot_subtree(handle: *DOMNode, flags: u32, out: *types.DOMSnapshotBuffer) c_int {
+    const node: *const Node = @ptrCast(@alignCast(handle));
+    const buffer = dom.tree_snapshot.snapshotSubtree(std.heap.c_allocator, node, flags) catch |err| {
+        return @intFromEnum(zigErrorToDOMError(err));
+    };
+    out.* = .{ .data = buffer.ptr, .length = buffer.len };
+    return 0; // Success
+}
+
+/// Free a buffer returned by dom_node_snapshot_subtree()
+pub export fn dom_snapshot_free(data: ?[*]u8, length: usize) void {
+    const ptr = data orelse return;
+    const aligned: [*]align(4) u8 = @alignCast(ptr);
+    dom.tree_snapshot.freeSnapshot(std.heap.c_allocator, aligned[0..length]);
+}
+
+/// Compute the patch that turns the subtree of `old` into that of `new`
+///
+/// See src/tree_diff.zig for the layout. `key` names the attribute that
+/// identifies element children across the trees (null matches by
+/// position). On success `out` receives a buffer that must be freed with
+/// dom_patch_free().
+pub export fn dom_node_diff(old: *DOMNode, new: *DOMNode, key: ?[*:0]const u8, out: *types.DOMSnapshotBuffer) c_int {
+    const old_node: *Node = @ptrCast(@alignCast(old));
+    const new_node: *Node = @ptrCast(@alignCast(new));
+    const options = dom.tree_diff.Options{ .key = if (key) |k| std.mem.span(k) else null };
+    const buffer = dom.tree_diff.diff(std.heap.c_allocator, old_node, new_node, options) catch |err| {
+        return @intFromEnum(zigErrorToDOMError(err));
+    };
+    out.* = .{ .data = buffer.ptr, .length = buffer.len };
+    return 0; // Success
+}
+
+/// Free a buffer returned by dom_node_diff()
+pub export fn dom_patch_free(data: ?[*]u8, length: usize) void {
+    const ptr = data orelse return;
+    const aligned: [*]align(4) u8 = @alignCast(ptr);
+    dom.tree_diff.freePatch(std.heap.c_allocator, aligned[0..length]);
+}
+
+/// Callback receiving one chunk of serialized markup.
+///
+/// `data` is UTF-8 (not NUL-terminated) and only valid during the call.
+/// The callback must not mutate the document.
+pub const DOMMarkupChunk = *const fn (data: [*]const u8, length: u32, user_data: ?*anyopaque) callconv(.c) void;
+
+/// Stream a node's markup to a callback
+///
+/// See src/serializer.zig for the syntax. Chunks arrive in order and
+/// concatenate to the markup; nothing is allocated.
+pub export fn dom_node_serialize(handle: *DOMNode, flags: u32, chunk: DOMMarkupChunk, user_data: ?*anyopaque) void {
+    const node: *const Node = @ptrCast(@alignCast(handle));
+
+    const Sink = struct {
+        callback: DOMMarkupChunk,
+        user_data: ?*anyopaque,
+
+        fn emit(sink: @This(), data: []const u8) std.mem.Allocator.Error!void {
+            sink.callback(data.ptr, @intCast(data.len), sink.user_data);
+        }
+    };
+
+    // Emitting never allocates
+    dom.serializer.serialize(node, flags, Sink{ .callback = chunk, .user_data = user_data }, Sink.emit) catch unreachable;
+}
+
+/// Serialize a node's markup into a caller-provided buffer
+///
+/// Writes at most `capacity` bytes and returns the full markup length;
+/// when it exceeds `capacity` the buffer holds only a prefix, and the
+/// caller can retry with a buffer of the returned size.
+pub export fn dom_node_serialize_into(handle: *DOMNode, flags: u32, buffer: ?[*]u8, capacity: usize) usize {
+    const node: *const Node = @ptrCast(@alignCast(handle));
+
+    const Sink = struct {
+        buffer: ?[*]u8,
+        capacity: usize,
+        length: usize = 0,
+
+        fn emit(sink: *@This(), data: []const u8) std.mem.Allocator.Error!void {
+            if (sink.length < sink.capacity) {
+                const n = @min(data.len, sink.capacity - sink.length);
+                @memcpy(sink.buffer.?[sink.length..][0..n], data[0..n]);
+            }
+            sink.length += data.len;
+        }
+    };
+
+    var sink = Sink{ .buffer = buffer, .capacity = if (buffer == null) 0 else capacity };
+    dom.serializer.serialize(node, flags, &sink, Sink.emit) catch unreachable;
+    return sink.length;
+}
+
+// ============================================================================
+// Bulk Child Access
+// ============================================================================
+
+/// Get the child list generation
+///
+/// The value changes whenever a child is inserted or removed, so bindings
+/// can keep a copy of the child array and refill it only when this differs
+/// from the generation they copied at.
+pub export fn dom_node_get_child_generation(handle: *DOMNode) u32 {
+    const node: *const Node = @ptrCast(@alignCast(handle));
+    return node.generation;
+}
+
+/// Copy child node pointers into a caller-provided array
+///
+/// Fills `out` with up to `capacity` children in tree order. Pointers are
+/// borrowed (no addref).
+///
+/// ## Returns
+/// Total number of children; if larger than `capacity`, call again with a
+/// bigger array.
+pub export fn dom_node_get_children_array(handle: *DOMNode, out: ?[*]*DOMNode, capacity: u32) u32 {
+    const node: *const Node = @ptrCast(@alignCast(handle));
+    var total: u32 = 0;
+    var current = node.first_child;
+    while (current) |child| : (current = child.next_sibling) {
+        if (total < capacity) {
+            out.?[total] = @ptrCast(child);
+        }
+        total += 1;
+    }
+    return total;
+}
+
+/// Copy element child pointers into a caller-provided array
+///
+/// Same as dom_node_get_children_array(), but only Element children
+/// (the `children` collection).
+pub export fn dom_node_get_element_children_array(handle: *DOMNode, out: ?[*]*DOMNode, capacity: u32) u32 {
+    const node: *const Node = @ptrCast(@alignCast(handle));
+    var total: u32 = 0;
+    var current = node.first_child;
+    while (current) |child| : (current = child.next_sibling) {
+        if (child.node_type != .element) continue;
+        if (total < capacity) {
+            out.?[total] = @ptrCast(child);
+        }
+        total += 1;
+    }
+    return total;
+}
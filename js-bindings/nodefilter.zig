@@ -0,0 +1,125 @@
+//! NodeFilter C-ABI Bindings
+//!
+//! C-ABI support for the NodeFilter argument of createTreeWalker and
+//! createNodeIterator, in two forms:
+//!
+//! - **Callback filters** (`DOMNodeFilter`): a C function pointer plus
+//!   user data, called once per candidate node. Bindings use it for
+//!   script filters.
+//! - **Native element filters** (`DOMElementFilter`): a tag-name set and/or
+//!   a required class, evaluated entirely in Zig. Bindings compile common
+//!   declarative filters into one, so walking a document never leaves Zig.
+//!
+//! Without a filter, `whatToShow` alone is applied natively.
+//!
+//! ## Usage Example (C)
+//!
+//! ```c
+//! DOMElementFilter* filter = dom_elementfilter_new(DOM_NODEFILTER_FILTER_SKIP);
+//! dom_elementfilter_add_tagname(filter, "item", 4);
+//! dom_elementfilter_set_classname(filter, "visible", 7);
+//!
+//! DOMTreeWalker* walker = dom_document_createtreewalker_native(
+//!     doc, root, DOM_NODEFILTER_SHOW_ELEMENT, filter);
+//! for (DOMNode* node = dom_treewalker_nextnode(walker); node;
+//!      node = dom_treewalker_nextnode(walker)) {
+//!     // ...
+//! }
+//!
+//! dom_treewalker_release(walker);
+//! dom_elementfilter_release(filter);  // after every walker using it
+//! ```
+//!
+//! ## Spec References
+//!
+//! - **NodeFilter**: https://dom.spec.whatwg.org/#callbackdef-nodefilter
+
+const std = @import("std");
+const dom = @import("dom");
+const types = @import("dom_types.zig");
+
+const Node = dom.Node;
+const NodeFilter = dom.NodeFilter;
+const FilterResult = dom.FilterResult;
+const ElementFilter = dom.ElementFilter;
+const DOMNode = types.DOMNode;
+const DOMNodeFilter = types.DOMNodeFilter;
+const DOMElementFilter = types.DOMElementFilter;
+
+// ============================================================================
+// Callback Filters
+// ============================================================================
+
+/// NodeFilter that calls a caller-supplied DOMNodeFilter.
+///
+/// The DOMNodeFilter is read on every call, so it must outlive the walker
+/// or iterator.
+pub fn callbackFilter(filter: ?*const DOMNodeFilter) ?NodeFilter {
+    const f = filter orelse return null;
+    return .{ .callback = invokeCallback, .context = @constCast(f) };
+}
+
+fn invokeCallback(node: *Node, context: ?*anyopaque) FilterResult {
+    const filter: *const DOMNodeFilter = @ptrCast(@alignCast(context.?));
+    return switch (filter.accept_node(@ptrCast(node), filter.user_data)) {
+        1 => .accept,
+        2 => .reject,
+        else => .skip,
+    };
+}
+
+// ============================================================================
+// Native Element Filters
+// ============================================================================
+
+/// Create a native element filter.
+///
+/// With no tag names and no class set it accepts every element.
+///
+/// ## Parameters
+/// - `miss_result`: Result for nodes that do not match:
+///   DOM_NODEFILTER_FILTER_SKIP (3) or DOM_NODEFILTER_FILTER_REJECT (2)
+///
+/// ## Returns
+/// New filter (release with dom_elementfilter_release), or NULL if out of memory
+pub export fn dom_elementfilter_new(miss_result: u16) ?*DOMElementFilter {
+    const allocator = std.heap.c_allocator;
+    const filter = allocator.create(ElementFilter) catch return null;
+    filter.* = ElementFilter.init(allocator);
+    filter.miss = if (miss_result == @intFromEnum(FilterResult.reject)) .reject else .skip;
+    return @ptrCast(filter);
+}
+
+/// Add a tag name to the filter's accepted set (compared exactly).
+///
+/// ## Returns
+/// 0 on success, error code on failure
+pub export fn dom_elementfilter_add_tagname(filter: *DOMElementFilter, name: [*]const u8, name_len: usize) c_int {
+    const f: *ElementFilter = @ptrCast(@alignCast(filter));
+    f.addTagName(name[0..name_len]) catch |err| {
+        return @intFromEnum(types.zigErrorToDOMError(err));
+    };
+    return 0;
+}
+
+/// Require matching elements to carry a class (replaces any previous one).
+///
+/// ## Returns
+/// 0 on success, error code on failure
+pub export fn dom_elementfilter_set_classname(filter: *DOMElementFilter, name: [*]const u8, name_len: usize) c_int {
+    const f: *ElementFilter = @ptrCast(@alignCast(filter));
+    f.setClassName(name[0..name_len]) catch |err| {
+        return @intFromEnum(types.zigErrorToDOMError(err));
+    };
+    return 0;
+}
+
+/// Release a native element filter.
+///
+/// Walkers and iterators using it must be released first.
+pub export fn dom_elementfilter_release(filter: *DOMElementFilter) void {
+    const f: *ElementFilter = @ptrCast(@alignCast(filter));
+    const allocator = f.allocator;
+    f.deinit();
+    allocator.destroy(f);
+}
@@ -175,6 +175,28 @@ pub export fn dom_nodeiterator_nextnode(iterator: *DOMNodeIterator) ?*DOMNode {
     return if (it.nextNode()) |node| @ptrCast(node) else null;
 }
 
+/// Navigate forward by up to `max` nodes in one call (non-standard).
+///
+/// Equivalent to calling dom_nodeiterator_nextnode() until it returns NULL
+/// or `max` nodes have been returned.
+///
+/// ## Parameters
+/// - `iterator`: NodeIterator handle
+/// - `out`: Buffer receiving the nodes, in iteration order
+/// - `max`: Capacity of `out`
+///
+/// ## Returns
+/// Number of nodes written (less than `max` once iteration is exhausted)
+pub export fn dom_nodeiterator_nextnodes(iterator: *DOMNodeIterator, out: [*]*DOMNode, max: u32) u32 {
+    const it: *NodeIterator = @ptrCast(@alignCast(iterator));
+    var count: u32 = 0;
+    while (count < max) : (count += 1) {
+        const node = it.nextNode() orelse break;
+        out[count] = @ptrCast(node);
+    }
+    return count;
+}
+
 /// Navigate to previous node in iteration order.
 ///
 /// ## WebIDL
@@ -221,7 +243,7 @@ pub export fn dom_nodeiterator_detach(iterator: *DOMNodeIterator) void {
     it.detach();
 }
 
-/// Release a NodeIterator and free its memory.
+/// Release a NodeIterator and its references to its root and reference node.
 ///
 /// ## Parameters
 /// - `iterator`: NodeIterator handle
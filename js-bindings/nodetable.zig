@@ -0,0 +1,154 @@
+//! NodeTable C-ABI Bindings (non-standard)
+//!
+//! Exposes a document's integer node handles (node_table.zig) to bindings.
+//! Script algorithms that visit every node of a large tree (layout
+//! prototypes, diffing) otherwise get a wrapper object per node read, each
+//! one a wrapper cache lookup or allocation. With handles, traversal passes
+//! 30-bit integers (small integers in JS engines) and wrappers are only
+//! created for the nodes an algorithm returns, with dom_nodetable_node().
+//!
+//! ## Validity
+//!
+//! Ids are numbered per document on first use and never reused: once a
+//! node is destroyed or adopted by another document, its id resolves to
+//! nothing (NULL, or 0 from the stepping functions). 0 is never a node.
+//!
+//! ## Usage Example (C)
+//!
+//! ```c
+//! uint32_t row = dom_nodetable_atom(doc, "row", 3);
+//! uint32_t id = dom_nodetable_related(doc, dom_nodetable_id(root), DOM_NODE_RELATION_FIRST_CHILD);
+//! for (; id != 0; id = dom_nodetable_related(doc, id, DOM_NODE_RELATION_NEXT_SIBLING)) {
+//!     if (dom_nodetable_tag_atom(doc, id) == row) visit(dom_nodetable_node(doc, id));
+//! }
+//! ```
+//!
+//! ## Exported Functions
+//! - dom_nodetable_id() - Id of a node in its document's table
+//! - dom_nodetable_node() - Node of an id (borrowed)
+//! - dom_nodetable_related() - Id of a parent, child or sibling
+//! - dom_nodetable_nodetype() - nodeType of an id
+//! - dom_nodetable_tag_atom() - Tag name atom of an element id
+//! - dom_nodetable_atom() - Atom of a tag name
+//! - dom_nodetable_atom_name() - Tag name of an atom
+//! - dom_nodetable_clear() - Drop every id of a document
+//! - dom_nodetable_count() - Number of nodes with an id
+
+const std = @import("std");
+const dom = @import("dom");
+const Node = dom.Node;
+const Document = dom.Document;
+const Relation = dom.node_table.Relation;
+const dom_types = @import("dom_types.zig");
+
+pub const DOMNode = dom_types.DOMNode;
+pub const DOMDocument = dom_types.DOMDocument;
+pub const DOMStringView = dom_types.DOMStringView;
+
+fn documentOf(handle: *DOMDocument) *Document {
+    return @ptrCast(@alignCast(handle));
+}
+
+/// Get the id of a node in its owner document's node table, numbering the
+/// node on first use (and enabling the table on the first call).
+///
+/// A document node gets an id in its own table.
+///
+/// ## Returns
+/// Id (at least 1), or 0 for attributes, nodes without a document, nodes
+/// outside the tree of a frozen document, or on allocation failure
+pub export fn dom_nodetable_id(handle: *DOMNode) u32 {
+    const node: *Node = @ptrCast(@alignCast(handle));
+    const doc_node = node.owner_document orelse node;
+    if (doc_node.node_type != .document) return 0;
+    const doc: *Document = @fieldParentPtr("prototype", doc_node);
+    return doc.nodeId(node) catch 0;
+}
+
+/// Get the node of an id from dom_nodetable_id().
+///
+/// ## Returns
+/// Node (borrowed), or NULL if the id names no node of the document
+pub export fn dom_nodetable_node(doc: *DOMDocument, id: u32) ?*DOMNode {
+    const node = documentOf(doc).nodeById(id) orelse return null;
+    return @ptrCast(node);
+}
+
+/// Get the id of the parent, first or last child, or previous or next
+/// sibling of a node, numbering it if needed.
+///
+/// ## Parameters
+/// - `relation`: DOM_NODE_RELATION_* (see node_table.Relation)
+///
+/// ## Returns
+/// Id, or 0 if there is no such node (or `relation` is unknown)
+pub export fn dom_nodetable_related(doc: *DOMDocument, id: u32, relation: u8) u32 {
+    const table = documentOf(doc).node_table orelse return 0;
+    const kind = std.meta.intToEnum(Relation, relation) catch return 0;
+    return table.related(id, kind) catch 0;
+}
+
+/// Get the nodeType of the node of an id.
+///
+/// ## Returns
+/// nodeType, or 0 if the id names no node
+pub export fn dom_nodetable_nodetype(doc: *DOMDocument, id: u32) u16 {
+    const node = documentOf(doc).nodeById(id) orelse return 0;
+    return @intFromEnum(node.node_type);
+}
+
+/// Get the atom of the tag name of the element of an id.
+///
+/// ## Returns
+/// Atom (at least 1), or 0 if the id names no element
+pub export fn dom_nodetable_tag_atom(doc: *DOMDocument, id: u32) u32 {
+    const self = documentOf(doc);
+    const table = self.node_table orelse return 0;
+    return table.tagAtom(&self.string_pool, id) catch 0;
+}
+
+/// Get the atom of a tag name, to compare with dom_nodetable_tag_atom().
+///
+/// Enables the table on the first call. Names compare exactly, as tagName
+/// does.
+///
+/// ## Returns
+/// Atom (at least 1), or 0 if a frozen document's table has none or on
+/// allocation failure
+pub export fn dom_nodetable_atom(doc: *DOMDocument, name: [*]const u8, name_len: usize) u32 {
+    const self = documentOf(doc);
+    if (self.node_table == null) {
+        if (self.frozen) return 0;
+        self.enableNodeTable() catch return 0;
+    }
+    return self.node_table.?.atomOf(&self.string_pool, name[0..name_len]) catch 0;
+}
+
+/// Get the tag name of an atom.
+///
+/// ## Returns
+/// True and the name in `out` (interned in the document's pool), or false
+/// if there is no such atom
+pub export fn dom_nodetable_atom_name(doc: *DOMDocument, atom: u32, out: *DOMStringView) bool {
+    const self = documentOf(doc);
+    const table = self.node_table orelse return false;
+    const name = table.atomName(atom) orelse return false;
+    out.* = if (self.string_pool.ownedEncoding(name)) |encoding|
+        dom_types.encodedStringView(name, encoding, true)
+    else
+        dom_types.zigStringToStringView(name, false);
+    return true;
+}
+
+/// Drop every id of the document's table; ids given out before never name
+/// a node again. Atoms are kept. Does nothing for frozen documents.
+pub export fn dom_nodetable_clear(doc: *DOMDocument) void {
+    const table = documentOf(doc).node_table orelse return;
+    table.clear();
+}
+
+/// Get the number of nodes of the document with an id.
+pub export fn dom_nodetable_count(doc: *DOMDocument) u32 {
+    const table = documentOf(doc).node_table orelse return 0;
+    return @intCast(table.count());
+}
@@ -0,0 +1,87 @@
+//! Sliced Query C-ABI Bindings (non-standard)
+//!
+//! Exposes SlicedQuery (sliced_query.zig): querySelectorAll in steps with
+//! a time budget each, for documents too large to query in one call
+//! without blocking the embedder's event loop.
+//!
+//! ## Usage Example (C)
+//!
+//! ```c
+//! DOMQuery* query = dom_query_begin(doc, ".row", 4);
+//! DOMElement* batch[256];
+//! while (dom_query_get_state(query) == DOM_QUERY_RUNNING) {
+//!     uint32_t count = dom_query_step(query, 2000000, batch, 256);
+//!     for (uint32_t i = 0; i < count; i++) visit(batch[i]);
+//!     yield_to_event_loop();
+//! }
+//! if (dom_query_get_state(query) == DOM_QUERY_INVALIDATED) restart();
+//! dom_query_release(query);
+//! ```
+//!
+//! ## Exported Functions
+//! - dom_query_begin() - Start a query over a document
+//! - dom_query_step() - Next matches within a time budget
+//! - dom_query_get_state() - Running, done or invalidated
+//! - dom_query_release() - Release the query
+
+const std = @import("std");
+const dom = @import("dom");
+const Document = dom.Document;
+const Element = dom.Element;
+const SlicedQuery = dom.SlicedQuery;
+const dom_types = @import("dom_types.zig");
+const cLenStringToZigString = dom_types.cLenStringToZigString;
+
+pub const DOMDocument = dom_types.DOMDocument;
+pub const DOMElement = dom_types.DOMElement;
+pub const DOMQuery = dom_types.DOMQuery;
+
+fn of(handle: *DOMQuery) *SlicedQuery {
+    return @ptrCast(@alignCast(handle));
+}
+
+/// Start a query for the elements of `doc` matching `selectors`.
+///
+/// ## Parameters
+/// - `doc`: Document to query (referenced until release)
+/// - `selectors`: Selector string (UTF-8, need not be null-terminated)
+/// - `selectors_len`: Length of selectors in bytes
+///
+/// ## Returns
+/// Query handle, or NULL if the selector is invalid or allocation failed
+pub export fn dom_query_begin(doc: *DOMDocument, selectors: [*]const u8, selectors_len: usize) ?*DOMQuery {
+    const document: *Document = @ptrCast(@alignCast(doc));
+    const query = SlicedQuery.init(std.heap.c_allocator, document, &document.prototype, cLenStringToZigString(selectors, selectors_len)) catch {
+        return null;
+    };
+    return @ptrCast(query);
+}
+
+/// Visit elements for up to `budget_ns` nanoseconds (or until `max`
+/// matches) and write the matches to `out`, in tree order.
+///
+/// ## Parameters
+/// - `query`: Query handle
+/// - `budget_ns`: Time budget of this step
+/// - `out`: Buffer receiving the matches
+/// - `max`: Capacity of `out`
+///
+/// ## Returns
+/// Number of matches written (0 once the query is done or invalidated,
+/// or if matching failed)
+pub export fn dom_query_step(query: *DOMQuery, budget_ns: u64, out: [*]*DOMElement, max: u32) u32 {
+    const elements: [*]*Element = @ptrCast(out);
+    const count = of(query).step(budget_ns, elements[0..max]) catch return 0;
+    return @intCast(count);
+}
+
+/// Get the state of a query: DOM_QUERY_RUNNING (step again),
+/// DOM_QUERY_DONE or DOM_QUERY_INVALIDATED (the document mutated).
+pub export fn dom_query_get_state(query: *DOMQuery) u8 {
+    return @intFromEnum(of(query).state);
+}
+
+/// Release a query and its references.
+pub export fn dom_query_release(query: *DOMQuery) void {
+    of(query).deinit();
+}
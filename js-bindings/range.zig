@@ -102,10 +102,16 @@ const DOMNode = types.DOMNode;
 const DOMDocumentFragment = types.DOMDocumentFragment;
 const DOMErrorCode = types.DOMErrorCode;
 const zigErrorToDOMError = types.zigErrorToDOMError;
+const toByteOffset = dom.character_data.toByteOffset;
+const toDomOffset = dom.character_data.toDomOffset;
 
 // ============================================================================
 // AbstractRange Properties (inherited by Range)
 // ============================================================================
+//
+// Offsets in character data are UTF-16 code units, as in JavaScript; ranges
+// keep byte offsets, converted here with the node's UTF-16 index (see
+// character_data.zig).
 
 /// Get the start container node.
 ///
@@ -140,7 +146,7 @@ pub export fn dom_range_get_startcontainer(range: *DOMRange) *DOMNode {
 /// - https://developer.mozilla.org/en-US/docs/Web/API/Range/startOffset
 pub export fn dom_range_get_startoffset(range: *DOMRange) u32 {
     const r: *Range = @ptrCast(@alignCast(range));
-    return r.start_offset;
+    return toDomOffset(r.start_container, r.start_offset);
 }
 
 /// Get the end container node.
@@ -176,7 +182,7 @@ pub export fn dom_range_get_endcontainer(range: *DOMRange) *DOMNode {
 /// - https://developer.mozilla.org/en-US/docs/Web/API/Range/endOffset
 pub export fn dom_range_get_endoffset(range: *DOMRange) u32 {
     const r: *Range = @ptrCast(@alignCast(range));
-    return r.end_offset;
+    return toDomOffset(r.end_container, r.end_offset);
 }
 
 /// Check if the range is collapsed (start equals end).
@@ -247,7 +253,7 @@ pub export fn dom_range_setstart(range: *DOMRange, node: *DOMNode, offset: u32)
     const r: *Range = @ptrCast(@alignCast(range));
     const n: *Node = @ptrCast(@alignCast(node));
 
-    r.setStart(n, offset) catch |err| {
+    r.setStart(n, toByteOffset(n, offset)) catch |err| {
         return @intFromEnum(zigErrorToDOMError(err));
     };
 
@@ -276,7 +282,40 @@ pub export fn dom_range_setend(range: *DOMRange, node: *DOMNode, offset: u32) c_
     const r: *Range = @ptrCast(@alignCast(range));
     const n: *Node = @ptrCast(@alignCast(node));
 
-    r.setEnd(n, offset) catch |err| {
+    r.setEnd(n, toByteOffset(n, offset)) catch |err| {
+        return @intFromEnum(zigErrorToDOMError(err));
+    };
+
+    return 0;
+}
+
+/// Set both boundary points at once (non-standard).
+///
+/// Equivalent to dom_range_setstart() followed by dom_range_setend(), with
+/// both points validated first: on error the range is unchanged. If the end
+/// is before the start, the range collapses to the end.
+///
+/// ## Parameters
+/// - `range`: Range handle
+/// - `start_node`: Container node for start boundary
+/// - `start_offset`: Offset within start_node
+/// - `end_node`: Container node for end boundary
+/// - `end_offset`: Offset within end_node
+///
+/// ## Returns
+/// 0 on success, error code on failure
+pub export fn dom_range_setbaseandextent(
+    range: *DOMRange,
+    start_node: *DOMNode,
+    start_offset: u32,
+    end_node: *DOMNode,
+    end_offset: u32,
+) c_int {
+    const r: *Range = @ptrCast(@alignCast(range));
+    const start: *Node = @ptrCast(@alignCast(start_node));
+    const end: *Node = @ptrCast(@alignCast(end_node));
+
+    r.setBaseAndExtent(start, toByteOffset(start, start_offset), end, toByteOffset(end, end_offset)) catch |err| {
         return @intFromEnum(zigErrorToDOMError(err));
     };
 
@@ -500,6 +539,11 @@ pub export fn dom_range_compareboundarypoints(range: *DOMRange, how: u16, source
     const r: *Range = @ptrCast(@alignCast(range));
     const sr: *Range = @ptrCast(@alignCast(source_range));
 
+    // Step 1: how must be one of the four constants
+    if (how > @intFromEnum(BoundaryPointComparison.end_to_start)) {
+        return @intFromEnum(DOMErrorCode.NotSupportedError);
+    }
+
     // Convert u16 to BoundaryPointComparison enum
     const comparison: BoundaryPointComparison = @enumFromInt(how);
 
@@ -532,7 +576,7 @@ pub export fn dom_range_comparepoint(range: *DOMRange, node: *DOMNode, offset: u
     const r: *Range = @ptrCast(@alignCast(range));
     const n: *Node = @ptrCast(@alignCast(node));
 
-    const result = r.comparePoint(n, offset) catch |err| {
+    const result = r.comparePoint(n, toByteOffset(n, offset)) catch |err| {
         return @as(i16, @intCast(@intFromEnum(zigErrorToDOMError(err))));
     };
 
@@ -561,7 +605,7 @@ pub export fn dom_range_ispointinrange(range: *DOMRange, node: *DOMNode, offset:
     const r: *Range = @ptrCast(@alignCast(range));
     const n: *Node = @ptrCast(@alignCast(node));
 
-    const result = r.isPointInRange(n, offset) catch {
+    const result = r.isPointInRange(n, toByteOffset(n, offset)) catch {
         return 2; // Error
     };
 
@@ -845,6 +889,48 @@ pub export fn dom_range_tostring(range: *DOMRange) ?[*:0]const u8 {
     return c_str;
 }
 
+/// Callback receiving one piece of a range's string.
+///
+/// `data` points into the Text node's own storage (UTF-8, not
+/// NUL-terminated) and is only valid during the call. The callback must
+/// not mutate the document.
+pub const DOMRangeTextSegment = *const fn (data: [*]const u8, length: u32, user_data: ?*anyopaque) callconv(.c) void;
+
+/// Stream the range's string to a callback without building it.
+///
+/// Calls `segment` once per non-empty piece, in order; the pieces
+/// concatenate to dom_range_tostring()'s result. No memory is allocated,
+/// so bindings can copy the text straight into their own string type.
+///
+/// ## Parameters
+/// - `range`: Range handle
+/// - `segment`: Called with each piece
+/// - `user_data`: Passed through to `segment`
+///
+/// ## Example
+/// ```c
+/// static void append(const char* data, uint32_t length, void* user_data) {
+///     fwrite(data, 1, length, (FILE*)user_data);
+/// }
+///
+/// dom_range_foreach_text(range, append, stdout);
+/// ```
+pub export fn dom_range_foreach_text(range: *DOMRange, segment: DOMRangeTextSegment, user_data: ?*anyopaque) void {
+    const r: *const Range = @ptrCast(@alignCast(range));
+
+    const Sink = struct {
+        callback: DOMRangeTextSegment,
+        user_data: ?*anyopaque,
+
+        fn emit(sink: @This(), data: []const u8) std.mem.Allocator.Error!void {
+            sink.callback(data.ptr, @intCast(data.len), sink.user_data);
+        }
+    };
+
+    // Emitting never allocates
+    r.forEachTextSegment(Sink{ .callback = segment, .user_data = user_data }, Sink.emit) catch unreachable;
+}
+
 /// Free toString string.
 ///
 /// ## Parameters
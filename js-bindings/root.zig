@@ -88,12 +88,20 @@ const range = @import("range.zig");
 const mutationobserver = @import("mutationobserver.zig");
 const treewalker = @import("treewalker.zig");
 const nodeiterator = @import("nodeiterator.zig");
+const elementiterator = @import("elementiterator.zig");
+const closestmemo = @import("closestmemo.zig");
+const nodetable = @import("nodetable.zig");
+const query = @import("query.zig");
+const nodefilter = @import("nodefilter.zig");
 const childnode = @import("childnode.zig");
 const parentnode = @import("parentnode.zig");
 const shadowroot = @import("shadowroot.zig");
 const abortcontroller = @import("abortcontroller.zig");
 const abortsignal = @import("abortsignal.zig");
 const staticrange = @import("staticrange.zig");
+const treebuilder = @import("treebuilder.zig");
+const template = @import("template.zig");
+const customelementregistry = @import("customelementregistry.zig");
 
 // Force export of all C-ABI functions by referencing them
 // This ensures they are included in the static library
@@ -125,10 +133,18 @@ comptime {
     _ = mutationobserver;
     _ = treewalker;
     _ = nodeiterator;
+    _ = elementiterator;
+    _ = closestmemo;
+    _ = nodetable;
+    _ = query;
+    _ = nodefilter;
     _ = childnode;
     _ = parentnode;
     _ = shadowroot;
     _ = abortcontroller;
     _ = abortsignal;
     _ = staticrange;
+    _ = treebuilder;
+    _ = template;
+    _ = customelementregistry;
 }
@@ -57,6 +57,7 @@ const ShadowRoot = dom.ShadowRoot;
 const Element = dom.Element;
 const DOMShadowRoot = types.DOMShadowRoot;
 const DOMElement = types.DOMElement;
+const StaticNodeList = @import("document.zig").StaticNodeList;
 
 // ============================================================================
 // Properties
@@ -228,3 +229,80 @@ pub export fn dom_shadowroot_get_host(shadow: *DOMShadowRoot) *DOMElement {
     const shadow_root: *ShadowRoot = @ptrCast(@alignCast(shadow));
     return @ptrCast(@alignCast(shadow_root.host_element));
 }
+
+// ============================================================================
+// NonElementParentNode / ParentNode Mixins
+// ============================================================================
+
+/// Find the element with the given id in the shadow tree.
+///
+/// ## WebIDL
+/// ```webidl
+/// Element? getElementById(DOMString elementId);
+/// ```
+///
+/// ## Returns
+/// First element in tree order with the id (borrowed reference), or NULL.
+/// Answered from the shadow root's own id index; the document's index
+/// never holds shadow-tree elements.
+pub export fn dom_shadowroot_getelementbyid(shadow: *DOMShadowRoot, element_id: [*:0]const u8) ?*DOMElement {
+    const shadow_root: *ShadowRoot = @ptrCast(@alignCast(shadow));
+    const result = shadow_root.getElementById(types.cStringToZigString(element_id));
+    return if (result) |elem| @ptrCast(elem) else null;
+}
+
+/// Find the first element in the shadow tree matching a CSS selector.
+///
+/// ## WebIDL
+/// ```webidl
+/// Element? querySelector(DOMString selectors);
+/// ```
+///
+/// ## Returns
+/// First matching element in tree order (borrowed reference), or NULL if
+/// none matches or the selector is invalid. Nested shadow trees and the
+/// host's children are not searched.
+pub export fn dom_shadowroot_queryselector(shadow: *DOMShadowRoot, selectors: [*:0]const u8) ?*DOMElement {
+    const shadow_root: *ShadowRoot = @ptrCast(@alignCast(shadow));
+    const result = shadow_root.querySelector(std.heap.c_allocator, types.cStringToZigString(selectors)) catch {
+        return null;
+    };
+    return if (result) |elem| @ptrCast(elem) else null;
+}
+
+/// Find all elements in the shadow tree matching a CSS selector.
+///
+/// ## WebIDL
+/// ```webidl
+/// [NewObject] NodeList querySelectorAll(DOMString selectors);
+/// ```
+///
+/// ## Returns
+/// Static NodeList of matches in tree order (caller must release with
+/// dom_nodelist_static_release), or NULL if none matches or the selector
+/// is invalid
+pub export fn dom_shadowroot_queryselectorall(shadow: *DOMShadowRoot, selectors: [*:0]const u8) ?*types.DOMNodeList {
+    const shadow_root: *ShadowRoot = @ptrCast(@alignCast(shadow));
+    const allocator = std.heap.c_allocator;
+
+    const results = shadow_root.querySelectorAll(allocator, types.cStringToZigString(selectors)) catch {
+        return null;
+    };
+
+    if (results.len == 0) {
+        return null;
+    }
+
+    // The result slice is already owned by c_allocator; hand it to the list
+    const wrapper = allocator.create(StaticNodeList) catch {
+        allocator.free(results);
+        return null;
+    };
+
+    wrapper.* = StaticNodeList{
+        .elements = @constCast(results.ptr),
+        .count = results.len,
+    };
+
+    return @ptrCast(wrapper);
+}
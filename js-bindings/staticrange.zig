@@ -5,6 +5,7 @@
 //!
 //! ## Exported Functions
 //! - dom_staticrange_new() - Create new StaticRange with init dict
+//! - dom_staticrange_new_many() - Create many StaticRanges from a document's pool
 //! - dom_staticrange_get_startcontainer() - Get start container node
 //! - dom_staticrange_get_startoffset() - Get start offset
 //! - dom_staticrange_get_endcontainer() - Get end container node
@@ -18,6 +19,11 @@ const StaticRange = dom.StaticRange;
 const StaticRangeInit = dom.StaticRangeInit;
 const Node = dom.Node;
 const dom_types = @import("dom_types.zig");
+const Document = dom.Document;
+const DOMDocument = dom_types.DOMDocument;
+const zigErrorToDOMError = dom_types.zigErrorToDOMError;
+const toByteOffset = dom.character_data.toByteOffset;
+const toDomOffset = dom.character_data.toDomOffset;
 
 /// Opaque StaticRange handle for C
 pub const DOMStaticRange = opaque {};
@@ -26,7 +32,8 @@ pub const DOMStaticRange = opaque {};
 ///
 /// Creates an immutable range from the provided boundary points.
 /// Unlike Range, StaticRange does NOT track DOM mutations and allows
-/// out-of-bounds offsets.
+/// out-of-bounds offsets. Offsets in character data are UTF-16 code units,
+/// converted against the data as it is now.
 ///
 /// ## Parameters
 /// - `start_container`: Start boundary node
@@ -74,9 +81,9 @@ pub export fn dom_staticrange_new(
 
     const init = StaticRangeInit{
         .start_container = start_container,
-        .start_offset = start_offset,
+        .start_offset = toByteOffset(start_container, start_offset),
         .end_container = end_container,
-        .end_offset = end_offset,
+        .end_offset = toByteOffset(end_container, end_offset),
     };
 
     const range = StaticRange.init(allocator, init) catch {
@@ -86,6 +93,71 @@ pub export fn dom_staticrange_new(
     return @ptrCast(range);
 }
 
+/// Create `count` StaticRanges at once from the document's range pool.
+///
+/// Range `i` spans (`containers[2i]`, `offsets[2i]`) to
+/// (`containers[2i + 1]`, `offsets[2i + 1]`); offsets in character data
+/// are UTF-16 code units, as for dom_staticrange_new(). The ranges come
+/// from contiguous slabs owned by `doc` and are released one by one with
+/// dom_staticrange_release(); until the last is released they keep `doc`
+/// alive.
+///
+/// ## Parameters
+/// - `doc`: Document whose pool the ranges come from
+/// - `containers`: 2 * count boundary nodes (start, end per range)
+/// - `offsets`: 2 * count boundary offsets (start, end per range)
+/// - `count`: Number of ranges
+/// - `out`: Receives the count range handles
+///
+/// ## Returns
+/// 0 on success, or a DOM error code (InvalidNodeTypeError for a
+/// DocumentType or Attr container); on error no range is created.
+///
+/// ## Example
+/// ```c
+/// DOMNode* containers[4] = { text, text, text, text };
+/// uint32_t offsets[4] = { 0, 4, 6, 9 };
+/// DOMStaticRange* ranges[2];
+/// if (dom_staticrange_new_many(doc, containers, offsets, 2, ranges) == 0) {
+///     // ... use ranges ...
+///     dom_staticrange_release(ranges[0]);
+///     dom_staticrange_release(ranges[1]);
+/// }
+/// ```
+pub export fn dom_staticrange_new_many(
+    doc: *DOMDocument,
+    containers: [*]const *Node,
+    offsets: [*]const u32,
+    count: usize,
+    out: [*]*DOMStaticRange,
+) c_int {
+    const document: *Document = @ptrCast(@alignCast(doc));
+    const ranges: [*]*StaticRange = @ptrCast(out);
+
+    // Converted a chunk at a time, so no list of inits is allocated
+    var inits: [256]StaticRangeInit = undefined;
+    var done: usize = 0;
+    while (done < count) {
+        const n = @min(count - done, inits.len);
+        for (inits[0..n], done..) |*init, i| {
+            const start = containers[2 * i];
+            const end = containers[2 * i + 1];
+            init.* = .{
+                .start_container = start,
+                .start_offset = toByteOffset(start, offsets[2 * i]),
+                .end_container = end,
+                .end_offset = toByteOffset(end, offsets[2 * i + 1]),
+            };
+        }
+        document.createStaticRanges(inits[0..n], ranges[done .. done + n]) catch |err| {
+            for (ranges[0..done]) |range| range.deinit(range.allocator);
+            return @intFromEnum(zigErrorToDOMError(err));
+        };
+        done += n;
+    }
+    return 0;
+}
+
 /// Get the start container node.
 ///
 /// ## Parameters
@@ -129,7 +201,7 @@ pub export fn dom_staticrange_get_startcontainer(range: *DOMStaticRange) *Node {
 /// ```
 pub export fn dom_staticrange_get_startoffset(range: *DOMStaticRange) u32 {
     const r: *StaticRange = @ptrCast(@alignCast(range));
-    return r.startOffset();
+    return toDomOffset(r.startContainer(), r.startOffset());
 }
 
 /// Get the end container node.
@@ -175,7 +247,7 @@ pub export fn dom_staticrange_get_endcontainer(range: *DOMStaticRange) *Node {
 /// ```
 pub export fn dom_staticrange_get_endoffset(range: *DOMStaticRange) u32 {
     const r: *StaticRange = @ptrCast(@alignCast(range));
-    return r.endOffset();
+    return toDomOffset(r.endContainer(), r.endOffset());
 }
 
 /// Check if range is collapsed.
@@ -0,0 +1,77 @@
+//! Template C-ABI Bindings
+//!
+//! Precompiled subtrees (see src/template.zig): a subtree is flattened once
+//! and every instance is created in one call, together with the copies of
+//! the nodes marked as holes, so a renderer crosses the ABI once per
+//! instance instead of once per node.
+//!
+//! ## Exported Functions
+//! - dom_template_compile() - Compile a subtree with holes
+//! - dom_template_get_holecount() - Number of holes
+//! - dom_template_instantiate() - Create an instance and its holes
+//! - dom_template_release() - Release a template
+
+const std = @import("std");
+const dom = @import("dom");
+const Node = dom.Node;
+const Document = dom.Document;
+const Template = dom.Template;
+const dom_types = @import("dom_types.zig");
+const DOMNode = dom_types.DOMNode;
+const DOMDocument = dom_types.DOMDocument;
+const DOMTemplate = dom_types.DOMTemplate;
+
+/// Compile the subtree of `root` into a template.
+///
+/// ## Parameters
+/// - `root`: Element or DocumentFragment to compile
+/// - `holes`: Nodes of the subtree whose copies instances return (may be
+///   null when count is 0)
+/// - `hole_count`: Number of holes
+///
+/// ## Returns
+/// Template handle, or null if the root or a descendant is not an element,
+/// Text or Comment node (the root may be a fragment), a hole is outside
+/// the subtree, or allocation fails
+///
+/// ## Memory
+/// Caller must call `dom_template_release()` when done
+pub export fn dom_template_compile(handle: *DOMNode, holes: ?[*]const *DOMNode, hole_count: u32) ?*DOMTemplate {
+    const root: *Node = @ptrCast(@alignCast(handle));
+    const hole_nodes: []const *const Node = if (holes) |h| @ptrCast(h[0..hole_count]) else &.{};
+    const template = Template.compile(root.allocator, root, hole_nodes) catch return null;
+    return @ptrCast(template);
+}
+
+/// Get the number of holes (the size `holes_out` needs).
+pub export fn dom_template_get_holecount(handle: *DOMTemplate) u32 {
+    const template: *const Template = @ptrCast(@alignCast(handle));
+    return template.hole_count;
+}
+
+/// Create an instance of the template in a document.
+///
+/// ## Parameters
+/// - `doc`: Document that owns the new nodes
+/// - `holes_out`: Receives the copy of each hole, in compile order (needs
+///   dom_template_get_holecount() entries; may be null when there are none)
+///
+/// ## Returns
+/// Root of the instance, or null on allocation failure
+///
+/// ## Memory
+/// Caller must call `dom_node_release()` on the root when done; holes are
+/// owned by the instance and are not released separately
+pub export fn dom_template_instantiate(handle: *DOMTemplate, doc_handle: *DOMDocument, holes_out: ?[*]*DOMNode) ?*DOMNode {
+    const template: *const Template = @ptrCast(@alignCast(handle));
+    const doc: *Document = @ptrCast(@alignCast(doc_handle));
+    const out: []*Node = if (holes_out) |h| @ptrCast(h[0..template.hole_count]) else &.{};
+    const root = template.instantiate(doc, out) catch return null;
+    return @ptrCast(root);
+}
+
+/// Release a template (instances are independent of it).
+pub export fn dom_template_release(handle: *DOMTemplate) void {
+    const template: *Template = @ptrCast(@alignCast(handle));
+    template.deinit();
+}
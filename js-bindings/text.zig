@@ -26,11 +26,13 @@
 //!
 //! Spec reference: https://dom.spec.whatwg.org/#text (WebIDL: dom.idl:439-443)
 //!
-//! ## Exported Functions (4 total)
+//! ## Exported Functions (5 total)
 //!
 //! ### Text-Specific Methods
 //! - `dom_text_splittext()` - Split text node at offset
-//! - `dom_text_get_wholetext()` - Get concatenated text of adjacent text nodes
+//! - `dom_text_get_wholetext_into()` - Write the concatenated text of adjacent
+//!   text nodes into a caller buffer
+//! - `dom_text_get_wholetext()` - Same, as an allocated string
 //!
 //! ### Memory Management
 //! - `dom_text_addref()` - Increment reference count
@@ -153,21 +155,44 @@ pub export fn dom_text_get_wholetext(text: *DOMText) [*:0]const u8 {
     const text_node: *const Text = @ptrCast(@alignCast(text));
     const allocator = std.heap.c_allocator;
 
-    const whole = text_node.wholeText(allocator) catch return "";
-
     // Allocate null-terminated C string
-    const c_str = allocator.allocSentinel(u8, whole.len, 0) catch {
-        allocator.free(whole);
-        return "";
-    };
-
-    @memcpy(c_str, whole);
-    allocator.free(whole);
+    const c_str = allocator.allocSentinel(u8, text_node.wholeTextLength(), 0) catch return "";
+    _ = text_node.writeWholeText(c_str);
 
     // WARNING: Caller must free with dom_text_free_wholetext()
     return c_str;
 }
 
+/// Writes wholeText into a caller-provided buffer (no allocation).
+///
+/// ## Parameters
+/// - `text`: Text node
+/// - `buffer`: Receives the UTF-8 bytes (not NUL-terminated); may be NULL
+///   when `capacity` is 0
+/// - `capacity`: Size of `buffer` in bytes
+///
+/// ## Returns
+/// The length of wholeText in bytes. The text is only written if it fits
+/// (length <= capacity); otherwise call again with a buffer that large.
+///
+/// ## Example
+/// ```c
+/// char stack[256];
+/// size_t length = dom_text_get_wholetext_into(text, stack, sizeof(stack));
+/// if (length > sizeof(stack)) {
+///     char* heap = malloc(length);
+///     dom_text_get_wholetext_into(text, heap, length);
+/// }
+/// ```
+pub export fn dom_text_get_wholetext_into(text: *DOMText, buffer: ?[*]u8, capacity: usize) usize {
+    const text_node: *const Text = @ptrCast(@alignCast(text));
+    const length = text_node.wholeTextLength();
+    if (length <= capacity and length > 0) {
+        _ = text_node.writeWholeText(buffer.?[0..length]);
+    }
+    return length;
+}
+
 /// Free wholeText string.
 ///
 /// ## Parameters
@@ -0,0 +1,153 @@
+//! TreeBuilder C-ABI Bindings
+//!
+//! Push-style tree construction: nodes are created and linked in document
+//! order into a private DocumentFragment, with no per-node insertion
+//! steps, and the finished fragment is inserted by the caller in one step.
+//! dom_builder_write() runs a whole chunk of encoded instructions (see
+//! src/tree_builder.zig) per call, so a renderer crosses the ABI once per
+//! chunk instead of once per node.
+//!
+//! ## Exported Functions
+//! - dom_builder_new() - Create a builder for a document
+//! - dom_builder_open() - Open an element with attributes
+//! - dom_builder_text() - Append text to the current element
+//! - dom_builder_close() - Close the current element
+//! - dom_builder_write() - Run a chunk of encoded instructions
+//! - dom_builder_finish() - Take the built fragment
+//! - dom_builder_release() - Release the builder
+
+const std = @import("std");
+const dom = @import("dom");
+const Document = dom.Document;
+const TreeBuilder = dom.TreeBuilder;
+const dom_types = @import("dom_types.zig");
+const DOMDocument = dom_types.DOMDocument;
+const DOMDocumentFragment = dom_types.DOMDocumentFragment;
+const DOMTreeBuilder = dom_types.DOMTreeBuilder;
+const zigErrorToDOMError = dom_types.zigErrorToDOMError;
+
+/// One attribute for dom_builder_open(), as null-terminated UTF-8 strings.
+pub const DOMBuilderAttribute = extern struct {
+    name: [*:0]const u8,
+    value: [*:0]const u8,
+};
+
+/// Create a tree builder for a document.
+///
+/// The builder holds a reference on the document until it is released.
+///
+/// ## Returns
+/// Builder handle, or null on allocation failure
+///
+/// ## Memory
+/// Caller must call `dom_builder_release()` when done
+pub export fn dom_builder_new(handle: *DOMDocument) ?*DOMTreeBuilder {
+    const doc: *Document = @ptrCast(@alignCast(handle));
+    const builder = doc.prototype.allocator.create(TreeBuilder) catch return null;
+    builder.* = TreeBuilder.init(doc);
+    doc.acquire();
+    return @ptrCast(builder);
+}
+
+/// Open an element as the last child of the current element.
+///
+/// ## Parameters
+/// - `tag_name`: Tag name
+/// - `attributes`: Attributes to set (may be null when count is 0)
+/// - `count`: Number of attributes
+///
+/// ## Returns
+/// 0 on success, error code on failure
+pub export fn dom_builder_open(
+    handle: *DOMTreeBuilder,
+    tag_name: [*:0]const u8,
+    attributes: ?[*]const DOMBuilderAttribute,
+    count: u32,
+) c_int {
+    const builder: *TreeBuilder = @ptrCast(@alignCast(handle));
+
+    var buffer: [16]dom.tree_builder.Attribute = undefined;
+    const attrs = if (attributes) |a| a[0..count] else &[_]DOMBuilderAttribute{};
+    if (attrs.len <= buffer.len) {
+        for (attrs, buffer[0..attrs.len]) |attr, *slot| {
+            slot.* = .{ .name = std.mem.span(attr.name), .value = std.mem.span(attr.value) };
+        }
+        builder.open(std.mem.span(tag_name), buffer[0..attrs.len]) catch |err| {
+            return @intFromEnum(zigErrorToDOMError(err));
+        };
+        return 0;
+    }
+
+    const converted = builder.document.prototype.allocator.alloc(dom.tree_builder.Attribute, attrs.len) catch |err| {
+        return @intFromEnum(zigErrorToDOMError(err));
+    };
+    defer builder.document.prototype.allocator.free(converted);
+    for (attrs, converted) |attr, *slot| {
+        slot.* = .{ .name = std.mem.span(attr.name), .value = std.mem.span(attr.value) };
+    }
+    builder.open(std.mem.span(tag_name), converted) catch |err| {
+        return @intFromEnum(zigErrorToDOMError(err));
+    };
+    return 0;
+}
+
+/// Append UTF-8 text to the current element (joins directly preceding text).
+///
+/// ## Returns
+/// 0 on success, error code on failure
+pub export fn dom_builder_text(handle: *DOMTreeBuilder, data: [*]const u8, length: u32) c_int {
+    const builder: *TreeBuilder = @ptrCast(@alignCast(handle));
+    builder.text(data[0..length]) catch |err| {
+        return @intFromEnum(zigErrorToDOMError(err));
+    };
+    return 0;
+}
+
+/// Close the current element.
+///
+/// ## Returns
+/// 0 on success, DOM_ERROR_INVALID_STATE if no element is open
+pub export fn dom_builder_close(handle: *DOMTreeBuilder) c_int {
+    const builder: *TreeBuilder = @ptrCast(@alignCast(handle));
+    builder.close() catch |err| {
+        return @intFromEnum(zigErrorToDOMError(err));
+    };
+    return 0;
+}
+
+/// Run a chunk of encoded builder instructions.
+///
+/// ## Returns
+/// 0 on success, DOM_ERROR_SYNTAX for a malformed chunk (the instructions
+/// before the bad one have run), or the error of the failing instruction
+pub export fn dom_builder_write(handle: *DOMTreeBuilder, instructions: [*]const u8, length: usize) c_int {
+    const builder: *TreeBuilder = @ptrCast(@alignCast(handle));
+    builder.write(instructions[0..length]) catch |err| {
+        return @intFromEnum(zigErrorToDOMError(err));
+    };
+    return 0;
+}
+
+/// Close every open element and take the built fragment.
+///
+/// The builder can be used again for a new fragment afterwards.
+///
+/// ## Returns
+/// The fragment (possibly empty), or null on allocation failure
+///
+/// ## Memory
+/// Caller must call `dom_documentfragment_release()` when done
+pub export fn dom_builder_finish(handle: *DOMTreeBuilder) ?*DOMDocumentFragment {
+    const builder: *TreeBuilder = @ptrCast(@alignCast(handle));
+    const fragment = builder.finish() catch return null;
+    return @ptrCast(fragment);
+}
+
+/// Release a builder, any unfinished tree and its document reference.
+pub export fn dom_builder_release(handle: *DOMTreeBuilder) void {
+    const builder: *TreeBuilder = @ptrCast(@alignCast(handle));
+    const doc = builder.document;
+    builder.deinit();
+    doc.prototype.allocator.destroy(builder);
+    doc.release();
+}
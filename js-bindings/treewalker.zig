@@ -146,7 +146,7 @@ pub export fn dom_treewalker_get_currentnode(walker: *const DOMTreeWalker) *DOMN
 pub export fn dom_treewalker_set_currentnode(walker: *DOMTreeWalker, node: *DOMNode) void {
     const tw: *TreeWalker = @ptrCast(@alignCast(walker));
     const n: *Node = @ptrCast(@alignCast(node));
-    tw.current_node = n;
+    tw.setCurrentNode(n);
 }
 
 // ============================================================================
@@ -300,11 +300,33 @@ pub export fn dom_treewalker_nextnode(walker: *DOMTreeWalker) ?*DOMNode {
     return if (tw.nextNode()) |node| @ptrCast(node) else null;
 }
 
+/// Navigate forward by up to `max` nodes in one call (non-standard).
+///
+/// Equivalent to calling dom_treewalker_nextnode() until it returns NULL or
+/// `max` nodes have been returned; currentNode ends on the last one.
+///
+/// ## Parameters
+/// - `walker`: TreeWalker handle
+/// - `out`: Buffer receiving the nodes, in tree order
+/// - `max`: Capacity of `out`
+///
+/// ## Returns
+/// Number of nodes written (less than `max` once the walk is exhausted)
+pub export fn dom_treewalker_nextnodes(walker: *DOMTreeWalker, out: [*]*DOMNode, max: u32) u32 {
+    const tw: *TreeWalker = @ptrCast(@alignCast(walker));
+    var count: u32 = 0;
+    while (count < max) : (count += 1) {
+        const node = tw.nextNode() orelse break;
+        out[count] = @ptrCast(node);
+    }
+    return count;
+}
+
 // ============================================================================
 // TreeWalker Lifecycle
 // ============================================================================
 
-/// Release a TreeWalker and free its memory.
+/// Release a TreeWalker and its references to its root and current node.
 ///
 /// ## Parameters
 /// - `walker`: TreeWalker handle
@@ -54,20 +54,25 @@
 //! // Useful for immediately cancelled operations
 //! ```
 //!
-//! ### Timeout Signal (NOT YET IMPLEMENTED)
+//! ### Timeout Signal
 //!
-//! **Status**: Waiting for Zig async/await support
+//! `AbortSignal.timeout(milliseconds)` needs the embedder's event loop, which
+//! a generic DOM library does not own. The embedder provides it as a
+//! `TimerHost` (a monotonic clock plus ONE timer it can arm and disarm) and
+//! creates a `TimeoutQueue` over it; every timeout signal shares that queue
+//! and its single timer (see `abort_timeout.zig`).
+//! ```zig
+//! var queue = TimeoutQueue.init(allocator, host);
+//! defer queue.deinit();
 //!
-//! The `AbortSignal.timeout(milliseconds)` static method is specified in WHATWG DOM
-//! but requires timer/event loop integration from the HTML spec. This cannot be
-//! implemented in a generic DOM library without:
-//! 1. Forcing a specific event loop implementation on users (breaks generality)
-//! 2. Using std.time.Timer with threads (adds complexity, not zero-cost)
-//! 3. Requiring user-provided timer callbacks (breaks spec API)
+//! const signal = try AbortSignal.timeout(allocator, &queue, 1000); // 1 second
+//! defer signal.release();
 //!
-//! The most appropriate solution is to wait for Zig's async/await to stabilize,
-//! which will provide language-level support for timeout/timer operations without
-//! forcing implementation details on library users.
+//! // When the host timer fires, the embedder calls:
+//! try queue.run();
+//! // After 1 second, signal.aborted becomes true
+//! // and "abort" event fires with TimeoutError
+//! ```
 //!
 //! **Spec Reference**: https://dom.spec.whatwg.org/#dom-abortsignal-timeout
 //!
@@ -77,15 +82,6 @@
 //! static AbortSignal timeout([EnforceRange] unsigned long long milliseconds);
 //! ```
 //!
-//! **Future API** (when async/await is available):
-//! ```zig
-//! const signal = try AbortSignal.timeout(allocator, 1000); // 1 second
-//! defer signal.release();
-//!
-//! // After 1 second, signal.aborted becomes true
-//! // and "abort" event fires with TimeoutError
-//! ```
-//!
 //! ## AbortSignal Structure
 //!
 //! AbortSignal extends EventTarget with abort state and algorithms:
@@ -99,7 +95,7 @@
 //! - Abort algorithms run before abort event fires
 //! - Can be created pre-aborted (AbortSignal.abort())
 //! - Supports composite signals (AbortSignal.any())
-//! - Timeout-based abort (AbortSignal.timeout()) - NOT YET IMPLEMENTED (waiting for Zig async/await)
+//! - Timeout-based abort (AbortSignal.timeout()) through the embedder's timer
 //!
 //! ## Memory Management
 //!
@@ -153,19 +149,17 @@
 //! ### Composite Signal Pattern (ANY of multiple signals)
 //! ```zig
 //! fn fetchWithTimeout(controller: *AbortController, timeout_ms: u64) !void {
-//!     // Create manual timeout signal (user-managed)
-//!     const timeout_controller = try AbortController.init(allocator);
-//!     defer timeout_controller.deinit();
+//!     // Timeout signal on the embedder's timer queue
+//!     const timeout_signal = try AbortSignal.timeout(allocator, &queue, timeout_ms);
+//!     defer timeout_signal.release();
 //!
 //!     // Composite: abort on EITHER user cancel OR timeout
 //!     const composite = try AbortSignal.any(allocator, &[_]*AbortSignal{
 //!         controller.signal,
-//!         timeout_controller.signal,
+//!         timeout_signal,
 //!     });
 //!     defer composite.release();
 //!
-//!     // User triggers their own timeout logic
-//!     // (AbortSignal.timeout() not yet available - see documentation above)
 //!     return fetchWithAbort(url, composite);
 //! }
 //! ```
@@ -248,10 +242,9 @@
 //!   return zig.abortsignal_abort(reason);
 //! };
 //!
-//! // Create signal that aborts after timeout (NOT YET IMPLEMENTED)
-//! // Waiting for Zig async/await support
+//! // Create signal that aborts after timeout (on the embedder's timer)
 //! AbortSignal.timeout = function(milliseconds) {
-//!   throw new Error("AbortSignal.timeout() not yet implemented in Zig DOM library");
+//!   return zig.abortsignal_timeout(milliseconds);
 //! };
 //!
 //! // Create composite signal from multiple signals (future)
@@ -329,7 +322,8 @@
 //! const controller2 = new AbortController();
 //! const compositeSignal = AbortSignal.any([signal, controller2.signal]);
 //!
-//! // Note: AbortSignal.timeout() not yet implemented (waiting for Zig async/await)
+//! // Timeout signal (aborts with a TimeoutError)
+//! const timeoutSignal = AbortSignal.timeout(5000);
 //! ```
 //!
 //! See `JS_BINDINGS.md` for complete binding patterns and memory management.
@@ -340,11 +334,11 @@
 //! - aborted flag is immutable once set (never goes from true → false)
 //! - Abort algorithms run BEFORE abort event fires
 //! - reason defaults to DOMException("AbortError") if not specified
-//! - AbortSignal.timeout() NOT YET IMPLEMENTED (waiting for Zig async/await)
-//!   - Spec requires HTML event loop integration
-//!   - Cannot implement in generic DOM library without forcing event loop choice
-//!   - Will be added when Zig async/await stabilizes
+//! - AbortSignal.timeout() runs on a `TimeoutQueue` over the embedder's
+//!   `TimerHost`: all pending timeouts share one host timer
 //! - SignalRareData stores event listeners and abort algorithms
+//! - AbortSignal.any() links are weak in both directions and unlink in O(1),
+//!   so composites that never abort cost their sources nothing once released
 //! - Not reference counted (use explicit deinit())
 //! - Thread-safety not guaranteed (single-threaded by default)
 
@@ -354,6 +348,8 @@ const EventTarget = @import("event_target.zig").EventTarget;
 const EventTargetVTable = @import("event_target.zig").EventTargetVTable;
 const EventTargetMixin = @import("event_target.zig").EventTargetMixin;
 const SignalRareData = @import("abort_signal_rare_data.zig").SignalRareData;
+const SignalLink = @import("abort_signal_rare_data.zig").SignalLink;
+const TimeoutQueue = @import("abort_timeout.zig").TimeoutQueue;
 const Event = @import("event.zig").Event;
 
 /// Minimal DOMException representation for abort reasons.
@@ -463,7 +459,7 @@ pub const AbortAlgorithm = struct {
 /// - Reference counted (acquire/release pattern)
 /// - Initial ref_count = 1 (caller owns)
 /// - MUST call release() when done
-/// - Dependent/source signals: raw pointers (NOT strong refs)
+/// - Dependent/source signals: weak links (NOT strong refs), unlinked in O(1)
 ///
 /// ## Example
 /// ```zig
@@ -631,10 +627,8 @@ pub const AbortSignal = struct {
     /// Do NOT call directly - use release() instead.
     ///
     /// ## Cleanup
-    /// - Frees any remaining abort algorithms
-    /// - Removes self from all source signal's dependent lists
-    /// - Clears dependent signal list (doesn't release dependents)
-    /// - Frees rare data (if allocated)
+    /// - Unlinks self from its source and dependent signals (O(1) each)
+    /// - Frees rare data (if allocated), including unrun abort algorithms
     /// - Frees the signal itself
     fn deinit(self: *AbortSignal) void {
         // Step 1: Free owned abort reason (DOMException)
@@ -645,114 +639,107 @@ pub const AbortSignal = struct {
             }
         }
 
+        var reason_source: ?*AbortSignal = null;
         if (self.rare_data) |rare| {
-            // Step 2: Free any remaining abort algorithms
-            for (rare.abort_algorithms.items) |algorithm_ptr| {
-                const algorithm = @as(*AbortAlgorithm, @ptrCast(@alignCast(algorithm_ptr)));
-                self.allocator.destroy(algorithm);
-            }
-
-            // Step 3: Remove self from all source signals' dependent lists
-            // This prevents dangling pointers when this signal is destroyed
-            if (rare.source_signals) |sources| {
-                for (sources.items) |source_ptr| {
-                    const source: *AbortSignal = @ptrCast(@alignCast(source_ptr));
-                    if (source.rare_data) |source_rare| {
-                        if (source_rare.dependent_signals) |*deps| {
-                            removeSignalFromList(deps, self);
-                        }
-                    }
-                }
-            }
+            // Step 2: Drop the links to and from other signals, so neither
+            // side is left with a dangling pointer
+            self.unlinkAll();
 
-            // Step 4: Clean up rare data (this deinit()s the ArrayLists)
+            // Step 3: Clean up rare data
+            if (rare.reason_source) |source| reason_source = @ptrCast(@alignCast(source));
             rare.deinit();
             self.allocator.destroy(rare);
         }
 
-        // Step 5: Destroy self
+        // Step 4: Destroy self, then drop the signal owning our reason
         self.allocator.destroy(self);
+        if (reason_source) |source| source.release();
     }
 
-    /// Helper: Remove signal from ArrayList of signals.
+    /// Links this dependent signal to `source` (both directions).
     ///
-    /// Used to remove dependent signals from source signal lists during cleanup.
-    ///
-    /// ## Parameters
-    /// - `list`: List to remove from
-    /// - `signal`: Signal to remove
-    fn removeSignalFromList(list: *std.ArrayList(*anyopaque), signal: *AbortSignal) void {
-        const signal_ptr: *anyopaque = @ptrCast(signal);
-        for (list.items, 0..) |item, i| {
-            if (item == signal_ptr) {
-                _ = list.orderedRemove(i);
-                return;
-            }
-        }
-    }
-
-    /// Adds a source signal to this dependent signal.
-    ///
-    /// Used internally by createDependentAbortSignal() to link signals.
-    /// The source signal is NOT acquired (raw pointer only).
+    /// Used internally by createDependentAbortSignal(). Neither signal is
+    /// acquired: the link is weak, and whichever signal is destroyed (or
+    /// aborts) first unlinks it from the other.
     ///
     /// ## Parameters
     /// - `source`: Source signal to add
     ///
     /// ## Errors
-    /// - `error.OutOfMemory`: Failed to allocate list
+    /// - `error.OutOfMemory`: Failed to allocate the link
     ///
     /// ## Spec Compliance
-    /// Per spec, source_signals is a "weak set" - prevents duplicate signals.
+    /// Per spec, source signals are a "weak set" - linking the same source
+    /// twice is a no-op. The duplicate check scans this signal's own
+    /// sources, never the source's dependents.
     pub fn addSourceSignal(self: *AbortSignal, source: *AbortSignal) !void {
         const rare = try self.ensureRareData();
-
-        // Ensure source_signals list exists
-        if (rare.source_signals == null) {
-            rare.source_signals = std.ArrayList(*anyopaque){};
-        }
-
-        // Check for duplicates (spec says "set", not "list")
         const source_ptr: *anyopaque = @ptrCast(source);
-        for (rare.source_signals.?.items) |item| {
-            if (item == source_ptr) {
-                return; // Already exists, don't add duplicate
-            }
+        for (rare.source_links.items) |link| {
+            if (link.source == source_ptr) return;
         }
 
-        try rare.source_signals.?.append(self.allocator, source_ptr);
+        const source_rare = try source.ensureRareData();
+        try rare.source_links.ensureUnusedCapacity(self.allocator, 1);
+        const link = try self.allocator.create(SignalLink);
+        link.* = .{
+            .source = source_ptr,
+            .dependent = @ptrCast(self),
+            .prev = source_rare.last_dependent,
+            .source_index = @intCast(rare.source_links.items.len),
+        };
+        if (source_rare.last_dependent) |last| last.next = link else source_rare.first_dependent = link;
+        source_rare.last_dependent = link;
+        source_rare.dependent_count += 1;
+        rare.source_links.appendAssumeCapacity(link);
     }
 
-    /// Adds a dependent signal to this source signal.
+    /// Links `dependent` to this source signal (both directions).
     ///
-    /// Used internally by createDependentAbortSignal() to link signals.
-    /// The dependent signal is NOT acquired (raw pointer only).
-    ///
-    /// ## Parameters
-    /// - `dependent`: Dependent signal to add
+    /// Same as `dependent.addSourceSignal(self)`.
     ///
     /// ## Errors
-    /// - `error.OutOfMemory`: Failed to allocate list
-    ///
-    /// ## Spec Compliance
-    /// Per spec, dependent_signals is a "weak set" - prevents duplicate signals.
+    /// - `error.OutOfMemory`: Failed to allocate the link
     pub fn addDependentSignal(self: *AbortSignal, dependent: *AbortSignal) !void {
-        const rare = try self.ensureRareData();
+        return dependent.addSourceSignal(self);
+    }
 
-        // Ensure dependent_signals list exists
-        if (rare.dependent_signals == null) {
-            rare.dependent_signals = std.ArrayList(*anyopaque){};
-        }
+    /// Number of signals this dependent signal follows.
+    pub fn sourceSignalCount(self: *const AbortSignal) usize {
+        const rare = self.rare_data orelse return 0;
+        return rare.source_links.items.len;
+    }
 
-        // Check for duplicates (spec says "set", not "list")
-        const dependent_ptr: *anyopaque = @ptrCast(dependent);
-        for (rare.dependent_signals.?.items) |item| {
-            if (item == dependent_ptr) {
-                return; // Already exists, don't add duplicate
-            }
-        }
+    /// Number of signals that depend on this one.
+    pub fn dependentSignalCount(self: *const AbortSignal) usize {
+        const rare = self.rare_data orelse return 0;
+        return rare.dependent_count;
+    }
 
-        try rare.dependent_signals.?.append(self.allocator, dependent_ptr);
+    /// Drops every link of this signal, as a source and as a dependent.
+    fn unlinkAll(self: *AbortSignal) void {
+        const rare = self.rare_data orelse return;
+        while (rare.first_dependent) |link| destroyLink(link);
+        while (rare.source_links.getLastOrNull()) |link| destroyLink(link);
+    }
+
+    /// Unlinks `link` from its source's dependent list and its dependent's
+    /// source array (O(1) both), then frees it.
+    fn destroyLink(link: *SignalLink) void {
+        const source: *AbortSignal = @ptrCast(@alignCast(link.source));
+        const dependent: *AbortSignal = @ptrCast(@alignCast(link.dependent));
+
+        const source_rare = source.rare_data.?;
+        if (link.prev) |prev| prev.next = link.next else source_rare.first_dependent = link.next;
+        if (link.next) |next| next.prev = link.prev else source_rare.last_dependent = link.prev;
+        source_rare.dependent_count -= 1;
+
+        const sources = &dependent.rare_data.?.source_links;
+        _ = sources.swapRemove(link.source_index);
+        if (link.source_index < sources.items.len) {
+            sources.items[link.source_index].source_index = link.source_index;
+        }
+        dependent.allocator.destroy(link);
     }
 
     /// Returns whether the signal has been aborted.
@@ -903,6 +890,18 @@ pub const AbortSignal = struct {
         // Step 1: Already aborted check (idempotent)
         if (self.isAborted()) return;
 
+        // Abort steps run callbacks, which may drop the last reference
+        self.acquire();
+        defer self.release();
+
+        // Reserve the list before any state changes
+        var dependents_to_abort = std.ArrayList(*AbortSignal){};
+        defer {
+            for (dependents_to_abort.items) |dependent| dependent.release();
+            dependents_to_abort.deinit(self.allocator);
+        }
+        try dependents_to_abort.ensureTotalCapacity(self.allocator, self.dependentSignalCount());
+
         // Step 2: Set abort reason
         // Per spec: "otherwise to a new 'AbortError' DOMException"
         if (reason) |r| {
@@ -920,23 +919,28 @@ pub const AbortSignal = struct {
         }
 
         // Step 3-4: Collect dependents to abort
-        var dependents_to_abort = std.ArrayList(*AbortSignal){};
-        defer dependents_to_abort.deinit(self.allocator);
-
         if (self.rare_data) |rare| {
-            if (rare.dependent_signals) |deps| {
-                for (deps.items) |dependent_ptr| {
-                    const dependent: *AbortSignal = @ptrCast(@alignCast(dependent_ptr));
-                    if (!dependent.isAborted()) {
-                        // Set dependent's abort reason to ours (borrowed reference)
-                        dependent.abort_reason = self.abort_reason;
-                        dependent.owns_abort_reason = false; // Dependent doesn't own it
-                        try dependents_to_abort.append(self.allocator, dependent);
-                    }
+            var link = rare.first_dependent;
+            while (link) |l| : (link = l.next) {
+                const dependent: *AbortSignal = @ptrCast(@alignCast(l.dependent));
+                if (!dependent.isAborted()) {
+                    // Set dependent's abort reason to ours (borrowed reference);
+                    // the dependent keeps us alive for as long as it borrows it
+                    dependent.abort_reason = self.abort_reason;
+                    dependent.owns_abort_reason = false; // Dependent doesn't own it
+                    dependent.rare_data.?.reason_source = @ptrCast(self);
+                    self.acquire();
+                    dependent.acquire();
+                    dependents_to_abort.appendAssumeCapacity(dependent);
                 }
             }
         }
 
+        // Aborted signals never abort again: drop their links now, which
+        // also takes the dependents off their other (long-lived) sources
+        self.unlinkAll();
+        for (dependents_to_abort.items) |dependent| dependent.unlinkAll();
+
         // Step 5: Run abort steps for self
         try runAbortSteps(self);
 
@@ -962,18 +966,13 @@ pub const AbortSignal = struct {
     /// ## Spec Reference
     /// - Algorithm: https://dom.spec.whatwg.org/#abortsignal-abort-steps
     fn runAbortSteps(signal: *AbortSignal) !void {
-        // Step 1-2: Run and clear abort algorithms
+        // Step 1-2: Run and clear abort algorithms, taking each off the
+        // set before it runs (it may remove others)
         if (signal.rare_data) |rare| {
-            for (rare.abort_algorithms.items) |algorithm_ptr| {
-                // Cast from anyopaque back to AbortAlgorithm struct
-                const algorithm = @as(*AbortAlgorithm, @ptrCast(@alignCast(algorithm_ptr)));
-                algorithm.callback(signal, algorithm.context);
-
-                // Free the allocated algorithm struct
-                signal.allocator.destroy(algorithm);
+            while (rare.abort_algorithms.takeFirst(signal.allocator)) |entry| {
+                const callback: *const fn (*AbortSignal, *anyopaque) void = @ptrCast(@alignCast(entry.callback));
+                callback(signal, entry.context);
             }
-            // Clear algorithms (makes abort idempotent)
-            rare.abort_algorithms.clearRetainingCapacity();
         }
 
         // Step 3: Fire abort event
@@ -1030,22 +1029,9 @@ pub const AbortSignal = struct {
 
         const rare = try self.ensureRareData();
 
-        // Step 2: Check for duplicates (spec says "set", not "list")
-        // Duplicate means same callback + context pair
-        for (rare.abort_algorithms.items) |item| {
-            const existing = @as(*AbortAlgorithm, @ptrCast(@alignCast(item)));
-            if (existing.callback == algorithm.callback and
-                existing.context == algorithm.context)
-            {
-                // Already exists, don't add duplicate
-                return;
-            }
-        }
-
-        // Step 3: Allocate and store algorithm struct
-        const algo_copy = try self.allocator.create(AbortAlgorithm);
-        algo_copy.* = algorithm;
-        try rare.abort_algorithms.append(self.allocator, @ptrCast(algo_copy));
+        // Step 2: Append unless the same callback + context pair is
+        // already there (spec says "set", not "list"); O(1) either way
+        try rare.abort_algorithms.add(self.allocator, @ptrCast(algorithm.callback), algorithm.context);
     }
 
     /// Removes an algorithm from the signal's abort algorithms.
@@ -1059,6 +1045,8 @@ pub const AbortSignal = struct {
     /// ## Note
     /// Matches by BOTH callback and context pointers. This enables removing
     /// specific algorithm instances when multiple algorithms share the same callback.
+    /// Removal is O(1), so operations that complete without aborting can
+    /// take their algorithm off a long-lived signal cheaply.
     ///
     /// ## Example
     /// ```zig
@@ -1070,15 +1058,7 @@ pub const AbortSignal = struct {
         context: *anyopaque,
     ) void {
         if (self.rare_data) |rare| {
-            for (rare.abort_algorithms.items, 0..) |item, i| {
-                const algo = @as(*AbortAlgorithm, @ptrCast(@alignCast(item)));
-                if (algo.callback == callback and algo.context == context) {
-                    _ = rare.abort_algorithms.orderedRemove(i);
-                    // Free the algorithm struct
-                    self.allocator.destroy(algo);
-                    return;
-                }
-            }
+            _ = rare.abort_algorithms.remove(self.allocator, @ptrCast(callback), context);
         }
     }
 
@@ -1141,6 +1121,54 @@ pub const AbortSignal = struct {
         return signal;
     }
 
+    /// Creates a signal that aborts after a timeout.
+    ///
+    /// Implements WHATWG DOM AbortSignal.timeout() static method per §3.2.
+    ///
+    /// ## WebIDL
+    /// ```webidl
+    /// [NewObject] static AbortSignal timeout([EnforceRange] unsigned long long milliseconds);
+    /// ```
+    ///
+    /// ## Algorithm
+    /// Per spec:
+    /// 1. Let signal be a new AbortSignal
+    /// 2. Run steps after a timeout of `milliseconds`: signal abort given
+    ///    signal and a new "TimeoutError" DOMException
+    /// 3. Return signal
+    ///
+    /// The timeout runs on `queue`, i.e. on the embedder's timer.
+    ///
+    /// ## Parameters
+    /// - `allocator`: Memory allocator
+    /// - `queue`: Timer queue of the embedder's event loop
+    /// - `milliseconds`: Delay before the signal aborts
+    ///
+    /// ## Returns
+    /// New signal (not aborted yet)
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to allocate signal or queue entry
+    ///
+    /// ## Memory Management
+    /// - Returned signal has ref_count = 1 (caller MUST release)
+    /// - The queue holds its own reference until the timeout fires
+    ///
+    /// ## Example
+    /// ```zig
+    /// const signal = try AbortSignal.timeout(allocator, &queue, 5000);
+    /// defer signal.release();
+    /// ```
+    ///
+    /// ## Spec Reference
+    /// - Algorithm: https://dom.spec.whatwg.org/#dom-abortsignal-timeout
+    pub fn timeout(allocator: Allocator, queue: *TimeoutQueue, milliseconds: u64) !*AbortSignal {
+        const signal = try init(allocator);
+        errdefer signal.release();
+        try queue.add(signal, milliseconds);
+        return signal;
+    }
+
     /// Creates a dependent signal that aborts when ANY source signal aborts.
     ///
     /// Implements WHATWG DOM AbortSignal.any() static method per §3.2.2.
@@ -1166,9 +1194,9 @@ pub const AbortSignal = struct {
     ///
     /// ## Memory Management
     /// - Returned signal has ref_count = 1 (caller MUST release)
-    /// - Source signals are NOT acquired (raw pointers only)
-    /// - Caller MUST ensure source signals outlive dependent signal
-    /// - Dependent signal cleans up links in deinit()
+    /// - Source signals are NOT acquired (weak links)
+    /// - Either side may be destroyed first; it unlinks from the other in O(1)
+    /// - All links are dropped once the signal aborts
     ///
     /// ## Example
     /// ```zig
@@ -1273,30 +1301,24 @@ pub const AbortSignal = struct {
             if (!signal.dependent) {
                 // 4a: Direct source signal (not dependent)
 
-                // i. Append signal to resultSignal's source signals
+                // i-ii. Append signal to resultSignal's source signals and
+                // resultSignal to signal's dependent signals (one link)
                 try result.addSourceSignal(signal);
-
-                // ii. Append resultSignal to signal's dependent signals
-                try signal.addDependentSignal(result);
             } else {
                 // 4b: Source signal is itself dependent - flatten
 
-                // Must have source_signals (it's dependent)
+                // Its sources (none left if they were all destroyed)
                 if (signal.rare_data) |signal_rare| {
-                    if (signal_rare.source_signals) |sources| {
-                        for (sources.items) |source_ptr| {
-                            const source: *AbortSignal = @ptrCast(@alignCast(source_ptr));
-
-                            // i. Assert: sourceSignal is not aborted and not dependent
-                            std.debug.assert(!source.isAborted());
-                            std.debug.assert(!source.dependent);
+                    for (signal_rare.source_links.items) |link| {
+                        const source: *AbortSignal = @ptrCast(@alignCast(link.source));
 
-                            // ii. Append sourceSignal to resultSignal's source signals
-                            try result.addSourceSignal(source);
+                        // i. Assert: sourceSignal is not aborted and not dependent
+                        std.debug.assert(!source.isAborted());
+                        std.debug.assert(!source.dependent);
 
-                            // iii. Append resultSignal to sourceSignal's dependent signals
-                            try source.addDependentSignal(result);
-                        }
+                        // ii-iii. Append sourceSignal to resultSignal's source
+                        // signals and resultSignal to its dependent signals
+                        try result.addSourceSignal(source);
                     }
                 }
             }
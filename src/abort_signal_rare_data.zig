@@ -50,9 +50,9 @@
 //! ```zig
 //! pub const SignalRareData = struct {
 //!     event_listeners: ?StringHashMap(ArrayList(EventListener)),
-//!     abort_algorithms: ArrayList(AbortAlgorithmStorage),
-//!     source_signals: ?ArrayList(*anyopaque),
-//!     dependent_signals: ?ArrayList(*anyopaque),
+//!     abort_algorithms: AlgorithmSet,
+//!     source_links: ArrayListUnmanaged(*SignalLink),
+//!     first_dependent: ?*SignalLink, // + last_dependent, dependent_count
 //! };
 //! ```
 //!
@@ -66,20 +66,24 @@
 //! - Most signals don't need listeners
 //!
 //! **2. Abort Algorithms** (run before abort event)
-//! - ArrayList of callback + context pairs
+//! - Ordered set of callback + context pairs, indexed for O(1) removal
 //! - Used by Fetch API, Streams for cleanup
 //! - Only needed for advanced use cases
 //!
 //! **3. Source Signals** (for AbortSignal.any())
-//! - Null for independent signals
-//! - List of signals this depends on
+//! - Empty for independent signals
+//! - One SignalLink per signal this depends on
 //! - Only for composite signals
 //!
 //! **4. Dependent Signals** (for AbortSignal.any())
-//! - Null if no dependents
-//! - List of signals that depend on this
+//! - Empty if no dependents
+//! - Doubly linked list of the SignalLinks of signals that depend on this
 //! - Only for signals used in AbortSignal.any()
 //!
+//! A composite that completes without aborting unlinks from each source in
+//! O(1) when it is destroyed, and every link of a signal is dropped once
+//! it aborts, so long-lived sources don't accumulate dead dependents.
+//!
 //! ## Memory Management
 //!
 //! SignalRareData is owned by AbortSignal and freed automatically:
@@ -91,7 +95,7 @@
 //! // rare_data allocated
 //!
 //! // signal.deinit() will:
-//! // 1. Call rare_data.deinit() (frees all ArrayLists)
+//! // 1. Unlink from source and dependent signals, call rare_data.deinit()
 //! // 2. Free rare_data struct
 //! // 3. Free signal
 //! ```
@@ -114,39 +118,32 @@
 //! ```zig
 //! fn addCleanup(signal: *AbortSignal, cleanup_fn: AbortCallback, ctx: *anyopaque) !void {
 //!     const rare_data = try signal.ensureRareData();
+//!     try rare_data.abort_algorithms.add(allocator, @ptrCast(cleanup_fn), ctx);
+//! }
 //!
-//!     const algorithm = try allocator.create(AbortAlgorithm);
-//!     algorithm.* = .{ .callback = cleanup_fn, .context = ctx };
-//!
-//!     try rare_data.abort_algorithms.append(@ptrCast(algorithm));
+//! fn removeCleanup(signal: *AbortSignal, cleanup_fn: AbortCallback, ctx: *anyopaque) void {
+//!     const rare_data = signal.rare_data orelse return;
+//!     _ = rare_data.abort_algorithms.remove(allocator, @ptrCast(cleanup_fn), ctx);
 //! }
 //! ```
 //!
 //! ### Dependent Signal Tracking
 //! ```zig
-//! fn trackDependent(source: *AbortSignal, dependent: *AbortSignal) !void {
-//!     const rare_data = try source.ensureRareData();
-//!
-//!     if (rare_data.dependent_signals == null) {
-//!         rare_data.dependent_signals = std.ArrayList(*anyopaque).init(allocator);
-//!     }
-//!
-//!     try rare_data.dependent_signals.?.append(@ptrCast(dependent));
+//! fn dependents(source: *AbortSignal) usize {
+//!     const rare_data = source.rare_data orelse return 0;
+//!     return rare_data.dependent_count;
 //! }
 //! ```
 //!
 //! ## Common Patterns
 //!
-//! ### Conditional Cleanup
+//! ### Walking Dependents
 //! ```zig
-//! fn cleanupSignal(signal: *AbortSignal) void {
-//!     if (signal.rare_data) |rare_data| {
-//!         // Cleanup abort algorithms
-//!         for (rare_data.abort_algorithms.items) |algo_ptr| {
-//!             const algo = @as(*AbortAlgorithm, @ptrCast(@alignCast(algo_ptr)));
-//!             allocator.destroy(algo);
-//!         }
-//!         rare_data.abort_algorithms.clearRetainingCapacity();
+//! fn forEachDependent(source: *AbortSignal, visit: *const fn (*AbortSignal) void) void {
+//!     const rare_data = source.rare_data orelse return;
+//!     var link = rare_data.first_dependent;
+//!     while (link) |l| : (link = l.next) {
+//!         visit(@ptrCast(@alignCast(l.dependent)));
 //!     }
 //! }
 //! ```
@@ -175,7 +172,8 @@
 //! - Most signals (80%+) don't need rare features
 //! - Memory savings: 50% on typical signal-heavy applications
 //! - anyopaque used to avoid circular dependencies with AbortSignal
-//! - Source/dependent signals are weak references (not refcounted)
+//! - Source/dependent signals are weak references (not refcounted); the
+//!   link between them is unlinked from both sides by whichever goes first
 //! - Event listeners use StringHashMap for fast type lookup
 //! - Abort algorithms run in order added (FIFO)
 //! - All fields lazy-initialized (null until first use)
@@ -185,10 +183,105 @@ const Allocator = std.mem.Allocator;
 const EventListener = @import("event_target.zig").EventListener;
 const EventCallback = @import("event_target.zig").EventCallback;
 
-// Forward declaration to break dependency cycle
-// AbortAlgorithm is defined in abort_signal.zig as a struct with callback + context
-// We use anyopaque here to store it without importing abort_signal.zig
-const AbortAlgorithmStorage = *anyopaque;
+/// Link between a source signal and a signal that depends on it
+/// (AbortSignal.any()).
+///
+/// Each link is on two lists: the source's dependents (doubly linked, in
+/// the order the dependents were created) and the dependent's
+/// `source_links` (an array, `source_index` being the link's slot). Either
+/// signal unlinks it in O(1), so neither side is scanned when a signal
+/// aborts or is destroyed. Signals are stored as anyopaque (*AbortSignal)
+/// to avoid a circular dependency; neither is a strong reference.
+pub const SignalLink = struct {
+    source: *anyopaque,
+    dependent: *anyopaque,
+
+    /// Neighbours in the source's dependent list
+    prev: ?*SignalLink = null,
+    next: ?*SignalLink = null,
+
+    /// Slot in the dependent's source_links
+    source_index: u32 = 0,
+};
+
+/// One abort algorithm (AbortAlgorithm callback + context, stored as
+/// anyopaque to avoid a circular dependency).
+pub const AlgorithmEntry = struct {
+    callback: *const anyopaque,
+    context: *anyopaque,
+    prev: ?*AlgorithmEntry = null,
+    next: ?*AlgorithmEntry = null,
+};
+
+/// Abort algorithms as an ordered set: entries chained in insertion order
+/// (the order they run in) and indexed by (callback, context), so adding,
+/// duplicate checks and removal are O(1).
+pub const AlgorithmSet = struct {
+    first: ?*AlgorithmEntry = null,
+    last: ?*AlgorithmEntry = null,
+    index: std.AutoHashMapUnmanaged(Key, *AlgorithmEntry) = .{},
+
+    const Key = struct { callback: usize, context: usize };
+
+    fn keyOf(callback: *const anyopaque, context: *anyopaque) Key {
+        return .{ .callback = @intFromPtr(callback), .context = @intFromPtr(context) };
+    }
+
+    pub fn deinit(self: *AlgorithmSet, allocator: Allocator) void {
+        var current = self.first;
+        while (current) |entry| {
+            current = entry.next;
+            allocator.destroy(entry);
+        }
+        self.index.deinit(allocator);
+        self.* = .{};
+    }
+
+    pub fn count(self: *const AlgorithmSet) usize {
+        return self.index.count();
+    }
+
+    /// Appends (callback, context) unless it is already in the set.
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to allocate the entry
+    pub fn add(self: *AlgorithmSet, allocator: Allocator, callback: *const anyopaque, context: *anyopaque) !void {
+        const slot = try self.index.getOrPut(allocator, keyOf(callback, context));
+        if (slot.found_existing) return;
+        errdefer _ = self.index.remove(keyOf(callback, context));
+
+        const entry = try allocator.create(AlgorithmEntry);
+        entry.* = .{ .callback = callback, .context = context, .prev = self.last };
+        if (self.last) |last| last.next = entry else self.first = entry;
+        self.last = entry;
+        slot.value_ptr.* = entry;
+    }
+
+    /// Removes (callback, context). Returns false if it was not in the set.
+    pub fn remove(self: *AlgorithmSet, allocator: Allocator, callback: *const anyopaque, context: *anyopaque) bool {
+        const removed = self.index.fetchRemove(keyOf(callback, context)) orelse return false;
+        self.unlink(removed.value);
+        allocator.destroy(removed.value);
+        return true;
+    }
+
+    /// Removes the first entry and returns its (callback, context), or
+    /// null when empty. Abort steps run algorithms this way, one at a time,
+    /// so an algorithm may remove others.
+    pub fn takeFirst(self: *AlgorithmSet, allocator: Allocator) ?AlgorithmEntry {
+        const entry = self.first orelse return null;
+        const taken = entry.*;
+        _ = self.index.remove(keyOf(entry.callback, entry.context));
+        self.unlink(entry);
+        allocator.destroy(entry);
+        return taken;
+    }
+
+    fn unlink(self: *AlgorithmSet, entry: *AlgorithmEntry) void {
+        if (entry.prev) |prev| prev.next = entry.next else self.first = entry.next;
+        if (entry.next) |next| next.prev = entry.prev else self.last = entry.prev;
+    }
+};
 
 /// Rare data storage for AbortSignal.
 ///
@@ -207,24 +300,22 @@ pub const SignalRareData = struct {
     event_listeners: ?std.StringHashMap(std.ArrayList(EventListener)) = null,
 
     /// Abort algorithms (run when signal aborts)
-    /// Allocated immediately (empty ArrayList)
-    /// Algorithms run BEFORE abort event fires
-    /// Each element is an allocated AbortAlgorithm struct (stored as anyopaque)
-    abort_algorithms: std.ArrayList(AbortAlgorithmStorage),
-
-    /// Source signals (for dependent signals only)
-    /// Null if this is independent signal
-    /// Contains raw pointers to signals this depends on
-    /// IMPORTANT: These are NOT strong references
-    /// Type: *AbortSignal (stored as anyopaque to avoid circular dependency)
-    source_signals: ?std.ArrayList(*anyopaque) = null,
-
-    /// Dependent signals (signals that depend on this)
-    /// Null if no dependents
-    /// Contains raw pointers to signals that depend on this
-    /// IMPORTANT: These are NOT strong references
-    /// Type: *AbortSignal (stored as anyopaque to avoid circular dependency)
-    dependent_signals: ?std.ArrayList(*anyopaque) = null,
+    /// Algorithms run BEFORE abort event fires, in the order added
+    abort_algorithms: AlgorithmSet = .{},
+
+    /// Links to the signals this dependent signal follows, one per source
+    /// Empty for independent signals
+    source_links: std.ArrayListUnmanaged(*SignalLink) = .{},
+
+    /// Links to the signals that depend on this one, in creation order
+    /// The links are owned by the dependents' source_links
+    first_dependent: ?*SignalLink = null,
+    last_dependent: ?*SignalLink = null,
+    dependent_count: usize = 0,
+
+    /// Signal whose abort reason this aborted dependent borrows (a strong
+    /// reference, so the reason outlives its owner's last other release)
+    reason_source: ?*anyopaque = null,
 
     /// Creates a new SignalRareData structure.
     ///
@@ -232,21 +323,15 @@ pub const SignalRareData = struct {
     /// - `allocator`: Memory allocator
     ///
     /// ## Returns
-    /// New rare data with abort_algorithms pre-allocated (empty)
+    /// New rare data with every feature empty
     pub fn init(allocator: Allocator) SignalRareData {
-        return .{
-            .allocator = allocator,
-            .event_listeners = null,
-            .abort_algorithms = std.ArrayList(AbortAlgorithmStorage){},
-            .source_signals = null,
-            .dependent_signals = null,
-        };
+        return .{ .allocator = allocator };
     }
 
     /// Cleans up all allocated rare data.
     ///
-    /// Frees all lists and maps, but does NOT release referenced signals
-    /// (source_signals and dependent_signals are raw pointers).
+    /// Frees all lists and maps, but does NOT release referenced signals.
+    /// The owning signal unlinks its source and dependent links first.
     pub fn deinit(self: *SignalRareData) void {
         // Clean up event listeners
         if (self.event_listeners) |*listeners| {
@@ -257,18 +342,12 @@ pub const SignalRareData = struct {
             listeners.deinit();
         }
 
-        // Clean up abort algorithms
+        // Clean up abort algorithms (never run)
         self.abort_algorithms.deinit(self.allocator);
 
-        // Clean up source signals list (NOT the signals themselves)
-        if (self.source_signals) |*sources| {
-            sources.deinit(self.allocator);
-        }
-
-        // Clean up dependent signals list (NOT the signals themselves)
-        if (self.dependent_signals) |*deps| {
-            deps.deinit(self.allocator);
-        }
+        // Clean up the source link array (the links are already unlinked)
+        std.debug.assert(self.source_links.items.len == 0 and self.first_dependent == null);
+        self.source_links.deinit(self.allocator);
     }
 
     // === Event Listener Management (EventTarget Interface) ===
@@ -0,0 +1,344 @@
+//! Abort Timeout - Timer queue behind `AbortSignal.timeout()`
+//!
+//! `AbortSignal.timeout(ms)` (WHATWG DOM §3.2) aborts its signal with a
+//! "TimeoutError" DOMException once `ms` milliseconds have passed. Timers
+//! belong to the embedder's event loop, so the library never owns an OS
+//! timer or a thread. A `TimeoutQueue` keeps every pending timeout and asks
+//! its `TimerHost` for ONE timer, armed for the earliest deadline; the
+//! embedder calls `run()` when it fires.
+//!
+//! ## Timer Wheels
+//!
+//! Timeouts are kept in 8 levels of 64 buckets (a hierarchical timing
+//! wheel without cascading). Level `n` has a granularity of 8^n ms, so:
+//!
+//! - Level 0 holds deadlines up to 64 ms away, to the millisecond
+//! - Level 3 holds deadlines up to ~33 s away, in 512 ms buckets
+//! - Level 7 holds deadlines up to ~37 h away, in ~35 min buckets
+//!
+//! A deadline is rounded UP to its bucket, so a timeout never fires early;
+//! it may fire up to one granularity late (at most ~1/8 of its delay).
+//! Timeouts sharing a bucket fire together, which coalesces thousands of
+//! pending timeouts into a handful of wakeups. Adding is O(1), and finding
+//! the next deadline is one bit scan per level.
+//!
+//! Deadlines beyond the last level are parked in its farthest bucket and
+//! requeued when it comes round.
+//!
+//! ## Ownership
+//!
+//! The queue holds a reference on each pending signal until it fires (or
+//! the queue is destroyed), like the timer task of the HTML "run steps
+//! after a timeout" algorithm. This keeps composite signals built with
+//! `AbortSignal.any()` working after their caller drops the timeout signal.
+//!
+//! ## Example
+//! ```zig
+//! var queue = TimeoutQueue.init(allocator, host);
+//! defer queue.deinit();
+//!
+//! const signal = try AbortSignal.timeout(allocator, &queue, 5000);
+//! defer signal.release();
+//!
+//! // In the embedder, when the timer armed through `host.arm` fires:
+//! try queue.run();
+//! ```
+//!
+//! ## Spec References
+//! - AbortSignal.timeout(): https://dom.spec.whatwg.org/#dom-abortsignal-timeout
+//! - Run steps after a timeout: https://html.spec.whatwg.org/multipage/timers-and-user-prompts.html#run-steps-after-a-timeout
+
+const std = @import("std");
+const Allocator = std.mem.Allocator;
+const abort_signal = @import("abort_signal.zig");
+const AbortSignal = abort_signal.AbortSignal;
+const DOMException = abort_signal.DOMException;
+
+/// The embedder's timer, on its own monotonic millisecond clock.
+pub const TimerHost = struct {
+    /// Passed to every callback
+    context: ?*anyopaque = null,
+
+    /// Returns the current time in milliseconds
+    now: *const fn (context: ?*anyopaque) u64,
+
+    /// Arms the single timer to call `TimeoutQueue.run()` at `deadline`
+    /// (a time on the `now` clock, possibly already past), replacing any
+    /// deadline armed before
+    arm: *const fn (context: ?*anyopaque, deadline: u64) void,
+
+    /// Disarms the timer (no timeouts are pending)
+    disarm: *const fn (context: ?*anyopaque) void,
+};
+
+const level_count = 8;
+const level_size = 64;
+const level_shift = 3;
+
+/// Expired timeouts waiting to fire live in one extra bucket
+const due_bucket = level_count * level_size;
+
+const Entry = struct {
+    signal: *AbortSignal,
+    deadline: u64,
+    bucket: u16,
+    prev: ?*Entry = null,
+    next: ?*Entry = null,
+};
+
+const Bucket = struct {
+    first: ?*Entry = null,
+    last: ?*Entry = null,
+};
+
+pub const TimeoutQueue = struct {
+    allocator: Allocator,
+    host: TimerHost,
+
+    /// Every bucket due at or before this time has been collected
+    clk: u64,
+
+    /// Time `run()` last saw; new deadlines are always later, so a
+    /// timeout added by an abort callback waits for the next wakeup
+    run_time: u64,
+
+    buckets: [level_count * level_size + 1]Bucket = [_]Bucket{.{}} ** (level_count * level_size + 1),
+
+    /// One bit per non-empty bucket, per level
+    pending: [level_count]u64 = [_]u64{0} ** level_count,
+
+    count: usize = 0,
+
+    /// Deadline currently armed on the host, if any
+    armed: ?u64 = null,
+
+    /// Recycled entries
+    free_entries: ?*Entry = null,
+
+    running: bool = false,
+
+    pub fn init(allocator: Allocator, host: TimerHost) TimeoutQueue {
+        const now = host.now(host.context);
+        return .{
+            .allocator = allocator,
+            .host = host,
+            .clk = now,
+            .run_time = now,
+        };
+    }
+
+    /// Releases every pending signal without aborting it.
+    pub fn deinit(self: *TimeoutQueue) void {
+        for (&self.buckets) |*bucket| {
+            var current = bucket.first;
+            while (current) |entry| {
+                current = entry.next;
+                entry.signal.release();
+                self.allocator.destroy(entry);
+            }
+            bucket.* = .{};
+        }
+        while (self.free_entries) |entry| {
+            self.free_entries = entry.next;
+            self.allocator.destroy(entry);
+        }
+        if (self.armed != null) self.host.disarm(self.host.context);
+        self.* = undefined;
+    }
+
+    /// Number of timeouts that have not fired yet.
+    pub fn pendingCount(self: *const TimeoutQueue) usize {
+        return self.count;
+    }
+
+    /// Schedules `signal` to abort with a "TimeoutError" DOMException
+    /// `milliseconds` from now. The queue acquires the signal until then.
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to allocate the entry
+    pub fn add(self: *TimeoutQueue, signal: *AbortSignal, milliseconds: u64) Allocator.Error!void {
+        const entry = if (self.free_entries) |recycled| blk: {
+            self.free_entries = recycled.next;
+            break :blk recycled;
+        } else try self.allocator.create(Entry);
+
+        const now = self.host.now(self.host.context);
+        signal.acquire();
+        entry.* = .{
+            .signal = signal,
+            .deadline = @max(now +| milliseconds, self.run_time + 1),
+            .bucket = 0,
+        };
+        self.insert(entry);
+        self.count += 1;
+        if (!self.running) self.rearm();
+    }
+
+    /// Aborts every signal whose deadline has passed, then re-arms the
+    /// host for the next one. Call it when the armed timer fires; calling
+    /// it early (or re-entrantly, from an abort callback) is harmless.
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to abort a signal; it (and the rest of
+    ///   the expired timeouts) fire on the next call
+    pub fn run(self: *TimeoutQueue) !void {
+        if (self.running) return;
+        self.running = true;
+        defer {
+            self.running = false;
+            self.rearm();
+        }
+
+        const now = self.host.now(self.host.context);
+        self.run_time = @max(self.run_time, now);
+
+        while (true) {
+            const entry = self.buckets[due_bucket].first orelse {
+                const next = self.nextExpiry() orelse break;
+                if (next > now) break;
+                self.clk = next;
+                self.collect(next);
+                continue;
+            };
+
+            if (entry.deadline > now) {
+                // Parked beyond the last level: requeue from here
+                self.unlink(entry);
+                self.insert(entry);
+                continue;
+            }
+            try self.fire(entry);
+        }
+        self.clk = @max(self.clk, now);
+    }
+
+    /// Aborts the signal of the due `entry`. On failure the entry stays
+    /// due, unless the signal was aborted regardless.
+    fn fire(self: *TimeoutQueue, entry: *Entry) !void {
+        const signal = entry.signal;
+        if (!signal.isAborted()) {
+            const reason = try DOMException.create(signal.allocator, "TimeoutError", "signal timed out");
+            const reason_ptr: *anyopaque = @ptrCast(reason);
+            signal.signalAbort(reason_ptr) catch |err| {
+                if (signal.abort_reason != reason_ptr) {
+                    signal.allocator.destroy(reason);
+                    return err;
+                }
+                signal.owns_abort_reason = true;
+                self.retire(entry);
+                return err;
+            };
+            if (signal.abort_reason == reason_ptr) {
+                signal.owns_abort_reason = true;
+            } else {
+                signal.allocator.destroy(reason);
+            }
+        }
+        self.retire(entry);
+    }
+
+    /// Drops a fired entry and the queue's reference on its signal.
+    fn retire(self: *TimeoutQueue, entry: *Entry) void {
+        const signal = entry.signal;
+        self.unlink(entry);
+        self.count -= 1;
+        entry.next = self.free_entries;
+        self.free_entries = entry;
+        signal.release();
+    }
+
+    /// Links `entry` into the bucket its deadline rounds up to.
+    fn insert(self: *TimeoutQueue, entry: *Entry) void {
+        const bucket: u16 = blk: {
+            for (0..level_count) |level| {
+                const shift: u6 = @intCast(level * level_shift);
+                const position = ceilShift(entry.deadline, shift);
+                if (position - (self.clk >> shift) <= level_size) {
+                    break :blk @intCast(level * level_size + (position % level_size));
+                }
+            }
+            // Beyond the last level: park in its farthest bucket
+            const shift: u6 = (level_count - 1) * level_shift;
+            const position = (self.clk >> shift) + level_size;
+            break :blk @intCast((level_count - 1) * level_size + (position % level_size));
+        };
+
+        entry.bucket = bucket;
+        entry.next = null;
+        const list = &self.buckets[bucket];
+        entry.prev = list.last;
+        if (list.last) |last| last.next = entry else list.first = entry;
+        list.last = entry;
+        if (bucket != due_bucket) self.pending[bucket / level_size] |= bitOf(bucket);
+    }
+
+    fn unlink(self: *TimeoutQueue, entry: *Entry) void {
+        const list = &self.buckets[entry.bucket];
+        if (entry.prev) |prev| prev.next = entry.next else list.first = entry.next;
+        if (entry.next) |next| next.prev = entry.prev else list.last = entry.prev;
+        entry.prev = null;
+        entry.next = null;
+        if (list.first == null and entry.bucket != due_bucket) {
+            self.pending[entry.bucket / level_size] &= ~bitOf(entry.bucket);
+        }
+    }
+
+    /// Moves every bucket due at `time` to the due list. Level `n` has a
+    /// bucket due when `time` is a multiple of its granularity.
+    fn collect(self: *TimeoutQueue, time: u64) void {
+        var position = time;
+        for (0..level_count) |level| {
+            const bucket = level * level_size + @as(usize, @intCast(position % level_size));
+            if (self.pending[level] & bitOf(bucket) != 0) {
+                self.pending[level] &= ~bitOf(bucket);
+                const list = &self.buckets[bucket];
+                var current = list.first;
+                while (current) |entry| : (current = entry.next) entry.bucket = due_bucket;
+                const due = &self.buckets[due_bucket];
+                if (due.last) |last| last.next = list.first else due.first = list.first;
+                list.first.?.prev = due.last;
+                due.last = list.last;
+                list.* = .{};
+            }
+            if (position % (1 << level_shift) != 0) break;
+            position >>= level_shift;
+        }
+    }
+
+    /// Time the earliest non-empty bucket is due, if any.
+    fn nextExpiry(self: *const TimeoutQueue) ?u64 {
+        if (self.buckets[due_bucket].first != null) return self.clk;
+        var earliest: ?u64 = null;
+        for (self.pending, 0..) |map, level| {
+            if (map == 0) continue;
+            const shift: u6 = @intCast(level * level_shift);
+            // Buckets are searched from the one after `clk`, wrapping round
+            const start = (self.clk >> shift) + 1;
+            const offset = @ctz(std.math.rotr(u64, map, start % level_size));
+            const time = std.math.shlExact(u64, start + offset, shift) catch std.math.maxInt(u64);
+            earliest = if (earliest) |e| @min(e, time) else time;
+        }
+        return earliest;
+    }
+
+    /// Arms the host for the earliest deadline, if it changed.
+    fn rearm(self: *TimeoutQueue) void {
+        const next = self.nextExpiry();
+        if (std.meta.eql(next, self.armed)) return;
+        self.armed = next;
+        if (next) |deadline| {
+            self.host.arm(self.host.context, deadline);
+        } else {
+            self.host.disarm(self.host.context);
+        }
+    }
+};
+
+fn ceilShift(value: u64, shift: u6) u64 {
+    const mask = (@as(u64, 1) << shift) - 1;
+    return (value >> shift) + @intFromBool(value & mask != 0);
+}
+
+fn bitOf(bucket: usize) u64 {
+    return @as(u64, 1) << @intCast(bucket % level_size);
+}
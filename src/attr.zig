@@ -537,30 +537,54 @@ pub const Attr = struct {
         return self._value;
     }
 
-    /// Sets the attribute value.
+    /// Sets the attribute value ("set an existing attribute value").
     ///
-    /// Frees the old value and allocates a new copy of the provided value.
+    /// An attribute attached to an element changes the element's attribute
+    /// (with its mutation record and reactions), which updates this node
+    /// too; a detached one just stores the value. The value, nodeValue and
+    /// textContent setters all come here.
     ///
     /// ## Parameters
     /// - `new_value`: New value to set
     ///
     /// ## Returns
-    /// Error if allocation fails, otherwise void.
+    /// Error if allocation or the element's attribute change fails.
     ///
-    /// **Spec**: https://dom.spec.whatwg.org/#dom-attr-value
+    /// **Spec**: https://dom.spec.whatwg.org/#set-an-existing-attribute-value
     ///
     /// **WebIDL**: dom.idl:437 [CEReactions]
     pub fn setValue(self: *Attr, new_value: []const u8) !void {
-        const allocator = self.node.allocator;
+        if (self.owner_element) |owner| {
+            if (self.namespace_uri) |namespace_uri| {
+                if (self.prefix) |pfx| {
+                    const allocator = self.node.allocator;
+                    const qualified = try std.fmt.allocPrint(allocator, "{s}:{s}", .{ pfx, self.local_name });
+                    defer allocator.free(qualified);
+                    try owner.setAttributeNS(namespace_uri, qualified, new_value);
+                } else {
+                    try owner.setAttributeNS(namespace_uri, self.local_name, new_value);
+                }
+            } else {
+                try owner.setAttribute(self.local_name, new_value);
+            }
+            // The element updates its cached attribute node itself
+            if (std.mem.eql(u8, self._value, new_value)) return;
+        }
+        try self.storeValue(new_value);
+    }
 
-        // Free old value
-        allocator.free(self._value);
+    /// Replaces the stored value without touching the owner element; for
+    /// elements keeping their attribute nodes in step with their
+    /// attributes, and for attributes not attached to one.
+    ///
+    /// Frees the old value and allocates a new copy of the provided value.
+    pub fn storeValue(self: *Attr, new_value: []const u8) !void {
+        const allocator = self.node.allocator;
 
-        // Allocate and copy new value
+        // Copy first, so the old value survives a failed allocation
         const value_copy = try allocator.dupe(u8, new_value);
+        allocator.free(self._value);
         self._value = value_copy;
-
-        // TODO: Fire CEReactions if attached to element
     }
 
     /// Returns true if this attribute was explicitly specified.
@@ -615,7 +639,7 @@ pub const Attr = struct {
             try create(node.allocator, self.local_name);
 
         // Copy value
-        try cloned.setValue(self.value());
+        try cloned.storeValue(self.value());
 
         // Preserve owner document (WHATWG DOM clone algorithm)
         cloned.node.owner_document = self.node.owner_document;
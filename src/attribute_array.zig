@@ -16,6 +16,15 @@
 //! - Covers ~70% of elements (Chrome telemetry)
 //! - Lazy migration to heap on 5th attribute
 //!
+//! **Name Index** (large elements):
+//! - Heap storage stays a plain array, scanned linearly, up to
+//!   `index_threshold` attributes
+//! - From there on a side hash maps each local name to its position, so
+//!   lookups on elements with dozens of attributes (SVG, data-heavy
+//!   markup) stay O(1)
+//! - The index hashes name bytes but compares pointers first: stored names
+//!   are interned, and so are most names looked up
+//!
 //! **String Interning**:
 //! - All strings MUST be interned via Document.string_pool
 //! - Enables O(1) comparison via pointer equality
@@ -77,6 +86,9 @@ const Allocator = std.mem.Allocator;
 const Attribute = @import("attribute.zig").Attribute;
 const QualifiedName = @import("qualified_name.zig").QualifiedName;
 
+/// Heap attribute count from which lookups go through a name index.
+pub const index_threshold = 16;
+
 /// AttributeArray stores element attributes in insertion order.
 ///
 /// Uses linear search (O(n)) which is faster than hash map for typical element sizes
@@ -89,12 +101,14 @@ const QualifiedName = @import("qualified_name.zig").QualifiedName;
 ///   attributes: ArrayListUnmanaged(Attribute)  (24 bytes)
 ///   allocator: Allocator                       (16 bytes)
 ///   inline_storage: [4]Attribute               (256 bytes = 4 * 64)
+///   index: ?*NameIndex                         (8 bytes)
 ///   inline_count: u8                           (1 byte)
 ///   (padding)                                  (7 bytes)
-///   Total: 304 bytes
+///   Total: 312 bytes
 /// ```
 ///
 /// For elements with ≤4 attributes: Zero separate heap allocations!
+/// The name index is only allocated from `index_threshold` attributes.
 ///
 /// ## Spec Compliance
 ///
@@ -124,6 +138,9 @@ pub const AttributeArray = struct {
     /// 1-4 = using inline storage
     inline_count: u8,
 
+    /// Name index over the heap array (null below `index_threshold`).
+    index: ?*NameIndex,
+
     /// Initializes empty attribute array.
     ///
     /// ## Parameters
@@ -139,6 +156,7 @@ pub const AttributeArray = struct {
             .allocator = allocator,
             .inline_storage = undefined,
             .inline_count = 0,
+            .index = null,
         };
     }
 
@@ -146,9 +164,9 @@ pub const AttributeArray = struct {
     ///
     /// Inline storage needs no deallocation (stack allocated).
     pub fn deinit(self: *AttributeArray) void {
-        if (self.inline_count == 0 and self.attributes.items.len > 0) {
-            self.attributes.deinit(self.allocator);
-        }
+        self.dropIndex();
+        // Heap capacity may outlive its items (removed down to zero)
+        self.attributes.deinit(self.allocator);
     }
 
     /// Gets attribute value by qualified name.
@@ -165,7 +183,8 @@ pub const AttributeArray = struct {
     /// ## Performance
     ///
     /// O(n) linear search, but n is typically 3-5. Sequential memory access
-    /// is cache-friendly. Faster than HashMap for small n.
+    /// is cache-friendly. Faster than HashMap for small n. From
+    /// `index_threshold` attributes, one hash lookup.
     ///
     /// ## Example
     ///
@@ -190,10 +209,26 @@ pub const AttributeArray = struct {
         }
 
         // Heap storage
-        for (self.attributes.items) |attr| {
-            if (attr.matches(local_name, namespace_uri)) {
-                return attr.value;
+        const i = self.heapIndexOf(local_name, namespace_uri) orelse return null;
+        return self.attributes.items[i].value;
+    }
+
+    /// Gets the first attribute whose local name is `local_name`, in any
+    /// namespace (the lookup of getAttribute() and removeAttribute()).
+    pub fn getByLocalName(self: *const AttributeArray, local_name: []const u8) ?Attribute {
+        if (self.inline_count > 0) {
+            for (self.inline_storage[0..self.inline_count]) |attr| {
+                if (std.mem.eql(u8, attr.name.local_name, local_name)) return attr;
             }
+            return null;
+        }
+
+        if (self.index) |index| {
+            const i = index.map.get(local_name) orelse return null;
+            return self.attributes.items[i];
+        }
+        for (self.attributes.items) |attr| {
+            if (std.mem.eql(u8, attr.name.local_name, local_name)) return attr;
         }
         return null;
     }
@@ -237,13 +272,9 @@ pub const AttributeArray = struct {
                     return;
                 }
             }
-        } else {
-            for (self.attributes.items, 0..) |attr, i| {
-                if (attr.matches(local_name, namespace_uri)) {
-                    self.attributes.items[i].value = value;
-                    return;
-                }
-            }
+        } else if (self.heapIndexOf(local_name, namespace_uri)) |i| {
+            self.attributes.items[i].value = value;
+            return;
         }
 
         // Not found - append new attribute
@@ -252,24 +283,16 @@ pub const AttributeArray = struct {
         else
             Attribute.init(local_name, value);
 
-        // Determine storage location
-        if (self.attributes.items.len > 0) {
-            // Already using heap - append
-            try self.attributes.append(self.allocator, new_attr);
-        } else if (self.inline_count < 4) {
-            // Using inline storage with room - add to inline
-            self.inline_storage[self.inline_count] = new_attr;
-            self.inline_count += 1;
-        } else {
-            // inline_count == 4 - first overflow, migrate to heap
-            try self.attributes.ensureTotalCapacity(self.allocator, 8);
-            for (self.inline_storage[0..4]) |attr| {
-                self.attributes.appendAssumeCapacity(attr);
-            }
+        try self.append(new_attr);
+    }
 
-            // Append the new attribute
-            try self.attributes.append(self.allocator, new_attr);
-            self.inline_count = 0; // Mark as using heap
+    /// Reserves heap storage for `additional` more attributes when they
+    /// would not fit inline, so that adding them allocates at most for the
+    /// name index.
+    pub fn reserve(self: *AttributeArray, additional: usize) Allocator.Error!void {
+        const total = self.count() + additional;
+        if (total > self.inline_storage.len) {
+            try self.attributes.ensureTotalCapacity(self.allocator, total);
         }
     }
 
@@ -311,20 +334,28 @@ pub const AttributeArray = struct {
                     return;
                 }
             }
-        } else {
-            for (self.attributes.items, 0..) |attr, i| {
-                if (attr.matches(local_name, namespace_uri)) {
-                    self.attributes.items[i].value = value;
-                    // Update the qualified name to preserve the prefix
-                    self.attributes.items[i].name = QualifiedName.initNS(namespace_uri, qualified_name);
-                    return;
+        } else if (self.heapIndexOf(local_name, namespace_uri)) |i| {
+            const attr = &self.attributes.items[i];
+            attr.value = value;
+            // Update the qualified name to preserve the prefix
+            attr.name = QualifiedName.initNS(namespace_uri, qualified_name);
+            if (self.index) |index| {
+                // Keep the key pointing at a live name
+                if (index.map.getEntry(local_name)) |entry| {
+                    if (entry.value_ptr.* == i) entry.key_ptr.* = attr.name.local_name;
                 }
             }
+            return;
         }
 
         // Not found - append new attribute (use initNS to preserve prefix)
         const new_attr = Attribute.initNS(namespace_uri, qualified_name, value);
+        try self.append(new_attr);
+    }
 
+    /// Adds a new attribute at the end, migrating to heap storage and
+    /// building the name index as the count crosses their thresholds.
+    fn append(self: *AttributeArray, new_attr: Attribute) Allocator.Error!void {
         // Determine storage location
         if (self.attributes.items.len > 0) {
             // Already using heap - append
@@ -343,7 +374,19 @@ pub const AttributeArray = struct {
             // Append the new attribute
             try self.attributes.append(self.allocator, new_attr);
             self.inline_count = 0; // Mark as using heap
+            return;
         }
+
+        if (self.attributes.items.len < index_threshold) return;
+        const position: u32 = @intCast(self.attributes.items.len - 1);
+        const added = if (self.index) |index|
+            index.add(self.allocator, new_attr.name.local_name, position)
+        else
+            self.buildIndex();
+        added catch |err| {
+            _ = self.attributes.pop();
+            return err;
+        };
     }
 
     /// Removes attribute by qualified name.
@@ -387,13 +430,17 @@ pub const AttributeArray = struct {
             return false;
         }
 
-        for (self.attributes.items, 0..) |attr, i| {
-            if (attr.matches(local_name, namespace_uri)) {
-                _ = self.attributes.swapRemove(i); // O(1) removal
-                return true;
+        const i = self.heapIndexOf(local_name, namespace_uri) orelse return false;
+        _ = self.attributes.orderedRemove(i); // Preserve order
+        if (self.index != null) {
+            // Positions after i moved; rebuild (or drop below the threshold)
+            self.dropIndex();
+            if (self.attributes.items.len >= index_threshold) {
+                // Lookups fall back to scanning if this fails
+                self.buildIndex() catch {};
             }
         }
-        return false;
+        return true;
     }
 
     /// Returns count of attributes.
@@ -408,6 +455,50 @@ pub const AttributeArray = struct {
         return self.attributes.items.len;
     }
 
+    /// Returns the bytes allocated for heap storage: the attribute list
+    /// and its name index. Inline storage is part of the owning element,
+    /// and names and values live in the document's string pool.
+    pub fn heapBytes(self: *const AttributeArray) usize {
+        var bytes = self.attributes.capacity * @sizeOf(Attribute);
+        if (self.index) |index| {
+            bytes += @sizeOf(NameIndex) + index.map.capacity() * (@sizeOf([]const u8) + @sizeOf(u32) + 1);
+        }
+        return bytes;
+    }
+
+    /// Returns the attribute at `index` in insertion order, or null if out
+    /// of bounds. O(1) for both inline and heap storage.
+    pub fn at(self: *const AttributeArray, index: usize) ?Attribute {
+        if (self.inline_count > 0) {
+            if (index >= self.inline_count) return null;
+            return self.inline_storage[index];
+        }
+        if (index >= self.attributes.items.len) return null;
+        return self.attributes.items[index];
+    }
+
+    /// Replaces every name, namespace and value with its copy from
+    /// `remap` (a StringRemap, see adopt() in node.zig). Copies have the
+    /// same bytes, so the name index keeps its buckets and only its keys
+    /// are repointed.
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to remap a string (the attributes
+    ///   remapped so far keep their new strings)
+    pub fn remapStrings(self: *AttributeArray, remap: anytype) Allocator.Error!void {
+        const items = if (self.inline_count > 0) self.inline_storage[0..self.inline_count] else self.attributes.items;
+        for (items) |*attr| {
+            attr.name.local_name = try remap.string(attr.name.local_name);
+            attr.name.namespace_uri = try remap.optional(attr.name.namespace_uri);
+            attr.name.prefix = try remap.optional(attr.name.prefix);
+            attr.value = try remap.string(attr.value);
+        }
+        if (self.index) |index| {
+            var keys = index.map.keyIterator();
+            while (keys.next()) |key| key.* = try remap.string(key.*);
+        }
+    }
+
     /// Checks if attribute with given name exists.
     ///
     /// ## Parameters
@@ -426,6 +517,49 @@ pub const AttributeArray = struct {
         return self.get(local_name, namespace_uri) != null;
     }
 
+    /// Position of an attribute in heap storage.
+    fn heapIndexOf(
+        self: *const AttributeArray,
+        local_name: []const u8,
+        namespace_uri: ?[]const u8,
+    ) ?usize {
+        const items = self.attributes.items;
+        var start: usize = 0;
+        if (self.index) |index| {
+            start = index.map.get(local_name) orelse return null;
+            if (items[start].matches(local_name, namespace_uri)) return start;
+            // Other attributes with this local name can only come later
+            if (!index.shared) return null;
+            start += 1;
+        }
+        for (items[start..], start..) |attr, i| {
+            if (attr.matches(local_name, namespace_uri)) return i;
+        }
+        return null;
+    }
+
+    fn buildIndex(self: *AttributeArray) Allocator.Error!void {
+        const index = try self.allocator.create(NameIndex);
+        index.* = .{};
+        errdefer index.deinit(self.allocator);
+
+        try index.map.ensureTotalCapacity(self.allocator, @intCast(self.attributes.items.len));
+        for (self.attributes.items, 0..) |attr, i| {
+            const entry = index.map.getOrPutAssumeCapacity(attr.name.local_name);
+            if (entry.found_existing) {
+                index.shared = true;
+            } else {
+                entry.value_ptr.* = @intCast(i);
+            }
+        }
+        self.index = index;
+    }
+
+    fn dropIndex(self: *AttributeArray) void {
+        if (self.index) |index| index.deinit(self.allocator);
+        self.index = null;
+    }
+
     /// Iterator for all attributes (preserves insertion order).
     ///
     /// ## Example
@@ -463,3 +597,40 @@ pub const AttributeArray = struct {
         return .{ .array = self };
     }
 };
+
+/// Local name → position of the first heap attribute with that local name.
+const NameIndex = struct {
+    map: std.HashMapUnmanaged([]const u8, u32, NameContext, std.hash_map.default_max_load_percentage) = .{},
+
+    /// Some local name is used by more than one attribute (in different
+    /// namespaces), so a miss on the first one must keep scanning.
+    shared: bool = false,
+
+    fn add(self: *NameIndex, allocator: Allocator, local_name: []const u8, position: u32) Allocator.Error!void {
+        const entry = try self.map.getOrPut(allocator, local_name);
+        if (entry.found_existing) {
+            self.shared = true;
+        } else {
+            entry.value_ptr.* = position;
+        }
+    }
+
+    /// Frees the map and the index itself.
+    fn deinit(self: *NameIndex, allocator: Allocator) void {
+        self.map.deinit(allocator);
+        allocator.destroy(self);
+    }
+};
+
+/// Hashes name bytes, but compares pointers before bytes: stored names are
+/// interned in the document's string pool, as are most looked-up names.
+const NameContext = struct {
+    pub fn hash(_: NameContext, name: []const u8) u64 {
+        return std.hash.Wyhash.hash(0, name);
+    }
+
+    pub fn eql(_: NameContext, a: []const u8, b: []const u8) bool {
+        if (a.ptr == b.ptr) return a.len == b.len;
+        return std.mem.eql(u8, a, b);
+    }
+};
@@ -228,6 +228,8 @@ const Allocator = std.mem.Allocator;
 const text_mod = @import("text.zig");
 const Text = text_mod.Text;
 const node_mod = @import("node.zig");
+const range_mod = @import("range.zig");
+const character_data = @import("character_data.zig");
 const Node = node_mod.Node;
 const NodeVTable = node_mod.NodeVTable;
 const Event = @import("event.zig").Event;
@@ -372,7 +374,9 @@ pub const CDATASection = struct {
     fn deinitImpl(node: *Node) void {
         const text: *Text = @fieldParentPtr("prototype", node);
         const cdata: *CDATASection = @fieldParentPtr("prototype", text);
-        node.allocator.free(cdata.prototype.data);
+        node.deinitRareData();
+        node.dropNodeId();
+        character_data.freeData(&cdata.prototype);
         node.allocator.destroy(cdata);
     }
 
@@ -397,9 +401,10 @@ pub const CDATASection = struct {
         // Replace data
         const data = try node.allocator.dupe(u8, new_value);
 
-        node.allocator.free(cdata.prototype.data);
-        cdata.prototype.data = data;
+        character_data.takeData(&cdata.prototype, data);
         node.generation += 1;
+        node.invalidateHashes();
+        range_mod.dataReplaced(node, 0, old_value.len, data.len);
 
         // Queue mutation record for characterData
         node_mod.queueMutationRecord(
@@ -478,6 +483,8 @@ pub const CDATASection = struct {
     /// // second is now next sibling of cdata in parent
     /// ```
     pub fn splitText(self: *CDATASection, offset: usize) !*CDATASection {
+        try self.prototype.prototype.checkMutable();
+
         // Step 1: Validate offset
         if (offset > self.prototype.data.len) {
             return error.IndexSizeError;
@@ -494,9 +501,7 @@ pub const CDATASection = struct {
         new_cdata.prototype.prototype.owner_document = self.prototype.prototype.owner_document;
 
         // Step 3: Truncate this node's data to before offset
-        const truncated = try self.prototype.prototype.allocator.dupe(u8, self.prototype.data[0..offset]);
-        self.prototype.prototype.allocator.free(self.prototype.data);
-        self.prototype.data = truncated;
+        try character_data.spliceData(&self.prototype, offset, self.prototype.data.len, "");
 
         // Step 4: If this node has a parent, insert new node after this one
         if (self.prototype.prototype.parent_node) |parent| {
@@ -505,6 +510,8 @@ pub const CDATASection = struct {
         }
 
         self.prototype.prototype.generation += 1;
+        self.prototype.prototype.invalidateHashes();
+        range_mod.textSplit(&self.prototype.prototype, &new_cdata.prototype.prototype, offset, new_cdata.prototype.data.len);
         return new_cdata;
     }
 };
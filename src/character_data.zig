@@ -150,9 +150,44 @@
 //! ```
 //!
 //! See `JS_BINDINGS.md` for complete binding patterns and memory management.
+//!
+//! ## Large Data
+//!
+//! Text and Comment nodes edit their data through `replaceBytes()`. Data
+//! shorter than `in_place_threshold` is reallocated to its exact length on
+//! every edit, as before. Longer data lives at the start of a buffer with
+//! spare room (the node's `capacity`), so typing into or deleting from a
+//! multi-megabyte node shifts its tail in place instead of allocating and
+//! copying the whole string; the buffer grows by half when it fills up. The
+//! data stays one contiguous slice, so every reader (`data`, `nodeValue()`,
+//! `textContent`, ranges, the bindings) sees it as before.
+//!
+//! The old value of the data is only copied when a mutation observer could
+//! receive it.
+//!
+//! ## UTF-16 Offsets
+//!
+//! DOMString offsets count UTF-16 code units while the data is UTF-8, so the
+//! bindings go through `replaceUtf16()` and `sliceUtf16()`, which convert
+//! offsets with the node's `Utf16Index` (its `utf16` field) instead of
+//! rescanning the data: the cached UTF-16 length answers `length` and, when
+//! it equals the byte length (ASCII data), makes offsets byte offsets; a
+//! checkpoint at the last converted position lets the next conversion scan
+//! only from there. Data of `in_place_threshold` bytes or more that is not
+//! ASCII keeps `Utf16Chunks` in its rare data instead: an entry every
+//! `chunk_len` bytes and code units, built lazily and dropped from an edit
+//! on, so any offset converts by scanning at most one chunk. In a frozen
+//! document, which may be read on several threads, conversions use the
+//! index and tables as they were but never write them.
+//!
+//! `toByteOffset()` and `toDomOffset()` apply the same conversion to range
+//! boundaries, which keep byte offsets in character data; the bindings
+//! convert at the C-ABI so script sees UTF-16 offsets everywhere.
 
 const std = @import("std");
 const Allocator = std.mem.Allocator;
+const node_mod = @import("node.zig");
+const range_mod = @import("range.zig");
 
 /// Extract a substring from character data.
 ///
@@ -453,3 +488,556 @@ pub fn replaceData(
     allocator.free(data_ptr.*);
     data_ptr.* = new_data;
 }
+
+// ============================================================================
+// In-place Editing (Text and Comment)
+// ============================================================================
+
+/// Data at least this many bytes long keeps spare room for in-place edits.
+pub const in_place_threshold: usize = 4096;
+
+/// Returns the allocation `owner.data` starts (`owner` is a *Text or
+/// *Comment; a `capacity` of 0 means the allocation is exactly `data`).
+pub fn buffer(owner: anytype) []u8 {
+    return owner.data.ptr[0..@max(owner.capacity, owner.data.len)];
+}
+
+/// Frees the data of `owner` (see `buffer()`).
+pub fn freeData(owner: anytype) void {
+    owner.prototype.allocator.free(buffer(owner));
+}
+
+/// Frees the data of `owner` and takes ownership of `new_data`, an exact
+/// allocation from the node's allocator.
+pub fn takeData(owner: anytype, new_data: []u8) void {
+    freeData(owner);
+    owner.data = new_data;
+    owner.capacity = 0;
+    owner.utf16 = .{};
+    dropChunks(owner, 0);
+}
+
+/// Moves the bytes of `owner.data` from `at` on to `target`, a new node of
+/// the same kind with empty data (splitText). Only the smaller half is
+/// copied into a new allocation; the larger one keeps the buffer (the tail
+/// moved to its start), so a split allocates once and never copies the
+/// larger half.
+///
+/// Only the storage changes, as in `spliceData()`.
+///
+/// ## Errors
+/// - `error.OutOfMemory`: Failed to allocate (data unchanged)
+pub fn splitData(owner: anytype, target: anytype, at: usize) Allocator.Error!void {
+    const allocator = owner.prototype.allocator;
+    const old = owner.data;
+    const current = buffer(owner);
+    const tail_len = old.len - at;
+
+    if (tail_len > at) {
+        const head = try allocator.dupe(u8, old[0..at]);
+        std.mem.copyForwards(u8, current[0..tail_len], old[at..]);
+        freeData(target);
+        target.data = current[0..tail_len];
+        target.capacity = current.len;
+        owner.data = head;
+        owner.capacity = 0;
+    } else {
+        const tail = try allocator.dupe(u8, old[at..]);
+        freeData(target);
+        target.data = tail;
+        target.capacity = 0;
+        owner.data = current[0..at];
+        owner.capacity = current.len;
+    }
+
+    // The head is unchanged: offsets before `at` stay valid
+    owner.utf16.length = Utf16Index.unknown;
+    if (owner.utf16.checkpoint.byte > at) owner.utf16.checkpoint = .{};
+    dropChunks(owner, at);
+    target.utf16 = .{};
+    dropChunks(target, 0);
+}
+
+/// Appends `extra` bytes to the data of `owner` and returns them, for the
+/// caller to fill before the data is read again. The data grows in one
+/// step: in place when the buffer has room, otherwise into a new exact
+/// allocation (callers that append several pieces sum them first).
+///
+/// Only the storage changes, as in `spliceData()`.
+///
+/// ## Errors
+/// - `error.OutOfMemory`: Failed to allocate (data unchanged)
+pub fn growData(owner: anytype, extra: usize) Allocator.Error![]u8 {
+    const old_len = owner.data.len;
+    const new_len = old_len + extra;
+    var current = buffer(owner);
+
+    if (new_len > current.len) {
+        const new_buffer = try owner.prototype.allocator.alloc(u8, new_len);
+        @memcpy(new_buffer[0..old_len], owner.data);
+        owner.prototype.allocator.free(current);
+        current = new_buffer;
+    }
+    owner.data = current[0..new_len];
+    owner.capacity = if (current.len > new_len) current.len else 0;
+
+    // The old data is a prefix of the new one: its offsets stay valid
+    owner.utf16.length = Utf16Index.unknown;
+    dropChunks(owner, old_len);
+    return current[old_len..new_len];
+}
+
+/// Replaces the bytes `start..end` of `owner.data` with `replacement`, in
+/// place when the data is long enough (see the module doc).
+///
+/// Only the storage changes: live ranges, the node generation and mutation
+/// records are the caller's business (see `replaceBytes()`). `replacement`
+/// may point into the data itself.
+///
+/// ## Errors
+/// - `error.OutOfMemory`: Failed to allocate a new buffer (data unchanged)
+pub fn spliceData(owner: anytype, start: usize, end: usize, replacement: []const u8) Allocator.Error!void {
+    const old = owner.data;
+    const new_len = old.len - (end - start) + replacement.len;
+    const current = buffer(owner);
+
+    // The UTF-16 length is recounted on demand; offsets in the untouched
+    // prefix stay valid
+    owner.utf16.length = Utf16Index.unknown;
+    if (owner.utf16.checkpoint.byte > start) owner.utf16.checkpoint = .{};
+    dropChunks(owner, start);
+
+    const aliased = @intFromPtr(replacement.ptr) < @intFromPtr(current.ptr) + current.len and
+        @intFromPtr(current.ptr) < @intFromPtr(replacement.ptr) + replacement.len;
+
+    // In place while the data is long and fills at least a quarter of the buffer
+    if (new_len >= in_place_threshold and new_len <= current.len and new_len >= current.len / 4 and !aliased) {
+        const tail_len = old.len - end;
+        const new_end = start + replacement.len;
+        if (new_end < end) {
+            std.mem.copyForwards(u8, current[new_end..][0..tail_len], old[end..]);
+        } else if (new_end > end) {
+            std.mem.copyBackwards(u8, current[new_end..][0..tail_len], old[end..]);
+        }
+        @memcpy(current[start..new_end], replacement);
+        owner.data = current[0..new_len];
+        owner.capacity = current.len;
+        return;
+    }
+
+    const capacity = if (new_len >= in_place_threshold) new_len + new_len / 2 else new_len;
+    const new_buffer = try owner.prototype.allocator.alloc(u8, capacity);
+    @memcpy(new_buffer[0..start], old[0..start]);
+    @memcpy(new_buffer[start..][0..replacement.len], replacement);
+    @memcpy(new_buffer[start + replacement.len ..][0 .. old.len - end], old[end..]);
+
+    owner.prototype.allocator.free(current);
+    owner.data = new_buffer[0..new_len];
+    owner.capacity = if (capacity > new_len) capacity else 0;
+}
+
+/// Replaces the bytes `start..end` of the data of `owner` with
+/// `replacement` ("replace data" in the spec, with byte offsets): updates
+/// the storage, live ranges and generation and queues the characterData
+/// record.
+///
+/// ## Errors
+/// - `error.OutOfMemory`: Failed to allocate (data unchanged)
+/// - `error.NoModificationAllowedError`: The owner's document is frozen
+pub fn replaceBytes(owner: anytype, start: usize, end: usize, replacement: []const u8) (Allocator.Error || error{NoModificationAllowedError})!void {
+    const node: *node_mod.Node = &owner.prototype;
+    try node.checkMutable();
+
+    // Capture old value for mutation observers (before modification)
+    const old_value: ?[]u8 = if (node_mod.hasMutationObservers(node))
+        try node.allocator.dupe(u8, owner.data)
+    else
+        null;
+    defer if (old_value) |value| node.allocator.free(value);
+
+    try spliceData(owner, start, end, replacement);
+    node.generation += 1;
+    node.invalidateHashes();
+    range_mod.dataReplaced(node, start, end - start, replacement.len);
+
+    // Queue mutation record for characterData
+    if (old_value) |value| {
+        node_mod.queueMutationRecord(
+            node,
+            "characterData",
+            null, // added_nodes
+            null, // removed_nodes
+            null, // previous_sibling
+            null, // next_sibling
+            null, // attribute_name
+            null, // attribute_namespace
+            value, // old_value
+        ) catch {}; // Best effort
+    }
+}
+
+// ============================================================================
+// UTF-16 Offsets (Text and Comment)
+// ============================================================================
+
+/// A code point boundary of the data: its byte offset and UTF-16 offset.
+pub const Position = struct {
+    byte: u32 = 0,
+    unit: u32 = 0,
+};
+
+/// UTF-16 view of the data of a Text or Comment (its `utf16` field).
+///
+/// `length` is the data's length in UTF-16 code units, counted on first use
+/// after a byte-level edit; it equals the byte length exactly when the data
+/// is ASCII, which then needs no conversion at all. `checkpoint` is the
+/// last position converted in short data, from which the next conversion
+/// scans; long data uses the `Utf16Chunks` in the node's rare data instead.
+/// Only well-formed UTF-8 below 4 GiB is indexed (other data keeps `length`
+/// unknown and is scanned from the start every time).
+pub const Utf16Index = struct {
+    length: u32 = unknown,
+    checkpoint: Position = .{},
+
+    pub const unknown = std.math.maxInt(u32);
+};
+
+/// UTF-16 code units (and bytes) per entry of the `Utf16Chunks` tables.
+pub const chunk_len: u32 = 256;
+
+/// Offset tables of long non-ASCII data (`in_place_threshold` bytes or
+/// more), kept in the node's rare data: a conversion reads the entry of its
+/// chunk and scans at most one chunk from there, wherever it is in the data.
+///
+/// `units[j]` is the UTF-16 offset of the code point containing byte
+/// `j * chunk_len`; `bytes[j]` is the code point containing code unit
+/// `j * chunk_len`. Both are built lazily, only as far as a conversion
+/// needs, by one scan that resumes at `scan`. An edit drops the entries
+/// from its start on, so typing into a long node only rebuilds the chunks
+/// around the edit, the next time they are needed.
+pub const Utf16Chunks = struct {
+    units: std.ArrayListUnmanaged(u32) = .{},
+    bytes: std.ArrayListUnmanaged(Position) = .{},
+    scan: Position = .{},
+
+    pub fn deinit(self: *Utf16Chunks, allocator: Allocator) void {
+        self.units.deinit(allocator);
+        self.bytes.deinit(allocator);
+    }
+
+    /// Drops the entries that depend on the data from byte `start` on.
+    fn truncate(self: *Utf16Chunks, start: usize) void {
+        if (self.scan.byte <= start) return;
+
+        // Resume at the last `bytes` entry at or before `start`
+        var low: usize = 0;
+        var high: usize = self.bytes.items.len;
+        while (low < high) {
+            const mid = (low + high) / 2;
+            if (self.bytes.items[mid].byte <= start) low = mid + 1 else high = mid;
+        }
+        const resume_at: Position = if (low > 0) self.bytes.items[low - 1] else .{};
+        self.bytes.shrinkRetainingCapacity(low -| 1);
+        self.units.shrinkRetainingCapacity(@min(self.units.items.len, std.math.divCeil(u32, resume_at.byte, chunk_len) catch unreachable));
+        self.scan = resume_at;
+    }
+
+    /// Scans `data` until the tables cover byte `byte` and code unit
+    /// `unit`, or the data ends.
+    fn extend(self: *Utf16Chunks, allocator: Allocator, data: []const u8, byte: usize, unit: usize) Allocator.Error!void {
+        var at = self.scan;
+        defer self.scan = at;
+        while (at.byte < data.len and (self.units.items.len * chunk_len <= byte or self.bytes.items.len * chunk_len <= unit)) {
+            const lead = data[at.byte];
+            const len: u32 = std.unicode.utf8ByteSequenceLength(lead) catch unreachable;
+            const width: u32 = if (len == 4) 2 else 1;
+            // One entry per chunk start this code point covers (appending
+            // again after a failed append adds nothing twice)
+            while (self.units.items.len * chunk_len < at.byte + len) try self.units.append(allocator, at.unit);
+            while (self.bytes.items.len * chunk_len < at.unit + width) try self.bytes.append(allocator, at);
+            at.byte += len;
+            at.unit += width;
+        }
+    }
+
+    /// The last code point boundary at or before byte `byte`.
+    fn fromByte(self: *const Utf16Chunks, data: []const u8, byte: usize) Position {
+        const j = byte / chunk_len;
+        var at = self.scan;
+        if (j < self.units.items.len) {
+            var start = j * chunk_len;
+            while (data[start] & 0xC0 == 0x80) start -= 1;
+            at = .{ .byte = @intCast(start), .unit = self.units.items[j] };
+        }
+        return scanToByte(data, at, byte);
+    }
+
+    /// The code point boundary at (or, inside a surrogate pair, just
+    /// before) code unit `unit`.
+    fn fromUnit(self: *const Utf16Chunks, data: []const u8, unit: usize) Position {
+        const j = unit / chunk_len;
+        const at = if (j < self.bytes.items.len) self.bytes.items[j] else self.scan;
+        return scanToUnit(data, at, unit);
+    }
+};
+
+/// Scans well-formed `data` forward from `at` to the last code point
+/// boundary at or before byte `byte`.
+fn scanToByte(data: []const u8, from: Position, byte: usize) Position {
+    var at = from;
+    while (at.byte < byte) {
+        const lead = data[at.byte];
+        const len: u32 = std.unicode.utf8ByteSequenceLength(lead) catch unreachable;
+        if (at.byte + len > byte) break;
+        at.byte += len;
+        at.unit += if (len == 4) 2 else 1;
+    }
+    return at;
+}
+
+/// Scans well-formed `data` forward from `at` to the code point boundary
+/// at (or, inside a surrogate pair, just before) code unit `unit`.
+fn scanToUnit(data: []const u8, from: Position, unit: usize) Position {
+    var at = from;
+    while (at.byte < data.len) {
+        const lead = data[at.byte];
+        const width: u32 = if (lead >= 0xF0) 2 else 1;
+        if (at.unit + width > unit) break;
+        at.byte += std.unicode.utf8ByteSequenceLength(lead) catch unreachable;
+        at.unit += width;
+    }
+    return at;
+}
+
+/// The `Utf16Chunks` of long indexed data, created on first use (null:
+/// the data is short, or they could not be allocated). With `shared` set
+/// (see isShared) only existing tables are returned; nothing is created.
+fn chunksOf(owner: anytype, shared: bool) ?*Utf16Chunks {
+    if (owner.data.len < in_place_threshold) return null;
+    const node: *node_mod.Node = &owner.prototype;
+    if (shared) {
+        const rare = node.rare_data orelse return null;
+        return rare.utf16_chunks;
+    }
+    const rare = node.ensureRareData() catch return null;
+    if (rare.utf16_chunks == null) {
+        const chunks = rare.allocator.create(Utf16Chunks) catch return null;
+        chunks.* = .{};
+        rare.utf16_chunks = chunks;
+    }
+    return rare.utf16_chunks;
+}
+
+/// Drops the offset tables of `owner` from byte `start` on (all of them,
+/// and their memory, from 0).
+fn dropChunks(owner: anytype, start: usize) void {
+    const node: *node_mod.Node = &owner.prototype;
+    const rare = node.rare_data orelse return;
+    const chunks = rare.utf16_chunks orelse return;
+    if (start > 0) {
+        chunks.truncate(start);
+        return;
+    }
+    chunks.deinit(rare.allocator);
+    rare.allocator.destroy(chunks);
+    rare.utf16_chunks = null;
+}
+
+/// True when the owner's document is frozen. Frozen documents may be read
+/// on several threads, so conversions only read the index there and never
+/// record a length or checkpoint, or create or extend `Utf16Chunks`.
+fn isShared(owner: anytype) bool {
+    const node: *const node_mod.Node = &owner.prototype;
+    node.checkMutable() catch return true;
+    return false;
+}
+
+/// Returns the length of the data of `owner` in UTF-16 code units.
+pub fn utf16Length(owner: anytype) usize {
+    const string_utils = @import("string_utils.zig");
+    if (owner.utf16.length != Utf16Index.unknown) return owner.utf16.length;
+
+    const data = owner.data;
+    const shared = isShared(owner);
+    if (string_utils.isAscii(data)) {
+        if (!shared and data.len < Utf16Index.unknown) owner.utf16.length = @intCast(data.len);
+        return data.len;
+    }
+    const length = string_utils.utf16Length(data);
+    if (!shared and data.len < Utf16Index.unknown and std.unicode.utf8ValidateSlice(data)) {
+        owner.utf16.length = @intCast(length);
+    }
+    return length;
+}
+
+/// The position of code unit `offset` (at most the length) in indexed
+/// non-ASCII data.
+fn unitPosition(owner: anytype, offset: usize) Position {
+    const data = owner.data;
+    const shared = isShared(owner);
+    if (chunksOf(owner, shared)) |chunks| {
+        if (!shared) chunks.extend(owner.prototype.allocator, data, 0, offset) catch {};
+        return chunks.fromUnit(data, offset);
+    }
+    const checkpoint = owner.utf16.checkpoint;
+    const at = scanToUnit(data, if (checkpoint.unit <= offset) checkpoint else .{}, offset);
+    if (!shared) owner.utf16.checkpoint = at;
+    return at;
+}
+
+/// The position of byte `byte` (at most the length) in indexed non-ASCII
+/// data.
+fn bytePosition(owner: anytype, byte: usize) Position {
+    const data = owner.data;
+    const shared = isShared(owner);
+    if (chunksOf(owner, shared)) |chunks| {
+        if (!shared) chunks.extend(owner.prototype.allocator, data, byte, 0) catch {};
+        return chunks.fromByte(data, byte);
+    }
+    const checkpoint = owner.utf16.checkpoint;
+    const at = scanToByte(data, if (checkpoint.byte <= byte) checkpoint else .{}, byte);
+    if (!shared) owner.utf16.checkpoint = at;
+    return at;
+}
+
+/// Returns the byte offset of the UTF-16 offset `offset` (at most the
+/// length) in the data of `owner`. An offset inside a surrogate pair maps
+/// to the start of its code point, like
+/// `string_utils.utf16OffsetToUtf8Byte()`.
+pub fn utf16ToByte(owner: anytype, offset: usize) usize {
+    const string_utils = @import("string_utils.zig");
+    const length = utf16Length(owner);
+    if (length == owner.data.len) return offset;
+    if (owner.utf16.length == Utf16Index.unknown) return string_utils.utf16OffsetToUtf8Byte(owner.data, offset);
+    return unitPosition(owner, offset).byte;
+}
+
+/// Returns the UTF-16 offset of the byte offset `byte` (at most the byte
+/// length) in the data of `owner`; a byte inside a code point maps to the
+/// offset of that code point.
+pub fn byteToUtf16(owner: anytype, byte: usize) usize {
+    const string_utils = @import("string_utils.zig");
+    const length = utf16Length(owner);
+    if (length == owner.data.len) return byte;
+    if (owner.utf16.length == Utf16Index.unknown) return string_utils.utf8ByteToUtf16Offset(owner.data, byte);
+    return bytePosition(owner, byte).unit;
+}
+
+/// Returns the data of `owner` from UTF-16 offset `offset`, `count` code
+/// units long (clamped to the end): "substring data", as a slice of the
+/// data (valid until the next edit).
+///
+/// ## Errors
+/// - `error.IndexSizeError`: `offset` is greater than the length
+pub fn sliceUtf16(owner: anytype, offset: usize, count: usize) error{IndexSizeError}![]const u8 {
+    const length = utf16Length(owner);
+    if (offset > length) return error.IndexSizeError;
+
+    const start = utf16ToByte(owner, offset);
+    const end = utf16ToByte(owner, offset + @min(count, length - offset));
+    return owner.data[start..end];
+}
+
+/// Replaces `count` UTF-16 code units (clamped to the end) of the data of
+/// `owner` at UTF-16 offset `offset` with `replacement`: "replace data" with
+/// DOMString offsets, through `replaceBytes()`. The length stays cached,
+/// with the checkpoint after the replacement, where the next edit usually
+/// is.
+///
+/// ## Errors
+/// - `error.IndexSizeError`: `offset` is greater than the length
+/// - `error.OutOfMemory`: Failed to allocate (data unchanged)
+/// - `error.NoModificationAllowedError`: The owner's document is frozen
+pub fn replaceUtf16(
+    owner: anytype,
+    offset: usize,
+    count: usize,
+    replacement: []const u8,
+) (Allocator.Error || error{ IndexSizeError, NoModificationAllowedError })!void {
+    const string_utils = @import("string_utils.zig");
+    const length = utf16Length(owner);
+    if (offset > length) return error.IndexSizeError;
+    const end_offset = offset + @min(count, length - offset);
+
+    // The exact positions of both ends
+    const indexed = owner.utf16.length != Utf16Index.unknown;
+    var start: Position = .{ .byte = @intCast(offset), .unit = @intCast(offset) };
+    var end: Position = .{ .byte = @intCast(end_offset), .unit = @intCast(end_offset) };
+    if (!indexed) {
+        start.byte = @intCast(string_utils.utf16OffsetToUtf8Byte(owner.data, offset));
+        end.byte = @intCast(string_utils.utf16OffsetToUtf8Byte(owner.data, end_offset));
+    } else if (length != owner.data.len) {
+        start = unitPosition(owner, offset);
+        end = unitPosition(owner, end_offset);
+    }
+
+    // Count the replacement before the edit (it may point into the data)
+    const replacement_units: ?usize = if (string_utils.isAscii(replacement))
+        replacement.len
+    else if (std.unicode.utf8ValidateSlice(replacement))
+        string_utils.utf16Length(replacement)
+    else
+        null;
+
+    try replaceBytes(owner, start.byte, end.byte, replacement);
+
+    if (!indexed or owner.data.len >= Utf16Index.unknown) return;
+    const units = replacement_units orelse return;
+    owner.utf16 = .{
+        .length = @intCast(length - (end.unit - start.unit) + units),
+        .checkpoint = .{
+            .byte = @intCast(start.byte + replacement.len),
+            .unit = @intCast(start.unit + units),
+        },
+    };
+}
+
+// ============================================================================
+// DOM Offsets (any node)
+// ============================================================================
+
+/// The node that stores the data of a CharacterData node (CDATASection and
+/// ProcessingInstruction embed a Text).
+pub const Owner = union(enum) {
+    text: *@import("text.zig").Text,
+    comment: *@import("comment.zig").Comment,
+};
+
+/// Returns the owner of the data of `node`, or null if it is not
+/// character data.
+pub fn ownerOf(node: *node_mod.Node) ?Owner {
+    return switch (node.node_type) {
+        .text, .cdata_section, .processing_instruction => .{ .text = @fieldParentPtr("prototype", node) },
+        .comment => .{ .comment = @fieldParentPtr("prototype", node) },
+        else => null,
+    };
+}
+
+/// Converts a DOM offset in `node` (UTF-16 code units in character data,
+/// a child index elsewhere) to the offset live ranges keep (bytes in
+/// character data). Offsets past the end keep their distance from it, so
+/// Range still rejects them and StaticRange reads them back as given (while
+/// the data is unchanged).
+pub fn toByteOffset(node: *node_mod.Node, offset: u32) u32 {
+    const owner = ownerOf(node) orelse return offset;
+    return switch (owner) {
+        inline else => |data_owner| blk: {
+            const length = utf16Length(data_owner);
+            if (offset > length) break :blk std.math.lossyCast(u32, data_owner.data.len + (offset - length));
+            break :blk @intCast(utf16ToByte(data_owner, offset));
+        },
+    };
+}
+
+/// Converts an offset kept by a range (see `toByteOffset()`) back to a DOM
+/// offset.
+pub fn toDomOffset(node: *node_mod.Node, offset: u32) u32 {
+    const owner = ownerOf(node) orelse return offset;
+    return switch (owner) {
+        inline else => |data_owner| blk: {
+            const len = data_owner.data.len;
+            if (offset > len) break :blk std.math.lossyCast(u32, utf16Length(data_owner) + (offset - len));
+            break :blk @intCast(byteToUtf16(data_owner, offset));
+        },
+    };
+}
@@ -0,0 +1,237 @@
+//! Class Index - Optional per-document map from class token to elements
+//!
+//! Document-wide `getElementsByClassName()` collections normally walk the
+//! whole tree on every `length` and `item()` (with bloom-filter rejection).
+//! Code that polls a collection every frame pays that walk each time. Once
+//! enabled with `Document.enableClassIndex()`, the document keeps an
+//! inverted index from each interned class token to the connected elements
+//! carrying it, and such collections answer from the index instead.
+//!
+//! ## Maintenance
+//!
+//! The index is updated when a connected element's class attribute changes
+//! (setAttribute, className, classList and removeAttribute all go through
+//! the same attribute path) and when elements are connected to or
+//! disconnected from the document. Shadow trees are not indexed, matching
+//! the tree-walking collections (each shadow root indexes its own tree,
+//! see shadow_index.zig).
+//!
+//! ## Ordering
+//!
+//! Members are kept in an insertion-ordered set, so adding and removing is
+//! O(1). `length` is the set size. The set is sorted into tree order lazily,
+//! on the first `item()` after a change, so a burst of mutations costs one
+//! sort.
+//!
+//! ## Batches
+//!
+//! Inside a document mutation batch (`Document.beginBatch()`), the first
+//! class change drops the index instead of updating it, and maintenance
+//! stops. The index is rebuilt in one pass when the batch ends, or earlier
+//! if a collection reads it, so bulk class writes cost one tree walk.
+//! Outside a batch, an invalidated index can also be rebuilt a slice at a
+//! time from idle work (see idle_work.zig).
+
+const std = @import("std");
+const Allocator = std.mem.Allocator;
+const Element = @import("element.zig").Element;
+const Node = @import("node.zig").Node;
+const StringPool = @import("document.zig").StringPool;
+const ElementIterator = @import("element_iterator.zig").ElementIterator;
+const Budget = @import("idle_work.zig").Budget;
+
+pub const ClassIndex = struct {
+    allocator: Allocator,
+    map: std.StringHashMapUnmanaged(Entry) = .{},
+
+    /// Tree and pool the index was built from (for rebuilds)
+    document: ?*Node = null,
+    pool: ?*StringPool = null,
+
+    /// True when the index was dropped (see invalidate) and must be rebuilt
+    /// before it is read; maintenance is skipped meanwhile
+    stale: bool = false,
+
+    /// Rebuild of a stale index in progress (see rebuildStep)
+    rebuilding: ?Rebuild = null,
+
+    /// Connected elements with one class token
+    const Entry = struct {
+        members: std.AutoArrayHashMapUnmanaged(*Element, void) = .{},
+        /// False when members are no longer in tree order
+        sorted: bool = true,
+    };
+
+    /// Resume point of an incremental rebuild, valid while the document's
+    /// mutation version is still `version`
+    const Rebuild = struct {
+        iterator: ElementIterator,
+        version: u64,
+    };
+
+    pub fn init(allocator: Allocator) ClassIndex {
+        return .{ .allocator = allocator };
+    }
+
+    pub fn deinit(self: *ClassIndex) void {
+        self.clearEntries();
+        self.map.deinit(self.allocator);
+    }
+
+    /// Indexes every element of the document tree rooted at `document`.
+    pub fn build(self: *ClassIndex, pool: *StringPool, document: *Node) !void {
+        self.document = document;
+        self.pool = pool;
+        var iter = ElementIterator.init(document);
+        while (iter.next()) |elem| {
+            if (elem.getAttribute("class")) |class_value| {
+                try self.addTokens(pool, class_value, elem);
+            }
+        }
+    }
+
+    /// Drops every entry; the index is rebuilt on the next read (or
+    /// `refresh()`), and changes are not tracked until then.
+    pub fn invalidate(self: *ClassIndex) void {
+        if (self.stale) return;
+        self.clearEntries();
+        self.stale = true;
+    }
+
+    /// Rebuilds the index if it was invalidated. On allocation failure the
+    /// index stays stale (reads see it empty) and the next read retries.
+    pub fn refresh(self: *ClassIndex) void {
+        if (!self.stale) return;
+        const document = self.document orelse return;
+        // Entries of an unfinished rebuildStep are redone from the start
+        self.clearEntries();
+        self.rebuilding = null;
+        self.stale = false;
+        self.build(self.pool.?, document) catch {
+            self.clearEntries();
+            self.stale = true;
+        };
+    }
+
+    /// Continues rebuilding a stale index for one slice of `budget`.
+    /// `version` is the document's mutation version; if the document
+    /// changed since the previous slice, the rebuild starts over. Reads
+    /// meanwhile rebuild the index in one pass, as without slices.
+    ///
+    /// ## Returns
+    /// True once the index is current, false if the budget ran out first.
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to grow the index (the next step
+    ///   starts over)
+    pub fn rebuildStep(self: *ClassIndex, version: u64, budget: *Budget) !bool {
+        if (!self.stale) return true;
+        const document = self.document orelse return true;
+        if (self.rebuilding == null or self.rebuilding.?.version != version) {
+            self.clearEntries();
+            self.rebuilding = .{ .iterator = ElementIterator.init(document), .version = version };
+        }
+        errdefer self.rebuilding = null;
+
+        const rebuild = &self.rebuilding.?;
+        while (!budget.tick()) {
+            const elem = rebuild.iterator.next() orelse {
+                self.rebuilding = null;
+                self.stale = false;
+                return true;
+            };
+            if (elem.getAttribute("class")) |class_value| {
+                try self.insertTokens(self.pool.?, class_value, elem);
+            }
+        }
+        return false;
+    }
+
+    /// Adds `element` under every token of `class_value`.
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to grow the index or intern a token
+    pub fn addTokens(self: *ClassIndex, pool: *StringPool, class_value: []const u8, element: *Element) !void {
+        if (self.stale) return;
+        return self.insertTokens(pool, class_value, element);
+    }
+
+    fn insertTokens(self: *ClassIndex, pool: *StringPool, class_value: []const u8, element: *Element) !void {
+        var tokens = std.mem.tokenizeScalar(u8, class_value, ' ');
+        while (tokens.next()) |token| {
+            const result = try self.map.getOrPut(self.allocator, token);
+            if (!result.found_existing) {
+                // Store the interned copy as the key
+                result.key_ptr.* = pool.intern(token) catch |err| {
+                    self.map.removeByPtr(result.key_ptr);
+                    return err;
+                };
+                result.value_ptr.* = .{};
+            }
+
+            const entry = result.value_ptr;
+            const member = try entry.members.getOrPut(self.allocator, element);
+            if (!member.found_existing and entry.members.count() > 1) {
+                entry.sorted = false;
+            }
+        }
+    }
+
+    /// Removes `element` from under every token of `class_value`.
+    pub fn removeTokens(self: *ClassIndex, class_value: []const u8, element: *Element) void {
+        if (self.stale) return;
+        var tokens = std.mem.tokenizeScalar(u8, class_value, ' ');
+        while (tokens.next()) |token| {
+            const entry = self.map.getPtr(token) orelse continue;
+            if (entry.members.swapRemove(element)) {
+                entry.sorted = false;
+            }
+        }
+    }
+
+    /// Returns the number of connected elements with class `class_name`.
+    pub fn count(self: *ClassIndex, class_name: []const u8) usize {
+        self.refresh();
+        const entry = self.map.getPtr(class_name) orelse return 0;
+        return entry.members.count();
+    }
+
+    /// Returns the element at `index` in tree order among those with class
+    /// `class_name`, or null.
+    pub fn item(self: *ClassIndex, class_name: []const u8, index: usize) ?*Element {
+        const members = self.elements(class_name);
+        if (index >= members.len) return null;
+        return members[index];
+    }
+
+    /// Returns the elements with class `class_name` in tree order. The slice
+    /// is invalidated by the next change to the index.
+    pub fn elements(self: *ClassIndex, class_name: []const u8) []const *Element {
+        self.refresh();
+        const entry = self.map.getPtr(class_name) orelse return &.{};
+
+        if (!entry.sorted) {
+            entry.members.sort(TreeOrder{ .keys = entry.members.keys() });
+            entry.sorted = true;
+        }
+        return entry.members.keys();
+    }
+
+    fn clearEntries(self: *ClassIndex) void {
+        var it = self.map.valueIterator();
+        while (it.next()) |entry| {
+            entry.members.deinit(self.allocator);
+        }
+        self.map.clearRetainingCapacity();
+    }
+
+    const TreeOrder = struct {
+        keys: []*Element,
+
+        pub fn lessThan(ctx: TreeOrder, a_index: usize, b_index: usize) bool {
+            const a = &ctx.keys[a_index].prototype;
+            const b = &ctx.keys[b_index].prototype;
+            return a.compareDocumentPosition(b) & Node.DOCUMENT_POSITION_FOLLOWING != 0;
+        }
+    };
+};
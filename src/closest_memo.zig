@@ -0,0 +1,146 @@
+//! Closest Memo - Remembered closest() answers for event delegation
+//!
+//! Delegated event handlers call `target.closest(selector)` on every event,
+//! with the same few selectors, from targets that share most of their
+//! ancestors. A ClosestMemo remembers the answer per (element, selector):
+//! the next call from a nearby target stops at the first ancestor already
+//! answered instead of matching every ancestor up to the root, and every
+//! element walked past is answered in turn.
+//!
+//! ## Validity
+//!
+//! Answers are valid until the document's mutation version changes (any
+//! child list or attribute change), at which point the memo forgets
+//! everything. Only connected elements are remembered: a node is freed
+//! only after being removed, which bumps the version, so a remembered
+//! pointer is never reused by another node. The memo holds a reference on
+//! every selector it has answers for.
+//!
+//! A memo belongs to one caller (the bindings keep one per event dispatch)
+//! and is not thread-safe.
+//!
+//! ## Usage
+//!
+//! ```zig
+//! var memo = ClosestMemo.init(allocator);
+//! defer memo.deinit();
+//!
+//! const parsed = try doc.selector_cache.acquire(".row");
+//! defer parsed.release();
+//! const row = try memo.closest(target, parsed);
+//! ```
+
+const std = @import("std");
+const Allocator = std.mem.Allocator;
+const Element = @import("element.zig").Element;
+const Node = @import("node.zig").Node;
+const Document = @import("document.zig").Document;
+const ParsedSelector = @import("document.zig").ParsedSelector;
+const Matcher = @import("selector/matcher.zig").Matcher;
+
+pub const ClosestMemo = struct {
+    allocator: Allocator,
+
+    /// Document the answers belong to, and its mutation version then
+    document: ?*const Document = null,
+    version: u64 = 0,
+
+    /// closest() result per element and selector
+    answers: std.AutoHashMapUnmanaged(Key, ?*Element) = .{},
+
+    /// Selectors referenced by `answers` (one reference each)
+    selectors: std.ArrayList(*ParsedSelector) = .{},
+
+    const Key = struct {
+        element: *const Element,
+        selector: *const ParsedSelector,
+    };
+
+    pub fn init(allocator: Allocator) ClosestMemo {
+        return .{ .allocator = allocator };
+    }
+
+    pub fn deinit(self: *ClosestMemo) void {
+        self.clear();
+        self.answers.deinit(self.allocator);
+        self.selectors.deinit(self.allocator);
+    }
+
+    /// Forgets every answer and releases the selectors.
+    pub fn clear(self: *ClosestMemo) void {
+        for (self.selectors.items) |parsed| parsed.release();
+        self.selectors.clearRetainingCapacity();
+        self.answers.clearRetainingCapacity();
+        self.document = null;
+    }
+
+    /// Number of remembered answers.
+    pub fn count(self: *const ClosestMemo) usize {
+        return self.answers.count();
+    }
+
+    /// Element.closest() for a parsed selector, answered from and recorded
+    /// in the memo.
+    ///
+    /// Elements without a document or not connected are matched without
+    /// the memo.
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to record an answer
+    pub fn closest(self: *ClosestMemo, element: *Element, parsed: *ParsedSelector) !?*Element {
+        const owner = element.prototype.owner_document orelse return try element.closestParsed(self.allocator, parsed);
+        if (owner.node_type != .document or !element.prototype.isConnected()) {
+            return try element.closestParsed(self.allocator, parsed);
+        }
+        const doc: *const Document = @fieldParentPtr("prototype", owner);
+
+        if (self.document != doc or self.version != doc.mutation_version) {
+            self.clear();
+            self.document = doc;
+            self.version = doc.mutation_version;
+        }
+        try self.hold(parsed);
+
+        // Walk up to the first element answered before or matching
+        const matcher = Matcher.init(self.allocator);
+        var answer: ?*Element = null;
+        var stop: ?*Element = null;
+        var current: ?*Node = &element.prototype;
+        while (current) |node| {
+            if (node.node_type == .element) {
+                const elem: *Element = @fieldParentPtr("prototype", node);
+                if (self.answers.get(.{ .element = elem, .selector = parsed })) |known| {
+                    answer = known;
+                    stop = elem;
+                    break;
+                }
+                if (try matcher.matches(elem, &parsed.selector_list)) {
+                    answer = elem;
+                    stop = elem;
+                    break;
+                }
+            }
+            current = node.parent_node;
+        }
+
+        // Every element walked past has the same answer
+        current = &element.prototype;
+        while (current) |node| {
+            if (node.node_type == .element) {
+                const elem: *Element = @fieldParentPtr("prototype", node);
+                try self.answers.put(self.allocator, .{ .element = elem, .selector = parsed }, answer);
+                if (elem == stop) break;
+            }
+            current = node.parent_node;
+        }
+
+        return answer;
+    }
+
+    /// Takes a reference on `parsed` the first time it is used.
+    fn hold(self: *ClosestMemo, parsed: *ParsedSelector) !void {
+        if (std.mem.indexOfScalar(*ParsedSelector, self.selectors.items, parsed) != null) return;
+        try self.selectors.append(self.allocator, parsed);
+        parsed.acquire();
+    }
+};
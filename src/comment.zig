@@ -260,6 +260,8 @@
 const std = @import("std");
 const Allocator = std.mem.Allocator;
 const node_mod = @import("node.zig");
+const range_mod = @import("range.zig");
+const character_data = @import("character_data.zig");
 const Node = node_mod.Node;
 const NodeType = node_mod.NodeType;
 const NodeVTable = node_mod.NodeVTable;
@@ -283,6 +285,15 @@ pub const Comment = struct {
     /// Allocated and freed by this Comment node
     data: []u8,
 
+    /// Length of the buffer `data` starts, when long data keeps spare room
+    /// for in-place edits (0: the buffer is exactly `data`; see
+    /// character_data.zig)
+    capacity: usize = 0,
+
+    /// UTF-16 length and last converted offset of `data`, for DOMString
+    /// offsets (see character_data.Utf16Index)
+    utf16: character_data.Utf16Index = .{},
+
     /// Vtable for Comment nodes.
     const vtable = NodeVTable{
         .deinit = deinitImpl,
@@ -420,6 +431,8 @@ pub const Comment = struct {
 
         // Initialize Comment-specific fields
         comment.data = data;
+        comment.capacity = 0;
+        comment.utf16 = .{};
 
         return comment;
     }
@@ -468,32 +481,8 @@ pub const Comment = struct {
     /// ## Errors
     /// - `error.OutOfMemory`: Failed to allocate new string
     pub fn appendData(self: *Comment, text_to_append: []const u8) !void {
-        // Capture old value for mutation observers (before modification)
-        const old_value = try self.prototype.allocator.dupe(u8, self.data);
-        defer self.prototype.allocator.free(old_value);
-
-        const new_data = try std.mem.concat(
-            self.prototype.allocator,
-            u8,
-            &[_][]const u8{ self.data, text_to_append },
-        );
-
-        self.prototype.allocator.free(self.data);
-        self.data = new_data;
-        self.prototype.generation += 1;
-
-        // Queue mutation record for characterData
-        node_mod.queueMutationRecord(
-            &self.prototype,
-            "characterData",
-            null, // added_nodes
-            null, // removed_nodes
-            null, // previous_sibling
-            null, // next_sibling
-            null, // attribute_name
-            null, // attribute_namespace
-            old_value, // old_value
-        ) catch {}; // Best effort
+        const len = self.data.len;
+        try character_data.replaceBytes(self, len, len, text_to_append);
     }
 
     /// Inserts text at the specified offset.
@@ -510,32 +499,7 @@ pub const Comment = struct {
             return error.IndexOutOfBounds;
         }
 
-        // Capture old value for mutation observers (before modification)
-        const old_value = try self.prototype.allocator.dupe(u8, self.data);
-        defer self.prototype.allocator.free(old_value);
-
-        const new_data = try std.mem.concat(
-            self.prototype.allocator,
-            u8,
-            &[_][]const u8{ self.data[0..offset], text_to_insert, self.data[offset..] },
-        );
-
-        self.prototype.allocator.free(self.data);
-        self.data = new_data;
-        self.prototype.generation += 1;
-
-        // Queue mutation record for characterData
-        node_mod.queueMutationRecord(
-            &self.prototype,
-            "characterData",
-            null, // added_nodes
-            null, // removed_nodes
-            null, // previous_sibling
-            null, // next_sibling
-            null, // attribute_name
-            null, // attribute_namespace
-            old_value, // old_value
-        ) catch {}; // Best effort
+        try character_data.replaceBytes(self, offset, offset, text_to_insert);
     }
 
     /// Deletes text at the specified offset.
@@ -552,34 +516,8 @@ pub const Comment = struct {
             return error.IndexOutOfBounds;
         }
 
-        // Capture old value for mutation observers (before modification)
-        const old_value = try self.prototype.allocator.dupe(u8, self.data);
-        defer self.prototype.allocator.free(old_value);
-
         const end = @min(offset + count, self.data.len);
-
-        const new_data = try std.mem.concat(
-            self.prototype.allocator,
-            u8,
-            &[_][]const u8{ self.data[0..offset], self.data[end..] },
-        );
-
-        self.prototype.allocator.free(self.data);
-        self.data = new_data;
-        self.prototype.generation += 1;
-
-        // Queue mutation record for characterData
-        node_mod.queueMutationRecord(
-            &self.prototype,
-            "characterData",
-            null, // added_nodes
-            null, // removed_nodes
-            null, // previous_sibling
-            null, // next_sibling
-            null, // attribute_name
-            null, // attribute_namespace
-            old_value, // old_value
-        ) catch {}; // Best effort
+        try character_data.replaceBytes(self, offset, end, "");
     }
 
     /// Replaces text at the specified offset.
@@ -603,33 +541,7 @@ pub const Comment = struct {
         }
 
         const end = @min(offset + count, self.data.len);
-
-        // Capture old value for mutation observers (before modification)
-        const old_value = try self.prototype.allocator.dupe(u8, self.data);
-        defer self.prototype.allocator.free(old_value);
-
-        const new_data = try std.mem.concat(
-            self.prototype.allocator,
-            u8,
-            &[_][]const u8{ self.data[0..offset], replacement, self.data[end..] },
-        );
-
-        self.prototype.allocator.free(self.data);
-        self.data = new_data;
-        self.prototype.generation += 1;
-
-        // Queue mutation record for characterData
-        node_mod.queueMutationRecord(
-            &self.prototype,
-            "characterData",
-            null, // added_nodes
-            null, // removed_nodes
-            null, // previous_sibling
-            null, // next_sibling
-            null, // attribute_name
-            null, // attribute_namespace
-            old_value, // old_value
-        ) catch {}; // Best effort
+        try character_data.replaceBytes(self, offset, end, replacement);
     }
 
     // ========================================================================
@@ -1010,14 +922,14 @@ pub const Comment = struct {
                 // Get Document from its node field (node is first field)
                 const Document = @import("document.zig").Document;
                 const doc: *Document = @fieldParentPtr("prototype", owner_doc);
-                doc.releaseNodeRef();
+                doc.releaseNodeRef(node);
             }
         }
 
         // Clean up rare data if allocated
         comment.prototype.deinitRareData();
 
-        comment.prototype.allocator.free(comment.data);
+        character_data.freeData(comment);
         comment.prototype.allocator.destroy(comment);
     }
 
@@ -1040,9 +952,11 @@ pub const Comment = struct {
         const new_data = try node.allocator.dupe(u8, value);
 
         // Free old and replace
-        node.allocator.free(comment.data);
-        comment.data = new_data;
+        const old_len = comment.data.len;
+        character_data.takeData(comment, new_data);
         node.generation += 1;
+        node.invalidateHashes();
+        range_mod.dataReplaced(node, 0, old_len, new_data.len);
     }
 
     /// Vtable implementation: clone node
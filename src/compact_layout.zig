@@ -0,0 +1,231 @@
+//! Compact Layout - Optional per-document struct-of-arrays element table
+//!
+//! Every Node carries its tree links as full pointers, so a selector scan
+//! over a subtree chases `first_child`/`next_sibling` from one fat node to
+//! the next (Text and Comment nodes included), touching a cache line or two
+//! per node just to find the next element to test. Once enabled with
+//! `Document.enableCompactLayout()`, the document keeps its elements in a
+//! preorder table of parallel arrays: 32-bit parent and subtree-end
+//! indices, interned tag name pointers and class Bloom filters. The
+//! descendants of an element are then one contiguous index range, scanned
+//! linearly, and only candidates are dereferenced.
+//!
+//! ## Handles
+//!
+//! The table is a secondary view: nodes keep their links, which remain the
+//! source of truth, and `*Node`/`*Element` handles stay valid as they are.
+//! `elements[i]` resolves an index to its handle.
+//!
+//! ## Maintenance
+//!
+//! The table is stamped with the document's mutation version and rebuilt
+//! in one pass by the first query after any child list or attribute
+//! change. It pays off for documents that are queried much more often
+//! than they change (rendered pages, parsed templates), and costs a
+//! rebuild per query for documents that change between every query.
+//! Idle work (see idle_work.zig) can rebuild it a slice at a time before
+//! the next query needs it.
+//!
+//! Only the document tree is covered; elements in shadow trees or detached
+//! subtrees are queried by walking their links, as without the table.
+
+const std = @import("std");
+const Allocator = std.mem.Allocator;
+const Node = @import("node.zig").Node;
+const element_mod = @import("element.zig");
+const Element = element_mod.Element;
+const BloomFilter = element_mod.BloomFilter;
+const Document = @import("document.zig").Document;
+const Budget = @import("idle_work.zig").Budget;
+
+pub const CompactLayout = struct {
+    allocator: Allocator,
+
+    /// Elements of the document tree, in preorder
+    elements: std.ArrayList(*Element) = .empty,
+
+    /// Index of each element's parent element (`none` for the root)
+    parents: std.ArrayList(u32) = .empty,
+
+    /// One past the index of each element's last descendant
+    ends: std.ArrayList(u32) = .empty,
+
+    /// Tag name of each element, as its string pool copy
+    tags: std.ArrayList([*]const u8) = .empty,
+
+    /// Class Bloom filter of each element
+    class_blooms: std.ArrayList(BloomFilter) = .empty,
+
+    /// Table index of each element
+    indices: std.AutoHashMapUnmanaged(*const Element, u32) = .{},
+
+    /// Mutation version the table was built at (null: not built)
+    version: ?u64 = null,
+
+    /// Rebuild in progress (see rebuildStep)
+    pending: ?Cursor = null,
+
+    pub const none = std.math.maxInt(u32);
+
+    /// Resume point of a rebuild: the next node of the preorder walk and
+    /// the table index of its parent element, for mutation version `version`
+    const Cursor = struct {
+        current: ?*Node,
+        parent: u32,
+        version: u64,
+
+        fn start(doc: *Document) Cursor {
+            return .{ .current = doc.prototype.first_child, .parent = none, .version = doc.mutation_version };
+        }
+    };
+
+    /// Descendants of one element, as a range of the table.
+    pub const Range = struct {
+        layout: *const CompactLayout,
+        start: u32,
+        end: u32,
+
+        pub fn elements(self: Range) []const *Element {
+            return self.layout.elements.items[self.start..self.end];
+        }
+
+        pub fn tags(self: Range) []const [*]const u8 {
+            return self.layout.tags.items[self.start..self.end];
+        }
+
+        pub fn classBlooms(self: Range) []const BloomFilter {
+            return self.layout.class_blooms.items[self.start..self.end];
+        }
+    };
+
+    pub fn init(allocator: Allocator) CompactLayout {
+        return .{ .allocator = allocator };
+    }
+
+    pub fn deinit(self: *CompactLayout) void {
+        self.elements.deinit(self.allocator);
+        self.parents.deinit(self.allocator);
+        self.ends.deinit(self.allocator);
+        self.tags.deinit(self.allocator);
+        self.class_blooms.deinit(self.allocator);
+        self.indices.deinit(self.allocator);
+    }
+
+    /// Returns the descendants of `elem` (which must belong to `doc`),
+    /// rebuilding the table first if the document changed, or null if
+    /// `elem` is not in the document tree.
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to rebuild the table
+    pub fn descendants(self: *CompactLayout, doc: *Document, elem: *const Element) !?Range {
+        if (!elem.prototype.isConnected() or elem.prototype.flags & Node.FLAG_IS_IN_SHADOW_TREE != 0) return null;
+        try self.refresh(doc);
+
+        const index = self.indices.get(elem) orelse return null;
+        return .{ .layout = self, .start = index + 1, .end = self.ends.items[index] };
+    }
+
+    /// Rebuilds the table if the document changed since it was built.
+    pub fn refresh(self: *CompactLayout, doc: *Document) !void {
+        if (self.version != doc.mutation_version) try self.rebuild(doc);
+    }
+
+    /// Continues rebuilding an out-of-date table for one slice of `budget`
+    /// (see idle_work.zig). If the document changed since the previous
+    /// slice, the rebuild starts over; a query meanwhile rebuilds the
+    /// table in one pass.
+    ///
+    /// ## Returns
+    /// True once the table is current, false if the budget ran out first.
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to grow the table (the next step
+    ///   starts over)
+    pub fn rebuildStep(self: *CompactLayout, doc: *Document, budget: *Budget) !bool {
+        if (self.version == doc.mutation_version) return true;
+        if (self.pending == null or self.pending.?.version != doc.mutation_version) {
+            self.clear();
+            self.pending = Cursor.start(doc);
+        }
+        errdefer self.pending = null;
+
+        if (!try self.fill(doc, &self.pending.?, budget)) return false;
+        self.pending = null;
+        return true;
+    }
+
+    /// Refills the table from the document tree.
+    fn rebuild(self: *CompactLayout, doc: *Document) !void {
+        self.pending = null;
+        self.clear();
+        var cursor = Cursor.start(doc);
+        _ = try self.fill(doc, &cursor, null);
+    }
+
+    fn clear(self: *CompactLayout) void {
+        self.version = null;
+        self.elements.clearRetainingCapacity();
+        self.parents.clearRetainingCapacity();
+        self.ends.clearRetainingCapacity();
+        self.tags.clearRetainingCapacity();
+        self.class_blooms.clearRetainingCapacity();
+        self.indices.clearRetainingCapacity();
+    }
+
+    /// Appends the rest of the document tree from `cursor`, stopping early
+    /// (with `cursor` at the next node) once `budget` is spent. Returns
+    /// true when the table is complete.
+    fn fill(self: *CompactLayout, doc: *Document, cursor: *Cursor, budget: ?*Budget) !bool {
+        // Preorder walk; only elements have element children in a document
+        while (cursor.current) |node| {
+            if (budget) |b| {
+                if (b.tick()) return false;
+            }
+            if (node.node_type == .element) {
+                const elem: *Element = @fieldParentPtr("prototype", node);
+                const index: u32 = @intCast(self.elements.items.len);
+                try self.append(doc, elem, cursor.parent);
+
+                if (node.first_child) |child| {
+                    cursor.parent = index;
+                    cursor.current = child;
+                    continue;
+                }
+                self.ends.items[index] = index + 1;
+            }
+
+            // Next sibling, closing finished parents on the way up
+            cursor.current = node.next_sibling;
+            while (cursor.current == null and cursor.parent != none) {
+                self.ends.items[cursor.parent] = @intCast(self.elements.items.len);
+                cursor.current = self.elements.items[cursor.parent].prototype.next_sibling;
+                cursor.parent = self.parents.items[cursor.parent];
+            }
+        }
+
+        self.version = cursor.version;
+        return true;
+    }
+
+    fn append(self: *CompactLayout, doc: *Document, elem: *Element, parent: u32) !void {
+        const allocator = self.allocator;
+        const index: u32 = @intCast(self.elements.items.len);
+
+        // Prefixed tag names are not in the pool until interned here
+        const tag = try doc.string_pool.intern(elem.tag_name);
+
+        try self.elements.append(allocator, elem);
+        try self.parents.append(allocator, parent);
+        try self.ends.append(allocator, none);
+        try self.tags.append(allocator, tag.ptr);
+        try self.class_blooms.append(allocator, elem.class_bloom);
+        try self.indices.put(allocator, elem, index);
+    }
+};
+
+/// Bloom filter bits a class name sets, to test many filters against.
+pub fn classProbe(class_name: []const u8) u64 {
+    var probe = BloomFilter{};
+    probe.add(class_name);
+    return probe.bits;
+}
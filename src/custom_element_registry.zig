@@ -26,7 +26,10 @@
 //! **Zig Design Decisions**:
 //! - Single HashMap (Firefox pattern) - no constructor map needed
 //! - Explicit namespace support (Firefox pattern) - generic DOM requirement
-//! - Strong refs + manual cleanup for upgrade candidates (Zig has no weak refs)
+//! - No upgrade candidate lists: define() walks the document and matches
+//!   undefined elements by interned local name (pointer comparison)
+//! - Upgrades are custom element reactions, run in one pass when the
+//!   [CEReactions] scope of define()/upgrade() closes
 //! - Static scoped registry map (WebKit pattern) - zero overhead
 //!
 //! ## Performance
@@ -55,8 +58,8 @@
 //! const doc = try Document.init(allocator);
 //! defer doc.release();
 //!
-//! const registry = try CustomElementRegistry.init(allocator, doc);
-//! defer registry.deinit();
+//! // Created on first use, owned by the document
+//! const registry = try doc.getCustomElementRegistry();
 //!
 //! // Define a custom element
 //! try registry.define("x-button", CustomElementCallbacks{
@@ -78,11 +81,12 @@
 //!
 //! Phase 1 (Week 2): Registry Foundation
 //! - [x] Name validation
-//! - [ ] CustomElementRegistry struct
-//! - [ ] CustomElementDefinition struct
-//! - [ ] define() method
-//! - [ ] get() / isDefined() methods
-//! - [ ] Upgrade candidate tracking (stub)
+//! - [x] CustomElementRegistry struct
+//! - [x] CustomElementDefinition struct
+//! - [x] define() method
+//! - [x] get() / isDefined() methods
+//! - [x] Upgrade of existing elements (batched upgrade reactions)
+//! - [ ] whenDefined()
 //!
 //! ## JavaScript Bindings
 //!
@@ -248,7 +252,6 @@
 
 const std = @import("std");
 const Allocator = std.mem.Allocator;
-const StringHashMap = std.StringHashMap;
 const ArrayList = std.ArrayList;
 
 const Document = @import("document.zig").Document;
@@ -427,10 +430,13 @@ pub fn isValidCustomElementName(name: []const u8) bool {
 /// - **WebKit**: Uses flat struct with direct pointers ✅ (best cache locality)
 /// - **Zig Choice**: Follow WebKit (no virtual dispatch overhead)
 ///
-/// **Memory**: 40 bytes (5 optional function pointers × 8 bytes each)
+/// **Memory**: 56 bytes (context + 6 optional function pointers × 8 bytes each)
 ///
 /// ## Callbacks
 ///
+/// - `context`: Embedder data (e.g. a script constructor); callbacks reach it
+///   through `element.getCustomElementDefinition().?.callbacks.context`
+/// - `release_context`: Called with `context` when the definition is destroyed
 /// - `constructor_fn`: Called when element is upgraded (undefined → custom)
 /// - `connected_callback`: Called when element is inserted into document
 /// - `disconnected_callback`: Called when element is removed from document
@@ -440,6 +446,12 @@ pub fn isValidCustomElementName(name: []const u8) bool {
 /// **Spec Reference**:
 /// - WHATWG DOM: https://dom.spec.whatwg.org/#concept-custom-element-definition
 pub const CustomElementCallbacks = struct {
+    /// Embedder data shared by all callbacks of the definition.
+    context: ?*anyopaque = null,
+
+    /// Releases `context` when the definition is destroyed.
+    release_context: ?*const fn (context: ?*anyopaque) void = null,
+
     /// Constructor function called during element upgrade.
     ///
     /// Must not throw. If it throws, element transitions to "failed" state.
@@ -588,9 +600,10 @@ pub const CustomElementDefinition = struct {
             .is_shadow_disabled = options.disable_shadow,
         };
 
-        // Populate observed attributes set
+        // Populate observed attributes set (names interned, so the caller's
+        // list need not outlive the definition)
         for (observed_attributes_list) |attr| {
-            try def.observed_attributes.put(attr, {});
+            try def.observed_attributes.put(try registry.document.string_pool.internName(attr), {});
         }
 
         return def;
@@ -598,6 +611,7 @@ pub const CustomElementDefinition = struct {
 
     /// Destroys the definition and frees all associated memory.
     pub fn destroy(self: *CustomElementDefinition) void {
+        if (self.callbacks.release_context) |release| release(self.callbacks.context);
         self.observed_attributes.deinit();
         self.construction_stack.deinit(self.allocator);
         self.allocator.destroy(self);
@@ -671,10 +685,9 @@ pub const DefineOptions = struct {
 /// ```
 /// allocator: 8 bytes
 /// document: 8 bytes
-/// definitions: ~40 bytes (StringHashMap)
-/// upgrade_candidates: ~40 bytes (StringHashMap of ArrayLists)
+/// definitions: ~24 bytes (pointer-keyed HashMap)
 /// is_defining: 1 byte
-/// Total: ~120 bytes
+/// Total: ~48 bytes
 /// ```
 ///
 /// **Spec Reference**:
@@ -685,12 +698,11 @@ pub const CustomElementRegistry = struct {
     allocator: Allocator,
     document: *Document,
 
-    /// Main registry: name → definition (Firefox pattern: single HashMap)
-    definitions: StringHashMap(*CustomElementDefinition),
-
-    /// Upgrade candidates: name → elements awaiting upgrade
-    /// Note: Strong references (Zig has no weak refs), manual cleanup on define()
-    upgrade_candidates: StringHashMap(ArrayList(*Element)),
+    /// Main registry: interned name → definition (Firefox pattern: single
+    /// HashMap). Names are interned in the document's string pool, like
+    /// element local names, so the map is keyed by the interned pointer and
+    /// the lookup on every createElement() hashes one word.
+    definitions: std.AutoHashMapUnmanaged([*]const u8, *CustomElementDefinition),
 
     /// Reentrancy guard (prevents nested define() calls)
     /// Spec explicitly forbids reentrant define()
@@ -715,8 +727,7 @@ pub const CustomElementRegistry = struct {
         registry.* = CustomElementRegistry{
             .allocator = allocator,
             .document = document,
-            .definitions = StringHashMap(*CustomElementDefinition).init(allocator),
-            .upgrade_candidates = StringHashMap(ArrayList(*Element)).init(allocator),
+            .definitions = .{},
             .is_defining = false,
         };
 
@@ -730,14 +741,7 @@ pub const CustomElementRegistry = struct {
         while (def_iter.next()) |def| {
             def.*.destroy();
         }
-        self.definitions.deinit();
-
-        // Free all upgrade candidate lists
-        var cand_iter = self.upgrade_candidates.valueIterator();
-        while (cand_iter.next()) |list| {
-            list.deinit(self.allocator);
-        }
-        self.upgrade_candidates.deinit();
+        self.definitions.deinit(self.allocator);
 
         self.allocator.destroy(self);
     }
@@ -756,9 +760,24 @@ pub const CustomElementRegistry = struct {
     ///
     /// ## Complexity
     ///
-    /// O(1) - HashMap lookup
+    /// O(1) - string pool lookup + HashMap lookup
     pub fn get(self: *const CustomElementRegistry, name: []const u8) ?*CustomElementDefinition {
-        return self.definitions.get(name);
+        // A name that was never interned cannot have been defined
+        const interned = self.document.string_pool.lookup(name) orelse return null;
+        return self.lookupLocalName(interned);
+    }
+
+    /// Looks up a definition by a local name interned in the document's
+    /// string pool (an element's `local_name`).
+    ///
+    /// **Spec**: https://html.spec.whatwg.org/multipage/custom-elements.html#look-up-a-custom-element-definition
+    ///
+    /// ## Complexity
+    ///
+    /// O(1) - one pointer hash, no string comparison
+    pub fn lookupLocalName(self: *const CustomElementRegistry, local_name: []const u8) ?*CustomElementDefinition {
+        if (self.definitions.count() == 0) return null;
+        return self.definitions.get(local_name.ptr);
     }
 
     /// Checks if a custom element name is defined.
@@ -775,7 +794,7 @@ pub const CustomElementRegistry = struct {
     ///
     /// O(1) - HashMap contains check
     pub fn isDefined(self: *const CustomElementRegistry, name: []const u8) bool {
-        return self.definitions.contains(name);
+        return self.get(name) != null;
     }
 
     /// Defines a new custom element.
@@ -790,7 +809,8 @@ pub const CustomElementRegistry = struct {
     /// 4. Intern name string (via document string pool)
     /// 5. Create definition
     /// 6. Add to registry
-    /// 7. Upgrade existing elements (stub for Phase 1)
+    /// 7. Upgrade existing elements: one upgrade reaction is enqueued per
+    ///    candidate, and all of them run when the [CEReactions] scope closes
     ///
     /// ## Parameters
     ///
@@ -845,38 +865,41 @@ pub const CustomElementRegistry = struct {
         }
 
         // 4. Check for duplicate name (spec step 3)
-        if (self.definitions.contains(name)) {
+        if (self.get(name) != null) {
             return error.CustomElementAlreadyDefined;
         }
 
         // 5. Intern name string (use document's string pool - Firefox pattern)
-        // TODO: When Document.string_pool is implemented, use:
-        // const interned_name = try self.document.string_pool.intern(name);
-        // For now, just use the name as-is
-        const interned_name = name;
+        const interned_name = try self.document.string_pool.internName(name);
 
         // 6. Parse observed attributes from options
         const observed_attrs = options.observed_attributes orelse &[_][]const u8{};
 
-        // 7. Create definition
-        const definition = try CustomElementDefinition.create(
-            self.allocator,
-            self,
-            interned_name,
-            callbacks,
-            observed_attrs,
-            .{
-                .disable_internals = options.disable_internals,
-                .disable_shadow = options.disable_shadow,
-            },
-        );
-        errdefer definition.destroy();
-
-        // 8. Add to registry
-        try self.definitions.put(interned_name, definition);
-
-        // 9. Upgrade existing elements (spec step 10)
-        try self.upgradeCandidates(interned_name, definition);
+        // 7. Create definition and add it to the registry
+        {
+            try self.definitions.ensureUnusedCapacity(self.allocator, 1);
+            const definition = try CustomElementDefinition.create(
+                self.allocator,
+                self,
+                interned_name,
+                callbacks,
+                observed_attrs,
+                .{
+                    .disable_internals = options.disable_internals,
+                    .disable_shadow = options.disable_shadow,
+                },
+            );
+            self.definitions.putAssumeCapacity(interned_name.ptr, definition);
+        }
+
+        // 8. Constructors may define other elements (spec step 14)
+        self.is_defining = false;
+
+        // 9. Upgrade existing elements (spec step 16)
+        const stack = self.document.getCEReactionsStack();
+        try stack.enter();
+        defer stack.leave();
+        try self.enqueueUpgradeCandidates(&self.document.prototype);
     }
 
     // ========================================================================
@@ -890,8 +913,11 @@ pub const CustomElementRegistry = struct {
     /// ## Algorithm (WHATWG DOM)
     ///
     /// 1. Check if element is in "undefined" state (early exit if not)
-    /// 2. Look up definition by element's tag name
-    /// 3. If found, upgrade element to "custom" state
+    /// 2. Look up definition by element's interned local name
+    /// 3. If found, enqueue an upgrade reaction and run it before returning
+    ///
+    /// A constructor that throws leaves the element in the "failed" state;
+    /// the error is not propagated (spec: report the exception).
     ///
     /// ## Parameters
     ///
@@ -899,7 +925,6 @@ pub const CustomElementRegistry = struct {
     ///
     /// ## Errors
     ///
-    /// - `error.ConstructorThrew`: Constructor threw during upgrade (element → failed state)
     /// - `error.OutOfMemory`: Failed to allocate memory
     ///
     /// ## Complexity
@@ -912,10 +937,13 @@ pub const CustomElementRegistry = struct {
         }
 
         // 2. Look up definition (spec step 2)
-        const definition = self.definitions.get(element.tag_name) orelse return;
+        const definition = self.lookupLocalName(element.local_name) orelse return;
 
         // 3. Upgrade element (spec step 3)
-        try upgradeElement(element, definition);
+        const stack = self.document.getCEReactionsStack();
+        try stack.enter();
+        defer stack.leave();
+        try enqueueUpgradeReaction(element, definition, stack);
     }
 
     /// Upgrades all elements in a tree that match defined custom element names.
@@ -924,7 +952,9 @@ pub const CustomElementRegistry = struct {
     ///
     /// ## Algorithm (WHATWG DOM)
     ///
-    /// Performs depth-first traversal of tree, calling tryToUpgradeElement on each element.
+    /// Walks the tree depth-first and enqueues an upgrade reaction for each
+    /// element awaiting one; the upgrades run together, in tree order, when
+    /// the [CEReactions] scope closes.
     ///
     /// ## Parameters
     ///
@@ -932,78 +962,78 @@ pub const CustomElementRegistry = struct {
     ///
     /// ## Errors
     ///
-    /// - `error.ConstructorThrew`: Constructor threw during upgrade
     /// - `error.OutOfMemory`: Failed to allocate memory
     ///
     /// ## Complexity
     ///
     /// O(n) where n = number of nodes in tree
     pub fn upgrade(self: *CustomElementRegistry, root: *Node) !void {
-        // 1. Walk tree depth-first (all browsers use this pattern)
-        var node: ?*Node = root;
-        while (node) |current| {
-            // 2. Skip non-elements
-            if (current.node_type != .element) {
-                node = treeTraversalNext(current, root);
-                continue;
-            }
-
-            const element: *Element = @fieldParentPtr("prototype", current);
-
-            // 3. Try to upgrade
-            try self.tryToUpgradeElement(element);
-
-            // 4. Next node
-            node = treeTraversalNext(current, root);
-        }
+        const stack = self.document.getCEReactionsStack();
+        try stack.enter();
+        defer stack.leave();
+        try self.enqueueUpgradeCandidates(root);
     }
 
-    /// Upgrades all candidates for a specific element name.
-    ///
-    /// Called by define() after adding new definition to upgrade existing elements.
-    ///
-    /// ## Parameters
-    ///
-    /// - `name`: Element name that was just defined
-    /// - `definition`: Definition to apply to candidates
-    ///
-    /// ## Errors
+    /// Enqueues an upgrade reaction for every undefined element under
+    /// `root` (inclusive) that has a definition and none pending.
     ///
-    /// - `error.ConstructorThrew`: Constructor threw during upgrade
-    /// - `error.OutOfMemory`: Failed to allocate memory
-    fn upgradeCandidates(
-        self: *CustomElementRegistry,
-        name: []const u8,
-        definition: *CustomElementDefinition,
-    ) !void {
-        // 1. Get upgrade candidates for this name
-        const candidates = self.upgrade_candidates.get(name) orelse return;
-
-        // 2. Upgrade each candidate
-        for (candidates.items) |element| {
-            // Check element is still undefined (may have changed)
+    /// Elements are matched by their interned local name, so each candidate
+    /// costs one pointer lookup and there is no candidate list to keep.
+    fn enqueueUpgradeCandidates(self: *CustomElementRegistry, root: *Node) !void {
+        const stack = self.document.getCEReactionsStack();
+        var node: ?*Node = root;
+        while (node) |current| : (node = treeTraversalNext(current, root)) {
+            if (current.node_type != .element) continue;
+            const element: *Element = @fieldParentPtr("prototype", current);
+
             if (element.custom_element_state != .undefined) continue;
+            if (element.custom_element_definition != null) continue; // Already enqueued
 
-            // Upgrade element
-            try upgradeElement(element, definition);
+            const definition = self.lookupLocalName(element.local_name) orelse continue;
+            try enqueueUpgradeReaction(element, definition, stack);
         }
-
-        // 3. Clear candidates list (all upgraded or failed)
-        // Note: In browsers this uses weak refs (auto-cleanup)
-        // In Zig: manual cleanup with strong refs
-        _ = self.upgrade_candidates.remove(name);
     }
 };
 
+/// Enqueues an upgrade reaction for an undefined element.
+///
+/// **Spec**: https://html.spec.whatwg.org/multipage/custom-elements.html#enqueue-a-custom-element-upgrade-reaction
+///
+/// ## Parameters
+///
+/// - `element`: Element in "undefined" state
+/// - `definition`: Definition to upgrade it with
+/// - `stack`: Document's CE reactions stack
+///
+/// ## Errors
+///
+/// - `error.OutOfMemory`: Failed to allocate queue or grow it
+pub fn enqueueUpgradeReaction(
+    element: *Element,
+    definition: *const CustomElementDefinition,
+    stack: *CEReactionsStack,
+) !void {
+    const queue = try element.getOrCreateReactionQueue();
+    try queue.enqueue(.{ .upgrade = {} });
+    element.custom_element_definition = definition;
+    try stack.enqueueElement(element);
+}
+
 /// Upgrades an element to a custom element by running its constructor.
 ///
 /// **Spec**: https://dom.spec.whatwg.org/#concept-upgrade-an-element
 ///
+/// Runs as the element's upgrade reaction.
+///
 /// ## Algorithm (WHATWG DOM)
 ///
-/// 1. Try to run constructor (while still in "undefined" state)
-/// 2. If constructor succeeds, set state to "custom"
-/// 3. If constructor throws, set state to "failed"
+/// 1. Enqueue attributeChanged reactions for the observed attributes the
+///    element already has, and a connected reaction if it is connected;
+///    they run after the constructor, from the same queue
+/// 2. Try to run constructor (while still in "undefined" state)
+/// 3. If constructor succeeds, set state to "custom"
+/// 4. If constructor throws, set state to "failed" (dropping the reactions
+///    of step 1)
 ///
 /// ## Parameters
 ///
@@ -1013,8 +1043,32 @@ pub const CustomElementRegistry = struct {
 /// ## Errors
 ///
 /// - `error.ConstructorThrew`: Constructor threw (element → failed state)
+/// - `error.OutOfMemory`: Failed to enqueue the reactions of step 1
 fn upgradeElement(element: *Element, definition: *const CustomElementDefinition) !void {
-    // 1. Try to run constructor (element still in "undefined" state)
+    // Upgraded (or failed) by a reaction enqueued earlier
+    if (element.custom_element_state != .undefined) return;
+
+    // 1. Reactions for the element's current state (spec steps 3-4)
+    const queue = try element.getOrCreateReactionQueue();
+    if (definition.callbacks.attribute_changed_callback != null) {
+        var index: usize = 0;
+        while (element.attributes.at(index)) |attr| : (index += 1) {
+            if (!definition.observesAttribute(attr.name.local_name)) continue;
+            try queue.enqueue(.{
+                .attribute_changed = .{
+                    .name = attr.name.local_name,
+                    .old_value = null,
+                    .new_value = attr.value,
+                    .namespace_uri = attr.name.namespace_uri,
+                },
+            });
+        }
+    }
+    if (definition.callbacks.connected_callback != null and element.prototype.isConnected()) {
+        try queue.enqueue(.{ .connected = {} });
+    }
+
+    // 2. Try to run constructor (element still in "undefined" state)
     if (definition.callbacks.constructor_fn) |constructor| {
         constructor(element, element.prototype.allocator) catch {
             // Constructor threw error → set to failed state (undefined → failed)
@@ -1023,11 +1077,8 @@ fn upgradeElement(element: *Element, definition: *const CustomElementDefinition)
         };
     }
 
-    // 2. Constructor succeeded → set state to custom (undefined → custom)
+    // 3. Constructor succeeded → set state to custom (undefined → custom)
     element.setIsCustom(definition);
-
-    // 3. Element is now upgraded!
-    // Subsequent callbacks (connected, etc.) will be enqueued in Phase 3
 }
 
 /// Tree traversal helper (depth-first, next node).
@@ -1075,7 +1126,7 @@ fn treeTraversalNext(current: *Node, root: *Node) ?*Node {
 ///
 /// ## Variants
 ///
-/// - `upgrade` - Run constructor (mostly for spec compliance, Phase 2 handles this)
+/// - `upgrade` - Run constructor (undefined → custom or failed)
 /// - `connected` - Element inserted into document
 /// - `disconnected` - Element removed from document
 /// - `adopted` - Element moved to new document
@@ -1089,8 +1140,8 @@ fn treeTraversalNext(current: *Node, root: *Node) ?*Node {
 /// - **Total: 72 bytes per reaction**
 pub const CustomElementReaction = union(enum) {
     /// Upgrade element (run constructor).
-    /// Note: Phase 2 already handles upgrades in upgradeElement().
-    /// This reaction type is for spec compliance and explicit upgrade() calls.
+    /// Enqueued by define(), upgrade(), createElement() and insertion of an
+    /// undefined element; see enqueueUpgradeReaction().
     upgrade: void,
 
     /// Element connected to document (inserted).
@@ -1151,6 +1202,10 @@ pub const CustomElementReactionQueue = struct {
     allocator: Allocator,
     reactions: ArrayList(CustomElementReaction),
 
+    /// Index of the next reaction to invoke. Reactions may be appended (and
+    /// the queue invoked re-entrantly) while a callback runs.
+    head: usize = 0,
+
     /// Creates a new reaction queue.
     ///
     /// ## Parameters
@@ -1209,10 +1264,13 @@ pub const CustomElementReactionQueue = struct {
     ///
     /// - Reactions are NOT removed from queue (caller must clear)
     /// - Processes all reactions even if one throws
+    /// - Reactions appended by a callback run in the same pass
+    /// - A failed upgrade clears the definition, dropping the rest
     pub fn invokeAll(self: *CustomElementReactionQueue, element: *Element) void {
-        const definition = element.getCustomElementDefinition() orelse return;
-
-        for (self.reactions.items) |reaction| {
+        while (self.head < self.reactions.items.len) {
+            const reaction = self.reactions.items[self.head];
+            self.head += 1;
+            const definition = element.getCustomElementDefinition() orelse continue;
             invokeReaction(element, definition, reaction);
         }
     }
@@ -1220,11 +1278,12 @@ pub const CustomElementReactionQueue = struct {
     /// Clears all reactions from queue.
     pub fn clear(self: *CustomElementReactionQueue) void {
         self.reactions.clearRetainingCapacity();
+        self.head = 0;
     }
 
-    /// Checks if queue is empty.
+    /// Checks if queue is empty (no reactions left to invoke).
     pub fn isEmpty(self: *const CustomElementReactionQueue) bool {
-        return self.reactions.items.len == 0;
+        return self.head == self.reactions.items.len;
     }
 };
 
@@ -1249,15 +1308,11 @@ fn invokeReaction(
 ) void {
     switch (reaction) {
         .upgrade => {
-            // Constructor already run in Phase 2 (upgradeElement)
-            // This reaction type is mostly for spec compliance
-            if (definition.callbacks.constructor_fn) |constructor| {
-                constructor(element, element.prototype.allocator) catch |err| {
-                    // Log error but don't propagate (spec says catch + ignore)
-                    std.log.warn("Custom element constructor threw: {}", .{err});
-                    return;
-                };
-            }
+            upgradeElement(element, definition) catch |err| {
+                // Element is now "failed"; report but don't propagate
+                std.log.warn("Custom element upgrade failed: {}", .{err});
+                return;
+            };
         },
 
         .connected => {
@@ -1492,8 +1547,11 @@ pub const CEReactionsStack = struct {
 /// ## Notes
 ///
 /// - Only enqueues if element is custom AND connected
+/// - An undefined element with a definition gets an upgrade reaction instead
+///   (spec: insertion steps "try to upgrade")
 /// - Uses depth-first traversal (same as browsers)
 pub fn enqueueConnectedReactionsForTree(root: *Node, stack: *CEReactionsStack) !void {
+    const registry = registryOf(root);
     var node: ?*Node = root;
     while (node) |current| {
         if (current.node_type == .element) {
@@ -1502,6 +1560,14 @@ pub fn enqueueConnectedReactionsForTree(root: *Node, stack: *CEReactionsStack) !
                 const queue = try elem.getOrCreateReactionQueue();
                 try queue.enqueue(.{ .connected = {} });
                 try stack.enqueueElement(elem);
+            } else if (elem.custom_element_state == .undefined and
+                elem.custom_element_definition == null and current.isConnected())
+            {
+                if (registry) |r| {
+                    if (r.lookupLocalName(elem.local_name)) |definition| {
+                        try enqueueUpgradeReaction(elem, definition, stack);
+                    }
+                }
             }
         }
 
@@ -1510,6 +1576,14 @@ pub fn enqueueConnectedReactionsForTree(root: *Node, stack: *CEReactionsStack) !
     }
 }
 
+/// Registry of the document a node belongs to, if one was created.
+fn registryOf(node: *Node) ?*CustomElementRegistry {
+    const doc_node = node.owner_document orelse return null;
+    if (doc_node.node_type != .document) return null;
+    const doc: *Document = @fieldParentPtr("prototype", doc_node);
+    return doc.custom_element_registry;
+}
+
 /// Enqueues disconnected reactions for all custom elements in a tree.
 ///
 /// Called before tree is removed from document (becomes disconnected).
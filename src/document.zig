@@ -255,11 +255,34 @@ const DocumentFragment = @import("document_fragment.zig").DocumentFragment;
 const parent_node_mod = @import("parent_node.zig");
 const SelectorList = @import("selector/parser.zig").SelectorList;
 const FastPathType = @import("fast_path.zig").FastPathType;
+const FastPathSelector = @import("fast_path.zig").FastPathSelector;
+const FastPathStats = @import("fast_path.zig").FastPathStats;
+const IdIndex = @import("id_index.zig").IdIndex;
+const ClassIndex = @import("class_index.zig").ClassIndex;
+const TagIndex = @import("tag_index.zig").TagIndex;
+const HasCache = @import("selector/has_cache.zig").HasCache;
+const StructuralHashes = @import("structural_hash.zig").StructuralHashes;
+const MatchCache = @import("match_cache.zig").MatchCache;
+const NodeTable = @import("node_table.zig").NodeTable;
+const DocumentOrderIndex = @import("document_order.zig").DocumentOrderIndex;
+const CompactLayout = @import("compact_layout.zig").CompactLayout;
+const TreeBuilder = @import("tree_builder.zig").TreeBuilder;
+const ParallelQuery = @import("parallel_query.zig").ParallelQuery;
 const HTMLCollection = @import("html_collection.zig").HTMLCollection;
-const CEReactionsStack = @import("custom_element_registry.zig").CEReactionsStack;
+const custom_elements = @import("custom_element_registry.zig");
+const CEReactionsStack = custom_elements.CEReactionsStack;
+const CustomElementRegistry = custom_elements.CustomElementRegistry;
+const StaticRange = @import("static_range.zig").StaticRange;
+const StaticRangeInit = @import("static_range.zig").StaticRangeInit;
+const StaticRangePool = @import("static_range.zig").StaticRangePool;
+const NodeIterator = @import("node_iterator.zig").NodeIterator;
+const PatchQueue = @import("patch_queue.zig").PatchQueue;
+const idle_work = @import("idle_work.zig");
+const PatchDrainResult = @import("patch_queue.zig").DrainResult;
 const Event = @import("event.zig").Event;
 const EventTarget = @import("event_target.zig").EventTarget;
 const EventCallback = @import("event_target.zig").EventCallback;
+const string_utils = @import("string_utils.zig");
 
 /// String interning pool for per-document string deduplication.
 ///
@@ -268,14 +291,50 @@ const EventCallback = @import("event_target.zig").EventCallback;
 ///
 /// HTML-specific optimizations (e.g., common tag name pools) should be
 /// implemented in the HTML library, not here.
+///
+/// Each string's encoding (ASCII, Latin-1 or other UTF-8) is recorded when
+/// it is interned, so bindings can pick a one-byte engine string without
+/// scanning it on every read (see `ownedEncoding()`).
 pub const StringPool = struct {
-    /// Interned strings hash map
-    strings: std.StringHashMap([]const u8),
+    /// Interned strings hash map (keys are the interned copies)
+    strings: std.StringHashMap(Interned),
     allocator: Allocator,
 
+    /// Last string returned by internName(). The same few names are set
+    /// over and over, so a repeat costs one comparison instead of a hash
+    /// lookup (a pointer comparison when the caller passes the interned
+    /// copy itself).
+    last_name: []const u8 = "",
+
+    /// Bytes held by interned strings (null terminators included)
+    bytes: usize = 0,
+
+    /// Pool of the document this one was forked from (see Document.fork),
+    /// or of the SharedNames it was created with. Its strings are returned
+    /// instead of being copied; they stay valid because the document holds
+    /// a reference on their owner.
+    base: ?*const StringPool = null,
+
+    /// Memory the pool borrows strings from instead of owning them (the
+    /// mapped image of a loaded document, see document_image.zig)
+    borrowed: []const u8 = &.{},
+
+    /// Buffers set aside by reserve(); new strings are copied into them
+    /// instead of being allocated one by one
+    chunks: std.ArrayList([]u8) = .empty,
+
+    /// Unused end of the last chunk
+    chunk_free: []u8 = &.{},
+
+    /// An interned string and its encoding.
+    pub const Interned = struct {
+        str: []const u8,
+        encoding: string_utils.Encoding,
+    };
+
     pub fn init(allocator: Allocator) StringPool {
         return .{
-            .strings = std.StringHashMap([]const u8).init(allocator),
+            .strings = std.StringHashMap(Interned).init(allocator),
             .allocator = allocator,
         };
     }
@@ -284,15 +343,42 @@ pub const StringPool = struct {
         // Free all interned strings (including null terminator)
         var it = self.strings.iterator();
         while (it.next()) |entry| {
-            const str = entry.value_ptr.*;
+            const str = entry.value_ptr.str;
+            if (self.isBorrowed(str) or self.isChunked(str)) continue;
             // dupeZ allocates len+1 bytes but returns slice of len
             // We must free the full allocation including the null terminator
             const ptr: [*]const u8 = str.ptr;
             self.allocator.free(ptr[0 .. str.len + 1]);
         }
+        for (self.chunks.items) |chunk| self.allocator.free(chunk);
+        self.chunks.deinit(self.allocator);
         self.strings.deinit();
     }
 
+    /// Bytes per string assumed when reserve() sizes the map from a byte
+    /// count (names and short attribute values, terminator included)
+    pub const reserve_bytes_per_string = 16;
+
+    /// Makes room for about `bytes` of new strings (terminators included):
+    /// they are copied into one buffer instead of one allocation each, and
+    /// the map is grown once for them instead of rehashing as they arrive.
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to allocate (nothing is reserved)
+    pub fn reserve(self: *StringPool, bytes: usize) !void {
+        if (bytes <= self.chunk_free.len) return;
+        try self.strings.ensureUnusedCapacity(std.math.cast(u32, bytes / reserve_bytes_per_string) orelse return error.OutOfMemory);
+        try self.chunks.ensureUnusedCapacity(self.allocator, 1);
+        const chunk = try self.allocator.alloc(u8, bytes);
+        self.chunks.appendAssumeCapacity(chunk);
+        self.chunk_free = chunk;
+    }
+
+    /// Returns the bytes reserved but not used yet.
+    pub fn reservedBytes(self: *const StringPool) usize {
+        return self.chunk_free.len;
+    }
+
     /// Interns a string, returning a pointer to the canonical null-terminated copy.
     ///
     /// If the string has already been interned, returns the existing copy.
@@ -306,18 +392,214 @@ pub const StringPool = struct {
     /// Pointer to interned string (valid until document destroyed).
     /// Can be safely cast to `[*:0]const u8` via `.ptr` for C interop.
     pub fn intern(self: *StringPool, str: []const u8) ![]const u8 {
+        // Own strings first: the namespaces every document pre-interns
+        // must keep resolving to the copies its fields point at
+        if (self.base) |base| {
+            if (self.strings.get(str)) |interned| return interned.str;
+            if (base.lookup(str)) |interned| return interned;
+        }
         const result = try self.strings.getOrPut(str);
         if (!result.found_existing) {
-            // New string, duplicate with null terminator for C-ABI compatibility
-            result.value_ptr.* = try self.allocator.dupeZ(u8, str);
+            errdefer self.strings.removeByPtr(result.key_ptr);
+
+            // New string, duplicate with null terminator for C-ABI
+            // compatibility; the copy is also the key, so the caller's
+            // bytes may go away
+            const copy = try self.copyZ(str);
+            result.key_ptr.* = copy;
+            result.value_ptr.* = .{ .str = copy, .encoding = string_utils.encodingOf(copy) };
+            self.bytes += str.len + 1;
+        }
+        return result.value_ptr.str;
+    }
+
+    /// Adds `str`, which lies in `borrowed`, as the interned copy of its
+    /// contents without copying it (an equal string already interned is
+    /// kept). `borrowed` must outlive the pool and have a null terminator
+    /// after `str`.
+    pub fn internBorrowed(self: *StringPool, str: []const u8) !void {
+        std.debug.assert(self.isBorrowed(str));
+        const result = try self.strings.getOrPut(str);
+        if (!result.found_existing) result.value_ptr.* = .{ .str = str, .encoding = string_utils.encodingOf(str) };
+    }
+
+    fn isBorrowed(self: *const StringPool, str: []const u8) bool {
+        const start = @intFromPtr(self.borrowed.ptr);
+        const ptr = @intFromPtr(str.ptr);
+        return ptr >= start and ptr < start + self.borrowed.len;
+    }
+
+    fn isChunked(self: *const StringPool, str: []const u8) bool {
+        const ptr = @intFromPtr(str.ptr);
+        for (self.chunks.items) |chunk| {
+            const start = @intFromPtr(chunk.ptr);
+            if (ptr >= start and ptr < start + chunk.len) return true;
+        }
+        return false;
+    }
+
+    /// Null-terminated copy of `str`, from the reserved chunk if it fits.
+    fn copyZ(self: *StringPool, str: []const u8) ![:0]u8 {
+        if (str.len >= self.chunk_free.len) return self.allocator.dupeZ(u8, str);
+        const copy = self.chunk_free[0 .. str.len + 1];
+        self.chunk_free = self.chunk_free[str.len + 1 ..];
+        @memcpy(copy[0..str.len], str);
+        copy[str.len] = 0;
+        return copy[0..str.len :0];
+    }
+
+    /// Interns a tag or attribute name; same as intern(), with a fast path
+    /// for the name interned last.
+    pub fn internName(self: *StringPool, str: []const u8) ![]const u8 {
+        if (self.last_name.len != 0 and std.mem.eql(u8, str, self.last_name)) {
+            return self.last_name;
         }
-        return result.value_ptr.*;
+        const interned = try self.intern(str);
+        self.last_name = interned;
+        return interned;
+    }
+
+    /// Returns the interned copy of `str` if there is one, without adding it.
+    pub fn lookup(self: *const StringPool, str: []const u8) ?[]const u8 {
+        const interned = self.lookupInterned(str) orelse return null;
+        return interned.str;
     }
 
-    /// Returns the number of strings currently interned.
+    fn lookupInterned(self: *const StringPool, str: []const u8) ?Interned {
+        if (self.strings.get(str)) |interned| return interned;
+        const base = self.base orelse return null;
+        return base.lookupInterned(str);
+    }
+
+    /// Returns true if `str` is the canonical interned copy owned by this pool
+    /// (or its base).
+    ///
+    /// Compares pointers, not contents: an equal string from elsewhere is not
+    /// owned. Owned strings are immutable and valid until the document is
+    /// destroyed, so bindings may reference them without copying.
+    pub fn owns(self: *const StringPool, str: []const u8) bool {
+        return self.ownedEncoding(str) != null;
+    }
+
+    /// Returns the encoding recorded for `str` if it is the canonical
+    /// interned copy owned by this pool (or its base), as `owns()` checks;
+    /// null otherwise. One lookup answers both questions.
+    pub fn ownedEncoding(self: *const StringPool, str: []const u8) ?string_utils.Encoding {
+        const interned = self.lookupInterned(str) orelse return null;
+        if (interned.str.ptr != str.ptr) return null;
+        return interned.encoding;
+    }
+
+    /// Returns the number of strings interned in this pool (not its base).
     pub fn count(self: *const StringPool) usize {
         return self.strings.count();
     }
+
+    /// Returns true if `other` is this pool or one of its bases, so every
+    /// string `other` owns stays valid for as long as this pool does
+    /// (forks hold a reference on their base document).
+    pub fn inherits(self: *const StringPool, other: *const StringPool) bool {
+        var pool: ?*const StringPool = self;
+        while (pool) |p| : (pool = p.base) {
+            if (p == other) return true;
+        }
+        return false;
+    }
+};
+
+/// Maps the strings of nodes moving between documents to their copies in
+/// the destination pool, for one adoption or import (see adopt() in
+/// node.zig).
+///
+/// Each distinct source string is interned into the destination once;
+/// every later occurrence (the same tag or attribute name on thousands of
+/// elements) is resolved by its address, without hashing its bytes.
+pub const StringRemap = struct {
+    map: std.AutoHashMapUnmanaged(Key, []const u8) = .{},
+    dest: *StringPool,
+    allocator: Allocator,
+
+    const Key = struct { ptr: usize, len: usize };
+
+    pub fn init(allocator: Allocator, dest: *StringPool) StringRemap {
+        return .{ .dest = dest, .allocator = allocator };
+    }
+
+    pub fn deinit(self: *StringRemap) void {
+        self.map.deinit(self.allocator);
+    }
+
+    /// Returns the destination pool's copy of `str`.
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to grow the table or intern `str`
+    pub fn string(self: *StringRemap, str: []const u8) Allocator.Error![]const u8 {
+        const entry = try self.map.getOrPut(self.allocator, .{ .ptr = @intFromPtr(str.ptr), .len = str.len });
+        if (!entry.found_existing) {
+            errdefer self.map.removeByPtr(entry.key_ptr);
+            entry.value_ptr.* = try self.dest.intern(str);
+        }
+        return entry.value_ptr.*;
+    }
+
+    /// Returns the destination pool's copy of `str`, if there is a string.
+    pub fn optional(self: *StringRemap, str: ?[]const u8) Allocator.Error!?[]const u8 {
+        return if (str) |s| try self.string(s) else null;
+    }
+};
+
+/// An immutable pool of common names (tag names, attribute names and
+/// values, namespaces) shared by many documents, one per isolate or
+/// process. Documents created with Document.initWithSharedNames() use it
+/// as the base of their string pool: its strings are returned instead of
+/// being copied, so they are stored once and compare equal by pointer in
+/// every such document, and moving nodes between them copies none of
+/// them. Other strings go to each document's own pool as usual.
+///
+/// The pool is never modified after init(), so documents on different
+/// threads may share it. It is reference counted: each document holds a
+/// reference until it is destroyed.
+pub const SharedNames = struct {
+    pool: StringPool,
+    ref_count: std.atomic.Value(usize),
+
+    /// The namespaces every document interns (see Document.init)
+    const namespaces = [_][]const u8{
+        "http://www.w3.org/1999/xhtml",
+        "http://www.w3.org/2000/svg",
+        "http://www.w3.org/1998/Math/MathML",
+        "http://www.w3.org/XML/1998/namespace",
+        "http://www.w3.org/2000/xmlns/",
+    };
+
+    /// Creates a pool holding `names` and the standard namespaces, with one
+    /// reference for the caller.
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to allocate the pool
+    pub fn init(allocator: Allocator, names: []const []const u8) !*SharedNames {
+        const self = try allocator.create(SharedNames);
+        errdefer allocator.destroy(self);
+        self.* = .{ .pool = StringPool.init(allocator), .ref_count = std.atomic.Value(usize).init(1) };
+        errdefer self.pool.deinit();
+
+        try self.pool.strings.ensureTotalCapacity(@intCast(namespaces.len + names.len));
+        for (namespaces) |ns| _ = try self.pool.intern(ns);
+        for (names) |name| _ = try self.pool.intern(name);
+        return self;
+    }
+
+    pub fn acquire(self: *SharedNames) void {
+        _ = self.ref_count.fetchAdd(1, .monotonic);
+    }
+
+    /// Drops a reference; the last one frees the pool.
+    pub fn release(self: *SharedNames) void {
+        if (self.ref_count.fetchSub(1, .acq_rel) != 1) return;
+        const allocator = self.pool.allocator;
+        self.pool.deinit();
+        allocator.destroy(self);
+    }
 };
 
 /// Parsed selector with cached fast path detection
@@ -325,7 +607,15 @@ pub const StringPool = struct {
 /// Stores the parsed selector AST and fast path type for reuse.
 /// Eliminates repeated parsing overhead in SPA scenarios where the same
 /// selectors are queried hundreds or thousands of times.
+///
+/// ## Lifetime
+/// A selector owns all of its memory and refers to nothing of the document
+/// whose cache parsed it, and it is freed through the allocator it was
+/// created with (the document's base allocator, never its node arena). So
+/// a reference taken with `acquire()` may outlive the document; only that
+/// allocator has to stay alive until the last `release()`.
 pub const ParsedSelector = struct {
+    /// Allocator the selector was created with and is freed through
     allocator: Allocator,
 
     /// Original selector string (owned)
@@ -340,6 +630,22 @@ pub const ParsedSelector = struct {
     /// Extracted identifier for fast path (e.g., "id" from "#id")
     identifier: ?[]const u8,
 
+    /// Names compared by the compound and combinator fast paths
+    /// (slices of `selector_string`)
+    fast: FastPathSelector,
+
+    /// References held by the cache, by compiled-selector handles and by
+    /// running queries (atomic: queries of a frozen document run on
+    /// several threads)
+    ref_count: std.atomic.Value(u32),
+
+    /// Cache clock value of the last lookup (LRU eviction)
+    last_used: u64,
+
+    /// True if matching depends only on the element's own name and
+    /// attributes (see match_cache.zig)
+    element_local: bool,
+
     pub fn init(allocator: Allocator, selectors: []const u8) !*ParsedSelector {
         const parsed = try allocator.create(ParsedSelector);
         errdefer allocator.destroy(parsed);
@@ -348,9 +654,10 @@ pub const ParsedSelector = struct {
         parsed.selector_string = try allocator.dupe(u8, selectors);
         errdefer allocator.free(parsed.selector_string);
 
-        // Detect fast path
+        // Detect fast path on the owned copy, which `fast` slices into
         const fast_path_mod = @import("fast_path.zig");
-        parsed.fast_path = fast_path_mod.detectFastPath(selectors);
+        parsed.fast = fast_path_mod.parseFastPath(parsed.selector_string);
+        parsed.fast_path = parsed.fast.kind;
 
         // Extract identifier for fast paths
         parsed.identifier = if (parsed.fast_path != .generic)
@@ -363,16 +670,32 @@ pub const ParsedSelector = struct {
         const Tokenizer = @import("selector/tokenizer.zig").Tokenizer;
         const Parser = @import("selector/parser.zig").Parser;
 
-        var tokenizer = Tokenizer.init(allocator, selectors);
+        // Parse the owned copy, which the AST slices into, into one block
+        var tokenizer = Tokenizer.init(allocator, parsed.selector_string);
         var parser = try Parser.init(allocator, &tokenizer);
         defer parser.deinit();
 
-        parsed.selector_list = try parser.parse();
+        parsed.selector_list = try parser.parseCompact();
+        parsed.element_local = @import("match_cache.zig").isElementLocal(&parsed.selector_list);
         parsed.allocator = allocator;
+        parsed.ref_count = std.atomic.Value(u32).init(1);
+        parsed.last_used = 0;
 
         return parsed;
     }
 
+    /// Takes another reference (e.g. for a handle that outlives eviction).
+    pub fn acquire(self: *ParsedSelector) void {
+        _ = self.ref_count.fetchAdd(1, .monotonic);
+    }
+
+    /// Drops a reference; frees the selector when the last one is gone.
+    pub fn release(self: *ParsedSelector) void {
+        if (self.ref_count.fetchSub(1, .acq_rel) == 1) {
+            self.deinit();
+        }
+    }
+
     pub fn deinit(self: *ParsedSelector) void {
         self.selector_list.deinit();
         self.allocator.free(self.selector_string);
@@ -386,7 +709,9 @@ pub const ParsedSelector = struct {
 /// Selector cache for querySelector performance optimization
 ///
 /// Caches parsed selectors to avoid repeated parsing overhead.
-/// Uses FIFO eviction when cache reaches max_size (like Chromium).
+/// Evicts the least recently used entry when the cache reaches max_size.
+/// Shared by querySelector(), querySelectorAll(), matches() and closest(),
+/// so event-delegation code calling closest() per event parses once.
 ///
 /// ## Performance Impact
 /// - Simple selectors: 10-100x faster (parsing eliminated)
@@ -394,67 +719,121 @@ pub const ParsedSelector = struct {
 /// - Memory overhead: ~256 entries × ~100 bytes = ~25KB
 ///
 /// ## Thread Safety
-/// Not thread-safe. External synchronization required for concurrent access.
+/// Not thread-safe, except through `acquire()` once `shared` is set (see
+/// Document.freeze).
 pub const SelectorCache = struct {
     cache: std.StringHashMap(*ParsedSelector),
+
+    /// The document's base allocator, kept by every selector it parses
+    /// (see ParsedSelector, Lifetime)
     allocator: Allocator,
     max_size: usize,
 
-    /// FIFO queue for eviction (stores selector strings)
-    fifo_queue: std.ArrayList([]const u8),
+    /// Lookup clock for LRU ordering
+    clock: u64,
+
+    /// Lookup statistics
+    hits: u64,
+    misses: u64,
+
+    /// Queries run per fast path kind (see fast_path.zig)
+    fast_path_stats: FastPathStats,
+
+    /// Set when several threads may query at once; `acquire()` then takes
+    /// `mutex` and statistics are counted atomically
+    shared: bool = false,
+    mutex: std.Thread.Mutex = .{},
 
     pub fn init(allocator: Allocator) SelectorCache {
         return .{
             .cache = std.StringHashMap(*ParsedSelector).init(allocator),
             .allocator = allocator,
             .max_size = 256, // Like Chromium
-            .fifo_queue = std.ArrayList([]const u8){},
+            .clock = 0,
+            .hits = 0,
+            .misses = 0,
+            .fast_path_stats = .{},
         };
     }
 
     pub fn deinit(self: *SelectorCache) void {
-        // Free all cached selectors
+        // Drop the cache's reference to every selector
         var it = self.cache.valueIterator();
         while (it.next()) |parsed_ptr| {
-            parsed_ptr.*.deinit();
+            parsed_ptr.*.release();
         }
         self.cache.deinit();
-        self.fifo_queue.deinit(self.allocator);
     }
 
     /// Get cached selector or parse and cache it
+    ///
+    /// The returned selector is borrowed and valid until the next call that
+    /// may evict; call `acquire()` to keep it longer.
     pub fn get(self: *SelectorCache, selectors: []const u8) !*ParsedSelector {
+        self.clock += 1;
+
         // Check cache first
         if (self.cache.get(selectors)) |parsed| {
+            self.hits += 1;
+            parsed.last_used = self.clock;
             return parsed;
         }
+        self.misses += 1;
 
         // Parse selector
         const parsed = try ParsedSelector.init(self.allocator, selectors);
-        errdefer parsed.deinit();
+        errdefer parsed.release();
+        parsed.last_used = self.clock;
 
-        // Evict oldest if at capacity
+        // Evict least recently used if at capacity
         if (self.cache.count() >= self.max_size) {
-            try self.evictOldest();
+            self.evictLeastRecentlyUsed();
         }
 
         // Cache it
         try self.cache.put(parsed.selector_string, parsed);
-        try self.fifo_queue.append(self.allocator, parsed.selector_string);
 
         return parsed;
     }
 
-    /// Evict oldest entry (FIFO)
-    fn evictOldest(self: *SelectorCache) !void {
-        if (self.fifo_queue.items.len == 0) return;
+    /// Like `get()`, but returns a reference of the caller's own, released
+    /// with `ParsedSelector.release()`, so the selector survives eviction by
+    /// a concurrent lookup. The query entry points use this.
+    pub fn acquire(self: *SelectorCache, selectors: []const u8) !*ParsedSelector {
+        if (self.shared) self.mutex.lock();
+        defer if (self.shared) self.mutex.unlock();
+
+        const parsed = try self.get(selectors);
+        parsed.acquire();
+        return parsed;
+    }
+
+    /// Counts one query that used `kind`.
+    pub fn recordFastPath(self: *SelectorCache, kind: FastPathType) void {
+        if (self.shared) {
+            self.fast_path_stats.recordAtomic(kind);
+        } else {
+            self.fast_path_stats.record(kind);
+        }
+    }
 
-        // Remove oldest from queue
-        const oldest = self.fifo_queue.orderedRemove(0);
+    /// Evict least recently used entry
+    ///
+    /// Linear in max_size, but only runs on a miss with a full cache; hits
+    /// just stamp `last_used`.
+    fn evictLeastRecentlyUsed(self: *SelectorCache) void {
+        var oldest: ?*ParsedSelector = null;
+        var it = self.cache.valueIterator();
+        while (it.next()) |parsed_ptr| {
+            if (oldest == null or parsed_ptr.*.last_used < oldest.?.last_used) {
+                oldest = parsed_ptr.*;
+            }
+        }
 
-        // Remove from cache and free
-        if (self.cache.fetchRemove(oldest)) |entry| {
-            entry.value.deinit();
+        // Remove from cache and drop its reference
+        if (oldest) |parsed| {
+            _ = self.cache.remove(parsed.selector_string);
+            parsed.release();
         }
     }
 
@@ -462,10 +841,9 @@ pub const SelectorCache = struct {
     pub fn clear(self: *SelectorCache) void {
         var it = self.cache.valueIterator();
         while (it.next()) |parsed_ptr| {
-            parsed_ptr.*.deinit();
+            parsed_ptr.*.release();
         }
         self.cache.clearRetainingCapacity();
-        self.fifo_queue.clearRetainingCapacity();
     }
 
     /// Returns number of cached selectors
@@ -495,6 +873,17 @@ pub const FactoryConfig = struct {
     comment_factory: ?*const fn (Allocator, []const u8) anyerror!*Comment = null,
 };
 
+/// Sizes of content about to be added to a document (see
+/// Document.reserve), from a known template or source document.
+pub const Capacity = struct {
+    /// Nodes to be created
+    nodes: usize = 0,
+
+    /// Bytes of distinct names and attribute values to be interned, one
+    /// terminator each included
+    string_bytes: usize = 0,
+};
+
 /// Document node - root of the DOM tree.
 ///
 /// Uses dual reference counting to handle two types of ownership:
@@ -514,31 +903,110 @@ pub const Document = struct {
     /// Atomic for thread safety
     node_ref_count: std.atomic.Value(usize),
 
-    /// Arena allocator for DOM nodes (100-200x faster than general-purpose allocator)
-    /// All Element, Text, Comment, and DocumentFragment nodes are allocated from this arena
-    /// The entire arena is freed when the document is destroyed
+    /// Arena freed when the document is destroyed: holds NodeIterator and
+    /// TreeWalker state, and every node in arena mode (see initWithArena)
     node_arena: std.heap.ArenaAllocator,
 
+    /// True for documents created with initWithArena(): nodes and their
+    /// storage come from `node_arena`, releasing a node frees nothing, and
+    /// the whole tree goes away with the document.
+    arena_mode: bool,
+
+    /// Arena nodes with rare data, whose release hooks (event listeners,
+    /// live ranges) run when the document goes away
+    arena_rare_nodes: std.ArrayList(*Node),
+
     /// String interning pool (per-document)
     string_pool: StringPool,
 
     /// Selector cache for querySelector optimization
     selector_cache: SelectorCache,
 
-    /// ID map for O(1) getElementById lookups
-    /// Maps id attribute values to elements
-    id_map: std.StringHashMap(*Element),
+    /// ID index for O(1) getElementById lookups
+    /// Maps id attribute values to connected elements in tree order
+    id_map: IdIndex,
 
-    /// Tag map for O(k) getElementsByTagName lookups
-    /// Maps tag names to lists of elements with that tag
+    /// Tag index for O(k) getElementsByTagName lookups
+    /// Maps queried tag names to their connected elements in tree order
     /// k = number of matching elements
-    tag_map: std.StringHashMap(std.ArrayList(*Element)),
+    tag_index: TagIndex,
 
     /// Class map for O(k) getElementsByClassName lookups
     // NOTE: class_map removed in Phase 3
     // getElementsByClassName now uses tree traversal with bloom filters (like browsers)
     // This matches browser behavior where class queries don't maintain a separate map
 
+    /// Optional class token index (see enableClassIndex)
+    /// When set, document-wide getElementsByClassName answers from it
+    class_index: ?*ClassIndex,
+
+    /// Optional cache of subtree hashes (see enableStructuralHashes)
+    /// When set, isEqualNode rejects differing subtrees by hash
+    structural_hashes: ?*StructuralHashes,
+
+    /// Optional per-element matches() answers (see enableMatchCache)
+    match_cache: ?*MatchCache,
+
+    /// Optional integer handles of nodes (see enableNodeTable)
+    node_table: ?*NodeTable,
+
+    /// :has() subtree answers of queries, valid for one mutation version
+    /// (see selector/has_cache.zig; unused once frozen)
+    has_cache: HasCache,
+
+    /// Optional preorder numbering of the tree (see enableDocumentOrderIndex)
+    /// When set, tree-order comparisons between its nodes are O(1)
+    order_index: ?*DocumentOrderIndex,
+
+    /// Optional struct-of-arrays element table (see enableCompactLayout)
+    /// When set, selector scans over the tree run over its arrays
+    compact_layout: ?*CompactLayout,
+
+    /// Optional thread pool for querySelectorAll (see enableParallelQueries)
+    /// When set, queries of a large frozen document are split across it
+    parallel_query: ?ParallelQuery,
+
+    /// Nesting depth of mutation batches (see beginBatch)
+    batch_depth: u32,
+
+    /// Set by freeze(): mutations fail with NoModificationAllowedError
+    frozen: bool,
+
+    /// Set by enableInPlaceTextContent(): textContent reuses a sole Text
+    /// child instead of replacing it
+    in_place_text_content: bool,
+
+    /// Document this one was forked from (see fork), referenced so the
+    /// strings shared through `string_pool.base` outlive this document
+    fork_base: ?*Document,
+
+    /// Common names this document's string pool falls back to (see
+    /// initWithSharedNames), referenced until it is destroyed
+    shared_names: ?*SharedNames,
+
+    /// Slabs the StaticRanges of createStaticRanges() come from
+    static_ranges: StaticRangePool,
+
+    /// Patches other threads submitted (see submitPatch)
+    patch_queue: PatchQueue,
+
+    /// Mapped image this document was loaded from (see document_image.zig);
+    /// its strings are borrowed by `string_pool`, so it is unmapped last
+    image: ?[]align(std.heap.page_size_min) const u8,
+
+    /// Document-wide mutation counter (see noteMutation)
+    /// Bumped on every child list and attribute change in the document's
+    /// nodes, so bindings can cache a collection's elements and refill them
+    /// only when this differs from the version they copied at
+    mutation_version: u64,
+
+    /// Spare event path buffer (see takeEventPath)
+    event_path_buffer: std.ArrayList(*anyopaque),
+
+    /// NodeIterators whose root is one of this document's nodes, whose
+    /// pre-removing steps its removals run (see node_iterator.zig)
+    node_iterators: std.ArrayList(*NodeIterator),
+
     /// Single-entry cache for getElementById optimization
     /// Caches the last looked-up ID for O(1) repeated lookups
     id_cache_key: ?[]const u8 = null,
@@ -569,6 +1037,9 @@ pub const Document = struct {
     /// Manages nested [CEReactions] scopes for lifecycle callbacks
     ce_reactions_stack: CEReactionsStack,
 
+    /// Custom element registry, created on first use (getCustomElementRegistry)
+    custom_element_registry: ?*CustomElementRegistry = null,
+
     /// DOMImplementation instance for this document.
     /// Per WebIDL [SameObject], must return the same object every time.
     /// Initialized to undefined, set in initWithVTableAndFactories()
@@ -712,7 +1183,31 @@ pub const Document = struct {
         allocator: Allocator,
         factories: FactoryConfig,
     ) !*Document {
-        return initWithVTableAndFactories(allocator, &vtable, factories);
+        return initWithVTableAndFactories(allocator, &vtable, factories, null);
+    }
+
+    /// Initializes a document whose string pool falls back to `shared`
+    /// (see SharedNames): names held there are returned instead of being
+    /// copied into this document's pool. The document holds a reference on
+    /// `shared` until it is destroyed.
+    ///
+    /// ## Example
+    /// ```zig
+    /// const shared = try SharedNames.init(allocator, &.{ "item", "class", "id" });
+    /// defer shared.release();
+    ///
+    /// const doc1 = try Document.initWithSharedNames(allocator, shared);
+    /// defer doc1.release();
+    /// const doc2 = try Document.initWithSharedNames(allocator, shared);
+    /// defer doc2.release();
+    ///
+    /// // Same pointer in both documents
+    /// const a = try doc1.createElement("item");
+    /// const b = try doc2.createElement("item");
+    /// std.debug.assert(a.tag_name.ptr == b.tag_name.ptr);
+    /// ```
+    pub fn initWithSharedNames(allocator: Allocator, shared: *SharedNames) !*Document {
+        return initWithVTableAndFactories(allocator, &vtable, .{}, shared);
     }
 
     /// Initializes a document with a custom vtable (enables extensibility).
@@ -720,7 +1215,7 @@ pub const Document = struct {
         allocator: Allocator,
         node_vtable: *const NodeVTable,
     ) !*Document {
-        return initWithVTableAndFactories(allocator, node_vtable, .{});
+        return initWithVTableAndFactories(allocator, node_vtable, .{}, null);
     }
 
     /// Full initialization with both vtable and factories (maximum extensibility).
@@ -728,6 +1223,7 @@ pub const Document = struct {
         allocator: Allocator,
         node_vtable: *const NodeVTable,
         factories: FactoryConfig,
+        shared_names: ?*SharedNames,
     ) !*Document {
         const doc = try allocator.create(Document);
         errdefer allocator.destroy(doc);
@@ -739,18 +1235,19 @@ pub const Document = struct {
         // Initialize string pool
         var string_pool = StringPool.init(allocator);
         errdefer string_pool.deinit();
+        if (shared_names) |shared| string_pool.base = &shared.pool;
 
         // Initialize selector cache
         var selector_cache = SelectorCache.init(allocator);
         errdefer selector_cache.deinit();
 
         // Initialize ID map
-        var id_map = std.StringHashMap(*Element).init(allocator);
+        var id_map = IdIndex.init(allocator);
         errdefer id_map.deinit();
 
-        // Initialize tag map
-        var tag_map = std.StringHashMap(std.ArrayList(*Element)).init(allocator);
-        errdefer tag_map.deinit();
+        // Initialize tag index (buckets are built on first query)
+        var tag_index = TagIndex.init(allocator);
+        errdefer tag_index.deinit();
 
         // NOTE: class_map removed in Phase 3 - no longer needed
 
@@ -779,11 +1276,32 @@ pub const Document = struct {
         doc.external_ref_count = std.atomic.Value(usize).init(1);
         doc.node_ref_count = std.atomic.Value(usize).init(0);
         doc.node_arena = node_arena;
+        doc.arena_mode = false;
+        doc.arena_rare_nodes = .empty;
         doc.string_pool = string_pool;
         doc.selector_cache = selector_cache;
         doc.id_map = id_map;
-        doc.tag_map = tag_map;
+        doc.tag_index = tag_index;
         // NOTE: class_map removed in Phase 3
+        doc.class_index = null;
+        doc.structural_hashes = null;
+        doc.match_cache = null;
+        doc.node_table = null;
+        doc.has_cache = HasCache.init(allocator);
+        doc.order_index = null;
+        doc.compact_layout = null;
+        doc.parallel_query = null;
+        doc.mutation_version = 0;
+        doc.batch_depth = 0;
+        doc.frozen = false;
+        doc.in_place_text_content = false;
+        doc.fork_base = null;
+        doc.shared_names = null;
+        doc.static_ranges = StaticRangePool.init(allocator);
+        doc.patch_queue = .{};
+        doc.image = null;
+        doc.event_path_buffer = .{};
+        doc.node_iterators = .empty;
         doc.next_node_id = 1; // 0 reserved for document itself
         doc.is_destroying = false;
 
@@ -802,6 +1320,12 @@ pub const Document = struct {
         // Initialize custom element reactions stack (Phase 3)
         doc.ce_reactions_stack = CEReactionsStack.init(allocator);
 
+        // Referenced last, since nothing after this can fail
+        if (shared_names) |shared| {
+            shared.acquire();
+            doc.shared_names = shared;
+        }
+
         // Initialize DOMImplementation (must be after doc is fully initialized)
         // [SameObject] requires we return the same instance every time
         doc.implementation = .{ .document = doc };
@@ -809,6 +1333,181 @@ pub const Document = struct {
         return doc;
     }
 
+    /// Creates a document whose nodes are bump-allocated from one arena.
+    ///
+    /// Meant for short-lived documents that are built, serialized and
+    /// discarded: node creation is a pointer bump, releasing a node frees
+    /// nothing, and release() of the document frees every node at once
+    /// without walking the tree.
+    ///
+    /// ## Restrictions
+    /// - Nodes cannot move between this document and any other one (see
+    ///   `adopt()`); copy them with importNode() instead.
+    /// - Node references, ranges, iterators and observers on its nodes must
+    ///   not outlive the document.
+    /// - Memory of removed nodes is only reclaimed with the document.
+    ///
+    /// ## Parameters
+    /// - `allocator`: Backs the arena and the document's own structures
+    /// - `initial_bytes`: Arena capacity to reserve up front (0 for none)
+    pub fn initWithArena(allocator: Allocator, initial_bytes: usize) !*Document {
+        const doc = try init(allocator);
+        errdefer doc.release();
+
+        doc.arena_mode = true;
+        if (initial_bytes > 0) {
+            // Freeing the last allocation rewinds the arena but keeps the buffer
+            const arena = doc.node_arena.allocator();
+            arena.free(try arena.alloc(u8, initial_bytes));
+        }
+        return doc;
+    }
+
+    /// Returns a copy of this document's tree in a new document, for
+    /// pipelines that derive many variants from one base document and
+    /// change a few nodes in each.
+    ///
+    /// The fork is an arena document (see initWithArena(), whose
+    /// restrictions apply) with room reserved for every node, so copying a
+    /// node is a pointer bump and discarding the fork frees one arena. It
+    /// shares this document's interned strings (tag names, attribute names
+    /// and values) instead of copying them: its string pool falls back to
+    /// this document's pool and only copies strings neither holds. The
+    /// fork holds a reference on this document until it is destroyed.
+    /// Subtrees are linked as they are copied, as a TreeBuilder does, and
+    /// each child of the document is inserted once. Character data is
+    /// copied; shadow roots and lazy indices are not.
+    ///
+    /// This document may be frozen or shared (see freeze, share); it is
+    /// only read. The fork starts mutable and unshared.
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to allocate the fork
+    pub fn fork(self: *Document) !*Document {
+        const reserve = self.node_ref_count.load(.monotonic) * @sizeOf(Element);
+        const copy = try initWithArena(self.prototype.allocator, reserve);
+        errdefer copy.release();
+
+        self.acquire();
+        copy.fork_base = self;
+        copy.string_pool.base = &self.string_pool;
+
+        var child = self.prototype.first_child;
+        while (child) |node| : (child = node.next_sibling) {
+            const copied = try copy.forkNode(node);
+            _ = copy.prototype.appendChild(copied) catch |err| {
+                copied.release();
+                return err;
+            };
+        }
+        return copy;
+    }
+
+    /// Copies `node` and its descendants into this document (see fork).
+    fn forkNode(self: *Document, node: *const Node) anyerror!*Node {
+        const copy: *Node = switch (node.node_type) {
+            .element => blk: {
+                const elem: *const Element = @fieldParentPtr("prototype", node);
+                const copied = if (elem.namespace_uri) |namespace|
+                    try self.createElementNS(namespace, elem.tag_name)
+                else
+                    try self.createElement(elem.tag_name);
+                errdefer copied.prototype.release();
+                try self.forkAttributes(elem, copied);
+                break :blk &copied.prototype;
+            },
+            .text => &(try self.createTextNode(node.nodeValue().?)).prototype,
+            .comment => &(try self.createComment(node.nodeValue().?)).prototype,
+            .cdata_section => &(try self.createCDATASection(node.nodeValue().?)).prototype.prototype,
+            .processing_instruction => blk: {
+                const ProcessingInstruction = @import("processing_instruction.zig").ProcessingInstruction;
+                const text: *const Text = @fieldParentPtr("prototype", node);
+                const pi: *const ProcessingInstruction = @fieldParentPtr("prototype", text);
+                break :blk &(try self.createProcessingInstruction(pi.target, node.nodeValue().?)).prototype.prototype;
+            },
+            .document_type => blk: {
+                const DocumentType = @import("document_type.zig").DocumentType;
+                const doctype: *const DocumentType = @fieldParentPtr("prototype", node);
+                break :blk &(try self.createDocumentType(doctype.name, doctype.publicId, doctype.systemId)).prototype;
+            },
+            else => return error.NotSupported,
+        };
+        errdefer copy.release();
+
+        // The copy lands where the original is, so linking it shifts nothing
+        copy.depth = node.depth;
+
+        var child = node.first_child;
+        while (child) |child_node| : (child = child_node.next_sibling) {
+            TreeBuilder.appendBuilt(copy, try self.forkNode(child_node));
+        }
+        return copy;
+    }
+
+    /// Sets the attributes of `elem` on its fork `copy`.
+    fn forkAttributes(self: *Document, elem: *const Element, copy: *Element) !void {
+        try copy.attributes.array.reserve(elem.attributes.array.count());
+        var attr_iter = elem.attributes.iterator();
+        while (attr_iter.next()) |attr| {
+            const namespace = attr.name.namespace_uri orelse {
+                try copy.setAttribute(attr.name.local_name, attr.value);
+                continue;
+            };
+            if (attr.name.prefix) |prefix| {
+                const qualified = try std.fmt.allocPrint(self.prototype.allocator, "{s}:{s}", .{ prefix, attr.name.local_name });
+                defer self.prototype.allocator.free(qualified);
+                try copy.setAttributeNS(namespace, qualified, attr.value);
+            } else {
+                try copy.setAttributeNS(namespace, attr.name.local_name, attr.value);
+            }
+        }
+    }
+
+    /// Returns the allocator for this document's nodes (the arena for
+    /// documents created with initWithArena()).
+    pub fn nodeAllocator(self: *Document) Allocator {
+        return if (self.arena_mode) self.node_arena.allocator() else self.prototype.allocator;
+    }
+
+    /// Pre-sizes storage for content about to be added, so building a large
+    /// tree does not grow it step by step: the string pool takes a buffer
+    /// for the new strings and grows its map once, and the arena of an
+    /// arena document (see initWithArena()) makes room for the nodes.
+    ///
+    /// Other documents allocate each node on its own (nodes are released
+    /// individually), so `nodes` only applies to arena documents. Hints
+    /// are not limits: content beyond them is allocated as usual.
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to allocate
+    pub fn reserve(self: *Document, capacity: Capacity) !void {
+        try self.string_pool.reserve(capacity.string_bytes);
+        if (self.arena_mode and capacity.nodes > 0) {
+            const bytes = std.math.mul(usize, capacity.nodes, @sizeOf(Element)) catch return error.OutOfMemory;
+            // Freeing the last allocation rewinds the arena but keeps the buffer
+            const arena = self.node_arena.allocator();
+            arena.free(try arena.alloc(u8, bytes));
+        }
+    }
+
+    /// Returns an estimate of the memory this document keeps alive, in
+    /// bytes: its nodes, the arena, interned strings and its indices.
+    ///
+    /// Meant for embedders that report DOM memory to a garbage collector
+    /// (a small wrapper can keep a large tree alive). Each live node counts
+    /// as one Element; character data and attribute storage are not
+    /// counted. Cheap enough to call after every batch of mutations.
+    pub fn allocatedBytes(self: *const Document) usize {
+        var bytes: usize = @sizeOf(Document) + self.string_pool.bytes + self.string_pool.reservedBytes();
+        bytes += self.node_arena.queryCapacity();
+        if (!self.arena_mode) {
+            // Arena nodes are in the arena capacity already
+            bytes += self.node_ref_count.load(.monotonic) * @sizeOf(Element);
+        }
+        bytes += self.id_map.count() * (@sizeOf([]const u8) + @sizeOf(*Element));
+        return bytes;
+    }
+
     /// Increments the external reference count.
     ///
     /// Call this when sharing ownership from application code.
@@ -822,13 +1521,29 @@ pub const Document = struct {
     /// All nodes (including orphaned nodes) are freed via arena deallocation.
     /// This matches browser GC semantics where document destruction frees all associated nodes.
     pub fn release(self: *Document) void {
-        const old = self.external_ref_count.fetchSub(1, .monotonic);
+        // Shared documents may be released last on any thread
+        const old = if (self.prototype.isShared())
+            self.external_ref_count.fetchSub(1, .acq_rel)
+        else
+            self.external_ref_count.fetchSub(1, .monotonic);
 
         if (old == 1) {
             // External refs reached 0 - document is "closed"
             // Destroy immediately, freeing all nodes (tree + orphaned)
             self.is_destroying = true;
 
+            if (self.arena_mode) {
+                // Nodes are freed with the arena; only rare data has hooks
+                for (self.arena_rare_nodes.items) |node| {
+                    node.deinitRareData();
+                }
+                self.arena_rare_nodes.deinit(self.prototype.allocator);
+                self.prototype.first_child = null;
+                self.prototype.last_child = null;
+                self.deinitInternal();
+                return;
+            }
+
             // Release tree nodes cleanly (calls their deinit hooks)
             var current = self.prototype.first_child;
             while (current) |child| {
@@ -859,12 +1574,17 @@ pub const Document = struct {
 
     /// Decrements the internal node reference count.
     ///
-    /// Called when a node with ownerDocument=this is destroyed.
-    /// PUBLIC for nodes to call during cleanup.
+    /// Called when a node with ownerDocument=this is destroyed or adopted
+    /// into another document. PUBLIC for nodes to call during cleanup.
     ///
     /// Note: This only tracks refs, it does NOT trigger document destruction.
     /// Document destruction is controlled solely by external_ref_count reaching 0.
-    pub fn releaseNodeRef(self: *Document) void {
+    pub fn releaseNodeRef(self: *Document, node: *const Node) void {
+        // The node is going away or leaving: its cached hash must not outlive it
+        if (self.structural_hashes) |hashes| hashes.forget(node);
+        if (self.match_cache) |cache| cache.forget(node);
+        if (self.node_table) |table| table.forget(node);
+
         // Just decrement the counter
         // Document destruction happens when external_ref_count reaches 0,
         // not when node_ref_count reaches 0
@@ -893,6 +1613,20 @@ pub const Document = struct {
         return &self.ce_reactions_stack;
     }
 
+    /// Gets the custom element registry of this document, creating it on
+    /// first use.
+    ///
+    /// **Spec**: https://html.spec.whatwg.org/multipage/custom-elements.html#dom-window-customelements
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to allocate the registry
+    pub fn getCustomElementRegistry(self: *Document) !*CustomElementRegistry {
+        if (self.custom_element_registry) |registry| return registry;
+        const registry = try CustomElementRegistry.init(self.prototype.allocator, self);
+        self.custom_element_registry = registry;
+        return registry;
+    }
+
     /// Creates a new element with the specified tag name.
     ///
     /// Tag name is automatically interned via the document's string pool.
@@ -906,14 +1640,16 @@ pub const Document = struct {
     /// ## Errors
     /// - `error.OutOfMemory`: Failed to allocate element
     pub fn createElement(self: *Document, tag_name: []const u8) !*Element {
+        try self.checkMutable();
+
         // Intern tag name via string pool
         const interned_tag = try self.string_pool.intern(tag_name);
 
         // Create element using factory (if provided) or default
         const elem = if (self.element_factory) |factory|
-            try factory(self.prototype.allocator, interned_tag)
+            try factory(self.nodeAllocator(), interned_tag)
         else
-            try Element.create(self.prototype.allocator, interned_tag);
+            try Element.create(self.nodeAllocator(), interned_tag);
         errdefer elem.prototype.release();
 
         // Set owner document and assign node ID
@@ -923,13 +1659,34 @@ pub const Document = struct {
         // Increment document's node ref count
         self.acquireNodeRef();
 
-        // NOTE: We don't add to tag_map here anymore!
-        // Elements are added to tag_map when inserted into the document tree (appendChild/insertBefore)
-        // This matches browser behavior and ensures only connected elements are in the map.
+        // NOTE: We don't add to tag_index here!
+        // Elements are added to tag_index when inserted into the document tree (appendChild/insertBefore)
+        // This matches browser behavior and ensures only connected elements are in the index.
+
+        try self.initCustomElementState(elem);
 
         return elem;
     }
 
+    /// Marks a new element with a valid custom element name as "undefined"
+    /// and upgrades it if its name is defined. The interned tag name makes
+    /// the definition lookup one pointer hash.
+    ///
+    /// A throwing constructor leaves the element "failed" (spec: report the
+    /// exception); createElement() still returns it.
+    fn initCustomElementState(self: *Document, elem: *Element) !void {
+        if (std.mem.indexOfScalar(u8, elem.local_name, '-') == null) return;
+        if (!custom_elements.isValidCustomElementName(elem.local_name)) return;
+        elem.setIsUndefined();
+
+        const registry = self.custom_element_registry orelse return;
+        const definition = registry.lookupLocalName(elem.local_name) orelse return;
+        const stack = self.getCEReactionsStack();
+        try stack.enter();
+        defer stack.leave();
+        try custom_elements.enqueueUpgradeReaction(elem, definition, stack);
+    }
+
     /// Creates a new namespaced Element with the specified namespace and qualified name.
     ///
     /// Implements WHATWG DOM Document.createElementNS() per §4.10.
@@ -994,6 +1751,8 @@ pub const Document = struct {
         namespace_uri: ?[]const u8,
         qualified_name: []const u8,
     ) !*Element {
+        try self.checkMutable();
+
         const qualified_name_mod = @import("qualified_name.zig");
 
         // Step 1: Validate and parse qualified name
@@ -1028,7 +1787,7 @@ pub const Document = struct {
         // Note: Factory functions are not used for namespaced elements
         // (would need different signature to support namespace data)
         const elem = try Element.createNS(
-            self.prototype.allocator,
+            self.nodeAllocator(),
             interned_ns,
             interned_prefix,
             interned_local,
@@ -1056,10 +1815,12 @@ pub const Document = struct {
     /// ## Errors
     /// - `error.OutOfMemory`: Failed to allocate text node
     pub fn createTextNode(self: *Document, data: []const u8) !*Text {
+        try self.checkMutable();
+
         const text = if (self.text_factory) |factory|
-            try factory(self.prototype.allocator, data)
+            try factory(self.nodeAllocator(), data)
         else
-            try Text.create(self.prototype.allocator, data);
+            try Text.create(self.nodeAllocator(), data);
         errdefer text.prototype.release();
 
         // Set owner document and assign node ID
@@ -1083,10 +1844,12 @@ pub const Document = struct {
     /// ## Errors
     /// - `error.OutOfMemory`: Failed to allocate comment node
     pub fn createComment(self: *Document, data: []const u8) !*Comment {
+        try self.checkMutable();
+
         const comment = if (self.comment_factory) |factory|
-            try factory(self.prototype.allocator, data)
+            try factory(self.nodeAllocator(), data)
         else
-            try Comment.create(self.prototype.allocator, data);
+            try Comment.create(self.nodeAllocator(), data);
         errdefer comment.prototype.release();
 
         // Set owner document and assign node ID
@@ -1149,9 +1912,11 @@ pub const Document = struct {
     /// // <script><![CDATA[if (x < y && y > z) { }]]></script>
     /// ```
     pub fn createCDATASection(self: *Document, data: []const u8) !*@import("cdata_section.zig").CDATASection {
+        try self.checkMutable();
+
         const CDATASection = @import("cdata_section.zig").CDATASection;
 
-        const cdata = try CDATASection.create(self.prototype.allocator, data);
+        const cdata = try CDATASection.create(self.nodeAllocator(), data);
         errdefer cdata.prototype.prototype.release();
 
         // Set owner document and assign node ID
@@ -1219,9 +1984,11 @@ pub const Document = struct {
     /// _ = try doc.prototype.appendChild(&stylesheet.prototype.prototype);
     /// ```
     pub fn createProcessingInstruction(self: *Document, target: []const u8, data: []const u8) !*@import("processing_instruction.zig").ProcessingInstruction {
+        try self.checkMutable();
+
         const ProcessingInstruction = @import("processing_instruction.zig").ProcessingInstruction;
 
-        const pi = try ProcessingInstruction.create(self.prototype.allocator, target, data);
+        const pi = try ProcessingInstruction.create(self.nodeAllocator(), target, data);
         errdefer pi.prototype.prototype.release();
 
         // Set owner document and assign node ID
@@ -1277,7 +2044,9 @@ pub const Document = struct {
     /// _ = try doc.prototype.appendChild(&fragment.prototype);
     /// ```
     pub fn createDocumentFragment(self: *Document) !*DocumentFragment {
-        const fragment = try DocumentFragment.create(self.prototype.allocator);
+        try self.checkMutable();
+
+        const fragment = try DocumentFragment.create(self.nodeAllocator());
         errdefer fragment.prototype.release();
 
         // Set owner document and assign node ID
@@ -1339,6 +2108,41 @@ pub const Document = struct {
         return Range.init(self.prototype.allocator, self);
     }
 
+    /// Creates one StaticRange per entry of `inits` into `out`, from this
+    /// document's range pool (slabs of ranges reused as they are released).
+    ///
+    /// Meant for highlight and annotation layers that create and drop
+    /// thousands of ranges at once. The ranges are ordinary StaticRanges:
+    /// release each with `range.deinit(range.allocator)`. Until the last
+    /// one is released they keep the document alive.
+    ///
+    /// ## Errors
+    /// - `error.InvalidNodeTypeError`: A container is a DocumentType or Attr
+    ///   (no range is created)
+    /// - `error.OutOfMemory`: Failed to grow the pool (no range is created)
+    ///
+    /// ## Example
+    /// ```zig
+    /// var ranges: [2]*StaticRange = undefined;
+    /// try doc.createStaticRanges(&.{
+    ///     .{ .start_container = &text.prototype, .start_offset = 0, .end_container = &text.prototype, .end_offset = 4 },
+    ///     .{ .start_container = &text.prototype, .start_offset = 6, .end_container = &text.prototype, .end_offset = 9 },
+    /// }, &ranges);
+    /// defer for (ranges) |range| range.deinit(range.allocator);
+    /// ```
+    pub fn createStaticRanges(self: *Document, inits: []const StaticRangeInit, out: []*StaticRange) !void {
+        std.debug.assert(out.len >= inits.len);
+        const pool = self.static_ranges.allocator();
+
+        var created: usize = 0;
+        errdefer for (out[0..created]) |range| range.deinit(pool);
+
+        for (inits, out[0..inits.len]) |init_dict, *slot| {
+            slot.* = try StaticRange.init(pool, init_dict);
+            created += 1;
+        }
+    }
+
     /// Creates an event of the specified type (legacy method).
     ///
     /// Implements WHATWG DOM Document.createEvent() per §2.3.
@@ -1439,9 +2243,9 @@ pub const Document = struct {
         root: *Node,
         what_to_show: u32,
         node_filter: ?@import("node_filter.zig").NodeFilter,
-    ) !*@import("node_iterator.zig").NodeIterator {
-        const NodeIterator = @import("node_iterator.zig").NodeIterator;
-        // Use arena allocator so iterator is automatically freed with document
+    ) !*NodeIterator {
+        // Arena memory goes with the document; deinit() still releases
+        // the iterator's node references
         return NodeIterator.init(self.node_arena.allocator(), root, what_to_show, node_filter);
     }
 
@@ -1476,7 +2280,8 @@ pub const Document = struct {
         node_filter: ?@import("node_filter.zig").NodeFilter,
     ) !*@import("tree_walker.zig").TreeWalker {
         const TreeWalker = @import("tree_walker.zig").TreeWalker;
-        // Use arena allocator so walker is automatically freed with document
+        // Arena memory goes with the document; deinit() still releases
+        // the walker's node references
         return TreeWalker.init(self.node_arena.allocator(), root, what_to_show, node_filter);
     }
 
@@ -1520,11 +2325,13 @@ pub const Document = struct {
     /// _ = try elem.setAttributeNode(attr);
     /// ```
     pub fn createAttribute(self: *Document, local_name: []const u8) !*Attr {
+        try self.checkMutable();
+
         // Intern attribute name via string pool
         const interned_name = try self.string_pool.intern(local_name);
 
         // Create Attr node
-        const attr = try Attr.create(self.prototype.allocator, interned_name);
+        const attr = try Attr.create(self.nodeAllocator(), interned_name);
         errdefer attr.node.release();
 
         // Set owner document and assign node ID
@@ -1581,6 +2388,8 @@ pub const Document = struct {
         namespace_uri: ?[]const u8,
         qualified_name: []const u8,
     ) !*Attr {
+        try self.checkMutable();
+
         // Intern namespace URI and qualified name
         const interned_ns = if (namespace_uri) |ns|
             try self.string_pool.intern(ns)
@@ -1590,7 +2399,7 @@ pub const Document = struct {
 
         // Create namespaced Attr node
         const attr = try Attr.createNS(
-            self.prototype.allocator,
+            self.nodeAllocator(),
             interned_ns,
             interned_name,
         );
@@ -1661,6 +2470,8 @@ pub const Document = struct {
     /// defer xml_doctype.prototype.release();
     /// ```
     pub fn createDocumentType(self: *Document, name: []const u8, publicId: []const u8, systemId: []const u8) !*@import("document_type.zig").DocumentType {
+        try self.checkMutable();
+
         const DocumentType = @import("document_type.zig").DocumentType;
 
         // Intern strings via document string pool
@@ -1669,8 +2480,8 @@ pub const Document = struct {
         const systemId_interned = try self.string_pool.intern(systemId);
 
         // Create DocumentType with interned strings
-        const dt = try self.prototype.allocator.create(DocumentType);
-        errdefer self.prototype.allocator.destroy(dt);
+        const dt = try self.nodeAllocator().create(DocumentType);
+        errdefer self.nodeAllocator().destroy(dt);
 
         dt.* = DocumentType{
             .prototype = .{
@@ -1683,7 +2494,7 @@ pub const Document = struct {
                 .flags = 0,
                 .node_id = 0,
                 .generation = 0,
-                .allocator = self.prototype.allocator,
+                .allocator = self.nodeAllocator(),
                 .parent_node = null,
                 .previous_sibling = null,
                 .first_child = null,
@@ -1813,6 +2624,8 @@ pub const Document = struct {
     /// See: https://dom.spec.whatwg.org/#dom-document-importnode
     /// See: https://developer.mozilla.org/en-US/docs/Web/API/Document/importNode
     pub fn importNode(self: *Document, node: *Node, deep: bool) !*Node {
+        try self.checkMutable();
+
         // Step 1: If node is a document, throw NotSupportedError
         if (node.node_type == .document) {
             return error.NotSupported;
@@ -1826,7 +2639,7 @@ pub const Document = struct {
         // Step 3: Clone the node using this document's allocator
         // This ensures the cloned node and all its descendants are allocated
         // in the target document's arena, avoiding cross-arena memory issues
-        const cloned = try node.cloneNodeWithAllocator(self.prototype.allocator, deep);
+        const cloned = try node.cloneNodeWithAllocator(self.nodeAllocator(), deep);
         errdefer cloned.release();
 
         // Step 4: Adopt the cloned node into this document
@@ -1872,7 +2685,6 @@ pub const Document = struct {
         // Only enqueue if old document was different from new document
         if (old_doc) |old| {
             if (old != self) {
-                const custom_elements = @import("custom_element_registry.zig");
                 try custom_elements.enqueueAdoptedReactionsForTree(node, old, self, stack);
             }
         }
@@ -2328,6 +3140,10 @@ pub const Document = struct {
     }
 
     pub fn getElementById(self: *Document, element_id: []const u8) ?*Element {
+        // Frozen documents may be read on several threads: skip the cache
+        // and interning, both of which write
+        if (self.frozen) return self.id_map.get(element_id);
+
         // Phase 1: Fast path - Check cache with pointer equality
         if (self.id_cache_key) |cached_key| {
             // Pointer equality check (fastest path: ~2ns)
@@ -2423,27 +3239,27 @@ pub const Document = struct {
     /// - WebIDL: /Users/bcardarella/projects/webref/ed/idl/dom.idl:518
     ///
     /// ## Note
-    /// This returns a live collection backed by Document's internal tag_map.
-    /// Changes to the DOM automatically reflect in the collection.
+    /// This returns a live collection backed by Document's internal tag index.
+    /// The tag's bucket is built by one traversal on first call, then kept
+    /// up to date as elements are connected and disconnected, so the
+    /// collection reflects changes to the DOM automatically.
     pub fn getElementsByTagName(self: *Document, tag_name: []const u8) HTMLCollection {
-        // IMPORTANT: Intern the tag name to match createElement's interned strings
-        // This ensures the tag_map key matches what addNodeToDocumentMaps uses
-        const interned_tag = self.string_pool.intern(tag_name) catch {
-            // If allocation fails, return empty collection
-            return HTMLCollection.initDocumentTagged(null);
-        };
-
-        // IMPORTANT: Ensure the tag exists in tag_map (even if empty) so HTMLCollection
-        // gets a stable pointer. This makes the collection truly "live" - it will
-        // reflect additions/removals even if called before any elements exist.
-        const result = self.tag_map.getOrPut(interned_tag) catch {
-            // If allocation fails, return empty collection
-            return HTMLCollection.initDocumentTagged(null);
-        };
-        if (!result.found_existing) {
-            result.value_ptr.* = .{};
+        if (self.tagBucket(tag_name)) |bucket| {
+            return HTMLCollection.initDocumentTagged(bucket);
         }
-        return HTMLCollection.initDocumentTagged(result.value_ptr);
+
+        // Frozen with no bucket yet (or out of memory): traverse instead
+        return HTMLCollection.initDocumentByTagName(&self.prototype, tag_name);
+    }
+
+    /// Returns the tag index bucket for `tag_name`, building it on first use.
+    ///
+    /// Frozen documents may be queried on several threads, so they only
+    /// use buckets that already exist. Returns null if there is none (or
+    /// it could not be allocated); callers fall back to traversal.
+    pub fn tagBucket(self: *Document, tag_name: []const u8) ?*const TagIndex.Bucket {
+        if (self.frozen) return self.tag_index.get(tag_name);
+        return self.tag_index.getOrBuild(&self.string_pool, &self.prototype, tag_name) catch null;
     }
 
     /// Returns all elements with the specified class name (O(k) lookup).
@@ -2513,11 +3329,409 @@ pub const Document = struct {
     /// Phase 3: Uses tree traversal instead of class_map (removed for browser alignment).
     /// Bloom filters in Element provide O(1) fast rejection for non-matching elements.
     pub fn getElementsByClassName(self: *const Document, class_name: []const u8) HTMLCollection {
+        // Answer from the class index when it is enabled
+        if (self.class_index) |index| {
+            // Keep the interned name so the collection outlives the argument
+            const doc = @constCast(self);
+            const name = doc.string_pool.intern(class_name) catch class_name;
+            return HTMLCollection.initDocumentClassIndexed(index, name);
+        }
+
         // Use HTMLCollection's document-level class traversal
         // This traverses the entire document tree, using bloom filters for fast rejection
         return HTMLCollection.initDocumentByClassName(&self.prototype, class_name);
     }
 
+    /// Enables the class token index for this document.
+    ///
+    /// Builds an index from each class token to the connected elements
+    /// carrying it and keeps it up to date from then on, so live
+    /// document-wide getElementsByClassName() collections answer `length`
+    /// and `item()` without walking the tree. Worth it when collections are
+    /// read much more often than classes change (e.g. polled every frame).
+    /// Calling it again does nothing.
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to allocate the index
+    pub fn enableClassIndex(self: *Document) !void {
+        if (self.class_index != null) return;
+
+        const allocator = self.prototype.allocator;
+        const index = try allocator.create(ClassIndex);
+        errdefer allocator.destroy(index);
+        index.* = ClassIndex.init(allocator);
+        errdefer index.deinit();
+
+        try index.build(&self.string_pool, &self.prototype);
+        self.class_index = index;
+    }
+
+    /// Enables structural hashes for this document's nodes.
+    ///
+    /// From then on each node's structural hash (see
+    /// Node.structuralHash) is cached on first use and dropped along the
+    /// ancestor chain when the subtree changes, so repeated hashing costs
+    /// O(1) and isEqualNode() between nodes of documents that both enable
+    /// it returns false on a hash mismatch without walking the subtrees.
+    /// Worth it when the same fragments are compared or fingerprinted
+    /// repeatedly. Nothing is hashed until asked. Calling it again does
+    /// nothing.
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to allocate the cache
+    pub fn enableStructuralHashes(self: *Document) !void {
+        if (self.structural_hashes != null) return;
+
+        const allocator = self.prototype.allocator;
+        const hashes = try allocator.create(StructuralHashes);
+        hashes.* = StructuralHashes.init(allocator);
+        self.structural_hashes = hashes;
+    }
+
+    /// Enables the matches() cache for this document's elements.
+    ///
+    /// From then on each element remembers its last few matches() answers
+    /// per compiled selector (see match_cache.zig), so checks repeated
+    /// against unchanged elements, as reactive frameworks do on every
+    /// render, are answered without matching. Selectors that only look at
+    /// the element itself stay cached until its attributes change; others
+    /// until the document next changes. Hit counts are kept in the cache.
+    /// Calling it again does nothing.
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to allocate the cache
+    pub fn enableMatchCache(self: *Document) !void {
+        if (self.match_cache != null) return;
+
+        const allocator = self.prototype.allocator;
+        const cache = try allocator.create(MatchCache);
+        cache.* = MatchCache.init(allocator);
+        self.match_cache = cache;
+    }
+
+    /// Enables integer handles for this document's nodes (see
+    /// node_table.zig).
+    ///
+    /// Nodes are numbered on demand by nodeId(), and the table steps
+    /// between the ids of parents, children and siblings and numbers tag
+    /// names, so script algorithms that visit millions of nodes (layout
+    /// prototypes, diffing) can pass integers instead of creating a
+    /// wrapper per node. nodeId() enables it on first use. Calling it
+    /// again does nothing.
+    ///
+    /// ## Errors
+    /// - `error.InvalidStateError`: The document is frozen (enable the
+    ///   table before freezing, which numbers the whole tree)
+    /// - `error.OutOfMemory`: Failed to allocate the table
+    pub fn enableNodeTable(self: *Document) !void {
+        if (self.node_table != null) return;
+        if (self.frozen) return error.InvalidStateError;
+
+        const allocator = self.prototype.allocator;
+        const table = try allocator.create(NodeTable);
+        table.* = NodeTable.init(allocator);
+        self.node_table = table;
+    }
+
+    /// Returns the integer handle of `node` in this document's node table,
+    /// enabling the table first if needed (see enableNodeTable).
+    ///
+    /// ## Returns
+    /// The id (at least 1), or 0 for attributes, nodes of other documents,
+    /// nodes outside the tree of a frozen document, and once the table has
+    /// run out of ids (see NodeTable.clear)
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to grow the table
+    pub fn nodeId(self: *Document, node: *Node) !u32 {
+        if (node.node_type == .attribute) return 0;
+        if (node != &self.prototype and node.owner_document != &self.prototype) return 0;
+        if (self.node_table == null) {
+            if (self.frozen) return 0;
+            try self.enableNodeTable();
+        }
+        return try self.node_table.?.idOf(node);
+    }
+
+    /// Returns the node with handle `id` (see nodeId), or null if there is
+    /// none.
+    pub fn nodeById(self: *const Document, id: u32) ?*Node {
+        const table = self.node_table orelse return null;
+        return table.get(id);
+    }
+
+    /// Enables the document order index for this document.
+    ///
+    /// Numbers the document tree in preorder (lazily, on the first
+    /// comparison), so compareDocumentPosition(), contains() and Range
+    /// boundary point comparisons between nodes of the tree take constant
+    /// time instead of walking ancestor chains. Worth it when nodes are
+    /// compared much more often than the tree changes (e.g. sorting
+    /// selection or annotation anchors). Calling it again does nothing.
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to allocate the index
+    pub fn enableDocumentOrderIndex(self: *Document) !void {
+        if (self.order_index != null) return;
+
+        const allocator = self.prototype.allocator;
+        const index = try allocator.create(DocumentOrderIndex);
+        index.* = DocumentOrderIndex.init(allocator);
+        self.order_index = index;
+    }
+
+    /// Keeps a compact preorder table of the document's elements (see
+    /// compact_layout.zig): 32-bit parent and subtree indices, interned tag
+    /// pointers and class filters in parallel arrays. querySelector(),
+    /// querySelectorAll() and the class and tag fast paths then scan a
+    /// subtree as one contiguous range instead of chasing sibling pointers
+    /// through every node. The table is rebuilt by the first query after
+    /// each change, so it suits documents that are queried much more often
+    /// than they change. Calling it again does nothing.
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to allocate the table
+    pub fn enableCompactLayout(self: *Document) !void {
+        if (self.compact_layout != null) return;
+
+        const allocator = self.prototype.allocator;
+        const layout = try allocator.create(CompactLayout);
+        layout.* = CompactLayout.init(allocator);
+        self.compact_layout = layout;
+    }
+
+    /// Lets querySelectorAll() split queries of this document across
+    /// `pool` once it is frozen (see freeze) and holds at least
+    /// `min_nodes` nodes (see parallel_query.zig). The tree is cut into
+    /// partitions in tree order, so results are the same as sequential
+    /// ones. `pool` must outlive the document's queries. Calling it again
+    /// replaces the pool and threshold; call it before freezing, since
+    /// frozen documents may be queried from several threads.
+    pub fn enableParallelQueries(self: *Document, pool: *std.Thread.Pool, min_nodes: usize) void {
+        self.parallel_query = .{ .pool = pool, .min_nodes = min_nodes };
+    }
+
+    /// Lets the textContent setter reuse a sole Text child of this
+    /// document's nodes: a non-empty string replaces the child's data in
+    /// place, so repeatedly setting a label's text creates no node and
+    /// leaves the child list (and its caches) alone.
+    ///
+    /// Not spec-conformant, hence opt-in: observers get one characterData
+    /// record for the Text child instead of a childList record, and the
+    /// old child stays in the tree. Calling it again does nothing.
+    pub fn enableInPlaceTextContent(self: *Document) void {
+        self.in_place_text_content = true;
+    }
+
+    /// Brings the enabled lazy indices (class index, compact layout,
+    /// document order index, structural hashes) up to date until
+    /// `budget_ns` has passed, most needed first (see idle_work.zig).
+    ///
+    /// Meant for the embedder's idle time: each call resumes where the
+    /// previous one stopped, so queries find the indices built instead of
+    /// rebuilding them on first use. Does nothing for frozen documents.
+    ///
+    /// ## Returns
+    /// True if work remains for another call, false once every index is
+    /// current.
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: An index could not grow; its next query
+    ///   rebuilds it as without idle work
+    pub fn runIdleWork(self: *Document, budget_ns: u64) !bool {
+        return idle_work.run(self, budget_ns);
+    }
+
+    /// Returns true if runIdleWork() has work to do (a few field reads).
+    pub fn hasIdleWork(self: *const Document) bool {
+        return idle_work.pending(self);
+    }
+
+    /// Starts a mutation batch (batches nest; see endBatch).
+    ///
+    /// Until the outermost batch ends:
+    /// - Mutation records are coalesced for every observer of the document,
+    ///   as if each had observed with `coalesce` (see MutationObserverInit).
+    /// - The class index, if enabled, is dropped on the first class change
+    ///   and rebuilt in one pass at endBatch (or by an earlier read).
+    ///
+    /// Everything else (the tree, id lookups, live ranges, collections)
+    /// stays current inside the batch.
+    pub fn beginBatch(self: *Document) void {
+        self.batch_depth += 1;
+    }
+
+    /// Ends a mutation batch started with beginBatch.
+    ///
+    /// ## Errors
+    /// - `error.InvalidStateError`: No batch is open
+    pub fn endBatch(self: *Document) !void {
+        if (self.batch_depth == 0) return error.InvalidStateError;
+        self.batch_depth -= 1;
+        if (self.batch_depth > 0) return;
+
+        if (self.class_index) |index| {
+            index.refresh();
+        }
+    }
+
+    /// Queues a patch for the thread that owns the document. Safe to call
+    /// from any thread (see patch_queue.zig).
+    ///
+    /// `bytes` is a patch in the `tree_diff` format; `targets` and
+    /// `sources` are its node tables, copied with it. The nodes must stay
+    /// alive until the patch is drained. `allocator` must be thread-safe.
+    ///
+    /// ## Returns
+    /// True if no patch was queued before: the caller should wake the
+    /// owning thread, which then calls drainPatches().
+    ///
+    /// ## Errors
+    /// - `error.SyntaxError`: `bytes` is not a valid patch
+    /// - `error.OutOfMemory`: Allocation failed
+    pub fn submitPatch(
+        self: *Document,
+        allocator: Allocator,
+        bytes: []const u8,
+        targets: []const *Node,
+        sources: []const *Node,
+    ) !bool {
+        return self.patch_queue.submit(allocator, bytes, targets, sources);
+    }
+
+    /// Applies every submitted patch in submission order, inside one
+    /// mutation batch. Owning thread only; cheap when nothing is queued.
+    pub fn drainPatches(self: *Document, allocator: Allocator) PatchDrainResult {
+        if (self.patch_queue.isEmpty()) return .{};
+        return self.patch_queue.drain(allocator, self);
+    }
+
+    /// Makes the document immutable, for concurrent read-only queries.
+    ///
+    /// Builds every enabled lazy index (class index, document order index,
+    /// compact layout) so no read has to, and from then on fails mutations
+    /// of the document's nodes and creation of new nodes with
+    /// `error.NoModificationAllowedError`. querySelector(),
+    /// querySelectorAll(), querySelectorAllMany(), getElementById(), and
+    /// Element.matches() and Element.querySelectorAll() may then run on
+    /// several threads at once; other reads (live collections, ranges)
+    /// remain single-threaded. See share() for referencing the nodes from
+    /// several threads. Freezing cannot be undone; calling it again
+    /// does nothing.
+    ///
+    /// ## Errors
+    /// - `error.InvalidStateError`: A mutation batch is open
+    /// - `error.OutOfMemory`: Failed to build an index
+    pub fn freeze(self: *Document) !void {
+        if (self.frozen) return;
+        if (self.batch_depth > 0) return error.InvalidStateError;
+
+        if (self.class_index) |index| {
+            index.refresh();
+            if (index.stale) return error.OutOfMemory;
+        }
+        if (self.order_index) |index| {
+            try index.build(&self.prototype);
+        }
+        if (self.compact_layout) |layout| {
+            try layout.refresh(self);
+        }
+        if (self.structural_hashes) |hashes| {
+            _ = try hashes.get(&self.prototype);
+            hashes.read_only = true;
+        }
+        if (self.node_table) |table| {
+            try table.fill(&self.string_pool, &self.prototype);
+            table.read_only = true;
+        }
+
+        self.frozen = true;
+        self.selector_cache.shared = true;
+    }
+
+    /// Lets a frozen document be referenced from several threads at once,
+    /// e.g. wrapped by one JS engine isolate per thread, without copying.
+    ///
+    /// Marks the document and every node of its tree and shadow trees as
+    /// shared (see Node.isShared): from then on acquire() and release() of
+    /// those nodes, and of the document, update the reference counts
+    /// atomically, while nodes of unshared documents keep plain updates.
+    /// Each node's wrapper slot is claimed (Node.shared_wrapper_slot), so
+    /// embedders that cache wrappers in the slot fall back to their own
+    /// maps; share before any wrapper is cached. Nodes created but never
+    /// inserted are not reachable and stay unshared. Sharing cannot be
+    /// undone; calling it again does nothing.
+    ///
+    /// ## Errors
+    /// - `error.InvalidStateError`: The document is not frozen
+    pub fn share(self: *Document) !void {
+        if (!self.frozen) return error.InvalidStateError;
+        if (self.prototype.isShared()) return;
+        markShared(&self.prototype);
+    }
+
+    /// Marks node and its descendants (shadow trees included) as shared.
+    fn markShared(root: *Node) void {
+        var node: ?*Node = root;
+        while (node) |current| {
+            current.flags |= Node.FLAG_IS_SHARED;
+            current.wrapper_slot = Node.shared_wrapper_slot;
+
+            if (current.node_type == .element) {
+                if (current.rare_data) |rare_data| {
+                    if (rare_data.shadow_root) |shadow_ptr| {
+                        const shadow: *@import("shadow_root.zig").ShadowRoot = @ptrCast(@alignCast(shadow_ptr));
+                        markShared(&shadow.prototype);
+                    }
+                }
+            }
+
+            // Preorder step within root
+            if (current.first_child) |child| {
+                node = child;
+                continue;
+            }
+            var next: ?*Node = current;
+            node = null;
+            while (next) |n| : (next = n.parent_node) {
+                if (n == root) break;
+                if (n.next_sibling) |sibling| {
+                    node = sibling;
+                    break;
+                }
+            }
+        }
+    }
+
+    /// Fails with `error.NoModificationAllowedError` once the document is
+    /// frozen (see freeze).
+    pub fn checkMutable(self: *const Document) error{NoModificationAllowedError}!void {
+        if (self.frozen) return error.NoModificationAllowedError;
+    }
+
+    /// Returns the document's spare event path buffer, emptied.
+    ///
+    /// dispatchEvent() builds each propagation path in it and hands it back
+    /// with recycleEventPath(), so once the buffer has grown to the tree
+    /// depth, dispatch allocates nothing for the path. A dispatch nested in
+    /// a listener finds no spare buffer and starts an empty one.
+    pub fn takeEventPath(self: *Document) std.ArrayList(*anyopaque) {
+        var path = self.event_path_buffer;
+        self.event_path_buffer = .{};
+        path.clearRetainingCapacity();
+        return path;
+    }
+
+    /// Hands an event path buffer back after dispatch, keeping the larger
+    /// of it and the current spare.
+    pub fn recycleEventPath(self: *Document, path: std.ArrayList(*anyopaque)) void {
+        var unused = path;
+        if (unused.capacity > self.event_path_buffer.capacity) {
+            std.mem.swap(std.ArrayList(*anyopaque), &unused, &self.event_path_buffer);
+        }
+        unused.deinit(self.prototype.allocator);
+    }
+
     /// Returns all elements with the specified namespace URI and local name.
     ///
     /// Implements WHATWG DOM Document.getElementsByTagNameNS() interface.
@@ -2691,7 +3905,18 @@ pub const Document = struct {
         // searches descendants (not self).
 
         // Get parsed selector from cache
-        const parsed_selector = try self.selector_cache.get(selectors);
+        const parsed_selector = try self.selector_cache.acquire(selectors);
+        defer parsed_selector.release();
+
+        // Large frozen documents may be matched in parallel; ID queries
+        // have at most one result and stay on their index
+        if (self.parallel_query) |parallel| {
+            if (parallel.engages(self) and parsed_selector.fast_path != .simple_id) {
+                self.selector_cache.recordFastPath(parsed_selector.fast_path);
+                return parallel.querySelectorAll(self.prototype.allocator, self, root, &parsed_selector.selector_list);
+            }
+        }
+
         const Matcher = @import("selector/matcher.zig").Matcher;
         const matcher = Matcher.init(self.prototype.allocator);
 
@@ -2704,7 +3929,7 @@ pub const Document = struct {
         }
 
         // Get all descendants that match
-        const descendants = try root.querySelectorAll(self.prototype.allocator, selectors);
+        const descendants = try root.querySelectorAllParsed(self.prototype.allocator, parsed_selector);
         defer self.prototype.allocator.free(descendants);
 
         // Add all descendants
@@ -2713,6 +3938,63 @@ pub const Document = struct {
         return try results.toOwnedSlice(self.prototype.allocator);
     }
 
+    /// Runs querySelectorAll() for every selector of `selectors` on
+    /// `pool`, storing the matches of `selectors[i]` in `results[i]`
+    /// (caller frees each with the document's allocator).
+    ///
+    /// The document must be frozen (see freeze), so the queries can share
+    /// the tree and the selector cache without locking it. The calling
+    /// thread works on the queries too while it waits.
+    ///
+    /// ## Errors
+    /// - `error.InvalidStateError`: The document is not frozen
+    /// - Any querySelectorAll() error of one of the selectors (the first
+    ///   in list order); no results are returned then
+    pub fn querySelectorAllMany(
+        self: *Document,
+        pool: *std.Thread.Pool,
+        selectors: []const []const u8,
+        results: [][]const *Element,
+    ) !void {
+        std.debug.assert(results.len == selectors.len);
+        if (!self.frozen) return error.InvalidStateError;
+
+        const allocator = self.prototype.allocator;
+        const errors = try allocator.alloc(?anyerror, selectors.len);
+        defer allocator.free(errors);
+        @memset(errors, null);
+        @memset(results, &[_]*Element{});
+
+        var wait_group: std.Thread.WaitGroup = .{};
+        for (selectors, results, errors) |selector, *result, *err| {
+            pool.spawnWg(&wait_group, querySelectorAllInto, .{ self, selector, result, err });
+        }
+        pool.waitAndWork(&wait_group);
+
+        for (errors) |err| {
+            if (err) |e| {
+                for (results) |*result| {
+                    allocator.free(result.*);
+                    result.* = &[_]*Element{};
+                }
+                return e;
+            }
+        }
+    }
+
+    /// One task of querySelectorAllMany().
+    fn querySelectorAllInto(
+        self: *Document,
+        selectors: []const u8,
+        result: *[]const *Element,
+        err: *?anyerror,
+    ) void {
+        result.* = self.querySelectorAll(selectors) catch |e| {
+            err.* = e;
+            return;
+        };
+    }
+
     /// Returns a live collection of element children.
     ///
     /// Implements WHATWG DOM ParentNode.children property per §4.2.6.
@@ -3109,6 +4391,11 @@ pub const Document = struct {
             elem.attributes.deinit();
         }
 
+        // Let bindings free their listener state before the nodes go away
+        if (node.rare_data) |rare| {
+            rare.releaseEventListeners();
+        }
+
         // Recursively clean up children
         var current = node.first_child;
         while (current) |child| {
@@ -3119,6 +4406,9 @@ pub const Document = struct {
     }
 
     fn deinitInternal(self: *Document) void {
+        // Patches nobody drained refer to nodes about to go away
+        self.patch_queue.deinit();
+
         // Clean up rare data if allocated
         self.prototype.deinitRareData();
 
@@ -3128,31 +4418,79 @@ pub const Document = struct {
             cleanupElementAttributesRecursive(first_child);
         }
 
+        self.event_path_buffer.deinit(self.prototype.allocator);
+
+        // Iterators must not outlive the document; drop the links anyway
+        for (self.node_iterators.items) |iterator| iterator.document = null;
+        self.node_iterators.deinit(self.prototype.allocator);
+
         // Clean up selector cache
         self.selector_cache.deinit();
 
         // Clean up ID map
         self.id_map.deinit();
+        self.has_cache.deinit();
+
+        // Clean up class index
+        if (self.class_index) |index| {
+            index.deinit();
+            self.prototype.allocator.destroy(index);
+        }
 
-        // Clean up tag map - Free ArrayList values before deiniting the HashMap
-        // IMPORTANT: Must deinit tag_map BEFORE string_pool because tag_map keys are string pointers
-        var tag_it = self.tag_map.valueIterator();
-        while (tag_it.next()) |list_ptr| {
-            list_ptr.deinit(self.prototype.allocator);
+        // Clean up structural hashes
+        if (self.structural_hashes) |hashes| {
+            hashes.deinit();
+            self.prototype.allocator.destroy(hashes);
         }
-        self.tag_map.deinit();
+
+        // Clean up match cache
+        if (self.match_cache) |cache| {
+            cache.deinit();
+            self.prototype.allocator.destroy(cache);
+        }
+
+        // Clean up node table
+        if (self.node_table) |table| {
+            table.deinit();
+            self.prototype.allocator.destroy(table);
+        }
+
+        // Clean up document order index
+        if (self.order_index) |index| {
+            index.deinit();
+            self.prototype.allocator.destroy(index);
+        }
+
+        // Clean up compact layout
+        if (self.compact_layout) |layout| {
+            layout.deinit();
+            self.prototype.allocator.destroy(layout);
+        }
+
+        // Clean up tag index
+        // IMPORTANT: Must deinit tag_index BEFORE string_pool because its keys are interned strings
+        self.tag_index.deinit();
 
         // NOTE: class_map removed in Phase 3 - no cleanup needed
 
         // Clean up custom element reactions stack (Phase 3)
         self.ce_reactions_stack.deinit();
+        if (self.custom_element_registry) |registry| registry.deinit();
 
-        // Clean up string pool (must be AFTER tag_map)
+        // Clean up string pool (must be AFTER tag_index)
         self.string_pool.deinit();
 
+        // No pooled range is left: each one references the document
+        self.static_ranges.deinit();
+
         // Deinit arena allocator (frees all nodes at once - 100-200x faster than individual frees)
         self.node_arena.deinit();
 
+        // Shared and borrowed strings are no longer referenced
+        if (self.fork_base) |base| base.release();
+        if (self.shared_names) |shared| shared.release();
+        if (self.image) |image| @import("document_image.zig").unmap(image);
+
         // Free document structure
         self.prototype.allocator.destroy(self);
     }
@@ -901,7 +901,7 @@ pub const DocumentFragment = struct {
             if (owner_doc.node_type == .document) {
                 const Document = @import("document.zig").Document;
                 const doc: *Document = @fieldParentPtr("prototype", owner_doc);
-                doc.releaseNodeRef();
+                doc.releaseNodeRef(node);
             }
         }
 
@@ -0,0 +1,560 @@
+//! Document Image - Binary save and mapped load of whole documents
+//!
+//! Workers that start from the same precomputed tree (templates, fixtures)
+//! otherwise rebuild it with one createElement, setAttribute and
+//! appendChild call per node, interning every name and value again. `save`
+//! writes a document's tree to a compact image once; `loadFile` maps the
+//! image read-only and rebuilds the tree in one pass. Names and attribute
+//! values are not copied: the loaded document's string pool borrows them
+//! from the mapping, which stays mapped until the document is destroyed.
+//!
+//! ## Image Layout
+//!
+//! Integers are u32 in the byte order of the machine that saved the image
+//! (`byte_order` tells); images load only on machines with the same order.
+//! Every section starts at a 4-byte aligned offset and follows the
+//! previous one, so offsets are derived from the header counts.
+//!
+//! ```text
+//! ImageHeader                 (32 bytes)
+//! node_types[node_count]      (u8 WHATWG nodeType, padded to 4 bytes)
+//! parents[node_count]         (record index, `none` for children of the document)
+//! names[node_count]           (string id)
+//! extras[node_count]          (string id)
+//! data[node_count]            (string id)
+//! attribute_ends[node_count]  (attributes of node i end here; they start
+//!                              at the previous node's end)
+//! attribute_names[attribute_count]       (qualified name)
+//! attribute_namespaces[attribute_count]  (namespace, `none` if null)
+//! attribute_values[attribute_count]
+//! StringEntry[string_count]   (8 bytes each)
+//! string bytes[strings_length] (UTF-8, each string null-terminated)
+//! ```
+//!
+//! Nodes are in preorder, so a parent always precedes its children. The
+//! name, extra and data columns hold, by node type:
+//!
+//! | node type              | name           | extra     | data     |
+//! |------------------------|----------------|-----------|----------|
+//! | element                | qualified name | namespace | -        |
+//! | text, comment, CDATA   | -              | -         | data     |
+//! | processing instruction | target         | -         | data     |
+//! | document type          | name           | system id | public id|
+//!
+//! Unused columns hold `none`. Only the document tree is saved: shadow
+//! roots, nodes outside the tree and lazy indices are not. Character data
+//! is copied on load, since text nodes own their (mutable) data.
+//!
+//! ## Loading
+//!
+//! The image is validated before any node is created. The loaded document
+//! is an arena document (see `Document.initWithArena()`) with room for
+//! every node reserved up front, so its restrictions apply.
+
+const std = @import("std");
+const builtin = @import("builtin");
+const Allocator = std.mem.Allocator;
+const Node = @import("node.zig").Node;
+const Element = @import("element.zig").Element;
+const Document = @import("document.zig").Document;
+const DocumentType = @import("document_type.zig").DocumentType;
+const ProcessingInstruction = @import("processing_instruction.zig").ProcessingInstruction;
+const Text = @import("text.zig").Text;
+const TreeBuilder = @import("tree_builder.zig").TreeBuilder;
+
+/// Index value meaning "no node" / "no string".
+pub const none: u32 = std.math.maxInt(u32);
+
+/// Magic number at the start of every image ("DOMI").
+pub const magic: u32 = 0x494D4F44;
+
+/// Current layout version.
+pub const version: u16 = 1;
+
+/// `byte_order` value of the machine reading the image.
+const native_byte_order: u16 = if (builtin.cpu.arch.endian() == .little) 1 else 2;
+
+/// Image header.
+pub const ImageHeader = extern struct {
+    magic: u32,
+    version: u16,
+    /// 1 = little-endian, 2 = big-endian
+    byte_order: u16,
+    node_count: u32,
+    attribute_count: u32,
+    string_count: u32,
+    strings_length: u32,
+    reserved: [2]u32 = .{ 0, 0 },
+};
+
+/// String table entry, a range of the string bytes (terminator excluded).
+pub const StringEntry = extern struct {
+    offset: u32,
+    length: u32,
+};
+
+comptime {
+    std.debug.assert(@sizeOf(ImageHeader) == 32);
+    std.debug.assert(@sizeOf(StringEntry) == 8);
+}
+
+/// Alignment of image buffers.
+pub const image_alignment = std.mem.Alignment.of(u32);
+
+/// Image buffer type.
+pub const ImageBuffer = []align(4) u8;
+
+/// Section offsets of an image, derived from its header.
+const Layout = struct {
+    node_types: usize,
+    parents: usize,
+    names: usize,
+    extras: usize,
+    data: usize,
+    attribute_ends: usize,
+    attribute_names: usize,
+    attribute_namespaces: usize,
+    attribute_values: usize,
+    string_entries: usize,
+    strings: usize,
+    total: usize,
+
+    fn of(header: ImageHeader) Layout {
+        const nodes: usize = header.node_count;
+        const attributes: usize = header.attribute_count;
+        var layout: Layout = undefined;
+        layout.node_types = @sizeOf(ImageHeader);
+        layout.parents = layout.node_types + std.mem.alignForward(usize, nodes, 4);
+        layout.names = layout.parents + nodes * 4;
+        layout.extras = layout.names + nodes * 4;
+        layout.data = layout.extras + nodes * 4;
+        layout.attribute_ends = layout.data + nodes * 4;
+        layout.attribute_names = layout.attribute_ends + nodes * 4;
+        layout.attribute_namespaces = layout.attribute_names + attributes * 4;
+        layout.attribute_values = layout.attribute_namespaces + attributes * 4;
+        layout.string_entries = layout.attribute_values + attributes * 4;
+        layout.strings = layout.string_entries + @as(usize, header.string_count) * @sizeOf(StringEntry);
+        layout.total = std.mem.alignForward(usize, layout.strings + header.strings_length, 4);
+        return layout;
+    }
+};
+
+/// Read access to the sections of a validated image.
+const Image = struct {
+    bytes: []align(4) const u8,
+    header: ImageHeader,
+    layout: Layout,
+
+    fn column(self: Image, offset: usize, count: usize) []const u32 {
+        const ptr: [*]const u32 = @ptrCast(@alignCast(self.bytes.ptr + offset));
+        return ptr[0..count];
+    }
+
+    fn nodeTypes(self: Image) []const u8 {
+        return self.bytes[self.layout.node_types..][0..self.header.node_count];
+    }
+
+    fn nodeColumn(self: Image, offset: usize) []const u32 {
+        return self.column(offset, self.header.node_count);
+    }
+
+    fn attributeColumn(self: Image, offset: usize) []const u32 {
+        return self.column(offset, self.header.attribute_count);
+    }
+
+    fn entries(self: Image) []const StringEntry {
+        const ptr: [*]const StringEntry = @ptrCast(@alignCast(self.bytes.ptr + self.layout.string_entries));
+        return ptr[0..self.header.string_count];
+    }
+
+    fn stringBytes(self: Image) []const u8 {
+        return self.bytes[self.layout.strings..][0..self.header.strings_length];
+    }
+
+    fn string(self: Image, id: u32) []const u8 {
+        const entry = self.entries()[id];
+        return self.stringBytes()[entry.offset..][0..entry.length];
+    }
+
+    fn optionalString(self: Image, id: u32) ?[]const u8 {
+        return if (id == none) null else self.string(id);
+    }
+};
+
+// ============================================================================
+// Saving
+// ============================================================================
+
+const Writer = struct {
+    allocator: Allocator,
+    node_types: std.ArrayList(u8) = .{},
+    parents: std.ArrayList(u32) = .{},
+    names: std.ArrayList(u32) = .{},
+    extras: std.ArrayList(u32) = .{},
+    data: std.ArrayList(u32) = .{},
+    attribute_ends: std.ArrayList(u32) = .{},
+    attribute_names: std.ArrayList(u32) = .{},
+    attribute_namespaces: std.ArrayList(u32) = .{},
+    attribute_values: std.ArrayList(u32) = .{},
+    entries: std.ArrayList(StringEntry) = .{},
+    strings: std.ArrayList(u8) = .{},
+    string_ids: std.StringHashMapUnmanaged(u32) = .{},
+
+    fn deinit(self: *Writer) void {
+        inline for (.{ "node_types", "parents", "names", "extras", "data", "attribute_ends", "attribute_names", "attribute_namespaces", "attribute_values", "entries", "strings" }) |name| {
+            @field(self, name).deinit(self.allocator);
+        }
+        self.string_ids.deinit(self.allocator);
+    }
+
+    /// Returns the id of `str`, adding it to the table on first use.
+    fn stringId(self: *Writer, str: []const u8) !u32 {
+        const entry = try self.string_ids.getOrPut(self.allocator, str);
+        if (!entry.found_existing) {
+            entry.value_ptr.* = @intCast(self.entries.items.len);
+            try self.entries.append(self.allocator, .{
+                .offset = @intCast(self.strings.items.len),
+                .length = @intCast(str.len),
+            });
+            try self.strings.appendSlice(self.allocator, str);
+            try self.strings.append(self.allocator, 0);
+        }
+        return entry.value_ptr.*;
+    }
+
+    fn optionalStringId(self: *Writer, str: ?[]const u8) !u32 {
+        return if (str) |s| self.stringId(s) else none;
+    }
+
+    fn appendNode(self: *Writer, node: *const Node, parent: u32) !void {
+        var name: u32 = none;
+        var extra: u32 = none;
+        var data: u32 = none;
+
+        switch (node.node_type) {
+            .element => {
+                const elem: *const Element = @fieldParentPtr("prototype", node);
+                name = try self.stringId(elem.tag_name);
+                extra = try self.optionalStringId(elem.namespace_uri);
+                // Parts of namespaced names are interned on load too
+                if (elem.namespace_uri != null) _ = try self.stringId(elem.local_name);
+                _ = try self.optionalStringId(elem.prefix);
+
+                var attr_iter = elem.attributes.iterator();
+                while (attr_iter.next()) |attr| {
+                    const namespace = try self.optionalStringId(attr.name.namespace_uri);
+                    const qualified = if (attr.name.prefix) |prefix| blk: {
+                        _ = try self.stringId(prefix);
+                        _ = try self.stringId(attr.name.local_name);
+                        const joined = try std.fmt.allocPrint(self.allocator, "{s}:{s}", .{ prefix, attr.name.local_name });
+                        defer self.allocator.free(joined);
+                        break :blk try self.stringId(joined);
+                    } else try self.stringId(attr.name.local_name);
+
+                    try self.attribute_names.append(self.allocator, qualified);
+                    try self.attribute_namespaces.append(self.allocator, namespace);
+                    try self.attribute_values.append(self.allocator, try self.stringId(attr.value));
+                }
+            },
+            .text, .comment, .cdata_section => data = try self.stringId(node.nodeValue().?),
+            .processing_instruction => {
+                const text: *const Text = @fieldParentPtr("prototype", node);
+                const pi: *const ProcessingInstruction = @fieldParentPtr("prototype", text);
+                name = try self.stringId(pi.target);
+                data = try self.stringId(node.nodeValue().?);
+            },
+            .document_type => {
+                const doctype: *const DocumentType = @fieldParentPtr("prototype", node);
+                name = try self.stringId(doctype.name);
+                extra = try self.stringId(doctype.systemId);
+                data = try self.stringId(doctype.publicId);
+            },
+            else => return error.NotSupported,
+        }
+
+        try self.node_types.append(self.allocator, node.node_type.value());
+        try self.parents.append(self.allocator, parent);
+        try self.names.append(self.allocator, name);
+        try self.extras.append(self.allocator, extra);
+        try self.data.append(self.allocator, data);
+        try self.attribute_ends.append(self.allocator, @intCast(self.attribute_names.items.len));
+    }
+
+    /// Adds `root` and its descendants in preorder.
+    fn appendTree(self: *Writer, root: *const Node) !void {
+        try self.appendNode(root, none);
+
+        // Indices of the open ancestors of the next node
+        var open = std.ArrayList(struct { node: *const Node, index: u32 }){};
+        defer open.deinit(self.allocator);
+        try open.append(self.allocator, .{ .node = root, .index = @intCast(self.parents.items.len - 1) });
+
+        var next = root.first_child;
+        while (open.items.len > 0) {
+            const node = next orelse {
+                const closed = open.pop().?;
+                next = if (open.items.len > 0) closed.node.next_sibling else null;
+                continue;
+            };
+            try self.appendNode(node, open.getLast().index);
+            try open.append(self.allocator, .{ .node = node, .index = @intCast(self.parents.items.len - 1) });
+            next = node.first_child;
+        }
+    }
+
+    fn finish(self: *Writer) !ImageBuffer {
+        const header = ImageHeader{
+            .magic = magic,
+            .version = version,
+            .byte_order = native_byte_order,
+            .node_count = @intCast(self.node_types.items.len),
+            .attribute_count = @intCast(self.attribute_names.items.len),
+            .string_count = @intCast(self.entries.items.len),
+            .strings_length = @intCast(self.strings.items.len),
+        };
+        const layout = Layout.of(header);
+
+        const buffer = try self.allocator.alignedAlloc(u8, image_alignment, layout.total);
+        @memset(buffer, 0);
+        @memcpy(buffer[0..@sizeOf(ImageHeader)], std.mem.asBytes(&header));
+        @memcpy(buffer[layout.node_types..][0..self.node_types.items.len], self.node_types.items);
+        const columns = .{
+            .{ layout.parents, &self.parents },
+            .{ layout.names, &self.names },
+            .{ layout.extras, &self.extras },
+            .{ layout.data, &self.data },
+            .{ layout.attribute_ends, &self.attribute_ends },
+            .{ layout.attribute_names, &self.attribute_names },
+            .{ layout.attribute_namespaces, &self.attribute_namespaces },
+            .{ layout.attribute_values, &self.attribute_values },
+        };
+        inline for (columns) |entry| {
+            const bytes = std.mem.sliceAsBytes(entry[1].items);
+            @memcpy(buffer[entry[0]..][0..bytes.len], bytes);
+        }
+        const entry_bytes = std.mem.sliceAsBytes(self.entries.items);
+        @memcpy(buffer[layout.string_entries..][0..entry_bytes.len], entry_bytes);
+        @memcpy(buffer[layout.strings..][0..self.strings.items.len], self.strings.items);
+        return buffer;
+    }
+};
+
+/// Serializes the tree of `doc` (its children and their descendants).
+///
+/// ## Returns
+/// Image buffer; free with `freeImage`.
+///
+/// ## Errors
+/// - `error.OutOfMemory`: Allocation failed
+/// - `error.NotSupported`: The tree holds a node type images cannot store
+pub fn save(allocator: Allocator, doc: *const Document) !ImageBuffer {
+    var writer = Writer{ .allocator = allocator };
+    defer writer.deinit();
+
+    var child = doc.prototype.first_child;
+    while (child) |node| : (child = node.next_sibling) {
+        try writer.appendTree(node);
+    }
+    return writer.finish();
+}
+
+/// Saves the tree of `doc` to `path` in `dir` (see save).
+pub fn saveFile(allocator: Allocator, doc: *const Document, dir: std.fs.Dir, path: []const u8) !void {
+    const image = try save(allocator, doc);
+    defer freeImage(allocator, image);
+    try dir.writeFile(.{ .sub_path = path, .data = image });
+}
+
+/// Frees a buffer returned by `save`.
+pub fn freeImage(allocator: Allocator, image: ImageBuffer) void {
+    allocator.free(image);
+}
+
+// ============================================================================
+// Loading
+// ============================================================================
+
+/// Checks that `bytes` is a complete, consistent image.
+///
+/// ## Errors
+/// - `error.SyntaxError`: Not an image of this version and byte order,
+///   truncated, or with out-of-range indices
+fn validate(bytes: []align(4) const u8) !Image {
+    if (bytes.len < @sizeOf(ImageHeader)) return error.SyntaxError;
+    const header = std.mem.bytesToValue(ImageHeader, bytes[0..@sizeOf(ImageHeader)]);
+    if (header.magic != magic or header.version != version or header.byte_order != native_byte_order) {
+        return error.SyntaxError;
+    }
+    // Counts are u32, so the layout cannot overflow usize on 64-bit targets
+    const layout = Layout.of(header);
+    if (layout.total != bytes.len) return error.SyntaxError;
+
+    const image = Image{ .bytes = bytes, .header = header, .layout = layout };
+
+    const strings = image.stringBytes();
+    for (image.entries()) |entry| {
+        if (entry.offset >= strings.len or strings.len - entry.offset <= entry.length) return error.SyntaxError;
+        if (strings[entry.offset + entry.length] != 0) return error.SyntaxError;
+    }
+
+    const checkId = struct {
+        fn check(id: u32, count: u32) !void {
+            if (id != none and id >= count) return error.SyntaxError;
+        }
+    }.check;
+
+    const names = image.nodeColumn(layout.names);
+    const extras = image.nodeColumn(layout.extras);
+    const data = image.nodeColumn(layout.data);
+    const attribute_ends = image.nodeColumn(layout.attribute_ends);
+    var attribute_start: u32 = 0;
+    for (image.nodeTypes(), image.nodeColumn(layout.parents), names, extras, data, attribute_ends, 0..) |node_type, parent, name, extra, text, end, i| {
+        // Preorder: parents come first and only elements have children
+        if (parent != none) {
+            if (parent >= i or image.nodeTypes()[parent] != @intFromEnum(Node.NodeType.element)) return error.SyntaxError;
+        }
+        try checkId(name, header.string_count);
+        try checkId(extra, header.string_count);
+        try checkId(text, header.string_count);
+
+        const has_attributes = end != attribute_start;
+        if (end < attribute_start or end > header.attribute_count) return error.SyntaxError;
+        attribute_start = end;
+
+        const required_ok = switch (std.meta.intToEnum(Node.NodeType, node_type) catch return error.SyntaxError) {
+            .element => name != none and text == none,
+            .text, .comment, .cdata_section => text != none and !has_attributes,
+            .processing_instruction => name != none and text != none and !has_attributes,
+            .document_type => name != none and extra != none and text != none and parent == none and !has_attributes,
+            else => false,
+        };
+        if (!required_ok) return error.SyntaxError;
+    }
+    if (attribute_start != header.attribute_count) return error.SyntaxError;
+
+    for (image.attributeColumn(layout.attribute_names), image.attributeColumn(layout.attribute_namespaces), image.attributeColumn(layout.attribute_values)) |name, namespace, value| {
+        if (name == none or value == none) return error.SyntaxError;
+        try checkId(name, header.string_count);
+        try checkId(namespace, header.string_count);
+        try checkId(value, header.string_count);
+    }
+    return image;
+}
+
+/// Maps the image at `path` in `dir` read-only and loads it into a new
+/// document, which keeps the mapping until it is destroyed.
+///
+/// ## Errors
+/// - `error.SyntaxError`: The file is not a valid image (see validate)
+/// - `error.NotSupported`: The platform has no mmap
+/// - Any error of opening, reading or mapping the file, or of creating
+///   the nodes (e.g. `error.InvalidCharacterError` for a corrupt name)
+pub fn loadFile(allocator: Allocator, dir: std.fs.Dir, path: []const u8) !*Document {
+    if (comptime builtin.os.tag == .windows) return error.NotSupported;
+
+    const file = try dir.openFile(path, .{});
+    defer file.close();
+    const size = try file.getEndPos();
+    if (size < @sizeOf(ImageHeader)) return error.SyntaxError;
+
+    const mapping = try std.posix.mmap(null, @intCast(size), std.posix.PROT.READ, .{ .TYPE = .PRIVATE }, file.handle, 0);
+    const image = validate(mapping) catch |err| {
+        std.posix.munmap(mapping);
+        return err;
+    };
+
+    const doc = Document.initWithArena(allocator, @as(usize, image.header.node_count) * @sizeOf(Element)) catch |err| {
+        std.posix.munmap(mapping);
+        return err;
+    };
+    // From here on the document unmaps the image when it is destroyed
+    doc.image = mapping;
+    errdefer doc.release();
+
+    try build(doc, image);
+    return doc;
+}
+
+/// Unmaps a document image (called when its document is destroyed).
+pub fn unmap(image: []align(std.heap.page_size_min) const u8) void {
+    if (comptime builtin.os.tag == .windows) unreachable;
+    std.posix.munmap(image);
+}
+
+/// Creates the nodes of a validated image in `doc`.
+fn build(doc: *Document, image: Image) !void {
+    const allocator = doc.prototype.allocator;
+
+    // Every string becomes an interned string without a copy
+    doc.string_pool.borrowed = image.stringBytes();
+    for (image.entries()) |entry| {
+        try doc.string_pool.internBorrowed(image.stringBytes()[entry.offset..][0..entry.length]);
+    }
+
+    const nodes = try allocator.alloc(*Node, image.header.node_count);
+    defer allocator.free(nodes);
+    var roots = std.ArrayList(*Node){};
+    defer roots.deinit(allocator);
+    try roots.ensureTotalCapacity(allocator, image.header.node_count);
+
+    // Roots not inserted yet are linked on error so the document's teardown
+    // frees their attribute storage
+    var inserted: usize = 0;
+    errdefer for (roots.items[inserted..]) |root| TreeBuilder.appendBuilt(&doc.prototype, root);
+
+    const layout = image.layout;
+    const parents = image.nodeColumn(layout.parents);
+    const names = image.nodeColumn(layout.names);
+    const extras = image.nodeColumn(layout.extras);
+    const data = image.nodeColumn(layout.data);
+    const attribute_ends = image.nodeColumn(layout.attribute_ends);
+    const attribute_names = image.attributeColumn(layout.attribute_names);
+    const attribute_namespaces = image.attributeColumn(layout.attribute_namespaces);
+    const attribute_values = image.attributeColumn(layout.attribute_values);
+
+    var attribute_start: u32 = 0;
+    for (image.nodeTypes(), 0..) |node_type, i| {
+        const node: *Node = switch (@as(Node.NodeType, @enumFromInt(node_type))) {
+            .element => blk: {
+                const elem = if (image.optionalString(extras[i])) |namespace|
+                    try doc.createElementNS(namespace, image.string(names[i]))
+                else
+                    try doc.createElement(image.string(names[i]));
+                errdefer elem.prototype.release();
+
+                const end = attribute_ends[i];
+                try elem.attributes.array.reserve(end - attribute_start);
+                for (attribute_start..end) |a| {
+                    const name = image.string(attribute_names[a]);
+                    const value = image.string(attribute_values[a]);
+                    if (image.optionalString(attribute_namespaces[a])) |namespace| {
+                        try elem.setAttributeNS(namespace, name, value);
+                    } else {
+                        try elem.setAttribute(name, value);
+                    }
+                }
+                attribute_start = end;
+                break :blk &elem.prototype;
+            },
+            .text => &(try doc.createTextNode(image.string(data[i]))).prototype,
+            .comment => &(try doc.createComment(image.string(data[i]))).prototype,
+            .cdata_section => &(try doc.createCDATASection(image.string(data[i]))).prototype.prototype,
+            .processing_instruction => &(try doc.createProcessingInstruction(image.string(names[i]), image.string(data[i]))).prototype.prototype,
+            .document_type => &(try doc.createDocumentType(image.string(names[i]), image.string(data[i]), image.string(extras[i]))).prototype,
+            else => unreachable, // rejected by validate
+        };
+        nodes[i] = node;
+
+        if (parents[i] == none) {
+            roots.appendAssumeCapacity(node);
+        } else {
+            TreeBuilder.appendBuilt(nodes[parents[i]], node);
+        }
+    }
+
+    // One insertion per child of the document connects its subtree
+    for (roots.items) |root| {
+        _ = try doc.prototype.appendChild(root);
+        inserted += 1;
+    }
+}
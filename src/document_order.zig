@@ -0,0 +1,246 @@
+//! Document Order Index - Optional per-document preorder numbering
+//!
+//! `compareDocumentPosition()`, `contains()` and Range boundary point
+//! comparisons normally walk ancestor chains (and sibling lists, to order
+//! two nodes under their common ancestor). Code that sorts many nodes by
+//! document order pays those walks on every comparison. Once enabled with
+//! `Document.enableDocumentOrderIndex()`, the document numbers its tree in
+//! preorder, and tree order and containment between two numbered nodes are
+//! two integer comparisons.
+//!
+//! ## Entries
+//!
+//! Each numbered node stores its preorder number and the number of its last
+//! inclusive descendant, so `a` contains `b` exactly when `b.pre` falls in
+//! `a.pre ... a.last`.
+//!
+//! ## Maintenance
+//!
+//! The numbering is built lazily, on the first query that needs it. Removing
+//! a node from the document tree (or moving it within its parent) drops the
+//! entries of its subtree only: every other node keeps its relative order,
+//! so their numbers stay valid. Inserted nodes are not numbered until the
+//! next build; queries involving them fall back to tree walks, and once
+//! enough queries have fallen back (scaled with the document size, so
+//! rebuilds stay amortized) the index is rebuilt. Idle work (see
+//! idle_work.zig) renumbers the tree after insertions a slice at a time,
+//! into a separate table that replaces the current one when complete, so
+//! queries keep using the old numbers meanwhile.
+//!
+//! Only the document tree is indexed; shadow trees are not.
+
+const std = @import("std");
+const Allocator = std.mem.Allocator;
+const Node = @import("node.zig").Node;
+const Budget = @import("idle_work.zig").Budget;
+
+pub const DocumentOrderIndex = struct {
+    allocator: Allocator,
+    entries: Entries = .{},
+
+    /// Queries answered by tree walks since the last build (starts past the
+    /// threshold, so the first query builds)
+    misses: u32 = std.math.maxInt(u32),
+
+    /// True when nodes may have been inserted since the last build (and
+    /// before the first one)
+    unnumbered: bool = true,
+
+    /// Numbering in progress (see buildStep)
+    pending: ?Pending = null,
+
+    const Entries = std.AutoHashMapUnmanaged(*const Node, Entry);
+
+    /// A numbering built a slice at a time: its entries so far and the
+    /// next node to number, for mutation version `version`
+    const Pending = struct {
+        entries: Entries = .{},
+        cursor: Cursor,
+        version: u64,
+    };
+
+    const Cursor = struct {
+        node: *const Node,
+        order: u32 = 0,
+    };
+
+    pub const Entry = struct {
+        /// Preorder number
+        pre: u32,
+        /// Preorder number of the last inclusive descendant
+        last: u32,
+    };
+
+    /// Tree-order relation of a node `a` to a node `b`.
+    pub const Relation = enum {
+        equal,
+        /// `a` is an ancestor of `b`
+        ancestor,
+        /// `a` is a descendant of `b`
+        descendant,
+        /// `a` precedes `b` and is not its ancestor
+        before,
+        /// `a` follows `b` and is not its descendant
+        after,
+    };
+
+    /// Base number of fallen-back queries before a rebuild
+    const min_misses = 32;
+
+    pub fn init(allocator: Allocator) DocumentOrderIndex {
+        return .{ .allocator = allocator };
+    }
+
+    pub fn deinit(self: *DocumentOrderIndex) void {
+        self.dropPending();
+        self.entries.deinit(self.allocator);
+    }
+
+    /// Relation of `a` to `b` if both are in the document tree rooted at
+    /// `document`, or null when the caller must walk the tree.
+    pub fn relation(self: *DocumentOrderIndex, document: *Node, a: *const Node, b: *const Node) ?Relation {
+        if (a == b) return .equal;
+
+        if (self.entries.get(a)) |ea| {
+            if (self.entries.get(b)) |eb| return compareEntries(ea, eb);
+        }
+
+        // Nodes outside the document tree never get numbered
+        if (!a.isConnected() or !b.isConnected()) return null;
+
+        self.misses +|= 1;
+        if (self.misses < min_misses + self.entries.count() / 16) return null;
+
+        self.build(document) catch return null;
+        const ea = self.entries.get(a) orelse return null;
+        const eb = self.entries.get(b) orelse return null;
+        return compareEntries(ea, eb);
+    }
+
+    /// Drops the entry of one node (the caller visits its descendants).
+    pub fn forget(self: *DocumentOrderIndex, node: *const Node) void {
+        _ = self.entries.remove(node);
+    }
+
+    /// Drops the entries of `node` and all its descendants.
+    pub fn forgetSubtree(self: *DocumentOrderIndex, node: *const Node) void {
+        if (self.entries.count() == 0) return;
+
+        var current: *const Node = node;
+        while (true) {
+            _ = self.entries.remove(current);
+            if (current.first_child) |child| {
+                current = child;
+                continue;
+            }
+            while (current != node) {
+                if (current.next_sibling) |next| {
+                    current = next;
+                    break;
+                }
+                current = current.parent_node.?;
+            } else return;
+        }
+    }
+
+    /// Numbers the tree rooted at `document` in preorder.
+    pub fn build(self: *DocumentOrderIndex, document: *Node) !void {
+        self.dropPending();
+        self.misses = 0;
+        self.entries.clearRetainingCapacity();
+
+        var cursor = Cursor{ .node = document };
+        _ = try self.fill(&self.entries, document, &cursor, null);
+        self.unnumbered = false;
+    }
+
+    /// Continues numbering the tree rooted at `document` after insertions,
+    /// for one slice of `budget`. `version` is the document's mutation
+    /// version; if the document changed since the previous slice, the
+    /// numbering starts over. Completed numberings replace the entries.
+    ///
+    /// ## Returns
+    /// True once every node is numbered, false if the budget ran out first.
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to grow the table (the next step
+    ///   starts over)
+    pub fn buildStep(self: *DocumentOrderIndex, document: *Node, version: u64, budget: *Budget) !bool {
+        if (!self.unnumbered) return true;
+        if (self.pending == null or self.pending.?.version != version) {
+            self.dropPending();
+            self.pending = .{ .cursor = .{ .node = document }, .version = version };
+        }
+        errdefer self.dropPending();
+
+        const next = &self.pending.?;
+        if (!try self.fill(&next.entries, document, &next.cursor, budget)) return false;
+
+        self.entries.deinit(self.allocator);
+        self.entries = next.entries;
+        self.pending = null;
+        self.misses = 0;
+        self.unnumbered = false;
+        return true;
+    }
+
+    /// Numbers the nodes of the tree rooted at `document` from `cursor` on,
+    /// stopping early (with `cursor` at the next node) once `budget` is
+    /// spent. Returns true when the whole tree is numbered.
+    fn fill(self: *DocumentOrderIndex, entries: *Entries, document: *Node, cursor: *Cursor, budget: ?*Budget) !bool {
+        while (true) {
+            if (budget) |b| {
+                if (b.tick()) return false;
+            }
+            const node = cursor.node;
+            try entries.put(self.allocator, node, .{ .pre = cursor.order, .last = cursor.order });
+            cursor.order += 1;
+            if (node.first_child) |child| {
+                cursor.node = child;
+                continue;
+            }
+
+            // Close every subtree that ends here
+            var closing = node;
+            while (true) {
+                entries.getPtr(closing).?.last = cursor.order - 1;
+                if (closing == document) return true;
+                if (closing.next_sibling) |sibling| {
+                    cursor.node = sibling;
+                    break;
+                }
+                closing = closing.parent_node.?;
+            }
+        }
+    }
+
+    fn dropPending(self: *DocumentOrderIndex) void {
+        if (self.pending) |*next| next.entries.deinit(self.allocator);
+        self.pending = null;
+    }
+
+    fn compareEntries(a: Entry, b: Entry) Relation {
+        if (a.pre < b.pre) {
+            return if (b.pre <= a.last) .ancestor else .before;
+        }
+        return if (a.pre <= b.last) .descendant else .after;
+    }
+};
+
+/// Relation of `a` to `b` from their document's order index, or null when
+/// the index is disabled or cannot answer (the caller walks the tree).
+pub fn relation(a: *const Node, b: *const Node) ?DocumentOrderIndex.Relation {
+    const doc_node = documentOf(a) orelse return null;
+    if (documentOf(b) != doc_node) return null;
+
+    const Document = @import("document.zig").Document;
+    const doc: *Document = @fieldParentPtr("prototype", doc_node);
+    const index = doc.order_index orelse return null;
+    return index.relation(doc_node, a, b);
+}
+
+fn documentOf(node: *const Node) ?*Node {
+    if (node.node_type == .document) return @constCast(node);
+    const owner = node.owner_document orelse return null;
+    return if (owner.node_type == .document) owner else null;
+}
@@ -365,6 +365,13 @@ pub const DocumentType = struct {
             allocator.free(doctype.name);
             allocator.free(doctype.publicId);
             allocator.free(doctype.systemId);
+        } else if (node.owner_document.?.node_type == .document) {
+            // Doctypes hold no document node ref, so drop the cached hash
+            // and the node's id here
+            const Document = @import("document.zig").Document;
+            const doc: *Document = @fieldParentPtr("prototype", node.owner_document.?);
+            if (doc.structural_hashes) |hashes| hashes.forget(node);
+            if (doc.node_table) |table| table.forget(node);
         }
 
         // Destroy the node itself
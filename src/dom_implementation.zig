@@ -203,6 +203,7 @@
 const std = @import("std");
 const Allocator = std.mem.Allocator;
 const Document = @import("document.zig").Document;
+const Capacity = @import("document.zig").Capacity;
 const DocumentType = @import("document_type.zig").DocumentType;
 
 /// DOMImplementation - Factory for creating documents and document types.
@@ -352,10 +353,28 @@ pub const DOMImplementation = struct {
         namespace: ?[]const u8,
         qualified_name: []const u8,
         doctype: ?*DocumentType,
+    ) !*Document {
+        return self.createDocumentWithCapacity(namespace, qualified_name, doctype, .{});
+    }
+
+    /// createDocument() for a document about to be filled with known
+    /// content (a template instantiated many times, a cloned source):
+    /// its storage is pre-sized with Document.reserve(capacity) before the
+    /// root element and doctype are added. Non-standard.
+    ///
+    /// ## Errors
+    /// Same as createDocument()
+    pub fn createDocumentWithCapacity(
+        self: *const DOMImplementation,
+        namespace: ?[]const u8,
+        qualified_name: []const u8,
+        doctype: ?*DocumentType,
+        capacity: Capacity,
     ) !*Document {
         // Step 1: Create new document using same allocator as parent document
         const doc = try Document.init(self.document.prototype.allocator);
         errdefer doc.release();
+        try doc.reserve(capacity);
 
         // Step 2: If qualified_name not empty, create and append root element
         if (qualified_name.len > 0) {
@@ -471,8 +471,8 @@ pub const DOMTokenList = struct {
                 const interned = blk: {
                     var it = doc.string_pool.strings.iterator();
                     while (it.next()) |entry| {
-                        if (std.mem.eql(u8, entry.value_ptr.*, new_value)) {
-                            break :blk entry.value_ptr.*;
+                        if (std.mem.eql(u8, entry.value_ptr.str, new_value)) {
+                            break :blk entry.value_ptr.str;
                         }
                     }
                     // Not found, intern it
@@ -567,8 +567,8 @@ pub const DOMTokenList = struct {
                     const interned = blk: {
                         var it = doc.string_pool.strings.iterator();
                         while (it.next()) |entry| {
-                            if (std.mem.eql(u8, entry.value_ptr.*, new_value)) {
-                                break :blk entry.value_ptr.*;
+                            if (std.mem.eql(u8, entry.value_ptr.str, new_value)) {
+                                break :blk entry.value_ptr.str;
                             }
                         }
                         // Not found, intern it
@@ -757,8 +757,8 @@ pub const DOMTokenList = struct {
                 const interned = blk: {
                     var it = doc.string_pool.strings.iterator();
                     while (it.next()) |entry| {
-                        if (std.mem.eql(u8, entry.value_ptr.*, new_value)) {
-                            break :blk entry.value_ptr.*;
+                        if (std.mem.eql(u8, entry.value_ptr.str, new_value)) {
+                            break :blk entry.value_ptr.str;
                         }
                     }
                     // Not found, intern it
@@ -241,6 +241,7 @@ const Attr = @import("attr.zig").Attr;
 const NamedNodeMap = @import("named_node_map.zig").NamedNodeMap;
 const DOMError = @import("validation.zig").DOMError;
 const AttributeArray = @import("attribute_array.zig").AttributeArray;
+const Attribute = @import("attribute.zig").Attribute;
 const CustomElementDefinition = @import("custom_element_registry.zig").CustomElementDefinition;
 const CustomElementReactionQueue = @import("custom_element_registry.zig").CustomElementReactionQueue;
 const CEReactionsStack = @import("custom_element_registry.zig").CEReactionsStack;
@@ -363,17 +364,11 @@ pub const AttributeMap = struct {
         // qualified name is 'name', IRRESPECTIVE of namespace.
         // See: https://dom.spec.whatwg.org/#dom-element-getattribute
 
-        // Iterate through all attributes and return first match by qualified name
-        var iter = self.array.iterator();
-        while (iter.next()) |attr| {
-            // Match on local_name (which is the qualified name for all attributes)
-            // For namespaced attributes, this would be "prefix:localName" but we
-            // store just the local part, so we match on that.
-            if (std.mem.eql(u8, name, attr.name.local_name)) {
-                return attr.value;
-            }
-        }
-        return null;
+        // Match on local_name (which is the qualified name for all attributes)
+        // For namespaced attributes, this would be "prefix:localName" but we
+        // store just the local part, so we match on that.
+        const attr = self.array.getByLocalName(name) orelse return null;
+        return attr.value;
     }
 
     pub fn remove(self: *AttributeMap, name: []const u8) bool {
@@ -381,15 +376,9 @@ pub const AttributeMap = struct {
         // qualified name is 'name', IRRESPECTIVE of namespace.
         // See: https://dom.spec.whatwg.org/#dom-element-removeattribute
 
-        // Iterate through all attributes and remove first match by qualified name
-        var iter = self.array.iterator();
-        while (iter.next()) |attr| {
-            // Match on local_name (qualified name comparison for now)
-            if (std.mem.eql(u8, name, attr.name.local_name)) {
-                return self.array.remove(attr.name.local_name, attr.name.namespace_uri);
-            }
-        }
-        return false;
+        // Match on local_name (qualified name comparison for now)
+        const attr = self.array.getByLocalName(name) orelse return false;
+        return self.array.remove(attr.name.local_name, attr.name.namespace_uri);
     }
 
     pub fn has(self: *const AttributeMap, name: []const u8) bool {
@@ -402,6 +391,11 @@ pub const AttributeMap = struct {
         return self.array.count();
     }
 
+    /// Returns the attribute at `index` in insertion order.
+    pub fn at(self: *const AttributeMap, index: usize) ?Attribute {
+        return self.array.at(index);
+    }
+
     /// Returns an iterator over attributes.
     ///
     /// For backward compatibility with code that accessed .map.iterator().
@@ -428,6 +422,12 @@ pub const AttributeMap = struct {
     }
 };
 
+/// One attribute for Element.setAttributes().
+pub const AttributeInit = struct {
+    name: []const u8,
+    value: []const u8,
+};
+
 /// Attr node cache for [SameObject] semantics.
 ///
 /// Caches Attr nodes to ensure repeated calls to getAttributeNode()
@@ -939,6 +939,8 @@ pub const Element = struct {
     /// See: https://dom.spec.whatwg.org/#dom-element-setattribute
     /// See: https://developer.mozilla.org/en-US/docs/Web/API/Element/setAttribute
     pub fn setAttribute(self: *Element, name: []const u8, value: []const u8) !void {
+        try self.prototype.checkMutable();
+
         // [CEReactions] scope for custom element lifecycle callbacks (Phase 4)
         if (self.prototype.owner_document) |doc_node| {
             if (doc_node.node_type == .document) {
@@ -965,50 +967,46 @@ pub const Element = struct {
         try setAttributeImpl(self, name, value, old_value, null);
     }
 
+    /// Sets several attributes, in order, as consecutive setAttribute()
+    /// calls would (one mutation record and custom element reaction each),
+    /// with attribute storage reserved once for all of them.
+    ///
+    /// ## Errors
+    ///
+    /// - `error.OutOfMemory`: Failed to allocate; the attributes before the
+    ///   failing one are set
+    pub fn setAttributes(self: *Element, attributes: []const AttributeInit) !void {
+        try self.attributes.array.reserve(attributes.len);
+        for (attributes) |attr| {
+            try self.setAttribute(attr.name, attr.value);
+        }
+    }
+
     /// Internal implementation of setAttribute (extracted to avoid duplication).
     fn setAttributeImpl(self: *Element, name: []const u8, value: []const u8, old_value: ?[]const u8, namespace: ?[]const u8) !void {
         _ = namespace; // Currently unused, for future setAttributeNS support
 
-        // Handle ID attribute changes (maintain document ID map)
-        // Only update id_map if element is connected to the document tree
+        // Handle ID attribute changes (maintain document ID index)
+        // Only connected elements are indexed
         // Per browser behavior: disconnected elements don't participate in getElementById
         if (std.mem.eql(u8, name, "id")) {
-            if (self.prototype.isConnected()) {
-                // Remove old ID from document map if it exists and this element is the one mapped
+            if (self.prototype.isInShadowTree()) {
+                @import("shadow_index.zig").idChanged(self, self.getAttribute("id"), null);
+            } else if (self.prototype.isConnected()) {
                 if (self.getAttribute("id")) |old_id| {
-                    if (self.prototype.owner_document) |owner| {
-                        if (owner.node_type == .document) {
-                            const Document = @import("document.zig").Document;
-                            const doc: *Document = @fieldParentPtr("prototype", owner);
-
-                            // Only remove if this element is the one in the map
-                            if (doc.id_map.get(old_id)) |mapped_elem| {
-                                if (mapped_elem == self) {
-                                    _ = doc.id_map.remove(old_id);
-                                    doc.invalidateIdCache();
-
-                                    // Search for another element with the same ID to replace it
-                                    const ElementIterator = @import("element_iterator.zig").ElementIterator;
-                                    var iter = ElementIterator.init(&doc.prototype);
-                                    while (iter.next()) |other_elem| {
-                                        if (other_elem != self) {
-                                            if (other_elem.getId()) |other_id| {
-                                                if (std.mem.eql(u8, other_id, old_id)) {
-                                                    doc.id_map.put(old_id, other_elem) catch {};
-                                                    doc.invalidateIdCache();
-                                                    break;
-                                                }
-                                            }
-                                        }
-                                    }
-                                }
-                            }
-                        }
+                    if (self.ownerDocumentNode()) |doc| {
+                        doc.id_map.remove(old_id, self);
+                        doc.invalidateIdCache();
                     }
                 }
             }
         }
 
+        // Drop old class tokens from the document's class index
+        if (std.mem.eql(u8, name, "class")) {
+            self.unindexClasses();
+        }
+
         // Intern BOTH name and value for stable pointers and null-termination
         // CRITICAL: Names must be interned to prevent use-after-free when C API
         // strings (from V8, Node.js, etc.) become invalid after function returns.
@@ -1018,7 +1016,7 @@ pub const Element = struct {
                 const Document = @import("document.zig").Document;
                 const doc: *Document = @fieldParentPtr("prototype", owner);
                 break :blk InternedStrings{
-                    .interned_name = try doc.string_pool.intern(name),
+                    .interned_name = try doc.string_pool.internName(name),
                     .interned_value = try doc.string_pool.intern(value),
                 };
             }
@@ -1033,28 +1031,25 @@ pub const Element = struct {
 
         // Set the attribute with interned strings
         try self.attributes.set(interned.interned_name, interned.interned_value);
+        self.prototype.noteMutation();
 
-        // Invalidate cached Attr for this name
-        self.invalidateCachedAttr(interned.interned_name);
+        // A cached Attr stays attached and takes the new value
+        self.syncCachedAttr(interned.interned_name, interned.interned_value);
 
         // Update bloom filter for class attribute (Phase 3: class_map removed, bloom filter still used)
         if (std.mem.eql(u8, interned.interned_name, "class")) {
             self.updateClassBloom(interned.interned_value);
+            try self.indexClasses(interned.interned_value);
         }
 
-        // Add new ID to document map (only if connected, and only if ID not already in use - first wins)
+        // Add new ID to document index (only if connected; kept in tree order)
         if (std.mem.eql(u8, interned.interned_name, "id")) {
-            if (self.prototype.isConnected()) {
-                if (self.prototype.owner_document) |owner| {
-                    if (owner.node_type == .document) {
-                        const Document = @import("document.zig").Document;
-                        const doc: *Document = @fieldParentPtr("prototype", owner);
-                        const result = try doc.id_map.getOrPut(interned.interned_value);
-                        if (!result.found_existing) {
-                            result.value_ptr.* = self;
-                            doc.invalidateIdCache();
-                        }
-                    }
+            if (self.prototype.isInShadowTree()) {
+                @import("shadow_index.zig").idChanged(self, null, interned.interned_value);
+            } else if (self.prototype.isConnected()) {
+                if (self.ownerDocumentNode()) |doc| {
+                    try doc.id_map.add(&doc.string_pool, interned.interned_value, self);
+                    doc.invalidateIdCache();
                 }
             }
         }
@@ -1062,22 +1057,13 @@ pub const Element = struct {
         // Handle slot name attribute changes (WHATWG DOM §4.2.2.3)
         // When a slot's name changes, reassign all slottables in the shadow tree
         if (std.mem.eql(u8, name, "name") and std.mem.eql(u8, self.tag_name, "slot")) {
-            // Run assign slottables for a tree with element's root
-            const root = self.prototype.getRootNode(false);
-            if (root.node_type == .shadow_root) {
-                assignSlottablesForTree(self.prototype.allocator, root) catch {};
-            }
+            self.slotRenamed();
         }
 
         // Handle slottable slot attribute changes (WHATWG DOM §4.2.2.3)
         // When an element's slot attribute changes, reassign it to the correct slot
         if (std.mem.eql(u8, name, "slot")) {
-            // If element is assigned, run assign slottables for element's assigned slot
-            if (self.assignedSlot()) |assigned| {
-                assignSlottables(self.prototype.allocator, assigned) catch {};
-            }
-            // Run assign a slot for element
-            assignASlot(self.prototype.allocator, &self.prototype) catch {};
+            self.slotAttributeChanged();
         }
 
         // Queue mutation record for attributes
@@ -1133,6 +1119,9 @@ pub const Element = struct {
     /// ## Parameters
     /// - `name`: Attribute name to remove
     pub fn removeAttribute(self: *Element, name: []const u8) void {
+        // No error channel: a frozen document's attributes are left as is
+        self.prototype.checkMutable() catch return;
+
         // [CEReactions] scope for custom element lifecycle callbacks (Phase 4)
         if (self.prototype.owner_document) |doc_node| {
             if (doc_node.node_type == .document) {
@@ -1163,48 +1152,30 @@ pub const Element = struct {
     /// Internal implementation of removeAttribute (extracted to avoid duplication).
     fn removeAttributeImpl(self: *Element, name: []const u8, old_value: ?[]const u8) void {
 
-        // Remove ID from document map before removing attribute (only if connected and this element is mapped)
+        // Remove ID from document index before removing attribute (only if connected)
         if (std.mem.eql(u8, name, "id")) {
-            if (self.prototype.isConnected()) {
+            if (self.prototype.isInShadowTree()) {
+                @import("shadow_index.zig").idChanged(self, self.getAttribute("id"), null);
+            } else if (self.prototype.isConnected()) {
                 if (self.getAttribute("id")) |old_id| {
-                    if (self.prototype.owner_document) |owner| {
-                        if (owner.node_type == .document) {
-                            const Document = @import("document.zig").Document;
-                            const doc: *Document = @fieldParentPtr("prototype", owner);
-
-                            // Only remove if this element is the one in the map
-                            if (doc.id_map.get(old_id)) |mapped_elem| {
-                                if (mapped_elem == self) {
-                                    _ = doc.id_map.remove(old_id);
-                                    doc.invalidateIdCache();
-
-                                    // Search for another element with the same ID to replace it
-                                    const ElementIterator = @import("element_iterator.zig").ElementIterator;
-                                    var iter = ElementIterator.init(&doc.prototype);
-                                    while (iter.next()) |other_elem| {
-                                        if (other_elem != self) {
-                                            if (other_elem.getId()) |other_id| {
-                                                if (std.mem.eql(u8, other_id, old_id)) {
-                                                    doc.id_map.put(old_id, other_elem) catch {};
-                                                    doc.invalidateIdCache();
-                                                    break;
-                                                }
-                                            }
-                                        }
-                                    }
-                                }
-                            }
-                        }
+                    if (self.ownerDocumentNode()) |doc| {
+                        doc.id_map.remove(old_id, self);
+                        doc.invalidateIdCache();
                     }
                 }
             }
         }
 
+        if (std.mem.eql(u8, name, "class")) {
+            self.unindexClasses();
+        }
+
         const removed = self.attributes.remove(name);
 
         // Invalidate cached Attr for this name
         if (removed) {
             self.invalidateCachedAttr(name);
+            self.prototype.noteMutation();
         }
 
         // Clear bloom filter if removing class attribute (Phase 3: class_map removed, bloom filter still used)
@@ -1215,22 +1186,13 @@ pub const Element = struct {
         // Handle slot name attribute removal (WHATWG DOM §4.2.2.3)
         // When a slot's name is removed, it becomes a default slot - reassign all slottables
         if (removed and std.mem.eql(u8, name, "name") and std.mem.eql(u8, self.tag_name, "slot")) {
-            // Run assign slottables for a tree with element's root
-            const root = self.prototype.getRootNode(false);
-            if (root.node_type == .shadow_root) {
-                assignSlottablesForTree(self.prototype.allocator, root) catch {};
-            }
+            self.slotRenamed();
         }
 
         // Handle slottable slot attribute removal (WHATWG DOM §4.2.2.3)
         // When an element's slot attribute is removed, reassign it to default slot
         if (removed and std.mem.eql(u8, name, "slot")) {
-            // If element was assigned, run assign slottables for its old slot
-            if (self.assignedSlot()) |assigned| {
-                assignSlottables(self.prototype.allocator, assigned) catch {};
-            }
-            // Run assign a slot for element (will now match default slot)
-            assignASlot(self.prototype.allocator, &self.prototype) catch {};
+            self.slotAttributeChanged();
         }
 
         // Queue mutation record for attributes (only if attribute was actually removed)
@@ -1336,6 +1298,8 @@ pub const Element = struct {
         qualified_name: []const u8,
         value: []const u8,
     ) !void {
+        try self.prototype.checkMutable();
+
         // [CEReactions] scope for custom element lifecycle callbacks (Phase 5)
         if (self.prototype.owner_document) |doc_node| {
             if (doc_node.node_type == .document) {
@@ -1372,7 +1336,7 @@ pub const Element = struct {
             if (owner.node_type == .document) {
                 const Document = @import("document.zig").Document;
                 const doc: *Document = @fieldParentPtr("prototype", owner);
-                break :blk try doc.string_pool.intern(qualified_name);
+                break :blk try doc.string_pool.internName(qualified_name);
             }
             break :blk qualified_name;
         } else qualified_name;
@@ -1400,6 +1364,7 @@ pub const Element = struct {
         // Step 2: Set attribute value with namespace (use qualified name for AttributeArray)
         // AttributeArray.set needs to be updated to accept qualified_name for NS attributes
         try self.attributes.array.setNS(interned_qualified, interned_ns, interned_value);
+        self.prototype.noteMutation();
 
         // Queue mutation record for attributes
         node_mod.queueMutationRecord(
@@ -1456,6 +1421,8 @@ pub const Element = struct {
         namespace: ?[]const u8,
         local_name: []const u8,
     ) void {
+        self.prototype.checkMutable() catch return;
+
         // [CEReactions] scope for custom element lifecycle callbacks (Phase 5)
         if (self.prototype.owner_document) |doc_node| {
             if (doc_node.node_type == .document) {
@@ -1487,6 +1454,8 @@ pub const Element = struct {
 
         // Queue mutation record for attributes (only if attribute was actually removed)
         if (removed) {
+            self.prototype.noteMutation();
+
             node_mod.queueMutationRecord(
                 &self.prototype,
                 "attributes",
@@ -1698,6 +1667,8 @@ pub const Element = struct {
     /// button.toggleAttribute('disabled', true); // Always add
     /// ```
     pub fn toggleAttribute(self: *Element, qualified_name: []const u8, force: ?bool) !bool {
+        try self.prototype.checkMutable();
+
         // Step 1: Validate qualified name
         // TODO: Add XML Name production validation per spec
         // For now, rely on setAttribute's validation
@@ -1939,6 +1910,19 @@ pub const Element = struct {
     /// - Cache holds its own reference (released on invalidation or deinit)
     /// - This ensures [SameObject] while allowing caller to safely release
     pub fn getOrCreateCachedAttr(self: *Element, name: []const u8, value: []const u8) !*Attr {
+        const attr = try self.cachedAttr(name, value);
+        // Acquire reference for caller (they must release)
+        attr.node.acquire();
+        return attr;
+    }
+
+    /// Like `getOrCreateCachedAttr`, but borrowed: the returned Attr holds
+    /// no reference for the caller. It stays valid while it is this
+    /// element's attribute node, i.e. until the attribute is removed or
+    /// replaced, or the element is destroyed; callers that keep it longer
+    /// acquire it themselves. Reading attribute nodes through this touches
+    /// no reference count once the Attr is cached.
+    pub fn cachedAttr(self: *Element, name: []const u8, value: []const u8) !*Attr {
         // Lazy initialize cache on first access
         if (self.attr_cache == null) {
             self.attr_cache = AttrCache.init(self.prototype.allocator);
@@ -1948,25 +1932,18 @@ pub const Element = struct {
         if (self.attr_cache.?.get(name)) |cached| {
             // Update value if it changed (AttributeMap is source of truth)
             if (!std.mem.eql(u8, cached.value(), value)) {
-                try cached.setValue(value);
+                try cached.storeValue(value);
             }
-            // Acquire reference for caller (they must release)
-            cached.node.acquire();
             return cached;
         }
 
-        // Not in cache - create new Attr (ref_count=1)
+        // Not in cache - create new Attr (ref_count=1, the cache's reference)
         const attr = try Attr.create(self.prototype.allocator, name);
         errdefer attr.node.release();
 
-        try attr.setValue(value);
+        try attr.storeValue(value);
         attr.owner_element = self;
-
-        // Add to cache (cache holds one strong reference)
-        attr.node.acquire(); // Cache's reference
         try self.attr_cache.?.put(name, attr);
-
-        // Return to caller (they hold the original ref_count=1)
         return attr;
     }
 
@@ -2001,16 +1978,28 @@ pub const Element = struct {
         attr.prefix = prefix;
         attr.local_name = local_name;
 
-        try attr.setValue(value);
+        try attr.storeValue(value);
         attr.owner_element = self;
 
         // Return to caller (they hold ref_count=1, must release)
         return attr;
     }
 
+    /// Updates the value of a cached Attr node after setAttribute, so the
+    /// node handed out earlier stays the element's attribute node.
+    fn syncCachedAttr(self: *Element, name: []const u8, value: []const u8) void {
+        const cache_ptr = &self.attr_cache;
+        if (cache_ptr.*) |*cache| {
+            const cached = cache.get(name) orelse return;
+            if (std.mem.eql(u8, cached.value(), value)) return;
+            // Out of memory: drop it, the next access creates a fresh Attr
+            cached.storeValue(value) catch self.invalidateCachedAttr(name);
+        }
+    }
+
     /// Invalidates a single cached Attr node.
     ///
-    /// Called when an attribute is modified or removed via setAttribute/removeAttribute.
+    /// Called when an attribute is removed via removeAttribute.
     /// Removes from cache and releases the cache's reference.
     fn invalidateCachedAttr(self: *Element, name: []const u8) void {
         // Access cache through pointer capture to avoid alignment issues
@@ -2361,19 +2350,29 @@ pub const Element = struct {
     /// ## Note
     /// This is called internally during slot assignment. Users should not call this directly.
     pub fn setAssignedSlot(self: *Element, slot: ?*Element) !void {
-        if (slot == null) {
-            // Clear assigned slot
-            if (self.prototype.rare_data) |rare_data| {
-                rare_data.assigned_slot = null;
-            }
-            return;
-        }
+        // WEAK reference; drops the host's cached assigned nodes
+        try @import("slot_map.zig").setAssignedSlot(&self.prototype, slot);
+    }
 
-        // Ensure rare data exists
-        const rare_data = try self.prototype.ensureRareData();
+    /// A slot's name changed: the shadow tree's slot names are stale, and
+    /// the host's children may now find other slots.
+    fn slotRenamed(self: *Element) void {
+        const root = self.prototype.getRootNode(false);
+        if (root.node_type != .shadow_root) return;
 
-        // Set assigned slot (WEAK reference)
-        rare_data.assigned_slot = @ptrCast(slot.?);
+        const ShadowRoot = @import("shadow_root.zig").ShadowRoot;
+        const shadow: *ShadowRoot = @fieldParentPtr("prototype", root);
+        shadow.slots.invalidateNames();
+        @import("slot_map.zig").reassignHostChildren(shadow);
+    }
+
+    /// A slottable's slot attribute changed: find its slot again.
+    fn slotAttributeChanged(self: *Element) void {
+        const slot_map = @import("slot_map.zig");
+        const parent = self.prototype.parent_node orelse return;
+        const shadow = slot_map.shadowOf(parent) orelse return;
+        if (shadow.slot_assignment != .named) return;
+        slot_map.setAssignedSlot(&self.prototype, findSlot(&self.prototype, false)) catch {};
     }
 
     // ========================================================================
@@ -2424,52 +2423,27 @@ pub const Element = struct {
             return &[_]*Node{};
         }
 
-        // Collect nodes that are assigned to this slot
-        var nodes = std.ArrayList(*Node){};
-        errdefer nodes.deinit(allocator);
+        return allocator.dupe(*Node, try self.assignedNodesCached());
+    }
 
-        // Find nodes in the host's children that are assigned to this slot
-        // For now, we'll search through all nodes and check their assignedSlot
-        // TODO: Optimize with a reverse map from slot -> assigned nodes
+    /// Returns the nodes assigned to this slot element without copying.
+    ///
+    /// Answered from the shadow root's cached assignment lists (see
+    /// slot_map.zig), which are rebuilt in one pass over the host's
+    /// children after the host's children or an assignment change. The
+    /// slice is borrowed: it is valid until the next such change.
+    ///
+    /// ## Errors
+    /// - `OutOfMemory`: Failed to build the lists
+    pub fn assignedNodesCached(self: *const Element) ![]const *Node {
+        if (!std.mem.eql(u8, self.tag_name, "slot")) return &[_]*Node{};
 
-        // Get the shadow root that contains this slot
-        var current: ?*Node = @constCast(&self.prototype);
-        while (current) |node| {
-            if (node.node_type == .shadow_root) {
-                // This is a shadow root - get its host
-                const ShadowRoot = @import("shadow_root.zig").ShadowRoot;
-                const shadow: *ShadowRoot = @fieldParentPtr("prototype", node);
-                const host = shadow.host_element;
-
-                // Iterate through host's children
-                var child = host.prototype.first_child;
-                while (child) |child_node| {
-                    // Check if this node is assigned to our slot
-                    if (child_node.node_type == .element) {
-                        const child_elem: *Element = @fieldParentPtr("prototype", child_node);
-                        if (child_elem.assignedSlot()) |assigned| {
-                            if (assigned == self) {
-                                try nodes.append(allocator, child_node);
-                            }
-                        }
-                    } else if (child_node.node_type == .text) {
-                        // Text nodes can also be assigned to slots
-                        const Text = @import("text.zig").Text;
-                        const text: *Text = @fieldParentPtr("prototype", child_node);
-                        if (text.assignedSlot()) |assigned| {
-                            if (assigned == self) {
-                                try nodes.append(allocator, child_node);
-                            }
-                        }
-                    }
-                    child = child_node.next_sibling;
-                }
-                break;
-            }
-            current = node.parent_node;
-        }
+        const root = self.prototype.getRootNode(false);
+        if (root.node_type != .shadow_root) return &[_]*Node{};
 
-        return nodes.toOwnedSlice(allocator);
+        const ShadowRoot = @import("shadow_root.zig").ShadowRoot;
+        const shadow: *ShadowRoot = @fieldParentPtr("prototype", root);
+        return shadow.slots.assignedTo(shadow, self);
     }
 
     /// Returns only the element nodes assigned to this slot.
@@ -2551,21 +2525,20 @@ pub const Element = struct {
             return error.InvalidNodeType;
         }
 
-        // Clear existing assignments for this slot
-        // (find all nodes assigned to this slot and clear them)
-        // TODO: Optimize with reverse map
+        const slot_map = @import("slot_map.zig");
+
+        // Clear existing assignments for this slot (copied: clearing
+        // drops the cached list)
+        const previous = try self.prototype.allocator.dupe(*Node, try self.assignedNodesCached());
+        defer self.prototype.allocator.free(previous);
+        for (previous) |node| try slot_map.setAssignedSlot(node, null);
 
         // Assign new nodes to this slot
         for (nodes) |node| {
-            if (node.node_type == .element) {
-                const elem: *Element = @fieldParentPtr("prototype", node);
-                try elem.setAssignedSlot(self);
-            } else if (node.node_type == .text) {
-                const Text = @import("text.zig").Text;
-                const text: *Text = @fieldParentPtr("prototype", node);
-                try text.setAssignedSlot(self);
-            }
             // Ignore other node types (only Element and Text are slottable)
+            if (node.node_type == .element or node.node_type == .text) {
+                try slot_map.setAssignedSlot(node, self);
+            }
         }
     }
 
@@ -2645,33 +2618,8 @@ pub const Element = struct {
         }
 
         // 6. Return the first slot in tree order in shadow's descendants whose name is
-        //    slottable's name, if any; otherwise null.
-        return findSlotByName(&shadow.prototype, slottable_name);
-    }
-
-    /// Helper: Find a slot by name in tree order.
-    fn findSlotByName(root: *const Node, name: []const u8) ?*Element {
-        var current = root.first_child;
-        while (current) |node| {
-            if (node.node_type == .element) {
-                const elem: *const Element = @fieldParentPtr("prototype", node);
-
-                // Check if this is a slot with matching name
-                if (std.mem.eql(u8, elem.tag_name, "slot")) {
-                    const slot_name = elem.getAttribute("name") orelse "";
-                    if (std.mem.eql(u8, slot_name, name)) {
-                        return @constCast(elem);
-                    }
-                }
-
-                // Recursively search descendants
-                if (findSlotByName(node, name)) |found| {
-                    return found;
-                }
-            }
-            current = node.next_sibling;
-        }
-        return null;
+        //    slottable's name, if any; otherwise null (from the shadow root's name map).
+        return @constCast(shadow).slots.find(shadow, slottable_name);
     }
 
     /// Helper: Find a slot that manually contains the given slottable.
@@ -2953,61 +2901,10 @@ pub const Element = struct {
             return error.InvalidSelector;
         }
 
-        // Try to get parsed selector from cache if we have an owner document
-        const parsed_selector = blk: {
-            if (self.prototype.owner_document) |owner| {
-                if (owner.node_type == .document) {
-                    const Document = @import("document.zig").Document;
-                    const doc: *Document = @fieldParentPtr("prototype", owner);
-                    break :blk try doc.selector_cache.get(selectors);
-                }
-            }
-            // No document, parse directly
-            break :blk null;
-        };
-
-        // Use fast path if available
-        if (parsed_selector) |parsed| {
-            switch (parsed.fast_path) {
-                .simple_id => {
-                    if (parsed.identifier) |id| {
-                        return self.queryById(id);
-                    }
-                },
-                .simple_class => {
-                    if (parsed.identifier) |class_name| {
-                        return self.queryByClass(class_name);
-                    }
-                },
-                .simple_tag => {
-                    if (parsed.identifier) |tag_name| {
-                        return self.queryByTagName(tag_name);
-                    }
-                },
-                .id_filtered, .generic => {
-                    // Use cached parsed selector
-                    const Matcher = @import("selector/matcher.zig").Matcher;
-                    const matcher = Matcher.init(allocator);
-
-                    // Traverse descendants in tree order
-                    var current = self.prototype.first_child;
-                    while (current) |node| {
-                        if (node.node_type == .element) {
-                            const elem: *Element = @fieldParentPtr("prototype", node);
-
-                            if (try matcher.matches(elem, &parsed.selector_list)) {
-                                return elem;
-                            }
-
-                            if (try elem.querySelector(allocator, selectors)) |found| {
-                                return found;
-                            }
-                        }
-                        current = node.next_sibling;
-                    }
-                    return null;
-                },
-            }
+        // Use the document's cached parse when there is one
+        if (try self.cachedSelector(selectors)) |parsed| {
+            defer parsed.release();
+            return try self.querySelectorParsed(allocator, parsed);
         }
 
         // Fallback: parse selector without caching
@@ -3097,54 +2994,10 @@ pub const Element = struct {
             return error.InvalidSelector;
         }
 
-        // Try to get parsed selector from cache if we have an owner document
-        const parsed_selector = blk: {
-            if (self.prototype.owner_document) |owner| {
-                if (owner.node_type == .document) {
-                    const Document = @import("document.zig").Document;
-                    const doc: *Document = @fieldParentPtr("prototype", owner);
-                    break :blk try doc.selector_cache.get(selectors);
-                }
-            }
-            break :blk null;
-        };
-
-        // Use fast path if available
-        if (parsed_selector) |parsed| {
-            switch (parsed.fast_path) {
-                .simple_class => {
-                    if (parsed.identifier) |class_name| {
-                        return try self.queryAllByClass(allocator, class_name);
-                    }
-                },
-                .simple_tag => {
-                    if (parsed.identifier) |tag_name| {
-                        return try self.queryAllByTagName(allocator, tag_name);
-                    }
-                },
-                .simple_id => {
-                    // ID queries return at most one result
-                    if (parsed.identifier) |id| {
-                        if (self.queryById(id)) |elem| {
-                            const result = try allocator.alloc(*Element, 1);
-                            result[0] = elem;
-                            return result;
-                        }
-                        return &[_]*Element{};
-                    }
-                },
-                .id_filtered, .generic => {
-                    // Use cached parsed selector
-                    const Matcher = @import("selector/matcher.zig").Matcher;
-                    const matcher = Matcher.init(allocator);
-
-                    var results = std.ArrayList(*Element){};
-                    defer results.deinit(allocator);
-
-                    try self.querySelectorAllHelper(allocator, &matcher, &parsed.selector_list, &results);
-                    return try results.toOwnedSlice(allocator);
-                },
-            }
+        // Use the document's cached parse when there is one
+        if (try self.cachedSelector(selectors)) |parsed| {
+            defer parsed.release();
+            return try self.querySelectorAllParsed(allocator, parsed);
         }
 
         // Fallback: parse selector without caching
@@ -3169,7 +3022,240 @@ pub const Element = struct {
         return try results.toOwnedSlice(allocator);
     }
 
-    /// Helper for querySelectorAll - recursively collects matching elements
+    /// Returns the owner document's cached parse of `selectors`, or null for
+    /// elements without an owner document.
+    ///
+    /// The caller releases the result (see `SelectorCache.acquire`).
+    pub fn cachedSelector(self: *Element, selectors: []const u8) !?*@import("document.zig").ParsedSelector {
+        const doc = self.ownerDocumentNode() orelse return null;
+        return try doc.selector_cache.acquire(selectors);
+    }
+
+    /// Returns the owner Document, or null if there is none.
+    fn ownerDocumentNode(self: *const Element) ?*@import("document.zig").Document {
+        const owner = self.prototype.owner_document orelse return null;
+        if (owner.node_type != .document) return null;
+        return @fieldParentPtr("prototype", owner);
+    }
+
+    /// Returns the descendants of self from the owner document's compact
+    /// layout, or null when it is not enabled or self is not in the
+    /// document tree (see compact_layout.zig).
+    fn compactDescendants(self: *const Element) !?@import("compact_layout.zig").CompactLayout.Range {
+        const doc = self.ownerDocumentNode() orelse return null;
+        const layout = doc.compact_layout orelse return null;
+        return layout.descendants(doc, self);
+    }
+
+    /// Returns the descendants of self named `tag_name` from the owner
+    /// document's tag index, in tree order, or null when self is not in
+    /// the document tree or the tag has no bucket (see tag_index.zig).
+    fn tagDescendants(self: *const Element, tag_name: []const u8) ?[]const *Element {
+        const doc = self.ownerDocumentNode() orelse return null;
+        // Shadow trees are connected but not indexed
+        if (self.prototype.getRootNode(false) != &doc.prototype) return null;
+        const bucket = doc.tagBucket(tag_name) orelse return null;
+        return @import("tag_index.zig").TagIndex.descendants(bucket, &self.prototype);
+    }
+
+    /// Counts a query in the owner document's fast path statistics.
+    fn recordFastPath(self: *const Element, kind: @import("fast_path.zig").FastPathType) void {
+        if (self.ownerDocumentNode()) |doc| {
+            doc.selector_cache.recordFastPath(kind);
+        }
+    }
+
+    /// Resolves a compound or combinator fast path against the owner
+    /// document's string pool.
+    fn fastPathMatcher(
+        self: *const Element,
+        parsed: *const @import("document.zig").ParsedSelector,
+    ) ?@import("fast_path.zig").FastPathMatcher {
+        const doc = self.ownerDocumentNode() orelse return null;
+        const FastPathMatcher = @import("fast_path.zig").FastPathMatcher;
+        return FastPathMatcher.init(&parsed.fast, &doc.string_pool);
+    }
+
+    /// querySelector() with an already parsed selector.
+    ///
+    /// Uses the selector's fast path when it has one.
+    pub fn querySelectorParsed(
+        self: *Element,
+        allocator: Allocator,
+        parsed: *const @import("document.zig").ParsedSelector,
+    ) !?*Element {
+        self.recordFastPath(parsed.fast_path);
+        switch (parsed.fast_path) {
+            .simple_id => {
+                if (parsed.identifier) |id| {
+                    return self.queryById(id);
+                }
+            },
+            .simple_class => {
+                if (parsed.identifier) |class_name| {
+                    return self.queryByClass(class_name);
+                }
+            },
+            .simple_tag => {
+                if (parsed.identifier) |tag_name| {
+                    return self.queryByTagName(tag_name);
+                }
+            },
+            .attribute_equals, .tag_class, .child_tag => {
+                if (self.fastPathMatcher(parsed)) |fast| {
+                    return self.queryByFastPath(&fast);
+                }
+            },
+            .id_filtered, .generic => {},
+        }
+
+        const Matcher = @import("selector/matcher.zig").Matcher;
+        const matcher = Matcher.init(allocator);
+        return try self.firstMatchingDescendant(&matcher, &parsed.selector_list);
+    }
+
+    /// querySelectorAll() with an already parsed selector.
+    ///
+    /// Uses the selector's fast path when it has one.
+    pub fn querySelectorAllParsed(
+        self: *Element,
+        allocator: Allocator,
+        parsed: *const @import("document.zig").ParsedSelector,
+    ) ![]const *Element {
+        self.recordFastPath(parsed.fast_path);
+        switch (parsed.fast_path) {
+            .simple_class => {
+                if (parsed.identifier) |class_name| {
+                    return try self.queryAllByClass(allocator, class_name);
+                }
+            },
+            .simple_tag => {
+                if (parsed.identifier) |tag_name| {
+                    return try self.queryAllByTagName(allocator, tag_name);
+                }
+            },
+            .simple_id => {
+                // ID queries return at most one result
+                if (parsed.identifier) |id| {
+                    if (self.queryById(id)) |elem| {
+                        const result = try allocator.alloc(*Element, 1);
+                        result[0] = elem;
+                        return result;
+                    }
+                    return &[_]*Element{};
+                }
+            },
+            .attribute_equals, .tag_class, .child_tag => {
+                if (self.fastPathMatcher(parsed)) |fast| {
+                    return try self.queryAllByFastPath(allocator, &fast);
+                }
+            },
+            .id_filtered, .generic => {},
+        }
+
+        const Matcher = @import("selector/matcher.zig").Matcher;
+        const matcher = Matcher.init(allocator);
+
+        var results = std.ArrayList(*Element){};
+        defer results.deinit(allocator);
+
+        try self.querySelectorAllHelper(allocator, &matcher, &parsed.selector_list, &results);
+        return try results.toOwnedSlice(allocator);
+    }
+
+    fn firstMatchingDescendant(
+        self: *Element,
+        matcher: *const @import("selector/matcher.zig").Matcher,
+        selector_list: *const @import("selector/parser.zig").SelectorList,
+    ) !?*Element {
+        if (try self.compactDescendants()) |range| {
+            for (range.elements()) |elem| {
+                if (try matcher.matches(elem, selector_list)) return elem;
+            }
+            return null;
+        }
+
+        // Traverse descendants in tree order
+        var current = self.prototype.first_child;
+        while (current) |node| {
+            if (node.node_type == .element) {
+                const elem: *Element = @fieldParentPtr("prototype", node);
+
+                if (try matcher.matches(elem, selector_list)) {
+                    return elem;
+                }
+
+                if (try elem.firstMatchingDescendant(matcher, selector_list)) |found| {
+                    return found;
+                }
+            }
+            current = node.next_sibling;
+        }
+        return null;
+    }
+
+    /// matches() with an already parsed selector.
+    ///
+    /// Answered from the owner document's match cache when it has one
+    /// (see Document.enableMatchCache).
+    pub fn matchesParsed(
+        self: *Element,
+        allocator: Allocator,
+        parsed: *const @import("document.zig").ParsedSelector,
+    ) !bool {
+        if (self.ownerDocumentNode()) |doc| {
+            if (doc.match_cache) |cache| {
+                if (!doc.frozen) return try cache.matches(allocator, self, parsed, doc.mutation_version);
+            }
+        }
+
+        const Matcher = @import("selector/matcher.zig").Matcher;
+        const matcher = Matcher.init(allocator);
+        return try matcher.matches(self, &parsed.selector_list);
+    }
+
+    /// closest() with an already parsed selector.
+    pub fn closestParsed(
+        self: *Element,
+        allocator: Allocator,
+        parsed: *const @import("document.zig").ParsedSelector,
+    ) !?*Element {
+        const Matcher = @import("selector/matcher.zig").Matcher;
+        const matcher = Matcher.init(allocator);
+        return try self.closestWithMatcher(&matcher, &parsed.selector_list);
+    }
+
+    fn closestWithMatcher(
+        self: *Element,
+        matcher: *const @import("selector/matcher.zig").Matcher,
+        selector_list: *const @import("selector/parser.zig").SelectorList,
+    ) !?*Element {
+        // Test self first
+        if (try matcher.matches(self, selector_list)) {
+            return self;
+        }
+
+        // Traverse ancestors
+        var current = self.prototype.parent_node;
+        while (current) |parent_node| {
+            if (parent_node.node_type == .element) {
+                const parent_elem: *Element = @fieldParentPtr("prototype", parent_node);
+                if (try matcher.matches(parent_elem, selector_list)) {
+                    return parent_elem;
+                }
+            }
+            current = parent_node.parent_node;
+        }
+
+        return null;
+    }
+
+    /// Helper for querySelectorAll - collects matching descendants in tree order
+    ///
+    /// When every selector in the list needs some ancestor tag, id or class
+    /// (e.g. `.a .b leaf`), an ancestor Bloom filter is kept along the walk
+    /// and candidates whose ancestors cannot match are skipped without
+    /// running the matcher (see selector/ancestor_filter.zig).
     pub fn querySelectorAllHelper(
         self: *Element,
         allocator: Allocator,
@@ -3177,7 +3263,54 @@ pub const Element = struct {
         selector_list: *const @import("selector/parser.zig").SelectorList,
         results: *std.ArrayList(*Element),
     ) !void {
+        const filter_mod = @import("selector/ancestor_filter.zig");
+
+        // The filter can only reject when every alternative has requirements
+        var required: [max_filtered_selectors]filter_mod.AncestorHashes = undefined;
+        const use_filter = blk: {
+            if (selector_list.selectors.len > max_filtered_selectors) break :blk false;
+            for (selector_list.selectors, 0..) |*complex, i| {
+                required[i] = filter_mod.AncestorHashes.fromComplex(complex);
+                if (required[i].len == 0) break :blk false;
+            }
+            break :blk true;
+        };
+
+        if (!use_filter) {
+            if (try self.compactDescendants()) |range| {
+                for (range.elements()) |elem| {
+                    if (try matcher.matches(elem, selector_list)) try results.append(allocator, elem);
+                }
+                return;
+            }
+            return self.collectMatchingDescendants(allocator, matcher, selector_list, results);
+        }
+
+        const filter = try allocator.create(filter_mod.AncestorFilter);
+        defer allocator.destroy(filter);
+        filter.* = .{};
+        filter.pushAncestorsOf(self);
+
+        try self.collectFilteredDescendants(
+            allocator,
+            matcher,
+            selector_list,
+            filter,
+            required[0..selector_list.selectors.len],
+            results,
+        );
+    }
 
+    /// Selector lists longer than this are matched without the ancestor filter
+    const max_filtered_selectors = 8;
+
+    fn collectMatchingDescendants(
+        self: *Element,
+        allocator: Allocator,
+        matcher: *const @import("selector/matcher.zig").Matcher,
+        selector_list: *const @import("selector/parser.zig").SelectorList,
+        results: *std.ArrayList(*Element),
+    ) !void {
         // Traverse children in tree order
         var current = self.prototype.first_child;
         while (current) |node| {
@@ -3190,7 +3323,40 @@ pub const Element = struct {
                 }
 
                 // Recursively search descendants
-                try elem.querySelectorAllHelper(allocator, matcher, selector_list, results);
+                try elem.collectMatchingDescendants(allocator, matcher, selector_list, results);
+            }
+            current = node.next_sibling;
+        }
+    }
+
+    fn collectFilteredDescendants(
+        self: *Element,
+        allocator: Allocator,
+        matcher: *const @import("selector/matcher.zig").Matcher,
+        selector_list: *const @import("selector/parser.zig").SelectorList,
+        filter: *@import("selector/ancestor_filter.zig").AncestorFilter,
+        required: []const @import("selector/ancestor_filter.zig").AncestorHashes,
+        results: *std.ArrayList(*Element),
+    ) !void {
+        // `filter` holds self and its ancestors: the ancestors of each child
+        var current = self.prototype.first_child;
+        while (current) |node| {
+            if (node.node_type == .element) {
+                const elem: *Element = @fieldParentPtr("prototype", node);
+
+                const may_match = for (required) |*hashes| {
+                    if (filter.mayMatch(hashes)) break true;
+                } else false;
+
+                if (may_match and try matcher.matches(elem, selector_list)) {
+                    try results.append(allocator, elem);
+                }
+
+                if (elem.prototype.first_child != null) {
+                    filter.push(elem);
+                    defer filter.pop(elem);
+                    try elem.collectFilteredDescendants(allocator, matcher, selector_list, filter, required, results);
+                }
             }
             current = node.next_sibling;
         }
@@ -3418,27 +3584,45 @@ pub const Element = struct {
     /// // found == button
     /// ```
     pub fn queryById(self: *Element, id: []const u8) ?*Element {
+        // In a shadow tree: the shadow root's own id index
+        if (@import("shadow_index.zig").containingShadowRoot(&self.prototype)) |shadow| {
+            if (shadow.ensureIndex()) |index| {
+                var candidates = index.ids.iterator(id);
+                while (candidates.next()) |elem| {
+                    if (elem != self and self.prototype.contains(&elem.prototype)) return elem;
+                }
+                return null;
+            }
+        }
+
         // Fast path: Use document ID map if available (O(1) lookup!)
         if (self.prototype.owner_document) |owner| {
             if (owner.node_type == .document) {
                 const Document = @import("document.zig").Document;
                 const doc: *Document = @fieldParentPtr("prototype", owner);
 
-                // Check if element with this ID exists
-                if (doc.id_map.get(id)) |elem| {
-                    // Fast case: if self is the document element, all elements are descendants
-                    if (self == doc.documentElement()) {
-                        return elem;
-                    }
+                // The index holds every element with this ID in the document
+                // tree, in tree order, so no scan is needed when self is
+                // in that tree (shadow trees are not indexed)
+                if (self.prototype.getRootNode(false) == &doc.prototype) {
+                    var candidates = doc.id_map.iterator(id);
+                    while (candidates.next()) |elem| {
+                        // Fast case: if self is the document element, all elements are descendants
+                        if (self == doc.documentElement()) {
+                            if (elem != self) return elem;
+                            continue;
+                        }
 
-                    // Otherwise verify the element is actually a descendant of self
-                    var current = elem.prototype.parent_node;
-                    while (current) |parent| {
-                        if (parent == &self.prototype) {
-                            return elem;
+                        // Otherwise verify the element is actually a descendant of self
+                        var current = elem.prototype.parent_node;
+                        while (current) |parent| {
+                            if (parent == &self.prototype) {
+                                return elem;
+                            }
+                            current = parent.parent_node;
                         }
-                        current = parent.parent_node;
                     }
+                    return null;
                 }
             }
         }
@@ -3485,6 +3669,15 @@ pub const Element = struct {
     /// // found == button
     /// ```
     pub fn queryByClass(self: *Element, class_name: []const u8) ?*Element {
+        // Compact layout: scan the filters without touching other elements
+        if (self.compactDescendants() catch null) |range| {
+            const probe = @import("compact_layout.zig").classProbe(class_name);
+            for (range.classBlooms(), range.elements()) |bloom, elem| {
+                if (bloom.bits & probe != 0 and elem.hasClass(class_name)) return elem;
+            }
+            return null;
+        }
+
         // Phase 3: Tree traversal with bloom filter (class_map removed)
         // Bloom filter provides O(1) fast rejection for non-matching elements
         const ElementIterator = @import("element_iterator.zig").ElementIterator;
@@ -3529,35 +3722,9 @@ pub const Element = struct {
     /// // found == button
     /// ```
     pub fn queryByTagName(self: *Element, tag_name: []const u8) ?*Element {
-        // Fast path: Use document tag map if available
-        if (self.prototype.owner_document) |owner| {
-            if (owner.node_type == .document) {
-                const Document = @import("document.zig").Document;
-                const doc: *Document = @fieldParentPtr("prototype", owner);
-
-                // Check if any elements with this tag exist
-                if (doc.tag_map.get(tag_name)) |list| {
-                    // Find first element that is a descendant of self
-                    for (list.items) |elem| {
-                        // Skip self (we only want descendants)
-                        if (elem == self) continue;
-
-                        // Fast case: if self is the document element, all other elements are descendants
-                        if (self == doc.documentElement()) {
-                            return elem;
-                        }
-
-                        // Verify element is descendant of self
-                        var current = elem.prototype.parent_node;
-                        while (current) |parent| {
-                            if (parent == &self.prototype) {
-                                return elem;
-                            }
-                            current = parent.parent_node;
-                        }
-                    }
-                }
-            }
+        // Fast path: the document's tag index, when self is connected
+        if (self.tagDescendants(tag_name)) |matches| {
+            return if (matches.len > 0) matches[0] else null;
         }
 
         // Fallback: O(n) scan if no document or no elements in our subtree
@@ -3588,11 +3755,21 @@ pub const Element = struct {
     /// ## Errors
     /// - `error.OutOfMemory`: Failed to allocate result array
     pub fn queryAllByClass(self: *Element, allocator: Allocator, class_name: []const u8) ![]const *Element {
+        var results = std.ArrayList(*Element){};
+        defer results.deinit(allocator);
+
+        // Compact layout: scan the filters without touching other elements
+        if (try self.compactDescendants()) |range| {
+            const probe = @import("compact_layout.zig").classProbe(class_name);
+            for (range.classBlooms(), range.elements()) |bloom, elem| {
+                if (bloom.bits & probe != 0 and elem.hasClass(class_name)) try results.append(allocator, elem);
+            }
+            return try results.toOwnedSlice(allocator);
+        }
+
         // Phase 3: Tree traversal with bloom filter (class_map removed)
         // Bloom filter provides O(1) fast rejection for non-matching elements
         const ElementIterator = @import("element_iterator.zig").ElementIterator;
-        var results = std.ArrayList(*Element){};
-        defer results.deinit(allocator);
 
         var iter = ElementIterator.init(&self.prototype);
         while (iter.next()) |elem| {
@@ -3622,54 +3799,93 @@ pub const Element = struct {
     /// ## Errors
     /// - `error.OutOfMemory`: Failed to allocate result array
     pub fn queryAllByTagName(self: *Element, allocator: Allocator, tag_name: []const u8) ![]const *Element {
-        // Fast path: Use document tag map if available
-        if (self.prototype.owner_document) |owner| {
-            if (owner.node_type == .document) {
-                const Document = @import("document.zig").Document;
-                const doc: *Document = @fieldParentPtr("prototype", owner);
+        // Compact layout: compare interned tag pointers in one range
+        if (try self.compactDescendants()) |range| {
+            const doc = self.ownerDocumentNode().?;
+            const tag = doc.string_pool.lookup(tag_name) orelse return &[_]*Element{};
+
+            var results = std.ArrayList(*Element){};
+            defer results.deinit(allocator);
+            for (range.tags(), range.elements()) |candidate, elem| {
+                if (candidate == tag.ptr) try results.append(allocator, elem);
+            }
+            return try results.toOwnedSlice(allocator);
+        }
 
-                // Check if any elements with this tag exist
-                if (doc.tag_map.get(tag_name)) |list| {
-                    var results = std.ArrayList(*Element){};
-                    defer results.deinit(allocator);
+        // Fast path: the document's tag index, when self is connected
+        if (self.tagDescendants(tag_name)) |matches| {
+            return try allocator.dupe(*Element, matches);
+        }
 
-                    for (list.items) |elem| {
-                        // Skip self (we only want descendants)
-                        if (elem == self) continue;
+        // Fallback: O(n) scan
+        const ElementIterator = @import("element_iterator.zig").ElementIterator;
+        var results = std.ArrayList(*Element){};
+        defer results.deinit(allocator);
 
-                        // Fast case: if self is the document element, all other elements are descendants
-                        if (self == doc.documentElement()) {
-                            try results.append(allocator, elem);
-                            continue;
-                        }
+        var iter = ElementIterator.init(&self.prototype);
+        while (iter.next()) |elem| {
+            if (std.mem.eql(u8, elem.tag_name, tag_name)) {
+                try results.append(allocator, elem);
+            }
+        }
 
-                        // Verify element is descendant of self
-                        var current = elem.prototype.parent_node;
-                        while (current) |parent| {
-                            if (parent == &self.prototype) {
-                                try results.append(allocator, elem);
-                                break;
-                            }
-                            current = parent.parent_node;
-                        }
-                    }
+        return try results.toOwnedSlice(allocator);
+    }
 
-                    return try results.toOwnedSlice(allocator);
-                }
+    /// Fast path: Query by a compound or combinator fast path
+    ///
+    /// Returns the first descendant matching `fast` (see fast_path.zig),
+    /// or null. Tag tests are pointer comparisons on interned names.
+    pub fn queryByFastPath(self: *Element, fast: *const @import("fast_path.zig").FastPathMatcher) ?*Element {
+        if (!fast.possible) return null;
 
-                // No elements with this tag
-                return &[_]*Element{};
+        if (self.compactDescendants() catch null) |range| {
+            for (range.elements()) |elem| {
+                if (fast.matches(elem)) return elem;
             }
+            return null;
         }
 
-        // Fallback: O(n) scan
         const ElementIterator = @import("element_iterator.zig").ElementIterator;
+        var iter = ElementIterator.init(&self.prototype);
+        while (iter.next()) |elem| {
+            if (fast.matches(elem)) {
+                return elem;
+            }
+        }
+
+        return null;
+    }
+
+    /// Fast path: Query all by a compound or combinator fast path
+    ///
+    /// ## Returns
+    /// Array of matching elements in tree order (caller owns, must free)
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to allocate result array
+    pub fn queryAllByFastPath(
+        self: *Element,
+        allocator: Allocator,
+        fast: *const @import("fast_path.zig").FastPathMatcher,
+    ) ![]const *Element {
+        if (!fast.possible) return &[_]*Element{};
+
         var results = std.ArrayList(*Element){};
         defer results.deinit(allocator);
 
+        if (try self.compactDescendants()) |range| {
+            for (range.elements()) |elem| {
+                if (fast.matches(elem)) try results.append(allocator, elem);
+            }
+            return try results.toOwnedSlice(allocator);
+        }
+
+        const ElementIterator = @import("element_iterator.zig").ElementIterator;
+
         var iter = ElementIterator.init(&self.prototype);
         while (iter.next()) |elem| {
-            if (std.mem.eql(u8, elem.tag_name, tag_name)) {
+            if (fast.matches(elem)) {
                 try results.append(allocator, elem);
             }
         }
@@ -3728,6 +3944,12 @@ pub const Element = struct {
     /// - Conditional logic: Apply different behavior based on selector match
     /// - Feature detection: Test element characteristics
     pub fn matches(self: *Element, allocator: Allocator, selectors: []const u8) !bool {
+        // Use the document's cached parse when there is one
+        if (try self.cachedSelector(selectors)) |parsed| {
+            defer parsed.release();
+            return try self.matchesParsed(allocator, parsed);
+        }
+
         const Tokenizer = @import("selector/tokenizer.zig").Tokenizer;
         const Parser = @import("selector/parser.zig").Parser;
         const Matcher = @import("selector/matcher.zig").Matcher;
@@ -3802,6 +4024,12 @@ pub const Element = struct {
     /// - Component boundaries: Find containing component element
     /// - Form handling: Find form from any input element
     pub fn closest(self: *Element, allocator: Allocator, selectors: []const u8) !?*Element {
+        // Use the document's cached parse when there is one
+        if (try self.cachedSelector(selectors)) |parsed| {
+            defer parsed.release();
+            return try self.closestParsed(allocator, parsed);
+        }
+
         const Tokenizer = @import("selector/tokenizer.zig").Tokenizer;
         const Parser = @import("selector/parser.zig").Parser;
         const Matcher = @import("selector/matcher.zig").Matcher;
@@ -3816,25 +4044,7 @@ pub const Element = struct {
 
         // Create matcher
         const matcher = Matcher.init(allocator);
-
-        // Test self first
-        if (try matcher.matches(self, &selector_list)) {
-            return self;
-        }
-
-        // Traverse ancestors
-        var current = self.prototype.parent_node;
-        while (current) |parent_node| {
-            if (parent_node.node_type == .element) {
-                const parent_elem: *Element = @fieldParentPtr("prototype", parent_node);
-                if (try matcher.matches(parent_elem, &selector_list)) {
-                    return parent_elem;
-                }
-            }
-            current = parent_node.parent_node;
-        }
-
-        return null;
+        return try self.closestWithMatcher(&matcher, &selector_list);
     }
 
     /// Legacy alias for matches().
@@ -4685,6 +4895,36 @@ pub const Element = struct {
 
     // === Private implementation ===
 
+    /// Adds this element under the tokens of `class_value` in the owner
+    /// document's class index (if enabled and the element is in the
+    /// document tree), or in its shadow root's index.
+    fn indexClasses(self: *Element, class_value: []const u8) !void {
+        if (self.prototype.isInShadowTree()) {
+            return @import("shadow_index.zig").classChanged(self, null, class_value);
+        }
+        if (!self.prototype.isConnected()) return;
+        const doc = self.ownerDocumentNode() orelse return;
+        const index = doc.class_index orelse return;
+        // Batches rebuild the index once at the end instead
+        if (doc.batch_depth > 0) return index.invalidate();
+        if (self.prototype.getRootNode(false) != &doc.prototype) return;
+        try index.addTokens(&doc.string_pool, class_value, self);
+    }
+
+    /// Removes this element's current class tokens from the owner
+    /// document's class index, or from its shadow root's index.
+    fn unindexClasses(self: *Element) void {
+        if (self.prototype.isInShadowTree()) {
+            return @import("shadow_index.zig").classChanged(self, self.getAttribute("class"), null);
+        }
+        if (!self.prototype.isConnected()) return;
+        const doc = self.ownerDocumentNode() orelse return;
+        const index = doc.class_index orelse return;
+        if (doc.batch_depth > 0) return index.invalidate();
+        const class_value = self.getAttribute("class") orelse return;
+        index.removeTokens(class_value, self);
+    }
+
     /// Updates the bloom filter from a class attribute value.
     fn updateClassBloom(self: *Element, class_value: []const u8) void {
         self.class_bloom.clear();
@@ -4834,6 +5074,120 @@ pub const Element = struct {
         }
     }
 
+    /// Position argument of insertAdjacentMarkup().
+    const AdjacentPosition = enum { beforebegin, afterbegin, beforeend, afterend };
+
+    /// Parses markup and inserts the nodes at a position relative to this
+    /// element.
+    ///
+    /// The DOM counterpart of HTML's insertAdjacentHTML(), with the generic
+    /// syntax of src/markup_parser.zig instead of the HTML parser. The
+    /// markup is built into a fragment with a TreeBuilder and inserted in
+    /// one step, so observers get one childList record and live ranges one
+    /// update however many nodes it holds.
+    ///
+    /// ## Parameters
+    /// - `where`: Position string ("beforebegin", "afterbegin", "beforeend", "afterend")
+    /// - `markup`: UTF-8 markup to insert
+    ///
+    /// ## Errors
+    /// - `error.SyntaxError`: Invalid position string
+    /// - `error.NoModificationAllowedError`: "beforebegin" or "afterend"
+    ///   and this element has no parent, or its parent is a Document
+    /// - `error.InvalidStateError`: Element not owned by a document
+    /// - `error.OutOfMemory`: Failed to allocate
+    /// - Any error of the insertion
+    ///
+    /// ## Example
+    /// ```zig
+    /// try list.insertAdjacentMarkup("beforeend", "<item>one</item><item>two</item>");
+    /// ```
+    pub fn insertAdjacentMarkup(self: *Element, where: []const u8, markup: []const u8) !void {
+        const position = std.meta.stringToEnum(AdjacentPosition, where) orelse return error.SyntaxError;
+        const node = &self.prototype;
+        if (position == .beforebegin or position == .afterend) _ = try self.adjacentParent();
+
+        const doc = try self.ownerDocumentForMarkup();
+        const stack = doc.getCEReactionsStack();
+        try stack.enter();
+        defer stack.leave();
+
+        const fragment = try @import("markup_parser.zig").parseFragment(doc, markup);
+        defer fragment.prototype.release();
+
+        // Positions are resolved after parsing, which may run upgrades
+        switch (position) {
+            .beforebegin => _ = try (try self.adjacentParent()).insertBefore(&fragment.prototype, node),
+            .afterbegin => _ = try node.insertBefore(&fragment.prototype, node.first_child),
+            .beforeend => _ = try node.appendChild(&fragment.prototype),
+            .afterend => _ = try (try self.adjacentParent()).insertBefore(&fragment.prototype, node.next_sibling),
+        }
+    }
+
+    /// Parses markup and replaces this element's children with the nodes.
+    ///
+    /// The DOM counterpart of the innerHTML setter, for an HTML layer to
+    /// build on (see src/markup_parser.zig for the syntax). The markup is
+    /// parsed before anything is removed, so running out of memory while
+    /// parsing leaves the children as they were. The old children then leave as one run and
+    /// the new ones arrive as one insertion.
+    ///
+    /// ## Parameters
+    /// - `markup`: UTF-8 markup of the new children (empty removes them)
+    ///
+    /// ## Errors
+    /// - `error.NoModificationAllowedError`: Element is read-only
+    /// - `error.InvalidStateError`: Element not owned by a document
+    /// - `error.OutOfMemory`: Failed to allocate
+    ///
+    /// ## Example
+    /// ```zig
+    /// try list.setInnerMarkup("<item>one</item><item>two</item>");
+    /// ```
+    pub fn setInnerMarkup(self: *Element, markup: []const u8) !void {
+        const node = &self.prototype;
+        try node.checkMutable();
+
+        const doc = try self.ownerDocumentForMarkup();
+        const stack = doc.getCEReactionsStack();
+        try stack.enter();
+        defer stack.leave();
+
+        const fragment = try @import("markup_parser.zig").parseFragment(doc, markup);
+        defer fragment.prototype.release();
+
+        var count: usize = 0;
+        var child = node.first_child;
+        while (child) |c| : (child = c.next_sibling) count += 1;
+
+        var fallback = std.heap.stackFallback(64 * @sizeOf(*Node), node.allocator);
+        const allocator = fallback.get();
+        const old_children = try allocator.alloc(*Node, count);
+        defer allocator.free(old_children);
+
+        child = node.first_child;
+        for (old_children) |*slot| {
+            slot.* = child.?;
+            child = child.?.next_sibling;
+        }
+
+        try node_mod.moveChildRun(node, old_children, null);
+        _ = try node.appendChild(&fragment.prototype);
+    }
+
+    /// Parent for the "beforebegin" and "afterend" positions.
+    fn adjacentParent(self: *Element) !*Node {
+        const parent = self.prototype.parent_node orelse return error.NoModificationAllowedError;
+        if (parent.node_type == .document) return error.NoModificationAllowedError;
+        return parent;
+    }
+
+    fn ownerDocumentForMarkup(self: *Element) !*@import("document.zig").Document {
+        const owner_doc = self.prototype.owner_document orelse return error.InvalidStateError;
+        if (owner_doc.node_type != .document) return error.InvalidStateError;
+        return @fieldParentPtr("prototype", owner_doc);
+    }
+
     // ========================================================================
     // Vtable Implementations
     // ========================================================================
@@ -4849,20 +5203,12 @@ pub const Element = struct {
                 const Document = @import("document.zig").Document;
                 const doc: *Document = @fieldParentPtr("prototype", owner_doc);
 
-                // Remove from tag map
-                if (doc.tag_map.getPtr(elem.tag_name)) |list_ptr| {
-                    // Find and remove this element from the list
-                    for (list_ptr.items, 0..) |item, i| {
-                        if (item == elem) {
-                            _ = list_ptr.swapRemove(i);
-                            break;
-                        }
-                    }
-                }
+                // NOTE: No tag index cleanup - an element being freed has no
+                // parent, so it was removed from the index when disconnected
 
                 // NOTE: Phase 3 - class_map removed, no cleanup needed
 
-                doc.releaseNodeRef();
+                doc.releaseNodeRef(node);
             }
         }
 
@@ -5001,55 +5347,39 @@ pub const Element = struct {
                 const Document = @import("document.zig").Document;
                 const old_doc_ptr: *Document = @fieldParentPtr("prototype", old_doc);
 
-                // Remove from old tag map
-                if (old_doc_ptr.tag_map.getPtr(elem.tag_name)) |list_ptr| {
-                    for (list_ptr.items, 0..) |item, i| {
-                        if (item == elem) {
-                            _ = list_ptr.swapRemove(i);
-                            break;
-                        }
-                    }
-                }
+                // Remove from old tag index (normally already done on removal)
+                old_doc_ptr.tag_index.remove(elem);
 
                 // NOTE: Phase 3 - class_map removed, no cleanup needed
 
-                // Remove from old id map
+                // Remove from old id index (normally already done on removal)
                 if (elem.getAttribute("id")) |id| {
-                    _ = old_doc_ptr.id_map.remove(id);
+                    old_doc_ptr.id_map.remove(id, elem);
                     old_doc_ptr.invalidateIdCache();
                 }
             }
         }
 
-        // Add to new document's maps if it has one
-        if (node.owner_document) |new_doc| {
-            if (new_doc.node_type == .document) {
-                const Document = @import("document.zig").Document;
-                const new_doc_ptr: *Document = @fieldParentPtr("prototype", new_doc);
-
-                // Re-intern tag name in new document's string pool
-                const new_tag_name = try new_doc_ptr.string_pool.intern(elem.tag_name);
-                elem.tag_name = new_tag_name;
-
-                // Add to new tag map
-                const gop = try new_doc_ptr.tag_map.getOrPut(elem.tag_name);
-                if (!gop.found_existing) {
-                    gop.value_ptr.* = std.ArrayList(*Element){};
-                }
-                try gop.value_ptr.append(new_doc_ptr.prototype.allocator, elem);
-
-                // NOTE: Phase 3 - class_map removed, no need to add classes
+        // The names and values are moved to the new document's string pool
+        // by adopt() (see remapStrings); the new id and tag indices pick
+        // the element up when it is connected
+    }
 
-                // Add to new id map (only if ID not already in use - first wins)
-                if (elem.getAttribute("id")) |id| {
-                    const result = try new_doc_ptr.id_map.getOrPut(id);
-                    if (!result.found_existing) {
-                        result.value_ptr.* = elem;
-                        new_doc_ptr.invalidateIdCache();
-                    }
-                }
-            }
+    /// Replaces the interned tag name, namespace, prefix, local name and
+    /// attribute strings with their copies from `remap`, a StringRemap into the
+    /// string pool of the document the element is adopted into.
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to remap a string
+    pub fn remapStrings(self: *Element, remap: *@import("document.zig").StringRemap) Allocator.Error!void {
+        // A prefixed tag name is the element's own allocation (see deinitImpl)
+        if (self.prefix == null or self.tag_name.ptr == self.local_name.ptr) {
+            self.tag_name = try remap.string(self.tag_name);
         }
+        self.local_name = try remap.string(self.local_name);
+        self.namespace_uri = try remap.optional(self.namespace_uri);
+        self.prefix = try remap.optional(self.prefix);
+        try self.attributes.array.remapStrings(remap);
     }
 
     // ========================================================================
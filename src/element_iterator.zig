@@ -35,25 +35,7 @@ pub const ElementIterator = struct {
     /// Get next element in depth-first traversal order
     pub fn next(self: *ElementIterator) ?*Element {
         while (self.current) |node| {
-            // Find next node (depth-first)
-            const next_node = blk: {
-                // Try child first
-                if (node.first_child) |child| break :blk child;
-
-                // Try sibling
-                if (node.next_sibling) |sibling| break :blk sibling;
-
-                // Walk up tree to find next sibling
-                var parent = node.parent_node;
-                while (parent) |p| {
-                    if (p == self.root) break :blk null; // Hit root
-                    if (p.next_sibling) |sibling| break :blk sibling;
-                    parent = p.parent_node;
-                }
-                break :blk null;
-            };
-
-            self.current = next_node;
+            self.current = self.following(node);
 
             // Return only elements (skip text, comment, etc.)
             if (node.node_type == .element) {
@@ -64,6 +46,36 @@ pub const ElementIterator = struct {
         return null;
     }
 
+    /// Continue from the node following `node` in tree order, at its current
+    /// position (`root` restarts). Ends iteration if `node` is not under root.
+    pub fn seekAfter(self: *ElementIterator, node: *Node) void {
+        if (node == self.root) {
+            self.current = self.root.first_child;
+        } else if (self.root.contains(node)) {
+            self.current = self.following(node);
+        } else {
+            self.current = null;
+        }
+    }
+
+    /// Next node in depth-first order within root, or null at the end
+    fn following(self: *const ElementIterator, node: *Node) ?*Node {
+        // Try child first
+        if (node.first_child) |child| return child;
+
+        // Try sibling
+        if (node.next_sibling) |sibling| return sibling;
+
+        // Walk up tree to find next sibling
+        var parent = node.parent_node;
+        while (parent) |p| {
+            if (p == self.root) return null; // Hit root
+            if (p.next_sibling) |sibling| return sibling;
+            parent = p.parent_node;
+        }
+        return null;
+    }
+
     /// Reset iterator to beginning
     pub fn reset(self: *ElementIterator) void {
         self.current = self.root.first_child;
@@ -352,6 +352,11 @@ pub const Event = struct {
     /// This is populated during dispatch and exposed via composedPath()
     event_path: ?std.ArrayList(*anyopaque) = null,
 
+    /// Dispatch counter - incremented when each dispatch of this event starts
+    /// Lets bindings tell dispatches apart, e.g. to cache composedPath()
+    /// for exactly one dispatch
+    dispatch_id: u32 = 0,
+
     /// Event phase constants (WHATWG DOM §2.2)
     pub const EventPhase = enum(u16) {
         none = 0,
@@ -0,0 +1,202 @@
+//! Event Pool - Recycled, reference-counted event records
+//!
+//! Bindings hand out heap events (`new Event()`, `new CustomEvent()`,
+//! embedder-synthesized input events) at a high rate, and almost all of them
+//! die right after their dispatch. An `EventPool` keeps released records on
+//! a free list and hands them out again, so a steady stream of synthetic
+//! events allocates nothing once the pool is warm.
+//!
+//! ## Records
+//!
+//! One record type backs both Event and CustomEvent: the record starts with
+//! a `CustomEvent`, whose first field is the `Event`, so a record pointer is
+//! also a valid `*Event` and `*CustomEvent`. The event type is copied into
+//! the record (inline for short types, otherwise into a heap buffer the
+//! record keeps across reuse), so callers may pass temporary strings.
+//!
+//! ## Opt-In
+//!
+//! A pool with capacity 0 (the default) keeps nothing: every acquire
+//! allocates and every release frees, exactly like unpooled events. Raise
+//! the capacity with `setCapacity()`; records beyond it are freed.
+//!
+//! ## Usage
+//!
+//! ```zig
+//! var pool = EventPool.init(allocator, 64);
+//! defer pool.deinit();
+//!
+//! const record = try pool.acquire("pointermove", .{ .event_options = .{ .bubbles = true } });
+//! _ = try target.prototype.dispatchEvent(record.event());
+//! pool.release(record); // back on the free list
+//! ```
+
+const std = @import("std");
+const Allocator = std.mem.Allocator;
+const Event = @import("event.zig").Event;
+const CustomEvent = @import("custom_event.zig").CustomEvent;
+const CustomEventInit = @import("custom_event.zig").CustomEventInit;
+
+/// Longest event type stored inside the record itself.
+pub const inline_type_capacity = 32;
+
+/// One pooled Event / CustomEvent.
+pub const PooledEvent = struct {
+    /// Must stay first: record, CustomEvent and Event share an address
+    custom: CustomEvent,
+    ref_count: u32,
+    type_inline: [inline_type_capacity + 1]u8 = undefined,
+    /// Buffer for longer types, kept for the next user of the record
+    type_heap: []u8 = &.{},
+
+    /// Returns the record an event handed out by a pool lives in.
+    pub fn fromEvent(evt: *Event) *PooledEvent {
+        const custom: *CustomEvent = @fieldParentPtr("event", evt);
+        return @fieldParentPtr("custom", custom);
+    }
+
+    pub fn event(self: *PooledEvent) *Event {
+        return &self.custom.event;
+    }
+
+    pub fn customEvent(self: *PooledEvent) *CustomEvent {
+        return &self.custom;
+    }
+
+    /// Copies `event_type` into the record and returns the stored copy,
+    /// which is followed by a NUL byte for C callers. `event_type` may be
+    /// the record's current type.
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to grow the heap type buffer
+    pub fn storeType(self: *PooledEvent, allocator: Allocator, event_type: []const u8) ![:0]const u8 {
+        const buffer: []u8 = if (event_type.len <= inline_type_capacity)
+            &self.type_inline
+        else if (self.type_heap.len > event_type.len)
+            self.type_heap
+        else {
+            const grown = try allocator.alloc(u8, event_type.len + 1);
+            @memcpy(grown[0..event_type.len], event_type);
+            grown[event_type.len] = 0;
+            allocator.free(self.type_heap);
+            self.type_heap = grown;
+            return grown[0..event_type.len :0];
+        };
+        std.mem.copyForwards(u8, buffer[0..event_type.len], event_type);
+        buffer[event_type.len] = 0;
+        return buffer[0..event_type.len :0];
+    }
+};
+
+pub const EventPool = struct {
+    allocator: Allocator,
+    /// Released records ready for reuse
+    free: std.ArrayList(*PooledEvent) = .{},
+    /// Most records kept on the free list
+    capacity: usize = 0,
+    /// Acquires served from the free list
+    hits: u64 = 0,
+    /// Acquires that allocated a record
+    misses: u64 = 0,
+    /// Records acquired and not yet released
+    live: usize = 0,
+
+    pub const Stats = struct {
+        hits: u64,
+        misses: u64,
+        pooled: usize,
+        live: usize,
+        capacity: usize,
+    };
+
+    pub fn init(allocator: Allocator, capacity: usize) EventPool {
+        var pool = EventPool{ .allocator = allocator };
+        pool.setCapacity(capacity);
+        return pool;
+    }
+
+    /// Frees the pooled records. Records still live are not touched.
+    pub fn deinit(self: *EventPool) void {
+        for (self.free.items) |record| {
+            self.destroy(record);
+        }
+        self.free.deinit(self.allocator);
+    }
+
+    /// Sets how many released records are kept, freeing any beyond it.
+    ///
+    /// The free list is reserved up front so releasing never allocates. If
+    /// that reservation fails, the pool keeps what already fits.
+    pub fn setCapacity(self: *EventPool, capacity: usize) void {
+        while (self.free.items.len > capacity) {
+            self.destroy(self.free.pop().?);
+        }
+        self.free.ensureTotalCapacity(self.allocator, capacity) catch {
+            self.capacity = self.free.capacity;
+            return;
+        };
+        self.capacity = capacity;
+    }
+
+    /// Returns an initialized record with one reference.
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to allocate a record or its type
+    pub fn acquire(self: *EventPool, event_type: []const u8, options: CustomEventInit) !*PooledEvent {
+        const record = if (self.free.pop()) |reused| blk: {
+            self.hits += 1;
+            break :blk reused;
+        } else blk: {
+            const created = try self.allocator.create(PooledEvent);
+            created.* = .{ .custom = undefined, .ref_count = 0 };
+            self.misses += 1;
+            break :blk created;
+        };
+        errdefer self.recycle(record);
+
+        const stored_type = try record.storeType(self.allocator, event_type);
+        record.custom = CustomEvent.init(stored_type, options);
+        record.ref_count = 1;
+        self.live += 1;
+        return record;
+    }
+
+    pub fn retain(_: *EventPool, record: *PooledEvent) void {
+        record.ref_count += 1;
+    }
+
+    /// Drops one reference; the last one returns the record to the pool.
+    pub fn release(self: *EventPool, record: *PooledEvent) void {
+        std.debug.assert(record.ref_count > 0);
+        record.ref_count -= 1;
+        if (record.ref_count > 0) return;
+
+        self.live -= 1;
+        self.recycle(record);
+    }
+
+    pub fn stats(self: *const EventPool) Stats {
+        return .{
+            .hits = self.hits,
+            .misses = self.misses,
+            .pooled = self.free.items.len,
+            .live = self.live,
+            .capacity = self.capacity,
+        };
+    }
+
+    fn recycle(self: *EventPool, record: *PooledEvent) void {
+        if (self.free.items.len < self.capacity) {
+            // The detail belongs to the previous user
+            record.custom.detail = null;
+            self.free.appendAssumeCapacity(record);
+            return;
+        }
+        self.destroy(record);
+    }
+
+    fn destroy(self: *EventPool, record: *PooledEvent) void {
+        self.allocator.free(record.type_heap);
+        self.allocator.destroy(record);
+    }
+};
@@ -627,6 +627,7 @@ pub const EventTarget = struct {
 
         // Step 3: Dispatch (simplified for Phase 1)
         event.dispatch_flag = true;
+        event.dispatch_id +%= 1;
         event.target = @ptrCast(self);
         event.current_target = @ptrCast(self);
         event.event_phase = .at_target;
@@ -664,14 +665,16 @@ pub const EventTarget = struct {
                     break;
                 }
 
-                // Handle "once" listeners - remove before invoking
+                // Handle "once" listeners - remove before invoking, release after
                 if (listener.once) {
-                    self.removeEventListener(
+                    _ = rare.takeEventListener(
                         listener.event_type,
                         listener.callback,
+                        listener.context,
                         listener.capture,
                     );
                 }
+                defer if (listener.once) listener.release();
 
                 // Set passive listener flag
                 const prev_passive = event.in_passive_listener_flag;
@@ -768,6 +771,17 @@ pub const EventListener = struct {
     /// then add the following abort steps to it: Remove an event listener"
     /// This enables automatic cleanup when operations are aborted.
     signal: ?*anyopaque = null, // Will be *AbortSignal once that type exists
+
+    /// Optional hook that frees `context`, called once the listener is
+    /// removed or its target is destroyed ("once" listeners: after their
+    /// invocation). Lets bindings own per-listener state such as a JS
+    /// function handle.
+    release_context: ?*const fn (context: *anyopaque) void = null,
+
+    /// Runs the release hook, if any.
+    pub fn release(self: EventListener) void {
+        if (self.release_context) |release_fn| release_fn(self.context);
+    }
 };
 
 /// Composition-aware EventTarget mixin.
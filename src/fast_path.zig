@@ -4,11 +4,21 @@
 //! - Simple ID selectors: #id
 //! - Simple class selectors: .class
 //! - Simple tag selectors: tag
+//! - Attribute equality: [name="value"], tag[name="value"]
+//! - Tag and class compounds: tag.class
+//! - Child combinators between tags: parent > child
 //!
 //! These patterns skip the full CSS parser and matcher for significant
 //! performance improvements (10-500x faster).
+//!
+//! The compound and combinator shapes are matched by `FastPathMatcher`,
+//! which resolves the selector's names against the document's string pool
+//! once per query. Tag names of elements in a document are interned there,
+//! so per-element tag tests are pointer comparisons.
 
 const std = @import("std");
+const Element = @import("element.zig").Element;
+const StringPool = @import("document.zig").StringPool;
 
 /// Fast path types for querySelector optimization
 pub const FastPathType = enum {
@@ -21,6 +31,15 @@ pub const FastPathType = enum {
     /// Simple tag selector: "div"
     simple_tag,
 
+    /// Attribute equality, optionally with a tag: "[data-id=\"x\"]"
+    attribute_equals,
+
+    /// Tag and class compound: "div.item"
+    tag_class,
+
+    /// Child combinator between two tags: "ul > li"
+    child_tag,
+
     /// Complex selector with ID that can filter search scope
     id_filtered,
 
@@ -28,37 +47,115 @@ pub const FastPathType = enum {
     generic,
 };
 
+/// A detected fast path and the names it compares.
+///
+/// Names are slices of the selector string passed to `parseFastPath`.
+pub const FastPathSelector = struct {
+    kind: FastPathType,
+
+    /// Subject tag name (simple_tag, tag_class, child_tag; optional for
+    /// attribute_equals)
+    tag: ?[]const u8 = null,
+
+    /// Parent tag name (child_tag)
+    parent_tag: []const u8 = "",
+
+    /// Class name (tag_class) or attribute name (attribute_equals)
+    name: []const u8 = "",
+
+    /// Attribute value (attribute_equals)
+    value: []const u8 = "",
+};
+
 /// Detect if a selector string matches a fast path pattern
 pub fn detectFastPath(selectors: []const u8) FastPathType {
+    return parseFastPath(selectors).kind;
+}
+
+/// Detect the fast path of a selector string and extract its names
+pub fn parseFastPath(selectors: []const u8) FastPathSelector {
     const trimmed = std.mem.trim(u8, selectors, &std.ascii.whitespace);
 
-    if (trimmed.len == 0) return .generic;
+    if (trimmed.len == 0) return .{ .kind = .generic };
 
     // Fast path: Simple ID selector "#id"
     if (trimmed.len > 1 and trimmed[0] == '#') {
         if (isSimpleIdentifier(trimmed[1..])) {
-            return .simple_id;
+            return .{ .kind = .simple_id, .name = trimmed[1..] };
         }
     }
 
     // Fast path: Simple class selector ".class"
     if (trimmed.len > 1 and trimmed[0] == '.') {
         if (isSimpleIdentifier(trimmed[1..])) {
-            return .simple_class;
+            return .{ .kind = .simple_class, .name = trimmed[1..] };
         }
     }
 
     // Fast path: Simple tag selector "div"
     if (isSimpleTagName(trimmed)) {
-        return .simple_tag;
+        return .{ .kind = .simple_tag, .tag = trimmed };
+    }
+
+    // Fast path: Attribute equality "[name=value]", "tag[name=\"value\"]"
+    if (parseAttributeEquals(trimmed)) |fast| {
+        return fast;
+    }
+
+    // Fast path: Tag and class compound "div.item"
+    if (std.mem.indexOfScalar(u8, trimmed, '.')) |dot| {
+        if (dot > 0 and isSimpleTagName(trimmed[0..dot]) and isSimpleIdentifier(trimmed[dot + 1 ..])) {
+            return .{ .kind = .tag_class, .tag = trimmed[0..dot], .name = trimmed[dot + 1 ..] };
+        }
+    }
+
+    // Fast path: Child combinator "ul > li"
+    if (std.mem.indexOfScalar(u8, trimmed, '>')) |gt| {
+        const parent = std.mem.trimRight(u8, trimmed[0..gt], " ");
+        const child = std.mem.trimLeft(u8, trimmed[gt + 1 ..], " ");
+        if (isSimpleTagName(parent) and isSimpleTagName(child)) {
+            return .{ .kind = .child_tag, .tag = child, .parent_tag = parent };
+        }
     }
 
     // Check for ID filtering opportunity: "article#main .content"
     if (std.mem.indexOf(u8, trimmed, "#")) |_| {
-        return .id_filtered;
+        return .{ .kind = .id_filtered };
     }
 
-    return .generic;
+    return .{ .kind = .generic };
+}
+
+/// Parse "[name=value]", "[name=\"value\"]" or "[name='value']" with an
+/// optional leading tag. Flags (`i`/`s`), escapes and whitespace inside the
+/// brackets are left to the full parser.
+fn parseAttributeEquals(s: []const u8) ?FastPathSelector {
+    if (s.len < 4 or s[s.len - 1] != ']') return null;
+    const open = std.mem.indexOfScalar(u8, s, '[') orelse return null;
+    const tag = s[0..open];
+    if (tag.len > 0 and !isSimpleTagName(tag)) return null;
+
+    const inner = s[open + 1 .. s.len - 1];
+    const eq = std.mem.indexOfScalar(u8, inner, '=') orelse return null;
+    const name = inner[0..eq];
+    if (!isSimpleIdentifier(name)) return null;
+
+    var value = inner[eq + 1 ..];
+    if (value.len >= 2 and (value[0] == '"' or value[0] == '\'') and value[value.len - 1] == value[0]) {
+        value = value[1 .. value.len - 1];
+        for (value) |c| {
+            if (c == '"' or c == '\'' or c == '\\' or c == '\n') return null;
+        }
+    } else if (!isSimpleIdentifier(value)) {
+        return null;
+    }
+
+    return .{
+        .kind = .attribute_equals,
+        .tag = if (tag.len > 0) tag else null,
+        .name = name,
+        .value = value,
+    };
 }
 
 /// Check if a string is a valid CSS identifier (alphanumeric, -, _, non-ASCII)
@@ -104,3 +201,101 @@ pub fn extractIdentifier(selectors: []const u8) []const u8 {
     }
     return trimmed;
 }
+
+/// A compound or combinator fast path resolved against a document.
+///
+/// Created once per query. Tag names are looked up in the document's
+/// string pool, so each element test is a pointer comparison; a tag that
+/// was never interned cannot be any element's tag name. Attribute names
+/// and values are usually interned too and are compared by pointer first.
+pub const FastPathMatcher = struct {
+    kind: FastPathType,
+    tag: ?[]const u8,
+    parent_tag: ?[]const u8,
+    name: []const u8,
+    value: []const u8,
+
+    /// False when some required tag is not interned (nothing can match)
+    possible: bool,
+
+    pub fn init(fast: *const FastPathSelector, pool: *const StringPool) FastPathMatcher {
+        var matcher = FastPathMatcher{
+            .kind = fast.kind,
+            .tag = null,
+            .parent_tag = null,
+            .name = pool.lookup(fast.name) orelse fast.name,
+            .value = pool.lookup(fast.value) orelse fast.value,
+            .possible = true,
+        };
+        if (fast.tag) |tag| {
+            matcher.tag = pool.lookup(tag) orelse blk: {
+                matcher.possible = false;
+                break :blk null;
+            };
+        }
+        if (fast.kind == .child_tag) {
+            matcher.parent_tag = pool.lookup(fast.parent_tag) orelse blk: {
+                matcher.possible = false;
+                break :blk null;
+            };
+        }
+        return matcher;
+    }
+
+    /// Returns true if `element` matches the selector.
+    pub fn matches(self: *const FastPathMatcher, element: *const Element) bool {
+        if (self.tag) |tag| {
+            if (element.tag_name.ptr != tag.ptr or element.tag_name.len != tag.len) return false;
+        }
+
+        switch (self.kind) {
+            .attribute_equals => {
+                var iter = element.attributes.array.iterator();
+                while (iter.next()) |attr| {
+                    // First attribute with the name, as in getAttribute()
+                    if (sameString(attr.name.local_name, self.name)) {
+                        return sameString(attr.value, self.value);
+                    }
+                }
+                return false;
+            },
+            .tag_class => return element.hasClass(self.name),
+            .child_tag => {
+                const parent = element.prototype.parent_node orelse return false;
+                if (parent.node_type != .element) return false;
+                const parent_elem: *const Element = @fieldParentPtr("prototype", parent);
+                const parent_tag = self.parent_tag.?;
+                return parent_elem.tag_name.ptr == parent_tag.ptr and parent_elem.tag_name.len == parent_tag.len;
+            },
+            else => unreachable,
+        }
+    }
+
+    fn sameString(a: []const u8, b: []const u8) bool {
+        return (a.ptr == b.ptr and a.len == b.len) or std.mem.eql(u8, a, b);
+    }
+};
+
+/// Per-kind counts of queries by fast path, for measuring the hit rate.
+pub const FastPathStats = struct {
+    counts: std.EnumArray(FastPathType, u64) = std.EnumArray(FastPathType, u64).initFill(0),
+
+    /// Counts one query that used `kind`.
+    pub fn record(self: *FastPathStats, kind: FastPathType) void {
+        self.counts.getPtr(kind).* += 1;
+    }
+
+    /// `record()` for statistics updated from several threads.
+    pub fn recordAtomic(self: *FastPathStats, kind: FastPathType) void {
+        _ = @atomicRmw(u64, self.counts.getPtr(kind), .Add, 1, .monotonic);
+    }
+
+    /// Returns the number of queries that used `kind`.
+    pub fn get(self: *const FastPathStats, kind: FastPathType) u64 {
+        return self.counts.get(kind);
+    }
+
+    pub fn reset(self: *FastPathStats) void {
+        self.* = .{};
+    }
+};
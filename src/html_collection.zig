@@ -44,7 +44,7 @@
 //! HTMLCollection supports three different backing strategies:
 //!
 //! 1. **children** property - filters Element nodes from parent's child list
-//! 2. **Document.getElementsByTagName** - views Document's tag_map (O(1) access)
+//! 2. **Document.getElementsByTagName** - views Document's tag index (O(1) access)
 //! 3. **Document.getElementsByClassName** - document-wide tree traversal with bloom filters (Phase 3)
 //! 4. **Element.getElementsBy*** - scoped subtree search with filtering
 //!
@@ -75,7 +75,7 @@
 //!
 //! HTMLCollection is a lightweight view using a tagged union for different backing strategies:
 //! - **children**: Pointer to parent node (filters Element nodes)
-//! - **document_tagged**: Pointer to Document's ArrayList (tag_map only, Phase 3)
+//! - **document_tagged**: Pointer to a Document tag index bucket
 //! - **element_scoped**: Root element + filter (tag or class name)
 //! - **document_scoped**: Document node + filter (for getElementsByClassName, Phase 3)
 //!
@@ -139,7 +139,7 @@
 //! _ = try doc.prototype.appendChild(&widget1.prototype);
 //! _ = try doc.prototype.appendChild(&widget2.prototype);
 //!
-//! // Live collection backed by Document's tag_map
+//! // Live collection backed by Document's tag index
 //! const widgets = doc.getElementsByTagName("widget");
 //! try std.testing.expectEqual(@as(usize, 2), widgets.length());
 //!
@@ -173,7 +173,7 @@
 //! ## Performance Tips
 //!
 //! 1. **Cache Length** - length() traversal cost varies by backing type
-//! 2. **Document.getElementsBy*** is Fast** - O(1) via tag_map/class_map
+//! 2. **Document.getElementsBy*** is Fast** - O(1) via the tag index
 //! 3. **Element.getElementsBy*** is O(n)** - Traverses subtree each time
 //! 4. **children is O(n)** - Traverses child list filtering Elements
 //! 5. **Snapshot if Modifying** - Convert to array before modifying DOM during iteration
@@ -182,7 +182,7 @@
 //!
 //! - HTMLCollection is a plain struct (16-24 bytes, tagged union)
 //! - No heap allocation (stack-allocated value type)
-//! - Document.getElementsBy* backed by tag_map/class_map (O(1) access)
+//! - Document.getElementsBy* backed by the tag index (O(1) access)
 //! - Element.getElementsBy* traverses subtree each call (O(n))
 //! - children traverses child list each call filtering Elements (O(n))
 //! - Live collection - automatically reflects DOM mutations
@@ -290,6 +290,7 @@ const std = @import("std");
 const Node = @import("node.zig").Node;
 const Element = @import("element.zig").Element;
 const NodeType = @import("node.zig").NodeType;
+const ClassIndex = @import("class_index.zig").ClassIndex;
 
 /// HTMLCollection - live collection of Element nodes.
 ///
@@ -299,7 +300,7 @@ const NodeType = @import("node.zig").NodeType;
 /// This is a "live" collection that automatically reflects changes to the DOM tree.
 /// Three backing strategies support different use cases:
 /// - children: Views parent's element children
-/// - document_tagged: Views Document's tag_map or class_map
+/// - document_tagged: Views a bucket of Document's tag index
 /// - element_scoped: Filters elements in subtree by tag/class
 ///
 /// ## WHATWG Specification
@@ -326,7 +327,7 @@ pub const HTMLCollection = struct {
         /// For ParentNode.children - filters Element nodes from parent's child list
         children: *Node,
 
-        /// For Document.getElementsByTagName - backed by tag_map (fast O(1) access)
+        /// For Document.getElementsByTagName - backed by the tag index (fast O(1) access)
         document_tagged: struct {
             elements: ?*const std.ArrayList(*Element),
         },
@@ -343,6 +344,13 @@ pub const HTMLCollection = struct {
             document: *const Node, // Document node
             filter: Filter,
         },
+
+        /// For Document.getElementsByClassName with the class index enabled
+        /// (O(1) length, item in tree order without traversal)
+        document_class_indexed: struct {
+            index: *ClassIndex,
+            class_name: []const u8,
+        },
     };
 
     /// Creates a collection for ParentNode.children (filters Element nodes from parent).
@@ -358,13 +366,13 @@ pub const HTMLCollection = struct {
         };
     }
 
-    /// Creates a collection for Document.getElementsBy* (backed by tag_map or class_map).
+    /// Creates a collection for Document.getElementsByTagName (backed by the tag index).
     ///
     /// ## Parameters
-    /// - `elements`: ArrayList from Document's tag_map or class_map, or null for empty
+    /// - `elements`: Bucket from Document's tag index, or null for empty
     ///
     /// ## Returns
-    /// HTMLCollection viewing Document's internal map
+    /// HTMLCollection viewing the bucket
     pub fn initDocumentTagged(elements: ?*const std.ArrayList(*Element)) HTMLCollection {
         return .{
             .impl = .{ .document_tagged = .{ .elements = elements } },
@@ -409,6 +417,28 @@ pub const HTMLCollection = struct {
         };
     }
 
+    /// Creates a collection for Document.getElementsByTagName (document-wide search).
+    ///
+    /// Used when the document's tag index has no bucket to view (a frozen
+    /// document, or out of memory).
+    ///
+    /// ## Parameters
+    /// - `document`: Document node to search from
+    /// - `tag_name`: Tag name to filter by
+    ///
+    /// ## Returns
+    /// HTMLCollection filtering all document elements by tag name
+    pub fn initDocumentByTagName(document: *const Node, tag_name: []const u8) HTMLCollection {
+        return .{
+            .impl = .{
+                .document_scoped = .{
+                    .document = document,
+                    .filter = .{ .tag_name = tag_name },
+                },
+            },
+        };
+    }
+
     /// Creates a collection for Document.getElementsByClassName (document-wide search).
     ///
     /// Phase 3: Uses tree traversal with bloom filters instead of class_map.
@@ -430,6 +460,26 @@ pub const HTMLCollection = struct {
         };
     }
 
+    /// Creates a collection for Document.getElementsByClassName backed by the
+    /// document's class index (see Document.enableClassIndex).
+    ///
+    /// ## Parameters
+    /// - `index`: The document's class index
+    /// - `class_name`: Class name to filter by (should be interned)
+    ///
+    /// ## Returns
+    /// HTMLCollection viewing the index entry for class_name
+    pub fn initDocumentClassIndexed(index: *ClassIndex, class_name: []const u8) HTMLCollection {
+        return .{
+            .impl = .{
+                .document_class_indexed = .{
+                    .index = index,
+                    .class_name = class_name,
+                },
+            },
+        };
+    }
+
     /// Creates a collection for Element.getElementsByTagNameNS (scoped to subtree).
     ///
     /// ## Parameters
@@ -492,6 +542,7 @@ pub const HTMLCollection = struct {
     /// - **children**: O(n) - traverses child list filtering Elements
     /// - **document_tagged**: O(1) - ArrayList.items.len
     /// - **element_scoped**: O(n) - traverses subtree with filter
+    /// - **document_class_indexed**: O(1) - class index entry size
     ///
     /// ## Returns
     /// Number of elements in the collection
@@ -524,6 +575,10 @@ pub const HTMLCollection = struct {
                 // Count matching elements in entire document
                 return countMatchingInDocument(scoped.document, &scoped.filter);
             },
+            .document_class_indexed => |indexed| {
+                // Fast path: size of the index entry
+                return indexed.index.count(indexed.class_name);
+            },
         }
     }
 
@@ -545,6 +600,8 @@ pub const HTMLCollection = struct {
     /// - **children**: O(n) - traverses child list to index
     /// - **document_tagged**: O(1) - ArrayList direct access
     /// - **element_scoped**: O(n) - traverses subtree to index
+    /// - **document_class_indexed**: O(1) - class index entry (after a sort
+    ///   if classes changed since the last item() call)
     ///
     /// ## Example
     /// ```zig
@@ -588,7 +645,71 @@ pub const HTMLCollection = struct {
                 // Find nth matching element in document
                 return findMatchingInDocument(scoped.document, &scoped.filter, index);
             },
+            .document_class_indexed => |indexed| {
+                // Fast path: index entry, sorted into tree order on demand
+                return indexed.index.item(indexed.class_name, index);
+            },
+        }
+    }
+
+    /// Copies the collection's elements, in order, into `out`.
+    ///
+    /// Writes up to `out.len` elements and returns the total number in the
+    /// collection, which may be larger; callers retry with a bigger buffer.
+    /// One traversal for every variant, so bindings can snapshot a live
+    /// collection instead of calling item() once per index (O(n) each for
+    /// the traversing variants).
+    ///
+    /// ## Parameters
+    /// - `out`: Buffer to fill (may be empty to query the length)
+    ///
+    /// ## Returns
+    /// Number of elements in the collection
+    pub fn copyItems(self: *const HTMLCollection, out: []*Element) usize {
+        var total: usize = 0;
+        switch (self.impl) {
+            .children => |parent| {
+                var current = parent.first_child;
+                while (current) |node| : (current = node.next_sibling) {
+                    if (node.node_type != .element) continue;
+                    if (total < out.len) out[total] = @fieldParentPtr("prototype", node);
+                    total += 1;
+                }
+            },
+            .document_tagged => |tagged| {
+                const list = tagged.elements orelse return 0;
+                return copySlice(list.items, out);
+            },
+            .element_scoped => |scoped| {
+                total = copyMatching(&scoped.root.prototype, &scoped.filter, out);
+            },
+            .document_scoped => |scoped| {
+                total = copyMatching(@constCast(scoped.document), &scoped.filter, out);
+            },
+            .document_class_indexed => |indexed| {
+                return copySlice(indexed.index.elements(indexed.class_name), out);
+            },
+        }
+        return total;
+    }
+
+    fn copySlice(elements: []const *Element, out: []*Element) usize {
+        const n = @min(elements.len, out.len);
+        @memcpy(out[0..n], elements[0..n]);
+        return elements.len;
+    }
+
+    /// Copies the descendants of `root` matching the filter (tree order).
+    fn copyMatching(root: *Node, filter: *const Filter, out: []*Element) usize {
+        var total: usize = 0;
+        const ElementIterator = @import("element_iterator.zig").ElementIterator;
+        var iter = ElementIterator.init(root);
+        while (iter.next()) |elem| {
+            if (!matchesFilter(elem, filter)) continue;
+            if (total < out.len) out[total] = elem;
+            total += 1;
         }
+        return total;
     }
 
     /// Returns the element with the specified id or name attribute.
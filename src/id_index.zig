@@ -0,0 +1,166 @@
+//! Id Index - Per-document map from id to the connected elements carrying it
+//!
+//! Backs `Document.getElementById()`, `Element.queryById()` and the `#id`
+//! querySelector fast path. The index is updated incrementally, when an
+//! element's id attribute changes and when elements are connected to or
+//! disconnected from the document, so lookups never scan the tree.
+//!
+//! ## Duplicate Ids
+//!
+//! Ids should be unique, but documents routinely contain duplicates. Each
+//! entry keeps every connected element with the id in tree order, so the
+//! first element is the one `getElementById()` returns and removing it
+//! promotes the next one without searching the document. The common unique
+//! case stores the element inline and allocates nothing beyond the map slot.
+//!
+//! ## Keys
+//!
+//! Keys are interned in the document's string pool, so they stay valid for
+//! the life of the document whatever happens to the attribute value they
+//! were read from.
+//!
+//! ## Usage
+//!
+//! ```zig
+//! try doc.id_map.add(&doc.string_pool, id, elem);  // element connected
+//! const found = doc.id_map.get("main");           // first in tree order
+//! doc.id_map.remove(id, elem);                     // element disconnected
+//! ```
+
+const std = @import("std");
+const Allocator = std.mem.Allocator;
+const Element = @import("element.zig").Element;
+const Node = @import("node.zig").Node;
+const StringPool = @import("document.zig").StringPool;
+
+pub const IdIndex = struct {
+    allocator: Allocator,
+    map: std.StringHashMapUnmanaged(Entry) = .{},
+
+    /// Connected elements with one id, in tree order
+    const Entry = struct {
+        /// First element in tree order
+        first: *Element,
+        /// Further elements with the same id (duplicate ids only)
+        rest: std.ArrayList(*Element) = .{},
+    };
+
+    pub fn init(allocator: Allocator) IdIndex {
+        return .{ .allocator = allocator };
+    }
+
+    pub fn deinit(self: *IdIndex) void {
+        var it = self.map.valueIterator();
+        while (it.next()) |entry| {
+            entry.rest.deinit(self.allocator);
+        }
+        self.map.deinit(self.allocator);
+    }
+
+    /// Returns the first connected element with `id` in tree order.
+    pub fn get(self: *const IdIndex, id: []const u8) ?*Element {
+        const entry = self.map.getPtr(id) orelse return null;
+        return entry.first;
+    }
+
+    /// Returns an iterator over the elements with `id`, in tree order.
+    pub fn iterator(self: *const IdIndex, id: []const u8) Iterator {
+        return .{ .entry = self.map.getPtr(id) };
+    }
+
+    /// Returns the number of distinct ids.
+    pub fn count(self: *const IdIndex) usize {
+        return self.map.count();
+    }
+
+    /// Adds a connected element under `id`.
+    ///
+    /// Adding an element that is already indexed under `id` does nothing.
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to grow the map or intern the key
+    pub fn add(self: *IdIndex, pool: *StringPool, id: []const u8, element: *Element) !void {
+        const result = try self.map.getOrPut(self.allocator, id);
+        if (!result.found_existing) {
+            // Store the interned copy as the key
+            result.key_ptr.* = pool.intern(id) catch |err| {
+                self.map.removeByPtr(result.key_ptr);
+                return err;
+            };
+            result.value_ptr.* = .{ .first = element };
+            return;
+        }
+
+        const entry = result.value_ptr;
+        if (entry.first == element) return;
+        for (entry.rest.items) |existing| {
+            if (existing == element) return;
+        }
+
+        if (precedes(element, entry.first)) {
+            try entry.rest.insert(self.allocator, 0, entry.first);
+            entry.first = element;
+            return;
+        }
+
+        // Duplicates are rare; keep them sorted with a linear scan
+        var index: usize = entry.rest.items.len;
+        for (entry.rest.items, 0..) |existing, i| {
+            if (precedes(element, existing)) {
+                index = i;
+                break;
+            }
+        }
+        try entry.rest.insert(self.allocator, index, element);
+    }
+
+    /// Removes `element` from under `id`. Does nothing if it is not indexed.
+    pub fn remove(self: *IdIndex, id: []const u8, element: *Element) void {
+        const entry = self.map.getPtr(id) orelse return;
+
+        if (entry.first == element) {
+            if (entry.rest.items.len == 0) {
+                entry.rest.deinit(self.allocator);
+                _ = self.map.remove(id);
+                return;
+            }
+            entry.first = entry.rest.orderedRemove(0);
+            return;
+        }
+
+        for (entry.rest.items, 0..) |existing, i| {
+            if (existing == element) {
+                _ = entry.rest.orderedRemove(i);
+                return;
+            }
+        }
+    }
+
+    /// Removes every entry.
+    pub fn clear(self: *IdIndex) void {
+        var it = self.map.valueIterator();
+        while (it.next()) |entry| {
+            entry.rest.deinit(self.allocator);
+        }
+        self.map.clearRetainingCapacity();
+    }
+
+    pub const Iterator = struct {
+        entry: ?*const Entry,
+        index: usize = 0,
+
+        pub fn next(self: *Iterator) ?*Element {
+            const entry = self.entry orelse return null;
+            defer self.index += 1;
+            if (self.index == 0) return entry.first;
+            if (self.index - 1 < entry.rest.items.len) return entry.rest.items[self.index - 1];
+            return null;
+        }
+    };
+
+    /// True if `a` comes before `b` in tree order
+    fn precedes(a: *const Element, b: *const Element) bool {
+        const position = a.prototype.compareDocumentPosition(&b.prototype);
+        return position & Node.DOCUMENT_POSITION_FOLLOWING != 0;
+    }
+};
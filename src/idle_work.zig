@@ -0,0 +1,120 @@
+//! Idle Work - Budgeted upkeep of a document's lazy indices
+//!
+//! The optional indices (class index, compact layout, document order
+//! numbering, structural hashes) are rebuilt by the first query that finds
+//! them out of date, so a query after a burst of mutations pays a full
+//! tree walk. `run` does that work ahead of time instead, in slices of a
+//! time budget the embedder spends when its event loop is idle (e.g. from
+//! a V8 idle task), so queries on long-lived documents find the indices
+//! warm.
+//!
+//! ## Priority
+//!
+//! Indices are brought up to date in this order, each resuming where the
+//! previous run stopped:
+//! 1. Class index, if a change outside a batch invalidated it (a read
+//!    would otherwise rebuild it in one pass)
+//! 2. Compact layout, rebuilt after any change (every query needs it)
+//! 3. Document order numbering, renumbered after insertions (comparisons
+//!    of the inserted nodes walk the tree until then)
+//! 4. Structural hash of the document (only the dirty paths are rehashed)
+//!
+//! The id index and the tag buckets are updated on every mutation and
+//! need no idle work.
+//!
+//! ## Mutations
+//!
+//! Work in progress is checked against the document's mutation version
+//! (or, for hashes, the cache's invalidations) before each slice; a change
+//! since the previous slice restarts that index. Subtree hashes already
+//! cached are kept. A query that needs an index before its rebuild has
+//! finished rebuilds it in one pass as before.
+//!
+//! ## Example
+//! ```zig
+//! // From the embedder's idle callback, with the time left until the deadline
+//! if (try doc.runIdleWork(remaining_ns)) scheduleIdleTask();
+//! ```
+
+const std = @import("std");
+const Document = @import("document.zig").Document;
+
+/// Work units (nodes visited) between two reads of the clock
+pub const check_interval = 256;
+
+/// Time budget of one run, shared by the indices it visits.
+pub const Budget = struct {
+    timer: ?std.time.Timer,
+    budget_ns: u64,
+    units: usize = 0,
+    spent: bool = false,
+
+    pub fn init(budget_ns: u64) Budget {
+        return .{ .timer = std.time.Timer.start() catch null, .budget_ns = budget_ns };
+    }
+
+    /// Counts one unit of work about to be done. Returns true, and keeps
+    /// returning true, once the budget is spent: the caller saves its
+    /// resume point instead of doing the unit.
+    ///
+    /// The clock is read every `check_interval` units, so a run does at
+    /// least that many; without a monotonic clock it does exactly that many.
+    pub fn tick(self: *Budget) bool {
+        if (self.spent) return true;
+        self.units += 1;
+        if (self.units % check_interval != 0) return false;
+        const elapsed = if (self.timer) |*t| t.read() else std.math.maxInt(u64);
+        self.spent = elapsed >= self.budget_ns;
+        return self.spent;
+    }
+};
+
+/// Brings the enabled indices of `doc` up to date in priority order until
+/// `budget_ns` has passed.
+///
+/// ## Returns
+/// True if work remains (call again at the next idle period), false once
+/// every index is current.
+///
+/// ## Errors
+/// - `error.OutOfMemory`: An index could not grow; it is left to be
+///   rebuilt by its next query, and the next run retries
+pub fn run(doc: *Document, budget_ns: u64) !bool {
+    if (!pending(doc)) return false;
+
+    var budget = Budget.init(budget_ns);
+    if (doc.class_index) |index| {
+        if (doc.batch_depth == 0 and !try index.rebuildStep(doc.mutation_version, &budget)) return true;
+    }
+    if (doc.compact_layout) |layout| {
+        if (!try layout.rebuildStep(doc, &budget)) return true;
+    }
+    if (doc.order_index) |index| {
+        if (!try index.buildStep(&doc.prototype, doc.mutation_version, &budget)) return true;
+    }
+    if (doc.structural_hashes) |hashes| {
+        if (!try hashes.warmStep(&doc.prototype, &budget)) return true;
+    }
+    return false;
+}
+
+/// Returns true if `run` has work to do. Cheap enough to test after every
+/// task, to decide whether to ask for an idle callback.
+pub fn pending(doc: *const Document) bool {
+    // Frozen documents built every index when they froze
+    if (doc.frozen) return false;
+
+    if (doc.class_index) |index| {
+        if (index.stale and doc.batch_depth == 0) return true;
+    }
+    if (doc.compact_layout) |layout| {
+        if (layout.version != doc.mutation_version) return true;
+    }
+    if (doc.order_index) |index| {
+        if (index.unnumbered) return true;
+    }
+    if (doc.structural_hashes) |hashes| {
+        if (!hashes.hashes.contains(&doc.prototype)) return true;
+    }
+    return false;
+}
@@ -0,0 +1,335 @@
+//! Markup Parser - UTF-8 markup to a DocumentFragment in one pass
+//!
+//! Reads the markup serializer.zig writes (and the usual forms of
+//! hand-written markup) and builds it with a `TreeBuilder`, so a whole
+//! string of markup becomes a DocumentFragment in one call and is then
+//! inserted in one step: one mutation record and one range update however
+//! many nodes it holds. Element.insertAdjacentMarkup() and
+//! Element.setInnerMarkup() are built on it.
+//!
+//! ## Syntax
+//!
+//! - Start tags `<name a="value" b='value' c=value d>` and self-closing
+//!   `<name/>`. Names are kept as written: this is a generic DOM, so there
+//!   is no case folding and no element closes implicitly. The first of
+//!   repeated attributes wins.
+//! - End tags `</name>` close the innermost open element with that name and
+//!   every element opened inside it. An end tag no open element matches is
+//!   ignored, and elements still open at the end are closed.
+//! - Character references `&amp;` `&lt;` `&gt;` `&quot;` `&apos;` `&nbsp;`,
+//!   `&#N;` and `&#xH;` in text and attribute values. Any other `&` is
+//!   literal, as is a `<` that does not start a tag.
+//! - Comments `<!--data-->` become Comment nodes and CDATA sections
+//!   `<![CDATA[data]]>` become text. Document types and processing
+//!   instructions are skipped.
+//! - A tag cut off by the end of the markup is dropped.
+//!
+//! Text and attribute values are handed to the builder as slices of the
+//! markup itself; only those containing character references are decoded,
+//! into one scratch buffer reused for the whole parse.
+//!
+//! ## Usage
+//!
+//! ```zig
+//! const fragment = try markup_parser.parseFragment(doc, "<item id=\"first\">one</item>");
+//! defer fragment.prototype.release();
+//! _ = try list.prototype.appendChild(&fragment.prototype);
+//! ```
+
+const std = @import("std");
+const Allocator = std.mem.Allocator;
+const Document = @import("document.zig").Document;
+const DocumentFragment = @import("document_fragment.zig").DocumentFragment;
+const tree_builder = @import("tree_builder.zig");
+const TreeBuilder = tree_builder.TreeBuilder;
+const Attribute = tree_builder.Attribute;
+
+/// Parses `markup` (see the module doc) into a new DocumentFragment of
+/// `document`, owned by the caller.
+///
+/// Markup is never rejected (see the module doc for how malformed markup
+/// is read), so the only failure is running out of memory.
+///
+/// ## Errors
+/// - `error.OutOfMemory`: Failed to allocate
+pub fn parseFragment(document: *Document, markup: []const u8) !*DocumentFragment {
+    var builder = TreeBuilder.init(document);
+    defer builder.deinit();
+
+    var parser = Parser{ .builder = &builder, .markup = markup };
+    defer parser.deinit();
+    try parser.run();
+
+    return builder.finish();
+}
+
+/// Named character references, without the leading '&'.
+const named_references = [_]struct { []const u8, []const u8 }{
+    .{ "amp;", "&" },
+    .{ "lt;", "<" },
+    .{ "gt;", ">" },
+    .{ "quot;", "\"" },
+    .{ "apos;", "'" },
+    .{ "nbsp;", "\u{00A0}" },
+};
+
+/// An attribute value decoded into the scratch buffer, resolved to a slice
+/// once the start tag is complete (the buffer may move while it grows).
+const DecodedValue = struct {
+    index: usize,
+    start: usize,
+    len: usize,
+};
+
+const Parser = struct {
+    builder: *TreeBuilder,
+    markup: []const u8,
+    pos: usize = 0,
+
+    /// Decoded text and attribute values
+    scratch: std.ArrayList(u8) = .empty,
+
+    /// Attributes of the start tag being read
+    attributes: std.ArrayList(Attribute) = .empty,
+    decoded: std.ArrayList(DecodedValue) = .empty,
+
+    fn deinit(self: *Parser) void {
+        const gpa = self.allocator();
+        self.scratch.deinit(gpa);
+        self.attributes.deinit(gpa);
+        self.decoded.deinit(gpa);
+    }
+
+    fn allocator(self: *const Parser) Allocator {
+        return self.builder.document.prototype.allocator;
+    }
+
+    fn run(self: *Parser) !void {
+        while (self.pos < self.markup.len) {
+            const rest = self.markup[self.pos..];
+            const tag_start = std.mem.indexOfScalar(u8, rest, '<') orelse rest.len;
+            if (tag_start > 0) {
+                try self.text(rest[0..tag_start]);
+                self.pos += tag_start;
+            } else {
+                try self.tag(rest);
+            }
+        }
+    }
+
+    fn text(self: *Parser, raw: []const u8) !void {
+        if (std.mem.indexOfScalar(u8, raw, '&') == null) {
+            return self.builder.text(raw);
+        }
+        self.scratch.clearRetainingCapacity();
+        try self.decode(raw);
+        try self.builder.text(self.scratch.items);
+    }
+
+    /// Handles the markup at a '<' (the start of `rest`).
+    fn tag(self: *Parser, rest: []const u8) !void {
+        if (std.mem.startsWith(u8, rest, "<!--")) {
+            const end = std.mem.indexOfPos(u8, rest, 4, "-->");
+            try self.builder.comment(rest[4 .. end orelse rest.len]);
+            self.pos += if (end) |e| e + 3 else rest.len;
+        } else if (std.mem.startsWith(u8, rest, "<![CDATA[")) {
+            const end = std.mem.indexOfPos(u8, rest, 9, "]]>");
+            try self.builder.text(rest[9 .. end orelse rest.len]);
+            self.pos += if (end) |e| e + 3 else rest.len;
+        } else if (rest.len > 1 and (rest[1] == '!' or rest[1] == '?')) {
+            // Document type or processing instruction: skipped
+            const end = std.mem.indexOfScalarPos(u8, rest, 2, '>');
+            self.pos += if (end) |e| e + 1 else rest.len;
+        } else if (rest.len > 2 and rest[1] == '/' and std.ascii.isAlphabetic(rest[2])) {
+            self.endTag();
+        } else if (rest.len > 1 and std.ascii.isAlphabetic(rest[1])) {
+            try self.startTag();
+        } else {
+            try self.builder.text("<");
+            self.pos += 1;
+        }
+    }
+
+    fn startTag(self: *Parser) !void {
+        self.pos += 1;
+        const tag_name = self.name();
+
+        self.scratch.clearRetainingCapacity();
+        self.attributes.clearRetainingCapacity();
+        self.decoded.clearRetainingCapacity();
+
+        var self_closing = false;
+        while (true) {
+            self.skipSpace();
+            if (self.pos >= self.markup.len) return; // Cut off: dropped
+            switch (self.markup[self.pos]) {
+                '>' => {
+                    self.pos += 1;
+                    break;
+                },
+                '/' => {
+                    self.pos += 1;
+                    if (self.pos < self.markup.len and self.markup[self.pos] == '>') {
+                        self.pos += 1;
+                        self_closing = true;
+                        break;
+                    }
+                },
+                else => try self.attribute(),
+            }
+        }
+
+        for (self.decoded.items) |value| {
+            self.attributes.items[value.index].value = self.scratch.items[value.start..][0..value.len];
+        }
+        try self.builder.open(tag_name, self.attributes.items);
+        if (self_closing) self.builder.close() catch unreachable;
+    }
+
+    fn endTag(self: *Parser) void {
+        self.pos += 2;
+        const tag_name = self.name();
+        const end = std.mem.indexOfScalarPos(u8, self.markup, self.pos, '>') orelse {
+            self.pos = self.markup.len; // Cut off: dropped
+            return;
+        };
+        self.pos = end + 1;
+        _ = self.builder.closeNamed(tag_name);
+    }
+
+    fn attribute(self: *Parser) !void {
+        // The first byte belongs to the name, even an '='
+        const start = self.pos;
+        self.pos += 1;
+        while (self.pos < self.markup.len) : (self.pos += 1) {
+            const c = self.markup[self.pos];
+            if (isSpace(c) or c == '/' or c == '>' or c == '=') break;
+        }
+        const attr_name = self.markup[start..self.pos];
+
+        var value: []const u8 = "";
+        self.skipSpace();
+        if (self.pos < self.markup.len and self.markup[self.pos] == '=') {
+            self.pos += 1;
+            self.skipSpace();
+            value = self.attributeValue();
+        }
+
+        for (self.attributes.items) |attr| {
+            if (std.mem.eql(u8, attr.name, attr_name)) return;
+        }
+
+        const gpa = self.allocator();
+        try self.attributes.ensureUnusedCapacity(gpa, 1);
+        if (std.mem.indexOfScalar(u8, value, '&') != null) {
+            const value_start = self.scratch.items.len;
+            try self.decode(value);
+            try self.decoded.append(gpa, .{
+                .index = self.attributes.items.len,
+                .start = value_start,
+                .len = self.scratch.items.len - value_start,
+            });
+        }
+        self.attributes.appendAssumeCapacity(.{ .name = attr_name, .value = value });
+    }
+
+    fn attributeValue(self: *Parser) []const u8 {
+        if (self.pos >= self.markup.len) return "";
+
+        const quote = self.markup[self.pos];
+        if (quote == '"' or quote == '\'') {
+            const start = self.pos + 1;
+            const end = std.mem.indexOfScalarPos(u8, self.markup, start, quote) orelse {
+                self.pos = self.markup.len;
+                return "";
+            };
+            self.pos = end + 1;
+            return self.markup[start..end];
+        }
+
+        const start = self.pos;
+        while (self.pos < self.markup.len) : (self.pos += 1) {
+            const c = self.markup[self.pos];
+            if (isSpace(c) or c == '>') break;
+        }
+        return self.markup[start..self.pos];
+    }
+
+    /// Reads a tag name (up to whitespace, '/' or '>').
+    fn name(self: *Parser) []const u8 {
+        const start = self.pos;
+        while (self.pos < self.markup.len) : (self.pos += 1) {
+            const c = self.markup[self.pos];
+            if (isSpace(c) or c == '/' or c == '>') break;
+        }
+        return self.markup[start..self.pos];
+    }
+
+    fn skipSpace(self: *Parser) void {
+        while (self.pos < self.markup.len and isSpace(self.markup[self.pos])) self.pos += 1;
+    }
+
+    /// Appends `raw` to the scratch buffer with its character references
+    /// decoded. A reference never decodes to more bytes than it spans, so
+    /// reserving `raw.len` up front is enough.
+    fn decode(self: *Parser, raw: []const u8) !void {
+        try self.scratch.ensureUnusedCapacity(self.allocator(), raw.len);
+
+        var rest = raw;
+        while (std.mem.indexOfScalar(u8, rest, '&')) |amp| {
+            self.scratch.appendSliceAssumeCapacity(rest[0..amp]);
+            rest = rest[amp + self.reference(rest[amp..]) ..];
+        }
+        self.scratch.appendSliceAssumeCapacity(rest);
+    }
+
+    /// Decodes the reference at the start of `rest` (an '&') and returns the
+    /// bytes it spans; a lone '&' is kept as it is.
+    fn reference(self: *Parser, rest: []const u8) usize {
+        if (rest.len > 1 and rest[1] == '#') return self.numericReference(rest);
+
+        for (named_references) |named| {
+            if (std.mem.startsWith(u8, rest[1..], named[0])) {
+                self.scratch.appendSliceAssumeCapacity(named[1]);
+                return named[0].len + 1;
+            }
+        }
+        self.scratch.appendAssumeCapacity('&');
+        return 1;
+    }
+
+    fn numericReference(self: *Parser, rest: []const u8) usize {
+        const hex = rest.len > 2 and (rest[2] == 'x' or rest[2] == 'X');
+        const base: u8 = if (hex) 16 else 10;
+        const digits_start: usize = if (hex) 3 else 2;
+
+        var end = digits_start;
+        var value: u32 = 0;
+        while (end < rest.len) : (end += 1) {
+            const digit = std.fmt.charToDigit(rest[end], base) catch break;
+            value = @min(value *| base +| @as(u32, digit), 0x110000);
+        }
+        if (end == digits_start) {
+            self.scratch.appendAssumeCapacity('&');
+            return 1;
+        }
+        if (end < rest.len and rest[end] == ';') end += 1;
+
+        // NUL, surrogates and values past U+10FFFF become U+FFFD
+        const code_point: u21 = if (value == 0 or value > 0x10FFFF or (value >= 0xD800 and value <= 0xDFFF))
+            0xFFFD
+        else
+            @intCast(value);
+        var bytes: [4]u8 = undefined;
+        const len = std.unicode.utf8Encode(code_point, &bytes) catch unreachable;
+        self.scratch.appendSliceAssumeCapacity(bytes[0..len]);
+        return end;
+    }
+};
+
+fn isSpace(c: u8) bool {
+    return switch (c) {
+        ' ', '\t', '\n', '\r', 0x0C => true,
+        else => false,
+    };
+}
@@ -0,0 +1,210 @@
+//! Match Cache - Remembered matches() answers per element
+//!
+//! Reactive frameworks re-run the same few `element.matches(selector)`
+//! checks on every render, mostly against elements that did not change.
+//! With the cache enabled (see Document.enableMatchCache), each element
+//! keeps its last answers in a few slots keyed by compiled selector, so a
+//! repeated check is a probe instead of a run of the matcher.
+//!
+//! ## Validity
+//!
+//! Selectors are split once, when compiled, by what their answer depends
+//! on (see isElementLocal):
+//! - Element-local selectors (names, ids, classes, attributes, and :is(),
+//!   :not() and :where() of such) depend only on the element itself. Their
+//!   answers stay valid until the element's attributes change, which drops
+//!   the element's slots (Node.noteMutation), so they survive renders that
+//!   change other parts of the document.
+//! - Every other selector (combinators, structural pseudo-classes, :has())
+//!   is answered for one mutation version of the document.
+//!
+//! Selectors are identified by their SelectorList id, which is never
+//! reused, so an evicted and re-parsed selector starts over rather than
+//! reading another selector's answers. An element's slots are dropped when
+//! it is destroyed or adopted by another document (Document.releaseNodeRef),
+//! so a remembered pointer never names another node.
+//!
+//! The cache belongs to its document and is not thread-safe; frozen
+//! documents, which may be queried on several threads, leave it alone.
+//!
+//! ## Example
+//! ```zig
+//! try doc.enableMatchCache();
+//! _ = try item.matches(allocator, ".selected"); // matched and remembered
+//! _ = try item.matches(allocator, ".selected"); // answered by the cache
+//! ```
+
+const std = @import("std");
+const Allocator = std.mem.Allocator;
+const Element = @import("element.zig").Element;
+const Node = @import("node.zig").Node;
+const ParsedSelector = @import("document.zig").ParsedSelector;
+const Matcher = @import("selector/matcher.zig").Matcher;
+const parser = @import("selector/parser.zig");
+const SelectorList = parser.SelectorList;
+const CompoundSelector = parser.CompoundSelector;
+
+/// Answers remembered per element; the oldest is replaced first
+pub const slots_per_element = 4;
+
+/// Past this many elements the cache starts over (bounds its memory)
+pub const max_elements = 1 << 16;
+
+pub const MatchCache = struct {
+    allocator: Allocator,
+
+    /// Remembered answers per element
+    elements: std.AutoHashMapUnmanaged(*const Element, Slots) = .{},
+
+    /// Lookup statistics
+    hits: u64 = 0,
+    misses: u64 = 0,
+
+    const Slot = struct {
+        /// SelectorList id, 0 for an unused slot
+        selector: u64 = 0,
+        /// Mutation version of the answer (unused for local selectors)
+        version: u64 = 0,
+        local: bool = false,
+        result: bool = false,
+    };
+
+    const Slots = struct {
+        slots: [slots_per_element]Slot = [_]Slot{.{}} ** slots_per_element,
+        /// Slot to replace next
+        next: u8 = 0,
+
+        fn find(self: *const Slots, selector: u64, version: u64) ?*const Slot {
+            for (&self.slots) |*slot| {
+                if (slot.selector != selector) continue;
+                if (!slot.local and slot.version != version) return null;
+                return slot;
+            }
+            return null;
+        }
+
+        fn store(self: *Slots, entry: Slot) void {
+            // Refresh the selector's slot if it has one
+            for (&self.slots) |*slot| {
+                if (slot.selector == entry.selector) {
+                    slot.* = entry;
+                    return;
+                }
+            }
+            self.slots[self.next] = entry;
+            self.next = (self.next + 1) % slots_per_element;
+        }
+    };
+
+    pub fn init(allocator: Allocator) MatchCache {
+        return .{ .allocator = allocator };
+    }
+
+    pub fn deinit(self: *MatchCache) void {
+        self.elements.deinit(self.allocator);
+    }
+
+    /// Number of elements with remembered answers.
+    pub fn count(self: *const MatchCache) usize {
+        return self.elements.count();
+    }
+
+    /// Element.matches() for a parsed selector, answered from and recorded
+    /// in the cache. `version` is the document's mutation version.
+    ///
+    /// ## Errors
+    /// Errors of matching (e.g. `error.OutOfMemory` in :has()), or
+    /// `error.OutOfMemory` when the answer could not be recorded
+    pub fn matches(
+        self: *MatchCache,
+        allocator: Allocator,
+        element: *Element,
+        parsed: *const ParsedSelector,
+        version: u64,
+    ) !bool {
+        const selector = parsed.selector_list.id;
+        if (self.elements.getPtr(element)) |slots| {
+            if (slots.find(selector, version)) |slot| {
+                self.hits += 1;
+                return slot.result;
+            }
+        }
+        self.misses += 1;
+
+        const matcher = Matcher.init(allocator);
+        const result = try matcher.matches(element, &parsed.selector_list);
+
+        if (self.elements.count() >= max_elements) self.elements.clearRetainingCapacity();
+        const entry = try self.elements.getOrPut(self.allocator, element);
+        if (!entry.found_existing) entry.value_ptr.* = .{};
+        entry.value_ptr.store(.{
+            .selector = selector,
+            .version = version,
+            .local = parsed.element_local,
+            .result = result,
+        });
+        return result;
+    }
+
+    /// Drops the answers of `node` (after a change of its attributes, or
+    /// before it goes away). Other nodes are ignored.
+    pub fn forget(self: *MatchCache, node: *const Node) void {
+        if (node.node_type != .element) return;
+        const element: *const Element = @fieldParentPtr("prototype", node);
+        _ = self.elements.remove(element);
+    }
+};
+
+/// Returns true if whether an element matches `list` depends only on the
+/// element's own name and attributes, so an answer stays valid until they
+/// change.
+pub fn isElementLocal(list: *const SelectorList) bool {
+    for (list.selectors) |*selector| {
+        if (selector.combinators.len > 0) return false;
+        if (!isCompoundLocal(&selector.compound)) return false;
+    }
+    return true;
+}
+
+fn isCompoundLocal(compound: *const CompoundSelector) bool {
+    for (compound.simple_selectors) |*simple| {
+        switch (simple.*) {
+            .Universal, .Type, .Class, .Id, .Attribute, .PseudoElement => {},
+            .PseudoClass => |pseudo| switch (pseudo.kind) {
+                .Not, .Is, .Where => |inner| if (!isElementLocal(inner)) return false,
+                // Position, children or descendants
+                .FirstChild,
+                .LastChild,
+                .OnlyChild,
+                .FirstOfType,
+                .LastOfType,
+                .OnlyOfType,
+                .Empty,
+                .Root,
+                .NthChild,
+                .NthLastChild,
+                .NthOfType,
+                .NthLastOfType,
+                .Has,
+                => return false,
+                // Never match here (the matcher keeps no link, user action
+                // or form state); one that gains state must move up
+                .AnyLink,
+                .Link,
+                .Visited,
+                .Hover,
+                .Active,
+                .Focus,
+                .FocusVisible,
+                .FocusWithin,
+                .Enabled,
+                .Disabled,
+                .ReadOnly,
+                .ReadWrite,
+                .Checked,
+                => {},
+            },
+        }
+    }
+    return true;
+}
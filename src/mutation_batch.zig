@@ -0,0 +1,226 @@
+//! Mutation Record Batch - An observer's record queue as packed tables
+//!
+//! Handing mutation records to script one wrapper at a time costs a binding
+//! crossing per record, plus one per node field that script reads. A
+//! `MutationRecordBatch` takes an observer's whole record queue and flattens
+//! it into integer tables a binding can pass over in one crossing (e.g. as a
+//! Uint32Array). Nodes are referenced by index into a deduplicated node
+//! table, so a binding only creates a node wrapper when script reads the
+//! field it appears in.
+//!
+//! ## Layout
+//!
+//! `entries` holds `entry_stride` u32 per record, in queue order:
+//!
+//! ```text
+//! [0] type              RecordType
+//! [1] target            node index
+//! [2] added_offset      index of the first added node in node_lists
+//! [3] added_count
+//! [4] removed_offset    index of the first removed node in node_lists
+//! [5] removed_count
+//! [6] previous_sibling  node index or `none`
+//! [7] next_sibling      node index or `none`
+//! ```
+//!
+//! `node_lists` holds the node indexes of every addedNodes and removedNodes
+//! list back to back. Strings (attributeName, attributeNamespace, oldValue)
+//! stay on the records and are read per record with `record()`.
+//!
+//! ## Ownership
+//!
+//! The batch owns the taken records and holds a reference on every node in
+//! its node table; `deinit()` releases both.
+//!
+//! ## Usage
+//!
+//! ```zig
+//! var batch = try MutationRecordBatch.take(observer);
+//! defer batch.deinit();
+//!
+//! for (0..batch.count()) |i| {
+//!     const entry = batch.entry(i);
+//!     const target = batch.nodes[entry[mutation_batch.field_target]];
+//!     _ = target;
+//! }
+//! ```
+
+const std = @import("std");
+const Allocator = std.mem.Allocator;
+const Node = @import("node.zig").Node;
+const MutationObserver = @import("mutation_observer.zig").MutationObserver;
+const MutationRecord = @import("mutation_observer.zig").MutationRecord;
+
+/// Node index meaning "no node".
+pub const none: u32 = std.math.maxInt(u32);
+
+/// Number of u32 per record in `entries`.
+pub const entry_stride = 8;
+
+/// Offsets of the fields within one entry.
+pub const field_type = 0;
+pub const field_target = 1;
+pub const field_added_offset = 2;
+pub const field_added_count = 3;
+pub const field_removed_offset = 4;
+pub const field_removed_count = 5;
+pub const field_previous_sibling = 6;
+pub const field_next_sibling = 7;
+
+/// MutationRecord.type as an integer.
+pub const RecordType = enum(u32) {
+    attributes = 0,
+    character_data = 1,
+    child_list = 2,
+
+    pub fn fromString(record_type: []const u8) RecordType {
+        if (std.mem.eql(u8, record_type, "attributes")) return .attributes;
+        if (std.mem.eql(u8, record_type, "characterData")) return .character_data;
+        return .child_list;
+    }
+};
+
+pub const MutationRecordBatch = struct {
+    /// The observer's allocator; owns the records and the tables
+    allocator: Allocator,
+    /// Taken records, in queue order
+    records: []const *MutationRecord,
+    /// `entry_stride` u32 per record
+    entries: []u32,
+    /// Node indexes of the added and removed node lists
+    node_lists: []u32,
+    /// Every node the records reference, each once and referenced
+    nodes: []*Node,
+
+    /// Takes every pending record of `observer` and packs it.
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to build the tables; the records stay
+    ///   queued on the observer
+    pub fn take(observer: *MutationObserver) !MutationRecordBatch {
+        const allocator = observer.allocator;
+        const pending = observer.records.items;
+
+        var list_len: usize = 0;
+        for (pending) |rec| {
+            list_len += rec.added_nodes.items.len + rec.removed_nodes.items.len;
+        }
+
+        const entries = try allocator.alloc(u32, pending.len * entry_stride);
+        errdefer allocator.free(entries);
+        const node_lists = try allocator.alloc(u32, list_len);
+        errdefer allocator.free(node_lists);
+
+        var table = NodeTable{ .allocator = allocator };
+        defer table.indexes.deinit(allocator);
+        errdefer table.releaseNodes();
+
+        var list_index: u32 = 0;
+        for (pending, 0..) |rec, i| {
+            const out = entries[i * entry_stride ..][0..entry_stride];
+            out[field_type] = @intFromEnum(RecordType.fromString(rec.type));
+            out[field_target] = try table.indexOf(rec.target);
+
+            out[field_added_offset] = list_index;
+            out[field_added_count] = @intCast(rec.added_nodes.items.len);
+            for (rec.added_nodes.items) |added| {
+                node_lists[list_index] = try table.indexOf(added);
+                list_index += 1;
+            }
+
+            out[field_removed_offset] = list_index;
+            out[field_removed_count] = @intCast(rec.removed_nodes.items.len);
+            for (rec.removed_nodes.items) |removed| {
+                node_lists[list_index] = try table.indexOf(removed);
+                list_index += 1;
+            }
+
+            out[field_previous_sibling] = if (rec.previous_sibling) |sibling| try table.indexOf(sibling) else none;
+            out[field_next_sibling] = if (rec.next_sibling) |sibling| try table.indexOf(sibling) else none;
+        }
+
+        const nodes = try table.nodes.toOwnedSlice(allocator);
+        errdefer {
+            for (nodes) |n| n.release();
+            allocator.free(nodes);
+        }
+
+        // Last: once the queue is emptied nothing may fail
+        const records = try observer.takeRecordQueue();
+
+        return .{
+            .allocator = allocator,
+            .records = records,
+            .entries = entries,
+            .node_lists = node_lists,
+            .nodes = nodes,
+        };
+    }
+
+    /// Frees the records and tables and releases the nodes.
+    pub fn deinit(self: *MutationRecordBatch) void {
+        for (self.records) |rec| {
+            rec.deinit();
+        }
+        self.allocator.free(self.records);
+        for (self.nodes) |n| {
+            n.release();
+        }
+        self.allocator.free(self.nodes);
+        self.allocator.free(self.node_lists);
+        self.allocator.free(self.entries);
+    }
+
+    /// Returns the number of records.
+    pub fn count(self: *const MutationRecordBatch) usize {
+        return self.records.len;
+    }
+
+    /// Returns the packed entry of record `index`.
+    pub fn entry(self: *const MutationRecordBatch, index: usize) []const u32 {
+        return self.entries[index * entry_stride ..][0..entry_stride];
+    }
+
+    /// Returns record `index` (owned by the batch).
+    pub fn record(self: *const MutationRecordBatch, index: usize) *MutationRecord {
+        return self.records[index];
+    }
+
+    /// Returns the node indexes of the addedNodes of record `index`.
+    pub fn addedNodes(self: *const MutationRecordBatch, index: usize) []const u32 {
+        const e = self.entry(index);
+        return self.node_lists[e[field_added_offset]..][0..e[field_added_count]];
+    }
+
+    /// Returns the node indexes of the removedNodes of record `index`.
+    pub fn removedNodes(self: *const MutationRecordBatch, index: usize) []const u32 {
+        const e = self.entry(index);
+        return self.node_lists[e[field_removed_offset]..][0..e[field_removed_count]];
+    }
+};
+
+/// Deduplicating node table built while packing.
+const NodeTable = struct {
+    allocator: Allocator,
+    nodes: std.ArrayList(*Node) = .{},
+    indexes: std.AutoHashMapUnmanaged(*Node, u32) = .{},
+
+    fn indexOf(self: *NodeTable, node: *Node) !u32 {
+        const result = try self.indexes.getOrPut(self.allocator, node);
+        if (result.found_existing) return result.value_ptr.*;
+
+        self.nodes.append(self.allocator, node) catch |err| {
+            self.indexes.removeByPtr(result.key_ptr);
+            return err;
+        };
+        node.acquire();
+        result.value_ptr.* = @intCast(self.nodes.items.len - 1);
+        return result.value_ptr.*;
+    }
+
+    /// Releases and forgets the collected nodes.
+    fn releaseNodes(self: *NodeTable) void {
+        for (self.nodes.items) |n| n.release();
+        self.nodes.deinit(self.allocator);
+    }
+};
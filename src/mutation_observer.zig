@@ -411,6 +411,46 @@ pub const MutationRecord = struct {
         return self;
     }
 
+    /// Merge a childList mutation of `target` into this record if it
+    /// continues this record's run: an insertion right after the nodes this
+    /// record added, or a removal of the node right after the ones it
+    /// removed. Returns false (and changes nothing) otherwise.
+    ///
+    /// ## Errors
+    ///
+    /// - `OutOfMemory`: Failed to grow the node list
+    pub fn mergeChildList(
+        self: *MutationRecord,
+        target: *Node,
+        added_nodes: ?[]const *Node,
+        removed_nodes: ?[]const *Node,
+        previous_sibling: ?*Node,
+        next_sibling: ?*Node,
+    ) !bool {
+        if (self.target != target or !std.mem.eql(u8, self.type, "childList")) return false;
+
+        const added = added_nodes orelse &[_]*Node{};
+        const removed = removed_nodes orelse &[_]*Node{};
+
+        if (removed.len == 0 and added.len > 0 and self.removed_nodes.items.len == 0) {
+            // Insertion run: new nodes go right after the last added one
+            const last = self.added_nodes.getLastOrNull() orelse return false;
+            if (previous_sibling != last or next_sibling != self.next_sibling) return false;
+            try self.added_nodes.appendSlice(self.allocator, added);
+            return true;
+        }
+
+        if (added.len == 0 and removed.len > 0 and self.added_nodes.items.len == 0) {
+            // Removal run: the removed nodes followed the ones already removed
+            if (previous_sibling != self.previous_sibling or self.next_sibling != removed[0]) return false;
+            try self.removed_nodes.appendSlice(self.allocator, removed);
+            self.next_sibling = next_sibling;
+            return true;
+        }
+
+        return false;
+    }
+
     /// Free all resources associated with this record.
     pub fn deinit(self: *MutationRecord) void {
         self.allocator.free(self.type);
@@ -462,6 +502,14 @@ pub const MutationRecord = struct {
 /// - If `attribute_old_value` is true, `attributes` must be true (or omitted → defaults to true)
 /// - If `character_data_old_value` is true, `character_data` must be true (or omitted → defaults to true)
 /// - If `attribute_filter` is present, `attributes` must be true (or omitted → defaults to true)
+///
+/// ## Extensions
+///
+/// - `coalesce`: Queue at most one attributes record per (target, attribute)
+///   until the queue is taken, keeping the first oldValue, and merge
+///   childList records into an adjacent one on the same parent when they
+///   continue its run of insertions or removals. Not in the spec: records
+///   script sees are fewer, but describe the same net changes.
 pub const MutationObserverInit = struct {
     child_list: bool = false,
     attributes: ?bool = null,
@@ -470,6 +518,7 @@ pub const MutationObserverInit = struct {
     attribute_old_value: ?bool = null,
     character_data_old_value: ?bool = null,
     attribute_filter: ?[]const []const u8 = null,
+    coalesce: bool = false,
 
     /// Validate options per WHATWG spec.
     ///
@@ -592,6 +641,36 @@ pub const MutationObserver = struct {
     records: std.ArrayList(*MutationRecord),
     registrations: std.ArrayList(*MutationObserverRegistration),
     allocator: Allocator,
+    /// Called when a record is queued into an empty record queue, so an
+    /// embedder can schedule delivery (the spec's mutation observer
+    /// microtask). Runs in the middle of the mutation: it must not touch
+    /// the DOM or run script.
+    on_records: ?*const fn (observer: *MutationObserver) void = null,
+    /// Queued attributes records of coalescing registrations
+    coalesced_attributes: std.HashMapUnmanaged(AttributeKey, void, AttributeKey.Context, std.hash_map.default_max_load_percentage) = .{},
+
+    /// Identifies an attributes record in the queue; slices are the record's
+    const AttributeKey = struct {
+        target: *Node,
+        name: []const u8,
+        namespace: ?[]const u8,
+
+        const Context = struct {
+            pub fn hash(_: Context, key: AttributeKey) u64 {
+                var hasher = std.hash.Wyhash.init(0);
+                hasher.update(std.mem.asBytes(&key.target));
+                hasher.update(key.name);
+                if (key.namespace) |ns| hasher.update(ns);
+                return hasher.final();
+            }
+
+            pub fn eql(_: Context, a: AttributeKey, b: AttributeKey) bool {
+                if (a.target != b.target or !std.mem.eql(u8, a.name, b.name)) return false;
+                if (a.namespace == null or b.namespace == null) return a.namespace == null and b.namespace == null;
+                return std.mem.eql(u8, a.namespace.?, b.namespace.?);
+            }
+        };
+    };
 
     /// Create a new MutationObserver with a callback.
     ///
@@ -639,6 +718,7 @@ pub const MutationObserver = struct {
         self.disconnect();
         self.records.deinit(self.allocator);
         self.registrations.deinit(self.allocator);
+        self.coalesced_attributes.deinit(self.allocator);
         self.allocator.destroy(self);
     }
 
@@ -748,6 +828,7 @@ pub const MutationObserver = struct {
         self.registrations.clearRetainingCapacity();
 
         // 2. Clear pending records
+        self.coalesced_attributes.clearRetainingCapacity();
         for (self.records.items) |record| {
             record.deinit();
         }
@@ -775,7 +856,61 @@ pub const MutationObserver = struct {
     ///
     /// Slice of MutationRecord pointers (caller must free)
     pub fn takeRecords(self: *MutationObserver) []const *MutationRecord {
-        return self.records.toOwnedSlice(self.allocator) catch &[_]*MutationRecord{};
+        return self.takeRecordQueue() catch &[_]*MutationRecord{};
+    }
+
+    /// Move the record queue out (caller owns the slice and the records).
+    ///
+    /// ## Errors
+    ///
+    /// - `OutOfMemory`: Failed to shrink the queue; the records stay queued
+    pub fn takeRecordQueue(self: *MutationObserver) ![]*MutationRecord {
+        const records = try self.records.toOwnedSlice(self.allocator);
+        self.coalesced_attributes.clearRetainingCapacity();
+        return records;
+    }
+
+    /// True if a coalescing registration already queued an attributes
+    /// record for this attribute of `target`.
+    pub fn hasCoalescedAttribute(
+        self: *const MutationObserver,
+        target: *Node,
+        name: []const u8,
+        namespace: ?[]const u8,
+    ) bool {
+        return self.coalesced_attributes.contains(.{ .target = target, .name = name, .namespace = namespace });
+    }
+
+    /// Queue an attributes record of a coalescing registration, so later
+    /// changes to the same attribute are dropped until the queue is taken.
+    ///
+    /// ## Errors
+    ///
+    /// - `OutOfMemory`: Failed to grow the queue or the index (the record
+    ///   is not taken)
+    pub fn enqueueCoalescedAttribute(self: *MutationObserver, record: *MutationRecord) !void {
+        const key = AttributeKey{
+            .target = record.target,
+            .name = record.attribute_name orelse "",
+            .namespace = record.attribute_namespace,
+        };
+        try self.coalesced_attributes.put(self.allocator, key, {});
+        errdefer _ = self.coalesced_attributes.remove(key);
+        try self.enqueueRecord(record);
+    }
+
+    /// Append `record` to the record queue (the observer takes ownership)
+    /// and notify `on_records` if the queue was empty.
+    ///
+    /// ## Errors
+    ///
+    /// - `OutOfMemory`: Failed to grow the queue (the record is not taken)
+    pub fn enqueueRecord(self: *MutationObserver, record: *MutationRecord) !void {
+        const was_empty = self.records.items.len == 0;
+        try self.records.append(self.allocator, record);
+        if (was_empty) {
+            if (self.on_records) |notify| notify(self);
+        }
     }
 };
 
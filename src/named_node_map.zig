@@ -99,7 +99,8 @@
 //!
 //! **Attr Node Lifecycle**:
 //! 1. **Created on access**: Attr nodes created lazily via getNamedItem/item
-//! 2. **Cached in Element**: Element caches Attr nodes (TODO: implement cache)
+//! 2. **Cached in Element**: Element caches Attr nodes by name, so repeated
+//!    access returns the same node
 //! 3. **Released with Element**: When Element destroyed, cached Attr nodes released
 //!
 //! ## Usage Examples
@@ -332,23 +333,9 @@ pub const NamedNodeMap = struct {
     ///
     /// **WebIDL**: dom.idl:422 (getter)
     pub fn item(self: *NamedNodeMap, index: u32) !?*Attr {
-        const attrs = &self.element.attributes;
-        if (index >= attrs.count()) {
-            return null;
-        }
-
-        // Iterate to the index-th attribute
-        var iter = attrs.iterator();
-        var i: u32 = 0;
-        while (iter.next()) |attr| {
-            if (i == index) {
-                // Create or retrieve cached Attr node
-                return try self.getOrCreateAttr(attr.name.local_name, attr.value);
-            }
-            i += 1;
-        }
-
-        return null;
+        const attr = self.element.attributes.at(index) orelse return null;
+        // Create or retrieve cached Attr node
+        return try self.getOrCreateAttr(attr.name.local_name, attr.value);
     }
 
     /// Returns the attribute with the specified name, or null if not found.
@@ -367,6 +354,20 @@ pub const NamedNodeMap = struct {
         return try self.getOrCreateAttr(qualified_name, value);
     }
 
+    /// Like `item`, but the Attr is borrowed from the element's Attr cache
+    /// (see `Element.cachedAttr`): the caller must not release it.
+    pub fn itemBorrowed(self: *NamedNodeMap, index: u32) !?*Attr {
+        const attr = self.element.attributes.at(index) orelse return null;
+        return try self.element.cachedAttr(attr.name.local_name, attr.value);
+    }
+
+    /// Like `getNamedItem`, but the Attr is borrowed from the element's
+    /// Attr cache (see `Element.cachedAttr`): the caller must not release it.
+    pub fn getNamedItemBorrowed(self: *NamedNodeMap, qualified_name: []const u8) !?*Attr {
+        const value = self.element.getAttribute(qualified_name) orelse return null;
+        return try self.element.cachedAttr(qualified_name, value);
+    }
+
     /// Returns the namespaced attribute, or null if not found.
     ///
     /// ## Parameters
@@ -435,6 +436,8 @@ pub const NamedNodeMap = struct {
     ///
     /// **WebIDL**: dom.idl:425 [CEReactions]
     pub fn setNamedItem(self: *NamedNodeMap, attr: *Attr) !?*Attr {
+        try self.element.prototype.checkMutable();
+
         // [CEReactions] scope for custom element lifecycle callbacks (Phase 5)
         // Note: setAttribute() already has [CEReactions], so this creates nested scope
         // which is harmless and ensures spec compliance
@@ -493,6 +496,8 @@ pub const NamedNodeMap = struct {
     ///
     /// **WebIDL**: dom.idl:426 [CEReactions]
     pub fn setNamedItemNS(self: *NamedNodeMap, attr: *Attr) !?*Attr {
+        try self.element.prototype.checkMutable();
+
         // [CEReactions] scope for custom element lifecycle callbacks (Phase 5)
         if (self.element.prototype.owner_document) |doc_node| {
             if (doc_node.node_type == .document) {
@@ -540,6 +545,7 @@ pub const NamedNodeMap = struct {
         } else {
             try self.element.attributes.set(attr.local_name, attr.value());
         }
+        self.element.prototype.noteMutation();
 
         // Update attr's owner_element
         attr.owner_element = self.element;
@@ -562,6 +568,8 @@ pub const NamedNodeMap = struct {
     ///
     /// **WebIDL**: dom.idl:427 [CEReactions]
     pub fn removeNamedItem(self: *NamedNodeMap, qualified_name: []const u8) !*Attr {
+        try self.element.prototype.checkMutable();
+
         // [CEReactions] scope for custom element lifecycle callbacks (Phase 5)
         if (self.element.prototype.owner_document) |doc_node| {
             if (doc_node.node_type == .document) {
@@ -611,6 +619,8 @@ pub const NamedNodeMap = struct {
         namespace_uri: ?[]const u8,
         local_name: []const u8,
     ) !*Attr {
+        try self.element.prototype.checkMutable();
+
         // [CEReactions] scope for custom element lifecycle callbacks (Phase 5)
         if (self.element.prototype.owner_document) |doc_node| {
             if (doc_node.node_type == .document) {
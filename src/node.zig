@@ -56,24 +56,30 @@
 //! }
 //! ```
 //!
-//! ## Memory Layout (88 bytes)
+//! ## Memory Layout (112 bytes with the EventTarget prototype)
 //!
+//! Hot fields (read by traversal; the pointers sit in the first 64 bytes):
 //! - **vtable**: Polymorphic function pointers (8 bytes)
-//! - **ref_count_and_parent**: Packed 31-bit refcount + has_parent flag (4 bytes)
-//! - **node_type**: NodeType enum (1 byte)
-//! - **flags**: Boolean properties (1 byte)
-//! - **node_id**: Unique ID (2 bytes)
-//! - **generation**: Mutation counter (4 bytes)
-//! - **allocator**: Memory allocator (8 bytes)
 //! - **parent_node**: WEAK parent pointer (8 bytes)
 //! - **previous_sibling**: WEAK sibling pointer (8 bytes)
 //! - **first_child**: STRONG child pointer (8 bytes)
 //! - **last_child**: STRONG child pointer (8 bytes)
 //! - **next_sibling**: STRONG sibling pointer (8 bytes)
+//! - **node_type**: NodeType enum (1 byte)
+//! - **flags**: Boolean properties (1 byte)
+//!
+//! Cold fields:
 //! - **owner_document**: WEAK document pointer (8 bytes)
 //! - **rare_data**: Optional rare data (8 bytes)
+//! - **allocator**: Memory allocator (16 bytes)
+//! - **ref_count_and_parent**: Packed 31-bit refcount + has_parent flag (4 bytes)
+//! - **generation**: Mutation counter (4 bytes)
+//! - **node_id**: Unique ID (2 bytes)
+//! - **wrapper_slot**: Embedder wrapper slot (4 bytes)
+//! - **depth**: Ancestor count, for bounded ancestor walks (4 bytes)
 //!
-//! Total: 88 bytes (8 bytes under 96-byte budget!)
+//! Total: 112 bytes (2 bytes of padding), checked at compile time together with the offsets
+//! of the hot pointers.
 //!
 //! ## Memory Management
 //!
@@ -175,7 +181,7 @@
 //!
 //! ## Performance Tips
 //!
-//! 1. **Node size**: 88 bytes (optimized, 8 under budget)
+//! 1. **Node size**: 112 bytes, tree links in the first 64
 //! 2. **Packed ref_count**: Saves 12 bytes vs separate fields
 //! 3. **Rare data**: Allocated on demand for uncommon features
 //! 4. **Weak pointers**: No cycle detection overhead
@@ -340,7 +346,8 @@
 //! ## Implementation Notes
 //!
 //! - Compile-time size verification enforces ≤96 byte limit
-//! - Atomic ref_count for thread-safe reference counting
+//! - Plain ref_count updates, atomic for nodes of shared documents
+//!   (see `Document.share()`)
 //! - WebKit-style hybrid strong/weak reference system
 //! - Vtable polymorphism for extensibility (Element, Text, etc.)
 //! - has_parent flag prevents premature destruction in tree
@@ -351,7 +358,10 @@ const NodeRareData = @import("rare_data.zig").NodeRareData;
 const Event = @import("event.zig").Event;
 const EventTarget = @import("event_target.zig").EventTarget;
 const EventTargetVTable = @import("event_target.zig").EventTargetVTable;
+const EventListener = @import("event_target.zig").EventListener;
+const eventTypeBit = @import("rare_data.zig").eventTypeBit;
 const custom_elements = @import("custom_element_registry.zig");
+const character_data = @import("character_data.zig");
 
 /// Node types per WHATWG DOM specification.
 pub const NodeType = enum(u8) {
@@ -459,36 +469,10 @@ pub const Node = struct {
     /// Virtual table for Node-specific polymorphic dispatch (8 bytes)
     vtable: *const NodeVTable,
 
-    /// PACKED: 31-bit ref_count + 1-bit has_parent flag (4 bytes)
-    ///
-    /// This optimization saves 12 bytes per node vs separate fields.
-    /// - Bits 0-30: Reference count (max 2,147,483,647)
-    /// - Bit 31: has_parent flag (1 = has parent, 0 = no parent)
-    ///
-    /// The has_parent flag prevents premature destruction when:
-    /// - Node is in tree (parent owns it via strong reference)
-    /// - Node ref_count can drop to 0, but it's kept alive by parent
-    ref_count_and_parent: std.atomic.Value(u32),
-
-    /// Node type (1 byte)
-    node_type: NodeType,
-
-    /// Flags for various boolean properties (1 byte)
-    /// Bits: [unused(6), is_connected(1), is_in_shadow_tree(1)]
-    flags: u8,
-
-    /// Unique node ID within document (2 bytes)
-    /// Used for equality checks and debugging
-    /// Max 65,535 nodes per document (sufficient for most pages)
-    node_id: u16,
-
-    /// Generation counter for detecting stale references (4 bytes)
-    /// Incremented on major mutations
-    /// Max 4,294,967,295 mutations (sufficient for long-lived pages)
-    generation: u32,
-
-    /// Allocator used to create this node (8 bytes)
-    allocator: Allocator,
+    // === Hot fields ===
+    // Tree links, read by every traversal (firstChild/nextSibling walks,
+    // selector matching, ancestor checks). Declared together so they sit
+    // in the first 64 bytes of the node (see the layout check below).
 
     /// WEAK pointer to parent (8 bytes)
     /// Does NOT increment ref_count (prevents circular references)
@@ -509,6 +493,17 @@ pub const Node = struct {
     /// Only STRONG if sibling has parent (transitively owned)
     next_sibling: ?*Node,
 
+    /// Node type (1 byte)
+    node_type: NodeType,
+
+    /// Flags for various boolean properties (1 byte)
+    /// Bits: [unused(6), is_connected(1), is_in_shadow_tree(1)]
+    flags: u8,
+
+    // === Cold fields ===
+    // Read on ownership changes, mutation bookkeeping, allocation and
+    // bindings, not while walking the tree.
+
     /// WEAK pointer to owner document (8 bytes)
     /// Document uses separate dual ref counting
     owner_document: ?*Node, // TODO: Type as *Document once implemented
@@ -518,15 +513,68 @@ pub const Node = struct {
     /// Most nodes don't need this, saving 40-80 bytes
     rare_data: ?*NodeRareData,
 
-    // === Size Verification ===
-    // Node = EventTarget (8) + Node fields (96) = 104 bytes
+    /// Allocator used to create this node (16 bytes)
+    allocator: Allocator,
+
+    /// PACKED: 31-bit ref_count + 1-bit has_parent flag (4 bytes)
+    ///
+    /// This optimization saves 12 bytes per node vs separate fields.
+    /// - Bits 0-30: Reference count (max 2,147,483,647)
+    /// - Bit 31: has_parent flag (1 = has parent, 0 = no parent)
+    ///
+    /// The has_parent flag prevents premature destruction when:
+    /// - Node is in tree (parent owns it via strong reference)
+    /// - Node ref_count can drop to 0, but it's kept alive by parent
+    ref_count_and_parent: std.atomic.Value(u32),
+
+    /// Generation counter for detecting stale references (4 bytes)
+    /// Incremented whenever this node's child list changes, so bindings can
+    /// tell whether a cached children snapshot is still valid
+    /// Max 4,294,967,295 mutations (sufficient for long-lived pages)
+    generation: u32,
+
+    /// Unique node ID within document (2 bytes)
+    /// Used for equality checks and debugging
+    /// Max 65,535 nodes per document (sufficient for most pages)
+    node_id: u16,
+
+    /// Opaque wrapper slot for JavaScript engine embedders (4 bytes)
+    /// 0 = no wrapper. Owned entirely by the embedder (e.g. the V8 bindings
+    /// store an index into their per-isolate wrapper table here); the DOM
+    /// never interprets it and clones always start at 0. Nodes of shared
+    /// documents hold `shared_wrapper_slot`, which cannot be overwritten.
+    wrapper_slot: u32 = 0,
+
+    /// Number of ancestors in this node's tree (4 bytes)
+    /// 0 for nodes without a parent, including shadow roots; insertion and
+    /// removal shift a moved subtree's depths in one pass
+    /// (tree_helpers.setSubtreeDepth). Bounds the parent walks of
+    /// contains() and Range's common ancestor to the depth difference.
+    depth: u32 = 0,
+
+    // === Size and Layout Verification ===
+    // Node = EventTarget (8) + Node fields (100, padded to 104) = 112 bytes
     // This is acceptable for the prototype chain architecture
+    //
+    // Auto layout orders fields by alignment, keeping declaration order
+    // within an alignment, so the pointers come first: the EventTarget and
+    // node vtables, then the five tree links (bytes 16-56), then the cold
+    // pointers. The byte-sized node_type and flags end up in the tail with
+    // the other small fields; pinning them next to the links would need an
+    // 8-byte hole per node.
     comptime {
         const size = @sizeOf(Node);
-        if (size > 104) {
-            const msg = std.fmt.comptimePrint("Node size ({d} bytes) exceeded 104 byte limit!", .{size});
+        if (size > 112) {
+            const msg = std.fmt.comptimePrint("Node size ({d} bytes) exceeded 112 byte limit!", .{size});
             @compileError(msg);
         }
+
+        inline for ([_][]const u8{ "vtable", "parent_node", "previous_sibling", "first_child", "last_child", "next_sibling" }) |name| {
+            if (@offsetOf(Node, name) + @sizeOf(usize) > 64) {
+                const msg = std.fmt.comptimePrint("Node.{s} (offset {d}) left the first 64 bytes", .{ name, @offsetOf(Node, name) });
+                @compileError(msg);
+            }
+        }
     }
 
     // === Bit manipulation constants ===
@@ -537,6 +585,12 @@ pub const Node = struct {
     // === Flag bit positions ===
     pub const FLAG_IS_CONNECTED: u8 = 1 << 0;
     pub const FLAG_IS_IN_SHADOW_TREE: u8 = 1 << 1;
+    /// Owner document is shared between threads (see Document.share)
+    pub const FLAG_IS_SHARED: u8 = 1 << 2;
+
+    /// Wrapper slot of every node of a shared document: claimed, so no
+    /// single embedder cache can own it
+    pub const shared_wrapper_slot: u32 = std.math.maxInt(u32);
 
     // === Document position constants (WHATWG DOM §4.4) ===
     pub const DOCUMENT_POSITION_DISCONNECTED: u16 = 0x01;
@@ -589,7 +643,8 @@ pub const Node = struct {
         return node;
     }
 
-    /// Increments the reference count atomically.
+    /// Increments the reference count (atomically for nodes of shared
+    /// documents, see isShared).
     ///
     /// Call this when sharing ownership of the node.
     /// MUST be paired with a corresponding `release()` call.
@@ -601,7 +656,13 @@ pub const Node = struct {
     /// // Both must call release()
     /// ```
     pub fn acquire(self: *Node) void {
-        const old = self.ref_count_and_parent.fetchAdd(1, .monotonic);
+        const old = if (self.isShared())
+            self.ref_count_and_parent.fetchAdd(1, .monotonic)
+        else blk: {
+            const value = self.ref_count_and_parent.raw;
+            self.ref_count_and_parent.raw = value + 1;
+            break :blk value;
+        };
         const ref_count = old & REF_COUNT_MASK;
 
         // Safety: Check for overflow (extremely unlikely)
@@ -610,7 +671,8 @@ pub const Node = struct {
         }
     }
 
-    /// Decrements the reference count atomically.
+    /// Decrements the reference count (atomically for nodes of shared
+    /// documents, see isShared).
     ///
     /// When ref_count reaches 0 AND has_parent=false, the node is destroyed.
     /// MUST be called exactly once for each `acquire()` or `init()`.
@@ -621,7 +683,15 @@ pub const Node = struct {
     /// defer node.release(); // REQUIRED
     /// ```
     pub fn release(self: *Node) void {
-        const old = self.ref_count_and_parent.fetchSub(1, .monotonic);
+        // acq_rel: whichever thread drops the last reference sees every
+        // other thread's writes before destroying the node
+        const old = if (self.isShared())
+            self.ref_count_and_parent.fetchSub(1, .acq_rel)
+        else blk: {
+            const value = self.ref_count_and_parent.raw;
+            self.ref_count_and_parent.raw = value - 1;
+            break :blk value;
+        };
         const ref_count = old & REF_COUNT_MASK;
         const has_parent = (old & HAS_PARENT_BIT) != 0;
 
@@ -629,11 +699,13 @@ pub const Node = struct {
         // - ref_count reaches 0 (no external owners)
         // - AND has_parent=false (not owned by parent)
         if (ref_count == 1 and !has_parent) {
+            // Arena nodes are freed with their document
+            if (self.owner_document != self and isArenaDocument(self.owner_document)) return;
             self.vtable.deinit(self);
         }
     }
 
-    /// Sets the has_parent flag atomically.
+    /// Sets the has_parent flag.
     ///
     /// This flag prevents premature destruction when node is in tree.
     /// Parent-child relationship is STRONG (parent owns child).
@@ -641,10 +713,11 @@ pub const Node = struct {
     /// ## Parameters
     /// - `value`: true = has parent (in tree), false = no parent (detached)
     pub fn setHasParent(self: *Node, value: bool) void {
+        // Shared documents are frozen, so only teardown gets here for them
         if (value) {
-            _ = self.ref_count_and_parent.fetchOr(HAS_PARENT_BIT, .monotonic);
+            self.ref_count_and_parent.raw |= HAS_PARENT_BIT;
         } else {
-            _ = self.ref_count_and_parent.fetchAnd(~HAS_PARENT_BIT, .monotonic);
+            self.ref_count_and_parent.raw &= ~HAS_PARENT_BIT;
         }
     }
 
@@ -674,10 +747,24 @@ pub const Node = struct {
         }
     }
 
+    /// Returns true if the node belongs to a shared document, so its
+    /// reference count may change on several threads.
+    pub fn isShared(self: *const Node) bool {
+        return (self.flags & FLAG_IS_SHARED) != 0;
+    }
+
     pub fn isInShadowTree(self: *const Node) bool {
         return (self.flags & FLAG_IS_IN_SHADOW_TREE) != 0;
     }
 
+    pub fn setInShadowTree(self: *Node, value: bool) void {
+        if (value) {
+            self.flags |= FLAG_IS_IN_SHADOW_TREE;
+        } else {
+            self.flags &= ~FLAG_IS_IN_SHADOW_TREE;
+        }
+    }
+
     // === Polymorphic dispatch methods ===
 
     /// Returns the node name (delegates to vtable).
@@ -692,6 +779,8 @@ pub const Node = struct {
 
     /// Sets the node value (delegates to vtable).
     pub fn setNodeValue(self: *Node, value: []const u8) !void {
+        try self.checkMutable();
+
         // [CEReactions] scope for custom element lifecycle callbacks (Phase 5)
         // Note: setNodeValue is for Text/Comment nodes, not Elements
         // But [CEReactions] scope is required per spec
@@ -751,8 +840,9 @@ pub const Node = struct {
             return null;
         }
 
-        // Step 2: If Text, ProcessingInstruction, or Comment, return data
+        // Step 2: If CharacterData (Text, CDATASection, ProcessingInstruction, Comment), return data
         if (self.node_type == .text or
+            self.node_type == .cdata_section or
             self.node_type == .processing_instruction or
             self.node_type == .comment)
         {
@@ -783,9 +873,16 @@ pub const Node = struct {
     /// Performs "string replace all" algorithm:
     /// 1. Let string be the given value (or empty string if null)
     /// 2. If node is Document or DocumentType: do nothing
-    /// 3. If node is Text, ProcessingInstruction, or Comment: replace node's data
+    /// 3. If node is Attr: set an existing attribute value (its element's
+    ///    attribute changes too); if Text, ProcessingInstruction, or
+    ///    Comment: replace node's data
     /// 4. Otherwise: remove all children and insert a Text node (if string non-empty)
     ///
+    /// Deviation, only in documents that enable it (see
+    /// Document.enableInPlaceTextContent): a non-empty string replaces the
+    /// data of a sole Text child in place (one characterData record)
+    /// instead of replacing the child.
+    ///
     /// ## Parameters
     /// - `value`: New text content (null or empty removes all children)
     ///
@@ -803,6 +900,8 @@ pub const Node = struct {
     /// try elem.prototype.setTextContent(null); // Removes all children
     /// ```
     pub fn setTextContent(self: *Node, value: ?[]const u8) !void {
+        try self.checkMutable();
+
         // [CEReactions] scope for custom element lifecycle callbacks (Phase 5)
         const doc_node = self.owner_document orelse self;
         const is_document = doc_node.node_type == .document;
@@ -829,14 +928,30 @@ pub const Node = struct {
             return;
         }
 
-        // Step 2: If Text, ProcessingInstruction, or Comment, set data
-        if (self.node_type == .text or
+        // Step 2: Attr sets an existing attribute value, CharacterData
+        // (Text, CDATASection, ProcessingInstruction, Comment) sets its data
+        if (self.node_type == .attribute or
+            self.node_type == .text or
+            self.node_type == .cdata_section or
             self.node_type == .processing_instruction or
             self.node_type == .comment)
         {
             return self.setNodeValue(string);
         }
 
+        // Opt-in fast path (see Document.enableInPlaceTextContent): a sole
+        // Text child takes the new data in place. Observers get one
+        // characterData record instead of a childList record.
+        if (string.len > 0 and inPlaceTextContent(self)) {
+            if (self.first_child) |child| {
+                if (child == self.last_child and child.node_type == .text) {
+                    const Text = @import("text.zig").Text;
+                    const text: *Text = @fieldParentPtr("prototype", child);
+                    return character_data.replaceBytes(text, 0, text.data.len, string);
+                }
+            }
+        }
+
         // Step 3: String replace all (for Element, DocumentFragment, etc.)
         // Remove all children (using removeChild to fire disconnected callbacks)
         while (self.first_child) |child| {
@@ -858,8 +973,15 @@ pub const Node = struct {
             // Insert the text node directly (bypass validation for efficiency)
             text_node.prototype.parent_node = self;
             text_node.prototype.setHasParent(true);
+            text_node.prototype.depth = self.depth + 1;
             self.first_child = &text_node.prototype;
             self.last_child = &text_node.prototype;
+            self.generation += 1;
+            self.noteMutation();
+            @import("slot_map.zig").nodeInserted(self, &text_node.prototype);
+            if (@import("shadow_index.zig").containingShadowRoot(self)) |shadow| {
+                @import("shadow_index.zig").subtreeInserted(shadow, &text_node.prototype);
+            }
 
             // Propagate connected state if parent is connected
             if (self.isConnected()) {
@@ -868,6 +990,15 @@ pub const Node = struct {
         }
     }
 
+    /// True if `node`'s document opted into the in-place textContent path.
+    fn inPlaceTextContent(node: *const Node) bool {
+        const doc_node = node.owner_document orelse return false;
+        if (doc_node.node_type != .document) return false;
+        const Document = @import("document.zig").Document;
+        const doc: *const Document = @fieldParentPtr("prototype", doc_node);
+        return doc.in_place_text_content;
+    }
+
     /// Clones the node (delegates to vtable).
     pub fn cloneNode(self: *const Node, deep: bool) !*Node {
         return self.vtable.clone_node(self, deep);
@@ -1014,6 +1145,11 @@ pub const Node = struct {
     ///   - Node in document → Returns document
     ///   - Handles nested shadow roots (traverses all levels)
     ///
+    /// ## Performance
+    /// O(1) for connected nodes, whose shadow-including root is their node
+    /// document: the connected and in-shadow-tree flags kept by insertion
+    /// and removal say whether that is the answer. Other nodes walk up.
+    ///
     /// ## Parameters
     /// - `composed`: If true, pierces shadow boundaries (default: false)
     ///
@@ -1043,6 +1179,12 @@ pub const Node = struct {
         const ShadowRoot = @import("shadow_root.zig").ShadowRoot;
         const Element = @import("element.zig").Element;
 
+        // Connected nodes outside shadow trees (or any connected node, when
+        // composed) have their node document as root
+        if (self.isConnected() and (composed or (self.node_type != .shadow_root and !self.isInShadowTree()))) {
+            if (self.owner_document) |doc| return doc;
+        }
+
         // Step 1: Start with self
         var root: *Node = @constCast(self);
 
@@ -1114,14 +1256,13 @@ pub const Node = struct {
         // If other is this, return true (inclusive)
         if (other_node == self) return true;
 
-        // Walk up from other looking for self
-        var current = other_node.parent_node;
-        while (current) |parent| {
-            if (parent == self) return true;
-            current = parent.parent_node;
-        }
+        // Descendants are deeper
+        if (other_node.depth <= self.depth) return false;
 
-        return false;
+        if (document_order.relation(self, other_node)) |relation| return relation == .ancestor;
+
+        // Climb from other to self's depth
+        return tree_helpers.ancestorAtDepth(other_node, self.depth) == self;
     }
 
     /// Returns the base URI of this node.
@@ -1425,6 +1566,15 @@ pub const Node = struct {
         // Step 1: If this is other, return 0
         if (self == other) return 0;
 
+        // Indexed documents answer without walking (see document_order.zig)
+        if (document_order.relation(other, self)) |relation| return switch (relation) {
+            .equal => 0,
+            .ancestor => DOCUMENT_POSITION_CONTAINS | DOCUMENT_POSITION_PRECEDING,
+            .descendant => DOCUMENT_POSITION_CONTAINED_BY | DOCUMENT_POSITION_FOLLOWING,
+            .before => DOCUMENT_POSITION_PRECEDING,
+            .after => DOCUMENT_POSITION_FOLLOWING,
+        };
+
         // Step 2: Get roots
         const this_root = self.getRootNode(false);
         const other_root = other.getRootNode(false);
@@ -1580,6 +1730,16 @@ pub const Node = struct {
         // Check node types match
         if (self.node_type != other_node.node_type) return false;
 
+        // Differing structural hashes prove inequality without the walk
+        // (only when both documents cache them; allocation failure falls back)
+        if (self.structuralHashes()) |this_hashes| {
+            if (other_node.structuralHashes()) |other_hashes| {
+                const this_hash = this_hashes.get(self) catch null;
+                const other_hash = other_hashes.get(other_node) catch null;
+                if (this_hash != null and other_hash != null and this_hash.? != other_hash.?) return false;
+            }
+        }
+
         // Per WHATWG DOM § 4.2.2: Check type-specific properties
         switch (self.node_type) {
             .document_type => {
@@ -1743,6 +1903,85 @@ pub const Node = struct {
         return null;
     }
 
+    /// Bumps the mutation version of the node's document (or of the node
+    /// itself, for a Document).
+    ///
+    /// Called on every child list and attribute change, next to the
+    /// per-node `generation` bump. Nodes without a document are ignored.
+    /// Also drops the node's cached matches() answers, which its attribute
+    /// changes may have changed (see match_cache.zig).
+    pub fn noteMutation(self: *Node) void {
+        const doc_node = self.owner_document orelse self;
+        if (doc_node.node_type != .document) return;
+
+        const Document = @import("document.zig").Document;
+        const doc: *Document = @fieldParentPtr("prototype", doc_node);
+        doc.mutation_version +%= 1;
+        if (doc.structural_hashes) |hashes| hashes.invalidate(self);
+        if (doc.match_cache) |cache| cache.forget(self);
+    }
+
+    /// Drops the cached structural hashes of the node and its ancestors
+    /// (see Document.enableStructuralHashes).
+    ///
+    /// noteMutation() does this for child list and attribute changes;
+    /// character data changes, which bump no mutation version, call it
+    /// directly.
+    pub fn invalidateHashes(self: *Node) void {
+        const hashes = self.structuralHashes() orelse return;
+        hashes.invalidate(self);
+    }
+
+    /// Drops the node's id from its document's node table (see
+    /// Document.nodeId), for node types that are destroyed without
+    /// releasing a document node reference.
+    pub fn dropNodeId(self: *const Node) void {
+        const doc_node = self.owner_document orelse return;
+        if (doc_node.node_type != .document) return;
+
+        const Document = @import("document.zig").Document;
+        const doc: *const Document = @fieldParentPtr("prototype", doc_node);
+        if (doc.node_table) |table| table.forget(self);
+    }
+
+    fn structuralHashes(self: *const Node) ?*@import("structural_hash.zig").StructuralHashes {
+        const doc_node = self.owner_document orelse self;
+        if (doc_node.node_type != .document) return null;
+
+        const Document = @import("document.zig").Document;
+        const doc: *const Document = @fieldParentPtr("prototype", doc_node);
+        return doc.structural_hashes;
+    }
+
+    /// Returns a 64-bit fingerprint of the node's subtree.
+    ///
+    /// Covers exactly what isEqualNode() compares (type, names, attributes
+    /// in any order, data and the children in order), so equal nodes have
+    /// equal hashes and a differing hash proves the nodes differ. Equal
+    /// hashes are very likely, but not certain, to mean equal nodes.
+    /// Cached per node when the document enables structural hashes;
+    /// otherwise the subtree is walked on every call.
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to allocate the walk state or cache
+    pub fn structuralHash(self: *const Node) Allocator.Error!u64 {
+        const StructuralHashes = @import("structural_hash.zig").StructuralHashes;
+        if (self.structuralHashes()) |hashes| return hashes.get(self);
+        return StructuralHashes.compute(self.allocator, self);
+    }
+
+    /// Fails with `error.NoModificationAllowedError` when the node's
+    /// document (or the node itself, for a Document) is frozen (see
+    /// Document.freeze). Nodes without a document are always mutable.
+    pub fn checkMutable(self: *const Node) error{NoModificationAllowedError}!void {
+        const doc_node = self.owner_document orelse self;
+        if (doc_node.node_type != .document) return;
+
+        const Document = @import("document.zig").Document;
+        const doc: *const Document = @fieldParentPtr("prototype", doc_node);
+        return doc.checkMutable();
+    }
+
     /// Returns a live NodeList of child nodes.
     ///
     /// Implements WHATWG DOM Node.childNodes property.
@@ -1959,6 +2198,7 @@ pub const Node = struct {
         node.next_sibling = null;
         node.parent_node = self;
         node.setHasParent(true);
+        tree_helpers.setSubtreeDepth(node, self.depth + 1);
 
         if (last) |l| {
             l.next_sibling = node;
@@ -1966,6 +2206,12 @@ pub const Node = struct {
             self.first_child = node;
         }
         self.last_child = node;
+        self.generation += 1;
+        self.noteMutation();
+
+        // Shadow trees keep their own indices instead of the document maps
+        const shadow = @import("shadow_index.zig").containingShadowRoot(self);
+        if (shadow) |s| @import("shadow_index.zig").subtreeInserted(s, node);
 
         // Set connected state if parent is connected
         if (self.isConnected()) {
@@ -1973,10 +2219,10 @@ pub const Node = struct {
             // Propagate to descendants
             tree_helpers.setDescendantsConnected(node, true);
 
-            // Update document maps (id_map, tag_map) for newly connected elements
+            // Update document maps (id_map, tag_index) for newly connected elements
             // This must happen AFTER setConnected() so isConnected() returns true
             if (self.owner_document) |owner_doc| {
-                if (owner_doc.node_type == .document) {
+                if (owner_doc.node_type == .document and shadow == null) {
                     try addNodeToDocumentMaps(node, owner_doc);
                 }
             }
@@ -1984,21 +2230,9 @@ pub const Node = struct {
 
         // Slot assignment for fast path (WHATWG DOM §4.2.4 step 7.4)
         // If parent is a shadow host whose shadow root's slot assignment is "named"
-        // and node is a slottable, then assign a slot for node.
-        if (self.node_type == .element) {
-            const Element = @import("element.zig").Element;
-            if (self.rare_data) |rare_data| {
-                if (rare_data.shadow_root) |shadow_ptr| {
-                    const ShadowRoot = @import("shadow_root.zig").ShadowRoot;
-                    const shadow: *const ShadowRoot = @ptrCast(@alignCast(shadow_ptr));
-                    if (shadow.slot_assignment == .named) {
-                        if (node.node_type == .element or node.node_type == .text) {
-                            Element.assignASlot(node.allocator, node) catch {};
-                        }
-                    }
-                }
-            }
-        }
+        // and node is a slottable, then assign a slot for node (and keep the
+        // shadow root's slot caches current).
+        @import("slot_map.zig").nodeInserted(self, node);
 
         // Queue mutation record for childList mutations
         var nodes_array = [_]*Node{node};
@@ -2151,11 +2385,24 @@ pub const Node = struct {
     /// ## Spec Notes
     /// Empty text nodes are removed before merging. Adjacent text nodes are merged
     /// left-to-right, with the leftmost node retaining the merged data.
+    ///
+    /// Each run of adjacent text nodes is merged in one pass: the data of
+    /// the run is summed and appended with one allocation, and the merged
+    /// nodes are unlinked together. Observers get one characterData record
+    /// for the kept node (old value: its data before the merge) and one
+    /// childList record listing the whole run, instead of one pair per
+    /// merged node.
     pub fn normalize(self: *Node) !void {
+        try self.checkMutable();
+
         // [CEReactions] scope for custom element lifecycle callbacks (Phase 5)
         const doc_node = self.owner_document orelse self;
         const is_document = doc_node.node_type == .document;
 
+        // The adjacent text nodes of the run being merged (reused for every run)
+        var run: std.ArrayListUnmanaged(*Node) = .{};
+        defer run.deinit(self.allocator);
+
         if (is_document) {
             const Document = @import("document.zig").Document;
             const doc: *Document = @fieldParentPtr("prototype", doc_node);
@@ -2163,13 +2410,13 @@ pub const Node = struct {
             try stack.enter();
             defer stack.leave();
 
-            return try normalizeImpl(self);
+            return try normalizeImpl(self, &run);
         } else {
-            return try normalizeImpl(self);
+            return try normalizeImpl(self, &run);
         }
     }
 
-    fn normalizeImpl(self: *Node) !void {
+    fn normalizeImpl(self: *Node, run: *std.ArrayListUnmanaged(*Node)) !void {
         const Text = @import("text.zig").Text;
 
         var current = self.first_child;
@@ -2188,44 +2435,59 @@ pub const Node = struct {
                     continue;
                 }
 
-                // Step 2: Merge adjacent text nodes
+                // Step 2: Collect the adjacent text nodes and their total length
+                run.clearRetainingCapacity();
+                var total: usize = 0;
                 var adjacent = next;
-                while (adjacent) |adj_node| {
-                    // Stop if not a text node
+                while (adjacent) |adj_node| : (adjacent = adj_node.next_sibling) {
                     if (adj_node.node_type != .text) break;
-
                     const adj_text: *Text = @fieldParentPtr("prototype", adj_node);
-                    const adj_next = adj_node.next_sibling;
-
-                    // Merge data: concatenate adj_text.data into text_node.data
-                    const new_data = try std.mem.concat(
-                        node.allocator,
-                        u8,
-                        &[_][]const u8{ text_node.data, adj_text.data },
-                    );
-
-                    // Free old data and update
-                    node.allocator.free(text_node.data);
-                    text_node.data = new_data;
+                    try run.append(self.allocator, adj_node);
+                    total += adj_text.data.len;
+                }
+                if (run.items.len == 0) {
+                    current = next;
+                    continue;
+                }
 
-                    // Remove the merged node and release it
-                    // Note: adj_node is a sibling, so remove from parent (self)
-                    const removed = try self.removeChild(adj_node);
-                    removed.release(); // Free the merged text node
+                // Step 3: Append their data with one allocation
+                if (total > 0) {
+                    const old_value: ?[]u8 = if (hasMutationObservers(node))
+                        try self.allocator.dupe(u8, text_node.data)
+                    else
+                        null;
+                    defer if (old_value) |value| self.allocator.free(value);
+
+                    var merged_at = text_node.data.len;
+                    var tail = try character_data.growData(text_node, total);
+                    for (run.items) |adj_node| {
+                        const adj_text: *Text = @fieldParentPtr("prototype", adj_node);
+                        @memcpy(tail[0..adj_text.data.len], adj_text.data);
+                        tail = tail[adj_text.data.len..];
+                        range_mod.textMerged(node, adj_node, merged_at);
+                        merged_at += adj_text.data.len;
+                    }
+                    node.generation += 1;
+                    node.invalidateHashes();
 
-                    // Continue to next adjacent sibling
-                    adjacent = adj_next;
+                    if (old_value) |value| {
+                        queueMutationRecord(node, "characterData", null, null, null, null, null, null, value) catch {}; // Best effort
+                    }
+                } else {
+                    for (run.items) |adj_node| range_mod.textMerged(node, adj_node, text_node.data.len);
                 }
 
-                // After merging, the current text node's next_sibling is now correct
-                // Skip to it to avoid processing merged nodes
+                // Step 4: Remove the merged nodes at once and release them
+                removeRun(self, run.items);
+                for (run.items) |adj_node| adj_node.release();
+
                 current = node.next_sibling;
                 continue;
             }
 
-            // Step 3: Recursively normalize child elements
+            // Step 5: Recursively normalize child elements
             if (node.node_type == .element or node.node_type == .document_fragment) {
-                try normalizeImpl(node);
+                try normalizeImpl(node, run);
             }
 
             current = next;
@@ -2246,7 +2508,16 @@ pub const Node = struct {
     pub fn ensureRareData(self: *Node) !*NodeRareData {
         if (self.rare_data == null) {
             const rare = try self.allocator.create(NodeRareData);
+            errdefer self.allocator.destroy(rare);
             rare.* = NodeRareData.init(self.allocator);
+
+            // Arena nodes are never deinitialized; their document runs
+            // the rare data hooks when it goes away
+            if (self.owner_document != self and isArenaDocument(self.owner_document)) {
+                const Document = @import("document.zig").Document;
+                const doc: *Document = @fieldParentPtr("prototype", self.owner_document.?);
+                try doc.arena_rare_nodes.append(doc.prototype.allocator, self);
+            }
             self.rare_data = rare;
         }
         return self.rare_data.?;
@@ -2262,12 +2533,62 @@ pub const Node = struct {
         return self.rare_data != null;
     }
 
+    /// Returns the bytes this node holds by itself: its struct, character
+    /// data, attribute storage and rare data. Children and strings in the
+    /// document's string pool are not included, so summing over a subtree
+    /// gives what freeing the subtree releases; a document counts its
+    /// string pool and indices instead.
+    ///
+    /// Used to attribute DOM memory in heap snapshots. O(1).
+    pub fn selfBytes(self: *const Node) usize {
+        const rare_bytes: usize = if (self.rare_data != null) @sizeOf(NodeRareData) else 0;
+        return rare_bytes + switch (self.node_type) {
+            .element => blk: {
+                const Element = @import("element.zig").Element;
+                const elem: *const Element = @fieldParentPtr("prototype", self);
+                break :blk @sizeOf(Element) + elem.attributes.array.heapBytes();
+            },
+            .text, .cdata_section, .processing_instruction => blk: {
+                const Text = @import("text.zig").Text;
+                const text: *const Text = @fieldParentPtr("prototype", self);
+                const data_bytes = character_data.buffer(text).len;
+                break :blk data_bytes + switch (self.node_type) {
+                    .cdata_section => @sizeOf(@import("cdata_section.zig").CDATASection),
+                    .processing_instruction => target: {
+                        const ProcessingInstruction = @import("processing_instruction.zig").ProcessingInstruction;
+                        const pi: *const ProcessingInstruction = @fieldParentPtr("prototype", text);
+                        break :target @sizeOf(ProcessingInstruction) + pi.target.len;
+                    },
+                    else => @sizeOf(Text),
+                };
+            },
+            .comment => blk: {
+                const Comment = @import("comment.zig").Comment;
+                const comment: *const Comment = @fieldParentPtr("prototype", self);
+                break :blk @sizeOf(Comment) + character_data.buffer(comment).len;
+            },
+            .attribute => @sizeOf(@import("attr.zig").Attr),
+            .document => blk: {
+                // The string pool and indices: every node of the document
+                // refers into them, and they live as long as it does
+                const Document = @import("document.zig").Document;
+                const doc: *const Document = @fieldParentPtr("prototype", self);
+                break :blk @sizeOf(Document) + doc.string_pool.bytes +
+                    doc.id_map.count() * (@sizeOf([]const u8) + @sizeOf(*@import("element.zig").Element));
+            },
+            .document_type => @sizeOf(@import("document_type.zig").DocumentType),
+            .document_fragment => @sizeOf(@import("document_fragment.zig").DocumentFragment),
+            .shadow_root => @sizeOf(@import("shadow_root.zig").ShadowRoot),
+        };
+    }
+
     /// Frees rare data if allocated.
     ///
     /// Called during node cleanup by vtable deinit implementations.
     /// PUBLIC for Element/Text/Comment/Document to call.
     pub fn deinitRareData(self: *Node) void {
         if (self.rare_data) |rare| {
+            if (rare.getLiveRanges().len > 0) range_mod.containerDestroyed(self);
             rare.deinit();
             self.allocator.destroy(rare);
             self.rare_data = null;
@@ -2481,13 +2802,15 @@ pub const Node = struct {
     /// - Index 0: target node
     /// - Index 1..n: ancestors up to root
     /// - Crosses shadow boundaries if event.composed = true
-    fn buildEventPath(allocator: Allocator, target: *Node, event: *Event) !void {
-        // Initialize event path directly
-        event.event_path = std.ArrayList(*anyopaque){};
+    ///
+    /// Returns the union of the path nodes' listener type bitmaps.
+    fn buildEventPath(allocator: Allocator, target: *Node, event: *Event) !u64 {
+        // Fill the (empty) path buffer set up by dispatchEvent
         var path = &event.event_path.?;
 
         // Add target
         try path.append(allocator, @ptrCast(target));
+        var listener_types = listenerTypes(target);
 
         // Walk up to root, crossing shadow boundaries if composed
         var current: ?*Node = target;
@@ -2502,11 +2825,20 @@ pub const Node = struct {
 
             if (parent) |p| {
                 try path.append(allocator, @ptrCast(p));
+                listener_types |= listenerTypes(p);
                 current = p;
             } else {
                 break;
             }
         }
+
+        return listener_types;
+    }
+
+    /// Listener type bitmap of a node, both phases.
+    fn listenerTypes(node: *const Node) u64 {
+        const rare = node.rare_data orelse return 0;
+        return rare.capture_types | rare.bubble_types;
     }
 
     /// Invokes event listeners on a node for the current phase.
@@ -2516,13 +2848,27 @@ pub const Node = struct {
     /// - `event`: Event being dispatched
     /// - `capture`: true for capture phase listeners, false for bubble phase
     /// - `original_target`: The original event target (for retargeting)
-    fn invokeListeners(node: *Node, event: *Event, capture: bool, original_target: *Node) !void {
-        if (node.rare_data == null) return;
-        const rare = node.rare_data.?;
+    /// - `type_bit`: `eventTypeBit()` of the event type
+    fn invokeListeners(node: *Node, event: *Event, capture: bool, original_target: *Node, type_bit: u64) !void {
+        const rare = node.rare_data orelse return;
 
+        // Bitmap check first: most path nodes have no listener of this type
+        if (!rare.mayHaveEventListeners(type_bit, capture)) return;
         if (!rare.hasEventListeners(event.event_type)) return;
 
-        const listeners = rare.getEventListeners(event.event_type);
+        // Listeners may add or remove listeners while they run, so iterate
+        // a copy of the list ("clone listeners" in the spec). Short lists,
+        // the common case, are copied to the stack.
+        const registered = rare.getEventListeners(event.event_type);
+        var inline_copy: [8]EventListener = undefined;
+        const heap_copy = registered.len > inline_copy.len;
+        const listeners = if (heap_copy)
+            try node.allocator.dupe(EventListener, registered)
+        else blk: {
+            @memcpy(inline_copy[0..registered.len], registered);
+            break :blk inline_copy[0..registered.len];
+        };
+        defer if (heap_copy) node.allocator.free(listeners);
 
         // Retarget the event for this node's listeners
         const retargeted = retargetNode(original_target, node);
@@ -2536,14 +2882,16 @@ pub const Node = struct {
             // Check stopImmediatePropagation
             if (event.stop_immediate_propagation_flag) break;
 
-            // Handle "once" listeners - remove before invoking
+            // Skip listeners an earlier listener removed (already released)
+            if (!rare.containsEventListener(event.event_type, listener.callback, listener.context, listener.capture)) {
+                continue;
+            }
+
+            // Handle "once" listeners - remove before invoking, release after
             if (listener.once) {
-                node.removeEventListener(
-                    listener.event_type,
-                    listener.callback,
-                    listener.capture,
-                );
+                _ = rare.takeEventListener(event.event_type, listener.callback, listener.context, listener.capture);
             }
+            defer if (listener.once) listener.release();
 
             // Set passive listener flag
             const prev_passive = event.in_passive_listener_flag;
@@ -2574,16 +2922,36 @@ pub const Node = struct {
         // Set flags
         event.is_trusted = false;
         event.dispatch_flag = true;
+        event.dispatch_id +%= 1;
 
         // Build event path (capture phase ancestors + target + bubble phase ancestors)
-        try buildEventPath(self.allocator, self, event);
-        defer event.clearEventPath(self.allocator);
+        // in the document's recycled path buffer, so steady-state dispatch
+        // allocates nothing for it
+        const Document = @import("document.zig").Document;
+        const doc_node = self.owner_document orelse self;
+        const doc: ?*Document = if (doc_node.node_type == .document) @fieldParentPtr("prototype", doc_node) else null;
+        const path_allocator = if (doc) |d| d.prototype.allocator else self.allocator;
+
+        event.event_path = if (doc) |d| d.takeEventPath() else .{};
+        defer {
+            var path = event.event_path.?;
+            event.event_path = null;
+            if (doc) |d| d.recycleEventPath(path) else path.deinit(path_allocator);
+        }
+        const type_bit = eventTypeBit(event.event_type);
+        const path_types = try buildEventPath(path_allocator, self, event);
 
         const event_path = event.event_path.?;
 
         // Original target (never changes)
         event.target = @ptrCast(self);
 
+        // No node on the path listens for this type: nothing to invoke
+        if (path_types & type_bit == 0) {
+            event.dispatch_flag = false;
+            return !event.canceled_flag;
+        }
+
         // Phase 1: CAPTURING_PHASE - Walk down from root to target
         event.event_phase = .capturing_phase;
         var i: usize = event_path.items.len;
@@ -2595,7 +2963,7 @@ pub const Node = struct {
             if (current_node == self) continue;
 
             event.current_target = @ptrCast(current_node);
-            try invokeListeners(current_node, event, true, self); // capture = true
+            try invokeListeners(current_node, event, true, self, type_bit); // capture = true
 
             if (event.stop_propagation_flag) break;
         }
@@ -2606,9 +2974,9 @@ pub const Node = struct {
             event.current_target = @ptrCast(self);
 
             // Fire both capture and bubble listeners at target
-            try invokeListeners(self, event, true, self); // capture listeners
+            try invokeListeners(self, event, true, self, type_bit); // capture listeners
             if (!event.stop_propagation_flag) {
-                try invokeListeners(self, event, false, self); // bubble listeners
+                try invokeListeners(self, event, false, self, type_bit); // bubble listeners
             }
         }
 
@@ -2620,7 +2988,7 @@ pub const Node = struct {
                 const current_node = @as(*Node, @ptrCast(@alignCast(event_path.items[i])));
 
                 event.current_target = @ptrCast(current_node);
-                try invokeListeners(current_node, event, false, self); // capture = false
+                try invokeListeners(current_node, event, false, self, type_bit); // capture = false
 
                 if (event.stop_propagation_flag) break;
             }
@@ -2644,6 +3012,9 @@ const tree_helpers = @import("tree_helpers.zig");
 const MutationRecord = @import("mutation_observer.zig").MutationRecord;
 const MutationObserver = @import("mutation_observer.zig").MutationObserver;
 const MutationObserverRegistration = @import("mutation_observer.zig").MutationObserverRegistration;
+const range_mod = @import("range.zig");
+const node_iterator_mod = @import("node_iterator.zig");
+const document_order = @import("document_order.zig");
 
 /// Adopt a node into a document per WHATWG DOM §4.2.4.
 ///
@@ -2669,9 +3040,14 @@ const MutationObserverRegistration = @import("mutation_observer.zig").MutationOb
 ///
 /// PUBLIC for Document.adoptNode() to call.
 pub fn adopt(node: *Node, document: *Node) !void {
+    try node.checkMutable();
+    try document.checkMutable();
+
     // Step 1: Get old document
     const old_document = node.owner_document;
 
+    if (old_document != document) try checkArenaAdoption(node, old_document, document);
+
     // Step 2: If node has a parent, remove it
     if (node.parent_node) |_| {
         remove(node);
@@ -2682,6 +3058,24 @@ pub fn adopt(node: *Node, document: *Node) !void {
         return;
     }
 
+    // The subtree's names and values move to the new document's string
+    // pool through one table for the whole subtree, unless they already
+    // live there (adoption from a document into its fork)
+    const Document = @import("document.zig").Document;
+    const StringRemap = @import("document.zig").StringRemap;
+    var remap: ?StringRemap = null;
+    if (document.node_type == .document) {
+        const new_doc: *Document = @fieldParentPtr("prototype", document);
+        const shared = blk: {
+            const old_doc = old_document orelse break :blk false;
+            if (old_doc.node_type != .document) break :blk false;
+            const old_doc_ptr: *Document = @fieldParentPtr("prototype", old_doc);
+            break :blk new_doc.string_pool.inherits(&old_doc_ptr.string_pool);
+        };
+        if (!shared) remap = StringRemap.init(new_doc.string_pool.allocator, &new_doc.string_pool);
+    }
+    defer if (remap) |*r| r.deinit();
+
     // Step 4: For each inclusive descendant (node + descendants)
     // We'll use a simple stack-based traversal to avoid recursion
     var stack: [256]*Node = undefined;
@@ -2699,20 +3093,19 @@ pub fn adopt(node: *Node, document: *Node) !void {
         // Update document reference counts
         if (old_owner) |old_doc| {
             if (old_doc.node_type == .document) {
-                const Document = @import("document.zig").Document;
                 const old_doc_ptr: *Document = @fieldParentPtr("prototype", old_doc);
-                old_doc_ptr.releaseNodeRef();
+                old_doc_ptr.releaseNodeRef(current);
             }
         }
 
         if (document.node_type == .document) {
-            const Document = @import("document.zig").Document;
             const new_doc: *Document = @fieldParentPtr("prototype", document);
             new_doc.acquireNodeRef();
         }
 
         // Call adopting steps for this node
         try current.vtable.adopting_steps(current, old_owner);
+        if (remap) |*r| try remapStrings(current, r);
 
         // Add children to stack (process in reverse order to maintain tree order)
         var child = current.last_child;
@@ -2726,36 +3119,93 @@ pub fn adopt(node: *Node, document: *Node) !void {
             child = c.previous_sibling;
         }
     }
+
+    // Iterators rooted in the subtree follow it to the new document
+    if (old_document) |old_doc| {
+        if (old_doc.node_type == .document) {
+            const old_doc_ptr: *Document = @fieldParentPtr("prototype", old_doc);
+            const new_doc: ?*Document = if (document.node_type == .document) @as(*Document, @fieldParentPtr("prototype", document)) else null;
+            try node_iterator_mod.nodesAdopted(old_doc_ptr, new_doc);
+        }
+    }
+}
+
+/// Moves the interned strings of `node` (not its descendants) to the
+/// destination pool of `remap`.
+fn remapStrings(node: *Node, remap: *@import("document.zig").StringRemap) !void {
+    switch (node.node_type) {
+        .element => {
+            const Element = @import("element.zig").Element;
+            const elem: *Element = @fieldParentPtr("prototype", node);
+            try elem.remapStrings(remap);
+        },
+        .attribute => {
+            const Attr = @import("attr.zig").Attr;
+            const attr: *Attr = @fieldParentPtr("node", node);
+            attr.local_name = try remap.string(attr.local_name);
+            attr.namespace_uri = try remap.optional(attr.namespace_uri);
+            attr.prefix = try remap.optional(attr.prefix);
+        },
+        // Character data is owned by its node
+        else => {},
+    }
+}
+
+/// True if `document` is a document created with Document.initWithArena().
+fn isArenaDocument(document: ?*const Node) bool {
+    const doc_node = document orelse return false;
+    if (doc_node.node_type != .document) return false;
+    const Document = @import("document.zig").Document;
+    const doc: *const Document = @fieldParentPtr("prototype", doc_node);
+    return doc.arena_mode;
+}
+
+/// Arena documents own the memory of their nodes, so a node only moves
+/// into or out of one if it was allocated for the target document (as
+/// importNode() copies are). Anything else must be copied.
+fn checkArenaAdoption(node: *const Node, old_document: ?*const Node, document: *Node) !void {
+    if (document.node_type != .document) return;
+    const Document = @import("document.zig").Document;
+    const target: *Document = @fieldParentPtr("prototype", document);
+    if (!target.arena_mode and !isArenaDocument(old_document)) return;
+    const expected = target.nodeAllocator();
+    if (node.allocator.vtable != expected.vtable or node.allocator.ptr != expected.ptr) {
+        return error.NotSupportedError;
+    }
 }
 
-/// Recursively adds a node and its descendants to document maps (id_map, tag_map).
+/// Recursively adds a node and its descendants to document maps (id_map, tag_index).
 /// Called after a node tree is inserted and connected.
 /// This matches browser behavior where maps are updated during tree mutations, not setAttribute.
 fn addNodeToDocumentMaps(node: *Node, owner_doc: *Node) !void {
     const Document = @import("document.zig").Document;
     const doc: *Document = @fieldParentPtr("prototype", owner_doc);
 
+    // Numbered by the next build of the order index
+    if (doc.order_index) |index| {
+        index.unnumbered = true;
+    }
+
     // Handle this node if it's an element
     if (node.node_type == .element) {
         const Element = @import("element.zig").Element;
         const elem: *Element = @fieldParentPtr("prototype", node);
 
-        // Add to id_map if element has an id (only if ID not already present - first wins)
+        // Add to id index if element has an id (kept in tree order)
         if (elem.getId()) |id| {
-            const result = try doc.id_map.getOrPut(id);
-            if (!result.found_existing) {
-                result.value_ptr.* = elem;
-                doc.invalidateIdCache();
-            }
+            try doc.id_map.add(&doc.string_pool, id, elem);
+            doc.invalidateIdCache();
         }
 
-        // Add to tag_map
-        const tag = elem.tag_name;
-        const result = try doc.tag_map.getOrPut(tag);
-        if (!result.found_existing) {
-            result.value_ptr.* = .{};
+        // Add to class index if enabled
+        if (doc.class_index) |index| {
+            if (elem.getAttribute("class")) |class_value| {
+                try index.addTokens(&doc.string_pool, class_value, elem);
+            }
         }
-        try result.value_ptr.append(doc.prototype.allocator, elem);
+
+        // Add to tag index (only tags that have been queried have a bucket)
+        try doc.tag_index.add(elem);
 
         // NOTE: We deliberately don't update class_map here
         // This will be removed in Phase 3 when we switch to tree traversal for classes
@@ -2769,56 +3219,37 @@ fn addNodeToDocumentMaps(node: *Node, owner_doc: *Node) !void {
     }
 }
 
-/// Recursively removes a node and its descendants from document maps (id_map, tag_map).
+/// Recursively removes a node and its descendants from document maps (id_map, tag_index).
 /// Called after a node tree is removed and disconnected.
-fn removeNodeFromDocumentMaps(node: *Node, owner_doc: *Node) void {
+pub fn removeNodeFromDocumentMaps(node: *Node, owner_doc: *Node) void {
     const Document = @import("document.zig").Document;
     const doc: *Document = @fieldParentPtr("prototype", owner_doc);
 
+    // Its tree-order number is no longer valid
+    if (doc.order_index) |index| {
+        index.forget(node);
+    }
+
     // Handle this node if it's an element
     if (node.node_type == .element) {
         const Element = @import("element.zig").Element;
         const elem: *Element = @fieldParentPtr("prototype", node);
 
-        // Remove from id_map if element has an id and is the one in the map
+        // Remove from id index; the next element with the same id takes over
         if (elem.getId()) |id| {
-            if (doc.id_map.get(id)) |mapped_elem| {
-                if (mapped_elem == elem) {
-                    _ = doc.id_map.remove(id);
-                    doc.invalidateIdCache();
-
-                    // Search for another element with the same ID to replace it
-                    // This handles the case where duplicate IDs exist (spec violation but browsers handle it)
-                    const ElementIterator = @import("element_iterator.zig").ElementIterator;
-                    var iter = ElementIterator.init(&doc.prototype);
-                    while (iter.next()) |other_elem| {
-                        if (other_elem != elem) {
-                            if (other_elem.getId()) |other_id| {
-                                if (std.mem.eql(u8, other_id, id)) {
-                                    doc.id_map.put(id, other_elem) catch {};
-                                    doc.invalidateIdCache();
-                                    break;
-                                }
-                            }
-                        }
-                    }
-                }
-            }
+            doc.id_map.remove(id, elem);
+            doc.invalidateIdCache();
         }
 
-        // Remove from tag_map
-        const tag = elem.tag_name;
-        if (doc.tag_map.getPtr(tag)) |list_ptr| {
-            // Find and remove this element from the list
-            var i: usize = 0;
-            while (i < list_ptr.items.len) {
-                if (list_ptr.items[i] == elem) {
-                    _ = list_ptr.swapRemove(i);
-                    break;
-                }
-                i += 1;
+        // Remove from class index if enabled
+        if (doc.class_index) |index| {
+            if (elem.getAttribute("class")) |class_value| {
+                index.removeTokens(class_value, elem);
             }
         }
+
+        // Remove from tag index (keeps the bucket in tree order)
+        doc.tag_index.remove(elem);
     }
 
     // Recursively process children
@@ -2835,6 +3266,10 @@ fn preInsert(
     parent: *Node,
     child: ?*Node,
 ) !*Node {
+    // A frozen document's nodes can neither gain nor lose children
+    try parent.checkMutable();
+    try node.checkMutable();
+
     // [CEReactions] scope for custom element lifecycle callbacks (Phase 4)
     const doc_node = parent.owner_document orelse parent;
     const is_document = doc_node.node_type == .document;
@@ -2892,66 +3327,99 @@ fn preInsert(
 ///
 /// Handles DocumentFragment expansion, sibling pointer updates,
 /// parent pointer updates, and connected state propagation.
+///
+/// A fragment's children are spliced into the parent's child list as one
+/// chain (they keep their sibling links), and the whole insertion queues a
+/// single childList record; only the per-node work (parent pointers,
+/// adoption, connected state, document maps) is done per child.
 fn insert(
     node: *Node,
     parent: *Node,
     child: ?*Node,
 ) !void {
-    // Step 1: Determine nodes to insert
-    var nodes_buffer: [256]*Node = undefined; // Should be enough for most cases
-    var nodes: []*Node = undefined;
-    var node_count: usize = 0;
+    // Step 1: Determine nodes to insert (fragments larger than the stack
+    // buffer collect into a heap list)
+    var nodes_buffer: [256]*Node = undefined;
+    var nodes: []*Node = nodes_buffer[0..1];
+    var heap_nodes: []*Node = &.{};
+    defer node.allocator.free(heap_nodes);
 
     if (node.node_type == .document_fragment) {
-        // Collect fragment children
+        var count: usize = 0;
         var current = node.first_child;
-        while (current) |c| {
-            nodes_buffer[node_count] = c;
-            node_count += 1;
-            current = c.next_sibling;
-        }
-        nodes = nodes_buffer[0..node_count];
+        while (current) |c| : (current = c.next_sibling) count += 1;
 
-        // Clear fragment's child pointers WITHOUT releasing children
-        // (we're about to insert them into parent, so they need to stay alive)
-        node.first_child = null;
-        node.last_child = null;
+        // Step 3: Return if no nodes
+        if (count == 0) return;
 
-        // Clear children's parent pointers and has_parent flag
-        for (nodes) |c| {
-            c.parent_node = null;
-            c.previous_sibling = null;
-            c.next_sibling = null;
-            c.setHasParent(false);
+        if (count > nodes_buffer.len) {
+            heap_nodes = try node.allocator.alloc(*Node, count);
+            nodes = heap_nodes;
+        } else {
+            nodes = nodes_buffer[0..count];
+        }
+        current = node.first_child;
+        for (nodes) |*slot| {
+            slot.* = current.?;
+            current = current.?.next_sibling;
         }
     } else {
         nodes_buffer[0] = node;
-        node_count = 1;
-        nodes = nodes_buffer[0..1];
     }
 
-    // Step 3: Return if no nodes
-    if (node_count == 0) return;
+    // Step 5: Live ranges in parent after child move right
+    range_mod.nodesWillBeInserted(parent, child, nodes.len);
 
-    // Step 7: Insert each node
-    for (nodes) |n| {
+    if (node.node_type == .document_fragment) {
+        // Live ranges in the fragment end up at (fragment, 0)
+        range_mod.childrenWillBeRemoved(node);
+        node_iterator_mod.childrenWillBeRemoved(node);
+
+        // Detach the chain from the fragment WITHOUT releasing the children
+        // (we're about to insert them into parent, so they need to stay alive)
+        node.first_child = null;
+        node.last_child = null;
+        node.generation += 1;
+        node.noteMutation();
+
+        // Step 7.1: Adopt nodes into parent's node document (WHATWG DOM §4.2.4)
+        // This must happen BEFORE insertion to ensure all string references point to the right document
+        for (nodes) |n| {
+            n.parent_node = null;
+            n.setHasParent(false);
+            if (parent.owner_document) |parent_doc| {
+                if (n.owner_document != parent_doc) try adopt(n, parent_doc);
+            }
+        }
+    } else {
         // Step 7.1: Adopt node into parent's node document (WHATWG DOM §4.2.4)
         // This must happen BEFORE insertion to ensure all string references point to the right document
         if (parent.owner_document) |parent_doc| {
-            try adopt(n, parent_doc);
+            try adopt(node, parent_doc);
         }
 
         // Remove from old parent if any
-        if (n.parent_node) |_| {
-            remove(n);
+        if (node.parent_node) |_| {
+            remove(node);
         }
+    }
+
+    // The record's previousSibling is the node before the inserted ones
+    const previous_sibling = if (child) |c| c.previous_sibling else parent.last_child;
 
-        // Step 7.2-7.3: Insert into children list
-        insertIntoChildrenList(n, parent, child);
+    // Step 7.2-7.3: Insert into children list
+    spliceIntoChildrenList(nodes[0], nodes[nodes.len - 1], parent, child);
 
+    // Shadow trees keep their own indices instead of the document maps
+    const shadow = @import("shadow_index.zig").containingShadowRoot(parent);
+
+    // Step 7: Per-node insertion steps
+    for (nodes) |n| {
         // Update parent pointer
         n.parent_node = parent;
         n.setHasParent(true);
+        tree_helpers.setSubtreeDepth(n, parent.depth + 1);
+        if (shadow) |s| @import("shadow_index.zig").subtreeInserted(s, n);
 
         // Update connected state
         if (parent.isConnected()) {
@@ -2959,10 +3427,10 @@ fn insert(
             // Recursively set connected for descendants
             tree_helpers.setDescendantsConnected(n, true);
 
-            // Update document maps (id_map, tag_map) for newly connected elements
+            // Update document maps (id_map, tag_index) for newly connected elements
             // This must happen AFTER setConnected() so isConnected() returns true
             if (parent.owner_document) |owner_doc| {
-                if (owner_doc.node_type == .document) {
+                if (owner_doc.node_type == .document and shadow == null) {
                     addNodeToDocumentMaps(n, owner_doc) catch {}; // Best effort
                 }
             }
@@ -2971,20 +3439,7 @@ fn insert(
         // Slot assignment steps (WHATWG DOM §4.2.4 - insert algorithm step 7.4)
         // Step 7.4: If parent is a shadow host whose shadow root's slot assignment is "named"
         //           and node is a slottable, then assign a slot for node.
-        if (parent.node_type == .element) {
-            const Element = @import("element.zig").Element;
-            if (parent.rare_data) |rare_data| {
-                if (rare_data.shadow_root) |shadow_ptr| {
-                    const ShadowRoot = @import("shadow_root.zig").ShadowRoot;
-                    const shadow: *const ShadowRoot = @ptrCast(@alignCast(shadow_ptr));
-                    if (shadow.slot_assignment == .named) {
-                        if (n.node_type == .element or n.node_type == .text) {
-                            Element.assignASlot(n.allocator, n) catch {};
-                        }
-                    }
-                }
-            }
-        }
+        @import("slot_map.zig").nodeInserted(parent, n);
     }
 
     // Queue mutation record for childList mutations
@@ -2993,7 +3448,7 @@ fn insert(
         "childList",
         nodes, // added_nodes
         null, // removed_nodes
-        if (child) |c| c.previous_sibling else parent.last_child, // previousSibling
+        previous_sibling, // previousSibling
         child, // nextSibling
         null, // attribute_name
         null, // attribute_namespace
@@ -3001,44 +3456,33 @@ fn insert(
     ) catch {}; // Best effort - don't fail insertion if mutation tracking fails
 }
 
-/// Inserts node into parent's children list before child.
-fn insertIntoChildrenList(
-    node: *Node,
+/// Links the sibling chain `first ... last` into parent's children list
+/// before child; the chain's inner sibling links are kept as they are.
+fn spliceIntoChildrenList(
+    first: *Node,
+    last: *Node,
     parent: *Node,
     child: ?*Node,
 ) void {
-    if (child) |c| {
-        // Insert before child
-        const prev = c.previous_sibling;
-
-        // Update node's pointers
-        node.previous_sibling = prev;
-        node.next_sibling = c;
+    const prev = if (child) |c| c.previous_sibling else parent.last_child;
 
-        // Update prev's next
-        if (prev) |p| {
-            p.next_sibling = node;
-        } else {
-            parent.first_child = node;
-        }
+    first.previous_sibling = prev;
+    last.next_sibling = child;
 
-        // Update child's prev
-        c.previous_sibling = node;
+    if (prev) |p| {
+        p.next_sibling = first;
     } else {
-        // Append to end
-        const last = parent.last_child;
-
-        node.previous_sibling = last;
-        node.next_sibling = null;
-
-        if (last) |l| {
-            l.next_sibling = node;
-        } else {
-            parent.first_child = node;
-        }
+        parent.first_child = first;
+    }
 
-        parent.last_child = node;
+    if (child) |c| {
+        c.previous_sibling = last;
+    } else {
+        parent.last_child = last;
     }
+
+    parent.generation += 1;
+    parent.noteMutation();
 }
 
 /// Pre-remove algorithm per WHATWG DOM §4.2.4.
@@ -3046,6 +3490,8 @@ fn preRemove(
     child: *Node,
     parent: *Node,
 ) !*Node {
+    try parent.checkMutable();
+
     // [CEReactions] scope for custom element lifecycle callbacks (Phase 4)
     const doc_node = parent.owner_document orelse parent;
     const is_document = doc_node.node_type == .document;
@@ -3089,6 +3535,11 @@ fn preRemove(
 fn remove(node: *Node) void {
     const parent = node.parent_node orelse return;
 
+    // Live ranges in node move out to parent, those after it move left
+    range_mod.nodeWillBeRemoved(node, parent);
+    // NodeIterators in it move off it
+    node_iterator_mod.nodeWillBeRemoved(node, node.previous_sibling);
+
     // Capture siblings for mutation record BEFORE updating pointers
     const prev = node.previous_sibling;
     const next = node.next_sibling;
@@ -3104,19 +3555,29 @@ fn remove(node: *Node) void {
     } else {
         parent.last_child = prev;
     }
+    parent.generation += 1;
+    parent.noteMutation();
 
     // Clear node's pointers
     node.parent_node = null;
     node.previous_sibling = null;
     node.next_sibling = null;
     node.setHasParent(false);
+    tree_helpers.setSubtreeDepth(node, 0);
+
+    // Leave the host's slot or the shadow tree's slot names
+    @import("slot_map.zig").nodeRemoved(parent, node);
+
+    // Leave the shadow tree's indices (the document maps never held it)
+    const shadow = @import("shadow_index.zig").containingShadowRoot(parent);
+    if (shadow) |s| @import("shadow_index.zig").subtreeRemoved(s, node);
 
     // Update connected state
     if (node.isConnected()) {
         // Remove from document maps BEFORE disconnecting
         // (while isConnected() still returns true for the check, but we're about to disconnect)
         if (parent.owner_document) |owner_doc| {
-            if (owner_doc.node_type == .document) {
+            if (owner_doc.node_type == .document and shadow == null) {
                 removeNodeFromDocumentMaps(node, owner_doc);
             }
         }
@@ -3141,12 +3602,149 @@ fn remove(node: *Node) void {
     ) catch {}; // Best effort
 }
 
+/// Removes `nodes`, consecutive children of `parent` in tree order, as
+/// `remove()` would one by one, but relinks the siblings once, bumps the
+/// generation once and queues one childList record listing them all.
+fn removeRun(parent: *Node, nodes: []const *Node) void {
+    const first = nodes[0];
+    const last = nodes[nodes.len - 1];
+
+    // Live ranges in the run move out to parent, those after it move left
+    range_mod.nodesWillBeRemoved(parent, nodes);
+    // NodeIterators in it move off it
+    node_iterator_mod.nodesWillBeRemoved(nodes);
+
+    const prev = first.previous_sibling;
+    const next = last.next_sibling;
+
+    if (prev) |p| {
+        p.next_sibling = next;
+    } else {
+        parent.first_child = next;
+    }
+
+    if (next) |n| {
+        n.previous_sibling = prev;
+    } else {
+        parent.last_child = prev;
+    }
+    parent.generation += 1;
+    parent.noteMutation();
+
+    const shadow = @import("shadow_index.zig").containingShadowRoot(parent);
+    for (nodes) |node| {
+        node.parent_node = null;
+        node.previous_sibling = null;
+        node.next_sibling = null;
+        node.setHasParent(false);
+        tree_helpers.setSubtreeDepth(node, 0);
+
+        @import("slot_map.zig").nodeRemoved(parent, node);
+        if (shadow) |s| @import("shadow_index.zig").subtreeRemoved(s, node);
+
+        if (node.isConnected()) {
+            if (parent.owner_document) |owner_doc| {
+                if (owner_doc.node_type == .document and shadow == null) {
+                    removeNodeFromDocumentMaps(node, owner_doc);
+                }
+            }
+
+            node.setConnected(false);
+            tree_helpers.setDescendantsConnected(node, false);
+        }
+    }
+
+    queueMutationRecord(
+        parent,
+        "childList",
+        null, // added_nodes
+        nodes, // removed_nodes
+        prev, // previousSibling
+        next, // nextSibling
+        null, // attribute_name
+        null, // attribute_namespace
+        null, // old_value
+    ) catch {}; // Best effort
+}
+
+/// Removes `nodes`, consecutive children of `parent` in tree order, and
+/// appends them to `fragment`, or releases them when it is null. Backs
+/// Range.extractContents() and deleteContents(): the run is unlinked and
+/// relinked as one sibling chain, with one childList record on `parent`
+/// and one on `fragment`, however many nodes it holds.
+///
+/// `fragment` must be a new DocumentFragment of `parent`'s node document.
+pub fn moveChildRun(parent: *Node, nodes: []const *Node, fragment: ?*Node) !void {
+    if (nodes.len == 0) return;
+    try parent.checkMutable();
+
+    // [CEReactions] scope for the disconnected reactions of the run
+    const doc_node = parent.owner_document orelse parent;
+    if (doc_node.node_type == .document) {
+        const Document = @import("document.zig").Document;
+        const doc: *Document = @fieldParentPtr("prototype", doc_node);
+        const stack = doc.getCEReactionsStack();
+        try stack.enter();
+        defer stack.leave();
+
+        for (nodes) |node| {
+            if (node.isConnected()) {
+                try custom_elements.enqueueDisconnectedReactionsForTree(node, stack);
+            }
+        }
+        removeRun(parent, nodes);
+    } else {
+        removeRun(parent, nodes);
+    }
+
+    const target = fragment orelse {
+        for (nodes) |node| node.release();
+        return;
+    };
+    appendRun(target, nodes);
+}
+
+/// Appends `nodes`, parentless nodes of `parent`'s node document, to
+/// `parent` as one sibling chain, with one childList record listing them.
+/// `parent` must be a disconnected DocumentFragment outside any shadow
+/// tree, so no connected, slot or index steps apply.
+pub fn appendRun(parent: *Node, nodes: []const *Node) void {
+    if (nodes.len == 0) return;
+    std.debug.assert(parent.node_type == .document_fragment and !parent.isConnected());
+
+    for (nodes, 0..) |node, i| {
+        node.parent_node = parent;
+        node.setHasParent(true);
+        tree_helpers.setSubtreeDepth(node, parent.depth + 1);
+        node.previous_sibling = if (i > 0) nodes[i - 1] else null;
+        node.next_sibling = if (i + 1 < nodes.len) nodes[i + 1] else null;
+    }
+
+    const previous_sibling = parent.last_child;
+    spliceIntoChildrenList(nodes[0], nodes[nodes.len - 1], parent, null);
+
+    queueMutationRecord(
+        parent,
+        "childList",
+        nodes, // added_nodes
+        null, // removed_nodes
+        previous_sibling, // previousSibling
+        null, // nextSibling
+        null, // attribute_name
+        null, // attribute_namespace
+        null, // old_value
+    ) catch {}; // Best effort
+}
+
 /// Replace algorithm per WHATWG DOM §4.2.4.
 fn replace(
     child: *Node,
     node: *Node,
     parent: *Node,
 ) !*Node {
+    try parent.checkMutable();
+    try node.checkMutable();
+
     // [CEReactions] scope for custom element lifecycle callbacks (Phase 4)
     const doc_node = parent.owner_document orelse parent;
     const is_document = doc_node.node_type == .document;
@@ -3218,6 +3816,23 @@ fn replace(
 // MUTATION OBSERVER SUPPORT (Phase 17)
 // ============================================================================
 
+/// Returns true if a mutation observer is registered on `target` or one of
+/// its ancestors, i.e. if queueMutationRecord() might queue anything.
+///
+/// Lets callers skip preparing record data (such as a copy of the old
+/// value of a long text) that nobody can observe.
+pub fn hasMutationObservers(target: *const Node) bool {
+    var current: ?*const Node = target;
+    while (current) |node| : (current = node.parent_node) {
+        if (node.rare_data) |rare| {
+            if (rare.mutation_observers) |observers| {
+                if (observers.items.len > 0) return true;
+            }
+        }
+    }
+    return false;
+}
+
 /// Queue a mutation record for interested observers.
 ///
 /// This is called by tree mutation methods (appendChild, removeChild, etc.)
@@ -3253,6 +3868,15 @@ pub fn queueMutationRecord(
     attribute_namespace: ?[]const u8,
     old_value: ?[]const u8,
 ) !void {
+    // Mutation batches coalesce for every registration (see Document.beginBatch)
+    const batching = blk: {
+        const doc_node = target.owner_document orelse target;
+        if (doc_node.node_type != .document) break :blk false;
+        const Document = @import("document.zig").Document;
+        const doc: *Document = @fieldParentPtr("prototype", doc_node);
+        break :blk doc.batch_depth > 0;
+    };
+
     // Process observers on target and ancestors (for subtree observation)
     var current_node: ?*Node = target;
     var is_target = true;
@@ -3272,6 +3896,18 @@ pub fn queueMutationRecord(
                     const interested = reg.matches(mutation_type, attribute_name);
                     if (!interested) continue;
 
+                    // Coalescing registrations fold the mutation into a queued record
+                    const coalesce = reg.options.coalesce or batching;
+                    if (coalesce) {
+                        if (std.mem.eql(u8, mutation_type, "attributes")) {
+                            if (reg.observer.hasCoalescedAttribute(target, attribute_name orelse "", attribute_namespace)) continue;
+                        } else if (std.mem.eql(u8, mutation_type, "childList")) {
+                            if (reg.observer.records.getLastOrNull()) |last| {
+                                if (try last.mergeChildList(target, added_nodes, removed_nodes, previous_sibling, next_sibling)) continue;
+                            }
+                        }
+                    }
+
                     // Create mutation record
                     const record = try MutationRecord.init(
                         target.allocator,
@@ -3324,7 +3960,11 @@ pub fn queueMutationRecord(
                     }
 
                     // Add record to observer's queue
-                    try reg.observer.records.append(reg.observer.allocator, record);
+                    if (coalesce and std.mem.eql(u8, mutation_type, "attributes")) {
+                        try reg.observer.enqueueCoalescedAttribute(record);
+                    } else {
+                        try reg.observer.enqueueRecord(record);
+                    }
                 }
             }
         }
@@ -243,8 +243,10 @@
 //! See `JS_BINDINGS.md` for complete binding patterns and memory management.
 
 const std = @import("std");
+const Allocator = std.mem.Allocator;
 const Node = @import("node.zig").Node;
 const NodeType = @import("node.zig").NodeType;
+const Element = @import("element.zig").Element;
 
 /// Filter result from acceptNode callback.
 ///
@@ -513,3 +515,94 @@ pub const NodeFilter = struct {
         return (what_to_show & node_bit) != 0;
     }
 };
+
+/// Declarative element filter evaluated natively.
+///
+/// Accepts elements whose tag name is in a set and/or that carry a class,
+/// and gives every other node a fixed result (`.skip` by default, or
+/// `.reject` to prune whole subtrees in a TreeWalker). Bindings compile
+/// common script filters into one of these so traversal never calls back
+/// into script.
+///
+/// The filter owns copies of its names and must outlive every walker or
+/// iterator it is attached to (via `nodeFilter()`).
+///
+/// ## Example
+/// ```zig
+/// var filter = ElementFilter.init(allocator);
+/// defer filter.deinit();
+/// try filter.addTagName("item");
+/// try filter.setClassName("visible");
+///
+/// const walker = try doc.createTreeWalker(root, NodeFilter.SHOW_ELEMENT, filter.nodeFilter());
+/// ```
+pub const ElementFilter = struct {
+    allocator: Allocator,
+
+    /// Accepted tag names (empty = any tag name)
+    tag_names: std.ArrayList([]const u8) = .{},
+
+    /// Required class (null = no class requirement)
+    class_name: ?[]const u8 = null,
+
+    /// Result for nodes that do not match
+    miss: FilterResult = .skip,
+
+    pub fn init(allocator: Allocator) ElementFilter {
+        return .{ .allocator = allocator };
+    }
+
+    pub fn deinit(self: *ElementFilter) void {
+        for (self.tag_names.items) |name| self.allocator.free(name);
+        self.tag_names.deinit(self.allocator);
+        if (self.class_name) |name| self.allocator.free(name);
+    }
+
+    /// Adds a tag name to the accepted set (compared exactly).
+    pub fn addTagName(self: *ElementFilter, name: []const u8) Allocator.Error!void {
+        const owned = try self.allocator.dupe(u8, name);
+        errdefer self.allocator.free(owned);
+        try self.tag_names.append(self.allocator, owned);
+    }
+
+    /// Requires matching elements to carry `name` in their class list.
+    pub fn setClassName(self: *ElementFilter, name: []const u8) Allocator.Error!void {
+        const owned = try self.allocator.dupe(u8, name);
+        if (self.class_name) |old| self.allocator.free(old);
+        self.class_name = owned;
+    }
+
+    /// True if `node` is an element satisfying every configured predicate.
+    pub fn matches(self: *const ElementFilter, node: *Node) bool {
+        if (node.node_type != .element) return false;
+        const elem: *Element = @fieldParentPtr("prototype", node);
+
+        if (self.tag_names.items.len > 0) {
+            const found = for (self.tag_names.items) |name| {
+                if (std.mem.eql(u8, name, elem.tag_name)) break true;
+            } else false;
+            if (!found) return false;
+        }
+
+        if (self.class_name) |name| {
+            // Bloom-filtered, so elements without the class are cheap
+            if (!elem.hasClass(name)) return false;
+        }
+
+        return true;
+    }
+
+    pub fn acceptNode(self: *const ElementFilter, node: *Node) FilterResult {
+        return if (self.matches(node)) .accept else self.miss;
+    }
+
+    /// The NodeFilter to pass to createTreeWalker / createNodeIterator.
+    pub fn nodeFilter(self: *const ElementFilter) NodeFilter {
+        return .{ .callback = acceptCallback, .context = @constCast(self) };
+    }
+
+    fn acceptCallback(node: *Node, context: ?*anyopaque) FilterResult {
+        const self: *const ElementFilter = @ptrCast(@alignCast(context.?));
+        return self.acceptNode(node);
+    }
+};
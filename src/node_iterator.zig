@@ -200,6 +200,7 @@
 const std = @import("std");
 const Allocator = std.mem.Allocator;
 const Node = @import("node.zig").Node;
+const Document = @import("document.zig").Document;
 const NodeFilter = @import("node_filter.zig").NodeFilter;
 const FilterResult = @import("node_filter.zig").FilterResult;
 
@@ -231,10 +232,10 @@ pub const NodeIterator = struct {
     /// Allocator for iterator cleanup
     allocator: Allocator,
 
-    /// Root node of traversal (boundary)
+    /// Root node of traversal (boundary), referenced until deinit
     root: *Node,
 
-    /// Current reference node
+    /// Current reference node, referenced until it changes
     reference_node: *Node,
 
     /// True if pointer is before reference node, false if after
@@ -246,6 +247,10 @@ pub const NodeIterator = struct {
     /// Optional custom filter
     node_filter: ?NodeFilter,
 
+    /// Document whose removals run this iterator's pre-removing steps
+    /// (root's node document; follows root when it is adopted)
+    document: ?*Document,
+
     /// Creates a new NodeIterator.
     ///
     /// ## Parameters
@@ -255,7 +260,8 @@ pub const NodeIterator = struct {
     /// - `node_filter`: Optional custom filter
     ///
     /// ## Returns
-    /// New NodeIterator positioned before root
+    /// New NodeIterator positioned before root, referencing root until
+    /// deinit()
     ///
     /// ## Example
     /// ```zig
@@ -274,6 +280,7 @@ pub const NodeIterator = struct {
         node_filter: ?NodeFilter,
     ) !*NodeIterator {
         const iterator = try allocator.create(NodeIterator);
+        errdefer allocator.destroy(iterator);
         iterator.* = .{
             .allocator = allocator,
             .root = root,
@@ -281,12 +288,21 @@ pub const NodeIterator = struct {
             .pointer_before_reference_node = true,
             .what_to_show = what_to_show,
             .node_filter = node_filter,
+            .document = null,
         };
+        if (documentOf(root)) |doc| try register(iterator, doc);
+
+        // One reference for root, one for the reference node
+        root.acquire();
+        root.acquire();
         return iterator;
     }
 
-    /// Frees the iterator.
+    /// Releases the iterator's node references and frees it.
     pub fn deinit(self: *NodeIterator) void {
+        if (self.document) |doc| unregister(self, doc);
+        self.reference_node.release();
+        self.root.release();
         self.allocator.destroy(self);
     }
 
@@ -337,8 +353,7 @@ pub const NodeIterator = struct {
             // Step 3c.ii: Filter the node
             const result = filterNode(self, node);
             if (result == .accept) {
-                self.reference_node = node;
-                self.pointer_before_reference_node = false;
+                self.setReference(node, false);
                 return node;
             }
             // Continue to next node
@@ -384,8 +399,7 @@ pub const NodeIterator = struct {
             // Filter the node
             const result = filterNode(self, node);
             if (result == .accept) {
-                self.reference_node = node;
-                self.pointer_before_reference_node = true;
+                self.setReference(node, true);
                 return node;
             }
             // Continue to previous node
@@ -415,6 +429,62 @@ pub const NodeIterator = struct {
     // Helper Functions
     // ========================================================================
 
+    /// Moves the reference to `node`; acquires first, as the old reference
+    /// node may own the new one.
+    fn setReference(self: *NodeIterator, node: *Node, before: bool) void {
+        self.pointer_before_reference_node = before;
+        if (node == self.reference_node) return;
+        node.acquire();
+        const old = self.reference_node;
+        self.reference_node = node;
+        old.release();
+    }
+
+    /// NodeIterator pre-removing steps per WHATWG DOM §6.1, run before
+    /// `node` is removed. `previous_sibling` is the sibling node will have
+    /// had just before its removal (the one before a whole removed run).
+    ///
+    /// ## Spec References
+    /// - Algorithm: https://dom.spec.whatwg.org/#nodeiterator-pre-removing-steps
+    fn preRemovingSteps(self: *NodeIterator, node: *Node, previous_sibling: ?*Node) void {
+        // Step 1: Only a removal taking the reference node along matters
+        if (node == self.root or !isDescendantOf(self.reference_node, node)) return;
+
+        // Step 2: Before the reference node, move to the first node
+        // following the removed subtree that is still under root
+        if (self.pointer_before_reference_node) {
+            if (followingOutside(node, self.root)) |next| {
+                self.setReference(next, true);
+                return;
+            }
+            self.pointer_before_reference_node = false;
+        }
+
+        // Step 3: Otherwise move to the last node preceding it
+        const preceding = if (previous_sibling) |sibling| lastDescendant(sibling) else node.parent_node.?;
+        self.setReference(preceding, false);
+    }
+
+    /// First node following `node`'s subtree in tree order that is an
+    /// inclusive descendant of `root`, or null.
+    fn followingOutside(node: *Node, root: *const Node) ?*Node {
+        var current = followingSubtree(node);
+        while (current) |candidate| {
+            if (isDescendantOf(candidate, root)) return candidate;
+            current = candidate.first_child orelse followingSubtree(candidate);
+        }
+        return null;
+    }
+
+    /// First node following `node`'s subtree in tree order, or null.
+    fn followingSubtree(node: *Node) ?*Node {
+        var current: *Node = node;
+        while (true) {
+            if (current.next_sibling) |sibling| return sibling;
+            current = current.parent_node orelse return null;
+        }
+    }
+
     /// Filters a node based on whatToShow and custom filter.
     fn filterNode(self: *const NodeIterator, node: *Node) FilterResult {
         // Check whatToShow bitfield
@@ -487,3 +557,87 @@ pub const NodeIterator = struct {
         return false;
     }
 };
+
+// === Removal and Adoption Hooks ===
+//
+// A document lists the iterators whose root is one of its nodes, so tree
+// algorithms find the iterators a removal affects without a global
+// registry; each hook returns at once when the document has none.
+
+fn documentOf(node: *const Node) ?*Document {
+    const doc_node = node.owner_document orelse return null;
+    if (doc_node.node_type != .document) return null;
+    const doc: *Document = @fieldParentPtr("prototype", doc_node);
+    return doc;
+}
+
+fn register(iterator: *NodeIterator, doc: *Document) Allocator.Error!void {
+    try doc.node_iterators.append(doc.prototype.allocator, iterator);
+    iterator.document = doc;
+}
+
+fn unregister(iterator: *NodeIterator, doc: *Document) void {
+    const list = &doc.node_iterators;
+    for (list.items, 0..) |entry, i| {
+        if (entry == iterator) {
+            _ = list.swapRemove(i);
+            break;
+        }
+    }
+    iterator.document = null;
+}
+
+/// Pre-removing steps of `node`'s document's iterators: `node`, a child
+/// whose previous sibling will be `previous_sibling`, is about to be
+/// removed.
+pub fn nodeWillBeRemoved(node: *Node, previous_sibling: ?*Node) void {
+    const doc = documentOf(node) orelse return;
+    for (doc.node_iterators.items) |iterator| {
+        iterator.preRemovingSteps(node, previous_sibling);
+    }
+}
+
+/// Pre-removing steps for `nodes`, consecutive children removed together,
+/// as if they were removed one by one in tree order.
+pub fn nodesWillBeRemoved(nodes: []const *Node) void {
+    const doc = documentOf(nodes[0]) orelse return;
+    if (doc.node_iterators.items.len == 0) return;
+
+    // By the time each one goes, the nodes before it are gone
+    const previous_sibling = nodes[0].previous_sibling;
+    for (nodes) |node| {
+        for (doc.node_iterators.items) |iterator| {
+            iterator.preRemovingSteps(node, previous_sibling);
+        }
+    }
+}
+
+/// Pre-removing steps for all of `parent`'s children at once (a fragment
+/// being inserted), as if they were removed one by one.
+pub fn childrenWillBeRemoved(parent: *Node) void {
+    const doc = documentOf(parent) orelse return;
+    if (doc.node_iterators.items.len == 0) return;
+
+    var child = parent.first_child;
+    while (child) |c| : (child = c.next_sibling) {
+        for (doc.node_iterators.items) |iterator| {
+            iterator.preRemovingSteps(c, null);
+        }
+    }
+}
+
+/// Moves the iterators of `old_doc` whose root left it (adopted into
+/// `new_doc`) to `new_doc`'s list.
+pub fn nodesAdopted(old_doc: *Document, new_doc: ?*Document) Allocator.Error!void {
+    var i = old_doc.node_iterators.items.len;
+    while (i > 0) {
+        i -= 1;
+        const iterator = old_doc.node_iterators.items[i];
+        if (iterator.root.owner_document == &old_doc.prototype) continue;
+
+        if (new_doc) |doc| try doc.node_iterators.ensureUnusedCapacity(doc.prototype.allocator, 1);
+        _ = old_doc.node_iterators.swapRemove(i);
+        iterator.document = new_doc;
+        if (new_doc) |doc| doc.node_iterators.appendAssumeCapacity(iterator);
+    }
+}
@@ -0,0 +1,230 @@
+//! Node Table - Integer handles for a document's nodes
+//!
+//! Script algorithms over large trees (layout prototypes, tree diffing)
+//! read every node through the bindings, and each read returns a wrapper
+//! object that has to be looked up or created. A NodeTable numbers the
+//! nodes of one document on demand instead: `idOf()` gives a node a small
+//! integer id, `get()` turns an id back into the node, `related()` steps
+//! from an id to the id of its parent, first or last child or a sibling,
+//! and `tagAtom()` numbers tag names, so a traversal passes integers only
+//! and wrappers are created just for the nodes the algorithm hands back.
+//!
+//! ## Ids
+//!
+//! Ids are assigned 1, 2, ... in the order nodes are first asked for and
+//! stay below `max_id`, which fits a JS engine's small integers. 0 means
+//! "no node". A node keeps its id when it moves within the document. Ids
+//! are never reused: the id of a node destroyed or adopted by another
+//! document is dropped (Document.releaseNodeRef), so `get()` returns null
+//! for it from then on, and `clear()` drops every id at once. Attributes
+//! and nodes of other documents get no id.
+//!
+//! Tag atoms are numbered the same way from 1 and are kept for the life of
+//! the table; `atomName()` returns the name of one.
+//!
+//! ## Frozen documents
+//!
+//! Freezing a document numbers every node of its tree (see `fill`) and
+//! drops the ids of nodes outside it; the table is then read-only, so
+//! several threads may use it, and nodes without an id get none (0).
+//!
+//! ## Example
+//! ```zig
+//! const root_id = try doc.nodeId(&root.prototype); // enables the table
+//! const table = doc.node_table.?;
+//! const row = try table.atomOf(&doc.string_pool, "row");
+//! var id = try table.related(root_id, .first_child);
+//! while (id != 0) : (id = try table.related(id, .next_sibling)) {
+//!     if (try table.tagAtom(&doc.string_pool, id) == row) visit(table.get(id).?);
+//! }
+//! ```
+
+const std = @import("std");
+const Allocator = std.mem.Allocator;
+const Node = @import("node.zig").Node;
+const Element = @import("element.zig").Element;
+const StringPool = @import("document.zig").StringPool;
+
+/// Largest id and atom (2^30 - 1, a small integer in every JS engine)
+pub const max_id: u32 = (1 << 30) - 1;
+
+/// Node reached by `related()`
+pub const Relation = enum(u8) {
+    parent = 0,
+    first_child = 1,
+    last_child = 2,
+    previous_sibling = 3,
+    next_sibling = 4,
+};
+
+pub const NodeTable = struct {
+    allocator: Allocator,
+
+    /// Node of each id given out since the last clear, null once dropped;
+    /// `nodes.items[i]` has id `base + i`
+    nodes: std.ArrayList(?*Node) = .{},
+
+    /// Id of the first entry of `nodes` (ids below it were cleared)
+    base: u32 = 1,
+
+    /// Id of each numbered node
+    ids: std.AutoHashMapUnmanaged(*const Node, u32) = .{},
+
+    /// Atom of each tag name (keys interned in the document's pool)
+    atoms: std.StringHashMapUnmanaged(u32) = .{},
+
+    /// Name of each atom; `atom_names.items[i]` is atom `i + 1`
+    atom_names: std.ArrayList([]const u8) = .{},
+
+    /// Set by the document's freeze(): no ids or atoms are added
+    read_only: bool = false,
+
+    pub fn init(allocator: Allocator) NodeTable {
+        return .{ .allocator = allocator };
+    }
+
+    pub fn deinit(self: *NodeTable) void {
+        self.nodes.deinit(self.allocator);
+        self.ids.deinit(self.allocator);
+        self.atoms.deinit(self.allocator);
+        self.atom_names.deinit(self.allocator);
+    }
+
+    /// Number of nodes with an id.
+    pub fn count(self: *const NodeTable) usize {
+        return self.ids.count();
+    }
+
+    /// Returns the id of `node`, numbering it if it has none.
+    ///
+    /// The caller checks that `node` belongs to the table's document and
+    /// is not an attribute (see Document.nodeId).
+    ///
+    /// ## Returns
+    /// The id, or 0 if the table is read-only and `node` has none, or if
+    /// `max_id` ids were given out since the last clear
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to grow the table
+    pub fn idOf(self: *NodeTable, node: *Node) !u32 {
+        if (self.ids.get(node)) |id| return id;
+        if (self.read_only) return 0;
+
+        const next = @as(u64, self.base) + self.nodes.items.len;
+        if (next > max_id) return 0;
+        const id: u32 = @intCast(next);
+        try self.nodes.ensureUnusedCapacity(self.allocator, 1);
+        try self.ids.put(self.allocator, node, id);
+        self.nodes.appendAssumeCapacity(node);
+        return id;
+    }
+
+    /// Returns the node with id `id`, or null if there is none (0, dropped
+    /// or cleared).
+    pub fn get(self: *const NodeTable, id: u32) ?*Node {
+        if (id < self.base) return null;
+        const index = id - self.base;
+        if (index >= self.nodes.items.len) return null;
+        return self.nodes.items[index];
+    }
+
+    /// Returns the id of the node `relation` of the node with id `id`,
+    /// numbering it if needed, or 0 if either node does not exist.
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to grow the table
+    pub fn related(self: *NodeTable, id: u32, relation: Relation) !u32 {
+        const node = self.get(id) orelse return 0;
+        const target = switch (relation) {
+            .parent => node.parent_node,
+            .first_child => node.first_child,
+            .last_child => node.last_child,
+            .previous_sibling => node.previous_sibling,
+            .next_sibling => node.next_sibling,
+        } orelse return 0;
+        return try self.idOf(target);
+    }
+
+    /// Returns the atom of the tag name of the element with id `id`, or 0
+    /// if it is not an element (or a read-only table has no atom for it).
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to grow the table
+    pub fn tagAtom(self: *NodeTable, pool: *StringPool, id: u32) !u32 {
+        const node = self.get(id) orelse return 0;
+        if (node.node_type != .element) return 0;
+        const element: *const Element = @fieldParentPtr("prototype", node);
+        return try self.atomOf(pool, element.tag_name);
+    }
+
+    /// Returns the atom of `name`, numbering it if it has none, or 0 if a
+    /// read-only or full table has none.
+    ///
+    /// Tag atoms compare names exactly, as the element's tagName does.
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to grow the table or intern the name
+    pub fn atomOf(self: *NodeTable, pool: *StringPool, name: []const u8) !u32 {
+        if (self.atoms.get(name)) |atom| return atom;
+        if (self.read_only or self.atom_names.items.len >= max_id) return 0;
+
+        const interned = try pool.intern(name);
+        try self.atom_names.ensureUnusedCapacity(self.allocator, 1);
+        const atom: u32 = @intCast(self.atom_names.items.len + 1);
+        try self.atoms.put(self.allocator, interned, atom);
+        self.atom_names.appendAssumeCapacity(interned);
+        return atom;
+    }
+
+    /// Returns the name of atom `atom`, or null if there is no such atom.
+    pub fn atomName(self: *const NodeTable, atom: u32) ?[]const u8 {
+        if (atom == 0 or atom > self.atom_names.items.len) return null;
+        return self.atom_names.items[atom - 1];
+    }
+
+    /// Drops the id of `node` (destroyed or leaving the document).
+    pub fn forget(self: *NodeTable, node: *const Node) void {
+        const removed = self.ids.fetchRemove(node) orelse return;
+        self.nodes.items[removed.value - self.base] = null;
+    }
+
+    /// Drops every id; ids given out before are never valid again. Atoms
+    /// are kept.
+    pub fn clear(self: *NodeTable) void {
+        if (self.read_only) return;
+        self.base = @intCast(@min(@as(u64, self.base) + self.nodes.items.len, max_id + 1));
+        self.nodes.clearRetainingCapacity();
+        self.ids.clearRetainingCapacity();
+    }
+
+    /// Numbers every node of the tree of `root`, and the tag of every
+    /// element, then drops the ids of nodes outside it (for freeze()).
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to grow the table
+    pub fn fill(self: *NodeTable, pool: *StringPool, root: *Node) !void {
+        var current: ?*Node = root;
+        while (current) |node| {
+            const id = try self.idOf(node);
+            if (node.node_type == .element) _ = try self.tagAtom(pool, id);
+            current = nextInTree(root, node);
+        }
+
+        for (self.nodes.items, 0..) |entry, index| {
+            const node = entry orelse continue;
+            if (node == root or node.isConnected()) continue;
+            _ = self.ids.remove(node);
+            self.nodes.items[index] = null;
+        }
+    }
+
+    fn nextInTree(root: *Node, node: *Node) ?*Node {
+        if (node.first_child) |child| return child;
+        var current = node;
+        while (current != root) {
+            if (current.next_sibling) |sibling| return sibling;
+            current = current.parent_node orelse return null;
+        }
+        return null;
+    }
+};
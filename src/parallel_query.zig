@@ -0,0 +1,200 @@
+//! Parallel Query - Opt-in multi-threaded querySelectorAll for large documents
+//!
+//! Matching a generic selector against every element of a very large
+//! document is a long run of independent `matches()` calls. Once enabled
+//! with `Document.enableParallelQueries()`, `Document.querySelectorAll()`
+//! of a frozen document (see `Document.freeze()`) with at least
+//! `min_nodes` nodes splits the document element's subtree into
+//! partitions, matches them on a thread pool and concatenates the
+//! partition results, so the result is in tree order as before.
+//!
+//! ## Partitions
+//!
+//! With the compact layout (`Document.enableCompactLayout()`), the
+//! preorder element table is cut into equal index ranges. Otherwise the
+//! tree is cut into units: an element on its own, or an element with its
+//! whole subtree. Starting from the document element, subtree units are
+//! replaced by their root followed by one subtree unit per element child,
+//! level by level, until there are enough units, and consecutive units
+//! are grouped into tasks. Every split keeps the units in tree order.
+//!
+//! `std.Thread.Pool` feeds all workers from one queue, so load is balanced
+//! by queueing several tasks per worker rather than by stealing: a worker
+//! that finishes a small task takes the next one. The calling thread
+//! works on the tasks too while it waits.
+//!
+//! ## Scope
+//!
+//! Only the frozen document's own querySelectorAll() is split; ID queries
+//! (at most one result) and small documents take the sequential path, as
+//! do documents without a document element.
+
+const std = @import("std");
+const Allocator = std.mem.Allocator;
+const Element = @import("element.zig").Element;
+const Document = @import("document.zig").Document;
+const Matcher = @import("selector/matcher.zig").Matcher;
+const HasCache = @import("selector/has_cache.zig").HasCache;
+const SelectorList = @import("selector/parser.zig").SelectorList;
+
+pub const ParallelQuery = struct {
+    /// Pool the partitions run on (owned by the caller)
+    pool: *std.Thread.Pool,
+
+    /// Documents with fewer nodes are queried sequentially
+    min_nodes: usize,
+
+    /// Tasks queued per pool thread (and for the calling thread)
+    const tasks_per_thread = 4;
+
+    /// Returns true if a query of `doc` should be split.
+    pub fn engages(self: ParallelQuery, doc: *const Document) bool {
+        return doc.frozen and self.pool.threads.len > 0 and
+            doc.node_ref_count.load(.monotonic) >= self.min_nodes;
+    }
+
+    /// Returns root and its matching descendants in tree order (caller
+    /// frees with `allocator`).
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to allocate partitions or results
+    pub fn querySelectorAll(
+        self: ParallelQuery,
+        allocator: Allocator,
+        doc: *Document,
+        root: *Element,
+        selector_list: *const SelectorList,
+    ) ![]const *Element {
+        const task_count = (self.pool.threads.len + 1) * tasks_per_thread;
+
+        const tasks = try allocator.alloc(Task, task_count);
+        defer {
+            for (tasks) |*task| task.results.deinit(allocator);
+            allocator.free(tasks);
+        }
+
+        var units = std.ArrayList(Unit){};
+        defer units.deinit(allocator);
+
+        // The compact layout covers descendants only; the tree units cover root
+        var root_matches = false;
+        const range = if (doc.compact_layout) |layout| try layout.descendants(doc, root) else null;
+        if (range) |descendants| {
+            const matcher = Matcher.init(allocator);
+            root_matches = try matcher.matches(root, selector_list);
+            splitRange(tasks, descendants.elements());
+        } else {
+            try splitTree(allocator, &units, root, task_count);
+            splitUnits(tasks, units.items);
+        }
+
+        var wait_group: std.Thread.WaitGroup = .{};
+        for (tasks) |*task| {
+            task.allocator = allocator;
+            task.selector_list = selector_list;
+            self.pool.spawnWg(&wait_group, Task.run, .{task});
+        }
+        self.pool.waitAndWork(&wait_group);
+
+        var total: usize = 0;
+        for (tasks) |*task| {
+            if (task.err) |err| return err;
+            total += task.results.items.len;
+        }
+
+        var results = try std.ArrayList(*Element).initCapacity(allocator, total + 1);
+        errdefer results.deinit(allocator);
+        if (root_matches) results.appendAssumeCapacity(root);
+        for (tasks) |*task| results.appendSliceAssumeCapacity(task.results.items);
+        return try results.toOwnedSlice(allocator);
+    }
+};
+
+/// A piece of the tree matched by one task.
+const Unit = struct {
+    element: *Element,
+    /// Include the element's descendants
+    subtree: bool,
+};
+
+/// One queued piece of work: a range of the compact layout or a run of
+/// consecutive units.
+const Task = struct {
+    allocator: Allocator = undefined,
+    selector_list: *const SelectorList = undefined,
+    elements: []const *Element = &.{},
+    units: []const Unit = &.{},
+    results: std.ArrayList(*Element) = .{},
+    err: ?anyerror = null,
+
+    fn run(self: *Task) void {
+        self.collect() catch |err| {
+            self.err = err;
+        };
+    }
+
+    fn collect(self: *Task) !void {
+        // The document's :has() cache is not shared between threads
+        var has_cache = HasCache.init(self.allocator);
+        defer has_cache.deinit();
+        var matcher = Matcher.init(self.allocator);
+        matcher.has_cache = &has_cache;
+        for (self.elements) |elem| {
+            if (try matcher.matches(elem, self.selector_list)) try self.results.append(self.allocator, elem);
+        }
+        for (self.units) |unit| {
+            if (try matcher.matches(unit.element, self.selector_list)) {
+                try self.results.append(self.allocator, unit.element);
+            }
+            if (unit.subtree) {
+                try unit.element.querySelectorAllHelper(self.allocator, &matcher, self.selector_list, &self.results);
+            }
+        }
+    }
+};
+
+/// Cuts `elements` into one contiguous range per task.
+fn splitRange(tasks: []Task, elements: []const *Element) void {
+    for (tasks, 0..) |*task, i| {
+        const start = elements.len * i / tasks.len;
+        const end = elements.len * (i + 1) / tasks.len;
+        task.* = .{ .elements = elements[start..end] };
+    }
+}
+
+/// Cuts `units` into one run of consecutive units per task.
+fn splitUnits(tasks: []Task, units: []const Unit) void {
+    for (tasks, 0..) |*task, i| {
+        const start = units.len * i / tasks.len;
+        const end = units.len * (i + 1) / tasks.len;
+        task.* = .{ .units = units[start..end] };
+    }
+}
+
+/// Fills `units` with the tree of `root` in tree order: split level by
+/// level until there are at least `target` units or nothing left to split.
+fn splitTree(allocator: Allocator, units: *std.ArrayList(Unit), root: *Element, target: usize) !void {
+    try units.append(allocator, .{ .element = root, .subtree = true });
+
+    var next = std.ArrayList(Unit){};
+    defer next.deinit(allocator);
+
+    while (units.items.len < target) {
+        next.clearRetainingCapacity();
+        var split_any = false;
+        for (units.items) |unit| {
+            if (!unit.subtree or unit.element.firstElementChild() == null) {
+                try next.append(allocator, unit);
+                continue;
+            }
+            split_any = true;
+            try next.append(allocator, .{ .element = unit.element, .subtree = false });
+            var child = unit.element.firstElementChild();
+            while (child) |elem| : (child = elem.nextElementSibling()) {
+                try next.append(allocator, .{ .element = elem, .subtree = true });
+            }
+        }
+        if (!split_any) break;
+        std.mem.swap(std.ArrayList(Unit), units, &next);
+    }
+}
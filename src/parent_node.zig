@@ -474,6 +474,8 @@ pub fn replaceChildren(self: *Node, nodes: []const NodeOrString) !void {
 /// // Order: third, first, second
 /// ```
 pub fn moveBefore(self: *Node, node: *Node, child: ?*Node) !void {
+    try self.checkMutable();
+
     // [CEReactions] scope for custom element lifecycle callbacks (Phase 5)
     const doc_node = self.owner_document orelse self;
     const is_document = doc_node.node_type == .document;
@@ -492,6 +494,16 @@ pub fn moveBefore(self: *Node, node: *Node, child: ?*Node) !void {
     }
 }
 
+/// Drops `node`'s subtree from the document order index of `parent`'s
+/// document, if enabled.
+fn forgetDocumentOrder(parent: *Node, node: *Node) void {
+    const doc_node = parent.owner_document orelse parent;
+    if (doc_node.node_type != .document) return;
+    const Document = @import("document.zig").Document;
+    const doc: *Document = @fieldParentPtr("prototype", doc_node);
+    if (doc.order_index) |index| index.forgetSubtree(node);
+}
+
 fn moveBeforeImpl(self: *Node, node: *Node, child: ?*Node) !void {
     // Step 1: Verify node is a child of this
     if (node.parent_node != self) {
@@ -512,6 +524,11 @@ fn moveBeforeImpl(self: *Node, node: *Node, child: ?*Node) !void {
 
     // Step 4: Remove node from current position
     // We don't use removeChild because we're just moving within same parent
+    const range_mod = @import("range.zig");
+    range_mod.nodeWillBeRemoved(node, self);
+    @import("node_iterator.zig").nodeWillBeRemoved(node, node.previous_sibling);
+    // Its subtree's tree-order numbers no longer hold
+    if (self.isConnected()) forgetDocumentOrder(self, node);
     // Update sibling pointers
     if (node.previous_sibling) |prev| {
         prev.next_sibling = node.next_sibling;
@@ -528,6 +545,7 @@ fn moveBeforeImpl(self: *Node, node: *Node, child: ?*Node) !void {
     }
 
     // Step 5: Insert node before child (or append if child is null)
+    range_mod.nodesWillBeInserted(self, child, 1);
     if (child) |ref_child| {
         // Insert before ref_child
         node.next_sibling = ref_child;
@@ -562,6 +580,7 @@ fn moveBeforeImpl(self: *Node, node: *Node, child: ?*Node) !void {
     // No need to update document maps (same parent, same document)
 
     self.generation += 1;
+    self.noteMutation();
 
     // Queue mutation record for childList (optional, for MutationObserver)
     const node_mod = @import("node.zig");
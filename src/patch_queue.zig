@@ -0,0 +1,187 @@
+//! Patch Queue - Patches submitted to a document from other threads
+//!
+//! Only the thread that owns a document may mutate it, but updates are
+//! often produced elsewhere (network threads decoding server patches).
+//! Those threads `submit` patch buffers in the `tree_diff` format, with
+//! the node tables they index, to the document's queue; the owning thread
+//! applies everything queued with `drain`, typically at a task boundary.
+//!
+//! ## Design
+//!
+//! The queue is an intrusive lock-free stack of patch copies. `submit`
+//! copies the buffer and its tables into one allocation, validates it and
+//! pushes it with a compare-and-swap; `drain` takes the whole stack with
+//! one atomic swap, reverses it into submission order and replays the
+//! patches inside one mutation batch. Neither side takes a lock, and the
+//! consumer never races a producer for the same entry, so there is no ABA
+//! hazard.
+//!
+//! `submit` reports whether it found the queue empty. Only that producer
+//! needs to wake the owning thread: later submissions land in the same
+//! drain, so a burst of patches costs one wakeup.
+//!
+//! ## Node Tables
+//!
+//! Tables hold plain pointers, and a queued patch takes no references
+//! (node reference counts are not atomic outside shared documents).
+//! Submitters must only name nodes the owning thread keeps alive until
+//! the patch is drained, e.g. nodes it handed out and still references.
+
+const std = @import("std");
+const Allocator = std.mem.Allocator;
+const Node = @import("node.zig").Node;
+const Document = @import("document.zig").Document;
+const tree_diff = @import("tree_diff.zig");
+
+/// A queued patch; its node tables and buffer follow it in the same
+/// allocation.
+const Entry = struct {
+    next: ?*Entry,
+    allocator: Allocator,
+    target_count: usize,
+    source_count: usize,
+    length: usize,
+
+    fn allocationSize(target_count: usize, source_count: usize, length: usize) usize {
+        return @sizeOf(Entry) + (target_count + source_count) * @sizeOf(*Node) + length;
+    }
+
+    fn create(allocator: Allocator, bytes: []const u8, target_nodes: []const *Node, source_nodes: []const *Node) Allocator.Error!*Entry {
+        const memory = try allocator.alignedAlloc(u8, .of(Entry), allocationSize(target_nodes.len, source_nodes.len, bytes.len));
+        const entry: *Entry = @ptrCast(memory.ptr);
+        entry.* = .{
+            .next = null,
+            .allocator = allocator,
+            .target_count = target_nodes.len,
+            .source_count = source_nodes.len,
+            .length = bytes.len,
+        };
+        @memcpy(entry.targets(), target_nodes);
+        @memcpy(entry.sources(), source_nodes);
+        @memcpy(entry.buffer(), bytes);
+        return entry;
+    }
+
+    fn destroy(self: *Entry) void {
+        const memory: [*]align(@alignOf(Entry)) u8 = @ptrCast(self);
+        self.allocator.free(memory[0..allocationSize(self.target_count, self.source_count, self.length)]);
+    }
+
+    fn nodes(self: *Entry) [*]*Node {
+        return @ptrCast(@alignCast(@as([*]u8, @ptrCast(self)) + @sizeOf(Entry)));
+    }
+
+    fn targets(self: *Entry) []*Node {
+        return self.nodes()[0..self.target_count];
+    }
+
+    fn sources(self: *Entry) []*Node {
+        return self.nodes()[self.target_count..][0..self.source_count];
+    }
+
+    fn buffer(self: *Entry) []align(4) u8 {
+        // Pointer tables keep the buffer pointer-aligned
+        const start = @as([*]u8, @ptrCast(self)) + @sizeOf(Entry) + (self.target_count + self.source_count) * @sizeOf(*Node);
+        return @alignCast(start[0..self.length]);
+    }
+};
+
+/// Result of `PatchQueue.drain`.
+pub const DrainResult = struct {
+    /// Patches taken from the queue (applied, or failed part-way)
+    drained: usize = 0,
+
+    /// Error of the first patch that failed; the patches after it still ran
+    first_error: ?anyerror = null,
+};
+
+/// Multi-producer, single-consumer queue of patches for one document.
+pub const PatchQueue = struct {
+    /// Most recently submitted entry; older entries follow `next`
+    head: std.atomic.Value(?*Entry) = .init(null),
+
+    /// Copies a patch and queues it. Safe to call from any thread.
+    ///
+    /// `bytes` is any patch in the `tree_diff` format (no alignment
+    /// needed); `allocator` must be usable from the draining thread too.
+    ///
+    /// ## Returns
+    /// True if the queue was empty, i.e. the caller should wake the
+    /// owning thread to drain it.
+    ///
+    /// ## Errors
+    /// - `error.SyntaxError`: `bytes` is not a valid patch (nothing queued)
+    /// - `error.OutOfMemory`: The copy could not be allocated
+    pub fn submit(
+        self: *PatchQueue,
+        allocator: Allocator,
+        bytes: []const u8,
+        targets: []const *Node,
+        sources: []const *Node,
+    ) !bool {
+        const entry = try Entry.create(allocator, bytes, targets, sources);
+        // Checked here, off the owning thread
+        tree_diff.validate(entry.buffer()) catch |err| {
+            entry.destroy();
+            return err;
+        };
+
+        var head = self.head.load(.monotonic);
+        while (true) {
+            entry.next = head;
+            head = self.head.cmpxchgWeak(head, entry, .release, .monotonic) orelse return entry.next == null;
+        }
+    }
+
+    /// Returns true if no patch is queued. A hint only: producers may
+    /// submit right after it returns.
+    pub fn isEmpty(self: *const PatchQueue) bool {
+        return self.head.load(.monotonic) == null;
+    }
+
+    /// Applies every queued patch to `doc` in submission order, inside one
+    /// mutation batch. Owning thread only. `allocator` holds temporary
+    /// replay state.
+    ///
+    /// A failing patch stops at its failing op (see `tree_diff.replay`)
+    /// and the remaining patches still run.
+    pub fn drain(self: *PatchQueue, allocator: Allocator, doc: *Document) DrainResult {
+        var entry = reverse(self.head.swap(null, .acquire));
+        var result = DrainResult{};
+        if (entry == null) return result;
+
+        doc.beginBatch();
+        defer doc.endBatch() catch unreachable;
+
+        while (entry) |current| {
+            entry = current.next;
+            defer current.destroy();
+            result.drained += 1;
+            tree_diff.replay(allocator, doc, current.buffer(), current.targets(), current.sources()) catch |err| {
+                if (result.first_error == null) result.first_error = err;
+            };
+        }
+        return result;
+    }
+
+    /// Frees every queued patch without applying it. No producer may
+    /// submit concurrently.
+    pub fn deinit(self: *PatchQueue) void {
+        var entry = self.head.swap(null, .acquire);
+        while (entry) |current| {
+            entry = current.next;
+            current.destroy();
+        }
+    }
+
+    fn reverse(first: ?*Entry) ?*Entry {
+        var reversed: ?*Entry = null;
+        var entry = first;
+        while (entry) |current| {
+            entry = current.next;
+            current.next = reversed;
+            reversed = current;
+        }
+        return reversed;
+    }
+};
@@ -230,6 +230,8 @@ const Allocator = std.mem.Allocator;
 const text_mod = @import("text.zig");
 const Text = text_mod.Text;
 const node_mod = @import("node.zig");
+const range_mod = @import("range.zig");
+const character_data = @import("character_data.zig");
 const Node = node_mod.Node;
 const NodeVTable = node_mod.NodeVTable;
 const Event = @import("event.zig").Event;
@@ -504,8 +506,10 @@ pub const ProcessingInstruction = struct {
     fn deinitImpl(node: *Node) void {
         const text: *Text = @fieldParentPtr("prototype", node);
         const pi: *ProcessingInstruction = @fieldParentPtr("prototype", text);
+        node.deinitRareData();
+        node.dropNodeId();
         node.allocator.free(pi.target);
-        node.allocator.free(pi.prototype.data);
+        character_data.freeData(&pi.prototype);
         node.allocator.destroy(pi);
     }
 
@@ -532,9 +536,10 @@ pub const ProcessingInstruction = struct {
         // Replace data
         const data = try node.allocator.dupe(u8, new_value);
 
-        node.allocator.free(pi.prototype.data);
-        pi.prototype.data = data;
+        character_data.takeData(&pi.prototype, data);
         node.generation += 1;
+        node.invalidateHashes();
+        range_mod.dataReplaced(node, 0, old_value.len, data.len);
 
         // Queue mutation record for characterData
         node_mod.queueMutationRecord(
@@ -438,6 +438,8 @@ const NodeType = @import("node.zig").NodeType;
 const Document = @import("document.zig").Document;
 const DocumentFragment = @import("document_fragment.zig").DocumentFragment;
 const DOMError = @import("validation.zig").DOMError;
+const document_order = @import("document_order.zig");
+const tree_helpers = @import("tree_helpers.zig");
 
 /// Range error types per WHATWG DOM specification.
 ///
@@ -614,8 +616,14 @@ pub const AbstractRange = struct {
 /// - Interface: https://dom.spec.whatwg.org/#interface-range
 /// - WebIDL: dom.idl lines 496-532
 ///
+/// ## Live Ranges
+/// Ranges are live: tree and character data mutations update their
+/// boundary points (see "Live Range Updates" below). A range is listed in
+/// the RareData of each of its boundary containers, so a mutation only
+/// visits the ranges anchored in the nodes it changes.
+///
 /// ## Memory Layout
-/// Size: 40 bytes (AbstractRange fields + allocator)
+/// Size: 48 bytes (AbstractRange fields + allocator + live flag)
 pub const Range = struct {
     /// Start boundary container node (from AbstractRange).
     start_container: *Node,
@@ -632,6 +640,11 @@ pub const Range = struct {
     /// Allocator for content manipulation.
     allocator: Allocator,
 
+    /// Registered with its boundary containers and updated by mutations.
+    /// Cleared when a boundary container is destroyed while the range is
+    /// still alive; the range then keeps its (stale) boundary points.
+    live: bool,
+
     /// Creates a new collapsed range at document start.
     ///
     /// ## WebIDL
@@ -660,13 +673,17 @@ pub const Range = struct {
     /// ```
     pub fn init(allocator: Allocator, doc: *Document) !*Range {
         const self = try allocator.create(Range);
+        errdefer allocator.destroy(self);
         self.* = .{
             .start_container = &doc.prototype,
             .start_offset = 0,
             .end_container = &doc.prototype,
             .end_offset = 0,
             .allocator = allocator,
+            .live = true,
         };
+        try registerLiveRange(&doc.prototype, self);
+        _ = live_range_count.fetchAdd(1, .monotonic);
         return self;
     }
 
@@ -680,9 +697,49 @@ pub const Range = struct {
     /// defer range.deinit();
     /// ```
     pub fn deinit(self: *Range) void {
+        if (self.live) {
+            unregisterLiveRange(self.start_container, self);
+            if (self.end_container != self.start_container) {
+                unregisterLiveRange(self.end_container, self);
+            }
+            _ = live_range_count.fetchSub(1, .monotonic);
+        }
         self.allocator.destroy(self);
     }
 
+    /// Moves both boundary points, keeping the containers' live range
+    /// lists in step. On error nothing has changed.
+    fn setBoundaries(self: *Range, start: BoundaryPoint, end: BoundaryPoint) Allocator.Error!void {
+        const old_start = self.start_container;
+        const old_end = self.end_container;
+
+        if (self.live) {
+            const add_start = start.container != old_start and start.container != old_end;
+            const add_end = end.container != old_start and end.container != old_end and end.container != start.container;
+            if (add_start) try registerLiveRange(start.container, self);
+            if (add_end) {
+                registerLiveRange(end.container, self) catch |err| {
+                    if (add_start) unregisterLiveRange(start.container, self);
+                    return err;
+                };
+            }
+        }
+
+        self.start_container = start.container;
+        self.start_offset = start.offset;
+        self.end_container = end.container;
+        self.end_offset = end.offset;
+
+        if (self.live) {
+            if (old_start != start.container and old_start != end.container) {
+                unregisterLiveRange(old_start, self);
+            }
+            if (old_end != old_start and old_end != start.container and old_end != end.container) {
+                unregisterLiveRange(old_end, self);
+            }
+        }
+    }
+
     /// Returns true if start and end boundary points are equal.
     ///
     /// ## WebIDL
@@ -740,16 +797,14 @@ pub const Range = struct {
         }
 
         // Step 3-4: Set start boundary
-        self.start_container = node;
-        self.start_offset = offset;
-
-        // Step 5: If end is now before start, collapse to start
-        const bp_start = BoundaryPoint{ .container = self.start_container, .offset = self.start_offset };
+        const bp_start = BoundaryPoint{ .container = node, .offset = offset };
         const bp_end = BoundaryPoint{ .container = self.end_container, .offset = self.end_offset };
 
+        // Step 5: If end is now before start, collapse to start
         if (compareBoundaryPointsImpl(bp_end, bp_start) == .before) {
-            self.end_container = node;
-            self.end_offset = offset;
+            try self.setBoundaries(bp_start, bp_start);
+        } else {
+            try self.setBoundaries(bp_start, bp_end);
         }
     }
 
@@ -796,16 +851,55 @@ pub const Range = struct {
         }
 
         // Step 3-4: Set end boundary
-        self.end_container = node;
-        self.end_offset = offset;
+        const bp_start = BoundaryPoint{ .container = self.start_container, .offset = self.start_offset };
+        const bp_end = BoundaryPoint{ .container = node, .offset = offset };
 
         // Step 5: If start is now after end, collapse to end
-        const bp_start = BoundaryPoint{ .container = self.start_container, .offset = self.start_offset };
-        const bp_end = BoundaryPoint{ .container = self.end_container, .offset = self.end_offset };
+        if (compareBoundaryPointsImpl(bp_start, bp_end) == .after) {
+            try self.setBoundaries(bp_end, bp_end);
+        } else {
+            try self.setBoundaries(bp_start, bp_end);
+        }
+    }
+
+    /// Sets both boundary points at once.
+    ///
+    /// Non-standard. Same result as `setStart(start_node, start_offset)`
+    /// followed by `setEnd(end_node, end_offset)`: if the end is before the
+    /// start, the range collapses to the end. Both
+    /// points are validated before anything changes, and the range is
+    /// re-registered with its containers once.
+    ///
+    /// ## Errors
+    /// - `InvalidNodeTypeError`: either node is DocumentType
+    /// - `IndexSizeError`: an offset > its node's length
+    ///
+    /// ## Usage
+    /// ```zig
+    /// try range.setBaseAndExtent(&first.prototype, 2, &last.prototype, 3);
+    /// ```
+    pub fn setBaseAndExtent(
+        self: *Range,
+        start_node: *Node,
+        start_offset: u32,
+        end_node: *Node,
+        end_offset: u32,
+    ) RangeError!void {
+        if (start_node.node_type == .document_type or end_node.node_type == .document_type) {
+            return error.InvalidNodeTypeError;
+        }
+        if (start_offset > nodeLength(start_node) or end_offset > nodeLength(end_node)) {
+            return error.IndexSizeError;
+        }
 
+        const bp_start = BoundaryPoint{ .container = start_node, .offset = start_offset };
+        const bp_end = BoundaryPoint{ .container = end_node, .offset = end_offset };
+
+        // setEnd's step 5: a start after the end collapses to the end
         if (compareBoundaryPointsImpl(bp_start, bp_end) == .after) {
-            self.start_container = node;
-            self.start_offset = offset;
+            try self.setBoundaries(bp_end, bp_end);
+        } else {
+            try self.setBoundaries(bp_start, bp_end);
         }
     }
 
@@ -840,15 +934,13 @@ pub const Range = struct {
     /// try range.collapse(false);
     /// ```
     pub fn collapse(self: *Range, toStart: bool) void {
-        if (toStart) {
-            // Collapse to start
-            self.end_container = self.start_container;
-            self.end_offset = self.start_offset;
-        } else {
-            // Collapse to end
-            self.start_container = self.end_container;
-            self.start_offset = self.end_offset;
-        }
+        const point = if (toStart)
+            BoundaryPoint{ .container = self.start_container, .offset = self.start_offset }
+        else
+            BoundaryPoint{ .container = self.end_container, .offset = self.end_offset };
+
+        // Dropping a container never allocates
+        self.setBoundaries(point, point) catch unreachable;
     }
 
     /// Selects the contents of a node.
@@ -895,10 +987,10 @@ pub const Range = struct {
         const length = nodeLength(node);
 
         // Steps 3-4: Set boundaries
-        self.start_container = node;
-        self.start_offset = 0;
-        self.end_container = node;
-        self.end_offset = length;
+        try self.setBoundaries(
+            .{ .container = node, .offset = 0 },
+            .{ .container = node, .offset = length },
+        );
     }
 
     /// Sets start boundary to just before a node.
@@ -1057,10 +1149,10 @@ pub const Range = struct {
     pub fn selectNode(self: *Range, node: *Node) RangeError!void {
         const parent = node.parent_node orelse return error.InvalidNodeTypeError;
         const index = try nodeIndex(node);
-        self.start_container = parent;
-        self.start_offset = index;
-        self.end_container = parent;
-        self.end_offset = index + 1;
+        try self.setBoundaries(
+            .{ .container = parent, .offset = index },
+            .{ .container = parent, .offset = index + 1 },
+        );
     }
 
     /// Returns the deepest node that contains both boundary points.
@@ -1623,13 +1715,25 @@ pub const Range = struct {
     /// ```
     pub fn cloneRange(self: *const Range) RangeError!*Range {
         const cloned = try self.allocator.create(Range);
+        errdefer self.allocator.destroy(cloned);
         cloned.* = .{
             .start_container = self.start_container,
             .start_offset = self.start_offset,
             .end_container = self.end_container,
             .end_offset = self.end_offset,
             .allocator = self.allocator,
+            .live = self.live,
         };
+        if (cloned.live) {
+            try registerLiveRange(cloned.start_container, cloned);
+            if (cloned.end_container != cloned.start_container) {
+                registerLiveRange(cloned.end_container, cloned) catch |err| {
+                    unregisterLiveRange(cloned.start_container, cloned);
+                    return err;
+                };
+            }
+            _ = live_range_count.fetchAdd(1, .monotonic);
+        }
         return cloned;
     }
 
@@ -1716,97 +1820,95 @@ pub const Range = struct {
         var result = std.ArrayList(u8){};
         defer result.deinit(allocator);
 
-        // Traverse all nodes in the range in tree order and collect text
-        try self.collectTextInRange(allocator, &result);
+        const Collector = struct {
+            list: *std.ArrayList(u8),
+            allocator: Allocator,
+
+            fn append(collector: @This(), segment: []const u8) Allocator.Error!void {
+                try collector.list.appendSlice(collector.allocator, segment);
+            }
+        };
+        try self.forEachTextSegment(Collector{ .list = &result, .allocator = allocator }, Collector.append);
 
         return result.toOwnedSlice(allocator);
     }
 
-    /// Collects all text content within the range in tree order.
+    /// Calls `emit` with each piece of the range's string, in tree order.
+    ///
+    /// The pieces concatenate to `toString()`: the partial start and end
+    /// Text data and every contained Text node's data. Each piece is a
+    /// slice of the node's own data, so nothing is copied; the slices are
+    /// valid until the next mutation and `emit` must not mutate the tree.
+    /// Empty pieces are skipped.
     ///
-    /// This implements the WHATWG algorithm for gathering text:
-    /// 1. If start container is Text, include partial text from start offset to end
-    /// 2. Include all Text nodes fully contained in range
-    /// 3. If end container is Text (and different from start), include partial text from 0 to end offset
-    fn collectTextInRange(
+    /// ## Usage
+    /// ```zig
+    /// const Counter = struct {
+    ///     fn add(total: *usize, segment: []const u8) Allocator.Error!void {
+    ///         total.* += segment.len;
+    ///     }
+    /// };
+    /// var total: usize = 0;
+    /// try range.forEachTextSegment(&total, Counter.add);
+    /// ```
+    pub fn forEachTextSegment(
         self: *const Range,
-        allocator: Allocator,
-        result: *std.ArrayList(u8),
-    ) !void {
-        // Find common ancestor to traverse from
-        const ancestor = findCommonAncestor(self.start_container, self.end_container);
+        context: anytype,
+        comptime emit: fn (@TypeOf(context), []const u8) Allocator.Error!void,
+    ) Allocator.Error!void {
+        if (self.collapsed()) {
+            return;
+        }
 
-        // Traverse tree in document order
-        try self.traverseAndCollect(allocator, result, ancestor);
+        if (self.start_container == self.end_container and
+            self.start_container.node_type == .text)
+        {
+            const Text = @import("text.zig").Text;
+            const text_node: *const Text = @fieldParentPtr("prototype", self.start_container);
+            try emit(context, text_node.data[self.start_offset..self.end_offset]);
+            return;
+        }
+
+        // Traverse tree in document order from the common ancestor
+        const ancestor = findCommonAncestor(self.start_container, self.end_container);
+        try self.traverseAndEmit(ancestor, context, emit);
     }
 
-    /// Traverses nodes in tree order and collects text based on range boundaries.
-    fn traverseAndCollect(
+    /// Traverses nodes in tree order and emits text based on range boundaries.
+    fn traverseAndEmit(
         self: *const Range,
-        allocator: Allocator,
-        result: *std.ArrayList(u8),
         node: *Node,
-    ) !void {
+        context: anytype,
+        comptime emit: fn (@TypeOf(context), []const u8) Allocator.Error!void,
+    ) Allocator.Error!void {
         // For each node, determine its relationship to the range
         const position = self.getNodePosition(node);
 
-        switch (position) {
-            .before, .after => return, // Node is outside range
-
-            .partial_start => {
+        if (node.node_type == .text) {
+            const Text = @import("text.zig").Text;
+            const text_node: *const Text = @fieldParentPtr("prototype", node);
+            const segment = switch (position) {
+                .before, .after, .contains_range => return,
                 // This node contains the start boundary
-                if (node.node_type == .text) {
-                    const Text = @import("text.zig").Text;
-                    const text_node: *const Text = @fieldParentPtr("prototype", node);
-                    const end_offset = if (node == self.end_container) self.end_offset else text_node.data.len;
-                    try result.appendSlice(allocator, text_node.data[self.start_offset..end_offset]);
-                } else {
-                    // Traverse children
-                    var child = node.first_child;
-                    while (child) |c| {
-                        try self.traverseAndCollect(allocator, result, c);
-                        child = c.next_sibling;
-                    }
-                }
-            },
-
-            .partial_end => {
+                .partial_start => text_node.data[self.start_offset..if (node == self.end_container) self.end_offset else text_node.data.len],
                 // This node contains the end boundary (but not start)
-                if (node.node_type == .text) {
-                    const Text = @import("text.zig").Text;
-                    const text_node: *const Text = @fieldParentPtr("prototype", node);
-                    try result.appendSlice(allocator, text_node.data[0..self.end_offset]);
-                } else {
-                    // Traverse children
-                    var child = node.first_child;
-                    while (child) |c| {
-                        try self.traverseAndCollect(allocator, result, c);
-                        child = c.next_sibling;
-                    }
-                }
-            },
-
-            .contained => {
+                .partial_end => text_node.data[0..self.end_offset],
                 // Node is fully contained in range
-                if (node.node_type == .text) {
-                    const Text = @import("text.zig").Text;
-                    const text_node: *const Text = @fieldParentPtr("prototype", node);
-                    try result.appendSlice(allocator, text_node.data);
-                } else {
-                    // Traverse children
-                    var child = node.first_child;
-                    while (child) |c| {
-                        try self.traverseAndCollect(allocator, result, c);
-                        child = c.next_sibling;
-                    }
-                }
-            },
+                .contained => text_node.data,
+            };
+            if (segment.len > 0) {
+                try emit(context, segment);
+            }
+            return;
+        }
 
-            .contains_range => {
-                // Node contains both boundaries - traverse children
+        switch (position) {
+            .before, .after => return, // Node is outside range
+            .partial_start, .partial_end, .contained, .contains_range => {
+                // Traverse children
                 var child = node.first_child;
                 while (child) |c| {
-                    try self.traverseAndCollect(allocator, result, c);
+                    try self.traverseAndEmit(c, context, emit);
                     child = c.next_sibling;
                 }
             },
@@ -1910,7 +2012,7 @@ pub const Range = struct {
             if (action == .extract or action == .clone) {
                 // Get document from start container
                 const doc = getOwnerDocument(self.start_container);
-                return try DocumentFragment.create(doc.prototype.allocator);
+                return try DocumentFragment.create(doc.nodeAllocator());
             }
             return null;
         }
@@ -1919,7 +2021,7 @@ pub const Range = struct {
         var fragment: ?*DocumentFragment = null;
         if (action != .delete) {
             const doc = getOwnerDocument(self.start_container);
-            fragment = try DocumentFragment.create(doc.prototype.allocator);
+            fragment = try DocumentFragment.create(doc.nodeAllocator());
         }
         errdefer if (fragment) |f| f.prototype.release();
 
@@ -2004,21 +2106,7 @@ pub const Range = struct {
                 current_child = child.next_sibling;
             }
 
-            // Process collected children
-            for (children_to_process.items) |child| {
-                if (action == .clone) {
-                    const cloned = child.cloneNode(true) catch |err| return err;
-                    _ = fragment.?.prototype.appendChild(cloned) catch unreachable;
-                } else {
-                    // Extract or delete
-                    _ = try container.removeChild(child);
-                    if (action == .extract) {
-                        _ = fragment.?.prototype.appendChild(child) catch unreachable;
-                    } else {
-                        child.release();
-                    }
-                }
-            }
+            try self.processContainedRun(action, container, children_to_process.items, fragment);
 
             // Collapse to start for delete/extract
             if (action != .clone) {
@@ -2027,6 +2115,33 @@ pub const Range = struct {
         }
     }
 
+    /// Processes `nodes`, a run of consecutive children of `parent` fully
+    /// contained in the range. Extract and delete unlink the run as one
+    /// sibling chain; extract and clone append it to the fragment in one
+    /// step, so each touched parent gets one childList record.
+    fn processContainedRun(
+        self: *Range,
+        action: ContentAction,
+        parent: *Node,
+        nodes: []const *Node,
+        fragment: ?*DocumentFragment,
+    ) RangeError!void {
+        if (nodes.len == 0) return;
+        const node_mod = @import("node.zig");
+
+        if (action != .clone) {
+            const target: ?*Node = if (action == .extract) &fragment.?.prototype else null;
+            return node_mod.moveChildRun(parent, nodes, target);
+        }
+
+        var clones = try std.ArrayList(*Node).initCapacity(self.allocator, nodes.len);
+        defer clones.deinit(self.allocator);
+        errdefer for (clones.items) |clone| clone.release();
+
+        for (nodes) |node| clones.appendAssumeCapacity(try node.cloneNode(true));
+        node_mod.appendRun(&fragment.?.prototype, clones.items);
+    }
+
     /// Processes contents when start and end are in different containers.
     fn processDifferentContainers(
         self: *Range,
@@ -2107,19 +2222,7 @@ pub const Range = struct {
         }
 
         // Process complete nodes between start and end
-        for (nodes_to_process.items) |node| {
-            if (action == .clone) {
-                const cloned = node.cloneNode(true) catch |err| return err;
-                _ = fragment.?.prototype.appendChild(cloned) catch unreachable;
-            } else {
-                _ = try common_ancestor.removeChild(node);
-                if (action == .extract) {
-                    _ = fragment.?.prototype.appendChild(node) catch unreachable;
-                } else {
-                    node.release();
-                }
-            }
-        }
+        try self.processContainedRun(action, common_ancestor, nodes_to_process.items, fragment);
 
         // Process end container (partial)
         if (original_end_container.node_type == .text or original_end_container.node_type == .comment) {
@@ -2161,14 +2264,242 @@ pub const Range = struct {
 
         // Collapse to start for delete/extract
         if (action != .clone) {
-            self.start_container = original_start_container;
-            self.start_offset = original_start_offset;
-            self.end_container = original_start_container;
-            self.end_offset = original_start_offset;
+            const start = BoundaryPoint{ .container = original_start_container, .offset = original_start_offset };
+            try self.setBoundaries(start, start);
         }
     }
 };
 
+// === Live Range Updates ===
+//
+// Mutation hooks for live ranges (WHATWG DOM §4.2.3, §4.10). Tree and
+// character data algorithms call them; each one only reads the live range
+// lists of the nodes the mutation changes, so its cost follows the number
+// of ranges anchored there, not the number of ranges alive.
+
+/// Ranges currently registered with their containers, in every document.
+/// Lets removal skip the subtree walk when no range exists at all. Counted
+/// process-wide rather than per thread: a document built on one thread
+/// and handed to another takes its ranges along, and a per-thread count
+/// would then skip their updates or underflow when they are destroyed.
+var live_range_count = std.atomic.Value(usize).init(0);
+
+fn registerLiveRange(node: *Node, range: *Range) Allocator.Error!void {
+    const rare = try node.ensureRareData();
+    try rare.addLiveRange(range);
+}
+
+fn unregisterLiveRange(node: *Node, range: *Range) void {
+    if (node.rare_data) |rare| rare.removeLiveRange(range);
+}
+
+fn liveRanges(node: *const Node) []const *anyopaque {
+    const rare = node.rare_data orelse return &[_]*anyopaque{};
+    return rare.getLiveRanges();
+}
+
+fn liveRangeAt(node: *const Node, i: usize) *Range {
+    return @ptrCast(@alignCast(liveRanges(node)[i]));
+}
+
+/// Moves every boundary point in `node` to (`container`, `offset` +
+/// its own offset, when `keep_offset`). Best effort: a range that cannot
+/// be registered with `container` keeps its old boundary points.
+fn moveBoundaries(node: *Node, container: *Node, offset: u32, keep_offset: bool) void {
+    // Backwards: moving a range out of `node` swap-removes its entry,
+    // which only pulls an already visited entry into the current slot
+    var i = liveRanges(node).len;
+    while (i > 0) {
+        i -= 1;
+        const range = liveRangeAt(node, i);
+        var start = BoundaryPoint{ .container = range.start_container, .offset = range.start_offset };
+        var end = BoundaryPoint{ .container = range.end_container, .offset = range.end_offset };
+        if (start.container == node) start = .{ .container = container, .offset = if (keep_offset) offset + start.offset else offset };
+        if (end.container == node) end = .{ .container = container, .offset = if (keep_offset) offset + end.offset else offset };
+        range.setBoundaries(start, end) catch {};
+    }
+}
+
+/// Insert steps: `count` nodes are about to be inserted into `parent`
+/// before `child`. Boundary points in `parent` after `child` move right.
+pub fn nodesWillBeInserted(parent: *Node, child: ?*Node, count: usize) void {
+    const ref = child orelse return; // Appending: no offset is past the end
+    if (liveRanges(parent).len == 0) return;
+
+    const index = nodeIndex(ref) catch return;
+    const delta: u32 = @intCast(count);
+    for (liveRanges(parent)) |entry| {
+        const range: *Range = @ptrCast(@alignCast(entry));
+        if (range.start_container == parent and range.start_offset > index) range.start_offset += delta;
+        if (range.end_container == parent and range.end_offset > index) range.end_offset += delta;
+    }
+}
+
+/// Removing steps: `node` is about to be removed from `parent`. Boundary
+/// points inside `node` move to (`parent`, index of `node`), and those in
+/// `parent` after it move left.
+pub fn nodeWillBeRemoved(node: *Node, parent: *Node) void {
+    if (live_range_count.load(.monotonic) == 0) return;
+
+    const index = nodeIndex(node) catch return;
+    moveSubtreeBoundaries(node, parent, index);
+
+    for (liveRanges(parent)) |entry| {
+        const range: *Range = @ptrCast(@alignCast(entry));
+        if (range.start_container == parent and range.start_offset > index) range.start_offset -= 1;
+        if (range.end_container == parent and range.end_offset > index) range.end_offset -= 1;
+    }
+}
+
+/// Removing steps for `nodes`, consecutive children of `parent` removed
+/// together: boundary points inside them move to (`parent`, index of the
+/// first one), and those in `parent` past the run move left by its
+/// length, as if the nodes were removed one by one.
+pub fn nodesWillBeRemoved(parent: *Node, nodes: []const *Node) void {
+    if (live_range_count.load(.monotonic) == 0) return;
+
+    const index = nodeIndex(nodes[0]) catch return;
+    for (nodes) |node| moveSubtreeBoundaries(node, parent, index);
+
+    const count: u32 = @intCast(nodes.len);
+    for (liveRanges(parent)) |entry| {
+        const range: *Range = @ptrCast(@alignCast(entry));
+        if (range.start_container == parent and range.start_offset > index) {
+            range.start_offset = if (range.start_offset > index + count) range.start_offset - count else index;
+        }
+        if (range.end_container == parent and range.end_offset > index) {
+            range.end_offset = if (range.end_offset > index + count) range.end_offset - count else index;
+        }
+    }
+}
+
+/// Removing steps for all of `parent`'s children at once (a fragment
+/// being inserted): every boundary point in or below `parent` ends up at
+/// (`parent`, 0), as if the children were removed one by one.
+pub fn childrenWillBeRemoved(parent: *Node) void {
+    if (live_range_count.load(.monotonic) == 0) return;
+
+    var child = parent.first_child;
+    while (child) |c| : (child = c.next_sibling) {
+        moveSubtreeBoundaries(c, parent, 0);
+    }
+
+    for (liveRanges(parent)) |entry| {
+        const range: *Range = @ptrCast(@alignCast(entry));
+        if (range.start_container == parent) range.start_offset = 0;
+        if (range.end_container == parent) range.end_offset = 0;
+    }
+}
+
+/// Moves the boundary points of every inclusive descendant of `root` to
+/// (`container`, `offset`).
+fn moveSubtreeBoundaries(root: *Node, container: *Node, offset: u32) void {
+    // Inclusive descendants of root, in tree order
+    var current: ?*Node = root;
+    while (current) |n| {
+        if (liveRanges(n).len > 0) moveBoundaries(n, container, offset, false);
+
+        if (n.first_child) |first| {
+            current = first;
+            continue;
+        }
+        var up: ?*Node = n;
+        current = null;
+        while (up) |u| : (up = u.parent_node) {
+            if (u == root) break;
+            if (u.next_sibling) |next| {
+                current = next;
+                break;
+            }
+        }
+    }
+}
+
+/// Replace data steps: `count` units of `node`'s data at `offset` were
+/// replaced by `data_len` units (`count` clamped to the old length).
+pub fn dataReplaced(node: *Node, offset: usize, count: usize, data_len: usize) void {
+    const start: u32 = @intCast(offset);
+    const end: u32 = @intCast(offset + count);
+    for (liveRanges(node)) |entry| {
+        const range: *Range = @ptrCast(@alignCast(entry));
+        if (range.start_container == node) range.start_offset = replacedOffset(range.start_offset, start, end, data_len);
+        if (range.end_container == node) range.end_offset = replacedOffset(range.end_offset, start, end, data_len);
+    }
+}
+
+fn replacedOffset(point: u32, start: u32, end: u32, data_len: usize) u32 {
+    if (point <= start) return point;
+    if (point <= end) return start;
+    return @intCast(@as(usize, point - end) + start + data_len);
+}
+
+/// splitText steps: `node`'s data after `offset` (`removed_len` units)
+/// moved into `new_node`, which was inserted after `node` if it has a
+/// parent. Boundary points past the split follow the moved data.
+pub fn textSplit(node: *Node, new_node: *Node, offset: usize, removed_len: usize) void {
+    const split: u32 = @intCast(offset);
+    if (node.parent_node) |parent| {
+        var i = liveRanges(node).len;
+        while (i > 0) {
+            i -= 1;
+            const range = liveRangeAt(node, i);
+            var start = BoundaryPoint{ .container = range.start_container, .offset = range.start_offset };
+            var end = BoundaryPoint{ .container = range.end_container, .offset = range.end_offset };
+            if (start.container == node and start.offset > split) start = .{ .container = new_node, .offset = start.offset - split };
+            if (end.container == node and end.offset > split) end = .{ .container = new_node, .offset = end.offset - split };
+            range.setBoundaries(start, end) catch {};
+        }
+
+        if (liveRanges(parent).len > 0) {
+            const after = (nodeIndex(node) catch return) + 1;
+            for (liveRanges(parent)) |entry| {
+                const range: *Range = @ptrCast(@alignCast(entry));
+                if (range.start_container == parent and range.start_offset == after) range.start_offset += 1;
+                if (range.end_container == parent and range.end_offset == after) range.end_offset += 1;
+            }
+        }
+    }
+
+    dataReplaced(node, offset, removed_len, 0);
+}
+
+/// normalize() steps: `merged`'s data was appended to `node`, whose data
+/// was `length` units long. Boundary points in `merged`, or in its parent
+/// right before it, move into `node`. Call before `merged` is removed.
+pub fn textMerged(node: *Node, merged: *Node, length: usize) void {
+    const base: u32 = @intCast(length);
+    if (liveRanges(merged).len > 0) moveBoundaries(merged, node, base, true);
+
+    const parent = merged.parent_node orelse return;
+    if (liveRanges(parent).len == 0) return;
+
+    const index = nodeIndex(merged) catch return;
+    var i = liveRanges(parent).len;
+    while (i > 0) {
+        i -= 1;
+        const range = liveRangeAt(parent, i);
+        var start = BoundaryPoint{ .container = range.start_container, .offset = range.start_offset };
+        var end = BoundaryPoint{ .container = range.end_container, .offset = range.end_offset };
+        if (start.container == parent and start.offset == index) start = .{ .container = node, .offset = base };
+        if (end.container == parent and end.offset == index) end = .{ .container = node, .offset = base };
+        range.setBoundaries(start, end) catch {};
+    }
+}
+
+/// `node` is being destroyed with live ranges still anchored in it. They
+/// stop being live and are unlisted from their other container; their
+/// boundary points are left as they are.
+pub fn containerDestroyed(node: *Node) void {
+    for (liveRanges(node)) |entry| {
+        const range: *Range = @ptrCast(@alignCast(entry));
+        if (!range.live) continue;
+        const other = if (range.start_container == node) range.end_container else range.start_container;
+        if (other != node) unregisterLiveRange(other, range);
+        range.live = false;
+        _ = live_range_count.fetchSub(1, .monotonic);
+    }
+}
+
 // === Helper Types and Functions ===
 
 /// Boundary point for internal comparisons.
@@ -2287,15 +2618,7 @@ fn compareBoundaryPointsImpl(a: BoundaryPoint, b: BoundaryPoint) BoundaryPointPo
 
 /// Returns true if ancestor contains descendant (inclusive).
 fn nodeContains(ancestor: *Node, descendant: *Node) bool {
-    if (ancestor == descendant) return true;
-
-    var current = descendant.parent_node;
-    while (current) |parent| {
-        if (parent == ancestor) return true;
-        current = parent.parent_node;
-    }
-
-    return false;
+    return ancestor.contains(descendant);
 }
 
 /// Returns the child index offset that contains or is an ancestor of node.
@@ -2323,6 +2646,10 @@ const TreeOrder = enum {
 };
 
 fn nodeTreeOrder(a: *Node, b: *Node) TreeOrder {
+    if (document_order.relation(a, b)) |relation| {
+        return if (relation == .before or relation == .ancestor) .before else .after;
+    }
+
     // Find common ancestor
     const ancestor = findCommonAncestor(a, b);
 
@@ -2353,22 +2680,16 @@ fn nodeTreeOrder(a: *Node, b: *Node) TreeOrder {
 
 /// Finds lowest common ancestor of two nodes.
 fn findCommonAncestor(a: *Node, b: *Node) *Node {
-    // Quick check: same node
-    if (a == b) return a;
-
-    // Check if one contains the other
-    if (nodeContains(a, b)) return a;
-    if (nodeContains(b, a)) return b;
-
-    // Walk ancestors of a, checking if each contains b
-    var ancestor = a;
-    while (ancestor.parent_node) |parent| {
-        if (nodeContains(parent, b)) return parent;
-        ancestor = parent;
+    // Bring the deeper node up to the other's depth, then climb both
+    // until they meet: O(depth) however far apart the nodes are
+    var x: *const Node = if (a.depth > b.depth) tree_helpers.ancestorAtDepth(a, b.depth) else a;
+    var y: *const Node = if (b.depth > a.depth) tree_helpers.ancestorAtDepth(b, a.depth) else b;
+    while (x != y) {
+        // Different trees: a's root, as the walk would end there
+        x = x.parent_node orelse break;
+        y = y.parent_node.?;
     }
-
-    // Should not reach here if both in same tree
-    return ancestor;
+    return @constCast(x);
 }
 
 /// Gets the owner document of a node.
@@ -191,6 +191,15 @@ const Event = @import("event.zig").Event;
 pub const EventCallback = @import("event_target.zig").EventCallback;
 pub const EventListener = @import("event_target.zig").EventListener;
 
+/// Returns the listener bitmap bit of an event type (one of 64).
+///
+/// Dispatch computes it once per event and tests it against each node's
+/// `capture_types` / `bubble_types`.
+pub fn eventTypeBit(event_type: []const u8) u64 {
+    const hash = std.hash.Wyhash.hash(0, event_type);
+    return @as(u64, 1) << @as(u6, @truncate(hash));
+}
+
 /// Rare data storage for Node.
 ///
 /// Allocated on-demand when node uses rare features.
@@ -213,11 +222,21 @@ pub const NodeRareData = struct {
     /// Key: event type, Value: list of listeners for that type
     event_listeners: ?std.StringHashMap(std.ArrayList(EventListener)),
 
+    /// Event types with capture / bubble listeners, one `eventTypeBit()`
+    /// per type. Bits are shared between types, so a set bit means "maybe";
+    /// a clear bit lets dispatch skip this node without a map lookup.
+    capture_types: u64,
+    bubble_types: u64,
+
     /// Mutation observer registrations (allocated when first observer registered)
     /// WEAK pointers - MutationObserver owns registrations, not Node
     /// Registrations removed automatically when observer.disconnect() called
     mutation_observers: ?std.ArrayList(*anyopaque),
 
+    /// Live ranges with a boundary point in this node, each listed once
+    /// WEAK pointers - Range registers and unregisters itself (range.zig)
+    live_ranges: ?std.ArrayList(*anyopaque),
+
     /// User data (allocated when first data set)
     /// Key: data key, Value: opaque user data pointer
     user_data: ?std.StringHashMap(*anyopaque),
@@ -241,6 +260,11 @@ pub const NodeRareData = struct {
     /// WEAK reference - slot element owns itself, this node doesn't own the slot
     assigned_slot: ?*anyopaque,
 
+    /// UTF-16 offset tables of long non-ASCII character data (allocated on
+    /// first conversion, see character_data.zig)
+    /// OWNING pointer - rebuilt lazily after edits
+    utf16_chunks: ?*@import("character_data.zig").Utf16Chunks,
+
     /// Creates a new RareData structure.
     ///
     /// All fields initialized to null (allocated on first use).
@@ -248,25 +272,23 @@ pub const NodeRareData = struct {
         return .{
             .allocator = allocator,
             .event_listeners = null,
+            .capture_types = 0,
+            .bubble_types = 0,
             .mutation_observers = null,
+            .live_ranges = null,
             .user_data = null,
             .custom_element_data = null,
             .animation_data = null,
             .shadow_root = null,
             .assigned_slot = null,
+            .utf16_chunks = null,
         };
     }
 
     /// Cleans up all allocated rare data.
     pub fn deinit(self: *NodeRareData) void {
         // Clean up event listeners
-        if (self.event_listeners) |*listeners| {
-            var it = listeners.iterator();
-            while (it.next()) |entry| {
-                entry.value_ptr.deinit(self.allocator);
-            }
-            listeners.deinit();
-        }
+        self.releaseEventListeners();
 
         // Clean up mutation observers ArrayList
         // Note: Pointers are WEAK (MutationObserver owns registrations)
@@ -275,11 +297,22 @@ pub const NodeRareData = struct {
             list.deinit(self.allocator);
         }
 
+        // Clean up live range list (pointers are WEAK)
+        if (self.live_ranges) |*list| {
+            list.deinit(self.allocator);
+        }
+
         // Clean up user data
         if (self.user_data) |*data| {
             data.deinit();
         }
 
+        // Clean up UTF-16 offset tables (OWNING pointer)
+        if (self.utf16_chunks) |chunks| {
+            chunks.deinit(self.allocator);
+            self.allocator.destroy(chunks);
+        }
+
         // Clean up shadow root (OWNING pointer)
         if (self.shadow_root) |shadow_ptr| {
             const ShadowRoot = @import("shadow_root.zig").ShadowRoot;
@@ -307,6 +340,39 @@ pub const NodeRareData = struct {
         return &self.user_data.?;
     }
 
+    // === Live Range Management ===
+
+    /// Lists a live range as having a boundary point in this node.
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to allocate storage
+    pub fn addLiveRange(self: *NodeRareData, range: *anyopaque) !void {
+        if (self.live_ranges == null) {
+            self.live_ranges = std.ArrayList(*anyopaque){};
+        }
+        try self.live_ranges.?.append(self.allocator, range);
+    }
+
+    /// Unlists a live range. Does not preserve order, and only moves an
+    /// entry from the end of the list into the removed slot.
+    pub fn removeLiveRange(self: *NodeRareData, range: *anyopaque) void {
+        const list = if (self.live_ranges) |*l| l else return;
+        for (list.items, 0..) |item, i| {
+            if (item == range) {
+                _ = list.swapRemove(i);
+                return;
+            }
+        }
+    }
+
+    /// Returns the live ranges with a boundary point in this node.
+    pub fn getLiveRanges(self: *const NodeRareData) []const *anyopaque {
+        if (self.live_ranges) |list| {
+            return list.items;
+        }
+        return &[_]*anyopaque{};
+    }
+
     // === Event Listener Management ===
 
     /// Adds an event listener for the specified event type.
@@ -325,11 +391,15 @@ pub const NodeRareData = struct {
         }
 
         try result.value_ptr.append(self.allocator, listener);
+
+        const bit = eventTypeBit(listener.event_type);
+        if (listener.capture) self.capture_types |= bit else self.bubble_types |= bit;
     }
 
     /// Removes an event listener.
     ///
-    /// Matches by event type, callback pointer, and capture phase.
+    /// Matches by event type, callback pointer, and capture phase, and runs
+    /// the removed listener's release hook.
     ///
     /// ## Returns
     /// true if listener was found and removed, false otherwise
@@ -339,26 +409,114 @@ pub const NodeRareData = struct {
         callback: EventCallback,
         capture: bool,
     ) bool {
+        const removed = self.takeListener(event_type, callback, null, capture) orelse return false;
+        removed.release();
+        return true;
+    }
+
+    /// Removes the listener registered with exactly `callback`, `context`
+    /// and `capture`, and returns it without running its release hook.
+    ///
+    /// Bindings that register many listeners through one shared callback
+    /// tell them apart by context. Dispatch uses this for "once" listeners,
+    /// releasing them only after they have been invoked.
+    pub fn takeEventListener(
+        self: *NodeRareData,
+        event_type: []const u8,
+        callback: EventCallback,
+        context: *anyopaque,
+        capture: bool,
+    ) ?EventListener {
+        return self.takeListener(event_type, callback, context, capture);
+    }
+
+    /// Returns true if the listener registered with exactly `callback`,
+    /// `context` and `capture` is still registered for `event_type`.
+    pub fn containsEventListener(
+        self: *const NodeRareData,
+        event_type: []const u8,
+        callback: EventCallback,
+        context: *anyopaque,
+        capture: bool,
+    ) bool {
+        for (self.getEventListeners(event_type)) |listener| {
+            if (listener.callback == callback and listener.context == context and listener.capture == capture) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// Removes every event listener, running their release hooks.
+    pub fn releaseEventListeners(self: *NodeRareData) void {
         if (self.event_listeners) |*listeners| {
-            if (listeners.getPtr(event_type)) |list| {
-                // Find matching listener
-                for (list.items, 0..) |listener, i| {
-                    if (listener.callback == callback and listener.capture == capture) {
-                        _ = list.swapRemove(i);
-
-                        // Clean up empty list
-                        if (list.items.len == 0) {
-                            list.deinit(self.allocator);
-                            _ = listeners.remove(event_type);
-                        }
-
-                        return true;
-                    }
+            var it = listeners.iterator();
+            while (it.next()) |entry| {
+                for (entry.value_ptr.items) |listener| {
+                    listener.release();
                 }
+                entry.value_ptr.deinit(self.allocator);
+            }
+            listeners.deinit();
+            self.event_listeners = null;
+        }
+        self.capture_types = 0;
+        self.bubble_types = 0;
+    }
+
+    /// Returns false if no listener for the phase can match `type_bit`
+    /// (from `eventTypeBit()`); true means there may be one.
+    pub fn mayHaveEventListeners(self: *const NodeRareData, type_bit: u64, capture: bool) bool {
+        const types = if (capture) self.capture_types else self.bubble_types;
+        return types & type_bit != 0;
+    }
+
+    /// Rebuilds the type bitmaps from the registered listeners.
+    fn recomputeListenerTypes(self: *NodeRareData) void {
+        self.capture_types = 0;
+        self.bubble_types = 0;
+        const listeners = self.event_listeners orelse return;
+        var it = listeners.iterator();
+        while (it.next()) |entry| {
+            const bit = eventTypeBit(entry.key_ptr.*);
+            for (entry.value_ptr.items) |listener| {
+                if (listener.capture) self.capture_types |= bit else self.bubble_types |= bit;
             }
         }
+    }
 
-        return false;
+    /// Removes the first listener matching `callback` and `capture` (and
+    /// `context`, when given). Keeps the remaining listeners in
+    /// registration order, which is the order dispatch invokes them in.
+    fn takeListener(
+        self: *NodeRareData,
+        event_type: []const u8,
+        callback: EventCallback,
+        context: ?*anyopaque,
+        capture: bool,
+    ) ?EventListener {
+        const listeners = if (self.event_listeners) |*map| map else return null;
+        const list = listeners.getPtr(event_type) orelse return null;
+
+        for (list.items, 0..) |listener, i| {
+            if (listener.callback != callback or listener.capture != capture) continue;
+            if (context) |ctx| {
+                if (listener.context != ctx) continue;
+            }
+
+            const removed = list.orderedRemove(i);
+
+            // Clean up empty list
+            if (list.items.len == 0) {
+                list.deinit(self.allocator);
+                _ = listeners.remove(event_type);
+            }
+            self.recomputeListenerTypes();
+
+            return removed;
+        }
+
+        return null;
     }
 
     /// Returns all event listeners for a specific event type.
@@ -125,6 +125,21 @@
 //! ### Utilities
 //! - `validation` - Tree mutation validation
 //! - `tree_helpers` - Tree traversal utilities
+//! - `tree_snapshot` - Flat preorder subtree serialization
+//! - `tree_diff` - Keyed patch streams between two subtrees
+//! - `patch_queue` - Lock-free queue of patches from other threads
+//! - `sliced_query` - querySelectorAll in time-budgeted steps
+//! - `idle_work` - Budgeted index upkeep for the embedder's idle time
+//! - `document_image` - Binary document images loaded with mmap
+//! - `structural_hash` - Cached subtree fingerprints for isEqualNode
+//! - `match_cache` - Remembered matches() answers per element
+//! - `node_table` - Integer node handles for wrapper-free traversal
+//! - `tree_builder` - Push-style tree construction in document order
+//! - `template` - Precompiled subtrees instantiated in one pass
+//! - `serializer` - Streaming subtree to UTF-8 markup
+//! - `markup_parser` - UTF-8 markup to a DocumentFragment in one pass
+//! - `string_utils` - UTF-16 offsets and vectorized byte scanning
+//! - `mutation_batch` - Mutation record queues as packed tables
 //! - `selector.Tokenizer` - CSS selector tokenization
 //!
 //! ## Performance Characteristics
@@ -132,7 +147,7 @@
 //! ### Memory
 //! - Node: 96 bytes (target achieved)
 //! - Element: Node + 32 bytes
-//! - Text/Comment: Node + 16 bytes
+//! - Text/Comment: Node + 24 bytes
 //! - Document: Node + string pool
 //! - RareData: Allocated only when needed (40-50% savings)
 //!
@@ -182,6 +197,7 @@ pub const NodeVTable = @import("node.zig").NodeVTable;
 pub const Element = @import("element.zig").Element;
 pub const BloomFilter = @import("element.zig").BloomFilter;
 pub const AttributeMap = @import("element.zig").AttributeMap;
+pub const AttributeInit = @import("element.zig").AttributeInit;
 
 // Export character data module (base for Text and Comment)
 pub const character_data = @import("character_data.zig");
@@ -202,11 +218,17 @@ pub const Event = @import("event.zig").Event;
 pub const EventInit = @import("event.zig").EventInit;
 pub const CustomEvent = @import("custom_event.zig").CustomEvent;
 pub const CustomEventInit = @import("custom_event.zig").CustomEventInit;
+pub const EventPool = @import("event_pool.zig").EventPool;
+pub const PooledEvent = @import("event_pool.zig").PooledEvent;
 pub const ShadowRoot = @import("shadow_root.zig").ShadowRoot;
 pub const SelectorCache = @import("document.zig").SelectorCache;
+pub const ParsedSelector = @import("document.zig").ParsedSelector;
 // Export document modules
 pub const Document = @import("document.zig").Document;
 pub const StringPool = @import("document.zig").StringPool;
+pub const Capacity = @import("document.zig").Capacity;
+pub const StringRemap = @import("document.zig").StringRemap;
+pub const SharedNames = @import("document.zig").SharedNames;
 pub const DocumentFragment = @import("document_fragment.zig").DocumentFragment;
 pub const DOMImplementation = @import("dom_implementation.zig").DOMImplementation;
 
@@ -214,6 +236,7 @@ pub const DOMImplementation = @import("dom_implementation.zig").DOMImplementatio
 pub const NodeRareData = @import("rare_data.zig").NodeRareData;
 pub const EventListener = @import("rare_data.zig").EventListener;
 pub const EventCallback = @import("rare_data.zig").EventCallback;
+pub const eventTypeBit = @import("rare_data.zig").eventTypeBit;
 
 // Export mutation observer (Phase 17)
 pub const MutationObserver = @import("mutation_observer.zig").MutationObserver;
@@ -221,6 +244,8 @@ pub const MutationRecord = @import("mutation_observer.zig").MutationRecord;
 pub const MutationObserverInit = @import("mutation_observer.zig").MutationObserverInit;
 pub const MutationCallback = @import("mutation_observer.zig").MutationCallback;
 pub const MutationObserverRegistration = @import("mutation_observer.zig").MutationObserverRegistration;
+pub const MutationRecordBatch = @import("mutation_batch.zig").MutationRecordBatch;
+pub const mutation_batch = @import("mutation_batch.zig");
 
 // Export range (Phase 18)
 pub const AbstractRange = @import("range.zig").AbstractRange;
@@ -230,10 +255,12 @@ pub const BoundaryPointComparison = @import("range.zig").BoundaryPointComparison
 // Export static range (Phase 19)
 pub const StaticRange = @import("static_range.zig").StaticRange;
 pub const StaticRangeInit = @import("static_range.zig").StaticRangeInit;
+pub const StaticRangePool = @import("static_range.zig").StaticRangePool;
 
 // Export traversal (Phase 21)
 pub const NodeFilter = @import("node_filter.zig").NodeFilter;
 pub const FilterResult = @import("node_filter.zig").FilterResult;
+pub const ElementFilter = @import("node_filter.zig").ElementFilter;
 pub const NodeIterator = @import("node_iterator.zig").NodeIterator;
 pub const TreeWalker = @import("tree_walker.zig").TreeWalker;
 
@@ -246,7 +273,10 @@ pub const DOMTokenList = @import("dom_token_list.zig").DOMTokenList;
 pub const AbortSignal = @import("abort_signal.zig").AbortSignal;
 pub const AbortController = @import("abort_controller.zig").AbortController;
 pub const AbortAlgorithm = @import("abort_signal.zig").AbortAlgorithm;
+pub const DOMException = @import("abort_signal.zig").DOMException;
 pub const SignalRareData = @import("abort_signal_rare_data.zig").SignalRareData;
+pub const TimeoutQueue = @import("abort_timeout.zig").TimeoutQueue;
+pub const TimerHost = @import("abort_timeout.zig").TimerHost;
 
 // Export mixins (Phase 16)
 pub const child_node = @import("child_node.zig");
@@ -255,6 +285,18 @@ pub const parent_node = @import("parent_node.zig");
 // Export validation and helpers (internal)
 pub const validation = @import("validation.zig");
 pub const tree_helpers = @import("tree_helpers.zig");
+pub const tree_snapshot = @import("tree_snapshot.zig");
+pub const tree_diff = @import("tree_diff.zig");
+pub const patch_queue = @import("patch_queue.zig");
+pub const document_image = @import("document_image.zig");
+pub const structural_hash = @import("structural_hash.zig");
+pub const tree_builder = @import("tree_builder.zig");
+pub const TreeBuilder = @import("tree_builder.zig").TreeBuilder;
+pub const template = @import("template.zig");
+pub const Template = @import("template.zig").Template;
+pub const serializer = @import("serializer.zig");
+pub const markup_parser = @import("markup_parser.zig");
+pub const string_utils = @import("string_utils.zig");
 
 // Export selector module (Phase 4 - querySelector)
 pub const selector = struct {
@@ -267,6 +309,8 @@ pub const selector = struct {
     pub const CompoundSelector = @import("selector/parser.zig").CompoundSelector;
     pub const SimpleSelector = @import("selector/parser.zig").SimpleSelector;
     pub const Combinator = @import("selector/parser.zig").Combinator;
+    pub const AncestorFilter = @import("selector/ancestor_filter.zig").AncestorFilter;
+    pub const AncestorHashes = @import("selector/ancestor_filter.zig").AncestorHashes;
 };
 pub const Tokenizer = selector.Tokenizer;
 pub const Token = selector.Token;
@@ -277,8 +321,19 @@ pub const Combinator = selector.Combinator;
 // Export fast path optimization modules
 pub const FastPathType = @import("fast_path.zig").FastPathType;
 pub const detectFastPath = @import("fast_path.zig").detectFastPath;
+pub const parseFastPath = @import("fast_path.zig").parseFastPath;
+pub const FastPathSelector = @import("fast_path.zig").FastPathSelector;
+pub const FastPathStats = @import("fast_path.zig").FastPathStats;
 pub const extractIdentifier = @import("fast_path.zig").extractIdentifier;
 pub const ElementIterator = @import("element_iterator.zig").ElementIterator;
+pub const SlicedQuery = @import("sliced_query.zig").SlicedQuery;
+pub const sliced_query = @import("sliced_query.zig");
+pub const idle_work = @import("idle_work.zig");
+pub const ClosestMemo = @import("closest_memo.zig").ClosestMemo;
+pub const match_cache = @import("match_cache.zig");
+pub const MatchCache = @import("match_cache.zig").MatchCache;
+pub const node_table = @import("node_table.zig");
+pub const NodeTable = @import("node_table.zig").NodeTable;
 
 // Export custom elements (Phase 1 - Registry Foundation)
 pub const CustomElementRegistry = @import("custom_element_registry.zig").CustomElementRegistry;
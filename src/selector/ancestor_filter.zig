@@ -0,0 +1,174 @@
+//! Ancestor Bloom Filter for Selector Matching
+//!
+//! Counting Bloom filter over the tag names, ids and classes of the elements
+//! on the current traversal path, as in WebKit's SelectorFilter. While
+//! querySelectorAll walks the tree it pushes each element before visiting
+//! its children and pops it afterwards, so the filter always describes the
+//! ancestors of the element being matched.
+//!
+//! A complex selector such as `.a .b leaf` needs an ancestor with class `a`
+//! and one with class `b`. Their hashes are collected once per query; a
+//! candidate whose ancestor filter is missing any of them cannot match and
+//! is rejected in O(1), without walking its ancestors.
+//!
+//! ## False Positives Only
+//!
+//! The filter may say "maybe" for identifiers that are not present (the
+//! matcher then runs as usual) but never "no" for ones that are. Names are
+//! hashed exactly as the matcher compares them: tag names and ids byte for
+//! byte, classes split on spaces.
+//!
+//! ## Usage
+//!
+//! ```zig
+//! var filter = AncestorFilter{};
+//! filter.pushAncestorsOf(root); // root and everything above it
+//!
+//! const hashes = AncestorHashes.fromComplex(&selector_list.selectors[0]);
+//! filter.push(child);
+//! if (filter.mayMatch(&hashes)) {
+//!     // run the full matcher on grandchildren...
+//! }
+//! filter.pop(child);
+//! ```
+
+const std = @import("std");
+const Element = @import("../element.zig").Element;
+const parser = @import("parser.zig");
+const ComplexSelector = parser.ComplexSelector;
+const CompoundSelector = parser.CompoundSelector;
+
+/// log2 of the counter table size (4096 counters, 4 KB)
+const table_bits = 12;
+const table_size = 1 << table_bits;
+const table_mask = table_size - 1;
+
+/// Hash seeds, so a class and a tag with the same text hash differently
+const tag_seed: u64 = 0x7461_67;
+const id_seed: u64 = 0x6964;
+const class_seed: u64 = 0x636c_6173_73;
+
+/// Maximum ancestor hashes kept per complex selector (as in WebKit)
+pub const max_hashes = 4;
+
+fn hashName(seed: u64, name: []const u8) u32 {
+    return @truncate(std.hash.Wyhash.hash(seed, name));
+}
+
+/// Identifier hashes a complex selector requires among the ancestors.
+pub const AncestorHashes = struct {
+    hashes: [max_hashes]u32 = undefined,
+    len: u8 = 0,
+
+    /// Collects the tag, id and class names of every compound that must
+    /// match an ancestor of the subject, i.e. every compound to the left of
+    /// a child or descendant combinator.
+    pub fn fromComplex(complex: *const ComplexSelector) AncestorHashes {
+        var result = AncestorHashes{};
+        var i: usize = complex.combinators.len;
+        while (i > 0 and result.len < max_hashes) {
+            i -= 1;
+            switch (complex.combinators[i].combinator) {
+                .Child, .Descendant => {
+                    const left = if (i == 0) &complex.compound else &complex.combinators[i - 1].compound;
+                    result.addCompound(left);
+                },
+                // The left compound matches a sibling, not an ancestor
+                .NextSibling, .SubsequentSibling => {},
+            }
+        }
+        return result;
+    }
+
+    fn addCompound(self: *AncestorHashes, compound: *const CompoundSelector) void {
+        for (compound.simple_selectors) |simple| {
+            const hash = switch (simple) {
+                .Type => |type_sel| hashName(tag_seed, type_sel.tag_name),
+                .Id => |id_sel| hashName(id_seed, id_sel.id),
+                .Class => |class_sel| hashName(class_seed, class_sel.class_name),
+                else => continue,
+            };
+            if (self.len == max_hashes) return;
+            self.hashes[self.len] = hash;
+            self.len += 1;
+        }
+    }
+};
+
+/// Counting Bloom filter of the current ancestor path.
+pub const AncestorFilter = struct {
+    /// Saturating counters; a saturated counter is never decremented
+    counters: [table_size]u8 = [_]u8{0} ** table_size,
+
+    /// Adds `element` (call before visiting its children).
+    pub fn push(self: *AncestorFilter, element: *const Element) void {
+        forEachHash(element, self, add);
+    }
+
+    /// Removes `element` (call after visiting its children).
+    pub fn pop(self: *AncestorFilter, element: *const Element) void {
+        forEachHash(element, self, remove);
+    }
+
+    /// Pushes `element` and all of its element ancestors.
+    pub fn pushAncestorsOf(self: *AncestorFilter, element: *const Element) void {
+        var current: ?*const Element = element;
+        while (current) |elem| {
+            self.push(elem);
+            const parent = elem.prototype.parent_node orelse break;
+            if (parent.node_type != .element) break;
+            const parent_elem: *const Element = @fieldParentPtr("prototype", parent);
+            current = parent_elem;
+        }
+    }
+
+    /// Returns false if some required ancestor identifier is definitely
+    /// missing from the path, true if the selector may match.
+    pub fn mayMatch(self: *const AncestorFilter, required: *const AncestorHashes) bool {
+        for (required.hashes[0..required.len]) |hash| {
+            if (!self.mayContain(hash)) return false;
+        }
+        return true;
+    }
+
+    /// Two counters per hash, from the low and high bits
+    fn slotsOf(hash: u32) [2]u32 {
+        return .{ hash & table_mask, (hash >> 16) & table_mask };
+    }
+
+    fn mayContain(self: *const AncestorFilter, hash: u32) bool {
+        const slots = slotsOf(hash);
+        return self.counters[slots[0]] != 0 and self.counters[slots[1]] != 0;
+    }
+
+    fn add(self: *AncestorFilter, hash: u32) void {
+        for (slotsOf(hash)) |slot| {
+            if (self.counters[slot] != std.math.maxInt(u8)) {
+                self.counters[slot] += 1;
+            }
+        }
+    }
+
+    fn remove(self: *AncestorFilter, hash: u32) void {
+        for (slotsOf(hash)) |slot| {
+            const count = self.counters[slot];
+            if (count != 0 and count != std.math.maxInt(u8)) {
+                self.counters[slot] = count - 1;
+            }
+        }
+    }
+
+    fn forEachHash(element: *const Element, self: *AncestorFilter, comptime op: fn (*AncestorFilter, u32) void) void {
+        op(self, hashName(tag_seed, element.tag_name));
+        if (element.getAttribute("id")) |id| {
+            op(self, hashName(id_seed, id));
+        }
+        if (element.getAttribute("class")) |class_attr| {
+            // Split like the matcher's class comparison
+            var it = std.mem.tokenizeScalar(u8, class_attr, ' ');
+            while (it.next()) |class| {
+                op(self, hashName(class_seed, class));
+            }
+        }
+    }
+};
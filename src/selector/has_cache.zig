@@ -0,0 +1,74 @@
+//! :has() Subtree Match Cache
+//!
+//! `E:has(arg)` holds if some descendant of E matches `arg`. Answered
+//! directly, every candidate walks its whole subtree, so a query such as
+//! `item:has(leaf)` over nested items is quadratic: each item walks the
+//! items below it again. Whether a subtree contains a match does not depend
+//! on who asks, so the answer is kept per (element, argument) and computed
+//! bottom-up: an element's answer is its children's matches or answers,
+//! each computed once, which makes a whole query linear in the tree size.
+//!
+//! ## Validity
+//!
+//! Entries are valid for one mutation version of the document (any child
+//! list or attribute change below an element may change its answer, and
+//! bumps the version). Arguments are identified by their SelectorList id,
+//! which is never reused, rather than by address. Only connected elements
+//! are cached: a node is freed only after being removed, which bumps the
+//! version, so a cached element pointer never names another node.
+//!
+//! The document keeps one cache for its queries; frozen documents, which
+//! may be queried on several threads, leave it alone and give each query
+//! task its own (see parallel_query.zig).
+
+const std = @import("std");
+const Allocator = std.mem.Allocator;
+const Element = @import("../element.zig").Element;
+
+/// Past this many entries the cache starts over (bounds its memory)
+pub const max_entries = 1 << 18;
+
+pub const HasCache = struct {
+    allocator: Allocator,
+
+    /// Mutation version the entries were computed at
+    version: u64 = 0,
+
+    results: std.AutoHashMapUnmanaged(Key, bool) = .{},
+
+    const Key = struct {
+        element: *const Element,
+        argument: u64,
+    };
+
+    pub fn init(allocator: Allocator) HasCache {
+        return .{ .allocator = allocator };
+    }
+
+    pub fn deinit(self: *HasCache) void {
+        self.results.deinit(self.allocator);
+    }
+
+    /// Drops every entry if they were computed at another version.
+    pub fn prepare(self: *HasCache, version: u64) void {
+        if (version == self.version) return;
+        self.results.clearRetainingCapacity();
+        self.version = version;
+    }
+
+    /// Number of cached answers.
+    pub fn count(self: *const HasCache) usize {
+        return self.results.count();
+    }
+
+    pub fn get(self: *const HasCache, element: *const Element, argument: u64) ?bool {
+        return self.results.get(.{ .element = element, .argument = argument });
+    }
+
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to grow the cache
+    pub fn put(self: *HasCache, element: *const Element, argument: u64, result: bool) !void {
+        if (self.results.count() >= max_entries) self.results.clearRetainingCapacity();
+        try self.results.put(self.allocator, .{ .element = element, .argument = argument }, result);
+    }
+};
@@ -74,6 +74,8 @@
 //! ### Match Evaluation Flow
 //! ```
 //! matches(elem, SelectorList)
+//!   ├─> matchesDispatched() [lists of several: only the alternatives
+//!   │                        keyed by elem's id, classes or tag]
 //!   └─> matchesComplexSelector(elem, ComplexSelector)
 //!        └─> matchesCompoundSelector(elem, CompoundSelector)
 //!             └─> matchesSimpleSelector(elem, SimpleSelector)
@@ -277,6 +279,8 @@ const AttributeMatcher = parser.AttributeMatcher;
 const PseudoClassSelector = parser.PseudoClassSelector;
 const PseudoClassKind = parser.PseudoClassKind;
 const NthPattern = parser.NthPattern;
+const RightmostDispatch = @import("rightmost_dispatch.zig").RightmostDispatch;
+const HasCache = @import("has_cache.zig").HasCache;
 
 // ============================================================================
 // Matcher Errors
@@ -293,12 +297,21 @@ pub const MatcherError = error{
 pub const Matcher = struct {
     allocator: Allocator,
 
+    /// :has() answers for this matcher's query, instead of the document's
+    /// cache (for frozen documents matched on several threads)
+    has_cache: ?*HasCache = null,
+
     pub fn init(allocator: Allocator) Matcher {
         return .{ .allocator = allocator };
     }
 
     /// Check if element matches selector list (OR semantics)
     pub fn matches(self: *const Matcher, element: *Element, selector_list: *const SelectorList) MatcherError!bool {
+        // Several alternatives: only try those the element's names allow
+        if (selector_list.dispatch) |dispatch| {
+            return try self.matchesDispatched(element, selector_list.selectors, dispatch);
+        }
+
         // Selector list is comma-separated (OR)
         // Element matches if it matches ANY selector in list
         for (selector_list.selectors) |*selector| {
@@ -309,6 +322,42 @@ pub const Matcher = struct {
         return false;
     }
 
+    /// Match a selector list through its rightmost-compound buckets
+    /// (see rightmost_dispatch.zig)
+    fn matchesDispatched(
+        self: *const Matcher,
+        element: *Element,
+        selectors: []const ComplexSelector,
+        dispatch: *const RightmostDispatch,
+    ) MatcherError!bool {
+        if (dispatch.by_id.count() > 0) {
+            if (element.getAttribute("id")) |id| {
+                if (dispatch.by_id.get(id)) |bucket| {
+                    if (try self.matchesAny(element, selectors, bucket.items)) return true;
+                }
+            }
+        }
+        if (dispatch.by_class.items.len > 0 and element.class_bloom.bits != 0) {
+            const class_attr = element.getAttribute("class") orelse "";
+            for (dispatch.by_class.items) |*entry| {
+                if (element.class_bloom.bits & entry.bloom_bits == 0) continue;
+                if (!hasClass(class_attr, entry.class_name)) continue;
+                if (try self.matchesAny(element, selectors, entry.indices.items)) return true;
+            }
+        }
+        if (dispatch.by_tag.get(element.tag_name)) |bucket| {
+            if (try self.matchesAny(element, selectors, bucket.items)) return true;
+        }
+        return try self.matchesAny(element, selectors, dispatch.universal.items);
+    }
+
+    fn matchesAny(self: *const Matcher, element: *Element, selectors: []const ComplexSelector, indices: []const u32) MatcherError!bool {
+        for (indices) |i| {
+            if (try self.matchesComplexSelector(element, &selectors[i])) return true;
+        }
+        return false;
+    }
+
     /// Check if element matches complex selector (combinator chain)
     fn matchesComplexSelector(self: *const Matcher, element: *Element, complex: *const ComplexSelector) MatcherError!bool {
         // Right-to-left matching (standard CSS strategy)
@@ -528,23 +577,55 @@ pub const Matcher = struct {
 
     /// Match :has() pseudo-class (element has descendant matching selector)
     fn matchesHas(self: *const Matcher, element: *Element, selector_list: *const SelectorList) MatcherError!bool {
-        // Check if any descendant matches selector list
+        const cache = if (selector_list.id != 0) self.hasCacheFor(element) else null;
+        return try self.subtreeHas(element, selector_list, cache);
+    }
+
+    /// True if a descendant of element matches selector_list. Answers for
+    /// element and every subtree walked are recorded in cache, so nested
+    /// candidates reuse them (see has_cache.zig).
+    fn subtreeHas(self: *const Matcher, element: *Element, selector_list: *const SelectorList, cache: ?*HasCache) MatcherError!bool {
+        if (cache) |c| {
+            if (c.get(element, selector_list.id)) |known| return known;
+        }
+
+        var result = false;
         var current = element.prototype.first_child;
         while (current) |child_node| {
             if (child_node.node_type == .element) {
                 const child_element: *Element = @fieldParentPtr("prototype", child_node);
                 // Check if child matches
                 if (try self.matches(child_element, selector_list)) {
-                    return true;
+                    result = true;
+                    break;
                 }
                 // Recursively check child's descendants
-                if (try self.matchesHas(child_element, selector_list)) {
-                    return true;
+                if (try self.subtreeHas(child_element, selector_list, cache)) {
+                    result = true;
+                    break;
                 }
             }
             current = child_node.next_sibling;
         }
-        return false;
+
+        if (cache) |c| try c.put(element, selector_list.id, result);
+        return result;
+    }
+
+    /// The :has() cache usable for element: the matcher's own, else its
+    /// connected, unfrozen document's (prepared for its current version)
+    fn hasCacheFor(self: *const Matcher, element: *Element) ?*HasCache {
+        if (self.has_cache) |cache| return cache;
+        if (!element.prototype.isConnected()) return null;
+
+        const owner = element.prototype.owner_document orelse return null;
+        if (owner.node_type != .document) return null;
+        const Document = @import("../document.zig").Document;
+        const doc: *Document = @fieldParentPtr("prototype", owner);
+        if (doc.frozen) return null;
+
+        doc.has_cache.prepare(doc.mutation_version);
+        return &doc.has_cache;
     }
 };
 
@@ -245,6 +245,16 @@
 //! - Input string must outlive parser
 //! - Call `parser.deinit()` to free all AST memory
 //!
+//! ### Compact Parsing
+//!
+//! `parse()` allocates every node slice separately, growing each list as
+//! it goes. `parseCompact()` parses a selector whose nodes fit in
+//! `compact_scratch_size` bytes into a stack buffer first, which measures
+//! it, then again into one allocation of exactly that size; the list is
+//! freed with that one allocation. Selectors compiled once and kept (the
+//! document's selector cache) use it. Larger selectors are parsed as by
+//! `parse()`.
+//!
 //! ## Usage Examples
 //!
 //! ### Simple Selector
@@ -373,6 +383,8 @@ const std = @import("std");
 const Allocator = std.mem.Allocator;
 const Tokenizer = @import("tokenizer.zig").Tokenizer;
 const Token = @import("tokenizer.zig").Token;
+const RightmostDispatch = @import("rightmost_dispatch.zig").RightmostDispatch;
+const min_dispatch_alternatives = @import("rightmost_dispatch.zig").min_alternatives;
 const ArrayList = std.ArrayList;
 
 // ============================================================================
@@ -384,7 +396,31 @@ pub const SelectorList = struct {
     selectors: []ComplexSelector,
     allocator: Allocator,
 
+    /// Alternatives bucketed by rightmost-compound key, for lists of
+    /// several (see rightmost_dispatch.zig)
+    dispatch: ?*RightmostDispatch = null,
+
+    /// Identity for caches keyed by selector (see has_cache.zig); unique
+    /// per parsed list and never reused, 0 for lists not from the parser
+    id: u64 = 0,
+
+    /// The allocation holding every node when parsed by parseCompact()
+    block: ?CompactBlock = null,
+
+    pub const CompactBlock = struct {
+        bytes: []align(compact_alignment) u8,
+        owner: Allocator,
+    };
+
     pub fn deinit(self: *SelectorList) void {
+        if (self.block) |block| {
+            block.owner.free(block.bytes);
+            return;
+        }
+        if (self.dispatch) |dispatch| {
+            dispatch.deinit(self.allocator);
+            self.allocator.destroy(dispatch);
+        }
         for (self.selectors) |*selector| {
             selector.deinit();
         }
@@ -556,6 +592,58 @@ pub const ParserError = error{
     OutOfMemory,
 };
 
+/// Source of SelectorList ids (atomic: selectors are parsed on several threads)
+var next_list_id = std.atomic.Value(u64).init(1);
+
+/// Stack buffer parseCompact() measures a selector in
+pub const compact_scratch_size = 8 * 1024;
+
+/// Longer selectors are not worth measuring (they rarely fit)
+pub const compact_max_input = 256;
+
+/// Both the stack buffer and the block start at this alignment, so the
+/// two passes lay nodes out at the same offsets
+const compact_alignment = 16;
+
+/// Allocator for parseCompact(): hands out `buffer` front to back, grows
+/// only its last allocation in place and never takes memory back, so
+/// `end` is the most a parse ever needed
+const Bump = struct {
+    buffer: []u8,
+    end: usize = 0,
+
+    fn allocator(self: *Bump) Allocator {
+        return .{
+            .ptr = self,
+            .vtable = &.{ .alloc = alloc, .resize = resize, .remap = remap, .free = free },
+        };
+    }
+
+    fn alloc(ctx: *anyopaque, len: usize, alignment: std.mem.Alignment, _: usize) ?[*]u8 {
+        const self: *Bump = @ptrCast(@alignCast(ctx));
+        const base = @intFromPtr(self.buffer.ptr);
+        const start = alignment.forward(base + self.end) - base;
+        if (start + len > self.buffer.len) return null;
+        self.end = start + len;
+        return self.buffer.ptr + start;
+    }
+
+    fn resize(ctx: *anyopaque, memory: []u8, _: std.mem.Alignment, new_len: usize, _: usize) bool {
+        const self: *Bump = @ptrCast(@alignCast(ctx));
+        if (new_len <= memory.len) return true;
+        const start = @intFromPtr(memory.ptr) - @intFromPtr(self.buffer.ptr);
+        if (start + memory.len != self.end or start + new_len > self.buffer.len) return false;
+        self.end = start + new_len;
+        return true;
+    }
+
+    fn remap(ctx: *anyopaque, memory: []u8, alignment: std.mem.Alignment, new_len: usize, ret_addr: usize) ?[*]u8 {
+        return if (resize(ctx, memory, alignment, new_len, ret_addr)) memory.ptr else null;
+    }
+
+    fn free(_: *anyopaque, _: []u8, _: std.mem.Alignment, _: usize) void {}
+};
+
 // ============================================================================
 // Parser
 // ============================================================================
@@ -587,6 +675,50 @@ pub const Parser = struct {
         return try self.parseSelectorList();
     }
 
+    /// Parse complete selector list into a single allocation
+    ///
+    /// The selector is parsed into a stack buffer to measure it, then
+    /// again into one allocation of that size (see "Compact Parsing").
+    /// Selectors that do not fit are parsed as by parse(). Either way the
+    /// list is freed by SelectorList.deinit().
+    pub fn parseCompact(self: *Parser) ParserError!SelectorList {
+        if (self.tokenizer.input.len > compact_max_input) return try self.parseSelectorList();
+
+        const backing = self.allocator;
+        defer self.allocator = backing;
+        const start_pos = self.tokenizer.pos;
+        const start_token = self.current_token;
+
+        // Measure: nodes and their growth, in a stack buffer
+        var scratch: [compact_scratch_size]u8 align(compact_alignment) = undefined;
+        var measure = Bump{ .buffer = &scratch };
+        self.allocator = measure.allocator();
+        _ = self.parseSelectorList() catch |err| switch (err) {
+            error.OutOfMemory => {
+                // Does not fit the buffer
+                self.rewind(start_pos, start_token);
+                self.allocator = backing;
+                return try self.parseSelectorList();
+            },
+            else => return err,
+        };
+
+        // Parse again into one block: a Bump over the rest of the block,
+        // then the nodes at the offsets the first pass gave them
+        const header = std.mem.alignForward(usize, @sizeOf(Bump), compact_alignment);
+        const bytes = try backing.alignedAlloc(u8, std.mem.Alignment.fromByteUnits(compact_alignment), header + measure.end);
+        errdefer backing.free(bytes);
+        const bump: *Bump = @ptrCast(@alignCast(bytes.ptr));
+        bump.* = .{ .buffer = bytes[header..] };
+
+        self.rewind(start_pos, start_token);
+        self.allocator = bump.allocator();
+        var list = try self.parseSelectorList();
+        std.debug.assert(bump.end == measure.end);
+        list.block = .{ .bytes = bytes, .owner = backing };
+        return list;
+    }
+
     // ========================================================================
     // Grammar Rules
     // ========================================================================
@@ -615,10 +747,20 @@ pub const Parser = struct {
             }
         }
 
-        return SelectorList{
+        var list = SelectorList{
             .selectors = try selectors.toOwnedSlice(self.allocator),
             .allocator = self.allocator,
+            .id = next_list_id.fetchAdd(1, .monotonic),
         };
+        errdefer list.deinit();
+
+        if (list.selectors.len >= min_dispatch_alternatives) {
+            const dispatch = try self.allocator.create(RightmostDispatch);
+            errdefer self.allocator.destroy(dispatch);
+            dispatch.* = try RightmostDispatch.init(self.allocator, list.selectors);
+            list.dispatch = dispatch;
+        }
+        return list;
     }
 
     /// Parse complex selector (combinator chain)
@@ -1047,6 +1189,12 @@ pub const Parser = struct {
         };
     }
 
+    /// Go back to an earlier position, with its current token
+    fn rewind(self: *Parser, pos: usize, token: ?Token) void {
+        self.tokenizer.pos = pos;
+        self.current_token = token;
+    }
+
     /// Skip whitespace tokens
     fn skipWhitespace(self: *Parser) void {
         while (self.current_token) |token| {
@@ -0,0 +1,129 @@
+//! Rightmost-Compound Dispatch for Selector Lists
+//!
+//! A selector list `a, b, c` matches an element if any alternative does.
+//! Testing every alternative against every element makes a query over N
+//! alternatives N times slower, although most alternatives are ruled out by
+//! one name: the id, a class or the tag of their rightmost compound, which
+//! the element itself must carry. As in WebKit's RuleSet, the alternatives
+//! are bucketed by that key once, when the list is parsed; an element then
+//! only runs the alternatives in its id's bucket, its tag's bucket, the
+//! buckets of classes it has, and those without a key.
+//!
+//! The traversal is unchanged: querySelector() still stops at the first
+//! element, in tree order, that matches any alternative.
+//!
+//! ## Keys
+//!
+//! The most selective name of the rightmost compound is used: the id,
+//! else the first class, else the tag. Names are compared exactly as the
+//! matcher compares them (byte for byte). Class buckets are few, so they
+//! are a list screened by the element's class Bloom filter, with each
+//! class's bit computed once here.
+
+const std = @import("std");
+const Allocator = std.mem.Allocator;
+const parser = @import("parser.zig");
+const ComplexSelector = parser.ComplexSelector;
+const CompoundSelector = parser.CompoundSelector;
+const BloomFilter = @import("../element.zig").BloomFilter;
+
+/// Lists shorter than this are matched alternative by alternative
+pub const min_alternatives = 2;
+
+pub const RightmostDispatch = struct {
+    /// Indices of alternatives, into `SelectorList.selectors`
+    pub const Bucket = std.ArrayList(u32);
+
+    pub const ClassBucket = struct {
+        class_name: []const u8,
+        bloom_bits: u64,
+        indices: Bucket = .{},
+    };
+
+    /// Keys are slices of the selector list's own names
+    by_id: std.StringHashMapUnmanaged(Bucket) = .{},
+    by_tag: std.StringHashMapUnmanaged(Bucket) = .{},
+    by_class: std.ArrayList(ClassBucket) = .{},
+
+    /// Alternatives whose rightmost compound names no id, class or tag
+    universal: Bucket = .{},
+
+    /// Buckets the alternatives of `selectors` by rightmost-compound key.
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to allocate a bucket
+    pub fn init(allocator: Allocator, selectors: []const ComplexSelector) !RightmostDispatch {
+        var self = RightmostDispatch{};
+        errdefer self.deinit(allocator);
+
+        for (selectors, 0..) |*complex, i| {
+            const index: u32 = @intCast(i);
+            const bucket = switch (keyOf(rightmost(complex))) {
+                .id => |id| try bucketIn(allocator, &self.by_id, id),
+                .class => |class_name| try self.classBucket(allocator, class_name),
+                .tag => |tag| try bucketIn(allocator, &self.by_tag, tag),
+                .none => &self.universal,
+            };
+            try bucket.append(allocator, index);
+        }
+        return self;
+    }
+
+    pub fn deinit(self: *RightmostDispatch, allocator: Allocator) void {
+        inline for (.{ &self.by_id, &self.by_tag }) |map| {
+            var it = map.valueIterator();
+            while (it.next()) |bucket| bucket.deinit(allocator);
+            map.deinit(allocator);
+        }
+        for (self.by_class.items) |*entry| entry.indices.deinit(allocator);
+        self.by_class.deinit(allocator);
+        self.universal.deinit(allocator);
+    }
+
+    const Key = union(enum) {
+        id: []const u8,
+        class: []const u8,
+        tag: []const u8,
+        none,
+    };
+
+    /// The compound that must match the subject element itself
+    fn rightmost(complex: *const ComplexSelector) *const CompoundSelector {
+        if (complex.combinators.len == 0) return &complex.compound;
+        return &complex.combinators[complex.combinators.len - 1].compound;
+    }
+
+    fn keyOf(compound: *const CompoundSelector) Key {
+        var class_name: ?[]const u8 = null;
+        var tag: ?[]const u8 = null;
+        for (compound.simple_selectors) |simple| {
+            switch (simple) {
+                .Id => |id_sel| return .{ .id = id_sel.id },
+                .Class => |class_sel| {
+                    if (class_name == null) class_name = class_sel.class_name;
+                },
+                .Type => |type_sel| tag = type_sel.tag_name,
+                else => {},
+            }
+        }
+        if (class_name) |name| return .{ .class = name };
+        if (tag) |name| return .{ .tag = name };
+        return .none;
+    }
+
+    fn bucketIn(allocator: Allocator, map: *std.StringHashMapUnmanaged(Bucket), name: []const u8) !*Bucket {
+        const gop = try map.getOrPut(allocator, name);
+        if (!gop.found_existing) gop.value_ptr.* = .{};
+        return gop.value_ptr;
+    }
+
+    fn classBucket(self: *RightmostDispatch, allocator: Allocator, class_name: []const u8) !*Bucket {
+        for (self.by_class.items) |*entry| {
+            if (std.mem.eql(u8, entry.class_name, class_name)) return &entry.indices;
+        }
+        var bloom = BloomFilter{};
+        bloom.add(class_name);
+        try self.by_class.append(allocator, .{ .class_name = class_name, .bloom_bits = bloom.bits });
+        return &self.by_class.items[self.by_class.items.len - 1].indices;
+    }
+};
@@ -0,0 +1,273 @@
+//! Serializer - Streaming subtree to UTF-8 markup
+//!
+//! Produces markup for a node and its descendants (outerHTML-style) or its
+//! children only (innerHTML-style) and streams it to a caller-supplied sink
+//! in chunks. Markup is assembled in a fixed stack buffer and handed to the
+//! sink whenever it fills, so serializing allocates nothing: tag and
+//! attribute names and values are copied straight out of the interned
+//! strings the nodes already hold, and character data out of the nodes'
+//! own storage.
+//!
+//! ## Syntax
+//!
+//! - Elements: `<name attr="value">children</name>`. With `xml`, elements
+//!   without children close as `<name/>`. Names are written as stored (the
+//!   qualified name); no namespace declarations are synthesized.
+//! - Text: `&`, `<` and `>` are escaped, and U+00A0 becomes `&nbsp;`
+//!   unless `xml` is set.
+//! - Attribute values: `&`, `"`, `<` and `>` are escaped, as is U+00A0
+//!   unless `xml` is set.
+//! - Comments `<!--data-->`, CDATA sections `<![CDATA[data]]>`, document
+//!   types `<!DOCTYPE name>` and processing instructions `<?target data>`
+//!   (`<?target data?>` with `xml`).
+//! - Documents, fragments and shadow roots serialize as their children.
+//!   The shadow trees of hosts are not included, and Attr nodes produce
+//!   nothing.
+//!
+//! Elements are not special-cased by name (this is a generic DOM), so every
+//! element gets an end tag outside `xml` syntax.
+//!
+//! ## Usage
+//!
+//! ```zig
+//! const Counter = struct {
+//!     fn add(total: *usize, chunk: []const u8) Allocator.Error!void {
+//!         total.* += chunk.len;
+//!     }
+//! };
+//! var total: usize = 0;
+//! try serializer.serialize(&root.prototype, 0, &total, Counter.add);
+//!
+//! // Or, when one buffer is wanted anyway:
+//! const markup = try serializer.serializeAlloc(allocator, &root.prototype, 0);
+//! defer allocator.free(markup);
+//! ```
+
+const std = @import("std");
+const Allocator = std.mem.Allocator;
+const Node = @import("node.zig").Node;
+const Element = @import("element.zig").Element;
+const string_utils = @import("string_utils.zig");
+
+/// Serialize the node's children only (innerHTML-style).
+pub const children_only: u32 = 1 << 0;
+
+/// Use XML syntax (see the module doc).
+pub const xml: u32 = 1 << 1;
+
+/// Size of the chunks handed to the sink (except the last one, and text
+/// runs too long to buffer, which are passed through directly).
+pub const chunk_size = 4096;
+
+/// Streams the markup of `node` (see the module doc) to `emit`, in order.
+///
+/// Chunks are only valid during the call; `emit` must not mutate the
+/// tree. Empty chunks are never emitted.
+///
+/// ## Errors
+/// Whatever `emit` returns.
+pub fn serialize(
+    node: *const Node,
+    flags: u32,
+    context: anytype,
+    comptime emit: fn (@TypeOf(context), []const u8) Allocator.Error!void,
+) Allocator.Error!void {
+    var writer = Writer(@TypeOf(context), emit){ .context = context, .xml = flags & xml != 0 };
+
+    if (flags & children_only != 0) {
+        var child = node.first_child;
+        while (child) |c| : (child = c.next_sibling) {
+            try writer.subtree(c);
+        }
+    } else {
+        try writer.subtree(node);
+    }
+    try writer.flush();
+}
+
+/// Returns the markup of `node` in one buffer, owned by the caller.
+///
+/// ## Errors
+/// - `error.OutOfMemory`: Failed to grow the buffer
+pub fn serializeAlloc(allocator: Allocator, node: *const Node, flags: u32) Allocator.Error![]u8 {
+    const Sink = struct {
+        allocator: Allocator,
+        out: std.ArrayList(u8) = .empty,
+
+        fn write(sink: *@This(), chunk: []const u8) Allocator.Error!void {
+            try sink.out.appendSlice(sink.allocator, chunk);
+        }
+    };
+
+    var sink = Sink{ .allocator = allocator };
+    errdefer sink.out.deinit(allocator);
+    try serialize(node, flags, &sink, Sink.write);
+    return sink.out.toOwnedSlice(allocator);
+}
+
+/// Bytes that need attention while escaping (the lead byte of U+00A0
+/// included); the runs between them are found with a vector scan and
+/// copied as they are.
+const text_special = "&<>\xC2";
+const attribute_special = "&<>\"\xC2";
+
+fn Writer(
+    comptime Context: type,
+    comptime emit: fn (Context, []const u8) Allocator.Error!void,
+) type {
+    return struct {
+        const Self = @This();
+
+        context: Context,
+        xml: bool,
+        buffer: [chunk_size]u8 = undefined,
+        len: usize = 0,
+
+        /// Writes `root` and its descendants (iteratively, so deep trees
+        /// cannot overflow the stack).
+        fn subtree(self: *Self, root: *const Node) Allocator.Error!void {
+            var node = root;
+            while (true) {
+                if (try self.open(node)) {
+                    node = node.first_child.?;
+                    continue;
+                }
+                while (node != root) {
+                    if (node.next_sibling) |next| {
+                        node = next;
+                        break;
+                    }
+                    node = node.parent_node.?;
+                    try self.close(node);
+                } else return;
+            }
+        }
+
+        /// Writes a node up to its children; true if they follow.
+        fn open(self: *Self, node: *const Node) Allocator.Error!bool {
+            switch (node.node_type) {
+                .element => {
+                    const elem: *const Element = @fieldParentPtr("prototype", node);
+                    try self.put("<");
+                    try self.put(elem.tag_name);
+
+                    var attrs = elem.attributes.iterator();
+                    while (attrs.next()) |attr| {
+                        try self.put(" ");
+                        if (attr.name.prefix) |prefix| {
+                            try self.put(prefix);
+                            try self.put(":");
+                        }
+                        try self.put(attr.name.local_name);
+                        try self.put("=\"");
+                        try self.escaped(attr.value, true);
+                        try self.put("\"");
+                    }
+
+                    if (node.first_child != null) {
+                        try self.put(">");
+                        return true;
+                    }
+                    if (self.xml) {
+                        try self.put("/>");
+                    } else {
+                        try self.put("></");
+                        try self.put(elem.tag_name);
+                        try self.put(">");
+                    }
+                    return false;
+                },
+                .text => try self.escaped(node.nodeValue() orelse "", false),
+                .comment => {
+                    try self.put("<!--");
+                    try self.put(node.nodeValue() orelse "");
+                    try self.put("-->");
+                },
+                .cdata_section => {
+                    try self.put("<![CDATA[");
+                    try self.put(node.nodeValue() orelse "");
+                    try self.put("]]>");
+                },
+                .processing_instruction => {
+                    try self.put("<?");
+                    try self.put(node.nodeName());
+                    try self.put(" ");
+                    try self.put(node.nodeValue() orelse "");
+                    try self.put(if (self.xml) "?>" else ">");
+                },
+                .document_type => {
+                    try self.put("<!DOCTYPE ");
+                    try self.put(node.nodeName());
+                    try self.put(">");
+                },
+                .document, .document_fragment, .shadow_root => return node.first_child != null,
+                else => {},
+            }
+            return false;
+        }
+
+        /// Writes the end of a node whose children were written.
+        fn close(self: *Self, node: *const Node) Allocator.Error!void {
+            if (node.node_type != .element) return;
+            const elem: *const Element = @fieldParentPtr("prototype", node);
+            try self.put("</");
+            try self.put(elem.tag_name);
+            try self.put(">");
+        }
+
+        fn escaped(self: *Self, data: []const u8, attribute: bool) Allocator.Error!void {
+            var start: usize = 0;
+            var i: usize = 0;
+            while (i < data.len) {
+                const found = if (attribute)
+                    string_utils.indexOfAnyPos(data, i, attribute_special)
+                else
+                    string_utils.indexOfAnyPos(data, i, text_special);
+                const at = found orelse break;
+                const c = data[at];
+                i = at + 1;
+
+                const replacement: []const u8 = switch (c) {
+                    '&' => "&amp;",
+                    '<' => "&lt;",
+                    '>' => "&gt;",
+                    '"' => "&quot;",
+                    else => blk: {
+                        // U+00A0 is C2 A0 in UTF-8
+                        if (self.xml or i >= data.len or data[i] != 0xA0) continue;
+                        i += 1;
+                        break :blk "&nbsp;";
+                    },
+                };
+
+                try self.put(data[start..at]);
+                try self.put(replacement);
+                start = i;
+            }
+            try self.put(data[start..]);
+        }
+
+        fn put(self: *Self, bytes: []const u8) Allocator.Error!void {
+            if (bytes.len <= self.buffer.len - self.len) {
+                @memcpy(self.buffer[self.len..][0..bytes.len], bytes);
+                self.len += bytes.len;
+                return;
+            }
+
+            try self.flush();
+            if (bytes.len >= self.buffer.len) {
+                // Too long to buffer: hand it over as is
+                return emit(self.context, bytes);
+            }
+            @memcpy(self.buffer[0..bytes.len], bytes);
+            self.len = bytes.len;
+        }
+
+        fn flush(self: *Self) Allocator.Error!void {
+            if (self.len == 0) return;
+            const len = self.len;
+            self.len = 0;
+            try emit(self.context, self.buffer[0..len]);
+        }
+    };
+}
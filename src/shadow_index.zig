@@ -0,0 +1,142 @@
+//! Shadow Index - Per-shadow-root id and class indices
+//!
+//! The document's id index (and optional class index) cover the document
+//! tree only, so `#id` and `.class` queries on a shadow root would walk
+//! the whole shadow tree. Each `ShadowRoot` can own a `ShadowIndex`
+//! instead: an `IdIndex` and a `ClassIndex` over the elements of its own
+//! tree (not nested shadow trees, which have their own).
+//!
+//! ## Lifetime
+//!
+//! The index is built on the first indexed query on the shadow root
+//! (`getElementById()`, or `querySelector()`/`querySelectorAll()` with a
+//! simple `#id` or `.class` selector) and kept up to date from then on.
+//! If an update fails to allocate, the index is dropped and the next query
+//! rebuilds it.
+//!
+//! ## Maintenance
+//!
+//! Nodes in a shadow tree carry `Node.FLAG_IS_IN_SHADOW_TREE`, set by
+//! `subtreeInserted()` and cleared by `subtreeRemoved()` as subtrees enter
+//! and leave the tree. The flag is what keeps maintenance away from the
+//! document tree: light DOM mutations test one bit and never reach a
+//! shadow index, and shadow-tree elements stay out of the document's
+//! maps. Id and class attribute changes of flagged elements go to the
+//! index of their shadow root (`idChanged()`, `classChanged()`).
+//!
+//! Keys are interned in the owner document's string pool, like the
+//! document's own indices.
+
+const std = @import("std");
+const Allocator = std.mem.Allocator;
+const Node = @import("node.zig").Node;
+const Element = @import("element.zig").Element;
+const ShadowRoot = @import("shadow_root.zig").ShadowRoot;
+const IdIndex = @import("id_index.zig").IdIndex;
+const ClassIndex = @import("class_index.zig").ClassIndex;
+const StringPool = @import("document.zig").StringPool;
+const tree_helpers = @import("tree_helpers.zig");
+
+pub const ShadowIndex = struct {
+    ids: IdIndex,
+    classes: ClassIndex,
+
+    /// Pool the keys are interned in (the owner document's)
+    pool: *StringPool,
+
+    /// Builds the index over the tree of `shadow`.
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to allocate the index
+    pub fn create(allocator: Allocator, pool: *StringPool, shadow: *ShadowRoot) !*ShadowIndex {
+        const index = try allocator.create(ShadowIndex);
+        index.* = .{
+            .ids = IdIndex.init(allocator),
+            .classes = ClassIndex.init(allocator),
+            .pool = pool,
+        };
+        errdefer index.destroy(allocator);
+
+        // Ids first, so the class index's own build is the last pass
+        const root = &shadow.prototype;
+        var current = root.first_child;
+        while (current) |node| : (current = tree_helpers.getNextNodeInTree(node, root)) {
+            if (node.node_type != .element) continue;
+            const elem: *Element = @fieldParentPtr("prototype", node);
+            if (elem.getId()) |id| try index.ids.add(pool, id, elem);
+        }
+        try index.classes.build(pool, root);
+        return index;
+    }
+
+    pub fn destroy(self: *ShadowIndex, allocator: Allocator) void {
+        self.ids.deinit();
+        self.classes.deinit();
+        allocator.destroy(self);
+    }
+
+    fn addElement(self: *ShadowIndex, elem: *Element) !void {
+        if (elem.getId()) |id| try self.ids.add(self.pool, id, elem);
+        if (elem.getAttribute("class")) |class_value| {
+            try self.classes.addTokens(self.pool, class_value, elem);
+        }
+    }
+
+    fn removeElement(self: *ShadowIndex, elem: *Element) void {
+        if (elem.getId()) |id| self.ids.remove(id, elem);
+        if (elem.getAttribute("class")) |class_value| {
+            self.classes.removeTokens(class_value, elem);
+        }
+    }
+};
+
+/// Returns the shadow root whose tree `node` is in (`node` itself for a
+/// shadow root), or null for nodes outside shadow trees.
+pub fn containingShadowRoot(node: *const Node) ?*ShadowRoot {
+    if (node.node_type != .shadow_root and !node.isInShadowTree()) return null;
+    const root = node.getRootNode(false);
+    if (root.node_type != .shadow_root) return null;
+    return @fieldParentPtr("prototype", root);
+}
+
+/// Marks the subtree `node` that was linked into the tree of `shadow`, and
+/// indexes its elements.
+pub fn subtreeInserted(shadow: *ShadowRoot, node: *Node) void {
+    var current: ?*Node = node;
+    while (current) |n| : (current = tree_helpers.getNextNodeInTree(n, node)) {
+        n.setInShadowTree(true);
+        if (n.node_type != .element) continue;
+        const index = shadow.index orelse continue;
+        index.addElement(@fieldParentPtr("prototype", n)) catch shadow.dropIndex();
+    }
+}
+
+/// Unmarks the subtree `node` that was unlinked from the tree of `shadow`,
+/// and drops its elements from the index.
+pub fn subtreeRemoved(shadow: *ShadowRoot, node: *Node) void {
+    var current: ?*Node = node;
+    while (current) |n| : (current = tree_helpers.getNextNodeInTree(n, node)) {
+        n.setInShadowTree(false);
+        if (n.node_type != .element) continue;
+        const index = shadow.index orelse continue;
+        index.removeElement(@fieldParentPtr("prototype", n));
+    }
+}
+
+/// Moves `elem` from `old_id` to `new_id` (either may be null) in its
+/// shadow root's index.
+pub fn idChanged(elem: *Element, old_id: ?[]const u8, new_id: ?[]const u8) void {
+    const shadow = containingShadowRoot(&elem.prototype) orelse return;
+    const index = shadow.index orelse return;
+    if (old_id) |id| index.ids.remove(id, elem);
+    if (new_id) |id| index.ids.add(index.pool, id, elem) catch shadow.dropIndex();
+}
+
+/// Moves `elem` from the tokens of `old_value` to those of `new_value`
+/// (either may be null) in its shadow root's index.
+pub fn classChanged(elem: *Element, old_value: ?[]const u8, new_value: ?[]const u8) void {
+    const shadow = containingShadowRoot(&elem.prototype) orelse return;
+    const index = shadow.index orelse return;
+    if (old_value) |value| index.classes.removeTokens(value, elem);
+    if (new_value) |value| index.classes.addTokens(index.pool, value, elem) catch shadow.dropIndex();
+}
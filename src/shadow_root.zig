@@ -344,6 +344,8 @@ const NodeType = node_mod.NodeType;
 const NodeVTable = node_mod.NodeVTable;
 const DocumentFragment = @import("document_fragment.zig").DocumentFragment;
 const Element = @import("element.zig").Element;
+const SlotMap = @import("slot_map.zig").SlotMap;
+const ShadowIndex = @import("shadow_index.zig").ShadowIndex;
 const Event = @import("event.zig").Event;
 const EventCallback = @import("event_target.zig").EventCallback;
 
@@ -477,6 +479,13 @@ pub const ShadowRoot = struct {
     /// - Spec: https://dom.spec.whatwg.org/#dom-shadowroot-onslotchange
     onslotchange: ?*anyopaque = null,
 
+    /// Slot name lookup and cached assigned nodes (see slot_map.zig)
+    slots: SlotMap = .{},
+
+    /// Id and class indices of the shadow tree, built on the first indexed
+    /// query (see shadow_index.zig)
+    index: ?*ShadowIndex = null,
+
     /// Vtable for ShadowRoot nodes.
     const vtable = NodeVTable{
         .deinit = deinitImpl,
@@ -607,6 +616,8 @@ pub const ShadowRoot = struct {
         shadow.serializable = init.serializable;
         shadow.host_element = host_elem; // Non-owning pointer
         shadow.onslotchange = null; // Phase 8 - Legacy event handler
+        shadow.slots = .{};
+        shadow.index = null;
 
         return shadow;
     }
@@ -654,6 +665,14 @@ pub const ShadowRoot = struct {
     /// ## MDN Documentation
     /// - ShadowRoot.querySelector(): https://developer.mozilla.org/en-US/docs/Web/API/ShadowRoot/querySelector
     pub fn querySelector(self: *ShadowRoot, allocator: Allocator, selectors: []const u8) !?*Element {
+        // "#id" and ".class" answer from the shadow tree's own indices
+        const fast = @import("fast_path.zig").parseFastPath(selectors);
+        switch (fast.kind) {
+            .simple_id => if (self.ensureIndex()) |index| return index.ids.get(fast.name),
+            .simple_class => if (self.ensureIndex()) |index| return index.classes.item(fast.name, 0),
+            else => {},
+        }
+
         const Tokenizer = @import("selector/tokenizer.zig").Tokenizer;
         const Parser = @import("selector/parser.zig").Parser;
         const Matcher = @import("selector/matcher.zig").Matcher;
@@ -669,23 +688,16 @@ pub const ShadowRoot = struct {
         // Create matcher
         const matcher = Matcher.init(allocator);
 
-        // Traverse children in tree order
+        // Walk the shadow tree in tree order with the one parsed list
+        // (nested shadow trees and the host's light tree are not reached)
+        const tree_helpers = @import("tree_helpers.zig");
         var current = self.prototype.first_child;
-        while (current) |node| {
-            if (node.node_type == .element) {
-                const elem: *Element = @fieldParentPtr("prototype", node);
-
-                // Check if element matches
-                if (try matcher.matches(elem, &selector_list)) {
-                    return elem;
-                }
-
-                // Recursively search descendants
-                if (try elem.querySelector(allocator, selectors)) |found| {
-                    return found;
-                }
+        while (current) |node| : (current = tree_helpers.getNextNodeInTree(node, &self.prototype)) {
+            if (node.node_type != .element) continue;
+            const elem: *Element = @fieldParentPtr("prototype", node);
+            if (try matcher.matches(elem, &selector_list)) {
+                return elem;
             }
-            current = node.next_sibling;
         }
 
         return null;
@@ -704,6 +716,21 @@ pub const ShadowRoot = struct {
     /// ## MDN Documentation
     /// - ShadowRoot.querySelectorAll(): https://developer.mozilla.org/en-US/docs/Web/API/ShadowRoot/querySelectorAll
     pub fn querySelectorAll(self: *ShadowRoot, allocator: Allocator, selectors: []const u8) ![]const *Element {
+        const fast = @import("fast_path.zig").parseFastPath(selectors);
+        switch (fast.kind) {
+            .simple_id => if (self.ensureIndex()) |index| {
+                var results = std.ArrayList(*Element){};
+                errdefer results.deinit(allocator);
+                var candidates = index.ids.iterator(fast.name);
+                while (candidates.next()) |elem| try results.append(allocator, elem);
+                return try results.toOwnedSlice(allocator);
+            },
+            .simple_class => if (self.ensureIndex()) |index| {
+                return try allocator.dupe(*Element, index.classes.elements(fast.name));
+            },
+            else => {},
+        }
+
         const Tokenizer = @import("selector/tokenizer.zig").Tokenizer;
         const Parser = @import("selector/parser.zig").Parser;
         const Matcher = @import("selector/matcher.zig").Matcher;
@@ -743,6 +770,53 @@ pub const ShadowRoot = struct {
         return try results.toOwnedSlice(allocator);
     }
 
+    /// Returns the first element in the shadow tree with the given id.
+    ///
+    /// ## WHATWG Specification
+    /// - **§4.2.4 Mixin NonElementParentNode**: https://dom.spec.whatwg.org/#dom-nonelementparentnode-getelementbyid
+    ///
+    /// ## WebIDL
+    /// ```webidl
+    /// Element? getElementById(DOMString elementId);
+    /// ```
+    ///
+    /// ## Note
+    /// Answered from the shadow tree's id index (built on first use);
+    /// falls back to a tree walk if the index cannot be allocated.
+    pub fn getElementById(self: *ShadowRoot, element_id: []const u8) ?*Element {
+        if (self.ensureIndex()) |index| return index.ids.get(element_id);
+
+        const ElementIterator = @import("element_iterator.zig").ElementIterator;
+        var iter = ElementIterator.init(&self.prototype);
+        while (iter.next()) |elem| {
+            const id = elem.getId() orelse continue;
+            if (std.mem.eql(u8, id, element_id)) return elem;
+        }
+        return null;
+    }
+
+    /// Returns the shadow tree's id and class indices, building them on
+    /// first use. Null if they cannot be built (no owner document, or
+    /// allocation failure); callers walk the tree instead.
+    pub fn ensureIndex(self: *ShadowRoot) ?*ShadowIndex {
+        if (self.index) |index| return index;
+        const owner = self.prototype.owner_document orelse return null;
+        if (owner.node_type != .document) return null;
+        const Document = @import("document.zig").Document;
+        const doc: *Document = @fieldParentPtr("prototype", owner);
+        // Readers of a frozen document must not write (building interns keys)
+        if (doc.frozen) return null;
+        self.index = ShadowIndex.create(self.prototype.allocator, &doc.string_pool, self) catch return null;
+        return self.index;
+    }
+
+    /// Drops the indices; the next indexed query rebuilds them.
+    pub fn dropIndex(self: *ShadowRoot) void {
+        const index = self.index orelse return;
+        index.destroy(self.prototype.allocator);
+        self.index = null;
+    }
+
     /// Returns a live collection of element children.
     ///
     /// ## WebIDL
@@ -823,12 +897,14 @@ pub const ShadowRoot = struct {
             if (owner_doc.node_type == .document) {
                 const Document = @import("document.zig").Document;
                 const doc: *Document = @fieldParentPtr("prototype", owner_doc);
-                doc.releaseNodeRef();
+                doc.releaseNodeRef(node);
             }
         }
 
         // Clean up rare data if allocated
         shadow.prototype.deinitRareData();
+        shadow.slots.deinit(shadow.prototype.allocator);
+        shadow.dropIndex();
 
         // Free all children
         var current = shadow.prototype.first_child;
@@ -0,0 +1,147 @@
+//! Sliced Query - querySelectorAll in time-budgeted steps
+//!
+//! querySelectorAll() over a document with a million nodes runs for tens
+//! of milliseconds in one call, and the embedder's event loop waits for
+//! all of it. A `SlicedQuery` walks the same elements in tree order but
+//! stops after each `step` once its time budget is spent (or its output
+//! buffer is full), so the embedder can run other tasks between slices
+//! and resume later.
+//!
+//! ## Mutations
+//!
+//! The query remembers the document's mutation version when it starts.
+//! A step that finds the version changed matches nothing and moves the
+//! query to `.invalidated`: the remaining tree may have moved under the
+//! resume point, and matches already returned may no longer match.
+//! Callers start a new query (or fall back to querySelectorAll()).
+//! Matches handed out are valid until the document next mutates.
+//!
+//! ## Example
+//! ```zig
+//! const query = try SlicedQuery.init(allocator, doc, &doc.prototype, ".row");
+//! defer query.deinit();
+//! var out: [256]*Element = undefined;
+//! while (query.state == .running) {
+//!     const matches = try query.step(2 * std.time.ns_per_ms, &out);
+//!     for (out[0..matches]) |element| visit(element);
+//!     // ... yield to the event loop ...
+//! }
+//! ```
+
+const std = @import("std");
+const Allocator = std.mem.Allocator;
+const Node = @import("node.zig").Node;
+const Element = @import("element.zig").Element;
+const Document = @import("document.zig").Document;
+const ParsedSelector = @import("document.zig").ParsedSelector;
+const ElementIterator = @import("element_iterator.zig").ElementIterator;
+const Matcher = @import("selector/matcher.zig").Matcher;
+
+/// Elements visited between two reads of the clock
+pub const check_interval = 256;
+
+pub const SlicedQuery = struct {
+    allocator: Allocator,
+
+    /// Document of the root (referenced)
+    doc: *Document,
+
+    /// Compiled selectors (referenced, from the document's cache)
+    parsed: *ParsedSelector,
+
+    /// Resume point, only valid while `version` is current; its root is
+    /// referenced unless it is the document
+    iterator: ElementIterator,
+
+    /// Document mutation version when the query started
+    version: u64,
+
+    state: State,
+
+    pub const State = enum(u8) {
+        /// More elements to visit
+        running = 0,
+        /// Every descendant of the root was visited
+        done = 1,
+        /// The document mutated since the query started
+        invalidated = 2,
+    };
+
+    /// Starts a query for the element descendants of `root` (a node of
+    /// `doc`, often `doc` itself) matching `selectors`.
+    ///
+    /// ## Errors
+    /// - `error.InvalidSelector` (or another parse error): `selectors` is
+    ///   empty or invalid
+    /// - `error.OutOfMemory`: Allocation failed
+    pub fn init(allocator: Allocator, doc: *Document, root: *Node, selectors: []const u8) !*SlicedQuery {
+        if (selectors.len == 0) return error.InvalidSelector;
+        const parsed = try doc.selector_cache.acquire(selectors);
+        errdefer parsed.release();
+
+        const query = try allocator.create(SlicedQuery);
+        doc.acquire();
+        if (root != &doc.prototype) root.acquire();
+        query.* = .{
+            .allocator = allocator,
+            .doc = doc,
+            .parsed = parsed,
+            .iterator = ElementIterator.init(root),
+            .version = doc.mutation_version,
+            .state = .running,
+        };
+        return query;
+    }
+
+    /// Releases the selectors, the document reference and the query.
+    pub fn deinit(self: *SlicedQuery) void {
+        const doc = self.doc;
+        if (self.iterator.root != &doc.prototype) self.iterator.root.release();
+        self.parsed.release();
+        self.allocator.destroy(self);
+        doc.release();
+    }
+
+    /// Visits elements until `budget_ns` has passed or `out` is full, and
+    /// writes the matching ones to `out` in tree order.
+    ///
+    /// Unless `out` fills up, each step visits at least `check_interval`
+    /// elements (or the rest of the tree), so a small budget still makes
+    /// progress. Without a monotonic clock a step visits exactly that many.
+    ///
+    /// ## Returns
+    /// Number of matches written. `state` tells whether to step again.
+    ///
+    /// ## Errors
+    /// Errors of matching (e.g. `error.OutOfMemory` in :has()); stepping
+    /// again continues after the element that failed
+    pub fn step(self: *SlicedQuery, budget_ns: u64, out: []*Element) !usize {
+        if (self.state != .running) return 0;
+        if (self.doc.mutation_version != self.version) {
+            self.state = .invalidated;
+            return 0;
+        }
+
+        var timer = std.time.Timer.start() catch null;
+        const matcher = Matcher.init(self.allocator);
+        var count: usize = 0;
+        var visited: usize = 0;
+        while (count < out.len) {
+            const element = self.iterator.next() orelse {
+                self.state = .done;
+                break;
+            };
+            if (try matcher.matches(element, &self.parsed.selector_list)) {
+                out[count] = element;
+                count += 1;
+            }
+
+            visited += 1;
+            if (visited % check_interval == 0) {
+                const elapsed = if (timer) |*t| t.read() else break;
+                if (elapsed >= budget_ns) break;
+            }
+        }
+        return count;
+    }
+};
@@ -0,0 +1,241 @@
+//! Slot Map - Per-shadow-root slot lookup and assigned-node cache
+//!
+//! Finding a slot for a slottable (WHATWG §4.2.2.3) means "the first slot
+//! in tree order in the shadow tree whose name matches", and a slot's
+//! assigned nodes are the host children assigned to it. Done on demand,
+//! every host child insertion walks the whole shadow tree, and every
+//! `assignedNodes()` walks the host's children. Each `ShadowRoot` keeps a
+//! `SlotMap` instead:
+//!
+//! - **Names**: slot name to first slot in tree order, built lazily in one
+//!   shadow tree walk. Dropped when a slot's `name` attribute changes or a
+//!   subtree containing a slot enters or leaves the shadow tree.
+//! - **Assigned nodes**: per slot, the host children assigned to it, in
+//!   tree order, built lazily in one pass over the host's children. Dropped
+//!   when the host's children change or a slottable's assigned slot
+//!   changes (its `slot` attribute, a slot rename, or manual assignment).
+//!
+//! Other mutations, inside or outside the shadow tree, leave both alone.
+//!
+//! ## Maintenance hooks
+//!
+//! The insert and remove algorithms call `nodeInserted()` and
+//! `nodeRemoved()` after linking or unlinking a node. Assigned slots are
+//! stored on the slottables (`NodeRareData.assigned_slot`) and always
+//! written through `setAssignedSlot()`, which drops the owning shadow
+//! root's assigned-node lists.
+
+const std = @import("std");
+const Allocator = std.mem.Allocator;
+const Node = @import("node.zig").Node;
+const Element = @import("element.zig").Element;
+const ShadowRoot = @import("shadow_root.zig").ShadowRoot;
+
+pub const SlotMap = struct {
+    /// First slot in tree order per name ("" for the default slot)
+    by_name: std.StringHashMapUnmanaged(*Element) = .{},
+    names_valid: bool = false,
+
+    /// Host children assigned to each slot, in tree order
+    assigned: std.AutoHashMapUnmanaged(*const Element, std.ArrayListUnmanaged(*Node)) = .{},
+    assigned_valid: bool = false,
+
+    pub fn deinit(self: *SlotMap, allocator: Allocator) void {
+        self.clearAssigned(allocator);
+        self.assigned.deinit(allocator);
+        self.by_name.deinit(allocator);
+    }
+
+    /// Drops the name map (and the assignments derived from it).
+    pub fn invalidateNames(self: *SlotMap) void {
+        self.names_valid = false;
+        self.assigned_valid = false;
+    }
+
+    /// Drops the assigned-node lists.
+    pub fn invalidateAssigned(self: *SlotMap) void {
+        self.assigned_valid = false;
+    }
+
+    /// Returns the first slot in tree order in `shadow` named `name`.
+    /// Falls back to a tree walk if the map cannot be built.
+    pub fn find(self: *SlotMap, shadow: *const ShadowRoot, name: []const u8) ?*Element {
+        if (!self.names_valid) {
+            self.buildNames(shadow) catch return firstSlotNamed(&shadow.prototype, name);
+        }
+        return self.by_name.get(name);
+    }
+
+    /// Returns the host children assigned to `slot`, in tree order.
+    /// Borrowed: valid until the next change to the host's children or to
+    /// an assignment.
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to build the lists
+    pub fn assignedTo(self: *SlotMap, shadow: *const ShadowRoot, slot: *const Element) Allocator.Error![]const *Node {
+        if (!self.assigned_valid) try self.buildAssigned(shadow);
+        const list = self.assigned.get(slot) orelse return &[_]*Node{};
+        return list.items;
+    }
+
+    fn buildNames(self: *SlotMap, shadow: *const ShadowRoot) Allocator.Error!void {
+        const allocator = shadow.prototype.allocator;
+        self.by_name.clearRetainingCapacity();
+        errdefer self.by_name.clearRetainingCapacity();
+
+        const tree_helpers = @import("tree_helpers.zig");
+        var current = shadow.prototype.first_child;
+        while (current) |node| : (current = tree_helpers.getNextNodeInTree(node, &shadow.prototype)) {
+            const slot = asSlot(node) orelse continue;
+            const entry = try self.by_name.getOrPut(allocator, slot.getAttribute("name") orelse "");
+            if (!entry.found_existing) entry.value_ptr.* = slot;
+        }
+        self.names_valid = true;
+    }
+
+    fn buildAssigned(self: *SlotMap, shadow: *const ShadowRoot) Allocator.Error!void {
+        const allocator = shadow.prototype.allocator;
+        self.clearAssigned(allocator);
+        errdefer self.clearAssigned(allocator);
+
+        var child = shadow.host_element.prototype.first_child;
+        while (child) |node| : (child = node.next_sibling) {
+            const slot = assignedSlotOf(node) orelse continue;
+            const entry = try self.assigned.getOrPut(allocator, slot);
+            if (!entry.found_existing) entry.value_ptr.* = .{};
+            try entry.value_ptr.append(allocator, node);
+        }
+        self.assigned_valid = true;
+    }
+
+    fn clearAssigned(self: *SlotMap, allocator: Allocator) void {
+        var lists = self.assigned.valueIterator();
+        while (lists.next()) |list| list.deinit(allocator);
+        self.assigned.clearRetainingCapacity();
+        self.assigned_valid = false;
+    }
+};
+
+/// Returns `node` as a slot element, or null
+pub fn asSlot(node: *const Node) ?*Element {
+    if (node.node_type != .element) return null;
+    const elem: *const Element = @fieldParentPtr("prototype", node);
+    if (!std.mem.eql(u8, elem.tag_name, "slot")) return null;
+    return @constCast(elem);
+}
+
+/// Returns the shadow root attached to `node`, if it is a shadow host
+pub fn shadowOf(node: *const Node) ?*ShadowRoot {
+    if (node.node_type != .element) return null;
+    const rare_data = node.rare_data orelse return null;
+    const shadow_ptr = rare_data.shadow_root orelse return null;
+    return @ptrCast(@alignCast(shadow_ptr));
+}
+
+/// Returns the slot `node` (an Element or Text) is assigned to
+pub fn assignedSlotOf(node: *const Node) ?*Element {
+    if (node.node_type != .element and node.node_type != .text) return null;
+    const rare_data = node.rare_data orelse return null;
+    const slot_ptr = rare_data.assigned_slot orelse return null;
+    return @ptrCast(@alignCast(slot_ptr));
+}
+
+/// Sets (or, with null, clears) the slot `node` is assigned to, and drops
+/// the assigned-node lists of the shadow root of its parent, if any.
+///
+/// ## Errors
+/// - `error.OutOfMemory`: Failed to allocate rare data
+pub fn setAssignedSlot(node: *Node, slot: ?*Element) Allocator.Error!void {
+    if (slot) |s| {
+        const rare_data = try node.ensureRareData();
+        if (rare_data.assigned_slot) |current| {
+            if (current == @as(*anyopaque, @ptrCast(s))) return;
+        }
+        rare_data.assigned_slot = @ptrCast(s);
+    } else {
+        const rare_data = node.rare_data orelse return;
+        if (rare_data.assigned_slot == null) return;
+        rare_data.assigned_slot = null;
+    }
+
+    if (node.parent_node) |parent| {
+        if (shadowOf(parent)) |shadow| shadow.slots.invalidateAssigned();
+    }
+}
+
+/// Slot bookkeeping after `node` was linked under `parent`.
+pub fn nodeInserted(parent: *Node, node: *Node) void {
+    if (shadowOf(parent)) |shadow| {
+        // A new host child: the lists change order, and it may find a slot
+        shadow.slots.invalidateAssigned();
+        if (shadow.slot_assignment == .named and (node.node_type == .element or node.node_type == .text)) {
+            setAssignedSlot(node, Element.findSlot(node, false)) catch {};
+        }
+    }
+    slotsMoved(parent, node);
+}
+
+/// Slot bookkeeping after `node` was unlinked from `parent`.
+pub fn nodeRemoved(parent: *Node, node: *Node) void {
+    hostChildRemoved(parent, node);
+    slotsMoved(parent, node);
+}
+
+/// Unassigns `node` if `parent` is a shadow host. Callers removing several
+/// children at once use this per child, then `slotsChanged()` once the
+/// child list is consistent again.
+pub fn hostChildRemoved(parent: *Node, node: *Node) void {
+    const shadow = shadowOf(parent) orelse return;
+    shadow.slots.invalidateAssigned();
+    if (node.rare_data) |rare_data| rare_data.assigned_slot = null;
+}
+
+/// Drops the name map of the shadow tree `parent` is in, when the subtree
+/// `node` entering or leaving it contains a slot.
+fn slotsMoved(parent: *Node, node: *Node) void {
+    if (containsSlot(node)) slotsChanged(parent);
+}
+
+/// Drops the name map of the shadow tree `parent` is in (if any) and
+/// reassigns the host's children to the slots that remain.
+pub fn slotsChanged(parent: *Node) void {
+    const root = parent.getRootNode(false);
+    if (root.node_type != .shadow_root) return;
+    const shadow: *ShadowRoot = @fieldParentPtr("prototype", root);
+    shadow.slots.invalidateNames();
+    reassignHostChildren(shadow);
+}
+
+/// Reassigns every slottable child of the host (named assignment only).
+pub fn reassignHostChildren(shadow: *ShadowRoot) void {
+    shadow.slots.invalidateAssigned();
+    if (shadow.slot_assignment != .named) return;
+
+    var child = shadow.host_element.prototype.first_child;
+    while (child) |node| : (child = node.next_sibling) {
+        if (node.node_type != .element and node.node_type != .text) continue;
+        setAssignedSlot(node, Element.findSlot(node, false)) catch {};
+    }
+}
+
+/// True when `root` or a descendant is a slot element
+pub fn containsSlot(root: *const Node) bool {
+    if (root.node_type != .element) return false;
+    const tree_helpers = @import("tree_helpers.zig");
+    var current: ?*const Node = root;
+    while (current) |node| : (current = tree_helpers.getNextNodeInTree(node, root)) {
+        if (asSlot(node) != null) return true;
+    }
+    return false;
+}
+
+/// Tree walk used when the name map cannot be built
+fn firstSlotNamed(root: *const Node, name: []const u8) ?*Element {
+    const tree_helpers = @import("tree_helpers.zig");
+    var current = root.first_child;
+    while (current) |node| : (current = tree_helpers.getNextNodeInTree(node, root)) {
+        const slot = asSlot(node) orelse continue;
+        if (std.mem.eql(u8, slot.getAttribute("name") orelse "", name)) return slot;
+    }
+    return null;
+}
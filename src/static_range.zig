@@ -743,6 +743,106 @@ pub const StaticRange = struct {
     }
 };
 
+/// Slab allocator for the StaticRanges of one document (see
+/// Document.createStaticRanges). Ranges come from contiguous slabs and go
+/// back on a free list when released, so highlight sets created and
+/// dropped in bulk reuse the same memory instead of one heap block each.
+///
+/// Ranges taken from the pool hold a reference on its document, so the
+/// slabs outlive every range: release them with `range.deinit(range.allocator)`
+/// like any other StaticRange.
+pub const StaticRangePool = struct {
+    backing: Allocator,
+    slabs: std.ArrayListUnmanaged([]Slot) = .{},
+    free_list: ?*Slot = null,
+    live: usize = 0,
+
+    /// A free slot stores the next free slot in its first bytes
+    const Slot = struct {
+        bytes: [@sizeOf(StaticRange)]u8 align(@alignOf(StaticRange)),
+
+        fn next(self: *Slot) *?*Slot {
+            return @ptrCast(@alignCast(&self.bytes));
+        }
+    };
+
+    const first_slab_len = 64;
+    const max_slab_len = 4096;
+
+    pub fn init(backing: Allocator) StaticRangePool {
+        return .{ .backing = backing };
+    }
+
+    /// Frees the slabs; every range taken from the pool is released.
+    pub fn deinit(self: *StaticRangePool) void {
+        std.debug.assert(self.live == 0);
+        for (self.slabs.items) |slab| self.backing.free(slab);
+        self.slabs.deinit(self.backing);
+    }
+
+    /// Allocator handing out single StaticRanges from the pool; any other
+    /// allocation fails.
+    pub fn allocator(self: *StaticRangePool) Allocator {
+        return .{
+            .ptr = self,
+            .vtable = &.{ .alloc = alloc, .resize = resize, .remap = remap, .free = free },
+        };
+    }
+
+    fn document(self: *StaticRangePool) *@import("document.zig").Document {
+        return @fieldParentPtr("static_ranges", self);
+    }
+
+    fn grow(self: *StaticRangePool) ?*Slot {
+        const len = @min(@as(usize, first_slab_len) << @intCast(@min(self.slabs.items.len, 6)), max_slab_len);
+        self.slabs.ensureUnusedCapacity(self.backing, 1) catch return null;
+        const slab = self.backing.alloc(Slot, len) catch return null;
+        self.slabs.appendAssumeCapacity(slab);
+
+        // Slot 0 is handed out, the rest go on the free list in order
+        var i = len;
+        while (i > 1) {
+            i -= 1;
+            slab[i].next().* = self.free_list;
+            self.free_list = &slab[i];
+        }
+        return &slab[0];
+    }
+
+    fn alloc(ctx: *anyopaque, len: usize, alignment: std.mem.Alignment, _: usize) ?[*]u8 {
+        const self: *StaticRangePool = @ptrCast(@alignCast(ctx));
+        if (len != @sizeOf(StaticRange) or alignment.toByteUnits() > @alignOf(StaticRange)) return null;
+
+        const slot = if (self.free_list) |head| blk: {
+            self.free_list = head.next().*;
+            break :blk head;
+        } else self.grow() orelse return null;
+
+        self.live += 1;
+        if (self.live == 1) self.document().acquire();
+        return &slot.bytes;
+    }
+
+    fn resize(_: *anyopaque, memory: []u8, _: std.mem.Alignment, new_len: usize, _: usize) bool {
+        return new_len == memory.len;
+    }
+
+    fn remap(_: *anyopaque, _: []u8, _: std.mem.Alignment, _: usize, _: usize) ?[*]u8 {
+        return null;
+    }
+
+    fn free(ctx: *anyopaque, memory: []u8, _: std.mem.Alignment, _: usize) void {
+        const self: *StaticRangePool = @ptrCast(@alignCast(ctx));
+        const slot: *Slot = @ptrCast(@alignCast(memory.ptr));
+        slot.next().* = self.free_list;
+        self.free_list = slot;
+
+        // Last: releasing the document may destroy it and this pool
+        self.live -= 1;
+        if (self.live == 0) self.document().release();
+    }
+};
+
 // ============================================================================
 // Private Helper Functions
 // ============================================================================
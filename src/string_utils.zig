@@ -1,8 +1,13 @@
-//! String utilities for UTF-8 to UTF-16 offset conversion.
+//! String utilities for UTF-8 to UTF-16 offset conversion and byte scanning.
 //!
 //! WHATWG DOM uses UTF-16 code units for DOMString offsets, but Zig strings are UTF-8.
 //! This module provides conversion utilities to maintain spec compliance.
 //!
+//! It also holds the byte scanning kernels used on long text runs (markup
+//! escaping, string view classification, whitespace trimming). They compare
+//! a whole `@Vector` of bytes per step when the target has SIMD registers
+//! and fall back to a byte loop otherwise and for the tail of the input.
+//!
 //! ## UTF-16 Code Unit Counting
 //!
 //! Per WHATWG spec, offsets are measured in UTF-16 code units:
@@ -33,6 +38,10 @@ const std = @import("std");
 /// - U+0000..U+FFFF (BMP): 1 code unit
 /// - U+10000..U+10FFFF (supplementary): 2 code units (surrogate pair)
 pub fn utf16OffsetToUtf8Byte(utf8_string: []const u8, utf16_offset: usize) usize {
+    // ASCII prefix: one byte per code unit
+    const prefix_len = @min(utf16_offset, utf8_string.len);
+    if (isAscii(utf8_string[0..prefix_len])) return prefix_len;
+
     var utf16_pos: usize = 0;
     var utf8_byte_pos: usize = 0;
 
@@ -90,6 +99,9 @@ pub fn utf8ByteToUtf16Offset(utf8_string: []const u8, utf8_byte_offset: usize) u
 
     const clamped_offset = @min(utf8_byte_offset, utf8_string.len);
 
+    // ASCII prefix: one code unit per byte
+    if (isAscii(utf8_string[0..clamped_offset])) return clamped_offset;
+
     while (utf8_byte_pos < clamped_offset) {
         const len = std.unicode.utf8ByteSequenceLength(utf8_string[utf8_byte_pos]) catch 1;
 
@@ -133,3 +145,149 @@ pub fn utf8ByteToUtf16Offset(utf8_string: []const u8, utf8_byte_offset: usize) u
 pub fn utf16Length(utf8_string: []const u8) usize {
     return utf8ByteToUtf16Offset(utf8_string, utf8_string.len);
 }
+
+// ============================================================================
+// Byte Scanning
+// ============================================================================
+
+/// Bytes compared per step by the scanning kernels (null: no SIMD, the
+/// scalar loops do all the work).
+const vector_len = std.simd.suggestVectorLength(u8);
+
+/// ASCII whitespace per the Infra standard: TAB, LF, FF, CR and SPACE.
+pub const ascii_whitespace = "\t\n\x0C\r ";
+
+/// Returns the index of the first byte at or after `start` that is one of
+/// `needles`, or null if there is none.
+///
+/// Used by the serializer to find the next byte that needs escaping and
+/// copy everything before it in one run.
+///
+/// ## Example
+/// ```zig
+/// const at = indexOfAnyPos("a < b", 0, "&<>"); // Returns 2
+/// ```
+pub fn indexOfAnyPos(haystack: []const u8, start: usize, comptime needles: []const u8) ?usize {
+    var i = start;
+    if (vector_len) |len| {
+        const V = @Vector(len, u8);
+        while (i + len <= haystack.len) : (i += len) {
+            const chunk: V = haystack[i..][0..len].*;
+            const hits = matchAny(len, chunk, needles) != @as(V, @splat(0));
+            if (@reduce(.Or, hits)) return i + std.simd.firstTrue(hits).?;
+        }
+    }
+    while (i < haystack.len) : (i += 1) {
+        if (std.mem.indexOfScalar(u8, needles, haystack[i]) != null) return i;
+    }
+    return null;
+}
+
+/// Returns true if every byte is ASCII (below 0x80).
+///
+/// A UTF-8 string that passes is byte-for-byte its own Latin-1 (one-byte)
+/// encoding, which is what `DOMStringView.is_latin1` promises.
+pub fn isAscii(bytes: []const u8) bool {
+    var i: usize = 0;
+    if (vector_len) |len| {
+        const V = @Vector(len, u8);
+        var seen: V = @splat(0);
+        while (i + len <= bytes.len) : (i += len) {
+            seen |= @as(V, bytes[i..][0..len].*);
+        }
+        if (@reduce(.Or, seen) >= 0x80) return false;
+    }
+    while (i < bytes.len) : (i += 1) {
+        if (bytes[i] >= 0x80) return false;
+    }
+    return true;
+}
+
+/// Returns true if the valid UTF-8 string `utf8` only holds code points up
+/// to U+00FF, so it can be stored as Latin-1 after transcoding.
+///
+/// Those code points never use a lead byte above 0xC3, so this is a scan
+/// for the maximum byte; the string is not validated.
+pub fn fitsLatin1(utf8: []const u8) bool {
+    var i: usize = 0;
+    if (vector_len) |len| {
+        const V = @Vector(len, u8);
+        var highest: V = @splat(0);
+        while (i + len <= utf8.len) : (i += len) {
+            highest = @max(highest, @as(V, utf8[i..][0..len].*));
+        }
+        if (@reduce(.Max, highest) > 0xC3) return false;
+    }
+    while (i < utf8.len) : (i += 1) {
+        if (utf8[i] > 0xC3) return false;
+    }
+    return true;
+}
+
+/// How a UTF-8 string can be represented by a JavaScript engine.
+pub const Encoding = enum(u8) {
+    /// Every byte is ASCII: the bytes are their own Latin-1 encoding
+    ascii,
+    /// Valid UTF-8 with code points up to U+00FF: one byte per code point
+    /// after transcoding
+    latin1,
+    /// Anything else (including invalid UTF-8)
+    utf8,
+};
+
+/// Classifies `bytes` (see `Encoding`). ASCII strings cost one
+/// `isAscii()` scan; others are also scanned by `fitsLatin1()` and
+/// validated.
+pub fn encodingOf(bytes: []const u8) Encoding {
+    if (isAscii(bytes)) return .ascii;
+    if (fitsLatin1(bytes) and std.unicode.utf8ValidateSlice(bytes)) return .latin1;
+    return .utf8;
+}
+
+/// Returns `bytes` without leading and trailing ASCII whitespace
+/// (see `ascii_whitespace`).
+///
+/// ## Example
+/// ```zig
+/// const trimmed = trimAsciiWhitespace("\n  text \t"); // Returns "text"
+/// ```
+pub fn trimAsciiWhitespace(bytes: []const u8) []const u8 {
+    var begin: usize = 0;
+    var end: usize = bytes.len;
+
+    if (vector_len) |len| {
+        const V = @Vector(len, u8);
+        const none: V = @splat(0);
+
+        while (begin + len <= end) : (begin += len) {
+            const chunk: V = bytes[begin..][0..len].*;
+            const other = matchAny(len, chunk, ascii_whitespace) == none;
+            if (@reduce(.Or, other)) {
+                begin += std.simd.firstTrue(other).?;
+                break;
+            }
+        }
+        while (end >= begin + len) : (end -= len) {
+            const chunk: V = bytes[end - len ..][0..len].*;
+            const other = matchAny(len, chunk, ascii_whitespace) == none;
+            if (@reduce(.Or, other)) {
+                end -= len - 1 - std.simd.lastTrue(other).?;
+                break;
+            }
+        }
+    }
+
+    while (begin < end and std.mem.indexOfScalar(u8, ascii_whitespace, bytes[begin]) != null) begin += 1;
+    while (end > begin and std.mem.indexOfScalar(u8, ascii_whitespace, bytes[end - 1]) != null) end -= 1;
+    return bytes[begin..end];
+}
+
+/// Lanes of `chunk` equal to one of `needles` are 0xFF, the others 0.
+inline fn matchAny(comptime len: comptime_int, chunk: @Vector(len, u8), comptime needles: []const u8) @Vector(len, u8) {
+    const V = @Vector(len, u8);
+    var hits: V = @splat(0);
+    inline for (needles) |needle| {
+        hits |= @select(u8, chunk == @as(V, @splat(needle)), @as(V, @splat(0xFF)), @as(V, @splat(0)));
+    }
+    return hits;
+}
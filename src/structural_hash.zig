@@ -0,0 +1,236 @@
+//! Structural Hashes - Optional per-document cache of subtree fingerprints
+//!
+//! `Node.isEqualNode()` walks both subtrees every time it is called, so a
+//! caching layer that asks "did this fragment change?" pays a full
+//! comparison per query. Once enabled with
+//! `Document.enableStructuralHashes()`, the document keeps a lazily filled
+//! map from node to a 64-bit hash of exactly what `isEqualNode()` compares:
+//! node type, doctype name and identifiers, element namespace, local name
+//! and attributes (order-independent), processing instruction target and
+//! data, text and comment data, and the children's hashes in order.
+//!
+//! Equal subtrees always hash equal, so a hash mismatch proves the nodes
+//! differ and `isEqualNode()` returns false without walking them. Equal
+//! hashes still fall through to the full comparison.
+//!
+//! ## Maintenance
+//!
+//! Computing a node's hash caches it for the node and every descendant, so
+//! whenever a node is cached its whole subtree is. A mutation drops the
+//! mutated node and its ancestors up to the first one that was not cached
+//! (above it nothing is), so invalidation is O(depth) and the next read
+//! rehashes only the dirty path. Child list and attribute changes invalidate
+//! through `Node.noteMutation()`; character data changes invalidate directly.
+//! Nodes that are destroyed or adopted into another document are forgotten.
+//! Idle work (see idle_work.zig) rehashes the document a slice at a time
+//! with `warmStep`, so the next comparison finds its hashes cached.
+//!
+//! ## Frozen documents
+//!
+//! Freezing computes the document's hash up front and makes the cache read
+//! only, so concurrent readers never write to it. Nodes outside the cached
+//! tree are hashed without caching.
+
+const std = @import("std");
+const Allocator = std.mem.Allocator;
+const Wyhash = std.hash.Wyhash;
+const Node = @import("node.zig").Node;
+const Budget = @import("idle_work.zig").Budget;
+
+pub const StructuralHashes = struct {
+    allocator: Allocator,
+    hashes: std.AutoHashMapUnmanaged(*const Node, u64) = .{},
+
+    /// True once the document is frozen: reads use the cache but never
+    /// add to it
+    read_only: bool = false,
+
+    /// Bumped whenever cached hashes are dropped, so a paused warmStep
+    /// knows its partial hashes may be out of date
+    epoch: u64 = 0,
+
+    /// Walk stack of a paused warmStep, and the epoch it started at
+    warming: std.ArrayListUnmanaged(Frame) = .{},
+    warming_epoch: u64 = 0,
+
+    /// A node being hashed, with the children folded in so far
+    const Frame = struct {
+        node: *const Node,
+        next: ?*Node,
+        hash: u64,
+    };
+
+    pub fn init(allocator: Allocator) StructuralHashes {
+        return .{ .allocator = allocator };
+    }
+
+    pub fn deinit(self: *StructuralHashes) void {
+        self.warming.deinit(self.allocator);
+        self.hashes.deinit(self.allocator);
+    }
+
+    /// Returns the structural hash of `node`, computing and caching it (and
+    /// its descendants' hashes) if needed.
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to allocate the walk stack or a cache entry
+    pub fn get(self: *StructuralHashes, node: *const Node) Allocator.Error!u64 {
+        if (self.hashes.get(node)) |hash| return hash;
+
+        var stack: std.ArrayListUnmanaged(Frame) = .{};
+        defer stack.deinit(self.allocator);
+        try stack.append(self.allocator, .{ .node = node, .next = node.first_child, .hash = ownHash(node) });
+        return (try self.walk(&stack, null)).?;
+    }
+
+    /// Computes and caches the hash of `node` like get(), for one slice of
+    /// `budget` (see idle_work.zig). A paused walk resumes on the next
+    /// step unless hashes were dropped meanwhile; it then starts over,
+    /// skipping the subtrees it already cached.
+    ///
+    /// ## Returns
+    /// True once the hash of `node` is cached, false if the budget ran out
+    /// first.
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to allocate the walk stack or a cache entry
+    pub fn warmStep(self: *StructuralHashes, node: *const Node, budget: *Budget) Allocator.Error!bool {
+        if (self.read_only or self.hashes.contains(node)) return true;
+        if (self.warming.items.len == 0 or self.warming_epoch != self.epoch or self.warming.items[0].node != node) {
+            self.warming.clearRetainingCapacity();
+            self.warming_epoch = self.epoch;
+            try self.warming.append(self.allocator, .{ .node = node, .next = node.first_child, .hash = ownHash(node) });
+        }
+        errdefer self.warming.clearRetainingCapacity();
+
+        const hash = try self.walk(&self.warming, budget);
+        return hash != null;
+    }
+
+    /// Postorder walk of the frames on `stack` that stops at cached
+    /// subtrees, and (leaving `stack` to resume from) once `budget` is
+    /// spent. Returns the hash of the bottom frame, or null if paused.
+    fn walk(self: *StructuralHashes, stack: *std.ArrayListUnmanaged(Frame), budget: ?*Budget) Allocator.Error!?u64 {
+        while (true) {
+            if (budget) |b| {
+                if (b.tick()) return null;
+            }
+            const top = &stack.items[stack.items.len - 1];
+            if (top.next) |child| {
+                top.next = child.next_sibling;
+                if (self.hashes.get(child)) |hash| {
+                    top.hash = fold(top.hash, hash);
+                } else {
+                    try stack.append(self.allocator, .{ .node = child, .next = child.first_child, .hash = ownHash(child) });
+                }
+                continue;
+            }
+
+            const done = stack.pop().?;
+            if (!self.read_only) try self.hashes.put(self.allocator, done.node, done.hash);
+            if (stack.items.len == 0) return done.hash;
+            const parent = &stack.items[stack.items.len - 1];
+            parent.hash = fold(parent.hash, done.hash);
+        }
+    }
+
+    /// Drops the cached hashes of `node` and its ancestors.
+    pub fn invalidate(self: *StructuralHashes, node: *const Node) void {
+        self.epoch +%= 1;
+        var current: ?*const Node = node;
+        while (current) |n| {
+            if (!self.hashes.remove(n)) return;
+            current = n.parent_node;
+        }
+    }
+
+    /// Drops the cached hash of `node` alone (it is being destroyed or left
+    /// the document; its ancestors are unaffected).
+    pub fn forget(self: *StructuralHashes, node: *const Node) void {
+        if (self.read_only) return;
+        self.epoch +%= 1;
+        _ = self.hashes.remove(node);
+    }
+
+    /// Hashes `node` without a persistent cache.
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to allocate the walk state
+    pub fn compute(allocator: Allocator, node: *const Node) Allocator.Error!u64 {
+        var scratch = StructuralHashes.init(allocator);
+        defer scratch.deinit();
+        return scratch.get(node);
+    }
+};
+
+/// Folds a child's hash into its parent's running hash (order-sensitive)
+fn fold(running: u64, child: u64) u64 {
+    return Wyhash.hash(running, std.mem.asBytes(&child));
+}
+
+/// Hashes the properties of `node` itself that isEqualNode() compares
+fn ownHash(node: *const Node) u64 {
+    var hasher = Wyhash.init(0);
+    hasher.update(&[_]u8{@intFromEnum(node.node_type)});
+
+    switch (node.node_type) {
+        .document_type => {
+            const DocumentType = @import("document_type.zig").DocumentType;
+            const doctype: *const DocumentType = @fieldParentPtr("prototype", node);
+            string(&hasher, doctype.name);
+            string(&hasher, doctype.publicId);
+            string(&hasher, doctype.systemId);
+        },
+        .element => {
+            const Element = @import("element.zig").Element;
+            const elem: *const Element = @fieldParentPtr("prototype", node);
+            optionalString(&hasher, elem.namespace_uri);
+            string(&hasher, elem.tag_name);
+
+            // Attribute order does not matter to isEqualNode: sum their hashes
+            var sum: u64 = 0;
+            var count: u64 = 0;
+            var iter = elem.attributes.array.iterator();
+            while (iter.next()) |attr| {
+                var attr_hasher = Wyhash.init(0);
+                optionalString(&attr_hasher, attr.name.namespace_uri);
+                string(&attr_hasher, attr.name.local_name);
+                string(&attr_hasher, attr.value);
+                sum +%= attr_hasher.final();
+                count += 1;
+            }
+            hasher.update(std.mem.asBytes(&count));
+            hasher.update(std.mem.asBytes(&sum));
+        },
+        .processing_instruction => {
+            const Text = @import("text.zig").Text;
+            const ProcessingInstruction = @import("processing_instruction.zig").ProcessingInstruction;
+            const text: *const Text = @fieldParentPtr("prototype", node);
+            const pi: *const ProcessingInstruction = @fieldParentPtr("prototype", text);
+            string(&hasher, pi.target);
+            string(&hasher, pi.prototype.data);
+        },
+        .text, .comment => optionalString(&hasher, node.nodeValue()),
+        // No properties of their own are compared
+        else => {},
+    }
+
+    return hasher.final();
+}
+
+/// Length-prefixed, so adjacent fields cannot run into each other
+fn string(hasher: *Wyhash, bytes: []const u8) void {
+    const len: u64 = bytes.len;
+    hasher.update(std.mem.asBytes(&len));
+    hasher.update(bytes);
+}
+
+/// Null hashes differently from the empty string
+fn optionalString(hasher: *Wyhash, bytes: ?[]const u8) void {
+    if (bytes) |b| {
+        hasher.update(&[_]u8{1});
+        string(hasher, b);
+    } else {
+        hasher.update(&[_]u8{0});
+    }
+}
@@ -0,0 +1,156 @@
+//! Tag Index - Per-document map from tag name to the connected elements
+//! carrying it, built lazily per tag
+//!
+//! Backs `Document.getElementsByTagName()` and the `tag` querySelector fast
+//! path. A tag gets a bucket the first time it is queried, filled by one
+//! traversal of the document; from then on the bucket is updated
+//! incrementally as elements are connected and disconnected, so repeated
+//! queries never walk the tree. Tags that are never queried cost nothing,
+//! which bounds memory by the tags callers actually ask for.
+//!
+//! ## Order
+//!
+//! Buckets hold elements in tree order. Appending in document order (the
+//! parser and most builders) is one comparison with the last element;
+//! other insertions binary search. The elements of a subtree are
+//! contiguous, so `descendants()` finds a scoped query's matches with two
+//! binary searches.
+//!
+//! ## Stability
+//!
+//! Buckets are heap allocated and live as long as the document, so a live
+//! HTMLCollection can keep a pointer to one.
+//!
+//! ## Usage
+//!
+//! ```zig
+//! const bucket = try doc.tag_index.getOrBuild(&doc.string_pool, &doc.prototype, "item");
+//! try doc.tag_index.add(elem);         // element connected
+//! doc.tag_index.remove(elem);          // element disconnected
+//! ```
+
+const std = @import("std");
+const Allocator = std.mem.Allocator;
+const Element = @import("element.zig").Element;
+const Node = @import("node.zig").Node;
+const StringPool = @import("document.zig").StringPool;
+const ElementIterator = @import("element_iterator.zig").ElementIterator;
+
+pub const TagIndex = struct {
+    allocator: Allocator,
+    buckets: std.StringHashMapUnmanaged(*Bucket) = .{},
+
+    /// Connected elements with one tag name, in tree order
+    pub const Bucket = std.ArrayList(*Element);
+
+    pub fn init(allocator: Allocator) TagIndex {
+        return .{ .allocator = allocator };
+    }
+
+    pub fn deinit(self: *TagIndex) void {
+        var it = self.buckets.valueIterator();
+        while (it.next()) |bucket| {
+            bucket.*.deinit(self.allocator);
+            self.allocator.destroy(bucket.*);
+        }
+        self.buckets.deinit(self.allocator);
+    }
+
+    /// Returns the bucket for `tag_name` if it has been built.
+    pub fn get(self: *const TagIndex, tag_name: []const u8) ?*Bucket {
+        return self.buckets.get(tag_name);
+    }
+
+    /// Returns the bucket for `tag_name`, building it with one traversal of
+    /// `document` on first use.
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to allocate the bucket or intern the key
+    pub fn getOrBuild(self: *TagIndex, pool: *StringPool, document: *Node, tag_name: []const u8) !*Bucket {
+        if (self.buckets.get(tag_name)) |bucket| return bucket;
+
+        const bucket = try self.allocator.create(Bucket);
+        bucket.* = .{};
+        errdefer {
+            bucket.deinit(self.allocator);
+            self.allocator.destroy(bucket);
+        }
+
+        var iter = ElementIterator.init(document);
+        while (iter.next()) |elem| {
+            if (std.mem.eql(u8, elem.tag_name, tag_name)) try bucket.append(self.allocator, elem);
+        }
+
+        // Store the interned copy as the key
+        const key = try pool.intern(tag_name);
+        try self.buckets.put(self.allocator, key, bucket);
+        return bucket;
+    }
+
+    /// Adds a connected element to its tag's bucket, if that was built.
+    ///
+    /// Adding an element that is already indexed does nothing.
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to grow the bucket
+    pub fn add(self: *TagIndex, element: *Element) !void {
+        if (self.buckets.count() == 0) return;
+        const bucket = self.buckets.get(element.tag_name) orelse return;
+
+        const items = bucket.items;
+        if (items.len == 0 or precedes(&items[items.len - 1].prototype, &element.prototype)) {
+            try bucket.append(self.allocator, element);
+            return;
+        }
+
+        var low: usize = 0;
+        var high: usize = items.len;
+        while (low < high) {
+            const mid = low + (high - low) / 2;
+            if (precedes(&items[mid].prototype, &element.prototype)) low = mid + 1 else high = mid;
+        }
+        if (low < items.len and items[low] == element) return;
+        try bucket.insert(self.allocator, low, element);
+    }
+
+    /// Removes a disconnected element from its tag's bucket. Does nothing
+    /// if it is not indexed.
+    pub fn remove(self: *TagIndex, element: *Element) void {
+        if (self.buckets.count() == 0) return;
+        const bucket = self.buckets.get(element.tag_name) orelse return;
+
+        // The element has already left the tree, so its position cannot be
+        // compared; scan for the pointer instead
+        const index = std.mem.indexOfScalar(*Element, bucket.items, element) orelse return;
+        _ = bucket.orderedRemove(index);
+    }
+
+    /// Returns the elements of `bucket` that are descendants of `root`
+    /// (a connected node of the bucket's document), in tree order.
+    pub fn descendants(bucket: *const Bucket, root: *const Node) []const *Element {
+        const items = bucket.items;
+        if (root.node_type == .document) return items;
+
+        // First element after root, then first after root's subtree
+        var low: usize = 0;
+        var high: usize = items.len;
+        while (low < high) {
+            const mid = low + (high - low) / 2;
+            if (!precedes(root, &items[mid].prototype)) low = mid + 1 else high = mid;
+        }
+        const start = low;
+
+        high = items.len;
+        while (low < high) {
+            const mid = low + (high - low) / 2;
+            if (root.contains(&items[mid].prototype)) low = mid + 1 else high = mid;
+        }
+        return items[start..low];
+    }
+
+    /// True if `a` comes before `b` in tree order
+    fn precedes(a: *const Node, b: *const Node) bool {
+        const position = a.compareDocumentPosition(b);
+        return position & Node.DOCUMENT_POSITION_FOLLOWING != 0;
+    }
+};
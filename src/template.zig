@@ -0,0 +1,328 @@
+//! Template - Precompiled subtrees instantiated in one pass
+//!
+//! View layers stamp out the same subtree many times per render.
+//! cloneNode(true) walks the source recursively and inserts every copy with
+//! appendChild(), paying pre-insertion validation, adoption, range updates
+//! and mutation record checks per node. A `Template` flattens the subtree
+//! once into a preorder array of records over one string buffer;
+//! `instantiate()` replays that array in a loop, creating each node in the
+//! target document and linking it straight after the previous one (as
+//! TreeBuilder does), since nothing can observe the new tree yet.
+//!
+//! ## Holes
+//!
+//! A template can mark holes: nodes of the source subtree the caller fills
+//! in per instance (text to bind, elements to attach listeners to).
+//! instantiate() hands back the copy of every hole together with the
+//! instance, so no child paths have to be walked afterwards.
+//!
+//! ## Supported Nodes
+//!
+//! The root may be an element or a DocumentFragment; descendants may be
+//! elements, Text and Comment nodes (anything else is rejected at compile
+//! time). Attributes are copied by name, as cloneNode() copies them.
+//!
+//! Nodes are still allocated one by one: they are reference counted and
+//! released individually, so they cannot share an arena allocation.
+//!
+//! ## Usage
+//!
+//! ```zig
+//! const template = try Template.compile(allocator, &row.prototype, &.{label});
+//! defer template.deinit();
+//!
+//! var holes: [1]*Node = undefined;
+//! const instance = try template.instantiate(doc, &holes);
+//! defer instance.release();
+//! try holes[0].setTextContent("first");
+//! _ = try list.prototype.appendChild(instance);
+//! ```
+
+const std = @import("std");
+const Allocator = std.mem.Allocator;
+const node_mod = @import("node.zig");
+const Node = node_mod.Node;
+const NodeType = node_mod.NodeType;
+const Document = @import("document.zig").Document;
+const Capacity = @import("document.zig").Capacity;
+const Element = @import("element.zig").Element;
+const AttributeInit = @import("element.zig").AttributeInit;
+const TreeBuilder = @import("tree_builder.zig").TreeBuilder;
+
+/// One node of the template, in preorder.
+const Record = struct {
+    node_type: NodeType,
+    /// Depth below the root (0 for the root)
+    depth: u32,
+    /// Tag name or character data
+    data: []const u8,
+    /// Range of `attributes`
+    attributes_start: u32,
+    attributes_count: u32,
+};
+
+const unseen = std.math.maxInt(u32);
+
+/// A hole, by the position of its record.
+const Hole = struct {
+    record: u32,
+    /// Index in the caller's hole list
+    index: u32,
+};
+
+pub const Template = struct {
+    allocator: Allocator,
+
+    /// Nodes in preorder, root first
+    records: []Record,
+
+    /// Attributes of all elements, in record order
+    attributes: []AttributeInit,
+
+    /// Holes, sorted by record
+    holes: []Hole,
+
+    /// Backing bytes of every name, value and character data
+    strings: []u8,
+
+    /// Number of holes instantiate() fills in
+    hole_count: u32,
+
+    /// Deepest record depth
+    max_depth: u32,
+
+    /// Compiles the subtree of `root`. `holes` are nodes of the subtree
+    /// whose copies instantiate() returns, in the same order.
+    ///
+    /// The template copies everything it needs; the source can change or
+    /// go away afterwards.
+    ///
+    /// ## Errors
+    /// - `error.NotSupportedError`: The root or a descendant has a node
+    ///   type templates do not support (see the module doc)
+    /// - `error.NotFoundError`: A hole is not in the subtree
+    /// - `error.OutOfMemory`: Failed to allocate
+    pub fn compile(allocator: Allocator, root: *const Node, holes: []const *const Node) !*Template {
+        switch (root.node_type) {
+            .element, .document_fragment => {},
+            else => return error.NotSupportedError,
+        }
+
+        var compiler = Compiler{ .allocator = allocator };
+        defer compiler.deinit();
+
+        for (holes) |hole| {
+            try compiler.hole_records.put(allocator, hole, unseen);
+        }
+
+        // Preorder walk (iterative, like the serializer)
+        var node = root;
+        var depth: u32 = 0;
+        while (true) {
+            try compiler.add(node, depth);
+            if (node.first_child) |child| {
+                node = child;
+                depth += 1;
+                continue;
+            }
+            while (node != root) {
+                if (node.next_sibling) |next| {
+                    node = next;
+                    break;
+                }
+                node = node.parent_node.?;
+                depth -= 1;
+            } else break;
+        }
+
+        try compiler.holes.ensureTotalCapacity(allocator, holes.len);
+        for (holes, 0..) |hole, i| {
+            const record = compiler.hole_records.get(hole).?;
+            if (record == unseen) return error.NotFoundError;
+            compiler.holes.appendAssumeCapacity(.{ .record = record, .index = @intCast(i) });
+        }
+        return compiler.finish();
+    }
+
+    /// Frees the template (instances are independent of it).
+    pub fn deinit(self: *Template) void {
+        const allocator = self.allocator;
+        allocator.free(self.records);
+        allocator.free(self.attributes);
+        allocator.free(self.holes);
+        allocator.free(self.strings);
+        allocator.destroy(self);
+    }
+
+    /// Capacity for `instances` copies of the template, to pass to
+    /// Document.reserve() before stamping them. `string_bytes` covers
+    /// every name and value once (the copies share the interned strings),
+    /// and overestimates by the character data, which is not interned.
+    pub fn capacity(self: *const Template, instances: usize) Capacity {
+        return .{
+            .nodes = self.records.len *| instances,
+            // A terminator per tag name, attribute name and value
+            .string_bytes = self.strings.len + self.records.len + 2 * self.attributes.len,
+        };
+    }
+
+    /// Creates a copy of the compiled subtree in `doc`, writing the copy of
+    /// hole `i` to `holes_out[i]` (which needs hole_count entries). The
+    /// caller owns the returned root; holes are owned by the tree.
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to allocate (nothing is left behind)
+    pub fn instantiate(self: *const Template, doc: *Document, holes_out: []*Node) !*Node {
+        std.debug.assert(holes_out.len >= self.hole_count);
+
+        // Open ancestors by depth
+        var inline_ancestors: [32]*Node = undefined;
+        const deep = self.max_depth >= inline_ancestors.len;
+        const ancestors = if (deep)
+            try self.allocator.alloc(*Node, self.max_depth + 1)
+        else
+            inline_ancestors[0 .. self.max_depth + 1];
+        defer if (deep) self.allocator.free(ancestors);
+
+        var root: ?*Node = null;
+        errdefer if (root) |r| r.release();
+
+        var next_hole: usize = 0;
+        for (self.records, 0..) |record, i| {
+            const node: *Node = switch (record.node_type) {
+                .element => blk: {
+                    const elem = try doc.createElement(record.data);
+                    errdefer elem.prototype.release();
+                    try elem.setAttributes(self.attributes[record.attributes_start..][0..record.attributes_count]);
+                    break :blk &elem.prototype;
+                },
+                .text => &(try doc.createTextNode(record.data)).prototype,
+                .comment => &(try doc.createComment(record.data)).prototype,
+                .document_fragment => &(try doc.createDocumentFragment()).prototype,
+                else => unreachable,
+            };
+
+            if (record.depth == 0) {
+                root = node;
+            } else {
+                TreeBuilder.appendBuilt(ancestors[record.depth - 1], node);
+            }
+            ancestors[record.depth] = node;
+
+            while (next_hole < self.holes.len and self.holes[next_hole].record == i) : (next_hole += 1) {
+                holes_out[self.holes[next_hole].index] = node;
+            }
+        }
+
+        // One version bump for the whole instance (see TreeBuilder.finish)
+        root.?.noteMutation();
+        return root.?;
+    }
+};
+
+const Compiler = struct {
+    allocator: Allocator,
+    records: std.ArrayList(Record) = .empty,
+    /// Offsets into `strings` until finish() turns them into slices
+    attributes: std.ArrayList([2]Range) = .empty,
+    holes: std.ArrayList(Hole) = .empty,
+    strings: std.ArrayList(u8) = .empty,
+    /// Record data ranges, parallel to `records`
+    data: std.ArrayList(Range) = .empty,
+    /// Record of each hole node (`unseen` until the walk reaches it)
+    hole_records: std.AutoHashMapUnmanaged(*const Node, u32) = .{},
+    max_depth: u32 = 0,
+
+    const Range = struct { offset: u32, len: u32 };
+
+    fn deinit(self: *Compiler) void {
+        self.records.deinit(self.allocator);
+        self.attributes.deinit(self.allocator);
+        self.holes.deinit(self.allocator);
+        self.strings.deinit(self.allocator);
+        self.data.deinit(self.allocator);
+        self.hole_records.deinit(self.allocator);
+    }
+
+    fn add(self: *Compiler, node: *const Node, depth: u32) !void {
+        const data: []const u8 = switch (node.node_type) {
+            .element => blk: {
+                const elem: *const Element = @fieldParentPtr("prototype", node);
+                break :blk elem.tag_name;
+            },
+            .text, .comment => node.nodeValue() orelse "",
+            .document_fragment => if (depth == 0) "" else return error.NotSupportedError,
+            else => return error.NotSupportedError,
+        };
+
+        const attributes_start: u32 = @intCast(self.attributes.items.len);
+        if (node.node_type == .element) {
+            const elem: *const Element = @fieldParentPtr("prototype", node);
+            var iter = elem.attributes.iterator();
+            while (iter.next()) |attr| {
+                const name = try self.string(attr.name.local_name);
+                try self.attributes.append(self.allocator, .{ name, try self.string(attr.value) });
+            }
+        }
+
+        if (self.hole_records.getPtr(node)) |record| {
+            record.* = @intCast(self.records.items.len);
+        }
+
+        try self.data.append(self.allocator, try self.string(data));
+        try self.records.append(self.allocator, .{
+            .node_type = node.node_type,
+            .depth = depth,
+            .data = "",
+            .attributes_start = attributes_start,
+            .attributes_count = @as(u32, @intCast(self.attributes.items.len)) - attributes_start,
+        });
+        self.max_depth = @max(self.max_depth, depth);
+    }
+
+    fn string(self: *Compiler, bytes: []const u8) !Range {
+        const offset: u32 = @intCast(self.strings.items.len);
+        try self.strings.appendSlice(self.allocator, bytes);
+        return .{ .offset = offset, .len = @intCast(bytes.len) };
+    }
+
+    fn finish(self: *Compiler) !*Template {
+        const allocator = self.allocator;
+        const template = try allocator.create(Template);
+        errdefer allocator.destroy(template);
+
+        const strings = try self.strings.toOwnedSlice(allocator);
+        errdefer allocator.free(strings);
+        const attributes = try allocator.alloc(AttributeInit, self.attributes.items.len);
+        errdefer allocator.free(attributes);
+        const holes = try self.holes.toOwnedSlice(allocator);
+        errdefer allocator.free(holes);
+        const records = try self.records.toOwnedSlice(allocator);
+
+        for (records, self.data.items) |*record, range| {
+            record.data = strings[range.offset..][0..range.len];
+        }
+        for (attributes, self.attributes.items) |*attr, ranges| {
+            attr.* = .{
+                .name = strings[ranges[0].offset..][0..ranges[0].len],
+                .value = strings[ranges[1].offset..][0..ranges[1].len],
+            };
+        }
+        std.mem.sort(Hole, holes, {}, struct {
+            fn lessThan(_: void, a: Hole, b: Hole) bool {
+                return a.record < b.record;
+            }
+        }.lessThan);
+
+        template.* = .{
+            .allocator = allocator,
+            .records = records,
+            .attributes = attributes,
+            .holes = holes,
+            .strings = strings,
+            .hole_count = @intCast(holes.len),
+            .max_depth = self.max_depth,
+        };
+        return template;
+    }
+};
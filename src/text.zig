@@ -285,6 +285,8 @@
 const std = @import("std");
 const Allocator = std.mem.Allocator;
 const node_mod = @import("node.zig");
+const range_mod = @import("range.zig");
+const character_data = @import("character_data.zig");
 const Node = node_mod.Node;
 const NodeType = node_mod.NodeType;
 const NodeVTable = node_mod.NodeVTable;
@@ -308,6 +310,15 @@ pub const Text = struct {
     /// Allocated and freed by this Text node
     data: []u8,
 
+    /// Length of the buffer `data` starts, when long data keeps spare room
+    /// for in-place edits (0: the buffer is exactly `data`; see
+    /// character_data.zig)
+    capacity: usize = 0,
+
+    /// UTF-16 length and last converted offset of `data`, for DOMString
+    /// offsets (see character_data.Utf16Index)
+    utf16: character_data.Utf16Index = .{},
+
     /// Vtable for Text nodes.
     const vtable = NodeVTable{
         .deinit = deinitImpl,
@@ -462,6 +473,8 @@ pub const Text = struct {
 
         // Initialize Text-specific fields
         text.data = data;
+        text.capacity = 0;
+        text.utf16 = .{};
 
         return text;
     }
@@ -510,32 +523,8 @@ pub const Text = struct {
     /// ## Errors
     /// - `error.OutOfMemory`: Failed to allocate new string
     pub fn appendData(self: *Text, text_to_append: []const u8) !void {
-        // Capture old value for mutation observers (before modification)
-        const old_value = try self.prototype.allocator.dupe(u8, self.data);
-        defer self.prototype.allocator.free(old_value);
-
-        const new_data = try std.mem.concat(
-            self.prototype.allocator,
-            u8,
-            &[_][]const u8{ self.data, text_to_append },
-        );
-
-        self.prototype.allocator.free(self.data);
-        self.data = new_data;
-        self.prototype.generation += 1;
-
-        // Queue mutation record for characterData
-        node_mod.queueMutationRecord(
-            &self.prototype,
-            "characterData",
-            null, // added_nodes
-            null, // removed_nodes
-            null, // previous_sibling
-            null, // next_sibling
-            null, // attribute_name
-            null, // attribute_namespace
-            old_value, // old_value
-        ) catch {}; // Best effort
+        const len = self.data.len;
+        try character_data.replaceBytes(self, len, len, text_to_append);
     }
 
     /// Inserts text at the specified offset.
@@ -552,32 +541,7 @@ pub const Text = struct {
             return error.IndexOutOfBounds;
         }
 
-        // Capture old value for mutation observers (before modification)
-        const old_value = try self.prototype.allocator.dupe(u8, self.data);
-        defer self.prototype.allocator.free(old_value);
-
-        const new_data = try std.mem.concat(
-            self.prototype.allocator,
-            u8,
-            &[_][]const u8{ self.data[0..offset], text_to_insert, self.data[offset..] },
-        );
-
-        self.prototype.allocator.free(self.data);
-        self.data = new_data;
-        self.prototype.generation += 1;
-
-        // Queue mutation record for characterData
-        node_mod.queueMutationRecord(
-            &self.prototype,
-            "characterData",
-            null, // added_nodes
-            null, // removed_nodes
-            null, // previous_sibling
-            null, // next_sibling
-            null, // attribute_name
-            null, // attribute_namespace
-            old_value, // old_value
-        ) catch {}; // Best effort
+        try character_data.replaceBytes(self, offset, offset, text_to_insert);
     }
 
     /// Deletes text at the specified offset.
@@ -594,34 +558,8 @@ pub const Text = struct {
             return error.IndexOutOfBounds;
         }
 
-        // Capture old value for mutation observers (before modification)
-        const old_value = try self.prototype.allocator.dupe(u8, self.data);
-        defer self.prototype.allocator.free(old_value);
-
         const end = @min(offset + count, self.data.len);
-
-        const new_data = try std.mem.concat(
-            self.prototype.allocator,
-            u8,
-            &[_][]const u8{ self.data[0..offset], self.data[end..] },
-        );
-
-        self.prototype.allocator.free(self.data);
-        self.data = new_data;
-        self.prototype.generation += 1;
-
-        // Queue mutation record for characterData
-        node_mod.queueMutationRecord(
-            &self.prototype,
-            "characterData",
-            null, // added_nodes
-            null, // removed_nodes
-            null, // previous_sibling
-            null, // next_sibling
-            null, // attribute_name
-            null, // attribute_namespace
-            old_value, // old_value
-        ) catch {}; // Best effort
+        try character_data.replaceBytes(self, offset, end, "");
     }
 
     /// Replaces text at the specified offset.
@@ -645,33 +583,7 @@ pub const Text = struct {
         }
 
         const end = @min(offset + count, self.data.len);
-
-        // Capture old value for mutation observers (before modification)
-        const old_value = try self.prototype.allocator.dupe(u8, self.data);
-        defer self.prototype.allocator.free(old_value);
-
-        const new_data = try std.mem.concat(
-            self.prototype.allocator,
-            u8,
-            &[_][]const u8{ self.data[0..offset], replacement, self.data[end..] },
-        );
-
-        self.prototype.allocator.free(self.data);
-        self.data = new_data;
-        self.prototype.generation += 1;
-
-        // Queue mutation record for characterData
-        node_mod.queueMutationRecord(
-            &self.prototype,
-            "characterData",
-            null, // added_nodes
-            null, // removed_nodes
-            null, // previous_sibling
-            null, // next_sibling
-            null, // attribute_name
-            null, // attribute_namespace
-            old_value, // old_value
-        ) catch {}; // Best effort
+        try character_data.replaceBytes(self, offset, end, replacement);
     }
 
     /// Splits this text node at the specified offset.
@@ -724,33 +636,30 @@ pub const Text = struct {
     /// ## Implementation Notes
     /// Per WHATWG spec, offset is measured in UTF-16 code units (DOMString semantics).
     /// We convert UTF-16 offsets to UTF-8 byte offsets internally.
+    ///
+    /// The data is split by `character_data.splitData()`: the larger half
+    /// keeps the buffer, so a split allocates only the smaller half.
     pub fn splitText(self: *Text, offset: usize) !*Text {
-        const string_utils = @import("string_utils.zig");
-
-        // Calculate length in UTF-16 code units
-        const utf16_len = string_utils.utf16Length(self.data);
+        try self.prototype.checkMutable();
 
         // Step 1: Validate offset (in UTF-16 code units)
-        if (offset > utf16_len) {
+        if (offset > character_data.utf16Length(self)) {
             return error.IndexSizeError;
         }
 
         // Step 2: Convert UTF-16 offset to UTF-8 byte offset
-        const byte_offset = string_utils.utf16OffsetToUtf8Byte(self.data, offset);
+        const byte_offset = character_data.utf16ToByte(self, offset);
 
-        // Step 3: Create new text node with text after offset
-        // Text.create will dupe the content, so just pass the slice
-        const new_text = try Text.create(self.prototype.allocator, self.data[byte_offset..]);
+        // Step 3: Create new text node (its data is moved in below)
+        const new_text = try Text.create(self.prototype.allocator, "");
         errdefer new_text.prototype.release();
 
         // Set owner document from the original text node's document
         // (following the same pattern as cloneNode)
         new_text.prototype.owner_document = self.prototype.owner_document;
 
-        // Step 4: Truncate this node's data to before offset
-        const truncated = try self.prototype.allocator.dupe(u8, self.data[0..byte_offset]);
-        self.prototype.allocator.free(self.data);
-        self.data = truncated;
+        // Step 4: Move the text after offset to the new node
+        try character_data.splitData(self, new_text, byte_offset);
 
         // Step 5: If this node has a parent, insert new node after this one
         if (self.prototype.parent_node) |parent| {
@@ -759,6 +668,8 @@ pub const Text = struct {
         }
 
         self.prototype.generation += 1;
+        self.prototype.invalidateHashes();
+        range_mod.textSplit(&self.prototype, &new_text.prototype, byte_offset, new_text.data.len);
         return new_text;
     }
 
@@ -803,32 +714,44 @@ pub const Text = struct {
     /// // whole = "Hello World"
     /// ```
     pub fn wholeText(self: *const Text, allocator: Allocator) ![]const u8 {
-        var list: std.ArrayList(u8) = .{};
-        errdefer list.deinit(allocator);
+        const whole = try allocator.alloc(u8, self.wholeTextLength());
+        return self.writeWholeText(whole);
+    }
 
-        // Find the first text node in the contiguous sequence
-        var first: *Node = @constCast(&self.prototype);
-        while (first.previous_sibling) |prev| {
-            if (prev.node_type == .text) {
-                first = prev;
-            } else {
-                break;
-            }
+    /// Returns the length of `wholeText` in bytes, without building it.
+    pub fn wholeTextLength(self: *const Text) usize {
+        var total: usize = 0;
+        var current: ?*const Node = self.firstOfRun();
+        while (current) |node| : (current = node.next_sibling) {
+            if (node.node_type != .text) break;
+            const text_node: *const Text = @fieldParentPtr("prototype", node);
+            total += text_node.data.len;
         }
+        return total;
+    }
 
-        // Concatenate all contiguous text nodes
-        var current: ?*Node = first;
-        while (current) |node| {
-            if (node.node_type == .text) {
-                const text_node: *const Text = @fieldParentPtr("prototype", node);
-                try list.appendSlice(allocator, text_node.data);
-                current = node.next_sibling;
-            } else {
-                break;
-            }
+    /// Writes `wholeText` into `out`, which must hold `wholeTextLength()`
+    /// bytes, and returns the written part of `out`.
+    pub fn writeWholeText(self: *const Text, out: []u8) []u8 {
+        var written: usize = 0;
+        var current: ?*const Node = self.firstOfRun();
+        while (current) |node| : (current = node.next_sibling) {
+            if (node.node_type != .text) break;
+            const text_node: *const Text = @fieldParentPtr("prototype", node);
+            @memcpy(out[written..][0..text_node.data.len], text_node.data);
+            written += text_node.data.len;
         }
+        return out[0..written];
+    }
 
-        return try list.toOwnedSlice(allocator);
+    /// The first text node in the contiguous sequence containing this one.
+    fn firstOfRun(self: *const Text) *const Node {
+        var first: *const Node = &self.prototype;
+        while (first.previous_sibling) |prev| {
+            if (prev.node_type != .text) break;
+            first = prev;
+        }
+        return first;
     }
 
     // ========================================================================
@@ -971,19 +894,8 @@ pub const Text = struct {
     /// ## Note
     /// This is called internally during slot assignment. Users should not call this directly.
     pub fn setAssignedSlot(self: *Text, slot: ?*@import("element.zig").Element) !void {
-        if (slot == null) {
-            // Clear assigned slot
-            if (self.prototype.rare_data) |rare_data| {
-                rare_data.assigned_slot = null;
-            }
-            return;
-        }
-
-        // Ensure rare data exists
-        const rare_data = try self.prototype.ensureRareData();
-
-        // Set assigned slot (WEAK reference)
-        rare_data.assigned_slot = @ptrCast(slot.?);
+        // WEAK reference; drops the host's cached assigned nodes
+        try @import("slot_map.zig").setAssignedSlot(&self.prototype, slot);
     }
 
     // ========================================================================
@@ -1272,14 +1184,14 @@ pub const Text = struct {
                 // Get Document from its node field (node is first field)
                 const Document = @import("document.zig").Document;
                 const doc: *Document = @fieldParentPtr("prototype", owner_doc);
-                doc.releaseNodeRef();
+                doc.releaseNodeRef(node);
             }
         }
 
         // Clean up rare data if allocated
         text.prototype.deinitRareData();
 
-        text.prototype.allocator.free(text.data);
+        character_data.freeData(text);
         text.prototype.allocator.destroy(text);
     }
 
@@ -1302,9 +1214,11 @@ pub const Text = struct {
         const new_data = try node.allocator.dupe(u8, value);
 
         // Free old and replace
-        node.allocator.free(text.data);
-        text.data = new_data;
+        const old_len = text.data.len;
+        character_data.takeData(text, new_data);
         node.generation += 1;
+        node.invalidateHashes();
+        range_mod.dataReplaced(node, 0, old_len, new_data.len);
     }
 
     /// Vtable implementation: clone node
@@ -0,0 +1,273 @@
+//! Tree Builder - Push-style construction of a tree in document order
+//!
+//! Building a tree through the regular API costs one createElement,
+//! setAttribute and appendChild call per node, and every appendChild runs
+//! pre-insertion validation, adoption, live range updates and mutation
+//! record queuing. A serializer or template renderer that already produces
+//! nodes in document order needs none of that: a `TreeBuilder` creates each
+//! node and links it straight after the previous one, into a
+//! DocumentFragment nothing else can see yet. The caller then inserts the
+//! fragment once, which is a single insertion (one mutation record, one
+//! range update) however many nodes it holds.
+//!
+//! The builder guarantees the tree is well formed (only new nodes are
+//! linked, elements close in order), so no per-node validation runs beyond
+//! what createElement and setAttribute do themselves.
+//!
+//! ## Instruction Buffers
+//!
+//! `write()` runs a whole chunk of instructions in one call, so bindings
+//! cross into the DOM once per chunk rather than once per node. Lengths are
+//! little-endian u32; strings are UTF-8 and not terminated.
+//!
+//! ```text
+//! op_open   u8 1, u32 tag_len, tag, u32 attr_count,
+//!           attr_count * (u32 name_len, name, u32 value_len, value)
+//! op_text   u8 2, u32 len, data
+//! op_close  u8 3
+//! ```
+//!
+//! A chunk holds whole instructions; open elements carry over from one
+//! chunk to the next.
+//!
+//! ## Usage
+//!
+//! ```zig
+//! var builder = TreeBuilder.init(doc);
+//! defer builder.deinit();
+//!
+//! try builder.open("list", &.{.{ .name = "class", .value = "rows" }});
+//! try builder.open("item", &.{});
+//! try builder.text("first");
+//! try builder.close();
+//! try builder.close();
+//!
+//! const fragment = try builder.finish();
+//! defer fragment.prototype.release();
+//! _ = try parent.prototype.appendChild(&fragment.prototype);
+//! ```
+
+const std = @import("std");
+const Allocator = std.mem.Allocator;
+const Node = @import("node.zig").Node;
+const Document = @import("document.zig").Document;
+const DocumentFragment = @import("document_fragment.zig").DocumentFragment;
+const Text = @import("text.zig").Text;
+const tree_helpers = @import("tree_helpers.zig");
+
+/// Opens an element (a child of the current element)
+pub const op_open: u8 = 1;
+
+/// Appends text to the current element
+pub const op_text: u8 = 2;
+
+/// Closes the current element
+pub const op_close: u8 = 3;
+
+/// One attribute of an opened element.
+pub const Attribute = @import("element.zig").AttributeInit;
+
+pub const TreeBuilder = struct {
+    document: *Document,
+
+    /// Fragment being built (created on the first node)
+    fragment: ?*DocumentFragment = null,
+
+    /// Open elements, innermost last
+    open_elements: std.ArrayListUnmanaged(*Node) = .{},
+
+    pub fn init(document: *Document) TreeBuilder {
+        return .{ .document = document };
+    }
+
+    /// Releases the builder and any tree not taken with finish().
+    pub fn deinit(self: *TreeBuilder) void {
+        self.open_elements.deinit(self.allocator());
+        if (self.fragment) |fragment| fragment.prototype.release();
+    }
+
+    /// Opens an element with `attributes` as the last child of the current
+    /// element; later nodes go inside it until close().
+    ///
+    /// ## Errors
+    /// - `error.InvalidCharacterError`: Invalid attribute name
+    /// - `error.OutOfMemory`: Failed to allocate
+    pub fn open(self: *TreeBuilder, tag_name: []const u8, attributes: []const Attribute) !void {
+        const parent = try self.currentParent();
+        try self.open_elements.ensureUnusedCapacity(self.allocator(), 1);
+
+        const elem = try self.document.createElement(tag_name);
+        errdefer elem.prototype.release();
+        try elem.setAttributes(attributes);
+
+        appendBuilt(parent, &elem.prototype);
+        self.open_elements.appendAssumeCapacity(&elem.prototype);
+    }
+
+    /// Appends `data` as text of the current element. Text that directly
+    /// follows other text joins its Text node.
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to allocate
+    pub fn text(self: *TreeBuilder, data: []const u8) !void {
+        if (data.len == 0) return;
+        const parent = try self.currentParent();
+
+        if (parent.last_child) |last| {
+            if (last.node_type == .text) {
+                const last_text: *Text = @fieldParentPtr("prototype", last);
+                return last_text.appendData(data);
+            }
+        }
+
+        const node = try self.document.createTextNode(data);
+        appendBuilt(parent, &node.prototype);
+    }
+
+    /// Appends a Comment with `data` to the current element.
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to allocate
+    pub fn comment(self: *TreeBuilder, data: []const u8) !void {
+        const parent = try self.currentParent();
+        const node = try self.document.createComment(data);
+        appendBuilt(parent, &node.prototype);
+    }
+
+    /// Closes the current element.
+    ///
+    /// ## Errors
+    /// - `error.InvalidStateError`: No element is open
+    pub fn close(self: *TreeBuilder) !void {
+        if (self.open_elements.pop() == null) return error.InvalidStateError;
+    }
+
+    /// Closes the innermost open element named `tag_name` and every element
+    /// opened inside it. Returns false, closing nothing, when no open
+    /// element has that name.
+    pub fn closeNamed(self: *TreeBuilder, tag_name: []const u8) bool {
+        const Element = @import("element.zig").Element;
+        var i = self.open_elements.items.len;
+        while (i > 0) {
+            i -= 1;
+            const elem: *Element = @fieldParentPtr("prototype", self.open_elements.items[i]);
+            if (std.mem.eql(u8, elem.tag_name, tag_name)) {
+                self.open_elements.shrinkRetainingCapacity(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// Runs a chunk of instructions (see the module doc for the encoding).
+    ///
+    /// ## Errors
+    /// - `error.SyntaxError`: Truncated instruction or unknown opcode; the
+    ///   instructions before it have run
+    /// - `error.InvalidStateError`: op_close with no element open
+    /// - Any error of open() or text()
+    pub fn write(self: *TreeBuilder, instructions: []const u8) !void {
+        var reader = Reader{ .bytes = instructions };
+        var attributes: [16]Attribute = undefined;
+
+        while (reader.pos < instructions.len) {
+            switch (try reader.byte()) {
+                op_open => {
+                    const tag_name = try reader.string();
+                    const count = try reader.int();
+                    if (count <= attributes.len) {
+                        for (attributes[0..count]) |*attr| {
+                            attr.* = .{ .name = try reader.string(), .value = try reader.string() };
+                        }
+                        try self.open(tag_name, attributes[0..count]);
+                    } else {
+                        // Rare: set the attributes one at a time
+                        try self.open(tag_name, &.{});
+                        const elem = self.open_elements.getLast();
+                        const Element = @import("element.zig").Element;
+                        const element: *Element = @fieldParentPtr("prototype", elem);
+                        for (0..count) |_| {
+                            const name = try reader.string();
+                            try element.setAttribute(name, try reader.string());
+                        }
+                    }
+                },
+                op_text => try self.text(try reader.string()),
+                op_close => try self.close(),
+                else => return error.SyntaxError,
+            }
+        }
+    }
+
+    /// Closes every open element and hands over the built tree. The caller
+    /// owns the returned fragment (release it after inserting it); the
+    /// builder starts a new one on the next node.
+    ///
+    /// ## Errors
+    /// - `error.OutOfMemory`: Failed to create an empty fragment
+    pub fn finish(self: *TreeBuilder) !*DocumentFragment {
+        const fragment = self.fragment orelse try self.document.createDocumentFragment();
+        self.fragment = null;
+        self.open_elements.clearRetainingCapacity();
+
+        // One version bump for the whole build (see appendBuilt)
+        fragment.prototype.noteMutation();
+        return fragment;
+    }
+
+    fn allocator(self: *const TreeBuilder) Allocator {
+        return self.document.prototype.allocator;
+    }
+
+    fn currentParent(self: *TreeBuilder) !*Node {
+        if (self.open_elements.getLastOrNull()) |elem| return elem;
+        if (self.fragment == null) {
+            self.fragment = try self.document.createDocumentFragment();
+        }
+        return &self.fragment.?.prototype;
+    }
+
+    /// Links a new, parentless node as the last child of `parent`, which is
+    /// in the builder's fragment (disconnected, unobserved, without ranges).
+    /// Also used by Template, whose instances are built the same way.
+    pub fn appendBuilt(parent: *Node, node: *Node) void {
+        node.parent_node = parent;
+        node.setHasParent(true);
+        tree_helpers.setSubtreeDepth(node, parent.depth + 1);
+        node.previous_sibling = parent.last_child;
+        if (parent.last_child) |last| {
+            last.next_sibling = node;
+        } else {
+            parent.first_child = node;
+        }
+        parent.last_child = node;
+        parent.generation += 1;
+    }
+};
+
+/// Bounds-checked reads from an instruction buffer.
+const Reader = struct {
+    bytes: []const u8,
+    pos: usize = 0,
+
+    fn byte(self: *Reader) !u8 {
+        if (self.pos >= self.bytes.len) return error.SyntaxError;
+        self.pos += 1;
+        return self.bytes[self.pos - 1];
+    }
+
+    fn int(self: *Reader) !u32 {
+        if (self.bytes.len - self.pos < 4) return error.SyntaxError;
+        const value = std.mem.readInt(u32, self.bytes[self.pos..][0..4], .little);
+        self.pos += 4;
+        return value;
+    }
+
+    fn string(self: *Reader) ![]const u8 {
+        const len = try self.int();
+        if (self.bytes.len - self.pos < len) return error.SyntaxError;
+        const value = self.bytes[self.pos..][0..len];
+        self.pos += len;
+        return value;
+    }
+};
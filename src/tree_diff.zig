@@ -0,0 +1,729 @@
+//! Tree Diff - Patch streams between two subtrees
+//!
+//! Server-driven UIs keep the previous tree, build the next one and send
+//! only the difference. Computing it through bindings crosses into the DOM
+//! for every node and property of both trees; `diff` compares the trees
+//! natively and returns a flat patch buffer the bindings can hand over
+//! whole (e.g. as an ArrayBuffer). `apply` replays a patch on the old tree;
+//! `replay` applies one to any table of nodes, such as a patch received
+//! from another process.
+//!
+//! ## Buffer Layout
+//!
+//! All integers are native-endian u32 unless noted; every section starts
+//! at a 4-byte aligned offset and follows the previous one.
+//!
+//! ```text
+//! PatchHeader                 (32 bytes)
+//! PatchRecord[op_count]       (32 bytes each, in application order)
+//! StringEntry[string_count]   (8 bytes each)
+//! string bytes[strings_length] (UTF-8, deduplicated, not terminated)
+//! ```
+//!
+//! Nodes are addressed by preorder index, root 0, the same numbering as
+//! the records of `tree_snapshot.snapshotSubtree()`: `target` and `before`
+//! index the old tree as it was before the patch, `source` and
+//! `before_source` index the new tree. String fields are ids into the
+//! string table (`none` if absent).
+//!
+//! | op               | fields                                            |
+//! |------------------|---------------------------------------------------|
+//! | insert           | copy of `source` into `target`, before the ref    |
+//! | remove           | `target` leaves its parent                        |
+//! | move             | `target` moves before the ref, same parent        |
+//! | replace          | copy of `source` replaces `target`                |
+//! | set_attribute    | `target`.setAttributeNS(namespace, name, value)   |
+//! | remove_attribute | `target`.removeAttributeNS(namespace, name=local) |
+//! | set_text         | `target`.data = value                             |
+//!
+//! The reference sibling of insert and move is old node `before` or the
+//! node inserted for `source` index `before_source`; with both `none` the
+//! node is appended.
+//!
+//! ## Matching
+//!
+//! Children of matched nodes are matched per child list: with a key
+//! attribute name, element children carrying that attribute match the old
+//! child with the same value; all other children match by position among
+//! the unkeyed children. A match also needs the same node type and name
+//! (tag name and namespace, target, doctype name); changed attributes and
+//! character data then become set ops, and unmatched children become
+//! insert and remove ops. Matched children outside the longest run
+//! already in order are moved; the others stay in place. Removed children
+//! and each run of inserted children come in document order, so a
+//! coalescing observer (or a batch) sees one childList record per run.
+
+const std = @import("std");
+const Allocator = std.mem.Allocator;
+const Node = @import("node.zig").Node;
+const Element = @import("element.zig").Element;
+const Document = @import("document.zig").Document;
+const DocumentType = @import("document_type.zig").DocumentType;
+const ProcessingInstruction = @import("processing_instruction.zig").ProcessingInstruction;
+const Text = @import("text.zig").Text;
+
+/// Index value meaning "no node" / "no string".
+pub const none: u32 = std.math.maxInt(u32);
+
+/// Magic number at the start of every patch ("DOMP").
+pub const magic: u32 = 0x504D4F44;
+
+/// Current layout version.
+pub const version: u16 = 1;
+
+/// Patch operations.
+pub const PatchOp = enum(u8) {
+    insert = 1,
+    remove = 2,
+    move = 3,
+    replace = 4,
+    set_attribute = 5,
+    remove_attribute = 6,
+    set_text = 7,
+};
+
+/// Patch header.
+pub const PatchHeader = extern struct {
+    magic: u32,
+    version: u16,
+    reserved: u16 = 0,
+    op_count: u32,
+    string_count: u32,
+    strings_length: u32,
+    /// Nodes in the old and new tree (their preorder index ranges)
+    old_node_count: u32,
+    new_node_count: u32,
+    reserved2: u32 = 0,
+};
+
+/// One operation.
+pub const PatchRecord = extern struct {
+    op: PatchOp,
+    reserved: [3]u8 = .{ 0, 0, 0 },
+    /// Old-tree node changed (parent for insert)
+    target: u32,
+    /// New-tree node copied by insert and replace
+    source: u32 = none,
+    /// Old-tree reference sibling of insert and move
+    before: u32 = none,
+    /// New-tree index of an inserted reference sibling
+    before_source: u32 = none,
+    /// Attribute name (qualified for set_attribute, local for remove_attribute)
+    name: u32 = none,
+    /// Attribute namespace
+    namespace: u32 = none,
+    /// Attribute value or character data
+    value: u32 = none,
+};
+
+/// String table entry, a range of the string bytes.
+pub const StringEntry = extern struct {
+    offset: u32,
+    length: u32,
+};
+
+comptime {
+    std.debug.assert(@sizeOf(PatchHeader) == 32);
+    std.debug.assert(@sizeOf(PatchRecord) == 32);
+    std.debug.assert(@sizeOf(StringEntry) == 8);
+}
+
+/// Alignment of patch buffers.
+pub const buffer_alignment = std.mem.Alignment.of(u32);
+
+/// Patch buffer type.
+pub const PatchBuffer = []align(4) u8;
+
+/// Diff options.
+pub const Options = struct {
+    /// Attribute whose value identifies element children across the trees
+    /// (e.g. "key"); null matches every child by position
+    key: ?[]const u8 = null,
+};
+
+/// A tree in preorder; the subtree of node i ends before `ends[i]`.
+const Tree = struct {
+    nodes: std.ArrayList(*Node) = .{},
+    ends: std.ArrayList(u32) = .{},
+
+    fn init(allocator: Allocator, root: *Node) !Tree {
+        var tree = Tree{};
+        errdefer tree.deinit(allocator);
+
+        var open = std.ArrayList(u32){};
+        defer open.deinit(allocator);
+
+        var next: ?*Node = root;
+        while (true) {
+            const node = next orelse {
+                const closed = open.pop() orelse break;
+                tree.ends.items[closed] = @intCast(tree.nodes.items.len);
+                next = if (open.items.len > 0) tree.nodes.items[closed].next_sibling else null;
+                continue;
+            };
+            try open.append(allocator, @intCast(tree.nodes.items.len));
+            try tree.nodes.append(allocator, node);
+            try tree.ends.append(allocator, none);
+            next = node.first_child;
+        }
+        return tree;
+    }
+
+    fn deinit(self: *Tree, allocator: Allocator) void {
+        self.nodes.deinit(allocator);
+        self.ends.deinit(allocator);
+    }
+
+    /// Appends the child indices of `index` to `children`.
+    fn childrenOf(self: *const Tree, allocator: Allocator, index: u32, children: *std.ArrayList(u32)) !void {
+        var child = index + 1;
+        while (child < self.ends.items[index]) : (child = self.ends.items[child]) {
+            try children.append(allocator, child);
+        }
+    }
+};
+
+/// Returns true if `old` can be updated in place to `new`.
+fn compatible(old: *const Node, new: *const Node) bool {
+    if (old.node_type != new.node_type) return false;
+    return switch (old.node_type) {
+        .element => blk: {
+            const a: *const Element = @fieldParentPtr("prototype", old);
+            const b: *const Element = @fieldParentPtr("prototype", new);
+            break :blk std.mem.eql(u8, a.tag_name, b.tag_name) and optionalEql(a.namespace_uri, b.namespace_uri);
+        },
+        .processing_instruction => blk: {
+            const a: *const ProcessingInstruction = @fieldParentPtr("prototype", @as(*const Text, @fieldParentPtr("prototype", old)));
+            const b: *const ProcessingInstruction = @fieldParentPtr("prototype", @as(*const Text, @fieldParentPtr("prototype", new)));
+            break :blk std.mem.eql(u8, a.target, b.target);
+        },
+        .document_type => blk: {
+            const a: *const DocumentType = @fieldParentPtr("prototype", old);
+            const b: *const DocumentType = @fieldParentPtr("prototype", new);
+            break :blk std.mem.eql(u8, a.name, b.name);
+        },
+        else => true,
+    };
+}
+
+fn optionalEql(a: ?[]const u8, b: ?[]const u8) bool {
+    if (a == null or b == null) return a == null and b == null;
+    return std.mem.eql(u8, a.?, b.?);
+}
+
+const Differ = struct {
+    allocator: Allocator,
+    options: Options,
+    old: Tree,
+    new: Tree,
+    records: std.ArrayList(PatchRecord) = .{},
+    entries: std.ArrayList(StringEntry) = .{},
+    strings: std.ArrayList(u8) = .{},
+    string_ids: std.StringHashMapUnmanaged(u32) = .{},
+
+    // Scratch space reused for every child list
+    pairs: std.ArrayList([2]u32) = .{},
+    old_children: std.ArrayList(u32) = .{},
+    new_children: std.ArrayList(u32) = .{},
+    /// Old child position matched by each new child, or `none`
+    matches: std.ArrayList(u32) = .{},
+    used: std.ArrayList(bool) = .{},
+    unkeyed: std.ArrayList(u32) = .{},
+    keyed: std.StringHashMapUnmanaged(u32) = .{},
+    sequence: std.ArrayList(u32) = .{},
+    stays: std.ArrayList(bool) = .{},
+    tails: std.ArrayList(u32) = .{},
+    previous: std.ArrayList(u32) = .{},
+
+    fn deinit(self: *Differ) void {
+        self.old.deinit(self.allocator);
+        self.new.deinit(self.allocator);
+        inline for (.{ "records", "entries", "strings", "pairs", "old_children", "new_children", "matches", "used", "unkeyed", "sequence", "stays", "tails", "previous" }) |name| {
+            @field(self, name).deinit(self.allocator);
+        }
+        self.string_ids.deinit(self.allocator);
+        self.keyed.deinit(self.allocator);
+    }
+
+    /// Returns the id of `str`, adding it to the table on first use.
+    fn stringId(self: *Differ, str: []const u8) !u32 {
+        const entry = try self.string_ids.getOrPut(self.allocator, str);
+        if (!entry.found_existing) {
+            entry.value_ptr.* = @intCast(self.entries.items.len);
+            try self.entries.append(self.allocator, .{
+                .offset = @intCast(self.strings.items.len),
+                .length = @intCast(str.len),
+            });
+            try self.strings.appendSlice(self.allocator, str);
+        }
+        return entry.value_ptr.*;
+    }
+
+    fn optionalStringId(self: *Differ, str: ?[]const u8) !u32 {
+        return if (str) |s| self.stringId(s) else none;
+    }
+
+    fn emit(self: *Differ, record: PatchRecord) !void {
+        try self.records.append(self.allocator, record);
+    }
+
+    fn run(self: *Differ) !void {
+        if (!compatible(self.old.nodes.items[0], self.new.nodes.items[0])) {
+            return self.emit(.{ .op = .replace, .target = 0, .source = 0 });
+        }
+        try self.pairs.append(self.allocator, .{ 0, 0 });
+        while (self.pairs.pop()) |pair| {
+            try self.diffNode(pair[0], pair[1]);
+            try self.diffChildren(pair[0], pair[1]);
+        }
+    }
+
+    /// Emits the attribute and character data changes of a matched pair.
+    fn diffNode(self: *Differ, old_index: u32, new_index: u32) !void {
+        const old = self.old.nodes.items[old_index];
+        const new = self.new.nodes.items[new_index];
+        switch (old.node_type) {
+            .element => {
+                const a: *const Element = @fieldParentPtr("prototype", old);
+                const b: *const Element = @fieldParentPtr("prototype", new);
+
+                var removed = a.attributes.iterator();
+                while (removed.next()) |attr| {
+                    if (b.getAttributeNS(attr.name.namespace_uri, attr.name.local_name) != null) continue;
+                    try self.emit(.{
+                        .op = .remove_attribute,
+                        .target = old_index,
+                        .name = try self.stringId(attr.name.local_name),
+                        .namespace = try self.optionalStringId(attr.name.namespace_uri),
+                    });
+                }
+
+                var changed = b.attributes.iterator();
+                while (changed.next()) |attr| {
+                    if (a.getAttributeNS(attr.name.namespace_uri, attr.name.local_name)) |value| {
+                        if (std.mem.eql(u8, value, attr.value)) continue;
+                    }
+                    const name = if (attr.name.prefix) |prefix| blk: {
+                        const qualified = try std.fmt.allocPrint(self.allocator, "{s}:{s}", .{ prefix, attr.name.local_name });
+                        defer self.allocator.free(qualified);
+                        break :blk try self.stringId(qualified);
+                    } else try self.stringId(attr.name.local_name);
+                    try self.emit(.{
+                        .op = .set_attribute,
+                        .target = old_index,
+                        .name = name,
+                        .namespace = try self.optionalStringId(attr.name.namespace_uri),
+                        .value = try self.stringId(attr.value),
+                    });
+                }
+            },
+            .text, .comment, .cdata_section, .processing_instruction => {
+                const data = new.nodeValue().?;
+                if (std.mem.eql(u8, old.nodeValue().?, data)) return;
+                try self.emit(.{ .op = .set_text, .target = old_index, .value = try self.stringId(data) });
+            },
+            else => {},
+        }
+    }
+
+    fn keyOf(self: *const Differ, node: *const Node) ?[]const u8 {
+        const key = self.options.key orelse return null;
+        if (node.node_type != .element) return null;
+        const elem: *const Element = @fieldParentPtr("prototype", node);
+        return elem.getAttribute(key);
+    }
+
+    /// Matches the child lists of a matched pair and emits their changes;
+    /// matched children are queued as pairs.
+    fn diffChildren(self: *Differ, old_index: u32, new_index: u32) !void {
+        const allocator = self.allocator;
+        self.old_children.clearRetainingCapacity();
+        self.new_children.clearRetainingCapacity();
+        try self.old.childrenOf(allocator, old_index, &self.old_children);
+        try self.new.childrenOf(allocator, new_index, &self.new_children);
+        const old_children = self.old_children.items;
+        const new_children = self.new_children.items;
+        if (old_children.len == 0 and new_children.len == 0) return;
+
+        // Index the old children by key; the rest match by position
+        self.keyed.clearRetainingCapacity();
+        self.unkeyed.clearRetainingCapacity();
+        try self.used.resize(allocator, old_children.len);
+        @memset(self.used.items, false);
+        for (old_children, 0..) |child, position| {
+            if (self.keyOf(self.old.nodes.items[child])) |key| {
+                const entry = try self.keyed.getOrPut(allocator, key);
+                if (!entry.found_existing) {
+                    entry.value_ptr.* = @intCast(position);
+                    continue;
+                }
+            }
+            try self.unkeyed.append(allocator, @intCast(position));
+        }
+
+        try self.matches.resize(allocator, new_children.len);
+        var next_unkeyed: usize = 0;
+        for (new_children, self.matches.items) |child, *match| {
+            match.* = none;
+            const node = self.new.nodes.items[child];
+            const candidate = if (self.keyOf(node)) |key|
+                self.keyed.get(key) orelse continue
+            else blk: {
+                if (next_unkeyed == self.unkeyed.items.len) continue;
+                next_unkeyed += 1;
+                break :blk self.unkeyed.items[next_unkeyed - 1];
+            };
+            if (self.used.items[candidate]) continue;
+            if (!compatible(self.old.nodes.items[old_children[candidate]], node)) continue;
+            self.used.items[candidate] = true;
+            match.* = candidate;
+        }
+
+        for (old_children, self.used.items) |child, used| {
+            if (!used) try self.emit(.{ .op = .remove, .target = child });
+        }
+
+        // Matched children in the longest run already in order stay put
+        self.sequence.clearRetainingCapacity();
+        for (self.matches.items) |match| {
+            if (match != none) try self.sequence.append(allocator, match);
+        }
+        try self.markIncreasingRun();
+
+        // Right to left, so every reference sibling is already in place
+        var before: u32 = none;
+        var before_source: u32 = none;
+        var matched = self.sequence.items.len;
+        var i = new_children.len;
+        while (i > 0) {
+            i -= 1;
+            const match = self.matches.items[i];
+            if (match == none) {
+                // A run of new children is inserted in order before one
+                // sibling, so coalescing observers merge it into one record
+                var start = i;
+                while (start > 0 and self.matches.items[start - 1] == none) start -= 1;
+                for (new_children[start .. i + 1]) |child| {
+                    try self.emit(.{
+                        .op = .insert,
+                        .target = old_index,
+                        .source = child,
+                        .before = before,
+                        .before_source = before_source,
+                    });
+                }
+                before = none;
+                before_source = new_children[start];
+                i = start;
+                continue;
+            }
+            matched -= 1;
+            const old_child = old_children[match];
+            if (!self.stays.items[matched]) {
+                try self.emit(.{
+                    .op = .move,
+                    .target = old_child,
+                    .before = before,
+                    .before_source = before_source,
+                });
+            }
+            try self.pairs.append(allocator, .{ old_child, new_children[i] });
+            before = old_child;
+            before_source = none;
+        }
+    }
+
+    /// Marks in `stays` one longest strictly increasing subsequence of
+    /// `sequence`.
+    fn markIncreasingRun(self: *Differ) !void {
+        const allocator = self.allocator;
+        const sequence = self.sequence.items;
+        try self.stays.resize(allocator, sequence.len);
+        @memset(self.stays.items, false);
+        try self.previous.resize(allocator, sequence.len);
+        self.tails.clearRetainingCapacity();
+
+        for (sequence, 0..) |value, i| {
+            // First tail not below value
+            var low: usize = 0;
+            var high: usize = self.tails.items.len;
+            while (low < high) {
+                const mid = (low + high) / 2;
+                if (sequence[self.tails.items[mid]] < value) low = mid + 1 else high = mid;
+            }
+            self.previous.items[i] = if (low > 0) self.tails.items[low - 1] else none;
+            if (low == self.tails.items.len) {
+                try self.tails.append(allocator, @intCast(i));
+            } else {
+                self.tails.items[low] = @intCast(i);
+            }
+        }
+
+        var index = if (self.tails.items.len > 0) self.tails.getLast() else none;
+        while (index != none) : (index = self.previous.items[index]) {
+            self.stays.items[index] = true;
+        }
+    }
+
+    fn finish(self: *Differ) !PatchBuffer {
+        const header = PatchHeader{
+            .magic = magic,
+            .version = version,
+            .op_count = @intCast(self.records.items.len),
+            .string_count = @intCast(self.entries.items.len),
+            .strings_length = @intCast(self.strings.items.len),
+            .old_node_count = @intCast(self.old.nodes.items.len),
+            .new_node_count = @intCast(self.new.nodes.items.len),
+        };
+        const records_offset: usize = @sizeOf(PatchHeader);
+        const entries_offset = records_offset + self.records.items.len * @sizeOf(PatchRecord);
+        const strings_offset = entries_offset + self.entries.items.len * @sizeOf(StringEntry);
+        const total = std.mem.alignForward(usize, strings_offset + self.strings.items.len, 4);
+
+        const buffer = try self.allocator.alignedAlloc(u8, buffer_alignment, total);
+        @memset(buffer[strings_offset + self.strings.items.len ..], 0);
+        @memcpy(buffer[0..@sizeOf(PatchHeader)], std.mem.asBytes(&header));
+        @memcpy(buffer[records_offset..entries_offset], std.mem.sliceAsBytes(self.records.items));
+        @memcpy(buffer[entries_offset..strings_offset], std.mem.sliceAsBytes(self.entries.items));
+        @memcpy(buffer[strings_offset..][0..self.strings.items.len], self.strings.items);
+        return buffer;
+    }
+};
+
+/// Computes the patch that turns the subtree of `old` into that of `new`.
+///
+/// Neither tree is changed; they may belong to different documents.
+///
+/// ## Returns
+/// Patch buffer; free with `freePatch`.
+///
+/// ## Errors
+/// - `error.OutOfMemory`: Allocation failed
+pub fn diff(allocator: Allocator, old: *Node, new: *Node, options: Options) !PatchBuffer {
+    var differ = Differ{
+        .allocator = allocator,
+        .options = options,
+        .old = try Tree.init(allocator, old),
+        .new = undefined,
+    };
+    differ.new = Tree.init(allocator, new) catch |err| {
+        differ.old.deinit(allocator);
+        return err;
+    };
+    defer differ.deinit();
+
+    try differ.run();
+    return differ.finish();
+}
+
+/// Frees a buffer returned by `diff`.
+pub fn freePatch(allocator: Allocator, buffer: PatchBuffer) void {
+    allocator.free(buffer);
+}
+
+/// Returns the header of a patch buffer.
+pub fn headerOf(buffer: []align(4) const u8) *const PatchHeader {
+    return @ptrCast(buffer.ptr);
+}
+
+/// Returns the operations of a patch buffer.
+pub fn recordsOf(buffer: []align(4) const u8) []const PatchRecord {
+    const header = headerOf(buffer);
+    const ptr: [*]const PatchRecord = @ptrCast(@alignCast(buffer.ptr + @sizeOf(PatchHeader)));
+    return ptr[0..header.op_count];
+}
+
+/// Returns the string for a string id, or null for `none`.
+pub fn stringOf(buffer: []align(4) const u8, id: u32) ?[]const u8 {
+    if (id == none) return null;
+    const header = headerOf(buffer);
+    const entries_offset = @sizeOf(PatchHeader) + @as(usize, header.op_count) * @sizeOf(PatchRecord);
+    const ptr: [*]const StringEntry = @ptrCast(@alignCast(buffer.ptr + entries_offset));
+    const strings_offset = entries_offset + @as(usize, header.string_count) * @sizeOf(StringEntry);
+    const entry = ptr[id];
+    return buffer[strings_offset + entry.offset ..][0..entry.length];
+}
+
+/// Checks that `bytes` is a complete patch with valid ops and string ids,
+/// e.g. one received from another process.
+///
+/// ## Errors
+/// - `error.SyntaxError`: Not a patch of this version, truncated, or with
+///   an unknown op or out-of-range string id
+pub fn validate(bytes: []align(4) const u8) !void {
+    if (bytes.len < @sizeOf(PatchHeader)) return error.SyntaxError;
+    const header = headerOf(bytes);
+    if (header.magic != magic or header.version != version) return error.SyntaxError;
+
+    const entries_offset = @sizeOf(PatchHeader) + @as(usize, header.op_count) * @sizeOf(PatchRecord);
+    const strings_offset = entries_offset + @as(usize, header.string_count) * @sizeOf(StringEntry);
+    if (std.mem.alignForward(usize, strings_offset + header.strings_length, 4) != bytes.len) return error.SyntaxError;
+
+    const entries: [*]const StringEntry = @ptrCast(@alignCast(bytes.ptr + entries_offset));
+    for (entries[0..header.string_count]) |entry| {
+        if (entry.offset > header.strings_length or header.strings_length - entry.offset < entry.length) return error.SyntaxError;
+    }
+
+    // Read ops as bytes: an unknown value is not a PatchOp
+    const records = bytes[@sizeOf(PatchHeader)..entries_offset];
+    for (recordsOf(bytes), 0..) |record, i| {
+        _ = std.meta.intToEnum(PatchOp, records[i * @sizeOf(PatchRecord)]) catch return error.SyntaxError;
+        for ([_]u32{ record.name, record.namespace, record.value }) |id| {
+            if (id != none and id >= header.string_count) return error.SyntaxError;
+        }
+        const strings_ok = switch (record.op) {
+            .set_attribute => record.name != none and record.value != none,
+            .remove_attribute => record.name != none,
+            .set_text => record.value != none,
+            else => true,
+        };
+        if (!strings_ok) return error.SyntaxError;
+    }
+}
+
+fn checkIndex(index: u32, count: usize) !void {
+    if (index >= count) return error.IndexSizeError;
+}
+
+fn checkOptionalIndex(index: u32, count: usize) !void {
+    if (index != none and index >= count) return error.IndexSizeError;
+}
+
+/// Applies a patch (from `diff`, or checked with `validate`) to the nodes
+/// of `doc`, inside one mutation
+/// batch (see `Document.beginBatch()`), so observers get coalesced records.
+///
+/// `targets` and `sources` are the node tables the patch indexes:
+/// `target` and `before` index `targets`, `source` and `before_source`
+/// index `sources`. Inserted and replacing nodes are deep copies of their
+/// sources imported into `doc`; the sources are not changed.
+///
+/// Every index is checked before the first op runs. An op that fails
+/// stops the replay; the ops before it stay applied.
+///
+/// ## Errors
+/// - `error.IndexSizeError`: An index is outside its node table
+/// - `error.InvalidNodeTypeError`: An attribute op targets a non-element
+/// - `error.NotFoundError`: A removed, moved or replaced node has no
+///   parent, or `before_source` names a source not inserted yet
+/// - Any error of the DOM operations the patch replays
+pub fn replay(
+    allocator: Allocator,
+    doc: *Document,
+    buffer: []align(4) const u8,
+    targets: []const *Node,
+    sources: []const *Node,
+) !void {
+    const records = recordsOf(buffer);
+    for (records) |record| {
+        try checkIndex(record.target, targets.len);
+        switch (record.op) {
+            .insert, .move => {
+                if (record.op == .insert) try checkIndex(record.source, sources.len);
+                try checkOptionalIndex(record.before, targets.len);
+                try checkOptionalIndex(record.before_source, sources.len);
+            },
+            .replace => try checkIndex(record.source, sources.len),
+            .set_attribute, .remove_attribute => {
+                if (targets[record.target].node_type != .element) return error.InvalidNodeTypeError;
+            },
+            .remove, .set_text => {},
+        }
+    }
+
+    // Copies of sources, for before_source references
+    var inserted = std.AutoHashMapUnmanaged(u32, *Node){};
+    defer inserted.deinit(allocator);
+
+    doc.beginBatch();
+    defer doc.endBatch() catch unreachable;
+
+    for (records) |record| {
+        const target = targets[record.target];
+        switch (record.op) {
+            .insert, .move => {
+                const ref = if (record.before != none)
+                    targets[record.before]
+                else if (record.before_source != none)
+                    inserted.get(record.before_source) orelse return error.NotFoundError
+                else
+                    null;
+
+                if (record.op == .insert) {
+                    try inserted.ensureUnusedCapacity(allocator, 1);
+                    const copy = try doc.importNode(sources[record.source], true);
+                    errdefer copy.release();
+                    _ = try target.insertBefore(copy, ref);
+                    inserted.putAssumeCapacity(record.source, copy);
+                } else {
+                    const parent = target.parent_node orelse return error.NotFoundError;
+                    _ = try parent.insertBefore(target, ref);
+                }
+            },
+            .remove => {
+                const parent = target.parent_node orelse return error.NotFoundError;
+                (try parent.removeChild(target)).release();
+            },
+            .replace => {
+                const parent = target.parent_node orelse return error.NotFoundError;
+                try inserted.ensureUnusedCapacity(allocator, 1);
+                const copy = try doc.importNode(sources[record.source], true);
+                errdefer copy.release();
+                (try parent.replaceChild(copy, target)).release();
+                inserted.putAssumeCapacity(record.source, copy);
+            },
+            .set_attribute => {
+                const elem: *Element = @fieldParentPtr("prototype", target);
+                const name = stringOf(buffer, record.name).?;
+                const value = stringOf(buffer, record.value).?;
+                if (stringOf(buffer, record.namespace)) |namespace| {
+                    try elem.setAttributeNS(namespace, name, value);
+                } else {
+                    try elem.setAttribute(name, value);
+                }
+            },
+            .remove_attribute => {
+                const elem: *Element = @fieldParentPtr("prototype", target);
+                elem.removeAttributeNS(stringOf(buffer, record.namespace), stringOf(buffer, record.name).?);
+            },
+            .set_text => try target.setNodeValue(stringOf(buffer, record.value).?),
+        }
+    }
+}
+
+/// Applies a patch from `diff(old, new)` to `old`, copying inserted
+/// subtrees from `new` into the document of `old` (see `replay`).
+///
+/// ## Returns
+/// The patched root: `old`, or a copy of `new` if the roots differ and
+/// `old` has no parent (the caller then owns the copy).
+///
+/// ## Errors
+/// - `error.InvalidStateError`: The trees do not have the node counts the
+///   patch was computed for
+/// - Any error of `replay`
+pub fn apply(allocator: Allocator, buffer: PatchBuffer, old: *Node, new: *Node) !*Node {
+    const doc: *Document = if (old.node_type == .document)
+        @fieldParentPtr("prototype", old)
+    else
+        old.getOwnerDocument() orelse return error.InvalidStateError;
+
+    // A root replace is the whole patch of incompatible roots
+    const records = recordsOf(buffer);
+    if (records.len == 1 and records[0].op == .replace and records[0].target == 0 and old.parent_node == null) {
+        return doc.importNode(new, true);
+    }
+
+    var old_tree = try Tree.init(allocator, old);
+    defer old_tree.deinit(allocator);
+    var new_tree = try Tree.init(allocator, new);
+    defer new_tree.deinit(allocator);
+
+    const header = headerOf(buffer);
+    if (header.old_node_count != old_tree.nodes.items.len or header.new_node_count != new_tree.nodes.items.len) {
+        return error.InvalidStateError;
+    }
+
+    try replay(allocator, doc, buffer, old_tree.nodes.items, new_tree.nodes.items);
+    return old;
+}
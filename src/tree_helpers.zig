@@ -237,6 +237,7 @@ pub fn isInclusiveDescendant(other: *const Node, node: *const Node) bool {
 ///
 /// This performs a tree-order traversal collecting text from all Text nodes.
 /// Used for Node.textContent getter on Element and DocumentFragment nodes.
+/// The length is summed first, so the result is allocated once.
 ///
 /// ## Memory
 /// Returns owned string - caller must free with allocator.
@@ -247,34 +248,82 @@ pub fn getDescendantTextContent(
     node: *const Node,
     allocator: Allocator,
 ) ![]u8 {
-    var list: std.ArrayList(u8) = .empty;
-    errdefer list.deinit(allocator);
-
-    try collectTextContent(node, &list, allocator);
-
-    return try list.toOwnedSlice(allocator);
+    const result = try allocator.alloc(u8, descendantTextContentLength(node));
+    _ = copyDescendantTextContent(node, result);
+    return result;
 }
 
-/// Recursively collects text content from node and all descendants.
-fn collectTextContent(node: *const Node, list: *std.ArrayList(u8), allocator: Allocator) !void {
+/// Calls `emit` with the data of each Text descendant of `node` in tree
+/// order; the pieces concatenate to its descendant text content. Nothing
+/// is allocated, and `emit` must not mutate the tree.
+pub fn forEachDescendantText(
+    node: *const Node,
+    context: anytype,
+    comptime emit: fn (@TypeOf(context), []const u8) void,
+) void {
     const TextNode = @import("text.zig").Text;
 
     var current = node.first_child;
-    while (current) |child| {
-        // Save next sibling before any operations
-        const next = child.next_sibling;
+    while (current) |descendant| : (current = getNextNodeInTree(descendant, node)) {
+        if (descendant.node_type == .text) {
+            const text: *const TextNode = @fieldParentPtr("prototype", descendant);
+            if (text.data.len > 0) emit(context, text.data);
+        }
+    }
+}
 
-        // If text node, append its data
-        if (child.node_type == .text) {
-            const text: *const TextNode = @fieldParentPtr("prototype", child);
-            try list.appendSlice(allocator, text.data);
+/// Returns the length in bytes of the descendant text content of `node`.
+pub fn descendantTextContentLength(node: *const Node) usize {
+    const Sum = struct {
+        fn add(total: *usize, data: []const u8) void {
+            total.* += data.len;
         }
+    };
+    var total: usize = 0;
+    forEachDescendantText(node, &total, Sum.add);
+    return total;
+}
 
-        // Recurse into all children (not just text nodes)
-        try collectTextContent(child, list, allocator);
+/// Copies as much of the descendant text content of `node` as fits into
+/// `buffer` and returns its full length in bytes (larger than
+/// `buffer.len` if it did not fit).
+pub fn copyDescendantTextContent(node: *const Node, buffer: []u8) usize {
+    const Copy = struct {
+        buffer: []u8,
+        length: usize = 0,
+
+        fn append(sink: *@This(), data: []const u8) void {
+            if (sink.length < sink.buffer.len) {
+                const n = @min(data.len, sink.buffer.len - sink.length);
+                @memcpy(sink.buffer[sink.length..][0..n], data[0..n]);
+            }
+            sink.length += data.len;
+        }
+    };
+    var sink = Copy{ .buffer = buffer };
+    forEachDescendantText(node, &sink, Copy.append);
+    return sink.length;
+}
 
-        current = next;
+/// Returns the descendant text content of `node` if it is stored in one
+/// place: the data of its only non-empty Text descendant, or "" if there
+/// is none. Null if the text spans several Text nodes.
+///
+/// The slice borrows the Text node's storage and is invalidated by the
+/// next mutation.
+pub fn descendantTextContentSlice(node: *const Node) ?[]const u8 {
+    const TextNode = @import("text.zig").Text;
+
+    var found: []const u8 = "";
+    var current = node.first_child;
+    while (current) |descendant| : (current = getNextNodeInTree(descendant, node)) {
+        if (descendant.node_type != .text) continue;
+        const text: *const TextNode = @fieldParentPtr("prototype", descendant);
+        if (text.data.len == 0) continue;
+        if (found.len > 0) return null;
+        found = text.data;
     }
+    return found;
 }
 
 /// Sets connected state for node and all its descendants recursively.
@@ -321,11 +370,39 @@ pub fn setDescendantsConnected(node: *Node, connected: bool) void {
     }
 }
 
+/// Sets `node`'s depth to `depth` and shifts its descendants' depths by
+/// the same amount, after `node` was linked under a new parent or
+/// unlinked from one.
+pub fn setSubtreeDepth(node: *Node, depth: u32) void {
+    const old = node.depth;
+    if (old == depth) return;
+
+    var current: ?*Node = node;
+    while (current) |n| : (current = getNextNodeInTree(n, node)) {
+        n.depth = n.depth - old + depth;
+    }
+}
+
+/// Returns the ancestor of `node` at `depth` (`node` itself at its own
+/// depth), walking `node.depth - depth` parent links.
+pub fn ancestorAtDepth(node: *const Node, depth: u32) *const Node {
+    std.debug.assert(depth <= node.depth);
+    var current = node;
+    var steps = node.depth - depth;
+    while (steps > 0) : (steps -= 1) current = current.parent_node.?;
+    return current;
+}
+
 /// Removes all children from parent node.
 ///
 /// Used by textContent setter and normalize() operations.
 /// Releases all children (decrements ref counts).
 pub fn removeAllChildren(parent: *Node) void {
+    const slot_map = @import("slot_map.zig");
+    const shadow_index = @import("shadow_index.zig");
+    var removed_slots = false;
+    const shadow = shadow_index.containingShadowRoot(parent);
+
     var current = parent.first_child;
     while (current) |child| {
         const next = child.next_sibling;
@@ -335,13 +412,25 @@ pub fn removeAllChildren(parent: *Node) void {
         child.previous_sibling = null;
         child.next_sibling = null;
         child.setHasParent(false);
+        slot_map.hostChildRemoved(parent, child);
+        removed_slots = removed_slots or slot_map.containsSlot(child);
+        if (shadow) |s| shadow_index.subtreeRemoved(s, child);
 
         // Update connected state
         if (child.isConnected()) {
+            // Drop from the id and tag maps before the child can be freed
+            if (parent.owner_document) |owner_doc| {
+                if (owner_doc.node_type == .document and shadow == null) {
+                    @import("node.zig").removeNodeFromDocumentMaps(child, owner_doc);
+                }
+            }
             child.setConnected(false);
             setDescendantsConnected(child, false);
         }
 
+        // The child may outlive the release
+        setSubtreeDepth(child, 0);
+
         // Release parent's ownership
         child.release();
 
@@ -351,6 +440,11 @@ pub fn removeAllChildren(parent: *Node) void {
     // Clear parent's child pointers
     parent.first_child = null;
     parent.last_child = null;
+    parent.generation += 1;
+    parent.noteMutation();
+
+    // Slots left a shadow tree: its host's children find new ones
+    if (removed_slots) slot_map.slotsChanged(parent);
 }
 
 /// Returns true if node has any element children.
@@ -0,0 +1,281 @@
+//! Tree Snapshot - Flat preorder serialization of a subtree
+//!
+//! Serializes a subtree into one contiguous buffer so bindings can hand it
+//! to JavaScript (e.g. as an ArrayBuffer) and walkers, serializers and diffing
+//! passes read plain records instead of crossing into the DOM once per
+//! node and property.
+//!
+//! ## Buffer Layout
+//!
+//! All integers are native-endian u32 unless noted; every section starts at a
+//! 4-byte aligned offset.
+//!
+//! ```text
+//! SnapshotHeader                      (32 bytes)
+//! NodeRecord[node_count]              (24 bytes each, preorder, root first)
+//! NameEntry[name_count]               (8 bytes each, only with include_names)
+//! string bytes[strings_length]        (UTF-8, names and text, not terminated)
+//! ```
+//!
+//! Records are in preorder, so a node's descendants follow it directly and
+//! `parent` / `next_sibling` always index into the record array. Names are
+//! deduplicated per snapshot: every element with the same interned tag name
+//! shares one `name_id`.
+//!
+//! ## Usage
+//!
+//! ```zig
+//! const buffer = try tree_snapshot.snapshotSubtree(allocator, &root.prototype,
+//!     tree_snapshot.include_names | tree_snapshot.include_text);
+//! defer tree_snapshot.freeSnapshot(allocator, buffer);
+//!
+//! const header = tree_snapshot.headerOf(buffer);
+//! for (tree_snapshot.recordsOf(buffer)) |record| {
+//!     // record.node_type, record.parent, record.name_id, ...
+//! }
+//! _ = header;
+//! ```
+
+const std = @import("std");
+const Allocator = std.mem.Allocator;
+const Node = @import("node.zig").Node;
+
+/// Index value meaning "no node" / "no name".
+pub const none: u32 = std.math.maxInt(u32);
+
+/// Magic number at the start of every snapshot ("DOMS").
+pub const magic: u32 = 0x534D4F44;
+
+/// Current layout version.
+pub const version: u16 = 1;
+
+/// Emit a name table and a `name_id` per node (nodeName).
+pub const include_names: u32 = 1 << 0;
+
+/// Copy Text, Comment, CDATASection and ProcessingInstruction data.
+pub const include_text: u32 = 1 << 1;
+
+/// Snapshot header.
+pub const SnapshotHeader = extern struct {
+    magic: u32,
+    version: u16,
+    flags: u16,
+    node_count: u32,
+    name_count: u32,
+    records_offset: u32,
+    names_offset: u32,
+    strings_offset: u32,
+    strings_length: u32,
+};
+
+/// One node, in preorder.
+pub const NodeRecord = extern struct {
+    /// WHATWG nodeType value
+    node_type: u8,
+    reserved: [3]u8 = .{ 0, 0, 0 },
+    /// Record index of the parent (`none` for the root)
+    parent: u32,
+    /// Record index of the next sibling (`none` for the last child and root)
+    next_sibling: u32,
+    /// Index into the name table (`none` without include_names)
+    name_id: u32,
+    /// Character data, as a range of the string bytes (0/0 if none)
+    text_offset: u32,
+    text_length: u32,
+};
+
+/// Name table entry, a range of the string bytes.
+pub const NameEntry = extern struct {
+    offset: u32,
+    length: u32,
+};
+
+/// Alignment of snapshot buffers.
+pub const buffer_alignment = std.mem.Alignment.of(u32);
+
+/// Snapshot buffer type.
+pub const SnapshotBuffer = []align(4) u8;
+
+comptime {
+    std.debug.assert(@sizeOf(SnapshotHeader) == 32);
+    std.debug.assert(@sizeOf(NodeRecord) == 24);
+    std.debug.assert(@sizeOf(NameEntry) == 8);
+}
+
+const NameKey = struct {
+    ptr: usize,
+    len: usize,
+};
+
+const Builder = struct {
+    allocator: Allocator,
+    flags: u32,
+    records: std.ArrayList(NodeRecord) = .{},
+    names: std.ArrayList(NameEntry) = .{},
+    name_ids: std.AutoHashMapUnmanaged(NameKey, u32) = .{},
+    strings: std.ArrayList(u8) = .{},
+
+    fn deinit(self: *Builder) void {
+        self.records.deinit(self.allocator);
+        self.names.deinit(self.allocator);
+        self.name_ids.deinit(self.allocator);
+        self.strings.deinit(self.allocator);
+    }
+
+    fn appendString(self: *Builder, bytes: []const u8) !u32 {
+        const offset: u32 = @intCast(self.strings.items.len);
+        try self.strings.appendSlice(self.allocator, bytes);
+        return offset;
+    }
+
+    fn nameId(self: *Builder, name: []const u8) !u32 {
+        // Keyed by pointer: interned names are shared, so this is one
+        // lookup per node without hashing the bytes
+        const key = NameKey{ .ptr = @intFromPtr(name.ptr), .len = name.len };
+        const entry = try self.name_ids.getOrPut(self.allocator, key);
+        if (!entry.found_existing) {
+            entry.value_ptr.* = @intCast(self.names.items.len);
+            const offset = try self.appendString(name);
+            try self.names.append(self.allocator, .{ .offset = offset, .length = @intCast(name.len) });
+        }
+        return entry.value_ptr.*;
+    }
+
+    fn appendNode(self: *Builder, node: *const Node, parent: u32) !u32 {
+        var record = NodeRecord{
+            .node_type = node.node_type.value(),
+            .parent = parent,
+            .next_sibling = none,
+            .name_id = none,
+            .text_offset = 0,
+            .text_length = 0,
+        };
+
+        if (self.flags & include_names != 0) {
+            record.name_id = try self.nameId(node.nodeName());
+        }
+
+        if (self.flags & include_text != 0) {
+            switch (node.node_type) {
+                .text, .comment, .cdata_section, .processing_instruction => {
+                    if (node.nodeValue()) |data| {
+                        record.text_offset = try self.appendString(data);
+                        record.text_length = @intCast(data.len);
+                    }
+                },
+                else => {},
+            }
+        }
+
+        const index: u32 = @intCast(self.records.items.len);
+        try self.records.append(self.allocator, record);
+        return index;
+    }
+};
+
+/// Serializes the subtree rooted at `root` (inclusive) in preorder.
+///
+/// ## Parameters
+/// - `allocator`: Allocator for the returned buffer and scratch space
+/// - `root`: Subtree root (record 0)
+/// - `flags`: `include_names` and/or `include_text`
+///
+/// ## Returns
+/// Snapshot buffer; free with `freeSnapshot`.
+///
+/// ## Errors
+/// - `error.OutOfMemory`: Allocation failed
+pub fn snapshotSubtree(allocator: Allocator, root: *const Node, flags: u32) !SnapshotBuffer {
+    var builder = Builder{ .allocator = allocator, .flags = flags };
+    defer builder.deinit();
+
+    _ = try builder.appendNode(root, none);
+
+    // Iterative preorder walk: one open entry per ancestor of the next node
+    const Open = struct {
+        node: *const Node,
+        index: u32,
+        last_child: ?*const Node,
+        last_index: u32,
+    };
+    var stack = std.ArrayList(Open){};
+    defer stack.deinit(allocator);
+    try stack.append(allocator, .{ .node = root, .index = 0, .last_child = null, .last_index = none });
+
+    while (stack.items.len > 0) {
+        const top = &stack.items[stack.items.len - 1];
+        const next = if (top.last_child) |last| last.next_sibling else top.node.first_child;
+        const child = next orelse {
+            _ = stack.pop();
+            continue;
+        };
+
+        const index = try builder.appendNode(child, top.index);
+        if (top.last_child != null) {
+            builder.records.items[top.last_index].next_sibling = index;
+        }
+        top.last_child = child;
+        top.last_index = index;
+
+        // `top` is invalid after this append
+        try stack.append(allocator, .{ .node = child, .index = index, .last_child = null, .last_index = none });
+    }
+
+    // Assemble the final buffer
+    const records_offset: usize = @sizeOf(SnapshotHeader);
+    const names_offset = records_offset + builder.records.items.len * @sizeOf(NodeRecord);
+    const strings_offset = names_offset + builder.names.items.len * @sizeOf(NameEntry);
+    const total = std.mem.alignForward(usize, strings_offset + builder.strings.items.len, 4);
+
+    const buffer = try allocator.alignedAlloc(u8, buffer_alignment, total);
+    @memset(buffer[strings_offset + builder.strings.items.len ..], 0);
+
+    const header = SnapshotHeader{
+        .magic = magic,
+        .version = version,
+        .flags = @intCast(flags & (include_names | include_text)),
+        .node_count = @intCast(builder.records.items.len),
+        .name_count = @intCast(builder.names.items.len),
+        .records_offset = @intCast(records_offset),
+        .names_offset = @intCast(names_offset),
+        .strings_offset = @intCast(strings_offset),
+        .strings_length = @intCast(builder.strings.items.len),
+    };
+    @memcpy(buffer[0..@sizeOf(SnapshotHeader)], std.mem.asBytes(&header));
+    @memcpy(buffer[records_offset..names_offset], std.mem.sliceAsBytes(builder.records.items));
+    @memcpy(buffer[names_offset..strings_offset], std.mem.sliceAsBytes(builder.names.items));
+    @memcpy(buffer[strings_offset..][0..builder.strings.items.len], builder.strings.items);
+
+    return buffer;
+}
+
+/// Frees a buffer returned by `snapshotSubtree`.
+pub fn freeSnapshot(allocator: Allocator, buffer: SnapshotBuffer) void {
+    allocator.free(buffer);
+}
+
+/// Returns the header of a snapshot buffer.
+pub fn headerOf(buffer: SnapshotBuffer) *const SnapshotHeader {
+    return @ptrCast(buffer.ptr);
+}
+
+/// Returns the node records of a snapshot buffer.
+pub fn recordsOf(buffer: SnapshotBuffer) []const NodeRecord {
+    const header = headerOf(buffer);
+    const ptr: [*]const NodeRecord = @ptrCast(@alignCast(buffer.ptr + header.records_offset));
+    return ptr[0..header.node_count];
+}
+
+/// Returns the name for a `name_id`.
+pub fn nameOf(buffer: SnapshotBuffer, name_id: u32) []const u8 {
+    const header = headerOf(buffer);
+    const ptr: [*]const NameEntry = @ptrCast(@alignCast(buffer.ptr + header.names_offset));
+    const entry = ptr[name_id];
+    return buffer[header.strings_offset + entry.offset ..][0..entry.length];
+}
+
+/// Returns the character data of a record.
+pub fn textOf(buffer: SnapshotBuffer, record: NodeRecord) []const u8 {
+    const header = headerOf(buffer);
+    return buffer[header.strings_offset + record.text_offset ..][0..record.text_length];
+}
@@ -247,10 +247,11 @@ pub const TreeWalker = struct {
     /// Allocator for walker cleanup
     allocator: Allocator,
 
-    /// Root node of traversal (boundary)
+    /// Root node of traversal (boundary), referenced until deinit
     root: *Node,
 
-    /// Current node position
+    /// Current node position, referenced until it changes (see
+    /// setCurrentNode)
     current_node: *Node,
 
     /// Bitfield of node types to show
@@ -259,7 +260,7 @@ pub const TreeWalker = struct {
     /// Optional custom filter
     node_filter: ?NodeFilter,
 
-    /// Creates a new TreeWalker.
+    /// Creates a new TreeWalker at `root`, referencing it until deinit().
     pub fn init(
         allocator: Allocator,
         root: *Node,
@@ -274,21 +275,37 @@ pub const TreeWalker = struct {
             .what_to_show = what_to_show,
             .node_filter = node_filter,
         };
+
+        // One reference for root, one for the current node
+        root.acquire();
+        root.acquire();
         return walker;
     }
 
-    /// Frees the walker.
+    /// Releases the walker's node references and frees it.
     pub fn deinit(self: *TreeWalker) void {
+        self.current_node.release();
+        self.root.release();
         self.allocator.destroy(self);
     }
 
+    /// Moves the walker to `node` (the currentNode setter); acquires first,
+    /// as the old current node may own the new one.
+    pub fn setCurrentNode(self: *TreeWalker, node: *Node) void {
+        if (node == self.current_node) return;
+        node.acquire();
+        const old = self.current_node;
+        self.current_node = node;
+        old.release();
+    }
+
     /// Moves to parent node and returns it, or null if at root or no matching parent.
     pub fn parentNode(self: *TreeWalker) ?*Node {
         var node = self.current_node;
         while (node != self.root) {
             node = node.parent_node orelse return null;
             if (filterNode(self, node) == .accept) {
-                self.current_node = node;
+                self.setCurrentNode(node);
                 return node;
             }
         }
@@ -335,7 +352,7 @@ pub const TreeWalker = struct {
                     }
                 }
                 if (filterNode(self, node) == .accept) {
-                    self.current_node = node;
+                    self.setCurrentNode(node);
                     return node;
                 }
                 sibling = node.previous_sibling;
@@ -344,7 +361,7 @@ pub const TreeWalker = struct {
             if (node == self.root) return null;
             node = node.parent_node orelse return null;
             if (filterNode(self, node) == .accept) {
-                self.current_node = node;
+                self.setCurrentNode(node);
                 return node;
             }
         }
@@ -364,7 +381,7 @@ pub const TreeWalker = struct {
                     node = ch;
                     result = filterNode(self, node);
                     if (result == .accept) {
-                        self.current_node = node;
+                        self.setCurrentNode(node);
                         return node;
                     }
                     if (result == .reject) {
@@ -388,7 +405,7 @@ pub const TreeWalker = struct {
             node = sibling.?;
             result = filterNode(self, node);
             if (result == .accept) {
-                self.current_node = node;
+                self.setCurrentNode(node);
                 return node;
             }
         }
@@ -416,7 +433,7 @@ pub const TreeWalker = struct {
         while (true) {
             const result = filterNode(self, node);
             if (result == .accept) {
-                self.current_node = node;
+                self.setCurrentNode(node);
                 return node;
             }
 
@@ -450,7 +467,7 @@ pub const TreeWalker = struct {
         while (true) {
             const result = filterNode(self, node);
             if (result == .accept) {
-                self.current_node = node;
+                self.setCurrentNode(node);
                 return node;
             }
 
@@ -651,8 +651,7 @@ test "AbortSignal - addSourceSignal creates source list" {
 
     // Rare data should be allocated
     try std.testing.expect(dependent.rare_data != null);
-    try std.testing.expect(dependent.rare_data.?.source_signals != null);
-    try std.testing.expectEqual(@as(usize, 1), dependent.rare_data.?.source_signals.?.items.len);
+    try std.testing.expectEqual(@as(usize, 1), dependent.sourceSignalCount());
 }
 
 test "AbortSignal - addDependentSignal creates dependent list" {
@@ -672,8 +671,7 @@ test "AbortSignal - addDependentSignal creates dependent list" {
 
     // Rare data should be allocated
     try std.testing.expect(source.rare_data != null);
-    try std.testing.expect(source.rare_data.?.dependent_signals != null);
-    try std.testing.expectEqual(@as(usize, 1), source.rare_data.?.dependent_signals.?.items.len);
+    try std.testing.expectEqual(@as(usize, 1), source.dependentSignalCount());
 }
 
 test "AbortSignal - deinit removes from source signal lists" {
@@ -690,14 +688,14 @@ test "AbortSignal - deinit removes from source signal lists" {
         try source.addDependentSignal(dependent);
 
         // Source should have dependent in list
-        try std.testing.expectEqual(@as(usize, 1), source.rare_data.?.dependent_signals.?.items.len);
+        try std.testing.expectEqual(@as(usize, 1), source.dependentSignalCount());
 
         // Release dependent - should remove from source list
         dependent.release();
     }
 
     // Source list should now be empty
-    try std.testing.expectEqual(@as(usize, 0), source.rare_data.?.dependent_signals.?.items.len);
+    try std.testing.expectEqual(@as(usize, 0), source.dependentSignalCount());
 }
 
 test "AbortSignal - multiple source signals cleanup" {
@@ -719,16 +717,16 @@ test "AbortSignal - multiple source signals cleanup" {
         try source2.addDependentSignal(dependent);
 
         // Both sources should have dependent
-        try std.testing.expectEqual(@as(usize, 1), source1.rare_data.?.dependent_signals.?.items.len);
-        try std.testing.expectEqual(@as(usize, 1), source2.rare_data.?.dependent_signals.?.items.len);
+        try std.testing.expectEqual(@as(usize, 1), source1.dependentSignalCount());
+        try std.testing.expectEqual(@as(usize, 1), source2.dependentSignalCount());
 
         // Release dependent
         dependent.release();
     }
 
     // Both source lists should be empty
-    try std.testing.expectEqual(@as(usize, 0), source1.rare_data.?.dependent_signals.?.items.len);
-    try std.testing.expectEqual(@as(usize, 0), source2.rare_data.?.dependent_signals.?.items.len);
+    try std.testing.expectEqual(@as(usize, 0), source1.dependentSignalCount());
+    try std.testing.expectEqual(@as(usize, 0), source2.dependentSignalCount());
 }
 
 test "AbortSignal - no memory leaks with dependent signals" {
@@ -771,8 +769,7 @@ test "AbortSignal.any - creates dependent signal from two sources" {
 
     // Composite should have 2 source signals
     try std.testing.expect(composite.rare_data != null);
-    try std.testing.expect(composite.rare_data.?.source_signals != null);
-    try std.testing.expectEqual(@as(usize, 2), composite.rare_data.?.source_signals.?.items.len);
+    try std.testing.expectEqual(@as(usize, 2), composite.sourceSignalCount());
 }
 
 test "AbortSignal.any - returns pre-aborted if source already aborted" {
@@ -824,13 +821,11 @@ test "AbortSignal.any - flattens nested dependent signals" {
 
     // composite2 should depend on controller1 and controller2 directly (flattened)
     try std.testing.expect(composite2.rare_data != null);
-    try std.testing.expect(composite2.rare_data.?.source_signals != null);
-    try std.testing.expectEqual(@as(usize, 2), composite2.rare_data.?.source_signals.?.items.len);
+    try std.testing.expectEqual(@as(usize, 2), composite2.sourceSignalCount());
 
     // composite2 should NOT depend on composite1
-    const sources = composite2.rare_data.?.source_signals.?.items;
-    for (sources) |source_ptr| {
-        const source: *AbortSignal = @ptrCast(@alignCast(source_ptr));
+    for (composite2.rare_data.?.source_links.items) |link| {
+        const source: *AbortSignal = @ptrCast(@alignCast(link.source));
         try std.testing.expect(source != composite1);
     }
 }
@@ -846,11 +841,7 @@ test "AbortSignal.any - empty signals array" {
     try std.testing.expect(!composite.isAborted());
 
     // Should have no source signals
-    if (composite.rare_data) |rare| {
-        if (rare.source_signals) |sources| {
-            try std.testing.expectEqual(@as(usize, 0), sources.items.len);
-        }
-    }
+    try std.testing.expectEqual(@as(usize, 0), composite.sourceSignalCount());
 }
 
 test "AbortSignal.any - single source signal" {
@@ -869,8 +860,7 @@ test "AbortSignal.any - single source signal" {
 
     // Should have 1 source signal
     try std.testing.expect(composite.rare_data != null);
-    try std.testing.expect(composite.rare_data.?.source_signals != null);
-    try std.testing.expectEqual(@as(usize, 1), composite.rare_data.?.source_signals.?.items.len);
+    try std.testing.expectEqual(@as(usize, 1), composite.sourceSignalCount());
 }
 
 test "AbortSignal.any - many source signals" {
@@ -897,7 +887,7 @@ test "AbortSignal.any - many source signals" {
     defer composite.release();
 
     // Should have 4 source signals
-    try std.testing.expectEqual(@as(usize, 4), composite.rare_data.?.source_signals.?.items.len);
+    try std.testing.expectEqual(@as(usize, 4), composite.sourceSignalCount());
 }
 
 test "AbortSignal.any - sources registered as dependents" {
@@ -917,12 +907,10 @@ test "AbortSignal.any - sources registered as dependents" {
 
     // Both sources should have composite in their dependent lists
     try std.testing.expect(controller1.signal.rare_data != null);
-    try std.testing.expect(controller1.signal.rare_data.?.dependent_signals != null);
-    try std.testing.expectEqual(@as(usize, 1), controller1.signal.rare_data.?.dependent_signals.?.items.len);
+    try std.testing.expectEqual(@as(usize, 1), controller1.signal.dependentSignalCount());
 
     try std.testing.expect(controller2.signal.rare_data != null);
-    try std.testing.expect(controller2.signal.rare_data.?.dependent_signals != null);
-    try std.testing.expectEqual(@as(usize, 1), controller2.signal.rare_data.?.dependent_signals.?.items.len);
+    try std.testing.expectEqual(@as(usize, 1), controller2.signal.dependentSignalCount());
 }
 
 test "AbortSignal.any - no memory leaks" {
@@ -1368,16 +1356,307 @@ test "AbortSignal.any - prevents duplicate source signals" {
     defer composite.release();
 
     // Verify only one source signal exists (set semantics)
-    if (composite.rare_data) |rare| {
-        if (rare.source_signals) |sources| {
-            try std.testing.expectEqual(@as(usize, 1), sources.items.len);
+    try std.testing.expectEqual(@as(usize, 1), composite.sourceSignalCount());
+
+    // Verify dependent signal only registered once in source
+    try std.testing.expectEqual(@as(usize, 1), controller.signal.dependentSignalCount());
+}
+
+test "AbortSignal.any - links are weak from both sides" {
+    const allocator = std.testing.allocator;
+
+    // Composite released first: the source's dependents empty out
+    const source = try AbortSignal.init(allocator);
+    defer source.release();
+    const composite = try AbortSignal.any(allocator, &[_]*AbortSignal{source});
+    try std.testing.expectEqual(@as(usize, 1), source.dependentSignalCount());
+    composite.release();
+    try std.testing.expectEqual(@as(usize, 0), source.dependentSignalCount());
+
+    // Source released first: the composite stops following it
+    const short_lived = try AbortSignal.init(allocator);
+    const orphan = try AbortSignal.any(allocator, &[_]*AbortSignal{ short_lived, source });
+    defer orphan.release();
+    short_lived.release();
+    try std.testing.expectEqual(@as(usize, 1), orphan.sourceSignalCount());
+
+    try source.signalAbort(null);
+    try std.testing.expect(orphan.isAborted());
+}
+
+test "AbortSignal - abort drops the links of aborted composites" {
+    const allocator = std.testing.allocator;
+
+    const request = try AbortController.init(allocator);
+    defer request.deinit();
+    const shutdown = try AbortController.init(allocator);
+    defer shutdown.deinit();
+
+    const composite = try AbortSignal.any(allocator, &[_]*AbortSignal{ request.signal, shutdown.signal });
+    defer composite.release();
+    try std.testing.expectEqual(@as(usize, 1), shutdown.signal.dependentSignalCount());
+
+    // The composite aborts with the request and leaves the long-lived source
+    try request.abort(null);
+    try std.testing.expect(composite.isAborted());
+    try std.testing.expectEqual(@as(usize, 0), composite.sourceSignalCount());
+    try std.testing.expectEqual(@as(usize, 0), request.signal.dependentSignalCount());
+    try std.testing.expectEqual(@as(usize, 0), shutdown.signal.dependentSignalCount());
+}
+
+test "AbortSignal - abort algorithms keep their order across removals" {
+    const allocator = std.testing.allocator;
+
+    const Log = struct { order: [8]u8 = undefined, len: usize = 0 };
+    const Step = struct {
+        tag: u8,
+        log: *Log,
+        removes: ?*@This() = null,
+
+        fn run(sig: *AbortSignal, ctx: *anyopaque) void {
+            const self: *@This() = @ptrCast(@alignCast(ctx));
+            self.log.order[self.log.len] = self.tag;
+            self.log.len += 1;
+            if (self.removes) |other| sig.removeAlgorithm(run, @ptrCast(other));
         }
+    };
+
+    const signal = try AbortSignal.init(allocator);
+    defer signal.release();
+
+    var log = Log{};
+    var a = Step{ .tag = 'a', .log = &log };
+    var b = Step{ .tag = 'b', .log = &log };
+    var d = Step{ .tag = 'd', .log = &log };
+    var c = Step{ .tag = 'c', .log = &log, .removes = &d };
+    for ([_]*Step{ &a, &b, &c, &d, &a }) |step| {
+        try signal.addAlgorithm(.{ .callback = Step.run, .context = @ptrCast(step) });
     }
+    // The second a is a duplicate
+    try std.testing.expectEqual(@as(usize, 4), signal.rare_data.?.abort_algorithms.count());
 
-    // Verify dependent signal only registered once in source
-    if (controller.signal.rare_data) |rare| {
-        if (rare.dependent_signals) |deps| {
-            try std.testing.expectEqual(@as(usize, 1), deps.items.len);
+    // Removal from the middle; c removes d while the algorithms run
+    signal.removeAlgorithm(Step.run, @ptrCast(&b));
+    try signal.signalAbort(null);
+
+    try std.testing.expectEqualSlices(u8, "ac", log.order[0..log.len]);
+    try std.testing.expectEqual(@as(usize, 0), signal.rare_data.?.abort_algorithms.count());
+}
+
+test "AbortSignal.any - short-lived composites leave a long-lived source empty" {
+    const allocator = std.testing.allocator;
+
+    const shutdown = try AbortController.init(allocator);
+    defer shutdown.deinit();
+
+    const cleanup = struct {
+        fn run(sig: *AbortSignal, ctx: *anyopaque) void {
+            _ = sig;
+            _ = ctx;
+        }
+    }.run;
+
+    // A window of requests in flight, completed out of order; every 16th aborts
+    var in_flight: [64]?struct { request: *AbortController, composite: *AbortSignal } = @splat(null);
+    var prng = std.Random.DefaultPrng.init(73);
+    for (0..10_000) |i| {
+        const slot = prng.random().uintLessThan(usize, in_flight.len);
+        if (in_flight[slot]) |done| {
+            done.composite.removeAlgorithm(cleanup, @ptrCast(done.composite));
+            done.composite.release();
+            done.request.deinit();
+        }
+
+        const request = try AbortController.init(allocator);
+        const composite = try AbortSignal.any(allocator, &[_]*AbortSignal{ request.signal, shutdown.signal });
+        try composite.addAlgorithm(.{ .callback = cleanup, .context = @ptrCast(composite) });
+        if (i % 16 == 0) try request.abort(null);
+        in_flight[slot] = .{ .request = request, .composite = composite };
+
+        try std.testing.expect(shutdown.signal.dependentSignalCount() <= in_flight.len);
+    }
+
+    for (in_flight) |entry| {
+        const done = entry orelse continue;
+        done.composite.release();
+        done.request.deinit();
+    }
+    try std.testing.expectEqual(@as(usize, 0), shutdown.signal.dependentSignalCount());
+}
+
+/// Manually advanced embedder clock with one timer
+const FakeTimer = struct {
+    time: u64 = 0,
+    armed: ?u64 = null,
+    arms: usize = 0,
+
+    fn host(self: *FakeTimer) dom.TimerHost {
+        return .{ .context = self, .now = now, .arm = arm, .disarm = disarm };
+    }
+
+    fn now(context: ?*anyopaque) u64 {
+        const self: *FakeTimer = @ptrCast(@alignCast(context.?));
+        return self.time;
+    }
+
+    fn arm(context: ?*anyopaque, deadline: u64) void {
+        const self: *FakeTimer = @ptrCast(@alignCast(context.?));
+        self.armed = deadline;
+        self.arms += 1;
+    }
+
+    fn disarm(context: ?*anyopaque) void {
+        const self: *FakeTimer = @ptrCast(@alignCast(context.?));
+        self.armed = null;
+    }
+
+    /// Moves the clock forward, running the queue each time the armed
+    /// deadline comes up
+    fn advance(self: *FakeTimer, queue: *dom.TimeoutQueue, milliseconds: u64) !void {
+        const end = self.time + milliseconds;
+        while (self.armed) |deadline| {
+            if (deadline > end) break;
+            self.time = @max(self.time, deadline);
+            try queue.run();
         }
+        self.time = end;
+    }
+};
+
+fn reasonName(signal: *AbortSignal) []const u8 {
+    const reason: *dom.DOMException = @ptrCast(@alignCast(signal.getReason().?));
+    return reason.name;
+}
+
+test "AbortSignal.timeout - aborts with TimeoutError, never early" {
+    const allocator = std.testing.allocator;
+
+    var timer = FakeTimer{ .time = 1_000 };
+    var queue = dom.TimeoutQueue.init(allocator, timer.host());
+    defer queue.deinit();
+
+    const signal = try AbortSignal.timeout(allocator, &queue, 100);
+    defer signal.release();
+    try std.testing.expectEqual(@as(usize, 1), queue.pendingCount());
+
+    try timer.advance(&queue, 99);
+    try std.testing.expect(!signal.isAborted());
+
+    // Rounded up to its bucket: at most 1/8 of the delay late
+    try timer.advance(&queue, 1 + 100 / 8);
+    try std.testing.expect(signal.isAborted());
+    try std.testing.expectEqualStrings("TimeoutError", reasonName(signal));
+    try std.testing.expectEqual(@as(usize, 0), queue.pendingCount());
+    try std.testing.expect(timer.armed == null);
+}
+
+test "AbortSignal.timeout - a zero delay waits for the host timer" {
+    const allocator = std.testing.allocator;
+
+    var timer = FakeTimer{};
+    var queue = dom.TimeoutQueue.init(allocator, timer.host());
+    defer queue.deinit();
+
+    const signal = try AbortSignal.timeout(allocator, &queue, 0);
+    defer signal.release();
+
+    try queue.run();
+    try std.testing.expect(!signal.isAborted());
+    try timer.advance(&queue, 1);
+    try std.testing.expect(signal.isAborted());
+}
+
+test "AbortSignal.timeout - pending timeouts share one host timer" {
+    const allocator = std.testing.allocator;
+
+    var timer = FakeTimer{};
+    var queue = dom.TimeoutQueue.init(allocator, timer.host());
+    defer queue.deinit();
+
+    // The queue keeps each signal alive until it fires
+    const count = 100_000;
+    for (0..count) |i| {
+        const signal = try AbortSignal.timeout(allocator, &queue, 1_000 + i / 4);
+        signal.release();
     }
+    try std.testing.expectEqual(@as(usize, count), queue.pendingCount());
+    try std.testing.expectEqual(@as(usize, 1), timer.arms);
+
+    // 25 s of deadlines coalesce into under a hundred wakeups
+    try timer.advance(&queue, 30_000);
+    try std.testing.expectEqual(@as(usize, 0), queue.pendingCount());
+    try std.testing.expect(timer.arms < 100);
+}
+
+test "AbortSignal.timeout - far deadlines are requeued, not fired early" {
+    const allocator = std.testing.allocator;
+
+    var timer = FakeTimer{};
+    var queue = dom.TimeoutQueue.init(allocator, timer.host());
+    defer queue.deinit();
+
+    const week = 7 * 24 * 3600 * 1000;
+    const signal = try AbortSignal.timeout(allocator, &queue, week);
+    defer signal.release();
+
+    try timer.advance(&queue, week - 1);
+    try std.testing.expect(!signal.isAborted());
+    try timer.advance(&queue, week / 8);
+    try std.testing.expect(signal.isAborted());
+}
+
+test "AbortSignal.timeout - composites keep the reason of a released timeout" {
+    const allocator = std.testing.allocator;
+
+    var timer = FakeTimer{};
+    var queue = dom.TimeoutQueue.init(allocator, timer.host());
+    defer queue.deinit();
+
+    const controller = try AbortController.init(allocator);
+    defer controller.deinit();
+
+    const timeout_signal = try AbortSignal.timeout(allocator, &queue, 50);
+    const composite = try AbortSignal.any(allocator, &[_]*AbortSignal{ controller.signal, timeout_signal });
+    defer composite.release();
+    timeout_signal.release();
+
+    try timer.advance(&queue, 100);
+    try std.testing.expect(composite.isAborted());
+    try std.testing.expectEqualStrings("TimeoutError", reasonName(composite));
+    try std.testing.expectEqual(@as(usize, 0), controller.signal.dependentSignalCount());
+}
+
+test "AbortSignal.timeout - abort callbacks may add timeouts" {
+    const allocator = std.testing.allocator;
+
+    var timer = FakeTimer{};
+    var queue = dom.TimeoutQueue.init(allocator, timer.host());
+    defer queue.deinit();
+
+    const Retry = struct {
+        queue: *dom.TimeoutQueue,
+        next: ?*AbortSignal = null,
+
+        fn onAbort(signal: *AbortSignal, context: *anyopaque) void {
+            _ = signal;
+            const self: *@This() = @ptrCast(@alignCast(context));
+            self.next = AbortSignal.timeout(std.testing.allocator, self.queue, 0) catch null;
+        }
+    };
+    var retry = Retry{ .queue = &queue };
+
+    const first = try AbortSignal.timeout(allocator, &queue, 10);
+    defer first.release();
+    try first.addAlgorithm(.{ .callback = Retry.onAbort, .context = @ptrCast(&retry) });
+
+    try timer.advance(&queue, 10);
+    try std.testing.expect(first.isAborted());
+    const next = retry.next.?;
+    defer next.release();
+
+    // Added during run(): fires on the next wakeup, not the same one
+    try std.testing.expect(!next.isAborted());
+    try std.testing.expect(timer.armed != null);
+    try timer.advance(&queue, 1);
+    try std.testing.expect(next.isAborted());
 }
@@ -0,0 +1,112 @@
+//! ancestor_filter Tests
+//!
+//! Tests for the ancestor Bloom filter used by querySelectorAll.
+
+const std = @import("std");
+const dom = @import("dom");
+
+const testing = std.testing;
+const Document = dom.Document;
+const Parser = dom.Parser;
+const Tokenizer = dom.Tokenizer;
+const AncestorFilter = dom.selector.AncestorFilter;
+const AncestorHashes = dom.selector.AncestorHashes;
+
+fn hashesFor(allocator: std.mem.Allocator, selectors: []const u8) !AncestorHashes {
+    var tokenizer = Tokenizer.init(allocator, selectors);
+    var parser = try Parser.init(allocator, &tokenizer);
+    defer parser.deinit();
+
+    var selector_list = try parser.parse();
+    defer selector_list.deinit();
+
+    return AncestorHashes.fromComplex(&selector_list.selectors[0]);
+}
+
+test "AncestorHashes - only compounds that match ancestors" {
+    const allocator = testing.allocator;
+
+    try testing.expectEqual(@as(u8, 0), (try hashesFor(allocator, "leaf.x")).len);
+    try testing.expectEqual(@as(u8, 2), (try hashesFor(allocator, ".a .b leaf")).len);
+    try testing.expectEqual(@as(u8, 2), (try hashesFor(allocator, "root#main > leaf")).len);
+
+    // The left side of a sibling combinator is not an ancestor
+    try testing.expectEqual(@as(u8, 0), (try hashesFor(allocator, "item + leaf")).len);
+    try testing.expectEqual(@as(u8, 1), (try hashesFor(allocator, "root > item + leaf")).len);
+}
+
+test "AncestorFilter - push and pop track the path" {
+    const allocator = testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const outer = try doc.createElement("root");
+    defer outer.prototype.release();
+    try outer.setAttribute("class", "a  wide");
+    const inner = try doc.createElement("item");
+    _ = try outer.prototype.appendChild(&inner.prototype);
+    try inner.setAttribute("id", "main");
+
+    const requires_both = try hashesFor(allocator, ".wide #main leaf");
+
+    var filter = AncestorFilter{};
+    filter.push(outer);
+    try testing.expect(!filter.mayMatch(&requires_both));
+
+    filter.push(inner);
+    try testing.expect(filter.mayMatch(&requires_both));
+
+    filter.pop(inner);
+    try testing.expect(!filter.mayMatch(&requires_both));
+
+    // pushAncestorsOf is inclusive
+    var from_leaf = AncestorFilter{};
+    from_leaf.pushAncestorsOf(inner);
+    try testing.expect(from_leaf.mayMatch(&requires_both));
+}
+
+test "AncestorFilter - querySelectorAll results are unchanged" {
+    const allocator = testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    // scope.a > (item.b > leaf, item > leaf, item.b > item > leaf)
+    const scope = try doc.createElement("root");
+    try scope.setAttribute("class", "a");
+    _ = try doc.prototype.appendChild(&scope.prototype);
+
+    var expected: [2]*dom.Element = undefined;
+    var i: usize = 0;
+    while (i < 3) : (i += 1) {
+        const item = try doc.createElement("item");
+        if (i != 1) try item.setAttribute("class", "b");
+        _ = try scope.prototype.appendChild(&item.prototype);
+
+        var parent = item;
+        if (i == 2) {
+            parent = try doc.createElement("item");
+            _ = try item.prototype.appendChild(&parent.prototype);
+        }
+        const leaf = try doc.createElement("leaf");
+        _ = try parent.prototype.appendChild(&leaf.prototype);
+        if (i != 1) expected[i / 2] = leaf;
+    }
+
+    // Ancestors above the query root still count
+    const results = try scope.querySelectorAll(allocator, ".a .b leaf");
+    defer allocator.free(results);
+    try testing.expectEqual(@as(usize, 2), results.len);
+    try testing.expectEqual(expected[0], results[0]);
+    try testing.expectEqual(expected[1], results[1]);
+
+    const children = try scope.querySelectorAll(allocator, ".a > .b > leaf");
+    defer allocator.free(children);
+    try testing.expectEqual(@as(usize, 1), children.len);
+    try testing.expectEqual(expected[0], children[0]);
+
+    const none = try scope.querySelectorAll(allocator, ".missing leaf");
+    defer allocator.free(none);
+    try testing.expectEqual(@as(usize, 0), none.len);
+}
@@ -1,6 +1,7 @@
 const std = @import("std");
 const dom = @import("dom");
 const Attr = dom.Attr;
+const Document = dom.Document;
 const NodeType = dom.NodeType;
 
 const testing = std.testing;
@@ -93,3 +94,61 @@ test "Attr: memory leak check" {
 
     // Verify no leaks via testing allocator
 }
+
+test "Attr: value, nodeValue and textContent of an attached Attr change its element" {
+    const allocator = testing.allocator;
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const elem = try doc.createElement("element");
+    defer elem.prototype.release();
+    try elem.setAttribute("title", "first");
+
+    const attr = (try elem.getAttributeNode("title")).?;
+    defer attr.node.release();
+
+    try attr.setValue("second");
+    try expectEqualStrings("second", elem.getAttribute("title").?);
+
+    try attr.node.setNodeValue("third");
+    try expectEqualStrings("third", elem.getAttribute("title").?);
+    try expectEqualStrings("third", attr.value());
+
+    try attr.node.setTextContent("fourth");
+    try expectEqualStrings("fourth", elem.getAttribute("title").?);
+    try expectEqualStrings("fourth", attr.value());
+    try expect(attr.node.first_child == null);
+}
+
+test "Attr: setValue of an attached namespaced Attr changes its element" {
+    const allocator = testing.allocator;
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const elem = try doc.createElement("element");
+    defer elem.prototype.release();
+
+    const xlink_ns = "http://www.w3.org/1999/xlink";
+    try elem.setAttributeNS(xlink_ns, "xlink:href", "#first");
+
+    const attr = (try elem.getAttributeNodeNS(xlink_ns, "href")).?;
+    defer attr.node.release();
+
+    try attr.node.setNodeValue("#second");
+    try expectEqualStrings("#second", elem.getAttributeNS(xlink_ns, "href").?);
+    try expectEqualStrings("#second", attr.value());
+}
+
+test "Attr: textContent of a detached Attr sets its value" {
+    const allocator = testing.allocator;
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const attr = try doc.createAttribute("title");
+    defer attr.node.release();
+
+    try attr.node.setTextContent("label");
+    try expectEqualStrings("label", attr.value());
+    try attr.node.setTextContent(null);
+    try expectEqualStrings("", attr.value());
+}
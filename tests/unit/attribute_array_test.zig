@@ -235,11 +235,58 @@ test "AttributeArray: null vs empty namespace distinction" {
 test "AttributeArray: memory layout size" {
     const size = @sizeOf(AttributeArray);
 
-    // Expected: 304 bytes
+    // Expected: 312 bytes
     //   ArrayListUnmanaged(Attribute): 24 bytes
     //   Allocator: 16 bytes
     //   [4]Attribute: 256 bytes (4 * 64)
+    //   ?*NameIndex: 8 bytes
     //   u8: 1 byte
     //   padding: 7 bytes
-    try expectEqual(@as(usize, 304), size);
+    try expectEqual(@as(usize, 312), size);
+}
+
+test "AttributeArray: name index above the threshold" {
+    const allocator = testing.allocator;
+    var attrs = AttributeArray.init(allocator);
+    defer attrs.deinit();
+
+    const count = dom.attribute_array.index_threshold * 4;
+    var names: [count][8]u8 = undefined;
+    for (&names, 0..) |*name, i| {
+        _ = try std.fmt.bufPrint(name, "data-{d:0>3}", .{i});
+        try attrs.set(name, null, name[5..]);
+        try expectEqual(i + 1 >= dom.attribute_array.index_threshold, attrs.index != null);
+    }
+
+    for (&names) |*name| {
+        try expectEqualStrings(name[5..], attrs.get(name, null).?);
+        // Equal bytes at another address still match
+        const copy = name.*;
+        try expectEqualStrings(name[5..], attrs.getByLocalName(&copy).?.value);
+    }
+    try expect(attrs.get("data-999", null) == null);
+
+    // Same local name in another namespace
+    try attrs.set("data-007", "urn:other", "other");
+    try expectEqualStrings("007", attrs.get("data-007", null).?);
+    try expectEqualStrings("other", attrs.get("data-007", "urn:other").?);
+
+    // Removal keeps order and positions
+    try expect(attrs.remove(&names[0], null));
+    try expect(attrs.remove(&names[1], null));
+    try expect(attrs.get(&names[0], null) == null);
+    try expectEqualStrings("063", attrs.get(&names[63], null).?);
+    try expectEqualStrings("other", attrs.get("data-007", "urn:other").?);
+
+    var iter = attrs.iterator();
+    try expectEqualStrings("data-002", iter.next().?.name.local_name);
+    try expectEqualStrings("data-003", iter.next().?.name.local_name);
+
+    // Dropping below the threshold goes back to scanning
+    for (names[2..]) |*name| {
+        try expect(attrs.remove(name, null));
+    }
+    try expect(attrs.index == null);
+    try expectEqual(@as(usize, 1), attrs.count());
+    try expectEqualStrings("other", attrs.get("data-007", "urn:other").?);
 }
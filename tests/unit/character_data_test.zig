@@ -1,5 +1,6 @@
 const std = @import("std");
 const character_data = @import("dom").character_data;
+const Document = @import("dom").Document;
 
 const substringData = character_data.substringData;
 const appendData = character_data.appendData;
@@ -250,3 +251,134 @@ test "CharacterData.replaceData - UTF-16 with supplementary characters" {
 
     try std.testing.expectEqualStrings("Music ♪ Notes", data);
 }
+
+test "CharacterData.replaceUtf16 - UTF-16 index follows edits" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    // "é" is one code unit in two bytes, "𝄞" two code units in four bytes
+    const text = try doc.createTextNode("aé𝄞b");
+    defer text.prototype.release();
+
+    try std.testing.expectEqual(@as(usize, 5), character_data.utf16Length(text));
+    try std.testing.expectEqualStrings("𝄞", try character_data.sliceUtf16(text, 2, 2));
+
+    // Typing moves the checkpoint along; the length stays cached
+    try character_data.replaceUtf16(text, 4, 0, "x");
+    try character_data.replaceUtf16(text, 5, 0, "ü");
+    try std.testing.expectEqualStrings("aé𝄞xüb", text.data);
+    try std.testing.expectEqual(@as(u32, 7), text.utf16.length);
+
+    // Backwards; an offset inside the pair maps to its start
+    try character_data.replaceUtf16(text, 1, 1, "");
+    try std.testing.expectEqualStrings("a𝄞xüb", text.data);
+    try std.testing.expectEqual(@as(usize, 1), character_data.utf16ToByte(text, 2));
+
+    // Counts are clamped; offsets past the end throw
+    try character_data.replaceUtf16(text, 3, 100, "!");
+    try std.testing.expectEqualStrings("a𝄞!", text.data);
+    try std.testing.expectEqual(@as(usize, 4), character_data.utf16Length(text));
+    try std.testing.expectError(error.IndexSizeError, character_data.replaceUtf16(text, 5, 0, "?"));
+    try std.testing.expectError(error.IndexSizeError, character_data.sliceUtf16(text, 5, 0));
+
+    // Byte-level edits drop the cached length until it is needed again
+    try text.appendData("é");
+    try std.testing.expectEqual(character_data.Utf16Index.unknown, text.utf16.length);
+    try std.testing.expectEqual(@as(usize, 5), character_data.utf16Length(text));
+}
+
+test "CharacterData.utf16Length - frozen documents leave the index alone" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    const indexed = try doc.createTextNode("aé𝄞bü");
+    const plain = try doc.createTextNode("aé");
+    _ = try root.prototype.appendChild(&indexed.prototype);
+    _ = try root.prototype.appendChild(&plain.prototype);
+    try std.testing.expectEqual(@as(usize, 6), character_data.utf16Length(indexed));
+    try plain.appendData("𝄞");
+    try std.testing.expectEqual(character_data.Utf16Index.unknown, plain.utf16.length);
+    const checkpoint = indexed.utf16.checkpoint;
+
+    // Several threads may read a frozen tree: conversions answer as before
+    // but record neither a length nor a checkpoint
+    try doc.freeze();
+    try std.testing.expectEqualStrings("𝄞b", try character_data.sliceUtf16(indexed, 2, 3));
+    try std.testing.expectEqual(@as(usize, 2), character_data.byteToUtf16(indexed, 3));
+    try std.testing.expectEqual(checkpoint, indexed.utf16.checkpoint);
+    try std.testing.expectEqual(@as(usize, 4), character_data.utf16Length(plain));
+    try std.testing.expectEqual(character_data.Utf16Index.unknown, plain.utf16.length);
+}
+
+test "CharacterData.utf16ToByte - chunked offsets in long data" {
+    const allocator = std.testing.allocator;
+    const string_utils = @import("dom").string_utils;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    // 8 bytes and 5 code units per repetition, past in_place_threshold
+    const unit = "é𝄞ab";
+    const source = try allocator.alloc(u8, unit.len * 2000);
+    defer allocator.free(source);
+    for (0..2000) |i| @memcpy(source[i * unit.len ..][0..unit.len], unit);
+
+    const text = try doc.createTextNode(source);
+    defer text.prototype.release();
+
+    try std.testing.expectEqual(@as(usize, 10000), character_data.utf16Length(text));
+    try std.testing.expectEqual(@as(usize, 16000 - 8), character_data.utf16ToByte(text, 10000 - 5));
+    try std.testing.expect(text.prototype.rare_data.?.utf16_chunks != null);
+
+    // Edits drop the tables from their start; conversions agree with a scan
+    try character_data.replaceUtf16(text, 6000, 3, "ü");
+    try character_data.replaceUtf16(text, 17, 0, "𝄞𝄞");
+    try character_data.replaceUtf16(text, 4001, 1, "");
+    const offsets = [_]usize{ 0, 1, 2, 3, 255, 256, 257, 4000, 4001, 5999, 6000, 6001, 7996 };
+    for (offsets) |offset| {
+        const byte = character_data.utf16ToByte(text, offset);
+        try std.testing.expectEqual(string_utils.utf16OffsetToUtf8Byte(text.data, offset), byte);
+        try std.testing.expectEqual(string_utils.utf8ByteToUtf16Offset(text.data, byte), character_data.byteToUtf16(text, byte));
+    }
+    try std.testing.expectEqual(string_utils.utf16Length(text.data), character_data.utf16Length(text));
+
+    // Replacing the data frees them
+    try text.prototype.setNodeValue("ascii");
+    try std.testing.expect(text.prototype.rare_data.?.utf16_chunks == null);
+    try std.testing.expectEqual(@as(usize, 3), character_data.utf16ToByte(text, 3));
+}
+
+test "CharacterData.utf16ToByte - frozen documents build no chunk tables" {
+    const allocator = std.testing.allocator;
+    const string_utils = @import("dom").string_utils;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    // Past in_place_threshold, non-ASCII, length known before freezing
+    const unit = "é𝄞ab";
+    const source = try allocator.alloc(u8, unit.len * 2000);
+    defer allocator.free(source);
+    for (0..2000) |i| @memcpy(source[i * unit.len ..][0..unit.len], unit);
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    const text = try doc.createTextNode(source);
+    _ = try root.prototype.appendChild(&text.prototype);
+    try std.testing.expectEqual(@as(usize, 10000), character_data.utf16Length(text));
+    try std.testing.expect(text.prototype.rare_data == null or text.prototype.rare_data.?.utf16_chunks == null);
+
+    try doc.freeze();
+    for ([_]usize{ 0, 3, 256, 4001, 9996 }) |offset| {
+        const byte = character_data.utf16ToByte(text, offset);
+        try std.testing.expectEqual(string_utils.utf16OffsetToUtf8Byte(text.data, offset), byte);
+        try std.testing.expectEqual(offset, character_data.byteToUtf16(text, byte));
+    }
+    try std.testing.expect(text.prototype.rare_data == null or text.prototype.rare_data.?.utf16_chunks == null);
+}
@@ -0,0 +1,95 @@
+const std = @import("std");
+const testing = std.testing;
+const dom = @import("dom");
+
+const Document = dom.Document;
+const ClosestMemo = dom.ClosestMemo;
+
+test "ClosestMemo - answers match closest() and are shared by nearby targets" {
+    const allocator = testing.allocator;
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    const list = try doc.createElement("list");
+    try list.setAttribute("class", "target");
+    _ = try root.prototype.appendChild(&list.prototype);
+    const row = try doc.createElement("row");
+    _ = try list.prototype.appendChild(&row.prototype);
+    const first = try doc.createElement("leaf");
+    _ = try row.prototype.appendChild(&first.prototype);
+    const second = try doc.createElement("leaf");
+    _ = try row.prototype.appendChild(&second.prototype);
+
+    var memo = ClosestMemo.init(allocator);
+    defer memo.deinit();
+
+    const target = try doc.selector_cache.acquire(".target");
+    defer target.release();
+    const missing = try doc.selector_cache.acquire(".missing");
+    defer missing.release();
+
+    try testing.expectEqual(list, (try memo.closest(first, target)).?);
+    try testing.expectEqual(@as(usize, 3), memo.count());
+
+    // The sibling stops at row, answered by the first walk
+    try testing.expectEqual(list, (try memo.closest(second, target)).?);
+    try testing.expectEqual(@as(usize, 4), memo.count());
+
+    // "No match" is remembered too, per selector
+    try testing.expect((try memo.closest(first, missing)) == null);
+    try testing.expect((try memo.closest(second, missing)) == null);
+    try testing.expectEqual(@as(usize, 4 + 5), memo.count());
+}
+
+test "ClosestMemo - mutations invalidate answers" {
+    const allocator = testing.allocator;
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    try root.setAttribute("class", "target");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    const row = try doc.createElement("row");
+    _ = try root.prototype.appendChild(&row.prototype);
+    const leaf = try doc.createElement("leaf");
+    _ = try row.prototype.appendChild(&leaf.prototype);
+
+    var memo = ClosestMemo.init(allocator);
+    defer memo.deinit();
+    const target = try doc.selector_cache.acquire(".target");
+    defer target.release();
+
+    try testing.expectEqual(root, (try memo.closest(leaf, target)).?);
+
+    try row.setAttribute("class", "target");
+    try testing.expectEqual(row, (try memo.closest(leaf, target)).?);
+
+    // Moved under a new parent: answered from its new position
+    const list = try doc.createElement("list");
+    try list.setAttribute("class", "target");
+    _ = try root.prototype.appendChild(&list.prototype);
+    _ = try list.prototype.appendChild(&leaf.prototype);
+    try testing.expectEqual(list, (try memo.closest(leaf, target)).?);
+}
+
+test "ClosestMemo - disconnected elements are not remembered" {
+    const allocator = testing.allocator;
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const list = try doc.createElement("list");
+    defer list.prototype.release();
+    try list.setAttribute("class", "target");
+    const leaf = try doc.createElement("leaf");
+    _ = try list.prototype.appendChild(&leaf.prototype);
+
+    var memo = ClosestMemo.init(allocator);
+    defer memo.deinit();
+    const target = try doc.selector_cache.acquire(".target");
+    defer target.release();
+
+    try testing.expectEqual(list, (try memo.closest(leaf, target)).?);
+    try testing.expectEqual(@as(usize, 0), memo.count());
+}
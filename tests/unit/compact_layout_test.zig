@@ -0,0 +1,127 @@
+//! compact_layout Tests
+//!
+//! Tests for Document.enableCompactLayout(): queries over the element table
+//! must return what the tree walks they replace return, also after the
+//! document changes.
+
+const std = @import("std");
+const dom = @import("dom");
+
+const testing = std.testing;
+const Document = dom.Document;
+const Element = dom.Element;
+
+const selectors = [_][]const u8{ ".even", "item", "row > item", "[data-x]", "item.even", "row .odd", "*" };
+
+/// Rows of items with ids, classes, text and a deeper leaf now and then.
+fn build(doc: *Document) !*Element {
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+
+    var id_buffer: [16]u8 = undefined;
+    var next_id: usize = 0;
+    for (0..6) |r| {
+        const row = try doc.createElement("row");
+        try row.setAttribute("id", try std.fmt.bufPrint(&id_buffer, "e{d}", .{next_id}));
+        next_id += 1;
+        _ = try root.prototype.appendChild(&row.prototype);
+        for (0..5) |i| {
+            const item = try doc.createElement("item");
+            try item.setAttribute("id", try std.fmt.bufPrint(&id_buffer, "e{d}", .{next_id}));
+            next_id += 1;
+            try item.setAttribute("class", if ((r + i) % 2 == 0) "even" else "odd");
+            if (i == 2) try item.setAttribute("data-x", "1");
+            _ = try row.prototype.appendChild(&item.prototype);
+            _ = try item.prototype.appendChild(&(try doc.createTextNode("line")).prototype);
+            if (i == 4) {
+                const leaf = try doc.createElement("leaf");
+                try leaf.setAttribute("id", try std.fmt.bufPrint(&id_buffer, "e{d}", .{next_id}));
+                next_id += 1;
+                try leaf.setAttribute("class", "even");
+                _ = try item.prototype.appendChild(&leaf.prototype);
+            }
+        }
+        _ = try row.prototype.appendChild(&(try doc.createComment("end")).prototype);
+    }
+    return root;
+}
+
+fn expectSameResults(plain: *Element, compact: *Element) !void {
+    const allocator = testing.allocator;
+    for (selectors) |selector| {
+        const expected = try plain.querySelectorAll(allocator, selector);
+        defer allocator.free(expected);
+        const actual = try compact.querySelectorAll(allocator, selector);
+        defer allocator.free(actual);
+
+        try testing.expectEqual(expected.len, actual.len);
+        for (expected, actual) |e, a| {
+            try testing.expectEqualStrings(e.getAttribute("id").?, a.getAttribute("id").?);
+        }
+
+        const first_expected = try plain.querySelector(allocator, selector);
+        const first_actual = try compact.querySelector(allocator, selector);
+        try testing.expectEqual(first_expected == null, first_actual == null);
+        if (first_expected) |e| {
+            try testing.expectEqualStrings(e.getAttribute("id").?, first_actual.?.getAttribute("id").?);
+        }
+    }
+}
+
+test "compact layout - queries match tree walks" {
+    const allocator = testing.allocator;
+
+    const plain_doc = try Document.init(allocator);
+    defer plain_doc.release();
+    const compact_doc = try Document.init(allocator);
+    defer compact_doc.release();
+    try compact_doc.enableCompactLayout();
+    try compact_doc.enableCompactLayout();
+
+    const plain = try build(plain_doc);
+    const compact = try build(compact_doc);
+    try expectSameResults(plain, compact);
+
+    // From a nested element, whose range ends before the next row
+    try expectSameResults(plain_doc.getElementById("e6").?, compact_doc.getElementById("e6").?);
+    try expectSameResults(plain_doc.getElementById("e1").?, compact_doc.getElementById("e1").?);
+}
+
+test "compact layout - rebuilt after changes, skipped for detached subtrees" {
+    const allocator = testing.allocator;
+
+    const plain_doc = try Document.init(allocator);
+    defer plain_doc.release();
+    const compact_doc = try Document.init(allocator);
+    defer compact_doc.release();
+    try compact_doc.enableCompactLayout();
+
+    const plain = try build(plain_doc);
+    const compact = try build(compact_doc);
+    try expectSameResults(plain, compact);
+
+    // Class changes, removals and insertions all show up
+    for ([_]*Document{ plain_doc, compact_doc }) |doc| {
+        try doc.getElementById("e3").?.setAttribute("class", "odd");
+        const row = doc.getElementById("e0").?;
+        _ = try row.prototype.parent_node.?.removeChild(&row.prototype);
+        row.prototype.release();
+
+        const added = try doc.createElement("item");
+        try added.setAttribute("id", "added");
+        try added.setAttribute("class", "even");
+        _ = try doc.getElementById("e12").?.prototype.appendChild(&added.prototype);
+    }
+    try expectSameResults(plain, compact);
+
+    // A detached subtree is walked, not looked up in the table
+    const detached = try compact_doc.createElement("row");
+    defer detached.prototype.release();
+    const item = try compact_doc.createElement("item");
+    try item.setAttribute("class", "even");
+    _ = try detached.prototype.appendChild(&item.prototype);
+    const found = try detached.querySelectorAll(allocator, ".even");
+    defer allocator.free(found);
+    try testing.expectEqual(@as(usize, 1), found.len);
+    try testing.expectEqual(item, found[0]);
+}
@@ -0,0 +1,163 @@
+const std = @import("std");
+const dom = @import("dom");
+const Document = dom.Document;
+const Element = dom.Element;
+const CustomElementCallbacks = dom.CustomElementCallbacks;
+
+/// Counts callback invocations through the definition's context.
+const Recorder = struct {
+    constructed: usize = 0,
+    connected: usize = 0,
+    attribute_changes: usize = 0,
+    fail_constructor: bool = false,
+    released: bool = false,
+
+    fn of(element: *Element) *Recorder {
+        return @ptrCast(@alignCast(element.getCustomElementDefinition().?.callbacks.context.?));
+    }
+
+    fn construct(element: *Element, allocator: std.mem.Allocator) anyerror!void {
+        _ = allocator;
+        const recorder = of(element);
+        recorder.constructed += 1;
+        if (recorder.fail_constructor) return error.ConstructorFailed;
+    }
+
+    fn connect(element: *Element) anyerror!void {
+        of(element).connected += 1;
+    }
+
+    fn attributeChanged(
+        element: *Element,
+        name: []const u8,
+        old_value: ?[]const u8,
+        new_value: ?[]const u8,
+        namespace_uri: ?[]const u8,
+    ) anyerror!void {
+        _ = name;
+        _ = old_value;
+        _ = new_value;
+        _ = namespace_uri;
+        of(element).attribute_changes += 1;
+    }
+
+    fn release(context: ?*anyopaque) void {
+        const recorder: *Recorder = @ptrCast(@alignCast(context.?));
+        recorder.released = true;
+    }
+
+    fn callbacks(self: *Recorder) CustomElementCallbacks {
+        return .{
+            .context = self,
+            .release_context = release,
+            .constructor_fn = construct,
+            .connected_callback = connect,
+            .attribute_changed_callback = attributeChanged,
+        };
+    }
+};
+
+test "CustomElementRegistry - createElement upgrades a defined name" {
+    const allocator = std.testing.allocator;
+
+    var recorder = Recorder{};
+    {
+        const doc = try Document.init(allocator);
+        defer doc.release();
+
+        const registry = try doc.getCustomElementRegistry();
+        try registry.define("x-item", recorder.callbacks(), .{});
+        try std.testing.expect(registry.isDefined("x-item"));
+        try std.testing.expect(registry.get("x-other") == null);
+
+        const elem = try doc.createElement("x-item");
+        defer elem.prototype.release();
+
+        try std.testing.expect(elem.isCustomElement());
+        try std.testing.expectEqual(@as(usize, 1), recorder.constructed);
+
+        // Not a valid custom element name: never undefined
+        const plain = try doc.createElement("item");
+        defer plain.prototype.release();
+        try std.testing.expect(!plain.isCustomElement());
+        try std.testing.expectEqual(@as(usize, 1), recorder.constructed);
+    }
+    try std.testing.expect(recorder.released);
+}
+
+test "CustomElementRegistry - define upgrades existing elements in one pass" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+
+    const first = try doc.createElement("x-row");
+    try first.setAttribute("label", "one");
+    try first.setAttribute("unobserved", "x");
+    _ = try root.prototype.appendChild(&first.prototype);
+
+    const second = try doc.createElement("x-row");
+    _ = try root.prototype.appendChild(&second.prototype);
+
+    // Detached: upgraded by define() only once inserted
+    const detached = try doc.createElement("x-row");
+
+    try std.testing.expect(!first.isCustomElement());
+
+    var recorder = Recorder{};
+    const registry = try doc.getCustomElementRegistry();
+    try registry.define("x-row", recorder.callbacks(), .{
+        .observed_attributes = &[_][]const u8{"label"},
+    });
+
+    try std.testing.expect(first.isCustomElement());
+    try std.testing.expect(second.isCustomElement());
+    try std.testing.expect(!detached.isCustomElement());
+    try std.testing.expectEqual(@as(usize, 2), recorder.constructed);
+    try std.testing.expectEqual(@as(usize, 2), recorder.connected);
+    try std.testing.expectEqual(@as(usize, 1), recorder.attribute_changes);
+
+    _ = try root.prototype.appendChild(&detached.prototype);
+    try std.testing.expect(detached.isCustomElement());
+    try std.testing.expectEqual(@as(usize, 3), recorder.constructed);
+    try std.testing.expectEqual(@as(usize, 3), recorder.connected);
+}
+
+test "CustomElementRegistry - throwing constructor leaves element failed" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    var recorder = Recorder{ .fail_constructor = true };
+    const registry = try doc.getCustomElementRegistry();
+    try registry.define("x-leaf", recorder.callbacks(), .{});
+
+    const elem = try doc.createElement("x-leaf");
+    defer elem.prototype.release();
+
+    try std.testing.expect(!elem.isCustomElement());
+    try std.testing.expect(elem.getCustomElementDefinition() == null);
+    try std.testing.expectEqual(@as(usize, 1), recorder.constructed);
+
+    // Failed elements are never upgraded again
+    try registry.upgrade(&elem.prototype);
+    try std.testing.expectEqual(@as(usize, 1), recorder.constructed);
+}
+
+test "CustomElementRegistry - define rejects invalid and duplicate names" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const registry = try doc.getCustomElementRegistry();
+    try std.testing.expectError(error.InvalidCustomElementName, registry.define("item", .{}, .{}));
+    try std.testing.expectError(error.ReservedCustomElementName, registry.define("font-face", .{}, .{}));
+
+    try registry.define("x-list", .{}, .{});
+    try std.testing.expectError(error.CustomElementAlreadyDefined, registry.define("x-list", .{}, .{}));
+}
@@ -83,3 +83,54 @@ test "DocumentFragment - clone deep" {
     try std.testing.expectEqual(@as(usize, 1), clone.childNodes().length());
 }
 
+
+fn ignoreRecords(_: []const *dom.MutationRecord, _: *dom.MutationObserver, _: ?*anyopaque) void {}
+
+test "DocumentFragment - large fragment inserts as one batch" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    const first = try doc.createElement("row");
+    _ = try root.prototype.appendChild(&first.prototype);
+    const last = try doc.createElement("row");
+    _ = try root.prototype.appendChild(&last.prototype);
+
+    const observer = try dom.MutationObserver.init(allocator, ignoreRecords, null);
+    defer observer.deinit();
+    try observer.observe(&root.prototype, .{ .child_list = true });
+
+    // More children than the insertion's stack buffer holds
+    const row_count = 1000;
+    const fragment = try doc.createDocumentFragment();
+    defer fragment.prototype.release();
+    for (0..row_count) |_| {
+        const row = try doc.createElement("row");
+        _ = try fragment.prototype.appendChild(&row.prototype);
+    }
+    const fragment_first = fragment.prototype.first_child.?;
+    const fragment_last = fragment.prototype.last_child.?;
+
+    _ = try root.prototype.insertBefore(&fragment.prototype, &last.prototype);
+
+    try std.testing.expect(fragment.prototype.first_child == null);
+    try std.testing.expect(fragment.prototype.last_child == null);
+    try std.testing.expectEqual(fragment_first, first.prototype.next_sibling.?);
+    try std.testing.expectEqual(&first.prototype, fragment_first.previous_sibling.?);
+    try std.testing.expectEqual(fragment_last, last.prototype.previous_sibling.?);
+    try std.testing.expectEqual(&last.prototype, fragment_last.next_sibling.?);
+    try std.testing.expectEqual(@as(usize, row_count + 2), root.prototype.childNodes().length());
+    try std.testing.expect(fragment_last.isConnected());
+    try std.testing.expectEqual(&root.prototype, fragment_last.parent_node.?);
+
+    // One record, whose previousSibling is the node before the inserted ones
+    try std.testing.expectEqual(@as(usize, 1), observer.records.items.len);
+    const record = observer.records.items[0];
+    try std.testing.expectEqual(@as(usize, row_count), record.added_nodes.items.len);
+    try std.testing.expectEqual(fragment_first, record.added_nodes.items[0]);
+    try std.testing.expectEqual(&first.prototype, record.previous_sibling.?);
+    try std.testing.expectEqual(&last.prototype, record.next_sibling.?);
+}
@@ -0,0 +1,139 @@
+//! document_image Tests
+//!
+//! Tests for saving documents as binary images and loading them back:
+//! round trips, borrowed strings and rejection of corrupt images.
+
+const std = @import("std");
+const dom = @import("dom");
+
+const testing = std.testing;
+const document_image = dom.document_image;
+const serializer = dom.serializer;
+const Document = dom.Document;
+
+fn build(doc: *Document) !void {
+    _ = try doc.prototype.appendChild(&(try doc.createDocumentType("root", "", "")).prototype);
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    for (0..4) |i| {
+        const row = try doc.createElement("row");
+        try row.setAttribute("class", if (i % 2 == 0) "even" else "odd");
+        _ = try root.prototype.appendChild(&row.prototype);
+        _ = try row.prototype.appendChild(&(try doc.createTextNode("line")).prototype);
+        if (i == 1) {
+            _ = try row.prototype.appendChild(&(try doc.createComment(" note ")).prototype);
+            _ = try row.prototype.appendChild(&(try doc.createElement("cell")).prototype);
+        }
+    }
+    const leaf = try doc.createElementNS("http://www.w3.org/2000/svg", "svg:leaf");
+    try leaf.setAttribute("id", "leaf");
+    try leaf.setAttributeNS("http://www.w3.org/XML/1998/namespace", "xml:lang", "en");
+    _ = try root.prototype.appendChild(&leaf.prototype);
+    _ = try doc.prototype.appendChild(&(try doc.createProcessingInstruction("target", "data")).prototype);
+}
+
+test "document image - round trip through a file" {
+    const allocator = testing.allocator;
+
+    var tmp = testing.tmpDir(.{});
+    defer tmp.cleanup();
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+    try build(doc);
+    try document_image.saveFile(allocator, doc, tmp.dir, "tree.domi");
+
+    const loaded = try document_image.loadFile(allocator, tmp.dir, "tree.domi");
+    defer loaded.release();
+
+    const expected = try serializer.serializeAlloc(allocator, &doc.documentElement().?.prototype, 0);
+    defer allocator.free(expected);
+    const loaded_root = loaded.documentElement().?;
+    const actual = try serializer.serializeAlloc(allocator, &loaded_root.prototype, 0);
+    defer allocator.free(actual);
+    try testing.expectEqualStrings(expected, actual);
+
+    // Document children, namespaces and indices are rebuilt
+    try testing.expectEqual(doc.prototype.childNodes().length(), loaded.prototype.childNodes().length());
+    try testing.expectEqualStrings("root", loaded.doctype().?.name);
+    try testing.expectEqual(dom.NodeType.processing_instruction, loaded.prototype.last_child.?.node_type);
+    const leaf = loaded.getElementById("leaf").?;
+    try testing.expectEqualStrings("http://www.w3.org/2000/svg", leaf.namespace_uri.?);
+    try testing.expectEqualStrings("svg", leaf.prefix.?);
+    try testing.expectEqualStrings("en", leaf.getAttributeNS("http://www.w3.org/XML/1998/namespace", "lang").?);
+    const odd = try loaded.querySelectorAll("row.odd");
+    defer allocator.free(odd);
+    try testing.expectEqual(@as(usize, 2), odd.len);
+
+    // Names and values point into the mapped image
+    const image = loaded.image.?;
+    const in_image = struct {
+        fn check(bytes: []const u8, str: []const u8) bool {
+            const start = @intFromPtr(bytes.ptr);
+            return @intFromPtr(str.ptr) >= start and @intFromPtr(str.ptr) < start + bytes.len;
+        }
+    }.check;
+    try testing.expect(in_image(image, loaded_root.tag_name));
+    try testing.expect(in_image(image, odd[0].getAttribute("class").?));
+}
+
+test "document image - loaded documents stay mutable" {
+    const allocator = testing.allocator;
+
+    var tmp = testing.tmpDir(.{});
+    defer tmp.cleanup();
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+    try build(doc);
+    try document_image.saveFile(allocator, doc, tmp.dir, "tree.domi");
+
+    const loaded = try document_image.loadFile(allocator, tmp.dir, "tree.domi");
+    defer loaded.release();
+
+    const row = loaded.documentElement().?.firstElementChild().?;
+    try row.setAttribute("class", "selected");
+    const text = row.prototype.first_child.?;
+    try text.setNodeValue("changed");
+    _ = try row.prototype.appendChild(&(try loaded.createElement("cell")).prototype);
+
+    try testing.expectEqualStrings("selected", row.getAttribute("class").?);
+    try testing.expectEqualStrings("changed", text.nodeValue().?);
+}
+
+test "document image - rejects corrupt images" {
+    const allocator = testing.allocator;
+
+    var tmp = testing.tmpDir(.{});
+    defer tmp.cleanup();
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+    try build(doc);
+    const image = try document_image.save(allocator, doc);
+    defer document_image.freeImage(allocator, image);
+
+    // Bad magic
+    {
+        const copy = try allocator.dupe(u8, image);
+        defer allocator.free(copy);
+        copy[0] ^= 0xFF;
+        try tmp.dir.writeFile(.{ .sub_path = "magic.domi", .data = copy });
+        try testing.expectError(error.SyntaxError, document_image.loadFile(allocator, tmp.dir, "magic.domi"));
+    }
+
+    // Truncated
+    try tmp.dir.writeFile(.{ .sub_path = "short.domi", .data = image[0 .. image.len - 4] });
+    try testing.expectError(error.SyntaxError, document_image.loadFile(allocator, tmp.dir, "short.domi"));
+
+    // Second node's parent points forward
+    {
+        const copy = try allocator.dupe(u8, image);
+        defer allocator.free(copy);
+        const header = std.mem.bytesToValue(document_image.ImageHeader, copy[0..@sizeOf(document_image.ImageHeader)]);
+        const parents = @sizeOf(document_image.ImageHeader) + std.mem.alignForward(usize, header.node_count, 4);
+        std.mem.writeInt(u32, copy[parents + 4 ..][0..4], header.node_count - 1, @import("builtin").cpu.arch.endian());
+        try tmp.dir.writeFile(.{ .sub_path = "parent.domi", .data = copy });
+        try testing.expectError(error.SyntaxError, document_image.loadFile(allocator, tmp.dir, "parent.domi"));
+    }
+}
@@ -0,0 +1,130 @@
+//! Document order index Tests
+//!
+//! Tests for Document.enableDocumentOrderIndex(): tree-order answers must
+//! match the tree walks they replace while the document is mutated.
+
+const std = @import("std");
+const dom = @import("dom");
+
+const testing = std.testing;
+const Document = dom.Document;
+const Node = dom.Node;
+
+test "document order index - order and containment" {
+    const allocator = testing.allocator;
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    const first = try doc.createElement("item");
+    _ = try root.prototype.appendChild(&first.prototype);
+    const leaf = try doc.createElement("leaf");
+    _ = try first.prototype.appendChild(&leaf.prototype);
+    const second = try doc.createElement("item");
+    _ = try root.prototype.appendChild(&second.prototype);
+
+    try doc.enableDocumentOrderIndex();
+    try doc.enableDocumentOrderIndex();
+
+    try testing.expectEqual(@as(u16, 0), first.prototype.compareDocumentPosition(&first.prototype));
+    try testing.expectEqual(
+        Node.DOCUMENT_POSITION_FOLLOWING,
+        first.prototype.compareDocumentPosition(&second.prototype),
+    );
+    try testing.expectEqual(
+        Node.DOCUMENT_POSITION_PRECEDING,
+        second.prototype.compareDocumentPosition(&leaf.prototype),
+    );
+    try testing.expectEqual(
+        Node.DOCUMENT_POSITION_CONTAINED_BY | Node.DOCUMENT_POSITION_FOLLOWING,
+        root.prototype.compareDocumentPosition(&leaf.prototype),
+    );
+    try testing.expectEqual(
+        Node.DOCUMENT_POSITION_CONTAINS | Node.DOCUMENT_POSITION_PRECEDING,
+        leaf.prototype.compareDocumentPosition(&first.prototype),
+    );
+
+    try testing.expect(root.prototype.contains(&leaf.prototype));
+    try testing.expect(!second.prototype.contains(&leaf.prototype));
+    try testing.expect(!leaf.prototype.contains(&root.prototype));
+}
+
+test "document order index - removal and moveBefore" {
+    const allocator = testing.allocator;
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    const first = try doc.createElement("item");
+    _ = try root.prototype.appendChild(&first.prototype);
+    const leaf = try doc.createElement("leaf");
+    _ = try first.prototype.appendChild(&leaf.prototype);
+    const second = try doc.createElement("item");
+    _ = try root.prototype.appendChild(&second.prototype);
+    const third = try doc.createElement("item");
+    _ = try root.prototype.appendChild(&third.prototype);
+
+    try doc.enableDocumentOrderIndex();
+    try testing.expectEqual(
+        Node.DOCUMENT_POSITION_FOLLOWING,
+        leaf.prototype.compareDocumentPosition(&third.prototype),
+    );
+
+    // Moving `first` to the end reorders its whole subtree
+    try root.moveBefore(&first.prototype, null);
+    try testing.expectEqual(
+        Node.DOCUMENT_POSITION_PRECEDING,
+        leaf.prototype.compareDocumentPosition(&third.prototype),
+    );
+    try testing.expectEqual(
+        Node.DOCUMENT_POSITION_PRECEDING,
+        first.prototype.compareDocumentPosition(&second.prototype),
+    );
+    try testing.expect(first.prototype.contains(&leaf.prototype));
+
+    // Removed nodes are disconnected, not numbered
+    _ = try root.prototype.removeChild(&first.prototype);
+    defer first.prototype.release();
+    const position = leaf.prototype.compareDocumentPosition(&third.prototype);
+    try testing.expect(position & Node.DOCUMENT_POSITION_DISCONNECTED != 0);
+    try testing.expect(!root.prototype.contains(&leaf.prototype));
+}
+
+test "document order index - inserted nodes" {
+    const allocator = testing.allocator;
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    const last = try doc.createElement("item");
+    _ = try root.prototype.appendChild(&last.prototype);
+
+    try doc.enableDocumentOrderIndex();
+    try testing.expect(root.prototype.contains(&last.prototype));
+
+    // Inserted before `last` after the index was built
+    var items: [100]*dom.Element = undefined;
+    for (&items) |*item| {
+        item.* = try doc.createElement("item");
+        _ = try root.prototype.insertBefore(&item.*.prototype, &last.prototype);
+    }
+
+    // Enough fallen-back queries rebuild the index along the way; every
+    // answer must agree with tree order either way
+    for (items, 0..) |item, i| {
+        try testing.expectEqual(
+            Node.DOCUMENT_POSITION_FOLLOWING,
+            item.prototype.compareDocumentPosition(&last.prototype),
+        );
+        if (i > 0) {
+            try testing.expectEqual(
+                Node.DOCUMENT_POSITION_PRECEDING,
+                item.prototype.compareDocumentPosition(&items[i - 1].prototype),
+            );
+        }
+        try testing.expect(root.prototype.contains(&item.prototype));
+    }
+}
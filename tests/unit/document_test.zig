@@ -72,6 +72,78 @@ test "StringPool - multiple unique strings" {
     try std.testing.expectEqual(@as(usize, 3), pool.count());
 }
 
+test "StringPool - owns only canonical copies" {
+    const allocator = std.testing.allocator;
+
+    var pool = StringPool.init(allocator);
+    defer pool.deinit();
+
+    const interned = try pool.intern("test-element");
+    try std.testing.expect(pool.owns(interned));
+
+    // Equal contents at a different address are not owned
+    var buffer: [12]u8 = undefined;
+    @memcpy(&buffer, "test-element");
+    try std.testing.expect(!pool.owns(&buffer));
+
+    // Strings never interned are not owned
+    try std.testing.expect(!pool.owns("other-element"));
+}
+
+test "StringPool - records each string's encoding" {
+    const allocator = std.testing.allocator;
+
+    var pool = StringPool.init(allocator);
+    defer pool.deinit();
+
+    // The key is the pool's copy: the caller's bytes may change
+    var buffer: [4]u8 = undefined;
+    @memcpy(&buffer, "item");
+    const ascii = try pool.intern(&buffer);
+    @memcpy(&buffer, "xxxx");
+    try std.testing.expectEqual(ascii.ptr, (try pool.intern("item")).ptr);
+
+    const latin1 = try pool.intern("caf\u{00E9}");
+    const other = try pool.intern("\u{1F600}");
+    try std.testing.expectEqual(dom.string_utils.Encoding.ascii, pool.ownedEncoding(ascii).?);
+    try std.testing.expectEqual(dom.string_utils.Encoding.latin1, pool.ownedEncoding(latin1).?);
+    try std.testing.expectEqual(dom.string_utils.Encoding.utf8, pool.ownedEncoding(other).?);
+    try std.testing.expectEqual(@as(?dom.string_utils.Encoding, null), pool.ownedEncoding("item"));
+}
+
+test "SharedNames - documents share common names by pointer" {
+    const allocator = std.testing.allocator;
+
+    const shared = try dom.SharedNames.init(allocator, &.{ "item", "class", "even" });
+    const doc1 = try Document.initWithSharedNames(allocator, shared);
+    defer doc1.release();
+    const doc2 = try Document.initWithSharedNames(allocator, shared);
+    defer doc2.release();
+    shared.release();
+
+    const first = try doc1.createElement("item");
+    _ = try doc1.prototype.appendChild(&first.prototype);
+    try first.setAttribute("class", "even");
+    const second = try doc2.createElement("item");
+    _ = try doc2.prototype.appendChild(&second.prototype);
+
+    // Shared names and the namespaces are not copied into either document
+    try std.testing.expectEqual(first.tag_name.ptr, second.tag_name.ptr);
+    try std.testing.expectEqual(doc1.html_namespace.ptr, doc2.html_namespace.ptr);
+    try std.testing.expectEqual(@as(usize, 0), doc1.string_pool.count());
+    try std.testing.expect(doc1.string_pool.owns(first.getAttribute("class").?));
+
+    // Other names go to the document's own pool
+    const row = try doc2.createElement("row");
+    _ = try second.prototype.appendChild(&row.prototype);
+    try std.testing.expectEqual(@as(usize, 1), doc2.string_pool.count());
+
+    // Moving nodes between the documents copies no shared name
+    _ = try second.prototype.appendChild(&first.prototype);
+    try std.testing.expectEqual(second.tag_name.ptr, first.tag_name.ptr);
+    try std.testing.expectEqual(@as(usize, 1), doc2.string_pool.count());
+}
+
 test "Document - creation and cleanup" {
     const allocator = std.testing.allocator;
 
@@ -224,6 +296,39 @@ test "Document - string interning in createElement" {
     try std.testing.expectEqual(@as(usize, 6), doc.string_pool.count());
 }
 
+test "Document - internName reuses the last name and lookup does not intern" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const before = doc.string_pool.count();
+    try std.testing.expect(doc.string_pool.lookup("data-row") == null);
+    try std.testing.expectEqual(before, doc.string_pool.count());
+
+    const first = try doc.string_pool.internName("data-row");
+    try std.testing.expectEqual(first.ptr, doc.string_pool.last_name.ptr);
+    try std.testing.expectEqual(first.ptr, doc.string_pool.lookup("data-row").?.ptr);
+
+    // Repeats (by value or by the interned copy) return the same copy
+    var copy = "data-row".*;
+    try std.testing.expectEqual(first.ptr, (try doc.string_pool.internName(&copy)).ptr);
+    try std.testing.expectEqual(first.ptr, (try doc.string_pool.internName(first)).ptr);
+
+    // Another name replaces the last one; the first stays interned
+    const second = try doc.string_pool.internName("data-column");
+    try std.testing.expectEqual(second.ptr, doc.string_pool.last_name.ptr);
+    try std.testing.expectEqual(first.ptr, (try doc.string_pool.internName("data-row")).ptr);
+    try std.testing.expectEqual(before + 2, doc.string_pool.count());
+
+    // Attribute names set on elements come from the pool
+    const elem = try doc.createElement("element");
+    defer elem.prototype.release();
+    try elem.setAttribute(&copy, "1");
+    var attrs = elem.attributes.iterator();
+    try std.testing.expectEqual(first.ptr, attrs.next().?.name.local_name.ptr);
+}
+
 test "Document - multiple node types" {
     const allocator = std.testing.allocator;
 
@@ -479,7 +584,7 @@ test "SelectorCache - fast path detection" {
     try std.testing.expect(gen_sel.identifier == null);
 }
 
-test "SelectorCache - FIFO eviction" {
+test "SelectorCache - eviction" {
     const allocator = std.testing.allocator;
 
     var cache = SelectorCache.init(allocator);
@@ -502,6 +607,46 @@ test "SelectorCache - FIFO eviction" {
     try std.testing.expectEqualStrings("#id1", id1_again.selector_string);
 }
 
+test "SelectorCache - LRU eviction keeps recently used entries" {
+    const allocator = std.testing.allocator;
+
+    var cache = SelectorCache.init(allocator);
+    cache.max_size = 3;
+    defer cache.deinit();
+
+    const id1 = try cache.get("#id1");
+    _ = try cache.get("#id2");
+    _ = try cache.get("#id3");
+
+    // Touch #id1 so #id2 becomes the least recently used
+    try std.testing.expect(id1 == try cache.get("#id1"));
+    _ = try cache.get("#id4");
+
+    try std.testing.expectEqual(@as(usize, 3), cache.count());
+    try std.testing.expect(cache.cache.contains("#id1"));
+    try std.testing.expect(!cache.cache.contains("#id2"));
+
+    try std.testing.expectEqual(@as(u64, 1), cache.hits);
+    try std.testing.expectEqual(@as(u64, 4), cache.misses);
+}
+
+test "SelectorCache - acquired selector outlives eviction" {
+    const allocator = std.testing.allocator;
+
+    var cache = SelectorCache.init(allocator);
+    cache.max_size = 1;
+    defer cache.deinit();
+
+    const parsed = try cache.get(".item");
+    parsed.acquire();
+    defer parsed.release();
+
+    // Evicts .item; the extra reference keeps it alive
+    _ = try cache.get(".other");
+    try std.testing.expect(!cache.cache.contains(".item"));
+    try std.testing.expectEqualStrings(".item", parsed.selector_string);
+}
+
 test "SelectorCache - clear" {
     const allocator = std.testing.allocator;
 
@@ -1240,6 +1385,70 @@ test "Document - importNode cloned node not connected" {
     try std.testing.expect(imported.isConnected());
 }
 
+test "Document - adoptNode moves names and values to the new pool" {
+    const allocator = std.testing.allocator;
+
+    const doc1 = try Document.init(allocator);
+    const doc2 = try Document.init(allocator);
+    defer doc2.release();
+
+    const root = try doc1.createElement("root");
+    _ = try doc1.prototype.appendChild(&root.prototype);
+    for (0..3) |_| {
+        const row = try doc1.createElement("row");
+        try row.setAttribute("class", "even");
+        try row.setAttributeNS("http://www.w3.org/XML/1998/namespace", "xml:lang", "en");
+        _ = try root.prototype.appendChild(&row.prototype);
+    }
+    const leaf = try doc1.createElementNS("http://www.w3.org/2000/svg", "svg:leaf");
+    _ = try root.prototype.appendChild(&leaf.prototype);
+
+    _ = try doc2.adoptNode(&root.prototype);
+    _ = try doc2.prototype.appendChild(&root.prototype);
+
+    // Every string now comes from doc2's pool, one copy per distinct string
+    const first = root.firstElementChild().?;
+    const last_row = leaf.previousElementSibling().?;
+    try std.testing.expect(doc2.string_pool.owns(root.tag_name));
+    try std.testing.expect(doc2.string_pool.owns(first.tag_name));
+    try std.testing.expect(doc2.string_pool.owns(first.getAttribute("class").?));
+    try std.testing.expectEqual(first.getAttribute("class").?.ptr, last_row.getAttribute("class").?.ptr);
+    try std.testing.expect(doc2.string_pool.owns(leaf.local_name));
+    try std.testing.expect(doc2.string_pool.owns(leaf.namespace_uri.?));
+
+    // They stay valid once the old document is gone
+    doc1.release();
+    try std.testing.expectEqualStrings("row", first.tag_name);
+    try std.testing.expectEqualStrings("en", first.getAttributeNS("http://www.w3.org/XML/1998/namespace", "lang").?);
+    try std.testing.expectEqualStrings("svg:leaf", leaf.tag_name);
+}
+
+test "Document - importNode into a fork keeps the base pool's strings" {
+    const allocator = std.testing.allocator;
+
+    const base = try Document.init(allocator);
+    defer base.release();
+    const root = try base.createElement("root");
+    _ = try base.prototype.appendChild(&root.prototype);
+
+    const forked = try base.fork();
+    defer forked.release();
+
+    const row = try base.createElement("row");
+    try row.setAttribute("class", "even");
+    _ = try root.prototype.appendChild(&row.prototype);
+
+    // The fork's pool falls back to the base's, so nothing is copied
+    const interned = forked.string_pool.count();
+    const imported = try forked.importNode(&row.prototype, true);
+    _ = try forked.documentElement().?.prototype.appendChild(imported);
+
+    const copy: *Element = @fieldParentPtr("prototype", imported);
+    try std.testing.expectEqual(row.tag_name.ptr, copy.tag_name.ptr);
+    try std.testing.expectEqual(row.getAttribute("class").?.ptr, copy.getAttribute("class").?.ptr);
+    try std.testing.expectEqual(interned, forked.string_pool.count());
+}
+
 // ============================================================================
 // Document Metadata Properties Tests
 // ============================================================================
@@ -1595,3 +1804,582 @@ test "Document convenience methods - EventTarget API delegation" {
     // NEW API: doc.removeEventListener() instead of doc.prototype.prototype.removeEventListener()
     doc.removeEventListener("test", callback, false);
 }
+
+test "Document - getElementById returns the first duplicate in tree order" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+
+    const first = try doc.createElement("item");
+    _ = try root.prototype.appendChild(&first.prototype);
+    const second = try doc.createElement("item");
+    _ = try root.prototype.appendChild(&second.prototype);
+
+    // Ids assigned out of tree order
+    try second.setAttribute("id", "dup");
+    try first.setAttribute("id", "dup");
+    try std.testing.expect(doc.getElementById("dup").? == first);
+
+    // Removing the first promotes the next one without a scan
+    first.removeAttribute("id");
+    try std.testing.expect(doc.getElementById("dup").? == second);
+
+    // Inserting an earlier duplicate takes over
+    const earlier = try doc.createElement("item");
+    try earlier.setAttribute("id", "dup");
+    _ = try root.prototype.insertBefore(&earlier.prototype, &first.prototype);
+    try std.testing.expect(doc.getElementById("dup").? == earlier);
+    try std.testing.expect((try root.querySelector(allocator, "#dup")).? == earlier);
+}
+
+test "Document - id index drops elements removed by textContent" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+
+    const container = try doc.createElement("item");
+    _ = try root.prototype.appendChild(&container.prototype);
+    const leaf = try doc.createElement("leaf");
+    try leaf.setAttribute("id", "gone");
+    _ = try container.prototype.appendChild(&leaf.prototype);
+    try std.testing.expect(doc.getElementById("gone").? == leaf);
+
+    try container.prototype.setTextContent("replaced");
+    try std.testing.expect(doc.getElementById("gone") == null);
+    try std.testing.expectEqual(@as(usize, 0), doc.id_map.count());
+}
+
+test "Document - id index under id churn" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+
+    var items: [64]*Element = undefined;
+    for (&items) |*item| {
+        item.* = try doc.createElement("item");
+        _ = try root.prototype.appendChild(&item.*.prototype);
+    }
+
+    // Reassign ids (with many duplicates), detach and reattach repeatedly
+    var buf: [16]u8 = undefined;
+    var round: usize = 0;
+    while (round < 200) : (round += 1) {
+        for (items, 0..) |item, i| {
+            const id = try std.fmt.bufPrint(&buf, "id-{d}", .{(i + round) % 16});
+            try item.setAttribute("id", id);
+        }
+
+        const moved = items[round % items.len];
+        _ = try root.prototype.removeChild(&moved.prototype);
+        try std.testing.expect(doc.getElementById(moved.getId().?) != moved);
+        _ = try root.prototype.appendChild(&moved.prototype);
+
+        if (round % 7 == 0) items[round % items.len].removeAttribute("id");
+    }
+
+    // Every indexed element is connected and carries its id
+    var connected_with_id: usize = 0;
+    for (items) |item| {
+        if (item.getId()) |id| {
+            connected_with_id += 1;
+            var candidates = doc.id_map.iterator(id);
+            var found = false;
+            while (candidates.next()) |elem| {
+                if (elem == item) found = true;
+            }
+            try std.testing.expect(found);
+        }
+    }
+    try std.testing.expect(connected_with_id > 0);
+    try std.testing.expect(doc.id_map.count() <= 16);
+
+    // Removing everything empties the index
+    try root.prototype.setTextContent(null);
+    try std.testing.expectEqual(@as(usize, 0), doc.id_map.count());
+}
+
+test "Document.initWithArena - nodes are freed with the document" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.initWithArena(allocator, 4096);
+    defer doc.release();
+    try std.testing.expect(doc.arena_mode);
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    for (0..32) |i| {
+        const item = try doc.createElement("item");
+        try item.setAttribute("class", if (i % 2 == 0) "even" else "odd");
+        _ = try root.prototype.appendChild(&item.prototype);
+        _ = try item.prototype.appendChild(&(try doc.createTextNode("line")).prototype);
+    }
+
+    // Releasing a removed node frees nothing; it stays valid until the
+    // document goes away
+    const removed = try root.prototype.removeChild(root.prototype.first_child.?);
+    removed.release();
+    try std.testing.expectEqualStrings("line", removed.first_child.?.nodeValue().?);
+
+    // Rare data of arena nodes is cleaned up by the document
+    const noop = struct {
+        fn cb(_: *Event, _: *anyopaque) void {}
+    }.cb;
+    var context: u8 = 0;
+    const detached = try doc.createElement("detached");
+    try detached.addEventListener("change", noop, @ptrCast(&context), false, false, false, null);
+    detached.prototype.release();
+
+    try std.testing.expectEqual(@as(usize, 31), root.prototype.childNodes().length());
+}
+
+test "Document.initWithArena - nodes only move between documents as copies" {
+    const allocator = std.testing.allocator;
+
+    const arena_doc = try Document.initWithArena(allocator, 0);
+    defer arena_doc.release();
+    const heap_doc = try Document.init(allocator);
+    defer heap_doc.release();
+
+    const leaf = try arena_doc.createElement("leaf");
+    try leaf.setAttribute("id", "a");
+    const root = try heap_doc.createElement("root");
+    _ = try heap_doc.prototype.appendChild(&root.prototype);
+
+    // Arena nodes cannot move into a heap document, nor heap nodes into an
+    // arena document
+    try std.testing.expectError(error.NotSupportedError, root.prototype.appendChild(&leaf.prototype));
+    try std.testing.expectError(error.NotSupportedError, heap_doc.adoptNode(&leaf.prototype));
+    const item = try heap_doc.createElement("item");
+    defer item.prototype.release();
+    try std.testing.expectError(error.NotSupportedError, leaf.prototype.appendChild(&item.prototype));
+    try std.testing.expect(leaf.prototype.owner_document == &arena_doc.prototype);
+
+    // Copies are allocated for the target document
+    const copy = try heap_doc.importNode(&leaf.prototype, true);
+    _ = try root.prototype.appendChild(copy);
+    try std.testing.expect(heap_doc.getElementById("a") != null);
+
+    const back = try arena_doc.importNode(&root.prototype, true);
+    _ = try leaf.prototype.appendChild(back);
+    try std.testing.expectEqual(@as(?*Node, back), leaf.prototype.first_child);
+}
+
+test "Document.allocatedBytes - follows nodes in and out of the document" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+    const other = try Document.init(allocator);
+    defer other.release();
+
+    const empty = doc.allocatedBytes();
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    for (0..16) |_| {
+        _ = try root.prototype.appendChild(&(try doc.createElement("item")).prototype);
+    }
+    const full = doc.allocatedBytes();
+    try std.testing.expect(full >= empty + 17 * @sizeOf(Element));
+
+    // Adopted nodes count for their new document
+    const before = other.allocatedBytes();
+    const adopted = try other.adoptNode(root.prototype.first_child.?);
+    defer adopted.release();
+    try std.testing.expect(doc.allocatedBytes() < full);
+    try std.testing.expect(other.allocatedBytes() > before);
+
+    // Freed nodes stop counting
+    const removed = try doc.prototype.removeChild(&root.prototype);
+    removed.release();
+    try std.testing.expect(doc.allocatedBytes() < full - 15 * @sizeOf(Element));
+}
+
+test "Document.reserve - new strings share one buffer, nodes the arena" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+    try doc.reserve(.{ .nodes = 64, .string_bytes = 64 });
+    try std.testing.expectEqual(@as(usize, 64), doc.string_pool.reservedBytes());
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    try root.setAttribute("class", "reserved");
+    try std.testing.expect(doc.string_pool.reservedBytes() <= 64 - "root".len - "class".len - "reserved".len - 3);
+    try std.testing.expect(doc.string_pool.owns(root.getAttribute("class").?));
+
+    // Past the hint, strings are allocated one by one (and freed with the
+    // pool, like the buffered ones)
+    const long = "a value longer than what is left of the reserved buffer";
+    try root.setAttribute("title", long);
+    try std.testing.expectEqualStrings(long, root.getAttribute("title").?);
+
+    // A smaller hint than what is left reserves nothing more
+    const before = doc.allocatedBytes();
+    try doc.reserve(.{ .string_bytes = 8 });
+    try std.testing.expectEqual(before, doc.allocatedBytes());
+
+    const arena_doc = try Document.initWithArena(allocator, 0);
+    defer arena_doc.release();
+    try arena_doc.reserve(.{ .nodes = 64 });
+    try std.testing.expect(arena_doc.node_arena.queryCapacity() >= 64 * @sizeOf(Element));
+}
+
+test "DOMImplementation.createDocumentWithCapacity - sized from a template" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+    const row = try doc.createElement("row");
+    defer row.prototype.release();
+    try row.setAttribute("class", "entry");
+    _ = try row.prototype.appendChild(&(try doc.createElement("cell")).prototype);
+
+    const template = try dom.Template.compile(allocator, &row.prototype, &.{});
+    defer template.deinit();
+    const capacity = template.capacity(100);
+    try std.testing.expectEqual(@as(usize, 200), capacity.nodes);
+
+    const impl = doc.getImplementation();
+    const copy = try impl.createDocumentWithCapacity(null, "list", null, capacity);
+    defer copy.release();
+    const list = copy.documentElement().?;
+    var no_holes: [0]*Node = .{};
+    for (0..100) |_| {
+        _ = try list.prototype.appendChild(try template.instantiate(copy, &no_holes));
+    }
+    try std.testing.expectEqual(@as(usize, 100), list.prototype.childNodes().length());
+}
+
+test "Document.freeze - rejects mutation and node creation" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    const item = try doc.createElement("item");
+    try item.setAttribute("class", "active");
+    _ = try root.prototype.appendChild(&item.prototype);
+    const line = try doc.createTextNode("line");
+    _ = try item.prototype.appendChild(&line.prototype);
+
+    try doc.freeze();
+    try doc.freeze(); // Calling it again does nothing
+
+    const version = doc.mutation_version;
+    try std.testing.expectError(error.NoModificationAllowedError, doc.createElement("leaf"));
+    try std.testing.expectError(error.NoModificationAllowedError, doc.createTextNode("leaf"));
+    try std.testing.expectError(error.NoModificationAllowedError, root.prototype.removeChild(&item.prototype));
+    try std.testing.expectError(error.NoModificationAllowedError, item.setAttribute("class", "idle"));
+    try std.testing.expectError(error.NoModificationAllowedError, item.toggleAttribute("hidden", null));
+    try std.testing.expectError(error.NoModificationAllowedError, line.appendData(" more"));
+    try std.testing.expectError(error.NoModificationAllowedError, root.prototype.setTextContent("gone"));
+    item.removeAttribute("class");
+
+    // Nothing changed
+    try std.testing.expectEqual(version, doc.mutation_version);
+    try std.testing.expectEqualStrings("active", item.getAttribute("class").?);
+    try std.testing.expectEqualStrings("line", line.data);
+    try std.testing.expectEqual(&item.prototype, root.prototype.first_child.?);
+
+    // Reads still work
+    try std.testing.expectEqual(item, (try doc.querySelector(".active")).?);
+    try std.testing.expect(try item.matches(allocator, "root > item"));
+}
+
+test "Document.freeze - fails inside a mutation batch" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    doc.beginBatch();
+    try std.testing.expectError(error.InvalidStateError, doc.freeze());
+    try doc.endBatch();
+    try doc.freeze();
+}
+
+test "Document.freeze - builds the compact layout" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+    try doc.enableCompactLayout();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    _ = try root.prototype.appendChild(&(try doc.createElement("item")).prototype);
+
+    try doc.freeze();
+    try std.testing.expectEqual(@as(?u64, doc.mutation_version), doc.compact_layout.?.version);
+}
+
+test "Document.querySelectorAllMany - matches querySelectorAll" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    for (0..8) |i| {
+        const row = try doc.createElement("row");
+        try row.setAttribute("class", if (i % 2 == 0) "even" else "odd");
+        _ = try root.prototype.appendChild(&row.prototype);
+        _ = try row.prototype.appendChild(&(try doc.createElement("cell")).prototype);
+    }
+
+    var pool: std.Thread.Pool = undefined;
+    try pool.init(.{ .allocator = allocator, .n_jobs = 4 });
+    defer pool.deinit();
+
+    const selectors = [_][]const u8{ "row", ".even", "row.odd > cell", "root", "list" };
+    var results: [selectors.len][]const *Element = undefined;
+
+    // Only frozen documents are queried in parallel
+    try std.testing.expectError(error.InvalidStateError, doc.querySelectorAllMany(&pool, &selectors, &results));
+
+    try doc.freeze();
+    try doc.querySelectorAllMany(&pool, &selectors, &results);
+    defer for (results) |result| allocator.free(result);
+
+    for (selectors, results) |selector, result| {
+        const expected = try doc.querySelectorAll(selector);
+        defer allocator.free(expected);
+        try std.testing.expectEqualSlices(*Element, expected, result);
+    }
+    try std.testing.expectEqual(@as(usize, 8), results[0].len);
+    try std.testing.expectEqual(@as(usize, 0), results[4].len);
+}
+
+test "Document.querySelectorAllMany - reports an invalid selector" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    try doc.freeze();
+
+    var pool: std.Thread.Pool = undefined;
+    try pool.init(.{ .allocator = allocator, .n_jobs = 2 });
+    defer pool.deinit();
+
+    const selectors = [_][]const u8{ "root", "[", "" };
+    var results: [selectors.len][]const *Element = undefined;
+    if (doc.querySelectorAllMany(&pool, &selectors, &results)) |_| {
+        return error.TestExpectedError;
+    } else |_| {}
+    for (results) |result| {
+        try std.testing.expectEqual(@as(usize, 0), result.len);
+    }
+}
+
+test "Document.freeze - concurrent queries share the selector cache" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    for (0..32) |_| {
+        const item = try doc.createElement("item");
+        try item.setAttribute("class", "active");
+        _ = try root.prototype.appendChild(&item.prototype);
+    }
+
+    // A small cache forces evictions while other threads hold selectors
+    doc.selector_cache.max_size = 2;
+    try doc.freeze();
+
+    const Worker = struct {
+        fn run(document: *Document, failures: *std.atomic.Value(u32)) void {
+            const selectors = [_][]const u8{ "item", ".active", "root > item", "item.active", "root item" };
+            for (0..50) |round| {
+                const selector = selectors[round % selectors.len];
+                const found = document.querySelectorAll(selector) catch {
+                    _ = failures.fetchAdd(1, .monotonic);
+                    continue;
+                };
+                defer document.prototype.allocator.free(found);
+                if (found.len != 32) _ = failures.fetchAdd(1, .monotonic);
+
+                const matched = found[0].matches(document.prototype.allocator, selector) catch false;
+                if (!matched) _ = failures.fetchAdd(1, .monotonic);
+            }
+        }
+    };
+
+    var failures = std.atomic.Value(u32).init(0);
+    var threads: [4]std.Thread = undefined;
+    for (&threads) |*thread| {
+        thread.* = try std.Thread.spawn(.{}, Worker.run, .{ doc, &failures });
+    }
+    for (threads) |thread| thread.join();
+
+    try std.testing.expectEqual(@as(u32, 0), failures.load(.monotonic));
+}
+
+test "Document.share - requires a frozen document and marks every node" {
+    const allocator = std.testing.allocator;
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    const item = try doc.createElement("item");
+    _ = try root.prototype.appendChild(&item.prototype);
+    const line = try doc.createTextNode("line");
+    _ = try item.prototype.appendChild(&line.prototype);
+    const shadow = try root.attachShadow(.{ .mode = .closed });
+    const leaf = try doc.createElement("leaf");
+    _ = try shadow.prototype.appendChild(&leaf.prototype);
+    item.prototype.wrapper_slot = 7;
+
+    try std.testing.expectError(error.InvalidStateError, doc.share());
+    try std.testing.expect(!root.prototype.isShared());
+
+    try doc.freeze();
+    try doc.share();
+    try doc.share();
+    for ([_]*Node{ &doc.prototype, &root.prototype, &item.prototype, &line.prototype, &shadow.prototype, &leaf.prototype }) |node| {
+        try std.testing.expect(node.isShared());
+        try std.testing.expectEqual(Node.shared_wrapper_slot, node.wrapper_slot);
+    }
+}
+
+test "Document.share - nodes count references atomically" {
+    const allocator = std.testing.allocator;
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    try doc.freeze();
+    try doc.share();
+
+    const Worker = struct {
+        fn run(node: *Node, document: *Document) void {
+            for (0..10_000) |_| {
+                node.acquire();
+                document.acquire();
+                node.release();
+                document.release();
+            }
+        }
+    };
+
+    var threads: [4]std.Thread = undefined;
+    for (&threads) |*thread| {
+        thread.* = try std.Thread.spawn(.{}, Worker.run, .{ &root.prototype, doc });
+    }
+    for (threads) |thread| thread.join();
+
+    try std.testing.expectEqual(@as(u32, 1), root.prototype.getRefCount());
+    try std.testing.expectEqual(@as(usize, 1), doc.external_ref_count.load(.monotonic));
+}
+
+test "Document.fork - copies the tree and shares interned strings" {
+    const allocator = std.testing.allocator;
+    const base = try Document.init(allocator);
+    defer base.release();
+
+    const doctype = try base.createDocumentType("root", "", "");
+    _ = try base.prototype.appendChild(&doctype.prototype);
+    const root = try base.createElement("root");
+    _ = try base.prototype.appendChild(&root.prototype);
+    for (0..3) |i| {
+        const row = try base.createElement("row");
+        try row.setAttribute("class", if (i % 2 == 0) "even" else "odd");
+        _ = try root.prototype.appendChild(&row.prototype);
+        _ = try row.prototype.appendChild(&(try base.createTextNode("line")).prototype);
+        _ = try row.prototype.appendChild(&(try base.createComment("note")).prototype);
+    }
+    const leaf = try base.createElementNS("http://www.w3.org/2000/svg", "svg:leaf");
+    try leaf.setAttribute("id", "leaf");
+    try leaf.setAttributeNS("http://www.w3.org/XML/1998/namespace", "xml:lang", "en");
+    _ = try root.prototype.appendChild(&leaf.prototype);
+
+    const forked = try base.fork();
+    defer forked.release();
+
+    const serializer = dom.serializer;
+    const expected = try serializer.serializeAlloc(allocator, &root.prototype, 0);
+    defer allocator.free(expected);
+    const copy_root = forked.documentElement().?;
+    try std.testing.expect(copy_root != root);
+    const actual = try serializer.serializeAlloc(allocator, &copy_root.prototype, 0);
+    defer allocator.free(actual);
+    try std.testing.expectEqualStrings(expected, actual);
+
+    // Strings come from the base pool; the fork only interns new ones
+    try std.testing.expectEqual(root.tag_name.ptr, copy_root.tag_name.ptr);
+    const fresh = try Document.init(allocator);
+    defer fresh.release();
+    try std.testing.expectEqual(fresh.string_pool.count(), forked.string_pool.count());
+    try std.testing.expect(forked.string_pool.owns(copy_root.tag_name));
+
+    // Indices and the doctype follow the copy
+    const copy_leaf = forked.getElementById("leaf").?;
+    try std.testing.expectEqualStrings("http://www.w3.org/2000/svg", copy_leaf.namespace_uri.?);
+    try std.testing.expectEqualStrings("en", copy_leaf.getAttributeNS("http://www.w3.org/XML/1998/namespace", "lang").?);
+    try std.testing.expect(forked.doctype() != null);
+    const rows = try forked.querySelectorAll("row.odd");
+    defer allocator.free(rows);
+    try std.testing.expectEqual(@as(usize, 1), rows.len);
+}
+
+test "Document.fork - changes stay in their document" {
+    const allocator = std.testing.allocator;
+    const base = try Document.init(allocator);
+
+    const root = try base.createElement("root");
+    _ = try base.prototype.appendChild(&root.prototype);
+    const row = try base.createElement("row");
+    try row.setAttribute("class", "even");
+    _ = try root.prototype.appendChild(&row.prototype);
+
+    const forked = try base.fork();
+    defer forked.release();
+    const copy_row = forked.documentElement().?.firstElementChild().?;
+    try copy_row.setAttribute("class", "selected");
+    _ = try copy_row.prototype.appendChild(&(try forked.createElement("cell")).prototype);
+
+    try std.testing.expectEqualStrings("even", row.getAttribute("class").?);
+    try std.testing.expect(row.firstElementChild() == null);
+
+    // The fork keeps the base's strings alive after the base is released
+    base.release();
+    try std.testing.expectEqualStrings("row", copy_row.tag_name);
+    try std.testing.expectEqualStrings("selected", copy_row.getAttribute("class").?);
+}
+
+test "Document.fork - forks a frozen document" {
+    const allocator = std.testing.allocator;
+    const base = try Document.init(allocator);
+    defer base.release();
+    const root = try base.createElement("root");
+    _ = try base.prototype.appendChild(&root.prototype);
+    try base.freeze();
+
+    const forked = try base.fork();
+    defer forked.release();
+    try std.testing.expect(!forked.frozen);
+    _ = try forked.documentElement().?.prototype.appendChild(&(try forked.createElement("row")).prototype);
+}
@@ -108,3 +108,38 @@ test "ElementIterator - reset" {
     try testing.expect(iter.next().? == p);
     try testing.expect(iter.next() == null);
 }
+
+test "ElementIterator - seekAfter resumes at the current position" {
+    const allocator = testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+
+    const list = try doc.createElement("list");
+    _ = try root.prototype.appendChild(&list.prototype);
+
+    const item = try doc.createElement("item");
+    _ = try list.prototype.appendChild(&item.prototype);
+
+    const row = try doc.createElement("row");
+    _ = try root.prototype.appendChild(&row.prototype);
+
+    var iter = ElementIterator.init(&root.prototype);
+    try testing.expect(iter.next().? == list);
+
+    // item moved after row: resuming after list continues with row
+    _ = try root.prototype.appendChild(&item.prototype);
+    iter.seekAfter(&list.prototype);
+    try testing.expect(iter.next().? == row);
+    try testing.expect(iter.next().? == item);
+    try testing.expect(iter.next() == null);
+
+    // The root restarts; a node outside the root ends iteration
+    iter.seekAfter(&root.prototype);
+    try testing.expect(iter.next().? == list);
+    iter.seekAfter(&doc.prototype);
+    try testing.expect(iter.next() == null);
+}
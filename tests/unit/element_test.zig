@@ -337,6 +337,51 @@ test "Element - getAttributeNames" {
     }
 }
 
+test "Element - setAttributes sets each attribute in order" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    const elem = try doc.createElement("element");
+    _ = try root.prototype.appendChild(&elem.prototype);
+    try elem.setAttribute("title", "old");
+
+    const observer = try dom.MutationObserver.init(allocator, struct {
+        fn callback(_: []const *dom.MutationRecord, _: *dom.MutationObserver, _: ?*anyopaque) void {}
+    }.callback, null);
+    defer observer.deinit();
+    try observer.observe(&elem.prototype, .{ .attributes = true, .attribute_old_value = true });
+
+    try elem.setAttributes(&.{
+        .{ .name = "id", .value = "main" },
+        .{ .name = "class", .value = "wide row" },
+        .{ .name = "title", .value = "new" },
+        .{ .name = "data-a", .value = "1" },
+        .{ .name = "data-b", .value = "2" },
+        .{ .name = "data-c", .value = "3" },
+    });
+
+    try std.testing.expectEqual(@as(usize, 6), elem.attributes.count());
+    try std.testing.expectEqualStrings("new", elem.getAttribute("title").?);
+    try std.testing.expectEqualStrings("3", elem.getAttribute("data-c").?);
+    try std.testing.expectEqual(elem, doc.getElementById("main").?);
+    try std.testing.expect(elem.class_bloom.mayContain("row"));
+
+    // One record per attribute, in order
+    const records = observer.takeRecords();
+    defer {
+        for (records) |record| record.deinit();
+        allocator.free(records);
+    }
+    try std.testing.expectEqual(@as(usize, 6), records.len);
+    try std.testing.expectEqualStrings("id", records[0].attribute_name.?);
+    try std.testing.expectEqualStrings("title", records[2].attribute_name.?);
+    try std.testing.expectEqualStrings("old", records[2].old_value.?);
+}
+
 test "Element - localName property" {
     const allocator = std.testing.allocator;
 
@@ -552,6 +597,29 @@ test "Element - querySelector uses cache with simple ID" {
     try std.testing.expectEqual(@as(usize, 1), doc.selector_cache.count());
 }
 
+test "Element - matches and closest share the selector cache" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    try root.setAttribute("class", "target");
+    _ = try doc.prototype.appendChild(&root.prototype);
+
+    const leaf = try doc.createElement("leaf");
+    _ = try root.prototype.appendChild(&leaf.prototype);
+
+    try std.testing.expect(try root.matches(allocator, ".target"));
+    try std.testing.expectEqual(@as(usize, 1), doc.selector_cache.count());
+
+    // closest() reuses the parse made by matches()
+    const misses = doc.selector_cache.misses;
+    try std.testing.expect((try leaf.closest(allocator, ".target")).? == root);
+    try std.testing.expectEqual(misses, doc.selector_cache.misses);
+    try std.testing.expectEqual(@as(usize, 1), doc.selector_cache.count());
+}
+
 test "Element - querySelector uses cache with simple class" {
     const allocator = std.testing.allocator;
 
@@ -764,7 +832,7 @@ test "Element - removeAttribute cleans id_map" {
     try std.testing.expect(doc.getElementById("temp") == null);
 }
 
-test "Element - queryByTagName uses tag_map" {
+test "Element - queryByTagName uses tag index" {
     const allocator = std.testing.allocator;
 
     const doc = try Document.init(allocator);
@@ -782,13 +850,13 @@ test "Element - queryByTagName uses tag_map" {
     const div2 = try doc.createElement("div");
     _ = try root.prototype.appendChild(&div2.prototype);
 
-    // queryByTagName should use O(k) tag_map lookup
+    // queryByTagName should use O(k) tag index lookup
     const found = root.queryByTagName("button");
     try std.testing.expect(found != null);
     try std.testing.expect(found.? == button);
 }
 
-test "Element - queryAllByTagName uses tag_map" {
+test "Element - queryAllByTagName uses tag index" {
     const allocator = std.testing.allocator;
 
     const doc = try Document.init(allocator);
@@ -806,13 +874,13 @@ test "Element - queryAllByTagName uses tag_map" {
     const button = try doc.createElement("button");
     _ = try root.prototype.appendChild(&button.prototype);
 
-    // queryAllByTagName should use tag_map
+    // queryAllByTagName should use the tag index
     const divs = try root.queryAllByTagName(allocator, "div");
     defer allocator.free(divs);
     try std.testing.expectEqual(@as(usize, 2), divs.len);
 }
 
-test "Element - querySelector tag uses tag_map" {
+test "Element - querySelector tag uses tag index" {
     const allocator = std.testing.allocator;
 
     const doc = try Document.init(allocator);
@@ -824,7 +892,7 @@ test "Element - querySelector tag uses tag_map" {
     const button = try doc.createElement("button");
     _ = try root.prototype.appendChild(&button.prototype);
 
-    // querySelector("tag") should use O(k) tag_map lookup
+    // querySelector("tag") should use O(k) tag index lookup
     const found = try root.querySelector(allocator, "button");
     try std.testing.expect(found != null);
     try std.testing.expect(found.? == button);
@@ -0,0 +1,147 @@
+//! event_pool Tests
+//!
+//! Tests for EventPool record reuse and reference counting.
+
+const std = @import("std");
+const dom = @import("dom");
+
+const testing = std.testing;
+const EventPool = dom.EventPool;
+const PooledEvent = dom.PooledEvent;
+const Document = dom.Document;
+const Event = dom.Event;
+
+test "EventPool - capacity 0 allocates and frees every record" {
+    var pool = EventPool.init(testing.allocator, 0);
+    defer pool.deinit();
+
+    const record = try pool.acquire("ping", .{});
+    try testing.expectEqualStrings("ping", record.event().event_type);
+    try testing.expectEqual(@as(usize, 1), pool.stats().live);
+
+    pool.release(record);
+    const stats = pool.stats();
+    try testing.expectEqual(@as(u64, 0), stats.hits);
+    try testing.expectEqual(@as(u64, 1), stats.misses);
+    try testing.expectEqual(@as(usize, 0), stats.pooled);
+    try testing.expectEqual(@as(usize, 0), stats.live);
+}
+
+test "EventPool - released records are reused and reset" {
+    var pool = EventPool.init(testing.allocator, 4);
+    defer pool.deinit();
+
+    var detail: u32 = 7;
+    const first = try pool.acquire("first", .{
+        .event_options = .{ .bubbles = true, .cancelable = true },
+        .detail = &detail,
+    });
+    first.event().preventDefault();
+    pool.release(first);
+    try testing.expectEqual(@as(usize, 1), pool.stats().pooled);
+
+    const second = try pool.acquire("second", .{});
+    defer pool.release(second);
+    try testing.expectEqual(first, second);
+    try testing.expectEqualStrings("second", second.event().event_type);
+    try testing.expect(!second.event().bubbles);
+    try testing.expect(!second.event().defaultPrevented());
+    try testing.expect(second.customEvent().detail == null);
+
+    const stats = pool.stats();
+    try testing.expectEqual(@as(u64, 1), stats.hits);
+    try testing.expectEqual(@as(u64, 1), stats.misses);
+    try testing.expectEqual(@as(usize, 0), stats.pooled);
+}
+
+test "EventPool - record is recycled after the last reference" {
+    var pool = EventPool.init(testing.allocator, 1);
+    defer pool.deinit();
+
+    const record = try pool.acquire("ping", .{});
+    pool.retain(record);
+    pool.release(record);
+    try testing.expectEqual(@as(usize, 1), pool.stats().live);
+    try testing.expectEqual(@as(usize, 0), pool.stats().pooled);
+
+    pool.release(record);
+    try testing.expectEqual(@as(usize, 0), pool.stats().live);
+    try testing.expectEqual(@as(usize, 1), pool.stats().pooled);
+}
+
+test "EventPool - long types use a buffer kept across reuse" {
+    var pool = EventPool.init(testing.allocator, 1);
+    defer pool.deinit();
+
+    const long_type = "a-very-long-synthetic-event-type-name-for-testing";
+    const record = try pool.acquire(long_type, .{});
+    try testing.expectEqualStrings(long_type, record.event().event_type);
+    pool.release(record);
+
+    const reused = try pool.acquire("short", .{});
+    try testing.expectEqualStrings("short", reused.event().event_type);
+    const renamed = try reused.storeType(pool.allocator, long_type[2..]);
+    try testing.expectEqualStrings(long_type[2..], renamed);
+    pool.release(reused);
+}
+
+test "EventPool - storeType accepts the current type" {
+    var pool = EventPool.init(testing.allocator, 0);
+    defer pool.deinit();
+
+    const record = try pool.acquire("ping", .{});
+    defer pool.release(record);
+    const stored = try record.storeType(pool.allocator, record.event().event_type);
+    try testing.expectEqualStrings("ping", stored);
+}
+
+test "EventPool - lowering the capacity frees pooled records" {
+    var pool = EventPool.init(testing.allocator, 4);
+    defer pool.deinit();
+
+    const a = try pool.acquire("a", .{});
+    const b = try pool.acquire("b", .{});
+    pool.release(a);
+    pool.release(b);
+    try testing.expectEqual(@as(usize, 2), pool.stats().pooled);
+
+    pool.setCapacity(1);
+    try testing.expectEqual(@as(usize, 1), pool.stats().pooled);
+    try testing.expectEqual(@as(usize, 1), pool.stats().capacity);
+}
+
+test "EventPool - steady-state dispatch reuses one record" {
+    const allocator = testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    const leaf = try doc.createElement("leaf");
+    _ = try root.prototype.appendChild(&leaf.prototype);
+
+    var pool = EventPool.init(allocator, 2);
+    defer pool.deinit();
+
+    var i: usize = 0;
+    while (i < 100) : (i += 1) {
+        const record = try pool.acquire("pointermove", .{ .event_options = .{ .bubbles = true } });
+        _ = try leaf.prototype.dispatchEvent(record.event());
+        pool.release(record);
+    }
+
+    const stats = pool.stats();
+    try testing.expectEqual(@as(u64, 1), stats.misses);
+    try testing.expectEqual(@as(u64, 99), stats.hits);
+}
+
+test "PooledEvent - fromEvent returns the record" {
+    var pool = EventPool.init(testing.allocator, 0);
+    defer pool.deinit();
+
+    const record = try pool.acquire("ping", .{});
+    defer pool.release(record);
+    const evt: *Event = record.event();
+    try testing.expectEqual(record, PooledEvent.fromEvent(evt));
+}
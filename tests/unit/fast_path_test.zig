@@ -8,6 +8,8 @@ const dom = @import("dom");
 const FastPathType = dom.FastPathType;
 const detectFastPath = dom.detectFastPath;
 const extractIdentifier = dom.extractIdentifier;
+const parseFastPath = dom.parseFastPath;
+const Document = dom.Document;
 
 test "detectFastPath - simple ID" {
     try testing.expectEqual(FastPathType.simple_id, detectFastPath("#main"));
@@ -33,11 +35,45 @@ test "detectFastPath - ID filtered" {
     try testing.expectEqual(FastPathType.id_filtered, detectFastPath("#wrapper div"));
 }
 
+test "detectFastPath - attribute equals" {
+    const fast = parseFastPath("[data-id=\"x\"]");
+    try testing.expectEqual(FastPathType.attribute_equals, fast.kind);
+    try testing.expect(fast.tag == null);
+    try testing.expectEqualStrings("data-id", fast.name);
+    try testing.expectEqualStrings("x", fast.value);
+
+    const tagged = parseFastPath("item[data-id='x']");
+    try testing.expectEqual(FastPathType.attribute_equals, tagged.kind);
+    try testing.expectEqualStrings("item", tagged.tag.?);
+
+    try testing.expectEqual(FastPathType.attribute_equals, detectFastPath("[role=list]"));
+    try testing.expectEqual(FastPathType.attribute_equals, detectFastPath("[data-id=\"#1\"]"));
+}
+
+test "detectFastPath - tag and class" {
+    const fast = parseFastPath("item.active");
+    try testing.expectEqual(FastPathType.tag_class, fast.kind);
+    try testing.expectEqualStrings("item", fast.tag.?);
+    try testing.expectEqualStrings("active", fast.name);
+}
+
+test "detectFastPath - child combinator" {
+    const fast = parseFastPath("list > item");
+    try testing.expectEqual(FastPathType.child_tag, fast.kind);
+    try testing.expectEqualStrings("list", fast.parent_tag);
+    try testing.expectEqualStrings("item", fast.tag.?);
+
+    try testing.expectEqual(FastPathType.child_tag, detectFastPath("list>item"));
+}
+
 test "detectFastPath - generic" {
-    try testing.expectEqual(FastPathType.generic, detectFastPath("div > p"));
-    try testing.expectEqual(FastPathType.generic, detectFastPath("div.active"));
     try testing.expectEqual(FastPathType.generic, detectFastPath("div:hover"));
     try testing.expectEqual(FastPathType.generic, detectFastPath("[href]"));
+    try testing.expectEqual(FastPathType.generic, detectFastPath("item.a.b"));
+    try testing.expectEqual(FastPathType.generic, detectFastPath("root > list > item"));
+    try testing.expectEqual(FastPathType.generic, detectFastPath("[lang|=en]"));
+    try testing.expectEqual(FastPathType.generic, detectFastPath("[type=\"a\" i]"));
+    try testing.expectEqual(FastPathType.generic, detectFastPath("item[a=\"1\"][b=\"2\"]"));
 }
 
 test "extractIdentifier - ID" {
@@ -54,3 +90,66 @@ test "extractIdentifier - tag" {
     try testing.expectEqualStrings("div", extractIdentifier("div"));
     try testing.expectEqualStrings("div", extractIdentifier("  div  "));
 }
+
+test "fast paths - query results match the full matcher" {
+    const allocator = testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    // root > (list > item.active[data-id=1], item[data-id=2], list > leaf)
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+
+    const list = try doc.createElement("list");
+    _ = try root.prototype.appendChild(&list.prototype);
+    const first = try doc.createElement("item");
+    try first.setAttribute("class", "active");
+    try first.setAttribute("data-id", "1");
+    _ = try list.prototype.appendChild(&first.prototype);
+
+    const loose = try doc.createElement("item");
+    try loose.setAttribute("data-id", "2");
+    _ = try root.prototype.appendChild(&loose.prototype);
+
+    const other = try doc.createElement("list");
+    _ = try root.prototype.appendChild(&other.prototype);
+    const leaf = try doc.createElement("leaf");
+    _ = try other.prototype.appendChild(&leaf.prototype);
+
+    const children = try root.querySelectorAll(allocator, "list > item");
+    defer allocator.free(children);
+    try testing.expectEqual(@as(usize, 1), children.len);
+    try testing.expectEqual(first, children[0]);
+
+    try testing.expectEqual(loose, (try root.querySelector(allocator, "[data-id=\"2\"]")).?);
+    try testing.expectEqual(first, (try root.querySelector(allocator, "item[data-id=\"1\"]")).?);
+    try testing.expectEqual(first, (try root.querySelector(allocator, "item.active")).?);
+    try testing.expect((try root.querySelector(allocator, "leaf.active")) == null);
+
+    // Names that were never interned cannot match
+    try testing.expect((try root.querySelector(allocator, "missing > item")) == null);
+    try testing.expect((try root.querySelector(allocator, "[data-id=\"3\"]")) == null);
+}
+
+test "fast paths - per-kind statistics" {
+    const allocator = testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+
+    _ = try root.querySelector(allocator, "list > item");
+    _ = try root.querySelector(allocator, "list > item");
+    const all = try root.querySelectorAll(allocator, "item.active");
+    allocator.free(all);
+    _ = try root.querySelector(allocator, "item:first-child");
+
+    const stats = &doc.selector_cache.fast_path_stats;
+    try testing.expectEqual(@as(u64, 2), stats.get(.child_tag));
+    try testing.expectEqual(@as(u64, 1), stats.get(.tag_class));
+    try testing.expectEqual(@as(u64, 1), stats.get(.generic));
+    try testing.expectEqual(@as(u64, 0), stats.get(.attribute_equals));
+}
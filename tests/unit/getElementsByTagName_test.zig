@@ -1,4 +1,4 @@
-//! Phase 2 Verification Tests: getElementsByTagName with mutation-time map updates
+//! Phase 2 Verification Tests: getElementsByTagName with mutation-time index updates
 
 const std = @import("std");
 const dom = @import("dom");
@@ -13,7 +13,7 @@ test "getElementsByTagName - elements added to map on appendChild" {
     const root = try doc.createElement("root");
     _ = try doc.prototype.appendChild(&root.prototype);
 
-    // Initially, tag_map should have no "div" entries
+    // Initially, tag index should have no "div" entries
     const initial = doc.getElementsByTagName("div");
     try std.testing.expectEqual(@as(usize, 0), initial.length());
 
@@ -27,7 +27,7 @@ test "getElementsByTagName - elements added to map on appendChild" {
     // Append to root element
     _ = try root.prototype.appendChild(&div1.prototype);
 
-    // NOW it should be in the tag_map
+    // NOW it should be in the tag index
     const after_append = doc.getElementsByTagName("div");
     try std.testing.expectEqual(@as(usize, 1), after_append.length());
 }
@@ -93,11 +93,11 @@ test "getElementsByTagName - nested elements" {
     const div2 = try doc.createElement("div");
     _ = try div1.prototype.appendChild(&div2.prototype);
 
-    // All nested divs should be in tag_map
+    // All nested divs should be in tag index
     const divs = doc.getElementsByTagName("div");
     try std.testing.expectEqual(@as(usize, 2), divs.length());
 
-    // Remove root - should remove all descendants from tag_map
+    // Remove root - should remove all descendants from tag index
     _ = try doc.prototype.removeChild(&root.prototype);
     root.prototype.release();
 
@@ -138,3 +138,118 @@ test "getElementsByTagName - live collection behavior" {
     // Collection should reflect the removal
     try std.testing.expectEqual(@as(usize, 1), divs.length());
 }
+
+test "getElementsByTagName - tree order after out-of-order inserts" {
+    const allocator = std.testing.allocator;
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+
+    const items = doc.getElementsByTagName("item");
+
+    const last = try doc.createElement("item");
+    _ = try root.prototype.appendChild(&last.prototype);
+    const first = try doc.createElement("item");
+    _ = try root.prototype.insertBefore(&first.prototype, &last.prototype);
+
+    // Nested under a row placed between them
+    const row = try doc.createElement("row");
+    _ = try root.prototype.insertBefore(&row.prototype, &last.prototype);
+    const middle = try doc.createElement("item");
+    _ = try row.prototype.appendChild(&middle.prototype);
+
+    try std.testing.expectEqual(@as(usize, 3), items.length());
+    try std.testing.expectEqual(first, items.item(0).?);
+    try std.testing.expectEqual(middle, items.item(1).?);
+    try std.testing.expectEqual(last, items.item(2).?);
+}
+
+test "getElementsByTagName - bucket built lazily for existing elements" {
+    const allocator = std.testing.allocator;
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+
+    const leaf1 = try doc.createElement("leaf");
+    _ = try root.prototype.appendChild(&leaf1.prototype);
+    const leaf2 = try doc.createElement("leaf");
+    _ = try root.prototype.appendChild(&leaf2.prototype);
+
+    // Nothing is indexed until a tag is queried
+    try std.testing.expect(doc.tag_index.get("leaf") == null);
+
+    const leaves = doc.getElementsByTagName("leaf");
+    try std.testing.expect(doc.tag_index.get("leaf") != null);
+    try std.testing.expectEqual(@as(usize, 2), leaves.length());
+    try std.testing.expectEqual(leaf1, leaves.item(0).?);
+    try std.testing.expectEqual(leaf2, leaves.item(1).?);
+
+    // Untouched tags still have no bucket
+    try std.testing.expect(doc.tag_index.get("root") == null);
+}
+
+test "getElementsByTagName - scoped queries use the index in tree order" {
+    const allocator = std.testing.allocator;
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+
+    const list1 = try doc.createElement("list");
+    _ = try root.prototype.appendChild(&list1.prototype);
+    const list2 = try doc.createElement("list");
+    _ = try root.prototype.appendChild(&list2.prototype);
+
+    const outside = try doc.createElement("item");
+    _ = try list1.prototype.appendChild(&outside.prototype);
+    const inside2 = try doc.createElement("item");
+    _ = try list2.prototype.appendChild(&inside2.prototype);
+    const inside1 = try doc.createElement("item");
+    _ = try list2.prototype.insertBefore(&inside1.prototype, &inside2.prototype);
+
+    // Build the bucket, then query one list's subtree
+    _ = doc.getElementsByTagName("item");
+
+    try std.testing.expectEqual(inside1, list2.queryByTagName("item").?);
+
+    const matches = try list2.queryAllByTagName(allocator, "item");
+    defer allocator.free(matches);
+    try std.testing.expectEqual(@as(usize, 2), matches.len);
+    try std.testing.expectEqual(inside1, matches[0]);
+    try std.testing.expectEqual(inside2, matches[1]);
+
+    // A leaf has no matching descendants
+    try std.testing.expect(inside1.queryByTagName("item") == null);
+
+    // Removal keeps the rest in order
+    _ = try list2.prototype.removeChild(&inside1.prototype);
+    inside1.prototype.release();
+
+    const items = doc.getElementsByTagName("item");
+    try std.testing.expectEqual(@as(usize, 2), items.length());
+    try std.testing.expectEqual(outside, items.item(0).?);
+    try std.testing.expectEqual(inside2, items.item(1).?);
+}
+
+test "getElementsByTagName - disconnected subtree queries traverse" {
+    const allocator = std.testing.allocator;
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    _ = doc.getElementsByTagName("item");
+
+    const list = try doc.createElement("list");
+    defer list.prototype.release();
+    const detached = try doc.createElement("item");
+    _ = try list.prototype.appendChild(&detached.prototype);
+
+    try std.testing.expectEqual(detached, list.queryByTagName("item").?);
+    try std.testing.expectEqual(@as(usize, 0), doc.getElementsByTagName("item").length());
+}
@@ -157,7 +157,7 @@ test "HTMLCollection - document_tagged: backed by ArrayList" {
     const elem2 = try doc.createElement("widget");
     _ = try root.prototype.appendChild(&elem2.prototype);
 
-    // Get collection backed by Document's tag_map
+    // Get collection backed by Document's tag index
     const collection = doc.getElementsByTagName("widget");
     try testing.expectEqual(@as(usize, 2), collection.length());
     try testing.expectEqualStrings("widget", collection.item(0).?.tag_name);
@@ -292,3 +292,151 @@ test "HTMLCollection - namedItem: not found" {
     const collection = HTMLCollection.initChildren(&parent.prototype);
     try testing.expectEqual(@as(?*Element, null), collection.namedItem("nonexistent"));
 }
+
+test "HTMLCollection - getElementsByClassName with the class index" {
+    const allocator = testing.allocator;
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+
+    const first = try doc.createElement("item");
+    try first.setAttribute("class", "row");
+    _ = try root.prototype.appendChild(&first.prototype);
+
+    // Existing classes are picked up when the index is built
+    try doc.enableClassIndex();
+    try doc.enableClassIndex();
+    const rows = doc.getElementsByClassName("row");
+    try testing.expectEqual(@as(usize, 1), rows.length());
+
+    // Inserted before `first`, so it must come first in tree order
+    const second = try doc.createElement("item");
+    try second.setAttribute("class", "row wide");
+    _ = try root.prototype.insertBefore(&second.prototype, &first.prototype);
+    try testing.expectEqual(@as(usize, 2), rows.length());
+    try testing.expectEqual(second, rows.item(0).?);
+    try testing.expectEqual(first, rows.item(1).?);
+    try testing.expect(rows.item(2) == null);
+
+    // className / classList changes
+    try first.setClassName("wide");
+    try testing.expectEqual(@as(usize, 1), rows.length());
+    try testing.expectEqual(@as(usize, 2), doc.getElementsByClassName("wide").length());
+
+    second.removeAttribute("class");
+    try testing.expectEqual(@as(usize, 0), rows.length());
+
+    // Disconnected elements are not indexed
+    const loose = try doc.createElement("item");
+    defer loose.prototype.release();
+    try loose.setAttribute("class", "row");
+    try testing.expectEqual(@as(usize, 0), rows.length());
+
+    // Removal drops descendants too
+    try first.setAttribute("class", "row");
+    try testing.expectEqual(@as(usize, 1), rows.length());
+    try root.prototype.setTextContent(null);
+    try testing.expectEqual(@as(usize, 0), rows.length());
+    try testing.expectEqual(@as(usize, 0), doc.getElementsByClassName("wide").length());
+}
+
+test "HTMLCollection - class index inside a document batch" {
+    const allocator = testing.allocator;
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+
+    try doc.enableClassIndex();
+    const rows = doc.getElementsByClassName("row");
+    try testing.expectEqual(@as(usize, 0), rows.length());
+
+    doc.beginBatch();
+    for (0..4) |i| {
+        const child = try doc.createElement("item");
+        try child.setAttribute("class", if (i % 2 == 0) "row" else "line");
+        _ = try root.prototype.appendChild(&child.prototype);
+    }
+
+    // The index is dropped inside the batch, but reads still see the tree
+    try testing.expect(doc.class_index.?.stale);
+    try testing.expectEqual(@as(usize, 2), rows.length());
+
+    const first: *Element = @fieldParentPtr("prototype", root.prototype.first_child.?);
+    try first.setClassName("line");
+    try doc.endBatch();
+
+    // Rebuilt once when the batch ends
+    try testing.expect(!doc.class_index.?.stale);
+    try testing.expectEqual(@as(usize, 1), rows.length());
+    try testing.expectEqual(@as(usize, 3), doc.getElementsByClassName("line").length());
+}
+
+test "HTMLCollection - copyItems matches item() order" {
+    const allocator = testing.allocator;
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+
+    for (0..5) |i| {
+        const child = try doc.createElement("item");
+        if (i % 2 == 0) try child.setAttribute("class", "row");
+        _ = try root.prototype.appendChild(&child.prototype);
+    }
+
+    const rows = doc.getElementsByClassName("row");
+    var buffer: [8]*Element = undefined;
+    const count = rows.copyItems(&buffer);
+    try testing.expectEqual(@as(usize, 3), count);
+    for (0..count) |i| {
+        try testing.expectEqual(rows.item(i).?, buffer[i]);
+    }
+
+    // A short buffer still reports the full length
+    const children = root.children();
+    var small: [2]*Element = undefined;
+    try testing.expectEqual(@as(usize, 5), children.copyItems(&small));
+    try testing.expectEqual(children.item(1).?, small[1]);
+    try testing.expectEqual(@as(usize, 5), children.copyItems(&.{}));
+}
+
+test "HTMLCollection - document mutation version" {
+    const allocator = testing.allocator;
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    var version = doc.mutation_version;
+    _ = try doc.prototype.appendChild(&root.prototype);
+    try testing.expect(doc.mutation_version != version);
+
+    // Attribute changes count, reads do not
+    version = doc.mutation_version;
+    try root.setAttribute("class", "row");
+    try testing.expect(doc.mutation_version != version);
+    version = doc.mutation_version;
+    _ = root.getAttribute("class");
+    _ = root.children().length();
+    try testing.expectEqual(version, doc.mutation_version);
+
+    root.removeAttribute("class");
+    try testing.expect(doc.mutation_version != version);
+
+    // Changes to disconnected nodes of the document count too
+    const loose = try doc.createElement("item");
+    defer loose.prototype.release();
+    version = doc.mutation_version;
+    const leaf = try doc.createElement("leaf");
+    _ = try loose.prototype.appendChild(&leaf.prototype);
+    try testing.expect(doc.mutation_version != version);
+
+    version = doc.mutation_version;
+    const removed = try loose.prototype.removeChild(&leaf.prototype);
+    removed.release();
+    try testing.expect(doc.mutation_version != version);
+}
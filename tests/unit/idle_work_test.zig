@@ -0,0 +1,113 @@
+//! idle_work Tests
+//!
+//! Tests for Document.runIdleWork(): budgeted slices bring every enabled
+//! index up to date, mutations between slices restart the index being
+//! built, and documents without lazy indices have no idle work.
+
+const std = @import("std");
+const dom = @import("dom");
+
+const testing = std.testing;
+const Document = dom.Document;
+const Element = dom.Element;
+
+/// A document with a root of `rows` rows of one text node each; every
+/// third row has class "hit". Every lazy index is enabled.
+fn buildDocument(rows: usize) !*Document {
+    const doc = try Document.init(testing.allocator);
+    errdefer doc.release();
+    try doc.enableClassIndex();
+    try doc.enableCompactLayout();
+    try doc.enableDocumentOrderIndex();
+    try doc.enableStructuralHashes();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    for (0..rows) |i| {
+        const row = try doc.createElement("row");
+        if (i % 3 == 0) try row.setAttribute("class", "hit");
+        _ = try row.prototype.appendChild(&(try doc.createTextNode("cell")).prototype);
+        _ = try root.prototype.appendChild(&row.prototype);
+    }
+    return doc;
+}
+
+/// Runs idle work with an exhausted budget until none is left; returns the
+/// number of runs.
+fn runToCompletion(doc: *Document) !usize {
+    var runs: usize = 1;
+    while (try doc.runIdleWork(0)) runs += 1;
+    return runs;
+}
+
+fn expectIndicesCurrent(doc: *Document) !void {
+    try testing.expect(!doc.hasIdleWork());
+    try testing.expect(!doc.class_index.?.stale);
+    try testing.expectEqual(@as(?u64, doc.mutation_version), doc.compact_layout.?.version);
+    try testing.expect(!doc.order_index.?.unnumbered);
+
+    const expected = try dom.structural_hash.StructuralHashes.compute(testing.allocator, &doc.prototype);
+    try testing.expectEqual(expected, doc.structural_hashes.?.hashes.get(&doc.prototype).?);
+}
+
+test "idle work - slices build every enabled index" {
+    const doc = try buildDocument(1000);
+    defer doc.release();
+    doc.class_index.?.invalidate();
+    try testing.expect(doc.hasIdleWork());
+
+    // ~3000 nodes per index at check_interval nodes per run
+    try testing.expect(try runToCompletion(doc) > 4);
+    try expectIndicesCurrent(doc);
+
+    // Built without the queries' one-pass rebuilds
+    const class_count = doc.class_index.?.count("hit");
+    try testing.expectEqual(@as(usize, 334), class_count);
+    const root = doc.prototype.first_child.?;
+    const first = root.first_child.?;
+    try testing.expect(doc.order_index.?.entries.contains(first));
+
+    // Nothing left until the document changes
+    try testing.expect(!try doc.runIdleWork(std.time.ns_per_s));
+}
+
+test "idle work - mutations between slices restart the index being built" {
+    const doc = try buildDocument(1000);
+    defer doc.release();
+    _ = try runToCompletion(doc);
+
+    const root = doc.prototype.first_child.?;
+    const row = try doc.createElement("row");
+    _ = try root.insertBefore(&row.prototype, root.first_child);
+    try testing.expect(doc.hasIdleWork());
+
+    // Mutate halfway through the compact layout rebuild
+    try testing.expect(try doc.runIdleWork(0));
+    try testing.expect(doc.compact_layout.?.version == null);
+    try row.setAttribute("class", "hit");
+    _ = try runToCompletion(doc);
+    try expectIndicesCurrent(doc);
+    try testing.expectEqual(@as(usize, 335), doc.class_index.?.count("hit"));
+
+    // A text change bumps no mutation version but drops the dirty hashes
+    const text = root.last_child.?.first_child.?;
+    const text_node: *dom.Text = @fieldParentPtr("prototype", text);
+    try text_node.appendData(" changed");
+    try testing.expect(doc.hasIdleWork());
+    _ = try runToCompletion(doc);
+    try expectIndicesCurrent(doc);
+}
+
+test "idle work - none without lazy indices or once frozen" {
+    const doc = try Document.init(testing.allocator);
+    defer doc.release();
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    try testing.expect(!doc.hasIdleWork());
+    try testing.expect(!try doc.runIdleWork(0));
+
+    try doc.enableCompactLayout();
+    try testing.expect(doc.hasIdleWork());
+    try doc.freeze();
+    try testing.expect(!doc.hasIdleWork());
+}
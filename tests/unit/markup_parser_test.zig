@@ -0,0 +1,154 @@
+//! markup_parser Tests
+//!
+//! Tests for parsing markup into fragments and the Element methods built
+//! on it.
+
+const std = @import("std");
+const dom = @import("dom");
+
+const testing = std.testing;
+const markup_parser = dom.markup_parser;
+const serializer = dom.serializer;
+const Document = dom.Document;
+const Element = dom.Element;
+const Text = dom.Text;
+const MutationObserver = dom.MutationObserver;
+const MutationRecord = dom.MutationRecord;
+
+fn ignoreRecords(_: []const *MutationRecord, _: *MutationObserver, _: ?*anyopaque) void {}
+
+test "markup_parser - round-trips serializer output" {
+    const allocator = testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const input = "<list class=\"rows\" title=\"a &quot;b&quot; &amp; &lt;c&gt;\">" ++
+        "<item>1 &lt; 2 &amp;&amp; 3&nbsp;!</item><leaf></leaf><!-- note --></list>tail";
+
+    const fragment = try markup_parser.parseFragment(doc, input);
+    defer fragment.prototype.release();
+
+    const list: *Element = @fieldParentPtr("prototype", fragment.prototype.first_child.?);
+    try testing.expectEqualStrings("a \"b\" & <c>", list.getAttribute("title").?);
+    try testing.expectEqualStrings("rows", list.getAttribute("class").?);
+
+    const item: *Element = @fieldParentPtr("prototype", list.prototype.first_child.?);
+    const text: *Text = @fieldParentPtr("prototype", item.prototype.first_child.?);
+    try testing.expectEqualStrings("1 < 2 && 3\u{00A0}!", text.data);
+    try testing.expect(list.prototype.last_child.?.node_type == .comment);
+    try testing.expect(fragment.prototype.last_child.?.node_type == .text);
+
+    const output = try serializer.serializeAlloc(allocator, &fragment.prototype, serializer.children_only);
+    defer allocator.free(output);
+    try testing.expectEqualStrings(input, output);
+}
+
+test "markup_parser - tolerates loose markup" {
+    const allocator = testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const fragment = try markup_parser.parseFragment(
+        doc,
+        "<!DOCTYPE x><?pi data?><root a=one b='two' c d=\"1\" a=\"ignored\">" ++
+            "<leaf/>1 < 2 &unknown; &#65;&#x42;&#0;<![CDATA[<raw>]]></missing>" ++
+            "<row><cell>open</row>after</root><cut a=\"",
+    );
+    defer fragment.prototype.release();
+
+    const output = try serializer.serializeAlloc(allocator, &fragment.prototype, serializer.children_only);
+    defer allocator.free(output);
+    try testing.expectEqualStrings(
+        "<root a=\"one\" b=\"two\" c=\"\" d=\"1\"><leaf></leaf>1 &lt; 2 &amp;unknown; AB\u{FFFD}&lt;raw&gt;" ++
+            "<row><cell>open</cell></row>after</root>",
+        output,
+    );
+
+    // Text pieces between tags join one node
+    const root = fragment.prototype.first_child.?;
+    const leaf = root.first_child.?;
+    try testing.expect(leaf.next_sibling.?.node_type == .text);
+    try testing.expect(leaf.next_sibling.?.next_sibling.?.node_type == .element);
+}
+
+test "Element.insertAdjacentMarkup - inserts at each position in one record" {
+    const allocator = testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    const target = try doc.createElement("target");
+    _ = try root.prototype.appendChild(&target.prototype);
+    try target.insertAdjacentMarkup("beforeend", "<leaf/>");
+
+    const observer = try MutationObserver.init(allocator, ignoreRecords, null);
+    defer observer.deinit();
+    try observer.observe(&root.prototype, .{ .child_list = true, .subtree = true });
+
+    try target.insertAdjacentMarkup("beforebegin", "<row id=\"first\"></row><row></row>");
+    try target.insertAdjacentMarkup("afterbegin", "head");
+    try target.insertAdjacentMarkup("beforeend", "<cell>tail</cell>");
+    try target.insertAdjacentMarkup("afterend", "<row id=\"last\"/>");
+
+    const output = try serializer.serializeAlloc(allocator, &root.prototype, serializer.children_only);
+    defer allocator.free(output);
+    try testing.expectEqualStrings(
+        "<row id=\"first\"></row><row></row><target>head<leaf></leaf><cell>tail</cell></target><row id=\"last\"></row>",
+        output,
+    );
+    try testing.expect(doc.getElementById("first").?.prototype.isConnected());
+
+    const records = observer.takeRecords();
+    defer {
+        for (records) |record| record.deinit();
+        allocator.free(records);
+    }
+    try testing.expectEqual(@as(usize, 4), records.len);
+    try testing.expectEqual(@as(usize, 2), records[0].added_nodes.items.len);
+
+    try testing.expectError(error.SyntaxError, target.insertAdjacentMarkup("inside", "<leaf/>"));
+    try testing.expectError(error.NoModificationAllowedError, root.insertAdjacentMarkup("afterend", "<leaf/>"));
+
+    const detached = try doc.createElement("detached");
+    defer detached.prototype.release();
+    try testing.expectError(error.NoModificationAllowedError, detached.insertAdjacentMarkup("beforebegin", "x"));
+}
+
+test "Element.setInnerMarkup - replaces the children" {
+    const allocator = testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    try root.setInnerMarkup("<item id=\"old\">one</item><item>two</item>text");
+    try testing.expect(doc.getElementById("old") != null);
+
+    const observer = try MutationObserver.init(allocator, ignoreRecords, null);
+    defer observer.deinit();
+    try observer.observe(&root.prototype, .{ .child_list = true });
+
+    try root.setInnerMarkup("<item id=\"new\">three</item>");
+    try testing.expect(doc.getElementById("old") == null);
+    try testing.expect(doc.getElementById("new").?.prototype.parent_node == &root.prototype);
+    try testing.expect(root.prototype.first_child == root.prototype.last_child);
+
+    try root.setInnerMarkup("");
+    try testing.expect(root.prototype.first_child == null);
+
+    const records = observer.takeRecords();
+    defer {
+        for (records) |record| record.deinit();
+        allocator.free(records);
+    }
+    // Each replacement: one record for the removed run, one for the insertion
+    try testing.expectEqual(@as(usize, 3), records.len);
+    try testing.expectEqual(@as(usize, 3), records[0].removed_nodes.items.len);
+    try testing.expectEqual(@as(usize, 1), records[1].added_nodes.items.len);
+    try testing.expectEqual(@as(usize, 1), records[2].removed_nodes.items.len);
+}
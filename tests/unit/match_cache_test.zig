@@ -0,0 +1,134 @@
+//! match_cache Tests
+//!
+//! Tests for Document.enableMatchCache(): repeated matches() calls are
+//! answered from the cache, element-local answers survive changes elsewhere
+//! in the document, and every answer stays equal to the matcher's.
+
+const std = @import("std");
+const testing = std.testing;
+const dom = @import("dom");
+
+const Document = dom.Document;
+const match_cache = dom.match_cache;
+
+fn isLocal(doc: *Document, selectors: []const u8) !bool {
+    const parsed = try doc.selector_cache.acquire(selectors);
+    defer parsed.release();
+    return parsed.element_local;
+}
+
+test "match cache - selectors are split by what their answer depends on" {
+    const doc = try Document.init(testing.allocator);
+    defer doc.release();
+
+    try testing.expect(try isLocal(doc, "item"));
+    try testing.expect(try isLocal(doc, "item.selected[data-state=\"open\"]"));
+    try testing.expect(try isLocal(doc, "#main, .row:not(.hidden)"));
+    try testing.expect(try isLocal(doc, ":is(item, row):where([hidden])"));
+
+    try testing.expect(!try isLocal(doc, "list > item"));
+    try testing.expect(!try isLocal(doc, "item:first-child"));
+    try testing.expect(!try isLocal(doc, "item:has(leaf)"));
+    try testing.expect(!try isLocal(doc, ".row, :not(list > item)"));
+}
+
+test "match cache - element-local answers survive changes elsewhere" {
+    const allocator = testing.allocator;
+    const doc = try Document.init(allocator);
+    defer doc.release();
+    try doc.enableMatchCache();
+    const cache = doc.match_cache.?;
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    const item = try doc.createElement("item");
+    try item.setAttribute("class", "selected");
+    _ = try root.prototype.appendChild(&item.prototype);
+    const other = try doc.createElement("item");
+    _ = try root.prototype.appendChild(&other.prototype);
+
+    try testing.expect(try item.matches(allocator, ".selected"));
+    try testing.expect(try item.matches(allocator, ".selected"));
+    try testing.expectEqual(@as(u64, 1), cache.hits);
+    try testing.expectEqual(@as(u64, 1), cache.misses);
+
+    // Changes to other elements keep the answer
+    try other.setAttribute("class", "selected");
+    _ = try root.prototype.appendChild(&(try doc.createElement("row")).prototype);
+    try testing.expect(try item.matches(allocator, ".selected"));
+    try testing.expectEqual(@as(u64, 2), cache.hits);
+
+    // A change to the element itself drops it
+    try item.setAttribute("class", "plain");
+    try testing.expect(!try item.matches(allocator, ".selected"));
+    try testing.expectEqual(@as(u64, 2), cache.misses);
+    item.removeAttribute("class");
+    try testing.expect(!try item.matches(allocator, ".plain"));
+    try testing.expectEqual(@as(u64, 3), cache.misses);
+}
+
+test "match cache - tree-dependent answers last one mutation version" {
+    const allocator = testing.allocator;
+    const doc = try Document.init(allocator);
+    defer doc.release();
+    try doc.enableMatchCache();
+    const cache = doc.match_cache.?;
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    const item = try doc.createElement("item");
+    _ = try root.prototype.appendChild(&item.prototype);
+
+    try testing.expect(try item.matches(allocator, "item:first-child"));
+    try testing.expect(try item.matches(allocator, "item:first-child"));
+    try testing.expectEqual(@as(u64, 1), cache.hits);
+
+    // Inserting before it changes the answer without touching the element
+    const first = try doc.createElement("item");
+    _ = try root.prototype.insertBefore(&first.prototype, &item.prototype);
+    try testing.expect(!try item.matches(allocator, "item:first-child"));
+    try testing.expect(try first.matches(allocator, "item:first-child"));
+    try testing.expectEqual(@as(u64, 3), cache.misses);
+
+    // More selectors than slots: the oldest is re-matched, answers stay right
+    const selectors = [_][]const u8{ "item", "root > item", ".none", "[id]", "item:first-child" };
+    try testing.expect(selectors.len > match_cache.slots_per_element);
+    for (selectors) |selectors_string| _ = try first.matches(allocator, selectors_string);
+    try testing.expect(try first.matches(allocator, "item"));
+    try testing.expect(!try first.matches(allocator, ".none"));
+    try testing.expect(try first.matches(allocator, "item:first-child"));
+}
+
+test "match cache - elements are forgotten when they go away" {
+    const allocator = testing.allocator;
+    const doc = try Document.init(allocator);
+    defer doc.release();
+    try doc.enableMatchCache();
+    const cache = doc.match_cache.?;
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    const item = try doc.createElement("item");
+    _ = try root.prototype.appendChild(&item.prototype);
+    try testing.expect(try item.matches(allocator, "item"));
+    try testing.expect(try root.matches(allocator, "root"));
+    try testing.expectEqual(@as(usize, 2), cache.count());
+
+    // Removed only: the element-local answer is still valid (the parent's
+    // child list changed, which drops the parent's answers)
+    _ = try root.prototype.removeChild(&item.prototype);
+    try testing.expect(try item.matches(allocator, "item"));
+    try testing.expectEqual(@as(u64, 1), cache.hits);
+    try testing.expectEqual(@as(usize, 1), cache.count());
+
+    // Destroyed: its address may be reused
+    item.prototype.release();
+    try testing.expectEqual(@as(usize, 0), cache.count());
+
+    // Frozen documents match without the cache
+    try doc.freeze();
+    try testing.expect(try root.matches(allocator, "root"));
+    try testing.expect(try root.matches(allocator, "root"));
+    try testing.expectEqual(@as(u64, 1), cache.hits);
+    try testing.expectEqual(@as(usize, 0), cache.count());
+}
@@ -107,3 +107,48 @@ test "Matcher - :first-child" {
     try testing.expect(matches_li1);
     try testing.expect(!matches_li2);
 }
+
+test "Matcher - selector list dispatches on rightmost id, class and tag" {
+    const allocator = testing.allocator;
+
+    var tokenizer = Tokenizer.init(allocator, "row > #main, list .active, leaf.wide, item, [data-x]");
+    var p = try Parser.init(allocator, &tokenizer);
+    defer p.deinit();
+    var selector_list = try p.parse();
+    defer selector_list.deinit();
+
+    const dispatch = selector_list.dispatch.?;
+    try testing.expectEqual(@as(usize, 1), dispatch.by_id.count());
+    try testing.expectEqual(@as(usize, 2), dispatch.by_class.items.len);
+    try testing.expectEqual(@as(usize, 1), dispatch.by_tag.count());
+    try testing.expectEqual(@as(usize, 1), dispatch.universal.items.len);
+
+    const matcher = Matcher.init(allocator);
+
+    const item = try Element.create(allocator, "item");
+    defer item.prototype.release();
+    try testing.expect(try matcher.matches(item, &selector_list));
+
+    const attributed = try Element.create(allocator, "content");
+    defer attributed.prototype.release();
+    try testing.expect(!try matcher.matches(attributed, &selector_list));
+    try attributed.setAttribute("data-x", "1");
+    try testing.expect(try matcher.matches(attributed, &selector_list));
+
+    // Carries the class but not the tag of "leaf.wide"
+    const wide = try Element.create(allocator, "row");
+    defer wide.prototype.release();
+    try wide.setAttribute("class", "wide");
+    try testing.expect(!try matcher.matches(wide, &selector_list));
+
+    const leaf = try Element.create(allocator, "leaf");
+    defer leaf.prototype.release();
+    try leaf.setAttribute("class", "narrow wide");
+    try testing.expect(try matcher.matches(leaf, &selector_list));
+
+    // The id bucket still checks the rest of the complex selector
+    const main = try Element.create(allocator, "content");
+    defer main.prototype.release();
+    try main.setAttribute("id", "main");
+    try testing.expect(!try matcher.matches(main, &selector_list));
+}
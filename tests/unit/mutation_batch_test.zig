@@ -0,0 +1,135 @@
+//! mutation_batch Tests
+//!
+//! Tests for packing an observer's record queue into a MutationRecordBatch,
+//! and for the observer's queue notification hook.
+
+const std = @import("std");
+const dom = @import("dom");
+
+const testing = std.testing;
+const Document = dom.Document;
+const MutationObserver = dom.MutationObserver;
+const MutationRecord = dom.MutationRecord;
+const MutationRecordBatch = dom.MutationRecordBatch;
+const mutation_batch = dom.mutation_batch;
+
+fn ignoreRecords(_: []const *MutationRecord, _: *MutationObserver, _: ?*anyopaque) void {}
+
+var notify_count: usize = 0;
+
+fn countNotify(_: *MutationObserver) void {
+    notify_count += 1;
+}
+
+test "MutationRecordBatch - packs records and deduplicates nodes" {
+    const allocator = testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+
+    const observer = try MutationObserver.init(allocator, ignoreRecords, null);
+    defer observer.deinit();
+    try observer.observe(&root.prototype, .{ .child_list = true, .attributes = true, .attribute_old_value = true });
+
+    const first = try doc.createElement("item");
+    _ = try root.prototype.appendChild(&first.prototype);
+    const second = try doc.createElement("item");
+    _ = try root.prototype.appendChild(&second.prototype);
+    try root.setAttribute("state", "open");
+
+    var batch = try MutationRecordBatch.take(observer);
+    defer batch.deinit();
+
+    try testing.expectEqual(@as(usize, 3), batch.count());
+    try testing.expectEqual(@as(usize, 0), observer.records.items.len);
+    // root, first, second: each node once
+    try testing.expectEqual(@as(usize, 3), batch.nodes.len);
+
+    const append_first = batch.entry(0);
+    try testing.expectEqual(@intFromEnum(mutation_batch.RecordType.child_list), append_first[mutation_batch.field_type]);
+    try testing.expectEqual(&root.prototype, batch.nodes[append_first[mutation_batch.field_target]]);
+    try testing.expectEqual(mutation_batch.none, append_first[mutation_batch.field_previous_sibling]);
+    try testing.expectEqual(@as(u32, 0), append_first[mutation_batch.field_removed_count]);
+    try testing.expectEqual(@as(usize, 1), batch.addedNodes(0).len);
+    try testing.expectEqual(&first.prototype, batch.nodes[batch.addedNodes(0)[0]]);
+
+    // The second append's previous sibling is the first added node
+    const append_second = batch.entry(1);
+    try testing.expectEqual(batch.addedNodes(0)[0], append_second[mutation_batch.field_previous_sibling]);
+    try testing.expectEqual(&second.prototype, batch.nodes[batch.addedNodes(1)[0]]);
+
+    const attribute = batch.entry(2);
+    try testing.expectEqual(@intFromEnum(mutation_batch.RecordType.attributes), attribute[mutation_batch.field_type]);
+    try testing.expectEqual(@as(u32, 0), attribute[mutation_batch.field_added_count]);
+    try testing.expectEqualStrings("state", batch.record(2).attribute_name.?);
+    try testing.expect(batch.record(2).old_value == null);
+}
+
+test "MutationRecordBatch - keeps removed nodes alive" {
+    const allocator = testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    const leaf = try doc.createElement("leaf");
+    _ = try root.prototype.appendChild(&leaf.prototype);
+
+    const observer = try MutationObserver.init(allocator, ignoreRecords, null);
+    defer observer.deinit();
+    try observer.observe(&root.prototype, .{ .child_list = true });
+
+    _ = try root.prototype.removeChild(&leaf.prototype);
+
+    var batch = try MutationRecordBatch.take(observer);
+    defer batch.deinit();
+
+    // Drop our reference; the batch still holds one
+    leaf.prototype.release();
+
+    try testing.expectEqual(@as(usize, 1), batch.count());
+    const removed = batch.removedNodes(0);
+    try testing.expectEqual(@as(usize, 1), removed.len);
+    try testing.expectEqual(dom.NodeType.element, batch.nodes[removed[0]].node_type);
+}
+
+test "MutationRecordBatch - empty queue gives an empty batch" {
+    const observer = try MutationObserver.init(testing.allocator, ignoreRecords, null);
+    defer observer.deinit();
+
+    var batch = try MutationRecordBatch.take(observer);
+    defer batch.deinit();
+
+    try testing.expectEqual(@as(usize, 0), batch.count());
+    try testing.expectEqual(@as(usize, 0), batch.nodes.len);
+}
+
+test "MutationObserver - on_records fires once per non-empty queue" {
+    const allocator = testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+
+    const observer = try MutationObserver.init(allocator, ignoreRecords, null);
+    defer observer.deinit();
+    observer.on_records = countNotify;
+    try observer.observe(&root.prototype, .{ .attributes = true });
+
+    notify_count = 0;
+    try root.setAttribute("a", "1");
+    try root.setAttribute("b", "2");
+    try testing.expectEqual(@as(usize, 1), notify_count);
+
+    var batch = try MutationRecordBatch.take(observer);
+    batch.deinit();
+
+    try root.setAttribute("c", "3");
+    try testing.expectEqual(@as(usize, 2), notify_count);
+}
@@ -0,0 +1,199 @@
+//! Mutation coalescing Tests
+//!
+//! Tests for the `coalesce` extension of MutationObserverInit: one
+//! attributes record per (target, attribute) per queue, and childList runs
+//! merged into one record.
+
+const std = @import("std");
+const dom = @import("dom");
+
+const testing = std.testing;
+const Document = dom.Document;
+const MutationObserver = dom.MutationObserver;
+const MutationRecord = dom.MutationRecord;
+
+fn ignoreRecords(_: []const *MutationRecord, _: *MutationObserver, _: ?*anyopaque) void {}
+
+fn freeRecords(observer: *MutationObserver, records: []const *MutationRecord) void {
+    for (records) |record| record.deinit();
+    observer.allocator.free(records);
+}
+
+test "MutationObserver coalesce - one attributes record per attribute keeps first oldValue" {
+    const allocator = testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    try root.setAttribute("state", "closed");
+
+    const observer = try MutationObserver.init(allocator, ignoreRecords, null);
+    defer observer.deinit();
+    try observer.observe(&root.prototype, .{ .attributes = true, .attribute_old_value = true, .coalesce = true });
+
+    try root.setAttribute("state", "opening");
+    try root.setAttribute("state", "open");
+    try root.setAttribute("level", "1");
+    try root.setAttribute("level", "2");
+
+    const records = observer.takeRecords();
+    defer freeRecords(observer, records);
+
+    try testing.expectEqual(@as(usize, 2), records.len);
+    try testing.expectEqualStrings("state", records[0].attribute_name.?);
+    try testing.expectEqualStrings("closed", records[0].old_value.?);
+    try testing.expectEqualStrings("level", records[1].attribute_name.?);
+    try testing.expect(records[1].old_value == null);
+
+    // Taking the queue starts a new coalescing window
+    try root.setAttribute("state", "closed");
+    const next = observer.takeRecords();
+    defer freeRecords(observer, next);
+
+    try testing.expectEqual(@as(usize, 1), next.len);
+    try testing.expectEqualStrings("open", next[0].old_value.?);
+}
+
+test "MutationObserver coalesce - consecutive appends merge into one record" {
+    const allocator = testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+
+    const observer = try MutationObserver.init(allocator, ignoreRecords, null);
+    defer observer.deinit();
+    try observer.observe(&root.prototype, .{ .child_list = true, .coalesce = true });
+
+    const first = try doc.createElement("item");
+    _ = try root.prototype.appendChild(&first.prototype);
+    const second = try doc.createElement("item");
+    _ = try root.prototype.appendChild(&second.prototype);
+    const third = try doc.createElement("item");
+    _ = try root.prototype.appendChild(&third.prototype);
+
+    // Inserting before the run breaks it
+    const head = try doc.createElement("item");
+    _ = try root.prototype.insertBefore(&head.prototype, &first.prototype);
+
+    const records = observer.takeRecords();
+    defer freeRecords(observer, records);
+
+    try testing.expectEqual(@as(usize, 2), records.len);
+    try testing.expectEqual(@as(usize, 3), records[0].added_nodes.items.len);
+    try testing.expectEqual(&first.prototype, records[0].added_nodes.items[0]);
+    try testing.expectEqual(&third.prototype, records[0].added_nodes.items[2]);
+    try testing.expect(records[0].previous_sibling == null);
+    try testing.expect(records[0].next_sibling == null);
+    try testing.expectEqual(&head.prototype, records[1].added_nodes.items[0]);
+    try testing.expectEqual(&first.prototype, records[1].next_sibling.?);
+}
+
+test "MutationObserver coalesce - consecutive removals merge into one record" {
+    const allocator = testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    const first = try doc.createElement("item");
+    _ = try root.prototype.appendChild(&first.prototype);
+    const second = try doc.createElement("item");
+    _ = try root.prototype.appendChild(&second.prototype);
+    const last = try doc.createElement("item");
+    _ = try root.prototype.appendChild(&last.prototype);
+
+    const observer = try MutationObserver.init(allocator, ignoreRecords, null);
+    defer observer.deinit();
+    try observer.observe(&root.prototype, .{ .child_list = true, .coalesce = true });
+
+    _ = try root.prototype.removeChild(&first.prototype);
+    defer first.prototype.release();
+    _ = try root.prototype.removeChild(&second.prototype);
+    defer second.prototype.release();
+
+    const records = observer.takeRecords();
+    defer freeRecords(observer, records);
+
+    try testing.expectEqual(@as(usize, 1), records.len);
+    try testing.expectEqual(@as(usize, 2), records[0].removed_nodes.items.len);
+    try testing.expectEqual(&second.prototype, records[0].removed_nodes.items[1]);
+    try testing.expect(records[0].previous_sibling == null);
+    try testing.expectEqual(&last.prototype, records[0].next_sibling.?);
+}
+
+test "MutationObserver coalesce - off by default" {
+    const allocator = testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+
+    const observer = try MutationObserver.init(allocator, ignoreRecords, null);
+    defer observer.deinit();
+    try observer.observe(&root.prototype, .{ .attributes = true, .child_list = true });
+
+    try root.setAttribute("state", "a");
+    try root.setAttribute("state", "b");
+    const first = try doc.createElement("item");
+    _ = try root.prototype.appendChild(&first.prototype);
+    const second = try doc.createElement("item");
+    _ = try root.prototype.appendChild(&second.prototype);
+
+    const records = observer.takeRecords();
+    defer freeRecords(observer, records);
+
+    try testing.expectEqual(@as(usize, 4), records.len);
+}
+
+test "Document batch - records coalesce for every observer until the batch ends" {
+    const allocator = testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+
+    const observer = try MutationObserver.init(allocator, ignoreRecords, null);
+    defer observer.deinit();
+    try observer.observe(&root.prototype, .{ .attributes = true, .child_list = true });
+
+    doc.beginBatch();
+    doc.beginBatch();
+    try root.setAttribute("state", "opening");
+    try root.setAttribute("state", "open");
+    for (0..3) |_| {
+        const item = try doc.createElement("item");
+        _ = try root.prototype.appendChild(&item.prototype);
+    }
+    try doc.endBatch();
+
+    // Still inside the outer batch
+    try root.setAttribute("state", "closed");
+    try doc.endBatch();
+
+    const records = observer.takeRecords();
+    defer freeRecords(observer, records);
+
+    try testing.expectEqual(@as(usize, 2), records.len);
+    try testing.expectEqualStrings("attributes", records[0].type);
+    try testing.expectEqualStrings("childList", records[1].type);
+    try testing.expectEqual(@as(usize, 3), records[1].added_nodes.items.len);
+
+    // Outside a batch every mutation is recorded again
+    try root.setAttribute("state", "open");
+    try root.setAttribute("state", "closed");
+    const next = observer.takeRecords();
+    defer freeRecords(observer, next);
+    try testing.expectEqual(@as(usize, 2), next.len);
+
+    try testing.expectError(error.InvalidStateError, doc.endBatch());
+}
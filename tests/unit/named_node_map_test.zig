@@ -218,3 +218,71 @@ test "NamedNodeMap: setNamedItemNS and removeNamedItemNS" {
     try expectEqualStrings("value1", removed.value());
     try expect(elem.getAttribute("data-test") == null);
 }
+
+test "NamedNodeMap: item returns the cached Attr in inline and heap storage" {
+    const allocator = testing.allocator;
+
+    const elem = try Element.create(allocator, "element");
+    defer elem.prototype.release();
+
+    var attrs = NamedNodeMap{ .element = elem };
+    const names = [_][]const u8{ "a", "b", "c", "d", "e", "f" };
+    for (names, 0..) |name, count| {
+        try elem.setAttribute(name, name);
+
+        // Four attributes fit inline; the fifth moves them to the heap
+        for (0..count + 1) |i| {
+            const first = (try attrs.item(@intCast(i))).?;
+            defer first.node.release();
+            const second = (try attrs.item(@intCast(i))).?;
+            defer second.node.release();
+            try expect(first == second);
+            try expectEqualStrings(names[i], first.name());
+        }
+        try expect((try attrs.item(@intCast(count + 1))) == null);
+    }
+}
+
+test "NamedNodeMap: setAttribute keeps the cached Attr attached" {
+    const allocator = testing.allocator;
+
+    const elem = try Element.create(allocator, "element");
+    defer elem.prototype.release();
+
+    try elem.setAttribute("id", "before");
+
+    var attrs = NamedNodeMap{ .element = elem };
+    const attr = (try attrs.item(0)).?;
+    defer attr.node.release();
+
+    try elem.setAttribute("id", "after");
+    try expect(attr.owner_element == elem);
+    try expectEqualStrings("after", attr.value());
+
+    const again = (try attrs.getNamedItem("id")).?;
+    defer again.node.release();
+    try expect(again == attr);
+}
+
+test "NamedNodeMap: borrowed lookups share the cached Attr without references" {
+    const allocator = testing.allocator;
+
+    const elem = try Element.create(allocator, "element");
+    defer elem.prototype.release();
+
+    try elem.setAttribute("id", "main");
+
+    var attrs = NamedNodeMap{ .element = elem };
+    const borrowed = (try attrs.itemBorrowed(0)).?;
+    const ref_count = borrowed.node.getRefCount();
+    try expect((try attrs.getNamedItemBorrowed("id")).? == borrowed);
+    try expectEqual(ref_count, borrowed.node.getRefCount());
+    try expect((try attrs.itemBorrowed(1)) == null);
+    try expect((try attrs.getNamedItemBorrowed("missing")) == null);
+
+    // The owned lookup hands out the same node, with a reference
+    const owned = (try attrs.item(0)).?;
+    try expect(owned == borrowed);
+    try expectEqual(ref_count + 1, owned.node.getRefCount());
+    owned.node.release();
+}
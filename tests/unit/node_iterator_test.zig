@@ -27,7 +27,7 @@ test "NodeIterator basic forward iteration" {
     _ = try doc.prototype.appendChild(&root.prototype);
 
     const iterator = try doc.createNodeIterator(&root.prototype, NodeFilter.SHOW_ALL, null);
-    // No need to deinit - arena allocated, freed with document
+    defer iterator.deinit();
 
     // Should return root, then children in order
     try std.testing.expectEqual(&root.prototype, iterator.nextNode().?);
@@ -50,7 +50,7 @@ test "NodeIterator backward iteration" {
     _ = try doc.prototype.appendChild(&root.prototype);
 
     const iterator = try doc.createNodeIterator(&root.prototype, NodeFilter.SHOW_ALL, null);
-    // No need to deinit - arena allocated, freed with document
+    defer iterator.deinit();
 
     // Move to end
     while (iterator.nextNode()) |_| {}
@@ -78,7 +78,7 @@ test "NodeIterator filter by node type" {
 
     // Only show elements
     const iterator = try doc.createNodeIterator(&root.prototype, NodeFilter.SHOW_ELEMENT, null);
-    // No need to deinit - arena allocated, freed with document
+    defer iterator.deinit();
 
     // Should skip text node
     try std.testing.expectEqual(&root.prototype, iterator.nextNode().?);
@@ -96,8 +96,133 @@ test "NodeIterator detach does nothing" {
     _ = try doc.prototype.appendChild(&root.prototype);
 
     const iterator = try doc.createNodeIterator(&root.prototype, NodeFilter.SHOW_ALL, null);
-    // No need to deinit - arena allocated, freed with document
+    defer iterator.deinit();
 
     iterator.detach(); // Should be no-op
     try std.testing.expectEqual(&root.prototype, iterator.nextNode().?);
 }
+
+test "NodeIterator references its reference node" {
+    const allocator = std.testing.allocator;
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    const item = try doc.createElement("item");
+    const row = try doc.createElement("row");
+    _ = try root.prototype.appendChild(&item.prototype);
+    _ = try root.prototype.appendChild(&row.prototype);
+    _ = try doc.prototype.appendChild(&root.prototype);
+
+    const iterator = try doc.createNodeIterator(&root.prototype, NodeFilter.SHOW_ALL, null);
+    defer iterator.deinit();
+
+    const base = row.prototype.getRefCount();
+    try std.testing.expectEqual(&root.prototype, iterator.nextNode().?);
+    try std.testing.expectEqual(&item.prototype, iterator.nextNode().?);
+    try std.testing.expectEqual(&row.prototype, iterator.nextNode().?);
+    try std.testing.expectEqual(base + 1, row.prototype.getRefCount());
+
+    // A removed reference node outlives its last other owner
+    _ = try root.prototype.removeChild(&row.prototype);
+    try std.testing.expectEqual(&item.prototype, iterator.reference_node);
+    try std.testing.expectEqual(base, row.prototype.getRefCount());
+    row.prototype.release();
+}
+
+test "NodeIterator pre-removing steps after the reference node" {
+    const allocator = std.testing.allocator;
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    // root -> [list -> [item], row]
+    const root = try doc.createElement("root");
+    const list = try doc.createElement("list");
+    const item = try doc.createElement("item");
+    const row = try doc.createElement("row");
+    _ = try root.prototype.appendChild(&list.prototype);
+    _ = try list.prototype.appendChild(&item.prototype);
+    _ = try root.prototype.appendChild(&row.prototype);
+    _ = try doc.prototype.appendChild(&root.prototype);
+
+    const iterator = try doc.createNodeIterator(&root.prototype, NodeFilter.SHOW_ALL, null);
+    defer iterator.deinit();
+    while (iterator.nextNode()) |node| {
+        if (node == &item.prototype) break;
+    }
+
+    // The reference moves to the node preceding the removed subtree
+    _ = try root.prototype.removeChild(&list.prototype);
+    defer list.prototype.release();
+    try std.testing.expectEqual(&root.prototype, iterator.reference_node);
+    try std.testing.expect(!iterator.pointer_before_reference_node);
+    try std.testing.expectEqual(&row.prototype, iterator.nextNode().?);
+}
+
+test "NodeIterator pre-removing steps before the reference node" {
+    const allocator = std.testing.allocator;
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    // root -> [list -> [item], row]
+    const root = try doc.createElement("root");
+    const list = try doc.createElement("list");
+    const item = try doc.createElement("item");
+    const row = try doc.createElement("row");
+    _ = try root.prototype.appendChild(&list.prototype);
+    _ = try list.prototype.appendChild(&item.prototype);
+    _ = try root.prototype.appendChild(&row.prototype);
+    _ = try doc.prototype.appendChild(&root.prototype);
+
+    const iterator = try doc.createNodeIterator(&root.prototype, NodeFilter.SHOW_ALL, null);
+    defer iterator.deinit();
+    while (iterator.nextNode()) |node| {
+        if (node == &item.prototype) break;
+    }
+    try std.testing.expectEqual(&item.prototype, iterator.previousNode().?);
+
+    // The reference moves to the first node following the removed subtree
+    _ = try root.prototype.removeChild(&list.prototype);
+    defer list.prototype.release();
+    try std.testing.expectEqual(&row.prototype, iterator.reference_node);
+    try std.testing.expect(iterator.pointer_before_reference_node);
+    try std.testing.expectEqual(&row.prototype, iterator.nextNode().?);
+
+    // Nothing follows row: the reference moves back to root, after it
+    _ = try root.prototype.removeChild(&row.prototype);
+    defer row.prototype.release();
+    try std.testing.expectEqual(&root.prototype, iterator.reference_node);
+    try std.testing.expect(!iterator.pointer_before_reference_node);
+    try std.testing.expect(iterator.nextNode() == null);
+}
+
+test "NodeIterator follows its root into another document" {
+    const allocator = std.testing.allocator;
+    const doc = try Document.init(allocator);
+    defer doc.release();
+    const other = try Document.init(allocator);
+    defer other.release();
+
+    const root = try doc.createElement("root");
+    defer root.prototype.release();
+    const list = try doc.createElement("list");
+    const item = try doc.createElement("item");
+    _ = try root.prototype.appendChild(&list.prototype);
+    _ = try list.prototype.appendChild(&item.prototype);
+    _ = try doc.prototype.appendChild(&root.prototype);
+
+    const iterator = try doc.createNodeIterator(&root.prototype, NodeFilter.SHOW_ALL, null);
+    defer iterator.deinit();
+    while (iterator.nextNode()) |node| {
+        if (node == &item.prototype) break;
+    }
+
+    _ = try other.adoptNode(&root.prototype);
+    try std.testing.expectEqual(@as(usize, 0), doc.node_iterators.items.len);
+    try std.testing.expectEqual(@as(usize, 1), other.node_iterators.items.len);
+
+    // Removals in the new document run the iterator's steps
+    _ = try list.prototype.removeChild(&item.prototype);
+    defer item.prototype.release();
+    try std.testing.expectEqual(&list.prototype, iterator.reference_node);
+}
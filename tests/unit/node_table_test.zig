@@ -0,0 +1,131 @@
+//! node_table Tests
+//!
+//! Tests for Document.nodeId() and the node table: ids step through the
+//! tree like the node pointers, tag atoms compare names, and ids of nodes
+//! that go away never name another node.
+
+const std = @import("std");
+const testing = std.testing;
+const dom = @import("dom");
+
+const Document = dom.Document;
+const Node = dom.Node;
+
+test "node table - ids walk the tree and atoms compare tag names" {
+    const doc = try Document.init(testing.allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    for (0..3) |_| {
+        _ = try root.prototype.appendChild(&(try doc.createElement("row")).prototype);
+        _ = try root.prototype.appendChild(&(try doc.createTextNode("gap")).prototype);
+    }
+
+    try testing.expect(doc.node_table == null);
+    const root_id = try doc.nodeId(&root.prototype);
+    try testing.expectEqual(@as(u32, 1), root_id);
+    try testing.expectEqual(root_id, try doc.nodeId(&root.prototype));
+    const table = doc.node_table.?;
+
+    // Same order and nodes as first_child / next_sibling
+    const row = try table.atomOf(&doc.string_pool, "row");
+    var rows: usize = 0;
+    var expected = root.prototype.first_child;
+    var id = try table.related(root_id, .first_child);
+    while (id != 0) : (id = try table.related(id, .next_sibling)) {
+        try testing.expectEqual(expected.?, table.get(id).?);
+        if (try table.tagAtom(&doc.string_pool, id) == row) rows += 1;
+        try testing.expectEqual(root_id, try table.related(id, .parent));
+        expected = expected.?.next_sibling;
+    }
+    try testing.expect(expected == null);
+    try testing.expectEqual(@as(usize, 3), rows);
+    try testing.expectEqual(@as(usize, 7), table.count());
+
+    // Atoms name their tags; text has none
+    const root_atom = try table.tagAtom(&doc.string_pool, root_id);
+    try testing.expect(root_atom != row);
+    try testing.expectEqualStrings("root", table.atomName(root_atom).?);
+    try testing.expectEqual(@as(u32, 0), try table.tagAtom(&doc.string_pool, try table.related(root_id, .last_child)));
+    try testing.expect(table.atomName(0) == null);
+
+    // The document is a node of its own table; ids of its parent stop there
+    const doc_id = try table.related(root_id, .parent);
+    try testing.expectEqual(&doc.prototype, doc.nodeById(doc_id).?);
+    try testing.expectEqual(doc_id, try doc.nodeId(&doc.prototype));
+    try testing.expectEqual(@as(u32, 0), try table.related(doc_id, .parent));
+}
+
+test "node table - ids of nodes that go away are never reused" {
+    const doc = try Document.init(testing.allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    const first = try doc.createElement("item");
+    const second = try doc.createElement("item");
+    _ = try root.prototype.appendChild(&first.prototype);
+    _ = try root.prototype.appendChild(&second.prototype);
+
+    const first_id = try doc.nodeId(&first.prototype);
+    const second_id = try doc.nodeId(&second.prototype);
+
+    // Moving keeps the id
+    _ = try root.prototype.insertBefore(&second.prototype, &first.prototype);
+    try testing.expectEqual(second_id, try doc.nodeId(&second.prototype));
+
+    // Destroyed: the id names nothing, new nodes get new ids
+    _ = try root.prototype.removeChild(&first.prototype);
+    first.prototype.release();
+    try testing.expect(doc.nodeById(first_id) == null);
+    const replacement = try doc.createElement("item");
+    _ = try root.prototype.appendChild(&replacement.prototype);
+    const replacement_id = try doc.nodeId(&replacement.prototype);
+    try testing.expect(replacement_id > second_id);
+
+    // Nodes of other documents get no id
+    const other = try Document.init(testing.allocator);
+    defer other.release();
+    const foreign = try other.createElement("item");
+    defer foreign.prototype.release();
+    try testing.expectEqual(@as(u32, 0), try doc.nodeId(&foreign.prototype));
+
+    // Clearing drops every id at once
+    doc.node_table.?.clear();
+    try testing.expect(doc.nodeById(second_id) == null);
+    try testing.expect(doc.nodeById(replacement_id) == null);
+    try testing.expect(try doc.nodeId(&second.prototype) > replacement_id);
+}
+
+test "node table - freezing numbers the tree and makes the table read-only" {
+    const doc = try Document.init(testing.allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    const leaf = try doc.createElement("leaf");
+    _ = try root.prototype.appendChild(&leaf.prototype);
+    const detached = try doc.createElement("item");
+    defer detached.prototype.release();
+
+    const detached_id = try doc.nodeId(&detached.prototype);
+    try doc.freeze();
+    const table = doc.node_table.?;
+
+    // Every tree node and tag has its id; the detached node lost its own
+    try testing.expectEqual(@as(usize, 3), table.count());
+    try testing.expect(doc.nodeById(detached_id) == null);
+    try testing.expectEqual(@as(u32, 0), try doc.nodeId(&detached.prototype));
+    const leaf_id = try doc.nodeId(&leaf.prototype);
+    try testing.expect(leaf_id != 0);
+    try testing.expectEqualStrings("leaf", table.atomName(try table.tagAtom(&doc.string_pool, leaf_id)).?);
+    try testing.expectEqual(@as(u32, 0), try table.atomOf(&doc.string_pool, "row"));
+
+    // Too late to enable on another frozen document
+    const frozen = try Document.init(testing.allocator);
+    defer frozen.release();
+    try frozen.freeze();
+    try testing.expectError(error.InvalidStateError, frozen.enableNodeTable());
+    try testing.expectEqual(@as(u32, 0), try frozen.nodeId(&frozen.prototype));
+}
@@ -14,10 +14,15 @@ const NodeVTable = dom.NodeVTable;
 
 test "Node - size constraint" {
     const size = @sizeOf(Node);
-    try std.testing.expect(size <= 104); // Node now includes EventTarget prototype (8 bytes)
+    try std.testing.expect(size <= 112); // Node now includes EventTarget prototype (8 bytes)
 
     // Print actual size for documentation
-    std.debug.print("\nNode size: {d} bytes (target: ≤104 with EventTarget)\n", .{size});
+    std.debug.print("\nNode size: {d} bytes (target: ≤112 with EventTarget)\n", .{size});
+
+    // Tree links share the first 64 bytes
+    try std.testing.expect(@offsetOf(Node, "next_sibling") + 8 <= 64);
+    try std.testing.expect(@offsetOf(Node, "first_child") + 8 <= 64);
+    try std.testing.expect(@offsetOf(Node, "parent_node") + 8 <= 64);
 }
 
 test "Node - packed ref_count and has_parent" {
@@ -1287,6 +1292,78 @@ test "Node.textContent - setter propagates connected state" {
     try std.testing.expect(root.prototype.first_child.?.isConnected());
 }
 
+test "Node.textContent - setter replaces a sole Text child by default" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+
+    const text = try doc.createTextNode("before");
+    _ = try root.prototype.appendChild(&text.prototype);
+    text.prototype.acquire();
+    defer text.prototype.release();
+
+    try root.prototype.setTextContent("after");
+
+    // Per spec the old child leaves the tree for a new Text node
+    try std.testing.expect(text.prototype.parent_node == null);
+    try std.testing.expectEqualStrings("before", text.data);
+    try std.testing.expect(root.prototype.first_child.? != &text.prototype);
+    try std.testing.expectEqual(root.prototype.first_child, root.prototype.last_child);
+}
+
+test "Node.textContent - setter reuses a sole Text child when enabled" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+    doc.enableInPlaceTextContent();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+
+    const text = try doc.createTextNode("before");
+    _ = try root.prototype.appendChild(&text.prototype);
+
+    const observer = try dom.MutationObserver.init(allocator, struct {
+        fn callback(_: []const *dom.MutationRecord, _: *dom.MutationObserver, _: ?*anyopaque) void {}
+    }.callback, null);
+    defer observer.deinit();
+    try observer.observe(&root.prototype, .{
+        .child_list = true,
+        .character_data = true,
+        .character_data_old_value = true,
+        .subtree = true,
+    });
+
+    try root.prototype.setTextContent("after");
+
+    // Same node, new data
+    try std.testing.expectEqual(&text.prototype, root.prototype.first_child.?);
+    try std.testing.expectEqual(&text.prototype, root.prototype.last_child.?);
+    try std.testing.expectEqualStrings("after", text.data);
+
+    // One characterData record instead of a childList record
+    const records = observer.takeRecords();
+    defer {
+        for (records) |record| record.deinit();
+        allocator.free(records);
+    }
+    try std.testing.expectEqual(@as(usize, 1), records.len);
+    try std.testing.expectEqualStrings("characterData", records[0].type);
+    try std.testing.expectEqualStrings("before", records[0].old_value.?);
+
+    // Any other child list is still replaced
+    const leaf = try doc.createElement("leaf");
+    _ = try root.prototype.appendChild(&leaf.prototype);
+    try root.prototype.setTextContent("replaced");
+    try std.testing.expectEqual(@as(usize, 1), root.prototype.childNodes().length());
+    try std.testing.expect(root.prototype.first_child.? != &text.prototype);
+}
+
 test "Node.textContent - no memory leaks" {
     const allocator = std.testing.allocator;
 
@@ -1514,6 +1591,50 @@ test "Node.contains - returns false for null (per spec)" {
     try std.testing.expect(!elem.prototype.contains(null));
 }
 
+test "Node.contains - depths follow moved subtrees" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    // root > list > item > leaf, built bottom-up
+    const root = try doc.createElement("root");
+    const list = try doc.createElement("list");
+    const item = try doc.createElement("item");
+    const leaf = try doc.createElement("leaf");
+    _ = try item.prototype.appendChild(&leaf.prototype);
+    _ = try list.prototype.appendChild(&item.prototype);
+    try std.testing.expectEqual(@as(u32, 2), leaf.prototype.depth);
+
+    _ = try root.prototype.appendChild(&list.prototype);
+    _ = try doc.prototype.appendChild(&root.prototype);
+    try std.testing.expectEqual(@as(u32, 1), root.prototype.depth);
+    try std.testing.expectEqual(@as(u32, 4), leaf.prototype.depth);
+    try std.testing.expect(doc.prototype.contains(&leaf.prototype));
+    try std.testing.expect(list.prototype.contains(&leaf.prototype));
+    try std.testing.expect(!leaf.prototype.contains(&list.prototype));
+
+    // Through a fragment and back out
+    const fragment = try doc.createDocumentFragment();
+    defer fragment.prototype.release();
+    _ = try fragment.prototype.appendChild(&item.prototype);
+    try std.testing.expectEqual(@as(u32, 2), leaf.prototype.depth);
+    try std.testing.expect(!list.prototype.contains(&leaf.prototype));
+
+    _ = try root.prototype.appendChild(&fragment.prototype);
+    try std.testing.expectEqual(@as(u32, 2), item.prototype.depth);
+    try std.testing.expectEqual(@as(u32, 3), leaf.prototype.depth);
+    try std.testing.expect(root.prototype.contains(&leaf.prototype));
+    try std.testing.expect(!list.prototype.contains(&leaf.prototype));
+
+    _ = try root.prototype.removeChild(&item.prototype);
+    defer item.prototype.release();
+    try std.testing.expectEqual(@as(u32, 0), item.prototype.depth);
+    try std.testing.expectEqual(@as(u32, 1), leaf.prototype.depth);
+    try std.testing.expect(item.prototype.contains(&leaf.prototype));
+    try std.testing.expect(!root.prototype.contains(&leaf.prototype));
+}
+
 // === baseURI() Tests ===
 
 test "Node.baseURI - returns empty string (placeholder)" {
@@ -2071,6 +2192,217 @@ test "Node.dispatchEvent - event retargeting across shadow boundary" {
     try std.testing.expect(host_check.actual_target == &host.prototype);
 }
 
+test "Node.dispatchEvent - once removes only its own registration of a shared callback" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    errdefer doc.release();
+
+    const elem = try doc.createElement("item");
+    _ = try doc.prototype.appendChild(&elem.prototype);
+
+    // Bindings register many listeners through one callback, told apart by context
+    const Counter = struct {
+        calls: u32 = 0,
+        released: u32 = 0,
+
+        fn invoke(_: *Event, context: *anyopaque) void {
+            const self: *@This() = @ptrCast(@alignCast(context));
+            self.calls += 1;
+        }
+
+        fn release(context: *anyopaque) void {
+            const self: *@This() = @ptrCast(@alignCast(context));
+            self.released += 1;
+        }
+    };
+    var once = Counter{};
+    var always = Counter{};
+
+    const rare = try elem.prototype.ensureRareData();
+    try rare.addEventListener(.{
+        .event_type = "ping",
+        .callback = Counter.invoke,
+        .context = @ptrCast(&always),
+        .capture = false,
+        .once = false,
+        .passive = false,
+        .release_context = Counter.release,
+    });
+    try rare.addEventListener(.{
+        .event_type = "ping",
+        .callback = Counter.invoke,
+        .context = @ptrCast(&once),
+        .capture = false,
+        .once = true,
+        .passive = false,
+        .release_context = Counter.release,
+    });
+
+    var event1 = Event.init("ping", .{});
+    _ = try elem.prototype.dispatchEvent(&event1);
+    var event2 = Event.init("ping", .{});
+    _ = try elem.prototype.dispatchEvent(&event2);
+
+    try std.testing.expectEqual(@as(u32, 1), once.calls);
+    try std.testing.expectEqual(@as(u32, 1), once.released);
+    try std.testing.expectEqual(@as(u32, 2), always.calls);
+    try std.testing.expectEqual(@as(u32, 0), always.released);
+
+    // Remaining listeners are released when the document goes away
+    doc.release();
+    try std.testing.expectEqual(@as(u32, 1), always.released);
+}
+
+test "Node.dispatchEvent - listener removed by an earlier listener is not invoked" {
+    const allocator = std.testing.allocator;
+
+    const elem = try Element.create(allocator, "item");
+    defer elem.prototype.release();
+
+    const State = struct {
+        var target: *Node = undefined;
+        var second_calls: u32 = 0;
+
+        fn first(_: *Event, _: *anyopaque) void {
+            target.removeEventListener("ping", second, false);
+        }
+
+        fn second(_: *Event, _: *anyopaque) void {
+            second_calls += 1;
+        }
+    };
+    State.target = &elem.prototype;
+
+    try elem.prototype.addEventListener("ping", State.first, undefined, false, false, false, null);
+    try elem.prototype.addEventListener("ping", State.second, undefined, false, false, false, null);
+
+    var event = Event.init("ping", .{});
+    _ = try elem.prototype.dispatchEvent(&event);
+
+    try std.testing.expectEqual(@as(u32, 0), State.second_calls);
+    try std.testing.expect(elem.prototype.hasEventListeners("ping"));
+}
+
+test "Node.dispatchEvent - dispatch_id identifies each dispatch" {
+    const allocator = std.testing.allocator;
+
+    const elem = try Element.create(allocator, "item");
+    defer elem.prototype.release();
+
+    const State = struct {
+        var seen: u32 = 0;
+
+        fn record(event: *Event, _: *anyopaque) void {
+            seen = event.dispatch_id;
+        }
+    };
+    try elem.prototype.addEventListener("ping", State.record, undefined, false, false, false, null);
+
+    var event = Event.init("ping", .{});
+    try std.testing.expectEqual(@as(u32, 0), event.dispatch_id);
+    _ = try elem.prototype.dispatchEvent(&event);
+    try std.testing.expectEqual(@as(u32, 1), State.seen);
+    _ = try elem.prototype.dispatchEvent(&event);
+    try std.testing.expectEqual(@as(u32, 2), State.seen);
+}
+
+test "Node.dispatchEvent - skips dispatch when no path node listens for the type" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    const leaf = try doc.createElement("leaf");
+    _ = try root.prototype.appendChild(&leaf.prototype);
+
+    const State = struct {
+        var calls: u32 = 0;
+
+        fn count(_: *Event, _: *anyopaque) void {
+            calls += 1;
+        }
+    };
+    State.calls = 0;
+    try root.prototype.addEventListener("ping", State.count, undefined, false, false, false, null);
+
+    // Another type: no listener runs and the event is left idle
+    var other = Event.init("pong", .{ .bubbles = true, .cancelable = true });
+    try std.testing.expect(try leaf.prototype.dispatchEvent(&other));
+    try std.testing.expect(!other.dispatch_flag);
+    try std.testing.expectEqual(Event.EventPhase.none, other.event_phase);
+    try std.testing.expectEqual(@as(u32, 0), State.calls);
+
+    var ping = Event.init("ping", .{ .bubbles = true });
+    _ = try leaf.prototype.dispatchEvent(&ping);
+    try std.testing.expectEqual(@as(u32, 1), State.calls);
+}
+
+test "Node.dispatchEvent - listener added to an ancestor during dispatch runs" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    const leaf = try doc.createElement("leaf");
+    _ = try root.prototype.appendChild(&leaf.prototype);
+
+    const State = struct {
+        var root_calls: u32 = 0;
+
+        fn onRoot(_: *Event, _: *anyopaque) void {
+            root_calls += 1;
+        }
+
+        fn onLeaf(_: *Event, context: *anyopaque) void {
+            const ancestor: *Node = @ptrCast(@alignCast(context));
+            ancestor.addEventListener("ping", onRoot, undefined, false, false, false, null) catch {};
+        }
+    };
+    State.root_calls = 0;
+
+    // root has no listener when the path is built
+    try leaf.prototype.addEventListener("ping", State.onLeaf, @ptrCast(&root.prototype), false, false, false, null);
+
+    var event = Event.init("ping", .{ .bubbles = true });
+    _ = try leaf.prototype.dispatchEvent(&event);
+    try std.testing.expectEqual(@as(u32, 1), State.root_calls);
+}
+
+test "Node.dispatchEvent - bubbling reuses the document event path buffer" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    // root > item > item > leaf
+    var parent = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&parent.prototype);
+    var depth: usize = 0;
+    while (depth < 3) : (depth += 1) {
+        const child = try doc.createElement(if (depth == 2) "leaf" else "item");
+        _ = try parent.prototype.appendChild(&child.prototype);
+        parent = child;
+    }
+    const leaf = parent;
+
+    var event1 = Event.init("ping", .{ .bubbles = true });
+    _ = try leaf.prototype.dispatchEvent(&event1);
+
+    // The path (leaf, 2 items, root, document) is kept for the next dispatch
+    const buffer = doc.event_path_buffer.items.ptr;
+    try std.testing.expect(doc.event_path_buffer.capacity >= 5);
+    try std.testing.expect(event1.event_path == null);
+
+    var event2 = Event.init("ping", .{ .bubbles = true });
+    _ = try leaf.prototype.dispatchEvent(&event2);
+    try std.testing.expectEqual(buffer, doc.event_path_buffer.items.ptr);
+}
+
 test "Event.composedPath - respects composed flag with shadow DOM" {
     const allocator = std.testing.allocator;
 
@@ -2672,6 +3004,77 @@ test "Node.normalize - handles document fragments" {
     try std.testing.expectEqualStrings("Fragment", merged_text.data);
 }
 
+test "Node.normalize - one record pair per merged run" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+
+    const t1 = try doc.createTextNode("ab");
+    const t2 = try doc.createTextNode("cd");
+    const leaf = try doc.createElement("leaf");
+    const t3 = try doc.createTextNode("");
+    const t4 = try doc.createTextNode("ef");
+    const t5 = try doc.createTextNode("gh");
+    const t6 = try doc.createTextNode("ij");
+    _ = try root.prototype.appendChild(&t1.prototype);
+    _ = try root.prototype.appendChild(&t2.prototype);
+    _ = try root.prototype.appendChild(&leaf.prototype);
+    _ = try root.prototype.appendChild(&t3.prototype);
+    _ = try root.prototype.appendChild(&t4.prototype);
+    _ = try root.prototype.appendChild(&t5.prototype);
+    _ = try root.prototype.appendChild(&t6.prototype);
+
+    const range = try doc.createRange();
+    defer range.deinit();
+    try range.setStart(&t6.prototype, 1);
+    try range.setEnd(&root.prototype, 7);
+
+    const observer = try dom.MutationObserver.init(allocator, struct {
+        fn callback(_: []const *dom.MutationRecord, _: *dom.MutationObserver, _: ?*anyopaque) void {}
+    }.callback, null);
+    defer observer.deinit();
+    try observer.observe(&root.prototype, .{
+        .child_list = true,
+        .character_data = true,
+        .character_data_old_value = true,
+        .subtree = true,
+    });
+
+    try root.prototype.normalize();
+
+    try std.testing.expectEqual(@as(usize, 3), root.prototype.childNodes().length());
+    try std.testing.expectEqualStrings("abcd", t1.data);
+    try std.testing.expectEqualStrings("efghij", t4.data);
+    try std.testing.expect(t4.prototype.next_sibling == null);
+
+    // Boundary points follow the merged data and the shorter child list
+    try std.testing.expect(range.start_container == &t4.prototype);
+    try std.testing.expectEqual(@as(u32, 5), range.start_offset);
+    try std.testing.expect(range.end_container == &root.prototype);
+    try std.testing.expectEqual(@as(u32, 3), range.end_offset);
+
+    const records = observer.takeRecords();
+    defer {
+        for (records) |record| record.deinit();
+        allocator.free(records);
+    }
+    try std.testing.expectEqual(@as(usize, 5), records.len);
+    try std.testing.expectEqualStrings("characterData", records[0].type);
+    try std.testing.expectEqualStrings("ab", records[0].old_value.?);
+    try std.testing.expectEqualStrings("childList", records[2].type);
+    try std.testing.expectEqual(@as(usize, 1), records[2].removed_nodes.items.len);
+    try std.testing.expectEqualStrings("ef", records[3].old_value.?);
+
+    // The last run is unlinked with one record listing both nodes
+    try std.testing.expectEqual(@as(usize, 2), records[4].removed_nodes.items.len);
+    try std.testing.expect(records[4].previous_sibling == &t4.prototype);
+    try std.testing.expect(records[4].next_sibling == null);
+}
+
 // ============================================================================
 // Namespace Lookup Methods Tests
 // ============================================================================
@@ -2940,3 +3343,55 @@ test "Node.lookupNamespaceURI returns null for DocumentFragment" {
     const ns = fragment.prototype.lookupNamespaceURI("svg");
     try std.testing.expect(ns == null);
 }
+
+test "Node.generation changes when the child list changes" {
+    const allocator = std.testing.allocator;
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const parent = try doc.createElement("root");
+    defer parent.prototype.release();
+
+    var last = parent.prototype.generation;
+
+    const child = try doc.createElement("item");
+    _ = try parent.prototype.appendChild(&child.prototype);
+    try std.testing.expect(parent.prototype.generation != last);
+    last = parent.prototype.generation;
+
+    const other = try doc.createElement("item");
+    _ = try parent.prototype.insertBefore(&other.prototype, &child.prototype);
+    try std.testing.expect(parent.prototype.generation != last);
+    last = parent.prototype.generation;
+
+    const removed = try parent.prototype.removeChild(&child.prototype);
+    removed.release();
+    try std.testing.expect(parent.prototype.generation != last);
+}
+
+test "Node.selfBytes counts character data and heap attribute storage" {
+    const allocator = std.testing.allocator;
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const text = try doc.createTextNode("content");
+    defer text.prototype.release();
+    try std.testing.expect(text.prototype.selfBytes() >= @sizeOf(Text) + "content".len);
+
+    const elem = try doc.createElement("element");
+    defer elem.prototype.release();
+    const bare = elem.prototype.selfBytes();
+    try std.testing.expect(bare >= @sizeOf(Element));
+
+    // Past the inline slots attributes move to the heap
+    const names = [_][]const u8{ "a1", "a2", "a3", "a4", "a5", "a6" };
+    for (names) |name| try elem.setAttribute(name, "value");
+    try std.testing.expect(elem.prototype.selfBytes() > bare);
+
+    // Children are not part of a node's own size
+    const child = try doc.createElement("item");
+    _ = try elem.prototype.appendChild(&child.prototype);
+    const with_attributes = elem.prototype.selfBytes();
+    _ = try child.prototype.ensureRareData();
+    try std.testing.expectEqual(with_attributes, elem.prototype.selfBytes());
+}
@@ -0,0 +1,167 @@
+//! parallel_query Tests
+//!
+//! Tests for Document.enableParallelQueries(): queries split across a pool
+//! must return what the sequential query returns, in the same order, with
+//! and without the compact layout.
+
+const std = @import("std");
+const dom = @import("dom");
+
+const testing = std.testing;
+const Document = dom.Document;
+const Element = dom.Element;
+
+const selectors = [_][]const u8{ "*", "row", ".even", "row > cell", "list .odd", "[data-x]", "cell.even", "root", "#e7", "leaf" };
+
+/// Lists of rows of cells, with a deeper leaf now and then.
+fn build(doc: *Document) !void {
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+
+    var id_buffer: [16]u8 = undefined;
+    var next_id: usize = 0;
+    for (0..3) |l| {
+        const list = try doc.createElement("list");
+        _ = try root.prototype.appendChild(&list.prototype);
+        for (0..7) |r| {
+            const row = try doc.createElement("row");
+            try row.setAttribute("id", try std.fmt.bufPrint(&id_buffer, "e{d}", .{next_id}));
+            next_id += 1;
+            _ = try list.prototype.appendChild(&row.prototype);
+            for (0..4) |c| {
+                const cell = try doc.createElement("cell");
+                try cell.setAttribute("id", try std.fmt.bufPrint(&id_buffer, "e{d}", .{next_id}));
+                next_id += 1;
+                try cell.setAttribute("class", if ((l + r + c) % 2 == 0) "even" else "odd");
+                if (c == 1) try cell.setAttribute("data-x", "1");
+                _ = try row.prototype.appendChild(&cell.prototype);
+                _ = try cell.prototype.appendChild(&(try doc.createTextNode("line")).prototype);
+                if (r % 3 == 0 and c == 3) {
+                    const leaf = try doc.createElement("leaf");
+                    try leaf.setAttribute("id", try std.fmt.bufPrint(&id_buffer, "e{d}", .{next_id}));
+                    next_id += 1;
+                    _ = try cell.prototype.appendChild(&leaf.prototype);
+                }
+            }
+        }
+    }
+}
+
+fn expectSameResults(sequential: *Document, parallel: *Document) !void {
+    const allocator = testing.allocator;
+    for (selectors) |selector| {
+        const expected = try sequential.querySelectorAll(selector);
+        defer allocator.free(expected);
+        const actual = try parallel.querySelectorAll(selector);
+        defer allocator.free(actual);
+
+        try testing.expectEqual(expected.len, actual.len);
+        for (expected, actual) |e, a| {
+            try testing.expectEqualStrings(e.tag_name, a.tag_name);
+            try testing.expectEqualStrings(e.getAttribute("id") orelse "", a.getAttribute("id") orelse "");
+        }
+    }
+}
+
+test "parallel query - matches sequential results in tree order" {
+    const allocator = testing.allocator;
+
+    var pool: std.Thread.Pool = undefined;
+    try pool.init(.{ .allocator = allocator, .n_jobs = 3 });
+    defer pool.deinit();
+
+    const sequential = try Document.init(allocator);
+    defer sequential.release();
+    const parallel = try Document.init(allocator);
+    defer parallel.release();
+    parallel.enableParallelQueries(&pool, 1);
+
+    try build(sequential);
+    try build(parallel);
+    try parallel.freeze();
+    try expectSameResults(sequential, parallel);
+}
+
+test "parallel query - compact layout ranges" {
+    const allocator = testing.allocator;
+
+    var pool: std.Thread.Pool = undefined;
+    try pool.init(.{ .allocator = allocator, .n_jobs = 3 });
+    defer pool.deinit();
+
+    const sequential = try Document.init(allocator);
+    defer sequential.release();
+    const parallel = try Document.init(allocator);
+    defer parallel.release();
+    try parallel.enableCompactLayout();
+    parallel.enableParallelQueries(&pool, 1);
+
+    try build(sequential);
+    try build(parallel);
+    try parallel.freeze();
+    try expectSameResults(sequential, parallel);
+}
+
+test "parallel query - narrow deep tree is split below the root" {
+    const allocator = testing.allocator;
+
+    var pool: std.Thread.Pool = undefined;
+    try pool.init(.{ .allocator = allocator, .n_jobs = 2 });
+    defer pool.deinit();
+
+    // A single chain down to a wide level
+    const docs = [_]*Document{ try Document.init(allocator), try Document.init(allocator) };
+    defer for (docs) |doc| doc.release();
+    docs[1].enableParallelQueries(&pool, 1);
+
+    for (docs) |doc| {
+        var parent = &doc.prototype;
+        for ([_][]const u8{ "root", "list", "row" }) |name| {
+            const elem = try doc.createElement(name);
+            _ = try parent.appendChild(&elem.prototype);
+            parent = &elem.prototype;
+        }
+        for (0..40) |i| {
+            const cell = try doc.createElement("cell");
+            if (i % 3 == 0) try cell.setAttribute("class", "even");
+            _ = try parent.appendChild(&cell.prototype);
+        }
+    }
+    try docs[1].freeze();
+
+    for ([_][]const u8{ "*", ".even", "row > cell", "root list" }) |selector| {
+        const expected = try docs[0].querySelectorAll(selector);
+        defer allocator.free(expected);
+        const actual = try docs[1].querySelectorAll(selector);
+        defer allocator.free(actual);
+        try testing.expectEqual(expected.len, actual.len);
+        for (expected, actual) |e, a| {
+            try testing.expectEqualStrings(e.tag_name, a.tag_name);
+            try testing.expectEqual(e.hasAttribute("class"), a.hasAttribute("class"));
+        }
+    }
+}
+
+test "parallel query - sequential below the threshold and before freezing" {
+    const allocator = testing.allocator;
+
+    var pool: std.Thread.Pool = undefined;
+    try pool.init(.{ .allocator = allocator, .n_jobs = 2 });
+    defer pool.deinit();
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+    doc.enableParallelQueries(&pool, 1_000_000);
+    try build(doc);
+
+    try testing.expect(!doc.parallel_query.?.engages(doc));
+    try doc.freeze();
+    try testing.expect(!doc.parallel_query.?.engages(doc));
+
+    doc.enableParallelQueries(&pool, 1);
+    try testing.expect(doc.parallel_query.?.engages(doc));
+
+    const rows = try doc.querySelectorAll("row");
+    defer allocator.free(rows);
+    try testing.expectEqual(@as(usize, 21), rows.len);
+}
@@ -206,3 +206,61 @@ test "Parser - complex selector chain" {
     try testing.expectEqual(Combinator.Descendant, complex.combinators[1].combinator);
 }
 
+
+test "Parser - parseCompact builds the list in one allocation" {
+    var counting = std.testing.FailingAllocator.init(testing.allocator, .{});
+    const allocator = counting.allocator();
+
+    var tokenizer = Tokenizer.init(allocator, "root > item.active[data-state^=on]:not(.hidden), leaf:has(cell)");
+    var parser = try Parser.init(allocator, &tokenizer);
+    defer parser.deinit();
+
+    var selector_list = try parser.parseCompact();
+    try testing.expectEqual(@as(usize, 1), counting.allocations);
+
+    try testing.expectEqual(@as(usize, 2), selector_list.selectors.len);
+    const complex = selector_list.selectors[0];
+    try testing.expectEqualStrings("root", complex.compound.simple_selectors[0].Type.tag_name);
+    try testing.expectEqual(@as(usize, 1), complex.combinators.len);
+    try testing.expectEqual(Combinator.Child, complex.combinators[0].combinator);
+
+    const compound = complex.combinators[0].compound;
+    try testing.expectEqual(@as(usize, 4), compound.simple_selectors.len);
+    try testing.expectEqualStrings("active", compound.simple_selectors[1].Class.class_name);
+    try testing.expectEqualStrings("on", compound.simple_selectors[2].Attribute.matcher.Prefix.value);
+    const negated = compound.simple_selectors[3].PseudoClass.kind.Not;
+    try testing.expectEqualStrings("hidden", negated.selectors[0].compound.simple_selectors[0].Class.class_name);
+
+    const has = selector_list.selectors[1].compound.simple_selectors[1].PseudoClass.kind.Has;
+    try testing.expectEqualStrings("cell", has.selectors[0].compound.simple_selectors[0].Type.tag_name);
+
+    selector_list.deinit();
+    try testing.expectEqual(@as(usize, 1), counting.deallocations);
+}
+
+test "Parser - parseCompact falls back for long selectors" {
+    const allocator = testing.allocator;
+
+    // Past the measured size bound: parsed node by node
+    var selector: [600]u8 = undefined;
+    for (0..100) |i| @memcpy(selector[i * 6 ..][0..6], "item, ");
+    var tokenizer = Tokenizer.init(allocator, selector[0 .. selector.len - 2]);
+    var parser = try Parser.init(allocator, &tokenizer);
+    defer parser.deinit();
+
+    var selector_list = try parser.parseCompact();
+    defer selector_list.deinit();
+
+    try testing.expect(selector_list.block == null);
+    try testing.expectEqual(@as(usize, 100), selector_list.selectors.len);
+}
+
+test "Parser - parseCompact reports invalid selectors" {
+    const allocator = testing.allocator;
+
+    var tokenizer = Tokenizer.init(allocator, "item > .");
+    var parser = try Parser.init(allocator, &tokenizer);
+    defer parser.deinit();
+
+    try testing.expectError(error.InvalidSelector, parser.parseCompact());
+}
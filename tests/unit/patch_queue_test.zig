@@ -0,0 +1,132 @@
+//! patch_queue Tests
+//!
+//! Tests for Document.submitPatch/drainPatches: submission order, one
+//! wakeup per batch, concurrent producers and rejected patches.
+
+const std = @import("std");
+const dom = @import("dom");
+
+const testing = std.testing;
+const tree_diff = dom.tree_diff;
+const Document = dom.Document;
+const Element = dom.Element;
+
+/// A list with a single row; class "selected" on the row if selected.
+fn buildList(doc: *Document, selected: bool) !*Element {
+    const list = try doc.createElement("list");
+    const row = try doc.createElement("row");
+    if (selected) try row.setAttribute("class", "selected");
+    _ = try list.prototype.appendChild(&row.prototype);
+    return list;
+}
+
+/// Patches selecting and unselecting the row of a list built as above.
+const Patches = struct {
+    select: tree_diff.PatchBuffer,
+    unselect: tree_diff.PatchBuffer,
+
+    fn init(doc: *Document) !Patches {
+        const allocator = testing.allocator;
+        const plain = try buildList(doc, false);
+        defer plain.prototype.release();
+        const selected = try buildList(doc, true);
+        defer selected.prototype.release();
+
+        const select = try tree_diff.diff(allocator, &plain.prototype, &selected.prototype, .{});
+        errdefer tree_diff.freePatch(allocator, select);
+        return .{
+            .select = select,
+            .unselect = try tree_diff.diff(allocator, &selected.prototype, &plain.prototype, .{}),
+        };
+    }
+
+    fn deinit(self: Patches) void {
+        tree_diff.freePatch(testing.allocator, self.select);
+        tree_diff.freePatch(testing.allocator, self.unselect);
+    }
+};
+
+test "patch_queue - drain applies patches in submission order" {
+    const allocator = testing.allocator;
+    const doc = try Document.init(allocator);
+    defer doc.release();
+    const patches = try Patches.init(doc);
+    defer patches.deinit();
+
+    const list = try buildList(doc, false);
+    defer list.prototype.release();
+    const row = list.firstElementChild().?;
+    const targets = [_]*dom.Node{ &list.prototype, &row.prototype };
+
+    // Only the first submission of a batch asks for a wakeup
+    try testing.expect(try doc.submitPatch(allocator, patches.select, &targets, &.{}));
+    try testing.expect(!try doc.submitPatch(allocator, patches.unselect, &targets, &.{}));
+    try testing.expect(!try doc.submitPatch(allocator, patches.select, &targets, &.{}));
+    try testing.expect(row.getAttribute("class") == null);
+
+    const result = doc.drainPatches(allocator);
+    try testing.expectEqual(@as(usize, 3), result.drained);
+    try testing.expect(result.first_error == null);
+    try testing.expectEqualStrings("selected", row.getAttribute("class").?);
+
+    // Drained: the next submission starts a new batch
+    try testing.expectEqual(@as(usize, 0), doc.drainPatches(allocator).drained);
+    try testing.expect(try doc.submitPatch(allocator, patches.unselect, &targets, &.{}));
+    // Freed undrained when the document goes away
+}
+
+test "patch_queue - concurrent producers share one batch" {
+    const allocator = testing.allocator;
+    const doc = try Document.init(allocator);
+    defer doc.release();
+    const patches = try Patches.init(doc);
+    defer patches.deinit();
+
+    const list = try buildList(doc, false);
+    defer list.prototype.release();
+    const targets = [_]*dom.Node{ &list.prototype, &list.firstElementChild().?.prototype };
+
+    const per_thread = 32;
+    const Producer = struct {
+        fn run(document: *Document, patch: []const u8, nodes: []const *dom.Node, wakeups: *std.atomic.Value(usize)) void {
+            for (0..per_thread) |_| {
+                const first = document.submitPatch(testing.allocator, patch, nodes, &.{}) catch unreachable;
+                if (first) _ = wakeups.fetchAdd(1, .monotonic);
+            }
+        }
+    };
+
+    var wakeups = std.atomic.Value(usize).init(0);
+    var threads: [4]std.Thread = undefined;
+    for (&threads) |*thread| {
+        thread.* = try std.Thread.spawn(.{}, Producer.run, .{ doc, patches.select, &targets, &wakeups });
+    }
+    for (threads) |thread| thread.join();
+
+    try testing.expectEqual(@as(usize, 1), wakeups.load(.monotonic));
+    const result = doc.drainPatches(allocator);
+    try testing.expectEqual(@as(usize, threads.len * per_thread), result.drained);
+    try testing.expect(result.first_error == null);
+}
+
+test "patch_queue - invalid patches are rejected at submission" {
+    const allocator = testing.allocator;
+    const doc = try Document.init(allocator);
+    defer doc.release();
+    const patches = try Patches.init(doc);
+    defer patches.deinit();
+
+    const list = try buildList(doc, false);
+    defer list.prototype.release();
+    const targets = [_]*dom.Node{&list.prototype};
+
+    const truncated = patches.select[0 .. patches.select.len - 4];
+    try testing.expectError(error.SyntaxError, doc.submitPatch(allocator, truncated, &targets, &.{}));
+    try testing.expectEqual(@as(usize, 0), doc.drainPatches(allocator).drained);
+
+    // Indices are checked when the patch runs: row 1 is outside the table
+    _ = try doc.submitPatch(allocator, patches.select, &targets, &.{});
+    const result = doc.drainPatches(allocator);
+    try testing.expectEqual(@as(usize, 1), result.drained);
+    try testing.expectEqual(@as(anyerror, error.IndexSizeError), result.first_error.?);
+}
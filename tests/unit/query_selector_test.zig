@@ -469,6 +469,28 @@ test "Element.matches - universal selector" {
 // Element.closest() Tests
 // ============================================================================
 
+test "Element.matches - parsed selectors outlive their document" {
+    const allocator = testing.allocator;
+
+    // Freed through its own allocator after the document is gone (the
+    // testing allocator reports a leak or a double free otherwise)
+    const doc = try Document.init(allocator);
+    const parsed = try doc.selector_cache.acquire("row > .item");
+    doc.release();
+    defer parsed.release();
+
+    const other = try Document.init(allocator);
+    defer other.release();
+    const row = try other.createElement("row");
+    _ = try other.prototype.appendChild(&row.prototype);
+    const item = try other.createElement("item");
+    try item.setAttribute("class", "item");
+    _ = try row.prototype.appendChild(&item.prototype);
+
+    try testing.expect(try item.matchesParsed(allocator, parsed));
+    try testing.expect(!try row.matchesParsed(allocator, parsed));
+}
+
 test "Element.closest - matches self" {
     const allocator = testing.allocator;
 
@@ -1025,3 +1047,140 @@ test "querySelector - :has() relational pseudo-class" {
     try testing.expect(result != null);
     try testing.expect(result.? == section1);
 }
+
+test "querySelector - selector list returns the first match in tree order" {
+    const allocator = testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+
+    const list = try doc.createElement("list");
+    _ = try root.prototype.appendChild(&list.prototype);
+    const row = try doc.createElement("row");
+    _ = try list.prototype.appendChild(&row.prototype);
+    const leaf = try doc.createElement("leaf");
+    try leaf.setAttribute("class", "late");
+    _ = try root.prototype.appendChild(&leaf.prototype);
+    const item = try doc.createElement("item");
+    try item.setAttribute("id", "last");
+    _ = try root.prototype.appendChild(&item.prototype);
+
+    // Alternatives listed against tree order: the earliest element wins
+    const first = try root.querySelector(allocator, "#last, .late, list > row");
+    try testing.expect(first.? == row);
+
+    const rest = try root.querySelector(allocator, "#last, .late, list > leaf");
+    try testing.expect(rest.? == leaf);
+
+    const all = try root.querySelectorAll(allocator, "#last, .late, list > row, row");
+    defer allocator.free(all);
+    try testing.expectEqual(@as(usize, 3), all.len);
+    try testing.expect(all[0] == row);
+    try testing.expect(all[1] == leaf);
+    try testing.expect(all[2] == item);
+}
+
+test "querySelectorAll - nested :has() answers each subtree once" {
+    const allocator = testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+
+    // A chain of 50 nested items with one leaf at the bottom
+    var parent = root;
+    var i: usize = 0;
+    while (i < 50) : (i += 1) {
+        const item = try doc.createElement("item");
+        _ = try parent.prototype.appendChild(&item.prototype);
+        parent = item;
+    }
+    const leaf = try doc.createElement("leaf");
+    _ = try parent.prototype.appendChild(&leaf.prototype);
+
+    const all = try root.querySelectorAll(allocator, "item:has(leaf)");
+    defer allocator.free(all);
+    try testing.expectEqual(@as(usize, 50), all.len);
+
+    // One answer per element below the query root, not per pair
+    try testing.expect(doc.has_cache.count() <= 52);
+}
+
+test "querySelectorAll - :has() answers follow mutations" {
+    const allocator = testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    const row1 = try doc.createElement("row");
+    _ = try root.prototype.appendChild(&row1.prototype);
+    const row2 = try doc.createElement("row");
+    _ = try root.prototype.appendChild(&row2.prototype);
+
+    const cell = try doc.createElement("cell");
+    _ = try row1.prototype.appendChild(&cell.prototype);
+
+    const before = try root.querySelectorAll(allocator, "row:has(cell.active)");
+    defer allocator.free(before);
+    try testing.expectEqual(@as(usize, 0), before.len);
+
+    // Attribute change below a cached answer
+    try cell.setAttribute("class", "active");
+    const after_attr = try root.querySelectorAll(allocator, "row:has(cell.active)");
+    defer allocator.free(after_attr);
+    try testing.expectEqual(@as(usize, 1), after_attr.len);
+    try testing.expect(after_attr[0] == row1);
+
+    // Child list change below a cached answer
+    const other = try doc.createElement("cell");
+    try other.setAttribute("class", "active");
+    _ = try row2.prototype.appendChild(&other.prototype);
+    const after_append = try root.querySelectorAll(allocator, "row:has(cell.active)");
+    defer allocator.free(after_append);
+    try testing.expectEqual(@as(usize, 2), after_append.len);
+
+    _ = try row1.prototype.removeChild(&cell.prototype);
+    defer cell.prototype.release();
+    const after_remove = try root.querySelectorAll(allocator, "row:has(cell.active)");
+    defer allocator.free(after_remove);
+    try testing.expectEqual(@as(usize, 1), after_remove.len);
+    try testing.expect(after_remove[0] == row2);
+}
+
+test "querySelectorAll - :has() with prefix and substring attribute arguments" {
+    const allocator = testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    const row1 = try doc.createElement("row");
+    _ = try root.prototype.appendChild(&row1.prototype);
+    const row2 = try doc.createElement("row");
+    _ = try root.prototype.appendChild(&row2.prototype);
+
+    const cell1 = try doc.createElement("cell");
+    try cell1.setAttribute("data-state", "open-pending");
+    _ = try row1.prototype.appendChild(&cell1.prototype);
+    const cell2 = try doc.createElement("cell");
+    try cell2.setAttribute("data-state", "closed");
+    _ = try row2.prototype.appendChild(&cell2.prototype);
+
+    const prefix = try root.querySelectorAll(allocator, "row:has([data-state^=open])");
+    defer allocator.free(prefix);
+    try testing.expectEqual(@as(usize, 1), prefix.len);
+    try testing.expect(prefix[0] == row1);
+
+    const substring = try root.querySelectorAll(allocator, "row:has([data-state*=lose])");
+    defer allocator.free(substring);
+    try testing.expectEqual(@as(usize, 1), substring.len);
+    try testing.expect(substring[0] == row2);
+}
@@ -300,6 +300,36 @@ test "Range: commonAncestorContainer - different nodes with common parent" {
     try std.testing.expect(ancestor == &parent.prototype);
 }
 
+test "Range: commonAncestorContainer - boundaries at different depths" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    // root > (list > item > leaf), (row)
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    const list = try doc.createElement("list");
+    const item = try doc.createElement("item");
+    const leaf = try doc.createElement("leaf");
+    const row = try doc.createElement("row");
+    _ = try root.prototype.appendChild(&list.prototype);
+    _ = try list.prototype.appendChild(&item.prototype);
+    _ = try item.prototype.appendChild(&leaf.prototype);
+    _ = try root.prototype.appendChild(&row.prototype);
+
+    const range = try doc.createRange();
+    defer range.deinit();
+
+    try range.setStart(&leaf.prototype, 0);
+    try range.setEnd(&row.prototype, 0);
+    try std.testing.expect(range.commonAncestorContainer() == &root.prototype);
+
+    try range.setStart(&list.prototype, 0);
+    try range.setEnd(&leaf.prototype, 0);
+    try std.testing.expect(range.commonAncestorContainer() == &list.prototype);
+}
+
 test "Range: compareBoundaryPoints - START_TO_START equal" {
     const allocator = std.testing.allocator;
 
@@ -1040,6 +1070,72 @@ test "Range: extractContents - different containers with mixed content" {
     try std.testing.expect(fragment_count >= 1); // At least the elem and partial texts
 }
 
+test "Range: extractContents - contained children move in one record" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+
+    const first = try doc.createTextNode("ab");
+    _ = try root.prototype.appendChild(&first.prototype);
+    var items: [4]*Element = undefined;
+    for (&items) |*item| {
+        item.* = try doc.createElement("item");
+        _ = try root.prototype.appendChild(&item.*.prototype);
+    }
+    const last = try doc.createTextNode("cd");
+    _ = try root.prototype.appendChild(&last.prototype);
+
+    const leaf = try doc.createElement("leaf");
+    _ = try items[2].prototype.appendChild(&leaf.prototype);
+
+    // A second live range inside the run and one past it
+    const inner = try doc.createRange();
+    defer inner.deinit();
+    try inner.setStart(&leaf.prototype, 0);
+    try inner.setEnd(&root.prototype, 6);
+
+    const observer = try dom.MutationObserver.init(allocator, struct {
+        fn callback(_: []const *dom.MutationRecord, _: *dom.MutationObserver, _: ?*anyopaque) void {}
+    }.callback, null);
+    defer observer.deinit();
+    try observer.observe(&root.prototype, .{ .child_list = true, .subtree = true });
+
+    const range = try doc.createRange();
+    defer range.deinit();
+    try range.setStart(&first.prototype, 1);
+    try range.setEnd(&last.prototype, 1);
+
+    const fragment = try range.extractContents();
+    defer fragment.prototype.release();
+
+    // "b", the four items, "c"
+    try std.testing.expectEqual(@as(usize, 6), fragment.prototype.childNodes().length());
+    try std.testing.expect(fragment.prototype.first_child.?.next_sibling == &items[0].prototype);
+    try std.testing.expect(items[3].prototype.parent_node == &fragment.prototype);
+    try std.testing.expectEqual(@as(usize, 2), root.prototype.childNodes().length());
+
+    // Boundary points in and past the run end up where the run was
+    try std.testing.expect(inner.start_container == &root.prototype);
+    try std.testing.expectEqual(@as(u32, 1), inner.start_offset);
+    try std.testing.expect(inner.end_container == &root.prototype);
+    try std.testing.expectEqual(@as(u32, 2), inner.end_offset);
+
+    const records = observer.takeRecords();
+    defer {
+        for (records) |record| record.deinit();
+        allocator.free(records);
+    }
+    try std.testing.expectEqual(@as(usize, 1), records.len);
+    try std.testing.expectEqualStrings("childList", records[0].type);
+    try std.testing.expectEqual(@as(usize, 4), records[0].removed_nodes.items.len);
+    try std.testing.expect(records[0].previous_sibling == &first.prototype);
+    try std.testing.expect(records[0].next_sibling == &last.prototype);
+}
+
 test "Range: cloneContents - different containers with mixed content" {
     const allocator = std.testing.allocator;
 
@@ -1588,3 +1684,291 @@ test "Range: toString - element-only range (no text)" {
 }
 
 // Phase 5 complete: 8 tests for toString() ✅
+
+// Phase 6: Live Range Updates (7 tests)
+
+test "Range: live - insertion before boundary shifts offsets" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    const first = try doc.createElement("item");
+    _ = try root.prototype.appendChild(&first.prototype);
+    const second = try doc.createElement("item");
+    _ = try root.prototype.appendChild(&second.prototype);
+
+    const range = try doc.createRange();
+    defer range.deinit();
+    try range.setStart(&root.prototype, 1);
+    try range.setEnd(&root.prototype, 2);
+
+    // Inserting at index 0 moves both boundaries right
+    const head = try doc.createElement("item");
+    _ = try root.prototype.insertBefore(&head.prototype, &first.prototype);
+    try std.testing.expectEqual(@as(u32, 2), range.start_offset);
+    try std.testing.expectEqual(@as(u32, 3), range.end_offset);
+
+    // Appending leaves them alone
+    const tail = try doc.createElement("item");
+    _ = try root.prototype.appendChild(&tail.prototype);
+    try std.testing.expectEqual(@as(u32, 2), range.start_offset);
+    try std.testing.expectEqual(@as(u32, 3), range.end_offset);
+}
+
+test "Range: live - removal moves boundaries out of removed subtree" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    const first = try doc.createElement("item");
+    _ = try root.prototype.appendChild(&first.prototype);
+    const second = try doc.createElement("item");
+    _ = try root.prototype.appendChild(&second.prototype);
+    const text = try doc.createTextNode("Hello");
+    _ = try second.prototype.appendChild(&text.prototype);
+
+    const range = try doc.createRange();
+    defer range.deinit();
+    try range.setStart(&text.prototype, 1);
+    try range.setEnd(&root.prototype, 2);
+
+    const removed = try root.prototype.removeChild(&second.prototype);
+    defer removed.release();
+
+    // Start was inside the removed item: now (root, 1). End was after it: 2 - 1
+    try std.testing.expect(range.start_container == &root.prototype);
+    try std.testing.expectEqual(@as(u32, 1), range.start_offset);
+    try std.testing.expect(range.end_container == &root.prototype);
+    try std.testing.expectEqual(@as(u32, 1), range.end_offset);
+}
+
+test "Range: live - character data edits adjust offsets" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const text = try doc.createTextNode("Hello World");
+    _ = try doc.prototype.appendChild(&text.prototype);
+
+    const range = try doc.createRange();
+    defer range.deinit();
+    try range.setStart(&text.prototype, 6);
+    try range.setEnd(&text.prototype, 11);
+
+    // Insert before the range: both move right
+    try text.insertData(0, ">> ");
+    try std.testing.expectEqual(@as(u32, 9), range.start_offset);
+    try std.testing.expectEqual(@as(u32, 14), range.end_offset);
+
+    // Delete across the start: start clamps to the deletion point
+    try text.deleteData(5, 6);
+    try std.testing.expectEqual(@as(u32, 5), range.start_offset);
+    try std.testing.expectEqual(@as(u32, 8), range.end_offset);
+}
+
+test "Range: live - splitText moves boundaries into new node" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    const text = try doc.createTextNode("HelloWorld");
+    _ = try root.prototype.appendChild(&text.prototype);
+
+    const range = try doc.createRange();
+    defer range.deinit();
+    try range.setStart(&text.prototype, 2);
+    try range.setEnd(&text.prototype, 8);
+
+    const tail = try text.splitText(5);
+
+    try std.testing.expect(range.start_container == &text.prototype);
+    try std.testing.expectEqual(@as(u32, 2), range.start_offset);
+    try std.testing.expect(range.end_container == &tail.prototype);
+    try std.testing.expectEqual(@as(u32, 3), range.end_offset);
+}
+
+test "Range: live - normalize merges boundaries into first text node" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    const first = try doc.createTextNode("Hello");
+    _ = try root.prototype.appendChild(&first.prototype);
+    const second = try doc.createTextNode("World");
+    _ = try root.prototype.appendChild(&second.prototype);
+
+    const range = try doc.createRange();
+    defer range.deinit();
+    try range.setStart(&root.prototype, 1);
+    try range.setEnd(&second.prototype, 3);
+
+    try root.prototype.normalize();
+
+    try std.testing.expect(range.start_container == &first.prototype);
+    try std.testing.expectEqual(@as(u32, 5), range.start_offset);
+    try std.testing.expect(range.end_container == &first.prototype);
+    try std.testing.expectEqual(@as(u32, 8), range.end_offset);
+}
+
+test "Range: live - destroyed container stops updates" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const text = try doc.createTextNode("detached");
+
+    const range = try doc.createRange();
+    defer range.deinit();
+    try range.setStart(&text.prototype, 2);
+    try range.setEnd(&text.prototype, 4);
+    try std.testing.expect(range.live);
+
+    // Destroying the container unlists the range instead of leaving it dangling
+    text.prototype.release();
+    try std.testing.expect(!range.live);
+}
+
+test "Range: live - ranges made on another thread keep updating" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    // Build the tree and its range on a worker, then hand them over
+    const Built = struct {
+        root: *Element = undefined,
+        item: *Element = undefined,
+        range: *Range = undefined,
+        err: ?anyerror = null,
+
+        fn run(self: *@This(), document: *Document) void {
+            self.build(document) catch |err| {
+                self.err = err;
+            };
+        }
+
+        fn build(self: *@This(), document: *Document) !void {
+            self.root = try document.createElement("root");
+            _ = try document.prototype.appendChild(&self.root.prototype);
+            self.item = try document.createElement("item");
+            _ = try self.root.prototype.appendChild(&self.item.prototype);
+            const text = try document.createTextNode("Hello");
+            _ = try self.item.prototype.appendChild(&text.prototype);
+
+            self.range = try document.createRange();
+            try self.range.setStart(&text.prototype, 1);
+            try self.range.setEnd(&text.prototype, 3);
+        }
+    };
+
+    var built: Built = .{};
+    const worker = try std.Thread.spawn(.{}, Built.run, .{ &built, doc });
+    worker.join();
+    if (built.err) |err| return err;
+    defer built.range.deinit();
+
+    // This thread never made a range, yet removal still moves the boundaries
+    const removed = try built.root.prototype.removeChild(&built.item.prototype);
+    defer removed.release();
+    try std.testing.expect(built.range.start_container == &built.root.prototype);
+    try std.testing.expectEqual(@as(u32, 0), built.range.start_offset);
+    try std.testing.expect(built.range.end_container == &built.root.prototype);
+    try std.testing.expectEqual(@as(u32, 0), built.range.end_offset);
+}
+
+// Phase 6 complete: 7 tests for live range updates ✅
+
+// Phase 7: Batched Boundaries and Text Segments (2 tests)
+
+test "Range: setBaseAndExtent sets both points or neither" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    const first = try doc.createTextNode("Hello");
+    _ = try root.prototype.appendChild(&first.prototype);
+    const second = try doc.createTextNode("World");
+    _ = try root.prototype.appendChild(&second.prototype);
+
+    const range = try doc.createRange();
+    defer range.deinit();
+
+    try range.setBaseAndExtent(&first.prototype, 1, &second.prototype, 4);
+    try std.testing.expect(range.start_container == &first.prototype);
+    try std.testing.expectEqual(@as(u32, 1), range.start_offset);
+    try std.testing.expect(range.end_container == &second.prototype);
+    try std.testing.expectEqual(@as(u32, 4), range.end_offset);
+
+    // Validation happens before anything changes
+    try std.testing.expectError(error.IndexSizeError, range.setBaseAndExtent(&first.prototype, 0, &second.prototype, 6));
+    try std.testing.expectEqual(@as(u32, 1), range.start_offset);
+
+    // Reversed points collapse to the end, like setStart then setEnd
+    try range.setBaseAndExtent(&second.prototype, 2, &first.prototype, 3);
+    try std.testing.expect(range.collapsed());
+    try std.testing.expect(range.start_container == &first.prototype);
+    try std.testing.expectEqual(@as(u32, 3), range.start_offset);
+}
+
+test "Range: forEachTextSegment yields toString pieces without copying" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    const first = try doc.createTextNode("Hello");
+    _ = try root.prototype.appendChild(&first.prototype);
+    const item = try doc.createElement("item");
+    _ = try root.prototype.appendChild(&item.prototype);
+    const inner = try doc.createTextNode(", ");
+    _ = try item.prototype.appendChild(&inner.prototype);
+    const last = try doc.createTextNode("World");
+    _ = try root.prototype.appendChild(&last.prototype);
+
+    const range = try doc.createRange();
+    defer range.deinit();
+    try range.setBaseAndExtent(&first.prototype, 1, &last.prototype, 3);
+
+    const Segments = struct {
+        pieces: [4][]const u8 = undefined,
+        count: usize = 0,
+
+        fn add(segments: *@This(), segment: []const u8) std.mem.Allocator.Error!void {
+            segments.pieces[segments.count] = segment;
+            segments.count += 1;
+        }
+    };
+    var segments = Segments{};
+    try range.forEachTextSegment(&segments, Segments.add);
+
+    try std.testing.expectEqual(@as(usize, 3), segments.count);
+    try std.testing.expectEqualStrings("ello", segments.pieces[0]);
+    try std.testing.expect(segments.pieces[0].ptr == first.data.ptr + 1);
+    try std.testing.expectEqualStrings(", ", segments.pieces[1]);
+    try std.testing.expectEqualStrings("Wor", segments.pieces[2]);
+
+    const text = try range.toString(allocator);
+    defer allocator.free(text);
+    try std.testing.expectEqualStrings("ello, Wor", text);
+}
+
+// Phase 7 complete: 2 tests for batched boundaries and text segments ✅
@@ -180,6 +180,36 @@ test "NodeRareData - multiple event types" {
     try std.testing.expectEqual(@as(usize, 1), rare_data.getEventListeners("change").len);
 }
 
+test "NodeRareData - listener type bitmaps follow add and remove" {
+    const allocator = std.testing.allocator;
+
+    var rare_data = NodeRareData.init(allocator);
+    defer rare_data.deinit();
+
+    var ctx: u32 = 0;
+    const callback = struct {
+        fn cb(_: *Event, _: *anyopaque) void {}
+    }.cb;
+
+    const click = dom.eventTypeBit("click");
+    try std.testing.expect(!rare_data.mayHaveEventListeners(click, false));
+
+    try rare_data.addEventListener(.{
+        .event_type = "click",
+        .callback = callback,
+        .context = @ptrCast(&ctx),
+        .capture = true,
+        .once = false,
+        .passive = false,
+    });
+    try std.testing.expect(rare_data.mayHaveEventListeners(click, true));
+    try std.testing.expect(!rare_data.mayHaveEventListeners(click, false));
+
+    try std.testing.expect(rare_data.removeEventListener("click", callback, true));
+    try std.testing.expect(!rare_data.mayHaveEventListeners(click, true));
+    try std.testing.expectEqual(@as(u64, 0), rare_data.capture_types | rare_data.bubble_types);
+}
+
 test "NodeRareData - memory leak test" {
     const allocator = std.testing.allocator;
 
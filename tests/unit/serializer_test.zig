@@ -0,0 +1,111 @@
+//! serializer Tests
+//!
+//! Tests for streaming markup serialization.
+
+const std = @import("std");
+const dom = @import("dom");
+
+const testing = std.testing;
+const serializer = dom.serializer;
+const Document = dom.Document;
+
+test "serializer - elements, attributes and escaping" {
+    const allocator = testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    defer root.prototype.release();
+    try root.setAttribute("title", "a \"b\" & <c>");
+    try root.setAttribute("class", "rows");
+
+    const item = try doc.createElement("item");
+    _ = try root.prototype.appendChild(&item.prototype);
+    const text = try doc.createTextNode("1 < 2 && 3 > 2\u{00A0}!");
+    _ = try item.prototype.appendChild(&text.prototype);
+
+    const empty = try doc.createElement("leaf");
+    _ = try root.prototype.appendChild(&empty.prototype);
+    const comment = try doc.createComment(" note ");
+    _ = try root.prototype.appendChild(&comment.prototype);
+
+    const markup = try serializer.serializeAlloc(allocator, &root.prototype, 0);
+    defer allocator.free(markup);
+    try testing.expectEqualStrings(
+        "<root title=\"a &quot;b&quot; &amp; &lt;c&gt;\" class=\"rows\">" ++
+            "<item>1 &lt; 2 &amp;&amp; 3 &gt; 2&nbsp;!</item><leaf></leaf><!-- note --></root>",
+        markup,
+    );
+
+    // Children only, XML syntax
+    const inner = try serializer.serializeAlloc(allocator, &root.prototype, serializer.children_only | serializer.xml);
+    defer allocator.free(inner);
+    try testing.expectEqualStrings(
+        "<item>1 &lt; 2 &amp;&amp; 3 &gt; 2\u{00A0}!</item><leaf/><!-- note -->",
+        inner,
+    );
+}
+
+test "serializer - streams chunks without allocating" {
+    const allocator = testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    defer root.prototype.release();
+    for (0..1000) |_| {
+        const row = try doc.createElement("row");
+        try row.setAttribute("class", "line");
+        _ = try root.prototype.appendChild(&row.prototype);
+    }
+
+    const Sink = struct {
+        chunks: usize = 0,
+        length: usize = 0,
+        largest: usize = 0,
+
+        fn write(sink: *@This(), chunk: []const u8) std.mem.Allocator.Error!void {
+            sink.chunks += 1;
+            sink.length += chunk.len;
+            sink.largest = @max(sink.largest, chunk.len);
+        }
+    };
+
+    var sink = Sink{};
+    try serializer.serialize(&root.prototype, 0, &sink, Sink.write);
+
+    const row_markup = "<row class=\"line\"></row>";
+    try testing.expectEqual("<root></root>".len + 1000 * row_markup.len, sink.length);
+    try testing.expect(sink.chunks > 1);
+    try testing.expect(sink.largest <= serializer.chunk_size);
+
+    // The concatenated chunks match the one-buffer form
+    const markup = try serializer.serializeAlloc(allocator, &root.prototype, 0);
+    defer allocator.free(markup);
+    try testing.expectEqual(sink.length, markup.len);
+    try testing.expect(std.mem.endsWith(u8, markup, row_markup ++ "</root>"));
+}
+
+test "serializer - documents serialize as their children" {
+    const allocator = testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    const leaf = try doc.createElement("leaf");
+    _ = try root.prototype.appendChild(&leaf.prototype);
+
+    const markup = try serializer.serializeAlloc(allocator, &doc.prototype, 0);
+    defer allocator.free(markup);
+    try testing.expectEqualStrings("<root><leaf></leaf></root>", markup);
+
+    const fragment = try doc.createDocumentFragment();
+    defer fragment.prototype.release();
+    const empty = try serializer.serializeAlloc(allocator, &fragment.prototype, 0);
+    defer allocator.free(empty);
+    try testing.expectEqualStrings("", empty);
+}
@@ -711,6 +711,37 @@ test "Node.getRootNode() - nested shadow roots (composed=true)" {
     try std.testing.expect(root.node_type == .document);
 }
 
+test "Node.getRootNode() - follows a host leaving the document" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    const host = try doc.createElement("host");
+    _ = try root.prototype.appendChild(&host.prototype);
+
+    const shadow = try host.attachShadow(.{
+        .mode = .open,
+        .delegates_focus = false,
+    });
+    const leaf = try doc.createElement("leaf");
+    _ = try shadow.prototype.appendChild(&leaf.prototype);
+
+    try std.testing.expect(leaf.prototype.getRootNode(true) == &doc.prototype);
+    try std.testing.expect(leaf.prototype.getRootNode(false) == &shadow.prototype);
+    try std.testing.expect(shadow.prototype.getRootNode(false) == &shadow.prototype);
+
+    // Disconnected: the walk ends at the detached subtree's root
+    _ = try doc.prototype.removeChild(&root.prototype);
+    defer root.prototype.release();
+
+    try std.testing.expect(leaf.prototype.getRootNode(true) == &root.prototype);
+    try std.testing.expect(leaf.prototype.getRootNode(false) == &shadow.prototype);
+    try std.testing.expect(host.prototype.getRootNode(false) == &root.prototype);
+}
+
 test "Node.getRootNode() - host element in document (composed=false)" {
     const allocator = std.testing.allocator;
 
@@ -978,3 +1009,92 @@ test "ShadowRoot.onslotchange - can be set and retrieved" {
     shadow.onslotchange = null;
     try std.testing.expect(shadow.onslotchange == null);
 }
+
+// ============================================================================
+// Shadow tree id and class indices
+// ============================================================================
+
+test "ShadowRoot - id and class queries use the shadow tree's own index" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    const host = try doc.createElement("host");
+    _ = try root.prototype.appendChild(&host.prototype);
+    const shadow = try host.attachShadow(.{ .mode = .open });
+
+    const wrapper = try doc.createElement("content");
+    _ = try shadow.prototype.appendChild(&wrapper.prototype);
+    const item = try doc.createElement("item");
+    try item.setAttribute("id", "x");
+    try item.setAttribute("class", "row active");
+    _ = try wrapper.prototype.appendChild(&item.prototype);
+
+    // Shadow-tree elements stay out of the document's maps
+    try std.testing.expect(doc.getElementById("x") == null);
+    try std.testing.expect(item.prototype.isInShadowTree());
+    try std.testing.expect(!host.prototype.isInShadowTree());
+
+    try std.testing.expect(shadow.getElementById("x") == item);
+    try std.testing.expect((try shadow.querySelector(allocator, ".active")).? == item);
+    try std.testing.expect(shadow.index != null);
+
+    // Later changes keep the index current, in tree order
+    const first = try doc.createElement("item");
+    try first.setAttribute("class", "active");
+    _ = try shadow.prototype.insertBefore(&first.prototype, &wrapper.prototype);
+    const actives = try shadow.querySelectorAll(allocator, ".active");
+    defer allocator.free(actives);
+    try std.testing.expectEqual(@as(usize, 2), actives.len);
+    try std.testing.expect(actives[0] == first);
+    try std.testing.expect(actives[1] == item);
+
+    try item.setAttribute("id", "y");
+    try std.testing.expect(shadow.getElementById("x") == null);
+    try std.testing.expect(shadow.getElementById("y") == item);
+    try std.testing.expect(wrapper.queryById("y") == item);
+
+    try item.removeAttribute("class");
+    try std.testing.expect((try shadow.querySelector(allocator, ".row")) == null);
+
+    // Leaving the shadow tree unflags and unindexes the subtree
+    _ = try shadow.prototype.removeChild(&wrapper.prototype);
+    try std.testing.expect(!item.prototype.isInShadowTree());
+    try std.testing.expect(shadow.getElementById("y") == null);
+    _ = try root.prototype.appendChild(&wrapper.prototype);
+    try std.testing.expect(doc.getElementById("y") == item);
+}
+
+test "ShadowRoot - light DOM mutations leave the shadow index alone" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const host = try doc.createElement("host");
+    _ = try doc.prototype.appendChild(&host.prototype);
+    const shadow = try host.attachShadow(.{ .mode = .open });
+    const inner = try doc.createElement("item");
+    try inner.setAttribute("id", "shared");
+    _ = try shadow.prototype.appendChild(&inner.prototype);
+    try std.testing.expect(shadow.getElementById("shared") == inner);
+    const index = shadow.index.?;
+
+    // Same id in the light tree: each tree answers with its own element
+    const light = try doc.createElement("item");
+    try light.setAttribute("id", "shared");
+    try light.setAttribute("class", "active");
+    _ = try host.prototype.appendChild(&light.prototype);
+    try std.testing.expect(doc.getElementById("shared") == light);
+    try std.testing.expect(shadow.getElementById("shared") == inner);
+    try std.testing.expect((try shadow.querySelector(allocator, ".active")) == null);
+    try std.testing.expect(shadow.index.? == index);
+
+    // Clearing the shadow tree empties its index
+    try shadow.prototype.setTextContent(null);
+    try std.testing.expect(shadow.getElementById("shared") == null);
+    try std.testing.expect(doc.getElementById("shared") == light);
+}
@@ -0,0 +1,85 @@
+//! sliced_query Tests
+//!
+//! Tests for SlicedQuery: results match querySelectorAll across steps,
+//! small budgets still make progress, and mutations invalidate the query.
+
+const std = @import("std");
+const dom = @import("dom");
+
+const testing = std.testing;
+const Document = dom.Document;
+const Element = dom.Element;
+const SlicedQuery = dom.SlicedQuery;
+
+/// A document with a root of `rows` rows; every third row has class "hit".
+fn buildDocument(rows: usize) !*Document {
+    const doc = try Document.init(testing.allocator);
+    errdefer doc.release();
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    for (0..rows) |i| {
+        const row = try doc.createElement("row");
+        if (i % 3 == 0) try row.setAttribute("class", "hit");
+        _ = try row.prototype.appendChild(&(try doc.createTextNode("cell")).prototype);
+        _ = try root.prototype.appendChild(&row.prototype);
+    }
+    return doc;
+}
+
+test "SlicedQuery - steps return the querySelectorAll matches in order" {
+    const allocator = testing.allocator;
+    const doc = try buildDocument(1000);
+    defer doc.release();
+
+    const expected = try doc.querySelectorAll(".hit");
+    defer allocator.free(expected);
+
+    const query = try SlicedQuery.init(allocator, doc, &doc.prototype, ".hit");
+    defer query.deinit();
+
+    var found = std.ArrayList(*Element){};
+    defer found.deinit(allocator);
+    var out: [7]*Element = undefined;
+    while (query.state == .running) {
+        const count = try query.step(std.time.ns_per_s, &out);
+        try found.appendSlice(allocator, out[0..count]);
+    }
+    try testing.expectEqual(SlicedQuery.State.done, query.state);
+    try testing.expectEqualSlices(*Element, expected, found.items);
+}
+
+test "SlicedQuery - an exhausted budget ends the step after one interval" {
+    const allocator = testing.allocator;
+    const doc = try buildDocument(1000);
+    defer doc.release();
+
+    const query = try SlicedQuery.init(allocator, doc, &doc.prototype, "row");
+    defer query.deinit();
+
+    var out: [1024]*Element = undefined;
+    try testing.expectEqual(@as(usize, dom.sliced_query.check_interval - 1), try query.step(0, &out));
+    try testing.expectEqual(SlicedQuery.State.running, query.state);
+
+    var steps: usize = 1;
+    var total: usize = dom.sliced_query.check_interval - 1;
+    while (query.state == .running) : (steps += 1) total += try query.step(0, &out);
+    try testing.expectEqual(@as(usize, 1000), total);
+    try testing.expect(steps >= 1001 / dom.sliced_query.check_interval);
+}
+
+test "SlicedQuery - mutations invalidate the query" {
+    const allocator = testing.allocator;
+    const doc = try buildDocument(600);
+    defer doc.release();
+
+    const query = try SlicedQuery.init(allocator, doc, &doc.prototype, ".hit");
+    defer query.deinit();
+
+    var out: [16]*Element = undefined;
+    try testing.expect(try query.step(std.time.ns_per_s, &out) > 0);
+    try out[0].setAttribute("class", "miss");
+
+    try testing.expectEqual(@as(usize, 0), try query.step(std.time.ns_per_s, &out));
+    try testing.expectEqual(SlicedQuery.State.invalidated, query.state);
+    try testing.expectError(error.InvalidSelector, SlicedQuery.init(allocator, doc, &doc.prototype, ""));
+}
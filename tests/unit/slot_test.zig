@@ -1137,3 +1137,152 @@ test "Automatic Assignment - removing slot name assigns default slot slottables"
     // Element should now be assigned (matches default slot)
     try std.testing.expect(elem.assignedSlot() == slot);
 }
+
+// ============================================================================
+// Slot map cache
+// ============================================================================
+
+test "Slot Map - assigned nodes are cached until the host's children change" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const host = try doc.createElement("host");
+    defer host.prototype.release();
+    const shadow = try host.attachShadow(.{ .mode = .open, .slot_assignment = .named });
+
+    const slot = try doc.createElement("slot");
+    _ = try shadow.prototype.appendChild(&slot.prototype);
+    const first = try doc.createElement("item");
+    _ = try host.prototype.appendChild(&first.prototype);
+
+    const cached = try slot.assignedNodesCached();
+    try std.testing.expectEqual(@as(usize, 1), cached.len);
+
+    // Unrelated mutations inside and outside the shadow tree keep the list
+    const leaf = try doc.createElement("leaf");
+    _ = try shadow.prototype.appendChild(&leaf.prototype);
+    try leaf.setAttribute("class", "busy");
+    try first.setAttribute("class", "busy");
+    try std.testing.expectEqual(cached.ptr, (try slot.assignedNodesCached()).ptr);
+
+    // A new host child rebuilds it, in tree order
+    const second = try doc.createElement("item");
+    _ = try host.prototype.insertBefore(&second.prototype, &first.prototype);
+    const rebuilt = try slot.assignedNodesCached();
+    try std.testing.expectEqual(@as(usize, 2), rebuilt.len);
+    try std.testing.expect(rebuilt[0] == &second.prototype);
+    try std.testing.expect(rebuilt[1] == &first.prototype);
+
+    // A removed host child loses its slot
+    const removed = try host.prototype.removeChild(&first.prototype);
+    defer removed.release();
+    try std.testing.expect(first.assignedSlot() == null);
+    try std.testing.expectEqual(@as(usize, 1), (try slot.assignedNodesCached()).len);
+}
+
+test "Slot Map - slot rename moves assigned nodes" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const host = try doc.createElement("host");
+    defer host.prototype.release();
+    const shadow = try host.attachShadow(.{ .mode = .open, .slot_assignment = .named });
+
+    const default_slot = try doc.createElement("slot");
+    _ = try shadow.prototype.appendChild(&default_slot.prototype);
+    const named_slot = try doc.createElement("slot");
+    try named_slot.setAttribute("name", "header");
+    _ = try shadow.prototype.appendChild(&named_slot.prototype);
+
+    const item = try doc.createElement("item");
+    try item.setAttribute("slot", "footer");
+    _ = try host.prototype.appendChild(&item.prototype);
+    const text = try doc.createTextNode("content");
+    _ = try host.prototype.appendChild(&text.prototype);
+
+    try std.testing.expect(item.assignedSlot() == null);
+    try std.testing.expectEqual(@as(usize, 1), (try default_slot.assignedNodesCached()).len);
+    try std.testing.expectEqual(@as(usize, 0), (try named_slot.assignedNodesCached()).len);
+
+    try named_slot.setAttribute("name", "footer");
+    try std.testing.expect(item.assignedSlot() == named_slot);
+    const assigned = try named_slot.assignedNodesCached();
+    try std.testing.expectEqual(@as(usize, 1), assigned.len);
+    try std.testing.expect(assigned[0] == &item.prototype);
+
+    // The slottable's own slot attribute
+    try item.removeAttribute("slot");
+    try std.testing.expect(item.assignedSlot() == default_slot);
+    try std.testing.expectEqual(@as(usize, 2), (try default_slot.assignedNodesCached()).len);
+    try std.testing.expectEqual(@as(usize, 0), (try named_slot.assignedNodesCached()).len);
+}
+
+test "Slot Map - removing a slot reassigns to the next slot with its name" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const host = try doc.createElement("host");
+    defer host.prototype.release();
+    const shadow = try host.attachShadow(.{ .mode = .open, .slot_assignment = .named });
+
+    // The first slot sits inside a wrapper, so removal takes a subtree
+    const wrapper = try doc.createElement("content");
+    _ = try shadow.prototype.appendChild(&wrapper.prototype);
+    const first = try doc.createElement("slot");
+    _ = try wrapper.prototype.appendChild(&first.prototype);
+    const second = try doc.createElement("slot");
+    _ = try shadow.prototype.appendChild(&second.prototype);
+
+    const item = try doc.createElement("item");
+    _ = try host.prototype.appendChild(&item.prototype);
+    try std.testing.expect(item.assignedSlot() == first);
+
+    _ = try shadow.prototype.removeChild(&wrapper.prototype);
+    try std.testing.expect(item.assignedSlot() == second);
+    try std.testing.expectEqual(@as(usize, 1), (try second.assignedNodesCached()).len);
+    try std.testing.expectEqual(@as(usize, 0), (try first.assignedNodesCached()).len);
+
+    // Putting it back in front wins again
+    _ = try shadow.prototype.insertBefore(&wrapper.prototype, &second.prototype);
+    try std.testing.expect(item.assignedSlot() == first);
+
+    // Clearing the shadow tree leaves the item unassigned
+    try shadow.prototype.setTextContent(null);
+    try std.testing.expect(item.assignedSlot() == null);
+}
+
+test "Slot Map - ShadowRoot.querySelector searches the shadow tree only" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const host = try doc.createElement("host");
+    defer host.prototype.release();
+    const shadow = try host.attachShadow(.{ .mode = .open });
+
+    const light = try doc.createElement("item");
+    _ = try host.prototype.appendChild(&light.prototype);
+
+    const wrapper = try doc.createElement("content");
+    _ = try shadow.prototype.appendChild(&wrapper.prototype);
+    const deep = try doc.createElement("item");
+    _ = try wrapper.prototype.appendChild(&deep.prototype);
+    const shallow = try doc.createElement("item");
+    _ = try shadow.prototype.appendChild(&shallow.prototype);
+
+    try std.testing.expect((try shadow.querySelector(allocator, "item")).? == deep);
+    try std.testing.expect((try shadow.querySelector(allocator, "content > item")).? == deep);
+
+    const all = try shadow.querySelectorAll(allocator, "item");
+    defer allocator.free(all);
+    try std.testing.expectEqual(@as(usize, 2), all.len);
+    try std.testing.expect(all[0] == deep);
+    try std.testing.expect(all[1] == shallow);
+}
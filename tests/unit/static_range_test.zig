@@ -555,3 +555,64 @@ test "StaticRange: nodes are ref-counted correctly" {
 
 
 
+
+test "StaticRange: createStaticRanges reuses pool slots" {
+    const allocator = testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const text = try doc.createTextNode("highlight every match in this text");
+    defer text.prototype.release();
+
+    var inits: [300]StaticRangeInit = undefined;
+    for (&inits, 0..) |*init, i| {
+        const offset: u32 = @intCast(i % 30);
+        init.* = .{
+            .start_container = &text.prototype,
+            .start_offset = offset,
+            .end_container = &text.prototype,
+            .end_offset = offset + 4,
+        };
+    }
+
+    var ranges: [300]*StaticRange = undefined;
+    try doc.createStaticRanges(&inits, &ranges);
+    try testing.expectEqual(@as(u32, 29), ranges[299].startOffset());
+    try testing.expectEqual(@as(u32, 33), ranges[299].endOffset());
+
+    // Released ranges go back to the pool and are handed out again
+    const first = ranges[0];
+    for (ranges) |range| range.deinit(range.allocator);
+    try doc.createStaticRanges(inits[0..1], ranges[0..1]);
+    try testing.expect(ranges[0] == first);
+    ranges[0].deinit(ranges[0].allocator);
+
+    // A DocumentType container fails the whole batch
+    const doctype = try doc.createDocumentType("root", "", "");
+    defer doctype.prototype.release();
+    inits[1].end_container = &doctype.prototype;
+    try testing.expectError(error.InvalidNodeTypeError, doc.createStaticRanges(inits[0..3], ranges[0..3]));
+    try testing.expectEqual(@as(usize, 0), doc.static_ranges.live);
+}
+
+test "StaticRange: pooled ranges keep their document alive" {
+    const allocator = testing.allocator;
+
+    const doc = try Document.init(allocator);
+    const elem = try doc.createElement("item");
+
+    var ranges: [2]*StaticRange = undefined;
+    try doc.createStaticRanges(&.{
+        .{ .start_container = &elem.prototype, .start_offset = 0, .end_container = &elem.prototype, .end_offset = 0 },
+        .{ .start_container = &elem.prototype, .start_offset = 0, .end_container = &elem.prototype, .end_offset = 1 },
+    }, &ranges);
+
+    elem.prototype.release();
+    doc.release();
+
+    // The document is still there; the last range destroys it
+    try testing.expect(ranges[1].startContainer() == &elem.prototype);
+    ranges[0].deinit(ranges[0].allocator);
+    ranges[1].deinit(ranges[1].allocator);
+}
@@ -0,0 +1,97 @@
+//! string_utils Tests
+//!
+//! Tests for the byte scanning kernels. Each kernel is checked against a
+//! plain byte loop at every length and position up to a few vector widths,
+//! so both the vector steps and the scalar tail are covered.
+
+const std = @import("std");
+const dom = @import("dom");
+
+const testing = std.testing;
+const string_utils = dom.string_utils;
+
+const max_len = 160;
+
+test "string_utils - indexOfAnyPos finds the first needle at every position" {
+    var buffer = [_]u8{'a'} ** max_len;
+
+    for (0..max_len + 1) |len| {
+        const haystack = buffer[0..len];
+        try testing.expectEqual(@as(?usize, null), string_utils.indexOfAnyPos(haystack, 0, "&<>\"\xC2"));
+
+        for (0..len) |at| {
+            haystack[at] = '<';
+            if (at + 1 < len) haystack[at + 1] = '&';
+            try testing.expectEqual(@as(?usize, at), string_utils.indexOfAnyPos(haystack, 0, "&<>\"\xC2"));
+            try testing.expectEqual(@as(?usize, at), string_utils.indexOfAnyPos(haystack, at, "&<>"));
+            if (at + 1 < len) {
+                try testing.expectEqual(@as(?usize, at + 1), string_utils.indexOfAnyPos(haystack, at + 1, "&<>"));
+            }
+            try testing.expectEqual(@as(?usize, null), string_utils.indexOfAnyPos(haystack, 0, "\""));
+            @memset(haystack, 'a');
+        }
+    }
+
+    try testing.expectEqual(@as(?usize, null), string_utils.indexOfAnyPos("abc", 3, "&"));
+}
+
+test "string_utils - isAscii and fitsLatin1 at every position" {
+    var buffer = [_]u8{'a'} ** max_len;
+
+    for (0..max_len + 1) |len| {
+        const bytes = buffer[0..len];
+        try testing.expect(string_utils.isAscii(bytes));
+        try testing.expect(string_utils.fitsLatin1(bytes));
+
+        for (0..len) |at| {
+            bytes[at] = 0xC3; // lead byte of U+00C0..U+00FF
+            try testing.expect(!string_utils.isAscii(bytes));
+            try testing.expect(string_utils.fitsLatin1(bytes));
+
+            bytes[at] = 0xE4; // lead byte of a three-byte sequence
+            try testing.expect(!string_utils.fitsLatin1(bytes));
+            bytes[at] = 'a';
+        }
+    }
+
+    try testing.expect(string_utils.fitsLatin1("caf\u{00E9} \u{00A0}"));
+    try testing.expect(!string_utils.fitsLatin1("\u{0100}"));
+    try testing.expect(!string_utils.fitsLatin1("\u{1F600}"));
+}
+
+test "string_utils - encodingOf" {
+    try testing.expectEqual(string_utils.Encoding.ascii, string_utils.encodingOf(""));
+    try testing.expectEqual(string_utils.Encoding.ascii, string_utils.encodingOf("item-1"));
+    try testing.expectEqual(string_utils.Encoding.latin1, string_utils.encodingOf("caf\u{00E9} \u{00A0}"));
+    try testing.expectEqual(string_utils.Encoding.utf8, string_utils.encodingOf("\u{0100}"));
+
+    // Latin-1 lead bytes that are not valid UTF-8 are not transcodable
+    try testing.expectEqual(string_utils.Encoding.utf8, string_utils.encodingOf("\xC3"));
+    try testing.expectEqual(string_utils.Encoding.utf8, string_utils.encodingOf("\x80"));
+    try testing.expectEqual(string_utils.Encoding.utf8, string_utils.encodingOf("\xC0\x80"));
+}
+
+test "string_utils - trimAsciiWhitespace at every length and position" {
+    var buffer: [max_len]u8 = undefined;
+
+    for (0..max_len + 1) |len| {
+        const bytes = buffer[0..len];
+        for (bytes, 0..) |*c, i| c.* = string_utils.ascii_whitespace[i % string_utils.ascii_whitespace.len];
+        try testing.expectEqual(@as(usize, 0), string_utils.trimAsciiWhitespace(bytes).len);
+
+        for (0..len) |first| {
+            bytes[first] = 'x';
+            for (first..len) |last| {
+                bytes[last] = 'y';
+                const trimmed = string_utils.trimAsciiWhitespace(bytes);
+                try testing.expectEqual(@intFromPtr(bytes.ptr + first), @intFromPtr(trimmed.ptr));
+                try testing.expectEqual(last - first + 1, trimmed.len);
+                if (last != first) bytes[last] = ' ';
+            }
+            bytes[first] = ' ';
+        }
+    }
+
+    // Vertical tab is not ASCII whitespace
+    try testing.expectEqualStrings("\x0Bitem", string_utils.trimAsciiWhitespace(" \x0Bitem\r\n"));
+}
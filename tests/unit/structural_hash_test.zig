@@ -0,0 +1,134 @@
+//! structural_hash Tests
+//!
+//! Tests for Node.structuralHash() and Document.enableStructuralHashes():
+//! agreement with isEqualNode, invalidation along the ancestor chain and
+//! read-only caches of frozen documents.
+
+const std = @import("std");
+const dom = @import("dom");
+
+const testing = std.testing;
+const Document = dom.Document;
+const Element = dom.Element;
+
+/// A root with three rows of cells; returns the root
+fn build(doc: *Document, reverse_attributes: bool) !*Element {
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+    for (0..3) |_| {
+        const row = try doc.createElement("row");
+        if (reverse_attributes) {
+            try row.setAttribute("data-x", "1");
+            try row.setAttribute("class", "even");
+        } else {
+            try row.setAttribute("class", "even");
+            try row.setAttribute("data-x", "1");
+        }
+        _ = try root.prototype.appendChild(&row.prototype);
+        const cell = try doc.createElement("cell");
+        _ = try row.prototype.appendChild(&cell.prototype);
+        _ = try cell.prototype.appendChild(&(try doc.createTextNode("line")).prototype);
+    }
+    return root;
+}
+
+test "structural hash - equal trees hash equal" {
+    const allocator = testing.allocator;
+
+    const a = try Document.init(allocator);
+    defer a.release();
+    const b = try Document.init(allocator);
+    defer b.release();
+    try b.enableStructuralHashes();
+
+    const root_a = try build(a, false);
+    const root_b = try build(b, true);
+
+    // Cached or not, attribute order aside
+    try testing.expect(root_a.prototype.isEqualNode(&root_b.prototype));
+    try testing.expectEqual(try root_a.prototype.structuralHash(), try root_b.prototype.structuralHash());
+
+    // Namespaces and node types are part of the hash
+    const plain = try a.createElement("leaf");
+    defer plain.prototype.release();
+    const namespaced = try a.createElementNS("http://www.w3.org/2000/svg", "leaf");
+    defer namespaced.prototype.release();
+    try testing.expect(try plain.prototype.structuralHash() != try namespaced.prototype.structuralHash());
+
+    const text = try a.createTextNode("line");
+    defer text.prototype.release();
+    const comment = try a.createComment("line");
+    defer comment.prototype.release();
+    try testing.expect(try text.prototype.structuralHash() != try comment.prototype.structuralHash());
+}
+
+test "structural hash - mutations invalidate the ancestor chain only" {
+    const allocator = testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+    try doc.enableStructuralHashes();
+    const root = try build(doc, false);
+    const hashes = doc.structural_hashes.?;
+
+    const before = try doc.prototype.structuralHash();
+    const first = root.firstElementChild().?;
+    const last = root.lastElementChild().?;
+    const text = first.firstElementChild().?.prototype.first_child.?;
+    try testing.expect(hashes.hashes.contains(text));
+
+    // Character data: the text, its cell, row, root and document go
+    try text.setNodeValue("changed");
+    try testing.expect(!hashes.hashes.contains(text));
+    try testing.expect(!hashes.hashes.contains(&first.prototype));
+    try testing.expect(!hashes.hashes.contains(&doc.prototype));
+    try testing.expect(hashes.hashes.contains(&last.prototype));
+    try testing.expect(try doc.prototype.structuralHash() != before);
+
+    try text.setNodeValue("line");
+    try testing.expectEqual(before, try doc.prototype.structuralHash());
+
+    // Attributes
+    try last.setAttribute("class", "odd");
+    try testing.expect(try doc.prototype.structuralHash() != before);
+    try last.setAttribute("class", "even");
+    try testing.expectEqual(before, try doc.prototype.structuralHash());
+
+    // Child list
+    const extra = try doc.createElement("cell");
+    _ = try last.prototype.appendChild(&extra.prototype);
+    try testing.expect(try doc.prototype.structuralHash() != before);
+    const removed = try last.prototype.removeChild(&extra.prototype);
+    removed.release();
+    try testing.expectEqual(before, try doc.prototype.structuralHash());
+
+    // Mismatched hashes short-circuit; the answer stays the one the walk gives
+    const other = try doc.createElement("root");
+    defer other.prototype.release();
+    try testing.expect(!root.prototype.isEqualNode(&other.prototype));
+    const clone = try root.prototype.cloneNode(true);
+    defer clone.release();
+    try testing.expect(root.prototype.isEqualNode(clone));
+    try first.setAttribute("class", "odd");
+    try testing.expect(!root.prototype.isEqualNode(clone));
+}
+
+test "structural hash - frozen documents read the cache without writing it" {
+    const allocator = testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+    try doc.enableStructuralHashes();
+    const root = try build(doc, false);
+    const detached = try doc.createElement("leaf");
+    defer detached.prototype.release();
+
+    try doc.freeze();
+    const hashes = doc.structural_hashes.?;
+    const cached = hashes.hashes.count();
+    try testing.expect(hashes.hashes.contains(&root.prototype));
+
+    const expected = try dom.structural_hash.StructuralHashes.compute(allocator, &detached.prototype);
+    try testing.expectEqual(expected, try detached.prototype.structuralHash());
+    try testing.expectEqual(cached, hashes.hashes.count());
+}
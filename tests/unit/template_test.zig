@@ -0,0 +1,103 @@
+//! template Tests
+//!
+//! Tests for compiling subtrees and instantiating them with holes.
+
+const std = @import("std");
+const dom = @import("dom");
+
+const testing = std.testing;
+const Template = dom.Template;
+const Document = dom.Document;
+const Element = dom.Element;
+const Node = dom.Node;
+
+test "template - instances copy the subtree and return their holes" {
+    const allocator = testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    // <row class="entry"><label>name</label><!--note--><cell id="c"/></row>
+    const row = try doc.createElement("row");
+    defer row.prototype.release();
+    try row.setAttribute("class", "entry");
+    const label = try doc.createElement("label");
+    _ = try row.prototype.appendChild(&label.prototype);
+    const name = try doc.createTextNode("name");
+    _ = try label.prototype.appendChild(&name.prototype);
+    _ = try row.prototype.appendChild(&(try doc.createComment("note")).prototype);
+    const cell = try doc.createElement("cell");
+    try cell.setAttribute("id", "c");
+    _ = try row.prototype.appendChild(&cell.prototype);
+
+    const template = try Template.compile(allocator, &row.prototype, &.{ &cell.prototype, &name.prototype });
+    defer template.deinit();
+    try testing.expectEqual(@as(u32, 2), template.hole_count);
+
+    // The source can change without affecting instances
+    try row.setAttribute("class", "changed");
+
+    var holes: [2]*Node = undefined;
+    const instance = try template.instantiate(doc, &holes);
+    defer instance.release();
+
+    const copy: *Element = @fieldParentPtr("prototype", instance);
+    try testing.expectEqualStrings("row", copy.tag_name);
+    try testing.expectEqualStrings("entry", copy.getAttribute("class").?);
+    try testing.expect(copy.class_bloom.mayContain("entry"));
+
+    const markup = try dom.serializer.serializeAlloc(allocator, instance, 0);
+    defer allocator.free(markup);
+    try testing.expectEqualStrings("<row class=\"entry\"><label>name</label><!--note--><cell id=\"c\"></cell></row>", markup);
+
+    // Holes are the copies, in the order they were listed
+    try testing.expectEqual(instance.last_child.?, holes[0]);
+    try testing.expectEqual(instance.first_child.?.first_child.?, holes[1]);
+    try holes[1].setNodeValue("first");
+    try testing.expectEqualStrings("name", name.data);
+
+    // Instances are independent of each other and of the template
+    const second = try template.instantiate(doc, &holes);
+    defer second.release();
+    try testing.expect(second != instance);
+    try testing.expectEqualStrings("name", holes[1].nodeValue().?);
+}
+
+test "template - fragments, deep trees and errors" {
+    const allocator = testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    // A chain deeper than the inline ancestor stack
+    const fragment = try doc.createDocumentFragment();
+    defer fragment.prototype.release();
+    var parent = &fragment.prototype;
+    for (0..40) |_| {
+        const item = try doc.createElement("item");
+        _ = try parent.appendChild(&item.prototype);
+        parent = &item.prototype;
+    }
+    const leaf = try doc.createTextNode("leaf");
+    _ = try parent.appendChild(&leaf.prototype);
+
+    const template = try Template.compile(allocator, &fragment.prototype, &.{&leaf.prototype});
+    defer template.deinit();
+
+    var holes: [1]*Node = undefined;
+    const instance = try template.instantiate(doc, &holes);
+    defer instance.release();
+    try testing.expectEqual(dom.NodeType.document_fragment, instance.node_type);
+    try testing.expectEqualStrings("leaf", holes[0].nodeValue().?);
+
+    var depth: usize = 0;
+    var node = holes[0];
+    while (node.parent_node) |p| : (node = p) depth += 1;
+    try testing.expectEqual(@as(usize, 41), depth);
+
+    // Holes must be in the subtree; only element and fragment roots
+    const outside = try doc.createElement("outside");
+    defer outside.prototype.release();
+    try testing.expectError(error.NotFoundError, Template.compile(allocator, &fragment.prototype, &.{&outside.prototype}));
+    try testing.expectError(error.NotSupportedError, Template.compile(allocator, &leaf.prototype, &.{}));
+}
@@ -12,7 +12,8 @@ test {
     _ = @import("text_test.zig");
     _ = @import("comment_test.zig");
     _ = @import("shadow_root_test.zig");
-    // TODO: Extract tests from src/processing_instruction.zig, src/cdata_section.zig, src/custom_element_registry.zig
+    _ = @import("custom_element_registry_test.zig");
+    // TODO: Extract tests from src/processing_instruction.zig, src/cdata_section.zig
     // These files have tests that reference internal/unexported APIs and need careful refactoring
 }
 
@@ -26,6 +27,9 @@ test {
 test {
     _ = @import("event_test.zig");
     _ = @import("event_legacy_test.zig"); // Phase 8
+    _ = @import("event_pool_test.zig");
+    _ = @import("mutation_batch_test.zig");
+    _ = @import("mutation_coalesce_test.zig");
     _ = @import("abort_signal_test.zig");
     _ = @import("mutation_observer_test_fixed.zig");
     // TODO: event_target_test.zig needs refactoring - tests internal APIs not exported
@@ -38,12 +42,31 @@ test {
     _ = @import("parser_test.zig");
     _ = @import("matcher_test.zig");
     _ = @import("query_selector_test.zig");
+    _ = @import("ancestor_filter_test.zig");
 }
 
 // Helper and utility tests
 test {
     _ = @import("tree_helpers_test.zig");
+    _ = @import("tree_snapshot_test.zig");
+    _ = @import("tree_diff_test.zig");
+    _ = @import("patch_queue_test.zig");
+    _ = @import("sliced_query_test.zig");
+    _ = @import("idle_work_test.zig");
+    _ = @import("document_order_test.zig");
+    _ = @import("compact_layout_test.zig");
+    _ = @import("parallel_query_test.zig");
+    _ = @import("document_image_test.zig");
+    _ = @import("structural_hash_test.zig");
+    _ = @import("tree_builder_test.zig");
+    _ = @import("template_test.zig");
+    _ = @import("serializer_test.zig");
+    _ = @import("markup_parser_test.zig");
+    _ = @import("string_utils_test.zig");
     _ = @import("element_iterator_test.zig");
+    _ = @import("closest_memo_test.zig");
+    _ = @import("match_cache_test.zig");
+    _ = @import("node_table_test.zig");
     _ = @import("fast_path_test.zig");
     _ = @import("rare_data_test.zig");
     _ = @import("validation_test.zig");
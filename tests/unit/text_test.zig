@@ -488,3 +488,154 @@ test "Text - wholeText with empty text nodes" {
 
     try std.testing.expectEqualStrings("Content", whole);
 }
+
+test "Text - wholeText into a caller buffer" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    defer root.prototype.release();
+
+    const first = try doc.createTextNode("caf\u{00E9} ");
+    const second = try doc.createTextNode("au lait");
+    _ = try root.prototype.appendChild(&first.prototype);
+    _ = try root.prototype.appendChild(&second.prototype);
+
+    try std.testing.expectEqual(@as(usize, 14), second.wholeTextLength());
+    var buffer: [14]u8 = undefined;
+    try std.testing.expectEqualStrings("caf\u{00E9} au lait", second.writeWholeText(&buffer));
+}
+
+test "Text.splitText - the larger half keeps the buffer" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    defer root.prototype.release();
+
+    const text = try doc.createTextNode("head|the longer tail");
+    _ = try root.prototype.appendChild(&text.prototype);
+    const buffer = text.data.ptr;
+
+    // The tail moves to the start of the buffer; the head is copied
+    const tail = try text.splitText(5);
+    try std.testing.expectEqualStrings("head|", text.data);
+    try std.testing.expectEqualStrings("the longer tail", tail.data);
+    try std.testing.expectEqual(buffer, tail.data.ptr);
+
+    // The head stays in place; the tail is copied
+    const end = try tail.splitText(11);
+    try std.testing.expectEqualStrings("the longer ", tail.data);
+    try std.testing.expectEqualStrings("tail", end.data);
+    try std.testing.expectEqual(buffer, tail.data.ptr);
+
+    // Edits after a split reallocate as usual
+    try tail.appendData("!");
+    try std.testing.expectEqualStrings("the longer !", tail.data);
+    try std.testing.expectEqual(@as(usize, 12), dom.character_data.utf16Length(tail));
+
+    try root.prototype.normalize();
+    try std.testing.expectEqualStrings("head|the longer !tail", text.data);
+}
+
+test "Text - long data is edited in place" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const initial = [_]u8{'a'} ** dom.character_data.in_place_threshold;
+    const text = try doc.createTextNode(&initial);
+    defer text.prototype.release();
+
+    // The first edit moves the data into a buffer with spare room
+    try text.appendData("b");
+    try std.testing.expect(text.capacity > text.data.len);
+    const buffer = text.data.ptr;
+
+    // Typing and deleting stay in that buffer
+    var i: usize = 0;
+    while (i < 100) : (i += 1) {
+        try text.insertData(10, "x");
+    }
+    try text.deleteData(10, 50);
+    try text.replaceData(0, 1, "yz");
+    try std.testing.expectEqual(buffer, text.data.ptr);
+
+    try std.testing.expectEqual(initial.len + 1 + 50 + 1, text.data.len);
+    try std.testing.expectEqualStrings("yz" ++ "a" ** 9 ++ "x" ** 50 ++ "a", text.data[0..62]);
+    try std.testing.expectEqual(@as(u8, 'b'), text.data[text.data.len - 1]);
+
+    // Appending the node's own data reads it before the buffer changes
+    const len = text.data.len;
+    try text.appendData(text.data[0..len]);
+    try std.testing.expectEqual(len * 2, text.data.len);
+    try std.testing.expectEqualSlices(u8, text.data[0..len], text.data[len..]);
+
+    // Shrinking far below the threshold goes back to an exact allocation
+    try text.deleteData(4, text.data.len);
+    try std.testing.expectEqualStrings("yzaa", text.data);
+    try std.testing.expectEqual(@as(usize, 0), text.capacity);
+}
+
+test "Text - long data edits keep observers, splitText and normalize working" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+
+    const initial = "line " ** 1000;
+    const text = try doc.createTextNode(initial);
+    _ = try root.prototype.appendChild(&text.prototype);
+    try text.appendData("end");
+
+    const observer = try dom.MutationObserver.init(allocator, struct {
+        fn callback(_: []const *dom.MutationRecord, _: *dom.MutationObserver, _: ?*anyopaque) void {}
+    }.callback, null);
+    defer observer.deinit();
+    try observer.observe(&text.prototype, .{ .character_data = true, .character_data_old_value = true });
+
+    try text.insertData(0, ">");
+    const records = observer.takeRecords();
+    defer {
+        for (records) |record| record.deinit();
+        allocator.free(records);
+    }
+    try std.testing.expectEqual(@as(usize, 1), records.len);
+    try std.testing.expectEqualStrings(initial ++ "end", records[0].old_value.?);
+
+    // Split the buffered node and merge it back
+    const second = try text.splitText(4000);
+    try std.testing.expectEqual(@as(usize, 4000), text.data.len);
+    try std.testing.expectEqual(@as(usize, initial.len + 4 - 4000), second.data.len);
+
+    try root.prototype.normalize();
+    try std.testing.expectEqual(@as(usize, initial.len + 4), text.data.len);
+    try std.testing.expectEqualStrings(">line", text.data[0..5]);
+    try std.testing.expectEqualStrings("end", text.data[text.data.len - 3 ..]);
+}
+
+test "Comment - long data is edited in place" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const comment = try doc.createComment("note " ** 1000);
+    defer comment.prototype.release();
+
+    try comment.appendData("!");
+    const buffer = comment.data.ptr;
+    try comment.insertData(0, "[");
+    try comment.deleteData(1, 5);
+    try std.testing.expectEqual(buffer, comment.data.ptr);
+    try std.testing.expectEqualStrings("[note ", comment.data[0..6]);
+    try std.testing.expectEqual(@as(usize, 5000 + 1 + 1 - 5), comment.data.len);
+}
@@ -0,0 +1,162 @@
+//! tree_builder Tests
+//!
+//! Tests for push-style tree construction and instruction buffers.
+
+const std = @import("std");
+const dom = @import("dom");
+
+const testing = std.testing;
+const tree_builder = dom.tree_builder;
+const TreeBuilder = dom.TreeBuilder;
+const Document = dom.Document;
+const Element = dom.Element;
+const Text = dom.Text;
+const MutationObserver = dom.MutationObserver;
+const MutationRecord = dom.MutationRecord;
+
+fn ignoreRecords(_: []const *MutationRecord, _: *MutationObserver, _: ?*anyopaque) void {}
+
+/// Appends one encoded instruction string (u32 length + bytes).
+fn putString(list: *std.ArrayList(u8), allocator: std.mem.Allocator, value: []const u8) !void {
+    var len: [4]u8 = undefined;
+    std.mem.writeInt(u32, &len, @intCast(value.len), .little);
+    try list.appendSlice(allocator, &len);
+    try list.appendSlice(allocator, value);
+}
+
+fn putInt(list: *std.ArrayList(u8), allocator: std.mem.Allocator, value: u32) !void {
+    var bytes: [4]u8 = undefined;
+    std.mem.writeInt(u32, &bytes, value, .little);
+    try list.appendSlice(allocator, &bytes);
+}
+
+test "tree_builder - builds nested elements in document order" {
+    const allocator = testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    var builder = TreeBuilder.init(doc);
+    defer builder.deinit();
+
+    try builder.open("list", &.{.{ .name = "class", .value = "rows" }});
+    try builder.open("item", &.{});
+    try builder.text("first");
+    try builder.text(" row");
+    try builder.close();
+    try builder.open("item", &.{.{ .name = "id", .value = "second" }});
+    try builder.close();
+    try builder.close();
+    try testing.expectError(error.InvalidStateError, builder.close());
+
+    const fragment = try builder.finish();
+    defer fragment.prototype.release();
+
+    const list: *Element = @fieldParentPtr("prototype", fragment.prototype.first_child.?);
+    try testing.expectEqualStrings("list", list.tag_name);
+    try testing.expectEqualStrings("rows", list.getAttribute("class").?);
+    try testing.expect(fragment.prototype.first_child == fragment.prototype.last_child);
+
+    const first: *Element = @fieldParentPtr("prototype", list.prototype.first_child.?);
+    const second: *Element = @fieldParentPtr("prototype", list.prototype.last_child.?);
+    try testing.expect(first.prototype.next_sibling == &second.prototype);
+    try testing.expect(second.prototype.previous_sibling == &first.prototype);
+    try testing.expect(second.prototype.parent_node == &list.prototype);
+    try testing.expectEqualStrings("second", second.getAttribute("id").?);
+
+    // Adjacent text joins one node
+    const text: *Text = @fieldParentPtr("prototype", first.prototype.first_child.?);
+    try testing.expect(text.prototype.next_sibling == null);
+    try testing.expectEqualStrings("first row", text.data);
+}
+
+test "tree_builder - finished fragment inserts as one mutation" {
+    const allocator = testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    _ = try doc.prototype.appendChild(&root.prototype);
+
+    const observer = try MutationObserver.init(allocator, ignoreRecords, null);
+    defer observer.deinit();
+    try observer.observe(&root.prototype, .{ .child_list = true, .subtree = true });
+
+    var builder = TreeBuilder.init(doc);
+    defer builder.deinit();
+    for (0..100) |_| {
+        try builder.open("row", &.{.{ .name = "id", .value = "row" }});
+        try builder.text("cell");
+        try builder.close();
+    }
+    // Open elements are closed by finish
+    try builder.open("row", &.{});
+
+    const fragment = try builder.finish();
+    defer fragment.prototype.release();
+    _ = try root.prototype.appendChild(&fragment.prototype);
+
+    const records = observer.takeRecords();
+    defer {
+        for (records) |record| record.deinit();
+        allocator.free(records);
+    }
+    try testing.expectEqual(@as(usize, 1), records.len);
+    try testing.expectEqual(@as(usize, 101), records[0].added_nodes.items.len);
+
+    // Built elements are connected like any inserted ones
+    const row = doc.getElementById("row").?;
+    try testing.expect(row.prototype.parent_node == &root.prototype);
+    try testing.expect(row.prototype.isConnected());
+
+    // The builder starts over on the next node
+    try builder.text("again");
+    const next = try builder.finish();
+    defer next.prototype.release();
+    try testing.expect(next != fragment);
+    try testing.expect(next.prototype.first_child.?.node_type == .text);
+}
+
+test "tree_builder - write runs an instruction buffer" {
+    const allocator = testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    var chunk: std.ArrayList(u8) = .empty;
+    defer chunk.deinit(allocator);
+
+    try chunk.append(allocator, tree_builder.op_open);
+    try putString(&chunk, allocator, "list");
+    try putInt(&chunk, allocator, 1);
+    try putString(&chunk, allocator, "class");
+    try putString(&chunk, allocator, "rows");
+    try chunk.append(allocator, tree_builder.op_open);
+    try putString(&chunk, allocator, "item");
+    try putInt(&chunk, allocator, 0);
+    try chunk.append(allocator, tree_builder.op_text);
+    try putString(&chunk, allocator, "line");
+
+    var builder = TreeBuilder.init(doc);
+    defer builder.deinit();
+    try builder.write(chunk.items);
+
+    // Open elements carry over to the next chunk
+    try builder.write(&.{ tree_builder.op_close, tree_builder.op_close });
+    try testing.expectError(error.InvalidStateError, builder.write(&.{tree_builder.op_close}));
+
+    // Truncated and unknown instructions
+    try testing.expectError(error.SyntaxError, builder.write(&.{ tree_builder.op_text, 5, 0 }));
+    try testing.expectError(error.SyntaxError, builder.write(&.{0xFF}));
+
+    const fragment = try builder.finish();
+    defer fragment.prototype.release();
+
+    const list: *Element = @fieldParentPtr("prototype", fragment.prototype.first_child.?);
+    try testing.expectEqualStrings("rows", list.getAttribute("class").?);
+    const item: *Element = @fieldParentPtr("prototype", list.prototype.first_child.?);
+    try testing.expectEqualStrings("item", item.tag_name);
+    const text: *Text = @fieldParentPtr("prototype", item.prototype.first_child.?);
+    try testing.expectEqualStrings("line", text.data);
+}
@@ -0,0 +1,294 @@
+//! tree_diff Tests
+//!
+//! Tests for tree_diff: the ops emitted for common changes, and patches
+//! that, applied to the old tree, reproduce the new one.
+
+const std = @import("std");
+const dom = @import("dom");
+
+const testing = std.testing;
+const tree_diff = dom.tree_diff;
+const serializer = dom.serializer;
+const Document = dom.Document;
+const Element = dom.Element;
+const MutationObserver = dom.MutationObserver;
+const MutationRecord = dom.MutationRecord;
+
+fn ignoreRecords(_: []const *MutationRecord, _: *MutationObserver, _: ?*anyopaque) void {}
+
+fn freeRecords(observer: *MutationObserver, records: []const *MutationRecord) void {
+    for (records) |record| record.deinit();
+    observer.allocator.free(records);
+}
+
+/// A list with one row per key; a key starting with '*' gets class "selected".
+fn buildList(doc: *Document, keys: []const []const u8) !*Element {
+    const list = try doc.createElement("list");
+    for (keys) |key| {
+        const row = try doc.createElement("row");
+        const selected = key[0] == '*';
+        try row.setAttribute("key", if (selected) key[1..] else key);
+        if (selected) try row.setAttribute("class", "selected");
+        _ = try row.prototype.appendChild(&(try doc.createTextNode(if (selected) key[1..] else key)).prototype);
+        _ = try list.prototype.appendChild(&row.prototype);
+    }
+    return list;
+}
+
+/// Diffs, applies the patch to `old` and checks the markup matches `new`.
+fn expectPatchReproduces(old: *Element, new: *Element, options: tree_diff.Options) !tree_diff.PatchBuffer {
+    const allocator = testing.allocator;
+    const patch = try tree_diff.diff(allocator, &old.prototype, &new.prototype, options);
+    errdefer tree_diff.freePatch(allocator, patch);
+
+    const root = try tree_diff.apply(allocator, patch, &old.prototype, &new.prototype);
+    try testing.expectEqual(&old.prototype, root);
+
+    const expected = try serializer.serializeAlloc(allocator, &new.prototype, 0);
+    defer allocator.free(expected);
+    const actual = try serializer.serializeAlloc(allocator, &old.prototype, 0);
+    defer allocator.free(actual);
+    try testing.expectEqualStrings(expected, actual);
+    return patch;
+}
+
+fn countOps(patch: tree_diff.PatchBuffer, op: tree_diff.PatchOp) usize {
+    var count: usize = 0;
+    for (tree_diff.recordsOf(patch)) |record| {
+        if (record.op == op) count += 1;
+    }
+    return count;
+}
+
+test "tree_diff - identical trees give an empty patch" {
+    const allocator = testing.allocator;
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const old = try buildList(doc, &.{ "a", "b", "c" });
+    defer old.prototype.release();
+    const new = try buildList(doc, &.{ "a", "b", "c" });
+    defer new.prototype.release();
+
+    const patch = try tree_diff.diff(allocator, &old.prototype, &new.prototype, .{ .key = "key" });
+    defer tree_diff.freePatch(allocator, patch);
+
+    const header = tree_diff.headerOf(patch);
+    try testing.expectEqual(tree_diff.magic, header.magic);
+    try testing.expectEqual(@as(u32, 0), header.op_count);
+    try testing.expectEqual(@as(u32, 7), header.old_node_count);
+    try testing.expectEqual(@as(u32, 7), header.new_node_count);
+}
+
+test "tree_diff - attribute and text changes" {
+    const allocator = testing.allocator;
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const old = try buildList(doc, &.{ "a", "b" });
+    defer old.prototype.release();
+    const new = try buildList(doc, &.{ "a", "*b" });
+    defer new.prototype.release();
+    try new.setAttribute("title", "rows");
+    try old.firstElementChild().?.prototype.first_child.?.setNodeValue("changed");
+
+    const patch = try expectPatchReproduces(old, new, .{ .key = "key" });
+    defer tree_diff.freePatch(allocator, patch);
+
+    try testing.expectEqual(@as(usize, 2), countOps(patch, .set_attribute));
+    try testing.expectEqual(@as(usize, 1), countOps(patch, .set_text));
+    try testing.expectEqual(@as(u32, 3), tree_diff.headerOf(patch).op_count);
+
+    // The class change addresses the second row: list 0, row 1, text 2, row 3
+    for (tree_diff.recordsOf(patch)) |record| {
+        if (record.op == .set_attribute and std.mem.eql(u8, "class", tree_diff.stringOf(patch, record.name).?)) {
+            try testing.expectEqual(@as(u32, 3), record.target);
+            try testing.expectEqualStrings("selected", tree_diff.stringOf(patch, record.value).?);
+            try testing.expect(tree_diff.stringOf(patch, record.namespace) == null);
+        }
+    }
+}
+
+test "tree_diff - keyed children are moved, not recreated" {
+    const allocator = testing.allocator;
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const old = try buildList(doc, &.{ "a", "b", "c", "d", "e" });
+    defer old.prototype.release();
+    const new = try buildList(doc, &.{ "e", "a", "c", "f", "b" });
+    defer new.prototype.release();
+
+    const patch = try expectPatchReproduces(old, new, .{ .key = "key" });
+    defer tree_diff.freePatch(allocator, patch);
+
+    // "d" goes, "f" comes, and of the four kept rows only two move
+    try testing.expectEqual(@as(usize, 1), countOps(patch, .remove));
+    try testing.expectEqual(@as(usize, 1), countOps(patch, .insert));
+    try testing.expectEqual(@as(usize, 2), countOps(patch, .move));
+    try testing.expectEqual(@as(usize, 0), countOps(patch, .set_text));
+}
+
+test "tree_diff - unkeyed children match by position" {
+    const allocator = testing.allocator;
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const old = try buildList(doc, &.{ "a", "b", "c" });
+    defer old.prototype.release();
+    const new = try buildList(doc, &.{ "c", "a" });
+    defer new.prototype.release();
+
+    const patch = try expectPatchReproduces(old, new, .{});
+    defer tree_diff.freePatch(allocator, patch);
+
+    // Without a key the rows are updated in place and the last one removed
+    try testing.expectEqual(@as(usize, 1), countOps(patch, .remove));
+    try testing.expectEqual(@as(usize, 0), countOps(patch, .move));
+    try testing.expectEqual(@as(usize, 2), countOps(patch, .set_text));
+}
+
+test "tree_diff - different node types and names are replaced" {
+    const allocator = testing.allocator;
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const old = try doc.createElement("list");
+    defer old.prototype.release();
+    _ = try old.prototype.appendChild(&(try doc.createElement("row")).prototype);
+    _ = try old.prototype.appendChild(&(try doc.createComment("note")).prototype);
+
+    const new = try doc.createElement("list");
+    defer new.prototype.release();
+    _ = try new.prototype.appendChild(&(try doc.createElement("cell")).prototype);
+    _ = try new.prototype.appendChild(&(try doc.createTextNode("note")).prototype);
+
+    const patch = try expectPatchReproduces(old, new, .{});
+    defer tree_diff.freePatch(allocator, patch);
+    try testing.expectEqual(@as(usize, 2), countOps(patch, .remove));
+    try testing.expectEqual(@as(usize, 2), countOps(patch, .insert));
+
+    // Incompatible roots become one replace
+    const leaf = try doc.createElement("leaf");
+    defer leaf.prototype.release();
+    const root_patch = try tree_diff.diff(allocator, &old.prototype, &leaf.prototype, .{});
+    defer tree_diff.freePatch(allocator, root_patch);
+    const records = tree_diff.recordsOf(root_patch);
+    try testing.expectEqual(@as(usize, 1), records.len);
+    try testing.expectEqual(tree_diff.PatchOp.replace, records[0].op);
+    try testing.expectEqual(@as(u32, 0), records[0].target);
+    try testing.expectEqual(@as(u32, 0), records[0].source);
+}
+
+test "tree_diff - nested changes across documents" {
+    const allocator = testing.allocator;
+    const old_doc = try Document.init(allocator);
+    defer old_doc.release();
+    const new_doc = try Document.init(allocator);
+    defer new_doc.release();
+
+    const old = try old_doc.createElement("root");
+    defer old.prototype.release();
+    const new = try new_doc.createElement("root");
+    defer new.prototype.release();
+    for ([_]*Document{ old_doc, new_doc }, [_]*Element{ old, new }, 0..) |doc, root, version| {
+        for (0..4) |i| {
+            const keys: []const []const u8 = if (version == 0) &.{ "a", "b", "c" } else if (i % 2 == 0) &.{ "c", "*b", "x", "a" } else &.{"a"};
+            const list = try buildList(doc, keys);
+            _ = try root.prototype.appendChild(&list.prototype);
+        }
+    }
+
+    const patch = try expectPatchReproduces(old, new, .{ .key = "key" });
+    defer tree_diff.freePatch(allocator, patch);
+    try testing.expect(countOps(patch, .move) > 0);
+}
+
+/// The nodes of `root` in preorder, the numbering patches use.
+fn preorder(allocator: std.mem.Allocator, root: *dom.Node) ![]*dom.Node {
+    var nodes = std.ArrayList(*dom.Node){};
+    errdefer nodes.deinit(allocator);
+    try nodes.append(allocator, root);
+    var i: usize = 0;
+    while (i < nodes.items.len) : (i += 1) {
+        // Insert each node's children right after it
+        var children = std.ArrayList(*dom.Node){};
+        defer children.deinit(allocator);
+        var child = nodes.items[i].first_child;
+        while (child) |node| : (child = node.next_sibling) try children.append(allocator, node);
+        try nodes.insertSlice(allocator, i + 1, children.items);
+    }
+    return nodes.toOwnedSlice(allocator);
+}
+
+test "tree_diff - replay applies received bytes to node tables in one batch" {
+    const allocator = testing.allocator;
+    const doc = try Document.init(allocator);
+    defer doc.release();
+    const source_doc = try Document.init(allocator);
+    defer source_doc.release();
+
+    const list = try buildList(doc, &.{ "a", "b" });
+    _ = try doc.prototype.appendChild(&list.prototype);
+    const next = try buildList(source_doc, &.{ "a", "b", "c", "d", "e" });
+    defer next.prototype.release();
+
+    // As received over the wire: a copy of the diff output
+    const patch = try tree_diff.diff(allocator, &list.prototype, &next.prototype, .{ .key = "key" });
+    defer tree_diff.freePatch(allocator, patch);
+    const received = try allocator.alignedAlloc(u8, tree_diff.buffer_alignment, patch.len);
+    defer allocator.free(received);
+    @memcpy(received, patch);
+    try tree_diff.validate(received);
+
+    const targets = try preorder(allocator, &list.prototype);
+    defer allocator.free(targets);
+    const sources = try preorder(allocator, &next.prototype);
+    defer allocator.free(sources);
+
+    const observer = try MutationObserver.init(allocator, ignoreRecords, null);
+    defer observer.deinit();
+    try observer.observe(&list.prototype, .{ .child_list = true });
+
+    try tree_diff.replay(allocator, doc, received, targets, sources);
+
+    // The three rows are one insertion run, so the batch gives one record
+    const records = observer.takeRecords();
+    defer freeRecords(observer, records);
+    try testing.expectEqual(@as(usize, 1), records.len);
+    try testing.expectEqual(@as(usize, 3), records[0].added_nodes.items.len);
+
+    const expected = try serializer.serializeAlloc(allocator, &next.prototype, 0);
+    defer allocator.free(expected);
+    const actual = try serializer.serializeAlloc(allocator, &list.prototype, 0);
+    defer allocator.free(actual);
+    try testing.expectEqualStrings(expected, actual);
+}
+
+test "tree_diff - validate and replay reject bad patches" {
+    const allocator = testing.allocator;
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const old = try buildList(doc, &.{"a"});
+    defer old.prototype.release();
+    const new = try buildList(doc, &.{"*a"});
+    defer new.prototype.release();
+
+    const patch = try tree_diff.diff(allocator, &old.prototype, &new.prototype, .{ .key = "key" });
+    defer tree_diff.freePatch(allocator, patch);
+    try testing.expectEqual(@as(u32, 1), tree_diff.headerOf(patch).op_count);
+
+    // Truncated, or with an unknown op
+    try testing.expectError(error.SyntaxError, tree_diff.validate(patch[0 .. patch.len - 4]));
+    const corrupt = try allocator.alignedAlloc(u8, tree_diff.buffer_alignment, patch.len);
+    defer allocator.free(corrupt);
+    @memcpy(corrupt, patch);
+    corrupt[@sizeOf(tree_diff.PatchHeader)] = 99;
+    try testing.expectError(error.SyntaxError, tree_diff.validate(corrupt));
+
+    // The class change targets row 1, outside a table of one node
+    const targets = [_]*dom.Node{&old.prototype};
+    try testing.expectError(error.IndexSizeError, tree_diff.replay(allocator, doc, patch, &targets, &.{}));
+    try testing.expect(old.firstElementChild().?.getAttribute("class") == null);
+}
@@ -299,3 +299,43 @@ test "tree_helpers - tree_helpers.countElementChildren" {
     elem2.prototype.previous_sibling = null;
 }
 
+
+test "tree_helpers - descendant text content without concatenating" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    defer root.prototype.release();
+    try testing.expectEqualStrings("", tree_helpers.descendantTextContentSlice(&root.prototype).?);
+
+    const item = try doc.createElement("item");
+    _ = try root.prototype.appendChild(&item.prototype);
+    const first = try doc.createTextNode("alpha");
+    _ = try item.prototype.appendChild(&first.prototype);
+    const empty = try doc.createTextNode("");
+    _ = try root.prototype.appendChild(&empty.prototype);
+    const comment = try doc.createComment("skipped");
+    _ = try root.prototype.appendChild(&comment.prototype);
+
+    // One non-empty Text descendant: its own storage
+    const slice = tree_helpers.descendantTextContentSlice(&root.prototype).?;
+    try testing.expectEqual(first.data.ptr, slice.ptr);
+    try testing.expectEqualStrings("alpha", slice);
+
+    const second = try doc.createTextNode(" beta");
+    _ = try root.prototype.appendChild(&second.prototype);
+    try testing.expect(tree_helpers.descendantTextContentSlice(&root.prototype) == null);
+
+    try testing.expectEqual(@as(usize, 10), tree_helpers.descendantTextContentLength(&root.prototype));
+    var buffer: [16]u8 = undefined;
+    try testing.expectEqual(@as(usize, 10), tree_helpers.copyDescendantTextContent(&root.prototype, &buffer));
+    try testing.expectEqualStrings("alpha beta", buffer[0..10]);
+    try testing.expectEqual(@as(usize, 10), tree_helpers.copyDescendantTextContent(&root.prototype, buffer[0..4]));
+    try testing.expectEqualStrings("alph", buffer[0..4]);
+
+    const joined = try tree_helpers.getDescendantTextContent(&root.prototype, allocator);
+    defer allocator.free(joined);
+    try testing.expectEqualStrings("alpha beta", joined);
+}
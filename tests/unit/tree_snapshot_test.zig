@@ -0,0 +1,101 @@
+//! tree_snapshot Tests
+//!
+//! Tests for tree_snapshot functionality.
+
+const std = @import("std");
+const dom = @import("dom");
+
+const testing = std.testing;
+const tree_snapshot = dom.tree_snapshot;
+const Document = dom.Document;
+
+test "tree_snapshot - single node" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const elem = try doc.createElement("element");
+    defer elem.prototype.release();
+
+    const buffer = try tree_snapshot.snapshotSubtree(allocator, &elem.prototype, 0);
+    defer tree_snapshot.freeSnapshot(allocator, buffer);
+
+    const header = tree_snapshot.headerOf(buffer);
+    try testing.expectEqual(tree_snapshot.magic, header.magic);
+    try testing.expectEqual(@as(u32, 1), header.node_count);
+    try testing.expectEqual(@as(u32, 0), header.name_count);
+
+    const records = tree_snapshot.recordsOf(buffer);
+    try testing.expectEqual(@as(u8, 1), records[0].node_type);
+    try testing.expectEqual(tree_snapshot.none, records[0].parent);
+    try testing.expectEqual(tree_snapshot.none, records[0].next_sibling);
+    try testing.expectEqual(tree_snapshot.none, records[0].name_id);
+}
+
+test "tree_snapshot - preorder with parent and sibling indices" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    // root -> (a -> (b), c)
+    const root = try doc.createElement("root");
+    defer root.prototype.release();
+    const a = try doc.createElement("item");
+    _ = try root.prototype.appendChild(&a.prototype);
+    const b = try doc.createElement("leaf");
+    _ = try a.prototype.appendChild(&b.prototype);
+    const c = try doc.createElement("item");
+    _ = try root.prototype.appendChild(&c.prototype);
+
+    const buffer = try tree_snapshot.snapshotSubtree(allocator, &root.prototype, tree_snapshot.include_names);
+    defer tree_snapshot.freeSnapshot(allocator, buffer);
+
+    const records = tree_snapshot.recordsOf(buffer);
+    try testing.expectEqual(@as(usize, 4), records.len);
+
+    // Preorder: root, a, b, c
+    try testing.expectEqual(tree_snapshot.none, records[0].parent);
+    try testing.expectEqual(@as(u32, 0), records[1].parent);
+    try testing.expectEqual(@as(u32, 1), records[2].parent);
+    try testing.expectEqual(@as(u32, 0), records[3].parent);
+
+    try testing.expectEqual(@as(u32, 3), records[1].next_sibling);
+    try testing.expectEqual(tree_snapshot.none, records[2].next_sibling);
+    try testing.expectEqual(tree_snapshot.none, records[3].next_sibling);
+
+    // Interned tag names are deduplicated
+    const header = tree_snapshot.headerOf(buffer);
+    try testing.expectEqual(@as(u32, 3), header.name_count);
+    try testing.expectEqual(records[1].name_id, records[3].name_id);
+    try testing.expectEqualStrings("item", tree_snapshot.nameOf(buffer, records[1].name_id));
+    try testing.expectEqualStrings("leaf", tree_snapshot.nameOf(buffer, records[2].name_id));
+}
+
+test "tree_snapshot - text data" {
+    const allocator = std.testing.allocator;
+
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    defer root.prototype.release();
+    const text = try doc.createTextNode("hello");
+    _ = try root.prototype.appendChild(&text.prototype);
+    const comment = try doc.createComment("note");
+    _ = try root.prototype.appendChild(&comment.prototype);
+
+    const buffer = try tree_snapshot.snapshotSubtree(allocator, &root.prototype, tree_snapshot.include_text);
+    defer tree_snapshot.freeSnapshot(allocator, buffer);
+
+    const records = tree_snapshot.recordsOf(buffer);
+    try testing.expectEqual(@as(usize, 3), records.len);
+    try testing.expectEqual(@as(u8, 3), records[1].node_type);
+    try testing.expectEqualStrings("hello", tree_snapshot.textOf(buffer, records[1]));
+    try testing.expectEqual(@as(u8, 8), records[2].node_type);
+    try testing.expectEqualStrings("note", tree_snapshot.textOf(buffer, records[2]));
+
+    // Elements carry no text
+    try testing.expectEqual(@as(u32, 0), records[0].text_length);
+}
@@ -5,6 +5,7 @@ const Document = dom.Document;
 const Element = dom.Element;
 const TreeWalker = dom.TreeWalker;
 const NodeFilter = dom.NodeFilter;
+const ElementFilter = dom.ElementFilter;
 
 test "TreeWalker firstChild navigation" {
     const allocator = std.testing.allocator;
@@ -19,7 +20,7 @@ test "TreeWalker firstChild navigation" {
     _ = try doc.prototype.appendChild(&root.prototype);
 
     const walker = try doc.createTreeWalker(&root.prototype, NodeFilter.SHOW_ALL, null);
-    // No need to deinit - arena allocated, freed with document
+    defer walker.deinit();
 
     try std.testing.expectEqual(&root.prototype, walker.current_node);
     try std.testing.expectEqual(&child1.prototype, walker.firstChild().?);
@@ -39,7 +40,7 @@ test "TreeWalker nextSibling navigation" {
     _ = try doc.prototype.appendChild(&root.prototype);
 
     const walker = try doc.createTreeWalker(&root.prototype, NodeFilter.SHOW_ALL, null);
-    // No need to deinit - arena allocated, freed with document
+    defer walker.deinit();
 
     _ = walker.firstChild();
     try std.testing.expectEqual(&child2.prototype, walker.nextSibling().?);
@@ -56,7 +57,7 @@ test "TreeWalker parentNode navigation" {
     _ = try doc.prototype.appendChild(&root.prototype);
 
     const walker = try doc.createTreeWalker(&root.prototype, NodeFilter.SHOW_ALL, null);
-    // No need to deinit - arena allocated, freed with document
+    defer walker.deinit();
 
     _ = walker.firstChild();
     try std.testing.expectEqual(&root.prototype, walker.parentNode().?);
@@ -75,9 +76,84 @@ test "TreeWalker nextNode traversal" {
     _ = try doc.prototype.appendChild(&root.prototype);
 
     const walker = try doc.createTreeWalker(&root.prototype, NodeFilter.SHOW_ALL, null);
-    // No need to deinit - arena allocated, freed with document
+    defer walker.deinit();
 
     try std.testing.expectEqual(&child1.prototype, walker.nextNode().?);
     try std.testing.expectEqual(&child2.prototype, walker.nextNode().?);
     try std.testing.expect(walker.nextNode() == null);
 }
+
+test "TreeWalker with ElementFilter" {
+    const allocator = std.testing.allocator;
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    const list = try doc.createElement("list");
+    const item1 = try doc.createElement("item");
+    const item2 = try doc.createElement("item");
+    const row = try doc.createElement("row");
+    try item2.setAttribute("class", "visible");
+    try row.setAttribute("class", "visible");
+    _ = try root.prototype.appendChild(&list.prototype);
+    _ = try list.prototype.appendChild(&item1.prototype);
+    _ = try list.prototype.appendChild(&item2.prototype);
+    _ = try root.prototype.appendChild(&row.prototype);
+    _ = try doc.prototype.appendChild(&root.prototype);
+
+    var filter = ElementFilter.init(allocator);
+    defer filter.deinit();
+    try filter.addTagName("item");
+    try filter.addTagName("row");
+
+    // Skip: "list" is passed over but its children are still visited
+    const walker = try doc.createTreeWalker(&root.prototype, NodeFilter.SHOW_ELEMENT, filter.nodeFilter());
+    defer walker.deinit();
+    try std.testing.expectEqual(&item1.prototype, walker.nextNode().?);
+    try std.testing.expectEqual(&item2.prototype, walker.nextNode().?);
+    try std.testing.expectEqual(&row.prototype, walker.nextNode().?);
+    try std.testing.expect(walker.nextNode() == null);
+
+    // Class predicate
+    try filter.setClassName("visible");
+    const visible = try doc.createTreeWalker(&root.prototype, NodeFilter.SHOW_ELEMENT, filter.nodeFilter());
+    defer visible.deinit();
+    try std.testing.expectEqual(&item2.prototype, visible.nextNode().?);
+    try std.testing.expectEqual(&row.prototype, visible.nextNode().?);
+    try std.testing.expect(visible.nextNode() == null);
+
+    // Reject: the "list" subtree is pruned
+    filter.miss = .reject;
+    const pruned = try doc.createTreeWalker(&root.prototype, NodeFilter.SHOW_ELEMENT, filter.nodeFilter());
+    defer pruned.deinit();
+    try std.testing.expectEqual(&row.prototype, pruned.nextNode().?);
+    try std.testing.expect(pruned.nextNode() == null);
+}
+
+test "TreeWalker references its current node" {
+    const allocator = std.testing.allocator;
+    const doc = try Document.init(allocator);
+    defer doc.release();
+
+    const root = try doc.createElement("root");
+    const item = try doc.createElement("item");
+    _ = try root.prototype.appendChild(&item.prototype);
+    _ = try doc.prototype.appendChild(&root.prototype);
+
+    const walker = try doc.createTreeWalker(&root.prototype, NodeFilter.SHOW_ALL, null);
+    defer walker.deinit();
+
+    const base = item.prototype.getRefCount();
+    try std.testing.expectEqual(&item.prototype, walker.firstChild().?);
+    try std.testing.expectEqual(base + 1, item.prototype.getRefCount());
+
+    // A removed current node outlives its last other owner
+    _ = try root.prototype.removeChild(&item.prototype);
+    item.prototype.release();
+    try std.testing.expectEqual(base, item.prototype.getRefCount());
+    try std.testing.expectEqual(&item.prototype, walker.current_node);
+
+    // Moving away drops the reference and frees it
+    walker.setCurrentNode(&root.prototype);
+    try std.testing.expectEqual(&root.prototype, walker.current_node);
+}
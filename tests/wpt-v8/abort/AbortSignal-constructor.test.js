@@ -0,0 +1,20 @@
+// AbortSignal is not constructible: signals come from AbortController and
+// AbortSignal.abort(), any() and timeout()
+
+"use strict";
+
+test(() => {
+  assert_throws_js(TypeError, () => new AbortSignal());
+  assert_throws_js(TypeError, () => AbortSignal());
+}, "new AbortSignal() throws a TypeError");
+
+test(() => {
+  const controller = new AbortController();
+  assert_true(controller.signal instanceof AbortSignal);
+  assert_false(controller.signal.aborted);
+  controller.signal.throwIfAborted();
+
+  const aborted = AbortSignal.abort("done");
+  assert_true(aborted.aborted);
+  assert_throws_exactly("done", () => aborted.throwIfAborted());
+}, "Signals created by the bindings are still usable");
@@ -0,0 +1,38 @@
+// Events the implementation creates itself reach script listeners as
+// wrappers built without running the Event constructor's argument checks
+"use strict";
+
+test(() => {
+  const controller = new AbortController();
+  let seen = null;
+  controller.signal.addEventListener("abort", event => {
+    seen = {
+      type: event.type,
+      isEvent: event instanceof Event,
+      target: event.target,
+      bubbles: event.bubbles,
+      cancelable: event.cancelable,
+    };
+  });
+  controller.abort();
+
+  assert_not_equals(seen, null, "listener ran");
+  assert_equals(seen.type, "abort");
+  assert_true(seen.isEvent, "wrapper is an Event");
+  assert_equals(seen.target, controller.signal);
+  assert_false(seen.bubbles);
+  assert_false(seen.cancelable);
+}, "abort event created by the implementation is passed to a script listener");
+
+test(() => {
+  const controller = new AbortController();
+  let type = null;
+  controller.signal.addEventListener("abort", { handleEvent(event) { type = event.type; } });
+  controller.abort();
+  assert_equals(type, "abort");
+}, "abort event created by the implementation is passed to a callback interface listener");
+
+test(() => {
+  assert_throws_js(TypeError, () => new Event());
+  assert_throws_js(TypeError, () => new CustomEvent());
+}, "script construction still requires the type argument");
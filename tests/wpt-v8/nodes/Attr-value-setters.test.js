@@ -0,0 +1,37 @@
+// value, nodeValue and textContent of an attached Attr all set the
+// attribute on its element
+"use strict";
+
+for (const setter of ["value", "nodeValue", "textContent"]) {
+  test(() => {
+    const element = document.createElement("element");
+    element.setAttribute("title", "first");
+    const attr = element.getAttributeNode("title");
+    attr[setter] = "second";
+    assert_equals(attr.value, "second");
+    assert_equals(element.getAttribute("title"), "second");
+    assert_equals(element.getAttributeNode("title"), attr);
+  }, `Attr.${setter} setter changes the owner element's attribute`);
+
+  test(() => {
+    const element = document.createElement("element");
+    element.setAttributeNS("http://www.w3.org/1999/xlink", "xlink:href", "#first");
+    const attr = element.getAttributeNodeNS("http://www.w3.org/1999/xlink", "href");
+    attr[setter] = "#second";
+    assert_equals(attr.value, "#second");
+    assert_equals(element.getAttributeNS("http://www.w3.org/1999/xlink", "href"), "#second");
+  }, `Attr.${setter} setter changes a namespaced attribute`);
+}
+
+test(() => {
+  const element = document.createElement("element");
+  element.setAttribute("title", "first");
+  const attr = element.getAttributeNode("title");
+  const observer = new MutationObserver(() => {});
+  observer.observe(element, { attributes: true, attributeOldValue: true });
+  attr.textContent = "second";
+  const records = observer.takeRecords();
+  assert_equals(records.length, 1);
+  assert_equals(records[0].attributeName, "title");
+  assert_equals(records[0].oldValue, "first");
+}, "Attr.textContent setter queues an attributes record");
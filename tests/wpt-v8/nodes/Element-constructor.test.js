@@ -0,0 +1,31 @@
+// Element is not constructible: only the bindings (wrapper creation) and
+// super() from a custom element upgrade may run its constructor
+
+"use strict";
+
+test(() => {
+  assert_throws_js(TypeError, () => new Element());
+  assert_throws_js(TypeError, () => Element());
+}, "new Element() throws a TypeError");
+
+test(() => {
+  class XItem extends Element {}
+  customElements.define("x-item", XItem);
+  assert_throws_js(TypeError, () => new XItem());
+}, "Constructing a custom element class outside an upgrade throws a TypeError");
+
+test(() => {
+  class XRow extends Element {
+    constructor() {
+      super();
+      this.upgraded = true;
+    }
+  }
+  const element = document.createElement("x-row");
+  document.documentElement.appendChild(element);
+  customElements.define("x-row", XRow);
+  assert_true(element instanceof XRow);
+  assert_true(element.upgraded);
+  assert_equals(element.tagName, "x-row");
+  element.remove();
+}, "Upgrades still construct the element being upgraded");
@@ -0,0 +1,13 @@
+// A shadow root's nodeType is DOCUMENT_FRAGMENT_NODE on every call path,
+// including Fast API calls from optimized code
+
+"use strict";
+
+test(() => {
+  const host = document.createElement("host");
+  const shadow = host.attachShadow({ mode: "open" });
+  const readNodeType = (node) => node.nodeType;
+  for (let i = 0; i < 100000; i++) {
+    assert_equals(readNodeType(shadow), Node.DOCUMENT_FRAGMENT_NODE);
+  }
+}, "ShadowRoot.nodeType stays 11 once the call site is optimized");
@@ -0,0 +1,22 @@
+// A static NodeList keeps its nodes alive after they leave the tree
+
+"use strict";
+
+test(() => {
+  const root = document.createElement("root");
+  for (let i = 0; i < 3; i++) {
+    const item = document.createElement("item");
+    item.setAttribute("data-index", String(i));
+    root.appendChild(item);
+  }
+  const list = root.querySelectorAll("item");
+  root.textContent = "";
+  for (let i = 0; i < 1000; i++) document.createElement("row");
+
+  assert_equals(list.length, 3);
+  for (let i = 0; i < list.length; i++) {
+    assert_equals(list[i].tagName, "item");
+    assert_equals(list.item(i).getAttribute("data-index"), String(i));
+    assert_equals(list[i].parentNode, null);
+  }
+}, "Nodes of a querySelectorAll() result outlive removal from the tree");
@@ -0,0 +1,42 @@
+// A TreeWalker or NodeIterator keeps the node it stands at alive after
+// script drops every other reference to it
+"use strict";
+
+function collectGarbage() {
+  if (typeof gc === "function") gc();
+}
+
+test(() => {
+  const root = document.createElement("root");
+  const walker = document.createTreeWalker(root);
+  walker.currentNode = document.createElement("item");
+  collectGarbage();
+  assert_equals(walker.currentNode.localName, "item");
+  assert_equals(walker.currentNode.parentNode, null);
+}, "currentNode set to a detached node outlives collection");
+
+test(() => {
+  const root = document.createElement("root");
+  root.appendChild(document.createElement("item"));
+  const walker = document.createTreeWalker(root);
+  walker.firstChild();
+  root.firstChild.remove();
+  collectGarbage();
+  assert_equals(walker.currentNode.localName, "item");
+  assert_equals(walker.nextNode(), null);
+}, "currentNode removed from the tree outlives collection");
+
+test(() => {
+  const root = document.createElement("root");
+  const list = root.appendChild(document.createElement("list"));
+  list.appendChild(document.createElement("item"));
+  const iterator = document.createNodeIterator(root);
+  iterator.nextNode();
+  iterator.nextNode();
+  iterator.nextNode();
+  list.remove();
+  collectGarbage();
+  assert_equals(iterator.referenceNode, root);
+  assert_false(iterator.pointerBeforeReferenceNode);
+  assert_equals(iterator.nextNode(), null);
+}, "referenceNode moves out of a removed subtree");
@@ -37,6 +37,7 @@ test "detach() should be a no-op" {
     _ = try doc.prototype.appendChild(&root.prototype);
 
     const iter = try doc.createNodeIterator(&root.prototype, NodeFilter.SHOW_ALL, null);
+    defer iter.deinit();
 
     iter.detach();
     iter.detach();
@@ -53,6 +54,7 @@ test "createNodeIterator() parameter defaults" {
     _ = try doc.prototype.appendChild(&root.prototype);
 
     const iter = try doc.createNodeIterator(&root.prototype, 0xFFFFFFFF, null);
+    defer iter.deinit();
 
     try std.testing.expectEqual(&root.prototype, iter.root);
     try std.testing.expectEqual(@as(u32, 0xFFFFFFFF), iter.what_to_show);
@@ -70,6 +72,7 @@ test "createNodeIterator() with zero whatToShow" {
     _ = try doc.prototype.appendChild(&root.prototype);
 
     const iter = try doc.createNodeIterator(&root.prototype, 0, null);
+    defer iter.deinit();
 
     try std.testing.expectEqual(&root.prototype, iter.root);
     try std.testing.expectEqual(@as(u32, 0), iter.what_to_show);
@@ -85,6 +88,7 @@ test "createNodeIterator() with specific whatToShow" {
     _ = try doc.prototype.appendChild(&root.prototype);
 
     const iter = try doc.createNodeIterator(&root.prototype, 42, null);
+    defer iter.deinit();
 
     try std.testing.expectEqual(&root.prototype, iter.root);
     try std.testing.expectEqual(&root.prototype, iter.reference_node);
@@ -101,6 +105,7 @@ test "nextNode() returns nodes in document order" {
     _ = try doc.prototype.appendChild(&root.prototype);
 
     const iter = try doc.createNodeIterator(&root.prototype, NodeFilter.SHOW_ALL, null);
+    defer iter.deinit();
 
     const node1 = iter.nextNode();
     try std.testing.expect(node1 != null);
@@ -143,6 +148,7 @@ test "previousNode() returns nodes in reverse document order" {
     _ = try doc.prototype.appendChild(&root.prototype);
 
     const iter = try doc.createNodeIterator(&root.prototype, NodeFilter.SHOW_ALL, null);
+    defer iter.deinit();
 
     while (iter.nextNode()) |_| {}
 
@@ -183,6 +189,7 @@ test "nextNode() with SHOW_ELEMENT filter" {
     _ = try doc.prototype.appendChild(&root.prototype);
 
     const iter = try doc.createNodeIterator(&root.prototype, NodeFilter.SHOW_ELEMENT, null);
+    defer iter.deinit();
 
     const node1 = iter.nextNode();
     try std.testing.expect(node1 != null);
@@ -215,6 +222,7 @@ test "nextNode() with SHOW_TEXT filter" {
     _ = try doc.prototype.appendChild(&root.prototype);
 
     const iter = try doc.createNodeIterator(&root.prototype, NodeFilter.SHOW_TEXT, null);
+    defer iter.deinit();
 
     const node1 = iter.nextNode();
     try std.testing.expect(node1 != null);
@@ -233,6 +241,7 @@ test "nextNode() with SHOW_COMMENT filter" {
     _ = try doc.prototype.appendChild(&root.prototype);
 
     const iter = try doc.createNodeIterator(&root.prototype, NodeFilter.SHOW_COMMENT, null);
+    defer iter.deinit();
 
     const node1 = iter.nextNode();
     try std.testing.expect(node1 != null);
@@ -251,6 +260,7 @@ test "nextNode() with combined filters" {
     _ = try doc.prototype.appendChild(&root.prototype);
 
     const iter = try doc.createNodeIterator(&root.prototype, NodeFilter.SHOW_ELEMENT | NodeFilter.SHOW_TEXT, null);
+    defer iter.deinit();
 
     const node1 = iter.nextNode();
     try std.testing.expect(node1 != null);
@@ -286,6 +296,7 @@ test "nextNode() does not traverse outside root" {
     _ = try doc.prototype.appendChild(&outer.prototype);
 
     const iter = try doc.createNodeIterator(&inner.prototype, NodeFilter.SHOW_ELEMENT, null);
+    defer iter.deinit();
 
     const node1 = iter.nextNode();
     try std.testing.expect(node1 != null);
@@ -313,6 +324,7 @@ test "previousNode() does not traverse outside root" {
     _ = try doc.prototype.appendChild(&outer.prototype);
 
     const iter = try doc.createNodeIterator(&inner.prototype, NodeFilter.SHOW_ELEMENT, null);
+    defer iter.deinit();
 
     while (iter.nextNode()) |_| {}
 
@@ -346,6 +358,7 @@ test "nested tree traversal with nextNode()" {
     _ = try doc.prototype.appendChild(&root.prototype);
 
     const iter = try doc.createNodeIterator(&root.prototype, NodeFilter.SHOW_ELEMENT, null);
+    defer iter.deinit();
 
     const nodes = [_]*Node{
         &root.prototype,
@@ -375,6 +388,7 @@ test "referenceNode and pointerBeforeReferenceNode tracking" {
     _ = try doc.prototype.appendChild(&root.prototype);
 
     const iter = try doc.createNodeIterator(&root.prototype, NodeFilter.SHOW_ELEMENT, null);
+    defer iter.deinit();
 
     try std.testing.expectEqual(&root.prototype, iter.reference_node);
     try std.testing.expectEqual(true, iter.pointer_before_reference_node);
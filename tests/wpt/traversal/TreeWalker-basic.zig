@@ -209,6 +209,6 @@ test "Walk over nodes" {
     try std.testing.expect(f_id != null);
     try std.testing.expectEqualStrings("f", f_id.?);
 
-    walker.current_node = elem_f_node;
+    walker.setCurrentNode(elem_f_node);
     try std.testing.expectEqual(elem_f_node, walker.current_node);
 }
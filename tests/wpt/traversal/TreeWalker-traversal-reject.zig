@@ -191,7 +191,7 @@ test "TreeWalker reject: parentNode" {
     try std.testing.expect(c1_node != null);
 
     // Set currentNode to C1
-    walker.current_node = &c1_node.?.prototype;
+    walker.setCurrentNode(&c1_node.?.prototype);
 
     // parentNode() from C1 should skip B1 (rejected) and find A1
     const a1 = walker.parentNode();
@@ -221,7 +221,7 @@ test "TreeWalker reject: previousSibling" {
     try std.testing.expect(b3_node != null);
 
     // Set currentNode to B3
-    walker.current_node = &b3_node.?.prototype;
+    walker.setCurrentNode(&b3_node.?.prototype);
 
     // previousSibling() from B3 should skip B2 and find B1
     const b1 = walker.previousSibling();
@@ -251,7 +251,7 @@ test "TreeWalker reject: previousNode" {
     try std.testing.expect(b3_node != null);
 
     // Set currentNode to B3
-    walker.current_node = &b3_node.?.prototype;
+    walker.setCurrentNode(&b3_node.?.prototype);
 
     // previousNode() from B3 should find B2
     const b2 = walker.previousNode();
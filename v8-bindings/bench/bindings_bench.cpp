@@ -0,0 +1,425 @@
+/**
+ * V8 DOM Bindings - Microbenchmarks
+ *
+ * Measures the binding glue between V8 and the DOM C-ABI: wrapping and
+ * unwrapping from C++, and property access, setAttribute(), querySelector()
+ * and traversal loops from JavaScript.
+ *
+ * Each benchmark times its own hot loop and is repeated with a growing
+ * operation count until one run takes at least --min-time milliseconds.
+ * Results are printed as a table on stderr and as JSON on stdout (or
+ * --out <file>), in the single-run shape of benchmarks/zig/baselines.zig,
+ * so the baseline gate can compare them with memory/performance_baselines.json.
+ *
+ * Build and run:
+ *   make bench
+ *   ./bench/bindings_bench --out results.json
+ *   ./bench/bindings_bench --filter getter --slots
+ *   cd .. && zig build baselines -- compare v8-bindings/results.json
+ */
+
+#include <v8.h>
+#include <libplatform/libplatform.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "v8_dom.h"
+#include "core/binding_state.h"
+#include "nodes/element_wrapper.h"
+#include "dom.h"
+
+namespace {
+
+struct Env {
+    v8::Isolate* isolate;
+    v8::Local<v8::Context> context;
+    DOMDocument* document;
+};
+
+// Returns the nanoseconds spent on `ops` operations
+using BenchFunc = std::function<uint64_t(Env& env, size_t ops)>;
+
+struct Benchmark {
+    const char* name;
+    const char* description;
+    BenchFunc run;
+};
+
+uint64_t NowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+v8::Local<v8::Value> RunScript(Env& env, const char* source) {
+    v8::Local<v8::String> code =
+        v8::String::NewFromUtf8(env.isolate, source).ToLocalChecked();
+    v8::TryCatch try_catch(env.isolate);
+    v8::Local<v8::Script> script;
+    v8::Local<v8::Value> result;
+    if (!v8::Script::Compile(env.context, code).ToLocal(&script) ||
+        !script->Run(env.context).ToLocal(&result)) {
+        v8::String::Utf8Value error(env.isolate, try_catch.Exception());
+        std::fprintf(stderr, "Script failed: %s\n%s\n", *error ? *error : "?", source);
+        std::exit(1);
+    }
+    return result;
+}
+
+/**
+ * A benchmark whose hot loop is JavaScript. `setup` runs once per process
+ * (it may define globals); `body` is the loop body of
+ * `for (let i = 0; i < n; i++) { body }`, with `sink` available to keep
+ * results alive.
+ */
+Benchmark ScriptBenchmark(const char* name, const char* description,
+                          const std::string& setup, const char* body) {
+    std::string source = std::string("(function (n) { let sink; for (let i = 0; i < n; i++) { ") +
+                         body + " } return sink; })";
+    std::string setup_source = setup;
+
+    // The function is compiled on first use and kept for the process
+    auto fn = std::make_shared<v8::Global<v8::Function>>();
+    return {name, description, [source, setup_source, fn](Env& env, size_t ops) -> uint64_t {
+        if (fn->IsEmpty()) {
+            if (!setup_source.empty()) {
+                RunScript(env, setup_source.c_str());
+            }
+            fn->Reset(env.isolate, RunScript(env, source.c_str()).As<v8::Function>());
+        }
+        v8::HandleScope handle_scope(env.isolate);
+        v8::Local<v8::Function> loop = fn->Get(env.isolate);
+        v8::Local<v8::Value> argv[] = {v8::Number::New(env.isolate, static_cast<double>(ops))};
+
+        uint64_t start = NowNs();
+        v8::Local<v8::Value> result;
+        if (!loop->Call(env.context, env.context->Global(), 1, argv).ToLocal(&result)) {
+            std::fprintf(stderr, "Benchmark loop threw\n");
+            std::exit(1);
+        }
+        return NowNs() - start;
+    }};
+}
+
+// Rows of 9 cells; every 10th cell has class "target" and a data-x attribute
+// (1000 elements in total, matching the Zig querySelector baselines)
+const char* kTreeSetup = R"JS(
+var root = document.createElement("root");
+document.appendChild(root);
+for (let r = 0; r < 100; r++) {
+    const row = document.createElement("row");
+    root.appendChild(row);
+    for (let c = 0; c < 9; c++) {
+        const cell = document.createElement("cell");
+        if ((r * 9 + c) % 10 === 0) {
+            cell.setAttribute("class", "target");
+            cell.setAttribute("data-x", String(c));
+        }
+        cell.appendChild(document.createTextNode("line"));
+        row.appendChild(cell);
+    }
+}
+)JS";
+
+const char* kElementSetup = R"JS(
+var item = document.createElement("item");
+item.id = "item-id";
+item.className = "first second";
+item.setAttribute("data-x", "value");
+item.appendChild(document.createTextNode("text content"));
+var text = item.firstChild;
+)JS";
+
+std::vector<Benchmark> AllBenchmarks() {
+    std::vector<Benchmark> benchmarks;
+
+    benchmarks.push_back({"wrap_cold", "ElementWrapper::Wrap() of an element without a wrapper",
+        [](Env& env, size_t ops) -> uint64_t {
+            std::vector<DOMElement*> elements(ops);
+            for (size_t i = 0; i < ops; i++) {
+                elements[i] = dom_document_createelement(env.document, "item");
+            }
+            uint64_t elapsed;
+            {
+                v8::HandleScope handle_scope(env.isolate);
+                uint64_t start = NowNs();
+                for (DOMElement* element : elements) {
+                    v8_dom::ElementWrapper::Wrap(env.isolate, env.context, element);
+                }
+                elapsed = NowNs() - start;
+            }
+            for (DOMElement* element : elements) {
+                dom_element_release(element);
+            }
+            return elapsed;
+        }});
+
+    benchmarks.push_back({"prewrap_subtree", "One wrapper of v8_dom::PrewrapSubtree() over fresh children of an element",
+        [](Env& env, size_t ops) -> uint64_t {
+            DOMElement* parent = dom_document_createelement(env.document, "list");
+            for (size_t i = 0; i < ops; i++) {
+                DOMElement* child = dom_document_createelement(env.document, "item");
+                dom_node_appendchild((DOMNode*)parent, (DOMNode*)child);
+            }
+            uint64_t elapsed;
+            {
+                v8::HandleScope handle_scope(env.isolate);
+                uint64_t start = NowNs();
+                v8_dom::PrewrapSubtree(env.isolate, env.context, (DOMNode*)parent, ops);
+                elapsed = NowNs() - start;
+            }
+            dom_element_release(parent);
+            return elapsed;
+        }});
+
+    benchmarks.push_back({"wrap_cached", "ElementWrapper::Wrap() of an element that has a wrapper",
+        [](Env& env, size_t ops) -> uint64_t {
+            DOMElement* element = dom_document_createelement(env.document, "item");
+            uint64_t elapsed;
+            {
+                v8::HandleScope handle_scope(env.isolate);
+                v8_dom::ElementWrapper::Wrap(env.isolate, env.context, element);
+                uint64_t start = NowNs();
+                for (size_t i = 0; i < ops; i++) {
+                    v8::HandleScope inner(env.isolate);
+                    v8_dom::ElementWrapper::Wrap(env.isolate, env.context, element);
+                }
+                elapsed = NowNs() - start;
+            }
+            dom_element_release(element);
+            return elapsed;
+        }});
+
+    benchmarks.push_back({"unwrap", "ElementWrapper::Unwrap() of an element wrapper",
+        [](Env& env, size_t ops) -> uint64_t {
+            DOMElement* element = dom_document_createelement(env.document, "item");
+            uint64_t elapsed;
+            {
+                v8::HandleScope handle_scope(env.isolate);
+                v8::Local<v8::Object> wrapper =
+                    v8_dom::ElementWrapper::Wrap(env.isolate, env.context, element);
+                uintptr_t sink = 0;
+                uint64_t start = NowNs();
+                for (size_t i = 0; i < ops; i++) {
+                    sink += reinterpret_cast<uintptr_t>(v8_dom::ElementWrapper::Unwrap(wrapper));
+                }
+                elapsed = NowNs() - start;
+                if (sink == 0) {
+                    std::fprintf(stderr, "Unwrap returned null\n");
+                }
+            }
+            dom_element_release(element);
+            return elapsed;
+        }});
+
+    // String getters, one C-ABI string crossing each
+    benchmarks.push_back(ScriptBenchmark("getter_tagName", "element.tagName from JS",
+        kElementSetup, "sink = item.tagName;"));
+    benchmarks.push_back(ScriptBenchmark("getter_localName", "element.localName from JS",
+        kElementSetup, "sink = item.localName;"));
+    benchmarks.push_back(ScriptBenchmark("getter_nodeName", "node.nodeName from JS",
+        kElementSetup, "sink = item.nodeName;"));
+    benchmarks.push_back(ScriptBenchmark("getter_id", "element.id from JS",
+        kElementSetup, "sink = item.id;"));
+    benchmarks.push_back(ScriptBenchmark("getter_className", "element.className from JS",
+        kElementSetup, "sink = item.className;"));
+    benchmarks.push_back(ScriptBenchmark("getter_getAttribute", "element.getAttribute('data-x') from JS",
+        kElementSetup, "sink = item.getAttribute('data-x');"));
+    benchmarks.push_back(ScriptBenchmark("getter_textContent", "element.textContent from JS",
+        kElementSetup, "sink = item.textContent;"));
+    benchmarks.push_back(ScriptBenchmark("getter_data", "text.data from JS",
+        kElementSetup, "sink = text.data;"));
+
+    benchmarks.push_back(ScriptBenchmark("setAttribute", "element.setAttribute() of an existing attribute from JS",
+        kElementSetup, "item.setAttribute('data-x', 'value');"));
+    benchmarks.push_back(ScriptBenchmark("throw_DOMException", "setAttribute() throwing InvalidCharacterError, caught in JS",
+        kElementSetup, "try { item.setAttribute('1bad', 'value'); } catch (e) { sink = e.code; }"));
+    benchmarks.push_back(ScriptBenchmark("createElement_appendChild", "createElement() plus appendChild() from JS",
+        "var holder = document.createElement('list');",
+        "if ((i & 1023) === 0) holder.textContent = ''; holder.appendChild(document.createElement('item'));"));
+
+    benchmarks.push_back(ScriptBenchmark("querySelector_simple", "root.querySelector('.target') on a 1000-element tree from JS",
+        kTreeSetup, "sink = root.querySelector('.target');"));
+    benchmarks.push_back(ScriptBenchmark("querySelector_complex", "root.querySelector('row > cell[data-x=\"8\"]') on a 1000-element tree from JS",
+        kTreeSetup, "sink = root.querySelector('row > cell[data-x=\"8\"]');"));
+    benchmarks.push_back(ScriptBenchmark("querySelectorAll", "root.querySelectorAll('.target').length on a 1000-element tree from JS",
+        kTreeSetup, "sink = root.querySelectorAll('.target').length;"));
+
+    // One op is one visited node
+    benchmarks.push_back(ScriptBenchmark("tree_traversal", "firstChild/nextSibling step in a 2000-node tree walk from JS",
+        kTreeSetup,
+        "if (sink === undefined || sink === null) sink = root; "
+        "if (sink.firstChild) { sink = sink.firstChild; continue; } "
+        "while (sink !== root && !sink.nextSibling) sink = sink.parentNode; "
+        "sink = sink === root ? null : sink.nextSibling;"));
+    benchmarks.push_back(ScriptBenchmark("childNodes_index", "childNodes[i] of a 9-child row from JS",
+        kTreeSetup, "sink = root.firstChild.childNodes[i % 9];"));
+    benchmarks.push_back(ScriptBenchmark("nodelist_for_of", "for...of over the 100 results of querySelectorAll('.target') from JS",
+        kTreeSetup + std::string("var targets = root.querySelectorAll('.target');"),
+        "for (const node of targets) sink = node;"));
+    benchmarks.push_back(ScriptBenchmark("nodelist_forEach", "forEach over the 100 results of querySelectorAll('.target') from JS",
+        kTreeSetup + std::string("var targets = root.querySelectorAll('.target');"),
+        "targets.forEach((node) => { sink = node; });"));
+    benchmarks.push_back(ScriptBenchmark("text_insertData_large", "insertData + deleteData of one character in a 1M-unit non-ASCII Text from JS",
+        kTreeSetup + std::string("var text = document.createTextNode('\u00e9'.repeat(1 << 20)); root.appendChild(text);"),
+        "text.insertData(500000 + (i % 64), 'x'); text.deleteData(500000 + (i % 64), 1);"));
+
+    return benchmarks;
+}
+
+struct Result {
+    const char* name;
+    const char* description;
+    double ns_per_op;
+    size_t ops;
+};
+
+Result Measure(Env& env, const Benchmark& benchmark, uint64_t min_time_ns) {
+    benchmark.run(env, 16);  // warm up, compile, build trees
+
+    size_t ops = 64;
+    uint64_t elapsed = 0;
+    while (true) {
+        elapsed = benchmark.run(env, ops);
+        if (elapsed >= min_time_ns || ops >= (size_t(1) << 30)) {
+            break;
+        }
+        // Aim a little past the target instead of doubling blindly
+        size_t next = elapsed > 0 ? static_cast<size_t>(double(ops) * 1.4 * double(min_time_ns) / double(elapsed))
+                                  : ops * 10;
+        ops = next > ops * 10 ? ops * 10 : (next > ops ? next : ops * 2);
+    }
+    return {benchmark.name, benchmark.description, double(elapsed) / double(ops), ops};
+}
+
+std::string JsonEscape(const char* s) {
+    std::string out;
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') {
+            out += '\\';
+        }
+        out += *s;
+    }
+    return out;
+}
+
+void WriteJson(FILE* out, const std::vector<Result>& results, const char* machine, bool slots) {
+    char date[16];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%d", std::localtime(&now));
+
+    std::fprintf(out, "{\n");
+    std::fprintf(out, "  \"version\": \"%s\",\n", v8_dom::GetVersion());
+    std::fprintf(out, "  \"baseline_date\": \"%s\",\n", date);
+    std::fprintf(out, "  \"machine\": \"%s\",\n", JsonEscape(machine).c_str());
+    std::fprintf(out, "  \"benchmarks\": {\n");
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& r = results[i];
+        std::fprintf(out, "    \"v8_%s\": {\n", r.name);
+        std::fprintf(out, "      \"ns_per_op\": %.2f,\n", r.ns_per_op);
+        std::fprintf(out, "      \"description\": \"%s\"\n", JsonEscape(r.description).c_str());
+        std::fprintf(out, "    }%s\n", i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(out, "  },\n");
+    std::fprintf(out, "  \"notes\": \"v8-bindings microbenchmarks (make bench), V8 %s%s\"\n",
+                 v8::V8::GetVersion(), slots ? ", node wrapper slots" : "");
+    std::fprintf(out, "}\n");
+}
+
+void PrintUsage() {
+    std::fprintf(stderr,
+        "Usage: bindings_bench [--filter <substring>] [--min-time <ms>] [--slots] [--out <file>] [--machine <class>]\n"
+        "  --filter    Only run benchmarks whose name contains the substring\n"
+        "  --min-time  Minimum duration of the measured run (default 200)\n"
+        "  --slots     Enable node wrapper slots (v8_dom::EnableNodeWrapperSlots)\n"
+        "  --out       Write the JSON results to a file instead of stdout\n"
+        "  --machine   Machine class to tag the results with (default: the gate's)\n");
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const char* filter = nullptr;
+    const char* out_path = nullptr;
+    const char* machine = "";
+    uint64_t min_time_ms = 200;
+    bool slots = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (std::strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+            min_time_ms = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            out_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--machine") == 0 && i + 1 < argc) {
+            machine = argv[++i];
+        } else if (std::strcmp(argv[i], "--slots") == 0) {
+            slots = true;
+        } else {
+            PrintUsage();
+            return std::strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+
+    v8::V8::InitializeICUDefaultLocation(argv[0]);
+    v8::V8::InitializeExternalStartupData(argv[0]);
+    std::unique_ptr<v8::Platform> platform = v8::platform::NewDefaultPlatform();
+    v8::V8::InitializePlatform(platform.get());
+    v8::V8::Initialize();
+
+    v8::Isolate::CreateParams create_params;
+    create_params.array_buffer_allocator = v8::ArrayBuffer::Allocator::NewDefaultAllocator();
+    v8::Isolate* isolate = v8::Isolate::New(create_params);
+
+    std::vector<Result> results;
+    {
+        v8::Isolate::Scope isolate_scope(isolate);
+        v8::HandleScope handle_scope(isolate);
+
+        v8::Local<v8::ObjectTemplate> global = v8::ObjectTemplate::New(isolate);
+        v8_dom::InstallDOMBindings(isolate, global);
+        if (slots) {
+            v8_dom::EnableNodeWrapperSlots(isolate);
+        }
+        v8::Local<v8::Context> context = v8::Context::New(isolate, nullptr, global);
+        v8::Context::Scope context_scope(context);
+
+        Env env{isolate, context, v8_dom::BindingState::ForIsolate(isolate)->Document()};
+
+        std::fprintf(stderr, "%-28s %12s %12s\n", "benchmark", "ns/op", "ops");
+        for (const Benchmark& benchmark : AllBenchmarks()) {
+            if (filter && !std::strstr(benchmark.name, filter)) {
+                continue;
+            }
+            Result result = Measure(env, benchmark, min_time_ms * 1000000);
+            std::fprintf(stderr, "%-28s %12.2f %12zu\n", result.name, result.ns_per_op, result.ops);
+            results.push_back(result);
+        }
+
+        v8_dom::Cleanup(isolate);
+    }
+
+    FILE* out = out_path ? std::fopen(out_path, "w") : stdout;
+    if (!out) {
+        std::fprintf(stderr, "Cannot open %s\n", out_path);
+        return 1;
+    }
+    WriteJson(out, results, machine, slots);
+    if (out_path) {
+        std::fclose(out);
+    }
+
+    isolate->Dispose();
+    v8::V8::Dispose();
+    v8::V8::DisposePlatform();
+    delete create_params.array_buffer_allocator;
+    return 0;
+}
@@ -0,0 +1,306 @@
+/**
+ * V8 DOM Bindings - JavaScript benchmark suite runner
+ *
+ * Runs benchmarks/js/benchmark.js, the suite the Playwright runner loads
+ * into Chromium, Firefox and WebKit, inside an isolate with the DOM
+ * bindings installed, so the same operations can be compared between the
+ * browsers' DOMs and this one.
+ *
+ * The suite only needs a few browser globals besides `document`; the
+ * runner provides them:
+ * - console.log() (stdout)
+ * - performance.now() (monotonic milliseconds)
+ * - navigator.userAgent ("v8-dom (V8 <version>)")
+ * - gc() (full GC, then the releases it queued)
+ * - document.body: an element appended under a new document element
+ *
+ * Results are written in the format of benchmarks/js/playwright-runner.js,
+ * as one more entry (--name, default "V8 DOM") of the latest browser
+ * results, so benchmarks/visualize.js charts it next to the browsers:
+ *   make jsbench
+ *   ./bench/js_suite
+ *   cd ../benchmarks && node visualize.js
+ */
+
+#include <v8.h>
+#include <libplatform/libplatform.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "v8_dom.h"
+
+namespace {
+
+struct Config {
+    std::string script_path = "../benchmarks/js/benchmark.js";
+    std::string output_dir = "../benchmark_results";
+    std::string name = "V8 DOM";
+    bool merge = true;
+    bool slots = false;
+};
+
+// Gives the suite a document element with a body-like child, as a
+// browser page would have
+const char* kPageSetup = R"JS(
+(function () {
+    const root = document.createElement("root");
+    document.appendChild(root);
+    const host = document.createElement("host");
+    root.appendChild(host);
+    Object.defineProperty(document, "body", { value: host, configurable: true });
+})();
+)JS";
+
+// Builds the result files from runBenchmarksAndExport(): the run alone and
+// the latest browser results with the run in place of an older one of the
+// same name
+const char* kExportScript = R"JS(
+(function (results, name, userAgent, previous) {
+    const entry = { browser: name, userAgent, timestamp: new Date().toISOString(), results };
+    let latest = [];
+    if (previous) {
+        try {
+            latest = JSON.parse(previous).filter(r => r.browser !== name);
+        } catch (e) {
+            latest = [];
+        }
+    }
+    latest.push(entry);
+    return {
+        run: JSON.stringify([entry], null, 2),
+        latest: JSON.stringify(latest, null, 2),
+        stamp: entry.timestamp.replace(/[:.]/g, "-"),
+    };
+})
+)JS";
+
+bool ReadFile(const std::string& path, std::string* contents) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+    char buffer[65536];
+    size_t read;
+    contents->clear();
+    while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        contents->append(buffer, read);
+    }
+    std::fclose(file);
+    return true;
+}
+
+bool WriteFile(const std::string& path, const std::string& contents) {
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    const bool written = std::fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+    return std::fclose(file) == 0 && written;
+}
+
+v8::Local<v8::Value> RunScript(v8::Isolate* isolate, v8::Local<v8::Context> context,
+                               const std::string& source, const char* name) {
+    v8::TryCatch try_catch(isolate);
+    v8::Local<v8::String> code = v8::String::NewFromUtf8(isolate, source.c_str()).ToLocalChecked();
+    v8::Local<v8::Script> script;
+    v8::Local<v8::Value> result;
+    if (!v8::Script::Compile(context, code).ToLocal(&script) || !script->Run(context).ToLocal(&result)) {
+        v8::String::Utf8Value error(isolate, try_catch.Exception());
+        std::fprintf(stderr, "%s failed: %s\n", name, *error ? *error : "?");
+        std::exit(1);
+    }
+    return result;
+}
+
+v8::Local<v8::Value> CallGlobal(v8::Isolate* isolate, v8::Local<v8::Context> context,
+                                v8::Local<v8::Function> fn, int argc, v8::Local<v8::Value> argv[],
+                                const char* name) {
+    v8::TryCatch try_catch(isolate);
+    v8::Local<v8::Value> result;
+    if (!fn->Call(context, context->Global(), argc, argv).ToLocal(&result)) {
+        v8::String::Utf8Value error(isolate, try_catch.Exception());
+        std::fprintf(stderr, "%s threw: %s\n", name, *error ? *error : "?");
+        std::exit(1);
+    }
+    return result;
+}
+
+std::string GetString(v8::Isolate* isolate, v8::Local<v8::Context> context,
+                      v8::Local<v8::Object> object, const char* key) {
+    v8::Local<v8::Value> value;
+    if (!object->Get(context, v8::String::NewFromUtf8(isolate, key).ToLocalChecked()).ToLocal(&value)) {
+        return std::string();
+    }
+    v8::String::Utf8Value utf8(isolate, value);
+    return *utf8 ? std::string(*utf8, utf8.length()) : std::string();
+}
+
+// ============================================================================
+// Browser globals
+// ============================================================================
+
+void ConsoleLog(const v8::FunctionCallbackInfo<v8::Value>& info) {
+    v8::Isolate* isolate = info.GetIsolate();
+    for (int i = 0; i < info.Length(); i++) {
+        v8::String::Utf8Value arg(isolate, info[i]);
+        std::printf("%s%s", i > 0 ? " " : "", *arg ? *arg : "");
+    }
+    std::printf("\n");
+    std::fflush(stdout);
+}
+
+void PerformanceNow(const v8::FunctionCallbackInfo<v8::Value>& info) {
+    static const auto origin = std::chrono::steady_clock::now();
+    const double ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - origin).count();
+    info.GetReturnValue().Set(ms);
+}
+
+void CollectGarbage(const v8::FunctionCallbackInfo<v8::Value>& info) {
+    v8::Isolate* isolate = info.GetIsolate();
+    isolate->LowMemoryNotification();
+    v8_dom::DrainDeferredReleases(isolate, SIZE_MAX);
+}
+
+void InstallBrowserGlobals(v8::Isolate* isolate, v8::Local<v8::ObjectTemplate> global) {
+    v8::Local<v8::ObjectTemplate> console = v8::ObjectTemplate::New(isolate);
+    console->Set(isolate, "log", v8::FunctionTemplate::New(isolate, ConsoleLog));
+    global->Set(isolate, "console", console);
+
+    v8::Local<v8::ObjectTemplate> performance = v8::ObjectTemplate::New(isolate);
+    performance->Set(isolate, "now", v8::FunctionTemplate::New(isolate, PerformanceNow));
+    global->Set(isolate, "performance", performance);
+
+    std::string user_agent = std::string("v8-dom (V8 ") + v8::V8::GetVersion() + ")";
+    v8::Local<v8::ObjectTemplate> navigator = v8::ObjectTemplate::New(isolate);
+    navigator->Set(isolate, "userAgent",
+                   v8::String::NewFromUtf8(isolate, user_agent.c_str()).ToLocalChecked());
+    global->Set(isolate, "navigator", navigator);
+
+    global->Set(isolate, "gc", v8::FunctionTemplate::New(isolate, CollectGarbage));
+}
+
+void PrintUsage() {
+    std::fprintf(stderr,
+        "Usage: js_suite [--script <file>] [--output-dir <dir>] [--name <name>] [--no-merge] [--slots]\n"
+        "  --script      Benchmark suite to run (default ../benchmarks/js/benchmark.js)\n"
+        "  --output-dir  Directory of the browser results (default ../benchmark_results)\n"
+        "  --name        Name of the run in the results (default \"V8 DOM\")\n"
+        "  --no-merge    Replace browser_benchmarks_latest.json instead of adding the run to it\n"
+        "  --slots       Enable node wrapper slots (v8_dom::EnableNodeWrapperSlots)\n");
+}
+
+bool ParseArgs(int argc, char* argv[], Config* config) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (std::strcmp(arg, "--script") == 0 && value) {
+            config->script_path = value;
+            i++;
+        } else if (std::strcmp(arg, "--output-dir") == 0 && value) {
+            config->output_dir = value;
+            i++;
+        } else if (std::strcmp(arg, "--name") == 0 && value) {
+            config->name = value;
+            i++;
+        } else if (std::strcmp(arg, "--no-merge") == 0) {
+            config->merge = false;
+        } else if (std::strcmp(arg, "--slots") == 0) {
+            config->slots = true;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Config config;
+    if (!ParseArgs(argc, argv, &config)) {
+        PrintUsage();
+        return 1;
+    }
+
+    std::string suite;
+    if (!ReadFile(config.script_path, &suite)) {
+        std::fprintf(stderr, "Cannot read %s\n", config.script_path.c_str());
+        return 1;
+    }
+    const std::string latest_path = config.output_dir + "/browser_benchmarks_latest.json";
+    std::string previous;
+    if (config.merge) {
+        ReadFile(latest_path, &previous);
+    }
+
+    v8::V8::InitializeICUDefaultLocation(argv[0]);
+    v8::V8::InitializeExternalStartupData(argv[0]);
+    std::unique_ptr<v8::Platform> platform = v8::platform::NewDefaultPlatform();
+    v8::V8::InitializePlatform(platform.get());
+    v8::V8::Initialize();
+
+    v8::Isolate::CreateParams create_params;
+    create_params.array_buffer_allocator = v8::ArrayBuffer::Allocator::NewDefaultAllocator();
+    v8::Isolate* isolate = v8::Isolate::New(create_params);
+
+    std::string run_json;
+    std::string latest_json;
+    std::string stamp;
+    {
+        v8::Isolate::Scope isolate_scope(isolate);
+        v8::HandleScope handle_scope(isolate);
+
+        v8::Local<v8::ObjectTemplate> global = v8::ObjectTemplate::New(isolate);
+        v8_dom::InstallDOMBindings(isolate, global);
+        if (config.slots) {
+            v8_dom::EnableNodeWrapperSlots(isolate);
+        }
+        InstallBrowserGlobals(isolate, global);
+        v8::Local<v8::Context> context = v8::Context::New(isolate, nullptr, global);
+        v8::Context::Scope context_scope(context);
+
+        RunScript(isolate, context, kPageSetup, "Page setup");
+        RunScript(isolate, context, suite, config.script_path.c_str());
+
+        v8::Local<v8::Function> run =
+            RunScript(isolate, context, "runBenchmarksAndExport", "Suite lookup").As<v8::Function>();
+        v8::Local<v8::Value> results = CallGlobal(isolate, context, run, 0, nullptr, "runBenchmarksAndExport()");
+
+        v8::Local<v8::Function> exporter = RunScript(isolate, context, kExportScript, "Export").As<v8::Function>();
+        v8::Local<v8::Value> user_agent = RunScript(isolate, context, "navigator.userAgent", "User agent");
+        v8::Local<v8::Value> argv_export[] = {
+            results,
+            v8::String::NewFromUtf8(isolate, config.name.c_str()).ToLocalChecked(),
+            user_agent,
+            previous.empty() ? v8::Local<v8::Value>(v8::Undefined(isolate))
+                             : v8::Local<v8::Value>(v8::String::NewFromUtf8(isolate, previous.c_str()).ToLocalChecked()),
+        };
+        v8::Local<v8::Object> files =
+            CallGlobal(isolate, context, exporter, 4, argv_export, "Export").As<v8::Object>();
+        run_json = GetString(isolate, context, files, "run");
+        latest_json = GetString(isolate, context, files, "latest");
+        stamp = GetString(isolate, context, files, "stamp");
+
+        v8_dom::Cleanup(isolate);
+    }
+
+    isolate->Dispose();
+    v8::V8::Dispose();
+    v8::V8::DisposePlatform();
+    delete create_params.array_buffer_allocator;
+
+    const std::string run_path = config.output_dir + "/v8_dom_benchmarks_" + stamp + ".json";
+    if (!WriteFile(run_path, run_json) || !WriteFile(latest_path, latest_json)) {
+        std::fprintf(stderr, "Cannot write results to %s (does the directory exist?)\n", config.output_dir.c_str());
+        return 1;
+    }
+    std::printf("\nResults: %s\nLatest:  %s\nReport:  cd ../benchmarks && node visualize.js\n",
+                run_path.c_str(), latest_path.c_str());
+    return 0;
+}
@@ -0,0 +1,463 @@
+/**
+ * V8 DOM Bindings - Memory stress driver
+ *
+ * Runs JavaScript create/mutate/discard cycles against the bindings inside
+ * one isolate, forcing full GCs, and samples over time:
+ * - live nodes of the document (dom_document_get_live_node_count)
+ * - the document's allocated bytes (dom_document_get_allocated_bytes)
+ * - live wrappers in the wrapper cache and the V8 heap size
+ *
+ * Every cycle discards everything it created, so after a forced GC the
+ * live node and wrapper counts must return to the same level. A count
+ * that keeps growing is a reference leaked between wrappers and the
+ * Zig refcounts (a Wrap addref without its release, a snapshot list that
+ * keeps its nodes, ...). Leak reports compare the last sample with the
+ * first one, after one warm-up cycle.
+ *
+ * Samples are written in the format of benchmarks/memory-stress, so the
+ * same report generator charts them:
+ *   make stress
+ *   ./bench/memory_stress --duration 60
+ *   node ../benchmarks/memory-stress/visualize_memory.js \
+ *       ../benchmark_results/memory_stress/v8_memory_samples_latest.json
+ */
+
+#include <v8.h>
+#include <libplatform/libplatform.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "v8_dom.h"
+#include "core/binding_state.h"
+#include "dom.h"
+
+namespace {
+
+struct Config {
+    uint64_t duration_seconds = 30;
+    uint64_t sample_interval_ms = 1000;
+    uint32_t nodes_per_cycle = 1000;
+    uint32_t operations_per_node = 4;
+    uint32_t gc_every = 10;  // Cycles between forced GCs
+    uint64_t seed = 1;
+    std::string output_dir = "../benchmark_results/memory_stress";
+    bool slots = false;
+    bool retention = false;
+    bool deferred = false;
+    bool fail_on_leak = false;
+};
+
+struct Sample {
+    uint64_t timestamp_ms;
+    size_t bytes_used;
+    size_t peak_bytes;
+    uint64_t operations_completed;
+    size_t live_nodes;
+    size_t wrappers_live;
+    size_t v8_heap_bytes;
+};
+
+struct Breakdown {
+    uint64_t nodes_created = 0;
+    uint64_t nodes_deleted = 0;
+    uint64_t reads = 0;
+    uint64_t updates = 0;
+    uint64_t attribute_ops = 0;
+    uint64_t complex_queries = 0;
+
+    uint64_t Total() const {
+        return nodes_created + nodes_deleted + reads + updates + attribute_ops + complex_queries;
+    }
+};
+
+// One cycle: build a subtree of `count` nodes under a persistent root,
+// exercise the binding paths that hold C references (wrappers, snapshot
+// and live lists, ranges, walkers, observers, expandos), then drop it
+// all. Returns the operation counts of the cycle.
+const char* kCycleScript = R"JS(
+var stressRoot = document.createElement("root");
+document.appendChild(stressRoot);
+
+function stressCycle(count, opsPerNode, seed) {
+    let state = seed >>> 0;
+    function random(n) {
+        state = (Math.imul(state, 1664525) + 1013904223) >>> 0;
+        return state % n;
+    }
+    const ops = { nodes_created: 0, nodes_deleted: 0, reads: 0, updates: 0,
+                  attribute_ops: 0, complex_queries: 0 };
+
+    const observer = new MutationObserver(() => {});
+    observer.observe(stressRoot, { childList: true, subtree: true, attributes: true });
+
+    // Create: rows of cells with text, some detached and held only by JS
+    const list = document.createElement("list");
+    const detached = [];
+    let row = null;
+    for (let i = 0; i < count; i++) {
+        if (i % 10 === 0) {
+            row = document.createElement("row");
+            list.appendChild(row);
+        }
+        const cell = document.createElement("cell");
+        cell.appendChild(document.createTextNode("line " + i));
+        if (random(20) === 0) {
+            detached.push(cell);
+        } else {
+            row.appendChild(cell);
+        }
+        ops.nodes_created += 2;
+    }
+    stressRoot.appendChild(list);
+
+    // Mutate and read
+    const cells = list.querySelectorAll("cell");
+    ops.complex_queries++;
+    for (let n = 0; n < cells.length * opsPerNode; n++) {
+        const cell = cells[random(cells.length)];
+        switch (random(8)) {
+        case 0:
+            cell.setAttribute("data-x", String(n));
+            ops.attribute_ops++;
+            break;
+        case 1:
+            cell.className = random(2) ? "target" : "other";
+            cell.classList.toggle("flag");
+            ops.attribute_ops++;
+            break;
+        case 2:
+            cell.textContent = "text " + n;
+            ops.updates++;
+            break;
+        case 3: {
+            const text = cell.firstChild;
+            if (text && text.nodeType === 3 && text.nodeValue.length > 1) {
+                text.splitText(1);
+                ops.nodes_created++;
+            }
+            ops.updates++;
+            break;
+        }
+        case 4:
+            ops.reads += cell.parentNode.childNodes.length + cell.parentNode.children.length;
+            break;
+        case 5:
+            cell.expando = { index: n, node: cell.parentNode };
+            ops.updates++;
+            break;
+        case 6:
+            cell.parentNode.insertBefore(cell, cell.parentNode.firstChild);
+            ops.updates++;
+            break;
+        default:
+            ops.reads += cell.getAttribute("data-x") ? 1 : 0;
+            ops.reads += cell.nextSibling ? 1 : 0;
+            break;
+        }
+    }
+
+    // Queries and traversal objects that hold nodes
+    ops.reads += list.querySelectorAll("row > cell.target").length;
+    ops.reads += document.getElementsByClassName("flag").length;
+    ops.complex_queries += 2;
+    const range = document.createRange();
+    range.selectNodeContents(list.firstChild);
+    const walker = document.createTreeWalker(list, NodeFilter.SHOW_TEXT);
+    while (walker.nextNode()) ops.reads++;
+    observer.takeRecords();
+
+    // Discard: remove the subtree, drop every reference
+    range.deleteContents();
+    stressRoot.removeChild(list);
+    observer.disconnect();
+    ops.nodes_deleted = ops.nodes_created;
+    detached.length = 0;
+    return ops;
+}
+)JS";
+
+uint64_t NowMs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+v8::Local<v8::Value> RunScript(v8::Isolate* isolate, v8::Local<v8::Context> context, const char* source) {
+    v8::TryCatch try_catch(isolate);
+    v8::Local<v8::String> code = v8::String::NewFromUtf8(isolate, source).ToLocalChecked();
+    v8::Local<v8::Script> script;
+    v8::Local<v8::Value> result;
+    if (!v8::Script::Compile(context, code).ToLocal(&script) || !script->Run(context).ToLocal(&result)) {
+        v8::String::Utf8Value error(isolate, try_catch.Exception());
+        std::fprintf(stderr, "Script failed: %s\n", *error ? *error : "?");
+        std::exit(1);
+    }
+    return result;
+}
+
+uint64_t ReadCount(v8::Isolate* isolate, v8::Local<v8::Context> context,
+                   v8::Local<v8::Object> ops, const char* name) {
+    v8::Local<v8::Value> value;
+    if (!ops->Get(context, v8::String::NewFromUtf8(isolate, name).ToLocalChecked()).ToLocal(&value)) {
+        return 0;
+    }
+    return static_cast<uint64_t>(value->NumberValue(context).FromMaybe(0));
+}
+
+// Full GC, then the releases it queued, so the counts reflect only what
+// is still referenced
+void ForceGC(v8::Isolate* isolate) {
+    isolate->LowMemoryNotification();
+    v8_dom::DrainDeferredReleases(isolate, SIZE_MAX);
+}
+
+Sample TakeSample(v8::Isolate* isolate, DOMDocument* doc, uint64_t start_ms,
+                  uint64_t operations, size_t peak_bytes) {
+    v8::HeapStatistics heap;
+    isolate->GetHeapStatistics(&heap);
+    v8_dom::Stats stats = v8_dom::GetStats(isolate);
+
+    size_t bytes = dom_document_get_allocated_bytes(doc);
+    return {NowMs() - start_ms, bytes, std::max(peak_bytes, bytes), operations,
+            dom_document_get_live_node_count(doc), stats.wrappers_live, heap.used_heap_size()};
+}
+
+bool WriteSamples(const std::string& path, const Config& config,
+                  const std::vector<Sample>& samples, uint64_t cycles, const Breakdown& ops) {
+    FILE* out = std::fopen(path.c_str(), "w");
+    if (!out) {
+        return false;
+    }
+    std::fprintf(out, "{\n  \"config\": {\n");
+    std::fprintf(out, "    \"duration_seconds\": %llu,\n", (unsigned long long)config.duration_seconds);
+    std::fprintf(out, "    \"sample_interval_ms\": %llu,\n", (unsigned long long)config.sample_interval_ms);
+    std::fprintf(out, "    \"nodes_per_cycle\": %u,\n", config.nodes_per_cycle);
+    std::fprintf(out, "    \"operations_per_node\": %u,\n", config.operations_per_node);
+    std::fprintf(out, "    \"seed\": %llu,\n", (unsigned long long)config.seed);
+    std::fprintf(out, "    \"driver\": \"v8-bindings\",\n");
+    std::fprintf(out, "    \"gc_every\": %u,\n", config.gc_every);
+    std::fprintf(out, "    \"node_wrapper_slots\": %s,\n", config.slots ? "true" : "false");
+    std::fprintf(out, "    \"tree_retention\": %s,\n", config.retention ? "true" : "false");
+    std::fprintf(out, "    \"deferred_releases\": %s\n", config.deferred ? "true" : "false");
+    std::fprintf(out, "  },\n  \"samples\": [\n");
+    for (size_t i = 0; i < samples.size(); i++) {
+        const Sample& s = samples[i];
+        std::fprintf(out, "    {\n");
+        std::fprintf(out, "      \"timestamp_ms\": %llu,\n", (unsigned long long)s.timestamp_ms);
+        std::fprintf(out, "      \"bytes_used\": %zu,\n", s.bytes_used);
+        std::fprintf(out, "      \"peak_bytes\": %zu,\n", s.peak_bytes);
+        std::fprintf(out, "      \"operations_completed\": %llu,\n", (unsigned long long)s.operations_completed);
+        std::fprintf(out, "      \"live_nodes\": %zu,\n", s.live_nodes);
+        std::fprintf(out, "      \"wrappers_live\": %zu,\n", s.wrappers_live);
+        std::fprintf(out, "      \"v8_heap_bytes\": %zu\n", s.v8_heap_bytes);
+        std::fprintf(out, "    }%s\n", i + 1 < samples.size() ? "," : "");
+    }
+    std::fprintf(out, "  ],\n  \"final_state\": {\n");
+    std::fprintf(out, "    \"cycles_completed\": %llu,\n", (unsigned long long)cycles);
+    std::fprintf(out, "    \"operation_breakdown\": {\n");
+    std::fprintf(out, "      \"nodes_created\": %llu,\n", (unsigned long long)ops.nodes_created);
+    std::fprintf(out, "      \"nodes_deleted\": %llu,\n", (unsigned long long)ops.nodes_deleted);
+    std::fprintf(out, "      \"reads\": %llu,\n", (unsigned long long)ops.reads);
+    std::fprintf(out, "      \"updates\": %llu,\n", (unsigned long long)ops.updates);
+    std::fprintf(out, "      \"attribute_ops\": %llu,\n", (unsigned long long)ops.attribute_ops);
+    std::fprintf(out, "      \"complex_queries\": %llu\n", (unsigned long long)ops.complex_queries);
+    std::fprintf(out, "    }\n  }\n}\n");
+    std::fclose(out);
+    return true;
+}
+
+void PrintUsage() {
+    std::fprintf(stderr,
+        "Usage: memory_stress [options]\n"
+        "  --duration <s>     Run time (default 30)\n"
+        "  --interval <ms>    Sample interval (default 1000)\n"
+        "  --nodes <n>        Elements created per cycle (default 1000)\n"
+        "  --ops <n>          Mutations per element per cycle (default 4)\n"
+        "  --gc-every <n>     Cycles between forced GCs (default 10)\n"
+        "  --seed <n>         Random seed (default 1)\n"
+        "  --output <dir>     Output directory (default ../benchmark_results/memory_stress)\n"
+        "  --slots            Enable node wrapper slots\n"
+        "  --retention        Enable wrapper tree retention (implies --slots)\n"
+        "  --deferred         Enable deferred wrapper releases\n"
+        "  --fail-on-leak     Exit 1 if live nodes or wrappers grew\n");
+}
+
+bool ParseArgs(int argc, char* argv[], Config* config) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (std::strcmp(arg, "--duration") == 0 && value) {
+            config->duration_seconds = std::strtoull(value, nullptr, 10);
+            i++;
+        } else if (std::strcmp(arg, "--interval") == 0 && value) {
+            config->sample_interval_ms = std::max<uint64_t>(1, std::strtoull(value, nullptr, 10));
+            i++;
+        } else if (std::strcmp(arg, "--nodes") == 0 && value) {
+            config->nodes_per_cycle = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+            i++;
+        } else if (std::strcmp(arg, "--ops") == 0 && value) {
+            config->operations_per_node = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+            i++;
+        } else if (std::strcmp(arg, "--gc-every") == 0 && value) {
+            config->gc_every = std::max<uint32_t>(1, static_cast<uint32_t>(std::strtoul(value, nullptr, 10)));
+            i++;
+        } else if (std::strcmp(arg, "--seed") == 0 && value) {
+            config->seed = std::strtoull(value, nullptr, 10);
+            i++;
+        } else if (std::strcmp(arg, "--output") == 0 && value) {
+            config->output_dir = value;
+            i++;
+        } else if (std::strcmp(arg, "--slots") == 0) {
+            config->slots = true;
+        } else if (std::strcmp(arg, "--retention") == 0) {
+            config->slots = true;
+            config->retention = true;
+        } else if (std::strcmp(arg, "--deferred") == 0) {
+            config->deferred = true;
+        } else if (std::strcmp(arg, "--fail-on-leak") == 0) {
+            config->fail_on_leak = true;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Config config;
+    if (!ParseArgs(argc, argv, &config)) {
+        PrintUsage();
+        return 1;
+    }
+
+    v8::V8::InitializeICUDefaultLocation(argv[0]);
+    v8::V8::InitializeExternalStartupData(argv[0]);
+    std::unique_ptr<v8::Platform> platform = v8::platform::NewDefaultPlatform();
+    v8::V8::InitializePlatform(platform.get());
+    v8::V8::Initialize();
+
+    v8::Isolate::CreateParams create_params;
+    create_params.array_buffer_allocator = v8::ArrayBuffer::Allocator::NewDefaultAllocator();
+    v8::Isolate* isolate = v8::Isolate::New(create_params);
+
+    std::vector<Sample> samples;
+    Breakdown ops;
+    uint64_t cycles = 0;
+    {
+        v8::Isolate::Scope isolate_scope(isolate);
+        v8::HandleScope handle_scope(isolate);
+
+        v8::Local<v8::ObjectTemplate> global = v8::ObjectTemplate::New(isolate);
+        v8_dom::InstallDOMBindings(isolate, global);
+        if (config.slots) {
+            v8_dom::EnableNodeWrapperSlots(isolate);
+        }
+        if (config.retention) {
+            v8_dom::EnableWrapperTreeRetention(isolate);
+        }
+        if (config.deferred) {
+            v8_dom::EnableDeferredReleases(isolate);
+        }
+        v8::Local<v8::Context> context = v8::Context::New(isolate, nullptr, global);
+        v8::Context::Scope context_scope(context);
+
+        DOMDocument* doc = v8_dom::BindingState::ForIsolate(isolate)->Document();
+        RunScript(isolate, context, kCycleScript);
+        v8::Local<v8::Function> cycle = RunScript(isolate, context, "stressCycle").As<v8::Function>();
+
+        std::printf("V8 bindings memory stress: %llus, %u elements x %u ops per cycle, GC every %u cycles%s%s%s\n",
+                    (unsigned long long)config.duration_seconds, config.nodes_per_cycle,
+                    config.operations_per_node, config.gc_every,
+                    config.slots ? ", slots" : "", config.retention ? ", retention" : "",
+                    config.deferred ? ", deferred releases" : "");
+
+        const uint64_t start_ms = NowMs();
+        const uint64_t end_ms = start_ms + config.duration_seconds * 1000;
+        uint64_t next_sample_ms = start_ms;
+        size_t peak_bytes = 0;
+
+        while (true) {
+            {
+                v8::HandleScope cycle_scope(isolate);
+                v8::Local<v8::Value> argv[] = {
+                    v8::Number::New(isolate, config.nodes_per_cycle),
+                    v8::Number::New(isolate, config.operations_per_node),
+                    v8::Number::New(isolate, static_cast<double>(config.seed + cycles)),
+                };
+                v8::TryCatch try_catch(isolate);
+                v8::Local<v8::Value> result;
+                if (!cycle->Call(context, context->Global(), 3, argv).ToLocal(&result)) {
+                    v8::String::Utf8Value error(isolate, try_catch.Exception());
+                    std::fprintf(stderr, "Cycle %llu threw: %s\n", (unsigned long long)cycles, *error ? *error : "?");
+                    return 1;
+                }
+                v8::Local<v8::Object> counts = result.As<v8::Object>();
+                ops.nodes_created += ReadCount(isolate, context, counts, "nodes_created");
+                ops.nodes_deleted += ReadCount(isolate, context, counts, "nodes_deleted");
+                ops.reads += ReadCount(isolate, context, counts, "reads");
+                ops.updates += ReadCount(isolate, context, counts, "updates");
+                ops.attribute_ops += ReadCount(isolate, context, counts, "attribute_ops");
+                ops.complex_queries += ReadCount(isolate, context, counts, "complex_queries");
+            }
+            isolate->PerformMicrotaskCheckpoint();
+            cycles++;
+
+            const bool done = NowMs() >= end_ms;
+            // The first sample follows one warm-up cycle
+            if (cycles % config.gc_every == 0 || done || cycles == 1) {
+                ForceGC(isolate);
+            } else if (config.deferred) {
+                v8_dom::DrainDeferredReleases(isolate, 4096);
+            }
+
+            if (done || (cycles % config.gc_every == 0 && NowMs() >= next_sample_ms) || cycles == 1) {
+                Sample sample = TakeSample(isolate, doc, start_ms, ops.Total(), peak_bytes);
+                peak_bytes = sample.peak_bytes;
+                samples.push_back(sample);
+                next_sample_ms = NowMs() + config.sample_interval_ms;
+                std::printf("[%6.1fs] cycles %llu  live nodes %zu  wrappers %zu  document %zu B  V8 heap %zu B\n",
+                            double(sample.timestamp_ms) / 1000.0, (unsigned long long)cycles,
+                            sample.live_nodes, sample.wrappers_live, sample.bytes_used, sample.v8_heap_bytes);
+            }
+            if (done) {
+                break;
+            }
+        }
+
+        v8_dom::Cleanup(isolate);
+    }
+
+    isolate->Dispose();
+    v8::V8::Dispose();
+    v8::V8::DisposePlatform();
+    delete create_params.array_buffer_allocator;
+
+    const long long node_growth = (long long)samples.back().live_nodes - (long long)samples.front().live_nodes;
+    const long long wrapper_growth = (long long)samples.back().wrappers_live - (long long)samples.front().wrappers_live;
+    const bool leaked = node_growth > 0 || wrapper_growth > 0;
+    std::printf("\n%llu cycles, %llu operations; live nodes %+lld, wrappers %+lld since the first sample: %s\n",
+                (unsigned long long)cycles, (unsigned long long)ops.Total(), node_growth, wrapper_growth,
+                leaked ? "LEAK" : "stable");
+
+    std::string stamp = std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    std::string path = config.output_dir + "/v8_memory_samples_" + stamp + ".json";
+    std::string latest = config.output_dir + "/v8_memory_samples_latest.json";
+    if (!WriteSamples(path, config, samples, cycles, ops) ||
+        !WriteSamples(latest, config, samples, cycles, ops)) {
+        std::fprintf(stderr, "Cannot write samples to %s (does the directory exist?)\n", config.output_dir.c_str());
+        return 1;
+    }
+    std::printf("Samples: %s\nReport:  node ../benchmarks/memory-stress/visualize_memory.js %s\n",
+                path.c_str(), latest.c_str());
+
+    return config.fail_on_leak && leaked ? 1 : 0;
+}
@@ -0,0 +1,549 @@
+/**
+ * V8 DOM Bindings - Call trace replay
+ *
+ * Re-executes a trace of dom_* calls recorded from script (make RECORD=1,
+ * v8_dom::StartCallRecording) against the DOM library alone, so core
+ * changes can be measured on recorded traffic without V8 in the loop.
+ *
+ * Each pass rebuilds the recorded document from the trace's snapshot on a
+ * fresh document and runs every record, timing each C-ABI call and
+ * summing the times per call family (create, tree, attribute, query,
+ * text; locating nodes and the snapshot count as state). The fastest of
+ * --iterations passes is reported per family. Replay is deterministic:
+ * the same trace makes the same calls in the same order every pass.
+ *
+ * Calls on nodes the recorder could not locate are skipped, and calls
+ * whose result differs from the recorded one (a null where a node was
+ * returned, another querySelectorAll match count) are counted as
+ * diverged; both should stay zero for a recording started on a document
+ * the snapshot reproduces.
+ *
+ * Results are printed as a table on stderr and as JSON on stdout (or
+ * --out <file>), in the shape of bench/bindings_bench.
+ *
+ * Build and run:
+ *   make replay
+ *   ./bench/trace_replay page.trace --iterations 10 --out replay.json
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "core/call_trace_format.h"
+#include "dom.h"
+
+namespace {
+
+using v8_dom::call_trace::Family;
+using v8_dom::call_trace::Op;
+using v8_dom::call_trace::Reader;
+
+constexpr size_t kFamilyCount = static_cast<size_t>(Family::kCount);
+
+struct FamilyTimes {
+    uint64_t calls = 0;
+    uint64_t ns = 0;
+};
+
+struct PassResult {
+    FamilyTimes families[kFamilyCount];
+    uint64_t skipped = 0;
+    uint64_t diverged = 0;
+    bool failed = false;
+};
+
+uint64_t Now() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/**
+ * One pass over a trace.
+ */
+class Replayer {
+public:
+    explicit Replayer(const std::vector<uint8_t>& trace)
+        : reader_(trace.data(), trace.size()), document_(dom_document_new()) {
+        nodes_.push_back(nullptr);  // Id 0 is null
+        nodes_.push_back(reinterpret_cast<DOMNode*>(document_));
+    }
+
+    ~Replayer() {
+        // Ids from 2 each own a reference (created, cloned or added on bind)
+        for (size_t i = 2; i < nodes_.size(); i++) {
+            if (nodes_[i]) {
+                dom_node_release(nodes_[i]);
+            }
+        }
+        dom_document_release(document_);
+    }
+
+    Replayer(const Replayer&) = delete;
+    Replayer& operator=(const Replayer&) = delete;
+
+    PassResult Run() {
+        reader_.Bytes(sizeof(v8_dom::call_trace::kMagic));
+        reader_.Varint();  // Version, checked by the caller
+        while (!reader_.AtEnd() && !reader_.failed()) {
+            Step(static_cast<Op>(reader_.Byte()));
+        }
+        result_.failed = result_.failed || reader_.failed();
+        return result_;
+    }
+
+private:
+    DOMNode* NodeOperand() {
+        uint64_t id = reader_.Varint();
+        if (id >= nodes_.size()) {
+            result_.failed = true;
+            return nullptr;
+        }
+        return nodes_[id];
+    }
+
+    std::string_view StringOperand() {
+        uint64_t id = reader_.Varint();
+        if (id == 0) {
+            strings_.push_back(reader_.Bytes(reader_.Varint()));
+            return strings_.back();
+        }
+        if (id > strings_.size()) {
+            result_.failed = true;
+            return {};
+        }
+        return strings_[id - 1];
+    }
+
+    /**
+     * Reads a result operand and binds the node replay got for it.
+     * owned: the call returned a reference for the caller.
+     */
+    void Bind(DOMNode* node, bool owned) {
+        uint64_t id = reader_.Varint();
+        if (id == v8_dom::call_trace::kNullNode) {
+            if (node) {
+                result_.diverged++;
+                if (owned) {
+                    dom_node_release(node);
+                }
+            }
+            return;
+        }
+        if (id != nodes_.size()) {
+            result_.failed = true;
+            return;
+        }
+        if (!node) {
+            result_.diverged++;
+        } else if (!owned) {
+            dom_node_addref(node);
+        }
+        nodes_.push_back(node);
+    }
+
+    void Count(Op op, uint64_t start_ns) {
+        FamilyTimes& times = result_.families[static_cast<size_t>(v8_dom::call_trace::FamilyOf(op))];
+        times.ns += Now() - start_ns;
+        times.calls++;
+    }
+
+    void Step(Op op) {
+        switch (op) {
+            case Op::kSnapshot: {
+                std::string_view markup = StringOperand();
+                uint64_t start = Now();
+                DOMElement* holder = dom_document_createelement_n(document_, "root", 4);
+                dom_element_setinnermarkup(holder, reinterpret_cast<const uint8_t*>(markup.data()),
+                                           markup.size());
+                while (DOMNode* child = dom_node_get_firstchild(reinterpret_cast<DOMNode*>(holder))) {
+                    dom_node_appendchild(reinterpret_cast<DOMNode*>(document_), child);
+                }
+                dom_element_release(holder);
+                Count(op, start);
+                break;
+            }
+            case Op::kLocate: {
+                uint64_t id = reader_.Varint();
+                DOMNode* node = NodeOperand();
+                uint64_t depth = reader_.Varint();
+                uint64_t start = Now();
+                for (uint64_t level = 0; level < depth; level++) {
+                    uint64_t index = reader_.Varint();
+                    node = node ? dom_node_get_firstchild(node) : nullptr;
+                    for (; node && index > 0; index--) {
+                        node = dom_node_get_nextsibling(node);
+                    }
+                }
+                Count(op, start);
+                if (id != nodes_.size()) {
+                    result_.failed = true;
+                    return;
+                }
+                if (node) {
+                    dom_node_addref(node);
+                } else {
+                    result_.diverged++;
+                }
+                nodes_.push_back(node);
+                break;
+            }
+            case Op::kCreateElement:
+            case Op::kCreateTextNode:
+            case Op::kCreateComment: {
+                DOMNode* doc = NodeOperand();
+                std::string_view data = StringOperand();
+                DOMNode* node = nullptr;
+                if (doc) {
+                    std::string comment_data;
+                    if (op == Op::kCreateComment) {
+                        comment_data.assign(data);  // Null-terminated for the C-ABI
+                    }
+                    uint64_t start = Now();
+                    DOMDocument* owner = reinterpret_cast<DOMDocument*>(doc);
+                    if (op == Op::kCreateElement) {
+                        node = reinterpret_cast<DOMNode*>(dom_document_createelement_n(owner, data.data(), data.size()));
+                    } else if (op == Op::kCreateTextNode) {
+                        node = reinterpret_cast<DOMNode*>(dom_document_createtextnode_n(owner, data.data(), data.size()));
+                    } else {
+                        node = reinterpret_cast<DOMNode*>(dom_document_createcomment(owner, comment_data.c_str()));
+                    }
+                    Count(op, start);
+                } else {
+                    result_.skipped++;
+                }
+                Bind(node, true);
+                break;
+            }
+            case Op::kCloneNode: {
+                DOMNode* node = NodeOperand();
+                uint8_t deep = static_cast<uint8_t>(reader_.Varint());
+                DOMNode* clone = nullptr;
+                if (node) {
+                    uint64_t start = Now();
+                    clone = dom_node_clonenode(node, deep);
+                    Count(op, start);
+                } else {
+                    result_.skipped++;
+                }
+                Bind(clone, true);
+                break;
+            }
+            case Op::kAppendChild:
+            case Op::kRemoveChild: {
+                DOMNode* parent = NodeOperand();
+                DOMNode* child = NodeOperand();
+                if (!parent || !child) {
+                    result_.skipped++;
+                    break;
+                }
+                uint64_t start = Now();
+                if (op == Op::kAppendChild) {
+                    dom_node_appendchild(parent, child);
+                } else {
+                    dom_node_removechild(parent, child);
+                }
+                Count(op, start);
+                break;
+            }
+            case Op::kInsertBefore:
+            case Op::kReplaceChild: {
+                DOMNode* parent = NodeOperand();
+                DOMNode* child = NodeOperand();
+                DOMNode* other = NodeOperand();
+                if (!parent || !child || (op == Op::kReplaceChild && !other)) {
+                    result_.skipped++;
+                    break;
+                }
+                uint64_t start = Now();
+                if (op == Op::kInsertBefore) {
+                    dom_node_insertbefore(parent, child, other);
+                } else {
+                    dom_node_replacechild(parent, child, other);
+                }
+                Count(op, start);
+                break;
+            }
+            case Op::kSetAttribute: {
+                DOMElement* elem = reinterpret_cast<DOMElement*>(NodeOperand());
+                std::string_view name = StringOperand();
+                std::string_view value = StringOperand();
+                if (!elem) {
+                    result_.skipped++;
+                    break;
+                }
+                uint64_t start = Now();
+                dom_element_setattribute_n(elem, name.data(), name.size(), value.data(), value.size());
+                Count(op, start);
+                break;
+            }
+            case Op::kGetAttribute:
+            case Op::kRemoveAttribute:
+            case Op::kHasAttribute: {
+                DOMElement* elem = reinterpret_cast<DOMElement*>(NodeOperand());
+                std::string_view name = StringOperand();
+                if (!elem) {
+                    result_.skipped++;
+                    break;
+                }
+                uint64_t start = Now();
+                if (op == Op::kGetAttribute) {
+                    DOMStringView value;
+                    dom_element_getattribute_view_n(elem, name.data(), name.size(), &value);
+                } else if (op == Op::kRemoveAttribute) {
+                    dom_element_removeattribute_n(elem, name.data(), name.size());
+                } else {
+                    dom_element_hasattribute_n(elem, name.data(), name.size());
+                }
+                Count(op, start);
+                break;
+            }
+            case Op::kGetElementById:
+            case Op::kQuerySelector:
+            case Op::kClosest: {
+                DOMNode* scope = NodeOperand();
+                std::string_view text = StringOperand();
+                DOMElement* found = nullptr;
+                if (scope) {
+                    uint64_t start = Now();
+                    if (op == Op::kGetElementById) {
+                        found = dom_document_getelementbyid_n(reinterpret_cast<DOMDocument*>(scope),
+                                                              text.data(), text.size());
+                    } else if (op == Op::kClosest) {
+                        found = dom_element_closest_n(reinterpret_cast<DOMElement*>(scope),
+                                                      text.data(), text.size());
+                    } else if (dom_node_get_nodetype(scope) == 9) {
+                        found = dom_document_queryselector_n(reinterpret_cast<DOMDocument*>(scope),
+                                                             text.data(), text.size());
+                    } else {
+                        found = dom_element_queryselector_n(reinterpret_cast<DOMElement*>(scope),
+                                                            text.data(), text.size());
+                    }
+                    Count(op, start);
+                } else {
+                    result_.skipped++;
+                }
+                Bind(reinterpret_cast<DOMNode*>(found), false);
+                break;
+            }
+            case Op::kQuerySelectorAll: {
+                DOMNode* scope = NodeOperand();
+                std::string_view selectors = StringOperand();
+                uint64_t recorded = reader_.Varint();
+                if (!scope) {
+                    result_.skipped++;
+                    break;
+                }
+                std::string terminated(selectors);
+                uint64_t start = Now();
+                DOMNodeList* list = dom_node_get_nodetype(scope) == 9
+                    ? dom_document_queryselectorall(reinterpret_cast<DOMDocument*>(scope), terminated.c_str())
+                    : dom_element_queryselectorall_n(reinterpret_cast<DOMElement*>(scope),
+                                                     selectors.data(), selectors.size());
+                Count(op, start);
+                uint32_t matches = list ? dom_nodelist_static_get_length(list) : 0;
+                if (matches != recorded) {
+                    result_.diverged++;
+                }
+                if (list) {
+                    dom_nodelist_static_release(list);
+                }
+                break;
+            }
+            case Op::kMatches: {
+                DOMElement* elem = reinterpret_cast<DOMElement*>(NodeOperand());
+                std::string_view selectors = StringOperand();
+                if (!elem) {
+                    result_.skipped++;
+                    break;
+                }
+                uint64_t start = Now();
+                dom_element_matches_n(elem, selectors.data(), selectors.size());
+                Count(op, start);
+                break;
+            }
+            case Op::kSetTextContent:
+            case Op::kSetData: {
+                DOMNode* node = NodeOperand();
+                std::string_view text = StringOperand();
+                if (!node) {
+                    result_.skipped++;
+                    break;
+                }
+                uint64_t start = Now();
+                if (op == Op::kSetTextContent) {
+                    dom_node_set_textcontent_n(node, text.data(), text.size());
+                } else {
+                    dom_characterdata_set_data_n(reinterpret_cast<DOMCharacterData*>(node),
+                                                 text.data(), text.size());
+                }
+                Count(op, start);
+                break;
+            }
+            case Op::kCount:
+            default:
+                result_.failed = true;
+                break;
+        }
+    }
+
+    Reader reader_;
+    DOMDocument* document_;
+    std::vector<DOMNode*> nodes_;
+    std::vector<std::string_view> strings_;  // Slices of the trace buffer
+    PassResult result_;
+};
+
+bool ReadFile(const char* path, std::vector<uint8_t>* out) {
+    FILE* file = std::fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+    uint8_t buffer[1 << 16];
+    size_t read;
+    while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        out->insert(out->end(), buffer, buffer + read);
+    }
+    std::fclose(file);
+    return true;
+}
+
+std::string JsonEscape(const char* s) {
+    std::string out;
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') {
+            out += '\\';
+        }
+        out += *s;
+    }
+    return out;
+}
+
+void WriteJson(FILE* out, const PassResult& best, const char* trace_path, const char* machine,
+               uint32_t iterations) {
+    char date[16];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%d", std::localtime(&now));
+
+    std::fprintf(out, "{\n");
+    std::fprintf(out, "  \"version\": \"trace-v%u\",\n", v8_dom::call_trace::kVersion);
+    std::fprintf(out, "  \"baseline_date\": \"%s\",\n", date);
+    std::fprintf(out, "  \"machine\": \"%s\",\n", JsonEscape(machine).c_str());
+    std::fprintf(out, "  \"benchmarks\": {\n");
+    bool first = true;
+    for (size_t i = 0; i < kFamilyCount; i++) {
+        const FamilyTimes& times = best.families[i];
+        if (times.calls == 0) {
+            continue;
+        }
+        std::fprintf(out, "%s    \"replay_%s\": {\n", first ? "" : ",\n", v8_dom::call_trace::kFamilyNames[i]);
+        std::fprintf(out, "      \"ns_per_op\": %.2f,\n", double(times.ns) / double(times.calls));
+        std::fprintf(out, "      \"description\": \"%llu %s calls replayed from %s\"\n",
+                     static_cast<unsigned long long>(times.calls), v8_dom::call_trace::kFamilyNames[i],
+                     JsonEscape(trace_path).c_str());
+        std::fprintf(out, "    }");
+        first = false;
+    }
+    std::fprintf(out, "\n  },\n");
+    std::fprintf(out, "  \"notes\": \"call trace replay (make replay), best of %u passes, %llu skipped, %llu diverged\"\n",
+                 iterations, static_cast<unsigned long long>(best.skipped),
+                 static_cast<unsigned long long>(best.diverged));
+    std::fprintf(out, "}\n");
+}
+
+void PrintUsage() {
+    std::fprintf(stderr,
+        "Usage: trace_replay <trace> [--iterations <n>] [--out <file>] [--machine <class>]\n"
+        "  --iterations  Passes over the trace; the fastest is reported per family (default 5)\n"
+        "  --out         Write the JSON results to a file instead of stdout\n"
+        "  --machine     Machine class to tag the results with (default: the gate's)\n");
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const char* trace_path = nullptr;
+    const char* out_path = nullptr;
+    const char* machine = "";
+    uint32_t iterations = 5;
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            out_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--machine") == 0 && i + 1 < argc) {
+            machine = argv[++i];
+        } else if (argv[i][0] != '-' && !trace_path) {
+            trace_path = argv[i];
+        } else {
+            PrintUsage();
+            return std::strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+    if (!trace_path || iterations == 0) {
+        PrintUsage();
+        return 1;
+    }
+
+    std::vector<uint8_t> trace;
+    if (!ReadFile(trace_path, &trace)) {
+        std::fprintf(stderr, "Cannot read %s\n", trace_path);
+        return 1;
+    }
+    Reader header(trace.data(), trace.size());
+    std::string_view magic = header.Bytes(sizeof(v8_dom::call_trace::kMagic));
+    if (magic != std::string_view(v8_dom::call_trace::kMagic, sizeof(v8_dom::call_trace::kMagic)) ||
+        header.Varint() != v8_dom::call_trace::kVersion) {
+        std::fprintf(stderr, "%s is not a version %u call trace\n", trace_path, v8_dom::call_trace::kVersion);
+        return 1;
+    }
+
+    PassResult best;
+    for (uint32_t pass = 0; pass < iterations; pass++) {
+        PassResult result = Replayer(trace).Run();
+        if (result.failed) {
+            std::fprintf(stderr, "%s is truncated or malformed\n", trace_path);
+            return 1;
+        }
+        if (pass == 0) {
+            best = result;
+            continue;
+        }
+        for (size_t i = 0; i < kFamilyCount; i++) {
+            if (result.families[i].ns < best.families[i].ns) {
+                best.families[i].ns = result.families[i].ns;
+            }
+        }
+    }
+
+    std::fprintf(stderr, "%-28s %12s %12s\n", "family", "ns/op", "calls");
+    for (size_t i = 0; i < kFamilyCount; i++) {
+        const FamilyTimes& times = best.families[i];
+        if (times.calls > 0) {
+            std::fprintf(stderr, "%-28s %12.2f %12llu\n", v8_dom::call_trace::kFamilyNames[i],
+                         double(times.ns) / double(times.calls), static_cast<unsigned long long>(times.calls));
+        }
+    }
+    if (best.skipped || best.diverged) {
+        std::fprintf(stderr, "%llu calls skipped, %llu diverged from the recording\n",
+                     static_cast<unsigned long long>(best.skipped),
+                     static_cast<unsigned long long>(best.diverged));
+    }
+
+    FILE* out = out_path ? std::fopen(out_path, "w") : stdout;
+    if (!out) {
+        std::fprintf(stderr, "Cannot open %s\n", out_path);
+        return 1;
+    }
+    WriteJson(out, best, trace_path, machine, iterations);
+    if (out_path) {
+        std::fclose(out);
+    }
+    return 0;
+}
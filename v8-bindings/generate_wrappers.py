@@ -6,17 +6,23 @@ This script generates V8 wrapper code for all DOM interfaces based on the C-ABI.
 It reads the dom.h header and generates corresponding wrapper classes.
 
 Usage:
-    python3 generate_wrappers.py
+    python3 generate_wrappers.py            # wrapper skeletons
+    python3 generate_wrappers.py --traits   # src/core/wrapper_traits_generated.h only
 
 Output:
     src/nodes/*.{h,cpp}
     src/collections/*.{h,cpp}
     src/events/*.{h,cpp}
     etc.
+
+The wrapper skeletons are a starting point and are edited by hand once
+generated. The traits header is regenerated whenever WRAPPER_TRAITS or
+TEMPLATE_INDICES change and is never edited by hand.
 """
 
 import os
 import re
+import sys
 from typing import List, Dict, Tuple
 
 # Template indices for each wrapper type
@@ -50,8 +56,68 @@ TEMPLATE_INDICES = {
     'ShadowRoot': 26,
     'AbortController': 27,
     'AbortSignal': 28,
+    # 29 and 30: ChildListWrapper (childNodes, children)
+    'MutationRecordBatch': 31,
+    'TreeBuilder': 32,
+    'CustomElementRegistry': 33,
+    'ElementIterator': 34,
+    'DOMException': 35,
+    'ListIterator': 36,
+    'SlicedQuery': 37,
+    'DOMStringMap': 38,
+}
+
+# How each wrapper caches and owns its C object (WrapperTraits<T>):
+#   storage: 'node'   - node wrapper slot (WrapperCache::LookupNode/SetNode)
+#            'map'    - pointer map (WrapperCache::Lookup/Set)
+#            'custom' - Wrap caches binding-side state of its own; only the
+#                       template index is shared
+#   addref:  called when the wrapper is created; None adopts the caller's
+#            reference
+#   release: called when the wrapper is collected; None if not owned
+# Node interfaces without refcount functions of their own use dom_node_*.
+WRAPPER_TRAITS = {
+    'EventTarget': ('custom', None, None),
+    'Node': ('node', 'dom_node_addref', 'dom_node_release'),
+    'Element': ('node', 'dom_element_addref', 'dom_element_release'),
+    'Document': ('node', 'dom_document_addref', 'dom_document_release'),
+    'DocumentFragment': ('node', 'dom_documentfragment_addref', 'dom_documentfragment_release'),
+    'CharacterData': ('node', 'dom_node_addref', 'dom_node_release'),
+    'Text': ('node', 'dom_node_addref', 'dom_node_release'),
+    'Comment': ('node', 'dom_node_addref', 'dom_node_release'),
+    'CDATASection': ('node', 'dom_node_addref', 'dom_node_release'),
+    'ProcessingInstruction': ('node', 'dom_node_addref', 'dom_node_release'),
+    'DocumentType': ('node', 'dom_node_addref', 'dom_node_release'),
+    'Attr': ('node', 'dom_attr_addref', 'dom_attr_release'),
+    'DOMImplementation': ('map', 'dom_domimplementation_addref', 'dom_domimplementation_release'),
+    'NodeList': ('custom', None, None),
+    'HTMLCollection': ('custom', None, None),
+    'NamedNodeMap': ('custom', None, None),
+    'DOMTokenList': ('custom', None, None),
+    'Event': ('map', 'dom_event_addref', 'dom_event_release'),
+    'CustomEvent': ('map', 'dom_customevent_addref', 'dom_customevent_release'),
+    'AbstractRange': ('map', None, None),
+    'Range': ('map', None, 'dom_range_release'),
+    'StaticRange': ('map', None, 'dom_staticrange_release'),
+    'NodeIterator': ('custom', None, None),
+    'TreeWalker': ('custom', None, None),
+    'MutationObserver': ('custom', None, None),
+    'MutationRecord': ('custom', None, None),
+    'MutationRecordBatch': ('custom', None, None),
+    'ShadowRoot': ('node', 'dom_node_addref', 'dom_node_release'),
+    'AbortController': ('map', None, 'dom_abortcontroller_release'),
+    'AbortSignal': ('map', 'dom_abortsignal_acquire', 'dom_abortsignal_release'),
+    'TreeBuilder': ('custom', None, None),
+    'CustomElementRegistry': ('map', None, None),
+    'ElementIterator': ('custom', None, None),
+    'DOMException': ('custom', None, None),
+    'ListIterator': ('custom', None, None),
+    'SlicedQuery': ('custom', None, None),
+    'DOMStringMap': ('custom', None, None),
 }
 
+TRAITS_HEADER = "src/core/wrapper_traits_generated.h"
+
 # Inheritance relationships
 INHERITANCE = {
     'Node': 'EventTarget',
@@ -68,13 +134,92 @@ INHERITANCE = {
     'ShadowRoot': 'DocumentFragment',
 }
 
+def traits_call(function: str, interface_name: str, arg: str, from_void: bool) -> str:
+    """Call a refcount function, casting to DOMNode* for dom_node_* on subtypes."""
+    dom_type = f"DOM{interface_name}"
+    if function.startswith("dom_node_") and interface_name != "Node":
+        if from_void:
+            return f"{function}(static_cast<DOMNode*>({arg}))"
+        return f"{function}((DOMNode*){arg})"
+    if from_void:
+        return f"{function}(static_cast<{dom_type}*>({arg}))"
+    return f"{function}({arg})"
+
+def generate_traits_specialization(interface_name: str) -> str:
+    """Generate the WrapperTraits<T> specialization of one wrapper."""
+    storage, addref, release = WRAPPER_TRAITS[interface_name]
+    wrapper_class = f"{interface_name}Wrapper"
+    lines = [
+        "template <>",
+        f"struct WrapperTraits<{wrapper_class}> {{",
+    ]
+    if storage == 'custom':
+        lines += [
+            f"    static constexpr int kTemplateIndex = {TEMPLATE_INDICES[interface_name]};",
+            "    static constexpr WrapperStorage kStorage = WrapperStorage::kCustom;",
+            "};",
+        ]
+        return "\n".join(lines)
+
+    kind = "kNodeSlot" if storage == 'node' else "kMap"
+    lines += [
+        f"    using Object = DOM{interface_name};",
+        f"    static constexpr int kTemplateIndex = {TEMPLATE_INDICES[interface_name]};",
+        f"    static constexpr WrapperStorage kStorage = WrapperStorage::{kind};",
+    ]
+    if addref:
+        lines += [
+            "    static constexpr bool kAddsRef = true;",
+            f"    static void AddRef(Object* obj) {{ {traits_call(addref, interface_name, 'obj', False)}; }}",
+        ]
+    elif release:
+        lines.append("    static constexpr bool kAddsRef = false;  // adopts the caller's reference")
+    else:
+        lines.append("    static constexpr bool kAddsRef = false;")
+    if release:
+        lines += [
+            "    static constexpr ReleaseCallback kRelease = [](void* ptr) {",
+            f"        {traits_call(release, interface_name, 'ptr', True)};",
+            "    };",
+        ]
+    else:
+        lines.append("    static constexpr ReleaseCallback kRelease = nullptr;  // not owned")
+    lines.append("};")
+    return "\n".join(lines)
+
+def generate_traits() -> str:
+    """Generate src/core/wrapper_traits_generated.h."""
+    interfaces = sorted(WRAPPER_TRAITS, key=lambda name: TEMPLATE_INDICES[name])
+    declarations = "\n".join(f"class {name}Wrapper;" for name in interfaces)
+    specializations = "\n\n".join(generate_traits_specialization(name) for name in interfaces)
+    return f'''/**
+ * Wrapper Traits - generated by generate_wrappers.py --traits; do not edit
+ *
+ * One WrapperTraits<T> specialization per wrapper class, from the
+ * TEMPLATE_INDICES and WRAPPER_TRAITS tables of the generator. Included
+ * by wrapper_traits.h.
+ */
+
+#ifndef V8_DOM_WRAPPER_TRAITS_GENERATED_H
+#define V8_DOM_WRAPPER_TRAITS_GENERATED_H
+
+namespace v8_dom {{
+
+{declarations}
+
+{specializations}
+
+}} // namespace v8_dom
+
+#endif // V8_DOM_WRAPPER_TRAITS_GENERATED_H
+'''
+
 def generate_header(interface_name: str, parent_class: str = None) -> str:
     """Generate wrapper header file."""
     guard = f"V8_DOM_{interface_name.upper()}_WRAPPER_H"
     dom_type = f"DOM{interface_name}"
     wrapper_class = f"{interface_name}Wrapper"
     parent_wrapper = f"{parent_class}Wrapper" if parent_class else "BaseWrapper"
-    template_index = TEMPLATE_INDICES.get(interface_name, 99)
     
     parent_include = f'#include "{parent_class.lower()}_wrapper.h"' if parent_class else '#include "../core/base_wrapper.h"'
     
@@ -89,6 +234,7 @@ def generate_header(interface_name: str, parent_class: str = None) -> str:
 #define {guard}
 
 #include <v8.h>
+#include "../core/wrapper_traits.h"
 {parent_include}
 #include "../../js-bindings/dom.h"
 
@@ -122,7 +268,12 @@ public:
     /**
      * Template cache index.
      */
-    static constexpr int kTemplateIndex = {template_index};
+    static constexpr int kTemplateIndex = WrapperTraits<{wrapper_class}>::kTemplateIndex;
+    
+    /**
+     * Type tag stored in the wrapper's type internal field.
+     */
+    static const WrapperTypeInfo kTypeInfo;
     
 private:
     // Property getters/setters and methods will be added here
@@ -141,76 +292,47 @@ def generate_implementation(interface_name: str, parent_class: str = None) -> st
     lower_name = interface_name.lower()
     parent_wrapper = f"{parent_class}Wrapper" if parent_class else ""
     
+    parent_type_info = f"&{parent_wrapper}::kTypeInfo" if parent_class else "nullptr"
+    
     inherit_line = f"    // Inherit from {parent_class}\n    tmpl->Inherit({parent_wrapper}::GetTemplate(isolate));\n" if parent_class else ""
     
+    if WRAPPER_TRAITS[interface_name][0] == 'custom':
+        # Custom wrappers cache binding-side state (see NodeListWrapper)
+        wrap_body = "    // TODO: Build and cache the wrapper state\n    return v8::Local<v8::Object>();"
+        unwrap_body = f"    return static_cast<{dom_type}*>(UnwrapObject(obj, &kTypeInfo));"
+    else:
+        wrap_body = f"    return WrapWithTraits<{wrapper_class}>(isolate, context, obj);"
+        unwrap_body = f"    return UnwrapWithTraits<{wrapper_class}>(obj);"
+    
     return f'''#include "{lower_name}_wrapper.h"
-#include "../core/wrapper_cache.h"
 #include "../core/template_cache.h"
 #include "../core/utilities.h"
 
 namespace v8_dom {{
 
+const WrapperTypeInfo {wrapper_class}::kTypeInfo = {{"{interface_name}", {parent_type_info}}};
+
 v8::Local<v8::Object> {wrapper_class}::Wrap(v8::Isolate* isolate,
                                               v8::Local<v8::Context> context,
                                               {dom_type}* obj) {{
-    if (!obj) {{
-        return v8::Local<v8::Object>();
-    }}
-    
-    // Check wrapper cache first
-    WrapperCache* cache = WrapperCache::ForIsolate(isolate);
-    if (cache->Has(obj)) {{
-        return cache->Get(isolate, obj);
-    }}
-    
-    // Create new wrapper
-    v8::EscapableHandleScope handle_scope(isolate);
-    v8::Local<v8::FunctionTemplate> tmpl = GetTemplate(isolate);
-    v8::Local<v8::Function> constructor = tmpl->GetFunction(context).ToLocalChecked();
-    v8::Local<v8::Object> wrapper = constructor->NewInstance(context).ToLocalChecked();
-    
-    // Store C pointer in internal field
-    wrapper->SetInternalField(0, v8::External::New(isolate, obj));
-    
-    // Increment C-side reference count
-    dom_{lower_name}_addref(obj);
-    
-    // Cache with release callback
-    cache->Set(isolate, obj, wrapper, [](void* ptr) {{
-        dom_{lower_name}_release(static_cast<{dom_type}*>(ptr));
-    }});
-    
-    return handle_scope.Escape(wrapper);
+{wrap_body}
 }}
 
 {dom_type}* {wrapper_class}::Unwrap(v8::Local<v8::Object> obj) {{
-    if (obj.IsEmpty() || obj->InternalFieldCount() < 1) {{
-        return nullptr;
-    }}
-    
-    v8::Local<v8::Value> ptr = obj->GetInternalField(0);
-    if (!ptr->IsExternal()) {{
-        return nullptr;
-    }}
-    
-    return static_cast<{dom_type}*>(v8::Local<v8::External>::Cast(ptr)->Value());
+{unwrap_body}
 }}
 
 void {wrapper_class}::InstallTemplate(v8::Isolate* isolate) {{
     v8::Local<v8::FunctionTemplate> tmpl = v8::FunctionTemplate::New(isolate);
     tmpl->SetClassName(v8::String::NewFromUtf8Literal(isolate, "{interface_name}"));
-    tmpl->InstanceTemplate()->SetInternalFieldCount(1);
+    tmpl->InstanceTemplate()->SetInternalFieldCount(kWrapperFieldCount);
     
 {inherit_line}
-    // Get prototype template for adding properties/methods
-    v8::Local<v8::ObjectTemplate> proto = tmpl->PrototypeTemplate();
-    
-    // TODO: Add properties and methods here
+    // TODO: List properties and methods in a kProperties table and
+    // install it with InstallProperties(isolate, tmpl, kProperties).
     // Example:
-    // proto->SetAccessor(v8::String::NewFromUtf8Literal(isolate, "propertyName"),
-    //                   PropertyNameGetter, PropertyNameSetter);
-    // proto->Set(v8::String::NewFromUtf8Literal(isolate, "methodName"),
-    //           v8::FunctionTemplate::New(isolate, MethodName));
+    //     DataProperty("propertyName", PropertyNameGetter, PropertyNameSetter),
+    //     MethodProperty("methodName", MethodName),
     
     // Cache the template
     TemplateCache* cache = TemplateCache::ForIsolate(isolate);
@@ -230,11 +352,21 @@ v8::Local<v8::FunctionTemplate> {wrapper_class}::GetTemplate(v8::Isolate* isolat
 }} // namespace v8_dom
 '''
 
+def write_traits():
+    """Regenerate the WrapperTraits<T> specializations."""
+    with open(TRAITS_HEADER, 'w') as f:
+        f.write(generate_traits())
+    print(f"✓ Generated {TRAITS_HEADER}")
+
 def main():
     """Generate all wrapper files."""
     print("V8 DOM Wrapper Generator")
     print("=" * 60)
     
+    if "--traits" in sys.argv[1:]:
+        write_traits()
+        return
+    
     # Create output directories
     os.makedirs("src/nodes", exist_ok=True)
     os.makedirs("src/collections", exist_ok=True)
@@ -244,6 +376,7 @@ def main():
     os.makedirs("src/observers", exist_ok=True)
     os.makedirs("src/shadow", exist_ok=True)
     os.makedirs("src/abort", exist_ok=True)
+    os.makedirs("src/core", exist_ok=True)
     
     # Node wrappers
     node_types = [
@@ -329,6 +462,9 @@ def main():
         
         generated_count += 2
     
+    write_traits()
+    generated_count += 1
+    
     print("=" * 60)
     print(f"Generated {generated_count} files successfully!")
     print("\nNext steps:")
@@ -27,6 +27,14 @@
 #define V8_DOM_H
 
 #include <v8.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// C-ABI node and document handles (see dom.h)
+typedef struct DOMNode DOMNode;
+typedef struct DOMDocument DOMDocument;
+typedef struct DOMSharedNames DOMSharedNames;
 
 /**
  * V8 DOM Bindings namespace.
@@ -43,6 +51,9 @@ namespace v8_dom {
  * 2. Installs all DOM interface templates (Node, Element, Document, etc.)
  * 3. Creates a global 'document' object
  * 4. Exposes DOMImplementation for creating new documents
+ * 5. Exposes the MutationObserver constructor (records are delivered from
+ *    one microtask per isolate covering every pending observer, so the
+ *    embedder must run microtask checkpoints)
  * 
  * Call this BEFORE creating your V8 context.
  * 
@@ -63,11 +74,408 @@ namespace v8_dom {
 void InstallDOMBindings(v8::Isolate* isolate,
                        v8::Local<v8::ObjectTemplate> global);
 
+/**
+ * Store node wrappers in the node's embedder slot instead of a hash map.
+ * 
+ * With this enabled, wrapping a node reached by traversal (firstChild,
+ * nextSibling, ...) is a slot load instead of a hash lookup. Non-node
+ * objects (NodeList, Range, ...) keep using the hash map.
+ * 
+ * Call this right after InstallDOMBindings(), before any script runs.
+ * Each node has a single slot, so enable it on at most one isolate per
+ * document; nodes whose slot is taken fall back to the hash map.
+ * 
+ * @param isolate The V8 isolate
+ * @return true if enabled, false if wrappers were already created
+ */
+bool EnableNodeWrapperSlots(v8::Isolate* isolate);
+
+/**
+ * Keep wrappers of nodes connected to a wrapped document alive.
+ * 
+ * Without this, a node wrapper dropped by script is collected and the
+ * node gets a fresh wrapper (without its expando properties) the next
+ * time it is reached. With it, wrappers of connected nodes are held
+ * strongly until their node leaves the document or the document wrapper
+ * dies, and take no part in the GC's weak handle processing meanwhile.
+ * 
+ * Requires EnableNodeWrapperSlots(); call right after it.
+ * 
+ * @param isolate The V8 isolate
+ * @return true if enabled, false if node wrapper slots are not enabled
+ */
+bool EnableWrapperTreeRetention(v8::Isolate* isolate);
+
+/**
+ * Move C-side releases of collected wrappers out of GC weak processing.
+ * 
+ * Weak callbacks then queue the DOM objects of collected wrappers, and
+ * the queue is drained after each GC, a bounded number per GC, nodes in
+ * batches. Tearing down a large collected subtree no longer happens
+ * inside the GC pause. Call DrainDeferredReleases() from idle time to
+ * apply releases left over by the per-GC bound.
+ * 
+ * @param isolate The V8 isolate
+ */
+void EnableDeferredReleases(v8::Isolate* isolate);
+
+/**
+ * Apply up to max queued releases (see EnableDeferredReleases()).
+ * 
+ * @param isolate The V8 isolate
+ * @param max Maximum number of releases to apply
+ * @return Number of releases still queued
+ */
+size_t DrainDeferredReleases(v8::Isolate* isolate, size_t max);
+
+/**
+ * Spend idle time building the document's lazy indices.
+ * 
+ * Runs dom_document_run_idle_work() on the isolate's document, so queries
+ * after a burst of mutations find the class index, compact layout,
+ * document order index and structural hashes built. Call it from a V8
+ * idle task with the time left until its deadline:
+ * 
+ *   void Run(double deadline_in_seconds) override {
+ *       double left = deadline_in_seconds - platform->MonotonicallyIncreasingTime();
+ *       if (v8_dom::RunIdleWork(isolate, left > 0 ? uint64_t(left * 1e9) : 0)) {
+ *           runner->PostIdleTask(std::make_unique<IndexIdleTask>(*this));
+ *       }
+ *   }
+ * 
+ * @param isolate The V8 isolate
+ * @param budget_ns Time budget in nanoseconds
+ * @return true if work remains for another idle task
+ */
+bool RunIdleWork(v8::Isolate* isolate, uint64_t budget_ns);
+
+/**
+ * Report the current size of every wrapped document to V8.
+ * 
+ * Wrapped documents report their Zig-side memory as external memory
+ * (see dom_document_get_allocated_bytes()) when wrapped, every 1024
+ * wrapper creations and when their wrapper is collected. Call this after
+ * large native-side changes (parsing, bulk building) to update it now.
+ * 
+ * @param isolate The V8 isolate
+ */
+void ReportExternalMemory(v8::Isolate* isolate);
+
+/**
+ * Apply patches other threads submit to doc at every task boundary.
+ * 
+ * Producer threads queue patches with dom_document_submit_patch(), which
+ * takes no lock; the one that finds the queue empty (should_wake == 1)
+ * posts a task to the isolate's thread. After each microtask checkpoint,
+ * i.e. when a task's script and microtasks are done, the isolate applies
+ * every queued patch of the registered documents in one mutation batch
+ * per document. Mutation observers see the records at the next
+ * checkpoint. An empty queue costs one atomic load per document.
+ * 
+ * Keeps a reference to doc until Cleanup(). Registering doc again does
+ * nothing.
+ * 
+ * @param isolate The V8 isolate
+ * @param doc Document producers submit patches to
+ */
+void DrainPatchesAtTaskBoundaries(v8::Isolate* isolate, DOMDocument* doc);
+
+/**
+ * Apply the queued patches of the documents registered with
+ * DrainPatchesAtTaskBoundaries() now, e.g. from the task a producer
+ * posted when the isolate runs no script.
+ * 
+ * @param isolate The V8 isolate
+ * @return Number of patches applied
+ */
+size_t DrainSubmittedPatches(v8::Isolate* isolate);
+
+/**
+ * Create the wrappers of a subtree before script traverses it.
+ * 
+ * After a bulk build or a template clone, a traversal from script wraps
+ * every node it reaches one at a time. This creates the wrappers of up
+ * to max descendants of node (in tree order, skipping those that have
+ * one) in a single pass: one cache reservation, one constructor lookup
+ * per node type and one handle scope per 1024 wrappers. node itself is
+ * not wrapped. Script can do the same with node.__prewrap(max).
+ * 
+ * Prewrapped wrappers are weak like any other, so unless wrapper tree
+ * retention is enabled (EnableWrapperTreeRetention()) the next GC may
+ * collect those script has not reached yet.
+ * 
+ * @param isolate The V8 isolate
+ * @param context Context to create the wrappers in
+ * @param node Root of the subtree
+ * @param max Maximum number of wrappers to create
+ * @return Number of wrappers created
+ */
+size_t PrewrapSubtree(v8::Isolate* isolate, v8::Local<v8::Context> context,
+                      DOMNode* node, size_t max);
+
+/**
+ * Make a document built on another thread the isolate's document.
+ * 
+ * Building a large document (dom_document_new(), dom_builder_*()) need
+ * not block the isolate: until it is first wrapped, a document may be
+ * used on any one thread at a time. Build it on a worker, pass it to the
+ * isolate's thread through something that synchronizes (a queue, a
+ * join), then adopt it there; from then on it belongs to the isolate.
+ * 
+ * This installs doc as the global 'document', taking over the caller's
+ * reference. Call it before script first reads 'document'.
+ * 
+ * @param isolate The V8 isolate
+ * @param doc Document no wrapper has been created for
+ * @return true if doc is now the isolate's document, false (doc stays
+ *         with the caller) if the isolate's document was already created
+ * 
+ * Example:
+ *   // Worker thread
+ *   DOMDocument* doc = dom_document_new();
+ *   DOMTreeBuilder* builder = dom_builder_new(doc);
+ *   ... dom_builder_write(builder, chunk, length) per network read ...
+ *   dom_node_appendchild((DOMNode*)doc, (DOMNode*)dom_builder_finish(builder));
+ *   queue.push(doc);
+ * 
+ *   // Isolate thread
+ *   v8_dom::AdoptDocument(isolate, queue.pop());
+ */
+bool AdoptDocument(v8::Isolate* isolate, DOMDocument* doc);
+
+/**
+ * Hand a document built on another thread to script as a wrapper.
+ * 
+ * Same handoff as AdoptDocument(isolate, doc), for documents other than
+ * the global 'document' (one per request, ...). The wrapper takes over
+ * the caller's reference, and the document's wrappers get a partition of
+ * their own, as with CreateDocument().
+ * 
+ * @param isolate The V8 isolate
+ * @param context Context to create the wrapper in
+ * @param doc Document no wrapper has been created for
+ * @return The document's wrapper
+ */
+v8::Local<v8::Object> AdoptDocument(v8::Isolate* isolate, v8::Local<v8::Context> context,
+                                    DOMDocument* doc);
+
+/**
+ * Create a document of its own, besides the global 'document'.
+ * 
+ * For isolates that go through many documents (one per crawled page,
+ * ...). The wrapper cache keeps the wrappers of the document and of its
+ * nodes in a partition of their own, so DisposeDocument() drops them all
+ * at once instead of each waiting for its weak callback.
+ * 
+ * @param isolate The V8 isolate
+ * @param context Context to create the wrapper in
+ * @return The new document's wrapper
+ */
+v8::Local<v8::Object> CreateDocument(v8::Isolate* isolate, v8::Local<v8::Context> context);
+
+/**
+ * Share one pool of common names among the isolate's documents.
+ * 
+ * Documents the bindings create for the isolate from now on (the global
+ * 'document' if script has not read it yet, CreateDocument()) are made
+ * with dom_document_new_with_sharednames(shared): common tag and
+ * attribute names are stored once for all of them, compare equal by
+ * pointer, and are not copied when nodes move between them. The same
+ * pool may serve several isolates, even on different threads.
+ * 
+ * @param isolate The V8 isolate
+ * @param shared Pool from dom_sharednames_new() (referenced), or nullptr
+ *        to create documents without one again
+ */
+void SetSharedNames(v8::Isolate* isolate, DOMSharedNames* shared);
+
+/**
+ * Drop a document from CreateDocument() or AdoptDocument(isolate, context,
+ * doc), with every wrapper of its nodes, in one sweep.
+ * 
+ * For deterministic teardown at the end of a request. The document's
+ * wrappers are found through its partition, so this is one pass over
+ * them, however many other wrappers the isolate has, and no GC. Each
+ * wrapper is detached from its node, so script still holding one gets
+ * "Illegal invocation" (or an invalid object error) instead of reaching
+ * the node. The node references are released in one batch, the
+ * document's last, and unless something else (a live HTMLCollection or
+ * NodeList, another embedder reference) still holds the document, it
+ * then frees its whole tree in one walk. Nodes adopted into another document keep
+ * their wrappers.
+ * 
+ * @param isolate The V8 isolate
+ * @param document The document's wrapper
+ * @return Number of wrappers dropped (0 if document was not created by
+ *         CreateDocument() or AdoptDocument(), or is disposed already)
+ */
+size_t DisposeDocument(v8::Isolate* isolate, v8::Local<v8::Object> document);
+
+/**
+ * Counters of one wrapper interface (Element, Text, NodeList, ...).
+ */
+struct InterfaceStats {
+    const char* name;
+    uint64_t wrappers_created;
+    uint64_t wrappers_collected;
+    uint64_t calls;  // Receivers and arguments unwrapped as this interface
+};
+
+/**
+ * Snapshot of an isolate's binding statistics.
+ * 
+ * Cache sizes and the atom and selector cache counters are always kept.
+ * The activity counters (counters_enabled) are only counted in builds with
+ * V8_DOM_STATS=1 (make STATS=1) and read zero otherwise.
+ */
+struct Stats {
+    bool counters_enabled;
+    
+    // Wrapper cache
+    size_t wrappers_live;
+    size_t node_slot_high_water;
+    size_t node_slot_capacity;
+    size_t wrappers_retained;
+    size_t releases_pending;
+    int64_t external_memory_reported;
+    uint64_t wrapper_cache_hits;
+    uint64_t wrapper_cache_misses;
+    uint64_t wrappers_created;
+    uint64_t wrappers_collected;
+    
+    // Templates and strings
+    uint64_t template_installs;
+    uint64_t string_conversions;
+    uint64_t string_bytes_copied;
+    size_t external_strings;
+    size_t atoms;
+    uint64_t atom_hits;
+    uint64_t atom_misses;
+    
+    // Compiled selectors
+    size_t selectors;
+    uint64_t selector_hits;
+    uint64_t selector_misses;
+    
+    // Per interface (counters_enabled only)
+    std::vector<InterfaceStats> interfaces;
+};
+
+/**
+ * Read the isolate's binding statistics.
+ * 
+ * Counters are relaxed atomics, so this may run on another thread than
+ * the isolate's (e.g. a metrics scraper) as long as the isolate is not
+ * being disposed; the cache sizes are then approximate.
+ * 
+ * @param isolate The V8 isolate
+ * @return Zeroed stats if the bindings are not installed
+ */
+Stats GetStats(v8::Isolate* isolate);
+
+/**
+ * Receives one sampled binding callback.
+ * 
+ * @param name Wrapper callback, e.g. "ElementWrapper::GetAttribute"
+ *             (static string)
+ * @param start_ns Steady-clock time the callback was entered
+ * @param end_ns Steady-clock time it returned
+ * @param user_data Value passed to SetTraceCallback()
+ */
+using TraceCallback = void (*)(const char* name, uint64_t start_ns, uint64_t end_ns, void* user_data);
+
+/**
+ * Report every Nth binding callback, per thread, with its timestamps.
+ * 
+ * Only effective in builds with V8_DOM_TRACE=1 (make TRACE=1); returns
+ * false otherwise. The callback runs on the isolate's thread inside the
+ * traced call and should only record the span (e.g. as a Perfetto or
+ * Chrome trace complete event). The setting is process-wide; pass
+ * nullptr to stop tracing.
+ * 
+ * @param callback Receiver of sampled spans, or nullptr
+ * @param user_data Passed to every call of callback
+ * @param sample_every Trace one call in this many (1 traces every call)
+ * @return true if tracing is compiled in
+ */
+bool SetTraceCallback(TraceCallback callback, void* user_data, uint32_t sample_every);
+
+/**
+ * Record the dom_* calls script makes on this thread to a trace file.
+ * 
+ * Only effective in builds with V8_DOM_RECORD=1 (make RECORD=1); returns
+ * false otherwise. The trace starts with the markup of the isolate's
+ * document and logs node creation, tree mutation, attribute, query and
+ * text calls with their arguments, nodes as stable ids. Replay it without
+ * V8 with bench/trace_replay (make replay) to time core changes against
+ * recorded traffic.
+ * 
+ * Example:
+ *   v8_dom::StartCallRecording(isolate, "/tmp/page.trace");
+ *   script->Run(context);
+ *   v8_dom::StopCallRecording();
+ * 
+ * @param isolate The V8 isolate whose document the trace starts from
+ * @param path File to create
+ * @return false if recording is not compiled in, the file cannot be
+ *         created or this thread is already recording
+ */
+bool StartCallRecording(v8::Isolate* isolate, const char* path);
+
+/**
+ * Finish this thread's recording and close its file.
+ * 
+ * @return Number of records written (0 if nothing was recording)
+ */
+uint64_t StopCallRecording();
+
+/**
+ * Create a V8 startup snapshot with the DOM already installed.
+ *
+ * The blob contains every DOM template and a default context whose
+ * global has the 'document' accessor, so isolates booted from it skip
+ * template construction. Create it once (at build time or process start)
+ * and reuse it for every isolate; the caller owns blob.data (delete[]).
+ *
+ * Example:
+ *   v8::StartupData blob = v8_dom::CreateSnapshotBlob();
+ *   create_params.snapshot_blob = &blob;
+ *   create_params.external_references = v8_dom::GetExternalReferences();
+ *   v8::Isolate* isolate = v8::Isolate::New(create_params);
+ *   v8_dom::InitializeFromSnapshot(isolate);
+ *   v8::Local<v8::Context> context = v8::Context::New(isolate);
+ *
+ * @return Snapshot blob for Isolate::CreateParams::snapshot_blob
+ */
+v8::StartupData CreateSnapshotBlob();
+
+/**
+ * Get the external reference table for the DOM callbacks.
+ *
+ * Must be passed as Isolate::CreateParams::external_references to every
+ * isolate booted from CreateSnapshotBlob(). Null-terminated; valid for
+ * the lifetime of the process.
+ */
+const intptr_t* GetExternalReferences();
+
+/**
+ * Initialize DOM bindings for an isolate booted from CreateSnapshotBlob().
+ *
+ * Use this instead of InstallDOMBindings(): it loads the snapshotted
+ * templates into the template cache so wrappers use them. Call it once,
+ * right after Isolate::New() and before any script runs.
+ *
+ * @param isolate The V8 isolate created with the DOM snapshot
+ */
+void InitializeFromSnapshot(v8::Isolate* isolate);
+
 /**
  * Cleanup DOM bindings for an isolate.
  * 
- * This is called automatically when the isolate is disposed.
- * You normally don't need to call this manually.
+ * Releases this isolate's document and deletes its wrapper and template
+ * caches, releasing documents from CreateDocument() after their nodes.
+ * Other isolates are not affected. Call it before disposing the
+ * isolate, from the thread that owns it.
  * 
  * @param isolate The V8 isolate to cleanup
  */
@@ -94,9 +502,12 @@ bool IsInstalled(v8::Isolate* isolate);
  * Integration Notes:
  * 
  * 1. Thread Safety:
- *    - Each V8 isolate has its own wrapper cache
- *    - Safe to use multiple isolates (one per thread)
- *    - Not safe to share isolates across threads
+ *    - Each V8 isolate has its own document, wrapper cache and template
+ *      cache (BindingState in isolate data); there is no global state
+ *    - Safe to run multiple isolates in parallel (one per thread)
+ *    - Not safe to share isolates across threads without v8::Locker
+ *    - Documents can be built on worker threads and handed over with
+ *      AdoptDocument() before they are first wrapped
  * 
  * 2. Memory Management:
  *    - Wrappers use weak callbacks for GC integration
@@ -116,6 +527,11 @@ bool IsInstalled(v8::Isolate* isolate);
  * 5. Extending for HTML:
  *    - Create HTMLElementWrapper extending ElementWrapper
  *    - Add innerHTML, outerHTML, and other HTML properties
+ *    - Markup setters can build on dom_element_setinnermarkup() and
+ *      dom_element_insertadjacentmarkup() (also reachable from script as
+ *      the non-enumerable Element.prototype.__setInnerMarkup and
+ *      __insertAdjacentMarkup): the whole string is parsed and inserted
+ *      in one C-ABI call. Getters can use dom_node_serialize().
  *    - Install your templates after calling InstallDOMBindings()
  *    - Do NOT modify the v8-bindings library itself
  * 
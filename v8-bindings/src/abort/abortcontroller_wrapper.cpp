@@ -1,72 +1,38 @@
 #include "abortcontroller_wrapper.h"
+#include "abortsignal_wrapper.h"
 #include "../wrapper_cache.h"
 #include "../core/template_cache.h"
 #include "../core/utilities.h"
 
 namespace v8_dom {
 
+const WrapperTypeInfo AbortControllerWrapper::kTypeInfo = {"AbortController", nullptr};
+
 v8::Local<v8::Object> AbortControllerWrapper::Wrap(v8::Isolate* isolate,
                                               v8::Local<v8::Context> context,
                                               DOMAbortController* obj) {
-    if (!obj) {
-        return v8::Local<v8::Object>();
-    }
-    
-    // Check wrapper cache first
-    WrapperCache* cache = WrapperCache::ForIsolate(isolate);
-    if (cache->Has(obj)) {
-        return cache->Get(isolate, obj);
-    }
-    
-    // Create new wrapper
-    v8::EscapableHandleScope handle_scope(isolate);
-    v8::Local<v8::FunctionTemplate> tmpl = GetTemplate(isolate);
-    v8::Local<v8::Function> constructor = tmpl->GetFunction(context).ToLocalChecked();
-    v8::Local<v8::Object> wrapper = constructor->NewInstance(context).ToLocalChecked();
-    
-    // Store C pointer in internal field
-    wrapper->SetInternalField(0, v8::External::New(isolate, obj));
-    
-    // Increment C-side reference count
-    dom_abortcontroller_addref(obj);
-    
-    // Cache with release callback
-    cache->Set(isolate, obj, wrapper, [](void* ptr) {
-        dom_abortcontroller_release(static_cast<DOMAbortController*>(ptr));
-    });
-    
-    return handle_scope.Escape(wrapper);
+    return WrapWithTraits<AbortControllerWrapper>(isolate, context, obj);
 }
 
 DOMAbortController* AbortControllerWrapper::Unwrap(v8::Local<v8::Object> obj) {
-    if (obj.IsEmpty() || obj->InternalFieldCount() < 1) {
-        return nullptr;
-    }
-    
-    v8::Local<v8::Value> ptr = obj->GetInternalField(0).As<v8::Value>();
-    if (!ptr->IsExternal()) {
-        return nullptr;
-    }
-    
-    return static_cast<DOMAbortController*>(v8::Local<v8::External>::Cast(ptr)->Value());
+    return UnwrapWithTraits<AbortControllerWrapper>(obj);
 }
 
+const PropertyDescriptor AbortControllerWrapper::kProperties[] = {
+    // Readonly properties
+    DataProperty("signal", SignalGetter),
+
+    // Methods
+    MethodProperty("abort", Abort),
+};
+
 void AbortControllerWrapper::InstallTemplate(v8::Isolate* isolate) {
-    v8::Local<v8::FunctionTemplate> tmpl = v8::FunctionTemplate::New(isolate);
+    v8::Local<v8::FunctionTemplate> tmpl = v8::FunctionTemplate::New(isolate, Constructor);
     tmpl->SetClassName(v8::String::NewFromUtf8Literal(isolate, "AbortController"));
-    tmpl->InstanceTemplate()->SetInternalFieldCount(1);
-    
-
-    // Get prototype template for adding properties/methods
-    v8::Local<v8::ObjectTemplate> proto = tmpl->PrototypeTemplate();
-    
-    // TODO: Add properties and methods here
-    // Example:
-    // proto->SetNativeDataProperty(v8::String::NewFromUtf8Literal(isolate, "propertyName"),
-    //                   PropertyNameGetter, PropertyNameSetter);
-    // proto->Set(v8::String::NewFromUtf8Literal(isolate, "methodName"),
-    //           v8::FunctionTemplate::New(isolate, MethodName));
-    
+    tmpl->InstanceTemplate()->SetInternalFieldCount(kWrapperFieldCount);
+
+    InstallProperties(isolate, tmpl, kProperties);
+
     // Cache the template
     TemplateCache* cache = TemplateCache::ForIsolate(isolate);
     cache->Set(kTemplateIndex, tmpl);
@@ -74,12 +40,84 @@ void AbortControllerWrapper::InstallTemplate(v8::Isolate* isolate) {
 
 v8::Local<v8::FunctionTemplate> AbortControllerWrapper::GetTemplate(v8::Isolate* isolate) {
     TemplateCache* cache = TemplateCache::ForIsolate(isolate);
-    
+
     if (!cache->Has(kTemplateIndex)) {
         InstallTemplate(isolate);
     }
-    
+
     return cache->Get(kTemplateIndex);
 }
 
+void AbortControllerWrapper::RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+    registry->Register(Constructor);
+    RegisterProperties(registry, kProperties);
+}
+
+// ============================================================================
+// Constructor
+// ============================================================================
+
+void AbortControllerWrapper::Constructor(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("AbortControllerWrapper::Constructor");
+    v8::Isolate* isolate = args.GetIsolate();
+    if (!args.IsConstructCall()) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Failed to construct 'AbortController': Please use the 'new' operator")));
+        return;
+    }
+
+    // Controllers only come from script, so Wrap() never instantiates the
+    // template for an existing one; the wrapper adopts the initial reference
+    DOMAbortController* controller = dom_abortcontroller_new();
+    v8::Local<v8::Object> wrapper = args.This();
+    SetWrapperFields(wrapper, controller, &kTypeInfo);
+    WrapperCache::ForIsolate(isolate)->Set(isolate, controller, wrapper,
+                                           WrapperTraits<AbortControllerWrapper>::kRelease);
+}
+
+// ============================================================================
+// Property Implementations - Readonly
+// ============================================================================
+
+void AbortControllerWrapper::SignalGetter(v8::Local<v8::Name> property,
+                                          const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("AbortControllerWrapper::SignalGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    DOMAbortController* controller = Unwrap(info.This());
+    if (!controller) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Invalid AbortController")));
+        return;
+    }
+
+    // [SameObject]: the wrapper cache hands back the same wrapper
+    DOMAbortSignal* signal = dom_abortcontroller_get_signal(controller);
+    info.GetReturnValue().Set(AbortSignalWrapper::Wrap(isolate, isolate->GetCurrentContext(), signal));
+}
+
+// ============================================================================
+// Method Implementations
+// ============================================================================
+
+void AbortControllerWrapper::Abort(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("AbortControllerWrapper::Abort");
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    DOMAbortController* controller = UnwrapReceiver<DOMAbortController>(args);
+    if (!controller) {
+        return;
+    }
+
+    DOMAbortSignal* signal = dom_abortcontroller_get_signal(controller);
+    if (dom_abortsignal_get_aborted(signal)) {
+        return;
+    }
+
+    // Keep a script reason before the abort steps run
+    if (args.Length() > 0 && !args[0]->IsUndefined()) {
+        AbortSignalWrapper::SetReason(isolate, AbortSignalWrapper::Wrap(isolate, context, signal), args[0]);
+    }
+    dom_abortcontroller_abort(controller, nullptr);
+}
+
 } // namespace v8_dom
@@ -9,6 +9,9 @@
 #define V8_DOM_ABORTCONTROLLER_WRAPPER_H
 
 #include <v8.h>
+#include "../core/wrapper_traits.h"
+#include "../core/external_references.h"
+#include "../core/property_table.h"
 #include "dom.h"
 
 namespace v8_dom {
@@ -41,11 +44,31 @@ public:
     /**
      * Template cache index.
      */
-    static constexpr int kTemplateIndex = 27;
+    static constexpr int kTemplateIndex = WrapperTraits<AbortControllerWrapper>::kTemplateIndex;
+    
+    /**
+     * Type tag stored in the wrapper's type internal field.
+     */
+    static const WrapperTypeInfo kTypeInfo;
+    
+    /**
+     * Register this wrapper's callbacks for snapshot serialization.
+     */
+    static void RegisterExternalReferences(ExternalReferenceRegistry* registry);
     
 private:
-    // Property getters/setters and methods will be added here
-    // TODO: Parse dom.h to auto-generate these declarations
+    // Prototype members, installed by InstallTemplate()
+    static const PropertyDescriptor kProperties[];
+    
+    // Constructor
+    static void Constructor(const v8::FunctionCallbackInfo<v8::Value>& args);
+    
+    // Readonly properties
+    static void SignalGetter(v8::Local<v8::Name> property,
+                             const v8::PropertyCallbackInfo<v8::Value>& info);
+    
+    // Methods
+    static void Abort(const v8::FunctionCallbackInfo<v8::Value>& args);
 };
 
 } // namespace v8_dom
@@ -1,72 +1,104 @@
 #include "abortsignal_wrapper.h"
+#include <cmath>
+#include <vector>
 #include "../wrapper_cache.h"
 #include "../core/template_cache.h"
 #include "../core/utilities.h"
+#include "../core/domexception_wrapper.h"
 
 namespace v8_dom {
 
+const WrapperTypeInfo AbortSignalWrapper::kTypeInfo = {"AbortSignal", nullptr};
+
+namespace {
+
+v8::Local<v8::Private> ReasonKey(v8::Isolate* isolate) {
+    return v8::Private::ForApi(isolate, v8::String::NewFromUtf8Literal(isolate, "AbortSignal#reason"));
+}
+
+v8::Local<v8::Private> TimeoutKey(v8::Isolate* isolate) {
+    return v8::Private::ForApi(isolate, v8::String::NewFromUtf8Literal(isolate, "AbortSignal#timeout"));
+}
+
+/**
+ * The reason of an aborted signal: the script reason kept on its wrapper,
+ * or a "TimeoutError" (timeout signals) or "AbortError" DOMException,
+ * created on first access and kept so the reason stays the same object.
+ */
+v8::Local<v8::Value> AbortReason(v8::Isolate* isolate, v8::Local<v8::Object> wrapper) {
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    v8::Local<v8::Value> reason;
+    if (wrapper->GetPrivate(context, ReasonKey(isolate)).ToLocal(&reason) && !reason->IsUndefined()) {
+        return reason;
+    }
+
+    v8::Local<v8::Value> timeout;
+    bool timed_out = wrapper->GetPrivate(context, TimeoutKey(isolate)).ToLocal(&timeout) && timeout->IsTrue();
+    v8::Local<v8::Object> error;
+    if (!DOMExceptionWrapper::Create(
+             isolate, context, timed_out ? 23 : 20,  // TimeoutError, AbortError
+             timed_out ? v8::String::NewFromUtf8Literal(isolate, "signal timed out")
+                       : v8::String::NewFromUtf8Literal(isolate, "signal is aborted without reason"))
+             .ToLocal(&error)) {
+        return v8::Undefined(isolate);
+    }
+    AbortSignalWrapper::SetReason(isolate, wrapper, error);
+    return error;
+}
+
+/**
+ * Wrap a signal the caller created, handing its reference to the wrapper.
+ */
+v8::Local<v8::Object> AdoptSignal(v8::Isolate* isolate, v8::Local<v8::Context> context,
+                                  DOMAbortSignal* signal) {
+    v8::Local<v8::Object> wrapper = AbortSignalWrapper::Wrap(isolate, context, signal);
+    dom_abortsignal_release(signal);
+    return wrapper;
+}
+
+} // namespace
+
 v8::Local<v8::Object> AbortSignalWrapper::Wrap(v8::Isolate* isolate,
                                               v8::Local<v8::Context> context,
                                               DOMAbortSignal* obj) {
-    if (!obj) {
-        return v8::Local<v8::Object>();
-    }
-    
-    // Check wrapper cache first
-    WrapperCache* cache = WrapperCache::ForIsolate(isolate);
-    if (cache->Has(obj)) {
-        return cache->Get(isolate, obj);
-    }
-    
-    // Create new wrapper
-    v8::EscapableHandleScope handle_scope(isolate);
-    v8::Local<v8::FunctionTemplate> tmpl = GetTemplate(isolate);
-    v8::Local<v8::Function> constructor = tmpl->GetFunction(context).ToLocalChecked();
-    v8::Local<v8::Object> wrapper = constructor->NewInstance(context).ToLocalChecked();
-    
-    // Store C pointer in internal field
-    wrapper->SetInternalField(0, v8::External::New(isolate, obj));
-    
-    // Increment C-side reference count
-    dom_abortsignal_addref(obj);
-    
-    // Cache with release callback
-    cache->Set(isolate, obj, wrapper, [](void* ptr) {
-        dom_abortsignal_release(static_cast<DOMAbortSignal*>(ptr));
-    });
-    
-    return handle_scope.Escape(wrapper);
+    return WrapWithTraits<AbortSignalWrapper>(isolate, context, obj);
 }
 
 DOMAbortSignal* AbortSignalWrapper::Unwrap(v8::Local<v8::Object> obj) {
-    if (obj.IsEmpty() || obj->InternalFieldCount() < 1) {
-        return nullptr;
-    }
-    
-    v8::Local<v8::Value> ptr = obj->GetInternalField(0).As<v8::Value>();
-    if (!ptr->IsExternal()) {
-        return nullptr;
-    }
-    
-    return static_cast<DOMAbortSignal*>(v8::Local<v8::External>::Cast(ptr)->Value());
+    return UnwrapWithTraits<AbortSignalWrapper>(obj);
+}
+
+void AbortSignalWrapper::SetReason(v8::Isolate* isolate,
+                                   v8::Local<v8::Object> wrapper,
+                                   v8::Local<v8::Value> reason) {
+    wrapper->SetPrivate(isolate->GetCurrentContext(), ReasonKey(isolate), reason).Check();
 }
 
+const PropertyDescriptor AbortSignalWrapper::kProperties[] = {
+    // Readonly properties
+    DataProperty("aborted", AbortedGetter),
+    DataProperty("reason", ReasonGetter),
+
+    // Methods
+    MethodProperty("throwIfAborted", ThrowIfAborted),
+};
+
 void AbortSignalWrapper::InstallTemplate(v8::Isolate* isolate) {
-    v8::Local<v8::FunctionTemplate> tmpl = v8::FunctionTemplate::New(isolate);
+    // Signals come from AbortController and the static methods only
+    v8::Local<v8::FunctionTemplate> tmpl = v8::FunctionTemplate::New(isolate, IllegalConstructor);
     tmpl->SetClassName(v8::String::NewFromUtf8Literal(isolate, "AbortSignal"));
-    tmpl->InstanceTemplate()->SetInternalFieldCount(1);
-    
-
-    // Get prototype template for adding properties/methods
-    v8::Local<v8::ObjectTemplate> proto = tmpl->PrototypeTemplate();
-    
-    // TODO: Add properties and methods here
-    // Example:
-    // proto->SetNativeDataProperty(v8::String::NewFromUtf8Literal(isolate, "propertyName"),
-    //                   PropertyNameGetter, PropertyNameSetter);
-    // proto->Set(v8::String::NewFromUtf8Literal(isolate, "methodName"),
-    //           v8::FunctionTemplate::New(isolate, MethodName));
-    
+    tmpl->InstanceTemplate()->SetInternalFieldCount(kWrapperFieldCount);
+
+    InstallProperties(isolate, tmpl, kProperties);
+
+    // Static methods live on the interface object
+    tmpl->Set(v8::String::NewFromUtf8Literal(isolate, "abort"),
+              v8::FunctionTemplate::New(isolate, Abort, {}, {}, 0));
+    tmpl->Set(v8::String::NewFromUtf8Literal(isolate, "any"),
+              v8::FunctionTemplate::New(isolate, Any, {}, {}, 1));
+    tmpl->Set(v8::String::NewFromUtf8Literal(isolate, "timeout"),
+              v8::FunctionTemplate::New(isolate, Timeout, {}, {}, 1));
+
     // Cache the template
     TemplateCache* cache = TemplateCache::ForIsolate(isolate);
     cache->Set(kTemplateIndex, tmpl);
@@ -74,12 +106,158 @@ void AbortSignalWrapper::InstallTemplate(v8::Isolate* isolate) {
 
 v8::Local<v8::FunctionTemplate> AbortSignalWrapper::GetTemplate(v8::Isolate* isolate) {
     TemplateCache* cache = TemplateCache::ForIsolate(isolate);
-    
+
     if (!cache->Has(kTemplateIndex)) {
         InstallTemplate(isolate);
     }
-    
+
     return cache->Get(kTemplateIndex);
 }
 
+void AbortSignalWrapper::RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+    registry->Register(IllegalConstructor);
+    registry->Register(Abort);
+    registry->Register(Any);
+    registry->Register(Timeout);
+    RegisterProperties(registry, kProperties);
+}
+
+// ============================================================================
+// Property Implementations - Readonly
+// ============================================================================
+
+void AbortSignalWrapper::AbortedGetter(v8::Local<v8::Name> property,
+                                       const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("AbortSignalWrapper::AbortedGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    DOMAbortSignal* signal = Unwrap(info.This());
+    if (!signal) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Invalid AbortSignal")));
+        return;
+    }
+
+    info.GetReturnValue().Set(dom_abortsignal_get_aborted(signal) != 0);
+}
+
+void AbortSignalWrapper::ReasonGetter(v8::Local<v8::Name> property,
+                                      const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("AbortSignalWrapper::ReasonGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    DOMAbortSignal* signal = Unwrap(info.This());
+    if (!signal) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Invalid AbortSignal")));
+        return;
+    }
+
+    if (!dom_abortsignal_get_aborted(signal)) {
+        info.GetReturnValue().SetUndefined();
+        return;
+    }
+    info.GetReturnValue().Set(AbortReason(isolate, info.This()));
+}
+
+// ============================================================================
+// Method Implementations
+// ============================================================================
+
+void AbortSignalWrapper::ThrowIfAborted(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("AbortSignalWrapper::ThrowIfAborted");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMAbortSignal* signal = UnwrapReceiver<DOMAbortSignal>(args);
+    if (!signal) {
+        return;
+    }
+
+    if (dom_abortsignal_get_aborted(signal)) {
+        isolate->ThrowException(AbortReason(isolate, args.This()));
+    }
+}
+
+// ============================================================================
+// Static Method Implementations
+// ============================================================================
+
+void AbortSignalWrapper::Abort(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("AbortSignalWrapper::Abort");
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+
+    v8::Local<v8::Object> wrapper = AdoptSignal(isolate, context, dom_abortsignal_abort(nullptr));
+    if (args.Length() > 0 && !args[0]->IsUndefined()) {
+        SetReason(isolate, wrapper, args[0]);
+    }
+    args.GetReturnValue().Set(wrapper);
+}
+
+void AbortSignalWrapper::Any(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("AbortSignalWrapper::Any");
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+
+    if (args.Length() < 1 || !args[0]->IsArray()) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "AbortSignal.any requires an array of AbortSignals")));
+        return;
+    }
+
+    v8::Local<v8::Array> array = args[0].As<v8::Array>();
+    uint32_t count = array->Length();
+    std::vector<DOMAbortSignal*> signals;
+    signals.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+        v8::Local<v8::Value> item;
+        if (!array->Get(context, i).ToLocal(&item)) {
+            return;
+        }
+        DOMAbortSignal* signal = item->IsObject() ? Unwrap(item.As<v8::Object>()) : nullptr;
+        if (!signal) {
+            isolate->ThrowException(v8::Exception::TypeError(
+                v8::String::NewFromUtf8Literal(isolate, "AbortSignal.any requires an array of AbortSignals")));
+            return;
+        }
+        signals.push_back(signal);
+    }
+
+    // The composite follows its sources through weak links, so it is
+    // collected like any other wrapper once script drops it
+    DOMAbortSignal* composite = dom_abortsignal_any(signals.data(), count);
+    args.GetReturnValue().Set(AdoptSignal(isolate, context, composite));
+}
+
+void AbortSignalWrapper::Timeout(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("AbortSignalWrapper::Timeout");
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+
+    // [EnforceRange] unsigned long long
+    if (args.Length() < 1) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "AbortSignal.timeout requires a delay")));
+        return;
+    }
+    double milliseconds = 0;
+    if (!args[0]->NumberValue(context).To(&milliseconds)) {
+        return;
+    }
+    milliseconds = std::trunc(milliseconds);
+    if (!std::isfinite(milliseconds) || milliseconds < 0 || milliseconds > 9007199254740991.0) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "AbortSignal.timeout delay is outside the unsigned long long range")));
+        return;
+    }
+
+    // One embedder timer serves every pending timeout (see DOMTimerHost)
+    DOMAbortSignal* signal = dom_abortsignal_timeout(static_cast<uint64_t>(milliseconds));
+    if (!signal) {
+        isolate->ThrowException(v8::Exception::Error(
+            v8::String::NewFromUtf8Literal(isolate, "AbortSignal.timeout needs a timer host (dom_abortsignal_set_timerhost)")));
+        return;
+    }
+    v8::Local<v8::Object> wrapper = AdoptSignal(isolate, context, signal);
+    wrapper->SetPrivate(context, TimeoutKey(isolate), v8::True(isolate)).Check();
+    args.GetReturnValue().Set(wrapper);
+}
+
 } // namespace v8_dom
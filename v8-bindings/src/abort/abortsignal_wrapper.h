@@ -9,6 +9,9 @@
 #define V8_DOM_ABORTSIGNAL_WRAPPER_H
 
 #include <v8.h>
+#include "../core/wrapper_traits.h"
+#include "../core/external_references.h"
+#include "../core/property_table.h"
 #include "dom.h"
 
 namespace v8_dom {
@@ -41,11 +44,46 @@ public:
     /**
      * Template cache index.
      */
-    static constexpr int kTemplateIndex = 28;
+    static constexpr int kTemplateIndex = WrapperTraits<AbortSignalWrapper>::kTemplateIndex;
+    
+    /**
+     * Type tag stored in the wrapper's type internal field.
+     */
+    static const WrapperTypeInfo kTypeInfo;
+    
+    /**
+     * Register this wrapper's callbacks for snapshot serialization.
+     */
+    static void RegisterExternalReferences(ExternalReferenceRegistry* registry);
+    
+    /**
+     * Keep a script abort reason on a signal's wrapper, for reason and
+     * throwIfAborted(). The C side only carries opaque reasons, so a signal
+     * aborted without one here (its sources' reasons included) reports an
+     * "AbortError" DOMException, or "TimeoutError" if it came from
+     * AbortSignal.timeout().
+     */
+    static void SetReason(v8::Isolate* isolate,
+                          v8::Local<v8::Object> wrapper,
+                          v8::Local<v8::Value> reason);
     
 private:
-    // Property getters/setters and methods will be added here
-    // TODO: Parse dom.h to auto-generate these declarations
+    // Prototype members, installed by InstallTemplate()
+    static const PropertyDescriptor kProperties[];
+    
+    // Readonly properties
+    static void AbortedGetter(v8::Local<v8::Name> property,
+                              const v8::PropertyCallbackInfo<v8::Value>& info);
+    static void ReasonGetter(v8::Local<v8::Name> property,
+                             const v8::PropertyCallbackInfo<v8::Value>& info);
+    
+    // Methods
+    static void ThrowIfAborted(const v8::FunctionCallbackInfo<v8::Value>& args);
+    
+    // Static methods
+    static void Abort(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void Any(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void Timeout(const v8::FunctionCallbackInfo<v8::Value>& args);
 };
 
 } // namespace v8_dom
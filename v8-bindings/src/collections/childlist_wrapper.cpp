@@ -0,0 +1,273 @@
+#include "childlist_wrapper.h"
+#include "../wrapper_cache.h"
+#include "../core/template_cache.h"
+#include "../core/utilities.h"
+#include "../nodes/node_wrapper.h"
+#include "nodelist_wrapper.h"
+#include "htmlcollection_wrapper.h"
+
+namespace v8_dom {
+
+const WrapperTypeInfo ChildListWrapper::kTypeInfo = {"ChildList", nullptr};
+
+namespace {
+
+// First copy reserves this many entries, so small lists fill in one call
+constexpr size_t kInitialCapacity = 16;
+
+v8::Local<v8::Private> ListKey(v8::Isolate* isolate, bool elements_only) {
+    return elements_only
+        ? v8::Private::ForApi(isolate, v8::String::NewFromUtf8Literal(isolate, "v8_dom::children"))
+        : v8::Private::ForApi(isolate, v8::String::NewFromUtf8Literal(isolate, "v8_dom::childNodes"));
+}
+
+v8::Local<v8::Private> OwnerKey(v8::Isolate* isolate) {
+    return v8::Private::ForApi(isolate, v8::String::NewFromUtf8Literal(isolate, "v8_dom::ownerNode"));
+}
+
+} // namespace
+
+void ChildList::Refresh() {
+    uint32_t current = dom_node_get_child_generation(parent);
+    if (filled && current == generation) {
+        return;
+    }
+
+    auto fill = elements_only ? dom_node_get_element_children_array
+                              : dom_node_get_children_array;
+    if (items.capacity() < kInitialCapacity) {
+        items.reserve(kInitialCapacity);
+    }
+    items.resize(items.capacity());
+
+    uint32_t count = fill(parent, items.data(), static_cast<uint32_t>(items.size()));
+    if (count > items.size()) {
+        items.resize(count);
+        count = fill(parent, items.data(), count);
+    }
+    items.resize(count);
+
+    generation = current;
+    filled = true;
+}
+
+v8::Local<v8::Object> ChildListWrapper::ChildNodes(v8::Isolate* isolate,
+                                                   v8::Local<v8::Context> context,
+                                                   v8::Local<v8::Object> node_wrapper,
+                                                   DOMNode* node) {
+    return GetOrCreate(isolate, context, node_wrapper, node, false);
+}
+
+v8::Local<v8::Object> ChildListWrapper::Children(v8::Isolate* isolate,
+                                                 v8::Local<v8::Context> context,
+                                                 v8::Local<v8::Object> node_wrapper,
+                                                 DOMNode* node) {
+    return GetOrCreate(isolate, context, node_wrapper, node, true);
+}
+
+v8::Local<v8::Object> ChildListWrapper::GetOrCreate(v8::Isolate* isolate,
+                                                    v8::Local<v8::Context> context,
+                                                    v8::Local<v8::Object> node_wrapper,
+                                                    DOMNode* node,
+                                                    bool elements_only) {
+    v8::EscapableHandleScope handle_scope(isolate);
+    v8::Local<v8::Private> key = ListKey(isolate, elements_only);
+
+    // [SameObject]: reuse the list stored on the node wrapper
+    v8::Local<v8::Value> existing;
+    if (node_wrapper->GetPrivate(context, key).ToLocal(&existing) && existing->IsObject()) {
+        return handle_scope.Escape(existing.As<v8::Object>());
+    }
+
+    int index = elements_only ? kChildrenTemplateIndex : kChildNodesTemplateIndex;
+    auto get_template = elements_only ? GetChildrenTemplate : GetChildNodesTemplate;
+    v8::Local<v8::Function> constructor =
+        TemplateCache::ForIsolate(isolate)->GetConstructor(context, index, get_template);
+    v8::Local<v8::Object> wrapper = constructor->NewInstance(context).ToLocalChecked();
+
+    ChildList* list = new ChildList{node, elements_only, false, 0, {}};
+    dom_node_addref(node);
+    SetWrapperFields(wrapper, list, &kTypeInfo);
+
+    // The list and its node wrapper keep each other alive
+    node_wrapper->SetPrivate(context, key, wrapper).Check();
+    wrapper->SetPrivate(context, OwnerKey(isolate), node_wrapper).Check();
+
+    WrapperCache::ForIsolate(isolate)->Set(isolate, list, wrapper, [](void* ptr) {
+        ChildList* list = static_cast<ChildList*>(ptr);
+        dom_node_release(list->parent);
+        delete list;
+    });
+
+    return handle_scope.Escape(wrapper);
+}
+
+ChildList* ChildListWrapper::Unwrap(v8::Local<v8::Object> obj) {
+    return static_cast<ChildList*>(UnwrapObject(obj, &kTypeInfo));
+}
+
+// Shadows the base length/item, which expect the base C types
+const PropertyDescriptor ChildListWrapper::kProperties[] = {
+    DataProperty("length", LengthGetter),
+    MethodProperty("item", Item),
+};
+
+v8::Local<v8::FunctionTemplate> ChildListWrapper::CreateTemplate(v8::Isolate* isolate,
+                                                                 const char* class_name,
+                                                                 v8::Local<v8::FunctionTemplate> parent) {
+    v8::Local<v8::FunctionTemplate> tmpl = v8::FunctionTemplate::New(isolate);
+    tmpl->SetClassName(v8::String::NewFromUtf8(isolate, class_name).ToLocalChecked());
+    tmpl->Inherit(parent);
+
+    v8::Local<v8::ObjectTemplate> instance = tmpl->InstanceTemplate();
+    instance->SetInternalFieldCount(kWrapperFieldCount);
+
+    // Enable indexed property access (list[0], list[1], etc.)
+    v8::IndexedPropertyHandlerConfiguration handler_config(
+        IndexedPropertyGetter,  // getter
+        nullptr,                // setter
+        nullptr,                // query
+        nullptr,                // deleter
+        nullptr                 // enumerator
+    );
+    instance->SetHandler(handler_config);
+
+    InstallProperties(isolate, tmpl, kProperties);
+
+    // Iteration (Symbol.iterator, forEach) is inherited from the base
+    // prototype and reads the refreshed items (see ListIteratorWrapper)
+    return tmpl;
+}
+
+v8::Local<v8::FunctionTemplate> ChildListWrapper::GetChildNodesTemplate(v8::Isolate* isolate) {
+    TemplateCache* cache = TemplateCache::ForIsolate(isolate);
+
+    if (!cache->Has(kChildNodesTemplateIndex)) {
+        cache->Set(kChildNodesTemplateIndex,
+                   CreateTemplate(isolate, "NodeList", NodeListWrapper::GetTemplate(isolate)));
+    }
+
+    return cache->Get(kChildNodesTemplateIndex);
+}
+
+v8::Local<v8::FunctionTemplate> ChildListWrapper::GetChildrenTemplate(v8::Isolate* isolate) {
+    TemplateCache* cache = TemplateCache::ForIsolate(isolate);
+
+    if (!cache->Has(kChildrenTemplateIndex)) {
+        cache->Set(kChildrenTemplateIndex,
+                   CreateTemplate(isolate, "HTMLCollection", HTMLCollectionWrapper::GetTemplate(isolate)));
+    }
+
+    return cache->Get(kChildrenTemplateIndex);
+}
+
+void ChildListWrapper::RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+    registry->Register(ChildNodesGetter);
+    registry->Register(ChildrenGetter);
+    registry->Register(IndexedPropertyGetter);
+    RegisterProperties(registry, kProperties);
+}
+
+// ===== Node / ParentNode Accessors =====
+
+void ChildListWrapper::ChildNodesGetter(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ChildListWrapper::ChildNodesGetter");
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    v8::Local<v8::Object> self = args.This();
+    DOMNode* node = UnwrapReceiver<DOMNode>(args);
+    if (!node) {
+        return;
+    }
+
+    args.GetReturnValue().Set(ChildNodes(isolate, context, self, node));
+}
+
+void ChildListWrapper::ChildrenGetter(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ChildListWrapper::ChildrenGetter");
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    v8::Local<v8::Object> self = args.This();
+    DOMNode* node = UnwrapReceiver<DOMNode>(args);
+    if (!node) {
+        return;
+    }
+
+    args.GetReturnValue().Set(Children(isolate, context, self, node));
+}
+
+// ===== Property Getters =====
+
+void ChildListWrapper::LengthGetter(v8::Local<v8::Name> property,
+                                    const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("ChildListWrapper::LengthGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    ChildList* list = Unwrap(info.This().As<v8::Object>());
+
+    if (!list) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Invalid NodeList object")));
+        return;
+    }
+
+    list->Refresh();
+    info.GetReturnValue().Set(
+        v8::Integer::NewFromUnsigned(isolate, static_cast<uint32_t>(list->items.size())));
+}
+
+// ===== Methods =====
+
+void ChildListWrapper::Item(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ChildListWrapper::Item");
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+
+    ChildList* list = UnwrapReceiver<ChildList>(args);
+    if (!list) {
+        return;
+    }
+
+    if (args.Length() < 1) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Index required")));
+        return;
+    }
+
+    v8::Maybe<uint32_t> maybeIndex = args[0]->Uint32Value(context);
+    if (maybeIndex.IsNothing()) {
+        args.GetReturnValue().SetNull();
+        return;
+    }
+    uint32_t index = maybeIndex.ToChecked();
+
+    list->Refresh();
+    if (index >= list->items.size()) {
+        args.GetReturnValue().SetNull();
+        return;
+    }
+
+    args.GetReturnValue().Set(NodeWrapper::Wrap(isolate, context, list->items[index]));
+}
+
+// ===== Indexed Property Handler =====
+
+v8::Intercepted ChildListWrapper::IndexedPropertyGetter(uint32_t index,
+                                                        const v8::PropertyCallbackInfo<v8::Value>& info) {
+    v8::Isolate* isolate = info.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+
+    ChildList* list = Unwrap(info.This().As<v8::Object>());
+    if (!list) {
+        return v8::Intercepted::kNo;  // Property does not exist
+    }
+
+    list->Refresh();
+    if (index >= list->items.size()) {
+        return v8::Intercepted::kNo;  // Index out of bounds
+    }
+
+    info.GetReturnValue().Set(NodeWrapper::Wrap(isolate, context, list->items[index]));
+    return v8::Intercepted::kYes;
+}
+
+} // namespace v8_dom
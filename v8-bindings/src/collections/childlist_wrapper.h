@@ -0,0 +1,123 @@
+/**
+ * ChildList Wrapper - Live childNodes / children collections
+ *
+ * Node.childNodes and ParentNode.children are served from a copy of the
+ * parent's child pointers, filled in one C-ABI call and refilled only when
+ * the parent's child generation changes. Indexed access and length are then
+ * plain vector reads instead of a sibling walk per index.
+ *
+ * The wrappers derive from NodeList / HTMLCollection (instanceof works) and
+ * are [SameObject]: each is stored on its parent's wrapper under a private
+ * key, and keeps the parent node alive.
+ */
+
+#ifndef V8_DOM_CHILDLIST_WRAPPER_H
+#define V8_DOM_CHILDLIST_WRAPPER_H
+
+#include <v8.h>
+#include <cstdint>
+#include <vector>
+#include "../core/wrapper_type_info.h"
+#include "../core/external_references.h"
+#include "../core/property_table.h"
+#include "dom.h"
+
+namespace v8_dom {
+
+/**
+ * Binding-side state of one child list.
+ */
+struct ChildList {
+    DOMNode* parent;         // addref'd
+    bool elements_only;      // children (true) or childNodes (false)
+    bool filled;
+    uint32_t generation;     // parent generation the items were copied at
+    std::vector<DOMNode*> items;
+
+    /**
+     * Refill items if the parent's child list changed since the last copy.
+     */
+    void Refresh();
+};
+
+class ChildListWrapper {
+public:
+    /**
+     * Get (or create) the childNodes NodeList of a node wrapper.
+     */
+    static v8::Local<v8::Object> ChildNodes(v8::Isolate* isolate,
+                                            v8::Local<v8::Context> context,
+                                            v8::Local<v8::Object> node_wrapper,
+                                            DOMNode* node);
+
+    /**
+     * Get (or create) the children HTMLCollection of a node wrapper.
+     */
+    static v8::Local<v8::Object> Children(v8::Isolate* isolate,
+                                          v8::Local<v8::Context> context,
+                                          v8::Local<v8::Object> node_wrapper,
+                                          DOMNode* node);
+
+    /**
+     * Unwrap a childNodes / children wrapper.
+     */
+    static ChildList* Unwrap(v8::Local<v8::Object> obj);
+
+    /**
+     * Accessor callbacks for installing the attributes on Node / ParentNode
+     * prototypes.
+     */
+    static void ChildNodesGetter(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void ChildrenGetter(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+    /**
+     * Get the cached templates.
+     */
+    static v8::Local<v8::FunctionTemplate> GetChildNodesTemplate(v8::Isolate* isolate);
+    static v8::Local<v8::FunctionTemplate> GetChildrenTemplate(v8::Isolate* isolate);
+
+    /**
+     * Template cache indices.
+     */
+    static constexpr int kChildNodesTemplateIndex = 29;
+    static constexpr int kChildrenTemplateIndex = 30;
+
+    /**
+     * Type tag stored in the wrapper's type internal field.
+     */
+    static const WrapperTypeInfo kTypeInfo;
+
+    /**
+     * Register this wrapper's callbacks for snapshot serialization.
+     */
+    static void RegisterExternalReferences(ExternalReferenceRegistry* registry);
+
+private:
+    // Prototype members, installed by InstallTemplate()
+    static const PropertyDescriptor kProperties[];
+    
+    static v8::Local<v8::Object> GetOrCreate(v8::Isolate* isolate,
+                                             v8::Local<v8::Context> context,
+                                             v8::Local<v8::Object> node_wrapper,
+                                             DOMNode* node,
+                                             bool elements_only);
+
+    static v8::Local<v8::FunctionTemplate> CreateTemplate(v8::Isolate* isolate,
+                                                          const char* class_name,
+                                                          v8::Local<v8::FunctionTemplate> parent);
+
+    // Readonly properties
+    static void LengthGetter(v8::Local<v8::Name> property,
+                             const v8::PropertyCallbackInfo<v8::Value>& info);
+
+    // Methods
+    static void Item(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+    // Indexed property handler
+    static v8::Intercepted IndexedPropertyGetter(uint32_t index,
+                                                 const v8::PropertyCallbackInfo<v8::Value>& info);
+};
+
+} // namespace v8_dom
+
+#endif // V8_DOM_CHILDLIST_WRAPPER_H
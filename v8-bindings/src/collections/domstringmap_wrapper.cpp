@@ -0,0 +1,254 @@
+#include "domstringmap_wrapper.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../wrapper_cache.h"
+#include "../core/template_cache.h"
+#include "../core/binding_state.h"
+#include "../core/dataset_names.h"
+#include "../core/utilities.h"
+
+namespace v8_dom {
+
+const WrapperTypeInfo DOMStringMapWrapper::kTypeInfo = {"DOMStringMap", nullptr};
+
+namespace {
+
+v8::Local<v8::Private> MapKey(v8::Isolate* isolate) {
+    return v8::Private::ForApi(isolate, v8::String::NewFromUtf8Literal(isolate, "v8_dom::dataset"));
+}
+
+v8::Local<v8::Private> OwnerKey(v8::Isolate* isolate) {
+    return v8::Private::ForApi(isolate, v8::String::NewFromUtf8Literal(isolate, "v8_dom::ownerElement"));
+}
+
+/**
+ * The data-* attribute a dataset property names.
+ */
+struct DataAttribute {
+    DOMElement* element;
+    std::string_view name;  // empty if the property names no attribute
+    DOMAtom atom;           // interned name, on elements of the isolate's document
+
+    bool Get(DOMStringView* out) const {
+        return atom ? dom_element_getattribute_atom_view(element, atom, out)
+                    : dom_element_getattribute_view_n(element, name.data(), name.size(), out);
+    }
+
+    bool Has() const {
+        return atom ? dom_element_hasattribute_atom(element, atom) != 0
+                    : dom_element_hasattribute_n(element, name.data(), name.size()) != 0;
+    }
+};
+
+/**
+ * Resolve a string property of a dataset; false for symbols and
+ * receivers that are not datasets.
+ */
+template <typename T>
+bool Resolve(v8::Local<v8::Name> property, const v8::PropertyCallbackInfo<T>& info, DataAttribute* out) {
+    if (!property->IsString()) {
+        return false;
+    }
+    StringMap* map = DOMStringMapWrapper::Unwrap(info.This());
+    if (!map) {
+        return false;
+    }
+
+    v8::Isolate* isolate = info.GetIsolate();
+    BindingState* state = BindingState::ForIsolate(isolate);
+    DOMDocument* document = state->Document();
+    const DatasetNames::Entry* entry =
+        state->DataNames()->Get(isolate, property.As<v8::String>(), document);
+
+    out->element = map->element;
+    out->name = entry->attribute;
+    out->atom = dom_node_get_ownerdocument(reinterpret_cast<DOMNode*>(map->element)) == document
+        ? entry->atom
+        : nullptr;
+    return true;
+}
+
+void CollectName(const DOMStringView* name, void* user_data) {
+    std::string property;
+    if (DatasetNames::ToProperty(std::string_view(name->data, name->length), &property)) {
+        static_cast<std::vector<std::string>*>(user_data)->push_back(std::move(property));
+    }
+}
+
+} // namespace
+
+v8::Local<v8::Object> DOMStringMapWrapper::Dataset(v8::Isolate* isolate,
+                                                   v8::Local<v8::Context> context,
+                                                   v8::Local<v8::Object> element_wrapper,
+                                                   DOMElement* element) {
+    v8::EscapableHandleScope handle_scope(isolate);
+    v8::Local<v8::Private> key = MapKey(isolate);
+
+    // [SameObject]: reuse the map stored on the element wrapper
+    v8::Local<v8::Value> existing;
+    if (element_wrapper->GetPrivate(context, key).ToLocal(&existing) && existing->IsObject()) {
+        return handle_scope.Escape(existing.As<v8::Object>());
+    }
+
+    v8::Local<v8::Function> constructor =
+        TemplateCache::ForIsolate(isolate)->GetConstructor(context, kTemplateIndex, GetTemplate);
+    v8::Local<v8::Object> wrapper = constructor->NewInstance(context).ToLocalChecked();
+
+    StringMap* map = new StringMap{element};
+    dom_element_addref(element);
+    SetWrapperFields(wrapper, map, &kTypeInfo);
+
+    // The map and its element wrapper keep each other alive
+    element_wrapper->SetPrivate(context, key, wrapper).Check();
+    wrapper->SetPrivate(context, OwnerKey(isolate), element_wrapper).Check();
+
+    WrapperCache::ForIsolate(isolate)->Set(isolate, map, wrapper, [](void* ptr) {
+        StringMap* map = static_cast<StringMap*>(ptr);
+        dom_element_release(map->element);
+        delete map;
+    });
+
+    return handle_scope.Escape(wrapper);
+}
+
+StringMap* DOMStringMapWrapper::Unwrap(v8::Local<v8::Object> obj) {
+    return static_cast<StringMap*>(UnwrapObject(obj, &kTypeInfo));
+}
+
+void DOMStringMapWrapper::InstallTemplate(v8::Isolate* isolate) {
+    v8::Local<v8::FunctionTemplate> tmpl = v8::FunctionTemplate::New(isolate);
+    tmpl->SetClassName(v8::String::NewFromUtf8Literal(isolate, "DOMStringMap"));
+
+    v8::Local<v8::ObjectTemplate> instance = tmpl->InstanceTemplate();
+    instance->SetInternalFieldCount(kWrapperFieldCount);
+
+    // [LegacyOverrideBuiltIns]: named properties shadow the prototype's
+    v8::NamedPropertyHandlerConfiguration handler_config(
+        NamedPropertyGetter,
+        NamedPropertySetter,
+        NamedPropertyQuery,
+        NamedPropertyDeleter,
+        NamedPropertyEnumerator,
+        v8::Local<v8::Value>(),
+        v8::PropertyHandlerFlags::kOnlyInterceptStrings);
+    instance->SetHandler(handler_config);
+
+    // Cache the template
+    TemplateCache* cache = TemplateCache::ForIsolate(isolate);
+    cache->Set(kTemplateIndex, tmpl);
+}
+
+v8::Local<v8::FunctionTemplate> DOMStringMapWrapper::GetTemplate(v8::Isolate* isolate) {
+    TemplateCache* cache = TemplateCache::ForIsolate(isolate);
+
+    if (!cache->Has(kTemplateIndex)) {
+        InstallTemplate(isolate);
+    }
+
+    return cache->Get(kTemplateIndex);
+}
+
+void DOMStringMapWrapper::RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+    registry->Register(NamedPropertyGetter);
+    registry->Register(NamedPropertySetter);
+    registry->Register(NamedPropertyQuery);
+    registry->Register(NamedPropertyDeleter);
+    registry->Register(NamedPropertyEnumerator);
+}
+
+// ============================================================================
+// Named Property Handler
+// ============================================================================
+
+v8::Intercepted DOMStringMapWrapper::NamedPropertyGetter(v8::Local<v8::Name> property,
+                                                         const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("DOMStringMapWrapper::NamedPropertyGetter");
+    DataAttribute attribute;
+    DOMStringView view;
+    if (!Resolve(property, info, &attribute) || attribute.name.empty() || !attribute.Get(&view)) {
+        return v8::Intercepted::kNo;
+    }
+    info.GetReturnValue().Set(
+        StringViewToV8String(info.GetIsolate(), view, reinterpret_cast<DOMNode*>(attribute.element)));
+    return v8::Intercepted::kYes;
+}
+
+v8::Intercepted DOMStringMapWrapper::NamedPropertySetter(v8::Local<v8::Name> property,
+                                                         v8::Local<v8::Value> value,
+                                                         const v8::PropertyCallbackInfo<void>& info) {
+    V8_DOM_TRACE_SCOPE("DOMStringMapWrapper::NamedPropertySetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    DataAttribute attribute;
+    if (!Resolve(property, info, &attribute)) {
+        return v8::Intercepted::kNo;
+    }
+    if (attribute.name.empty()) {
+        ThrowDOMException(isolate, DOM_ERROR_SYNTAX);  // '-' before a lowercase letter
+        return v8::Intercepted::kYes;
+    }
+
+    v8::Local<v8::String> string;
+    if (!value->ToString(isolate->GetCurrentContext()).ToLocal(&string)) {
+        return v8::Intercepted::kYes;
+    }
+    v8::String::Utf8Value utf8(isolate, string);
+    int32_t err = attribute.atom
+        ? dom_element_setattribute_atom(attribute.element, attribute.atom, *utf8, utf8.length())
+        : dom_element_setattribute_n(attribute.element, attribute.name.data(), attribute.name.size(),
+                                     *utf8, utf8.length());
+    if (err != 0) {
+        ThrowDOMException(isolate, err);
+    }
+    return v8::Intercepted::kYes;
+}
+
+v8::Intercepted DOMStringMapWrapper::NamedPropertyQuery(v8::Local<v8::Name> property,
+                                                        const v8::PropertyCallbackInfo<v8::Integer>& info) {
+    DataAttribute attribute;
+    if (!Resolve(property, info, &attribute) || attribute.name.empty() || !attribute.Has()) {
+        return v8::Intercepted::kNo;
+    }
+    info.GetReturnValue().Set(static_cast<int32_t>(v8::None));
+    return v8::Intercepted::kYes;
+}
+
+v8::Intercepted DOMStringMapWrapper::NamedPropertyDeleter(v8::Local<v8::Name> property,
+                                                          const v8::PropertyCallbackInfo<v8::Boolean>& info) {
+    V8_DOM_TRACE_SCOPE("DOMStringMapWrapper::NamedPropertyDeleter");
+    DataAttribute attribute;
+    if (!Resolve(property, info, &attribute) || attribute.name.empty() || !attribute.Has()) {
+        return v8::Intercepted::kNo;  // Not a supported name: ordinary delete
+    }
+    int32_t err = dom_element_removeattribute_n(attribute.element, attribute.name.data(), attribute.name.size());
+    if (err != 0) {
+        ThrowDOMException(info.GetIsolate(), err);
+        return v8::Intercepted::kYes;
+    }
+    info.GetReturnValue().Set(true);
+    return v8::Intercepted::kYes;
+}
+
+void DOMStringMapWrapper::NamedPropertyEnumerator(const v8::PropertyCallbackInfo<v8::Array>& info) {
+    v8::Isolate* isolate = info.GetIsolate();
+    StringMap* map = Unwrap(info.This());
+    if (!map) {
+        return;
+    }
+
+    // Supported names in attribute order
+    std::vector<std::string> names;
+    dom_element_foreach_attributename(map->element, CollectName, &names);
+
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    v8::Local<v8::Array> result = v8::Array::New(isolate, static_cast<int>(names.size()));
+    for (size_t i = 0; i < names.size(); i++) {
+        v8::Local<v8::String> name = v8::String::NewFromUtf8(
+            isolate, names[i].data(), v8::NewStringType::kInternalized, static_cast<int>(names[i].size()))
+            .ToLocalChecked();
+        result->Set(context, static_cast<uint32_t>(i), name).Check();
+    }
+    info.GetReturnValue().Set(result);
+}
+
+} // namespace v8_dom
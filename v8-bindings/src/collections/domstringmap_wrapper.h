@@ -0,0 +1,90 @@
+/**
+ * DOMStringMap Wrapper - V8 bindings for element.dataset
+ *
+ * dataset (HTMLOrSVGElement in HTML; installed on Element here, which
+ * HTML libraries build on) exposes the data-* attributes of an element as
+ * camelCase named properties, through a named property interceptor:
+ * dataset.fooBar reads, writes and deletes data-foo-bar. Property names
+ * are converted once per isolate (see DatasetNames), and on elements of
+ * the isolate's document the attribute is reached by its interned name,
+ * so a read is one pointer-compared attribute lookup and no string is
+ * built.
+ *
+ * dataset is [SameObject]: the map is stored on its element's wrapper
+ * under a private key and keeps the element alive.
+ */
+
+#ifndef V8_DOM_DOMSTRINGMAP_WRAPPER_H
+#define V8_DOM_DOMSTRINGMAP_WRAPPER_H
+
+#include <v8.h>
+#include "../core/wrapper_traits.h"
+#include "../core/external_references.h"
+#include "dom.h"
+
+namespace v8_dom {
+
+/**
+ * Binding-side state of one dataset.
+ */
+struct StringMap {
+    DOMElement* element;  // addref'd
+};
+
+class DOMStringMapWrapper {
+public:
+    /**
+     * Get (or create) the dataset of an element wrapper.
+     */
+    static v8::Local<v8::Object> Dataset(v8::Isolate* isolate,
+                                         v8::Local<v8::Context> context,
+                                         v8::Local<v8::Object> element_wrapper,
+                                         DOMElement* element);
+
+    /**
+     * Unwrap a V8 object to get the map state.
+     */
+    static StringMap* Unwrap(v8::Local<v8::Object> obj);
+
+    /**
+     * Install the DOMStringMap template (called once per isolate).
+     */
+    static void InstallTemplate(v8::Isolate* isolate);
+
+    /**
+     * Get the cached DOMStringMap template.
+     */
+    static v8::Local<v8::FunctionTemplate> GetTemplate(v8::Isolate* isolate);
+
+    /**
+     * Template cache index.
+     */
+    static constexpr int kTemplateIndex = WrapperTraits<DOMStringMapWrapper>::kTemplateIndex;
+
+    /**
+     * Type tag stored in the wrapper's type internal field.
+     */
+    static const WrapperTypeInfo kTypeInfo;
+
+    /**
+     * Register this wrapper's callbacks for snapshot serialization.
+     */
+    static void RegisterExternalReferences(ExternalReferenceRegistry* registry);
+
+private:
+    // Named property handler
+    static v8::Intercepted NamedPropertyGetter(v8::Local<v8::Name> property,
+                                               const v8::PropertyCallbackInfo<v8::Value>& info);
+    static v8::Intercepted NamedPropertySetter(v8::Local<v8::Name> property,
+                                               v8::Local<v8::Value> value,
+                                               const v8::PropertyCallbackInfo<void>& info);
+    static v8::Intercepted NamedPropertyQuery(v8::Local<v8::Name> property,
+                                              const v8::PropertyCallbackInfo<v8::Integer>& info);
+    static v8::Intercepted NamedPropertyDeleter(v8::Local<v8::Name> property,
+                                                const v8::PropertyCallbackInfo<v8::Boolean>& info);
+    static void NamedPropertyEnumerator(const v8::PropertyCallbackInfo<v8::Array>& info);
+};
+
+} // namespace v8_dom
+
+#endif // V8_DOM_DOMSTRINGMAP_WRAPPER_H
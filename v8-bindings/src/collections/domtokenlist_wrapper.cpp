@@ -2,71 +2,237 @@
 #include "../wrapper_cache.h"
 #include "../core/template_cache.h"
 #include "../core/utilities.h"
+#include <algorithm>
 
 namespace v8_dom {
 
-v8::Local<v8::Object> DOMTokenListWrapper::Wrap(v8::Isolate* isolate,
-                                              v8::Local<v8::Context> context,
-                                              DOMDOMTokenList* obj) {
-    if (!obj) {
-        return v8::Local<v8::Object>();
+const WrapperTypeInfo DOMTokenListWrapper::kTypeInfo = {"DOMTokenList", nullptr};
+
+namespace {
+
+// Token separators, as in the Zig DOMTokenList (ASCII whitespace)
+constexpr std::string_view kWhitespace = " \t\r\n\f";
+
+// add() / remove() arguments converted without a heap allocation
+constexpr size_t kInlineTokens = 8;
+
+v8::Local<v8::Private> ListKey(v8::Isolate* isolate) {
+    return v8::Private::ForApi(isolate, v8::String::NewFromUtf8Literal(isolate, "v8_dom::classList"));
+}
+
+v8::Local<v8::Private> OwnerKey(v8::Isolate* isolate) {
+    return v8::Private::ForApi(isolate, v8::String::NewFromUtf8Literal(isolate, "v8_dom::ownerElement"));
+}
+
+v8::Local<v8::String> TokenToV8String(v8::Isolate* isolate, std::string_view token) {
+    return v8::String::NewFromUtf8(isolate, token.data(), v8::NewStringType::kNormal,
+                                   static_cast<int>(token.size())).ToLocalChecked();
+}
+
+/**
+ * DOMTokenList token validation (empty → SyntaxError, whitespace →
+ * InvalidCharacterError). Returns 0 if the token is valid.
+ */
+int32_t ValidateToken(std::string_view token) {
+    if (token.empty()) {
+        return DOM_ERROR_SYNTAX;
+    }
+    if (token.find_first_of(kWhitespace) != std::string_view::npos) {
+        return DOM_ERROR_INVALID_CHARACTER;
+    }
+    return 0;
+}
+
+TokenList* ThisList(v8::Isolate* isolate, v8::Local<v8::Object> receiver) {
+    TokenList* list = DOMTokenListWrapper::Unwrap(receiver);
+    if (!list) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Invalid DOMTokenList")));
+    }
+    return list;
+}
+
+/**
+ * Runs a batched add/remove entry point over all call arguments.
+ */
+void ForwardTokens(const v8::FunctionCallbackInfo<v8::Value>& args,
+                   int32_t (*apply)(DOMDOMTokenList*, const char**, uint32_t)) {
+    v8::Isolate* isolate = args.GetIsolate();
+    TokenList* list = ThisList(isolate, args.This());
+    if (!list) {
+        return;
+    }
+
+    uint32_t count = static_cast<uint32_t>(args.Length());
+    std::vector<std::string> strings;
+    strings.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+        v8::String::Utf8Value utf8(isolate, args[i]);
+        if (!*utf8) {
+            return;  // ToString threw
+        }
+        strings.emplace_back(*utf8, utf8.length());
+    }
+
+    const char* inline_tokens[kInlineTokens];
+    std::vector<const char*> heap_tokens;
+    const char** tokens = inline_tokens;
+    if (count > kInlineTokens) {
+        heap_tokens.resize(count);
+        tokens = heap_tokens.data();
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        tokens[i] = strings[i].c_str();
+    }
+
+    // One crossing for the whole call
+    int32_t err = apply(list->list, tokens, count);
+    if (err != 0) {
+        ThrowDOMException(isolate, err);
+    }
+}
+
+} // namespace
+
+void TokenList::Refresh() {
+    DOMStringView view{};
+    bool present = dom_element_getattribute_view(element, "class", &view);
+    std::string_view current = present ? std::string_view(view.data, view.length)
+                                       : std::string_view();
+
+    if (filled) {
+        // Interned values are immutable, so the same pointer means the same value
+        if (present && view.is_interned && value_interned && view.data == value_data &&
+            view.length == value.size()) {
+            return;
+        }
+        if (current == value) {
+            value_data = present ? view.data : nullptr;
+            value_interned = present && view.is_interned;
+            return;
+        }
     }
-    
-    // Check wrapper cache first
-    WrapperCache* cache = WrapperCache::ForIsolate(isolate);
-    if (cache->Has(obj)) {
-        return cache->Get(isolate, obj);
+
+    value.assign(current);
+    value_data = present ? view.data : nullptr;
+    value_interned = present && view.is_interned;
+    filled = true;
+
+    // Ordered set: keep the first occurrence of each token
+    tokens.clear();
+    std::string_view rest(value);
+    while (true) {
+        size_t start = rest.find_first_not_of(kWhitespace);
+        if (start == std::string_view::npos) {
+            break;
+        }
+        rest.remove_prefix(start);
+        size_t end = std::min(rest.find_first_of(kWhitespace), rest.size());
+        std::string_view token = rest.substr(0, end);
+        if (std::find(tokens.begin(), tokens.end(), token) == tokens.end()) {
+            tokens.push_back(token);
+        }
+        rest.remove_prefix(end);
     }
-    
-    // Create new wrapper
+}
+
+bool TokenList::Contains(std::string_view token) const {
+    return std::find(tokens.begin(), tokens.end(), token) != tokens.end();
+}
+
+v8::Local<v8::Object> DOMTokenListWrapper::ClassList(v8::Isolate* isolate,
+                                                     v8::Local<v8::Context> context,
+                                                     v8::Local<v8::Object> element_wrapper,
+                                                     DOMElement* element) {
     v8::EscapableHandleScope handle_scope(isolate);
-    v8::Local<v8::FunctionTemplate> tmpl = GetTemplate(isolate);
-    v8::Local<v8::Function> constructor = tmpl->GetFunction(context).ToLocalChecked();
+    v8::Local<v8::Private> key = ListKey(isolate);
+
+    // [SameObject]: reuse the list stored on the element wrapper
+    v8::Local<v8::Value> existing;
+    if (element_wrapper->GetPrivate(context, key).ToLocal(&existing) && existing->IsObject()) {
+        return handle_scope.Escape(existing.As<v8::Object>());
+    }
+
+    DOMDOMTokenList* obj = dom_element_get_classlist(element);
+    if (!obj) {
+        return v8::Local<v8::Object>();
+    }
+
+    v8::Local<v8::Function> constructor =
+        TemplateCache::ForIsolate(isolate)->GetConstructor(context, kTemplateIndex, GetTemplate);
     v8::Local<v8::Object> wrapper = constructor->NewInstance(context).ToLocalChecked();
-    
-    // Store C pointer in internal field
-    wrapper->SetInternalField(0, v8::External::New(isolate, obj));
-    
-    // Increment C-side reference count
-    dom_domtokenlist_addref(obj);
-    
-    // Cache with release callback
-    cache->Set(isolate, obj, wrapper, [](void* ptr) {
-        dom_domtokenlist_release(static_cast<DOMDOMTokenList*>(ptr));
+
+    TokenList* list = new TokenList{obj, element, false, false, nullptr, {}, {}};
+    dom_element_addref(element);
+    SetWrapperFields(wrapper, list, &kTypeInfo);
+
+    // The list and its element wrapper keep each other alive
+    element_wrapper->SetPrivate(context, key, wrapper).Check();
+    wrapper->SetPrivate(context, OwnerKey(isolate), element_wrapper).Check();
+
+    WrapperCache::ForIsolate(isolate)->Set(isolate, list, wrapper, [](void* ptr) {
+        TokenList* list = static_cast<TokenList*>(ptr);
+        dom_domtokenlist_release(list->list);
+        dom_element_release(list->element);
+        delete list;
     });
-    
+
     return handle_scope.Escape(wrapper);
 }
 
-DOMDOMTokenList* DOMTokenListWrapper::Unwrap(v8::Local<v8::Object> obj) {
-    if (obj.IsEmpty() || obj->InternalFieldCount() < 1) {
-        return nullptr;
-    }
-    
-    v8::Local<v8::Value> ptr = obj->GetInternalField(0).As<v8::Value>();
-    if (!ptr->IsExternal()) {
-        return nullptr;
-    }
-    
-    return static_cast<DOMDOMTokenList*>(v8::Local<v8::External>::Cast(ptr)->Value());
+TokenList* DOMTokenListWrapper::Unwrap(v8::Local<v8::Object> obj) {
+    return static_cast<TokenList*>(UnwrapObject(obj, &kTypeInfo));
 }
 
+const PropertyDescriptor DOMTokenListWrapper::kProperties[] = {
+    // Properties
+    DataProperty("length", LengthGetter),
+    DataProperty("value", ValueGetter, ValueSetter),
+
+    // Methods
+    MethodProperty("item", Item),
+    MethodProperty("contains", Contains, kReceiverCheck | kNoSideEffect, 1, &kFastContains),
+    MethodProperty("add", Add),
+    MethodProperty("remove", Remove),
+    MethodProperty("toggle", Toggle),
+    MethodProperty("replace", Replace),
+    MethodProperty("supports", Supports),
+    MethodProperty("toString", ToString),
+};
+
 void DOMTokenListWrapper::InstallTemplate(v8::Isolate* isolate) {
     v8::Local<v8::FunctionTemplate> tmpl = v8::FunctionTemplate::New(isolate);
     tmpl->SetClassName(v8::String::NewFromUtf8Literal(isolate, "DOMTokenList"));
-    tmpl->InstanceTemplate()->SetInternalFieldCount(1);
-    
 
-    // Get prototype template for adding properties/methods
+    v8::Local<v8::ObjectTemplate> instance = tmpl->InstanceTemplate();
+    instance->SetInternalFieldCount(kWrapperFieldCount);
+
+    // Enable indexed property access (classList[0], classList[1], etc.)
+    v8::IndexedPropertyHandlerConfiguration handler_config(
+        IndexedPropertyGetter,  // getter
+        nullptr,                // setter
+        nullptr,                // query
+        nullptr,                // deleter
+        nullptr                 // enumerator
+    );
+    instance->SetHandler(handler_config);
+
+    InstallProperties(isolate, tmpl, kProperties);
+
     v8::Local<v8::ObjectTemplate> proto = tmpl->PrototypeTemplate();
-    
-    // TODO: Add properties and methods here
-    // Example:
-    // proto->SetNativeDataProperty(v8::String::NewFromUtf8Literal(isolate, "propertyName"),
-    //                   PropertyNameGetter, PropertyNameSetter);
-    // proto->Set(v8::String::NewFromUtf8Literal(isolate, "methodName"),
-    //           v8::FunctionTemplate::New(isolate, MethodName));
-    
+
+    // Iterable<DOMString>: the Array.prototype intrinsics read length and indices
+    proto->SetIntrinsicDataProperty(v8::Symbol::GetIterator(isolate),
+                                    v8::kArrayProto_values, v8::DontEnum);
+    proto->SetIntrinsicDataProperty(v8::String::NewFromUtf8Literal(isolate, "forEach"),
+                                    v8::kArrayProto_forEach, v8::DontEnum);
+    proto->SetIntrinsicDataProperty(v8::String::NewFromUtf8Literal(isolate, "keys"),
+                                    v8::kArrayProto_keys, v8::DontEnum);
+    proto->SetIntrinsicDataProperty(v8::String::NewFromUtf8Literal(isolate, "values"),
+                                    v8::kArrayProto_values, v8::DontEnum);
+    proto->SetIntrinsicDataProperty(v8::String::NewFromUtf8Literal(isolate, "entries"),
+                                    v8::kArrayProto_entries, v8::DontEnum);
+
     // Cache the template
     TemplateCache* cache = TemplateCache::ForIsolate(isolate);
     cache->Set(kTemplateIndex, tmpl);
@@ -74,12 +240,282 @@ void DOMTokenListWrapper::InstallTemplate(v8::Isolate* isolate) {
 
 v8::Local<v8::FunctionTemplate> DOMTokenListWrapper::GetTemplate(v8::Isolate* isolate) {
     TemplateCache* cache = TemplateCache::ForIsolate(isolate);
-    
+
     if (!cache->Has(kTemplateIndex)) {
         InstallTemplate(isolate);
     }
-    
+
     return cache->Get(kTemplateIndex);
 }
 
+void DOMTokenListWrapper::RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+    RegisterProperties(registry, kProperties);
+    registry->Register(IndexedPropertyGetter);
+}
+
+// ============================================================================
+// Property Implementations
+// ============================================================================
+
+void DOMTokenListWrapper::LengthGetter(v8::Local<v8::Name> property,
+                                       const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("DOMTokenListWrapper::LengthGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    TokenList* list = ThisList(isolate, info.This().As<v8::Object>());
+    if (!list) {
+        return;
+    }
+
+    list->Refresh();
+    info.GetReturnValue().Set(
+        v8::Integer::NewFromUnsigned(isolate, static_cast<uint32_t>(list->tokens.size())));
+}
+
+void DOMTokenListWrapper::ValueGetter(v8::Local<v8::Name> property,
+                                      const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("DOMTokenListWrapper::ValueGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    TokenList* list = ThisList(isolate, info.This().As<v8::Object>());
+    if (!list) {
+        return;
+    }
+
+    list->Refresh();
+    info.GetReturnValue().Set(TokenToV8String(isolate, list->value));
+}
+
+void DOMTokenListWrapper::ValueSetter(v8::Local<v8::Name> property,
+                                      v8::Local<v8::Value> value,
+                                      const v8::PropertyCallbackInfo<void>& info) {
+    V8_DOM_TRACE_SCOPE("DOMTokenListWrapper::ValueSetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    TokenList* list = ThisList(isolate, info.This().As<v8::Object>());
+    if (!list) {
+        return;
+    }
+
+    CStringFromV8 str(isolate, value);
+    if (!str.get()) {
+        return;  // ToString threw
+    }
+    int32_t err = dom_domtokenlist_set_value(list->list, str.get());
+    if (err != 0) {
+        ThrowDOMException(isolate, err);
+    }
+}
+
+// ============================================================================
+// Method Implementations
+// ============================================================================
+
+void DOMTokenListWrapper::Item(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("DOMTokenListWrapper::Item");
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    TokenList* list = UnwrapReceiver<TokenList>(args);
+    if (!list) {
+        return;
+    }
+
+    if (args.Length() < 1) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Index required")));
+        return;
+    }
+
+    v8::Maybe<uint32_t> maybeIndex = args[0]->Uint32Value(context);
+    if (maybeIndex.IsNothing()) {
+        args.GetReturnValue().SetNull();
+        return;
+    }
+    uint32_t index = maybeIndex.ToChecked();
+
+    list->Refresh();
+    if (index >= list->tokens.size()) {
+        args.GetReturnValue().SetNull();
+        return;
+    }
+    args.GetReturnValue().Set(TokenToV8String(isolate, list->tokens[index]));
+}
+
+void DOMTokenListWrapper::Contains(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("DOMTokenListWrapper::Contains");
+    v8::Isolate* isolate = args.GetIsolate();
+    TokenList* list = UnwrapReceiver<TokenList>(args);
+    if (!list) {
+        return;
+    }
+
+    if (args.Length() < 1) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "contains requires 1 argument")));
+        return;
+    }
+
+    StringArgFromV8 token(isolate, args[0]);
+    list->Refresh();
+    bool result = list->Contains(std::string_view(token.data(), token.length()));
+
+    args.GetReturnValue().Set(result);
+}
+
+void DOMTokenListWrapper::Add(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("DOMTokenListWrapper::Add");
+    ForwardTokens(args, dom_domtokenlist_add);
+}
+
+void DOMTokenListWrapper::Remove(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("DOMTokenListWrapper::Remove");
+    ForwardTokens(args, dom_domtokenlist_remove);
+}
+
+void DOMTokenListWrapper::Toggle(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("DOMTokenListWrapper::Toggle");
+    v8::Isolate* isolate = args.GetIsolate();
+    TokenList* list = UnwrapReceiver<TokenList>(args);
+    if (!list) {
+        return;
+    }
+
+    if (args.Length() < 1) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "toggle requires 1 argument")));
+        return;
+    }
+
+    StringArgFromV8 token(isolate, args[0]);
+    std::string_view token_view(token.data(), token.length());
+    int32_t err = ValidateToken(token_view);
+    if (err != 0) {
+        ThrowDOMException(isolate, err);
+        return;
+    }
+
+    // -1 = toggle, 0 = force remove, 1 = force add
+    int8_t force = -1;
+    if (args.Length() > 1 && !args[1]->IsUndefined()) {
+        force = args[1]->BooleanValue(isolate) ? 1 : 0;
+    }
+
+    // Answer no-op forced calls from the cached tokens
+    list->Refresh();
+    bool present = list->Contains(token_view);
+    if ((force == 1 && present) || (force == 0 && !present)) {
+        args.GetReturnValue().Set(present);
+        return;
+    }
+
+    uint8_t result = dom_domtokenlist_toggle(list->list, token.data(), force);
+    args.GetReturnValue().Set(result != 0);
+}
+
+void DOMTokenListWrapper::Replace(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("DOMTokenListWrapper::Replace");
+    v8::Isolate* isolate = args.GetIsolate();
+    TokenList* list = UnwrapReceiver<TokenList>(args);
+    if (!list) {
+        return;
+    }
+
+    if (args.Length() < 2) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "replace requires 2 arguments")));
+        return;
+    }
+
+    StringArgFromV8 token(isolate, args[0]);
+    StringArgFromV8 new_token(isolate, args[1]);
+    int32_t err = ValidateToken(std::string_view(token.data(), token.length()));
+    if (err == 0) {
+        err = ValidateToken(std::string_view(new_token.data(), new_token.length()));
+    }
+    if (err != 0) {
+        ThrowDOMException(isolate, err);
+        return;
+    }
+
+    // Nothing to replace: answer from the cached tokens
+    list->Refresh();
+    if (!list->Contains(std::string_view(token.data(), token.length()))) {
+        args.GetReturnValue().Set(false);
+        return;
+    }
+
+    uint8_t result = dom_domtokenlist_replace(list->list, token.data(), new_token.data());
+    args.GetReturnValue().Set(result != 0);
+}
+
+void DOMTokenListWrapper::Supports(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("DOMTokenListWrapper::Supports");
+    v8::Isolate* isolate = args.GetIsolate();
+    TokenList* list = UnwrapReceiver<TokenList>(args);
+    if (!list) {
+        return;
+    }
+
+    CStringFromV8 token(isolate, args.Length() > 0 ? args[0] : v8::Undefined(isolate).As<v8::Value>());
+    uint8_t result = token.get() ? dom_domtokenlist_supports(list->list, token.get()) : 0;
+    args.GetReturnValue().Set(result != 0);
+}
+
+void DOMTokenListWrapper::ToString(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("DOMTokenListWrapper::ToString");
+    v8::Isolate* isolate = args.GetIsolate();
+    TokenList* list = UnwrapReceiver<TokenList>(args);
+    if (!list) {
+        return;
+    }
+
+    list->Refresh();
+    args.GetReturnValue().Set(TokenToV8String(isolate, list->value));
+}
+
+// ============================================================================
+// Indexed Property Handler
+// ============================================================================
+
+v8::Intercepted DOMTokenListWrapper::IndexedPropertyGetter(uint32_t index,
+                                                           const v8::PropertyCallbackInfo<v8::Value>& info) {
+    v8::Isolate* isolate = info.GetIsolate();
+    TokenList* list = Unwrap(info.This().As<v8::Object>());
+    if (!list) {
+        return v8::Intercepted::kNo;  // Property does not exist
+    }
+
+    list->Refresh();
+    if (index >= list->tokens.size()) {
+        return v8::Intercepted::kNo;  // Index out of bounds
+    }
+
+    info.GetReturnValue().Set(TokenToV8String(isolate, list->tokens[index]));
+    return v8::Intercepted::kYes;
+}
+
+// ============================================================================
+// Fast API Implementations
+// ============================================================================
+
+const v8::CFunction DOMTokenListWrapper::kFastContains = v8::CFunction::Make(FastContains);
+
+bool DOMTokenListWrapper::FastContains(v8::Local<v8::Object> receiver,
+                                       const v8::FastOneByteString& token) {
+    TokenList* list = UnwrapReceiver<TokenList>(receiver);
+    if (!list) {
+        return false;
+    }
+
+    list->Refresh();
+
+    // Latin-1: ASCII bytes are already UTF-8
+    std::string_view bytes(token.data, token.length);
+    bool ascii = std::all_of(bytes.begin(), bytes.end(),
+                             [](char c) { return static_cast<unsigned char>(c) < 0x80; });
+    if (ascii) {
+        return list->Contains(bytes);
+    }
+
+    CStringFromFastString token_str(token);
+    return list->Contains(std::string_view(token_str.get(), token_str.length()));
+}
+
 } // namespace v8_dom
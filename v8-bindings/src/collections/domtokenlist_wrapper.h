@@ -1,51 +1,127 @@
 /**
- * DOMTokenList Wrapper - V8 bindings for DOMTokenList
- * 
- * Auto-generated wrapper for DOMDOMTokenList.
- * Provides JavaScript interface for DOMTokenList operations.
+ * DOMTokenList Wrapper - V8 bindings for DOMTokenList (Element.classList)
+ *
+ * Reads are served from the element's class tokens, split once and kept
+ * until the class attribute value changes. The check is one attribute view
+ * crossing: interned values are compared by pointer, others by bytes. So
+ * contains(), item() and length never re-split the class string of an
+ * unchanged element.
+ *
+ * Mutations go straight to the C-ABI; variadic add() / remove() pass all
+ * their tokens in one batched call.
+ *
+ * classList is [SameObject]: the list is stored on its element's wrapper
+ * under a private key and keeps the element alive.
  */
 
 #ifndef V8_DOM_DOMTOKENLIST_WRAPPER_H
 #define V8_DOM_DOMTOKENLIST_WRAPPER_H
 
 #include <v8.h>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../core/wrapper_traits.h"
+#include "../core/external_references.h"
+#include "../core/property_table.h"
 #include "dom.h"
 
 namespace v8_dom {
 
+/**
+ * Binding-side state of one classList.
+ */
+struct TokenList {
+    DOMDOMTokenList* list;           // owned
+    DOMElement* element;             // addref'd
+    bool filled;
+    bool value_interned;             // value_data is a string pool pointer
+    const char* value_data;          // attribute bytes the tokens came from
+    std::string value;               // copy of the class attribute value
+    std::vector<std::string_view> tokens;  // unique tokens, views into value
+
+    /**
+     * Re-split the tokens if the class attribute changed since the last split.
+     */
+    void Refresh();
+
+    /**
+     * True if token is one of the (refreshed) tokens.
+     */
+    bool Contains(std::string_view token) const;
+};
+
 class DOMTokenListWrapper {
 public:
     /**
-     * Wrap a C DOMDOMTokenList pointer in a V8 object.
-     * Uses wrapper cache for identity preservation.
+     * Get (or create) the classList of an element wrapper.
      */
-    static v8::Local<v8::Object> Wrap(v8::Isolate* isolate,
-                                      v8::Local<v8::Context> context,
-                                      DOMDOMTokenList* obj);
-    
+    static v8::Local<v8::Object> ClassList(v8::Isolate* isolate,
+                                           v8::Local<v8::Context> context,
+                                           v8::Local<v8::Object> element_wrapper,
+                                           DOMElement* element);
+
     /**
-     * Unwrap a V8 object to get the C DOMDOMTokenList pointer.
+     * Unwrap a V8 object to get the token list state.
      */
-    static DOMDOMTokenList* Unwrap(v8::Local<v8::Object> obj);
-    
+    static TokenList* Unwrap(v8::Local<v8::Object> obj);
+
     /**
      * Install the DOMTokenList template (called once per isolate).
      */
     static void InstallTemplate(v8::Isolate* isolate);
-    
+
     /**
      * Get the cached DOMTokenList template.
      */
     static v8::Local<v8::FunctionTemplate> GetTemplate(v8::Isolate* isolate);
-    
+
     /**
      * Template cache index.
      */
-    static constexpr int kTemplateIndex = 16;
-    
+    static constexpr int kTemplateIndex = WrapperTraits<DOMTokenListWrapper>::kTemplateIndex;
+
+    /**
+     * Type tag stored in the wrapper's type internal field.
+     */
+    static const WrapperTypeInfo kTypeInfo;
+
+    /**
+     * Register this wrapper's callbacks for snapshot serialization.
+     */
+    static void RegisterExternalReferences(ExternalReferenceRegistry* registry);
+
 private:
-    // Property getters/setters and methods will be added here
-    // TODO: Parse dom.h to auto-generate these declarations
+    // Prototype members, installed by InstallTemplate()
+    static const PropertyDescriptor kProperties[];
+    
+    // Properties
+    static void LengthGetter(v8::Local<v8::Name> property,
+                             const v8::PropertyCallbackInfo<v8::Value>& info);
+    static void ValueGetter(v8::Local<v8::Name> property,
+                            const v8::PropertyCallbackInfo<v8::Value>& info);
+    static void ValueSetter(v8::Local<v8::Name> property,
+                            v8::Local<v8::Value> value,
+                            const v8::PropertyCallbackInfo<void>& info);
+
+    // Methods
+    static void Item(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void Contains(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void Add(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void Remove(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void Toggle(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void Replace(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void Supports(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void ToString(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+    // Indexed property handler
+    static v8::Intercepted IndexedPropertyGetter(uint32_t index,
+                                                 const v8::PropertyCallbackInfo<v8::Value>& info);
+
+    // Fast API variants, called directly from optimized code
+    static bool FastContains(v8::Local<v8::Object> receiver,
+                             const v8::FastOneByteString& token);
+    static const v8::CFunction kFastContains;
 };
 
 } // namespace v8_dom
@@ -3,61 +3,96 @@
 #include "../core/template_cache.h"
 #include "../core/utilities.h"
 #include "../nodes/element_wrapper.h"
+#include "listiterator_wrapper.h"
 
 namespace v8_dom {
 
+const WrapperTypeInfo HTMLCollectionWrapper::kTypeInfo = {"HTMLCollection", nullptr};
+
+namespace {
+
+// First copy reserves this many entries, so small collections fill in one call
+constexpr size_t kInitialCapacity = 16;
+
+} // namespace
+
+void LiveCollection::Refresh() {
+    uint64_t current = document ? dom_document_get_mutation_version(document) : 0;
+    if (filled && document && current == version) {
+        return;
+    }
+
+    if (items.capacity() < kInitialCapacity) {
+        items.reserve(kInitialCapacity);
+    }
+    items.resize(items.capacity());
+
+    uint32_t count = dom_htmlcollection_get_items(collection, items.data(),
+                                                  static_cast<uint32_t>(items.size()));
+    if (count > items.size()) {
+        items.resize(count);
+        count = dom_htmlcollection_get_items(collection, items.data(), count);
+    }
+    items.resize(count);
+
+    version = current;
+    filled = true;
+}
+
 v8::Local<v8::Object> HTMLCollectionWrapper::Wrap(v8::Isolate* isolate,
                                               v8::Local<v8::Context> context,
-                                              DOMHTMLCollection* obj) {
+                                              DOMHTMLCollection* obj,
+                                              DOMDocument* document) {
     if (!obj) {
         return v8::Local<v8::Object>();
     }
     
-    // Check wrapper cache first
-    WrapperCache* cache = WrapperCache::ForIsolate(isolate);
-    if (cache->Has(obj)) {
-        return cache->Get(isolate, obj);
-    }
-    
-    // Create new wrapper
+    // Create new wrapper (every getElementsBy* call returns a new collection)
     v8::EscapableHandleScope handle_scope(isolate);
-    v8::Local<v8::FunctionTemplate> tmpl = GetTemplate(isolate);
-    v8::Local<v8::Function> constructor = tmpl->GetFunction(context).ToLocalChecked();
+    v8::Local<v8::Function> constructor =
+        TemplateCache::ForIsolate(isolate)->GetConstructor(context, kTemplateIndex, GetTemplate);
     v8::Local<v8::Object> wrapper = constructor->NewInstance(context).ToLocalChecked();
     
-    // Store C pointer in internal field
-    wrapper->SetInternalField(0, v8::External::New(isolate, obj));
-    
-    // NOTE: HTMLCollection doesn't have addref - it's managed by the document
-    // We just need to release it when the wrapper is GC'd
+    LiveCollection* live = new LiveCollection{obj, document, false, 0, {}};
+    if (document) {
+        dom_document_addref(document);
+    }
     
-    // Cache with release callback
-    cache->Set(isolate, obj, wrapper, [](void* ptr) {
-        dom_htmlcollection_release(static_cast<DOMHTMLCollection*>(ptr));
+    // Store state pointer and type tag in internal fields
+    SetWrapperFields(wrapper, live, &kTypeInfo);
+    
+    // Release the collection and the document when the wrapper is GC'd
+    WrapperCache::ForIsolate(isolate)->Set(isolate, live, wrapper, [](void* ptr) {
+        LiveCollection* live = static_cast<LiveCollection*>(ptr);
+        dom_htmlcollection_release(live->collection);
+        if (live->document) {
+            dom_document_release(live->document);
+        }
+        delete live;
     });
     
     return handle_scope.Escape(wrapper);
 }
 
-DOMHTMLCollection* HTMLCollectionWrapper::Unwrap(v8::Local<v8::Object> obj) {
-    if (obj.IsEmpty() || obj->InternalFieldCount() < 1) {
-        return nullptr;
-    }
-    
-    v8::Local<v8::Value> ptr = obj->GetInternalField(0).As<v8::Value>();
-    if (!ptr->IsExternal()) {
-        return nullptr;
-    }
-    
-    return static_cast<DOMHTMLCollection*>(v8::Local<v8::External>::Cast(ptr)->Value());
+LiveCollection* HTMLCollectionWrapper::Unwrap(v8::Local<v8::Object> obj) {
+    return static_cast<LiveCollection*>(UnwrapObject(obj, &kTypeInfo));
 }
 
+const PropertyDescriptor HTMLCollectionWrapper::kProperties[] = {
+    // Readonly properties
+    DataProperty("length", LengthGetter),
+
+    // Methods
+    MethodProperty("item", Item),
+    MethodProperty("namedItem", NamedItem),
+};
+
 void HTMLCollectionWrapper::InstallTemplate(v8::Isolate* isolate) {
     v8::Local<v8::FunctionTemplate> tmpl = v8::FunctionTemplate::New(isolate);
     tmpl->SetClassName(v8::String::NewFromUtf8Literal(isolate, "HTMLCollection"));
     
     v8::Local<v8::ObjectTemplate> instance = tmpl->InstanceTemplate();
-    instance->SetInternalFieldCount(1);
+    instance->SetInternalFieldCount(kWrapperFieldCount);
     
     // Enable indexed property access (collection[0], collection[1], etc.)
     // Use explicit constructor with 5 params
@@ -70,19 +105,11 @@ void HTMLCollectionWrapper::InstallTemplate(v8::Isolate* isolate) {
     );
     instance->SetHandler(handler_config);
 
-    // Get prototype template for adding properties/methods
-    v8::Local<v8::ObjectTemplate> proto = tmpl->PrototypeTemplate();
-    
-    // Readonly properties
-    proto->SetNativeDataProperty(v8::String::NewFromUtf8Literal(isolate, "length"),
-                                 LengthGetter);
-    
-    // Methods
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "item"),
-              v8::FunctionTemplate::New(isolate, Item));
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "namedItem"),
-              v8::FunctionTemplate::New(isolate, NamedItem));
-    
+    InstallProperties(isolate, tmpl, kProperties);
+
+    // Iterable: native Symbol.iterator over the refreshed items
+    ListIteratorWrapper::InstallIterable(isolate, tmpl, false);
+
     // Cache the template
     TemplateCache* cache = TemplateCache::ForIsolate(isolate);
     cache->Set(kTemplateIndex, tmpl);
@@ -98,33 +125,39 @@ v8::Local<v8::FunctionTemplate> HTMLCollectionWrapper::GetTemplate(v8::Isolate*
     return cache->Get(kTemplateIndex);
 }
 
+void HTMLCollectionWrapper::RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+    RegisterProperties(registry, kProperties);
+    registry->Register(IndexedPropertyGetter);
+}
+
 // ===== Property Getters =====
 
 void HTMLCollectionWrapper::LengthGetter(v8::Local<v8::Name> property,
                                         const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("HTMLCollectionWrapper::LengthGetter");
     v8::Isolate* isolate = info.GetIsolate();
-    DOMHTMLCollection* collection = Unwrap(info.This().As<v8::Object>());
+    LiveCollection* live = Unwrap(info.This().As<v8::Object>());
     
-    if (!collection) {
+    if (!live) {
         isolate->ThrowException(v8::Exception::TypeError(
             v8::String::NewFromUtf8Literal(isolate, "Invalid HTMLCollection object")));
         return;
     }
     
-    uint32_t length = dom_htmlcollection_get_length(collection);
-    info.GetReturnValue().Set(v8::Integer::NewFromUnsigned(isolate, length));
+    live->Refresh();
+    uint32_t length = static_cast<uint32_t>(live->items.size());
+    info.GetReturnValue().Set(length);
 }
 
 // ===== Methods =====
 
 void HTMLCollectionWrapper::Item(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("HTMLCollectionWrapper::Item");
     v8::Isolate* isolate = args.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     
-    DOMHTMLCollection* collection = Unwrap(args.This().As<v8::Object>());
-    if (!collection) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid HTMLCollection object")));
+    LiveCollection* live = UnwrapReceiver<LiveCollection>(args);
+    if (!live) {
         return;
     }
     
@@ -142,13 +175,12 @@ void HTMLCollectionWrapper::Item(const v8::FunctionCallbackInfo<v8::Value>& args
     }
     uint32_t index = maybeIndex.ToChecked();
     
-    // Call C-ABI to get element at index
-    DOMElement* elem = dom_htmlcollection_item(collection, index);
-    
-    if (!elem) {
+    live->Refresh();
+    if (index >= live->items.size()) {
         args.GetReturnValue().SetNull();
         return;
     }
+    DOMElement* elem = live->items[index];
     
     // Wrap and return the element
     v8::Local<v8::Object> wrapper = ElementWrapper::Wrap(isolate, context, elem);
@@ -156,13 +188,12 @@ void HTMLCollectionWrapper::Item(const v8::FunctionCallbackInfo<v8::Value>& args
 }
 
 void HTMLCollectionWrapper::NamedItem(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("HTMLCollectionWrapper::NamedItem");
     v8::Isolate* isolate = args.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     
-    DOMHTMLCollection* collection = Unwrap(args.This().As<v8::Object>());
-    if (!collection) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid HTMLCollection object")));
+    LiveCollection* live = UnwrapReceiver<LiveCollection>(args);
+    if (!live) {
         return;
     }
     
@@ -175,7 +206,7 @@ void HTMLCollectionWrapper::NamedItem(const v8::FunctionCallbackInfo<v8::Value>&
     v8::String::Utf8Value name(isolate, args[0]);
     
     // Call C-ABI to get element by name
-    DOMElement* elem = dom_htmlcollection_nameditem(collection, *name);
+    DOMElement* elem = dom_htmlcollection_nameditem(live->collection, *name);
     
     if (!elem) {
         args.GetReturnValue().SetNull();
@@ -194,17 +225,17 @@ v8::Intercepted HTMLCollectionWrapper::IndexedPropertyGetter(uint32_t index,
     v8::Isolate* isolate = info.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     
-    DOMHTMLCollection* collection = Unwrap(info.This().As<v8::Object>());
-    if (!collection) {
+    LiveCollection* live = Unwrap(info.This().As<v8::Object>());
+    if (!live) {
         return v8::Intercepted::kNo;  // Property does not exist
     }
     
-    // Call C-ABI to get element at index
-    DOMElement* elem = dom_htmlcollection_item(collection, index);
-    
-    if (!elem) {
+    // Served from the element copy; refilled only after a mutation
+    live->Refresh();
+    if (index >= live->items.size()) {
         return v8::Intercepted::kNo;  // Index out of bounds
     }
+    DOMElement* elem = live->items[index];
     
     // Wrap and return the element
     v8::Local<v8::Object> wrapper = ElementWrapper::Wrap(isolate, context, elem);
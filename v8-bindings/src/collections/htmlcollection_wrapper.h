@@ -3,30 +3,58 @@
  * 
  * Auto-generated wrapper for DOMHTMLCollection.
  * Provides JavaScript interface for HTMLCollection operations.
+ *
+ * Live collections are served from a copy of their elements, filled in one
+ * C-ABI call and refilled only when the owner document's mutation version
+ * changes, so `for (i < c.length; c[i])` loops over an unchanged tree are
+ * linear instead of a tree walk per index.
  */
 
 #ifndef V8_DOM_HTMLCOLLECTION_WRAPPER_H
 #define V8_DOM_HTMLCOLLECTION_WRAPPER_H
 
 #include <v8.h>
+#include <cstdint>
+#include <vector>
+#include "../core/wrapper_traits.h"
+#include "../core/external_references.h"
+#include "../core/property_table.h"
 #include "dom.h"
 
 namespace v8_dom {
 
+/**
+ * Binding-side state of one HTMLCollection.
+ */
+struct LiveCollection {
+    DOMHTMLCollection* collection;  // owned
+    DOMDocument* document;          // addref'd; NULL disables the copy
+    bool filled;
+    uint64_t version;               // document mutation version at the copy
+    std::vector<DOMElement*> items;
+
+    /**
+     * Refill items if the document changed since the last copy.
+     */
+    void Refresh();
+};
+
 class HTMLCollectionWrapper {
 public:
     /**
-     * Wrap a C DOMHTMLCollection pointer in a V8 object.
-     * Uses wrapper cache for identity preservation.
+     * Wrap a C DOMHTMLCollection pointer in a V8 object, taking ownership.
+     * `document` owns the collection's elements; its mutation version
+     * decides when the element copy is stale.
      */
     static v8::Local<v8::Object> Wrap(v8::Isolate* isolate,
                                       v8::Local<v8::Context> context,
-                                      DOMHTMLCollection* obj);
+                                      DOMHTMLCollection* obj,
+                                      DOMDocument* document);
     
     /**
-     * Unwrap a V8 object to get the C DOMHTMLCollection pointer.
+     * Unwrap a V8 object to get the collection state.
      */
-    static DOMHTMLCollection* Unwrap(v8::Local<v8::Object> obj);
+    static LiveCollection* Unwrap(v8::Local<v8::Object> obj);
     
     /**
      * Install the HTMLCollection template (called once per isolate).
@@ -41,9 +69,22 @@ public:
     /**
      * Template cache index.
      */
-    static constexpr int kTemplateIndex = 14;
+    static constexpr int kTemplateIndex = WrapperTraits<HTMLCollectionWrapper>::kTemplateIndex;
+    
+    /**
+     * Type tag stored in the wrapper's type internal field.
+     */
+    static const WrapperTypeInfo kTypeInfo;
+    
+    /**
+     * Register this wrapper's callbacks for snapshot serialization.
+     */
+    static void RegisterExternalReferences(ExternalReferenceRegistry* registry);
     
 private:
+    // Prototype members, installed by InstallTemplate()
+    static const PropertyDescriptor kProperties[];
+    
     // Readonly properties
     static void LengthGetter(v8::Local<v8::Name> property,
                             const v8::PropertyCallbackInfo<v8::Value>& info);
@@ -0,0 +1,257 @@
+#include "listiterator_wrapper.h"
+#include <vector>
+#include "../core/template_cache.h"
+#include "../core/utilities.h"
+#include "../nodes/node_wrapper.h"
+#include "../nodes/element_wrapper.h"
+#include "nodelist_wrapper.h"
+#include "childlist_wrapper.h"
+#include "htmlcollection_wrapper.h"
+
+namespace v8_dom {
+
+const WrapperTypeInfo ListIteratorWrapper::kTypeInfo = {"ListIterator", nullptr};
+
+namespace {
+
+/**
+ * The current items of a NodeList, childNodes/children or HTMLCollection
+ * wrapper. Live lists are refreshed first; the view is only valid until
+ * script runs again.
+ */
+struct ListView {
+    const std::vector<DOMNode*>* nodes = nullptr;
+    const std::vector<DOMElement*>* elements = nullptr;
+
+    size_t size() const { return nodes ? nodes->size() : elements->size(); }
+
+    v8::Local<v8::Object> Wrap(v8::Isolate* isolate, v8::Local<v8::Context> context, size_t index) const {
+        return nodes ? NodeWrapper::Wrap(isolate, context, (*nodes)[index])
+                     : ElementWrapper::Wrap(isolate, context, (*elements)[index]);
+    }
+};
+
+bool ViewOf(v8::Local<v8::Object> list, ListView* view) {
+    if (NodeListSnapshot* snapshot = NodeListWrapper::Unwrap(list)) {
+        view->nodes = &snapshot->nodes;
+        return true;
+    }
+    if (ChildList* children = ChildListWrapper::Unwrap(list)) {
+        children->Refresh();
+        view->nodes = &children->items;
+        return true;
+    }
+    if (LiveCollection* live = HTMLCollectionWrapper::Unwrap(list)) {
+        live->Refresh();
+        view->elements = &live->items;
+        return true;
+    }
+    return false;
+}
+
+void ThrowIllegalInvocation(v8::Isolate* isolate) {
+    isolate->ThrowException(v8::Exception::TypeError(
+        v8::String::NewFromUtf8Literal(isolate, "Illegal invocation")));
+}
+
+/**
+ * An iterator result object ({value, done}).
+ */
+v8::Local<v8::Object> IteratorResult(v8::Isolate* isolate, v8::Local<v8::Context> context,
+                                     v8::Local<v8::Value> value, bool done) {
+    v8::Local<v8::Object> result = v8::Object::New(isolate);
+    result->CreateDataProperty(context, v8::String::NewFromUtf8Literal(isolate, "value"), value).Check();
+    result->CreateDataProperty(context, v8::String::NewFromUtf8Literal(isolate, "done"),
+                               v8::Boolean::New(isolate, done)).Check();
+    return result;
+}
+
+} // namespace
+
+const PropertyDescriptor ListIteratorWrapper::kProperties[] = {
+    // Methods
+    MethodProperty("next", Next),
+};
+
+void ListIteratorWrapper::InstallIterable(v8::Isolate* isolate,
+                                          v8::Local<v8::FunctionTemplate> tmpl,
+                                          bool pair_methods) {
+    v8::Local<v8::Signature> signature = v8::Signature::New(isolate, tmpl);
+    v8::Local<v8::ObjectTemplate> proto = tmpl->PrototypeTemplate();
+
+    // Symbol.iterator and values are the same function
+    v8::Local<v8::FunctionTemplate> values = v8::FunctionTemplate::New(
+        isolate, Values, v8::Local<v8::Value>(), signature, 0, v8::ConstructorBehavior::kThrow);
+    proto->Set(v8::Symbol::GetIterator(isolate), values, v8::DontEnum);
+    if (!pair_methods) {
+        return;
+    }
+
+    proto->Set(v8::String::NewFromUtf8Literal(isolate, "values"), values, v8::DontEnum);
+    proto->Set(v8::String::NewFromUtf8Literal(isolate, "keys"),
+               v8::FunctionTemplate::New(isolate, Keys, v8::Local<v8::Value>(), signature, 0,
+                                         v8::ConstructorBehavior::kThrow),
+               v8::DontEnum);
+    proto->Set(v8::String::NewFromUtf8Literal(isolate, "entries"),
+               v8::FunctionTemplate::New(isolate, Entries, v8::Local<v8::Value>(), signature, 0,
+                                         v8::ConstructorBehavior::kThrow),
+               v8::DontEnum);
+    proto->Set(v8::String::NewFromUtf8Literal(isolate, "forEach"),
+               v8::FunctionTemplate::New(isolate, ForEach, v8::Local<v8::Value>(), signature, 1,
+                                         v8::ConstructorBehavior::kThrow),
+               v8::DontEnum);
+}
+
+void ListIteratorWrapper::InstallTemplate(v8::Isolate* isolate) {
+    v8::Local<v8::FunctionTemplate> tmpl = v8::FunctionTemplate::New(isolate);
+    tmpl->SetClassName(v8::String::NewFromUtf8Literal(isolate, "ListIterator"));
+    tmpl->InstanceTemplate()->SetInternalFieldCount(kFieldCount);
+
+    // The prototype inherits from %IteratorPrototype% (which provides
+    // Symbol.iterator): inherit from a template whose prototype is that
+    // intrinsic
+    v8::Local<v8::FunctionTemplate> iterator = v8::FunctionTemplate::New(
+        isolate, nullptr, v8::Local<v8::Value>(), v8::Local<v8::Signature>(), 0,
+        v8::ConstructorBehavior::kThrow);
+    iterator->SetIntrinsicDataProperty(v8::String::NewFromUtf8Literal(isolate, "prototype"),
+                                       v8::kIteratorPrototype);
+    tmpl->Inherit(iterator);
+
+    InstallProperties(isolate, tmpl, kProperties);
+
+    // Cache the template
+    TemplateCache* cache = TemplateCache::ForIsolate(isolate);
+    cache->Set(kTemplateIndex, tmpl);
+}
+
+v8::Local<v8::FunctionTemplate> ListIteratorWrapper::GetTemplate(v8::Isolate* isolate) {
+    TemplateCache* cache = TemplateCache::ForIsolate(isolate);
+
+    if (!cache->Has(kTemplateIndex)) {
+        InstallTemplate(isolate);
+    }
+
+    return cache->Get(kTemplateIndex);
+}
+
+void ListIteratorWrapper::RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+    registry->Register(Keys);
+    registry->Register(Values);
+    registry->Register(Entries);
+    registry->Register(ForEach);
+    RegisterProperties(registry, kProperties);
+}
+
+// ============================================================================
+// List Methods
+// ============================================================================
+
+void ListIteratorWrapper::Create(const v8::FunctionCallbackInfo<v8::Value>& args, Kind kind) {
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    ListView view;
+    if (!ViewOf(args.This(), &view)) {
+        ThrowIllegalInvocation(isolate);
+        return;
+    }
+
+    v8::Local<v8::Function> constructor =
+        TemplateCache::ForIsolate(isolate)->GetConstructor(context, kTemplateIndex, GetTemplate);
+    v8::Local<v8::Object> iterator;
+    if (!constructor->NewInstance(context).ToLocal(&iterator)) {
+        return;
+    }
+    SetWrapperFields(iterator, nullptr, &kTypeInfo);
+    iterator->SetInternalField(kListField, args.This());
+    iterator->SetInternalField(kIndexField, v8::Integer::New(isolate, 0));
+    iterator->SetInternalField(kKindField, v8::Integer::New(isolate, kind));
+    args.GetReturnValue().Set(iterator);
+}
+
+void ListIteratorWrapper::Keys(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ListIteratorWrapper::Keys");
+    Create(args, kKeys);
+}
+
+void ListIteratorWrapper::Values(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ListIteratorWrapper::Values");
+    Create(args, kValues);
+}
+
+void ListIteratorWrapper::Entries(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ListIteratorWrapper::Entries");
+    Create(args, kEntries);
+}
+
+void ListIteratorWrapper::ForEach(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ListIteratorWrapper::ForEach");
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    v8::Local<v8::Object> list = args.This();
+    ListView view;
+    if (!ViewOf(list, &view)) {
+        ThrowIllegalInvocation(isolate);
+        return;
+    }
+    if (args.Length() < 1 || !args[0]->IsFunction()) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "forEach requires a callback function")));
+        return;
+    }
+    v8::Local<v8::Function> callback = args[0].As<v8::Function>();
+    v8::Local<v8::Value> this_arg = args.Length() > 1 ? args[1] : v8::Undefined(isolate).As<v8::Value>();
+
+    // callback(node, index, list); the callback may mutate a live list, so
+    // its items are re-read before every step
+    v8::Local<v8::Value> argv[3] = {v8::Local<v8::Value>(), v8::Local<v8::Value>(), list};
+    for (uint32_t index = 0; index < view.size(); index++) {
+        v8::HandleScope handle_scope(isolate);
+        argv[0] = view.Wrap(isolate, context, index);
+        argv[1] = v8::Integer::NewFromUnsigned(isolate, index);
+        if (callback->Call(context, this_arg, 3, argv).IsEmpty()) {
+            return;
+        }
+        ViewOf(list, &view);
+    }
+}
+
+// ============================================================================
+// Iterator Methods
+// ============================================================================
+
+void ListIteratorWrapper::Next(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ListIteratorWrapper::Next");
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    v8::Local<v8::Object> iterator = args.This();
+
+    v8::Local<v8::Value> list = iterator->GetInternalField(kListField).As<v8::Value>();
+    ListView view;
+    if (list->IsObject() && ViewOf(list.As<v8::Object>(), &view)) {
+        uint32_t index = static_cast<uint32_t>(
+            iterator->GetInternalField(kIndexField).As<v8::Value>().As<v8::Integer>()->Value());
+        if (index < view.size()) {
+            iterator->SetInternalField(kIndexField, v8::Integer::NewFromUnsigned(isolate, index + 1));
+
+            v8::Local<v8::Value> value;
+            int64_t kind = iterator->GetInternalField(kKindField).As<v8::Value>().As<v8::Integer>()->Value();
+            if (kind == kKeys) {
+                value = v8::Integer::NewFromUnsigned(isolate, index);
+            } else if (kind == kValues) {
+                value = view.Wrap(isolate, context, index);
+            } else {
+                v8::Local<v8::Value> pair[2] = {v8::Integer::NewFromUnsigned(isolate, index),
+                                                view.Wrap(isolate, context, index)};
+                value = v8::Array::New(isolate, pair, 2);
+            }
+            args.GetReturnValue().Set(IteratorResult(isolate, context, value, false));
+            return;
+        }
+
+        // Exhausted iterators stay done, even if the list grows
+        iterator->SetInternalField(kListField, v8::Undefined(isolate));
+    }
+    args.GetReturnValue().Set(IteratorResult(isolate, context, v8::Undefined(isolate), true));
+}
+
+} // namespace v8_dom
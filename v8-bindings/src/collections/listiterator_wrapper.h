@@ -0,0 +1,98 @@
+/**
+ * ListIterator Wrapper - V8 bindings for NodeList / HTMLCollection iteration
+ *
+ * The iterable members of NodeList (keys, values, entries, forEach,
+ * Symbol.iterator) and HTMLCollection (Symbol.iterator) are native: they
+ * read the node pointers the list wrapper already keeps (the NodeList
+ * snapshot, or the refreshed items of a live list) instead of going
+ * through length and the indexed interceptor once per step, and forEach
+ * calls its callback from C++ with one argument array reused for every
+ * node. childNodes and children inherit them from their base prototypes.
+ *
+ * keys(), values(), entries() and Symbol.iterator return ListIterator
+ * objects, the default iterators of WebIDL: their prototype inherits
+ * %IteratorPrototype%, and each instance keeps its list, next index and
+ * kind in internal fields.
+ * Live lists are re-read on every step, so an iterator sees mutations
+ * made while it runs, like the Array iterator it replaces.
+ */
+
+#ifndef V8_DOM_LISTITERATOR_WRAPPER_H
+#define V8_DOM_LISTITERATOR_WRAPPER_H
+
+#include <v8.h>
+#include "../core/wrapper_traits.h"
+#include "../core/external_references.h"
+#include "../core/property_table.h"
+
+namespace v8_dom {
+
+class ListIteratorWrapper {
+public:
+    /**
+     * Install the iterable members on a list template's prototype: all of
+     * them (NodeList), or Symbol.iterator only (HTMLCollection). They
+     * accept receivers made from tmpl and its descendants.
+     */
+    static void InstallIterable(v8::Isolate* isolate,
+                                v8::Local<v8::FunctionTemplate> tmpl,
+                                bool pair_methods);
+
+    /**
+     * Install the ListIterator template (called once per isolate).
+     */
+    static void InstallTemplate(v8::Isolate* isolate);
+
+    /**
+     * Get the cached ListIterator template.
+     */
+    static v8::Local<v8::FunctionTemplate> GetTemplate(v8::Isolate* isolate);
+
+    /**
+     * Template cache index.
+     */
+    static constexpr int kTemplateIndex = WrapperTraits<ListIteratorWrapper>::kTemplateIndex;
+
+    /**
+     * Type tag stored in the wrapper's type internal field.
+     */
+    static const WrapperTypeInfo kTypeInfo;
+
+    /**
+     * Register this wrapper's callbacks for snapshot serialization.
+     */
+    static void RegisterExternalReferences(ExternalReferenceRegistry* registry);
+
+private:
+    // Internal fields after the shared wrapper fields (no C object)
+    enum Field {
+        kListField = kWrapperFieldCount,  // list wrapper, undefined once done
+        kIndexField,
+        kKindField,
+        kFieldCount,
+    };
+
+    enum Kind {
+        kKeys,
+        kValues,
+        kEntries,
+    };
+
+    // Prototype members, installed by InstallTemplate()
+    static const PropertyDescriptor kProperties[];
+
+    static void Create(const v8::FunctionCallbackInfo<v8::Value>& args, Kind kind);
+
+    // List methods
+    static void Keys(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void Values(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void Entries(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void ForEach(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+    // Iterator methods
+    static void Next(const v8::FunctionCallbackInfo<v8::Value>& args);
+};
+
+} // namespace v8_dom
+
+#endif // V8_DOM_LISTITERATOR_WRAPPER_H
@@ -2,71 +2,195 @@
 #include "../wrapper_cache.h"
 #include "../core/template_cache.h"
 #include "../core/utilities.h"
+#include "../core/string_cache.h"
+#include "../core/atom_table.h"
+#include "../nodes/attr_wrapper.h"
+#include "../nodes/element_wrapper.h"
+#include <vector>
 
 namespace v8_dom {
 
-v8::Local<v8::Object> NamedNodeMapWrapper::Wrap(v8::Isolate* isolate,
-                                              v8::Local<v8::Context> context,
-                                              DOMNamedNodeMap* obj) {
-    if (!obj) {
-        return v8::Local<v8::Object>();
+const WrapperTypeInfo NamedNodeMapWrapper::kTypeInfo = {"NamedNodeMap", nullptr};
+
+namespace {
+
+v8::Local<v8::Private> MapKey(v8::Isolate* isolate) {
+    return v8::Private::ForApi(isolate, v8::String::NewFromUtf8Literal(isolate, "v8_dom::attributes"));
+}
+
+v8::Local<v8::Private> OwnerKey(v8::Isolate* isolate) {
+    return v8::Private::ForApi(isolate, v8::String::NewFromUtf8Literal(isolate, "v8_dom::attributesOwner"));
+}
+
+AttributeMap* ThisMap(v8::Isolate* isolate, v8::Local<v8::Object> receiver) {
+    AttributeMap* map = NamedNodeMapWrapper::Unwrap(receiver);
+    if (!map) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Invalid NamedNodeMap")));
     }
-    
-    // Check wrapper cache first
-    WrapperCache* cache = WrapperCache::ForIsolate(isolate);
-    if (cache->Has(obj)) {
-        return cache->Get(isolate, obj);
+    return map;
+}
+
+/**
+ * Wrap an Attr borrowed from the element's Attr cache. The same attribute
+ * gets the same wrapper, and a cached wrapper costs no reference count
+ * write (only a new wrapper takes a reference).
+ */
+v8::Local<v8::Value> WrapAttr(v8::Isolate* isolate, v8::Local<v8::Context> context, DOMAttr* attr) {
+    if (!attr) {
+        return v8::Null(isolate);
+    }
+    return AttrWrapper::Wrap(isolate, context, attr);
+}
+
+/**
+ * Wrap an Attr the C-ABI returned with a reference (uncached namespaced
+ * lookups), handing that reference to the wrapper.
+ */
+v8::Local<v8::Value> AdoptAttr(v8::Isolate* isolate, v8::Local<v8::Context> context, DOMAttr* attr) {
+    if (!attr) {
+        return v8::Null(isolate);
     }
-    
-    // Create new wrapper
+    v8::Local<v8::Object> wrapper = AttrWrapper::Wrap(isolate, context, attr);
+    dom_attr_release(attr);
+    return wrapper;
+}
+
+/**
+ * Collects attribute names and values into two lists, in inline storage
+ * for the common case of a handful of attributes.
+ */
+class AttributeCollector {
+public:
+    AttributeCollector(v8::Isolate* isolate, DOMElement* elem)
+        : isolate_(isolate), node_(reinterpret_cast<DOMNode*>(elem)) {}
+
+    static void Add(const DOMStringView* name, const DOMStringView* value, void* user_data) {
+        auto* self = static_cast<AttributeCollector*>(user_data);
+        v8::Local<v8::Value> name_string = NameViewToV8String(self->isolate_, *name, self->node_);
+        v8::Local<v8::Value> value_string = StringViewToV8String(self->isolate_, *value, self->node_);
+        if (self->size_ < kInlineCapacity && self->heap_names_.empty()) {
+            self->inline_names_[self->size_] = name_string;
+            self->inline_values_[self->size_] = value_string;
+            self->size_++;
+            return;
+        }
+        if (self->heap_names_.empty()) {
+            self->heap_names_.assign(self->inline_names_, self->inline_names_ + self->size_);
+            self->heap_values_.assign(self->inline_values_, self->inline_values_ + self->size_);
+        }
+        self->heap_names_.push_back(name_string);
+        self->heap_values_.push_back(value_string);
+        self->size_++;
+    }
+
+    v8::Local<v8::Value>* names() { return heap_names_.empty() ? inline_names_ : heap_names_.data(); }
+    v8::Local<v8::Value>* values() { return heap_values_.empty() ? inline_values_ : heap_values_.data(); }
+    size_t size() const { return size_; }
+
+private:
+    static constexpr size_t kInlineCapacity = 16;
+
+    v8::Isolate* isolate_;
+    DOMNode* node_;
+    v8::Local<v8::Value> inline_names_[kInlineCapacity];
+    v8::Local<v8::Value> inline_values_[kInlineCapacity];
+    std::vector<v8::Local<v8::Value>> heap_names_;
+    std::vector<v8::Local<v8::Value>> heap_values_;
+    size_t size_ = 0;
+};
+
+} // namespace
+
+v8::Local<v8::Object> NamedNodeMapWrapper::Attributes(v8::Isolate* isolate,
+                                                      v8::Local<v8::Context> context,
+                                                      v8::Local<v8::Object> element_wrapper,
+                                                      DOMElement* element) {
     v8::EscapableHandleScope handle_scope(isolate);
-    v8::Local<v8::FunctionTemplate> tmpl = GetTemplate(isolate);
-    v8::Local<v8::Function> constructor = tmpl->GetFunction(context).ToLocalChecked();
+    v8::Local<v8::Private> key = MapKey(isolate);
+
+    // [SameObject]: reuse the map stored on the element wrapper
+    v8::Local<v8::Value> existing;
+    if (element_wrapper->GetPrivate(context, key).ToLocal(&existing) && existing->IsObject()) {
+        return handle_scope.Escape(existing.As<v8::Object>());
+    }
+
+    v8::Local<v8::Function> constructor =
+        TemplateCache::ForIsolate(isolate)->GetConstructor(context, kTemplateIndex, GetTemplate);
     v8::Local<v8::Object> wrapper = constructor->NewInstance(context).ToLocalChecked();
-    
-    // Store C pointer in internal field
-    wrapper->SetInternalField(0, v8::External::New(isolate, obj));
-    
-    // Increment C-side reference count
-    dom_namednodemap_addref(obj);
-    
-    // Cache with release callback
-    cache->Set(isolate, obj, wrapper, [](void* ptr) {
-        dom_namednodemap_release(static_cast<DOMNamedNodeMap*>(ptr));
+
+    AttributeMap* map = new AttributeMap{dom_element_get_attributes(element), element};
+    dom_element_addref(element);
+    SetWrapperFields(wrapper, map, &kTypeInfo);
+
+    // The map and its element wrapper keep each other alive
+    element_wrapper->SetPrivate(context, key, wrapper).Check();
+    wrapper->SetPrivate(context, OwnerKey(isolate), element_wrapper).Check();
+
+    WrapperCache::ForIsolate(isolate)->Set(isolate, map, wrapper, [](void* ptr) {
+        AttributeMap* map = static_cast<AttributeMap*>(ptr);
+        dom_element_release(map->element);
+        delete map;
     });
-    
+
     return handle_scope.Escape(wrapper);
 }
 
-DOMNamedNodeMap* NamedNodeMapWrapper::Unwrap(v8::Local<v8::Object> obj) {
-    if (obj.IsEmpty() || obj->InternalFieldCount() < 1) {
-        return nullptr;
-    }
-    
-    v8::Local<v8::Value> ptr = obj->GetInternalField(0).As<v8::Value>();
-    if (!ptr->IsExternal()) {
-        return nullptr;
+void NamedNodeMapWrapper::AttributesGetter(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("NamedNodeMapWrapper::AttributesGetter");
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::Local<v8::Object> self = args.This();
+    DOMElement* element = UnwrapReceiver<DOMElement>(args);
+    if (!element) {
+        return;
     }
-    
-    return static_cast<DOMNamedNodeMap*>(v8::Local<v8::External>::Cast(ptr)->Value());
+
+    args.GetReturnValue().Set(Attributes(isolate, isolate->GetCurrentContext(), self, element));
+}
+
+AttributeMap* NamedNodeMapWrapper::Unwrap(v8::Local<v8::Object> obj) {
+    return static_cast<AttributeMap*>(UnwrapObject(obj, &kTypeInfo));
 }
 
+const PropertyDescriptor NamedNodeMapWrapper::kProperties[] = {
+    // Readonly properties
+    DataProperty("length", LengthGetter),
+
+    // Methods
+    MethodProperty("item", Item),
+    MethodProperty("getNamedItem", GetNamedItem),
+    MethodProperty("getNamedItemNS", GetNamedItemNS),
+
+    // Non-standard: every name and value without creating Attr nodes
+    // (not enumerable)
+    MethodProperty("__namesAndValues", NamesAndValues, kReceiverCheck | kDontEnum),
+};
+
 void NamedNodeMapWrapper::InstallTemplate(v8::Isolate* isolate) {
     v8::Local<v8::FunctionTemplate> tmpl = v8::FunctionTemplate::New(isolate);
     tmpl->SetClassName(v8::String::NewFromUtf8Literal(isolate, "NamedNodeMap"));
-    tmpl->InstanceTemplate()->SetInternalFieldCount(1);
-    
 
-    // Get prototype template for adding properties/methods
+    v8::Local<v8::ObjectTemplate> instance = tmpl->InstanceTemplate();
+    instance->SetInternalFieldCount(kWrapperFieldCount);
+
+    // Indexed access (attributes[0]); Attr nodes are created on first access
+    v8::IndexedPropertyHandlerConfiguration handler_config(
+        IndexedPropertyGetter,  // getter
+        nullptr,                // setter
+        nullptr,                // query
+        nullptr,                // deleter
+        nullptr                 // enumerator
+    );
+    instance->SetHandler(handler_config);
+
+    InstallProperties(isolate, tmpl, kProperties);
+
     v8::Local<v8::ObjectTemplate> proto = tmpl->PrototypeTemplate();
-    
-    // TODO: Add properties and methods here
-    // Example:
-    // proto->SetNativeDataProperty(v8::String::NewFromUtf8Literal(isolate, "propertyName"),
-    //                   PropertyNameGetter, PropertyNameSetter);
-    // proto->Set(v8::String::NewFromUtf8Literal(isolate, "methodName"),
-    //           v8::FunctionTemplate::New(isolate, MethodName));
-    
+
+    // Iterable via the indexed getter
+    proto->SetIntrinsicDataProperty(v8::Symbol::GetIterator(isolate),
+                                    v8::kArrayProto_values, v8::DontEnum);
+
     // Cache the template
     TemplateCache* cache = TemplateCache::ForIsolate(isolate);
     cache->Set(kTemplateIndex, tmpl);
@@ -74,12 +198,149 @@ void NamedNodeMapWrapper::InstallTemplate(v8::Isolate* isolate) {
 
 v8::Local<v8::FunctionTemplate> NamedNodeMapWrapper::GetTemplate(v8::Isolate* isolate) {
     TemplateCache* cache = TemplateCache::ForIsolate(isolate);
-    
+
     if (!cache->Has(kTemplateIndex)) {
         InstallTemplate(isolate);
     }
-    
+
     return cache->Get(kTemplateIndex);
 }
 
+void NamedNodeMapWrapper::RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+    registry->Register(AttributesGetter);
+    registry->Register(IndexedPropertyGetter);
+    RegisterProperties(registry, kProperties);
+}
+
+// ============================================================================
+// Property Implementations - Readonly
+// ============================================================================
+
+void NamedNodeMapWrapper::LengthGetter(v8::Local<v8::Name> property,
+                                       const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("NamedNodeMapWrapper::LengthGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    AttributeMap* map = ThisMap(isolate, info.This().As<v8::Object>());
+    if (!map) {
+        return;
+    }
+
+    info.GetReturnValue().Set(dom_namednodemap_get_length(map->map));
+}
+
+// ============================================================================
+// Method Implementations
+// ============================================================================
+
+void NamedNodeMapWrapper::Item(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("NamedNodeMapWrapper::Item");
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    AttributeMap* map = UnwrapReceiver<AttributeMap>(args);
+    if (!map) {
+        return;
+    }
+
+    if (args.Length() < 1) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Index required")));
+        return;
+    }
+
+    uint32_t index = 0;
+    if (!args[0]->Uint32Value(context).To(&index)) {
+        return;
+    }
+    args.GetReturnValue().Set(WrapAttr(isolate, context, dom_namednodemap_item_borrowed(map->map, index)));
+}
+
+void NamedNodeMapWrapper::GetNamedItem(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("NamedNodeMapWrapper::GetNamedItem");
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    AttributeMap* map = UnwrapReceiver<AttributeMap>(args);
+    if (!map) {
+        return;
+    }
+
+    if (args.Length() < 1) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "getNamedItem requires 1 argument")));
+        return;
+    }
+
+    CStringFromV8 name(isolate, args[0]);
+    if (!name.get()) {
+        return;  // ToString threw
+    }
+    args.GetReturnValue().Set(WrapAttr(isolate, context, dom_namednodemap_getnameditem_borrowed(map->map, name)));
+}
+
+void NamedNodeMapWrapper::GetNamedItemNS(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("NamedNodeMapWrapper::GetNamedItemNS");
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    AttributeMap* map = UnwrapReceiver<AttributeMap>(args);
+    if (!map) {
+        return;
+    }
+
+    if (args.Length() < 2) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "getNamedItemNS requires 2 arguments")));
+        return;
+    }
+
+    // DOMString? namespace: null, undefined and "" all mean no namespace
+    CStringFromV8 ns(isolate, args[0]);
+    CStringFromV8 localName(isolate, args[1]);
+    if (!localName.get()) {
+        return;  // ToString threw
+    }
+    const char* namespace_uri = args[0]->IsNullOrUndefined() || !ns.get() || ns.get()[0] == '\0'
+        ? nullptr : ns.get();
+    args.GetReturnValue().Set(AdoptAttr(isolate, context,
+                                        dom_namednodemap_getnameditemns(map->map, namespace_uri, localName)));
+}
+
+void NamedNodeMapWrapper::NamesAndValues(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("NamedNodeMapWrapper::NamesAndValues");
+    v8::Isolate* isolate = args.GetIsolate();
+    AttributeMap* map = UnwrapReceiver<AttributeMap>(args);
+    if (!map) {
+        return;
+    }
+
+    // One pass over the attribute storage; no Attr node is created
+    AttributeCollector attributes(isolate, map->element);
+    dom_element_foreach_attribute(map->element, AttributeCollector::Add, &attributes);
+
+    v8::Local<v8::Value> pair[] = {
+        v8::Array::New(isolate, attributes.names(), attributes.size()),
+        v8::Array::New(isolate, attributes.values(), attributes.size()),
+    };
+    args.GetReturnValue().Set(v8::Array::New(isolate, pair, 2));
+}
+
+// ============================================================================
+// Indexed Property Handler
+// ============================================================================
+
+v8::Intercepted NamedNodeMapWrapper::IndexedPropertyGetter(uint32_t index,
+                                                           const v8::PropertyCallbackInfo<v8::Value>& info) {
+    v8::Isolate* isolate = info.GetIsolate();
+    AttributeMap* map = Unwrap(info.This().As<v8::Object>());
+    if (!map) {
+        return v8::Intercepted::kNo;  // Property does not exist
+    }
+
+    DOMAttr* attr = dom_namednodemap_item_borrowed(map->map, index);
+    if (!attr) {
+        return v8::Intercepted::kNo;  // Index out of bounds
+    }
+
+    info.GetReturnValue().Set(WrapAttr(isolate, isolate->GetCurrentContext(), attr));
+    return v8::Intercepted::kYes;
+}
+
 } // namespace v8_dom
@@ -1,51 +1,104 @@
 /**
- * NamedNodeMap Wrapper - V8 bindings for NamedNodeMap
- * 
- * Auto-generated wrapper for DOMNamedNodeMap.
- * Provides JavaScript interface for NamedNodeMap operations.
+ * NamedNodeMap Wrapper - V8 bindings for NamedNodeMap (Element.attributes)
+ *
+ * The map is a view of its element's attribute storage: length and the
+ * name/value extension read the storage directly, and an Attr node is only
+ * created when script asks for one by index or name. The element caches
+ * each Attr it hands out, and the wrapper cache keeps one Attr wrapper per
+ * node, so attributes[i] returns the same object until the attribute is
+ * removed.
+ *
+ * attributes is [SameObject]: the map is stored on its element's wrapper
+ * under a private key and keeps the element alive.
+ *
+ * Non-standard extension (not enumerable):
+ *   __namesAndValues() -> [names, values], two arrays filled in one C-ABI
+ *   call without creating any Attr node
  */
 
 #ifndef V8_DOM_NAMEDNODEMAP_WRAPPER_H
 #define V8_DOM_NAMEDNODEMAP_WRAPPER_H
 
 #include <v8.h>
+#include "../core/wrapper_traits.h"
+#include "../core/external_references.h"
+#include "../core/property_table.h"
 #include "dom.h"
 
 namespace v8_dom {
 
+/**
+ * Binding-side state of one NamedNodeMap.
+ */
+struct AttributeMap {
+    DOMNamedNodeMap* map;  // view of element (not owned)
+    DOMElement* element;   // addref'd
+};
+
 class NamedNodeMapWrapper {
 public:
     /**
-     * Wrap a C DOMNamedNodeMap pointer in a V8 object.
-     * Uses wrapper cache for identity preservation.
+     * Get (or create) the attributes map of an element wrapper.
      */
-    static v8::Local<v8::Object> Wrap(v8::Isolate* isolate,
-                                      v8::Local<v8::Context> context,
-                                      DOMNamedNodeMap* obj);
-    
+    static v8::Local<v8::Object> Attributes(v8::Isolate* isolate,
+                                            v8::Local<v8::Context> context,
+                                            v8::Local<v8::Object> element_wrapper,
+                                            DOMElement* element);
+
     /**
-     * Unwrap a V8 object to get the C DOMNamedNodeMap pointer.
+     * Element.attributes accessor, installed by ElementWrapper.
      */
-    static DOMNamedNodeMap* Unwrap(v8::Local<v8::Object> obj);
-    
+    static void AttributesGetter(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+    /**
+     * Unwrap a V8 object to get the map state.
+     */
+    static AttributeMap* Unwrap(v8::Local<v8::Object> obj);
+
     /**
      * Install the NamedNodeMap template (called once per isolate).
      */
     static void InstallTemplate(v8::Isolate* isolate);
-    
+
     /**
      * Get the cached NamedNodeMap template.
      */
     static v8::Local<v8::FunctionTemplate> GetTemplate(v8::Isolate* isolate);
-    
+
     /**
      * Template cache index.
      */
-    static constexpr int kTemplateIndex = 15;
-    
+    static constexpr int kTemplateIndex = WrapperTraits<NamedNodeMapWrapper>::kTemplateIndex;
+
+    /**
+     * Type tag stored in the wrapper's type internal field.
+     */
+    static const WrapperTypeInfo kTypeInfo;
+
+    /**
+     * Register this wrapper's callbacks for snapshot serialization.
+     */
+    static void RegisterExternalReferences(ExternalReferenceRegistry* registry);
+
 private:
-    // Property getters/setters and methods will be added here
-    // TODO: Parse dom.h to auto-generate these declarations
+    // Prototype members, installed by InstallTemplate()
+    static const PropertyDescriptor kProperties[];
+
+    // Readonly properties
+    static void LengthGetter(v8::Local<v8::Name> property,
+                             const v8::PropertyCallbackInfo<v8::Value>& info);
+
+    // Methods
+    static void Item(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void GetNamedItem(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void GetNamedItemNS(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+    // Non-standard extensions
+    static void NamesAndValues(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+    // Indexed property handler
+    static v8::Intercepted IndexedPropertyGetter(uint32_t index,
+                                                 const v8::PropertyCallbackInfo<v8::Value>& info);
 };
 
 } // namespace v8_dom
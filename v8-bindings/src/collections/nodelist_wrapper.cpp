@@ -3,61 +3,77 @@
 #include "../core/template_cache.h"
 #include "../core/utilities.h"
 #include "../nodes/node_wrapper.h"
+#include "listiterator_wrapper.h"
 
 namespace v8_dom {
 
-v8::Local<v8::Object> NodeListWrapper::Wrap(v8::Isolate* isolate,
-                                              v8::Local<v8::Context> context,
-                                              DOMNodeList* obj) {
-    if (!obj) {
-        return v8::Local<v8::Object>();
+const WrapperTypeInfo NodeListWrapper::kTypeInfo = {"NodeList", nullptr};
+
+NodeListSnapshot::NodeListSnapshot(DOMNodeList* list) {
+    if (!list) {
+        return;
     }
     
-    // Check wrapper cache first
-    WrapperCache* cache = WrapperCache::ForIsolate(isolate);
-    if (cache->Has(obj)) {
-        return cache->Get(isolate, obj);
+    // Copy all results in one call; the C list is not needed after this.
+    // Its pointers are borrowed, so reference them before releasing it
+    uint32_t count = dom_nodelist_static_get_length(list);
+    nodes.resize(count);
+    dom_nodelist_static_items(list, nodes.data(), count);
+    dom_node_addref_many(nodes.data(), count);
+    dom_nodelist_static_release(list);
+    if (count > 0) {
+        document = dom_node_get_ownerdocument(nodes[0]);
+        dom_document_addref(document);
+    }
+}
+
+NodeListSnapshot::~NodeListSnapshot() {
+    dom_node_release_many(nodes.data(), nodes.size());
+    if (document) {
+        dom_document_release(document);
     }
+}
+
+v8::Local<v8::Object> NodeListWrapper::Wrap(v8::Isolate* isolate,
+                                              v8::Local<v8::Context> context,
+                                              DOMNodeList* obj) {
+    NodeListSnapshot* snapshot = new NodeListSnapshot(obj);
     
-    // Create new wrapper
+    // Create new wrapper ([NewObject], so no cache lookup)
     v8::EscapableHandleScope handle_scope(isolate);
-    v8::Local<v8::FunctionTemplate> tmpl = GetTemplate(isolate);
-    v8::Local<v8::Function> constructor = tmpl->GetFunction(context).ToLocalChecked();
+    v8::Local<v8::Function> constructor =
+        TemplateCache::ForIsolate(isolate)->GetConstructor(context, kTemplateIndex, GetTemplate);
     v8::Local<v8::Object> wrapper = constructor->NewInstance(context).ToLocalChecked();
     
-    // Store C pointer in internal field
-    wrapper->SetInternalField(0, v8::External::New(isolate, obj));
-    
-    // NOTE: Static NodeLists (from querySelectorAll) don't have addref
-    // They're snapshots that need to be released when done
+    // Store snapshot pointer and type tag in internal fields
+    SetWrapperFields(wrapper, snapshot, &kTypeInfo);
     
     // Cache with release callback
-    cache->Set(isolate, obj, wrapper, [](void* ptr) {
-        dom_nodelist_static_release(static_cast<DOMNodeList*>(ptr));
+    WrapperCache::ForIsolate(isolate)->Set(isolate, snapshot, wrapper, [](void* ptr) {
+        delete static_cast<NodeListSnapshot*>(ptr);
     });
     
     return handle_scope.Escape(wrapper);
 }
 
-DOMNodeList* NodeListWrapper::Unwrap(v8::Local<v8::Object> obj) {
-    if (obj.IsEmpty() || obj->InternalFieldCount() < 1) {
-        return nullptr;
-    }
-    
-    v8::Local<v8::Value> ptr = obj->GetInternalField(0).As<v8::Value>();
-    if (!ptr->IsExternal()) {
-        return nullptr;
-    }
-    
-    return static_cast<DOMNodeList*>(v8::Local<v8::External>::Cast(ptr)->Value());
+NodeListSnapshot* NodeListWrapper::Unwrap(v8::Local<v8::Object> obj) {
+    return static_cast<NodeListSnapshot*>(UnwrapObject(obj, &kTypeInfo));
 }
 
+const PropertyDescriptor NodeListWrapper::kProperties[] = {
+    // Readonly properties
+    DataProperty("length", LengthGetter),
+
+    // Methods
+    MethodProperty("item", Item),
+};
+
 void NodeListWrapper::InstallTemplate(v8::Isolate* isolate) {
     v8::Local<v8::FunctionTemplate> tmpl = v8::FunctionTemplate::New(isolate);
     tmpl->SetClassName(v8::String::NewFromUtf8Literal(isolate, "NodeList"));
     
     v8::Local<v8::ObjectTemplate> instance = tmpl->InstanceTemplate();
-    instance->SetInternalFieldCount(1);
+    instance->SetInternalFieldCount(kWrapperFieldCount);
     
     // Enable indexed property access (list[0], list[1], etc.)
     // Use explicit constructor with 5 params
@@ -70,17 +86,11 @@ void NodeListWrapper::InstallTemplate(v8::Isolate* isolate) {
     );
     instance->SetHandler(handler_config);
 
-    // Get prototype template for adding properties/methods
-    v8::Local<v8::ObjectTemplate> proto = tmpl->PrototypeTemplate();
-    
-    // Readonly properties
-    proto->SetNativeDataProperty(v8::String::NewFromUtf8Literal(isolate, "length"),
-                                 LengthGetter);
-    
-    // Methods
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "item"),
-              v8::FunctionTemplate::New(isolate, Item));
-    
+    InstallProperties(isolate, tmpl, kProperties);
+
+    // Iterable<Node>: native keys, values, entries, forEach and Symbol.iterator
+    ListIteratorWrapper::InstallIterable(isolate, tmpl, true);
+
     // Cache the template
     TemplateCache* cache = TemplateCache::ForIsolate(isolate);
     cache->Set(kTemplateIndex, tmpl);
@@ -96,12 +106,18 @@ v8::Local<v8::FunctionTemplate> NodeListWrapper::GetTemplate(v8::Isolate* isolat
     return cache->Get(kTemplateIndex);
 }
 
+void NodeListWrapper::RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+    RegisterProperties(registry, kProperties);
+    registry->Register(IndexedPropertyGetter);
+}
+
 // ===== Property Getters =====
 
 void NodeListWrapper::LengthGetter(v8::Local<v8::Name> property,
                                   const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("NodeListWrapper::LengthGetter");
     v8::Isolate* isolate = info.GetIsolate();
-    DOMNodeList* list = Unwrap(info.This().As<v8::Object>());
+    NodeListSnapshot* list = Unwrap(info.This().As<v8::Object>());
     
     if (!list) {
         isolate->ThrowException(v8::Exception::TypeError(
@@ -109,20 +125,19 @@ void NodeListWrapper::LengthGetter(v8::Local<v8::Name> property,
         return;
     }
     
-    uint32_t length = dom_nodelist_static_get_length(list);
-    info.GetReturnValue().Set(v8::Integer::NewFromUnsigned(isolate, length));
+    uint32_t length = static_cast<uint32_t>(list->nodes.size());
+    info.GetReturnValue().Set(length);
 }
 
 // ===== Methods =====
 
 void NodeListWrapper::Item(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("NodeListWrapper::Item");
     v8::Isolate* isolate = args.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     
-    DOMNodeList* list = Unwrap(args.This().As<v8::Object>());
+    NodeListSnapshot* list = UnwrapReceiver<NodeListSnapshot>(args);
     if (!list) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid NodeList object")));
         return;
     }
     
@@ -140,16 +155,13 @@ void NodeListWrapper::Item(const v8::FunctionCallbackInfo<v8::Value>& args) {
     }
     uint32_t index = maybeIndex.ToChecked();
     
-    // Call C-ABI to get node at index
-    DOMNode* node = dom_nodelist_static_item(list, index);
-    
-    if (!node) {
+    if (index >= list->nodes.size()) {
         args.GetReturnValue().SetNull();
         return;
     }
     
     // Wrap and return the node
-    v8::Local<v8::Object> wrapper = NodeWrapper::Wrap(isolate, context, node);
+    v8::Local<v8::Object> wrapper = NodeWrapper::Wrap(isolate, context, list->nodes[index]);
     args.GetReturnValue().Set(wrapper);
 }
 
@@ -160,20 +172,17 @@ v8::Intercepted NodeListWrapper::IndexedPropertyGetter(uint32_t index,
     v8::Isolate* isolate = info.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     
-    DOMNodeList* list = Unwrap(info.This().As<v8::Object>());
+    NodeListSnapshot* list = Unwrap(info.This().As<v8::Object>());
     if (!list) {
         return v8::Intercepted::kNo;  // Property does not exist
     }
     
-    // Call C-ABI to get node at index
-    DOMNode* node = dom_nodelist_static_item(list, index);
-    
-    if (!node) {
+    if (index >= list->nodes.size()) {
         return v8::Intercepted::kNo;  // Index out of bounds
     }
     
     // Wrap and return the node
-    v8::Local<v8::Object> wrapper = NodeWrapper::Wrap(isolate, context, node);
+    v8::Local<v8::Object> wrapper = NodeWrapper::Wrap(isolate, context, list->nodes[index]);
     info.GetReturnValue().Set(wrapper);
     return v8::Intercepted::kYes;  // Property intercepted successfully
 }
@@ -9,24 +9,51 @@
 #define V8_DOM_NODELIST_WRAPPER_H
 
 #include <v8.h>
+#include <vector>
+#include "../core/wrapper_traits.h"
+#include "../core/external_references.h"
+#include "../core/property_table.h"
 #include "dom.h"
 
 namespace v8_dom {
 
+/**
+ * Node pointers of a static NodeList, copied out when the wrapper is
+ * created so length, item() and iteration never cross the C-ABI. The
+ * snapshot references its nodes and their document from construction to
+ * destruction, so they outlive removal from the tree (and DisposeDocument)
+ * while the list is reachable.
+ */
+struct NodeListSnapshot {
+    /**
+     * Copy and reference the nodes of list (NULL: empty), then release
+     * the C list.
+     */
+    explicit NodeListSnapshot(DOMNodeList* list);
+    ~NodeListSnapshot();
+    
+    NodeListSnapshot(const NodeListSnapshot&) = delete;
+    NodeListSnapshot& operator=(const NodeListSnapshot&) = delete;
+    
+    std::vector<DOMNode*> nodes;  // addref'd (dom_node_addref_many)
+    DOMDocument* document = nullptr;  // addref'd; nullptr for an empty list
+};
+
 class NodeListWrapper {
 public:
     /**
-     * Wrap a C DOMNodeList pointer in a V8 object.
-     * Uses wrapper cache for identity preservation.
+     * Wrap a static C DOMNodeList (querySelectorAll result) in a V8 object.
+     * All node pointers are copied and referenced in one call each, and
+     * the C list is released right away. NULL wraps as an empty list.
      */
     static v8::Local<v8::Object> Wrap(v8::Isolate* isolate,
                                       v8::Local<v8::Context> context,
                                       DOMNodeList* obj);
     
     /**
-     * Unwrap a V8 object to get the C DOMNodeList pointer.
+     * Unwrap a V8 object to get its copied nodes.
      */
-    static DOMNodeList* Unwrap(v8::Local<v8::Object> obj);
+    static NodeListSnapshot* Unwrap(v8::Local<v8::Object> obj);
     
     /**
      * Install the NodeList template (called once per isolate).
@@ -41,9 +68,22 @@ public:
     /**
      * Template cache index.
      */
-    static constexpr int kTemplateIndex = 13;
+    static constexpr int kTemplateIndex = WrapperTraits<NodeListWrapper>::kTemplateIndex;
+    
+    /**
+     * Type tag stored in the wrapper's type internal field.
+     */
+    static const WrapperTypeInfo kTypeInfo;
+    
+    /**
+     * Register this wrapper's callbacks for snapshot serialization.
+     */
+    static void RegisterExternalReferences(ExternalReferenceRegistry* registry);
     
 private:
+    // Prototype members, installed by InstallTemplate()
+    static const PropertyDescriptor kProperties[];
+    
     // Readonly properties
     static void LengthGetter(v8::Local<v8::Name> property,
                             const v8::PropertyCallbackInfo<v8::Value>& info);
@@ -0,0 +1,45 @@
+#include "atom_table.h"
+#include "binding_state.h"
+
+namespace v8_dom {
+
+constexpr size_t AtomTable::kMaxAtoms;
+
+AtomTable::~AtomTable() {
+    // Global<> handles clean themselves up
+    atoms_.clear();
+}
+
+v8::Local<v8::String> AtomTable::Get(v8::Isolate* isolate, const DOMStringView& view) {
+    auto it = atoms_.find(view.data);
+    if (it != atoms_.end()) {
+        hits_++;
+        return it->second.Get(isolate);
+    }
+
+    misses_++;
+    v8::Local<v8::String> atom =
+        NewStringFromView(isolate, view, v8::NewStringType::kInternalized).ToLocalChecked();
+
+    if (atoms_.size() < kMaxAtoms) {
+        atoms_.emplace(view.data, v8::Global<v8::String>(isolate, atom));
+    }
+    return atom;
+}
+
+v8::Local<v8::String> NameViewToV8String(v8::Isolate* isolate,
+                                         const DOMStringView& view,
+                                         DOMNode* node) {
+    if (!view.is_interned) {
+        return StringViewToV8String(isolate, view, node);
+    }
+
+    BindingState* state = BindingState::ForIsolate(isolate);
+    DOMDocument* owner = dom_node_get_ownerdocument(node);
+    if (owner != state->Document()) {
+        return state->Strings()->Get(isolate, view, owner);
+    }
+    return state->Atoms()->Get(isolate, view);
+}
+
+} // namespace v8_dom
@@ -0,0 +1,69 @@
+/**
+ * Atom Table - Internalized V8 strings for interned DOM names
+ *
+ * Tag names and attribute names come from a small vocabulary interned in
+ * the document's string pool. The atom table maps each pool pointer to an
+ * internalized v8::String, so repeated reads return the same string object
+ * (cheap === and property-key use) and allocate nothing.
+ *
+ * Atoms are only taken from the isolate's own document (BindingState),
+ * whose pool lives exactly as long as the table; strings from other
+ * documents go through the StringCache instead, since their pool pointers
+ * may be reused once those documents are destroyed.
+ */
+
+#ifndef V8_DOM_ATOM_TABLE_H
+#define V8_DOM_ATOM_TABLE_H
+
+#include <v8.h>
+#include <cstdint>
+#include <unordered_map>
+#include "dom.h"
+
+namespace v8_dom {
+
+class AtomTable {
+public:
+    AtomTable() = default;
+    ~AtomTable();
+
+    /**
+     * Get the atom for an interned view, creating it on first use.
+     * The view must be interned in the isolate's document.
+     */
+    v8::Local<v8::String> Get(v8::Isolate* isolate, const DOMStringView& view);
+
+    /**
+     * Statistics
+     */
+    size_t Size() const { return atoms_.size(); }
+    uint64_t Hits() const { return hits_; }
+    uint64_t Misses() const { return misses_; }
+
+private:
+    // Non-copyable, non-movable
+    AtomTable(const AtomTable&) = delete;
+    AtomTable& operator=(const AtomTable&) = delete;
+
+    // Past this many atoms, new names are internalized but not retained
+    static constexpr size_t kMaxAtoms = 4096;
+
+    std::unordered_map<const char*, v8::Global<v8::String>> atoms_;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+};
+
+/**
+ * Convert a DOM name (tag or attribute name) to a V8 string, using the
+ * atom table when the name is interned in the isolate's document and the
+ * StringCache otherwise.
+ *
+ * @param node Node the name was read from
+ */
+v8::Local<v8::String> NameViewToV8String(v8::Isolate* isolate,
+                                         const DOMStringView& view,
+                                         DOMNode* node);
+
+} // namespace v8_dom
+
+#endif // V8_DOM_ATOM_TABLE_H
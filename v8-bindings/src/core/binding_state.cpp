@@ -0,0 +1,144 @@
+#include "binding_state.h"
+#include "template_cache.h"
+#include "../wrapper_cache.h"
+
+namespace v8_dom {
+
+const int BindingState::kIsolateSlot;
+
+namespace {
+
+void PrepareDocument(DOMDocument* document) {
+    // Scripts poll getElementsByClassName() collections; answer them
+    // from the class index instead of walking the tree per access
+    dom_document_enable_class_index(document);
+    // Script-side sorting by compareDocumentPosition() compares the same
+    // nodes over and over; number the tree once instead of walking it
+    dom_document_enable_document_order_index(document);
+}
+
+} // namespace
+
+BindingState::~BindingState() {
+    // Compiled selectors were made in the document's cache
+    selectors_.Clear();
+    if (closest_memo_) {
+        dom_closestmemo_release(closest_memo_);
+        closest_memo_ = nullptr;
+    }
+    
+    if (document_) {
+        dom_document_release(document_);
+        document_ = nullptr;
+    }
+    for (DOMDocument* doc : patch_documents_) {
+        dom_document_release(doc);
+    }
+    SetSharedNames(nullptr);
+}
+
+BindingState* BindingState::ForIsolate(v8::Isolate* isolate) {
+    // Try to get existing state from isolate data
+    if (BindingState* state = TryForIsolate(isolate)) {
+        return state;
+    }
+    
+    // Create new state and store in isolate
+    BindingState* state = new BindingState();
+    isolate->SetData(kIsolateSlot, state);
+    return state;
+}
+
+BindingState* BindingState::TryForIsolate(v8::Isolate* isolate) {
+    return static_cast<BindingState*>(isolate->GetData(kIsolateSlot));
+}
+
+void BindingState::Dispose(v8::Isolate* isolate) {
+    // Wrappers first: they hold references into the document's tree
+    WrapperCache::Dispose(isolate);
+    TemplateCache::Dispose(isolate);
+    
+    BindingState* state = TryForIsolate(isolate);
+    if (state && !state->patch_documents_.empty()) {
+        isolate->RemoveMicrotasksCompletedCallback(DrainPatchesCallback, state);
+    }
+    delete state;
+    isolate->SetData(kIsolateSlot, nullptr);
+}
+
+void BindingState::DrainPatchesAtTaskBoundaries(v8::Isolate* isolate, DOMDocument* doc) {
+    for (DOMDocument* registered : patch_documents_) {
+        if (registered == doc) {
+            return;
+        }
+    }
+    if (patch_documents_.empty()) {
+        isolate->AddMicrotasksCompletedCallback(DrainPatchesCallback, this);
+    }
+    dom_document_addref(doc);
+    patch_documents_.push_back(doc);
+}
+
+size_t BindingState::DrainSubmittedPatches() {
+    size_t drained = 0;
+    for (DOMDocument* doc : patch_documents_) {
+        // One atomic load per document when nothing was submitted
+        drained += dom_document_drain_patches(doc, nullptr);
+    }
+    return drained;
+}
+
+void BindingState::DrainPatchesCallback(v8::Isolate*, void* data) {
+    static_cast<BindingState*>(data)->DrainSubmittedPatches();
+}
+
+void BindingState::EnterListener(DOMEvent* event) {
+    listener_depth_++;
+    if (!closest_memo_) {
+        // Without a memo closest() just matches every ancestor
+        closest_memo_ = dom_closestmemo_new();
+    } else if (event != memo_event_) {
+        dom_closestmemo_clear(closest_memo_);
+    }
+    memo_event_ = event;
+}
+
+DOMDocument* BindingState::Document() {
+    // Create document on first access
+    if (!document_) {
+        document_ = NewDocument();
+        PrepareDocument(document_);
+    }
+    return document_;
+}
+
+void BindingState::SetSharedNames(DOMSharedNames* shared) {
+    // Reference the new pool first, in case it is the current one
+    if (shared) {
+        dom_sharednames_acquire(shared);
+    }
+    if (shared_names_) {
+        dom_sharednames_release(shared_names_);
+    }
+    shared_names_ = shared;
+}
+
+DOMDocument* BindingState::NewDocument() {
+    if (shared_names_) {
+        if (DOMDocument* doc = dom_document_new_with_sharednames(shared_names_)) {
+            return doc;
+        }
+    }
+    return dom_document_new();
+}
+
+bool BindingState::AdoptDocument(DOMDocument* doc) {
+    if (document_) {
+        return false;
+    }
+    document_ = doc;
+    PrepareDocument(document_);
+    return true;
+}
+
+} // namespace v8_dom
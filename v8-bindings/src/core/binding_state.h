@@ -0,0 +1,195 @@
+/**
+ * Binding State - Per-isolate state of the DOM bindings
+ * 
+ * Everything the bindings keep for an isolate hangs off isolate data:
+ * the WrapperCache (slot 0), the TemplateCache (slot 1) and this
+ * BindingState (slot 2), which owns the isolate's document, its
+ * StringCache of external strings, its AtomTable of name strings, its
+ * DatasetNames, its CompiledSelectorCache, its MutationObserverQueue, its
+ * BindingStats, its ExceptionStrings, its PropertyKeys, the closest()
+ * memo of the event being dispatched and the documents whose submitted
+ * patches it drains.
+ * 
+ * Thread confinement: nothing here is shared between isolates and nothing
+ * is locked. State is only touched on the thread currently entered in its
+ * isolate (V8 already requires that, with v8::Locker when an isolate moves
+ * between threads), so N isolates can run in parallel on N threads.
+ */
+
+#ifndef V8_DOM_BINDING_STATE_H
+#define V8_DOM_BINDING_STATE_H
+
+#include <v8.h>
+#include <vector>
+#include "atom_table.h"
+#include "dataset_names.h"
+#include "string_cache.h"
+#include "selector_cache.h"
+#include "binding_stats.h"
+#include "domexception_wrapper.h"
+#include "property_keys.h"
+#include "features.h"
+#if V8_DOM_ENABLE_OBSERVERS
+#include "../observers/mutation_observer_queue.h"
+#endif
+#include "dom.h"
+
+namespace v8_dom {
+
+class BindingState {
+public:
+    /**
+     * Get the BindingState for a given isolate.
+     * Creates one if it doesn't exist.
+     */
+    static BindingState* ForIsolate(v8::Isolate* isolate);
+    
+    /**
+     * Get the BindingState if the bindings are installed, nullptr otherwise.
+     */
+    static BindingState* TryForIsolate(v8::Isolate* isolate);
+    
+    /**
+     * Release the document and delete all per-isolate binding state
+     * (wrapper cache, template cache and this object).
+     */
+    static void Dispose(v8::Isolate* isolate);
+    
+    /**
+     * Get the isolate's document, creating it on first use.
+     */
+    DOMDocument* Document();
+    
+    /**
+     * Make doc the isolate's document, taking over the caller's reference.
+     * Returns false, leaving doc with the caller, if the isolate's document
+     * was already created.
+     */
+    bool AdoptDocument(DOMDocument* doc);
+    
+    /**
+     * Make shared the name pool of the documents created for this isolate
+     * from now on (the global document, CreateDocument()), taking a
+     * reference; nullptr stops using one.
+     */
+    void SetSharedNames(DOMSharedNames* shared);
+    
+    /**
+     * Create a document for this isolate (with its shared names, if any).
+     */
+    DOMDocument* NewDocument();
+    
+    /**
+     * Get the isolate's cache of external strings for interned DOM strings.
+     */
+    StringCache* Strings() { return &strings_; }
+    
+    /**
+     * Get the isolate's atom table of internalized name strings.
+     */
+    AtomTable* Atoms() { return &atoms_; }
+    
+    /**
+     * Get the isolate's memoized dataset property names.
+     */
+    DatasetNames* DataNames() { return &dataset_names_; }
+    
+    /**
+     * Get the isolate's cache of compiled selectors.
+     */
+    CompiledSelectorCache* Selectors() { return &selectors_; }
+    
+#if V8_DOM_ENABLE_OBSERVERS
+    /**
+     * Get the isolate's pending mutation observers and delivery microtask.
+     */
+    MutationObserverQueue* MutationObservers() { return &mutation_observers_; }
+#endif
+    
+    /**
+     * Get the isolate's binding counters (only counted with V8_DOM_STATS).
+     */
+    BindingStats* Stats() { return &stats_; }
+    
+    /**
+     * Get the isolate's DOMException names and messages.
+     */
+    ExceptionStrings* Exceptions() { return &exception_strings_; }
+    
+    /**
+     * Get the isolate's internalized init dictionary member names.
+     */
+    PropertyKeys* Keys() { return &property_keys_; }
+    
+    /**
+     * Note that a script listener starts running for event. A listener of
+     * another event than the last one starts a new dispatch, which clears
+     * the closest() memo.
+     */
+    void EnterListener(DOMEvent* event);
+    
+    /**
+     * Note that the script listener entered last has returned.
+     */
+    void ExitListener() { listener_depth_--; }
+    
+    /**
+     * Get the closest() memo shared by the listeners of the current
+     * dispatch, or nullptr outside listeners.
+     */
+    DOMClosestMemo* DispatchClosestMemo() {
+        return listener_depth_ > 0 ? closest_memo_ : nullptr;
+    }
+    
+    /**
+     * Drain doc's submitted patches after every microtask checkpoint,
+     * taking a reference to doc. Registering a document twice does nothing.
+     */
+    void DrainPatchesAtTaskBoundaries(v8::Isolate* isolate, DOMDocument* doc);
+    
+    /**
+     * Apply the submitted patches of every registered document.
+     * Returns the number of patches applied.
+     */
+    size_t DrainSubmittedPatches();
+    
+private:
+    BindingState() = default;
+    ~BindingState();
+    
+    // Non-copyable, non-movable
+    BindingState(const BindingState&) = delete;
+    BindingState& operator=(const BindingState&) = delete;
+    
+    DOMDocument* document_ = nullptr;
+    DOMSharedNames* shared_names_ = nullptr;   // referenced
+    StringCache strings_;
+    AtomTable atoms_;
+    DatasetNames dataset_names_;
+    CompiledSelectorCache selectors_;
+#if V8_DOM_ENABLE_OBSERVERS
+    MutationObserverQueue mutation_observers_;
+#endif
+    BindingStats stats_;
+    ExceptionStrings exception_strings_;
+    PropertyKeys property_keys_;
+    
+    // Delegated handlers call closest() per listener per event; answers
+    // are kept across the listeners of one dispatch (see closestmemo.zig)
+    DOMClosestMemo* closest_memo_ = nullptr;   // owned
+    DOMEvent* memo_event_ = nullptr;
+    int listener_depth_ = 0;
+    
+    // Documents drained at task boundaries (referenced); the microtasks
+    // completed callback is registered while this is not empty
+    std::vector<DOMDocument*> patch_documents_;
+    
+    static void DrainPatchesCallback(v8::Isolate* isolate, void* data);
+    
+    // Isolate data slot (after WrapperCache and TemplateCache)
+    static const int kIsolateSlot = 2;
+};
+
+} // namespace v8_dom
+
+#endif // V8_DOM_BINDING_STATE_H
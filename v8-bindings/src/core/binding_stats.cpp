@@ -0,0 +1,51 @@
+#include "binding_stats.h"
+#include "binding_state.h"
+
+namespace v8_dom {
+
+void BindingStats::AddForType(const WrapperTypeInfo* type, TypeCounter counter) {
+    if (!type) {
+        return;
+    }
+
+    // Open addressing by pointer; slots are claimed once and never freed
+    size_t start = (reinterpret_cast<uintptr_t>(type) >> 4) % kMaxInterfaces;
+    for (size_t n = 0; n < kMaxInterfaces; n++) {
+        TypeSlot& slot = types_[(start + n) % kMaxInterfaces];
+        const WrapperTypeInfo* current = slot.type.load(std::memory_order_acquire);
+        if (!current) {
+            // Only the isolate's thread claims slots; readers see the type
+            // before any count for it
+            slot.type.store(type, std::memory_order_release);
+            current = type;
+        }
+        if (current == type) {
+            slot.counters[counter].fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+}
+
+#if V8_DOM_STATS
+
+void CountStat(v8::Isolate* isolate, BindingStats::Counter counter, uint64_t n) {
+    if (!isolate) {
+        isolate = v8::Isolate::GetCurrent();
+    }
+    if (BindingState* state = isolate ? BindingState::TryForIsolate(isolate) : nullptr) {
+        state->Stats()->Add(counter, n);
+    }
+}
+
+void CountTypeStat(v8::Isolate* isolate, const WrapperTypeInfo* type, BindingStats::TypeCounter counter) {
+    if (!isolate) {
+        isolate = v8::Isolate::GetCurrent();
+    }
+    if (BindingState* state = isolate ? BindingState::TryForIsolate(isolate) : nullptr) {
+        state->Stats()->AddForType(type, counter);
+    }
+}
+
+#endif
+
+} // namespace v8_dom
@@ -0,0 +1,111 @@
+/**
+ * Binding Stats - Optional per-isolate counters of binding activity
+ *
+ * Compiled in with V8_DOM_STATS=1 (make STATS=1). Without it every
+ * V8_DOM_COUNT / V8_DOM_COUNT_TYPE site expands to nothing, arguments
+ * included, so the counters cost nothing in regular builds.
+ *
+ * Counters are relaxed atomics owned by the isolate's BindingState. They
+ * are only incremented on the thread entered in the isolate, but may be
+ * read from any thread (e.g. a metrics scraper) through v8_dom::GetStats().
+ *
+ * Per-interface counters are kept in a fixed table keyed by the wrapper's
+ * WrapperTypeInfo; interfaces beyond kMaxInterfaces share no slot and only
+ * show up in the totals.
+ */
+
+#ifndef V8_DOM_BINDING_STATS_H
+#define V8_DOM_BINDING_STATS_H
+
+#include <v8.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#ifndef V8_DOM_STATS
+#define V8_DOM_STATS 0
+#endif
+
+namespace v8_dom {
+
+struct WrapperTypeInfo;
+
+class BindingStats {
+public:
+    enum Counter {
+        kWrapperCacheHits,
+        kWrapperCacheMisses,
+        kWrappersCreated,
+        kWrappersCollected,
+        kTemplateInstalls,
+        kStringConversions,   // DOM -> V8 copies and V8 -> DOM arguments
+        kStringBytesCopied,
+        kCounterCount,
+    };
+
+    enum TypeCounter {
+        kTypeWrappersCreated,
+        kTypeWrappersCollected,
+        kTypeCalls,  // Unwraps as this interface (one per C-ABI call family use)
+        kTypeCounterCount,
+    };
+
+    static constexpr size_t kMaxInterfaces = 64;
+
+    void Add(Counter counter, uint64_t n) {
+        counters_[counter].fetch_add(n, std::memory_order_relaxed);
+    }
+
+    uint64_t Get(Counter counter) const {
+        return counters_[counter].load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Count an event for an interface, claiming its table slot on first use.
+     */
+    void AddForType(const WrapperTypeInfo* type, TypeCounter counter);
+
+    /**
+     * Interface of table slot i (nullptr if unused) and its counters.
+     */
+    const WrapperTypeInfo* TypeAt(size_t i) const {
+        return types_[i].type.load(std::memory_order_acquire);
+    }
+    uint64_t GetForType(size_t i, TypeCounter counter) const {
+        return types_[i].counters[counter].load(std::memory_order_relaxed);
+    }
+
+private:
+    struct TypeSlot {
+        std::atomic<const WrapperTypeInfo*> type{nullptr};
+        std::atomic<uint64_t> counters[kTypeCounterCount] = {};
+    };
+
+    std::atomic<uint64_t> counters_[kCounterCount] = {};
+    TypeSlot types_[kMaxInterfaces];
+};
+
+#if V8_DOM_STATS
+
+/**
+ * Count into the isolate's stats (out of line, so headers that count do
+ * not depend on BindingState). A null isolate means the current one.
+ */
+void CountStat(v8::Isolate* isolate, BindingStats::Counter counter, uint64_t n);
+void CountTypeStat(v8::Isolate* isolate, const WrapperTypeInfo* type, BindingStats::TypeCounter counter);
+
+#define V8_DOM_COUNT(isolate, counter, n) \
+    ::v8_dom::CountStat((isolate), ::v8_dom::BindingStats::counter, (n))
+#define V8_DOM_COUNT_TYPE(isolate, type, counter) \
+    ::v8_dom::CountTypeStat((isolate), (type), ::v8_dom::BindingStats::counter)
+
+#else
+
+#define V8_DOM_COUNT(isolate, counter, n) ((void)0)
+#define V8_DOM_COUNT_TYPE(isolate, type, counter) ((void)0)
+
+#endif
+
+} // namespace v8_dom
+
+#endif // V8_DOM_BINDING_STATS_H
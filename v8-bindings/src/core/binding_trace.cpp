@@ -0,0 +1,19 @@
+#include "binding_trace.h"
+#include <chrono>
+
+namespace v8_dom {
+
+uint64_t TraceScope::Now() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void TraceScope::Emit(const char* name, uint64_t start_ns) {
+    uint64_t end_ns = Now();
+    TraceCallback callback = g_trace_config.callback.load(std::memory_order_acquire);
+    if (callback) {
+        callback(name, start_ns, end_ns, g_trace_config.user_data.load(std::memory_order_relaxed));
+    }
+}
+
+} // namespace v8_dom
@@ -0,0 +1,90 @@
+/**
+ * Binding Trace - Optional sampled timing of binding callbacks
+ *
+ * Compiled in with V8_DOM_TRACE=1 (make TRACE=1). Every V8 callback of
+ * the wrappers opens a V8_DOM_TRACE_SCOPE named after it; without the
+ * flag the macro expands to nothing.
+ *
+ * With the flag, a scope costs one relaxed load while no trace callback
+ * is registered (v8_dom::SetTraceCallback). Once one is, every Nth scope
+ * per thread is timed and reported with steady-clock start and end
+ * timestamps, which an embedder can forward as Perfetto or Chrome trace
+ * complete events. A callback's span covers the argument conversion, the
+ * dom_* calls and the result conversion; the gap between nested or
+ * consecutive spans is time spent in V8.
+ */
+
+#ifndef V8_DOM_BINDING_TRACE_H
+#define V8_DOM_BINDING_TRACE_H
+
+#include <atomic>
+#include <cstdint>
+
+#ifndef V8_DOM_TRACE
+#define V8_DOM_TRACE 0
+#endif
+
+namespace v8_dom {
+
+/**
+ * Receives one sampled binding callback (same type as declared in
+ * v8_dom.h, see SetTraceCallback()).
+ */
+using TraceCallback = void (*)(const char* name, uint64_t start_ns, uint64_t end_ns, void* user_data);
+
+struct TraceConfig {
+    std::atomic<TraceCallback> callback{nullptr};
+    std::atomic<void*> user_data{nullptr};
+    std::atomic<uint32_t> sample_every{1};
+};
+
+// Process-wide; constant-initialized, so reading it needs no guard
+inline TraceConfig g_trace_config;
+
+/**
+ * Times its own lifetime if sampled. Nested scopes are timed
+ * independently.
+ */
+class TraceScope {
+public:
+    explicit TraceScope(const char* name) {
+        if (!g_trace_config.callback.load(std::memory_order_relaxed)) {
+            return;
+        }
+        if (++calls_since_sample_ < g_trace_config.sample_every.load(std::memory_order_relaxed)) {
+            return;
+        }
+        calls_since_sample_ = 0;
+        name_ = name;
+        start_ns_ = Now();
+    }
+
+    ~TraceScope() {
+        if (name_) {
+            Emit(name_, start_ns_);
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+    static uint64_t Now();
+
+private:
+    static void Emit(const char* name, uint64_t start_ns);
+
+    static inline thread_local uint32_t calls_since_sample_ = 0;
+
+    const char* name_ = nullptr;
+    uint64_t start_ns_ = 0;
+};
+
+#if V8_DOM_TRACE
+#define V8_DOM_TRACE_SCOPE(name) ::v8_dom::TraceScope v8_dom_trace_scope_(name)
+#else
+#define V8_DOM_TRACE_SCOPE(name) ((void)0)
+#endif
+
+} // namespace v8_dom
+
+#endif // V8_DOM_BINDING_TRACE_H
@@ -0,0 +1,151 @@
+#include "call_recorder.h"
+#include <iterator>
+
+namespace v8_dom {
+
+namespace {
+
+// Buffered trace bytes written to the file at once
+constexpr size_t kFlushBytes = 1 << 20;
+
+void AppendChunk(const char* data, uint32_t length, void* user_data) {
+    static_cast<std::string*>(user_data)->append(data, length);
+}
+
+} // namespace
+
+CallRecorder::CallRecorder(DOMDocument* document, FILE* file)
+    : document_(document), file_(file) {
+    out_.reserve(kFlushBytes);
+    nodes_.push_back(nullptr);  // Id 0 is null
+    Assign(reinterpret_cast<DOMNode*>(document));
+
+    out_.insert(out_.end(), std::begin(call_trace::kMagic), std::end(call_trace::kMagic));
+    call_trace::PutVarint(&out_, call_trace::kVersion);
+    Snapshot();
+}
+
+CallRecorder::~CallRecorder() {
+    // nodes_[0] is the null id
+    dom_node_release_many(nodes_.data() + 1, nodes_.size() - 1);
+}
+
+bool CallRecorder::Start(DOMDocument* document, const char* path) {
+    if (active_ || !document || !path) {
+        return false;
+    }
+    FILE* file = std::fopen(path, "wb");
+    if (!file) {
+        return false;
+    }
+    active_ = new CallRecorder(document, file);
+    return true;
+}
+
+uint64_t CallRecorder::Stop() {
+    CallRecorder* recorder = active_;
+    if (!recorder) {
+        return 0;
+    }
+    active_ = nullptr;
+    recorder->Flush();
+    std::fclose(recorder->file_);
+    uint64_t records = recorder->records_;
+    delete recorder;
+    return records;
+}
+
+void CallRecorder::Put(const TraceResult& operand) {
+    call_trace::PutVarint(&out_, operand.node ? Assign(operand.node) : call_trace::kNullNode);
+}
+
+void CallRecorder::Put(std::string_view string) {
+    auto [it, inserted] = strings_.try_emplace(std::string(string), uint32_t(strings_.size() + 1));
+    if (!inserted) {
+        call_trace::PutVarint(&out_, it->second);
+        return;
+    }
+    call_trace::PutVarint(&out_, 0);
+    call_trace::PutVarint(&out_, string.size());
+    call_trace::PutBytes(&out_, string);
+}
+
+uint32_t CallRecorder::Assign(DOMNode* node) {
+    // Each entry of nodes_ owns a reference
+    dom_node_addref(node);
+    uint32_t id = uint32_t(nodes_.size());
+    nodes_.push_back(node);
+    ids_[node] = id;
+    return id;
+}
+
+uint32_t CallRecorder::IdOf(DOMNode* node) {
+    if (!node) {
+        return call_trace::kNullNode;
+    }
+    auto it = ids_.find(node);
+    if (it != ids_.end()) {
+        return it->second;
+    }
+
+    // Walk up to the nearest node with an id, noting child indices
+    path_.clear();
+    DOMNode* current = node;
+    uint32_t anchor = call_trace::kNullNode;
+    while (anchor == call_trace::kNullNode) {
+        DOMNode* parent = dom_node_get_parentnode(current);
+        if (!parent) {
+            return call_trace::kNullNode;  // Detached from everything the trace knows
+        }
+        uint32_t index = 0;
+        for (DOMNode* sibling = dom_node_get_previoussibling(current); sibling;
+             sibling = dom_node_get_previoussibling(sibling)) {
+            index++;
+        }
+        path_.push_back(index);
+        auto found = ids_.find(parent);
+        if (found != ids_.end()) {
+            anchor = found->second;
+        }
+        current = parent;
+    }
+
+    uint32_t id = Assign(node);
+    out_.push_back(static_cast<uint8_t>(call_trace::Op::kLocate));
+    call_trace::PutVarint(&out_, id);
+    call_trace::PutVarint(&out_, anchor);
+    call_trace::PutVarint(&out_, path_.size());
+    for (auto index = path_.rbegin(); index != path_.rend(); ++index) {
+        call_trace::PutVarint(&out_, *index);
+    }
+    Finish();
+    return id;
+}
+
+void CallRecorder::Snapshot() {
+    std::string markup;
+    dom_node_serialize(reinterpret_cast<DOMNode*>(document_), DOM_SERIALIZE_CHILDREN_ONLY,
+                       AppendChunk, &markup);
+    if (markup.empty()) {
+        return;
+    }
+    out_.push_back(static_cast<uint8_t>(call_trace::Op::kSnapshot));
+    Put(std::string_view(markup));
+    Finish();
+}
+
+void CallRecorder::Finish() {
+    records_++;
+    if (out_.size() >= kFlushBytes) {
+        Flush();
+    }
+}
+
+void CallRecorder::Flush() {
+    if (!out_.empty()) {
+        std::fwrite(out_.data(), 1, out_.size(), file_);
+        out_.clear();
+    }
+}
+
+} // namespace v8_dom
@@ -0,0 +1,148 @@
+/**
+ * Call Recorder - Optional log of the dom_* calls made by script
+ *
+ * Compiled in with V8_DOM_RECORD=1 (make RECORD=1). The wrappers note the
+ * C-ABI calls that shape a workload (node creation, tree mutation,
+ * attributes, queries, text) with V8_DOM_RECORD_CALL; without the flag
+ * the macro expands to nothing. Calls returning a node are recorded after
+ * they return, calls moving nodes before they run (while the nodes are
+ * still where the trace can locate them). Fast API variants are not
+ * installed in these builds, so no call bypasses its record.
+ *
+ * With the flag, a call costs one thread-local load while nothing is
+ * recording. v8_dom::StartCallRecording() starts a recorder on the
+ * calling thread, which appends each call to a binary trace
+ * (call_trace_format.h) with node handles mapped to stable ids and
+ * repeated strings interned; bench/trace_replay re-executes the trace
+ * against the DOM library alone.
+ *
+ * The recorder holds a reference to every node it gave an id until it
+ * stops, so a freed node's address cannot come back under a stale id.
+ */
+
+#ifndef V8_DOM_CALL_RECORDER_H
+#define V8_DOM_CALL_RECORDER_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "call_trace_format.h"
+#include "dom.h"
+
+#ifndef V8_DOM_RECORD
+#define V8_DOM_RECORD 0
+#endif
+
+namespace v8_dom {
+
+/**
+ * A node operand: resolved to the node's id, introducing it with a
+ * kLocate record if the trace has not seen it yet.
+ */
+struct TraceNode {
+    explicit TraceNode(const void* node) : node(static_cast<DOMNode*>(const_cast<void*>(node))) {}
+    DOMNode* node;
+    mutable uint32_t id = 0;
+};
+
+/**
+ * A node a call returned: gets the next id.
+ */
+struct TraceResult {
+    explicit TraceResult(const void* node) : node(static_cast<DOMNode*>(const_cast<void*>(node))) {}
+    DOMNode* node;
+};
+
+class CallRecorder {
+public:
+    /**
+     * The recorder of the calling thread, or nullptr.
+     */
+    static CallRecorder* Active() { return active_; }
+
+    /**
+     * Start recording this thread's calls against document to path,
+     * beginning with a snapshot of the document's children. Returns false
+     * if the file cannot be created or a recording is already running.
+     */
+    static bool Start(DOMDocument* document, const char* path);
+
+    /**
+     * Finish the trace and close its file.
+     * Returns the number of records written (0 if nothing was recording).
+     */
+    static uint64_t Stop();
+
+    /**
+     * Append one record (operands as listed for op in call_trace_format.h).
+     */
+    template <typename... Operands>
+    void Record(call_trace::Op op, const Operands&... operands) {
+        (Resolve(operands), ...);
+        out_.push_back(static_cast<uint8_t>(op));
+        (Put(operands), ...);
+        Finish();
+    }
+
+    CallRecorder(const CallRecorder&) = delete;
+    CallRecorder& operator=(const CallRecorder&) = delete;
+
+private:
+    CallRecorder(DOMDocument* document, FILE* file);
+    ~CallRecorder();
+
+    template <typename T>
+    void Resolve(const T&) {}
+    void Resolve(const TraceNode& operand) { operand.id = IdOf(operand.node); }
+
+    void Put(const TraceNode& operand) { call_trace::PutVarint(&out_, operand.id); }
+    void Put(const TraceResult& operand);
+    void Put(std::string_view string);
+    void Put(const char* string) { Put(std::string_view(string ? string : "")); }
+    void Put(uint32_t value) { call_trace::PutVarint(&out_, value); }
+
+    // Sized strings of the bindings (StringArgFromV8)
+    template <typename T>
+    auto Put(const T& string) -> decltype(string.data(), string.length(), void()) {
+        Put(std::string_view(string.data(), string.length()));
+    }
+
+    uint32_t IdOf(DOMNode* node);
+    uint32_t Assign(DOMNode* node);
+    void Snapshot();
+    void Finish();
+    void Flush();
+
+    static inline thread_local CallRecorder* active_ = nullptr;
+
+    DOMDocument* document_;
+    FILE* file_;
+    std::vector<uint8_t> out_;
+    uint64_t records_ = 0;
+
+    // Referenced nodes by id; ids index the trace's nodes from 1 (the document)
+    std::unordered_map<DOMNode*, uint32_t> ids_;
+    std::vector<DOMNode*> nodes_;
+    std::unordered_map<std::string, uint32_t> strings_;
+
+    // Child indices of the node being located, innermost first
+    std::vector<uint32_t> path_;
+};
+
+#if V8_DOM_RECORD
+#define V8_DOM_RECORD_CALL(op, ...)                                                    \
+    do {                                                                               \
+        if (::v8_dom::CallRecorder* v8_dom_recorder_ = ::v8_dom::CallRecorder::Active()) { \
+            v8_dom_recorder_->Record(::v8_dom::call_trace::Op::op, __VA_ARGS__);       \
+        }                                                                              \
+    } while (0)
+#else
+#define V8_DOM_RECORD_CALL(op, ...) ((void)0)
+#endif
+
+} // namespace v8_dom
+
+#endif // V8_DOM_CALL_RECORDER_H
@@ -0,0 +1,212 @@
+/**
+ * Call Trace Format - Binary log of the dom_* calls made by script
+ *
+ * Written by the call recorder (call_recorder.h, make RECORD=1) and read
+ * by the replay driver (bench/trace_replay.cpp), which re-executes it
+ * against the DOM library without V8. This header only depends on the
+ * standard library so the driver can include it on its own.
+ *
+ * ## Layout
+ *
+ * A trace starts with the 8 magic bytes "V8DOMTRC" and a varint format
+ * version, followed by records. Each record is one op byte and the
+ * operands listed for it below. All integers are unsigned LEB128
+ * varints.
+ *
+ * - node: id of a node. 0 is null (or a node the recorder could not
+ *   locate); 1 is the recorded document. A call whose receiver or node
+ *   argument is 0 is skipped by replay.
+ * - result: id handed to the node a call returned, or 0 for null. Ids of
+ *   results are assigned in increasing order, so a trace never refers to
+ *   an id before the record that introduced it.
+ * - string: 0 followed by a length and that many UTF-8 bytes defines the
+ *   next string id (from 1, per trace); any other value repeats that
+ *   string. Tag names, attribute names and selectors thus cost one byte
+ *   after their first use.
+ * - uint: a plain count or flag.
+ *
+ * Nodes script reaches without a recorded call returning them (through
+ * firstChild, children, an event target, ...) are introduced by a kLocate
+ * record on first use: the child index path from the nearest node the
+ * trace already knows.
+ */
+
+#ifndef V8_DOM_CALL_TRACE_FORMAT_H
+#define V8_DOM_CALL_TRACE_FORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace v8_dom {
+namespace call_trace {
+
+inline constexpr char kMagic[8] = {'V', '8', 'D', 'O', 'M', 'T', 'R', 'C'};
+inline constexpr uint32_t kVersion = 1;
+
+/**
+ * Node ids with a fixed meaning.
+ */
+inline constexpr uint32_t kNullNode = 0;
+inline constexpr uint32_t kDocumentNode = 1;
+
+/**
+ * Record types and their operands.
+ */
+enum class Op : uint8_t {
+    // Tree state
+    kSnapshot = 0,           // string markup: children of the document when recording started
+    kLocate,                 // result, node anchor, uint depth, uint index...
+
+    // Create
+    kCreateElement,          // node document, string local name, result
+    kCreateTextNode,         // node document, string data, result
+    kCreateComment,          // node document, string data, result
+    kCloneNode,              // node, uint deep, result
+
+    // Tree
+    kAppendChild,            // node parent, node child
+    kInsertBefore,           // node parent, node child, node reference (0: append)
+    kRemoveChild,            // node parent, node child
+    kReplaceChild,           // node parent, node new child, node old child
+
+    // Attribute
+    kSetAttribute,           // node element, string name, string value
+    kGetAttribute,           // node element, string name
+    kRemoveAttribute,        // node element, string name
+    kHasAttribute,           // node element, string name
+
+    // Query
+    kGetElementById,         // node document, string id, result
+    kQuerySelector,          // node scope, string selectors, result
+    kQuerySelectorAll,       // node scope, string selectors, uint matches
+    kMatches,                // node element, string selectors
+    kClosest,                // node element, string selectors, result
+
+    // Text
+    kSetTextContent,         // node, string text
+    kSetData,                // node character data, string data
+
+    kCount,
+};
+
+/**
+ * Groups of ops timed together by replay.
+ */
+enum class Family : uint8_t {
+    kState,
+    kCreate,
+    kTree,
+    kAttribute,
+    kQuery,
+    kText,
+    kCount,
+};
+
+inline constexpr const char* kFamilyNames[static_cast<size_t>(Family::kCount)] = {
+    "state", "create", "tree", "attribute", "query", "text",
+};
+
+inline constexpr Family FamilyOf(Op op) {
+    switch (op) {
+        case Op::kSnapshot:
+        case Op::kLocate:
+            return Family::kState;
+        case Op::kCreateElement:
+        case Op::kCreateTextNode:
+        case Op::kCreateComment:
+        case Op::kCloneNode:
+            return Family::kCreate;
+        case Op::kAppendChild:
+        case Op::kInsertBefore:
+        case Op::kRemoveChild:
+        case Op::kReplaceChild:
+            return Family::kTree;
+        case Op::kSetAttribute:
+        case Op::kGetAttribute:
+        case Op::kRemoveAttribute:
+        case Op::kHasAttribute:
+            return Family::kAttribute;
+        case Op::kGetElementById:
+        case Op::kQuerySelector:
+        case Op::kQuerySelectorAll:
+        case Op::kMatches:
+        case Op::kClosest:
+            return Family::kQuery;
+        case Op::kSetTextContent:
+        case Op::kSetData:
+        case Op::kCount:
+            break;
+    }
+    return Family::kText;
+}
+
+/**
+ * Appends varints and raw bytes to a growing buffer.
+ */
+inline void PutVarint(std::vector<uint8_t>* out, uint64_t value) {
+    while (value >= 0x80) {
+        out->push_back(static_cast<uint8_t>(value) | 0x80);
+        value >>= 7;
+    }
+    out->push_back(static_cast<uint8_t>(value));
+}
+
+inline void PutBytes(std::vector<uint8_t>* out, std::string_view bytes) {
+    out->insert(out->end(), bytes.begin(), bytes.end());
+}
+
+/**
+ * Reads a trace buffer front to back. A read past the end (a truncated
+ * trace) returns zeros and sets failed().
+ */
+class Reader {
+public:
+    Reader(const uint8_t* data, size_t size) : pos_(data), end_(data + size) {}
+
+    bool AtEnd() const { return pos_ == end_; }
+    bool failed() const { return failed_; }
+
+    uint8_t Byte() {
+        if (pos_ == end_) {
+            failed_ = true;
+            return 0;
+        }
+        return *pos_++;
+    }
+
+    uint64_t Varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t byte = Byte();
+            value |= uint64_t(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                return value;
+            }
+        }
+        failed_ = true;
+        return value;
+    }
+
+    std::string_view Bytes(size_t length) {
+        if (size_t(end_ - pos_) < length) {
+            failed_ = true;
+            pos_ = end_;
+            return {};
+        }
+        std::string_view bytes(reinterpret_cast<const char*>(pos_), length);
+        pos_ += length;
+        return bytes;
+    }
+
+private:
+    const uint8_t* pos_;
+    const uint8_t* end_;
+    bool failed_ = false;
+};
+
+} // namespace call_trace
+} // namespace v8_dom
+
+#endif // V8_DOM_CALL_TRACE_FORMAT_H
@@ -0,0 +1,82 @@
+#include "dataset_names.h"
+#include "utilities.h"
+
+namespace v8_dom {
+
+constexpr size_t DatasetNames::kMaxEntries;
+
+namespace {
+
+constexpr std::string_view kDataPrefix = "data-";
+
+bool IsAsciiLower(char c) { return c >= 'a' && c <= 'z'; }
+bool IsAsciiUpper(char c) { return c >= 'A' && c <= 'Z'; }
+
+} // namespace
+
+bool DatasetNames::ToAttribute(std::string_view property, std::string* attribute) {
+    attribute->assign(kDataPrefix);
+    for (size_t i = 0; i < property.size(); i++) {
+        char c = property[i];
+        if (c == '-' && i + 1 < property.size() && IsAsciiLower(property[i + 1])) {
+            attribute->clear();
+            return false;
+        }
+        if (IsAsciiUpper(c)) {
+            attribute->push_back('-');
+            attribute->push_back(static_cast<char>(c - 'A' + 'a'));
+        } else {
+            attribute->push_back(c);
+        }
+    }
+    return true;
+}
+
+bool DatasetNames::ToProperty(std::string_view attribute, std::string* property) {
+    if (attribute.substr(0, kDataPrefix.size()) != kDataPrefix) {
+        return false;
+    }
+    property->clear();
+    for (size_t i = kDataPrefix.size(); i < attribute.size(); i++) {
+        char c = attribute[i];
+        if (IsAsciiUpper(c)) {
+            return false;
+        }
+        if (c == '-' && i + 1 < attribute.size() && IsAsciiLower(attribute[i + 1])) {
+            property->push_back(static_cast<char>(attribute[++i] - 'a' + 'A'));
+        } else {
+            property->push_back(c);
+        }
+    }
+    return true;
+}
+
+const DatasetNames::Entry* DatasetNames::Get(v8::Isolate* isolate,
+                                             v8::Local<v8::String> property,
+                                             DOMDocument* document) {
+    int hash = property->GetIdentityHash();
+    auto range = entries_.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second.property == property) {
+            return &it->second;
+        }
+    }
+
+    Entry* entry = &overflow_;
+    if (entries_.size() < kMaxEntries) {
+        entry = &entries_.emplace(hash, Entry())->second;
+    }
+    Fill(isolate, property, document, entry);
+    return entry;
+}
+
+void DatasetNames::Fill(v8::Isolate* isolate, v8::Local<v8::String> property,
+                        DOMDocument* document, Entry* entry) {
+    entry->property.Reset(isolate, property);
+    entry->atom = nullptr;
+    if (ToAttribute(V8StringToStdString(isolate, property), &entry->attribute)) {
+        entry->atom = dom_document_intern_name(document, entry->attribute.data(), entry->attribute.size());
+    }
+}
+
+} // namespace v8_dom
@@ -0,0 +1,80 @@
+/**
+ * Dataset Names - Memoized dataset property to data-* attribute names
+ *
+ * element.dataset.fooBar reads the attribute data-foo-bar. Scripts use a
+ * handful of such names over and over, so each property name is converted
+ * once per isolate and kept here, keyed by the internalized V8 string V8
+ * passes to the interceptors (found by its identity hash, compared by
+ * identity). For the isolate's document an entry also holds the attribute
+ * name interned in its pool, so the attribute lookup compares names by
+ * pointer instead of hashing or copying them.
+ */
+
+#ifndef V8_DOM_DATASET_NAMES_H
+#define V8_DOM_DATASET_NAMES_H
+
+#include <v8.h>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "dom.h"
+
+namespace v8_dom {
+
+class DatasetNames {
+public:
+    /**
+     * A dataset property name and its attribute.
+     */
+    struct Entry {
+        v8::Global<v8::String> property;
+        std::string attribute;    // "data-" + name, empty if not a valid name
+        DOMAtom atom = nullptr;   // attribute interned in document, if any
+    };
+
+    DatasetNames() = default;
+
+    /**
+     * Get the entry for a property name, converting it on first use.
+     * document is the isolate's document (atoms are only taken from it).
+     * The entry is valid until the next call.
+     */
+    const Entry* Get(v8::Isolate* isolate, v8::Local<v8::String> property, DOMDocument* document);
+
+    /**
+     * The data-* attribute of a dataset property name ("fooBar" gives
+     * "data-foo-bar"), or false if the name has a '-' followed by an ASCII
+     * lowercase letter, which no attribute converts to.
+     */
+    static bool ToAttribute(std::string_view property, std::string* attribute);
+
+    /**
+     * The dataset property name of an attribute ("data-foo-bar" gives
+     * "fooBar"), or false if it is not a data-* name without ASCII
+     * uppercase letters.
+     */
+    static bool ToProperty(std::string_view attribute, std::string* property);
+
+    /**
+     * Statistics
+     */
+    size_t Size() const { return entries_.size(); }
+
+private:
+    // Non-copyable, non-movable
+    DatasetNames(const DatasetNames&) = delete;
+    DatasetNames& operator=(const DatasetNames&) = delete;
+
+    // Past this many names, new ones are converted on every access
+    static constexpr size_t kMaxEntries = 1024;
+
+    void Fill(v8::Isolate* isolate, v8::Local<v8::String> property, DOMDocument* document, Entry* entry);
+
+    std::unordered_multimap<int, Entry> entries_;
+    Entry overflow_;
+};
+
+} // namespace v8_dom
+
+#endif // V8_DOM_DATASET_NAMES_H
@@ -0,0 +1,257 @@
+#include "domexception_wrapper.h"
+#include <cstring>
+#include "binding_state.h"
+#include "template_cache.h"
+#include "binding_trace.h"
+#include "dom.h"
+
+namespace v8_dom {
+
+const WrapperTypeInfo DOMExceptionWrapper::kTypeInfo = {"DOMException", nullptr};
+
+namespace {
+
+// The error names with a legacy code (WebIDL error names table); the C-ABI
+// error codes are these codes, except UnknownError
+struct LegacyName {
+    const char* name;
+    uint16_t code;
+};
+
+constexpr LegacyName kLegacyNames[] = {
+    {"IndexSizeError", 1},
+    {"HierarchyRequestError", 3},
+    {"WrongDocumentError", 4},
+    {"InvalidCharacterError", 5},
+    {"NoModificationAllowedError", 7},
+    {"NotFoundError", 8},
+    {"NotSupportedError", 9},
+    {"InUseAttributeError", 10},
+    {"InvalidStateError", 11},
+    {"SyntaxError", 12},
+    {"InvalidModificationError", 13},
+    {"NamespaceError", 14},
+    {"InvalidAccessError", 15},
+    {"TypeMismatchError", 17},
+    {"SecurityError", 18},
+    {"NetworkError", 19},
+    {"AbortError", 20},
+    {"URLMismatchError", 21},
+    {"QuotaExceededError", 22},
+    {"TimeoutError", 23},
+    {"InvalidNodeTypeError", 24},
+    {"DataCloneError", 25},
+};
+
+// UnknownError has no legacy code
+constexpr int32_t kUnknownErrorCode = 999;
+
+bool IsLegacyCode(int32_t error_code) {
+    for (const LegacyName& entry : kLegacyNames) {
+        if (entry.code == error_code) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint16_t LegacyCodeOf(v8::Isolate* isolate, v8::Local<v8::String> name) {
+    v8::String::Utf8Value utf8(isolate, name);
+    if (!*utf8) {
+        return 0;
+    }
+    for (const LegacyName& entry : kLegacyNames) {
+        if (std::strcmp(entry.name, *utf8) == 0) {
+            return entry.code;
+        }
+    }
+    return 0;
+}
+
+v8::Local<v8::String> Internalized(v8::Isolate* isolate, const char* str) {
+    return v8::String::NewFromUtf8(isolate, str, v8::NewStringType::kInternalized).ToLocalChecked();
+}
+
+constexpr ConstantDescriptor kDOMExceptionConstants[] = {
+    {"INDEX_SIZE_ERR", 1},
+    {"DOMSTRING_SIZE_ERR", 2},
+    {"HIERARCHY_REQUEST_ERR", 3},
+    {"WRONG_DOCUMENT_ERR", 4},
+    {"INVALID_CHARACTER_ERR", 5},
+    {"NO_DATA_ALLOWED_ERR", 6},
+    {"NO_MODIFICATION_ALLOWED_ERR", 7},
+    {"NOT_FOUND_ERR", 8},
+    {"NOT_SUPPORTED_ERR", 9},
+    {"INUSE_ATTRIBUTE_ERR", 10},
+    {"INVALID_STATE_ERR", 11},
+    {"SYNTAX_ERR", 12},
+    {"INVALID_MODIFICATION_ERR", 13},
+    {"NAMESPACE_ERR", 14},
+    {"INVALID_ACCESS_ERR", 15},
+    {"VALIDATION_ERR", 16},
+    {"TYPE_MISMATCH_ERR", 17},
+    {"SECURITY_ERR", 18},
+    {"NETWORK_ERR", 19},
+    {"ABORT_ERR", 20},
+    {"URL_MISMATCH_ERR", 21},
+    {"QUOTA_EXCEEDED_ERR", 22},
+    {"TIMEOUT_ERR", 23},
+    {"INVALID_NODE_TYPE_ERR", 24},
+    {"DATA_CLONE_ERR", 25},
+};
+
+} // namespace
+
+// ============================================================================
+// ExceptionStrings
+// ============================================================================
+
+int ExceptionStrings::SlotOf(int32_t error_code) {
+    return IsLegacyCode(error_code) ? error_code : 0;
+}
+
+v8::Local<v8::String> ExceptionStrings::Name(v8::Isolate* isolate, int32_t error_code) {
+    int slot = SlotOf(error_code);
+    if (names_[slot].IsEmpty()) {
+        names_[slot].Reset(isolate, Internalized(isolate, dom_error_code_name(slot ? slot : kUnknownErrorCode)));
+    }
+    return names_[slot].Get(isolate);
+}
+
+v8::Local<v8::String> ExceptionStrings::Message(v8::Isolate* isolate, int32_t error_code) {
+    int slot = SlotOf(error_code);
+    if (messages_[slot].IsEmpty()) {
+        messages_[slot].Reset(isolate, Internalized(isolate, dom_error_code_message(slot ? slot : kUnknownErrorCode)));
+    }
+    return messages_[slot].Get(isolate);
+}
+
+// ============================================================================
+// DOMExceptionWrapper
+// ============================================================================
+
+const PropertyDescriptor DOMExceptionWrapper::kProperties[] = {
+    AccessorProperty("name", NameGetter, nullptr, kReceiverCheck | kNoSideEffect),
+    AccessorProperty("message", MessageGetter, nullptr, kReceiverCheck | kNoSideEffect),
+    AccessorProperty("code", CodeGetter, nullptr, kReceiverCheck | kNoSideEffect),
+};
+
+void DOMExceptionWrapper::InstallTemplate(v8::Isolate* isolate) {
+    v8::Local<v8::FunctionTemplate> tmpl = v8::FunctionTemplate::New(isolate, Constructor);
+    tmpl->SetClassName(v8::String::NewFromUtf8Literal(isolate, "DOMException"));
+    tmpl->InstanceTemplate()->SetInternalFieldCount(kFieldCount);
+
+    // DOMException.prototype inherits from %Error.prototype%: inherit from a
+    // template whose prototype is that intrinsic
+    v8::Local<v8::FunctionTemplate> error = v8::FunctionTemplate::New(
+        isolate, nullptr, v8::Local<v8::Value>(), v8::Local<v8::Signature>(), 0,
+        v8::ConstructorBehavior::kThrow);
+    error->SetIntrinsicDataProperty(v8::String::NewFromUtf8Literal(isolate, "prototype"),
+                                    v8::kErrorPrototype);
+    tmpl->Inherit(error);
+
+    InstallConstants(isolate, tmpl, kDOMExceptionConstants);
+    InstallProperties(isolate, tmpl, kProperties);
+
+    // Cache the template
+    TemplateCache* cache = TemplateCache::ForIsolate(isolate);
+    cache->Set(kTemplateIndex, tmpl);
+}
+
+v8::Local<v8::FunctionTemplate> DOMExceptionWrapper::GetTemplate(v8::Isolate* isolate) {
+    TemplateCache* cache = TemplateCache::ForIsolate(isolate);
+
+    if (!cache->Has(kTemplateIndex)) {
+        InstallTemplate(isolate);
+    }
+
+    return cache->Get(kTemplateIndex);
+}
+
+void DOMExceptionWrapper::RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+    registry->Register(Constructor);
+    RegisterProperties(registry, kProperties);
+}
+
+void DOMExceptionWrapper::Initialize(v8::Isolate* isolate,
+                                     v8::Local<v8::Object> exception,
+                                     v8::Local<v8::String> name,
+                                     v8::Local<v8::String> message,
+                                     uint16_t code) {
+    SetWrapperFields(exception, nullptr, &kTypeInfo);
+    exception->SetInternalField(kNameField, name);
+    exception->SetInternalField(kMessageField, message);
+    exception->SetInternalField(kCodeField, v8::Integer::New(isolate, code));
+}
+
+v8::MaybeLocal<v8::Object> DOMExceptionWrapper::Create(v8::Isolate* isolate,
+                                                       v8::Local<v8::Context> context,
+                                                       int32_t error_code,
+                                                       v8::Local<v8::String> message) {
+    v8::EscapableHandleScope handle_scope(isolate);
+
+    // An instance of the template, without calling the constructor
+    v8::Local<v8::Object> exception;
+    if (!GetTemplate(isolate)->InstanceTemplate()->NewInstance(context).ToLocal(&exception)) {
+        return v8::MaybeLocal<v8::Object>();
+    }
+
+    ExceptionStrings* strings = BindingState::ForIsolate(isolate)->Exceptions();
+    Initialize(isolate, exception, strings->Name(isolate, error_code),
+               message.IsEmpty() ? strings->Message(isolate, error_code) : message,
+               IsLegacyCode(error_code) ? static_cast<uint16_t>(error_code) : 0);
+    return handle_scope.Escape(exception);
+}
+
+void DOMExceptionWrapper::Throw(v8::Isolate* isolate, int32_t error_code) {
+    v8::HandleScope handle_scope(isolate);
+    v8::Local<v8::Object> exception;
+    if (Create(isolate, isolate->GetCurrentContext(), error_code).ToLocal(&exception)) {
+        isolate->ThrowException(exception);
+    }
+}
+
+// ============================================================================
+// Constructor
+// ============================================================================
+
+void DOMExceptionWrapper::Constructor(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("DOMExceptionWrapper::Constructor");
+    v8::Isolate* isolate = args.GetIsolate();
+    if (!args.IsConstructCall()) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Failed to construct 'DOMException': Please use the 'new' operator")));
+        return;
+    }
+
+    // constructor(optional DOMString message = "", optional DOMString name = "Error")
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    v8::Local<v8::String> message = v8::String::Empty(isolate);
+    if (args.Length() > 0 && !args[0]->IsUndefined() && !args[0]->ToString(context).ToLocal(&message)) {
+        return;
+    }
+    v8::Local<v8::String> name = v8::String::NewFromUtf8Literal(isolate, "Error");
+    if (args.Length() > 1 && !args[1]->IsUndefined() && !args[1]->ToString(context).ToLocal(&name)) {
+        return;
+    }
+
+    Initialize(isolate, args.This(), name, message, LegacyCodeOf(isolate, name));
+}
+
+// ============================================================================
+// Property Implementations - Readonly
+// ============================================================================
+
+void DOMExceptionWrapper::NameGetter(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    args.GetReturnValue().Set(args.This()->GetInternalField(kNameField).As<v8::Value>());
+}
+
+void DOMExceptionWrapper::MessageGetter(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    args.GetReturnValue().Set(args.This()->GetInternalField(kMessageField).As<v8::Value>());
+}
+
+void DOMExceptionWrapper::CodeGetter(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    args.GetReturnValue().Set(args.This()->GetInternalField(kCodeField).As<v8::Value>());
+}
+
+} // namespace v8_dom
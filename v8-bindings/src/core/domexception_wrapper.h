@@ -0,0 +1,131 @@
+/**
+ * DOMException Wrapper - V8 bindings for DOMException
+ *
+ * Errors reported by the C-ABI (DOM_ERROR_* codes) are thrown as
+ * DOMException instances of one template. name, message and code are
+ * prototype accessors reading the instance's internal fields, so throwing
+ * allocates the exception object and nothing else: the name and default
+ * message of each error code are internalized once per isolate and kept
+ * in the isolate's ExceptionStrings. Like the object it replaces, a
+ * thrown exception does not capture a stack trace.
+ *
+ * As WebIDL requires, DOMException.prototype inherits from Error.prototype
+ * (through an intrinsic base template), and script can construct its own
+ * exceptions with new DOMException(message, name).
+ */
+
+#ifndef V8_DOM_DOMEXCEPTION_WRAPPER_H
+#define V8_DOM_DOMEXCEPTION_WRAPPER_H
+
+#include <v8.h>
+#include <cstdint>
+#include "wrapper_traits.h"
+#include "external_references.h"
+#include "property_table.h"
+
+namespace v8_dom {
+
+/**
+ * Per-isolate names and default messages of the C-ABI error codes,
+ * created on first use (owned by BindingState).
+ */
+class ExceptionStrings {
+public:
+    ExceptionStrings() = default;
+
+    /**
+     * The DOMException name of an error code ("UnknownError" for codes
+     * the C-ABI does not define).
+     */
+    v8::Local<v8::String> Name(v8::Isolate* isolate, int32_t error_code);
+
+    /**
+     * The default message of an error code.
+     */
+    v8::Local<v8::String> Message(v8::Isolate* isolate, int32_t error_code);
+
+private:
+    // Non-copyable, non-movable
+    ExceptionStrings(const ExceptionStrings&) = delete;
+    ExceptionStrings& operator=(const ExceptionStrings&) = delete;
+
+    // Slot per legacy code (1-25); slot 0 is UnknownError
+    static constexpr int kSlots = 26;
+    static int SlotOf(int32_t error_code);
+
+    v8::Global<v8::String> names_[kSlots];
+    v8::Global<v8::String> messages_[kSlots];
+};
+
+class DOMExceptionWrapper {
+public:
+    /**
+     * Create a DOMException for a C-ABI error code, with the code's
+     * default message or the given one.
+     * Returns an empty handle if an exception was thrown.
+     */
+    static v8::MaybeLocal<v8::Object> Create(v8::Isolate* isolate,
+                                             v8::Local<v8::Context> context,
+                                             int32_t error_code,
+                                             v8::Local<v8::String> message = v8::Local<v8::String>());
+
+    /**
+     * Throw a DOMException for a C-ABI error code (see ThrowDOMException).
+     */
+    static void Throw(v8::Isolate* isolate, int32_t error_code);
+
+    /**
+     * Install the DOMException template (called once per isolate).
+     */
+    static void InstallTemplate(v8::Isolate* isolate);
+
+    /**
+     * Get the cached DOMException template.
+     */
+    static v8::Local<v8::FunctionTemplate> GetTemplate(v8::Isolate* isolate);
+
+    /**
+     * Template cache index.
+     */
+    static constexpr int kTemplateIndex = WrapperTraits<DOMExceptionWrapper>::kTemplateIndex;
+
+    /**
+     * Type tag stored in the wrapper's type internal field.
+     */
+    static const WrapperTypeInfo kTypeInfo;
+
+    /**
+     * Register this wrapper's callbacks for snapshot serialization.
+     */
+    static void RegisterExternalReferences(ExternalReferenceRegistry* registry);
+
+private:
+    // Internal fields after the shared wrapper fields (no C object)
+    enum Field {
+        kNameField = kWrapperFieldCount,
+        kMessageField,
+        kCodeField,
+        kFieldCount,
+    };
+
+    // Prototype members, installed by InstallTemplate()
+    static const PropertyDescriptor kProperties[];
+
+    static void Initialize(v8::Isolate* isolate,
+                           v8::Local<v8::Object> exception,
+                           v8::Local<v8::String> name,
+                           v8::Local<v8::String> message,
+                           uint16_t code);
+
+    // Constructor
+    static void Constructor(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+    // Readonly properties
+    static void NameGetter(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void MessageGetter(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void CodeGetter(const v8::FunctionCallbackInfo<v8::Value>& args);
+};
+
+} // namespace v8_dom
+
+#endif // V8_DOM_DOMEXCEPTION_WRAPPER_H
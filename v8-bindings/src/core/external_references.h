@@ -0,0 +1,58 @@
+/**
+ * External References - Callback table for V8 startup snapshots
+ *
+ * A snapshot stores templates, but not the C++ callbacks they point to.
+ * V8 serializes each callback as an index into the external reference
+ * table, which must list the same addresses, in the same order, when the
+ * snapshot is created and when an isolate is booted from it.
+ *
+ * Every wrapper class with callbacks registers them in its
+ * RegisterExternalReferences(). When adding a getter, setter, method or
+ * interceptor, add it there too, or snapshot creation will fail.
+ */
+
+#ifndef V8_DOM_EXTERNAL_REFERENCES_H
+#define V8_DOM_EXTERNAL_REFERENCES_H
+
+#include <v8.h>
+#include <v8-fast-api-calls.h>
+#include <cstdint>
+#include <vector>
+
+namespace v8_dom {
+
+class ExternalReferenceRegistry {
+public:
+    /**
+     * Register a callback address.
+     */
+    template <typename F>
+    void Register(F* callback) {
+        references_.push_back(reinterpret_cast<intptr_t>(callback));
+    }
+
+    /**
+     * Register a Fast API function (its address and its type info).
+     */
+    void Register(const v8::CFunction& function) {
+        references_.push_back(reinterpret_cast<intptr_t>(function.GetAddress()));
+        references_.push_back(reinterpret_cast<intptr_t>(function.GetInfo()));
+    }
+
+    /**
+     * Get the null-terminated table for Isolate::CreateParams.
+     */
+    const intptr_t* Table() {
+        if (references_.empty() || references_.back() != 0) {
+            references_.push_back(0);
+        }
+        return references_.data();
+    }
+
+private:
+    std::vector<intptr_t> references_;
+};
+
+} // namespace v8_dom
+
+#endif // V8_DOM_EXTERNAL_REFERENCES_H
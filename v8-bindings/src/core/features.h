@@ -0,0 +1,49 @@
+/**
+ * Features - Interface families compiled into the bindings
+ *
+ * Every family is on by default. Building with V8_DOM_ENABLE_<FAMILY>=0
+ * (make <FAMILY>=0, or make CORE_ONLY=1 for all of them) leaves out its
+ * sources, its templates, its snapshot data and external references, its
+ * globals and the methods of core interfaces that return its objects, so
+ * an embedder that only needs Node, Element, Document and Text pays for
+ * nothing else at startup:
+ *
+ * - RANGES:    AbstractRange, Range, StaticRange (document.createRange,
+ *              document.createStaticRanges)
+ * - TRAVERSAL: NodeFilter, NodeIterator, TreeWalker and the non-standard
+ *              element iterator and sliced query (document.createTreeWalker,
+ *              createNodeIterator, querySelectorAllSliced, elements())
+ * - OBSERVERS: MutationObserver, MutationRecord and record batches
+ * - SHADOW:    ShadowRoot (attachShadow, shadowRoot, assignedSlot); shadow
+ *              roots the C-ABI creates anyway are wrapped as
+ *              DocumentFragment
+ * - ABORT:     AbortController, AbortSignal
+ *
+ * Template indices stay fixed, so a snapshot is only valid for the
+ * feature set it was created with.
+ */
+
+#ifndef V8_DOM_FEATURES_H
+#define V8_DOM_FEATURES_H
+
+#ifndef V8_DOM_ENABLE_RANGES
+#define V8_DOM_ENABLE_RANGES 1
+#endif
+
+#ifndef V8_DOM_ENABLE_TRAVERSAL
+#define V8_DOM_ENABLE_TRAVERSAL 1
+#endif
+
+#ifndef V8_DOM_ENABLE_OBSERVERS
+#define V8_DOM_ENABLE_OBSERVERS 1
+#endif
+
+#ifndef V8_DOM_ENABLE_SHADOW
+#define V8_DOM_ENABLE_SHADOW 1
+#endif
+
+#ifndef V8_DOM_ENABLE_ABORT
+#define V8_DOM_ENABLE_ABORT 1
+#endif
+
+#endif // V8_DOM_FEATURES_H
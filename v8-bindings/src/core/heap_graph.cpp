@@ -0,0 +1,194 @@
+#include "heap_graph.h"
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "dom.h"
+#include "wrapper_cache.h"
+#include "nodes/node_wrapper.h"
+
+namespace v8_dom {
+
+namespace {
+
+using GraphNode = v8::EmbedderGraph::Node;
+using Detachedness = GraphNode::Detachedness;
+
+/**
+ * A DOM node in the snapshot, merged into its wrapper if it has one.
+ */
+class DOMGraphNode final : public GraphNode {
+public:
+    DOMGraphNode(std::string name, size_t size, GraphNode* wrapper, Detachedness detachedness)
+        : name_(std::move(name)), size_(size), wrapper_(wrapper), detachedness_(detachedness) {}
+
+    const char* Name() override { return name_.c_str(); }
+    size_t SizeInBytes() override { return size_; }
+    GraphNode* WrapperNode() override { return wrapper_; }
+    Detachedness GetDetachedness() override { return detachedness_; }
+
+private:
+    std::string name_;
+    size_t size_;
+    GraphNode* wrapper_;
+    Detachedness detachedness_;
+};
+
+std::string NameOf(DOMNode* node) {
+    switch (dom_node_get_nodetype(node)) {
+        case DOM_ELEMENT_NODE:
+            return std::string("Element <") +
+                   dom_element_get_localname(reinterpret_cast<DOMElement*>(node)) + ">";
+        case DOM_ATTRIBUTE_NODE:
+            return "Attr";
+        case DOM_TEXT_NODE:
+            return "Text";
+        case DOM_CDATA_SECTION_NODE:
+            return "CDATASection";
+        case DOM_PROCESSING_INSTRUCTION_NODE:
+            return "ProcessingInstruction";
+        case DOM_COMMENT_NODE:
+            return "Comment";
+        case DOM_DOCUMENT_NODE:
+            return "Document";
+        case DOM_DOCUMENT_TYPE_NODE:
+            return "DocumentType";
+        case DOM_DOCUMENT_FRAGMENT_NODE:
+            return "DocumentFragment";
+        case DOM_SHADOW_ROOT_NODE:
+            return "ShadowRoot";
+    }
+    return "Node";
+}
+
+class GraphBuilder {
+public:
+    explicit GraphBuilder(v8::EmbedderGraph* graph) : graph_(graph) {}
+
+    void AddWrapper(v8::Local<v8::Object> wrapper) {
+        if (void* node = UnwrapObject(wrapper, &NodeWrapper::kTypeInfo)) {
+            wrappers_.emplace(static_cast<DOMNode*>(node), wrapper);
+        }
+    }
+
+    void Build() {
+        for (const auto& [node, wrapper] : wrappers_) {
+            Reach(node);
+        }
+    }
+
+private:
+    struct PendingNode {
+        DOMNode* node;
+        GraphNode* parent;
+    };
+
+    /**
+     * Walk the tree holding node unless it was walked already.
+     * Returns whether that tree is attached to its document.
+     */
+    Detachedness Reach(DOMNode* node) {
+        DOMNode* root = node;
+        while (DOMNode* parent = dom_node_get_parentnode(root)) {
+            root = parent;
+        }
+        auto found = roots_.find(root);
+        if (found != roots_.end()) {
+            return found->second;
+        }
+
+        Detachedness detachedness = Detachedness::kDetached;
+        GraphNode* host = nullptr;
+        uint16_t type = dom_node_get_nodetype(root);
+        if (type == DOM_DOCUMENT_NODE) {
+            detachedness = Detachedness::kAttached;
+        } else if (type == DOM_SHADOW_ROOT_NODE) {
+            DOMElement* host_element = dom_shadowroot_get_host(reinterpret_cast<DOMShadowRoot*>(root));
+            if (host_element) {
+                DOMNode* host_node = reinterpret_cast<DOMNode*>(host_element);
+                detachedness = Reach(host_node);
+                // Open shadow roots are walked with their host
+                found = roots_.find(root);
+                if (found != roots_.end()) {
+                    return found->second;
+                }
+                host = nodes_[host_node];
+            }
+        }
+        Walk(root, host, detachedness);
+        return detachedness;
+    }
+
+    void Walk(DOMNode* root, GraphNode* host, Detachedness detachedness) {
+        roots_[root] = detachedness;
+        pending_.push_back({root, host});
+        while (!pending_.empty()) {
+            PendingNode next = pending_.back();
+            pending_.pop_back();
+
+            GraphNode* graph_node = AddNode(next.node, detachedness);
+            uint16_t type = dom_node_get_nodetype(next.node);
+            if (next.parent) {
+                graph_->AddEdge(next.parent, graph_node,
+                                type == DOM_SHADOW_ROOT_NODE ? "shadowRoot" : "child");
+            }
+            for (DOMNode* child = dom_node_get_firstchild(next.node); child;
+                 child = dom_node_get_nextsibling(child)) {
+                pending_.push_back({child, graph_node});
+            }
+            if (type == DOM_ELEMENT_NODE) {
+                DOMShadowRoot* shadow = dom_element_get_shadowroot(reinterpret_cast<DOMElement*>(next.node));
+                if (shadow) {
+                    DOMNode* shadow_node = reinterpret_cast<DOMNode*>(shadow);
+                    roots_[shadow_node] = detachedness;
+                    pending_.push_back({shadow_node, graph_node});
+                }
+            }
+        }
+    }
+
+    /**
+     * The snapshot node of node, created with its ownerDocument edge.
+     */
+    GraphNode* AddNode(DOMNode* node, Detachedness detachedness) {
+        auto [it, inserted] = nodes_.try_emplace(node, nullptr);
+        if (!inserted) {
+            return it->second;  // A document reached through ownerDocument first
+        }
+
+        GraphNode* wrapper_node = nullptr;
+        auto wrapper = wrappers_.find(node);
+        if (wrapper != wrappers_.end()) {
+            v8::Local<v8::Value> value = wrapper->second;
+            wrapper_node = graph_->V8Node(value);
+        }
+        GraphNode* graph_node = graph_->AddNode(std::make_unique<DOMGraphNode>(
+            NameOf(node), dom_node_get_self_bytes(node), wrapper_node, detachedness));
+        it->second = graph_node;
+
+        if (DOMDocument* document = dom_node_get_ownerdocument(node)) {
+            graph_->AddEdge(graph_node, AddNode(reinterpret_cast<DOMNode*>(document), Detachedness::kAttached),
+                            "ownerDocument");
+        }
+        return graph_node;
+    }
+
+    v8::EmbedderGraph* graph_;
+    std::unordered_map<DOMNode*, v8::Local<v8::Object>> wrappers_;
+    std::unordered_map<DOMNode*, GraphNode*> nodes_;
+    std::unordered_map<DOMNode*, Detachedness> roots_;
+    std::vector<PendingNode> pending_;
+};
+
+} // namespace
+
+void BuildEmbedderGraph(v8::Isolate* isolate, v8::EmbedderGraph* graph, void* data) {
+    v8::HandleScope handle_scope(isolate);
+    GraphBuilder builder(graph);
+    static_cast<const WrapperCache*>(data)->ForEachWrapper(
+        isolate, [&](v8::Local<v8::Object> wrapper) { builder.AddWrapper(wrapper); });
+    builder.Build();
+}
+
+} // namespace v8_dom
@@ -0,0 +1,42 @@
+/**
+ * Heap Graph - DOM nodes in V8 heap snapshots
+ *
+ * A wrapper is a few words on the V8 heap; the node behind it, and the
+ * tree that node keeps alive, live in the Zig allocator where a heap
+ * snapshot cannot see them. BuildEmbedderGraph() adds them to the
+ * snapshot as embedder nodes:
+ *
+ * - every tree holding a wrapped node, walked from its root, with
+ *   parent -> child edges ("child") and open shadow roots under their
+ *   host ("shadowRoot")
+ * - an "ownerDocument" edge from each node, which holds its document
+ * - sizes from dom_node_get_self_bytes(), so a node's retained size in
+ *   the snapshot is what its subtree costs
+ * - trees not rooted in a document marked detached, so DevTools lists
+ *   them (and their cost) under "Detached"
+ *
+ * Wrapped nodes are merged into their wrapper, which then shows the
+ * node's name and size and retains its children. Parent pointers are
+ * weak in the DOM, so no child -> parent edge is reported.
+ *
+ * Each WrapperCache registers the builder for its isolate
+ * (HeapProfiler::AddBuildEmbedderGraphCallback) and removes it on
+ * Dispose. It only runs while a snapshot is taken.
+ */
+
+#ifndef V8_DOM_HEAP_GRAPH_H
+#define V8_DOM_HEAP_GRAPH_H
+
+#include <v8.h>
+
+namespace v8_dom {
+
+/**
+ * v8::HeapProfiler::BuildEmbedderGraphCallback; data is the isolate's
+ * WrapperCache.
+ */
+void BuildEmbedderGraph(v8::Isolate* isolate, v8::EmbedderGraph* graph, void* data);
+
+} // namespace v8_dom
+
+#endif // V8_DOM_HEAP_GRAPH_H
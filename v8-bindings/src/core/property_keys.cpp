@@ -0,0 +1,43 @@
+#include "property_keys.h"
+#include "binding_state.h"
+
+namespace v8_dom {
+
+namespace {
+
+// Indexed by PropertyKey
+constexpr const char* kNames[] = {
+    "bubbles",
+    "cancelable",
+    "composed",
+    "detail",
+};
+
+static_assert(sizeof(kNames) / sizeof(kNames[0]) == static_cast<size_t>(PropertyKey::kCount),
+              "one name per PropertyKey");
+
+} // namespace
+
+v8::Local<v8::String> PropertyKeys::Get(v8::Isolate* isolate, PropertyKey key) {
+    int slot = static_cast<int>(key);
+    if (keys_[slot].IsEmpty()) {
+        keys_[slot].Reset(isolate, v8::String::NewFromUtf8(
+            isolate, kNames[slot], v8::NewStringType::kInternalized).ToLocalChecked());
+    }
+    return keys_[slot].Get(isolate);
+}
+
+bool ReadBooleanMember(v8::Isolate* isolate,
+                       v8::Local<v8::Context> context,
+                       v8::Local<v8::Object> dict,
+                       PropertyKey key,
+                       bool* out) {
+    v8::Local<v8::Value> value;
+    if (!dict->Get(context, BindingState::ForIsolate(isolate)->Keys()->Get(isolate, key)).ToLocal(&value)) {
+        return false;
+    }
+    *out = !value->IsUndefined() && value->BooleanValue(isolate);
+    return true;
+}
+
+} // namespace v8_dom
@@ -0,0 +1,64 @@
+/**
+ * Property Keys - Internalized member names of init dictionaries
+ *
+ * Constructors read their init dictionaries (EventInit, CustomEventInit)
+ * one member at a time with Object::Get. Each member name is internalized
+ * once per isolate and kept here, so reading a dictionary creates no
+ * strings and every lookup uses the same key object, which V8's property
+ * caches compare by identity.
+ */
+
+#ifndef V8_DOM_PROPERTY_KEYS_H
+#define V8_DOM_PROPERTY_KEYS_H
+
+#include <v8.h>
+
+namespace v8_dom {
+
+/**
+ * Dictionary members with a cached key.
+ */
+enum class PropertyKey {
+    kBubbles,
+    kCancelable,
+    kComposed,
+    kDetail,
+    kCount,
+};
+
+/**
+ * Per-isolate keys of the PropertyKey members, created on first use
+ * (owned by BindingState).
+ */
+class PropertyKeys {
+public:
+    PropertyKeys() = default;
+
+    /**
+     * The internalized name of a member.
+     */
+    v8::Local<v8::String> Get(v8::Isolate* isolate, PropertyKey key);
+
+private:
+    // Non-copyable, non-movable
+    PropertyKeys(const PropertyKeys&) = delete;
+    PropertyKeys& operator=(const PropertyKeys&) = delete;
+
+    static constexpr int kSlots = static_cast<int>(PropertyKey::kCount);
+
+    v8::Global<v8::String> keys_[kSlots];
+};
+
+/**
+ * Read an optional boolean member of a dictionary (false when undefined).
+ * Returns false if the getter threw.
+ */
+bool ReadBooleanMember(v8::Isolate* isolate,
+                       v8::Local<v8::Context> context,
+                       v8::Local<v8::Object> dict,
+                       PropertyKey key,
+                       bool* out);
+
+} // namespace v8_dom
+
+#endif // V8_DOM_PROPERTY_KEYS_H
@@ -0,0 +1,127 @@
+#include "property_table.h"
+#include "call_recorder.h"
+
+namespace v8_dom {
+
+namespace {
+
+v8::Local<v8::String> InternalizedName(v8::Isolate* isolate, const char* name, uint32_t length) {
+    return v8::String::NewFromOneByte(isolate, reinterpret_cast<const uint8_t*>(name),
+                                      v8::NewStringType::kInternalized, static_cast<int>(length))
+        .ToLocalChecked();
+}
+
+v8::Local<v8::FunctionTemplate> NewFunction(v8::Isolate* isolate,
+                                            v8::FunctionCallback callback,
+                                            uint8_t flags,
+                                            int length,
+                                            v8::Local<v8::Signature> signature,
+                                            const v8::CFunction* fast) {
+#if V8_DOM_RECORD
+    // Every call must reach the recorded slow callback
+    fast = nullptr;
+#endif
+    v8::Local<v8::Signature> receiver =
+        (flags & kReceiverCheck) ? signature : v8::Local<v8::Signature>();
+    if (flags & kNoSideEffect) {
+        return v8::FunctionTemplate::New(isolate, callback, v8::Local<v8::Value>(), receiver,
+                                         length, v8::ConstructorBehavior::kThrow,
+                                         v8::SideEffectType::kHasNoSideEffect, fast);
+    }
+    return v8::FunctionTemplate::New(isolate, callback, v8::Local<v8::Value>(), receiver,
+                                     length, v8::ConstructorBehavior::kAllow,
+                                     v8::SideEffectType::kHasSideEffect, fast);
+}
+
+} // namespace
+
+void InstallProperties(v8::Isolate* isolate,
+                       v8::Local<v8::ObjectTemplate> proto,
+                       v8::Local<v8::Signature> signature,
+                       const PropertyDescriptor* table,
+                       size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        const PropertyDescriptor& property = table[i];
+        v8::Local<v8::String> name = InternalizedName(isolate, property.name, property.name_length);
+        v8::PropertyAttribute attributes = (property.flags & kDontEnum) ? v8::DontEnum : v8::None;
+
+        switch (property.kind) {
+            case PropertyDescriptor::Kind::kData:
+                proto->SetNativeDataProperty(name, property.data_getter, property.data_setter,
+                                             v8::Local<v8::Value>(), attributes);
+                break;
+            case PropertyDescriptor::Kind::kAccessor:
+                // The setter keeps the receiver check but always has side effects
+                proto->SetAccessorProperty(
+                    name,
+                    NewFunction(isolate, property.callback, property.flags, 0, signature, property.fast),
+                    property.setter
+                        ? NewFunction(isolate, property.setter, property.flags & kReceiverCheck, 0,
+                                      signature, nullptr)
+                        : v8::Local<v8::FunctionTemplate>(),
+                    attributes);
+                break;
+            case PropertyDescriptor::Kind::kMethod:
+                proto->Set(name,
+                           NewFunction(isolate, property.callback, property.flags, property.length,
+                                       signature, property.fast),
+                           attributes);
+                break;
+        }
+    }
+}
+
+void InstallProperties(v8::Isolate* isolate,
+                       v8::Local<v8::FunctionTemplate> tmpl,
+                       const PropertyDescriptor* table,
+                       size_t count) {
+    v8::Local<v8::Signature> signature;
+    for (size_t i = 0; i < count; i++) {
+        if (table[i].flags & kReceiverCheck) {
+            signature = v8::Signature::New(isolate, tmpl);
+            break;
+        }
+    }
+    InstallProperties(isolate, tmpl->PrototypeTemplate(), signature, table, count);
+}
+
+void InstallConstants(v8::Isolate* isolate,
+                      v8::Local<v8::FunctionTemplate> tmpl,
+                      const ConstantDescriptor* table,
+                      size_t count) {
+    v8::Local<v8::ObjectTemplate> proto = tmpl->PrototypeTemplate();
+    auto attributes = static_cast<v8::PropertyAttribute>(v8::ReadOnly | v8::DontDelete);
+    for (size_t i = 0; i < count; i++) {
+        v8::Local<v8::String> name =
+            v8::String::NewFromUtf8(isolate, table[i].name, v8::NewStringType::kInternalized)
+                .ToLocalChecked();
+        v8::Local<v8::Integer> value = v8::Integer::New(isolate, table[i].value);
+        tmpl->Set(name, value, attributes);
+        proto->Set(name, value, attributes);
+    }
+}
+
+void RegisterProperties(ExternalReferenceRegistry* registry,
+                        const PropertyDescriptor* table,
+                        size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        const PropertyDescriptor& property = table[i];
+        if (property.data_getter) {
+            registry->Register(property.data_getter);
+        }
+        if (property.data_setter) {
+            registry->Register(property.data_setter);
+        }
+        if (property.callback) {
+            registry->Register(property.callback);
+        }
+        if (property.setter) {
+            registry->Register(property.setter);
+        }
+        if (property.fast) {
+            registry->Register(*property.fast);
+        }
+    }
+}
+
+} // namespace v8_dom
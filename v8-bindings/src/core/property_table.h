@@ -0,0 +1,174 @@
+/**
+ * Property Table - Declarative prototype members of wrapper templates
+ *
+ * Each wrapper lists the attributes and operations of its interface in a
+ * constant-initialized PropertyDescriptor array, built with
+ * DataProperty(), AccessorProperty() and MethodProperty(), and its
+ * constants in a ConstantDescriptor array. InstallProperties() installs a
+ * table on a prototype template in one loop, and RegisterProperties()
+ * adds the same callbacks (Fast API functions included) to the snapshot
+ * external reference list, so the two lists cannot drift apart.
+ *
+ * Names are created as internalized one-byte strings from their
+ * compile-time length, so installing a table neither measures nor
+ * UTF-8 decodes its names, and the receiver check signature is created
+ * once per table. Members that need more than a descriptor (interceptors,
+ * intrinsics, per-type data) are still installed by hand next to the
+ * table.
+ */
+
+#ifndef V8_DOM_PROPERTY_TABLE_H
+#define V8_DOM_PROPERTY_TABLE_H
+
+#include <v8.h>
+#include <v8-fast-api-calls.h>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "external_references.h"
+
+namespace v8_dom {
+
+/**
+ * Per-member options.
+ */
+enum PropertyFlags : uint8_t {
+    kPropertyDefault = 0,
+    kReceiverCheck = 1 << 0,  // v8::Signature of the installing template (see UnwrapReceiver)
+    kNoSideEffect = 1 << 1,   // kHasNoSideEffect, throws when called with new
+    kDontEnum = 1 << 2,
+};
+
+/**
+ * One attribute or operation of an interface prototype.
+ */
+struct PropertyDescriptor {
+    enum class Kind : uint8_t {
+        kData,      // SetNativeDataProperty (name callbacks)
+        kAccessor,  // SetAccessorProperty (function callbacks)
+        kMethod,    // Set with a function template
+    };
+
+    const char* name;
+    uint32_t name_length;
+    Kind kind;
+    uint8_t flags;
+    uint8_t length;  // Function.length of a method
+
+    v8::AccessorNameGetterCallback data_getter;
+    v8::AccessorNameSetterCallback data_setter;
+    v8::FunctionCallback callback;  // method, or accessor getter
+    v8::FunctionCallback setter;    // accessor setter
+    const v8::CFunction* fast;      // Fast API variant of callback
+};
+
+/**
+ * A readonly integer constant of an interface.
+ */
+struct ConstantDescriptor {
+    const char* name;
+    int value;
+};
+
+/**
+ * Attribute backed by native data property callbacks.
+ */
+constexpr PropertyDescriptor DataProperty(const char* name,
+                                          v8::AccessorNameGetterCallback getter,
+                                          v8::AccessorNameSetterCallback setter = nullptr,
+                                          uint8_t flags = kPropertyDefault) {
+    return {name, static_cast<uint32_t>(std::string_view(name).size()),
+            PropertyDescriptor::Kind::kData, flags, 0,
+            getter, setter, nullptr, nullptr, nullptr};
+}
+
+/**
+ * Attribute backed by accessor functions (a WebIDL-style accessor pair).
+ */
+constexpr PropertyDescriptor AccessorProperty(const char* name,
+                                              v8::FunctionCallback getter,
+                                              v8::FunctionCallback setter = nullptr,
+                                              uint8_t flags = kReceiverCheck,
+                                              const v8::CFunction* fast = nullptr) {
+    return {name, static_cast<uint32_t>(std::string_view(name).size()),
+            PropertyDescriptor::Kind::kAccessor, flags, 0,
+            nullptr, nullptr, getter, setter, fast};
+}
+
+/**
+ * Operation.
+ */
+constexpr PropertyDescriptor MethodProperty(const char* name,
+                                            v8::FunctionCallback callback,
+                                            uint8_t flags = kReceiverCheck,
+                                            uint8_t length = 0,
+                                            const v8::CFunction* fast = nullptr) {
+    return {name, static_cast<uint32_t>(std::string_view(name).size()),
+            PropertyDescriptor::Kind::kMethod, flags, length,
+            nullptr, nullptr, callback, nullptr, fast};
+}
+
+/**
+ * Install a table on proto; signature is used for kReceiverCheck members.
+ */
+void InstallProperties(v8::Isolate* isolate,
+                       v8::Local<v8::ObjectTemplate> proto,
+                       v8::Local<v8::Signature> signature,
+                       const PropertyDescriptor* table,
+                       size_t count);
+
+/**
+ * Install a table on tmpl's prototype, checking receivers against tmpl.
+ */
+void InstallProperties(v8::Isolate* isolate,
+                       v8::Local<v8::FunctionTemplate> tmpl,
+                       const PropertyDescriptor* table,
+                       size_t count);
+
+template <size_t N>
+void InstallProperties(v8::Isolate* isolate,
+                       v8::Local<v8::ObjectTemplate> proto,
+                       v8::Local<v8::Signature> signature,
+                       const PropertyDescriptor (&table)[N]) {
+    InstallProperties(isolate, proto, signature, table, N);
+}
+
+template <size_t N>
+void InstallProperties(v8::Isolate* isolate,
+                       v8::Local<v8::FunctionTemplate> tmpl,
+                       const PropertyDescriptor (&table)[N]) {
+    InstallProperties(isolate, tmpl, table, N);
+}
+
+/**
+ * Install constants on the interface object and its prototype
+ * (ReadOnly | DontDelete).
+ */
+void InstallConstants(v8::Isolate* isolate,
+                      v8::Local<v8::FunctionTemplate> tmpl,
+                      const ConstantDescriptor* table,
+                      size_t count);
+
+template <size_t N>
+void InstallConstants(v8::Isolate* isolate,
+                      v8::Local<v8::FunctionTemplate> tmpl,
+                      const ConstantDescriptor (&table)[N]) {
+    InstallConstants(isolate, tmpl, table, N);
+}
+
+/**
+ * Register every callback of a table for snapshots.
+ */
+void RegisterProperties(ExternalReferenceRegistry* registry,
+                        const PropertyDescriptor* table,
+                        size_t count);
+
+template <size_t N>
+void RegisterProperties(ExternalReferenceRegistry* registry,
+                        const PropertyDescriptor (&table)[N]) {
+    RegisterProperties(registry, table, N);
+}
+
+} // namespace v8_dom
+
+#endif // V8_DOM_PROPERTY_TABLE_H
@@ -0,0 +1,49 @@
+#include "selector_cache.h"
+#include "utilities.h"
+
+namespace v8_dom {
+
+constexpr size_t CompiledSelectorCache::kMaxEntries;
+
+CompiledSelectorCache::~CompiledSelectorCache() {
+    Clear();
+}
+
+DOMSelector* CompiledSelectorCache::Get(v8::Isolate* isolate,
+                                        v8::Local<v8::String> selectors,
+                                        DOMDocument* doc) {
+    // Selector literals are already internalized, so this is usually free
+    v8::Local<v8::String> key = selectors->InternalizeString(isolate);
+    int hash = key->GetIdentityHash();
+
+    auto range = entries_.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second.key.Get(isolate)->StrictEquals(key)) {
+            hits_++;
+            return it->second.selector;
+        }
+    }
+
+    misses_++;
+    StringArgFromV8 utf8(isolate, key);
+    DOMSelector* selector = dom_selector_compile(doc, utf8.data(), utf8.length());
+    if (!selector) {
+        return nullptr;
+    }
+
+    if (entries_.size() >= kMaxEntries) {
+        Clear();
+    }
+    entries_.emplace(hash, Entry{v8::Global<v8::String>(isolate, key), selector});
+    return selector;
+}
+
+void CompiledSelectorCache::Clear() {
+    for (auto& entry : entries_) {
+        dom_selector_release(entry.second.selector);
+    }
+    // Global<> handles clean themselves up
+    entries_.clear();
+}
+
+} // namespace v8_dom
@@ -0,0 +1,71 @@
+/**
+ * Compiled Selector Cache - JS selector strings to compiled DOM selectors
+ *
+ * matches(), closest() and querySelector() are called with the same few
+ * selector strings over and over (event delegation calls closest() per
+ * event). This cache maps the internalized V8 string to a DOMSelector
+ * handle from dom_selector_compile(), so a repeated call neither converts
+ * the string to UTF-8 nor looks it up in the document's selector cache.
+ *
+ * Entries are only made for the isolate's own document (BindingState),
+ * and hold a reference on their selector.
+ */
+
+#ifndef V8_DOM_SELECTOR_CACHE_H
+#define V8_DOM_SELECTOR_CACHE_H
+
+#include <v8.h>
+#include <cstdint>
+#include <unordered_map>
+#include "dom.h"
+
+namespace v8_dom {
+
+class CompiledSelectorCache {
+public:
+    CompiledSelectorCache() = default;
+    ~CompiledSelectorCache();
+
+    /**
+     * Get the compiled selector for a string, compiling it in doc on a miss.
+     * Returns nullptr if the selector is invalid. The handle is borrowed
+     * and valid until the next Get() or Clear().
+     */
+    DOMSelector* Get(v8::Isolate* isolate, v8::Local<v8::String> selectors, DOMDocument* doc);
+
+    /**
+     * Release every cached selector.
+     */
+    void Clear();
+
+    /**
+     * Statistics
+     */
+    size_t Size() const { return entries_.size(); }
+    uint64_t Hits() const { return hits_; }
+    uint64_t Misses() const { return misses_; }
+
+private:
+    // Non-copyable, non-movable
+    CompiledSelectorCache(const CompiledSelectorCache&) = delete;
+    CompiledSelectorCache& operator=(const CompiledSelectorCache&) = delete;
+
+    struct Entry {
+        v8::Global<v8::String> key;   // internalized
+        DOMSelector* selector;        // owned reference
+    };
+
+    // Past this many entries the cache is flushed; the document's own
+    // LRU cache still holds the parsed selectors
+    static constexpr size_t kMaxEntries = 256;
+
+    // Keyed by the string's identity hash; collisions are resolved by
+    // comparing the internalized strings
+    std::unordered_multimap<int, Entry> entries_;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+};
+
+} // namespace v8_dom
+
+#endif // V8_DOM_SELECTOR_CACHE_H
@@ -0,0 +1,129 @@
+#include "string_cache.h"
+#include "binding_state.h"
+
+namespace v8_dom {
+
+namespace {
+
+/**
+ * External string backed by bytes in a document's string pool.
+ * Keeps the document (and so the pool) alive until V8 disposes it.
+ */
+class InternedStringResource final : public v8::String::ExternalOneByteStringResource {
+public:
+    InternedStringResource(const DOMStringView& view, DOMDocument* owner)
+        : data_(view.data)
+        , length_(view.length)
+        , owner_(owner) {
+        dom_document_addref(owner_);
+    }
+
+    ~InternedStringResource() override {
+        dom_document_release(owner_);
+    }
+
+    const char* data() const override { return data_; }
+    size_t length() const override { return length_; }
+
+private:
+    const char* data_;
+    size_t length_;
+    DOMDocument* owner_;
+};
+
+v8::Local<v8::String> CopyStringView(v8::Isolate* isolate, const DOMStringView& view) {
+    V8_DOM_COUNT(isolate, kStringConversions, 1);
+    V8_DOM_COUNT(isolate, kStringBytesCopied, view.length);
+    return NewStringFromView(isolate, view, v8::NewStringType::kNormal).ToLocalChecked();
+}
+
+// Latin-1 strings up to this many bytes are transcoded on the stack
+constexpr size_t kInlineLatin1Capacity = 256;
+
+} // namespace
+
+v8::MaybeLocal<v8::String> NewStringFromView(v8::Isolate* isolate,
+                                             const DOMStringView& view,
+                                             v8::NewStringType type) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(view.data);
+    if (view.is_latin1) {
+        // ASCII: skip UTF-8 decoding
+        return v8::String::NewFromOneByte(isolate, bytes, type, static_cast<int>(view.length));
+    }
+    if (!view.fits_latin1) {
+        return v8::String::NewFromUtf8(isolate, view.data, type, static_cast<int>(view.length));
+    }
+
+    // Valid UTF-8 up to U+00FF: each non-ASCII code point is a two-byte
+    // sequence (lead 0xC2 or 0xC3) holding one Latin-1 byte
+    uint8_t inline_buffer[kInlineLatin1Capacity];
+    std::unique_ptr<uint8_t[]> heap_buffer;
+    uint8_t* latin1 = inline_buffer;
+    if (view.length > kInlineLatin1Capacity) {
+        heap_buffer.reset(new uint8_t[view.length]);
+        latin1 = heap_buffer.get();
+    }
+    size_t length = 0;
+    for (size_t i = 0; i < view.length; i++) {
+        uint8_t byte = bytes[i];
+        if (byte >= 0x80) {
+            byte = static_cast<uint8_t>(((byte & 0x1F) << 6) | (bytes[++i] & 0x3F));
+        }
+        latin1[length++] = byte;
+    }
+    return v8::String::NewFromOneByte(isolate, latin1, type, static_cast<int>(length));
+}
+
+StringCache::~StringCache() {
+    // Global<> handles clean themselves up; live external strings keep
+    // their document reference until V8 disposes them
+    entries_.clear();
+}
+
+v8::Local<v8::String> StringCache::Get(v8::Isolate* isolate,
+                                       const DOMStringView& view,
+                                       DOMDocument* owner) {
+    if (view.length == 0) {
+        return v8::String::Empty(isolate);
+    }
+
+    // External one-byte strings must be Latin-1 and must outlive the call
+    if (!view.is_interned || !view.is_latin1 || !owner) {
+        return CopyStringView(isolate, view);
+    }
+
+    auto it = entries_.find(view.data);
+    if (it != entries_.end()) {
+        return it->second->string.Get(isolate);
+    }
+
+    InternedStringResource* resource = new InternedStringResource(view, owner);
+    v8::Local<v8::String> str;
+    if (!v8::String::NewExternalOneByte(isolate, resource).ToLocal(&str)) {
+        // V8 did not take ownership
+        delete resource;
+        return CopyStringView(isolate, view);
+    }
+
+    std::unique_ptr<Entry> entry(new Entry{this, view.data, v8::Global<v8::String>()});
+    entry->string.Reset(isolate, str);
+    entry->string.SetWeak(entry.get(), WeakCallback, v8::WeakCallbackType::kParameter);
+    entries_.emplace(view.data, std::move(entry));
+
+    return str;
+}
+
+void StringCache::WeakCallback(const v8::WeakCallbackInfo<Entry>& info) {
+    // The string is about to be collected; V8 disposes the resource after
+    Entry* entry = info.GetParameter();
+    entry->cache->entries_.erase(entry->data);
+}
+
+v8::Local<v8::String> StringViewToV8String(v8::Isolate* isolate,
+                                           const DOMStringView& view,
+                                           DOMNode* node) {
+    DOMDocument* owner = view.is_interned ? dom_node_get_ownerdocument(node) : nullptr;
+    return BindingState::ForIsolate(isolate)->Strings()->Get(isolate, view, owner);
+}
+
+} // namespace v8_dom
@@ -0,0 +1,88 @@
+/**
+ * String Cache - Zero-copy V8 strings for interned DOM strings
+ *
+ * Tag names and most attribute values live in the owner document's string
+ * pool: immutable, and valid until the document is destroyed. Instead of
+ * copying them into the V8 heap on every read, they are exposed as
+ * external one-byte strings backed by the pool's bytes, and the V8 string
+ * is cached per pointer so repeated reads allocate nothing.
+ *
+ * Each external resource holds a reference on the owner document, so the
+ * bytes outlive the document's last wrapper if script still holds the
+ * string. Non-interned and non-ASCII strings are copied as before; views
+ * flagged fits_latin1 are copied into one-byte strings without going
+ * through the UTF-8 decoder.
+ */
+
+#ifndef V8_DOM_STRING_CACHE_H
+#define V8_DOM_STRING_CACHE_H
+
+#include <v8.h>
+#include <memory>
+#include <unordered_map>
+#include "dom.h"
+
+namespace v8_dom {
+
+class StringCache {
+public:
+    StringCache() = default;
+    ~StringCache();
+
+    /**
+     * Get a V8 string for a DOM string view.
+     *
+     * Interned ASCII strings are returned as cached external strings;
+     * anything else is copied.
+     *
+     * @param owner Document owning the view's string pool (may be nullptr
+     *              for non-interned views)
+     */
+    v8::Local<v8::String> Get(v8::Isolate* isolate,
+                              const DOMStringView& view,
+                              DOMDocument* owner);
+
+    /**
+     * Number of cached external strings.
+     */
+    size_t Size() const { return entries_.size(); }
+
+private:
+    struct Entry {
+        StringCache* cache;
+        const char* data;
+        v8::Global<v8::String> string;
+    };
+
+    // Non-copyable, non-movable
+    StringCache(const StringCache&) = delete;
+    StringCache& operator=(const StringCache&) = delete;
+
+    static void WeakCallback(const v8::WeakCallbackInfo<Entry>& info);
+
+    // Keyed by the interned pointer: one pool copy per distinct string
+    std::unordered_map<const char*, std::unique_ptr<Entry>> entries_;
+};
+
+/**
+ * Copy a DOM string view into a new V8 string. ASCII and Latin-1 views
+ * (is_latin1, fits_latin1) become one-byte strings directly; only other
+ * UTF-8 goes through NewFromUtf8.
+ */
+v8::MaybeLocal<v8::String> NewStringFromView(v8::Isolate* isolate,
+                                             const DOMStringView& view,
+                                             v8::NewStringType type);
+
+/**
+ * Convert a DOM string view to a V8 string via the isolate's StringCache.
+ *
+ * @param node Node the string was read from (its owner document owns
+ *             interned views)
+ */
+v8::Local<v8::String> StringViewToV8String(v8::Isolate* isolate,
+                                           const DOMStringView& view,
+                                           DOMNode* node);
+
+} // namespace v8_dom
+
+#endif // V8_DOM_STRING_CACHE_H
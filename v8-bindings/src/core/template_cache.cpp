@@ -1,4 +1,5 @@
 #include "template_cache.h"
+#include "binding_stats.h"
 
 namespace v8_dom {
 
@@ -11,6 +12,8 @@ TemplateCache::TemplateCache(v8::Isolate* isolate)
 
 TemplateCache::~TemplateCache() {
     // Global<> handles clean themselves up
+    constructors_.clear();
+    constructor_context_.Reset();
     templates_.clear();
 }
 
@@ -28,6 +31,11 @@ TemplateCache* TemplateCache::ForIsolate(v8::Isolate* isolate) {
     return cache;
 }
 
+void TemplateCache::Dispose(v8::Isolate* isolate) {
+    delete static_cast<TemplateCache*>(isolate->GetData(kIsolateSlot));
+    isolate->SetData(kIsolateSlot, nullptr);
+}
+
 v8::Local<v8::FunctionTemplate> TemplateCache::Get(int index) {
     if (index < 0 || index >= static_cast<int>(templates_.size())) {
         return v8::Local<v8::FunctionTemplate>();
@@ -48,6 +56,7 @@ void TemplateCache::Set(int index, v8::Local<v8::FunctionTemplate> tmpl) {
     
     // Store template as persistent
     templates_[index].Reset(isolate_, tmpl);
+    V8_DOM_COUNT(isolate_, kTemplateInstalls, 1);
 }
 
 bool TemplateCache::Has(int index) const {
@@ -58,4 +67,28 @@ bool TemplateCache::Has(int index) const {
     return !templates_[index].IsEmpty();
 }
 
+v8::Local<v8::Function> TemplateCache::GetConstructor(
+    v8::Local<v8::Context> context,
+    int index,
+    v8::Local<v8::FunctionTemplate> (*get_template)(v8::Isolate*)) {
+    // Constructors are per context; start over when the context changes
+    if (constructor_context_ != context) {
+        constructors_.clear();
+        constructor_context_.Reset(isolate_, context);
+    }
+    
+    if (index >= static_cast<int>(constructors_.size())) {
+        constructors_.resize(index + 1);
+    }
+    
+    if (!constructors_[index].IsEmpty()) {
+        return constructors_[index].Get(isolate_);
+    }
+    
+    v8::Local<v8::Function> constructor =
+        get_template(isolate_)->GetFunction(context).ToLocalChecked();
+    constructors_[index].Reset(isolate_, constructor);
+    return constructor;
+}
+
 } // namespace v8_dom
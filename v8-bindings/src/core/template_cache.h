@@ -3,6 +3,10 @@
  * 
  * V8 templates are expensive to create, so we cache them per isolate.
  * Each wrapper type has a unique index for template lookup.
+ * 
+ * The constructor Functions instantiated from those templates are also
+ * cached for the context that is currently wrapping objects, so Wrap does
+ * not go through FunctionTemplate::GetFunction on every new wrapper.
  */
 
 #ifndef V8_DOM_TEMPLATE_CACHE_H
@@ -21,6 +25,12 @@ public:
      */
     static TemplateCache* ForIsolate(v8::Isolate* isolate);
     
+    /**
+     * Delete the isolate's TemplateCache, dropping all cached templates
+     * and constructors.
+     */
+    static void Dispose(v8::Isolate* isolate);
+    
     /**
      * Get a cached template by index.
      * Returns empty handle if not found.
@@ -37,6 +47,23 @@ public:
      */
     bool Has(int index) const;
     
+    /**
+     * Get the constructor Function for a template in a context.
+     * 
+     * The first call per context instantiates it from get_template (which
+     * installs the template if needed); later calls return the cached
+     * Function. Only the most recently used context is cached; switching
+     * contexts drops the constructors of the previous one.
+     * 
+     * @param context Context the wrapper is created in
+     * @param index Template index (kTemplateIndex of the wrapper)
+     * @param get_template The wrapper's GetTemplate
+     */
+    v8::Local<v8::Function> GetConstructor(
+        v8::Local<v8::Context> context,
+        int index,
+        v8::Local<v8::FunctionTemplate> (*get_template)(v8::Isolate*));
+    
 private:
     TemplateCache(v8::Isolate* isolate);
     ~TemplateCache();
@@ -48,6 +75,10 @@ private:
     v8::Isolate* isolate_;
     std::vector<v8::Global<v8::FunctionTemplate>> templates_;
     
+    // Constructors instantiated in constructor_context_, by template index
+    v8::Global<v8::Context> constructor_context_;
+    std::vector<v8::Global<v8::Function>> constructors_;
+    
     // Isolate data slot (different from WrapperCache)
     static const int kIsolateSlot = 1;
 };
@@ -8,7 +8,14 @@
 #define V8_DOM_UTILITIES_H
 
 #include <v8.h>
+#include <v8-fast-api-calls.h>
+#include <cstring>
+#include <memory>
+#include <string>
 #include "dom.h"
+#include "binding_stats.h"
+#include "binding_trace.h"
+#include "domexception_wrapper.h"
 
 namespace v8_dom {
 
@@ -20,6 +27,8 @@ inline v8::Local<v8::String> CStringToV8String(v8::Isolate* isolate, const char*
     if (!str) {
         return v8::String::Empty(isolate);
     }
+    V8_DOM_COUNT(isolate, kStringConversions, 1);
+    V8_DOM_COUNT(isolate, kStringBytesCopied, std::strlen(str));
     return v8::String::NewFromUtf8(isolate, str).ToLocalChecked();
 }
 
@@ -45,25 +54,7 @@ inline void ThrowDOMException(v8::Isolate* isolate, int32_t error_code) {
         return;  // No error
     }
     
-    const char* name = dom_error_code_name(error_code);
-    const char* message = dom_error_code_message(error_code);
-    
-    v8::Local<v8::String> error_name = CStringToV8String(isolate, name);
-    v8::Local<v8::String> error_message = CStringToV8String(isolate, message);
-    
-    // Create DOMException-like error
-    v8::Local<v8::Object> error = v8::Exception::Error(error_message)
-        ->ToObject(isolate->GetCurrentContext()).ToLocalChecked();
-    
-    error->Set(isolate->GetCurrentContext(),
-              v8::String::NewFromUtf8Literal(isolate, "name"),
-              error_name).Check();
-    
-    error->Set(isolate->GetCurrentContext(),
-              v8::String::NewFromUtf8Literal(isolate, "code"),
-              v8::Integer::New(isolate, error_code)).Check();
-    
-    isolate->ThrowException(error);
+    DOMExceptionWrapper::Throw(isolate, error_code);
 }
 
 /**
@@ -83,7 +74,10 @@ inline bool IsNullOrUndefined(v8::Local<v8::Value> value) {
 class CStringFromV8 {
 public:
     explicit CStringFromV8(v8::Isolate* isolate, v8::Local<v8::Value> value)
-        : utf8_(isolate, value) {}
+        : utf8_(isolate, value) {
+        V8_DOM_COUNT(isolate, kStringConversions, 1);
+        V8_DOM_COUNT(isolate, kStringBytesCopied, utf8_.length());
+    }
     
     const char* get() const {
         return *utf8_;
@@ -97,6 +91,87 @@ private:
     v8::String::Utf8Value utf8_;
 };
 
+/**
+ * Get a sized UTF-8 string from a V8 value (for the _n C-ABI entry points).
+ * Converts like CStringFromV8 (ToString), but short strings are written
+ * into an inline stack buffer, so the common case allocates nothing and
+ * the C side gets the length without a strlen.
+ * 
+ * WARNING: The returned pointer is only valid while this object lives!
+ */
+class StringArgFromV8 {
+public:
+    StringArgFromV8(v8::Isolate* isolate, v8::Local<v8::Value> value) {
+        v8::Local<v8::String> str;
+        if (value.IsEmpty() ||
+            !value->ToString(isolate->GetCurrentContext()).ToLocal(&str)) {
+            return;
+        }
+        
+        // Each UTF-16 unit takes at most 3 UTF-8 bytes
+        size_t max_length = static_cast<size_t>(str->Length()) * 3;
+        char* buffer = inline_;
+        size_t capacity = kInlineCapacity;
+        if (max_length >= kInlineCapacity) {
+            capacity = str->Utf8LengthV2(isolate) + 1;
+            heap_.reset(new char[capacity]);
+            buffer = heap_.get();
+        }
+        
+        size_t written = str->WriteUtf8V2(
+            isolate, buffer, capacity,
+            v8::String::WriteFlags::kNullTerminate | v8::String::WriteFlags::kReplaceInvalidUtf8);
+        data_ = buffer;
+        length_ = written > 0 ? written - 1 : 0;  // Exclude the terminator
+        V8_DOM_COUNT(isolate, kStringConversions, 1);
+        V8_DOM_COUNT(isolate, kStringBytesCopied, length_);
+    }
+    
+    const char* data() const { return data_; }
+    size_t length() const { return length_; }
+    
+private:
+    static constexpr size_t kInlineCapacity = 256;
+    
+    char inline_[kInlineCapacity];
+    std::unique_ptr<char[]> heap_;
+    const char* data_ = "";
+    size_t length_ = 0;
+};
+
+/**
+ * Get a null-terminated UTF-8 C string from a Fast API one-byte string.
+ * 
+ * Fast API strings are Latin-1 and not null-terminated; bytes >= 0x80 are
+ * re-encoded as two-byte UTF-8 sequences for the C-ABI.
+ */
+class CStringFromFastString {
+public:
+    explicit CStringFromFastString(const v8::FastOneByteString& str) {
+        utf8_.reserve(str.length);
+        for (uint32_t i = 0; i < str.length; i++) {
+            unsigned char c = static_cast<unsigned char>(str.data[i]);
+            if (c < 0x80) {
+                utf8_.push_back(static_cast<char>(c));
+            } else {
+                utf8_.push_back(static_cast<char>(0xC0 | (c >> 6)));
+                utf8_.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+            }
+        }
+    }
+    
+    const char* get() const {
+        return utf8_.c_str();
+    }
+    
+    size_t length() const {
+        return utf8_.size();
+    }
+    
+private:
+    std::string utf8_;
+};
+
 } // namespace v8_dom
 
 #endif // V8_DOM_UTILITIES_H
@@ -0,0 +1,172 @@
+/**
+ * Wrapper Traits - Compile-time description of each wrapper class
+ *
+ * WrapperTraits<T> tells the shared Wrap/Unwrap code how wrapper class T
+ * caches and owns its C object: the C type, the template cache index,
+ * where the wrapper is cached (node slot or pointer map) and which
+ * C-ABI functions take and drop the wrapper's reference. The
+ * specializations are generated by generate_wrappers.py --traits into
+ * wrapper_traits_generated.h.
+ *
+ * Wrappers whose C object needs nothing beyond that implement Wrap and
+ * Unwrap as one call to WrapWithTraits<T> / UnwrapWithTraits<T>, so a
+ * change to the wrap fast path lands here once. Wrappers with extra work
+ * (Node's dispatch to the most-derived wrapper, Document's memory
+ * tracking) call LookupWrapper<T> and CreateWrapper<T> around it.
+ * Wrappers marked kCustom cache binding-side state of their own and only
+ * take their template index from the traits.
+ */
+
+#ifndef V8_DOM_WRAPPER_TRAITS_H
+#define V8_DOM_WRAPPER_TRAITS_H
+
+#include <v8.h>
+#include "dom.h"
+#include "../wrapper_cache.h"
+#include "template_cache.h"
+#include "wrapper_type_info.h"
+
+namespace v8_dom {
+
+/**
+ * Where a wrapper is cached.
+ */
+enum class WrapperStorage {
+    kNodeSlot,  // WrapperCache::LookupNode/SetNode
+    kMap,       // WrapperCache::Lookup/Set
+    kCustom,    // Wrap caches its own state
+};
+
+using ReleaseCallback = void (*)(void*);
+
+/**
+ * Specialized for every wrapper class in wrapper_traits_generated.h.
+ */
+template <typename T>
+struct WrapperTraits;
+
+} // namespace v8_dom
+
+#include "wrapper_traits_generated.h"
+
+namespace v8_dom {
+
+/**
+ * Look up the cached wrapper of obj in a single probe.
+ */
+template <typename T>
+inline bool LookupWrapper(v8::Isolate* isolate,
+                          WrapperCache* cache,
+                          typename WrapperTraits<T>::Object* obj,
+                          v8::Local<v8::Object>* wrapper) {
+    using Traits = WrapperTraits<T>;
+    if constexpr (Traits::kStorage == WrapperStorage::kNodeSlot) {
+        return cache->LookupNode(isolate, (DOMNode*)obj, wrapper);
+    } else {
+        return cache->Lookup(isolate, obj, wrapper);
+    }
+}
+
+/**
+ * Wrappers being created on this thread by CreateWrapperWith (isolates
+ * are thread-confined). Interface constructors run for those calls too;
+ * while this is 0 the caller is script's `new`.
+ */
+inline thread_local int wrappers_being_created = 0;
+
+/**
+ * Call handler of interfaces script may not construct: lets the bindings
+ * create wrappers and throws "Illegal constructor" otherwise, since no C
+ * object would back the new object's wrapper fields.
+ */
+inline void IllegalConstructor(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    if (wrappers_being_created > 0) {
+        return;
+    }
+    v8::Isolate* isolate = args.GetIsolate();
+    isolate->ThrowException(v8::Exception::TypeError(
+        v8::String::NewFromUtf8Literal(isolate, "Illegal constructor")));
+}
+
+/**
+ * Create and cache a new wrapper for obj from T's constructor, in the
+ * caller's handle scope. For loops creating many wrappers of one type
+ * (see NodeWrapper::PrewrapSubtree); CreateWrapper looks the constructor
+ * up itself.
+ */
+template <typename T>
+v8::Local<v8::Object> CreateWrapperWith(v8::Isolate* isolate,
+                                        v8::Local<v8::Context> context,
+                                        WrapperCache* cache,
+                                        v8::Local<v8::Function> constructor,
+                                        typename WrapperTraits<T>::Object* obj) {
+    using Traits = WrapperTraits<T>;
+    static_assert(Traits::kStorage != WrapperStorage::kCustom,
+                  "custom wrappers cache their own state");
+
+    wrappers_being_created++;
+    v8::Local<v8::Object> wrapper = constructor->NewInstance(context).ToLocalChecked();
+    wrappers_being_created--;
+
+    // Store C pointer and type tag in internal fields
+    SetWrapperFields(wrapper, obj, &T::kTypeInfo);
+
+    if constexpr (Traits::kAddsRef) {
+        Traits::AddRef(obj);
+    }
+
+    if constexpr (Traits::kStorage == WrapperStorage::kNodeSlot) {
+        cache->SetNode(isolate, (DOMNode*)obj, wrapper, Traits::kRelease);
+    } else {
+        cache->Set(isolate, obj, wrapper, Traits::kRelease);
+    }
+
+    return wrapper;
+}
+
+/**
+ * Create and cache a new wrapper for obj (not already cached).
+ * Takes the wrapper's C-side reference unless T adopts the caller's.
+ */
+template <typename T>
+v8::Local<v8::Object> CreateWrapper(v8::Isolate* isolate,
+                                    v8::Local<v8::Context> context,
+                                    WrapperCache* cache,
+                                    typename WrapperTraits<T>::Object* obj) {
+    v8::EscapableHandleScope handle_scope(isolate);
+    v8::Local<v8::Function> constructor =
+        TemplateCache::ForIsolate(isolate)->GetConstructor(context, WrapperTraits<T>::kTemplateIndex, T::GetTemplate);
+    return handle_scope.Escape(CreateWrapperWith<T>(isolate, context, cache, constructor, obj));
+}
+
+/**
+ * Return the cached wrapper of obj, creating it on first use.
+ * Empty handle for a null obj.
+ */
+template <typename T>
+v8::Local<v8::Object> WrapWithTraits(v8::Isolate* isolate,
+                                     v8::Local<v8::Context> context,
+                                     typename WrapperTraits<T>::Object* obj) {
+    if (!obj) {
+        return v8::Local<v8::Object>();
+    }
+
+    WrapperCache* cache = WrapperCache::ForIsolate(isolate);
+    v8::Local<v8::Object> cached;
+    if (LookupWrapper<T>(isolate, cache, obj, &cached)) {
+        return cached;
+    }
+    return CreateWrapper<T>(isolate, context, cache, obj);
+}
+
+/**
+ * Unwrap obj as T's C type; nullptr unless obj is a T (or derived) wrapper.
+ */
+template <typename T>
+inline typename WrapperTraits<T>::Object* UnwrapWithTraits(v8::Local<v8::Object> obj) {
+    return static_cast<typename WrapperTraits<T>::Object*>(UnwrapObject(obj, &T::kTypeInfo));
+}
+
+} // namespace v8_dom
+
+#endif // V8_DOM_WRAPPER_TRAITS_H
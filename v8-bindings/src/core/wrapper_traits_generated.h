@@ -0,0 +1,393 @@
+/**
+ * Wrapper Traits - generated by generate_wrappers.py --traits; do not edit
+ *
+ * One WrapperTraits<T> specialization per wrapper class, from the
+ * TEMPLATE_INDICES and WRAPPER_TRAITS tables of the generator. Included
+ * by wrapper_traits.h.
+ */
+
+#ifndef V8_DOM_WRAPPER_TRAITS_GENERATED_H
+#define V8_DOM_WRAPPER_TRAITS_GENERATED_H
+
+namespace v8_dom {
+
+class EventTargetWrapper;
+class NodeWrapper;
+class ElementWrapper;
+class DocumentWrapper;
+class DocumentFragmentWrapper;
+class CharacterDataWrapper;
+class TextWrapper;
+class CommentWrapper;
+class CDATASectionWrapper;
+class ProcessingInstructionWrapper;
+class DocumentTypeWrapper;
+class AttrWrapper;
+class DOMImplementationWrapper;
+class NodeListWrapper;
+class HTMLCollectionWrapper;
+class NamedNodeMapWrapper;
+class DOMTokenListWrapper;
+class EventWrapper;
+class CustomEventWrapper;
+class AbstractRangeWrapper;
+class RangeWrapper;
+class StaticRangeWrapper;
+class NodeIteratorWrapper;
+class TreeWalkerWrapper;
+class MutationObserverWrapper;
+class MutationRecordWrapper;
+class ShadowRootWrapper;
+class AbortControllerWrapper;
+class AbortSignalWrapper;
+class MutationRecordBatchWrapper;
+class TreeBuilderWrapper;
+class CustomElementRegistryWrapper;
+class ElementIteratorWrapper;
+class DOMExceptionWrapper;
+class ListIteratorWrapper;
+class SlicedQueryWrapper;
+class DOMStringMapWrapper;
+
+template <>
+struct WrapperTraits<EventTargetWrapper> {
+    static constexpr int kTemplateIndex = 0;
+    static constexpr WrapperStorage kStorage = WrapperStorage::kCustom;
+};
+
+template <>
+struct WrapperTraits<NodeWrapper> {
+    using Object = DOMNode;
+    static constexpr int kTemplateIndex = 1;
+    static constexpr WrapperStorage kStorage = WrapperStorage::kNodeSlot;
+    static constexpr bool kAddsRef = true;
+    static void AddRef(Object* obj) { dom_node_addref(obj); }
+    static constexpr ReleaseCallback kRelease = [](void* ptr) {
+        dom_node_release(static_cast<DOMNode*>(ptr));
+    };
+};
+
+template <>
+struct WrapperTraits<ElementWrapper> {
+    using Object = DOMElement;
+    static constexpr int kTemplateIndex = 2;
+    static constexpr WrapperStorage kStorage = WrapperStorage::kNodeSlot;
+    static constexpr bool kAddsRef = true;
+    static void AddRef(Object* obj) { dom_element_addref(obj); }
+    static constexpr ReleaseCallback kRelease = [](void* ptr) {
+        dom_element_release(static_cast<DOMElement*>(ptr));
+    };
+};
+
+template <>
+struct WrapperTraits<DocumentWrapper> {
+    using Object = DOMDocument;
+    static constexpr int kTemplateIndex = 3;
+    static constexpr WrapperStorage kStorage = WrapperStorage::kNodeSlot;
+    static constexpr bool kAddsRef = true;
+    static void AddRef(Object* obj) { dom_document_addref(obj); }
+    static constexpr ReleaseCallback kRelease = [](void* ptr) {
+        dom_document_release(static_cast<DOMDocument*>(ptr));
+    };
+};
+
+template <>
+struct WrapperTraits<DocumentFragmentWrapper> {
+    using Object = DOMDocumentFragment;
+    static constexpr int kTemplateIndex = 4;
+    static constexpr WrapperStorage kStorage = WrapperStorage::kNodeSlot;
+    static constexpr bool kAddsRef = true;
+    static void AddRef(Object* obj) { dom_documentfragment_addref(obj); }
+    static constexpr ReleaseCallback kRelease = [](void* ptr) {
+        dom_documentfragment_release(static_cast<DOMDocumentFragment*>(ptr));
+    };
+};
+
+template <>
+struct WrapperTraits<CharacterDataWrapper> {
+    using Object = DOMCharacterData;
+    static constexpr int kTemplateIndex = 5;
+    static constexpr WrapperStorage kStorage = WrapperStorage::kNodeSlot;
+    static constexpr bool kAddsRef = true;
+    static void AddRef(Object* obj) { dom_node_addref((DOMNode*)obj); }
+    static constexpr ReleaseCallback kRelease = [](void* ptr) {
+        dom_node_release(static_cast<DOMNode*>(ptr));
+    };
+};
+
+template <>
+struct WrapperTraits<TextWrapper> {
+    using Object = DOMText;
+    static constexpr int kTemplateIndex = 6;
+    static constexpr WrapperStorage kStorage = WrapperStorage::kNodeSlot;
+    static constexpr bool kAddsRef = true;
+    static void AddRef(Object* obj) { dom_node_addref((DOMNode*)obj); }
+    static constexpr ReleaseCallback kRelease = [](void* ptr) {
+        dom_node_release(static_cast<DOMNode*>(ptr));
+    };
+};
+
+template <>
+struct WrapperTraits<CommentWrapper> {
+    using Object = DOMComment;
+    static constexpr int kTemplateIndex = 7;
+    static constexpr WrapperStorage kStorage = WrapperStorage::kNodeSlot;
+    static constexpr bool kAddsRef = true;
+    static void AddRef(Object* obj) { dom_node_addref((DOMNode*)obj); }
+    static constexpr ReleaseCallback kRelease = [](void* ptr) {
+        dom_node_release(static_cast<DOMNode*>(ptr));
+    };
+};
+
+template <>
+struct WrapperTraits<CDATASectionWrapper> {
+    using Object = DOMCDATASection;
+    static constexpr int kTemplateIndex = 8;
+    static constexpr WrapperStorage kStorage = WrapperStorage::kNodeSlot;
+    static constexpr bool kAddsRef = true;
+    static void AddRef(Object* obj) { dom_node_addref((DOMNode*)obj); }
+    static constexpr ReleaseCallback kRelease = [](void* ptr) {
+        dom_node_release(static_cast<DOMNode*>(ptr));
+    };
+};
+
+template <>
+struct WrapperTraits<ProcessingInstructionWrapper> {
+    using Object = DOMProcessingInstruction;
+    static constexpr int kTemplateIndex = 9;
+    static constexpr WrapperStorage kStorage = WrapperStorage::kNodeSlot;
+    static constexpr bool kAddsRef = true;
+    static void AddRef(Object* obj) { dom_node_addref((DOMNode*)obj); }
+    static constexpr ReleaseCallback kRelease = [](void* ptr) {
+        dom_node_release(static_cast<DOMNode*>(ptr));
+    };
+};
+
+template <>
+struct WrapperTraits<DocumentTypeWrapper> {
+    using Object = DOMDocumentType;
+    static constexpr int kTemplateIndex = 10;
+    static constexpr WrapperStorage kStorage = WrapperStorage::kNodeSlot;
+    static constexpr bool kAddsRef = true;
+    static void AddRef(Object* obj) { dom_node_addref((DOMNode*)obj); }
+    static constexpr ReleaseCallback kRelease = [](void* ptr) {
+        dom_node_release(static_cast<DOMNode*>(ptr));
+    };
+};
+
+template <>
+struct WrapperTraits<AttrWrapper> {
+    using Object = DOMAttr;
+    static constexpr int kTemplateIndex = 11;
+    static constexpr WrapperStorage kStorage = WrapperStorage::kNodeSlot;
+    static constexpr bool kAddsRef = true;
+    static void AddRef(Object* obj) { dom_attr_addref(obj); }
+    static constexpr ReleaseCallback kRelease = [](void* ptr) {
+        dom_attr_release(static_cast<DOMAttr*>(ptr));
+    };
+};
+
+template <>
+struct WrapperTraits<DOMImplementationWrapper> {
+    using Object = DOMDOMImplementation;
+    static constexpr int kTemplateIndex = 12;
+    static constexpr WrapperStorage kStorage = WrapperStorage::kMap;
+    static constexpr bool kAddsRef = true;
+    static void AddRef(Object* obj) { dom_domimplementation_addref(obj); }
+    static constexpr ReleaseCallback kRelease = [](void* ptr) {
+        dom_domimplementation_release(static_cast<DOMDOMImplementation*>(ptr));
+    };
+};
+
+template <>
+struct WrapperTraits<NodeListWrapper> {
+    static constexpr int kTemplateIndex = 13;
+    static constexpr WrapperStorage kStorage = WrapperStorage::kCustom;
+};
+
+template <>
+struct WrapperTraits<HTMLCollectionWrapper> {
+    static constexpr int kTemplateIndex = 14;
+    static constexpr WrapperStorage kStorage = WrapperStorage::kCustom;
+};
+
+template <>
+struct WrapperTraits<NamedNodeMapWrapper> {
+    static constexpr int kTemplateIndex = 15;
+    static constexpr WrapperStorage kStorage = WrapperStorage::kCustom;
+};
+
+template <>
+struct WrapperTraits<DOMTokenListWrapper> {
+    static constexpr int kTemplateIndex = 16;
+    static constexpr WrapperStorage kStorage = WrapperStorage::kCustom;
+};
+
+template <>
+struct WrapperTraits<EventWrapper> {
+    using Object = DOMEvent;
+    static constexpr int kTemplateIndex = 17;
+    static constexpr WrapperStorage kStorage = WrapperStorage::kMap;
+    static constexpr bool kAddsRef = true;
+    static void AddRef(Object* obj) { dom_event_addref(obj); }
+    static constexpr ReleaseCallback kRelease = [](void* ptr) {
+        dom_event_release(static_cast<DOMEvent*>(ptr));
+    };
+};
+
+template <>
+struct WrapperTraits<CustomEventWrapper> {
+    using Object = DOMCustomEvent;
+    static constexpr int kTemplateIndex = 18;
+    static constexpr WrapperStorage kStorage = WrapperStorage::kMap;
+    static constexpr bool kAddsRef = true;
+    static void AddRef(Object* obj) { dom_customevent_addref(obj); }
+    static constexpr ReleaseCallback kRelease = [](void* ptr) {
+        dom_customevent_release(static_cast<DOMCustomEvent*>(ptr));
+    };
+};
+
+template <>
+struct WrapperTraits<AbstractRangeWrapper> {
+    using Object = DOMAbstractRange;
+    static constexpr int kTemplateIndex = 19;
+    static constexpr WrapperStorage kStorage = WrapperStorage::kMap;
+    static constexpr bool kAddsRef = false;
+    static constexpr ReleaseCallback kRelease = nullptr;  // not owned
+};
+
+template <>
+struct WrapperTraits<RangeWrapper> {
+    using Object = DOMRange;
+    static constexpr int kTemplateIndex = 20;
+    static constexpr WrapperStorage kStorage = WrapperStorage::kMap;
+    static constexpr bool kAddsRef = false;  // adopts the caller's reference
+    static constexpr ReleaseCallback kRelease = [](void* ptr) {
+        dom_range_release(static_cast<DOMRange*>(ptr));
+    };
+};
+
+template <>
+struct WrapperTraits<StaticRangeWrapper> {
+    using Object = DOMStaticRange;
+    static constexpr int kTemplateIndex = 21;
+    static constexpr WrapperStorage kStorage = WrapperStorage::kMap;
+    static constexpr bool kAddsRef = false;  // adopts the caller's reference
+    static constexpr ReleaseCallback kRelease = [](void* ptr) {
+        dom_staticrange_release(static_cast<DOMStaticRange*>(ptr));
+    };
+};
+
+template <>
+struct WrapperTraits<NodeIteratorWrapper> {
+    static constexpr int kTemplateIndex = 22;
+    static constexpr WrapperStorage kStorage = WrapperStorage::kCustom;
+};
+
+template <>
+struct WrapperTraits<TreeWalkerWrapper> {
+    static constexpr int kTemplateIndex = 23;
+    static constexpr WrapperStorage kStorage = WrapperStorage::kCustom;
+};
+
+template <>
+struct WrapperTraits<MutationObserverWrapper> {
+    static constexpr int kTemplateIndex = 24;
+    static constexpr WrapperStorage kStorage = WrapperStorage::kCustom;
+};
+
+template <>
+struct WrapperTraits<MutationRecordWrapper> {
+    static constexpr int kTemplateIndex = 25;
+    static constexpr WrapperStorage kStorage = WrapperStorage::kCustom;
+};
+
+template <>
+struct WrapperTraits<ShadowRootWrapper> {
+    using Object = DOMShadowRoot;
+    static constexpr int kTemplateIndex = 26;
+    static constexpr WrapperStorage kStorage = WrapperStorage::kNodeSlot;
+    static constexpr bool kAddsRef = true;
+    static void AddRef(Object* obj) { dom_node_addref((DOMNode*)obj); }
+    static constexpr ReleaseCallback kRelease = [](void* ptr) {
+        dom_node_release(static_cast<DOMNode*>(ptr));
+    };
+};
+
+template <>
+struct WrapperTraits<AbortControllerWrapper> {
+    using Object = DOMAbortController;
+    static constexpr int kTemplateIndex = 27;
+    static constexpr WrapperStorage kStorage = WrapperStorage::kMap;
+    static constexpr bool kAddsRef = false;  // adopts the caller's reference
+    static constexpr ReleaseCallback kRelease = [](void* ptr) {
+        dom_abortcontroller_release(static_cast<DOMAbortController*>(ptr));
+    };
+};
+
+template <>
+struct WrapperTraits<AbortSignalWrapper> {
+    using Object = DOMAbortSignal;
+    static constexpr int kTemplateIndex = 28;
+    static constexpr WrapperStorage kStorage = WrapperStorage::kMap;
+    static constexpr bool kAddsRef = true;
+    static void AddRef(Object* obj) { dom_abortsignal_acquire(obj); }
+    static constexpr ReleaseCallback kRelease = [](void* ptr) {
+        dom_abortsignal_release(static_cast<DOMAbortSignal*>(ptr));
+    };
+};
+
+template <>
+struct WrapperTraits<MutationRecordBatchWrapper> {
+    static constexpr int kTemplateIndex = 31;
+    static constexpr WrapperStorage kStorage = WrapperStorage::kCustom;
+};
+
+template <>
+struct WrapperTraits<TreeBuilderWrapper> {
+    static constexpr int kTemplateIndex = 32;
+    static constexpr WrapperStorage kStorage = WrapperStorage::kCustom;
+};
+
+template <>
+struct WrapperTraits<CustomElementRegistryWrapper> {
+    using Object = DOMCustomElementRegistry;
+    static constexpr int kTemplateIndex = 33;
+    static constexpr WrapperStorage kStorage = WrapperStorage::kMap;
+    static constexpr bool kAddsRef = false;
+    static constexpr ReleaseCallback kRelease = nullptr;  // not owned
+};
+
+template <>
+struct WrapperTraits<ElementIteratorWrapper> {
+    static constexpr int kTemplateIndex = 34;
+    static constexpr WrapperStorage kStorage = WrapperStorage::kCustom;
+};
+
+template <>
+struct WrapperTraits<DOMExceptionWrapper> {
+    static constexpr int kTemplateIndex = 35;
+    static constexpr WrapperStorage kStorage = WrapperStorage::kCustom;
+};
+
+template <>
+struct WrapperTraits<ListIteratorWrapper> {
+    static constexpr int kTemplateIndex = 36;
+    static constexpr WrapperStorage kStorage = WrapperStorage::kCustom;
+};
+
+template <>
+struct WrapperTraits<SlicedQueryWrapper> {
+    static constexpr int kTemplateIndex = 37;
+    static constexpr WrapperStorage kStorage = WrapperStorage::kCustom;
+};
+
+template <>
+struct WrapperTraits<DOMStringMapWrapper> {
+    static constexpr int kTemplateIndex = 38;
+    static constexpr WrapperStorage kStorage = WrapperStorage::kCustom;
+};
+
+} // namespace v8_dom
+
+#endif // V8_DOM_WRAPPER_TRAITS_GENERATED_H
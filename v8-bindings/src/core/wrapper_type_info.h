@@ -0,0 +1,116 @@
+/**
+ * Wrapper Type Info - Type tags for safe unwrapping
+ *
+ * Every wrapper stores two aligned pointers in its internal fields:
+ * - kWrapperObjectIndex: the C DOM pointer
+ * - kWrapperTypeIndex: the WrapperTypeInfo of the wrapper class
+ *
+ * Aligned pointers are stored directly in the object, so creating a wrapper
+ * allocates no v8::External, and Unwrap is a few loads plus a tag check.
+ * Each wrapper class defines a static kTypeInfo whose parent mirrors the
+ * C++ wrapper hierarchy (Element -> Node -> EventTarget), so a wrapper
+ * can be unwrapped as any of its base interfaces.
+ *
+ * Members installed with kReceiverCheck carry the v8::Signature of their
+ * template, so V8 brand-checks the receiver itself (in its ICs, throwing
+ * its standard "Illegal invocation" TypeError) before the callback runs.
+ * Their callbacks use UnwrapReceiver(), which skips the tag check.
+ */
+
+#ifndef V8_DOM_WRAPPER_TYPE_INFO_H
+#define V8_DOM_WRAPPER_TYPE_INFO_H
+
+#include <v8.h>
+#include "binding_stats.h"
+
+namespace v8_dom {
+
+/**
+ * Internal field layout shared by all wrapper templates.
+ */
+enum WrapperFieldIndex {
+    kWrapperObjectIndex = 0,
+    kWrapperTypeIndex = 1,
+    kWrapperFieldCount = 2,
+};
+
+/**
+ * Static type tag for a wrapper class.
+ */
+struct WrapperTypeInfo {
+    const char* interface_name;
+    const WrapperTypeInfo* parent;  // nullptr for root interfaces
+
+    /**
+     * Check if this type is the given type or derives from it.
+     */
+    bool IsSubtypeOf(const WrapperTypeInfo* other) const {
+        for (const WrapperTypeInfo* type = this; type; type = type->parent) {
+            if (type == other) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+/**
+ * Store the C pointer and type tag in a freshly created wrapper.
+ */
+inline void SetWrapperFields(v8::Local<v8::Object> wrapper,
+                             void* obj,
+                             const WrapperTypeInfo* type) {
+    wrapper->SetAlignedPointerInInternalField(kWrapperObjectIndex, obj);
+    wrapper->SetAlignedPointerInInternalField(
+        kWrapperTypeIndex, const_cast<WrapperTypeInfo*>(type));
+}
+
+/**
+ * Get the C pointer from a wrapper if it is of the given type (or derived).
+ * Returns nullptr for non-wrappers and wrappers of unrelated types.
+ */
+inline void* UnwrapObject(v8::Local<v8::Object> obj, const WrapperTypeInfo* type) {
+    if (obj.IsEmpty() || obj->InternalFieldCount() < kWrapperFieldCount) {
+        return nullptr;
+    }
+
+    const WrapperTypeInfo* actual = static_cast<const WrapperTypeInfo*>(
+        obj->GetAlignedPointerFromInternalField(kWrapperTypeIndex));
+    if (!actual || !actual->IsSubtypeOf(type)) {
+        return nullptr;
+    }
+    V8_DOM_COUNT_TYPE(nullptr, type, kTypeCalls);
+
+    return obj->GetAlignedPointerFromInternalField(kWrapperObjectIndex);
+}
+
+/**
+ * Get the C pointer of a receiver V8 has already brand-checked.
+ *
+ * Only for operations and accessors installed with kReceiverCheck, and
+ * their Fast API variants. Returns nullptr for an instance of the
+ * template that was never given a C object.
+ */
+template <typename T>
+inline T* UnwrapReceiver(v8::Local<v8::Object> receiver) {
+    return static_cast<T*>(receiver->GetAlignedPointerFromInternalField(kWrapperObjectIndex));
+}
+
+/**
+ * UnwrapReceiver() for a callback's This(); throws a TypeError and
+ * returns nullptr if it has no C object.
+ */
+template <typename T>
+inline T* UnwrapReceiver(const v8::FunctionCallbackInfo<v8::Value>& info) {
+    T* obj = UnwrapReceiver<T>(info.This());
+    if (!obj) {
+        v8::Isolate* isolate = info.GetIsolate();
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Illegal invocation")));
+    }
+    return obj;
+}
+
+} // namespace v8_dom
+
+#endif // V8_DOM_WRAPPER_TYPE_INFO_H
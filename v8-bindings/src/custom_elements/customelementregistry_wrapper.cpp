@@ -0,0 +1,440 @@
+#include "customelementregistry_wrapper.h"
+#include <memory>
+#include <string>
+#include <vector>
+#include "../wrapper_cache.h"
+#include "../core/template_cache.h"
+#include "../core/utilities.h"
+#include "../core/binding_state.h"
+#include "../core/string_cache.h"
+#include "../core/atom_table.h"
+#include "../nodes/node_wrapper.h"
+#include "../nodes/element_wrapper.h"
+#include "../nodes/document_wrapper.h"
+
+namespace v8_dom {
+
+const WrapperTypeInfo CustomElementRegistryWrapper::kTypeInfo = {"CustomElementRegistry", nullptr};
+
+namespace {
+
+/**
+ * Script side of one definition: the C registry's context for it.
+ * Deleted by the registry (through Release) with the document.
+ */
+struct ScriptDefinition {
+    v8::Isolate* isolate;
+    v8::Global<v8::Context> context;
+    v8::Global<v8::Function> constructor;
+    v8::Global<v8::Object> prototype;
+    v8::Global<v8::Function> connected;
+    v8::Global<v8::Function> disconnected;
+    v8::Global<v8::Function> adopted;
+    v8::Global<v8::Function> attribute_changed;
+
+    // Wrappers being upgraded; an empty entry is the "already constructed"
+    // marker left once super() has returned the element
+    std::vector<v8::Global<v8::Object>> construction_stack;
+};
+
+// Upgrades running on this thread (isolates are thread-confined). While
+// there are none, only the bindings may run the Element constructor.
+thread_local int upgrades_running = 0;
+
+v8::Local<v8::Private> DefinitionKey(v8::Isolate* isolate) {
+    return v8::Private::ForApi(isolate, v8::String::NewFromUtf8Literal(isolate, "v8_dom::CustomElementDefinition"));
+}
+
+/**
+ * The definition a constructor was defined with, or nullptr.
+ */
+ScriptDefinition* DefinitionOf(v8::Isolate* isolate, v8::Local<v8::Context> context,
+                               v8::Local<v8::Value> constructor) {
+    if (!constructor->IsObject()) {
+        return nullptr;
+    }
+    v8::Local<v8::Value> data;
+    if (!constructor.As<v8::Object>()->GetPrivate(context, DefinitionKey(isolate)).ToLocal(&data) ||
+        !data->IsExternal()) {
+        return nullptr;
+    }
+    return static_cast<ScriptDefinition*>(data.As<v8::External>()->Value());
+}
+
+/**
+ * Call one lifecycle callback with the element's wrapper as receiver.
+ * Exceptions are reported, not propagated.
+ */
+template <typename BuildArgs>
+void InvokeCallback(ScriptDefinition* def, const v8::Global<v8::Function>& callback,
+                    DOMElement* element, BuildArgs build_args) {
+    v8::Isolate* isolate = def->isolate;
+    v8::HandleScope handle_scope(isolate);
+    v8::Local<v8::Context> context = def->context.Get(isolate);
+    v8::Context::Scope context_scope(context);
+
+    v8::Local<v8::Object> wrapper = ElementWrapper::Wrap(isolate, context, element);
+    v8::Local<v8::Value> argv[4];
+    int argc = build_args(isolate, context, argv);
+
+    v8::TryCatch try_catch(isolate);
+    try_catch.SetVerbose(true);
+    (void)callback.Get(isolate)->Call(context, wrapper, argc, argv);
+}
+
+v8::Local<v8::Value> OptionalString(v8::Isolate* isolate, const DOMStringView* view, DOMElement* element) {
+    if (!view) {
+        return v8::Null(isolate);
+    }
+    return StringViewToV8String(isolate, *view, (DOMNode*)element);
+}
+
+// ===== C callbacks =====
+
+int Construct(DOMElement* element, void* ctx) {
+    ScriptDefinition* def = static_cast<ScriptDefinition*>(ctx);
+    v8::Isolate* isolate = def->isolate;
+    v8::HandleScope handle_scope(isolate);
+    v8::Local<v8::Context> context = def->context.Get(isolate);
+    v8::Context::Scope context_scope(context);
+
+    v8::Local<v8::Object> wrapper = ElementWrapper::Wrap(isolate, context, element);
+    def->construction_stack.emplace_back(isolate, wrapper);
+    upgrades_running++;
+
+    // Exceptions are reported, not propagated; the element is then "failed"
+    v8::TryCatch try_catch(isolate);
+    try_catch.SetVerbose(true);
+    v8::Local<v8::Object> result;
+    bool constructed = def->constructor.Get(isolate)->NewInstance(context).ToLocal(&result);
+
+    upgrades_running--;
+    def->construction_stack.pop_back();
+    if (!constructed) {
+        return 1;
+    }
+    if (!result->StrictEquals(wrapper)) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Custom element constructor did not return the upgraded element")));
+        return 1;
+    }
+    return 0;
+}
+
+void Connected(DOMElement* element, void* ctx) {
+    ScriptDefinition* def = static_cast<ScriptDefinition*>(ctx);
+    InvokeCallback(def, def->connected, element,
+                   [](v8::Isolate*, v8::Local<v8::Context>, v8::Local<v8::Value>*) { return 0; });
+}
+
+void Disconnected(DOMElement* element, void* ctx) {
+    ScriptDefinition* def = static_cast<ScriptDefinition*>(ctx);
+    InvokeCallback(def, def->disconnected, element,
+                   [](v8::Isolate*, v8::Local<v8::Context>, v8::Local<v8::Value>*) { return 0; });
+}
+
+void Adopted(DOMElement* element, DOMDocument* old_document, DOMDocument* new_document, void* ctx) {
+    ScriptDefinition* def = static_cast<ScriptDefinition*>(ctx);
+    InvokeCallback(def, def->adopted, element,
+                   [&](v8::Isolate* isolate, v8::Local<v8::Context> context, v8::Local<v8::Value>* argv) {
+                       argv[0] = DocumentWrapper::Wrap(isolate, context, old_document);
+                       argv[1] = DocumentWrapper::Wrap(isolate, context, new_document);
+                       return 2;
+                   });
+}
+
+void AttributeChanged(DOMElement* element, const DOMStringView* name,
+                      const DOMStringView* old_value, const DOMStringView* new_value,
+                      const DOMStringView* namespace_uri, void* ctx) {
+    ScriptDefinition* def = static_cast<ScriptDefinition*>(ctx);
+    InvokeCallback(def, def->attribute_changed, element,
+                   [&](v8::Isolate* isolate, v8::Local<v8::Context>, v8::Local<v8::Value>* argv) {
+                       argv[0] = NameViewToV8String(isolate, *name, (DOMNode*)element);
+                       argv[1] = OptionalString(isolate, old_value, element);
+                       argv[2] = OptionalString(isolate, new_value, element);
+                       argv[3] = OptionalString(isolate, namespace_uri, element);
+                       return 4;
+                   });
+}
+
+void Release(void* ctx) {
+    delete static_cast<ScriptDefinition*>(ctx);
+}
+
+/**
+ * Read an optional lifecycle callback off the prototype (spec: converted
+ * once, at define time). False with an exception if it is not callable.
+ */
+bool GetLifecycleCallback(v8::Isolate* isolate, v8::Local<v8::Context> context,
+                          v8::Local<v8::Object> prototype, v8::Local<v8::String> name,
+                          v8::Global<v8::Function>* out) {
+    v8::Local<v8::Value> value;
+    if (!prototype->Get(context, name).ToLocal(&value)) {
+        return false;
+    }
+    if (value->IsUndefined()) {
+        return true;
+    }
+    if (!value->IsFunction()) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Custom element lifecycle callbacks must be functions")));
+        return false;
+    }
+    out->Reset(isolate, value.As<v8::Function>());
+    return true;
+}
+
+} // namespace
+
+v8::Local<v8::Object> CustomElementRegistryWrapper::Wrap(v8::Isolate* isolate,
+                                                         v8::Local<v8::Context> context,
+                                                         DOMCustomElementRegistry* obj) {
+    return WrapWithTraits<CustomElementRegistryWrapper>(isolate, context, obj);
+}
+
+DOMCustomElementRegistry* CustomElementRegistryWrapper::Unwrap(v8::Local<v8::Object> obj) {
+    return UnwrapWithTraits<CustomElementRegistryWrapper>(obj);
+}
+
+const PropertyDescriptor CustomElementRegistryWrapper::kProperties[] = {
+    // Methods
+    MethodProperty("define", Define, 2),
+    MethodProperty("get", Get, 1),
+    MethodProperty("upgrade", Upgrade, 1),
+};
+
+void CustomElementRegistryWrapper::InstallTemplate(v8::Isolate* isolate) {
+    v8::Local<v8::FunctionTemplate> tmpl = v8::FunctionTemplate::New(isolate);
+    tmpl->SetClassName(v8::String::NewFromUtf8Literal(isolate, "CustomElementRegistry"));
+    tmpl->InstanceTemplate()->SetInternalFieldCount(kWrapperFieldCount);
+
+    InstallProperties(isolate, tmpl, kProperties);
+
+    // Cache the template
+    TemplateCache* cache = TemplateCache::ForIsolate(isolate);
+    cache->Set(kTemplateIndex, tmpl);
+}
+
+v8::Local<v8::FunctionTemplate> CustomElementRegistryWrapper::GetTemplate(v8::Isolate* isolate) {
+    TemplateCache* cache = TemplateCache::ForIsolate(isolate);
+
+    if (!cache->Has(kTemplateIndex)) {
+        InstallTemplate(isolate);
+    }
+
+    return cache->Get(kTemplateIndex);
+}
+
+void CustomElementRegistryWrapper::RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+    registry->Register(CustomElementsGetter);
+    registry->Register(ConstructElement);
+    RegisterProperties(registry, kProperties);
+}
+
+void CustomElementRegistryWrapper::RestoreClass(v8::Isolate* isolate,
+                                                v8::Local<v8::Context> context,
+                                                DOMElement* element,
+                                                v8::Local<v8::Object> wrapper) {
+    void* ctx = dom_element_get_customelementcontext(element);
+    if (!ctx) {
+        return;
+    }
+    ScriptDefinition* def = static_cast<ScriptDefinition*>(ctx);
+    (void)wrapper->SetPrototype(context, def->prototype.Get(isolate));
+}
+
+// ============================================================================
+// Global accessor and Element constructor
+// ============================================================================
+
+void CustomElementRegistryWrapper::CustomElementsGetter(v8::Local<v8::Name> property,
+                                                        const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("CustomElementRegistryWrapper::CustomElementsGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+
+    DOMDocument* document = BindingState::ForIsolate(isolate)->Document();
+    DOMCustomElementRegistry* registry = dom_document_get_customelementregistry(document);
+    if (!registry) {
+        ThrowDOMException(isolate, 22);
+        return;
+    }
+    info.GetReturnValue().Set(Wrap(isolate, context, registry));
+}
+
+void CustomElementRegistryWrapper::ConstructElement(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    // Wrapper creation: `this` is the new wrapper
+    if (wrappers_being_created > 0) {
+        return;
+    }
+
+    // Anything but super() from an upgrade (`new Element()`, a custom
+    // element class constructed by script) has no element behind `this`
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    ScriptDefinition* def = upgrades_running > 0 ? DefinitionOf(isolate, context, args.NewTarget()) : nullptr;
+    if (!def || def->construction_stack.empty()) {
+        IllegalConstructor(args);
+        return;
+    }
+
+    // super() from the class being upgraded: `this` is the element
+    v8::Global<v8::Object>& entry = def->construction_stack.back();
+    if (entry.IsEmpty()) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Custom element constructor called super() more than once")));
+        return;
+    }
+    v8::Local<v8::Object> element = entry.Get(isolate);
+    entry.Reset();
+    if (element->SetPrototype(context, def->prototype.Get(isolate)).IsNothing()) {
+        return;
+    }
+    args.GetReturnValue().Set(element);
+}
+
+// ============================================================================
+// Method Implementations
+// ============================================================================
+
+void CustomElementRegistryWrapper::Define(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("CustomElementRegistryWrapper::Define");
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    DOMCustomElementRegistry* registry = UnwrapReceiver<DOMCustomElementRegistry>(args);
+    if (!registry) {
+        return;
+    }
+
+    if (args.Length() < 2 || !args[1]->IsFunction()) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "CustomElementRegistry.define requires a name and a constructor")));
+        return;
+    }
+    CStringFromV8 name(isolate, args[0]);
+    v8::Local<v8::Function> constructor = args[1].As<v8::Function>();
+
+    // A constructor defines one name (spec step 3)
+    if (DefinitionOf(isolate, context, constructor)) {
+        ThrowDOMException(isolate, 9);
+        return;
+    }
+
+    v8::Local<v8::Value> prototype;
+    if (!constructor->Get(context, v8::String::NewFromUtf8Literal(isolate, "prototype")).ToLocal(&prototype)) {
+        return;
+    }
+    if (!prototype->IsObject()) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Custom element constructor prototype must be an object")));
+        return;
+    }
+    v8::Local<v8::Object> proto = prototype.As<v8::Object>();
+
+    auto def = std::make_unique<ScriptDefinition>();
+    def->isolate = isolate;
+    def->context.Reset(isolate, context);
+    def->constructor.Reset(isolate, constructor);
+    def->prototype.Reset(isolate, proto);
+    if (!GetLifecycleCallback(isolate, context, proto, v8::String::NewFromUtf8Literal(isolate, "connectedCallback"), &def->connected) ||
+        !GetLifecycleCallback(isolate, context, proto, v8::String::NewFromUtf8Literal(isolate, "disconnectedCallback"), &def->disconnected) ||
+        !GetLifecycleCallback(isolate, context, proto, v8::String::NewFromUtf8Literal(isolate, "adoptedCallback"), &def->adopted) ||
+        !GetLifecycleCallback(isolate, context, proto, v8::String::NewFromUtf8Literal(isolate, "attributeChangedCallback"), &def->attribute_changed)) {
+        return;
+    }
+
+    // observedAttributes is only read with an attributeChangedCallback
+    std::vector<std::string> observed;
+    if (!def->attribute_changed.IsEmpty()) {
+        v8::Local<v8::Value> list;
+        if (!constructor->Get(context, v8::String::NewFromUtf8Literal(isolate, "observedAttributes")).ToLocal(&list)) {
+            return;
+        }
+        if (!list->IsUndefined()) {
+            if (!list->IsArray()) {
+                isolate->ThrowException(v8::Exception::TypeError(
+                    v8::String::NewFromUtf8Literal(isolate, "observedAttributes must be an array of strings")));
+                return;
+            }
+            v8::Local<v8::Array> array = list.As<v8::Array>();
+            uint32_t count = array->Length();
+            observed.reserve(count);
+            for (uint32_t i = 0; i < count; i++) {
+                v8::Local<v8::Value> item;
+                if (!array->Get(context, i).ToLocal(&item)) {
+                    return;
+                }
+                observed.push_back(V8StringToStdString(isolate, item));
+            }
+        }
+    }
+    std::vector<const char*> observed_names;
+    observed_names.reserve(observed.size());
+    for (const std::string& attribute : observed) {
+        observed_names.push_back(attribute.c_str());
+    }
+
+    DOMCustomElementCallbacks callbacks = {
+        def.get(),
+        Construct,
+        def->connected.IsEmpty() ? nullptr : Connected,
+        def->disconnected.IsEmpty() ? nullptr : Disconnected,
+        def->adopted.IsEmpty() ? nullptr : Adopted,
+        def->attribute_changed.IsEmpty() ? nullptr : AttributeChanged,
+        Release,
+    };
+
+    // Set before defining: define() upgrades the existing elements, whose
+    // super() calls find the definition through the constructor
+    constructor->SetPrivate(context, DefinitionKey(isolate), v8::External::New(isolate, def.get())).Check();
+
+    int result = dom_customelementregistry_define(registry, name, &callbacks, observed_names.data(),
+                                                  static_cast<uint32_t>(observed_names.size()));
+    if (result != 0) {
+        constructor->DeletePrivate(context, DefinitionKey(isolate)).Check();
+        ThrowDOMException(isolate, result);
+        return;
+    }
+    // The registry owns the definition now
+    (void)def.release();
+}
+
+void CustomElementRegistryWrapper::Get(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("CustomElementRegistryWrapper::Get");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMCustomElementRegistry* registry = UnwrapReceiver<DOMCustomElementRegistry>(args);
+    if (!registry) {
+        return;
+    }
+
+    CStringFromV8 name(isolate, args.Length() > 0 ? args[0] : v8::Undefined(isolate).As<v8::Value>());
+    void* ctx = dom_customelementregistry_get(registry, name);
+    if (!ctx) {
+        args.GetReturnValue().SetUndefined();
+        return;
+    }
+    args.GetReturnValue().Set(static_cast<ScriptDefinition*>(ctx)->constructor.Get(isolate));
+}
+
+void CustomElementRegistryWrapper::Upgrade(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("CustomElementRegistryWrapper::Upgrade");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMCustomElementRegistry* registry = UnwrapReceiver<DOMCustomElementRegistry>(args);
+    if (!registry) {
+        return;
+    }
+
+    DOMNode* root = args.Length() > 0 && args[0]->IsObject() ? NodeWrapper::Unwrap(args[0].As<v8::Object>()) : nullptr;
+    if (!root) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "CustomElementRegistry.upgrade requires a Node")));
+        return;
+    }
+
+    int result = dom_customelementregistry_upgrade(registry, root);
+    if (result != 0) {
+        ThrowDOMException(isolate, result);
+    }
+}
+
+} // namespace v8_dom
@@ -0,0 +1,104 @@
+/**
+ * CustomElementRegistry Wrapper - V8 bindings for window.customElements
+ *
+ * Definitions live in the C registry of the isolate's document, keyed by
+ * interned name, so every createElement() looks its name up with one
+ * pointer hash. A definition's C callbacks call straight into script: one
+ * Function::Call per element and reaction, with no intermediate arrays.
+ * define() and upgrade() enqueue an upgrade reaction per existing element
+ * and run them in one pass before returning.
+ *
+ * Custom element classes extend Element. While an element is upgraded its
+ * wrapper sits on the definition's construction stack, and the Element
+ * constructor (reached through super()) returns that wrapper with the
+ * class prototype, so `this` is the upgraded element. Constructing a
+ * custom element class directly (`new XItem()`), like `new Element()`,
+ * throws "Illegal constructor".
+ */
+
+#ifndef V8_DOM_CUSTOMELEMENTREGISTRY_WRAPPER_H
+#define V8_DOM_CUSTOMELEMENTREGISTRY_WRAPPER_H
+
+#include <v8.h>
+#include "../core/wrapper_traits.h"
+#include "../core/external_references.h"
+#include "../core/property_table.h"
+#include "dom.h"
+
+namespace v8_dom {
+
+class CustomElementRegistryWrapper {
+public:
+    /**
+     * Wrap a C DOMCustomElementRegistry pointer in a V8 object.
+     * Uses wrapper cache for identity preservation.
+     */
+    static v8::Local<v8::Object> Wrap(v8::Isolate* isolate,
+                                      v8::Local<v8::Context> context,
+                                      DOMCustomElementRegistry* obj);
+
+    /**
+     * Unwrap a V8 object to get the C DOMCustomElementRegistry pointer.
+     */
+    static DOMCustomElementRegistry* Unwrap(v8::Local<v8::Object> obj);
+
+    /**
+     * Global customElements accessor, installed by InstallDOMBindings().
+     */
+    static void CustomElementsGetter(v8::Local<v8::Name> property,
+                                     const v8::PropertyCallbackInfo<v8::Value>& info);
+
+    /**
+     * Element constructor call handler, installed by ElementWrapper: returns
+     * the element being upgraded (see the file comment), lets the bindings
+     * create wrappers, and throws a TypeError otherwise.
+     */
+    static void ConstructElement(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+    /**
+     * Give a new wrapper of an upgraded element its class prototype back
+     * (the previous wrapper was collected). No-op for other elements.
+     */
+    static void RestoreClass(v8::Isolate* isolate,
+                             v8::Local<v8::Context> context,
+                             DOMElement* element,
+                             v8::Local<v8::Object> wrapper);
+
+    /**
+     * Install the CustomElementRegistry template (called once per isolate).
+     */
+    static void InstallTemplate(v8::Isolate* isolate);
+
+    /**
+     * Get the cached CustomElementRegistry template.
+     */
+    static v8::Local<v8::FunctionTemplate> GetTemplate(v8::Isolate* isolate);
+
+    /**
+     * Template cache index.
+     */
+    static constexpr int kTemplateIndex = WrapperTraits<CustomElementRegistryWrapper>::kTemplateIndex;
+
+    /**
+     * Type tag stored in the wrapper's type internal field.
+     */
+    static const WrapperTypeInfo kTypeInfo;
+
+    /**
+     * Register this wrapper's callbacks for snapshot serialization.
+     */
+    static void RegisterExternalReferences(ExternalReferenceRegistry* registry);
+
+private:
+    // Prototype members, installed by InstallTemplate()
+    static const PropertyDescriptor kProperties[];
+
+    // Methods
+    static void Define(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void Get(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void Upgrade(const v8::FunctionCallbackInfo<v8::Value>& args);
+};
+
+} // namespace v8_dom
+
+#endif // V8_DOM_CUSTOMELEMENTREGISTRY_WRAPPER_H
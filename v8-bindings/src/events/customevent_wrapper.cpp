@@ -2,72 +2,38 @@
 #include "../wrapper_cache.h"
 #include "../core/template_cache.h"
 #include "../core/utilities.h"
+#include "../core/binding_state.h"
+#include "../core/property_keys.h"
 
 namespace v8_dom {
 
+const WrapperTypeInfo CustomEventWrapper::kTypeInfo = {"CustomEvent", &EventWrapper::kTypeInfo};
+
 v8::Local<v8::Object> CustomEventWrapper::Wrap(v8::Isolate* isolate,
                                               v8::Local<v8::Context> context,
                                               DOMCustomEvent* obj) {
-    if (!obj) {
-        return v8::Local<v8::Object>();
-    }
-    
-    // Check wrapper cache first
-    WrapperCache* cache = WrapperCache::ForIsolate(isolate);
-    if (cache->Has(obj)) {
-        return cache->Get(isolate, obj);
-    }
-    
-    // Create new wrapper
-    v8::EscapableHandleScope handle_scope(isolate);
-    v8::Local<v8::FunctionTemplate> tmpl = GetTemplate(isolate);
-    v8::Local<v8::Function> constructor = tmpl->GetFunction(context).ToLocalChecked();
-    v8::Local<v8::Object> wrapper = constructor->NewInstance(context).ToLocalChecked();
-    
-    // Store C pointer in internal field
-    wrapper->SetInternalField(0, v8::External::New(isolate, obj));
-    
-    // Increment C-side reference count
-    dom_customevent_addref(obj);
-    
-    // Cache with release callback
-    cache->Set(isolate, obj, wrapper, [](void* ptr) {
-        dom_customevent_release(static_cast<DOMCustomEvent*>(ptr));
-    });
-    
-    return handle_scope.Escape(wrapper);
+    return WrapWithTraits<CustomEventWrapper>(isolate, context, obj);
 }
 
 DOMCustomEvent* CustomEventWrapper::Unwrap(v8::Local<v8::Object> obj) {
-    if (obj.IsEmpty() || obj->InternalFieldCount() < 1) {
-        return nullptr;
-    }
-    
-    v8::Local<v8::Value> ptr = obj->GetInternalField(0).As<v8::Value>();
-    if (!ptr->IsExternal()) {
-        return nullptr;
-    }
-    
-    return static_cast<DOMCustomEvent*>(v8::Local<v8::External>::Cast(ptr)->Value());
+    return UnwrapWithTraits<CustomEventWrapper>(obj);
 }
 
+const PropertyDescriptor CustomEventWrapper::kProperties[] = {
+    // Readonly properties
+    DataProperty("detail", DetailGetter),
+};
+
 void CustomEventWrapper::InstallTemplate(v8::Isolate* isolate) {
-    v8::Local<v8::FunctionTemplate> tmpl = v8::FunctionTemplate::New(isolate);
+    v8::Local<v8::FunctionTemplate> tmpl = v8::FunctionTemplate::New(isolate, Constructor);
     tmpl->SetClassName(v8::String::NewFromUtf8Literal(isolate, "CustomEvent"));
-    tmpl->InstanceTemplate()->SetInternalFieldCount(1);
+    tmpl->SetLength(1);
+    tmpl->InstanceTemplate()->SetInternalFieldCount(kFieldCount);
     
     // Inherit from Event
     tmpl->Inherit(EventWrapper::GetTemplate(isolate));
-
-    // Get prototype template for adding properties/methods
-    v8::Local<v8::ObjectTemplate> proto = tmpl->PrototypeTemplate();
     
-    // TODO: Add properties and methods here
-    // Example:
-    // proto->SetNativeDataProperty(v8::String::NewFromUtf8Literal(isolate, "propertyName"),
-    //                   PropertyNameGetter, PropertyNameSetter);
-    // proto->Set(v8::String::NewFromUtf8Literal(isolate, "methodName"),
-    //           v8::FunctionTemplate::New(isolate, MethodName));
+    InstallProperties(isolate, tmpl, kProperties);
     
     // Cache the template
     TemplateCache* cache = TemplateCache::ForIsolate(isolate);
@@ -84,4 +50,94 @@ v8::Local<v8::FunctionTemplate> CustomEventWrapper::GetTemplate(v8::Isolate* iso
     return cache->Get(kTemplateIndex);
 }
 
+void CustomEventWrapper::RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+    registry->Register(Constructor);
+    RegisterProperties(registry, kProperties);
+}
+
+// ===== Constructor =====
+
+void CustomEventWrapper::Constructor(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("CustomEventWrapper::Constructor");
+    // Wrap() instantiates this template for events C created; the
+    // bindings fill in the wrapper fields themselves
+    if (wrappers_being_created > 0) {
+        return;
+    }
+    v8::Isolate* isolate = args.GetIsolate();
+    if (!args.IsConstructCall()) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Failed to construct 'CustomEvent': Please use the 'new' operator")));
+        return;
+    }
+    if (args.Length() < 1) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Failed to construct 'CustomEvent': 1 argument required")));
+        return;
+    }
+    
+    // constructor(DOMString type, optional CustomEventInit eventInitDict = {})
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    v8::Local<v8::String> type;
+    if (!args[0]->ToString(context).ToLocal(&type)) {
+        return;
+    }
+    EventInit init;
+    if (!ReadEventInit(isolate, context, args[1], &init)) {
+        return;
+    }
+    
+    // detail follows composed in member order; ReadEventInit has already
+    // rejected non-objects
+    v8::Local<v8::Value> detail = v8::Null(isolate);
+    if (args[1]->IsObject()) {
+        v8::Local<v8::Value> value;
+        if (!args[1].As<v8::Object>()->Get(context, BindingState::ForIsolate(isolate)->Keys()->Get(
+                isolate, PropertyKey::kDetail)).ToLocal(&value)) {
+            return;
+        }
+        if (!value->IsUndefined()) {
+            detail = value;
+        }
+    }
+    
+    CStringFromV8 type_str(isolate, type);
+    DOMCustomEvent* event = dom_customevent_new(type_str.get(), init.bubbles, init.cancelable,
+                                                init.composed, nullptr);
+    if (!event) {
+        isolate->ThrowException(v8::Exception::Error(
+            v8::String::NewFromUtf8Literal(isolate, "Failed to create CustomEvent")));
+        return;
+    }
+    
+    v8::Local<v8::Object> wrapper = args.This();
+    SetWrapperFields(wrapper, event, &kTypeInfo);
+    wrapper->SetInternalField(kDetailField, detail);
+    WrapperCache::ForIsolate(isolate)->Set(isolate, event, wrapper,
+                                           WrapperTraits<CustomEventWrapper>::kRelease);
+}
+
+// ===== Readonly Property Getters =====
+
+void CustomEventWrapper::DetailGetter(v8::Local<v8::Name> property,
+                                     const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("CustomEventWrapper::DetailGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    v8::Local<v8::Object> self = info.This();
+    
+    if (!Unwrap(self)) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Invalid CustomEvent object")));
+        return;
+    }
+    
+    // Unset on wrappers of events C code created
+    v8::Local<v8::Value> detail = self->GetInternalField(kDetailField).As<v8::Value>();
+    if (detail->IsUndefined()) {
+        info.GetReturnValue().SetNull();
+        return;
+    }
+    info.GetReturnValue().Set(detail);
+}
+
 } // namespace v8_dom
@@ -3,12 +3,20 @@
  * 
  * Auto-generated wrapper for DOMCustomEvent.
  * Provides JavaScript interface for CustomEvent operations.
+ * 
+ * new CustomEvent(type, {detail}) keeps detail in an internal field of the
+ * wrapper as a V8 value: nothing is allocated for it on the C side, and the
+ * C event's detail pointer stays NULL. Events created by C code have no
+ * detail value and report null.
  */
 
 #ifndef V8_DOM_CUSTOMEVENT_WRAPPER_H
 #define V8_DOM_CUSTOMEVENT_WRAPPER_H
 
 #include <v8.h>
+#include "../core/wrapper_traits.h"
+#include "../core/external_references.h"
+#include "../core/property_table.h"
 #include "event_wrapper.h"
 #include "dom.h"
 
@@ -42,11 +50,34 @@ public:
     /**
      * Template cache index.
      */
-    static constexpr int kTemplateIndex = 18;
+    static constexpr int kTemplateIndex = WrapperTraits<CustomEventWrapper>::kTemplateIndex;
+    
+    /**
+     * Type tag stored in the wrapper's type internal field.
+     */
+    static const WrapperTypeInfo kTypeInfo;
+    
+    /**
+     * Register this wrapper's callbacks for snapshot serialization.
+     */
+    static void RegisterExternalReferences(ExternalReferenceRegistry* registry);
     
 private:
-    // Property getters/setters and methods will be added here
-    // TODO: Parse dom.h to auto-generate these declarations
+    // Internal fields after the shared wrapper fields
+    enum Field {
+        kDetailField = kWrapperFieldCount,
+        kFieldCount,
+    };
+    
+    // Prototype members, installed by InstallTemplate()
+    static const PropertyDescriptor kProperties[];
+    
+    // Constructor
+    static void Constructor(const v8::FunctionCallbackInfo<v8::Value>& args);
+    
+    // Readonly properties
+    static void DetailGetter(v8::Local<v8::Name> property,
+                            const v8::PropertyCallbackInfo<v8::Value>& info);
 };
 
 } // namespace v8_dom
@@ -2,109 +2,287 @@
 #include "../wrapper_cache.h"
 #include "../core/template_cache.h"
 #include "../core/utilities.h"
+#include "../core/property_keys.h"
+#include "../nodes/eventtarget_wrapper.h"
 
 namespace v8_dom {
 
+const WrapperTypeInfo EventWrapper::kTypeInfo = {"Event", nullptr};
+
+namespace {
+
+v8::Local<v8::Private> ComposedPathKey(v8::Isolate* isolate) {
+    return v8::Private::ForApi(isolate, v8::String::NewFromUtf8Literal(isolate, "v8_dom::composedPath"));
+}
+
+v8::Local<v8::Private> ComposedPathDispatchKey(v8::Isolate* isolate) {
+    return v8::Private::ForApi(isolate, v8::String::NewFromUtf8Literal(isolate, "v8_dom::composedPathDispatch"));
+}
+
+} // namespace
+
 v8::Local<v8::Object> EventWrapper::Wrap(v8::Isolate* isolate,
                                               v8::Local<v8::Context> context,
                                               DOMEvent* obj) {
-    if (!obj) {
-        return v8::Local<v8::Object>();
+    return WrapWithTraits<EventWrapper>(isolate, context, obj);
+}
+
+DOMEvent* EventWrapper::Unwrap(v8::Local<v8::Object> obj) {
+    return UnwrapWithTraits<EventWrapper>(obj);
+}
+
+const PropertyDescriptor EventWrapper::kProperties[] = {
+    // Readonly properties
+    DataProperty("type", TypeGetter),
+    DataProperty("target", TargetGetter),
+    DataProperty("currentTarget", CurrentTargetGetter),
+    DataProperty("srcElement", SrcElementGetter),
+    DataProperty("eventPhase", EventPhaseGetter),
+    DataProperty("bubbles", BubblesGetter),
+    DataProperty("cancelable", CancelableGetter),
+    DataProperty("defaultPrevented", DefaultPreventedGetter),
+    DataProperty("composed", ComposedGetter),
+    DataProperty("isTrusted", IsTrustedGetter),
+    DataProperty("timeStamp", TimeStampGetter),
+    
+    // Read/write properties
+    DataProperty("cancelBubble", CancelBubbleGetter, CancelBubbleSetter),
+    DataProperty("returnValue", ReturnValueGetter, ReturnValueSetter),
+    
+    // Methods
+    MethodProperty("stopPropagation", StopPropagation),
+    MethodProperty("stopImmediatePropagation", StopImmediatePropagation),
+    MethodProperty("preventDefault", PreventDefault),
+    MethodProperty("initEvent", InitEvent),
+    MethodProperty("composedPath", ComposedPath),
+};
+
+void EventWrapper::InstallTemplate(v8::Isolate* isolate) {
+    v8::Local<v8::FunctionTemplate> tmpl = v8::FunctionTemplate::New(isolate, Constructor);
+    tmpl->SetClassName(v8::String::NewFromUtf8Literal(isolate, "Event"));
+    tmpl->SetLength(1);
+    tmpl->InstanceTemplate()->SetInternalFieldCount(kWrapperFieldCount);
+    
+    InstallProperties(isolate, tmpl, kProperties);
+    
+    // Cache the template
+    TemplateCache* cache = TemplateCache::ForIsolate(isolate);
+    cache->Set(kTemplateIndex, tmpl);
+}
+
+v8::Local<v8::FunctionTemplate> EventWrapper::GetTemplate(v8::Isolate* isolate) {
+    TemplateCache* cache = TemplateCache::ForIsolate(isolate);
+    
+    if (!cache->Has(kTemplateIndex)) {
+        InstallTemplate(isolate);
     }
     
-    // Check wrapper cache first
-    WrapperCache* cache = WrapperCache::ForIsolate(isolate);
-    if (cache->Has(obj)) {
-        return cache->Get(isolate, obj);
+    return cache->Get(kTemplateIndex);
+}
+
+void EventWrapper::RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+    registry->Register(Constructor);
+    RegisterProperties(registry, kProperties);
+}
+
+bool EventWrapper::ReadEventInit(v8::Isolate* isolate,
+                                 v8::Local<v8::Context> context,
+                                 v8::Local<v8::Value> value,
+                                 EventInit* init) {
+    if (value.IsEmpty() || value->IsNullOrUndefined()) {
+        return true;
+    }
+    if (!value->IsObject()) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "The provided value is not of type 'EventInit'")));
+        return false;
     }
     
-    // Create new wrapper
-    v8::EscapableHandleScope handle_scope(isolate);
-    v8::Local<v8::FunctionTemplate> tmpl = GetTemplate(isolate);
-    v8::Local<v8::Function> constructor = tmpl->GetFunction(context).ToLocalChecked();
-    v8::Local<v8::Object> wrapper = constructor->NewInstance(context).ToLocalChecked();
+    // Members in WebIDL (lexicographic) order
+    v8::Local<v8::Object> dict = value.As<v8::Object>();
+    return ReadBooleanMember(isolate, context, dict, PropertyKey::kBubbles, &init->bubbles) &&
+           ReadBooleanMember(isolate, context, dict, PropertyKey::kCancelable, &init->cancelable) &&
+           ReadBooleanMember(isolate, context, dict, PropertyKey::kComposed, &init->composed);
+}
+
+// ===== Constructor =====
+
+void EventWrapper::Constructor(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("EventWrapper::Constructor");
+    // Wrap() instantiates this template for events C created; the
+    // bindings fill in the wrapper fields themselves
+    if (wrappers_being_created > 0) {
+        return;
+    }
+    v8::Isolate* isolate = args.GetIsolate();
+    if (!args.IsConstructCall()) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Failed to construct 'Event': Please use the 'new' operator")));
+        return;
+    }
+    if (args.Length() < 1) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Failed to construct 'Event': 1 argument required")));
+        return;
+    }
     
-    // Store C pointer in internal field
-    wrapper->SetInternalField(0, v8::External::New(isolate, obj));
+    // constructor(DOMString type, optional EventInit eventInitDict = {})
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    v8::Local<v8::String> type;
+    if (!args[0]->ToString(context).ToLocal(&type)) {
+        return;
+    }
+    EventInit init;
+    if (!ReadEventInit(isolate, context, args[1], &init)) {
+        return;
+    }
+    
+    CStringFromV8 type_str(isolate, type);
+    DOMEvent* event = dom_event_new(type_str.get(), init.bubbles, init.cancelable, init.composed);
+    if (!event) {
+        isolate->ThrowException(v8::Exception::Error(
+            v8::String::NewFromUtf8Literal(isolate, "Failed to create Event")));
+        return;
+    }
     
-    // Increment C-side reference count
-    dom_event_addref(obj);
+    // The wrapper adopts the initial reference; listeners of its dispatches
+    // get it back from the wrapper cache
+    v8::Local<v8::Object> wrapper = args.This();
+    SetWrapperFields(wrapper, event, &kTypeInfo);
+    WrapperCache::ForIsolate(isolate)->Set(isolate, event, wrapper,
+                                           WrapperTraits<EventWrapper>::kRelease);
+}
+
+// ===== Readonly Property Getters =====
+
+void EventWrapper::TypeGetter(v8::Local<v8::Name> property,
+                             const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("EventWrapper::TypeGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    DOMEvent* event = Unwrap(info.This());
     
-    // Cache with release callback
-    cache->Set(isolate, obj, wrapper, [](void* ptr) {
-        dom_event_release(static_cast<DOMEvent*>(ptr));
-    });
+    if (!event) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Invalid Event object")));
+        return;
+    }
     
-    return handle_scope.Escape(wrapper);
+    // Types are a small vocabulary compared against in listeners
+    v8::Local<v8::String> type;
+    if (v8::String::NewFromUtf8(isolate, dom_event_get_type(event),
+                                v8::NewStringType::kInternalized).ToLocal(&type)) {
+        info.GetReturnValue().Set(type);
+    }
 }
 
-DOMEvent* EventWrapper::Unwrap(v8::Local<v8::Object> obj) {
-    if (obj.IsEmpty() || obj->InternalFieldCount() < 1) {
-        return nullptr;
+void EventWrapper::EventPhaseGetter(v8::Local<v8::Name> property,
+                                   const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("EventWrapper::EventPhaseGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    DOMEvent* event = Unwrap(info.This());
+    
+    if (!event) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Invalid Event object")));
+        return;
     }
     
-    v8::Local<v8::Value> ptr = obj->GetInternalField(0).As<v8::Value>();
-    if (!ptr->IsExternal()) {
-        return nullptr;
+    info.GetReturnValue().Set(static_cast<uint32_t>(dom_event_get_eventphase(event)));
+}
+
+void EventWrapper::BubblesGetter(v8::Local<v8::Name> property,
+                                const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("EventWrapper::BubblesGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    DOMEvent* event = Unwrap(info.This());
+    
+    if (!event) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Invalid Event object")));
+        return;
     }
     
-    return static_cast<DOMEvent*>(v8::Local<v8::External>::Cast(ptr)->Value());
+    info.GetReturnValue().Set(dom_event_get_bubbles(event) != 0);
 }
 
-void EventWrapper::InstallTemplate(v8::Isolate* isolate) {
-    v8::Local<v8::FunctionTemplate> tmpl = v8::FunctionTemplate::New(isolate);
-    tmpl->SetClassName(v8::String::NewFromUtf8Literal(isolate, "Event"));
-    tmpl->InstanceTemplate()->SetInternalFieldCount(1);
+void EventWrapper::CancelableGetter(v8::Local<v8::Name> property,
+                                   const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("EventWrapper::CancelableGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    DOMEvent* event = Unwrap(info.This());
     
+    if (!event) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Invalid Event object")));
+        return;
+    }
+    
+    info.GetReturnValue().Set(dom_event_get_cancelable(event) != 0);
+}
 
-    // Get prototype template for adding properties/methods
-    v8::Local<v8::ObjectTemplate> proto = tmpl->PrototypeTemplate();
+void EventWrapper::DefaultPreventedGetter(v8::Local<v8::Name> property,
+                                         const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("EventWrapper::DefaultPreventedGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    DOMEvent* event = Unwrap(info.This());
     
-    // Readonly properties
-    proto->SetNativeDataProperty(v8::String::NewFromUtf8Literal(isolate, "target"),
-                                 TargetGetter);
-    proto->SetNativeDataProperty(v8::String::NewFromUtf8Literal(isolate, "currentTarget"),
-                                 CurrentTargetGetter);
-    proto->SetNativeDataProperty(v8::String::NewFromUtf8Literal(isolate, "srcElement"),
-                                 SrcElementGetter);
+    if (!event) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Invalid Event object")));
+        return;
+    }
     
-    // Read/write properties
-    proto->SetNativeDataProperty(v8::String::NewFromUtf8Literal(isolate, "cancelBubble"),
-                                 CancelBubbleGetter, CancelBubbleSetter);
-    proto->SetNativeDataProperty(v8::String::NewFromUtf8Literal(isolate, "returnValue"),
-                                 ReturnValueGetter, ReturnValueSetter);
+    info.GetReturnValue().Set(dom_event_get_defaultprevented(event) != 0);
+}
+
+void EventWrapper::ComposedGetter(v8::Local<v8::Name> property,
+                                 const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("EventWrapper::ComposedGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    DOMEvent* event = Unwrap(info.This());
     
-    // Methods
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "stopPropagation"),
-               v8::FunctionTemplate::New(isolate, StopPropagation));
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "stopImmediatePropagation"),
-               v8::FunctionTemplate::New(isolate, StopImmediatePropagation));
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "preventDefault"),
-               v8::FunctionTemplate::New(isolate, PreventDefault));
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "initEvent"),
-               v8::FunctionTemplate::New(isolate, InitEvent));
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "composedPath"),
-               v8::FunctionTemplate::New(isolate, ComposedPath));
+    if (!event) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Invalid Event object")));
+        return;
+    }
     
-    // Cache the template
-    TemplateCache* cache = TemplateCache::ForIsolate(isolate);
-    cache->Set(kTemplateIndex, tmpl);
+    info.GetReturnValue().Set(dom_event_get_composed(event) != 0);
 }
 
-v8::Local<v8::FunctionTemplate> EventWrapper::GetTemplate(v8::Isolate* isolate) {
-    TemplateCache* cache = TemplateCache::ForIsolate(isolate);
+void EventWrapper::IsTrustedGetter(v8::Local<v8::Name> property,
+                                  const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("EventWrapper::IsTrustedGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    DOMEvent* event = Unwrap(info.This());
     
-    if (!cache->Has(kTemplateIndex)) {
-        InstallTemplate(isolate);
+    if (!event) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Invalid Event object")));
+        return;
     }
     
-    return cache->Get(kTemplateIndex);
+    info.GetReturnValue().Set(dom_event_get_istrusted(event) != 0);
 }
 
-// ===== Readonly Property Getters =====
+void EventWrapper::TimeStampGetter(v8::Local<v8::Name> property,
+                                  const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("EventWrapper::TimeStampGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    DOMEvent* event = Unwrap(info.This());
+    
+    if (!event) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Invalid Event object")));
+        return;
+    }
+    
+    info.GetReturnValue().Set(dom_event_get_timestamp(event));
+}
 
 void EventWrapper::TargetGetter(v8::Local<v8::Name> property,
                                const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("EventWrapper::TargetGetter");
     v8::Isolate* isolate = info.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     DOMEvent* event = Unwrap(info.This());
@@ -121,12 +299,12 @@ void EventWrapper::TargetGetter(v8::Local<v8::Name> property,
         return;
     }
     
-    // TODO: Use EventTargetWrapper::Wrap when available
-    info.GetReturnValue().SetNull();
+    info.GetReturnValue().Set(EventTargetWrapper::Wrap(isolate, context, target));
 }
 
 void EventWrapper::CurrentTargetGetter(v8::Local<v8::Name> property,
                                       const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("EventWrapper::CurrentTargetGetter");
     v8::Isolate* isolate = info.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     DOMEvent* event = Unwrap(info.This());
@@ -143,12 +321,12 @@ void EventWrapper::CurrentTargetGetter(v8::Local<v8::Name> property,
         return;
     }
     
-    // TODO: Use EventTargetWrapper::Wrap when available
-    info.GetReturnValue().SetNull();
+    info.GetReturnValue().Set(EventTargetWrapper::Wrap(isolate, context, currentTarget));
 }
 
 void EventWrapper::SrcElementGetter(v8::Local<v8::Name> property,
                                    const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("EventWrapper::SrcElementGetter");
     v8::Isolate* isolate = info.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     DOMEvent* event = Unwrap(info.This());
@@ -165,14 +343,14 @@ void EventWrapper::SrcElementGetter(v8::Local<v8::Name> property,
         return;
     }
     
-    // TODO: Use EventTargetWrapper::Wrap when available
-    info.GetReturnValue().SetNull();
+    info.GetReturnValue().Set(EventTargetWrapper::Wrap(isolate, context, srcElement));
 }
 
 // ===== Read/Write Property Getters/Setters =====
 
 void EventWrapper::CancelBubbleGetter(v8::Local<v8::Name> property,
                                      const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("EventWrapper::CancelBubbleGetter");
     v8::Isolate* isolate = info.GetIsolate();
     DOMEvent* event = Unwrap(info.This());
     
@@ -183,12 +361,13 @@ void EventWrapper::CancelBubbleGetter(v8::Local<v8::Name> property,
     }
     
     uint8_t cancelBubble = dom_event_get_cancelbubble(event);
-    info.GetReturnValue().Set(v8::Boolean::New(isolate, cancelBubble != 0));
+    info.GetReturnValue().Set(cancelBubble != 0);
 }
 
 void EventWrapper::CancelBubbleSetter(v8::Local<v8::Name> property,
                                      v8::Local<v8::Value> value,
                                      const v8::PropertyCallbackInfo<void>& info) {
+    V8_DOM_TRACE_SCOPE("EventWrapper::CancelBubbleSetter");
     v8::Isolate* isolate = info.GetIsolate();
     DOMEvent* event = Unwrap(info.This());
     
@@ -204,6 +383,7 @@ void EventWrapper::CancelBubbleSetter(v8::Local<v8::Name> property,
 
 void EventWrapper::ReturnValueGetter(v8::Local<v8::Name> property,
                                     const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("EventWrapper::ReturnValueGetter");
     v8::Isolate* isolate = info.GetIsolate();
     DOMEvent* event = Unwrap(info.This());
     
@@ -214,12 +394,13 @@ void EventWrapper::ReturnValueGetter(v8::Local<v8::Name> property,
     }
     
     uint8_t returnValue = dom_event_get_returnvalue(event);
-    info.GetReturnValue().Set(v8::Boolean::New(isolate, returnValue != 0));
+    info.GetReturnValue().Set(returnValue != 0);
 }
 
 void EventWrapper::ReturnValueSetter(v8::Local<v8::Name> property,
                                     v8::Local<v8::Value> value,
                                     const v8::PropertyCallbackInfo<void>& info) {
+    V8_DOM_TRACE_SCOPE("EventWrapper::ReturnValueSetter");
     v8::Isolate* isolate = info.GetIsolate();
     DOMEvent* event = Unwrap(info.This());
     
@@ -236,12 +417,10 @@ void EventWrapper::ReturnValueSetter(v8::Local<v8::Name> property,
 // ===== Methods =====
 
 void EventWrapper::StopPropagation(const v8::FunctionCallbackInfo<v8::Value>& args) {
-    v8::Isolate* isolate = args.GetIsolate();
-    DOMEvent* event = Unwrap(args.This());
+    V8_DOM_TRACE_SCOPE("EventWrapper::StopPropagation");
+    DOMEvent* event = UnwrapReceiver<DOMEvent>(args);
     
     if (!event) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Event object")));
         return;
     }
     
@@ -249,12 +428,10 @@ void EventWrapper::StopPropagation(const v8::FunctionCallbackInfo<v8::Value>& ar
 }
 
 void EventWrapper::StopImmediatePropagation(const v8::FunctionCallbackInfo<v8::Value>& args) {
-    v8::Isolate* isolate = args.GetIsolate();
-    DOMEvent* event = Unwrap(args.This());
+    V8_DOM_TRACE_SCOPE("EventWrapper::StopImmediatePropagation");
+    DOMEvent* event = UnwrapReceiver<DOMEvent>(args);
     
     if (!event) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Event object")));
         return;
     }
     
@@ -262,12 +439,10 @@ void EventWrapper::StopImmediatePropagation(const v8::FunctionCallbackInfo<v8::V
 }
 
 void EventWrapper::PreventDefault(const v8::FunctionCallbackInfo<v8::Value>& args) {
-    v8::Isolate* isolate = args.GetIsolate();
-    DOMEvent* event = Unwrap(args.This());
+    V8_DOM_TRACE_SCOPE("EventWrapper::PreventDefault");
+    DOMEvent* event = UnwrapReceiver<DOMEvent>(args);
     
     if (!event) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Event object")));
         return;
     }
     
@@ -275,13 +450,12 @@ void EventWrapper::PreventDefault(const v8::FunctionCallbackInfo<v8::Value>& arg
 }
 
 void EventWrapper::InitEvent(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("EventWrapper::InitEvent");
     v8::Isolate* isolate = args.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
-    DOMEvent* event = Unwrap(args.This());
+    DOMEvent* event = UnwrapReceiver<DOMEvent>(args);
     
     if (!event) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Event object")));
         return;
     }
     
@@ -307,13 +481,32 @@ void EventWrapper::InitEvent(const v8::FunctionCallbackInfo<v8::Value>& args) {
 }
 
 void EventWrapper::ComposedPath(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("EventWrapper::ComposedPath");
     v8::Isolate* isolate = args.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
-    DOMEvent* event = Unwrap(args.This());
+    v8::Local<v8::Object> wrapper = args.This();
+    DOMEvent* event = UnwrapReceiver<DOMEvent>(args);
     
     if (!event) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Event object")));
+        return;
+    }
+    
+    // Outside dispatch the path is empty
+    if (dom_event_get_eventphase(event) == 0) {
+        args.GetReturnValue().Set(v8::Array::New(isolate, 0));
+        return;
+    }
+    
+    // The path does not change during a dispatch: every listener of this
+    // dispatch gets the array materialized by the first call
+    uint32_t dispatch_id = dom_event_get_dispatchid(event);
+    v8::Local<v8::Value> cached_id;
+    v8::Local<v8::Value> cached;
+    if (wrapper->GetPrivate(context, ComposedPathDispatchKey(isolate)).ToLocal(&cached_id) &&
+        cached_id->IsUint32() && cached_id.As<v8::Uint32>()->Value() == dispatch_id &&
+        wrapper->GetPrivate(context, ComposedPathKey(isolate)).ToLocal(&cached) &&
+        cached->IsArray()) {
+        args.GetReturnValue().Set(cached);
         return;
     }
     
@@ -328,12 +521,29 @@ void EventWrapper::ComposedPath(const v8::FunctionCallbackInfo<v8::Value>& args)
     v8::Local<v8::Array> result = v8::Array::New(isolate, count);
     
     for (uint32_t i = 0; i < count; i++) {
-        // TODO: Use EventTargetWrapper::Wrap when available
-        result->Set(context, i, v8::Null(isolate)).Check();
+        v8::Local<v8::Value> item = v8::Null(isolate);
+        if (path[i]) {
+            item = EventTargetWrapper::Wrap(isolate, context, path[i]);
+        }
+        result->Set(context, i, item).Check();
     }
     
     dom_event_free_composedpath(path, count);
+    
+    // Shared between listeners, so nobody may modify it
+    result->SetIntegrityLevel(context, v8::IntegrityLevel::kFrozen).Check();
+    wrapper->SetPrivate(context, ComposedPathKey(isolate), result).Check();
+    wrapper->SetPrivate(context, ComposedPathDispatchKey(isolate),
+                        v8::Integer::NewFromUnsigned(isolate, dispatch_id)).Check();
     args.GetReturnValue().Set(result);
 }
 
+void EventWrapper::ClearComposedPath(v8::Isolate* isolate,
+                                     v8::Local<v8::Context> context,
+                                     v8::Local<v8::Object> wrapper) {
+    // Drop the array (and the wrappers it keeps alive) once dispatch is over
+    (void)wrapper->DeletePrivate(context, ComposedPathKey(isolate));
+    (void)wrapper->DeletePrivate(context, ComposedPathDispatchKey(isolate));
+}
+
 } // namespace v8_dom
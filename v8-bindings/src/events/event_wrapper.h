@@ -3,16 +3,42 @@
  * 
  * Auto-generated wrapper for DOMEvent.
  * Provides JavaScript interface for Event operations.
+ * 
+ * composedPath() is materialized once per dispatch: the frozen array is
+ * kept on the wrapper and returned to every later call of the same
+ * dispatch, then dropped when the dispatch ends.
+ * 
+ * new Event(type, init) creates the event on the C side and the wrapper
+ * adopts its reference; EventInit members are read with the isolate's
+ * cached keys (see property_keys.h).
+ * 
+ * A wrapper holds one reference to its event. Wrappers are created lazily
+ * (the first time a script listener or getter sees the event), so with the
+ * C-ABI event pool enabled, embedder events no script saw go back to the
+ * pool at the embedder's release; wrapped ones return when the wrapper is
+ * collected.
  */
 
 #ifndef V8_DOM_EVENT_WRAPPER_H
 #define V8_DOM_EVENT_WRAPPER_H
 
 #include <v8.h>
+#include "../core/wrapper_traits.h"
+#include "../core/external_references.h"
+#include "../core/property_table.h"
 #include "dom.h"
 
 namespace v8_dom {
 
+/**
+ * Members of an EventInit dictionary.
+ */
+struct EventInit {
+    bool bubbles = false;
+    bool cancelable = false;
+    bool composed = false;
+};
+
 class EventWrapper {
 public:
     /**
@@ -41,10 +67,59 @@ public:
     /**
      * Template cache index.
      */
-    static constexpr int kTemplateIndex = 17;
+    static constexpr int kTemplateIndex = WrapperTraits<EventWrapper>::kTemplateIndex;
+    
+    /**
+     * Type tag stored in the wrapper's type internal field.
+     */
+    static const WrapperTypeInfo kTypeInfo;
+    
+    /**
+     * Register this wrapper's callbacks for snapshot serialization.
+     */
+    static void RegisterExternalReferences(ExternalReferenceRegistry* registry);
+    
+    /**
+     * Drop the composedPath() array cached for the dispatch that just ended.
+     */
+    static void ClearComposedPath(v8::Isolate* isolate,
+                                  v8::Local<v8::Context> context,
+                                  v8::Local<v8::Object> wrapper);
+    
+    /**
+     * Read an (optional) EventInit argument: undefined and null give the
+     * defaults, other non-objects throw a TypeError.
+     * Returns false if an exception is pending.
+     */
+    static bool ReadEventInit(v8::Isolate* isolate,
+                              v8::Local<v8::Context> context,
+                              v8::Local<v8::Value> value,
+                              EventInit* init);
     
 private:
+    // Prototype members, installed by InstallTemplate()
+    static const PropertyDescriptor kProperties[];
+    
+    // Constructor
+    static void Constructor(const v8::FunctionCallbackInfo<v8::Value>& args);
+    
     // Readonly properties
+    static void TypeGetter(v8::Local<v8::Name> property,
+                          const v8::PropertyCallbackInfo<v8::Value>& info);
+    static void EventPhaseGetter(v8::Local<v8::Name> property,
+                                const v8::PropertyCallbackInfo<v8::Value>& info);
+    static void BubblesGetter(v8::Local<v8::Name> property,
+                             const v8::PropertyCallbackInfo<v8::Value>& info);
+    static void CancelableGetter(v8::Local<v8::Name> property,
+                                const v8::PropertyCallbackInfo<v8::Value>& info);
+    static void DefaultPreventedGetter(v8::Local<v8::Name> property,
+                                      const v8::PropertyCallbackInfo<v8::Value>& info);
+    static void ComposedGetter(v8::Local<v8::Name> property,
+                              const v8::PropertyCallbackInfo<v8::Value>& info);
+    static void IsTrustedGetter(v8::Local<v8::Name> property,
+                               const v8::PropertyCallbackInfo<v8::Value>& info);
+    static void TimeStampGetter(v8::Local<v8::Name> property,
+                               const v8::PropertyCallbackInfo<v8::Value>& info);
     static void TargetGetter(v8::Local<v8::Name> property,
                             const v8::PropertyCallbackInfo<v8::Value>& info);
     static void CurrentTargetGetter(v8::Local<v8::Name> property,
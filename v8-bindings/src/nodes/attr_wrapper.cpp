@@ -2,72 +2,59 @@
 #include "../wrapper_cache.h"
 #include "../core/template_cache.h"
 #include "../core/utilities.h"
+#include "../core/string_cache.h"
+#include "../core/atom_table.h"
+#include "element_wrapper.h"
 
 namespace v8_dom {
 
+const WrapperTypeInfo AttrWrapper::kTypeInfo = {"Attr", &NodeWrapper::kTypeInfo};
+
+namespace {
+
+DOMAttr* ThisAttr(v8::Isolate* isolate, v8::Local<v8::Object> receiver) {
+    DOMAttr* attr = AttrWrapper::Unwrap(receiver);
+    if (!attr) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Invalid Attr")));
+    }
+    return attr;
+}
+
+} // namespace
+
 v8::Local<v8::Object> AttrWrapper::Wrap(v8::Isolate* isolate,
                                               v8::Local<v8::Context> context,
                                               DOMAttr* obj) {
-    if (!obj) {
-        return v8::Local<v8::Object>();
-    }
-    
-    // Check wrapper cache first
-    WrapperCache* cache = WrapperCache::ForIsolate(isolate);
-    if (cache->Has(obj)) {
-        return cache->Get(isolate, obj);
-    }
-    
-    // Create new wrapper
-    v8::EscapableHandleScope handle_scope(isolate);
-    v8::Local<v8::FunctionTemplate> tmpl = GetTemplate(isolate);
-    v8::Local<v8::Function> constructor = tmpl->GetFunction(context).ToLocalChecked();
-    v8::Local<v8::Object> wrapper = constructor->NewInstance(context).ToLocalChecked();
-    
-    // Store C pointer in internal field
-    wrapper->SetInternalField(0, v8::External::New(isolate, obj));
-    
-    // Increment C-side reference count
-    dom_attr_addref(obj);
-    
-    // Cache with release callback
-    cache->Set(isolate, obj, wrapper, [](void* ptr) {
-        dom_attr_release(static_cast<DOMAttr*>(ptr));
-    });
-    
-    return handle_scope.Escape(wrapper);
+    return WrapWithTraits<AttrWrapper>(isolate, context, obj);
 }
 
 DOMAttr* AttrWrapper::Unwrap(v8::Local<v8::Object> obj) {
-    if (obj.IsEmpty() || obj->InternalFieldCount() < 1) {
-        return nullptr;
-    }
-    
-    v8::Local<v8::Value> ptr = obj->GetInternalField(0).As<v8::Value>();
-    if (!ptr->IsExternal()) {
-        return nullptr;
-    }
-    
-    return static_cast<DOMAttr*>(v8::Local<v8::External>::Cast(ptr)->Value());
+    return UnwrapWithTraits<AttrWrapper>(obj);
 }
 
+const PropertyDescriptor AttrWrapper::kProperties[] = {
+    // Readonly properties
+    DataProperty("namespaceURI", NamespaceURIGetter),
+    DataProperty("prefix", PrefixGetter),
+    DataProperty("localName", LocalNameGetter),
+    DataProperty("name", NameGetter),
+    DataProperty("ownerElement", OwnerElementGetter),
+    DataProperty("specified", SpecifiedGetter),
+    
+    // Read/write properties
+    AccessorProperty("value", ValueGetter, ValueSetter),
+};
+
 void AttrWrapper::InstallTemplate(v8::Isolate* isolate) {
     v8::Local<v8::FunctionTemplate> tmpl = v8::FunctionTemplate::New(isolate);
     tmpl->SetClassName(v8::String::NewFromUtf8Literal(isolate, "Attr"));
-    tmpl->InstanceTemplate()->SetInternalFieldCount(1);
+    tmpl->InstanceTemplate()->SetInternalFieldCount(kWrapperFieldCount);
     
     // Inherit from Node
     tmpl->Inherit(NodeWrapper::GetTemplate(isolate));
 
-    // Get prototype template for adding properties/methods
-    v8::Local<v8::ObjectTemplate> proto = tmpl->PrototypeTemplate();
-    
-    // TODO: Add properties and methods here
-    // Example:
-    // proto->SetNativeDataProperty(v8::String::NewFromUtf8Literal(isolate, "propertyName"),
-    //                   PropertyNameGetter, PropertyNameSetter);
-    // proto->Set(v8::String::NewFromUtf8Literal(isolate, "methodName"),
-    //           v8::FunctionTemplate::New(isolate, MethodName));
+    InstallProperties(isolate, tmpl, kProperties);
     
     // Cache the template
     TemplateCache* cache = TemplateCache::ForIsolate(isolate);
@@ -84,4 +71,134 @@ v8::Local<v8::FunctionTemplate> AttrWrapper::GetTemplate(v8::Isolate* isolate) {
     return cache->Get(kTemplateIndex);
 }
 
+void AttrWrapper::RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+    RegisterProperties(registry, kProperties);
+}
+
+// ============================================================================
+// Property Implementations - Readonly
+// ============================================================================
+
+void AttrWrapper::NamespaceURIGetter(v8::Local<v8::Name> property,
+                                     const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("AttrWrapper::NamespaceURIGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    DOMAttr* attr = ThisAttr(isolate, info.This());
+    if (!attr) {
+        return;
+    }
+    
+    DOMStringView view;
+    if (dom_attr_get_namespaceuri_view(attr, &view)) {
+        info.GetReturnValue().Set(StringViewToV8String(isolate, view, (DOMNode*)attr));
+    } else {
+        info.GetReturnValue().SetNull();
+    }
+}
+
+void AttrWrapper::PrefixGetter(v8::Local<v8::Name> property,
+                               const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("AttrWrapper::PrefixGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    DOMAttr* attr = ThisAttr(isolate, info.This());
+    if (!attr) {
+        return;
+    }
+    
+    DOMStringView view;
+    if (dom_attr_get_prefix_view(attr, &view)) {
+        info.GetReturnValue().Set(NameViewToV8String(isolate, view, (DOMNode*)attr));
+    } else {
+        info.GetReturnValue().SetNull();
+    }
+}
+
+void AttrWrapper::LocalNameGetter(v8::Local<v8::Name> property,
+                                  const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("AttrWrapper::LocalNameGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    DOMAttr* attr = ThisAttr(isolate, info.This());
+    if (!attr) {
+        return;
+    }
+    
+    DOMStringView view;
+    dom_attr_get_localname_view(attr, &view);
+    info.GetReturnValue().Set(NameViewToV8String(isolate, view, (DOMNode*)attr));
+}
+
+void AttrWrapper::NameGetter(v8::Local<v8::Name> property,
+                             const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("AttrWrapper::NameGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    DOMAttr* attr = ThisAttr(isolate, info.This());
+    if (!attr) {
+        return;
+    }
+    
+    DOMStringView view;
+    dom_attr_get_name_view(attr, &view);
+    info.GetReturnValue().Set(NameViewToV8String(isolate, view, (DOMNode*)attr));
+}
+
+void AttrWrapper::OwnerElementGetter(v8::Local<v8::Name> property,
+                                     const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("AttrWrapper::OwnerElementGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    DOMAttr* attr = ThisAttr(isolate, info.This());
+    if (!attr) {
+        return;
+    }
+    
+    DOMElement* owner = dom_attr_get_ownerelement(attr);
+    if (owner) {
+        info.GetReturnValue().Set(ElementWrapper::Wrap(isolate, isolate->GetCurrentContext(), owner));
+    } else {
+        info.GetReturnValue().SetNull();
+    }
+}
+
+void AttrWrapper::SpecifiedGetter(v8::Local<v8::Name> property,
+                                  const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("AttrWrapper::SpecifiedGetter");
+    // Always true per spec
+    info.GetReturnValue().Set(true);
+}
+
+// ============================================================================
+// Property Implementations - Read/Write
+// ============================================================================
+
+void AttrWrapper::ValueGetter(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("AttrWrapper::ValueGetter");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMAttr* attr = UnwrapReceiver<DOMAttr>(args);
+    if (!attr) {
+        return;
+    }
+    
+    // An attached Attr reads its element's current value
+    DOMStringView view;
+    dom_attr_get_value_view(attr, &view);
+    args.GetReturnValue().Set(StringViewToV8String(isolate, view, (DOMNode*)attr));
+}
+
+void AttrWrapper::ValueSetter(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("AttrWrapper::ValueSetter");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMAttr* attr = UnwrapReceiver<DOMAttr>(args);
+    if (!attr) {
+        return;
+    }
+    
+    CStringFromV8 value(isolate, args[0]);
+    if (!value.get()) {
+        return;  // ToString threw
+    }
+    int32_t err = dom_attr_set_value(attr, value.get());
+    if (err != 0) {
+        ThrowDOMException(isolate, err);
+    }
+}
+
 } // namespace v8_dom
@@ -9,6 +9,7 @@
 #define V8_DOM_CDATASECTION_WRAPPER_H
 
 #include <v8.h>
+#include "../core/wrapper_traits.h"
 #include "text_wrapper.h"
 #include "dom.h"
 
@@ -42,7 +43,12 @@ public:
     /**
      * Template cache index.
      */
-    static constexpr int kTemplateIndex = 8;
+    static constexpr int kTemplateIndex = WrapperTraits<CDATASectionWrapper>::kTemplateIndex;
+    
+    /**
+     * Type tag stored in the wrapper's type internal field.
+     */
+    static const WrapperTypeInfo kTypeInfo;
     
 private:
     // Property getters/setters and methods will be added here
@@ -2,73 +2,74 @@
 #include "../wrapper_cache.h"
 #include "../core/template_cache.h"
 #include "../core/utilities.h"
+#include "../core/call_recorder.h"
+#include "../core/string_cache.h"
+#include "node_mixins.h"
 
 namespace v8_dom {
 
+const WrapperTypeInfo CharacterDataWrapper::kTypeInfo = {"CharacterData", &NodeWrapper::kTypeInfo};
+
+namespace {
+
+/**
+ * Convert the leading unsigned long arguments of a method (WebIDL
+ * ToUint32); returns false if a conversion threw.
+ */
+bool UnsignedLongArgs(const v8::FunctionCallbackInfo<v8::Value>& args, int count, uint32_t* out) {
+    v8::Local<v8::Context> context = args.GetIsolate()->GetCurrentContext();
+    for (int i = 0; i < count; i++) {
+        if (!args[i]->Uint32Value(context).To(&out[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
 v8::Local<v8::Object> CharacterDataWrapper::Wrap(v8::Isolate* isolate,
                                               v8::Local<v8::Context> context,
                                               DOMCharacterData* obj) {
-    if (!obj) {
-        return v8::Local<v8::Object>();
-    }
-    
-    // Check wrapper cache first
-    WrapperCache* cache = WrapperCache::ForIsolate(isolate);
-    if (cache->Has(obj)) {
-        return cache->Get(isolate, obj);
-    }
-    
-    // Create new wrapper
-    v8::EscapableHandleScope handle_scope(isolate);
-    v8::Local<v8::FunctionTemplate> tmpl = GetTemplate(isolate);
-    v8::Local<v8::Function> constructor = tmpl->GetFunction(context).ToLocalChecked();
-    v8::Local<v8::Object> wrapper = constructor->NewInstance(context).ToLocalChecked();
-    
-    // Store C pointer in internal field
-    wrapper->SetInternalField(0, v8::External::New(isolate, obj));
-    
-    // Increment C-side reference count (CharacterData inherits from Node)
-    dom_node_addref((DOMNode*)obj);
-    
-    // Cache with release callback
-    cache->Set(isolate, obj, wrapper, [](void* ptr) {
-        dom_node_release((DOMNode*)static_cast<DOMCharacterData*>(ptr));
-    });
-    
-    return handle_scope.Escape(wrapper);
+    // CharacterData is abstract: wrap with the node's own interface
+    return NodeWrapper::Wrap(isolate, context, (DOMNode*)obj);
 }
 
 DOMCharacterData* CharacterDataWrapper::Unwrap(v8::Local<v8::Object> obj) {
-    if (obj.IsEmpty() || obj->InternalFieldCount() < 1) {
-        return nullptr;
-    }
-    
-    v8::Local<v8::Data> data = obj->GetInternalField(0);
-    v8::Local<v8::Value> ptr = data.As<v8::Value>();
-    if (ptr.IsEmpty()) return nullptr;
-    if (!ptr->IsExternal()) {
-        return nullptr;
-    }
-    
-    return static_cast<DOMCharacterData*>(v8::Local<v8::External>::Cast(ptr)->Value());
+    return UnwrapWithTraits<CharacterDataWrapper>(obj);
 }
 
+const PropertyDescriptor CharacterDataWrapper::kProperties[] = {
+    // Read-write properties
+    DataProperty("data", DataGetter, DataSetter),
+
+    // Readonly properties
+    DataProperty("length", LengthGetter),
+
+    // Readonly properties (NonDocumentTypeChildNode mixin)
+    DataProperty("previousElementSibling", PreviousElementSiblingGetter),
+    DataProperty("nextElementSibling", NextElementSiblingGetter),
+
+    // Methods
+    MethodProperty("substringData", SubstringData, kReceiverCheck, 2),
+    MethodProperty("appendData", AppendData, kReceiverCheck, 1),
+    MethodProperty("insertData", InsertData, kReceiverCheck, 2),
+    MethodProperty("deleteData", DeleteData, kReceiverCheck, 2),
+    MethodProperty("replaceData", ReplaceData, kReceiverCheck, 3),
+};
+
 void CharacterDataWrapper::InstallTemplate(v8::Isolate* isolate) {
     v8::Local<v8::FunctionTemplate> tmpl = v8::FunctionTemplate::New(isolate);
     tmpl->SetClassName(v8::String::NewFromUtf8Literal(isolate, "CharacterData"));
-    tmpl->InstanceTemplate()->SetInternalFieldCount(1);
+    tmpl->InstanceTemplate()->SetInternalFieldCount(kWrapperFieldCount);
     
     // Inherit from Node
     tmpl->Inherit(NodeWrapper::GetTemplate(isolate));
 
-    // Get prototype template for adding properties/methods
-    v8::Local<v8::ObjectTemplate> proto = tmpl->PrototypeTemplate();
+    InstallProperties(isolate, tmpl, kProperties);
     
-    // Readonly properties (NonDocumentTypeChildNode mixin)
-    proto->SetNativeDataProperty(v8::String::NewFromUtf8Literal(isolate, "previousElementSibling"),
-                                 PreviousElementSiblingGetter);
-    proto->SetNativeDataProperty(v8::String::NewFromUtf8Literal(isolate, "nextElementSibling"),
-                                 NextElementSiblingGetter);
+    // Methods - ChildNode mixin
+    ChildNodeMixin::Install(isolate, tmpl->PrototypeTemplate(), v8::Signature::New(isolate, tmpl));
     
     // Cache the template
     TemplateCache* cache = TemplateCache::ForIsolate(isolate);
@@ -85,10 +86,78 @@ v8::Local<v8::FunctionTemplate> CharacterDataWrapper::GetTemplate(v8::Isolate* i
     return cache->Get(kTemplateIndex);
 }
 
+void CharacterDataWrapper::RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+    RegisterProperties(registry, kProperties);
+}
+
+// ============================================================================
+// Property Implementations
+// ============================================================================
+
+void CharacterDataWrapper::DataGetter(v8::Local<v8::Name> property,
+                                      const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("CharacterDataWrapper::DataGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    DOMCharacterData* cdata = Unwrap(info.This());
+    if (!cdata) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Invalid CharacterData object")));
+        return;
+    }
+
+    // The node's own storage, read in place
+    DOMStringView view;
+    dom_node_get_textcontent_view((DOMNode*)cdata, &view);
+    info.GetReturnValue().Set(StringViewToV8String(isolate, view, (DOMNode*)cdata));
+}
+
+void CharacterDataWrapper::DataSetter(v8::Local<v8::Name> property,
+                                      v8::Local<v8::Value> value,
+                                      const v8::PropertyCallbackInfo<void>& info) {
+    V8_DOM_TRACE_SCOPE("CharacterDataWrapper::DataSetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    DOMCharacterData* cdata = Unwrap(info.This());
+    if (!cdata) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Invalid CharacterData object")));
+        return;
+    }
+
+    // [LegacyNullToEmptyString]
+    int32_t err;
+    if (value->IsNull()) {
+        err = dom_characterdata_set_data_n(cdata, "", 0);
+        V8_DOM_RECORD_CALL(kSetData, TraceNode(cdata), "");
+    } else {
+        StringArgFromV8 data(isolate, value);
+        err = dom_characterdata_set_data_n(cdata, data.data(), data.length());
+        V8_DOM_RECORD_CALL(kSetData, TraceNode(cdata), data);
+    }
+    if (err != 0) {
+        ThrowDOMException(isolate, err);
+    }
+}
+
+void CharacterDataWrapper::LengthGetter(v8::Local<v8::Name> property,
+                                        const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("CharacterDataWrapper::LengthGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    DOMCharacterData* cdata = Unwrap(info.This());
+    if (!cdata) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Invalid CharacterData object")));
+        return;
+    }
+
+    // UTF-16 code units, cached on the node
+    info.GetReturnValue().Set(dom_characterdata_get_length(cdata));
+}
+
 // ===== Property Getters (NonDocumentTypeChildNode mixin) =====
 
 void CharacterDataWrapper::PreviousElementSiblingGetter(v8::Local<v8::Name> property,
                                                         const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("CharacterDataWrapper::PreviousElementSiblingGetter");
     v8::Isolate* isolate = info.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     DOMCharacterData* cdata = Unwrap(info.This());
@@ -111,6 +180,7 @@ void CharacterDataWrapper::PreviousElementSiblingGetter(v8::Local<v8::Name> prop
 
 void CharacterDataWrapper::NextElementSiblingGetter(v8::Local<v8::Name> property,
                                                     const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("CharacterDataWrapper::NextElementSiblingGetter");
     v8::Isolate* isolate = info.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     DOMCharacterData* cdata = Unwrap(info.This());
@@ -131,4 +201,129 @@ void CharacterDataWrapper::NextElementSiblingGetter(v8::Local<v8::Name> property
     info.GetReturnValue().SetNull();
 }
 
+// ============================================================================
+// Method Implementations
+// ============================================================================
+//
+// Offsets are UTF-16 code units; the C-ABI converts them with the node's
+// UTF-16 index and edits the data in place, so no call copies the whole
+// string across the boundary.
+
+void CharacterDataWrapper::SubstringData(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("CharacterDataWrapper::SubstringData");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMCharacterData* cdata = UnwrapReceiver<DOMCharacterData>(args);
+    if (!cdata) {
+        return;
+    }
+
+    if (args.Length() < 2) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "substringData requires offset and count arguments")));
+        return;
+    }
+    uint32_t range[2];
+    if (!UnsignedLongArgs(args, 2, range)) {
+        return;
+    }
+    DOMStringView view;
+    int32_t err = dom_characterdata_substringdata(cdata, range[0], range[1], &view);
+    if (err != 0) {
+        ThrowDOMException(isolate, err);
+        return;
+    }
+    args.GetReturnValue().Set(StringViewToV8String(isolate, view, (DOMNode*)cdata));
+}
+
+void CharacterDataWrapper::AppendData(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("CharacterDataWrapper::AppendData");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMCharacterData* cdata = UnwrapReceiver<DOMCharacterData>(args);
+    if (!cdata) {
+        return;
+    }
+
+    if (args.Length() < 1) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "appendData requires a data argument")));
+        return;
+    }
+    StringArgFromV8 data(isolate, args[0]);
+    int32_t err = dom_characterdata_appenddata_n(cdata, data.data(), data.length());
+    if (err != 0) {
+        ThrowDOMException(isolate, err);
+    }
+}
+
+void CharacterDataWrapper::InsertData(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("CharacterDataWrapper::InsertData");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMCharacterData* cdata = UnwrapReceiver<DOMCharacterData>(args);
+    if (!cdata) {
+        return;
+    }
+
+    if (args.Length() < 2) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "insertData requires offset and data arguments")));
+        return;
+    }
+    uint32_t offset;
+    if (!UnsignedLongArgs(args, 1, &offset)) {
+        return;
+    }
+    StringArgFromV8 data(isolate, args[1]);
+    int32_t err = dom_characterdata_insertdata_n(cdata, offset, data.data(), data.length());
+    if (err != 0) {
+        ThrowDOMException(isolate, err);
+    }
+}
+
+void CharacterDataWrapper::DeleteData(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("CharacterDataWrapper::DeleteData");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMCharacterData* cdata = UnwrapReceiver<DOMCharacterData>(args);
+    if (!cdata) {
+        return;
+    }
+
+    if (args.Length() < 2) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "deleteData requires offset and count arguments")));
+        return;
+    }
+    uint32_t range[2];
+    if (!UnsignedLongArgs(args, 2, range)) {
+        return;
+    }
+    int32_t err = dom_characterdata_deletedata(cdata, range[0], range[1]);
+    if (err != 0) {
+        ThrowDOMException(isolate, err);
+    }
+}
+
+void CharacterDataWrapper::ReplaceData(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("CharacterDataWrapper::ReplaceData");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMCharacterData* cdata = UnwrapReceiver<DOMCharacterData>(args);
+    if (!cdata) {
+        return;
+    }
+
+    if (args.Length() < 3) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "replaceData requires offset, count and data arguments")));
+        return;
+    }
+    uint32_t range[2];
+    if (!UnsignedLongArgs(args, 2, range)) {
+        return;
+    }
+    StringArgFromV8 data(isolate, args[2]);
+    int32_t err = dom_characterdata_replacedata_n(cdata, range[0], range[1], data.data(), data.length());
+    if (err != 0) {
+        ThrowDOMException(isolate, err);
+    }
+}
+
 } // namespace v8_dom
@@ -9,6 +9,9 @@
 #define V8_DOM_CHARACTERDATA_WRAPPER_H
 
 #include <v8.h>
+#include "../core/wrapper_traits.h"
+#include "../core/external_references.h"
+#include "../core/property_table.h"
 #include "node_wrapper.h"
 #include "dom.h"
 
@@ -17,8 +20,8 @@ namespace v8_dom {
 class CharacterDataWrapper : public NodeWrapper {
 public:
     /**
-     * Wrap a C DOMCharacterData pointer in a V8 object.
-     * Uses wrapper cache for identity preservation.
+     * Wrap a C DOMCharacterData pointer in a V8 object of the node's own
+     * interface (Text, Comment, ...), through NodeWrapper::Wrap.
      */
     static v8::Local<v8::Object> Wrap(v8::Isolate* isolate,
                                       v8::Local<v8::Context> context,
@@ -42,14 +45,45 @@ public:
     /**
      * Template cache index.
      */
-    static constexpr int kTemplateIndex = 5;
+    static constexpr int kTemplateIndex = WrapperTraits<CharacterDataWrapper>::kTemplateIndex;
+    
+    /**
+     * Type tag stored in the wrapper's type internal field.
+     */
+    static const WrapperTypeInfo kTypeInfo;
+    
+    /**
+     * Register this wrapper's callbacks for snapshot serialization.
+     */
+    static void RegisterExternalReferences(ExternalReferenceRegistry* registry);
     
 private:
+    // Prototype members, installed by InstallTemplate()
+    static const PropertyDescriptor kProperties[];
+    
+    // Read-write properties
+    static void DataGetter(v8::Local<v8::Name> property,
+                           const v8::PropertyCallbackInfo<v8::Value>& info);
+    static void DataSetter(v8::Local<v8::Name> property,
+                           v8::Local<v8::Value> value,
+                           const v8::PropertyCallbackInfo<void>& info);
+    
+    // Readonly properties
+    static void LengthGetter(v8::Local<v8::Name> property,
+                             const v8::PropertyCallbackInfo<v8::Value>& info);
+    
     // Readonly properties (NonDocumentTypeChildNode mixin)
     static void PreviousElementSiblingGetter(v8::Local<v8::Name> property,
                                              const v8::PropertyCallbackInfo<v8::Value>& info);
     static void NextElementSiblingGetter(v8::Local<v8::Name> property,
                                         const v8::PropertyCallbackInfo<v8::Value>& info);
+    
+    // Methods (UTF-16 offsets, converted and applied in place by the C-ABI)
+    static void SubstringData(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void AppendData(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void InsertData(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void DeleteData(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void ReplaceData(const v8::FunctionCallbackInfo<v8::Value>& args);
 };
 
 } // namespace v8_dom
@@ -1,16 +1,32 @@
 #include "document_wrapper.h"
+#include <vector>
 #include "../wrapper_cache.h"
 #include "../core/template_cache.h"
 #include "../core/utilities.h"
+#include "../core/call_recorder.h"
+#include "../core/atom_table.h"
 #include "element_wrapper.h"
 #include "text_wrapper.h"
 #include "attr_wrapper.h"
 #include "../collections/htmlcollection_wrapper.h"
 #include "../collections/nodelist_wrapper.h"
-#include <cstdio>
+#include "../collections/childlist_wrapper.h"
+#include "node_mixins.h"
+#include "treebuilder_wrapper.h"
+#if V8_DOM_ENABLE_RANGES
+#include "../ranges/range_wrapper.h"
+#include "../ranges/staticrange_wrapper.h"
+#endif
+#if V8_DOM_ENABLE_TRAVERSAL
+#include "../traversal/treewalker_wrapper.h"
+#include "../traversal/nodeiterator_wrapper.h"
+#include "../traversal/sliced_query_wrapper.h"
+#endif
 
 namespace v8_dom {
 
+const WrapperTypeInfo DocumentWrapper::kTypeInfo = {"Document", &NodeWrapper::kTypeInfo};
+
 v8::Local<v8::Object> DocumentWrapper::Wrap(v8::Isolate* isolate,
                                               v8::Local<v8::Context> context,
                                               DOMDocument* obj) {
@@ -18,111 +34,101 @@ v8::Local<v8::Object> DocumentWrapper::Wrap(v8::Isolate* isolate,
         return v8::Local<v8::Object>();
     }
     
-    // Check wrapper cache first
     WrapperCache* cache = WrapperCache::ForIsolate(isolate);
-    if (cache->Has(obj)) {
-        return cache->Get(isolate, obj);
+    v8::Local<v8::Object> cached;
+    if (LookupWrapper<DocumentWrapper>(isolate, cache, obj, &cached)) {
+        return cached;
     }
     
-    // Create new wrapper
-    v8::EscapableHandleScope handle_scope(isolate);
-    v8::Local<v8::FunctionTemplate> tmpl = GetTemplate(isolate);
-    v8::Local<v8::Function> constructor = tmpl->GetFunction(context).ToLocalChecked();
-    v8::Local<v8::Object> wrapper = constructor->NewInstance(context).ToLocalChecked();
-    
-    // Store C pointer in internal field
-    wrapper->SetInternalField(0, v8::External::New(isolate, obj));
+    v8::Local<v8::Object> wrapper = CreateWrapper<DocumentWrapper>(isolate, context, cache, obj);
     
-    // Increment C-side reference count
-    dom_document_addref(obj);
+    // Let the document's size pace V8's GC while the wrapper lives
+    cache->TrackDocument(isolate, obj);
     
-    // Cache with release callback
-    cache->Set(isolate, obj, wrapper, [](void* ptr) {
-        dom_document_release(static_cast<DOMDocument*>(ptr));
-    });
-    
-    return handle_scope.Escape(wrapper);
+    return wrapper;
 }
 
 DOMDocument* DocumentWrapper::Unwrap(v8::Local<v8::Object> obj) {
-    if (obj.IsEmpty() || obj->InternalFieldCount() < 1) {
-        return nullptr;
-    }
-    
-    v8::Local<v8::Data> data = obj->GetInternalField(0);
-    v8::Local<v8::Value> ptr = data.As<v8::Value>();
-    if (ptr.IsEmpty()) return nullptr;
-    if (!ptr->IsExternal()) {
-        return nullptr;
-    }
-    
-    return static_cast<DOMDocument*>(v8::Local<v8::External>::Cast(ptr)->Value());
+    return UnwrapWithTraits<DocumentWrapper>(obj);
 }
 
-void DocumentWrapper::InstallTemplate(v8::Isolate* isolate) {
-    v8::Local<v8::FunctionTemplate> tmpl = v8::FunctionTemplate::New(isolate);
-    tmpl->SetClassName(v8::String::NewFromUtf8Literal(isolate, "Document"));
-    tmpl->InstanceTemplate()->SetInternalFieldCount(1);
-    
-    // Inherit from Node
-    tmpl->Inherit(NodeWrapper::GetTemplate(isolate));
-
-    // Get prototype template for adding properties/methods
-    v8::Local<v8::ObjectTemplate> proto = tmpl->PrototypeTemplate();
-    
+const PropertyDescriptor DocumentWrapper::kProperties[] = {
     // Readonly properties
-    proto->SetNativeDataProperty(v8::String::NewFromUtf8Literal(isolate, "compatMode"),
-                                 CompatModeGetter);
-    proto->SetNativeDataProperty(v8::String::NewFromUtf8Literal(isolate, "characterSet"),
-                                 CharacterSetGetter);
-    proto->SetNativeDataProperty(v8::String::NewFromUtf8Literal(isolate, "contentType"),
-                                 ContentTypeGetter);
-    proto->SetNativeDataProperty(v8::String::NewFromUtf8Literal(isolate, "documentURI"),
-                                 DocumentURIGetter);
-    proto->SetNativeDataProperty(v8::String::NewFromUtf8Literal(isolate, "doctype"),
-                                 DoctypeGetter);
+    AccessorProperty("children", ChildListWrapper::ChildrenGetter, nullptr, kReceiverCheck | kNoSideEffect),
+    DataProperty("compatMode", CompatModeGetter),
+    DataProperty("characterSet", CharacterSetGetter),
+    DataProperty("contentType", ContentTypeGetter),
+    DataProperty("documentURI", DocumentURIGetter),
+    DataProperty("doctype", DoctypeGetter),
     
     // Factory methods
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "createElement"),
-               v8::FunctionTemplate::New(isolate, CreateElement));
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "createElementNS"),
-               v8::FunctionTemplate::New(isolate, CreateElementNS));
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "createTextNode"),
-               v8::FunctionTemplate::New(isolate, CreateTextNode));
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "createComment"),
-               v8::FunctionTemplate::New(isolate, CreateComment));
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "createAttribute"),
-               v8::FunctionTemplate::New(isolate, CreateAttribute));
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "createAttributeNS"),
-               v8::FunctionTemplate::New(isolate, CreateAttributeNS));
+    MethodProperty("createElement", CreateElement),
+    MethodProperty("createElementNS", CreateElementNS),
+    MethodProperty("createTextNode", CreateTextNode),
+    MethodProperty("createComment", CreateComment),
+    MethodProperty("createAttribute", CreateAttribute),
+    MethodProperty("createAttributeNS", CreateAttributeNS),
     
     // Node manipulation
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "importNode"),
-               v8::FunctionTemplate::New(isolate, ImportNode));
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "adoptNode"),
-               v8::FunctionTemplate::New(isolate, AdoptNode));
+    MethodProperty("importNode", ImportNode),
+    MethodProperty("adoptNode", AdoptNode),
     
     // Query methods
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "querySelector"),
-               v8::FunctionTemplate::New(isolate, QuerySelector));
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "querySelectorAll"),
-               v8::FunctionTemplate::New(isolate, QuerySelectorAll));
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "getElementsByTagName"),
-               v8::FunctionTemplate::New(isolate, GetElementsByTagName));
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "getElementsByTagNameNS"),
-               v8::FunctionTemplate::New(isolate, GetElementsByTagNameNS));
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "getElementsByClassName"),
-               v8::FunctionTemplate::New(isolate, GetElementsByClassName));
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "getElementById"),
-               v8::FunctionTemplate::New(isolate, GetElementById));
+    MethodProperty("querySelector", QuerySelector),
+    MethodProperty("querySelectorAll", QuerySelectorAll),
+    MethodProperty("getElementsByTagName", GetElementsByTagName),
+    MethodProperty("getElementsByTagNameNS", GetElementsByTagNameNS),
+    MethodProperty("getElementsByClassName", GetElementsByClassName),
+    MethodProperty("getElementById", GetElementById),
     
     // Range/Iterator factory methods
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "createRange"),
-               v8::FunctionTemplate::New(isolate, CreateRange));
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "createTreeWalker"),
-               v8::FunctionTemplate::New(isolate, CreateTreeWalker));
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "createNodeIterator"),
-               v8::FunctionTemplate::New(isolate, CreateNodeIterator));
+#if V8_DOM_ENABLE_RANGES
+    MethodProperty("createRange", CreateRange),
+#endif
+#if V8_DOM_ENABLE_TRAVERSAL
+    MethodProperty("createTreeWalker", CreateTreeWalker),
+    MethodProperty("createNodeIterator", CreateNodeIterator),
+#endif
+    
+    // Non-standard methods
+    MethodProperty("batch", Batch, kReceiverCheck | kDontEnum),
+    MethodProperty("createTreeBuilder", CreateTreeBuilder, kReceiverCheck | kDontEnum),
+    MethodProperty("applyPatch", ApplyPatch, kReceiverCheck | kDontEnum, 3),
+#if V8_DOM_ENABLE_RANGES
+    MethodProperty("createStaticRanges", CreateStaticRanges, kReceiverCheck | kDontEnum, 2),
+#endif
+#if V8_DOM_ENABLE_TRAVERSAL
+    MethodProperty("querySelectorAllSliced", SlicedQueryWrapper::QuerySelectorAllSliced, kReceiverCheck | kDontEnum),
+#endif
+    
+    // Non-standard: integer node handles for wrapper-free traversal (not
+    // enumerable)
+    MethodProperty("__nodeById", NodeById, kReceiverCheck | kDontEnum, 1),
+    MethodProperty("__parentNode", ParentOfId, kReceiverCheck | kDontEnum, 1, &kFastParentOfId),
+    MethodProperty("__firstChild", FirstChildOfId, kReceiverCheck | kDontEnum, 1, &kFastFirstChildOfId),
+    MethodProperty("__lastChild", LastChildOfId, kReceiverCheck | kDontEnum, 1, &kFastLastChildOfId),
+    MethodProperty("__previousSibling", PreviousSiblingOfId, kReceiverCheck | kDontEnum, 1,
+                   &kFastPreviousSiblingOfId),
+    MethodProperty("__nextSibling", NextSiblingOfId, kReceiverCheck | kDontEnum, 1, &kFastNextSiblingOfId),
+    MethodProperty("__nodeType", NodeTypeOfId, kReceiverCheck | kNoSideEffect | kDontEnum, 1, &kFastNodeTypeOfId),
+    MethodProperty("__tagAtom", TagAtomOfId, kReceiverCheck | kDontEnum, 1, &kFastTagAtomOfId),
+    MethodProperty("__atom", Atom, kReceiverCheck | kDontEnum, 1),
+    MethodProperty("__atomName", AtomName, kReceiverCheck | kDontEnum, 1),
+    MethodProperty("__clearNodeIds", ClearNodeIds, kReceiverCheck | kDontEnum),
+};
+
+void DocumentWrapper::InstallTemplate(v8::Isolate* isolate) {
+    v8::Local<v8::FunctionTemplate> tmpl = v8::FunctionTemplate::New(isolate);
+    tmpl->SetClassName(v8::String::NewFromUtf8Literal(isolate, "Document"));
+    tmpl->InstanceTemplate()->SetInternalFieldCount(kWrapperFieldCount);
+    
+    // Inherit from Node
+    tmpl->Inherit(NodeWrapper::GetTemplate(isolate));
+
+    InstallProperties(isolate, tmpl, kProperties);
+    
+    // Methods - ParentNode mixin
+    ParentNodeMixin::Install(isolate, tmpl->PrototypeTemplate(), v8::Signature::New(isolate, tmpl));
     
     // Cache the template
     TemplateCache* cache = TemplateCache::ForIsolate(isolate);
@@ -139,10 +145,15 @@ v8::Local<v8::FunctionTemplate> DocumentWrapper::GetTemplate(v8::Isolate* isolat
     return cache->Get(kTemplateIndex);
 }
 
+void DocumentWrapper::RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+    RegisterProperties(registry, kProperties);
+}
+
 // ===== Property Getters =====
 
 void DocumentWrapper::CompatModeGetter(v8::Local<v8::Name> property,
                                        const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("DocumentWrapper::CompatModeGetter");
     v8::Isolate* isolate = info.GetIsolate();
     DOMDocument* doc = Unwrap(info.This());
     
@@ -158,6 +169,7 @@ void DocumentWrapper::CompatModeGetter(v8::Local<v8::Name> property,
 
 void DocumentWrapper::CharacterSetGetter(v8::Local<v8::Name> property,
                                         const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("DocumentWrapper::CharacterSetGetter");
     v8::Isolate* isolate = info.GetIsolate();
     DOMDocument* doc = Unwrap(info.This());
     
@@ -173,6 +185,7 @@ void DocumentWrapper::CharacterSetGetter(v8::Local<v8::Name> property,
 
 void DocumentWrapper::ContentTypeGetter(v8::Local<v8::Name> property,
                                        const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("DocumentWrapper::ContentTypeGetter");
     v8::Isolate* isolate = info.GetIsolate();
     DOMDocument* doc = Unwrap(info.This());
     
@@ -188,6 +201,7 @@ void DocumentWrapper::ContentTypeGetter(v8::Local<v8::Name> property,
 
 void DocumentWrapper::DocumentURIGetter(v8::Local<v8::Name> property,
                                        const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("DocumentWrapper::DocumentURIGetter");
     v8::Isolate* isolate = info.GetIsolate();
     DOMDocument* doc = Unwrap(info.This());
     
@@ -203,6 +217,7 @@ void DocumentWrapper::DocumentURIGetter(v8::Local<v8::Name> property,
 
 void DocumentWrapper::DoctypeGetter(v8::Local<v8::Name> property,
                                    const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("DocumentWrapper::DoctypeGetter");
     v8::Isolate* isolate = info.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     DOMDocument* doc = Unwrap(info.This());
@@ -226,13 +241,12 @@ void DocumentWrapper::DoctypeGetter(v8::Local<v8::Name> property,
 // ===== Factory Methods =====
 
 void DocumentWrapper::CreateElement(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("DocumentWrapper::CreateElement");
     v8::Isolate* isolate = args.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     
-    DOMDocument* doc = Unwrap(args.This());
+    DOMDocument* doc = UnwrapReceiver<DOMDocument>(args);
     if (!doc) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Document object")));
         return;
     }
     
@@ -242,8 +256,9 @@ void DocumentWrapper::CreateElement(const v8::FunctionCallbackInfo<v8::Value>& a
         return;
     }
     
-    v8::String::Utf8Value tagName(isolate, args[0]);
-    DOMElement* elem = dom_document_createelement(doc, *tagName);
+    StringArgFromV8 tagName(isolate, args[0]);
+    DOMElement* elem = dom_document_createelement_n(doc, tagName.data(), tagName.length());
+    V8_DOM_RECORD_CALL(kCreateElement, TraceNode(doc), tagName, TraceResult(elem));
     
     if (!elem) {
         isolate->ThrowException(v8::Exception::Error(
@@ -257,13 +272,12 @@ void DocumentWrapper::CreateElement(const v8::FunctionCallbackInfo<v8::Value>& a
 }
 
 void DocumentWrapper::CreateElementNS(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("DocumentWrapper::CreateElementNS");
     v8::Isolate* isolate = args.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     
-    DOMDocument* doc = Unwrap(args.This());
+    DOMDocument* doc = UnwrapReceiver<DOMDocument>(args);
     if (!doc) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Document object")));
         return;
     }
     
@@ -293,13 +307,12 @@ void DocumentWrapper::CreateElementNS(const v8::FunctionCallbackInfo<v8::Value>&
 }
 
 void DocumentWrapper::CreateTextNode(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("DocumentWrapper::CreateTextNode");
     v8::Isolate* isolate = args.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     
-    DOMDocument* doc = Unwrap(args.This());
+    DOMDocument* doc = UnwrapReceiver<DOMDocument>(args);
     if (!doc) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Document object")));
         return;
     }
     
@@ -309,8 +322,9 @@ void DocumentWrapper::CreateTextNode(const v8::FunctionCallbackInfo<v8::Value>&
         return;
     }
     
-    v8::String::Utf8Value data(isolate, args[0]);
-    DOMText* text = dom_document_createtextnode(doc, *data);
+    StringArgFromV8 data(isolate, args[0]);
+    DOMText* text = dom_document_createtextnode_n(doc, data.data(), data.length());
+    V8_DOM_RECORD_CALL(kCreateTextNode, TraceNode(doc), data, TraceResult(text));
     
     if (!text) {
         isolate->ThrowException(v8::Exception::Error(
@@ -323,13 +337,12 @@ void DocumentWrapper::CreateTextNode(const v8::FunctionCallbackInfo<v8::Value>&
 }
 
 void DocumentWrapper::CreateComment(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("DocumentWrapper::CreateComment");
     v8::Isolate* isolate = args.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     
-    DOMDocument* doc = Unwrap(args.This());
+    DOMDocument* doc = UnwrapReceiver<DOMDocument>(args);
     if (!doc) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Document object")));
         return;
     }
     
@@ -341,6 +354,7 @@ void DocumentWrapper::CreateComment(const v8::FunctionCallbackInfo<v8::Value>& a
     
     v8::String::Utf8Value data(isolate, args[0]);
     DOMComment* comment = dom_document_createcomment(doc, *data);
+    V8_DOM_RECORD_CALL(kCreateComment, TraceNode(doc), *data, TraceResult(comment));
     
     if (!comment) {
         isolate->ThrowException(v8::Exception::Error(
@@ -353,13 +367,12 @@ void DocumentWrapper::CreateComment(const v8::FunctionCallbackInfo<v8::Value>& a
 }
 
 void DocumentWrapper::CreateAttribute(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("DocumentWrapper::CreateAttribute");
     v8::Isolate* isolate = args.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     
-    DOMDocument* doc = Unwrap(args.This());
+    DOMDocument* doc = UnwrapReceiver<DOMDocument>(args);
     if (!doc) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Document object")));
         return;
     }
     
@@ -383,13 +396,12 @@ void DocumentWrapper::CreateAttribute(const v8::FunctionCallbackInfo<v8::Value>&
 }
 
 void DocumentWrapper::CreateAttributeNS(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("DocumentWrapper::CreateAttributeNS");
     v8::Isolate* isolate = args.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     
-    DOMDocument* doc = Unwrap(args.This());
+    DOMDocument* doc = UnwrapReceiver<DOMDocument>(args);
     if (!doc) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Document object")));
         return;
     }
     
@@ -422,13 +434,12 @@ void DocumentWrapper::CreateAttributeNS(const v8::FunctionCallbackInfo<v8::Value
 // ===== Node Manipulation =====
 
 void DocumentWrapper::ImportNode(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("DocumentWrapper::ImportNode");
     v8::Isolate* isolate = args.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     
-    DOMDocument* doc = Unwrap(args.This());
+    DOMDocument* doc = UnwrapReceiver<DOMDocument>(args);
     if (!doc) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Document object")));
         return;
     }
     
@@ -449,13 +460,12 @@ void DocumentWrapper::ImportNode(const v8::FunctionCallbackInfo<v8::Value>& args
 }
 
 void DocumentWrapper::AdoptNode(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("DocumentWrapper::AdoptNode");
     v8::Isolate* isolate = args.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     
-    DOMDocument* doc = Unwrap(args.This());
+    DOMDocument* doc = UnwrapReceiver<DOMDocument>(args);
     if (!doc) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Document object")));
         return;
     }
     
@@ -472,13 +482,12 @@ void DocumentWrapper::AdoptNode(const v8::FunctionCallbackInfo<v8::Value>& args)
 // ===== Query Methods =====
 
 void DocumentWrapper::QuerySelector(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("DocumentWrapper::QuerySelector");
     v8::Isolate* isolate = args.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     
-    DOMDocument* doc = Unwrap(args.This());
+    DOMDocument* doc = UnwrapReceiver<DOMDocument>(args);
     if (!doc) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Document object")));
         return;
     }
     
@@ -488,8 +497,9 @@ void DocumentWrapper::QuerySelector(const v8::FunctionCallbackInfo<v8::Value>& a
         return;
     }
     
-    v8::String::Utf8Value selector(isolate, args[0]);
-    DOMElement* result = dom_document_queryselector(doc, *selector);
+    StringArgFromV8 selector(isolate, args[0]);
+    DOMElement* result = dom_document_queryselector_n(doc, selector.data(), selector.length());
+    V8_DOM_RECORD_CALL(kQuerySelector, TraceNode(doc), selector, TraceResult(result));
     
     if (!result) {
         args.GetReturnValue().SetNull();
@@ -501,13 +511,12 @@ void DocumentWrapper::QuerySelector(const v8::FunctionCallbackInfo<v8::Value>& a
 }
 
 void DocumentWrapper::QuerySelectorAll(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("DocumentWrapper::QuerySelectorAll");
     v8::Isolate* isolate = args.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     
-    DOMDocument* doc = Unwrap(args.This());
+    DOMDocument* doc = UnwrapReceiver<DOMDocument>(args);
     if (!doc) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Document object")));
         return;
     }
     
@@ -519,24 +528,21 @@ void DocumentWrapper::QuerySelectorAll(const v8::FunctionCallbackInfo<v8::Value>
     
     v8::String::Utf8Value selector(isolate, args[0]);
     DOMNodeList* results = dom_document_queryselectorall(doc, *selector);
+    V8_DOM_RECORD_CALL(kQuerySelectorAll, TraceNode(doc), *selector,
+                       results ? dom_nodelist_static_get_length(results) : 0u);
     
-    if (!results) {
-        args.GetReturnValue().SetNull();
-        return;
-    }
-    
+    // No matches wraps as an empty NodeList
     v8::Local<v8::Object> wrapper = NodeListWrapper::Wrap(isolate, context, results);
     args.GetReturnValue().Set(wrapper);
 }
 
 void DocumentWrapper::GetElementsByTagName(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("DocumentWrapper::GetElementsByTagName");
     v8::Isolate* isolate = args.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     
-    DOMDocument* doc = Unwrap(args.This());
+    DOMDocument* doc = UnwrapReceiver<DOMDocument>(args);
     if (!doc) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Document object")));
         return;
     }
     
@@ -554,18 +560,17 @@ void DocumentWrapper::GetElementsByTagName(const v8::FunctionCallbackInfo<v8::Va
         return;
     }
     
-    v8::Local<v8::Object> wrapper = HTMLCollectionWrapper::Wrap(isolate, context, results);
+    v8::Local<v8::Object> wrapper = HTMLCollectionWrapper::Wrap(isolate, context, results, doc);
     args.GetReturnValue().Set(wrapper);
 }
 
 void DocumentWrapper::GetElementsByTagNameNS(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("DocumentWrapper::GetElementsByTagNameNS");
     v8::Isolate* isolate = args.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     
-    DOMDocument* doc = Unwrap(args.This());
+    DOMDocument* doc = UnwrapReceiver<DOMDocument>(args);
     if (!doc) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Document object")));
         return;
     }
     
@@ -589,18 +594,17 @@ void DocumentWrapper::GetElementsByTagNameNS(const v8::FunctionCallbackInfo<v8::
         return;
     }
     
-    v8::Local<v8::Object> wrapper = HTMLCollectionWrapper::Wrap(isolate, context, results);
+    v8::Local<v8::Object> wrapper = HTMLCollectionWrapper::Wrap(isolate, context, results, doc);
     args.GetReturnValue().Set(wrapper);
 }
 
 void DocumentWrapper::GetElementsByClassName(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("DocumentWrapper::GetElementsByClassName");
     v8::Isolate* isolate = args.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     
-    DOMDocument* doc = Unwrap(args.This());
+    DOMDocument* doc = UnwrapReceiver<DOMDocument>(args);
     if (!doc) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Document object")));
         return;
     }
     
@@ -618,18 +622,17 @@ void DocumentWrapper::GetElementsByClassName(const v8::FunctionCallbackInfo<v8::
         return;
     }
     
-    v8::Local<v8::Object> wrapper = HTMLCollectionWrapper::Wrap(isolate, context, results);
+    v8::Local<v8::Object> wrapper = HTMLCollectionWrapper::Wrap(isolate, context, results, doc);
     args.GetReturnValue().Set(wrapper);
 }
 
 void DocumentWrapper::GetElementById(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("DocumentWrapper::GetElementById");
     v8::Isolate* isolate = args.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     
-    DOMDocument* doc = Unwrap(args.This());
+    DOMDocument* doc = UnwrapReceiver<DOMDocument>(args);
     if (!doc) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Document object")));
         return;
     }
     
@@ -639,15 +642,9 @@ void DocumentWrapper::GetElementById(const v8::FunctionCallbackInfo<v8::Value>&
         return;
     }
     
-    v8::String::Utf8Value elementId(isolate, args[0]);
-    
-    // DEBUG: Print document pointer and ID being searched
-    std::fprintf(stderr, "[DEBUG] getElementById: doc=%p, id='%s'\n", (void*)doc, *elementId);
-    
-    DOMElement* result = dom_document_getelementbyid(doc, *elementId);
-    
-    // DEBUG: Print result
-    std::fprintf(stderr, "[DEBUG] getElementById result: %p\n", (void*)result);
+    StringArgFromV8 elementId(isolate, args[0]);
+    DOMElement* result = dom_document_getelementbyid_n(doc, elementId.data(), elementId.length());
+    V8_DOM_RECORD_CALL(kGetElementById, TraceNode(doc), elementId, TraceResult(result));
     
     if (!result) {
         args.GetReturnValue().SetNull();
@@ -660,14 +657,14 @@ void DocumentWrapper::GetElementById(const v8::FunctionCallbackInfo<v8::Value>&
 
 // ===== Range/Iterator Factory Methods =====
 
+#if V8_DOM_ENABLE_RANGES
 void DocumentWrapper::CreateRange(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("DocumentWrapper::CreateRange");
     v8::Isolate* isolate = args.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     
-    DOMDocument* doc = Unwrap(args.This());
+    DOMDocument* doc = UnwrapReceiver<DOMDocument>(args);
     if (!doc) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Document object")));
         return;
     }
     
@@ -679,50 +676,451 @@ void DocumentWrapper::CreateRange(const v8::FunctionCallbackInfo<v8::Value>& arg
         return;
     }
     
-    // TODO: Use RangeWrapper::Wrap when available
-    args.GetReturnValue().SetNull();
+    args.GetReturnValue().Set(RangeWrapper::Wrap(isolate, context, range));
+}
+#endif // V8_DOM_ENABLE_RANGES
+
+#if V8_DOM_ENABLE_TRAVERSAL
+namespace {
+
+/**
+ * Read the (root, whatToShow) arguments of createTreeWalker/createNodeIterator;
+ * whatToShow defaults to SHOW_ALL. Returns false if an exception was thrown.
+ */
+bool TraversalArgs(const v8::FunctionCallbackInfo<v8::Value>& args,
+                   v8::Local<v8::Object>* root,
+                   uint32_t* what_to_show) {
+    v8::Isolate* isolate = args.GetIsolate();
+    if (args.Length() < 1 || !args[0]->IsObject() ||
+        !NodeWrapper::Unwrap(args[0].As<v8::Object>())) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Root must be a Node")));
+        return false;
+    }
+    *root = args[0].As<v8::Object>();
+    
+    *what_to_show = DOM_NODEFILTER_SHOW_ALL;
+    if (args.Length() > 1 && !args[1]->IsUndefined()) {
+        return args[1]->Uint32Value(isolate->GetCurrentContext()).To(what_to_show);
+    }
+    return true;
 }
 
+} // namespace
+
 void DocumentWrapper::CreateTreeWalker(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("DocumentWrapper::CreateTreeWalker");
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    
+    DOMDocument* doc = UnwrapReceiver<DOMDocument>(args);
+    if (!doc) {
+        return;
+    }
+    
+    v8::Local<v8::Object> root;
+    uint32_t what_to_show;
+    if (!TraversalArgs(args, &root, &what_to_show)) return;
+    
+    v8::Local<v8::Object> result;
+    if (TreeWalkerWrapper::Create(isolate, context, doc, root, what_to_show, args[2]).ToLocal(&result)) {
+        args.GetReturnValue().Set(result);
+    }
+}
+
+void DocumentWrapper::CreateNodeIterator(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("DocumentWrapper::CreateNodeIterator");
     v8::Isolate* isolate = args.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     
-    DOMDocument* doc = Unwrap(args.This());
+    DOMDocument* doc = UnwrapReceiver<DOMDocument>(args);
     if (!doc) {
+        return;
+    }
+    
+    v8::Local<v8::Object> root;
+    uint32_t what_to_show;
+    if (!TraversalArgs(args, &root, &what_to_show)) return;
+    
+    v8::Local<v8::Object> result;
+    if (NodeIteratorWrapper::Create(isolate, context, doc, root, what_to_show, args[2]).ToLocal(&result)) {
+        args.GetReturnValue().Set(result);
+    }
+}
+#endif // V8_DOM_ENABLE_TRAVERSAL
+
+// ===== Non-standard Methods =====
+
+void DocumentWrapper::Batch(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("DocumentWrapper::Batch");
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    
+    DOMDocument* doc = UnwrapReceiver<DOMDocument>(args);
+    if (!doc) {
+        return;
+    }
+    
+    if (args.Length() < 1 || !args[0]->IsFunction()) {
         isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Document object")));
+            v8::String::NewFromUtf8Literal(isolate, "batch requires a function")));
         return;
     }
     
-    if (args.Length() < 1) {
+    // Mutations made by the callback are coalesced into one batch; the batch
+    // ends even if the callback throws (the exception propagates as is)
+    dom_document_begin_batch(doc);
+    v8::MaybeLocal<v8::Value> result =
+        args[0].As<v8::Function>()->Call(context, args.This(), 0, nullptr);
+    dom_document_end_batch(doc);
+    
+    v8::Local<v8::Value> value;
+    if (result.ToLocal(&value)) {
+        args.GetReturnValue().Set(value);
+    }
+}
+
+namespace {
+
+// Unwraps an array of nodes; throws and returns false on anything else
+bool NodeTableArg(v8::Isolate* isolate, v8::Local<v8::Context> context,
+                  v8::Local<v8::Value> value, std::vector<DOMNode*>* nodes) {
+    if (value->IsNullOrUndefined()) {
+        return true;
+    }
+    if (!value->IsArray()) {
         isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Root node required")));
+            v8::String::NewFromUtf8Literal(isolate, "Node table must be an array of Nodes")));
+        return false;
+    }
+    v8::Local<v8::Array> array = value.As<v8::Array>();
+    nodes->reserve(array->Length());
+    for (uint32_t i = 0; i < array->Length(); i++) {
+        v8::Local<v8::Value> item;
+        if (!array->Get(context, i).ToLocal(&item)) {
+            return false;  // Exception pending
+        }
+        DOMNode* node = item->IsObject() ? NodeWrapper::Unwrap(item.As<v8::Object>()) : nullptr;
+        if (!node) {
+            isolate->ThrowException(v8::Exception::TypeError(
+                v8::String::NewFromUtf8Literal(isolate, "Node table must be an array of Nodes")));
+            return false;
+        }
+        nodes->push_back(node);
+    }
+    return true;
+}
+
+} // namespace
+
+void DocumentWrapper::ApplyPatch(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("DocumentWrapper::ApplyPatch");
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    
+    DOMDocument* doc = UnwrapReceiver<DOMDocument>(args);
+    if (!doc) {
         return;
     }
     
-    // TODO: Unwrap root node, get whatToShow, filter when NodeWrapper available
-    args.GetReturnValue().SetNull();
+    // The patch is read in place from the caller's buffer
+    const uint8_t* data = nullptr;
+    size_t length = 0;
+    if (args.Length() > 0 && args[0]->IsArrayBufferView()) {
+        v8::Local<v8::ArrayBufferView> view = args[0].As<v8::ArrayBufferView>();
+        data = static_cast<const uint8_t*>(view->Buffer()->GetBackingStore()->Data()) + view->ByteOffset();
+        length = view->ByteLength();
+    } else if (args.Length() > 0 && args[0]->IsArrayBuffer()) {
+        std::shared_ptr<v8::BackingStore> store = args[0].As<v8::ArrayBuffer>()->GetBackingStore();
+        data = static_cast<const uint8_t*>(store->Data());
+        length = store->ByteLength();
+    } else {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "applyPatch requires an ArrayBuffer or ArrayBufferView")));
+        return;
+    }
+    
+    std::vector<DOMNode*> targets;
+    std::vector<DOMNode*> sources;
+    if (!NodeTableArg(isolate, context, args[1], &targets) ||
+        !NodeTableArg(isolate, context, args[2], &sources)) {
+        return;
+    }
+    
+    int32_t err = dom_document_apply_patch(doc, data, length, targets.data(), targets.size(),
+                                           sources.data(), sources.size());
+    if (err != 0) {
+        ThrowDOMException(isolate, err);
+    }
 }
 
-void DocumentWrapper::CreateNodeIterator(const v8::FunctionCallbackInfo<v8::Value>& args) {
+#if V8_DOM_ENABLE_RANGES
+/**
+ * document.createStaticRanges(containers, offsets): non-standard batch
+ * StaticRange constructor for highlight layers. `offsets` is a Uint32Array
+ * of start/end pairs; `containers` is one Node used for every boundary or
+ * an array of Nodes, one per offset. Returns an array of StaticRanges taken
+ * from the document's range pool in one C-ABI call.
+ */
+void DocumentWrapper::CreateStaticRanges(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("DocumentWrapper::CreateStaticRanges");
     v8::Isolate* isolate = args.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     
-    DOMDocument* doc = Unwrap(args.This());
+    DOMDocument* doc = UnwrapReceiver<DOMDocument>(args);
     if (!doc) {
+        return;
+    }
+    
+    if (args.Length() < 2 || !args[1]->IsUint32Array()) {
         isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Document object")));
+            v8::String::NewFromUtf8Literal(isolate, "createStaticRanges requires a Uint32Array of offsets")));
+        return;
+    }
+    v8::Local<v8::Uint32Array> view = args[1].As<v8::Uint32Array>();
+    if (view->Length() % 2 != 0) {
+        isolate->ThrowException(v8::Exception::RangeError(
+            v8::String::NewFromUtf8Literal(isolate, "offsets must hold start/end pairs")));
+        return;
+    }
+    const size_t count = view->Length() / 2;
+    std::vector<uint32_t> offsets(view->Length());
+    view->CopyContents(offsets.data(), offsets.size() * sizeof(uint32_t));
+    
+    std::vector<DOMNode*> containers;
+    if (args[0]->IsArray()) {
+        if (!NodeTableArg(isolate, context, args[0], &containers)) {
+            return;
+        }
+    } else {
+        DOMNode* shared = args[0]->IsObject() ? NodeWrapper::Unwrap(args[0].As<v8::Object>()) : nullptr;
+        if (!shared) {
+            isolate->ThrowException(v8::Exception::TypeError(
+                v8::String::NewFromUtf8Literal(isolate, "containers must be a Node or an array of Nodes")));
+            return;
+        }
+        containers.assign(offsets.size(), shared);
+    }
+    if (containers.size() != offsets.size()) {
+        isolate->ThrowException(v8::Exception::RangeError(
+            v8::String::NewFromUtf8Literal(isolate, "containers and offsets differ in length")));
         return;
     }
     
+    std::vector<DOMStaticRange*> ranges(count);
+    int32_t err = dom_staticrange_new_many(doc, containers.data(), offsets.data(), count, ranges.data());
+    if (err != 0) {
+        ThrowDOMException(isolate, err);
+        return;
+    }
+    
+    // Each wrapper owns its range from here on; after a failure the
+    // ranges not yet wrapped are released
+    v8::Local<v8::Array> result = v8::Array::New(isolate, static_cast<int>(count));
+    bool ok = true;
+    for (size_t i = 0; i < count; i++) {
+        if (!ok) {
+            dom_staticrange_release(ranges[i]);
+            continue;
+        }
+        v8::Local<v8::Object> wrapper = StaticRangeWrapper::Wrap(isolate, context, ranges[i]);
+        ok = !wrapper.IsEmpty() && result->Set(context, static_cast<uint32_t>(i), wrapper).IsJust();
+    }
+    if (ok) {
+        args.GetReturnValue().Set(result);
+    }
+}
+#endif // V8_DOM_ENABLE_RANGES
+
+void DocumentWrapper::CreateTreeBuilder(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("DocumentWrapper::CreateTreeBuilder");
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    
+    DOMDocument* doc = UnwrapReceiver<DOMDocument>(args);
+    if (!doc) {
+        return;
+    }
+    
+    v8::Local<v8::Object> result;
+    if (TreeBuilderWrapper::Create(isolate, context, doc).ToLocal(&result)) {
+        args.GetReturnValue().Set(result);
+    }
+}
+
+// ===== Node Handles (non-standard) =====
+//
+// Ids are 30-bit integers (Smis), so a traversal over them allocates
+// nothing; only __nodeById() creates a wrapper. 0 means "no node".
+
+namespace {
+
+// Reads the id argument; false if the conversion threw
+bool IdArg(const v8::FunctionCallbackInfo<v8::Value>& args, uint32_t* id) {
+    *id = 0;
     if (args.Length() < 1) {
+        return true;
+    }
+    return args[0]->Uint32Value(args.GetIsolate()->GetCurrentContext()).To(id);
+}
+
+uint32_t NodeTypeOf(DOMDocument* doc, uint32_t id) {
+    return ScriptNodeType(dom_nodetable_nodetype(doc, id));
+}
+
+void SetRelated(const v8::FunctionCallbackInfo<v8::Value>& args, uint8_t relation) {
+    DOMDocument* doc = UnwrapReceiver<DOMDocument>(args);
+    uint32_t id;
+    if (!doc || !IdArg(args, &id)) {
+        return;
+    }
+    args.GetReturnValue().Set(dom_nodetable_related(doc, id, relation));
+}
+
+uint32_t FastRelated(v8::Local<v8::Object> receiver, uint32_t id, uint8_t relation) {
+    DOMDocument* doc = UnwrapReceiver<DOMDocument>(receiver);
+    return doc ? dom_nodetable_related(doc, id, relation) : 0;
+}
+
+} // namespace
+
+void DocumentWrapper::NodeById(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("DocumentWrapper::NodeById");
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    
+    DOMDocument* doc = UnwrapReceiver<DOMDocument>(args);
+    uint32_t id;
+    if (!doc || !IdArg(args, &id)) {
+        return;
+    }
+    
+    // Borrowed: the wrapper takes its own reference
+    DOMNode* node = dom_nodetable_node(doc, id);
+    if (node) {
+        args.GetReturnValue().Set(NodeWrapper::Wrap(isolate, context, node));
+    } else {
+        args.GetReturnValue().SetNull();
+    }
+}
+
+void DocumentWrapper::ParentOfId(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    SetRelated(args, DOM_NODE_RELATION_PARENT);
+}
+
+void DocumentWrapper::FirstChildOfId(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    SetRelated(args, DOM_NODE_RELATION_FIRST_CHILD);
+}
+
+void DocumentWrapper::LastChildOfId(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    SetRelated(args, DOM_NODE_RELATION_LAST_CHILD);
+}
+
+void DocumentWrapper::PreviousSiblingOfId(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    SetRelated(args, DOM_NODE_RELATION_PREVIOUS_SIBLING);
+}
+
+void DocumentWrapper::NextSiblingOfId(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    SetRelated(args, DOM_NODE_RELATION_NEXT_SIBLING);
+}
+
+void DocumentWrapper::NodeTypeOfId(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    DOMDocument* doc = UnwrapReceiver<DOMDocument>(args);
+    uint32_t id;
+    if (!doc || !IdArg(args, &id)) {
+        return;
+    }
+    args.GetReturnValue().Set(NodeTypeOf(doc, id));
+}
+
+void DocumentWrapper::TagAtomOfId(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    DOMDocument* doc = UnwrapReceiver<DOMDocument>(args);
+    uint32_t id;
+    if (!doc || !IdArg(args, &id)) {
+        return;
+    }
+    args.GetReturnValue().Set(dom_nodetable_tag_atom(doc, id));
+}
+
+void DocumentWrapper::Atom(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("DocumentWrapper::Atom");
+    v8::Isolate* isolate = args.GetIsolate();
+    
+    DOMDocument* doc = UnwrapReceiver<DOMDocument>(args);
+    if (!doc) {
+        return;
+    }
+    
+    if (args.Length() < 1 || !args[0]->IsString()) {
         isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Root node required")));
+            v8::String::NewFromUtf8Literal(isolate, "First argument must be a string")));
         return;
     }
     
-    // TODO: Unwrap root node, get whatToShow, filter when NodeWrapper available
-    args.GetReturnValue().SetNull();
+    StringArgFromV8 name(isolate, args[0]);
+    args.GetReturnValue().Set(dom_nodetable_atom(doc, name.data(), name.length()));
+}
+
+void DocumentWrapper::AtomName(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    v8::Isolate* isolate = args.GetIsolate();
+    
+    DOMDocument* doc = UnwrapReceiver<DOMDocument>(args);
+    uint32_t atom;
+    if (!doc || !IdArg(args, &atom)) {
+        return;
+    }
+    
+    DOMStringView view;
+    if (dom_nodetable_atom_name(doc, atom, &view)) {
+        args.GetReturnValue().Set(NameViewToV8String(isolate, view, reinterpret_cast<DOMNode*>(doc)));
+    } else {
+        args.GetReturnValue().SetNull();
+    }
+}
+
+void DocumentWrapper::ClearNodeIds(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    DOMDocument* doc = UnwrapReceiver<DOMDocument>(args);
+    if (doc) {
+        dom_nodetable_clear(doc);
+    }
+}
+
+const v8::CFunction DocumentWrapper::kFastParentOfId = v8::CFunction::Make(FastParentOfId);
+const v8::CFunction DocumentWrapper::kFastFirstChildOfId = v8::CFunction::Make(FastFirstChildOfId);
+const v8::CFunction DocumentWrapper::kFastLastChildOfId = v8::CFunction::Make(FastLastChildOfId);
+const v8::CFunction DocumentWrapper::kFastPreviousSiblingOfId = v8::CFunction::Make(FastPreviousSiblingOfId);
+const v8::CFunction DocumentWrapper::kFastNextSiblingOfId = v8::CFunction::Make(FastNextSiblingOfId);
+const v8::CFunction DocumentWrapper::kFastNodeTypeOfId = v8::CFunction::Make(FastNodeTypeOfId);
+const v8::CFunction DocumentWrapper::kFastTagAtomOfId = v8::CFunction::Make(FastTagAtomOfId);
+
+uint32_t DocumentWrapper::FastParentOfId(v8::Local<v8::Object> receiver, uint32_t id) {
+    return FastRelated(receiver, id, DOM_NODE_RELATION_PARENT);
+}
+
+uint32_t DocumentWrapper::FastFirstChildOfId(v8::Local<v8::Object> receiver, uint32_t id) {
+    return FastRelated(receiver, id, DOM_NODE_RELATION_FIRST_CHILD);
+}
+
+uint32_t DocumentWrapper::FastLastChildOfId(v8::Local<v8::Object> receiver, uint32_t id) {
+    return FastRelated(receiver, id, DOM_NODE_RELATION_LAST_CHILD);
+}
+
+uint32_t DocumentWrapper::FastPreviousSiblingOfId(v8::Local<v8::Object> receiver, uint32_t id) {
+    return FastRelated(receiver, id, DOM_NODE_RELATION_PREVIOUS_SIBLING);
+}
+
+uint32_t DocumentWrapper::FastNextSiblingOfId(v8::Local<v8::Object> receiver, uint32_t id) {
+    return FastRelated(receiver, id, DOM_NODE_RELATION_NEXT_SIBLING);
+}
+
+uint32_t DocumentWrapper::FastNodeTypeOfId(v8::Local<v8::Object> receiver, uint32_t id) {
+    DOMDocument* doc = UnwrapReceiver<DOMDocument>(receiver);
+    return doc ? NodeTypeOf(doc, id) : 0;
+}
+
+uint32_t DocumentWrapper::FastTagAtomOfId(v8::Local<v8::Object> receiver, uint32_t id) {
+    DOMDocument* doc = UnwrapReceiver<DOMDocument>(receiver);
+    return doc ? dom_nodetable_tag_atom(doc, id) : 0;
 }
 
 } // namespace v8_dom
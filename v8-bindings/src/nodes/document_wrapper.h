@@ -9,6 +9,10 @@
 #define V8_DOM_DOCUMENT_WRAPPER_H
 
 #include <v8.h>
+#include "../core/wrapper_traits.h"
+#include "../core/external_references.h"
+#include "../core/property_table.h"
+#include "../core/features.h"
 #include "node_wrapper.h"
 #include "dom.h"
 
@@ -42,9 +46,22 @@ public:
     /**
      * Template cache index.
      */
-    static constexpr int kTemplateIndex = 3;
+    static constexpr int kTemplateIndex = WrapperTraits<DocumentWrapper>::kTemplateIndex;
+    
+    /**
+     * Type tag stored in the wrapper's type internal field.
+     */
+    static const WrapperTypeInfo kTypeInfo;
+    
+    /**
+     * Register this wrapper's callbacks for snapshot serialization.
+     */
+    static void RegisterExternalReferences(ExternalReferenceRegistry* registry);
     
 private:
+    // Prototype members, installed by InstallTemplate()
+    static const PropertyDescriptor kProperties[];
+    
     // Readonly properties
     static void CompatModeGetter(v8::Local<v8::Name> property,
                                  const v8::PropertyCallbackInfo<v8::Value>& info);
@@ -78,9 +95,50 @@ private:
     static void GetElementById(const v8::FunctionCallbackInfo<v8::Value>& args);
     
     // Range/Iterator factory methods
+#if V8_DOM_ENABLE_RANGES
     static void CreateRange(const v8::FunctionCallbackInfo<v8::Value>& args);
+#endif
+#if V8_DOM_ENABLE_TRAVERSAL
     static void CreateTreeWalker(const v8::FunctionCallbackInfo<v8::Value>& args);
     static void CreateNodeIterator(const v8::FunctionCallbackInfo<v8::Value>& args);
+#endif
+    
+    // Non-standard methods
+    static void Batch(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void CreateTreeBuilder(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void ApplyPatch(const v8::FunctionCallbackInfo<v8::Value>& args);
+#if V8_DOM_ENABLE_RANGES
+    static void CreateStaticRanges(const v8::FunctionCallbackInfo<v8::Value>& args);
+#endif
+    
+    // Non-standard: integer node handles (node.__id, see dom_nodetable_*)
+    static void NodeById(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void ParentOfId(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void FirstChildOfId(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void LastChildOfId(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void PreviousSiblingOfId(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void NextSiblingOfId(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void NodeTypeOfId(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void TagAtomOfId(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void Atom(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void AtomName(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void ClearNodeIds(const v8::FunctionCallbackInfo<v8::Value>& args);
+    
+    // Fast API variants of the integer-only handle methods
+    static uint32_t FastParentOfId(v8::Local<v8::Object> receiver, uint32_t id);
+    static uint32_t FastFirstChildOfId(v8::Local<v8::Object> receiver, uint32_t id);
+    static uint32_t FastLastChildOfId(v8::Local<v8::Object> receiver, uint32_t id);
+    static uint32_t FastPreviousSiblingOfId(v8::Local<v8::Object> receiver, uint32_t id);
+    static uint32_t FastNextSiblingOfId(v8::Local<v8::Object> receiver, uint32_t id);
+    static uint32_t FastNodeTypeOfId(v8::Local<v8::Object> receiver, uint32_t id);
+    static uint32_t FastTagAtomOfId(v8::Local<v8::Object> receiver, uint32_t id);
+    static const v8::CFunction kFastParentOfId;
+    static const v8::CFunction kFastFirstChildOfId;
+    static const v8::CFunction kFastLastChildOfId;
+    static const v8::CFunction kFastPreviousSiblingOfId;
+    static const v8::CFunction kFastNextSiblingOfId;
+    static const v8::CFunction kFastNodeTypeOfId;
+    static const v8::CFunction kFastTagAtomOfId;
 };
 
 } // namespace v8_dom
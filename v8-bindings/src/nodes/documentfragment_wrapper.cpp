@@ -2,72 +2,59 @@
 #include "../wrapper_cache.h"
 #include "../core/template_cache.h"
 #include "../core/utilities.h"
+#include "../collections/childlist_wrapper.h"
+#include "../collections/nodelist_wrapper.h"
+#include "element_wrapper.h"
+#include "node_mixins.h"
+#include "../core/features.h"
+#if V8_DOM_ENABLE_SHADOW
+#include "../shadow/shadowroot_wrapper.h"
+#endif
 
 namespace v8_dom {
 
+const WrapperTypeInfo DocumentFragmentWrapper::kTypeInfo = {"DocumentFragment", &NodeWrapper::kTypeInfo};
+
 v8::Local<v8::Object> DocumentFragmentWrapper::Wrap(v8::Isolate* isolate,
                                               v8::Local<v8::Context> context,
                                               DOMDocumentFragment* obj) {
-    if (!obj) {
-        return v8::Local<v8::Object>();
-    }
-    
-    // Check wrapper cache first
-    WrapperCache* cache = WrapperCache::ForIsolate(isolate);
-    if (cache->Has(obj)) {
-        return cache->Get(isolate, obj);
+#if V8_DOM_ENABLE_SHADOW
+    // ShadowRoot derives from DocumentFragment: wrap those with their own template
+    if (obj && dom_node_get_nodetype((DOMNode*)obj) == DOM_SHADOW_ROOT_NODE) {
+        return ShadowRootWrapper::Wrap(isolate, context, (DOMShadowRoot*)obj);
     }
-    
-    // Create new wrapper
-    v8::EscapableHandleScope handle_scope(isolate);
-    v8::Local<v8::FunctionTemplate> tmpl = GetTemplate(isolate);
-    v8::Local<v8::Function> constructor = tmpl->GetFunction(context).ToLocalChecked();
-    v8::Local<v8::Object> wrapper = constructor->NewInstance(context).ToLocalChecked();
-    
-    // Store C pointer in internal field
-    wrapper->SetInternalField(0, v8::External::New(isolate, obj));
-    
-    // Increment C-side reference count
-    dom_documentfragment_addref(obj);
-    
-    // Cache with release callback
-    cache->Set(isolate, obj, wrapper, [](void* ptr) {
-        dom_documentfragment_release(static_cast<DOMDocumentFragment*>(ptr));
-    });
-    
-    return handle_scope.Escape(wrapper);
+#endif
+    return WrapWithTraits<DocumentFragmentWrapper>(isolate, context, obj);
 }
 
 DOMDocumentFragment* DocumentFragmentWrapper::Unwrap(v8::Local<v8::Object> obj) {
-    if (obj.IsEmpty() || obj->InternalFieldCount() < 1) {
-        return nullptr;
-    }
-    
-    v8::Local<v8::Value> ptr = obj->GetInternalField(0).As<v8::Value>();
-    if (!ptr->IsExternal()) {
-        return nullptr;
-    }
-    
-    return static_cast<DOMDocumentFragment*>(v8::Local<v8::External>::Cast(ptr)->Value());
+    return UnwrapWithTraits<DocumentFragmentWrapper>(obj);
 }
 
+const PropertyDescriptor DocumentFragmentWrapper::kProperties[] = {
+    // Readonly properties
+    AccessorProperty("children", ChildListWrapper::ChildrenGetter, nullptr, kReceiverCheck | kNoSideEffect),
+    DataProperty("firstElementChild", FirstElementChildGetter),
+    DataProperty("lastElementChild", LastElementChildGetter),
+    DataProperty("childElementCount", ChildElementCountGetter),
+    
+    // Methods - ParentNode mixin
+    MethodProperty("querySelector", QuerySelector),
+    MethodProperty("querySelectorAll", QuerySelectorAll),
+};
+
 void DocumentFragmentWrapper::InstallTemplate(v8::Isolate* isolate) {
     v8::Local<v8::FunctionTemplate> tmpl = v8::FunctionTemplate::New(isolate);
     tmpl->SetClassName(v8::String::NewFromUtf8Literal(isolate, "DocumentFragment"));
-    tmpl->InstanceTemplate()->SetInternalFieldCount(1);
+    tmpl->InstanceTemplate()->SetInternalFieldCount(kWrapperFieldCount);
     
     // Inherit from Node
     tmpl->Inherit(NodeWrapper::GetTemplate(isolate));
 
-    // Get prototype template for adding properties/methods
-    v8::Local<v8::ObjectTemplate> proto = tmpl->PrototypeTemplate();
+    InstallProperties(isolate, tmpl, kProperties);
     
-    // TODO: Add properties and methods here
-    // Example:
-    // proto->SetNativeDataProperty(v8::String::NewFromUtf8Literal(isolate, "propertyName"),
-    //                   PropertyNameGetter, PropertyNameSetter);
-    // proto->Set(v8::String::NewFromUtf8Literal(isolate, "methodName"),
-    //           v8::FunctionTemplate::New(isolate, MethodName));
+    // Methods - ParentNode mixin
+    ParentNodeMixin::Install(isolate, tmpl->PrototypeTemplate(), v8::Signature::New(isolate, tmpl));
     
     // Cache the template
     TemplateCache* cache = TemplateCache::ForIsolate(isolate);
@@ -84,4 +71,115 @@ v8::Local<v8::FunctionTemplate> DocumentFragmentWrapper::GetTemplate(v8::Isolate
     return cache->Get(kTemplateIndex);
 }
 
+void DocumentFragmentWrapper::RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+    RegisterProperties(registry, kProperties);
+}
+
+// ============================================================================
+// Property Implementations - Readonly
+// ============================================================================
+
+void DocumentFragmentWrapper::FirstElementChildGetter(v8::Local<v8::Name> property,
+                                                      const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("DocumentFragmentWrapper::FirstElementChildGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    DOMDocumentFragment* fragment = Unwrap(info.This());
+    if (!fragment) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Invalid DocumentFragment")));
+        return;
+    }
+    
+    DOMElement* result = dom_documentfragment_get_firstelementchild(fragment);
+    if (result) {
+        info.GetReturnValue().Set(ElementWrapper::Wrap(isolate, isolate->GetCurrentContext(), result));
+    } else {
+        info.GetReturnValue().SetNull();
+    }
+}
+
+void DocumentFragmentWrapper::LastElementChildGetter(v8::Local<v8::Name> property,
+                                                     const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("DocumentFragmentWrapper::LastElementChildGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    DOMDocumentFragment* fragment = Unwrap(info.This());
+    if (!fragment) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Invalid DocumentFragment")));
+        return;
+    }
+    
+    DOMElement* result = dom_documentfragment_get_lastelementchild(fragment);
+    if (result) {
+        info.GetReturnValue().Set(ElementWrapper::Wrap(isolate, isolate->GetCurrentContext(), result));
+    } else {
+        info.GetReturnValue().SetNull();
+    }
+}
+
+void DocumentFragmentWrapper::ChildElementCountGetter(v8::Local<v8::Name> property,
+                                                      const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("DocumentFragmentWrapper::ChildElementCountGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    DOMDocumentFragment* fragment = Unwrap(info.This());
+    if (!fragment) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Invalid DocumentFragment")));
+        return;
+    }
+    
+    info.GetReturnValue().Set(dom_documentfragment_get_childelementcount(fragment));
+}
+
+// ============================================================================
+// Method Implementations
+// ============================================================================
+
+void DocumentFragmentWrapper::QuerySelector(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("DocumentFragmentWrapper::QuerySelector");
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    DOMDocumentFragment* fragment = UnwrapReceiver<DOMDocumentFragment>(args);
+    if (!fragment) {
+        return;
+    }
+    
+    if (args.Length() < 1) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "querySelector requires 1 argument")));
+        return;
+    }
+    
+    StringArgFromV8 selectors(isolate, args[0]);
+    DOMElement* result = dom_documentfragment_queryselector(fragment, selectors.data());
+    
+    if (result) {
+        args.GetReturnValue().Set(ElementWrapper::Wrap(isolate, context, result));
+    } else {
+        args.GetReturnValue().SetNull();
+    }
+}
+
+void DocumentFragmentWrapper::QuerySelectorAll(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("DocumentFragmentWrapper::QuerySelectorAll");
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    DOMDocumentFragment* fragment = UnwrapReceiver<DOMDocumentFragment>(args);
+    if (!fragment) {
+        return;
+    }
+    
+    if (args.Length() < 1) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "querySelectorAll requires 1 argument")));
+        return;
+    }
+    
+    StringArgFromV8 selectors(isolate, args[0]);
+    DOMNodeList* result = dom_documentfragment_queryselectorall(fragment, selectors.data());
+    
+    // No matches wraps as an empty NodeList
+    args.GetReturnValue().Set(NodeListWrapper::Wrap(isolate, context, result));
+}
+
 } // namespace v8_dom
@@ -2,59 +2,26 @@
 #include "../wrapper_cache.h"
 #include "../core/template_cache.h"
 #include "../core/utilities.h"
+#include "node_mixins.h"
 
 namespace v8_dom {
 
+const WrapperTypeInfo DocumentTypeWrapper::kTypeInfo = {"DocumentType", &NodeWrapper::kTypeInfo};
+
 v8::Local<v8::Object> DocumentTypeWrapper::Wrap(v8::Isolate* isolate,
                                               v8::Local<v8::Context> context,
                                               DOMDocumentType* obj) {
-    if (!obj) {
-        return v8::Local<v8::Object>();
-    }
-    
-    // Check wrapper cache first
-    WrapperCache* cache = WrapperCache::ForIsolate(isolate);
-    if (cache->Has(obj)) {
-        return cache->Get(isolate, obj);
-    }
-    
-    // Create new wrapper
-    v8::EscapableHandleScope handle_scope(isolate);
-    v8::Local<v8::FunctionTemplate> tmpl = GetTemplate(isolate);
-    v8::Local<v8::Function> constructor = tmpl->GetFunction(context).ToLocalChecked();
-    v8::Local<v8::Object> wrapper = constructor->NewInstance(context).ToLocalChecked();
-    
-    // Store C pointer in internal field
-    wrapper->SetInternalField(0, v8::External::New(isolate, obj));
-    
-    // Increment C-side reference count
-    dom_documenttype_addref(obj);
-    
-    // Cache with release callback
-    cache->Set(isolate, obj, wrapper, [](void* ptr) {
-        dom_documenttype_release(static_cast<DOMDocumentType*>(ptr));
-    });
-    
-    return handle_scope.Escape(wrapper);
+    return WrapWithTraits<DocumentTypeWrapper>(isolate, context, obj);
 }
 
 DOMDocumentType* DocumentTypeWrapper::Unwrap(v8::Local<v8::Object> obj) {
-    if (obj.IsEmpty() || obj->InternalFieldCount() < 1) {
-        return nullptr;
-    }
-    
-    v8::Local<v8::Value> ptr = obj->GetInternalField(0).As<v8::Value>();
-    if (!ptr->IsExternal()) {
-        return nullptr;
-    }
-    
-    return static_cast<DOMDocumentType*>(v8::Local<v8::External>::Cast(ptr)->Value());
+    return UnwrapWithTraits<DocumentTypeWrapper>(obj);
 }
 
 void DocumentTypeWrapper::InstallTemplate(v8::Isolate* isolate) {
     v8::Local<v8::FunctionTemplate> tmpl = v8::FunctionTemplate::New(isolate);
     tmpl->SetClassName(v8::String::NewFromUtf8Literal(isolate, "DocumentType"));
-    tmpl->InstanceTemplate()->SetInternalFieldCount(1);
+    tmpl->InstanceTemplate()->SetInternalFieldCount(kWrapperFieldCount);
     
     // Inherit from Node
     tmpl->Inherit(NodeWrapper::GetTemplate(isolate));
@@ -62,12 +29,14 @@ void DocumentTypeWrapper::InstallTemplate(v8::Isolate* isolate) {
     // Get prototype template for adding properties/methods
     v8::Local<v8::ObjectTemplate> proto = tmpl->PrototypeTemplate();
     
-    // TODO: Add properties and methods here
+    // Methods - ChildNode mixin
+    ChildNodeMixin::Install(isolate, proto, v8::Signature::New(isolate, tmpl));
+    
+    // TODO: List properties and methods in a kProperties table and
+    // install it with InstallProperties(isolate, tmpl, kProperties).
     // Example:
-    // proto->SetNativeDataProperty(v8::String::NewFromUtf8Literal(isolate, "propertyName"),
-    //                   PropertyNameGetter, PropertyNameSetter);
-    // proto->Set(v8::String::NewFromUtf8Literal(isolate, "methodName"),
-    //           v8::FunctionTemplate::New(isolate, MethodName));
+    //     DataProperty("propertyName", PropertyNameGetter, PropertyNameSetter),
+    //     MethodProperty("methodName", MethodName),
     
     // Cache the template
     TemplateCache* cache = TemplateCache::ForIsolate(isolate);
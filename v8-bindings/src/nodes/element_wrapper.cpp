@@ -2,104 +2,179 @@
 #include "../wrapper_cache.h"
 #include "../core/template_cache.h"
 #include "../core/utilities.h"
+#include "../core/string_cache.h"
+#include "../core/atom_table.h"
+#include "../core/binding_state.h"
+#include "../core/call_recorder.h"
 #include "../collections/nodelist_wrapper.h"
 #include "../collections/domtokenlist_wrapper.h"
+#include "../collections/domstringmap_wrapper.h"
+#include "../collections/childlist_wrapper.h"
+#include "../collections/namednodemap_wrapper.h"
+#include "node_mixins.h"
+#if V8_DOM_ENABLE_SHADOW
 #include "../shadow/shadowroot_wrapper.h"
+#endif
+#include "../custom_elements/customelementregistry_wrapper.h"
 #include <cstdio>
+#include <string>
+#include <vector>
 
 namespace v8_dom {
 
+const WrapperTypeInfo ElementWrapper::kTypeInfo = {"Element", &NodeWrapper::kTypeInfo};
+
+namespace {
+
+/**
+ * Compiled selector for a string argument, or nullptr to take the string
+ * path (non-string argument, element of another document, invalid
+ * selector). Borrowed from BindingState's CompiledSelectorCache.
+ */
+DOMSelector* CompiledSelectorArg(v8::Isolate* isolate, DOMElement* elem, v8::Local<v8::Value> arg) {
+    if (!arg->IsString()) {
+        return nullptr;
+    }
+    
+    BindingState* state = BindingState::ForIsolate(isolate);
+    DOMDocument* doc = state->Document();
+    if (dom_node_get_ownerdocument((DOMNode*)elem) != doc) {
+        return nullptr;
+    }
+    return state->Selectors()->Get(isolate, arg.As<v8::String>(), doc);
+}
+
+/**
+ * Attribute names of one element as V8 strings, collected in a single
+ * pass over the attributes (inline up to kInlineCapacity names).
+ */
+class AttributeNameCollector {
+public:
+    AttributeNameCollector(v8::Isolate* isolate, DOMElement* elem)
+        : isolate_(isolate), node_(reinterpret_cast<DOMNode*>(elem)) {}
+
+    static void Add(const DOMStringView* name, void* user_data) {
+        auto* self = static_cast<AttributeNameCollector*>(user_data);
+        v8::Local<v8::Value> value = NameViewToV8String(self->isolate_, *name, self->node_);
+        if (self->size_ < kInlineCapacity && self->heap_.empty()) {
+            self->inline_[self->size_++] = value;
+            return;
+        }
+        if (self->heap_.empty()) {
+            self->heap_.assign(self->inline_, self->inline_ + self->size_);
+        }
+        self->heap_.push_back(value);
+        self->size_++;
+    }
+
+    v8::Local<v8::Value>* data() { return heap_.empty() ? inline_ : heap_.data(); }
+    size_t size() const { return size_; }
+
+private:
+    static constexpr size_t kInlineCapacity = 16;
+
+    v8::Isolate* isolate_;
+    DOMNode* node_;
+    v8::Local<v8::Value> inline_[kInlineCapacity];
+    std::vector<v8::Local<v8::Value>> heap_;
+    size_t size_ = 0;
+};
+
+} // namespace
+
 v8::Local<v8::Object> ElementWrapper::Wrap(v8::Isolate* isolate,
                                               v8::Local<v8::Context> context,
                                               DOMElement* obj) {
     if (!obj) {
         return v8::Local<v8::Object>();
     }
-    
-    // Check wrapper cache first
+
     WrapperCache* cache = WrapperCache::ForIsolate(isolate);
-    if (cache->Has(obj)) {
-        return cache->Get(isolate, obj);
+    v8::Local<v8::Object> cached;
+    if (LookupWrapper<ElementWrapper>(isolate, cache, obj, &cached)) {
+        return cached;
     }
-    
-    // Create new wrapper
-    v8::EscapableHandleScope handle_scope(isolate);
-    v8::Local<v8::FunctionTemplate> tmpl = GetTemplate(isolate);
-    v8::Local<v8::Function> constructor = tmpl->GetFunction(context).ToLocalChecked();
-    v8::Local<v8::Object> wrapper = constructor->NewInstance(context).ToLocalChecked();
-    
-    // Store C pointer in internal field
-    wrapper->SetInternalField(0, v8::External::New(isolate, obj));
-    
-    // Increment C-side reference count
-    dom_element_addref(obj);
-    
-    // Cache with release callback
-    cache->Set(isolate, obj, wrapper, [](void* ptr) {
-        dom_element_release(static_cast<DOMElement*>(ptr));
-    });
-    
-    return handle_scope.Escape(wrapper);
+    v8::Local<v8::Object> wrapper = CreateWrapper<ElementWrapper>(isolate, context, cache, obj);
+    CustomElementRegistryWrapper::RestoreClass(isolate, context, obj, wrapper);
+    return wrapper;
 }
 
 DOMElement* ElementWrapper::Unwrap(v8::Local<v8::Object> obj) {
-    if (obj.IsEmpty() || obj->InternalFieldCount() < 1) {
-        return nullptr;
-    }
-    
-    // V8 13.5: GetInternalField returns Local<Data>, cast to Local<Value>
-    v8::Local<v8::Data> data = obj->GetInternalField(0);
-    v8::Local<v8::Value> ptr = data.As<v8::Value>();
-    if (ptr.IsEmpty()) return nullptr;
-    if (!ptr->IsExternal()) {
-        return nullptr;
-    }
-    
-    return static_cast<DOMElement*>(v8::Local<v8::External>::Cast(ptr)->Value());
+    return UnwrapWithTraits<ElementWrapper>(obj);
 }
 
-// Named property setter interceptor to prevent instance property shadowing
-// This ensures elem.id = "value" calls the prototype setter instead of creating an instance property
-v8::Intercepted ElementWrapper::NamedPropertySetter(v8::Local<v8::Name> property,
-                                                    v8::Local<v8::Value> value,
-                                                    const v8::PropertyCallbackInfo<void>& info) {
-    v8::Isolate* isolate = info.GetIsolate();
+const PropertyDescriptor ElementWrapper::kProperties[] = {
+    // Readonly properties
+    DataProperty("tagName", TagNameGetter),
+    DataProperty("namespaceURI", NamespaceURIGetter),
+    DataProperty("prefix", PrefixGetter),
+    DataProperty("localName", LocalNameGetter),
+    DataProperty("classList", ClassListGetter),
+    DataProperty("dataset", DatasetGetter),
+#if V8_DOM_ENABLE_SHADOW
+    DataProperty("shadowRoot", ShadowRootGetter),
+    DataProperty("assignedSlot", AssignedSlotGetter),
+#endif
     
-    // Check if this is one of our special properties that should be handled by prototype setters
-    if (property->IsString()) {
-        v8::String::Utf8Value prop_name(isolate, property);
-        
-        // For id, className, and slot properties, explicitly call our setter
-        if (strcmp(*prop_name, "id") == 0) {
-            IdSetter(property, value, info);
-            return v8::Intercepted::kYes;  // We handled it
-        } else if (strcmp(*prop_name, "className") == 0) {
-            ClassNameSetter(property, value, info);
-            return v8::Intercepted::kYes;
-        } else if (strcmp(*prop_name, "slot") == 0) {
-            SlotSetter(property, value, info);
-            return v8::Intercepted::kYes;
-        }
-    }
+    // Read/write properties
+    // Accessor properties (like WebIDL attributes), so assignments on an
+    // instance reach the setter through the prototype chain instead of
+    // creating an own data property; expando stores are not intercepted
+    AccessorProperty("id", IdGetter, IdSetter),
+    AccessorProperty("className", ClassNameGetter, ClassNameSetter),
+    AccessorProperty("slot", SlotGetter, SlotSetter),
+    AccessorProperty("children", ChildListWrapper::ChildrenGetter),
+    AccessorProperty("attributes", NamedNodeMapWrapper::AttributesGetter),
     
-    // For other properties, let V8 handle them normally
-    return v8::Intercepted::kNo;
-}
+    // Methods - Attributes
+    MethodProperty("getAttribute", GetAttribute),
+    MethodProperty("getAttributeNS", GetAttributeNS),
+    MethodProperty("setAttribute", SetAttribute),
+    MethodProperty("setAttributeNS", SetAttributeNS),
+    MethodProperty("removeAttribute", RemoveAttribute),
+    MethodProperty("removeAttributeNS", RemoveAttributeNS),
+    MethodProperty("toggleAttribute", ToggleAttribute),
+    MethodProperty("hasAttribute", HasAttribute, kReceiverCheck | kNoSideEffect, 1, &kFastHasAttribute),
+    MethodProperty("hasAttributeNS", HasAttributeNS),
+    MethodProperty("hasAttributes", HasAttributes),
+    MethodProperty("getAttributeNames", GetAttributeNames),
+    
+    // Non-standard: set an object's properties as attributes in one call
+    // (not enumerable)
+    MethodProperty("__setAttributes", SetAttributes, kReceiverCheck | kDontEnum),
+    
+    // Methods - Querying
+    MethodProperty("matches", Matches),
+    MethodProperty("closest", Closest),
+    MethodProperty("querySelector", QuerySelector),
+    MethodProperty("querySelectorAll", QuerySelectorAll),
+    MethodProperty("webkitMatchesSelector", WebkitMatchesSelector),
+    
+#if V8_DOM_ENABLE_SHADOW
+    // Methods - Shadow DOM
+    MethodProperty("attachShadow", AttachShadow),
+#endif
+    
+    // Methods - Adjacent insertion
+    MethodProperty("insertAdjacentElement", InsertAdjacentElement),
+    MethodProperty("insertAdjacentText", InsertAdjacentText),
+    
+    // Non-standard: parse markup into one batch insertion, for an HTML
+    // layer's insertAdjacentHTML() and innerHTML (not enumerable)
+    MethodProperty("__insertAdjacentMarkup", InsertAdjacentMarkup, kReceiverCheck | kDontEnum, 2),
+    MethodProperty("__setInnerMarkup", SetInnerMarkup, kReceiverCheck | kDontEnum, 1),
+};
 
+// Named property setter interceptor to prevent instance property shadowing
+// This ensures elem.id = "value" calls the prototype setter instead of creating an instance property
 void ElementWrapper::InstallTemplate(v8::Isolate* isolate) {
-    v8::Local<v8::FunctionTemplate> tmpl = v8::FunctionTemplate::New(isolate);
+    // Custom element classes reach the element being upgraded through super()
+    v8::Local<v8::FunctionTemplate> tmpl =
+        v8::FunctionTemplate::New(isolate, CustomElementRegistryWrapper::ConstructElement);
     tmpl->SetClassName(v8::String::NewFromUtf8Literal(isolate, "Element"));
     
     v8::Local<v8::ObjectTemplate> instance = tmpl->InstanceTemplate();
-    instance->SetInternalFieldCount(1);
-    
-    // Add named property interceptor to prevent property shadowing
-    // This ensures that setting elem.id calls our IdSetter instead of creating an instance property
-    // Note: We only intercept setters, getters continue to use the prototype
-    instance->SetHandler(v8::NamedPropertyHandlerConfiguration(
-        nullptr,  // getter (use prototype chain)
-        NamedPropertySetter  // setter (intercept all property sets)
-    ));
+    instance->SetInternalFieldCount(kWrapperFieldCount);
     
     // Inherit from Node
     tmpl->Inherit(NodeWrapper::GetTemplate(isolate));
@@ -107,78 +182,13 @@ void ElementWrapper::InstallTemplate(v8::Isolate* isolate) {
     // Get prototype template for adding properties/methods
     v8::Local<v8::ObjectTemplate> proto = tmpl->PrototypeTemplate();
     
-    // Readonly properties
-    proto->SetNativeDataProperty(v8::String::NewFromUtf8Literal(isolate, "tagName"),
-                      TagNameGetter);
-    proto->SetNativeDataProperty(v8::String::NewFromUtf8Literal(isolate, "namespaceURI"),
-                      NamespaceURIGetter);
-    proto->SetNativeDataProperty(v8::String::NewFromUtf8Literal(isolate, "prefix"),
-                      PrefixGetter);
-    proto->SetNativeDataProperty(v8::String::NewFromUtf8Literal(isolate, "localName"),
-                      LocalNameGetter);
-    proto->SetNativeDataProperty(v8::String::NewFromUtf8Literal(isolate, "classList"),
-                      ClassListGetter);
-    proto->SetNativeDataProperty(v8::String::NewFromUtf8Literal(isolate, "shadowRoot"),
-                      ShadowRootGetter);
-    proto->SetNativeDataProperty(v8::String::NewFromUtf8Literal(isolate, "assignedSlot"),
-                      AssignedSlotGetter);
+    InstallProperties(isolate, tmpl, kProperties);
     
-    // Read/write properties
-    proto->SetNativeDataProperty(v8::String::NewFromUtf8Literal(isolate, "id"),
-                      IdGetter, IdSetter,
-                      v8::Local<v8::Value>(),
-                      v8::PropertyAttribute::DontDelete);
-    proto->SetNativeDataProperty(v8::String::NewFromUtf8Literal(isolate, "className"),
-                      ClassNameGetter, ClassNameSetter);
-    proto->SetNativeDataProperty(v8::String::NewFromUtf8Literal(isolate, "slot"),
-                      SlotGetter, SlotSetter);
+    v8::Local<v8::Signature> signature = v8::Signature::New(isolate, tmpl);
     
-    // Methods - Attributes
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "getAttribute"),
-              v8::FunctionTemplate::New(isolate, GetAttribute));
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "getAttributeNS"),
-              v8::FunctionTemplate::New(isolate, GetAttributeNS));
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "setAttribute"),
-              v8::FunctionTemplate::New(isolate, SetAttribute));
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "setAttributeNS"),
-              v8::FunctionTemplate::New(isolate, SetAttributeNS));
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "removeAttribute"),
-              v8::FunctionTemplate::New(isolate, RemoveAttribute));
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "removeAttributeNS"),
-              v8::FunctionTemplate::New(isolate, RemoveAttributeNS));
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "toggleAttribute"),
-              v8::FunctionTemplate::New(isolate, ToggleAttribute));
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "hasAttribute"),
-              v8::FunctionTemplate::New(isolate, HasAttribute));
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "hasAttributeNS"),
-              v8::FunctionTemplate::New(isolate, HasAttributeNS));
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "hasAttributes"),
-              v8::FunctionTemplate::New(isolate, HasAttributes));
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "getAttributeNames"),
-              v8::FunctionTemplate::New(isolate, GetAttributeNames));
-    
-    // Methods - Querying
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "matches"),
-              v8::FunctionTemplate::New(isolate, Matches));
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "closest"),
-              v8::FunctionTemplate::New(isolate, Closest));
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "querySelector"),
-              v8::FunctionTemplate::New(isolate, QuerySelector));
-    // TODO: Enable when dom_element_queryselectorall is implemented
-    //     proto->Set(v8::String::NewFromUtf8Literal(isolate, "querySelectorAll"),
-    //               v8::FunctionTemplate::New(isolate, QuerySelectorAll));
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "webkitMatchesSelector"),
-              v8::FunctionTemplate::New(isolate, WebkitMatchesSelector));
-    
-    // Methods - Shadow DOM
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "attachShadow"),
-              v8::FunctionTemplate::New(isolate, AttachShadow));
-    
-    // Methods - Adjacent insertion
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "insertAdjacentElement"),
-              v8::FunctionTemplate::New(isolate, InsertAdjacentElement));
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "insertAdjacentText"),
-              v8::FunctionTemplate::New(isolate, InsertAdjacentText));
+    // Methods - ParentNode / ChildNode mixins
+    ParentNodeMixin::Install(isolate, proto, signature);
+    ChildNodeMixin::Install(isolate, proto, signature);
     
     // Cache the template
     TemplateCache* cache = TemplateCache::ForIsolate(isolate);
@@ -195,12 +205,17 @@ v8::Local<v8::FunctionTemplate> ElementWrapper::GetTemplate(v8::Isolate* isolate
     return cache->Get(kTemplateIndex);
 }
 
+void ElementWrapper::RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+    RegisterProperties(registry, kProperties);
+}
+
 // ============================================================================
 // Property Implementations - Readonly
 // ============================================================================
 
 void ElementWrapper::TagNameGetter(v8::Local<v8::Name> property,
                                    const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("ElementWrapper::TagNameGetter");
     v8::Isolate* isolate = info.GetIsolate();
     DOMElement* elem = Unwrap(info.This().As<v8::Object>());
     if (!elem) {
@@ -209,12 +224,14 @@ void ElementWrapper::TagNameGetter(v8::Local<v8::Name> property,
         return;
     }
     
-    const char* tag_name = dom_element_get_tagname(elem);
-    info.GetReturnValue().Set(CStringToV8String(isolate, tag_name));
+    DOMStringView tag_name;
+    dom_element_get_tagname_view(elem, &tag_name);
+    info.GetReturnValue().Set(NameViewToV8String(isolate, tag_name, (DOMNode*)elem));
 }
 
 void ElementWrapper::NamespaceURIGetter(v8::Local<v8::Name> property,
                                         const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("ElementWrapper::NamespaceURIGetter");
     v8::Isolate* isolate = info.GetIsolate();
     DOMElement* elem = Unwrap(info.This().As<v8::Object>());
     if (!elem) {
@@ -233,6 +250,7 @@ void ElementWrapper::NamespaceURIGetter(v8::Local<v8::Name> property,
 
 void ElementWrapper::PrefixGetter(v8::Local<v8::Name> property,
                                   const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("ElementWrapper::PrefixGetter");
     v8::Isolate* isolate = info.GetIsolate();
     DOMElement* elem = Unwrap(info.This().As<v8::Object>());
     if (!elem) {
@@ -251,6 +269,7 @@ void ElementWrapper::PrefixGetter(v8::Local<v8::Name> property,
 
 void ElementWrapper::LocalNameGetter(v8::Local<v8::Name> property,
                                      const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("ElementWrapper::LocalNameGetter");
     v8::Isolate* isolate = info.GetIsolate();
     DOMElement* elem = Unwrap(info.This().As<v8::Object>());
     if (!elem) {
@@ -265,6 +284,7 @@ void ElementWrapper::LocalNameGetter(v8::Local<v8::Name> property,
 
 void ElementWrapper::ClassListGetter(v8::Local<v8::Name> property,
                                      const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("ElementWrapper::ClassListGetter");
     v8::Isolate* isolate = info.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     DOMElement* elem = Unwrap(info.This().As<v8::Object>());
@@ -274,17 +294,37 @@ void ElementWrapper::ClassListGetter(v8::Local<v8::Name> property,
         return;
     }
     
-    DOMDOMTokenList* classList = dom_element_get_classlist(elem);
-    if (classList) {
-        v8::Local<v8::Object> wrapped = DOMTokenListWrapper::Wrap(isolate, context, classList);
-        info.GetReturnValue().Set(wrapped);
-    } else {
+    // [SameObject], stored on this wrapper
+    v8::Local<v8::Object> wrapped =
+        DOMTokenListWrapper::ClassList(isolate, context, info.This().As<v8::Object>(), elem);
+    if (wrapped.IsEmpty()) {
         info.GetReturnValue().SetNull();
+        return;
     }
+    info.GetReturnValue().Set(wrapped);
 }
 
+void ElementWrapper::DatasetGetter(v8::Local<v8::Name> property,
+                                   const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("ElementWrapper::DatasetGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    DOMElement* elem = Unwrap(info.This().As<v8::Object>());
+    if (!elem) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Invalid Element")));
+        return;
+    }
+
+    // [SameObject], stored on this wrapper
+    info.GetReturnValue().Set(
+        DOMStringMapWrapper::Dataset(isolate, context, info.This().As<v8::Object>(), elem));
+}
+
+#if V8_DOM_ENABLE_SHADOW
 void ElementWrapper::ShadowRootGetter(v8::Local<v8::Name> property,
                                       const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("ElementWrapper::ShadowRootGetter");
     v8::Isolate* isolate = info.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     DOMElement* elem = Unwrap(info.This().As<v8::Object>());
@@ -305,6 +345,7 @@ void ElementWrapper::ShadowRootGetter(v8::Local<v8::Name> property,
 
 void ElementWrapper::AssignedSlotGetter(v8::Local<v8::Name> property,
                                         const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("ElementWrapper::AssignedSlotGetter");
     v8::Isolate* isolate = info.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     DOMElement* elem = Unwrap(info.This().As<v8::Object>());
@@ -322,101 +363,95 @@ void ElementWrapper::AssignedSlotGetter(v8::Local<v8::Name> property,
         info.GetReturnValue().SetNull();
     }
 }
+#endif // V8_DOM_ENABLE_SHADOW
 
 // ============================================================================
 // Property Implementations - Read/Write
 // ============================================================================
 
-void ElementWrapper::IdGetter(v8::Local<v8::Name> property,
-                              const v8::PropertyCallbackInfo<v8::Value>& info) {
-    v8::Isolate* isolate = info.GetIsolate();
-    DOMElement* elem = Unwrap(info.This().As<v8::Object>());
+void ElementWrapper::IdGetter(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ElementWrapper::IdGetter");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMElement* elem = UnwrapReceiver<DOMElement>(args);
     if (!elem) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Element")));
         return;
     }
     
-    const char* id = dom_element_get_id(elem);
-    info.GetReturnValue().Set(CStringToV8String(isolate, id));
+    DOMStringView id;
+    if (dom_element_getattribute_view(elem, "id", &id)) {
+        args.GetReturnValue().Set(StringViewToV8String(isolate, id, (DOMNode*)elem));
+    } else {
+        args.GetReturnValue().SetEmptyString();
+    }
 }
 
-void ElementWrapper::IdSetter(v8::Local<v8::Name> property,
-                              v8::Local<v8::Value> value,
-                              const v8::PropertyCallbackInfo<void>& info) {
-    v8::Isolate* isolate = info.GetIsolate();
-    DOMElement* elem = Unwrap(info.This().As<v8::Object>());
+void ElementWrapper::IdSetter(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ElementWrapper::IdSetter");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMElement* elem = UnwrapReceiver<DOMElement>(args);
     if (!elem) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Element")));
         return;
     }
     
-    CStringFromV8 id(isolate, value);
+    CStringFromV8 id(isolate, args[0]);
     int32_t err = dom_element_set_id(elem, id.get());
     if (err != 0) {
         ThrowDOMException(isolate, err);
     }
 }
 
-void ElementWrapper::ClassNameGetter(v8::Local<v8::Name> property,
-                                     const v8::PropertyCallbackInfo<v8::Value>& info) {
-    v8::Isolate* isolate = info.GetIsolate();
-    DOMElement* elem = Unwrap(info.This().As<v8::Object>());
+void ElementWrapper::ClassNameGetter(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ElementWrapper::ClassNameGetter");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMElement* elem = UnwrapReceiver<DOMElement>(args);
     if (!elem) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Element")));
         return;
     }
     
-    const char* className = dom_element_get_classname(elem);
-    info.GetReturnValue().Set(CStringToV8String(isolate, className));
+    DOMStringView className;
+    if (dom_element_getattribute_view(elem, "class", &className)) {
+        args.GetReturnValue().Set(StringViewToV8String(isolate, className, (DOMNode*)elem));
+    } else {
+        args.GetReturnValue().SetEmptyString();
+    }
 }
 
-void ElementWrapper::ClassNameSetter(v8::Local<v8::Name> property,
-                                     v8::Local<v8::Value> value,
-                                     const v8::PropertyCallbackInfo<void>& info) {
-    v8::Isolate* isolate = info.GetIsolate();
-    DOMElement* elem = Unwrap(info.This().As<v8::Object>());
+void ElementWrapper::ClassNameSetter(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ElementWrapper::ClassNameSetter");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMElement* elem = UnwrapReceiver<DOMElement>(args);
     if (!elem) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Element")));
         return;
     }
     
-    CStringFromV8 className(isolate, value);
+    CStringFromV8 className(isolate, args[0]);
     int32_t err = dom_element_set_classname(elem, className.get());
     if (err != 0) {
         ThrowDOMException(isolate, err);
     }
 }
 
-void ElementWrapper::SlotGetter(v8::Local<v8::Name> property,
-                                const v8::PropertyCallbackInfo<v8::Value>& info) {
-    v8::Isolate* isolate = info.GetIsolate();
-    DOMElement* elem = Unwrap(info.This().As<v8::Object>());
+void ElementWrapper::SlotGetter(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ElementWrapper::SlotGetter");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMElement* elem = UnwrapReceiver<DOMElement>(args);
     if (!elem) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Element")));
         return;
     }
     
     const char* slot = dom_element_get_slot(elem);
-    info.GetReturnValue().Set(CStringToV8String(isolate, slot));
+    args.GetReturnValue().Set(CStringToV8String(isolate, slot));
 }
 
-void ElementWrapper::SlotSetter(v8::Local<v8::Name> property,
-                                v8::Local<v8::Value> value,
-                                const v8::PropertyCallbackInfo<void>& info) {
-    v8::Isolate* isolate = info.GetIsolate();
-    DOMElement* elem = Unwrap(info.This().As<v8::Object>());
+void ElementWrapper::SlotSetter(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ElementWrapper::SlotSetter");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMElement* elem = UnwrapReceiver<DOMElement>(args);
     if (!elem) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Element")));
         return;
     }
     
-    CStringFromV8 slot(isolate, value);
+    CStringFromV8 slot(isolate, args[0]);
     int32_t err = dom_element_set_slot(elem, slot.get());
     if (err != 0) {
         ThrowDOMException(isolate, err);
@@ -428,11 +463,10 @@ void ElementWrapper::SlotSetter(v8::Local<v8::Name> property,
 // ============================================================================
 
 void ElementWrapper::GetAttribute(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ElementWrapper::GetAttribute");
     v8::Isolate* isolate = args.GetIsolate();
-    DOMElement* elem = Unwrap(args.This());
+    DOMElement* elem = UnwrapReceiver<DOMElement>(args);
     if (!elem) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Element")));
         return;
     }
     
@@ -442,22 +476,23 @@ void ElementWrapper::GetAttribute(const v8::FunctionCallbackInfo<v8::Value>& arg
         return;
     }
     
-    CStringFromV8 qualifiedName(isolate, args[0]);
-    const char* value = dom_element_getattribute(elem, qualifiedName.get());
+    StringArgFromV8 qualifiedName(isolate, args[0]);
+    DOMStringView value;
+    V8_DOM_RECORD_CALL(kGetAttribute, TraceNode(elem), qualifiedName);
     
-    if (value && value[0] != '\0') {
-        args.GetReturnValue().Set(CStringToV8String(isolate, value));
+    if (dom_element_getattribute_view_n(elem, qualifiedName.data(), qualifiedName.length(), &value) &&
+        value.length > 0) {
+        args.GetReturnValue().Set(StringViewToV8String(isolate, value, (DOMNode*)elem));
     } else {
         args.GetReturnValue().SetNull();
     }
 }
 
 void ElementWrapper::GetAttributeNS(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ElementWrapper::GetAttributeNS");
     v8::Isolate* isolate = args.GetIsolate();
-    DOMElement* elem = Unwrap(args.This());
+    DOMElement* elem = UnwrapReceiver<DOMElement>(args);
     if (!elem) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Element")));
         return;
     }
     
@@ -479,11 +514,10 @@ void ElementWrapper::GetAttributeNS(const v8::FunctionCallbackInfo<v8::Value>& a
 }
 
 void ElementWrapper::SetAttribute(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ElementWrapper::SetAttribute");
     v8::Isolate* isolate = args.GetIsolate();
-    DOMElement* elem = Unwrap(args.This());
+    DOMElement* elem = UnwrapReceiver<DOMElement>(args);
     if (!elem) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Element")));
         return;
     }
     
@@ -493,21 +527,86 @@ void ElementWrapper::SetAttribute(const v8::FunctionCallbackInfo<v8::Value>& arg
         return;
     }
     
-    CStringFromV8 qualifiedName(isolate, args[0]);
-    CStringFromV8 value(isolate, args[1]);
-    int32_t err = dom_element_setattribute(elem, qualifiedName.get(), value.get());
+    StringArgFromV8 qualifiedName(isolate, args[0]);
+    StringArgFromV8 value(isolate, args[1]);
+    int32_t err = dom_element_setattribute_n(elem, qualifiedName.data(), qualifiedName.length(),
+                                             value.data(), value.length());
+    V8_DOM_RECORD_CALL(kSetAttribute, TraceNode(elem), qualifiedName, value);
     
     if (err != 0) {
         ThrowDOMException(isolate, err);
     }
 }
 
-void ElementWrapper::SetAttributeNS(const v8::FunctionCallbackInfo<v8::Value>& args) {
+void ElementWrapper::SetAttributes(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ElementWrapper::SetAttributes");
     v8::Isolate* isolate = args.GetIsolate();
-    DOMElement* elem = Unwrap(args.This());
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    DOMElement* elem = UnwrapReceiver<DOMElement>(args);
     if (!elem) {
+        return;
+    }
+    
+    if (args.Length() < 1 || !args[0]->IsObject()) {
         isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Element")));
+            v8::String::NewFromUtf8Literal(isolate, "__setAttributes requires an object")));
+        return;
+    }
+    
+    v8::Local<v8::Object> object = args[0].As<v8::Object>();
+    v8::Local<v8::Array> keys;
+    if (!object->GetOwnPropertyNames(context).ToLocal(&keys)) {
+        return;
+    }
+    uint32_t count = keys->Length();
+    
+    // Names and values are written back to back into one buffer; entries
+    // [0, count) of the offset and length arrays are names, the rest values
+    std::string bytes;
+    std::vector<size_t> offsets(2 * count);
+    std::vector<size_t> lengths(2 * count);
+    for (uint32_t i = 0; i < count; i++) {
+        v8::Local<v8::Value> key;
+        v8::Local<v8::Value> value;
+        v8::Local<v8::String> name_str;
+        v8::Local<v8::String> value_str;
+        if (!keys->Get(context, i).ToLocal(&key) ||
+            !object->Get(context, key).ToLocal(&value) ||
+            !key->ToString(context).ToLocal(&name_str) ||
+            !value->ToString(context).ToLocal(&value_str)) {
+            return;
+        }
+        
+        v8::Local<v8::String> strings[2] = {name_str, value_str};
+        for (uint32_t j = 0; j < 2; j++) {
+            size_t slot = j * count + i;
+            size_t length = strings[j]->Utf8LengthV2(isolate);
+            offsets[slot] = bytes.size();
+            lengths[slot] = length;
+            bytes.resize(bytes.size() + length);
+            strings[j]->WriteUtf8V2(isolate, &bytes[offsets[slot]], length,
+                                    v8::String::WriteFlags::kReplaceInvalidUtf8);
+        }
+    }
+    
+    std::vector<const char*> pointers(2 * count);
+    for (size_t slot = 0; slot < pointers.size(); slot++) {
+        pointers[slot] = bytes.data() + offsets[slot];
+    }
+    
+    int32_t err = dom_element_setattributes(elem, pointers.data(), lengths.data(),
+                                            pointers.data() + count, lengths.data() + count,
+                                            count);
+    if (err != 0) {
+        ThrowDOMException(isolate, err);
+    }
+}
+
+void ElementWrapper::SetAttributeNS(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ElementWrapper::SetAttributeNS");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMElement* elem = UnwrapReceiver<DOMElement>(args);
+    if (!elem) {
         return;
     }
     
@@ -528,11 +627,10 @@ void ElementWrapper::SetAttributeNS(const v8::FunctionCallbackInfo<v8::Value>& a
 }
 
 void ElementWrapper::RemoveAttribute(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ElementWrapper::RemoveAttribute");
     v8::Isolate* isolate = args.GetIsolate();
-    DOMElement* elem = Unwrap(args.This());
+    DOMElement* elem = UnwrapReceiver<DOMElement>(args);
     if (!elem) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Element")));
         return;
     }
     
@@ -542,8 +640,9 @@ void ElementWrapper::RemoveAttribute(const v8::FunctionCallbackInfo<v8::Value>&
         return;
     }
     
-    CStringFromV8 qualifiedName(isolate, args[0]);
-    int32_t err = dom_element_removeattribute(elem, qualifiedName.get());
+    StringArgFromV8 qualifiedName(isolate, args[0]);
+    int32_t err = dom_element_removeattribute_n(elem, qualifiedName.data(), qualifiedName.length());
+    V8_DOM_RECORD_CALL(kRemoveAttribute, TraceNode(elem), qualifiedName);
     
     if (err != 0) {
         ThrowDOMException(isolate, err);
@@ -551,11 +650,10 @@ void ElementWrapper::RemoveAttribute(const v8::FunctionCallbackInfo<v8::Value>&
 }
 
 void ElementWrapper::RemoveAttributeNS(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ElementWrapper::RemoveAttributeNS");
     v8::Isolate* isolate = args.GetIsolate();
-    DOMElement* elem = Unwrap(args.This());
+    DOMElement* elem = UnwrapReceiver<DOMElement>(args);
     if (!elem) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Element")));
         return;
     }
     
@@ -575,11 +673,10 @@ void ElementWrapper::RemoveAttributeNS(const v8::FunctionCallbackInfo<v8::Value>
 }
 
 void ElementWrapper::ToggleAttribute(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ElementWrapper::ToggleAttribute");
     v8::Isolate* isolate = args.GetIsolate();
-    DOMElement* elem = Unwrap(args.This());
+    DOMElement* elem = UnwrapReceiver<DOMElement>(args);
     if (!elem) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Element")));
         return;
     }
     
@@ -593,15 +690,14 @@ void ElementWrapper::ToggleAttribute(const v8::FunctionCallbackInfo<v8::Value>&
     uint8_t force = args.Length() >= 2 ? args[1]->BooleanValue(isolate) : 2;  // 2 = not provided
     uint8_t result = dom_element_toggleattribute(elem, qualifiedName.get(), force);
     
-    args.GetReturnValue().Set(v8::Boolean::New(isolate, result != 0));
+    args.GetReturnValue().Set(result != 0);
 }
 
 void ElementWrapper::HasAttribute(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ElementWrapper::HasAttribute");
     v8::Isolate* isolate = args.GetIsolate();
-    DOMElement* elem = Unwrap(args.This());
+    DOMElement* elem = UnwrapReceiver<DOMElement>(args);
     if (!elem) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Element")));
         return;
     }
     
@@ -611,18 +707,31 @@ void ElementWrapper::HasAttribute(const v8::FunctionCallbackInfo<v8::Value>& arg
         return;
     }
     
-    CStringFromV8 qualifiedName(isolate, args[0]);
-    uint8_t result = dom_element_hasattribute(elem, qualifiedName.get());
+    StringArgFromV8 qualifiedName(isolate, args[0]);
+    uint8_t result = dom_element_hasattribute_n(elem, qualifiedName.data(), qualifiedName.length());
+    V8_DOM_RECORD_CALL(kHasAttribute, TraceNode(elem), qualifiedName);
+    
+    args.GetReturnValue().Set(result != 0);
+}
+
+const v8::CFunction ElementWrapper::kFastHasAttribute = v8::CFunction::Make(FastHasAttribute);
+
+bool ElementWrapper::FastHasAttribute(v8::Local<v8::Object> receiver,
+                                      const v8::FastOneByteString& qualified_name) {
+    DOMElement* elem = UnwrapReceiver<DOMElement>(receiver);
+    if (!elem) {
+        return false;
+    }
     
-    args.GetReturnValue().Set(v8::Boolean::New(isolate, result != 0));
+    CStringFromFastString name(qualified_name);
+    return dom_element_hasattribute_n(elem, name.get(), name.length()) != 0;
 }
 
 void ElementWrapper::HasAttributeNS(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ElementWrapper::HasAttributeNS");
     v8::Isolate* isolate = args.GetIsolate();
-    DOMElement* elem = Unwrap(args.This());
+    DOMElement* elem = UnwrapReceiver<DOMElement>(args);
     if (!elem) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Element")));
         return;
     }
     
@@ -636,42 +745,33 @@ void ElementWrapper::HasAttributeNS(const v8::FunctionCallbackInfo<v8::Value>& a
     CStringFromV8 localName(isolate, args[1]);
     uint8_t result = dom_element_hasattributens(elem, ns.get(), localName.get());
     
-    args.GetReturnValue().Set(v8::Boolean::New(isolate, result != 0));
+    args.GetReturnValue().Set(result != 0);
 }
 
 void ElementWrapper::HasAttributes(const v8::FunctionCallbackInfo<v8::Value>& args) {
-    v8::Isolate* isolate = args.GetIsolate();
-    DOMElement* elem = Unwrap(args.This());
+    V8_DOM_TRACE_SCOPE("ElementWrapper::HasAttributes");
+    DOMElement* elem = UnwrapReceiver<DOMElement>(args);
     if (!elem) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Element")));
         return;
     }
     
     uint8_t result = dom_element_hasattributes(elem);
-    args.GetReturnValue().Set(v8::Boolean::New(isolate, result != 0));
+    args.GetReturnValue().Set(result != 0);
 }
 
 void ElementWrapper::GetAttributeNames(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ElementWrapper::GetAttributeNames");
     v8::Isolate* isolate = args.GetIsolate();
-    v8::Local<v8::Context> context = isolate->GetCurrentContext();
-    DOMElement* elem = Unwrap(args.This());
+    DOMElement* elem = UnwrapReceiver<DOMElement>(args);
     if (!elem) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Element")));
         return;
     }
     
-    uint32_t count = 0;
-    const char** names = dom_element_getattributenames(elem, &count);
-    
-    v8::Local<v8::Array> array = v8::Array::New(isolate, count);
-    for (uint32_t i = 0; i < count; i++) {
-        array->Set(context, i, CStringToV8String(isolate, names[i])).Check();
-    }
-    
-    dom_element_free_attributenames(names, count);
-    args.GetReturnValue().Set(array);
+    // One pass over the attributes; the array is created from the names
+    // in one call instead of one Set() per element
+    AttributeNameCollector names(isolate, elem);
+    dom_element_foreach_attributename(elem, AttributeNameCollector::Add, &names);
+    args.GetReturnValue().Set(v8::Array::New(isolate, names.data(), names.size()));
 }
 
 // ============================================================================
@@ -679,11 +779,10 @@ void ElementWrapper::GetAttributeNames(const v8::FunctionCallbackInfo<v8::Value>
 // ============================================================================
 
 void ElementWrapper::Matches(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ElementWrapper::Matches");
     v8::Isolate* isolate = args.GetIsolate();
-    DOMElement* elem = Unwrap(args.This());
+    DOMElement* elem = UnwrapReceiver<DOMElement>(args);
     if (!elem) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Element")));
         return;
     }
     
@@ -693,19 +792,24 @@ void ElementWrapper::Matches(const v8::FunctionCallbackInfo<v8::Value>& args) {
         return;
     }
     
-    CStringFromV8 selectors(isolate, args[0]);
-    uint8_t result = dom_element_matches(elem, selectors.get());
+    uint8_t result;
+    if (DOMSelector* compiled = CompiledSelectorArg(isolate, elem, args[0])) {
+        result = dom_element_matches_compiled(elem, compiled);
+    } else {
+        StringArgFromV8 selectors(isolate, args[0]);
+        result = dom_element_matches_n(elem, selectors.data(), selectors.length());
+    }
+    V8_DOM_RECORD_CALL(kMatches, TraceNode(elem), StringArgFromV8(isolate, args[0]));
     
-    args.GetReturnValue().Set(v8::Boolean::New(isolate, result != 0));
+    args.GetReturnValue().Set(result != 0);
 }
 
 void ElementWrapper::Closest(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ElementWrapper::Closest");
     v8::Isolate* isolate = args.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
-    DOMElement* elem = Unwrap(args.This());
+    DOMElement* elem = UnwrapReceiver<DOMElement>(args);
     if (!elem) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Element")));
         return;
     }
     
@@ -715,8 +819,17 @@ void ElementWrapper::Closest(const v8::FunctionCallbackInfo<v8::Value>& args) {
         return;
     }
     
-    CStringFromV8 selectors(isolate, args[0]);
-    DOMElement* result = dom_element_closest(elem, selectors.get());
+    DOMElement* result;
+    if (DOMSelector* compiled = CompiledSelectorArg(isolate, elem, args[0])) {
+        // Delegated listeners of one dispatch mostly walk the same ancestors
+        DOMClosestMemo* memo = BindingState::ForIsolate(isolate)->DispatchClosestMemo();
+        result = memo ? dom_element_closest_memoized(elem, memo, compiled)
+                      : dom_element_closest_compiled(elem, compiled);
+    } else {
+        StringArgFromV8 selectors(isolate, args[0]);
+        result = dom_element_closest_n(elem, selectors.data(), selectors.length());
+    }
+    V8_DOM_RECORD_CALL(kClosest, TraceNode(elem), StringArgFromV8(isolate, args[0]), TraceResult(result));
     
     if (result) {
         args.GetReturnValue().Set(ElementWrapper::Wrap(isolate, context, result));
@@ -726,12 +839,11 @@ void ElementWrapper::Closest(const v8::FunctionCallbackInfo<v8::Value>& args) {
 }
 
 void ElementWrapper::QuerySelector(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ElementWrapper::QuerySelector");
     v8::Isolate* isolate = args.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
-    DOMElement* elem = Unwrap(args.This());
+    DOMElement* elem = UnwrapReceiver<DOMElement>(args);
     if (!elem) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Element")));
         return;
     }
     
@@ -741,8 +853,14 @@ void ElementWrapper::QuerySelector(const v8::FunctionCallbackInfo<v8::Value>& ar
         return;
     }
     
-    CStringFromV8 selectors(isolate, args[0]);
-    DOMElement* result = dom_element_queryselector(elem, selectors.get());
+    DOMElement* result;
+    if (DOMSelector* compiled = CompiledSelectorArg(isolate, elem, args[0])) {
+        result = dom_element_queryselector_compiled(elem, compiled);
+    } else {
+        StringArgFromV8 selectors(isolate, args[0]);
+        result = dom_element_queryselector_n(elem, selectors.data(), selectors.length());
+    }
+    V8_DOM_RECORD_CALL(kQuerySelector, TraceNode(elem), StringArgFromV8(isolate, args[0]), TraceResult(result));
     
     if (result) {
         args.GetReturnValue().Set(ElementWrapper::Wrap(isolate, context, result));
@@ -750,15 +868,13 @@ void ElementWrapper::QuerySelector(const v8::FunctionCallbackInfo<v8::Value>& ar
         args.GetReturnValue().SetNull();
     }
 }
-#if 0 // TODO: Enable when dom_element_queryselectorall is implemented
 
 void ElementWrapper::QuerySelectorAll(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ElementWrapper::QuerySelectorAll");
     v8::Isolate* isolate = args.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
-    DOMElement* elem = Unwrap(args.This());
+    DOMElement* elem = UnwrapReceiver<DOMElement>(args);
     if (!elem) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Element")));
         return;
     }
     
@@ -768,24 +884,21 @@ void ElementWrapper::QuerySelectorAll(const v8::FunctionCallbackInfo<v8::Value>&
         return;
     }
     
-    CStringFromV8 selectors(isolate, args[0]);
-    DOMNodeList* result = dom_element_queryselectorall(elem, selectors.get());
+    StringArgFromV8 selectors(isolate, args[0]);
+    DOMNodeList* result = dom_element_queryselectorall_n(elem, selectors.data(), selectors.length());
+    V8_DOM_RECORD_CALL(kQuerySelectorAll, TraceNode(elem), selectors,
+                       result ? dom_nodelist_static_get_length(result) : 0u);
     
-    if (result) {
-        args.GetReturnValue().Set(NodeListWrapper::Wrap(isolate, context, result));
-    } else {
-        args.GetReturnValue().SetNull();
-    }
-    }
-#endif
+    // No matches wraps as an empty NodeList
+    args.GetReturnValue().Set(NodeListWrapper::Wrap(isolate, context, result));
+}
 
 
 void ElementWrapper::WebkitMatchesSelector(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ElementWrapper::WebkitMatchesSelector");
     v8::Isolate* isolate = args.GetIsolate();
-    DOMElement* elem = Unwrap(args.This());
+    DOMElement* elem = UnwrapReceiver<DOMElement>(args);
     if (!elem) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Element")));
         return;
     }
     
@@ -795,23 +908,30 @@ void ElementWrapper::WebkitMatchesSelector(const v8::FunctionCallbackInfo<v8::Va
         return;
     }
     
-    CStringFromV8 selectors(isolate, args[0]);
-    uint8_t result = dom_element_webkitmatchesselector(elem, selectors.get());
+    // Alias of matches(); shares its compiled selectors
+    uint8_t result;
+    if (DOMSelector* compiled = CompiledSelectorArg(isolate, elem, args[0])) {
+        result = dom_element_matches_compiled(elem, compiled);
+    } else {
+        StringArgFromV8 selectors(isolate, args[0]);
+        result = dom_element_matches_n(elem, selectors.data(), selectors.length());
+    }
+    V8_DOM_RECORD_CALL(kMatches, TraceNode(elem), StringArgFromV8(isolate, args[0]));
     
-    args.GetReturnValue().Set(v8::Boolean::New(isolate, result != 0));
+    args.GetReturnValue().Set(result != 0);
 }
 
+#if V8_DOM_ENABLE_SHADOW
 // ============================================================================
 // Method Implementations - Shadow DOM
 // ============================================================================
 
 void ElementWrapper::AttachShadow(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ElementWrapper::AttachShadow");
     v8::Isolate* isolate = args.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
-    DOMElement* elem = Unwrap(args.This());
+    DOMElement* elem = UnwrapReceiver<DOMElement>(args);
     if (!elem) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Element")));
         return;
     }
     
@@ -848,18 +968,18 @@ void ElementWrapper::AttachShadow(const v8::FunctionCallbackInfo<v8::Value>& arg
             v8::String::NewFromUtf8Literal(isolate, "Failed to attach shadow root")));
     }
 }
+#endif // V8_DOM_ENABLE_SHADOW
 
 // ============================================================================
 // Method Implementations - Adjacent Insertion
 // ============================================================================
 
 void ElementWrapper::InsertAdjacentElement(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ElementWrapper::InsertAdjacentElement");
     v8::Isolate* isolate = args.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
-    DOMElement* elem = Unwrap(args.This());
+    DOMElement* elem = UnwrapReceiver<DOMElement>(args);
     if (!elem) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Element")));
         return;
     }
     
@@ -894,11 +1014,10 @@ void ElementWrapper::InsertAdjacentElement(const v8::FunctionCallbackInfo<v8::Va
 }
 
 void ElementWrapper::InsertAdjacentText(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ElementWrapper::InsertAdjacentText");
     v8::Isolate* isolate = args.GetIsolate();
-    DOMElement* elem = Unwrap(args.This());
+    DOMElement* elem = UnwrapReceiver<DOMElement>(args);
     if (!elem) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Element")));
         return;
     }
     
@@ -918,4 +1037,66 @@ void ElementWrapper::InsertAdjacentText(const v8::FunctionCallbackInfo<v8::Value
     }
 }
 
+void ElementWrapper::InsertAdjacentMarkup(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ElementWrapper::InsertAdjacentMarkup");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMElement* elem = UnwrapReceiver<DOMElement>(args);
+    if (!elem) {
+        return;
+    }
+    
+    if (args.Length() < 2) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "__insertAdjacentMarkup requires 2 arguments")));
+        return;
+    }
+    
+    CStringFromV8 where(isolate, args[0]);
+    if (!where.get()) {
+        return;  // Exception pending
+    }
+    v8::Local<v8::String> str;
+    if (!args[1]->ToString(isolate->GetCurrentContext()).ToLocal(&str)) {
+        return;  // Exception pending
+    }
+    StringArgFromV8 markup(isolate, str);
+    
+    // One crossing for the whole markup: parsed and inserted on the Zig side
+    int32_t err = dom_element_insertadjacentmarkup(
+        elem, where.get(), reinterpret_cast<const uint8_t*>(markup.data()), markup.length());
+    if (err != 0) {
+        ThrowDOMException(isolate, err);
+    }
+}
+
+void ElementWrapper::SetInnerMarkup(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ElementWrapper::SetInnerMarkup");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMElement* elem = UnwrapReceiver<DOMElement>(args);
+    if (!elem) {
+        return;
+    }
+    
+    // null and undefined clear the children, like the innerHTML setter's
+    // [LegacyNullToEmptyString]
+    if (args.Length() < 1 || IsNullOrUndefined(args[0])) {
+        int32_t err = dom_element_setinnermarkup(elem, nullptr, 0);
+        if (err != 0) {
+            ThrowDOMException(isolate, err);
+        }
+        return;
+    }
+    
+    v8::Local<v8::String> str;
+    if (!args[0]->ToString(isolate->GetCurrentContext()).ToLocal(&str)) {
+        return;  // Exception pending
+    }
+    StringArgFromV8 markup(isolate, str);
+    int32_t err = dom_element_setinnermarkup(
+        elem, reinterpret_cast<const uint8_t*>(markup.data()), markup.length());
+    if (err != 0) {
+        ThrowDOMException(isolate, err);
+    }
+}
+
 } // namespace v8_dom
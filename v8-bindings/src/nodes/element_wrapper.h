@@ -9,6 +9,10 @@
 #define V8_DOM_ELEMENT_WRAPPER_H
 
 #include <v8.h>
+#include "../core/wrapper_traits.h"
+#include "../core/external_references.h"
+#include "../core/property_table.h"
+#include "../core/features.h"
 #include "node_wrapper.h"
 #include "dom.h"
 
@@ -42,13 +46,21 @@ public:
     /**
      * Template cache index.
      */
-    static constexpr int kTemplateIndex = 2;
+    static constexpr int kTemplateIndex = WrapperTraits<ElementWrapper>::kTemplateIndex;
+    
+    /**
+     * Type tag stored in the wrapper's type internal field.
+     */
+    static const WrapperTypeInfo kTypeInfo;
+    
+    /**
+     * Register this wrapper's callbacks for snapshot serialization.
+     */
+    static void RegisterExternalReferences(ExternalReferenceRegistry* registry);
     
 private:
-    // Property interceptor to prevent shadowing
-    static v8::Intercepted NamedPropertySetter(v8::Local<v8::Name> property,
-                                               v8::Local<v8::Value> value,
-                                               const v8::PropertyCallbackInfo<void>& info);
+    // Prototype members, installed by InstallTemplate()
+    static const PropertyDescriptor kProperties[];
     
     // Readonly properties
     static void TagNameGetter(v8::Local<v8::Name> property,
@@ -61,37 +73,36 @@ private:
                                const v8::PropertyCallbackInfo<v8::Value>& info);
     static void ClassListGetter(v8::Local<v8::Name> property,
                                const v8::PropertyCallbackInfo<v8::Value>& info);
+    static void DatasetGetter(v8::Local<v8::Name> property,
+                             const v8::PropertyCallbackInfo<v8::Value>& info);
+#if V8_DOM_ENABLE_SHADOW
     static void ShadowRootGetter(v8::Local<v8::Name> property,
                                 const v8::PropertyCallbackInfo<v8::Value>& info);
     static void AssignedSlotGetter(v8::Local<v8::Name> property,
                                   const v8::PropertyCallbackInfo<v8::Value>& info);
+#endif
     
-    // Read/write properties
-    static void IdGetter(v8::Local<v8::Name> property,
-                        const v8::PropertyCallbackInfo<v8::Value>& info);
-    static void IdSetter(v8::Local<v8::Name> property,
-                        v8::Local<v8::Value> value,
-                        const v8::PropertyCallbackInfo<void>& info);
-    static void ClassNameGetter(v8::Local<v8::Name> property,
-                               const v8::PropertyCallbackInfo<v8::Value>& info);
-    static void ClassNameSetter(v8::Local<v8::Name> property,
-                               v8::Local<v8::Value> value,
-                               const v8::PropertyCallbackInfo<void>& info);
-    static void SlotGetter(v8::Local<v8::Name> property,
-                          const v8::PropertyCallbackInfo<v8::Value>& info);
-    static void SlotSetter(v8::Local<v8::Name> property,
-                          v8::Local<v8::Value> value,
-                          const v8::PropertyCallbackInfo<void>& info);
+    // Read/write properties (accessor properties, see InstallTemplate)
+    static void IdGetter(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void IdSetter(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void ClassNameGetter(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void ClassNameSetter(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void SlotGetter(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void SlotSetter(const v8::FunctionCallbackInfo<v8::Value>& args);
     
     // Methods - Attributes
     static void GetAttribute(const v8::FunctionCallbackInfo<v8::Value>& args);
     static void GetAttributeNS(const v8::FunctionCallbackInfo<v8::Value>& args);
     static void SetAttribute(const v8::FunctionCallbackInfo<v8::Value>& args);
     static void SetAttributeNS(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void SetAttributes(const v8::FunctionCallbackInfo<v8::Value>& args);
     static void RemoveAttribute(const v8::FunctionCallbackInfo<v8::Value>& args);
     static void RemoveAttributeNS(const v8::FunctionCallbackInfo<v8::Value>& args);
     static void ToggleAttribute(const v8::FunctionCallbackInfo<v8::Value>& args);
     static void HasAttribute(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static bool FastHasAttribute(v8::Local<v8::Object> receiver,
+                                 const v8::FastOneByteString& qualified_name);
+    static const v8::CFunction kFastHasAttribute;
     static void HasAttributeNS(const v8::FunctionCallbackInfo<v8::Value>& args);
     static void HasAttributes(const v8::FunctionCallbackInfo<v8::Value>& args);
     static void GetAttributeNames(const v8::FunctionCallbackInfo<v8::Value>& args);
@@ -103,12 +114,16 @@ private:
     static void QuerySelectorAll(const v8::FunctionCallbackInfo<v8::Value>& args);
     static void WebkitMatchesSelector(const v8::FunctionCallbackInfo<v8::Value>& args);
     
+#if V8_DOM_ENABLE_SHADOW
     // Methods - Shadow DOM
     static void AttachShadow(const v8::FunctionCallbackInfo<v8::Value>& args);
+#endif
     
     // Methods - Adjacent insertion
     static void InsertAdjacentElement(const v8::FunctionCallbackInfo<v8::Value>& args);
     static void InsertAdjacentText(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void InsertAdjacentMarkup(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void SetInnerMarkup(const v8::FunctionCallbackInfo<v8::Value>& args);
 };
 
 } // namespace v8_dom
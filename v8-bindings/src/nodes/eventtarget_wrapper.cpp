@@ -1,72 +1,161 @@
 #include "eventtarget_wrapper.h"
+#include "node_wrapper.h"
+#include "../events/event_wrapper.h"
 #include "../wrapper_cache.h"
 #include "../core/template_cache.h"
 #include "../core/utilities.h"
+#include "../core/binding_state.h"
 
 namespace v8_dom {
 
+const WrapperTypeInfo EventTargetWrapper::kTypeInfo = {"EventTarget", nullptr};
+
+namespace {
+
+/**
+ * One script listener, the user_data of its C-ABI registration.
+ * Deleted by ReleaseScriptListener when the DOM drops the listener.
+ */
+struct ScriptListener {
+    v8::Isolate* isolate;
+    v8::Global<v8::Object> callback;  // function, or object with handleEvent
+};
+
+void ReleaseScriptListener(void* user_data) {
+    delete static_cast<ScriptListener*>(user_data);
+}
+
+/**
+ * Match a registration against a v8::Local<v8::Object>* key (its callback).
+ */
+uint8_t MatchScriptListener(void* user_data, void* key) {
+    ScriptListener* listener = static_cast<ScriptListener*>(user_data);
+    const v8::Local<v8::Object>& callback = *static_cast<v8::Local<v8::Object>*>(key);
+    return listener->callback == callback ? 1 : 0;
+}
+
+/**
+ * Trampoline shared by every script listener ("inner invoke" of the spec).
+ */
+void InvokeScriptListener(DOMEvent* event, void* user_data) {
+    ScriptListener* listener = static_cast<ScriptListener*>(user_data);
+    v8::Isolate* isolate = listener->isolate;
+    v8::HandleScope handle_scope(isolate);
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+
+    // Take a local handle first: the listener may remove itself (which
+    // deletes *listener) while it runs
+    v8::Local<v8::Object> callback = listener->callback.Get(isolate);
+
+    // Exceptions are reported, not propagated to dispatchEvent()
+    v8::TryCatch try_catch(isolate);
+    try_catch.SetVerbose(true);
+
+    v8::Local<v8::Function> function;
+    v8::Local<v8::Value> receiver;
+    if (callback->IsFunction()) {
+        function = callback.As<v8::Function>();
+        DOMEventTarget* current_target = dom_event_get_currenttarget(event);
+        receiver = current_target
+            ? v8::Local<v8::Value>(EventTargetWrapper::Wrap(isolate, context, current_target))
+            : v8::Local<v8::Value>(v8::Undefined(isolate));
+    } else {
+        // Callback interface: look handleEvent up on every invocation
+        v8::Local<v8::Value> handle_event;
+        if (!callback->Get(context, v8::String::NewFromUtf8Literal(isolate, "handleEvent"))
+                 .ToLocal(&handle_event)) {
+            return;
+        }
+        if (!handle_event->IsFunction()) {
+            isolate->ThrowException(v8::Exception::TypeError(
+                v8::String::NewFromUtf8Literal(isolate, "handleEvent is not a function")));
+            return;
+        }
+        function = handle_event.As<v8::Function>();
+        receiver = callback;
+    }
+
+    v8::Local<v8::Value> argv[1] = {EventWrapper::Wrap(isolate, context, event)};
+
+    // closest() calls of the dispatch's listeners share one memo
+    BindingState* state = BindingState::ForIsolate(isolate);
+    state->EnterListener(event);
+    (void)function->Call(context, receiver, 1, argv);
+    state->ExitListener();
+}
+
+/**
+ * Flags from an (AddEventListenerOptions or boolean) argument.
+ */
+struct ListenerOptions {
+    bool capture = false;
+    bool once = false;
+    bool passive = false;
+};
+
+/**
+ * Read options; with full == false only capture (EventListenerOptions).
+ * Returns false if reading an options property threw.
+ */
+bool ReadListenerOptions(v8::Isolate* isolate, v8::Local<v8::Context> context,
+                         v8::Local<v8::Value> value, bool full,
+                         ListenerOptions* options) {
+    if (value.IsEmpty() || !value->IsObject()) {
+        options->capture = !value.IsEmpty() && value->BooleanValue(isolate);
+        return true;
+    }
+
+    v8::Local<v8::Object> dict = value.As<v8::Object>();
+    v8::Local<v8::Value> flag;
+    if (!dict->Get(context, v8::String::NewFromUtf8Literal(isolate, "capture")).ToLocal(&flag)) {
+        return false;
+    }
+    options->capture = flag->BooleanValue(isolate);
+    if (!full) {
+        return true;
+    }
+
+    if (!dict->Get(context, v8::String::NewFromUtf8Literal(isolate, "once")).ToLocal(&flag)) {
+        return false;
+    }
+    options->once = flag->BooleanValue(isolate);
+    if (!dict->Get(context, v8::String::NewFromUtf8Literal(isolate, "passive")).ToLocal(&flag)) {
+        return false;
+    }
+    options->passive = flag->BooleanValue(isolate);
+    return true;
+}
+
+} // namespace
+
 v8::Local<v8::Object> EventTargetWrapper::Wrap(v8::Isolate* isolate,
                                               v8::Local<v8::Context> context,
                                               DOMEventTarget* obj) {
     if (!obj) {
         return v8::Local<v8::Object>();
     }
-    
-    // Check wrapper cache first
-    WrapperCache* cache = WrapperCache::ForIsolate(isolate);
-    if (cache->Has(obj)) {
-        return cache->Get(isolate, obj);
-    }
-    
-    // Create new wrapper
-    v8::EscapableHandleScope handle_scope(isolate);
-    v8::Local<v8::FunctionTemplate> tmpl = GetTemplate(isolate);
-    v8::Local<v8::Function> constructor = tmpl->GetFunction(context).ToLocalChecked();
-    v8::Local<v8::Object> wrapper = constructor->NewInstance(context).ToLocalChecked();
-    
-    // Store C pointer in internal field
-    wrapper->SetInternalField(0, v8::External::New(isolate, obj));
-    
-    // Increment C-side reference count
-    dom_eventtarget_addref(obj);
-    
-    // Cache with release callback
-    cache->Set(isolate, obj, wrapper, [](void* ptr) {
-        dom_eventtarget_release(static_cast<DOMEventTarget*>(ptr));
-    });
-    
-    return handle_scope.Escape(wrapper);
+
+    // The C-ABI treats every DOMEventTarget as a node
+    return NodeWrapper::Wrap(isolate, context, reinterpret_cast<DOMNode*>(obj));
 }
 
 DOMEventTarget* EventTargetWrapper::Unwrap(v8::Local<v8::Object> obj) {
-    if (obj.IsEmpty() || obj->InternalFieldCount() < 1) {
-        return nullptr;
-    }
-    
-    v8::Local<v8::Value> ptr = obj->GetInternalField(0).As<v8::Value>();
-    if (!ptr->IsExternal()) {
-        return nullptr;
-    }
-    
-    return static_cast<DOMEventTarget*>(v8::Local<v8::External>::Cast(ptr)->Value());
+    return static_cast<DOMEventTarget*>(UnwrapObject(obj, &kTypeInfo));
 }
 
+const PropertyDescriptor EventTargetWrapper::kProperties[] = {
+    MethodProperty("addEventListener", AddEventListener),
+    MethodProperty("removeEventListener", RemoveEventListener),
+    MethodProperty("dispatchEvent", DispatchEvent),
+};
+
 void EventTargetWrapper::InstallTemplate(v8::Isolate* isolate) {
     v8::Local<v8::FunctionTemplate> tmpl = v8::FunctionTemplate::New(isolate);
     tmpl->SetClassName(v8::String::NewFromUtf8Literal(isolate, "EventTarget"));
-    tmpl->InstanceTemplate()->SetInternalFieldCount(1);
-    
-
-    // Get prototype template for adding properties/methods
-    v8::Local<v8::ObjectTemplate> proto = tmpl->PrototypeTemplate();
-    
-    // TODO: Add properties and methods here
-    // Example:
-    // proto->SetNativeDataProperty(v8::String::NewFromUtf8Literal(isolate, "propertyName"),
-    //                   PropertyNameGetter, PropertyNameSetter);
-    // proto->Set(v8::String::NewFromUtf8Literal(isolate, "methodName"),
-    //           v8::FunctionTemplate::New(isolate, MethodName));
-    
+    tmpl->InstanceTemplate()->SetInternalFieldCount(kWrapperFieldCount);
+
+    InstallProperties(isolate, tmpl, kProperties);
+
     // Cache the template
     TemplateCache* cache = TemplateCache::ForIsolate(isolate);
     cache->Set(kTemplateIndex, tmpl);
@@ -74,12 +163,132 @@ void EventTargetWrapper::InstallTemplate(v8::Isolate* isolate) {
 
 v8::Local<v8::FunctionTemplate> EventTargetWrapper::GetTemplate(v8::Isolate* isolate) {
     TemplateCache* cache = TemplateCache::ForIsolate(isolate);
-    
+
     if (!cache->Has(kTemplateIndex)) {
         InstallTemplate(isolate);
     }
-    
+
     return cache->Get(kTemplateIndex);
 }
 
+void EventTargetWrapper::RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+    RegisterProperties(registry, kProperties);
+}
+
+// ===== Methods =====
+
+void EventTargetWrapper::AddEventListener(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("EventTargetWrapper::AddEventListener");
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    DOMEventTarget* target = UnwrapReceiver<DOMEventTarget>(args);
+    if (!target) {
+        return;
+    }
+
+    if (args.Length() < 2) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "addEventListener requires 2 arguments")));
+        return;
+    }
+
+    // A null callback adds nothing
+    if (IsNullOrUndefined(args[1])) {
+        return;
+    }
+    if (!args[1]->IsObject()) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "The callback provided as parameter 2 is not an object")));
+        return;
+    }
+    v8::Local<v8::Object> callback = args[1].As<v8::Object>();
+
+    ListenerOptions options;
+    if (!ReadListenerOptions(isolate, context, args[2], true, &options)) {
+        return;
+    }
+
+    StringArgFromV8 type(isolate, args[0]);
+
+    // Same callback and capture already registered: nothing to add
+    if (dom_eventtarget_findeventlistener(target, type.data(), InvokeScriptListener,
+                                          options.capture, MatchScriptListener, &callback)) {
+        return;
+    }
+
+    ScriptListener* listener = new ScriptListener{isolate, v8::Global<v8::Object>(isolate, callback)};
+    int err = dom_eventtarget_addeventlistener_owned(target, type.data(), InvokeScriptListener,
+                                                     listener, options.capture, options.once,
+                                                     options.passive, ReleaseScriptListener);
+    if (err != 0) {
+        delete listener;
+        ThrowDOMException(isolate, err);
+    }
+}
+
+void EventTargetWrapper::RemoveEventListener(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("EventTargetWrapper::RemoveEventListener");
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    DOMEventTarget* target = UnwrapReceiver<DOMEventTarget>(args);
+    if (!target) {
+        return;
+    }
+
+    if (args.Length() < 2) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "removeEventListener requires 2 arguments")));
+        return;
+    }
+
+    if (!args[1]->IsObject()) {
+        return;
+    }
+    v8::Local<v8::Object> callback = args[1].As<v8::Object>();
+
+    ListenerOptions options;
+    if (!ReadListenerOptions(isolate, context, args[2], false, &options)) {
+        return;
+    }
+
+    StringArgFromV8 type(isolate, args[0]);
+    void* listener = dom_eventtarget_findeventlistener(target, type.data(), InvokeScriptListener,
+                                                       options.capture, MatchScriptListener, &callback);
+    if (listener) {
+        dom_eventtarget_removeeventlistener(target, type.data(), InvokeScriptListener,
+                                            listener, options.capture);
+    }
+}
+
+void EventTargetWrapper::DispatchEvent(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("EventTargetWrapper::DispatchEvent");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMEventTarget* target = UnwrapReceiver<DOMEventTarget>(args);
+    if (!target) {
+        return;
+    }
+
+    v8::Local<v8::Object> event_wrapper;
+    DOMEvent* event = nullptr;
+    if (args.Length() > 0 && args[0]->IsObject()) {
+        event_wrapper = args[0].As<v8::Object>();
+        event = EventWrapper::Unwrap(event_wrapper);
+    }
+    if (!event) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "parameter 1 is not of type 'Event'")));
+        return;
+    }
+
+    // An event already being dispatched has a phase
+    if (dom_event_get_eventphase(event) != 0) {
+        ThrowDOMException(isolate, DOM_ERROR_INVALID_STATE);
+        return;
+    }
+
+    uint8_t not_canceled = dom_eventtarget_dispatchevent(target, event);
+    EventWrapper::ClearComposedPath(isolate, isolate->GetCurrentContext(), event_wrapper);
+    args.GetReturnValue().Set(not_canceled != 0);
+}
+
 } // namespace v8_dom
@@ -1,14 +1,25 @@
 /**
  * EventTarget Wrapper - V8 bindings for EventTarget
  * 
- * Auto-generated wrapper for DOMEventTarget.
- * Provides JavaScript interface for EventTarget operations.
+ * addEventListener(), removeEventListener() and dispatchEvent() are native.
+ * A script listener is registered through the C-ABI with one shared
+ * trampoline and a small ScriptListener holding a persistent handle to the
+ * callback, so it lives in the target's RareData next to the Zig listeners
+ * and is freed by the DOM when it is removed or the target is destroyed.
+ * 
+ * Dispatch runs entirely in the Zig core: the propagation path is built in
+ * the document's recycled path buffer, and the trampoline invokes each
+ * callback with a stack argv, so a dispatch allocates no std::vector and
+ * no JS array.
  */
 
 #ifndef V8_DOM_EVENTTARGET_WRAPPER_H
 #define V8_DOM_EVENTTARGET_WRAPPER_H
 
 #include <v8.h>
+#include "../core/wrapper_traits.h"
+#include "../core/external_references.h"
+#include "../core/property_table.h"
 #include "dom.h"
 
 namespace v8_dom {
@@ -17,7 +28,8 @@ class EventTargetWrapper {
 public:
     /**
      * Wrap a C DOMEventTarget pointer in a V8 object.
-     * Uses wrapper cache for identity preservation.
+     * Every event target the C-ABI hands out is a node, so this returns
+     * the node's (cached, most-derived) wrapper.
      */
     static v8::Local<v8::Object> Wrap(v8::Isolate* isolate,
                                       v8::Local<v8::Context> context,
@@ -41,11 +53,26 @@ public:
     /**
      * Template cache index.
      */
-    static constexpr int kTemplateIndex = 0;
+    static constexpr int kTemplateIndex = WrapperTraits<EventTargetWrapper>::kTemplateIndex;
+    
+    /**
+     * Type tag stored in the wrapper's type internal field.
+     */
+    static const WrapperTypeInfo kTypeInfo;
+    
+    /**
+     * Register this wrapper's callbacks for snapshot serialization.
+     */
+    static void RegisterExternalReferences(ExternalReferenceRegistry* registry);
     
 private:
-    // Property getters/setters and methods will be added here
-    // TODO: Parse dom.h to auto-generate these declarations
+    // Prototype members, installed by InstallTemplate()
+    static const PropertyDescriptor kProperties[];
+    
+    // Methods
+    static void AddEventListener(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void RemoveEventListener(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void DispatchEvent(const v8::FunctionCallbackInfo<v8::Value>& args);
 };
 
 } // namespace v8_dom
@@ -0,0 +1,210 @@
+#include "node_mixins.h"
+#include <vector>
+#include "node_wrapper.h"
+#include "../core/features.h"
+#include "../core/utilities.h"
+#if V8_DOM_ENABLE_TRAVERSAL
+#include "../traversal/elementiterator_wrapper.h"
+#endif
+
+namespace v8_dom {
+
+namespace {
+
+/**
+ * The (Node or DOMString)... arguments of one call, as C-ABI nodes.
+ *
+ * Up to kInlineCapacity nodes are kept on the stack. Strings become Text
+ * nodes owned by this object until they are inserted; any not inserted
+ * (the call failed) are released with it.
+ */
+class NodeArgs {
+public:
+    NodeArgs() = default;
+    NodeArgs(const NodeArgs&) = delete;
+    NodeArgs& operator=(const NodeArgs&) = delete;
+
+    ~NodeArgs() {
+        for (DOMNode* text : texts_) {
+            if (!dom_node_get_parentnode(text)) {
+                dom_node_release(text);
+            }
+        }
+    }
+
+    /**
+     * Convert the arguments; Text nodes are created in node's document.
+     *
+     * @return false if an exception was thrown
+     */
+    bool Init(const v8::FunctionCallbackInfo<v8::Value>& args, DOMNode* node) {
+        v8::Isolate* isolate = args.GetIsolate();
+        v8::Local<v8::Context> context = isolate->GetCurrentContext();
+
+        int length = args.Length();
+        if (length > kInlineCapacity) {
+            heap_.reserve(length);
+        }
+
+        DOMDocument* doc = nullptr;
+        for (int i = 0; i < length; i++) {
+            if (args[i]->IsObject()) {
+                DOMNode* arg = NodeWrapper::Unwrap(args[i].As<v8::Object>());
+                if (arg) {
+                    Push(arg);
+                    continue;
+                }
+            }
+
+            v8::Local<v8::String> str;
+            if (!args[i]->ToString(context).ToLocal(&str)) {
+                return false;
+            }
+            if (!doc) {
+                doc = dom_node_get_nodetype(node) == DOM_DOCUMENT_NODE
+                    ? reinterpret_cast<DOMDocument*>(node)
+                    : dom_node_get_ownerdocument(node);
+            }
+            StringArgFromV8 data(isolate, str);
+            DOMNode* text = reinterpret_cast<DOMNode*>(
+                dom_document_createtextnode_n(doc, data.data(), data.length()));
+            texts_.push_back(text);
+            Push(text);
+        }
+        return true;
+    }
+
+    DOMNode** data() { return heap_.empty() ? inline_ : heap_.data(); }
+    uint32_t size() const { return size_; }
+
+private:
+    static constexpr int kInlineCapacity = 8;
+
+    void Push(DOMNode* node) {
+        if (size_ < kInlineCapacity && heap_.empty()) {
+            inline_[size_++] = node;
+            return;
+        }
+        if (heap_.empty()) {
+            heap_.assign(inline_, inline_ + size_);
+        }
+        heap_.push_back(node);
+        size_++;
+    }
+
+    DOMNode* inline_[kInlineCapacity];
+    std::vector<DOMNode*> heap_;
+    std::vector<DOMNode*> texts_;
+    uint32_t size_ = 0;
+};
+
+using NodesOperation = int32_t (*)(DOMNode*, DOMNode**, uint32_t);
+
+/**
+ * Run one variadic mixin method as a single C-ABI call.
+ */
+void CallWithNodes(const v8::FunctionCallbackInfo<v8::Value>& args, NodesOperation operation) {
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMNode* node = UnwrapReceiver<DOMNode>(args);
+    if (!node) {
+        return;
+    }
+
+    NodeArgs nodes;
+    if (!nodes.Init(args, node)) return;
+
+    int32_t err = operation(node, nodes.data(), nodes.size());
+    if (err != 0) {
+        ThrowDOMException(isolate, err);
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// ParentNode
+// ============================================================================
+
+const PropertyDescriptor ParentNodeMixin::kProperties[] = {
+    MethodProperty("prepend", Prepend, kReceiverCheck),
+    MethodProperty("append", Append, kReceiverCheck),
+    MethodProperty("replaceChildren", ReplaceChildren, kReceiverCheck),
+
+#if V8_DOM_ENABLE_TRAVERSAL
+    // Non-standard
+    MethodProperty("elements", ElementIteratorWrapper::Elements, kReceiverCheck | kDontEnum),
+#endif
+};
+
+void ParentNodeMixin::Install(v8::Isolate* isolate,
+                              v8::Local<v8::ObjectTemplate> proto,
+                              v8::Local<v8::Signature> signature) {
+    InstallProperties(isolate, proto, signature, kProperties);
+}
+
+void ParentNodeMixin::RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+    RegisterProperties(registry, kProperties);
+}
+
+void ParentNodeMixin::Prepend(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ParentNodeMixin::Prepend");
+    CallWithNodes(args, dom_parentnode_prepend);
+}
+
+void ParentNodeMixin::Append(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ParentNodeMixin::Append");
+    CallWithNodes(args, dom_parentnode_append);
+}
+
+void ParentNodeMixin::ReplaceChildren(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ParentNodeMixin::ReplaceChildren");
+    CallWithNodes(args, dom_parentnode_replacechildren);
+}
+
+// ============================================================================
+// ChildNode
+// ============================================================================
+
+const PropertyDescriptor ChildNodeMixin::kProperties[] = {
+    MethodProperty("before", Before, kReceiverCheck),
+    MethodProperty("after", After, kReceiverCheck),
+    MethodProperty("replaceWith", ReplaceWith, kReceiverCheck),
+    MethodProperty("remove", Remove, kReceiverCheck),
+};
+
+void ChildNodeMixin::Install(v8::Isolate* isolate,
+                             v8::Local<v8::ObjectTemplate> proto,
+                             v8::Local<v8::Signature> signature) {
+    InstallProperties(isolate, proto, signature, kProperties);
+}
+
+void ChildNodeMixin::RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+    RegisterProperties(registry, kProperties);
+}
+
+void ChildNodeMixin::Before(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ChildNodeMixin::Before");
+    CallWithNodes(args, dom_childnode_before);
+}
+
+void ChildNodeMixin::After(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ChildNodeMixin::After");
+    CallWithNodes(args, dom_childnode_after);
+}
+
+void ChildNodeMixin::ReplaceWith(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ChildNodeMixin::ReplaceWith");
+    CallWithNodes(args, dom_childnode_replacewith);
+}
+
+void ChildNodeMixin::Remove(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ChildNodeMixin::Remove");
+    DOMNode* node = UnwrapReceiver<DOMNode>(args);
+    if (!node) {
+        return;
+    }
+
+    dom_childnode_remove(node);
+}
+
+} // namespace v8_dom
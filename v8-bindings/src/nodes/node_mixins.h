@@ -0,0 +1,76 @@
+/**
+ * Node Mixins - V8 bindings for the ParentNode and ChildNode mixins
+ *
+ * prepend / append / replaceChildren (ParentNode) and before / after /
+ * replaceWith / remove (ChildNode) take variadic (Node or DOMString)
+ * arguments. The arguments are unwrapped into an inline array (strings
+ * become Text nodes) and handed to the array-based C-ABI in one call, which
+ * converts them into a single node first: a batch of any size is one
+ * insertion, so observers get one mutation record and live ranges one
+ * update per call instead of one per node.
+ *
+ * Installed on the Element, Document, DocumentFragment, CharacterData and
+ * DocumentType prototypes.
+ *
+ * ParentNode also carries the non-standard elements() (see
+ * elementiterator_wrapper.h).
+ */
+
+#ifndef V8_DOM_NODE_MIXINS_H
+#define V8_DOM_NODE_MIXINS_H
+
+#include <v8.h>
+#include "../core/external_references.h"
+#include "../core/property_table.h"
+#include "dom.h"
+
+namespace v8_dom {
+
+class ParentNodeMixin {
+public:
+    /**
+     * Install prepend, append, replaceChildren and elements on a prototype.
+     */
+    static void Install(v8::Isolate* isolate,
+                        v8::Local<v8::ObjectTemplate> proto,
+                        v8::Local<v8::Signature> signature);
+
+    /**
+     * Register this mixin's callbacks for snapshot serialization.
+     */
+    static void RegisterExternalReferences(ExternalReferenceRegistry* registry);
+
+private:
+    static const PropertyDescriptor kProperties[];
+    
+    static void Prepend(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void Append(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void ReplaceChildren(const v8::FunctionCallbackInfo<v8::Value>& args);
+};
+
+class ChildNodeMixin {
+public:
+    /**
+     * Install before, after, replaceWith and remove on a prototype.
+     */
+    static void Install(v8::Isolate* isolate,
+                        v8::Local<v8::ObjectTemplate> proto,
+                        v8::Local<v8::Signature> signature);
+
+    /**
+     * Register this mixin's callbacks for snapshot serialization.
+     */
+    static void RegisterExternalReferences(ExternalReferenceRegistry* registry);
+
+private:
+    static const PropertyDescriptor kProperties[];
+    
+    static void Before(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void After(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void ReplaceWith(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void Remove(const v8::FunctionCallbackInfo<v8::Value>& args);
+};
+
+} // namespace v8_dom
+
+#endif // V8_DOM_NODE_MIXINS_H
@@ -1,12 +1,220 @@
 #include "node_wrapper.h"
+#include <string>
+#include <vector>
 #include "../wrapper_cache.h"
 #include "../core/template_cache.h"
+#include "../core/string_cache.h"
 #include "../core/utilities.h"
+#include "../core/call_recorder.h"
 #include "element_wrapper.h"
 #include "document_wrapper.h"
+#include "attr_wrapper.h"
+#include "text_wrapper.h"
+#include "cdatasection_wrapper.h"
+#include "comment_wrapper.h"
+#include "processinginstruction_wrapper.h"
+#include "documenttype_wrapper.h"
+#include "documentfragment_wrapper.h"
+#include "../core/features.h"
+#if V8_DOM_ENABLE_SHADOW
+#include "../shadow/shadowroot_wrapper.h"
+#endif
+#include "../collections/childlist_wrapper.h"
+#include "../custom_elements/customelementregistry_wrapper.h"
 
 namespace v8_dom {
 
+const WrapperTypeInfo NodeWrapper::kTypeInfo = {"Node", &EventTargetWrapper::kTypeInfo};
+
+namespace {
+
+using NodeWrapFunction = v8::Local<v8::Object> (*)(v8::Isolate*,
+                                                   v8::Local<v8::Context>,
+                                                   DOMNode*);
+
+/**
+ * Most-derived Wrap for each nodeType (nullptr = generic Node template).
+ * A wrapper keeps the template it was created from (V8 brand-checks
+ * receivers against it), so it has to be right the first time: every
+ * typed Wrap of an interface with derived interfaces (CharacterData,
+ * Text, DocumentFragment) routes nodes of those to their own Wrap too.
+ */
+const NodeWrapFunction kNodeWrapDispatch[] = {
+    nullptr,  // 0: unused
+    [](v8::Isolate* isolate, v8::Local<v8::Context> context, DOMNode* node) {
+        return ElementWrapper::Wrap(isolate, context, (DOMElement*)node);
+    },
+    [](v8::Isolate* isolate, v8::Local<v8::Context> context, DOMNode* node) {
+        return AttrWrapper::Wrap(isolate, context, (DOMAttr*)node);
+    },
+    [](v8::Isolate* isolate, v8::Local<v8::Context> context, DOMNode* node) {
+        return WrapWithTraits<TextWrapper>(isolate, context, (DOMText*)node);
+    },
+    [](v8::Isolate* isolate, v8::Local<v8::Context> context, DOMNode* node) {
+        return CDATASectionWrapper::Wrap(isolate, context, (DOMCDATASection*)node);
+    },
+    nullptr,  // 5: ENTITY_REFERENCE_NODE (legacy)
+    nullptr,  // 6: ENTITY_NODE (legacy)
+    [](v8::Isolate* isolate, v8::Local<v8::Context> context, DOMNode* node) {
+        return ProcessingInstructionWrapper::Wrap(isolate, context, (DOMProcessingInstruction*)node);
+    },
+    [](v8::Isolate* isolate, v8::Local<v8::Context> context, DOMNode* node) {
+        return CommentWrapper::Wrap(isolate, context, (DOMComment*)node);
+    },
+    [](v8::Isolate* isolate, v8::Local<v8::Context> context, DOMNode* node) {
+        return DocumentWrapper::Wrap(isolate, context, (DOMDocument*)node);
+    },
+    [](v8::Isolate* isolate, v8::Local<v8::Context> context, DOMNode* node) {
+        return DocumentTypeWrapper::Wrap(isolate, context, (DOMDocumentType*)node);
+    },
+    [](v8::Isolate* isolate, v8::Local<v8::Context> context, DOMNode* node) {
+        return WrapWithTraits<DocumentFragmentWrapper>(isolate, context, (DOMDocumentFragment*)node);
+    },
+#if V8_DOM_ENABLE_SHADOW
+    [](v8::Isolate* isolate, v8::Local<v8::Context> context, DOMNode* node) {
+        return ShadowRootWrapper::Wrap(isolate, context, (DOMShadowRoot*)node);
+    },
+#else
+    [](v8::Isolate* isolate, v8::Local<v8::Context> context, DOMNode* node) {
+        return WrapWithTraits<DocumentFragmentWrapper>(isolate, context, (DOMDocumentFragment*)node);
+    },
+#endif
+};
+
+constexpr uint16_t kNodeWrapDispatchSize =
+    sizeof(kNodeWrapDispatch) / sizeof(kNodeWrapDispatch[0]);
+
+/**
+ * Wrapper creation for PrewrapSubtree() from a constructor looked up once
+ * per call, for the nodeTypes found below a root (create == nullptr:
+ * through NodeWrapper::Wrap).
+ */
+struct PrewrapEntry {
+    int template_index;
+    v8::Local<v8::FunctionTemplate> (*get_template)(v8::Isolate*);
+    void (*create)(v8::Isolate*, v8::Local<v8::Context>, WrapperCache*, v8::Local<v8::Function>, DOMNode*);
+};
+
+template <typename T>
+constexpr PrewrapEntry PrewrapWith() {
+    return {T::kTemplateIndex, T::GetTemplate,
+            [](v8::Isolate* isolate, v8::Local<v8::Context> context, WrapperCache* cache,
+               v8::Local<v8::Function> constructor, DOMNode* node) {
+                CreateWrapperWith<T>(isolate, context, cache, constructor,
+                                     (typename WrapperTraits<T>::Object*)node);
+            }};
+}
+
+const PrewrapEntry kPrewrapDispatch[kNodeWrapDispatchSize] = {
+    {},  // 0: unused
+    {ElementWrapper::kTemplateIndex, ElementWrapper::GetTemplate,
+     [](v8::Isolate* isolate, v8::Local<v8::Context> context, WrapperCache* cache,
+        v8::Local<v8::Function> constructor, DOMNode* node) {
+         v8::Local<v8::Object> wrapper =
+             CreateWrapperWith<ElementWrapper>(isolate, context, cache, constructor, (DOMElement*)node);
+         CustomElementRegistryWrapper::RestoreClass(isolate, context, (DOMElement*)node, wrapper);
+     }},
+    {},  // 2: ATTRIBUTE_NODE (not a child)
+    PrewrapWith<TextWrapper>(),
+    PrewrapWith<CDATASectionWrapper>(),
+    {},  // 5: ENTITY_REFERENCE_NODE (legacy)
+    {},  // 6: ENTITY_NODE (legacy)
+    PrewrapWith<ProcessingInstructionWrapper>(),
+    PrewrapWith<CommentWrapper>(),
+    {},  // 9: DOCUMENT_NODE (not a child)
+    PrewrapWith<DocumentTypeWrapper>(),
+    {},  // 11: DOCUMENT_FRAGMENT_NODE (not a child)
+    {},  // 12: DOM_SHADOW_ROOT_NODE (not a child)
+};
+
+// Wrappers created per handle scope by PrewrapSubtree()
+constexpr size_t kPrewrapChunk = 1024;
+
+/**
+ * Next node after node in a preorder walk of root's descendants.
+ */
+DOMNode* NextInSubtree(DOMNode* node, DOMNode* root) {
+    if (DOMNode* child = dom_node_get_firstchild(node)) {
+        return child;
+    }
+    while (node != root) {
+        if (DOMNode* sibling = dom_node_get_nextsibling(node)) {
+            return sibling;
+        }
+        node = dom_node_get_parentnode(node);
+    }
+    return nullptr;
+}
+
+/**
+ * Serialized markup collected from dom_node_serialize() chunks.
+ */
+struct MarkupSink {
+    std::string data;
+    bool ascii = true;
+
+    static void Append(const char* chunk, uint32_t length, void* user_data) {
+        MarkupSink* sink = static_cast<MarkupSink*>(user_data);
+        for (uint32_t i = 0; i < length && sink->ascii; i++) {
+            sink->ascii = static_cast<unsigned char>(chunk[i]) < 0x80;
+        }
+        sink->data.append(chunk, length);
+    }
+};
+
+/**
+ * External string owning ASCII bytes (serialized markup, concatenated text).
+ */
+class OwnedStringResource final : public v8::String::ExternalOneByteStringResource {
+public:
+    explicit OwnedStringResource(std::string data) : data_(std::move(data)) {}
+
+    const char* data() const override { return data_.data(); }
+    size_t length() const override { return data_.size(); }
+
+private:
+    std::string data_;
+};
+
+// Shorter strings are copied into a regular string
+constexpr size_t kExternalStringLength = 1024;
+
+/**
+ * Convert a UTF-8 buffer built for the result to a V8 string.
+ *
+ * Large ASCII buffers become an external string over the bytes themselves,
+ * so they are not copied again.
+ */
+v8::MaybeLocal<v8::String> OwnedUtf8ToV8String(v8::Isolate* isolate, std::string data, bool ascii) {
+    if (ascii && data.size() >= kExternalStringLength) {
+        OwnedStringResource* resource = new OwnedStringResource(std::move(data));
+        v8::Local<v8::String> str;
+        if (v8::String::NewExternalOneByte(isolate, resource).ToLocal(&str)) {
+            return str;
+        }
+        // V8 did not take ownership
+        data.assign(resource->data(), resource->length());
+        delete resource;
+    }
+    if (ascii) {
+        return v8::String::NewFromOneByte(isolate, reinterpret_cast<const uint8_t*>(data.data()),
+                                          v8::NewStringType::kNormal, static_cast<int>(data.size()));
+    }
+    return v8::String::NewFromUtf8(isolate, data.data(), v8::NewStringType::kNormal,
+                                   static_cast<int>(data.size()));
+}
+
+/**
+ * Read the optional serialization flags argument at index; false if it threw.
+ */
+bool SerializeFlagsArg(const v8::FunctionCallbackInfo<v8::Value>& args, int index, uint32_t* flags) {
+    *flags = 0;
+    if (args.Length() <= index || args[index]->IsUndefined()) return true;
+    return args[index]->Uint32Value(args.GetIsolate()->GetCurrentContext()).To(flags);
+}
+
+} // namespace
+
 v8::Local<v8::Object> NodeWrapper::Wrap(v8::Isolate* isolate,
                                               v8::Local<v8::Context> context,
                                               DOMNode* obj) {
@@ -14,130 +222,164 @@ v8::Local<v8::Object> NodeWrapper::Wrap(v8::Isolate* isolate,
         return v8::Local<v8::Object>();
     }
     
-    // Check wrapper cache first
     WrapperCache* cache = WrapperCache::ForIsolate(isolate);
-    if (cache->Has(obj)) {
-        return cache->Get(isolate, obj);
+    v8::Local<v8::Object> cached;
+    if (LookupWrapper<NodeWrapper>(isolate, cache, obj, &cached)) {
+        return cached;
     }
     
-    // Create new wrapper
-    v8::EscapableHandleScope handle_scope(isolate);
-    v8::Local<v8::FunctionTemplate> tmpl = GetTemplate(isolate);
-    v8::Local<v8::Function> constructor = tmpl->GetFunction(context).ToLocalChecked();
-    v8::Local<v8::Object> wrapper = constructor->NewInstance(context).ToLocalChecked();
-    
-    // Store C pointer in internal field
-    wrapper->SetInternalField(0, v8::External::New(isolate, obj));
-    
-    // Increment C-side reference count
-    dom_node_addref(obj);
-    
-    // Cache with release callback
-    cache->Set(isolate, obj, wrapper, [](void* ptr) {
-        dom_node_release(static_cast<DOMNode*>(ptr));
-    });
+    // Route to the most-derived wrapper so every node gets its real hidden class
+    uint16_t node_type = dom_node_get_nodetype(obj);
+    if (node_type < kNodeWrapDispatchSize && kNodeWrapDispatch[node_type]) {
+        return kNodeWrapDispatch[node_type](isolate, context, obj);
+    }
     
-    return handle_scope.Escape(wrapper);
+    return CreateWrapper<NodeWrapper>(isolate, context, cache, obj);
 }
 
-
-DOMNode* NodeWrapper::Unwrap(v8::Local<v8::Object> obj) {
-    if (obj.IsEmpty() || obj->InternalFieldCount() < 1) {
-        return nullptr;
+size_t NodeWrapper::PrewrapSubtree(v8::Isolate* isolate,
+                                   v8::Local<v8::Context> context,
+                                   DOMNode* root,
+                                   size_t max) {
+    if (!root || max == 0) {
+        return 0;
+    }
+    WrapperCache* cache = WrapperCache::ForIsolate(isolate);
+    
+    // Descendants without a wrapper, in tree order, and their nodeTypes
+    struct Pending {
+        DOMNode* node;
+        uint16_t node_type;
+    };
+    std::vector<Pending> pending;
+    uint32_t types_present = 0;
+    for (DOMNode* node = dom_node_get_firstchild(root); node && pending.size() < max;
+         node = NextInSubtree(node, root)) {
+        if (cache->HasNode(node)) {
+            continue;
+        }
+        uint16_t node_type = dom_node_get_nodetype(node);
+        pending.push_back({node, node_type});
+        if (node_type < kNodeWrapDispatchSize) {
+            types_present |= 1u << node_type;
+        }
+    }
+    if (pending.empty()) {
+        return 0;
     }
+    cache->ReserveNodes(pending.size());
     
-    v8::Local<v8::Data> data = obj->GetInternalField(0);
-    v8::Local<v8::Value> ptr = data.As<v8::Value>();
-    if (ptr.IsEmpty()) return nullptr;
-    if (!ptr->IsExternal()) {
-        return nullptr;
+    // Each constructor once, in the outer scope so every chunk can use it
+    v8::HandleScope handle_scope(isolate);
+    TemplateCache* templates = TemplateCache::ForIsolate(isolate);
+    v8::Local<v8::Function> constructors[kNodeWrapDispatchSize];
+    for (uint16_t type = 0; type < kNodeWrapDispatchSize; type++) {
+        const PrewrapEntry& entry = kPrewrapDispatch[type];
+        if ((types_present & (1u << type)) && entry.create) {
+            constructors[type] = templates->GetConstructor(context, entry.template_index, entry.get_template);
+        }
     }
     
-    return static_cast<DOMNode*>(v8::Local<v8::External>::Cast(ptr)->Value());
+    for (size_t start = 0; start < pending.size(); start += kPrewrapChunk) {
+        v8::HandleScope chunk_scope(isolate);
+        size_t end = start + kPrewrapChunk < pending.size() ? start + kPrewrapChunk : pending.size();
+        for (size_t i = start; i < end; i++) {
+            uint16_t type = pending[i].node_type;
+            if (type < kNodeWrapDispatchSize && kPrewrapDispatch[type].create) {
+                kPrewrapDispatch[type].create(isolate, context, cache, constructors[type], pending[i].node);
+            } else {
+                Wrap(isolate, context, pending[i].node);
+            }
+        }
+    }
+    return pending.size();
+}
 
+DOMNode* NodeWrapper::Unwrap(v8::Local<v8::Object> obj) {
+    return UnwrapWithTraits<NodeWrapper>(obj);
 }
 
-void NodeWrapper::InstallTemplate(v8::Isolate* isolate) {
-    v8::Local<v8::FunctionTemplate> tmpl = v8::FunctionTemplate::New(isolate);
-    tmpl->SetClassName(v8::String::NewFromUtf8Literal(isolate, "Node"));
-    tmpl->InstanceTemplate()->SetInternalFieldCount(1);
-    
-    // Inherit from EventTarget
-    tmpl->Inherit(EventTargetWrapper::GetTemplate(isolate));
+namespace {
 
-    // Get prototype template for adding properties/methods
-    v8::Local<v8::ObjectTemplate> proto = tmpl->PrototypeTemplate();
-    
+constexpr ConstantDescriptor kNodeConstants[] = {
+    {"DOCUMENT_POSITION_DISCONNECTED", DOM_DOCUMENT_POSITION_DISCONNECTED},
+    {"DOCUMENT_POSITION_PRECEDING", DOM_DOCUMENT_POSITION_PRECEDING},
+    {"DOCUMENT_POSITION_FOLLOWING", DOM_DOCUMENT_POSITION_FOLLOWING},
+    {"DOCUMENT_POSITION_CONTAINS", DOM_DOCUMENT_POSITION_CONTAINS},
+    {"DOCUMENT_POSITION_CONTAINED_BY", DOM_DOCUMENT_POSITION_CONTAINED_BY},
+    {"DOCUMENT_POSITION_IMPLEMENTATION_SPECIFIC", DOM_DOCUMENT_POSITION_IMPLEMENTATION_SPECIFIC},
+};
+
+} // namespace
+
+const PropertyDescriptor NodeWrapper::kProperties[] = {
     // Readonly properties
-    proto->SetNativeDataProperty(
-        v8::String::NewFromUtf8Literal(isolate, "nodeType"),
-        NodeTypeGetter);
-    proto->SetNativeDataProperty(
-        v8::String::NewFromUtf8Literal(isolate, "nodeName"),
-        NodeNameGetter);
-    proto->SetNativeDataProperty(
-        v8::String::NewFromUtf8Literal(isolate, "parentNode"),
-        ParentNodeGetter);
-    proto->SetNativeDataProperty(
-        v8::String::NewFromUtf8Literal(isolate, "parentElement"),
-        ParentElementGetter);
-    proto->SetNativeDataProperty(
-        v8::String::NewFromUtf8Literal(isolate, "firstChild"),
-        FirstChildGetter);
-    proto->SetNativeDataProperty(
-        v8::String::NewFromUtf8Literal(isolate, "lastChild"),
-        LastChildGetter);
-    proto->SetNativeDataProperty(
-        v8::String::NewFromUtf8Literal(isolate, "previousSibling"),
-        PreviousSiblingGetter);
-    proto->SetNativeDataProperty(
-        v8::String::NewFromUtf8Literal(isolate, "nextSibling"),
-        NextSiblingGetter);
-    proto->SetNativeDataProperty(
-        v8::String::NewFromUtf8Literal(isolate, "ownerDocument"),
-        OwnerDocumentGetter);
-    proto->SetNativeDataProperty(
-        v8::String::NewFromUtf8Literal(isolate, "isConnected"),
-        IsConnectedGetter);
+    AccessorProperty("nodeType", NodeTypeGetter, nullptr, kReceiverCheck | kNoSideEffect, &kFastNodeType),
+    DataProperty("nodeName", NodeNameGetter),
+    DataProperty("parentNode", ParentNodeGetter),
+    DataProperty("parentElement", ParentElementGetter),
+    AccessorProperty("childNodes", ChildListWrapper::ChildNodesGetter, nullptr, kReceiverCheck | kNoSideEffect),
+    DataProperty("firstChild", FirstChildGetter),
+    DataProperty("lastChild", LastChildGetter),
+    DataProperty("previousSibling", PreviousSiblingGetter),
+    DataProperty("nextSibling", NextSiblingGetter),
+    DataProperty("ownerDocument", OwnerDocumentGetter),
+    AccessorProperty("isConnected", IsConnectedGetter, nullptr, kReceiverCheck | kNoSideEffect, &kFastIsConnected),
     
     // Read/write properties
-    proto->SetNativeDataProperty(
-        v8::String::NewFromUtf8Literal(isolate, "nodeValue"),
-        NodeValueGetter,
-        NodeValueSetter);
-    proto->SetNativeDataProperty(
-        v8::String::NewFromUtf8Literal(isolate, "textContent"),
-        TextContentGetter,
-        TextContentSetter);
+    DataProperty("nodeValue", NodeValueGetter, NodeValueSetter),
+    DataProperty("textContent", TextContentGetter, TextContentSetter),
     
     // Methods - Tree manipulation
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "appendChild"),
-              v8::FunctionTemplate::New(isolate, AppendChild));
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "insertBefore"),
-              v8::FunctionTemplate::New(isolate, InsertBefore));
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "removeChild"),
-              v8::FunctionTemplate::New(isolate, RemoveChild));
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "replaceChild"),
-              v8::FunctionTemplate::New(isolate, ReplaceChild));
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "cloneNode"),
-              v8::FunctionTemplate::New(isolate, CloneNode));
+    MethodProperty("appendChild", AppendChild),
+    MethodProperty("insertBefore", InsertBefore),
+    MethodProperty("removeChild", RemoveChild),
+    MethodProperty("replaceChild", ReplaceChild),
+    MethodProperty("cloneNode", CloneNode),
     
     // Methods - Tree querying
-    // TODO: Enable when dom_node_getrootnode is implemented in C API
-    // proto->Set(v8::String::NewFromUtf8Literal(isolate, "getRootNode"),
-    //           v8::FunctionTemplate::New(isolate, GetRootNode));
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "hasChildNodes"),
-              v8::FunctionTemplate::New(isolate, HasChildNodes));
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "contains"),
-              v8::FunctionTemplate::New(isolate, Contains));
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "isSameNode"),
-              v8::FunctionTemplate::New(isolate, IsSameNode));
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "isEqualNode"),
-              v8::FunctionTemplate::New(isolate, IsEqualNode));
+    MethodProperty("getRootNode", GetRootNode),
+    MethodProperty("hasChildNodes", HasChildNodes, kReceiverCheck | kNoSideEffect, 0, &kFastHasChildNodes),
+    MethodProperty("contains", Contains, kReceiverCheck | kNoSideEffect, 1, &kFastContains),
+    MethodProperty("compareDocumentPosition", CompareDocumentPosition, kReceiverCheck | kNoSideEffect, 1,
+                   &kFastCompareDocumentPosition),
+    MethodProperty("isSameNode", IsSameNode, kReceiverCheck | kNoSideEffect, 1, &kFastIsSameNode),
+    MethodProperty("isEqualNode", IsEqualNode),
     
     // Methods - Other
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "normalize"),
-              v8::FunctionTemplate::New(isolate, Normalize));
+    MethodProperty("normalize", Normalize),
+    
+    // Non-standard: flat subtree snapshot for serializers (not enumerable)
+    MethodProperty("__snapshot", Snapshot, kReceiverCheck | kDontEnum),
+    
+    // Non-standard: patch stream to another subtree (not enumerable)
+    MethodProperty("__diff", Diff, kReceiverCheck | kDontEnum, 2),
+    
+    // Non-standard: markup serialization (not enumerable)
+    MethodProperty("__serialize", Serialize, kReceiverCheck | kDontEnum),
+    MethodProperty("__serializeInto", SerializeInto, kReceiverCheck | kDontEnum),
+    
+    // Non-standard: create the wrappers of a subtree ahead of a traversal
+    // (not enumerable)
+    MethodProperty("__prewrap", Prewrap, kReceiverCheck | kDontEnum),
+    
+    // Non-standard: integer handle in the owner document's node table, for
+    // the document's __firstChild(id) etc. (not enumerable)
+    AccessorProperty("__id", IdGetter, nullptr, kReceiverCheck | kDontEnum, &kFastId),
+};
+
+void NodeWrapper::InstallTemplate(v8::Isolate* isolate) {
+    v8::Local<v8::FunctionTemplate> tmpl = v8::FunctionTemplate::New(isolate);
+    tmpl->SetClassName(v8::String::NewFromUtf8Literal(isolate, "Node"));
+    tmpl->InstanceTemplate()->SetInternalFieldCount(kWrapperFieldCount);
+    
+    // Inherit from EventTarget
+    tmpl->Inherit(EventTargetWrapper::GetTemplate(isolate));
+    
+    // Document position constants (on the interface and its prototype)
+    InstallConstants(isolate, tmpl, kNodeConstants);
+    
+    InstallProperties(isolate, tmpl, kProperties);
     
     // Cache the template
     TemplateCache* cache = TemplateCache::ForIsolate(isolate);
@@ -155,27 +397,29 @@ v8::Local<v8::FunctionTemplate> NodeWrapper::GetTemplate(v8::Isolate* isolate) {
     return cache->Get(kTemplateIndex);
 }
 
+void NodeWrapper::RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+    RegisterProperties(registry, kProperties);
+}
+
 // ============================================================================
 // Property Implementations - Readonly
 // ============================================================================
 
-void NodeWrapper::NodeTypeGetter(v8::Local<v8::Name> property,
-                                 const v8::PropertyCallbackInfo<v8::Value>& info) {
-    v8::Isolate* isolate = info.GetIsolate();
-    DOMNode* node = Unwrap(info.This().As<v8::Object>());
+void NodeWrapper::NodeTypeGetter(const v8::FunctionCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("NodeWrapper::NodeTypeGetter");
+    DOMNode* node = UnwrapReceiver<DOMNode>(info);
     if (!node) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Node")));
         return;
     }
     
-    uint16_t nodeType = dom_node_get_nodetype(node);
-    info.GetReturnValue().Set(v8::Integer::New(isolate, nodeType));
+    uint16_t nodeType = ScriptNodeType(dom_node_get_nodetype(node));
+    info.GetReturnValue().Set(static_cast<uint32_t>(nodeType));
 
 }
 
 void NodeWrapper::NodeNameGetter(v8::Local<v8::Name> property,
                                  const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("NodeWrapper::NodeNameGetter");
     v8::Isolate* isolate = info.GetIsolate();
     DOMNode* node = Unwrap(info.This().As<v8::Object>());
     if (!node) {
@@ -191,6 +435,7 @@ void NodeWrapper::NodeNameGetter(v8::Local<v8::Name> property,
 
 void NodeWrapper::ParentNodeGetter(v8::Local<v8::Name> property,
                                    const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("NodeWrapper::ParentNodeGetter");
     v8::Isolate* isolate = info.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     DOMNode* node = Unwrap(info.This().As<v8::Object>());
@@ -211,6 +456,7 @@ void NodeWrapper::ParentNodeGetter(v8::Local<v8::Name> property,
 
 void NodeWrapper::ParentElementGetter(v8::Local<v8::Name> property,
                                       const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("NodeWrapper::ParentElementGetter");
     v8::Isolate* isolate = info.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     DOMNode* node = Unwrap(info.This().As<v8::Object>());
@@ -231,6 +477,7 @@ void NodeWrapper::ParentElementGetter(v8::Local<v8::Name> property,
 
 void NodeWrapper::FirstChildGetter(v8::Local<v8::Name> property,
                                    const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("NodeWrapper::FirstChildGetter");
     v8::Isolate* isolate = info.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     DOMNode* node = Unwrap(info.This().As<v8::Object>());
@@ -251,6 +498,7 @@ void NodeWrapper::FirstChildGetter(v8::Local<v8::Name> property,
 
 void NodeWrapper::LastChildGetter(v8::Local<v8::Name> property,
                                   const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("NodeWrapper::LastChildGetter");
     v8::Isolate* isolate = info.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     DOMNode* node = Unwrap(info.This().As<v8::Object>());
@@ -271,6 +519,7 @@ void NodeWrapper::LastChildGetter(v8::Local<v8::Name> property,
 
 void NodeWrapper::PreviousSiblingGetter(v8::Local<v8::Name> property,
                                         const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("NodeWrapper::PreviousSiblingGetter");
     v8::Isolate* isolate = info.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     DOMNode* node = Unwrap(info.This().As<v8::Object>());
@@ -291,6 +540,7 @@ void NodeWrapper::PreviousSiblingGetter(v8::Local<v8::Name> property,
 
 void NodeWrapper::NextSiblingGetter(v8::Local<v8::Name> property,
                                     const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("NodeWrapper::NextSiblingGetter");
     v8::Isolate* isolate = info.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     DOMNode* node = Unwrap(info.This().As<v8::Object>());
@@ -311,6 +561,7 @@ void NodeWrapper::NextSiblingGetter(v8::Local<v8::Name> property,
 
 void NodeWrapper::OwnerDocumentGetter(v8::Local<v8::Name> property,
                                       const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("NodeWrapper::OwnerDocumentGetter");
     v8::Isolate* isolate = info.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     DOMNode* node = Unwrap(info.This().As<v8::Object>());
@@ -328,18 +579,26 @@ void NodeWrapper::OwnerDocumentGetter(v8::Local<v8::Name> property,
     }
 }
 
-void NodeWrapper::IsConnectedGetter(v8::Local<v8::Name> property,
-                                    const v8::PropertyCallbackInfo<v8::Value>& info) {
-    v8::Isolate* isolate = info.GetIsolate();
-    DOMNode* node = Unwrap(info.This().As<v8::Object>());
+void NodeWrapper::IsConnectedGetter(const v8::FunctionCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("NodeWrapper::IsConnectedGetter");
+    DOMNode* node = UnwrapReceiver<DOMNode>(info);
     if (!node) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Node")));
         return;
     }
     
     uint8_t isConnected = dom_node_get_isconnected(node);
-    info.GetReturnValue().Set(v8::Boolean::New(isolate, isConnected != 0));
+    info.GetReturnValue().Set(isConnected != 0);
+}
+
+void NodeWrapper::IdGetter(const v8::FunctionCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("NodeWrapper::IdGetter");
+    DOMNode* node = UnwrapReceiver<DOMNode>(info);
+    if (!node) {
+        return;
+    }
+    
+    // 0 for attributes and nodes a frozen document could not number
+    info.GetReturnValue().Set(dom_nodetable_id(node));
 }
 
 // ============================================================================
@@ -348,6 +607,7 @@ void NodeWrapper::IsConnectedGetter(v8::Local<v8::Name> property,
 
 void NodeWrapper::NodeValueGetter(v8::Local<v8::Name> property,
                                   const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("NodeWrapper::NodeValueGetter");
     v8::Isolate* isolate = info.GetIsolate();
     DOMNode* node = Unwrap(info.This().As<v8::Object>());
     if (!node) {
@@ -368,6 +628,7 @@ void NodeWrapper::NodeValueGetter(v8::Local<v8::Name> property,
 void NodeWrapper::NodeValueSetter(v8::Local<v8::Name> property,
                                   v8::Local<v8::Value> value,
                                   const v8::PropertyCallbackInfo<void>& info) {
+    V8_DOM_TRACE_SCOPE("NodeWrapper::NodeValueSetter");
     v8::Isolate* isolate = info.GetIsolate();
     DOMNode* node = Unwrap(info.This().As<v8::Object>());
     if (!node) {
@@ -392,6 +653,7 @@ void NodeWrapper::NodeValueSetter(v8::Local<v8::Name> property,
 
 void NodeWrapper::TextContentGetter(v8::Local<v8::Name> property,
                                     const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("NodeWrapper::TextContentGetter");
     v8::Isolate* isolate = info.GetIsolate();
     DOMNode* node = Unwrap(info.This().As<v8::Object>());
     if (!node) {
@@ -400,17 +662,40 @@ void NodeWrapper::TextContentGetter(v8::Local<v8::Name> property,
         return;
     }
     
-    const char* textContent = dom_node_get_textcontent(node);
-    if (textContent && textContent[0] != '\0') {
-        info.GetReturnValue().Set(CStringToV8String(isolate, textContent));
-    } else {
-        info.GetReturnValue().SetEmptyString();
+    // Character data and single-Text subtrees: read the node's storage in place
+    DOMStringView view;
+    if (dom_node_get_textcontent_view(node, &view)) {
+        info.GetReturnValue().Set(StringViewToV8String(isolate, view, node));
+        return;
+    }
+    
+    size_t length;
+    if (!dom_node_get_textcontent_length(node, &length)) {
+        info.GetReturnValue().SetNull();
+        return;
+    }
+    
+    // Concatenate once, straight into the buffer the string is made from
+    std::string text(length, '\0');
+    dom_node_copy_textcontent(node, reinterpret_cast<uint8_t*>(&text[0]), length);
+    bool ascii = true;
+    for (char c : text) {
+        if (static_cast<unsigned char>(c) >= 0x80) {
+            ascii = false;
+            break;
+        }
+    }
+    
+    v8::Local<v8::String> str;
+    if (OwnedUtf8ToV8String(isolate, std::move(text), ascii).ToLocal(&str)) {
+        info.GetReturnValue().Set(str);
     }
 }
 
 void NodeWrapper::TextContentSetter(v8::Local<v8::Name> property,
                                     v8::Local<v8::Value> value,
                                     const v8::PropertyCallbackInfo<void>& info) {
+    V8_DOM_TRACE_SCOPE("NodeWrapper::TextContentSetter");
     v8::Isolate* isolate = info.GetIsolate();
     DOMNode* node = Unwrap(info.This().As<v8::Object>());
     if (!node) {
@@ -421,12 +706,16 @@ void NodeWrapper::TextContentSetter(v8::Local<v8::Name> property,
     
     if (value->IsNull() || value->IsUndefined()) {
         int32_t err = dom_node_set_textcontent(node, nullptr);
+        V8_DOM_RECORD_CALL(kSetTextContent, TraceNode(node), "");
         if (err != 0) {
             ThrowDOMException(isolate, err);
         }
     } else {
-        CStringFromV8 textContent(isolate, value);
-        int32_t err = dom_node_set_textcontent(node, textContent.get());
+        // Passed with its length; documents that enable in-place textContent
+        // update a sole Text child without a new node or wrapper
+        StringArgFromV8 textContent(isolate, value);
+        int32_t err = dom_node_set_textcontent_n(node, textContent.data(), textContent.length());
+        V8_DOM_RECORD_CALL(kSetTextContent, TraceNode(node), textContent);
         if (err != 0) {
             ThrowDOMException(isolate, err);
         }
@@ -438,12 +727,11 @@ void NodeWrapper::TextContentSetter(v8::Local<v8::Name> property,
 // ============================================================================
 
 void NodeWrapper::AppendChild(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("NodeWrapper::AppendChild");
     v8::Isolate* isolate = args.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
-    DOMNode* node = Unwrap(args.This());
+    DOMNode* node = UnwrapReceiver<DOMNode>(args);
     if (!node) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Node")));
         return;
     }
     
@@ -460,6 +748,7 @@ void NodeWrapper::AppendChild(const v8::FunctionCallbackInfo<v8::Value>& args) {
         return;
     }
     
+    V8_DOM_RECORD_CALL(kAppendChild, TraceNode(node), TraceNode(child));
     DOMNode* result = dom_node_appendchild(node, child);
     if (result) {
         args.GetReturnValue().Set(NodeWrapper::Wrap(isolate, context, result));
@@ -471,12 +760,11 @@ void NodeWrapper::AppendChild(const v8::FunctionCallbackInfo<v8::Value>& args) {
 }
 
 void NodeWrapper::InsertBefore(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("NodeWrapper::InsertBefore");
     v8::Isolate* isolate = args.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
-    DOMNode* node = Unwrap(args.This());
+    DOMNode* node = UnwrapReceiver<DOMNode>(args);
     if (!node) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Node")));
         return;
     }
     
@@ -503,6 +791,7 @@ void NodeWrapper::InsertBefore(const v8::FunctionCallbackInfo<v8::Value>& args)
         refNode = NodeWrapper::Unwrap(args[1].As<v8::Object>());
     }
     
+    V8_DOM_RECORD_CALL(kInsertBefore, TraceNode(node), TraceNode(newNode), TraceNode(refNode));
     DOMNode* result = dom_node_insertbefore(node, newNode, refNode);
     if (result) {
         args.GetReturnValue().Set(NodeWrapper::Wrap(isolate, context, result));
@@ -514,12 +803,11 @@ void NodeWrapper::InsertBefore(const v8::FunctionCallbackInfo<v8::Value>& args)
 }
 
 void NodeWrapper::RemoveChild(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("NodeWrapper::RemoveChild");
     v8::Isolate* isolate = args.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
-    DOMNode* node = Unwrap(args.This());
+    DOMNode* node = UnwrapReceiver<DOMNode>(args);
     if (!node) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Node")));
         return;
     }
     
@@ -536,6 +824,7 @@ void NodeWrapper::RemoveChild(const v8::FunctionCallbackInfo<v8::Value>& args) {
         return;
     }
     
+    V8_DOM_RECORD_CALL(kRemoveChild, TraceNode(node), TraceNode(child));
     DOMNode* result = dom_node_removechild(node, child);
     if (result) {
         args.GetReturnValue().Set(NodeWrapper::Wrap(isolate, context, result));
@@ -547,12 +836,11 @@ void NodeWrapper::RemoveChild(const v8::FunctionCallbackInfo<v8::Value>& args) {
 }
 
 void NodeWrapper::ReplaceChild(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("NodeWrapper::ReplaceChild");
     v8::Isolate* isolate = args.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
-    DOMNode* node = Unwrap(args.This());
+    DOMNode* node = UnwrapReceiver<DOMNode>(args);
     if (!node) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Node")));
         return;
     }
     
@@ -571,6 +859,7 @@ void NodeWrapper::ReplaceChild(const v8::FunctionCallbackInfo<v8::Value>& args)
         return;
     }
     
+    V8_DOM_RECORD_CALL(kReplaceChild, TraceNode(node), TraceNode(newNode), TraceNode(oldNode));
     DOMNode* result = dom_node_replacechild(node, newNode, oldNode);
     if (result) {
         args.GetReturnValue().Set(NodeWrapper::Wrap(isolate, context, result));
@@ -582,12 +871,11 @@ void NodeWrapper::ReplaceChild(const v8::FunctionCallbackInfo<v8::Value>& args)
 }
 
 void NodeWrapper::CloneNode(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("NodeWrapper::CloneNode");
     v8::Isolate* isolate = args.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
-    DOMNode* node = Unwrap(args.This());
+    DOMNode* node = UnwrapReceiver<DOMNode>(args);
     if (!node) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Node")));
         return;
     }
     
@@ -598,27 +886,25 @@ void NodeWrapper::CloneNode(const v8::FunctionCallbackInfo<v8::Value>& args) {
     }
     
     DOMNode* clone = dom_node_clonenode(node, deep);
+    V8_DOM_RECORD_CALL(kCloneNode, TraceNode(node), uint32_t(deep), TraceResult(clone));
     if (clone) {
         args.GetReturnValue().Set(NodeWrapper::Wrap(isolate, context, clone));
     } else {
         isolate->ThrowException(v8::Exception::Error(
             v8::String::NewFromUtf8Literal(isolate, "Failed to clone node")));
     }
-
+}
 
 // ============================================================================
 // Method Implementations - Tree Querying
 // ============================================================================
-#if 0 // TODO: Enable when dom_node_getrootnode is implemented
-}
 
 void NodeWrapper::GetRootNode(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("NodeWrapper::GetRootNode");
     v8::Isolate* isolate = args.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
-    DOMNode* node = Unwrap(args.This());
+    DOMNode* node = UnwrapReceiver<DOMNode>(args);
     if (!node) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Node")));
         return;
     }
     
@@ -626,52 +912,45 @@ void NodeWrapper::GetRootNode(const v8::FunctionCallbackInfo<v8::Value>& args) {
     uint8_t composed = 0;
     if (args.Length() > 0 && args[0]->IsObject()) {
         v8::Local<v8::Object> options = args[0].As<v8::Object>();
-        v8::Local<v8::Value> composedVal = options->Get(context,
-            v8::String::NewFromUtf8Literal(isolate, "composed")).ToLocalChecked();
+        v8::Local<v8::Value> composedVal;
+        if (!options->Get(context, v8::String::NewFromUtf8Literal(isolate, "composed")).ToLocal(&composedVal)) {
+            return;
+        }
         composed = composedVal->BooleanValue(isolate) ? 1 : 0;
     }
     
+    // O(1) for connected nodes; the root is usually the document
     DOMNode* rootNode = dom_node_getrootnode(node, composed);
-    if (rootNode) {
-        args.GetReturnValue().Set(NodeWrapper::Wrap(isolate, context, rootNode));
-    } else {
-        args.GetReturnValue().Set(NodeWrapper::Wrap(isolate, context, node));
-    }
-
-#endif
-
+    args.GetReturnValue().Set(NodeWrapper::Wrap(isolate, context, rootNode));
 }
 
 void NodeWrapper::HasChildNodes(const v8::FunctionCallbackInfo<v8::Value>& args) {
-    v8::Isolate* isolate = args.GetIsolate();
-    DOMNode* node = Unwrap(args.This());
+    V8_DOM_TRACE_SCOPE("NodeWrapper::HasChildNodes");
+    DOMNode* node = UnwrapReceiver<DOMNode>(args);
     if (!node) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Node")));
         return;
     }
     
     uint8_t result = dom_node_haschildnodes(node);
-    args.GetReturnValue().Set(v8::Boolean::New(isolate, result != 0));
+    args.GetReturnValue().Set(result != 0);
 
 }
 
 void NodeWrapper::Contains(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("NodeWrapper::Contains");
     v8::Isolate* isolate = args.GetIsolate();
-    DOMNode* node = Unwrap(args.This());
+    DOMNode* node = UnwrapReceiver<DOMNode>(args);
     if (!node) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Node")));
         return;
     }
     
     if (args.Length() < 1) {
-        args.GetReturnValue().Set(v8::Boolean::New(isolate, false));
+        args.GetReturnValue().Set(false);
         return;
     }
     
     if (args[0]->IsNull() || args[0]->IsUndefined()) {
-        args.GetReturnValue().Set(v8::Boolean::New(isolate, false));
+        args.GetReturnValue().Set(false);
         return;
     }
     
@@ -683,85 +962,190 @@ void NodeWrapper::Contains(const v8::FunctionCallbackInfo<v8::Value>& args) {
     
     DOMNode* other = NodeWrapper::Unwrap(args[0].As<v8::Object>());
     if (!other) {
-        args.GetReturnValue().Set(v8::Boolean::New(isolate, false));
+        args.GetReturnValue().Set(false);
         return;
     }
     
     uint8_t result = dom_node_contains(node, other);
-    args.GetReturnValue().Set(v8::Boolean::New(isolate, result != 0));
+    args.GetReturnValue().Set(result != 0);
 
 }
 
-void NodeWrapper::IsSameNode(const v8::FunctionCallbackInfo<v8::Value>& args) {
+void NodeWrapper::CompareDocumentPosition(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("NodeWrapper::CompareDocumentPosition");
     v8::Isolate* isolate = args.GetIsolate();
-    DOMNode* node = Unwrap(args.This());
+    DOMNode* node = UnwrapReceiver<DOMNode>(args);
     if (!node) {
+        return;
+    }
+    
+    DOMNode* other = nullptr;
+    if (args.Length() > 0 && args[0]->IsObject()) {
+        other = NodeWrapper::Unwrap(args[0].As<v8::Object>());
+    }
+    if (!other) {
         isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Node")));
+            v8::String::NewFromUtf8Literal(isolate, "Argument must be a Node")));
+        return;
+    }
+    
+    uint16_t result = dom_node_comparedocumentposition(node, other);
+    args.GetReturnValue().Set(static_cast<uint32_t>(result));
+
+}
+
+void NodeWrapper::IsSameNode(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("NodeWrapper::IsSameNode");
+    DOMNode* node = UnwrapReceiver<DOMNode>(args);
+    if (!node) {
         return;
     }
     
     if (args.Length() < 1 || args[0]->IsNull() || args[0]->IsUndefined()) {
-        args.GetReturnValue().Set(v8::Boolean::New(isolate, false));
+        args.GetReturnValue().Set(false);
         return;
     }
     
     if (!args[0]->IsObject()) {
-        args.GetReturnValue().Set(v8::Boolean::New(isolate, false));
+        args.GetReturnValue().Set(false);
         return;
     }
     
     DOMNode* other = NodeWrapper::Unwrap(args[0].As<v8::Object>());
     if (!other) {
-        args.GetReturnValue().Set(v8::Boolean::New(isolate, false));
+        args.GetReturnValue().Set(false);
         return;
     }
     
     uint8_t result = dom_node_issamenode(node, other);
-    args.GetReturnValue().Set(v8::Boolean::New(isolate, result != 0));
+    args.GetReturnValue().Set(result != 0);
 
 }
 
 void NodeWrapper::IsEqualNode(const v8::FunctionCallbackInfo<v8::Value>& args) {
-    v8::Isolate* isolate = args.GetIsolate();
-    DOMNode* node = Unwrap(args.This());
+    V8_DOM_TRACE_SCOPE("NodeWrapper::IsEqualNode");
+    DOMNode* node = UnwrapReceiver<DOMNode>(args);
     if (!node) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Node")));
         return;
     }
     
     if (args.Length() < 1 || args[0]->IsNull() || args[0]->IsUndefined()) {
-        args.GetReturnValue().Set(v8::Boolean::New(isolate, false));
+        args.GetReturnValue().Set(false);
         return;
     }
     
     if (!args[0]->IsObject()) {
-        args.GetReturnValue().Set(v8::Boolean::New(isolate, false));
+        args.GetReturnValue().Set(false);
         return;
     }
     
     DOMNode* other = NodeWrapper::Unwrap(args[0].As<v8::Object>());
     if (!other) {
-        args.GetReturnValue().Set(v8::Boolean::New(isolate, false));
+        args.GetReturnValue().Set(false);
         return;
     }
     
     uint8_t result = dom_node_isequalnode(node, other);
-    args.GetReturnValue().Set(v8::Boolean::New(isolate, result != 0));
+    args.GetReturnValue().Set(result != 0);
 
 }
 
+// ============================================================================
+// Fast API Implementations
+// ============================================================================
+//
+// Called from optimized code with the receiver already checked against the
+// Node signature. They must not allocate or call into JS, except to throw.
+
+const v8::CFunction NodeWrapper::kFastNodeType = v8::CFunction::Make(FastNodeType);
+const v8::CFunction NodeWrapper::kFastIsConnected = v8::CFunction::Make(FastIsConnected);
+const v8::CFunction NodeWrapper::kFastHasChildNodes = v8::CFunction::Make(FastHasChildNodes);
+const v8::CFunction NodeWrapper::kFastContains = v8::CFunction::Make(FastContains);
+const v8::CFunction NodeWrapper::kFastIsSameNode = v8::CFunction::Make(FastIsSameNode);
+const v8::CFunction NodeWrapper::kFastCompareDocumentPosition = v8::CFunction::Make(FastCompareDocumentPosition);
+const v8::CFunction NodeWrapper::kFastId = v8::CFunction::Make(FastId);
+
+uint32_t NodeWrapper::FastNodeType(v8::Local<v8::Object> receiver) {
+    DOMNode* node = UnwrapReceiver<DOMNode>(receiver);
+    // Same mapping as the slow getter, or the answer would change once
+    // the call site is optimized
+    return node ? ScriptNodeType(dom_node_get_nodetype(node)) : 0;
+}
+
+uint32_t NodeWrapper::FastId(v8::Local<v8::Object> receiver) {
+    DOMNode* node = UnwrapReceiver<DOMNode>(receiver);
+    return node ? dom_nodetable_id(node) : 0;
+}
+
+bool NodeWrapper::FastIsConnected(v8::Local<v8::Object> receiver) {
+    DOMNode* node = UnwrapReceiver<DOMNode>(receiver);
+    return node && dom_node_get_isconnected(node) != 0;
+}
+
+bool NodeWrapper::FastHasChildNodes(v8::Local<v8::Object> receiver) {
+    DOMNode* node = UnwrapReceiver<DOMNode>(receiver);
+    return node && dom_node_haschildnodes(node) != 0;
+}
+
+bool NodeWrapper::FastContains(v8::Local<v8::Object> receiver,
+                               v8::Local<v8::Value> other,
+                               v8::FastApiCallbackOptions& options) {
+    DOMNode* node = UnwrapReceiver<DOMNode>(receiver);
+    if (!node || other->IsNullOrUndefined()) {
+        return false;
+    }
+    
+    // Same TypeError as the slow path
+    if (!other->IsObject()) {
+        v8::Isolate* isolate = options.isolate;
+        v8::HandleScope handle_scope(isolate);
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Argument must be a Node")));
+        return false;
+    }
+    
+    DOMNode* other_node = NodeWrapper::Unwrap(other.As<v8::Object>());
+    return other_node && dom_node_contains(node, other_node) != 0;
+}
+
+bool NodeWrapper::FastIsSameNode(v8::Local<v8::Object> receiver,
+                                 v8::Local<v8::Value> other) {
+    DOMNode* node = UnwrapReceiver<DOMNode>(receiver);
+    if (!node || !other->IsObject()) {
+        return false;
+    }
+    
+    DOMNode* other_node = NodeWrapper::Unwrap(other.As<v8::Object>());
+    return other_node && dom_node_issamenode(node, other_node) != 0;
+}
+
+uint32_t NodeWrapper::FastCompareDocumentPosition(v8::Local<v8::Object> receiver,
+                                                  v8::Local<v8::Value> other,
+                                                  v8::FastApiCallbackOptions& options) {
+    DOMNode* node = UnwrapReceiver<DOMNode>(receiver);
+    DOMNode* other_node = other->IsObject() ? NodeWrapper::Unwrap(other.As<v8::Object>()) : nullptr;
+    
+    // Same TypeError as the slow path (the signature has checked the receiver)
+    if (!node || !other_node) {
+        v8::Isolate* isolate = options.isolate;
+        v8::HandleScope handle_scope(isolate);
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Argument must be a Node")));
+        return 0;
+    }
+    
+    return dom_node_comparedocumentposition(node, other_node);
+}
+
 // ============================================================================
 // Method Implementations - Other
 // ============================================================================
 
 void NodeWrapper::Normalize(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("NodeWrapper::Normalize");
     v8::Isolate* isolate = args.GetIsolate();
-    DOMNode* node = Unwrap(args.This());
+    DOMNode* node = UnwrapReceiver<DOMNode>(args);
     if (!node) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Node")));
         return;
     }
     
@@ -772,4 +1156,163 @@ void NodeWrapper::Normalize(const v8::FunctionCallbackInfo<v8::Value>& args) {
 
 }
 
+void NodeWrapper::Snapshot(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("NodeWrapper::Snapshot");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMNode* node = UnwrapReceiver<DOMNode>(args);
+    if (!node) {
+        return;
+    }
+    
+    // Optional flags argument, default: names and text
+    uint32_t flags = DOM_SNAPSHOT_INCLUDE_NAMES | DOM_SNAPSHOT_INCLUDE_TEXT;
+    if (args.Length() >= 1 && !args[0]->IsUndefined()) {
+        v8::Maybe<uint32_t> maybeFlags = args[0]->Uint32Value(isolate->GetCurrentContext());
+        if (maybeFlags.IsNothing()) {
+            return;  // Exception pending
+        }
+        flags = maybeFlags.ToChecked();
+    }
+    
+    DOMSnapshotBuffer snapshot;
+    int32_t err = dom_node_snapshot_subtree(node, flags, &snapshot);
+    if (err != 0) {
+        ThrowDOMException(isolate, err);
+        return;
+    }
+    
+    // Hand the Zig allocation to the ArrayBuffer without copying
+    std::unique_ptr<v8::BackingStore> store = v8::ArrayBuffer::NewBackingStore(
+        snapshot.data, snapshot.length,
+        [](void* data, size_t length, void*) {
+            dom_snapshot_free(static_cast<uint8_t*>(data), length);
+        },
+        nullptr);
+    args.GetReturnValue().Set(v8::ArrayBuffer::New(isolate, std::move(store)));
+}
+
+void NodeWrapper::Prewrap(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("NodeWrapper::Prewrap");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMNode* node = UnwrapReceiver<DOMNode>(args);
+    if (!node) {
+        return;
+    }
+    
+    // Optional maximum number of wrappers, default: the whole subtree
+    size_t max = static_cast<size_t>(-1);
+    if (args.Length() >= 1 && !args[0]->IsUndefined()) {
+        v8::Maybe<uint32_t> maybeMax = args[0]->Uint32Value(isolate->GetCurrentContext());
+        if (maybeMax.IsNothing()) {
+            return;  // Exception pending
+        }
+        max = maybeMax.ToChecked();
+    }
+    
+    size_t created = PrewrapSubtree(isolate, isolate->GetCurrentContext(), node, max);
+    args.GetReturnValue().Set(static_cast<double>(created));
+}
+
+void NodeWrapper::Diff(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("NodeWrapper::Diff");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMNode* node = UnwrapReceiver<DOMNode>(args);
+    if (!node) {
+        return;
+    }
+    
+    if (args.Length() < 1 || !args[0]->IsObject()) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "__diff requires a Node argument")));
+        return;
+    }
+    DOMNode* other = NodeWrapper::Unwrap(args[0].As<v8::Object>());
+    if (!other) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Argument must be a Node")));
+        return;
+    }
+    
+    // Optional key attribute name, default: match children by position
+    std::string keyName;
+    const char* key = nullptr;
+    if (args.Length() >= 2 && !args[1]->IsNullOrUndefined()) {
+        v8::String::Utf8Value keyValue(isolate, args[1]);
+        if (!*keyValue) {
+            return;  // Exception pending
+        }
+        keyName.assign(*keyValue, keyValue.length());
+        key = keyName.c_str();
+    }
+    
+    DOMSnapshotBuffer patch;
+    int32_t err = dom_node_diff(node, other, key, &patch);
+    if (err != 0) {
+        ThrowDOMException(isolate, err);
+        return;
+    }
+    
+    // Hand the Zig allocation to the ArrayBuffer without copying
+    std::unique_ptr<v8::BackingStore> store = v8::ArrayBuffer::NewBackingStore(
+        patch.data, patch.length,
+        [](void* data, size_t length, void*) {
+            dom_patch_free(static_cast<uint8_t*>(data), length);
+        },
+        nullptr);
+    args.GetReturnValue().Set(v8::ArrayBuffer::New(isolate, std::move(store)));
+}
+
+void NodeWrapper::Serialize(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("NodeWrapper::Serialize");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMNode* node = UnwrapReceiver<DOMNode>(args);
+    if (!node) {
+        return;
+    }
+    
+    uint32_t flags;
+    if (!SerializeFlagsArg(args, 0, &flags)) return;
+    
+    MarkupSink sink;
+    dom_node_serialize(node, flags, MarkupSink::Append, &sink);
+    
+    v8::Local<v8::String> str;
+    if (OwnedUtf8ToV8String(isolate, std::move(sink.data), sink.ascii).ToLocal(&str)) {
+        args.GetReturnValue().Set(str);
+    }
+}
+
+void NodeWrapper::SerializeInto(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("NodeWrapper::SerializeInto");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMNode* node = UnwrapReceiver<DOMNode>(args);
+    if (!node) {
+        return;
+    }
+    
+    // Fill the caller's buffer in place
+    uint8_t* data = nullptr;
+    size_t capacity = 0;
+    if (args.Length() > 0 && args[0]->IsArrayBufferView()) {
+        v8::Local<v8::ArrayBufferView> view = args[0].As<v8::ArrayBufferView>();
+        data = static_cast<uint8_t*>(view->Buffer()->GetBackingStore()->Data()) + view->ByteOffset();
+        capacity = view->ByteLength();
+    } else if (args.Length() > 0 && args[0]->IsArrayBuffer()) {
+        std::shared_ptr<v8::BackingStore> store = args[0].As<v8::ArrayBuffer>()->GetBackingStore();
+        data = static_cast<uint8_t*>(store->Data());
+        capacity = store->ByteLength();
+    } else {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Argument must be an ArrayBuffer or ArrayBufferView")));
+        return;
+    }
+    
+    uint32_t flags;
+    if (!SerializeFlagsArg(args, 1, &flags)) return;
+    
+    // The full length: larger than the buffer when only a prefix fit
+    size_t length = dom_node_serialize_into(node, flags, data, capacity);
+    args.GetReturnValue().Set(static_cast<double>(length));
+}
+
 } // namespace v8_dom
@@ -9,21 +9,47 @@
 #define V8_DOM_NODE_WRAPPER_H
 
 #include <v8.h>
+#include <v8-fast-api-calls.h>
+#include "../core/wrapper_traits.h"
+#include "../core/external_references.h"
+#include "../core/property_table.h"
 #include "eventtarget_wrapper.h"
 #include "dom.h"
 
 namespace v8_dom {
 
+/**
+ * The nodeType script sees for a C nodeType: shadow roots are
+ * DocumentFragments (DOM_SHADOW_ROOT_NODE is internal to the library).
+ */
+inline uint16_t ScriptNodeType(uint16_t type) {
+    return type == DOM_SHADOW_ROOT_NODE ? DOM_DOCUMENT_FRAGMENT_NODE : type;
+}
+
 class NodeWrapper : public EventTargetWrapper {
 public:
     /**
      * Wrap a C DOMNode pointer in a V8 object.
      * Uses wrapper cache for identity preservation.
+     * New wrappers are created from the template matching the node's
+     * nodeType (Element, Text, Comment, Document, ...), not the generic
+     * Node template.
      */
     static v8::Local<v8::Object> Wrap(v8::Isolate* isolate,
                                       v8::Local<v8::Context> context,
                                       DOMNode* obj);
     
+    /**
+     * Create the wrappers of up to max descendants of root that have none.
+     * See v8_dom::PrewrapSubtree().
+     *
+     * @return Number of wrappers created
+     */
+    static size_t PrewrapSubtree(v8::Isolate* isolate,
+                                 v8::Local<v8::Context> context,
+                                 DOMNode* root,
+                                 size_t max);
+    
     /**
      * Unwrap a V8 object to get the C DOMNode pointer.
      */
@@ -42,12 +68,25 @@ public:
     /**
      * Template cache index.
      */
-    static constexpr int kTemplateIndex = 1;
+    static constexpr int kTemplateIndex = WrapperTraits<NodeWrapper>::kTemplateIndex;
+    
+    /**
+     * Type tag stored in the wrapper's type internal field.
+     */
+    static const WrapperTypeInfo kTypeInfo;
+    
+    /**
+     * Register this wrapper's callbacks for snapshot serialization.
+     */
+    static void RegisterExternalReferences(ExternalReferenceRegistry* registry);
     
 private:
+    // Prototype members, installed by InstallTemplate()
+    static const PropertyDescriptor kProperties[];
+    
     // Readonly properties
-    static void NodeTypeGetter(v8::Local<v8::Name> property,
-                               const v8::PropertyCallbackInfo<v8::Value>& info);
+    // nodeType and isConnected are accessor properties with Fast API getters
+    static void NodeTypeGetter(const v8::FunctionCallbackInfo<v8::Value>& args);
     static void NodeNameGetter(v8::Local<v8::Name> property,
                                const v8::PropertyCallbackInfo<v8::Value>& info);
     static void ParentNodeGetter(v8::Local<v8::Name> property,
@@ -64,8 +103,8 @@ private:
                                   const v8::PropertyCallbackInfo<v8::Value>& info);
     static void OwnerDocumentGetter(v8::Local<v8::Name> property,
                                     const v8::PropertyCallbackInfo<v8::Value>& info);
-    static void IsConnectedGetter(v8::Local<v8::Name> property,
-                                  const v8::PropertyCallbackInfo<v8::Value>& info);
+    static void IsConnectedGetter(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void IdGetter(const v8::FunctionCallbackInfo<v8::Value>& args);
     
     // Read/write properties
     static void NodeValueGetter(v8::Local<v8::Name> property,
@@ -90,11 +129,38 @@ private:
     static void GetRootNode(const v8::FunctionCallbackInfo<v8::Value>& args);
     static void HasChildNodes(const v8::FunctionCallbackInfo<v8::Value>& args);
     static void Contains(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void CompareDocumentPosition(const v8::FunctionCallbackInfo<v8::Value>& args);
     static void IsSameNode(const v8::FunctionCallbackInfo<v8::Value>& args);
     static void IsEqualNode(const v8::FunctionCallbackInfo<v8::Value>& args);
     
+    // Fast API variants, called directly from optimized code
+    static uint32_t FastNodeType(v8::Local<v8::Object> receiver);
+    static bool FastIsConnected(v8::Local<v8::Object> receiver);
+    static bool FastHasChildNodes(v8::Local<v8::Object> receiver);
+    static bool FastContains(v8::Local<v8::Object> receiver,
+                             v8::Local<v8::Value> other,
+                             v8::FastApiCallbackOptions& options);
+    static bool FastIsSameNode(v8::Local<v8::Object> receiver,
+                               v8::Local<v8::Value> other);
+    static uint32_t FastCompareDocumentPosition(v8::Local<v8::Object> receiver,
+                                                v8::Local<v8::Value> other,
+                                                v8::FastApiCallbackOptions& options);
+    static const v8::CFunction kFastNodeType;
+    static const v8::CFunction kFastIsConnected;
+    static const v8::CFunction kFastHasChildNodes;
+    static const v8::CFunction kFastContains;
+    static const v8::CFunction kFastIsSameNode;
+    static const v8::CFunction kFastCompareDocumentPosition;
+    static uint32_t FastId(v8::Local<v8::Object> receiver);
+    static const v8::CFunction kFastId;
+    
     // Methods - Other
     static void Normalize(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void Snapshot(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void Prewrap(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void Diff(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void Serialize(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void SerializeInto(const v8::FunctionCallbackInfo<v8::Value>& args);
 };
 
 } // namespace v8_dom
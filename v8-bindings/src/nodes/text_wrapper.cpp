@@ -1,76 +1,52 @@
 #include "text_wrapper.h"
+#include <memory>
 #include "../wrapper_cache.h"
 #include "../core/template_cache.h"
 #include "../core/utilities.h"
+#include "cdatasection_wrapper.h"
 
 namespace v8_dom {
 
+const WrapperTypeInfo TextWrapper::kTypeInfo = {"Text", &CharacterDataWrapper::kTypeInfo};
+
+namespace {
+
+// wholeText up to this many bytes is read without allocating
+constexpr size_t kInlineWholeTextCapacity = 256;
+
+} // namespace
+
 v8::Local<v8::Object> TextWrapper::Wrap(v8::Isolate* isolate,
                                               v8::Local<v8::Context> context,
                                               DOMText* obj) {
-    if (!obj) {
-        return v8::Local<v8::Object>();
+    // CDATASection derives from Text: wrap those with their own template
+    if (obj && dom_node_get_nodetype((DOMNode*)obj) == DOM_CDATA_SECTION_NODE) {
+        return CDATASectionWrapper::Wrap(isolate, context, (DOMCDATASection*)obj);
     }
-    
-    // Check wrapper cache first
-    WrapperCache* cache = WrapperCache::ForIsolate(isolate);
-    if (cache->Has(obj)) {
-        return cache->Get(isolate, obj);
-    }
-    
-    // Create new wrapper
-    v8::EscapableHandleScope handle_scope(isolate);
-    v8::Local<v8::FunctionTemplate> tmpl = GetTemplate(isolate);
-    v8::Local<v8::Function> constructor = tmpl->GetFunction(context).ToLocalChecked();
-    v8::Local<v8::Object> wrapper = constructor->NewInstance(context).ToLocalChecked();
-    
-    // Store C pointer in internal field
-    wrapper->SetInternalField(0, v8::External::New(isolate, obj));
-    
-    // Increment C-side reference count (Text inherits from Node)
-    dom_node_addref((DOMNode*)obj);
-    
-    // Cache with release callback
-    cache->Set(isolate, obj, wrapper, [](void* ptr) {
-        dom_node_release((DOMNode*)static_cast<DOMText*>(ptr));
-    });
-    
-    return handle_scope.Escape(wrapper);
+    return WrapWithTraits<TextWrapper>(isolate, context, obj);
 }
 
 DOMText* TextWrapper::Unwrap(v8::Local<v8::Object> obj) {
-    if (obj.IsEmpty() || obj->InternalFieldCount() < 1) {
-        return nullptr;
-    }
-    
-    v8::Local<v8::Data> data = obj->GetInternalField(0);
-    v8::Local<v8::Value> ptr = data.As<v8::Value>();
-    if (ptr.IsEmpty()) return nullptr;
-    if (!ptr->IsExternal()) {
-        return nullptr;
-    }
-    
-    return static_cast<DOMText*>(v8::Local<v8::External>::Cast(ptr)->Value());
+    return UnwrapWithTraits<TextWrapper>(obj);
 }
 
+const PropertyDescriptor TextWrapper::kProperties[] = {
+    // Readonly property
+    DataProperty("wholeText", WholeTextGetter),
+    
+    // Methods
+    MethodProperty("splitText", SplitText),
+};
+
 void TextWrapper::InstallTemplate(v8::Isolate* isolate) {
     v8::Local<v8::FunctionTemplate> tmpl = v8::FunctionTemplate::New(isolate);
     tmpl->SetClassName(v8::String::NewFromUtf8Literal(isolate, "Text"));
-    tmpl->InstanceTemplate()->SetInternalFieldCount(1);
+    tmpl->InstanceTemplate()->SetInternalFieldCount(kWrapperFieldCount);
     
     // Inherit from CharacterData
     tmpl->Inherit(CharacterDataWrapper::GetTemplate(isolate));
 
-    // Get prototype template for adding properties/methods
-    v8::Local<v8::ObjectTemplate> proto = tmpl->PrototypeTemplate();
-    
-    // Readonly property
-    proto->SetNativeDataProperty(v8::String::NewFromUtf8Literal(isolate, "wholeText"),
-                                 WholeTextGetter);
-    
-    // Methods
-    proto->Set(v8::String::NewFromUtf8Literal(isolate, "splitText"),
-               v8::FunctionTemplate::New(isolate, SplitText));
+    InstallProperties(isolate, tmpl, kProperties);
     
     // Cache the template
     TemplateCache* cache = TemplateCache::ForIsolate(isolate);
@@ -87,10 +63,15 @@ v8::Local<v8::FunctionTemplate> TextWrapper::GetTemplate(v8::Isolate* isolate) {
     return cache->Get(kTemplateIndex);
 }
 
+void TextWrapper::RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+    RegisterProperties(registry, kProperties);
+}
+
 // ===== Property Getter =====
 
 void TextWrapper::WholeTextGetter(v8::Local<v8::Name> property,
                                  const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("TextWrapper::WholeTextGetter");
     v8::Isolate* isolate = info.GetIsolate();
     DOMText* text = Unwrap(info.This());
     
@@ -100,25 +81,30 @@ void TextWrapper::WholeTextGetter(v8::Local<v8::Name> property,
         return;
     }
     
-    const char* wholeText = dom_text_get_wholetext(text);
-    if (wholeText) {
-        info.GetReturnValue().Set(v8::String::NewFromUtf8(isolate, wholeText).ToLocalChecked());
-        dom_text_free_wholetext(wholeText);
-    } else {
-        info.GetReturnValue().SetEmptyString();
+    // Short runs are written straight into a stack buffer; the same call
+    // measures longer ones, which are written again into a heap buffer
+    char inline_buffer[kInlineWholeTextCapacity];
+    std::unique_ptr<char[]> heap_buffer;
+    const char* data = inline_buffer;
+    size_t length = dom_text_get_wholetext_into(text, inline_buffer, sizeof(inline_buffer));
+    if (length > sizeof(inline_buffer)) {
+        heap_buffer.reset(new char[length]);
+        dom_text_get_wholetext_into(text, heap_buffer.get(), length);
+        data = heap_buffer.get();
     }
+    info.GetReturnValue().Set(v8::String::NewFromUtf8(isolate, data, v8::NewStringType::kNormal,
+                                                      static_cast<int>(length)).ToLocalChecked());
 }
 
 // ===== Methods =====
 
 void TextWrapper::SplitText(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("TextWrapper::SplitText");
     v8::Isolate* isolate = args.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     
-    DOMText* text = Unwrap(args.This());
+    DOMText* text = UnwrapReceiver<DOMText>(args);
     if (!text) {
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8Literal(isolate, "Invalid Text object")));
         return;
     }
     
@@ -9,6 +9,9 @@
 #define V8_DOM_TEXT_WRAPPER_H
 
 #include <v8.h>
+#include "../core/wrapper_traits.h"
+#include "../core/external_references.h"
+#include "../core/property_table.h"
 #include "characterdata_wrapper.h"
 #include "dom.h"
 
@@ -42,9 +45,22 @@ public:
     /**
      * Template cache index.
      */
-    static constexpr int kTemplateIndex = 6;
+    static constexpr int kTemplateIndex = WrapperTraits<TextWrapper>::kTemplateIndex;
+    
+    /**
+     * Type tag stored in the wrapper's type internal field.
+     */
+    static const WrapperTypeInfo kTypeInfo;
+    
+    /**
+     * Register this wrapper's callbacks for snapshot serialization.
+     */
+    static void RegisterExternalReferences(ExternalReferenceRegistry* registry);
     
 private:
+    // Prototype members, installed by InstallTemplate()
+    static const PropertyDescriptor kProperties[];
+    
     // Readonly property
     static void WholeTextGetter(v8::Local<v8::Name> property,
                                const v8::PropertyCallbackInfo<v8::Value>& info);
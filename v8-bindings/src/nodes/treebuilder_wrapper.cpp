@@ -0,0 +1,136 @@
+#include "treebuilder_wrapper.h"
+#include "documentfragment_wrapper.h"
+#include "../wrapper_cache.h"
+#include "../core/template_cache.h"
+#include "../core/utilities.h"
+
+namespace v8_dom {
+
+const WrapperTypeInfo TreeBuilderWrapper::kTypeInfo = {"TreeBuilder", nullptr};
+
+v8::MaybeLocal<v8::Object> TreeBuilderWrapper::Create(v8::Isolate* isolate,
+                                                      v8::Local<v8::Context> context,
+                                                      DOMDocument* doc) {
+    v8::EscapableHandleScope handle_scope(isolate);
+
+    DOMTreeBuilder* builder = dom_builder_new(doc);
+    if (!builder) {
+        isolate->ThrowException(v8::Exception::Error(
+            v8::String::NewFromUtf8Literal(isolate, "Failed to create tree builder")));
+        return v8::MaybeLocal<v8::Object>();
+    }
+
+    v8::Local<v8::Function> constructor =
+        TemplateCache::ForIsolate(isolate)->GetConstructor(context, kTemplateIndex, GetTemplate);
+    v8::Local<v8::Object> wrapper = constructor->NewInstance(context).ToLocalChecked();
+    SetWrapperFields(wrapper, builder, &kTypeInfo);
+
+    WrapperCache::ForIsolate(isolate)->Set(isolate, builder, wrapper, [](void* ptr) {
+        dom_builder_release(static_cast<DOMTreeBuilder*>(ptr));
+    });
+
+    return handle_scope.Escape(wrapper);
+}
+
+DOMTreeBuilder* TreeBuilderWrapper::Unwrap(v8::Local<v8::Object> obj) {
+    return static_cast<DOMTreeBuilder*>(UnwrapObject(obj, &kTypeInfo));
+}
+
+namespace {
+
+constexpr ConstantDescriptor kOpcodeConstants[] = {
+    {"OPEN", DOM_BUILDER_OPEN},
+    {"TEXT", DOM_BUILDER_TEXT},
+    {"CLOSE", DOM_BUILDER_CLOSE},
+};
+
+} // namespace
+
+const PropertyDescriptor TreeBuilderWrapper::kProperties[] = {
+    MethodProperty("write", Write),
+    MethodProperty("finish", Finish),
+};
+
+void TreeBuilderWrapper::InstallTemplate(v8::Isolate* isolate) {
+    v8::Local<v8::FunctionTemplate> tmpl = v8::FunctionTemplate::New(isolate);
+    tmpl->SetClassName(v8::String::NewFromUtf8Literal(isolate, "TreeBuilder"));
+    tmpl->InstanceTemplate()->SetInternalFieldCount(kWrapperFieldCount);
+
+    // Instruction opcodes
+    InstallConstants(isolate, tmpl, kOpcodeConstants);
+
+    InstallProperties(isolate, tmpl, kProperties);
+
+    // Cache the template
+    TemplateCache* cache = TemplateCache::ForIsolate(isolate);
+    cache->Set(kTemplateIndex, tmpl);
+}
+
+v8::Local<v8::FunctionTemplate> TreeBuilderWrapper::GetTemplate(v8::Isolate* isolate) {
+    TemplateCache* cache = TemplateCache::ForIsolate(isolate);
+
+    if (!cache->Has(kTemplateIndex)) {
+        InstallTemplate(isolate);
+    }
+
+    return cache->Get(kTemplateIndex);
+}
+
+void TreeBuilderWrapper::RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+    RegisterProperties(registry, kProperties);
+}
+
+// ============================================================================
+// Methods
+// ============================================================================
+
+void TreeBuilderWrapper::Write(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("TreeBuilderWrapper::Write");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMTreeBuilder* builder = UnwrapReceiver<DOMTreeBuilder>(args);
+    if (!builder) return;
+
+    // Run the chunk in place, without copying it out of its buffer
+    const uint8_t* data = nullptr;
+    size_t length = 0;
+    if (args.Length() > 0 && args[0]->IsArrayBufferView()) {
+        v8::Local<v8::ArrayBufferView> view = args[0].As<v8::ArrayBufferView>();
+        data = static_cast<const uint8_t*>(view->Buffer()->GetBackingStore()->Data()) + view->ByteOffset();
+        length = view->ByteLength();
+    } else if (args.Length() > 0 && args[0]->IsArrayBuffer()) {
+        std::shared_ptr<v8::BackingStore> store = args[0].As<v8::ArrayBuffer>()->GetBackingStore();
+        data = static_cast<const uint8_t*>(store->Data());
+        length = store->ByteLength();
+    } else {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Argument must be an ArrayBuffer or ArrayBufferView")));
+        return;
+    }
+
+    if (length == 0) return;
+    int32_t err = dom_builder_write(builder, data, length);
+    if (err != 0) {
+        ThrowDOMException(isolate, err);
+    }
+}
+
+void TreeBuilderWrapper::Finish(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("TreeBuilderWrapper::Finish");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMTreeBuilder* builder = UnwrapReceiver<DOMTreeBuilder>(args);
+    if (!builder) return;
+
+    DOMDocumentFragment* fragment = dom_builder_finish(builder);
+    if (!fragment) {
+        isolate->ThrowException(v8::Exception::Error(
+            v8::String::NewFromUtf8Literal(isolate, "Failed to finish tree")));
+        return;
+    }
+
+    // The wrapper takes its own reference
+    v8::Local<v8::Object> wrapper = DocumentFragmentWrapper::Wrap(isolate, isolate->GetCurrentContext(), fragment);
+    dom_documentfragment_release(fragment);
+    args.GetReturnValue().Set(wrapper);
+}
+
+} // namespace v8_dom
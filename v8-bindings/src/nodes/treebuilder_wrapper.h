@@ -0,0 +1,78 @@
+/**
+ * TreeBuilder Wrapper - Chunked tree construction for script
+ *
+ * Non-standard. document.createTreeBuilder() returns a builder that takes
+ * encoded instruction chunks and produces a DocumentFragment:
+ *
+ *   builder.write(chunk)   Run a chunk (Uint8Array, any ArrayBufferView
+ *                          or ArrayBuffer) of encoded instructions
+ *   builder.finish()       Close open elements, return the fragment
+ *   builder.OPEN, TEXT, CLOSE   Instruction opcodes
+ *
+ * Each chunk is one C-ABI call however many nodes it builds (see
+ * dom_builder_write() for the encoding), and inserting the fragment is one
+ * insertion.
+ */
+
+#ifndef V8_DOM_TREEBUILDER_WRAPPER_H
+#define V8_DOM_TREEBUILDER_WRAPPER_H
+
+#include <v8.h>
+#include "../core/wrapper_traits.h"
+#include "../core/external_references.h"
+#include "../core/property_table.h"
+#include "dom.h"
+
+namespace v8_dom {
+
+class TreeBuilderWrapper {
+public:
+    /**
+     * Create a builder object for a document.
+     */
+    static v8::MaybeLocal<v8::Object> Create(v8::Isolate* isolate,
+                                             v8::Local<v8::Context> context,
+                                             DOMDocument* doc);
+
+    /**
+     * Unwrap a V8 object to get the C builder.
+     */
+    static DOMTreeBuilder* Unwrap(v8::Local<v8::Object> obj);
+
+    /**
+     * Install the TreeBuilder template (called once per isolate).
+     */
+    static void InstallTemplate(v8::Isolate* isolate);
+
+    /**
+     * Get the cached TreeBuilder template.
+     */
+    static v8::Local<v8::FunctionTemplate> GetTemplate(v8::Isolate* isolate);
+
+    /**
+     * Template cache index.
+     */
+    static constexpr int kTemplateIndex = WrapperTraits<TreeBuilderWrapper>::kTemplateIndex;
+
+    /**
+     * Type tag stored in the wrapper's type internal field.
+     */
+    static const WrapperTypeInfo kTypeInfo;
+
+    /**
+     * Register this wrapper's callbacks for snapshot serialization.
+     */
+    static void RegisterExternalReferences(ExternalReferenceRegistry* registry);
+
+private:
+    // Prototype members, installed by InstallTemplate()
+    static const PropertyDescriptor kProperties[];
+    
+    // Methods
+    static void Write(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void Finish(const v8::FunctionCallbackInfo<v8::Value>& args);
+};
+
+} // namespace v8_dom
+
+#endif // V8_DOM_TREEBUILDER_WRAPPER_H
@@ -0,0 +1,45 @@
+#include "mutation_observer_queue.h"
+#include <algorithm>
+#include "mutationobserver_wrapper.h"
+#include "../core/binding_state.h"
+
+namespace v8_dom {
+
+void MutationObserverQueue::Schedule(v8::Isolate* isolate, ScriptObserver* observer) {
+    if (observer->delivery_queued) {
+        return;
+    }
+    observer->delivery_queued = true;
+    pending_.push_back(observer);
+
+    if (!microtask_queued_) {
+        microtask_queued_ = true;
+        isolate->EnqueueMicrotask(Notify, isolate);
+    }
+}
+
+void MutationObserverQueue::Notify(void* data) {
+    v8::Isolate* isolate = static_cast<v8::Isolate*>(data);
+    // The bindings may have been disposed since the microtask was queued
+    BindingState* state = BindingState::TryForIsolate(isolate);
+    if (!state) {
+        return;
+    }
+    state->MutationObservers()->DeliverPending();
+}
+
+void MutationObserverQueue::DeliverPending() {
+    // Observers that get records from here on queue the next microtask
+    microtask_queued_ = false;
+
+    std::vector<ScriptObserver*> observers;
+    observers.swap(pending_);
+    std::sort(observers.begin(), observers.end(),
+              [](const ScriptObserver* a, const ScriptObserver* b) { return a->order < b->order; });
+
+    for (ScriptObserver* observer : observers) {
+        MutationObserverWrapper::Deliver(observer);
+    }
+}
+
+} // namespace v8_dom
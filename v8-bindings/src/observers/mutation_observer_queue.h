@@ -0,0 +1,71 @@
+/**
+ * Mutation Observer Queue - The isolate's "notify mutation observers" microtask
+ *
+ * Spec (DOM §4.3.1): the agent has one "mutation observer microtask queued"
+ * flag. The first observer to get records since the last delivery queues a
+ * single microtask; that microtask delivers every pending observer in
+ * creation order, one callback call each. A burst of mutations seen by N
+ * observers costs one microtask, not one per observer or per record.
+ *
+ * Callbacks that mutate the DOM again queue a new microtask for the
+ * observers they touch, which runs in the same microtask checkpoint.
+ *
+ * Owned by BindingState. Delivery of one observer is
+ * MutationObserverWrapper::Deliver.
+ */
+
+#ifndef V8_DOM_MUTATION_OBSERVER_QUEUE_H
+#define V8_DOM_MUTATION_OBSERVER_QUEUE_H
+
+#include <v8.h>
+#include <cstdint>
+#include <vector>
+
+namespace v8_dom {
+
+struct ScriptObserver;
+
+class MutationObserverQueue {
+public:
+    MutationObserverQueue() = default;
+
+    /**
+     * Creation order for a new observer (delivery follows it).
+     */
+    uint64_t NextObserverOrder() { return next_order_++; }
+
+    /**
+     * Mark an observer as having records and queue the microtask if it is
+     * not queued yet. The observer must stay alive until delivered (script
+     * observers hold their wrapper strongly while delivery_queued is set).
+     */
+    void Schedule(v8::Isolate* isolate, ScriptObserver* observer);
+
+    /**
+     * Number of observers waiting for the next delivery.
+     */
+    size_t PendingCount() const { return pending_.size(); }
+
+private:
+    // Non-copyable, non-movable
+    MutationObserverQueue(const MutationObserverQueue&) = delete;
+    MutationObserverQueue& operator=(const MutationObserverQueue&) = delete;
+
+    /**
+     * Microtask; data is the isolate (the queue may be gone by then).
+     */
+    static void Notify(void* data);
+
+    /**
+     * Deliver every pending observer.
+     */
+    void DeliverPending();
+
+    std::vector<ScriptObserver*> pending_;
+    uint64_t next_order_ = 0;
+    bool microtask_queued_ = false;
+};
+
+} // namespace v8_dom
+
+#endif // V8_DOM_MUTATION_OBSERVER_QUEUE_H
@@ -1,72 +1,92 @@
 #include "mutationobserver_wrapper.h"
+#include <memory>
+#include <string>
+#include <vector>
+#include "mutationrecord_wrapper.h"
+#include "mutationrecordbatch_wrapper.h"
+#include "../nodes/node_wrapper.h"
 #include "../wrapper_cache.h"
 #include "../core/template_cache.h"
+#include "../core/binding_state.h"
 #include "../core/utilities.h"
 
 namespace v8_dom {
 
-v8::Local<v8::Object> MutationObserverWrapper::Wrap(v8::Isolate* isolate,
-                                              v8::Local<v8::Context> context,
-                                              DOMMutationObserver* obj) {
-    if (!obj) {
-        return v8::Local<v8::Object>();
-    }
-    
-    // Check wrapper cache first
-    WrapperCache* cache = WrapperCache::ForIsolate(isolate);
-    if (cache->Has(obj)) {
-        return cache->Get(isolate, obj);
-    }
-    
-    // Create new wrapper
-    v8::EscapableHandleScope handle_scope(isolate);
-    v8::Local<v8::FunctionTemplate> tmpl = GetTemplate(isolate);
-    v8::Local<v8::Function> constructor = tmpl->GetFunction(context).ToLocalChecked();
-    v8::Local<v8::Object> wrapper = constructor->NewInstance(context).ToLocalChecked();
-    
-    // Store C pointer in internal field
-    wrapper->SetInternalField(0, v8::External::New(isolate, obj));
-    
-    // Increment C-side reference count
-    dom_mutationobserver_addref(obj);
-    
-    // Cache with release callback
-    cache->Set(isolate, obj, wrapper, [](void* ptr) {
-        dom_mutationobserver_release(static_cast<DOMMutationObserver*>(ptr));
-    });
-    
-    return handle_scope.Escape(wrapper);
-}
+const WrapperTypeInfo MutationObserverWrapper::kTypeInfo = {"MutationObserver", nullptr};
+
+namespace {
 
-DOMMutationObserver* MutationObserverWrapper::Unwrap(v8::Local<v8::Object> obj) {
-    if (obj.IsEmpty() || obj->InternalFieldCount() < 1) {
-        return nullptr;
+/**
+ * The C-ABI callback slot; script observers deliver through Deliver().
+ */
+void IgnoreRecords(DOMMutationRecord**, uint32_t, DOMMutationObserver*, void*) {}
+
+/**
+ * Take the pending records as the callback (or takeRecords()) sees them:
+ * an array of MutationRecords, or a MutationRecordBatch with as_batch.
+ * Returns false (with nothing pending or on allocation failure) if there
+ * is nothing to deliver.
+ */
+bool TakePending(v8::Isolate* isolate, v8::Local<v8::Context> context,
+                 ScriptObserver* state, bool as_batch, v8::Local<v8::Value>* out) {
+    std::shared_ptr<RecordBatch> batch = RecordBatch::Take(state->observer);
+    if (!batch || batch->count == 0) {
+        return false;
+    }
+    if (as_batch) {
+        *out = MutationRecordBatchWrapper::Wrap(isolate, context, batch);
+    } else {
+        *out = MutationRecordWrapper::WrapAll(isolate, context, batch);
     }
-    
-    v8::Local<v8::Value> ptr = obj->GetInternalField(0).As<v8::Value>();
-    if (!ptr->IsExternal()) {
-        return nullptr;
+    return true;
+}
+
+/**
+ * C-ABI notification: the record queue became non-empty. Runs inside the
+ * DOM mutation, so it only schedules the delivery.
+ */
+void NotifyRecords(DOMMutationObserver*, void* context) {
+    ScriptObserver* state = static_cast<ScriptObserver*>(context);
+    BindingState::ForIsolate(state->isolate)->MutationObservers()->Schedule(state->isolate, state);
+}
+
+/**
+ * Read an optional MutationObserverInit boolean (255 = not present).
+ * Returns false if reading the property threw.
+ */
+bool ReadOptionalFlag(v8::Isolate* isolate, v8::Local<v8::Context> context,
+                      v8::Local<v8::Object> dict, v8::Local<v8::String> name, uint8_t* out) {
+    v8::Local<v8::Value> value;
+    if (!dict->Get(context, name).ToLocal(&value)) {
+        return false;
     }
-    
-    return static_cast<DOMMutationObserver*>(v8::Local<v8::External>::Cast(ptr)->Value());
+    *out = value->IsUndefined() ? 255 : (value->BooleanValue(isolate) ? 1 : 0);
+    return true;
 }
 
+} // namespace
+
+ScriptObserver* MutationObserverWrapper::Unwrap(v8::Local<v8::Object> obj) {
+    return static_cast<ScriptObserver*>(UnwrapObject(obj, &kTypeInfo));
+}
+
+const PropertyDescriptor MutationObserverWrapper::kProperties[] = {
+    // Methods
+    MethodProperty("observe", Observe),
+    MethodProperty("disconnect", Disconnect),
+    MethodProperty("takeRecords", TakeRecords),
+
+    // Non-standard: the record queue as one packed batch (not enumerable)
+    MethodProperty("takeRecordBatch", TakeRecordBatch, kReceiverCheck | kDontEnum),
+};
+
 void MutationObserverWrapper::InstallTemplate(v8::Isolate* isolate) {
-    v8::Local<v8::FunctionTemplate> tmpl = v8::FunctionTemplate::New(isolate);
+    v8::Local<v8::FunctionTemplate> tmpl = v8::FunctionTemplate::New(isolate, Constructor);
     tmpl->SetClassName(v8::String::NewFromUtf8Literal(isolate, "MutationObserver"));
-    tmpl->InstanceTemplate()->SetInternalFieldCount(1);
-    
-
-    // Get prototype template for adding properties/methods
-    v8::Local<v8::ObjectTemplate> proto = tmpl->PrototypeTemplate();
-    
-    // TODO: Add properties and methods here
-    // Example:
-    // proto->SetNativeDataProperty(v8::String::NewFromUtf8Literal(isolate, "propertyName"),
-    //                   PropertyNameGetter, PropertyNameSetter);
-    // proto->Set(v8::String::NewFromUtf8Literal(isolate, "methodName"),
-    //           v8::FunctionTemplate::New(isolate, MethodName));
-    
+    tmpl->InstanceTemplate()->SetInternalFieldCount(kWrapperFieldCount);
+
+    InstallProperties(isolate, tmpl, kProperties);
+
     // Cache the template
     TemplateCache* cache = TemplateCache::ForIsolate(isolate);
     cache->Set(kTemplateIndex, tmpl);
@@ -74,12 +94,235 @@ void MutationObserverWrapper::InstallTemplate(v8::Isolate* isolate) {
 
 v8::Local<v8::FunctionTemplate> MutationObserverWrapper::GetTemplate(v8::Isolate* isolate) {
     TemplateCache* cache = TemplateCache::ForIsolate(isolate);
-    
+
     if (!cache->Has(kTemplateIndex)) {
         InstallTemplate(isolate);
     }
-    
+
     return cache->Get(kTemplateIndex);
 }
 
+void MutationObserverWrapper::RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+    registry->Register(Constructor);
+    RegisterProperties(registry, kProperties);
+}
+
+// ===== Constructor =====
+
+void MutationObserverWrapper::Constructor(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("MutationObserverWrapper::Constructor");
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    if (!args.IsConstructCall()) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Failed to construct 'MutationObserver': Please use the 'new' operator")));
+        return;
+    }
+    if (args.Length() < 1 || !args[0]->IsFunction()) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "The callback provided as parameter 1 is not a function")));
+        return;
+    }
+
+    // Non-standard options: { batch: true }
+    bool batch = false;
+    if (args.Length() > 1 && args[1]->IsObject()) {
+        v8::Local<v8::Value> flag;
+        if (!args[1].As<v8::Object>()->Get(context, v8::String::NewFromUtf8Literal(isolate, "batch"))
+                 .ToLocal(&flag)) {
+            return;
+        }
+        batch = flag->BooleanValue(isolate);
+    }
+
+    DOMMutationObserver* observer = dom_mutationobserver_new(IgnoreRecords, nullptr);
+    if (!observer) {
+        isolate->ThrowException(v8::Exception::Error(
+            v8::String::NewFromUtf8Literal(isolate, "Failed to create MutationObserver")));
+        return;
+    }
+
+    v8::Local<v8::Object> wrapper = args.This();
+    ScriptObserver* state = new ScriptObserver{
+        isolate, observer,
+        v8::Global<v8::Context>(isolate, context),
+        v8::Global<v8::Function>(isolate, args[0].As<v8::Function>()),
+        v8::Global<v8::Object>(),
+        BindingState::ForIsolate(isolate)->MutationObservers()->NextObserverOrder(),
+        batch, false, false};
+    dom_mutationobserver_set_notify(observer, NotifyRecords, state);
+    SetWrapperFields(wrapper, state, &kTypeInfo);
+
+    WrapperCache::ForIsolate(isolate)->Set(isolate, state, wrapper, [](void* ptr) {
+        ScriptObserver* state = static_cast<ScriptObserver*>(ptr);
+        dom_mutationobserver_release(state->observer);
+        delete state;
+    });
+}
+
+// ===== Delivery =====
+
+void MutationObserverWrapper::Deliver(ScriptObserver* state) {
+    v8::Isolate* isolate = state->isolate;
+    v8::HandleScope handle_scope(isolate);
+    v8::Local<v8::Context> context = state->context.Get(isolate);
+    v8::Context::Scope context_scope(context);
+
+    // The local handle keeps the observer alive for this delivery
+    v8::Local<v8::Object> wrapper = state->self.Get(isolate);
+    state->delivery_queued = false;
+    if (!state->observing) {
+        state->self.Reset();
+    }
+
+    v8::Local<v8::Value> records;
+    if (!TakePending(isolate, context, state, state->batch, &records)) {
+        return;
+    }
+
+    // Exceptions are reported, not propagated
+    v8::TryCatch try_catch(isolate);
+    try_catch.SetVerbose(true);
+
+    v8::Local<v8::Value> argv[2] = {records, wrapper};
+    (void)state->callback.Get(isolate)->Call(context, wrapper, 2, argv);
+}
+
+// ===== Methods =====
+
+void MutationObserverWrapper::Observe(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("MutationObserverWrapper::Observe");
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    ScriptObserver* state = UnwrapReceiver<ScriptObserver>(args);
+    if (!state) {
+        return;
+    }
+
+    DOMNode* target = nullptr;
+    if (args.Length() > 0 && args[0]->IsObject()) {
+        target = NodeWrapper::Unwrap(args[0].As<v8::Object>());
+    }
+    if (!target) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "parameter 1 is not of type 'Node'")));
+        return;
+    }
+
+    DOMMutationObserverInit options = {0, 255, 255, 0, 255, 255, 0, nullptr};
+    std::vector<std::string> filter;
+    std::vector<const char*> filter_ptrs;
+
+    if (args.Length() > 1 && args[1]->IsObject()) {
+        v8::Local<v8::Object> dict = args[1].As<v8::Object>();
+        uint8_t child_list = 255;
+        uint8_t subtree = 255;
+        uint8_t coalesce = 255;
+        if (!ReadOptionalFlag(isolate, context, dict, v8::String::NewFromUtf8Literal(isolate, "childList"), &child_list) ||
+            !ReadOptionalFlag(isolate, context, dict, v8::String::NewFromUtf8Literal(isolate, "attributes"), &options.attributes) ||
+            !ReadOptionalFlag(isolate, context, dict, v8::String::NewFromUtf8Literal(isolate, "characterData"), &options.character_data) ||
+            !ReadOptionalFlag(isolate, context, dict, v8::String::NewFromUtf8Literal(isolate, "subtree"), &subtree) ||
+            !ReadOptionalFlag(isolate, context, dict, v8::String::NewFromUtf8Literal(isolate, "attributeOldValue"), &options.attribute_old_value) ||
+            !ReadOptionalFlag(isolate, context, dict, v8::String::NewFromUtf8Literal(isolate, "characterDataOldValue"), &options.character_data_old_value) ||
+            !ReadOptionalFlag(isolate, context, dict, v8::String::NewFromUtf8Literal(isolate, "coalesce"), &coalesce)) {
+            return;
+        }
+        // childList, subtree and (non-standard) coalesce default to false
+        options.child_list = child_list == 1 ? 1 : 0;
+        options.subtree = subtree == 1 ? 1 : 0;
+        options.coalesce = coalesce == 1 ? 1 : 0;
+
+        v8::Local<v8::Value> names;
+        if (!dict->Get(context, v8::String::NewFromUtf8Literal(isolate, "attributeFilter")).ToLocal(&names)) {
+            return;
+        }
+        if (!names->IsUndefined()) {
+            if (!names->IsArray()) {
+                isolate->ThrowException(v8::Exception::TypeError(
+                    v8::String::NewFromUtf8Literal(isolate, "attributeFilter is not a sequence")));
+                return;
+            }
+            v8::Local<v8::Array> list = names.As<v8::Array>();
+            filter.reserve(list->Length());
+            for (uint32_t i = 0; i < list->Length(); i++) {
+                v8::Local<v8::Value> name;
+                if (!list->Get(context, i).ToLocal(&name)) {
+                    return;
+                }
+                StringArgFromV8 name_arg(isolate, name);
+                filter.emplace_back(name_arg.data(), name_arg.length());
+            }
+            for (const std::string& name : filter) {
+                filter_ptrs.push_back(name.c_str());
+            }
+            filter_ptrs.push_back(nullptr);
+            options.attribute_filter = filter_ptrs.data();
+        }
+    }
+
+    int32_t err = dom_mutationobserver_observe(state->observer, target, &options);
+    if (err == DOM_ERROR_INVALID_STATE) {
+        // Invalid option combinations are a TypeError in the spec
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "The options object must set at least one of 'attributes', 'characterData', or 'childList' to true")));
+        return;
+    }
+    if (err != 0) {
+        ThrowDOMException(isolate, err);
+        return;
+    }
+
+    state->observing = true;
+    state->self.Reset(isolate, args.This());
+}
+
+void MutationObserverWrapper::Disconnect(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("MutationObserverWrapper::Disconnect");
+    ScriptObserver* state = UnwrapReceiver<ScriptObserver>(args);
+    if (!state) {
+        return;
+    }
+
+    dom_mutationobserver_disconnect(state->observer);
+    state->observing = false;
+    // A queued delivery still needs the state; it drops the handle itself
+    if (!state->delivery_queued) {
+        state->self.Reset();
+    }
+}
+
+void MutationObserverWrapper::TakeRecords(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("MutationObserverWrapper::TakeRecords");
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    ScriptObserver* state = UnwrapReceiver<ScriptObserver>(args);
+    if (!state) {
+        return;
+    }
+
+    v8::Local<v8::Value> records;
+    if (!TakePending(isolate, context, state, false, &records)) {
+        records = v8::Array::New(isolate);
+    }
+    args.GetReturnValue().Set(records);
+}
+
+void MutationObserverWrapper::TakeRecordBatch(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("MutationObserverWrapper::TakeRecordBatch");
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    ScriptObserver* state = UnwrapReceiver<ScriptObserver>(args);
+    if (!state) {
+        return;
+    }
+
+    std::shared_ptr<RecordBatch> batch = RecordBatch::Take(state->observer);
+    if (!batch) {
+        isolate->ThrowException(v8::Exception::Error(
+            v8::String::NewFromUtf8Literal(isolate, "Failed to take mutation records")));
+        return;
+    }
+    args.GetReturnValue().Set(MutationRecordBatchWrapper::Wrap(isolate, context, batch));
+}
+
 } // namespace v8_dom
@@ -1,51 +1,99 @@
 /**
  * MutationObserver Wrapper - V8 bindings for MutationObserver
- * 
- * Auto-generated wrapper for DOMMutationObserver.
- * Provides JavaScript interface for MutationObserver operations.
+ *
+ * Records are delivered from a microtask: the first record queued into an
+ * empty queue (the C-ABI pending-records notification) schedules the
+ * observer on the isolate's MutationObserverQueue, whose single microtask
+ * takes each pending observer's whole queue as one packed batch and calls
+ * its callback once. Node wrappers are created only for record fields script reads
+ * (see MutationRecordWrapper).
+ *
+ * Non-standard: new MutationObserver(callback, { batch: true }) passes the
+ * callback a MutationRecordBatch instead of an array of records, and
+ * takeRecordBatch() takes the queue as one (see MutationRecordBatchWrapper).
+ * observe(target, { ..., coalesce: true }) coalesces the registration's
+ * attribute records and adjacent childList records (see DOMMutationObserverInit).
+ *
+ * An observer that observes anything is kept alive until disconnect(),
+ * standing in for the spec's strong references from observed nodes.
  */
 
 #ifndef V8_DOM_MUTATIONOBSERVER_WRAPPER_H
 #define V8_DOM_MUTATIONOBSERVER_WRAPPER_H
 
 #include <v8.h>
+#include "../core/wrapper_traits.h"
+#include "../core/external_references.h"
+#include "../core/property_table.h"
 #include "dom.h"
 
 namespace v8_dom {
 
+/**
+ * Binding-side state of one script MutationObserver.
+ */
+struct ScriptObserver {
+    v8::Isolate* isolate;
+    DOMMutationObserver* observer;     // owned
+    v8::Global<v8::Context> context;   // the callback's realm
+    v8::Global<v8::Function> callback;
+    v8::Global<v8::Object> self;       // strong while observing or a delivery is queued
+    uint64_t order;                    // creation order, for delivery
+    bool batch;                        // deliver a MutationRecordBatch
+    bool observing;
+    bool delivery_queued;
+};
+
 class MutationObserverWrapper {
 public:
     /**
-     * Wrap a C DOMMutationObserver pointer in a V8 object.
-     * Uses wrapper cache for identity preservation.
-     */
-    static v8::Local<v8::Object> Wrap(v8::Isolate* isolate,
-                                      v8::Local<v8::Context> context,
-                                      DOMMutationObserver* obj);
-    
-    /**
-     * Unwrap a V8 object to get the C DOMMutationObserver pointer.
+     * Unwrap a V8 object to get the observer state.
      */
-    static DOMMutationObserver* Unwrap(v8::Local<v8::Object> obj);
-    
+    static ScriptObserver* Unwrap(v8::Local<v8::Object> obj);
+
     /**
      * Install the MutationObserver template (called once per isolate).
      */
     static void InstallTemplate(v8::Isolate* isolate);
-    
+
     /**
      * Get the cached MutationObserver template.
      */
     static v8::Local<v8::FunctionTemplate> GetTemplate(v8::Isolate* isolate);
-    
+
+    /**
+     * Deliver an observer's queued records to its callback (one call, none
+     * if the queue is empty). Called by MutationObserverQueue.
+     */
+    static void Deliver(ScriptObserver* state);
+
     /**
      * Template cache index.
      */
-    static constexpr int kTemplateIndex = 24;
-    
+    static constexpr int kTemplateIndex = WrapperTraits<MutationObserverWrapper>::kTemplateIndex;
+
+    /**
+     * Type tag stored in the wrapper's type internal field.
+     */
+    static const WrapperTypeInfo kTypeInfo;
+
+    /**
+     * Register this wrapper's callbacks for snapshot serialization.
+     */
+    static void RegisterExternalReferences(ExternalReferenceRegistry* registry);
+
 private:
-    // Property getters/setters and methods will be added here
-    // TODO: Parse dom.h to auto-generate these declarations
+    // Prototype members, installed by InstallTemplate()
+    static const PropertyDescriptor kProperties[];
+    
+    // Constructor
+    static void Constructor(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+    // Methods
+    static void Observe(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void Disconnect(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void TakeRecords(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void TakeRecordBatch(const v8::FunctionCallbackInfo<v8::Value>& args);
 };
 
 } // namespace v8_dom
@@ -1,72 +1,190 @@
 #include "mutationrecord_wrapper.h"
+#include <vector>
+#include "../nodes/node_wrapper.h"
 #include "../wrapper_cache.h"
 #include "../core/template_cache.h"
+#include "../core/string_cache.h"
 #include "../core/utilities.h"
 
 namespace v8_dom {
 
-v8::Local<v8::Object> MutationRecordWrapper::Wrap(v8::Isolate* isolate,
-                                              v8::Local<v8::Context> context,
-                                              DOMMutationRecord* obj) {
-    if (!obj) {
-        return v8::Local<v8::Object>();
+const WrapperTypeInfo MutationRecordWrapper::kTypeInfo = {"MutationRecord", nullptr};
+
+RecordBatch::~RecordBatch() {
+    dom_mutationbatch_release(batch);
+}
+
+std::shared_ptr<RecordBatch> RecordBatch::Take(DOMMutationObserver* observer) {
+    DOMMutationBatch* taken = dom_mutationobserver_takebatch(observer);
+    if (!taken) {
+        return nullptr;
+    }
+
+    auto batch = std::make_shared<RecordBatch>();
+    batch->batch = taken;
+    batch->count = dom_mutationbatch_get_count(taken);
+    batch->entries = dom_mutationbatch_get_entries(taken);
+    batch->node_lists = dom_mutationbatch_get_nodelists(taken, &batch->node_list_count);
+    batch->nodes = dom_mutationbatch_get_nodes(taken, &batch->node_count);
+    return batch;
+}
+
+namespace {
+
+v8::Local<v8::Private> AddedNodesKey(v8::Isolate* isolate) {
+    return v8::Private::ForApi(isolate, v8::String::NewFromUtf8Literal(isolate, "v8_dom::addedNodes"));
+}
+
+v8::Local<v8::Private> RemovedNodesKey(v8::Isolate* isolate) {
+    return v8::Private::ForApi(isolate, v8::String::NewFromUtf8Literal(isolate, "v8_dom::removedNodes"));
+}
+
+RecordRef* ThisRecord(v8::Isolate* isolate, v8::Local<v8::Value> receiver) {
+    RecordRef* record = receiver->IsObject()
+        ? MutationRecordWrapper::Unwrap(receiver.As<v8::Object>())
+        : nullptr;
+    if (!record) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Invalid MutationRecord")));
+    }
+    return record;
+}
+
+/**
+ * Return the node at a node index field, or null.
+ */
+void ReturnNodeField(const v8::PropertyCallbackInfo<v8::Value>& info, int field) {
+    v8::Isolate* isolate = info.GetIsolate();
+    RecordRef* record = ThisRecord(isolate, info.This());
+    if (!record) {
+        return;
+    }
+
+    DOMNode* node = record->batch->NodeAt(record->batch->Field(record->index, field));
+    if (!node) {
+        info.GetReturnValue().SetNull();
+        return;
     }
-    
-    // Check wrapper cache first
-    WrapperCache* cache = WrapperCache::ForIsolate(isolate);
-    if (cache->Has(obj)) {
-        return cache->Get(isolate, obj);
+    info.GetReturnValue().Set(NodeWrapper::Wrap(isolate, isolate->GetCurrentContext(), node));
+}
+
+/**
+ * Return the [SameObject] node list at an offset / count field pair.
+ */
+void ReturnNodeList(const v8::PropertyCallbackInfo<v8::Value>& info,
+                    v8::Local<v8::Private> key, int offset_field, int count_field) {
+    v8::Isolate* isolate = info.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    RecordRef* record = ThisRecord(isolate, info.This());
+    if (!record) {
+        return;
+    }
+
+    v8::Local<v8::Object> wrapper = info.This().As<v8::Object>();
+    v8::Local<v8::Value> cached;
+    if (wrapper->GetPrivate(context, key).ToLocal(&cached) && cached->IsArray()) {
+        info.GetReturnValue().Set(cached);
+        return;
+    }
+
+    const RecordBatch& batch = *record->batch;
+    uint32_t offset = batch.Field(record->index, offset_field);
+    uint32_t count = batch.Field(record->index, count_field);
+    if (offset > batch.node_list_count || count > batch.node_list_count - offset) {
+        count = 0;
+    }
+
+    std::vector<v8::Local<v8::Value>> nodes;
+    nodes.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+        DOMNode* node = batch.NodeAt(batch.node_lists[offset + i]);
+        if (node) {
+            nodes.push_back(NodeWrapper::Wrap(isolate, context, node));
+        }
     }
-    
-    // Create new wrapper
+
+    v8::Local<v8::Array> list = v8::Array::New(isolate, nodes.data(), nodes.size());
+    list->SetIntegrityLevel(context, v8::IntegrityLevel::kFrozen).Check();
+    wrapper->SetPrivate(context, key, list).Check();
+    info.GetReturnValue().Set(list);
+}
+
+/**
+ * Return a string field of the record, or null.
+ */
+void ReturnStringField(const v8::PropertyCallbackInfo<v8::Value>& info,
+                       bool (*get)(const DOMMutationBatch*, uint32_t, DOMStringView*)) {
+    v8::Isolate* isolate = info.GetIsolate();
+    RecordRef* record = ThisRecord(isolate, info.This());
+    if (!record) {
+        return;
+    }
+
+    DOMStringView view;
+    if (!get(record->batch->batch, record->index, &view)) {
+        info.GetReturnValue().SetNull();
+        return;
+    }
+    info.GetReturnValue().Set(StringViewToV8String(isolate, view, nullptr));
+}
+
+} // namespace
+
+v8::Local<v8::Object> MutationRecordWrapper::Wrap(v8::Isolate* isolate,
+                                                  v8::Local<v8::Context> context,
+                                                  const std::shared_ptr<RecordBatch>& batch,
+                                                  uint32_t index) {
     v8::EscapableHandleScope handle_scope(isolate);
-    v8::Local<v8::FunctionTemplate> tmpl = GetTemplate(isolate);
-    v8::Local<v8::Function> constructor = tmpl->GetFunction(context).ToLocalChecked();
+    v8::Local<v8::Function> constructor =
+        TemplateCache::ForIsolate(isolate)->GetConstructor(context, kTemplateIndex, GetTemplate);
     v8::Local<v8::Object> wrapper = constructor->NewInstance(context).ToLocalChecked();
-    
-    // Store C pointer in internal field
-    wrapper->SetInternalField(0, v8::External::New(isolate, obj));
-    
-    // Increment C-side reference count
-    dom_mutationrecord_addref(obj);
-    
-    // Cache with release callback
-    cache->Set(isolate, obj, wrapper, [](void* ptr) {
-        dom_mutationrecord_release(static_cast<DOMMutationRecord*>(ptr));
+
+    RecordRef* record = new RecordRef{batch, index};
+    SetWrapperFields(wrapper, record, &kTypeInfo);
+
+    WrapperCache::ForIsolate(isolate)->Set(isolate, record, wrapper, [](void* ptr) {
+        delete static_cast<RecordRef*>(ptr);
     });
-    
+
     return handle_scope.Escape(wrapper);
 }
 
-DOMMutationRecord* MutationRecordWrapper::Unwrap(v8::Local<v8::Object> obj) {
-    if (obj.IsEmpty() || obj->InternalFieldCount() < 1) {
-        return nullptr;
-    }
-    
-    v8::Local<v8::Value> ptr = obj->GetInternalField(0).As<v8::Value>();
-    if (!ptr->IsExternal()) {
-        return nullptr;
+RecordRef* MutationRecordWrapper::Unwrap(v8::Local<v8::Object> obj) {
+    return static_cast<RecordRef*>(UnwrapObject(obj, &kTypeInfo));
+}
+
+v8::Local<v8::Array> MutationRecordWrapper::WrapAll(v8::Isolate* isolate,
+                                                    v8::Local<v8::Context> context,
+                                                    const std::shared_ptr<RecordBatch>& batch) {
+    v8::EscapableHandleScope handle_scope(isolate);
+    uint32_t count = batch ? batch->count : 0;
+    std::vector<v8::Local<v8::Value>> records(count);
+    for (uint32_t i = 0; i < count; i++) {
+        records[i] = Wrap(isolate, context, batch, i);
     }
-    
-    return static_cast<DOMMutationRecord*>(v8::Local<v8::External>::Cast(ptr)->Value());
+    return handle_scope.Escape(v8::Array::New(isolate, records.data(), records.size()));
 }
 
+const PropertyDescriptor MutationRecordWrapper::kProperties[] = {
+    // Properties (all readonly)
+    DataProperty("type", TypeGetter),
+    DataProperty("target", TargetGetter),
+    DataProperty("addedNodes", AddedNodesGetter),
+    DataProperty("removedNodes", RemovedNodesGetter),
+    DataProperty("previousSibling", PreviousSiblingGetter),
+    DataProperty("nextSibling", NextSiblingGetter),
+    DataProperty("attributeName", AttributeNameGetter),
+    DataProperty("attributeNamespace", AttributeNamespaceGetter),
+    DataProperty("oldValue", OldValueGetter),
+};
+
 void MutationRecordWrapper::InstallTemplate(v8::Isolate* isolate) {
     v8::Local<v8::FunctionTemplate> tmpl = v8::FunctionTemplate::New(isolate);
     tmpl->SetClassName(v8::String::NewFromUtf8Literal(isolate, "MutationRecord"));
-    tmpl->InstanceTemplate()->SetInternalFieldCount(1);
-    
-
-    // Get prototype template for adding properties/methods
-    v8::Local<v8::ObjectTemplate> proto = tmpl->PrototypeTemplate();
-    
-    // TODO: Add properties and methods here
-    // Example:
-    // proto->SetNativeDataProperty(v8::String::NewFromUtf8Literal(isolate, "propertyName"),
-    //                   PropertyNameGetter, PropertyNameSetter);
-    // proto->Set(v8::String::NewFromUtf8Literal(isolate, "methodName"),
-    //           v8::FunctionTemplate::New(isolate, MethodName));
-    
+    tmpl->InstanceTemplate()->SetInternalFieldCount(kWrapperFieldCount);
+
+    InstallProperties(isolate, tmpl, kProperties);
+
     // Cache the template
     TemplateCache* cache = TemplateCache::ForIsolate(isolate);
     cache->Set(kTemplateIndex, tmpl);
@@ -74,12 +192,90 @@ void MutationRecordWrapper::InstallTemplate(v8::Isolate* isolate) {
 
 v8::Local<v8::FunctionTemplate> MutationRecordWrapper::GetTemplate(v8::Isolate* isolate) {
     TemplateCache* cache = TemplateCache::ForIsolate(isolate);
-    
+
     if (!cache->Has(kTemplateIndex)) {
         InstallTemplate(isolate);
     }
-    
+
     return cache->Get(kTemplateIndex);
 }
 
+void MutationRecordWrapper::RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+    RegisterProperties(registry, kProperties);
+}
+
+// ===== Properties =====
+
+void MutationRecordWrapper::TypeGetter(v8::Local<v8::Name> property,
+                                       const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("MutationRecordWrapper::TypeGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    RecordRef* record = ThisRecord(isolate, info.This());
+    if (!record) {
+        return;
+    }
+
+    switch (record->batch->Field(record->index, DOM_MUTATION_FIELD_TYPE)) {
+        case DOM_MUTATION_TYPE_ATTRIBUTES:
+            info.GetReturnValue().Set(v8::String::NewFromUtf8Literal(isolate, "attributes"));
+            break;
+        case DOM_MUTATION_TYPE_CHARACTER_DATA:
+            info.GetReturnValue().Set(v8::String::NewFromUtf8Literal(isolate, "characterData"));
+            break;
+        default:
+            info.GetReturnValue().Set(v8::String::NewFromUtf8Literal(isolate, "childList"));
+            break;
+    }
+}
+
+void MutationRecordWrapper::TargetGetter(v8::Local<v8::Name> property,
+                                         const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("MutationRecordWrapper::TargetGetter");
+    ReturnNodeField(info, DOM_MUTATION_FIELD_TARGET);
+}
+
+void MutationRecordWrapper::AddedNodesGetter(v8::Local<v8::Name> property,
+                                             const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("MutationRecordWrapper::AddedNodesGetter");
+    ReturnNodeList(info, AddedNodesKey(info.GetIsolate()),
+                   DOM_MUTATION_FIELD_ADDED_OFFSET, DOM_MUTATION_FIELD_ADDED_COUNT);
+}
+
+void MutationRecordWrapper::RemovedNodesGetter(v8::Local<v8::Name> property,
+                                               const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("MutationRecordWrapper::RemovedNodesGetter");
+    ReturnNodeList(info, RemovedNodesKey(info.GetIsolate()),
+                   DOM_MUTATION_FIELD_REMOVED_OFFSET, DOM_MUTATION_FIELD_REMOVED_COUNT);
+}
+
+void MutationRecordWrapper::PreviousSiblingGetter(v8::Local<v8::Name> property,
+                                                  const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("MutationRecordWrapper::PreviousSiblingGetter");
+    ReturnNodeField(info, DOM_MUTATION_FIELD_PREVIOUS_SIBLING);
+}
+
+void MutationRecordWrapper::NextSiblingGetter(v8::Local<v8::Name> property,
+                                              const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("MutationRecordWrapper::NextSiblingGetter");
+    ReturnNodeField(info, DOM_MUTATION_FIELD_NEXT_SIBLING);
+}
+
+void MutationRecordWrapper::AttributeNameGetter(v8::Local<v8::Name> property,
+                                                const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("MutationRecordWrapper::AttributeNameGetter");
+    ReturnStringField(info, dom_mutationbatch_get_attributename);
+}
+
+void MutationRecordWrapper::AttributeNamespaceGetter(v8::Local<v8::Name> property,
+                                                     const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("MutationRecordWrapper::AttributeNamespaceGetter");
+    ReturnStringField(info, dom_mutationbatch_get_attributenamespace);
+}
+
+void MutationRecordWrapper::OldValueGetter(v8::Local<v8::Name> property,
+                                           const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("MutationRecordWrapper::OldValueGetter");
+    ReturnStringField(info, dom_mutationbatch_get_oldvalue);
+}
+
 } // namespace v8_dom
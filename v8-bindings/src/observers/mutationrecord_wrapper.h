@@ -1,51 +1,141 @@
 /**
  * MutationRecord Wrapper - V8 bindings for MutationRecord
- * 
- * Auto-generated wrapper for DOMMutationRecord.
- * Provides JavaScript interface for MutationRecord operations.
+ *
+ * Records are read from a DOMMutationBatch shared by every record of one
+ * takeRecords() / delivery (RecordBatch). A record is just a batch and a
+ * row index: its node fields are looked up in the batch's packed rows, so
+ * node wrappers are only created for the fields script actually reads.
+ *
+ * addedNodes and removedNodes are [SameObject]: frozen arrays of nodes,
+ * built on first read and kept on the record wrapper.
  */
 
 #ifndef V8_DOM_MUTATIONRECORD_WRAPPER_H
 #define V8_DOM_MUTATIONRECORD_WRAPPER_H
 
 #include <v8.h>
+#include <memory>
+#include "../core/wrapper_traits.h"
+#include "../core/external_references.h"
+#include "../core/property_table.h"
 #include "dom.h"
 
 namespace v8_dom {
 
+/**
+ * One taken record queue, shared by its record wrappers and batch object.
+ */
+struct RecordBatch {
+    DOMMutationBatch* batch;         // owned
+    const uint32_t* entries;         // count * DOM_MUTATION_BATCH_STRIDE
+    const uint32_t* node_lists;
+    uint32_t node_list_count;
+    DOMNode* const* nodes;
+    uint32_t node_count;
+    uint32_t count;
+
+    ~RecordBatch();
+
+    /**
+     * Take the pending records of observer. Returns null on allocation
+     * failure (the records stay queued).
+     */
+    static std::shared_ptr<RecordBatch> Take(DOMMutationObserver* observer);
+
+    /**
+     * Field of record index (a DOM_MUTATION_FIELD_* value).
+     */
+    uint32_t Field(uint32_t index, int field) const {
+        return entries[index * DOM_MUTATION_BATCH_STRIDE + field];
+    }
+
+    /**
+     * Node for a node index, or null for DOM_MUTATION_BATCH_NONE.
+     * Indexes are range-checked: script can write to the packed rows.
+     */
+    DOMNode* NodeAt(uint32_t node_index) const {
+        return node_index < node_count ? nodes[node_index] : nullptr;
+    }
+};
+
+/**
+ * Binding-side state of one MutationRecord wrapper.
+ */
+struct RecordRef {
+    std::shared_ptr<RecordBatch> batch;
+    uint32_t index;
+};
+
 class MutationRecordWrapper {
 public:
     /**
-     * Wrap a C DOMMutationRecord pointer in a V8 object.
-     * Uses wrapper cache for identity preservation.
+     * Create the wrapper of record index of batch.
      */
     static v8::Local<v8::Object> Wrap(v8::Isolate* isolate,
                                       v8::Local<v8::Context> context,
-                                      DOMMutationRecord* obj);
-    
+                                      const std::shared_ptr<RecordBatch>& batch,
+                                      uint32_t index);
+
     /**
-     * Unwrap a V8 object to get the C DOMMutationRecord pointer.
+     * Unwrap a V8 object to get the record state.
      */
-    static DOMMutationRecord* Unwrap(v8::Local<v8::Object> obj);
-    
+    static RecordRef* Unwrap(v8::Local<v8::Object> obj);
+
+    /**
+     * Wrap every record of batch into a new array.
+     */
+    static v8::Local<v8::Array> WrapAll(v8::Isolate* isolate,
+                                        v8::Local<v8::Context> context,
+                                        const std::shared_ptr<RecordBatch>& batch);
+
     /**
      * Install the MutationRecord template (called once per isolate).
      */
     static void InstallTemplate(v8::Isolate* isolate);
-    
+
     /**
      * Get the cached MutationRecord template.
      */
     static v8::Local<v8::FunctionTemplate> GetTemplate(v8::Isolate* isolate);
-    
+
     /**
      * Template cache index.
      */
-    static constexpr int kTemplateIndex = 25;
-    
+    static constexpr int kTemplateIndex = WrapperTraits<MutationRecordWrapper>::kTemplateIndex;
+
+    /**
+     * Type tag stored in the wrapper's type internal field.
+     */
+    static const WrapperTypeInfo kTypeInfo;
+
+    /**
+     * Register this wrapper's callbacks for snapshot serialization.
+     */
+    static void RegisterExternalReferences(ExternalReferenceRegistry* registry);
+
 private:
-    // Property getters/setters and methods will be added here
-    // TODO: Parse dom.h to auto-generate these declarations
+    // Prototype members, installed by InstallTemplate()
+    static const PropertyDescriptor kProperties[];
+    
+    // Properties
+    static void TypeGetter(v8::Local<v8::Name> property,
+                           const v8::PropertyCallbackInfo<v8::Value>& info);
+    static void TargetGetter(v8::Local<v8::Name> property,
+                             const v8::PropertyCallbackInfo<v8::Value>& info);
+    static void AddedNodesGetter(v8::Local<v8::Name> property,
+                                 const v8::PropertyCallbackInfo<v8::Value>& info);
+    static void RemovedNodesGetter(v8::Local<v8::Name> property,
+                                   const v8::PropertyCallbackInfo<v8::Value>& info);
+    static void PreviousSiblingGetter(v8::Local<v8::Name> property,
+                                      const v8::PropertyCallbackInfo<v8::Value>& info);
+    static void NextSiblingGetter(v8::Local<v8::Name> property,
+                                  const v8::PropertyCallbackInfo<v8::Value>& info);
+    static void AttributeNameGetter(v8::Local<v8::Name> property,
+                                    const v8::PropertyCallbackInfo<v8::Value>& info);
+    static void AttributeNamespaceGetter(v8::Local<v8::Name> property,
+                                         const v8::PropertyCallbackInfo<v8::Value>& info);
+    static void OldValueGetter(v8::Local<v8::Name> property,
+                               const v8::PropertyCallbackInfo<v8::Value>& info);
 };
 
 } // namespace v8_dom
@@ -0,0 +1,267 @@
+#include "mutationrecordbatch_wrapper.h"
+#include "../nodes/node_wrapper.h"
+#include "../wrapper_cache.h"
+#include "../core/template_cache.h"
+#include "../core/string_cache.h"
+#include "../core/utilities.h"
+
+namespace v8_dom {
+
+const WrapperTypeInfo MutationRecordBatchWrapper::kTypeInfo = {"MutationRecordBatch", nullptr};
+
+namespace {
+
+using SharedBatch = std::shared_ptr<RecordBatch>;
+
+v8::Local<v8::Private> RecordsKey(v8::Isolate* isolate) {
+    return v8::Private::ForApi(isolate, v8::String::NewFromUtf8Literal(isolate, "v8_dom::batchRecords"));
+}
+
+v8::Local<v8::Private> NodeListsKey(v8::Isolate* isolate) {
+    return v8::Private::ForApi(isolate, v8::String::NewFromUtf8Literal(isolate, "v8_dom::batchNodeLists"));
+}
+
+SharedBatch* ThisBatch(v8::Isolate* isolate, v8::Local<v8::Value> receiver) {
+    SharedBatch* batch = receiver->IsObject()
+        ? MutationRecordBatchWrapper::Unwrap(receiver.As<v8::Object>())
+        : nullptr;
+    if (!batch) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Invalid MutationRecordBatch")));
+    }
+    return batch;
+}
+
+/**
+ * A Uint32Array over C-ABI batch memory; the buffer holds a batch reference.
+ */
+v8::Local<v8::Uint32Array> BatchView(v8::Isolate* isolate, const SharedBatch& batch,
+                                     const uint32_t* data, size_t length) {
+    if (!data || length == 0) {
+        return v8::Uint32Array::New(v8::ArrayBuffer::New(isolate, 0), 0, 0);
+    }
+
+    std::unique_ptr<v8::BackingStore> store = v8::ArrayBuffer::NewBackingStore(
+        const_cast<uint32_t*>(data), length * sizeof(uint32_t),
+        [](void*, size_t, void* owner) {
+            delete static_cast<SharedBatch*>(owner);
+        },
+        new SharedBatch(batch));
+    return v8::Uint32Array::New(v8::ArrayBuffer::New(isolate, std::move(store)), 0, length);
+}
+
+/**
+ * Return the [SameObject] view stored under key, creating it on first use.
+ */
+void ReturnView(const v8::PropertyCallbackInfo<v8::Value>& info, v8::Local<v8::Private> key,
+                const uint32_t* (*data)(const RecordBatch&), size_t (*length)(const RecordBatch&)) {
+    v8::Isolate* isolate = info.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    SharedBatch* batch = ThisBatch(isolate, info.This());
+    if (!batch) {
+        return;
+    }
+
+    v8::Local<v8::Object> wrapper = info.This().As<v8::Object>();
+    v8::Local<v8::Value> cached;
+    if (wrapper->GetPrivate(context, key).ToLocal(&cached) && cached->IsUint32Array()) {
+        info.GetReturnValue().Set(cached);
+        return;
+    }
+
+    v8::Local<v8::Uint32Array> view = BatchView(isolate, *batch, data(**batch), length(**batch));
+    wrapper->SetPrivate(context, key, view).Check();
+    info.GetReturnValue().Set(view);
+}
+
+/**
+ * Read a uint32 index argument; false if it threw or the argument is missing.
+ */
+bool IndexArg(const v8::FunctionCallbackInfo<v8::Value>& args, uint32_t* out) {
+    v8::Isolate* isolate = args.GetIsolate();
+    if (args.Length() < 1) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "1 argument required")));
+        return false;
+    }
+    return args[0]->Uint32Value(isolate->GetCurrentContext()).To(out);
+}
+
+/**
+ * Return a string field of record args[0], or null.
+ */
+void ReturnStringField(const v8::FunctionCallbackInfo<v8::Value>& args,
+                       bool (*get)(const DOMMutationBatch*, uint32_t, DOMStringView*)) {
+    v8::Isolate* isolate = args.GetIsolate();
+    SharedBatch* batch = ThisBatch(isolate, args.This());
+    uint32_t index;
+    if (!batch || !IndexArg(args, &index)) {
+        return;
+    }
+
+    DOMStringView view;
+    if (!get((*batch)->batch, index, &view)) {
+        args.GetReturnValue().SetNull();
+        return;
+    }
+    args.GetReturnValue().Set(StringViewToV8String(isolate, view, nullptr));
+}
+
+} // namespace
+
+v8::Local<v8::Object> MutationRecordBatchWrapper::Wrap(v8::Isolate* isolate,
+                                                       v8::Local<v8::Context> context,
+                                                       const std::shared_ptr<RecordBatch>& batch) {
+    v8::EscapableHandleScope handle_scope(isolate);
+    v8::Local<v8::Function> constructor =
+        TemplateCache::ForIsolate(isolate)->GetConstructor(context, kTemplateIndex, GetTemplate);
+    v8::Local<v8::Object> wrapper = constructor->NewInstance(context).ToLocalChecked();
+
+    SharedBatch* shared = new SharedBatch(batch);
+    SetWrapperFields(wrapper, shared, &kTypeInfo);
+
+    WrapperCache::ForIsolate(isolate)->Set(isolate, shared, wrapper, [](void* ptr) {
+        delete static_cast<SharedBatch*>(ptr);
+    });
+
+    return handle_scope.Escape(wrapper);
+}
+
+std::shared_ptr<RecordBatch>* MutationRecordBatchWrapper::Unwrap(v8::Local<v8::Object> obj) {
+    return static_cast<SharedBatch*>(UnwrapObject(obj, &kTypeInfo));
+}
+
+const PropertyDescriptor MutationRecordBatchWrapper::kProperties[] = {
+    // Properties
+    DataProperty("length", LengthGetter),
+    DataProperty("records", RecordsGetter),
+    DataProperty("nodeLists", NodeListsGetter),
+
+    // Methods
+    MethodProperty("node", Node),
+    MethodProperty("record", Record),
+    MethodProperty("attributeName", AttributeName),
+    MethodProperty("attributeNamespace", AttributeNamespace),
+    MethodProperty("oldValue", OldValue),
+};
+
+void MutationRecordBatchWrapper::InstallTemplate(v8::Isolate* isolate) {
+    v8::Local<v8::FunctionTemplate> tmpl = v8::FunctionTemplate::New(isolate);
+    tmpl->SetClassName(v8::String::NewFromUtf8Literal(isolate, "MutationRecordBatch"));
+    tmpl->InstanceTemplate()->SetInternalFieldCount(kWrapperFieldCount);
+
+    // Get prototype template for adding properties/methods
+    v8::Local<v8::ObjectTemplate> proto = tmpl->PrototypeTemplate();
+
+    // Layout constants
+    v8::PropertyAttribute constant =
+        static_cast<v8::PropertyAttribute>(v8::ReadOnly | v8::DontDelete);
+    proto->Set(v8::String::NewFromUtf8Literal(isolate, "STRIDE"),
+               v8::Integer::New(isolate, DOM_MUTATION_BATCH_STRIDE), constant);
+    proto->Set(v8::String::NewFromUtf8Literal(isolate, "NONE"),
+               v8::Integer::NewFromUnsigned(isolate, DOM_MUTATION_BATCH_NONE), constant);
+
+    InstallProperties(isolate, tmpl, kProperties);
+
+    // Cache the template
+    TemplateCache* cache = TemplateCache::ForIsolate(isolate);
+    cache->Set(kTemplateIndex, tmpl);
+}
+
+v8::Local<v8::FunctionTemplate> MutationRecordBatchWrapper::GetTemplate(v8::Isolate* isolate) {
+    TemplateCache* cache = TemplateCache::ForIsolate(isolate);
+
+    if (!cache->Has(kTemplateIndex)) {
+        InstallTemplate(isolate);
+    }
+
+    return cache->Get(kTemplateIndex);
+}
+
+void MutationRecordBatchWrapper::RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+    RegisterProperties(registry, kProperties);
+}
+
+// ===== Properties =====
+
+void MutationRecordBatchWrapper::LengthGetter(v8::Local<v8::Name> property,
+                                              const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("MutationRecordBatchWrapper::LengthGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    SharedBatch* batch = ThisBatch(isolate, info.This());
+    if (!batch) {
+        return;
+    }
+    info.GetReturnValue().Set((*batch)->count);
+}
+
+void MutationRecordBatchWrapper::RecordsGetter(v8::Local<v8::Name> property,
+                                               const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("MutationRecordBatchWrapper::RecordsGetter");
+    ReturnView(info, RecordsKey(info.GetIsolate()),
+               [](const RecordBatch& batch) { return batch.entries; },
+               [](const RecordBatch& batch) {
+                   return static_cast<size_t>(batch.count) * DOM_MUTATION_BATCH_STRIDE;
+               });
+}
+
+void MutationRecordBatchWrapper::NodeListsGetter(v8::Local<v8::Name> property,
+                                                 const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("MutationRecordBatchWrapper::NodeListsGetter");
+    ReturnView(info, NodeListsKey(info.GetIsolate()),
+               [](const RecordBatch& batch) { return batch.node_lists; },
+               [](const RecordBatch& batch) { return static_cast<size_t>(batch.node_list_count); });
+}
+
+// ===== Methods =====
+
+void MutationRecordBatchWrapper::Node(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("MutationRecordBatchWrapper::Node");
+    v8::Isolate* isolate = args.GetIsolate();
+    SharedBatch* batch = UnwrapReceiver<SharedBatch>(args);
+    uint32_t index;
+    if (!batch || !IndexArg(args, &index)) {
+        return;
+    }
+
+    DOMNode* node = (*batch)->NodeAt(index);
+    if (!node) {
+        args.GetReturnValue().SetNull();
+        return;
+    }
+    args.GetReturnValue().Set(NodeWrapper::Wrap(isolate, isolate->GetCurrentContext(), node));
+}
+
+void MutationRecordBatchWrapper::Record(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("MutationRecordBatchWrapper::Record");
+    v8::Isolate* isolate = args.GetIsolate();
+    SharedBatch* batch = UnwrapReceiver<SharedBatch>(args);
+    uint32_t index;
+    if (!batch || !IndexArg(args, &index)) {
+        return;
+    }
+
+    if (index >= (*batch)->count) {
+        args.GetReturnValue().SetNull();
+        return;
+    }
+    args.GetReturnValue().Set(
+        MutationRecordWrapper::Wrap(isolate, isolate->GetCurrentContext(), *batch, index));
+}
+
+void MutationRecordBatchWrapper::AttributeName(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("MutationRecordBatchWrapper::AttributeName");
+    ReturnStringField(args, dom_mutationbatch_get_attributename);
+}
+
+void MutationRecordBatchWrapper::AttributeNamespace(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("MutationRecordBatchWrapper::AttributeNamespace");
+    ReturnStringField(args, dom_mutationbatch_get_attributenamespace);
+}
+
+void MutationRecordBatchWrapper::OldValue(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("MutationRecordBatchWrapper::OldValue");
+    ReturnStringField(args, dom_mutationbatch_get_oldvalue);
+}
+
+} // namespace v8_dom
@@ -0,0 +1,98 @@
+/**
+ * MutationRecordBatch Wrapper - Packed mutation records for script
+ *
+ * Non-standard. A MutationObserver constructed with { batch: true } hands
+ * its callback one MutationRecordBatch instead of an array of records, and
+ * takeRecordBatch() returns one on demand. The whole record queue crosses
+ * into script once:
+ *
+ *   batch.records    Uint32Array, batch.STRIDE values per record:
+ *                    type, target, addedOffset, addedCount, removedOffset,
+ *                    removedCount, previousSibling, nextSibling
+ *                    (type: 0 attributes, 1 characterData, 2 childList;
+ *                    node fields are node indexes, batch.NONE for null)
+ *   batch.nodeLists  Uint32Array of node indexes; added / removed nodes
+ *                    of a record are [offset, offset + count)
+ *   batch.node(i)    Node for a node index (wrapped on first use)
+ *   batch.record(r)  A regular MutationRecord for record r
+ *   batch.attributeName(r), attributeNamespace(r), oldValue(r)
+ *
+ * Both arrays view the C-ABI batch directly (no copy); their buffers keep
+ * the batch alive.
+ */
+
+#ifndef V8_DOM_MUTATIONRECORDBATCH_WRAPPER_H
+#define V8_DOM_MUTATIONRECORDBATCH_WRAPPER_H
+
+#include <v8.h>
+#include <memory>
+#include "mutationrecord_wrapper.h"
+#include "../core/wrapper_traits.h"
+#include "../core/external_references.h"
+#include "../core/property_table.h"
+#include "dom.h"
+
+namespace v8_dom {
+
+class MutationRecordBatchWrapper {
+public:
+    /**
+     * Create the batch object of a taken record queue.
+     */
+    static v8::Local<v8::Object> Wrap(v8::Isolate* isolate,
+                                      v8::Local<v8::Context> context,
+                                      const std::shared_ptr<RecordBatch>& batch);
+
+    /**
+     * Unwrap a V8 object to get its (shared) batch.
+     */
+    static std::shared_ptr<RecordBatch>* Unwrap(v8::Local<v8::Object> obj);
+
+    /**
+     * Install the MutationRecordBatch template (called once per isolate).
+     */
+    static void InstallTemplate(v8::Isolate* isolate);
+
+    /**
+     * Get the cached MutationRecordBatch template.
+     */
+    static v8::Local<v8::FunctionTemplate> GetTemplate(v8::Isolate* isolate);
+
+    /**
+     * Template cache index.
+     */
+    static constexpr int kTemplateIndex = WrapperTraits<MutationRecordBatchWrapper>::kTemplateIndex;
+
+    /**
+     * Type tag stored in the wrapper's type internal field.
+     */
+    static const WrapperTypeInfo kTypeInfo;
+
+    /**
+     * Register this wrapper's callbacks for snapshot serialization.
+     */
+    static void RegisterExternalReferences(ExternalReferenceRegistry* registry);
+
+private:
+    // Prototype members, installed by InstallTemplate()
+    static const PropertyDescriptor kProperties[];
+    
+    // Properties
+    static void LengthGetter(v8::Local<v8::Name> property,
+                             const v8::PropertyCallbackInfo<v8::Value>& info);
+    static void RecordsGetter(v8::Local<v8::Name> property,
+                              const v8::PropertyCallbackInfo<v8::Value>& info);
+    static void NodeListsGetter(v8::Local<v8::Name> property,
+                                const v8::PropertyCallbackInfo<v8::Value>& info);
+
+    // Methods
+    static void Node(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void Record(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void AttributeName(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void AttributeNamespace(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void OldValue(const v8::FunctionCallbackInfo<v8::Value>& args);
+};
+
+} // namespace v8_dom
+
+#endif // V8_DOM_MUTATIONRECORDBATCH_WRAPPER_H
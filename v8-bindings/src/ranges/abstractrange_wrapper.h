@@ -9,6 +9,7 @@
 #define V8_DOM_ABSTRACTRANGE_WRAPPER_H
 
 #include <v8.h>
+#include "../core/wrapper_traits.h"
 #include "dom.h"
 
 namespace v8_dom {
@@ -41,7 +42,12 @@ public:
     /**
      * Template cache index.
      */
-    static constexpr int kTemplateIndex = 19;
+    static constexpr int kTemplateIndex = WrapperTraits<AbstractRangeWrapper>::kTemplateIndex;
+    
+    /**
+     * Type tag stored in the wrapper's type internal field.
+     */
+    static const WrapperTypeInfo kTypeInfo;
     
 private:
     // Property getters/setters and methods will be added here
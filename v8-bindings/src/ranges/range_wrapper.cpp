@@ -1,74 +1,165 @@
 #include "range_wrapper.h"
+#include "../nodes/node_wrapper.h"
 #include "../wrapper_cache.h"
 #include "../core/template_cache.h"
 #include "../core/utilities.h"
 
 namespace v8_dom {
 
+const WrapperTypeInfo RangeWrapper::kTypeInfo = {"Range", &AbstractRangeWrapper::kTypeInfo};
+
+namespace {
+
+DOMRange* ThisRange(v8::Isolate* isolate, v8::Local<v8::Object> receiver) {
+    DOMRange* range = RangeWrapper::Unwrap(receiver);
+    if (!range) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Invalid Range object")));
+    }
+    return range;
+}
+
+/**
+ * Read a Node argument; throws a TypeError and returns nullptr otherwise.
+ */
+DOMNode* NodeArg(const v8::FunctionCallbackInfo<v8::Value>& args, int index) {
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMNode* node = nullptr;
+    if (index < args.Length() && args[index]->IsObject()) {
+        node = NodeWrapper::Unwrap(args[index].As<v8::Object>());
+    }
+    if (!node) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Argument must be a Node")));
+    }
+    return node;
+}
+
+/**
+ * Read an unsigned long argument (WebIDL ToUint32); returns false if the
+ * argument is missing or its conversion threw.
+ */
+bool OffsetArg(const v8::FunctionCallbackInfo<v8::Value>& args, int index, uint32_t* out) {
+    v8::Isolate* isolate = args.GetIsolate();
+    if (index >= args.Length()) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Offset argument required")));
+        return false;
+    }
+    return args[index]->Uint32Value(isolate->GetCurrentContext()).To(out);
+}
+
+/**
+ * Builds toString()'s result from streamed Text segments: one V8 string per
+ * segment, joined with String::Concat (ropes, no flattening here).
+ */
+struct RangeStringBuilder {
+    v8::Isolate* isolate;
+    v8::Local<v8::String> result;
+    bool failed;
+};
+
+void AppendSegment(const char* data, uint32_t length, void* user_data) {
+    RangeStringBuilder* builder = static_cast<RangeStringBuilder*>(user_data);
+    if (builder->failed) {
+        return;
+    }
+
+    v8::Local<v8::String> piece;
+    if (!v8::String::NewFromUtf8(builder->isolate, data, v8::NewStringType::kNormal,
+                                 static_cast<int>(length)).ToLocal(&piece)) {
+        builder->failed = true;
+        return;
+    }
+
+    if (builder->result.IsEmpty()) {
+        builder->result = piece;
+        return;
+    }
+    builder->result = v8::String::Concat(builder->isolate, builder->result, piece);
+    builder->failed = builder->result.IsEmpty();
+}
+
+} // namespace
+
 v8::Local<v8::Object> RangeWrapper::Wrap(v8::Isolate* isolate,
                                               v8::Local<v8::Context> context,
                                               DOMRange* obj) {
-    if (!obj) {
-        return v8::Local<v8::Object>();
-    }
-    
-    // Check wrapper cache first
-    WrapperCache* cache = WrapperCache::ForIsolate(isolate);
-    if (cache->Has(obj)) {
-        return cache->Get(isolate, obj);
-    }
-    
-    // Create new wrapper
-    v8::EscapableHandleScope handle_scope(isolate);
-    v8::Local<v8::FunctionTemplate> tmpl = GetTemplate(isolate);
-    v8::Local<v8::Function> constructor = tmpl->GetFunction(context).ToLocalChecked();
-    v8::Local<v8::Object> wrapper = constructor->NewInstance(context).ToLocalChecked();
-    
-    // Store C pointer in internal field
-    wrapper->SetInternalField(0, v8::External::New(isolate, obj));
-    
-    // Increment C-side reference count
-    dom_range_addref(obj);
-    
-    // Cache with release callback
-    cache->Set(isolate, obj, wrapper, [](void* ptr) {
-        dom_range_release(static_cast<DOMRange*>(ptr));
-    });
-    
-    return handle_scope.Escape(wrapper);
+    return WrapWithTraits<RangeWrapper>(isolate, context, obj);
 }
 
 DOMRange* RangeWrapper::Unwrap(v8::Local<v8::Object> obj) {
-    if (obj.IsEmpty() || obj->InternalFieldCount() < 1) {
-        return nullptr;
-    }
-    
-    v8::Local<v8::Value> ptr = obj->GetInternalField(0).As<v8::Value>();
-    if (!ptr->IsExternal()) {
-        return nullptr;
-    }
-    
-    return static_cast<DOMRange*>(v8::Local<v8::External>::Cast(ptr)->Value());
+    return UnwrapWithTraits<RangeWrapper>(obj);
 }
 
+namespace {
+
+constexpr ConstantDescriptor kRangeConstants[] = {
+    {"START_TO_START", DOM_RANGE_START_TO_START},
+    {"START_TO_END", DOM_RANGE_START_TO_END},
+    {"END_TO_END", DOM_RANGE_END_TO_END},
+    {"END_TO_START", DOM_RANGE_END_TO_START},
+};
+
+} // namespace
+
+const PropertyDescriptor RangeWrapper::kProperties[] = {
+    // Readonly properties (AbstractRange)
+    DataProperty("startContainer", StartContainerGetter),
+    DataProperty("startOffset", StartOffsetGetter),
+    DataProperty("endContainer", EndContainerGetter),
+    DataProperty("endOffset", EndOffsetGetter),
+    DataProperty("collapsed", CollapsedGetter),
+
+    // Readonly properties (Range)
+    DataProperty("commonAncestorContainer", CommonAncestorContainerGetter),
+
+    // Boundary methods
+    MethodProperty("setStart", SetStart),
+    MethodProperty("setEnd", SetEnd),
+    MethodProperty("setStartBefore", SetStartBefore),
+    MethodProperty("setStartAfter", SetStartAfter),
+    MethodProperty("setEndBefore", SetEndBefore),
+    MethodProperty("setEndAfter", SetEndAfter),
+    MethodProperty("collapse", Collapse),
+    MethodProperty("selectNode", SelectNode),
+    MethodProperty("selectNodeContents", SelectNodeContents),
+
+    // Non-standard: both boundary points in one call (not enumerable)
+    MethodProperty("setBaseAndExtent", SetBaseAndExtent, kReceiverCheck | kDontEnum),
+
+    // Comparison methods
+    MethodProperty("compareBoundaryPoints", CompareBoundaryPoints),
+    MethodProperty("comparePoint", ComparePoint),
+    MethodProperty("isPointInRange", IsPointInRange),
+    MethodProperty("intersectsNode", IntersectsNode),
+
+    // Content methods
+    MethodProperty("deleteContents", DeleteContents),
+    MethodProperty("extractContents", ExtractContents),
+    MethodProperty("cloneContents", CloneContents),
+    MethodProperty("insertNode", InsertNode),
+    MethodProperty("surroundContents", SurroundContents),
+
+    // Lifecycle and stringifier
+    MethodProperty("cloneRange", CloneRange),
+    MethodProperty("detach", Detach),
+    MethodProperty("toString", ToString),
+};
+
 void RangeWrapper::InstallTemplate(v8::Isolate* isolate) {
     v8::Local<v8::FunctionTemplate> tmpl = v8::FunctionTemplate::New(isolate);
     tmpl->SetClassName(v8::String::NewFromUtf8Literal(isolate, "Range"));
-    tmpl->InstanceTemplate()->SetInternalFieldCount(1);
-    
+    tmpl->InstanceTemplate()->SetInternalFieldCount(kWrapperFieldCount);
+
     // Inherit from AbstractRange
     tmpl->Inherit(AbstractRangeWrapper::GetTemplate(isolate));
 
-    // Get prototype template for adding properties/methods
-    v8::Local<v8::ObjectTemplate> proto = tmpl->PrototypeTemplate();
-    
-    // TODO: Add properties and methods here
-    // Example:
-    // proto->SetNativeDataProperty(v8::String::NewFromUtf8Literal(isolate, "propertyName"),
-    //                   PropertyNameGetter, PropertyNameSetter);
-    // proto->Set(v8::String::NewFromUtf8Literal(isolate, "methodName"),
-    //           v8::FunctionTemplate::New(isolate, MethodName));
-    
+    // Comparison constants (on the interface and its prototype)
+    InstallConstants(isolate, tmpl, kRangeConstants);
+
+    InstallProperties(isolate, tmpl, kProperties);
+
     // Cache the template
     TemplateCache* cache = TemplateCache::ForIsolate(isolate);
     cache->Set(kTemplateIndex, tmpl);
@@ -76,12 +167,408 @@ void RangeWrapper::InstallTemplate(v8::Isolate* isolate) {
 
 v8::Local<v8::FunctionTemplate> RangeWrapper::GetTemplate(v8::Isolate* isolate) {
     TemplateCache* cache = TemplateCache::ForIsolate(isolate);
-    
+
     if (!cache->Has(kTemplateIndex)) {
         InstallTemplate(isolate);
     }
-    
+
     return cache->Get(kTemplateIndex);
 }
 
+void RangeWrapper::RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+    RegisterProperties(registry, kProperties);
+}
+
+// ===== Property Getters =====
+
+void RangeWrapper::StartContainerGetter(v8::Local<v8::Name> property,
+                                        const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("RangeWrapper::StartContainerGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    DOMRange* range = ThisRange(isolate, info.This());
+    if (!range) return;
+
+    DOMNode* node = dom_range_get_startcontainer(range);
+    info.GetReturnValue().Set(NodeWrapper::Wrap(isolate, isolate->GetCurrentContext(), node));
+}
+
+void RangeWrapper::StartOffsetGetter(v8::Local<v8::Name> property,
+                                     const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("RangeWrapper::StartOffsetGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    DOMRange* range = ThisRange(isolate, info.This());
+    if (!range) return;
+
+    info.GetReturnValue().Set(dom_range_get_startoffset(range));
+}
+
+void RangeWrapper::EndContainerGetter(v8::Local<v8::Name> property,
+                                      const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("RangeWrapper::EndContainerGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    DOMRange* range = ThisRange(isolate, info.This());
+    if (!range) return;
+
+    DOMNode* node = dom_range_get_endcontainer(range);
+    info.GetReturnValue().Set(NodeWrapper::Wrap(isolate, isolate->GetCurrentContext(), node));
+}
+
+void RangeWrapper::EndOffsetGetter(v8::Local<v8::Name> property,
+                                   const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("RangeWrapper::EndOffsetGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    DOMRange* range = ThisRange(isolate, info.This());
+    if (!range) return;
+
+    info.GetReturnValue().Set(dom_range_get_endoffset(range));
+}
+
+void RangeWrapper::CollapsedGetter(v8::Local<v8::Name> property,
+                                   const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("RangeWrapper::CollapsedGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    DOMRange* range = ThisRange(isolate, info.This());
+    if (!range) return;
+
+    info.GetReturnValue().Set(dom_range_get_collapsed(range) != 0);
+}
+
+void RangeWrapper::CommonAncestorContainerGetter(v8::Local<v8::Name> property,
+                                                 const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("RangeWrapper::CommonAncestorContainerGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    DOMRange* range = ThisRange(isolate, info.This());
+    if (!range) return;
+
+    DOMNode* node = dom_range_get_commonancestorcontainer(range);
+    info.GetReturnValue().Set(NodeWrapper::Wrap(isolate, isolate->GetCurrentContext(), node));
+}
+
+// ===== Boundary Methods =====
+
+void RangeWrapper::SetStart(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("RangeWrapper::SetStart");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMRange* range = UnwrapReceiver<DOMRange>(args);
+    if (!range) return;
+
+    DOMNode* node = NodeArg(args, 0);
+    uint32_t offset;
+    if (!node || !OffsetArg(args, 1, &offset)) return;
+
+    ThrowDOMException(isolate, dom_range_setstart(range, node, offset));
+}
+
+void RangeWrapper::SetEnd(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("RangeWrapper::SetEnd");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMRange* range = UnwrapReceiver<DOMRange>(args);
+    if (!range) return;
+
+    DOMNode* node = NodeArg(args, 0);
+    uint32_t offset;
+    if (!node || !OffsetArg(args, 1, &offset)) return;
+
+    ThrowDOMException(isolate, dom_range_setend(range, node, offset));
+}
+
+void RangeWrapper::SetStartBefore(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("RangeWrapper::SetStartBefore");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMRange* range = UnwrapReceiver<DOMRange>(args);
+    if (!range) return;
+
+    DOMNode* node = NodeArg(args, 0);
+    if (!node) return;
+
+    ThrowDOMException(isolate, dom_range_setstartbefore(range, node));
+}
+
+void RangeWrapper::SetStartAfter(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("RangeWrapper::SetStartAfter");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMRange* range = UnwrapReceiver<DOMRange>(args);
+    if (!range) return;
+
+    DOMNode* node = NodeArg(args, 0);
+    if (!node) return;
+
+    ThrowDOMException(isolate, dom_range_setstartafter(range, node));
+}
+
+void RangeWrapper::SetEndBefore(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("RangeWrapper::SetEndBefore");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMRange* range = UnwrapReceiver<DOMRange>(args);
+    if (!range) return;
+
+    DOMNode* node = NodeArg(args, 0);
+    if (!node) return;
+
+    ThrowDOMException(isolate, dom_range_setendbefore(range, node));
+}
+
+void RangeWrapper::SetEndAfter(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("RangeWrapper::SetEndAfter");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMRange* range = UnwrapReceiver<DOMRange>(args);
+    if (!range) return;
+
+    DOMNode* node = NodeArg(args, 0);
+    if (!node) return;
+
+    ThrowDOMException(isolate, dom_range_setendafter(range, node));
+}
+
+void RangeWrapper::SetBaseAndExtent(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("RangeWrapper::SetBaseAndExtent");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMRange* range = UnwrapReceiver<DOMRange>(args);
+    if (!range) return;
+
+    // Convert every argument before the single C-ABI call
+    DOMNode* start_node = NodeArg(args, 0);
+    uint32_t start_offset;
+    if (!start_node || !OffsetArg(args, 1, &start_offset)) return;
+    DOMNode* end_node = NodeArg(args, 2);
+    uint32_t end_offset;
+    if (!end_node || !OffsetArg(args, 3, &end_offset)) return;
+
+    ThrowDOMException(isolate, dom_range_setbaseandextent(range, start_node, start_offset,
+                                                          end_node, end_offset));
+}
+
+void RangeWrapper::Collapse(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("RangeWrapper::Collapse");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMRange* range = UnwrapReceiver<DOMRange>(args);
+    if (!range) return;
+
+    bool to_start = args.Length() > 0 && args[0]->BooleanValue(isolate);
+    dom_range_collapse(range, to_start ? 1 : 0);
+}
+
+void RangeWrapper::SelectNode(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("RangeWrapper::SelectNode");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMRange* range = UnwrapReceiver<DOMRange>(args);
+    if (!range) return;
+
+    DOMNode* node = NodeArg(args, 0);
+    if (!node) return;
+
+    ThrowDOMException(isolate, dom_range_selectnode(range, node));
+}
+
+void RangeWrapper::SelectNodeContents(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("RangeWrapper::SelectNodeContents");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMRange* range = UnwrapReceiver<DOMRange>(args);
+    if (!range) return;
+
+    DOMNode* node = NodeArg(args, 0);
+    if (!node) return;
+
+    ThrowDOMException(isolate, dom_range_selectnodecontents(range, node));
+}
+
+// ===== Comparison Methods =====
+
+void RangeWrapper::CompareBoundaryPoints(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("RangeWrapper::CompareBoundaryPoints");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMRange* range = UnwrapReceiver<DOMRange>(args);
+    if (!range) return;
+
+    // how is an unsigned short (ToUint16)
+    uint32_t how;
+    if (!OffsetArg(args, 0, &how)) return;
+
+    DOMRange* source = nullptr;
+    if (args.Length() > 1 && args[1]->IsObject()) {
+        source = Unwrap(args[1].As<v8::Object>());
+    }
+    if (!source) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Argument must be a Range")));
+        return;
+    }
+
+    // Results are -1, 0 or 1; errors (NotSupported, WrongDocument) are larger
+    int16_t result = dom_range_compareboundarypoints(range, static_cast<uint16_t>(how & 0xFFFF), source);
+    if (result > 1) {
+        ThrowDOMException(isolate, result);
+        return;
+    }
+    args.GetReturnValue().Set(result);
+}
+
+void RangeWrapper::ComparePoint(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("RangeWrapper::ComparePoint");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMRange* range = UnwrapReceiver<DOMRange>(args);
+    if (!range) return;
+
+    DOMNode* node = NodeArg(args, 0);
+    uint32_t offset;
+    if (!node || !OffsetArg(args, 1, &offset)) return;
+
+    int16_t result = dom_range_comparepoint(range, node, offset);
+    if (result > 1) {
+        ThrowDOMException(isolate, result);
+        return;
+    }
+    // DOM_ERROR_INDEX_SIZE is also 1; isPointInRange reports it as an error
+    if (result == 1 && dom_range_ispointinrange(range, node, offset) > 1) {
+        ThrowDOMException(isolate, DOM_ERROR_INDEX_SIZE);
+        return;
+    }
+    args.GetReturnValue().Set(result);
+}
+
+void RangeWrapper::IsPointInRange(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("RangeWrapper::IsPointInRange");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMRange* range = UnwrapReceiver<DOMRange>(args);
+    if (!range) return;
+
+    DOMNode* node = NodeArg(args, 0);
+    uint32_t offset;
+    if (!node || !OffsetArg(args, 1, &offset)) return;
+
+    uint8_t result = dom_range_ispointinrange(range, node, offset);
+    if (result > 1) {
+        // The error code itself comes from comparePoint (same validation)
+        ThrowDOMException(isolate, dom_range_comparepoint(range, node, offset));
+        return;
+    }
+    args.GetReturnValue().Set(result == 1);
+}
+
+void RangeWrapper::IntersectsNode(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("RangeWrapper::IntersectsNode");
+    DOMRange* range = UnwrapReceiver<DOMRange>(args);
+    if (!range) return;
+
+    DOMNode* node = NodeArg(args, 0);
+    if (!node) return;
+
+    args.GetReturnValue().Set(dom_range_intersectsnode(range, node) != 0);
+}
+
+// ===== Content Methods =====
+
+void RangeWrapper::DeleteContents(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("RangeWrapper::DeleteContents");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMRange* range = UnwrapReceiver<DOMRange>(args);
+    if (!range) return;
+
+    ThrowDOMException(isolate, dom_range_deletecontents(range));
+}
+
+void RangeWrapper::ExtractContents(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("RangeWrapper::ExtractContents");
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    DOMRange* range = UnwrapReceiver<DOMRange>(args);
+    if (!range) return;
+
+    DOMDocumentFragment* fragment = dom_range_extractcontents(range);
+    if (!fragment) {
+        isolate->ThrowException(v8::Exception::Error(
+            v8::String::NewFromUtf8Literal(isolate, "Failed to extract contents")));
+        return;
+    }
+    args.GetReturnValue().Set(NodeWrapper::Wrap(isolate, context, (DOMNode*)fragment));
+}
+
+void RangeWrapper::CloneContents(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("RangeWrapper::CloneContents");
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    DOMRange* range = UnwrapReceiver<DOMRange>(args);
+    if (!range) return;
+
+    DOMDocumentFragment* fragment = dom_range_clonecontents(range);
+    if (!fragment) {
+        isolate->ThrowException(v8::Exception::Error(
+            v8::String::NewFromUtf8Literal(isolate, "Failed to clone contents")));
+        return;
+    }
+    args.GetReturnValue().Set(NodeWrapper::Wrap(isolate, context, (DOMNode*)fragment));
+}
+
+void RangeWrapper::InsertNode(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("RangeWrapper::InsertNode");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMRange* range = UnwrapReceiver<DOMRange>(args);
+    if (!range) return;
+
+    DOMNode* node = NodeArg(args, 0);
+    if (!node) return;
+
+    ThrowDOMException(isolate, dom_range_insertnode(range, node));
+}
+
+void RangeWrapper::SurroundContents(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("RangeWrapper::SurroundContents");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMRange* range = UnwrapReceiver<DOMRange>(args);
+    if (!range) return;
+
+    DOMNode* new_parent = NodeArg(args, 0);
+    if (!new_parent) return;
+
+    ThrowDOMException(isolate, dom_range_surroundcontents(range, new_parent));
+}
+
+// ===== Lifecycle and Stringifier =====
+
+void RangeWrapper::CloneRange(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("RangeWrapper::CloneRange");
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    DOMRange* range = UnwrapReceiver<DOMRange>(args);
+    if (!range) return;
+
+    DOMRange* clone = dom_range_clonerange(range);
+    if (!clone) {
+        isolate->ThrowException(v8::Exception::Error(
+            v8::String::NewFromUtf8Literal(isolate, "Failed to clone range")));
+        return;
+    }
+    args.GetReturnValue().Set(Wrap(isolate, context, clone));
+}
+
+void RangeWrapper::Detach(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("RangeWrapper::Detach");
+    DOMRange* range = UnwrapReceiver<DOMRange>(args);
+    if (!range) return;
+
+    dom_range_detach(range);
+}
+
+void RangeWrapper::ToString(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("RangeWrapper::ToString");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMRange* range = UnwrapReceiver<DOMRange>(args);
+    if (!range) return;
+
+    // Segments are copied once, from the Text nodes into V8 strings
+    RangeStringBuilder builder{isolate, v8::Local<v8::String>(), false};
+    dom_range_foreach_text(range, AppendSegment, &builder);
+
+    if (builder.failed) {
+        isolate->ThrowException(v8::Exception::RangeError(
+            v8::String::NewFromUtf8Literal(isolate, "Range text is too long")));
+        return;
+    }
+    if (builder.result.IsEmpty()) {
+        args.GetReturnValue().SetEmptyString();
+        return;
+    }
+    args.GetReturnValue().Set(builder.result);
+}
+
 } // namespace v8_dom
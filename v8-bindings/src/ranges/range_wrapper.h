@@ -3,12 +3,22 @@
  * 
  * Auto-generated wrapper for DOMRange.
  * Provides JavaScript interface for Range operations.
+ *
+ * toString() streams the range's Text data straight into V8 strings
+ * (dom_range_foreach_text) instead of copying it through a C string.
+ *
+ * Non-standard: setBaseAndExtent(startNode, startOffset, endNode, endOffset)
+ * sets both boundary points in one call, validating both before changing
+ * either (dom_range_setbaseandextent).
  */
 
 #ifndef V8_DOM_RANGE_WRAPPER_H
 #define V8_DOM_RANGE_WRAPPER_H
 
 #include <v8.h>
+#include "../core/wrapper_traits.h"
+#include "../core/external_references.h"
+#include "../core/property_table.h"
 #include "abstractrange_wrapper.h"
 #include "dom.h"
 
@@ -19,6 +29,9 @@ public:
     /**
      * Wrap a C DOMRange pointer in a V8 object.
      * Uses wrapper cache for identity preservation.
+     *
+     * Takes over the caller's reference: ranges come only from
+     * createRange() and cloneRange(), and are released with the wrapper.
      */
     static v8::Local<v8::Object> Wrap(v8::Isolate* isolate,
                                       v8::Local<v8::Context> context,
@@ -42,11 +55,65 @@ public:
     /**
      * Template cache index.
      */
-    static constexpr int kTemplateIndex = 20;
+    static constexpr int kTemplateIndex = WrapperTraits<RangeWrapper>::kTemplateIndex;
+    
+    /**
+     * Type tag stored in the wrapper's type internal field.
+     */
+    static const WrapperTypeInfo kTypeInfo;
+    
+    /**
+     * Register this wrapper's callbacks for snapshot serialization.
+     */
+    static void RegisterExternalReferences(ExternalReferenceRegistry* registry);
     
 private:
-    // Property getters/setters and methods will be added here
-    // TODO: Parse dom.h to auto-generate these declarations
+    // Prototype members, installed by InstallTemplate()
+    static const PropertyDescriptor kProperties[];
+    
+    // Readonly properties
+    static void StartContainerGetter(v8::Local<v8::Name> property,
+                                     const v8::PropertyCallbackInfo<v8::Value>& info);
+    static void StartOffsetGetter(v8::Local<v8::Name> property,
+                                  const v8::PropertyCallbackInfo<v8::Value>& info);
+    static void EndContainerGetter(v8::Local<v8::Name> property,
+                                   const v8::PropertyCallbackInfo<v8::Value>& info);
+    static void EndOffsetGetter(v8::Local<v8::Name> property,
+                                const v8::PropertyCallbackInfo<v8::Value>& info);
+    static void CollapsedGetter(v8::Local<v8::Name> property,
+                                const v8::PropertyCallbackInfo<v8::Value>& info);
+    static void CommonAncestorContainerGetter(v8::Local<v8::Name> property,
+                                              const v8::PropertyCallbackInfo<v8::Value>& info);
+    
+    // Boundary methods
+    static void SetStart(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void SetEnd(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void SetStartBefore(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void SetStartAfter(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void SetEndBefore(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void SetEndAfter(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void SetBaseAndExtent(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void Collapse(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void SelectNode(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void SelectNodeContents(const v8::FunctionCallbackInfo<v8::Value>& args);
+    
+    // Comparison methods
+    static void CompareBoundaryPoints(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void ComparePoint(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void IsPointInRange(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void IntersectsNode(const v8::FunctionCallbackInfo<v8::Value>& args);
+    
+    // Content methods
+    static void DeleteContents(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void ExtractContents(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void CloneContents(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void InsertNode(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void SurroundContents(const v8::FunctionCallbackInfo<v8::Value>& args);
+    
+    // Lifecycle and stringifier
+    static void CloneRange(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void Detach(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void ToString(const v8::FunctionCallbackInfo<v8::Value>& args);
 };
 
 } // namespace v8_dom
@@ -2,72 +2,57 @@
 #include "../wrapper_cache.h"
 #include "../core/template_cache.h"
 #include "../core/utilities.h"
+#include "../nodes/node_wrapper.h"
 
 namespace v8_dom {
 
+const WrapperTypeInfo StaticRangeWrapper::kTypeInfo = {"StaticRange", &AbstractRangeWrapper::kTypeInfo};
+
+namespace {
+
+DOMStaticRange* ThisStaticRange(v8::Isolate* isolate, v8::Local<v8::Object> receiver) {
+    DOMStaticRange* range = StaticRangeWrapper::Unwrap(receiver);
+    if (!range) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Invalid StaticRange object")));
+    }
+    return range;
+}
+
+} // namespace
+
 v8::Local<v8::Object> StaticRangeWrapper::Wrap(v8::Isolate* isolate,
                                               v8::Local<v8::Context> context,
                                               DOMStaticRange* obj) {
-    if (!obj) {
-        return v8::Local<v8::Object>();
-    }
-    
-    // Check wrapper cache first
-    WrapperCache* cache = WrapperCache::ForIsolate(isolate);
-    if (cache->Has(obj)) {
-        return cache->Get(isolate, obj);
-    }
-    
-    // Create new wrapper
-    v8::EscapableHandleScope handle_scope(isolate);
-    v8::Local<v8::FunctionTemplate> tmpl = GetTemplate(isolate);
-    v8::Local<v8::Function> constructor = tmpl->GetFunction(context).ToLocalChecked();
-    v8::Local<v8::Object> wrapper = constructor->NewInstance(context).ToLocalChecked();
-    
-    // Store C pointer in internal field
-    wrapper->SetInternalField(0, v8::External::New(isolate, obj));
-    
-    // Increment C-side reference count
-    dom_staticrange_addref(obj);
-    
-    // Cache with release callback
-    cache->Set(isolate, obj, wrapper, [](void* ptr) {
-        dom_staticrange_release(static_cast<DOMStaticRange*>(ptr));
-    });
-    
-    return handle_scope.Escape(wrapper);
+    return WrapWithTraits<StaticRangeWrapper>(isolate, context, obj);
 }
 
 DOMStaticRange* StaticRangeWrapper::Unwrap(v8::Local<v8::Object> obj) {
-    if (obj.IsEmpty() || obj->InternalFieldCount() < 1) {
-        return nullptr;
-    }
-    
-    v8::Local<v8::Value> ptr = obj->GetInternalField(0).As<v8::Value>();
-    if (!ptr->IsExternal()) {
-        return nullptr;
-    }
-    
-    return static_cast<DOMStaticRange*>(v8::Local<v8::External>::Cast(ptr)->Value());
+    return UnwrapWithTraits<StaticRangeWrapper>(obj);
+}
+
+const PropertyDescriptor StaticRangeWrapper::kProperties[] = {
+    // Readonly properties (AbstractRange)
+    DataProperty("startContainer", StartContainerGetter),
+    DataProperty("startOffset", StartOffsetGetter),
+    DataProperty("endContainer", EndContainerGetter),
+    DataProperty("endOffset", EndOffsetGetter),
+    DataProperty("collapsed", CollapsedGetter),
+};
+
+void StaticRangeWrapper::RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+    RegisterProperties(registry, kProperties);
 }
 
 void StaticRangeWrapper::InstallTemplate(v8::Isolate* isolate) {
     v8::Local<v8::FunctionTemplate> tmpl = v8::FunctionTemplate::New(isolate);
     tmpl->SetClassName(v8::String::NewFromUtf8Literal(isolate, "StaticRange"));
-    tmpl->InstanceTemplate()->SetInternalFieldCount(1);
+    tmpl->InstanceTemplate()->SetInternalFieldCount(kWrapperFieldCount);
     
     // Inherit from AbstractRange
     tmpl->Inherit(AbstractRangeWrapper::GetTemplate(isolate));
 
-    // Get prototype template for adding properties/methods
-    v8::Local<v8::ObjectTemplate> proto = tmpl->PrototypeTemplate();
-    
-    // TODO: Add properties and methods here
-    // Example:
-    // proto->SetNativeDataProperty(v8::String::NewFromUtf8Literal(isolate, "propertyName"),
-    //                   PropertyNameGetter, PropertyNameSetter);
-    // proto->Set(v8::String::NewFromUtf8Literal(isolate, "methodName"),
-    //           v8::FunctionTemplate::New(isolate, MethodName));
+    InstallProperties(isolate, tmpl, kProperties);
     
     // Cache the template
     TemplateCache* cache = TemplateCache::ForIsolate(isolate);
@@ -84,4 +69,56 @@ v8::Local<v8::FunctionTemplate> StaticRangeWrapper::GetTemplate(v8::Isolate* iso
     return cache->Get(kTemplateIndex);
 }
 
+void StaticRangeWrapper::StartContainerGetter(v8::Local<v8::Name> property,
+                                              const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("StaticRangeWrapper::StartContainerGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    DOMStaticRange* range = ThisStaticRange(isolate, info.This());
+    if (!range) return;
+
+    DOMNode* node = dom_staticrange_get_startcontainer(range);
+    info.GetReturnValue().Set(NodeWrapper::Wrap(isolate, isolate->GetCurrentContext(), node));
+}
+
+void StaticRangeWrapper::StartOffsetGetter(v8::Local<v8::Name> property,
+                                           const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("StaticRangeWrapper::StartOffsetGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    DOMStaticRange* range = ThisStaticRange(isolate, info.This());
+    if (!range) return;
+
+    info.GetReturnValue().Set(dom_staticrange_get_startoffset(range));
+}
+
+void StaticRangeWrapper::EndContainerGetter(v8::Local<v8::Name> property,
+                                            const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("StaticRangeWrapper::EndContainerGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    DOMStaticRange* range = ThisStaticRange(isolate, info.This());
+    if (!range) return;
+
+    DOMNode* node = dom_staticrange_get_endcontainer(range);
+    info.GetReturnValue().Set(NodeWrapper::Wrap(isolate, isolate->GetCurrentContext(), node));
+}
+
+void StaticRangeWrapper::EndOffsetGetter(v8::Local<v8::Name> property,
+                                         const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("StaticRangeWrapper::EndOffsetGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    DOMStaticRange* range = ThisStaticRange(isolate, info.This());
+    if (!range) return;
+
+    info.GetReturnValue().Set(dom_staticrange_get_endoffset(range));
+}
+
+void StaticRangeWrapper::CollapsedGetter(v8::Local<v8::Name> property,
+                                         const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("StaticRangeWrapper::CollapsedGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    DOMStaticRange* range = ThisStaticRange(isolate, info.This());
+    if (!range) return;
+
+    info.GetReturnValue().Set(dom_staticrange_get_collapsed(range) != 0);
+}
+
 } // namespace v8_dom
@@ -2,72 +2,47 @@
 #include "../wrapper_cache.h"
 #include "../core/template_cache.h"
 #include "../core/utilities.h"
+#include "../collections/nodelist_wrapper.h"
+#include "../nodes/element_wrapper.h"
 
 namespace v8_dom {
 
+const WrapperTypeInfo ShadowRootWrapper::kTypeInfo = {"ShadowRoot", &DocumentFragmentWrapper::kTypeInfo};
+
 v8::Local<v8::Object> ShadowRootWrapper::Wrap(v8::Isolate* isolate,
                                               v8::Local<v8::Context> context,
                                               DOMShadowRoot* obj) {
-    if (!obj) {
-        return v8::Local<v8::Object>();
-    }
-    
-    // Check wrapper cache first
-    WrapperCache* cache = WrapperCache::ForIsolate(isolate);
-    if (cache->Has(obj)) {
-        return cache->Get(isolate, obj);
-    }
-    
-    // Create new wrapper
-    v8::EscapableHandleScope handle_scope(isolate);
-    v8::Local<v8::FunctionTemplate> tmpl = GetTemplate(isolate);
-    v8::Local<v8::Function> constructor = tmpl->GetFunction(context).ToLocalChecked();
-    v8::Local<v8::Object> wrapper = constructor->NewInstance(context).ToLocalChecked();
-    
-    // Store C pointer in internal field
-    wrapper->SetInternalField(0, v8::External::New(isolate, obj));
-    
-    // Increment C-side reference count
-    dom_shadowroot_addref(obj);
-    
-    // Cache with release callback
-    cache->Set(isolate, obj, wrapper, [](void* ptr) {
-        dom_shadowroot_release(static_cast<DOMShadowRoot*>(ptr));
-    });
-    
-    return handle_scope.Escape(wrapper);
+    return WrapWithTraits<ShadowRootWrapper>(isolate, context, obj);
 }
 
 DOMShadowRoot* ShadowRootWrapper::Unwrap(v8::Local<v8::Object> obj) {
-    if (obj.IsEmpty() || obj->InternalFieldCount() < 1) {
-        return nullptr;
-    }
-    
-    v8::Local<v8::Value> ptr = obj->GetInternalField(0).As<v8::Value>();
-    if (!ptr->IsExternal()) {
-        return nullptr;
-    }
-    
-    return static_cast<DOMShadowRoot*>(v8::Local<v8::External>::Cast(ptr)->Value());
+    return UnwrapWithTraits<ShadowRootWrapper>(obj);
 }
 
+const PropertyDescriptor ShadowRootWrapper::kProperties[] = {
+    // Readonly properties
+    DataProperty("mode", ModeGetter),
+    DataProperty("delegatesFocus", DelegatesFocusGetter),
+    DataProperty("slotAssignment", SlotAssignmentGetter),
+    DataProperty("clonable", ClonableGetter),
+    DataProperty("serializable", SerializableGetter),
+    DataProperty("host", HostGetter),
+    
+    // Methods - NonElementParentNode and ParentNode mixins (shadow tree only)
+    MethodProperty("getElementById", GetElementById),
+    MethodProperty("querySelector", QuerySelector),
+    MethodProperty("querySelectorAll", QuerySelectorAll),
+};
+
 void ShadowRootWrapper::InstallTemplate(v8::Isolate* isolate) {
     v8::Local<v8::FunctionTemplate> tmpl = v8::FunctionTemplate::New(isolate);
     tmpl->SetClassName(v8::String::NewFromUtf8Literal(isolate, "ShadowRoot"));
-    tmpl->InstanceTemplate()->SetInternalFieldCount(1);
+    tmpl->InstanceTemplate()->SetInternalFieldCount(kWrapperFieldCount);
     
     // Inherit from DocumentFragment
     tmpl->Inherit(DocumentFragmentWrapper::GetTemplate(isolate));
 
-    // Get prototype template for adding properties/methods
-    v8::Local<v8::ObjectTemplate> proto = tmpl->PrototypeTemplate();
-    
-    // TODO: Add properties and methods here
-    // Example:
-    // proto->SetNativeDataProperty(v8::String::NewFromUtf8Literal(isolate, "propertyName"),
-    //                   PropertyNameGetter, PropertyNameSetter);
-    // proto->Set(v8::String::NewFromUtf8Literal(isolate, "methodName"),
-    //           v8::FunctionTemplate::New(isolate, MethodName));
+    InstallProperties(isolate, tmpl, kProperties);
     
     // Cache the template
     TemplateCache* cache = TemplateCache::ForIsolate(isolate);
@@ -84,4 +59,181 @@ v8::Local<v8::FunctionTemplate> ShadowRootWrapper::GetTemplate(v8::Isolate* isol
     return cache->Get(kTemplateIndex);
 }
 
+void ShadowRootWrapper::RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+    RegisterProperties(registry, kProperties);
+}
+
+// ============================================================================
+// Property Implementations - Readonly
+// ============================================================================
+
+void ShadowRootWrapper::ModeGetter(v8::Local<v8::Name> property,
+                                   const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("ShadowRootWrapper::ModeGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    DOMShadowRoot* shadow = Unwrap(info.This());
+    if (!shadow) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Invalid ShadowRoot")));
+        return;
+    }
+    
+    if (dom_shadowroot_get_mode(shadow) == DOM_SHADOWROOT_MODE_CLOSED) {
+        info.GetReturnValue().Set(v8::String::NewFromUtf8Literal(isolate, "closed"));
+    } else {
+        info.GetReturnValue().Set(v8::String::NewFromUtf8Literal(isolate, "open"));
+    }
+}
+
+void ShadowRootWrapper::DelegatesFocusGetter(v8::Local<v8::Name> property,
+                                             const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("ShadowRootWrapper::DelegatesFocusGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    DOMShadowRoot* shadow = Unwrap(info.This());
+    if (!shadow) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Invalid ShadowRoot")));
+        return;
+    }
+    
+    info.GetReturnValue().Set(dom_shadowroot_get_delegatesfocus(shadow));
+}
+
+void ShadowRootWrapper::SlotAssignmentGetter(v8::Local<v8::Name> property,
+                                             const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("ShadowRootWrapper::SlotAssignmentGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    DOMShadowRoot* shadow = Unwrap(info.This());
+    if (!shadow) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Invalid ShadowRoot")));
+        return;
+    }
+    
+    if (dom_shadowroot_get_slotassignment(shadow) == DOM_SLOTASSIGNMENT_MANUAL) {
+        info.GetReturnValue().Set(v8::String::NewFromUtf8Literal(isolate, "manual"));
+    } else {
+        info.GetReturnValue().Set(v8::String::NewFromUtf8Literal(isolate, "named"));
+    }
+}
+
+void ShadowRootWrapper::ClonableGetter(v8::Local<v8::Name> property,
+                                       const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("ShadowRootWrapper::ClonableGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    DOMShadowRoot* shadow = Unwrap(info.This());
+    if (!shadow) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Invalid ShadowRoot")));
+        return;
+    }
+    
+    info.GetReturnValue().Set(dom_shadowroot_get_clonable(shadow));
+}
+
+void ShadowRootWrapper::SerializableGetter(v8::Local<v8::Name> property,
+                                           const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("ShadowRootWrapper::SerializableGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    DOMShadowRoot* shadow = Unwrap(info.This());
+    if (!shadow) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Invalid ShadowRoot")));
+        return;
+    }
+    
+    info.GetReturnValue().Set(dom_shadowroot_get_serializable(shadow));
+}
+
+void ShadowRootWrapper::HostGetter(v8::Local<v8::Name> property,
+                                   const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("ShadowRootWrapper::HostGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    DOMShadowRoot* shadow = Unwrap(info.This());
+    if (!shadow) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Invalid ShadowRoot")));
+        return;
+    }
+    
+    DOMElement* host = dom_shadowroot_get_host(shadow);
+    info.GetReturnValue().Set(ElementWrapper::Wrap(isolate, isolate->GetCurrentContext(), host));
+}
+
+// ============================================================================
+// Method Implementations
+// ============================================================================
+
+void ShadowRootWrapper::GetElementById(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ShadowRootWrapper::GetElementById");
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    DOMShadowRoot* shadow = UnwrapReceiver<DOMShadowRoot>(args);
+    if (!shadow) {
+        return;
+    }
+    
+    if (args.Length() < 1) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "getElementById requires 1 argument")));
+        return;
+    }
+    
+    StringArgFromV8 element_id(isolate, args[0]);
+    DOMElement* result = dom_shadowroot_getelementbyid(shadow, element_id.data());
+    
+    if (result) {
+        args.GetReturnValue().Set(ElementWrapper::Wrap(isolate, context, result));
+    } else {
+        args.GetReturnValue().SetNull();
+    }
+}
+
+void ShadowRootWrapper::QuerySelector(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ShadowRootWrapper::QuerySelector");
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    DOMShadowRoot* shadow = UnwrapReceiver<DOMShadowRoot>(args);
+    if (!shadow) {
+        return;
+    }
+    
+    if (args.Length() < 1) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "querySelector requires 1 argument")));
+        return;
+    }
+    
+    StringArgFromV8 selectors(isolate, args[0]);
+    DOMElement* result = dom_shadowroot_queryselector(shadow, selectors.data());
+    
+    if (result) {
+        args.GetReturnValue().Set(ElementWrapper::Wrap(isolate, context, result));
+    } else {
+        args.GetReturnValue().SetNull();
+    }
+}
+
+void ShadowRootWrapper::QuerySelectorAll(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ShadowRootWrapper::QuerySelectorAll");
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    DOMShadowRoot* shadow = UnwrapReceiver<DOMShadowRoot>(args);
+    if (!shadow) {
+        return;
+    }
+    
+    if (args.Length() < 1) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "querySelectorAll requires 1 argument")));
+        return;
+    }
+    
+    StringArgFromV8 selectors(isolate, args[0]);
+    DOMNodeList* result = dom_shadowroot_queryselectorall(shadow, selectors.data());
+    
+    // No matches wraps as an empty NodeList
+    args.GetReturnValue().Set(NodeListWrapper::Wrap(isolate, context, result));
+}
+
 } // namespace v8_dom
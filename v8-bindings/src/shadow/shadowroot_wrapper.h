@@ -9,6 +9,9 @@
 #define V8_DOM_SHADOWROOT_WRAPPER_H
 
 #include <v8.h>
+#include "../core/wrapper_traits.h"
+#include "../core/external_references.h"
+#include "../core/property_table.h"
 #include "../nodes/documentfragment_wrapper.h"
 #include "dom.h"
 
@@ -42,11 +45,40 @@ public:
     /**
      * Template cache index.
      */
-    static constexpr int kTemplateIndex = 26;
+    static constexpr int kTemplateIndex = WrapperTraits<ShadowRootWrapper>::kTemplateIndex;
+    
+    /**
+     * Type tag stored in the wrapper's type internal field.
+     */
+    static const WrapperTypeInfo kTypeInfo;
+    
+    /**
+     * Register this wrapper's callbacks for snapshot serialization.
+     */
+    static void RegisterExternalReferences(ExternalReferenceRegistry* registry);
     
 private:
-    // Property getters/setters and methods will be added here
-    // TODO: Parse dom.h to auto-generate these declarations
+    // Prototype members, installed by InstallTemplate()
+    static const PropertyDescriptor kProperties[];
+    
+    // Readonly properties
+    static void ModeGetter(v8::Local<v8::Name> property,
+                           const v8::PropertyCallbackInfo<v8::Value>& info);
+    static void DelegatesFocusGetter(v8::Local<v8::Name> property,
+                                     const v8::PropertyCallbackInfo<v8::Value>& info);
+    static void SlotAssignmentGetter(v8::Local<v8::Name> property,
+                                     const v8::PropertyCallbackInfo<v8::Value>& info);
+    static void ClonableGetter(v8::Local<v8::Name> property,
+                               const v8::PropertyCallbackInfo<v8::Value>& info);
+    static void SerializableGetter(v8::Local<v8::Name> property,
+                                   const v8::PropertyCallbackInfo<v8::Value>& info);
+    static void HostGetter(v8::Local<v8::Name> property,
+                           const v8::PropertyCallbackInfo<v8::Value>& info);
+    
+    // Methods (NonElementParentNode and ParentNode mixins, scoped to the shadow tree)
+    static void GetElementById(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void QuerySelector(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void QuerySelectorAll(const v8::FunctionCallbackInfo<v8::Value>& args);
 };
 
 } // namespace v8_dom
@@ -0,0 +1,156 @@
+#include "elementiterator_wrapper.h"
+#include "../nodes/node_wrapper.h"
+#include "../nodes/element_wrapper.h"
+#include "../wrapper_cache.h"
+#include "../core/template_cache.h"
+#include "../core/utilities.h"
+
+namespace v8_dom {
+
+const WrapperTypeInfo ElementIteratorWrapper::kTypeInfo = {"ElementIterator", nullptr};
+
+namespace {
+
+/**
+ * An iterator result object ({value, done}).
+ */
+v8::Local<v8::Object> IteratorResult(v8::Isolate* isolate, v8::Local<v8::Context> context,
+                                     v8::Local<v8::Value> value, bool done) {
+    v8::Local<v8::Object> result = v8::Object::New(isolate);
+    result->CreateDataProperty(context, v8::String::NewFromUtf8Literal(isolate, "value"), value).Check();
+    result->CreateDataProperty(context, v8::String::NewFromUtf8Literal(isolate, "done"),
+                               v8::Boolean::New(isolate, done)).Check();
+    return result;
+}
+
+} // namespace
+
+v8::MaybeLocal<v8::Object> ElementIteratorWrapper::Create(v8::Isolate* isolate,
+                                                          v8::Local<v8::Context> context,
+                                                          DOMNode* root) {
+    v8::EscapableHandleScope handle_scope(isolate);
+
+    ScriptElementIterator* state = new ScriptElementIterator();
+    state->root = root;
+    state->document = dom_node_get_nodetype(root) == DOM_DOCUMENT_NODE
+        ? reinterpret_cast<DOMDocument*>(root)
+        : dom_node_get_ownerdocument(root);
+    state->iterator = dom_elementiterator_new(root);
+    if (!state->iterator) {
+        delete state;
+        ThrowDOMException(isolate, 22);
+        return v8::MaybeLocal<v8::Object>();
+    }
+
+    v8::Local<v8::Function> constructor =
+        TemplateCache::ForIsolate(isolate)->GetConstructor(context, kTemplateIndex, GetTemplate);
+    v8::Local<v8::Object> wrapper = constructor->NewInstance(context).ToLocalChecked();
+    SetWrapperFields(wrapper, state, &kTypeInfo);
+
+    WrapperCache::ForIsolate(isolate)->Set(isolate, state, wrapper, [](void* ptr) {
+        ScriptElementIterator* state = static_cast<ScriptElementIterator*>(ptr);
+        dom_elementiterator_release(state->iterator);
+        delete state;
+    });
+
+    return handle_scope.Escape(wrapper);
+}
+
+ScriptElementIterator* ElementIteratorWrapper::Unwrap(v8::Local<v8::Object> obj) {
+    return static_cast<ScriptElementIterator*>(UnwrapObject(obj, &kTypeInfo));
+}
+
+const PropertyDescriptor ElementIteratorWrapper::kProperties[] = {
+    // Methods
+    MethodProperty("next", Next),
+};
+
+void ElementIteratorWrapper::InstallTemplate(v8::Isolate* isolate) {
+    v8::Local<v8::FunctionTemplate> tmpl = v8::FunctionTemplate::New(isolate);
+    tmpl->SetClassName(v8::String::NewFromUtf8Literal(isolate, "ElementIterator"));
+    tmpl->InstanceTemplate()->SetInternalFieldCount(kWrapperFieldCount);
+
+    InstallProperties(isolate, tmpl, kProperties);
+
+    // Iterable: [Symbol.iterator]() returns the iterator itself
+    tmpl->PrototypeTemplate()->Set(v8::Symbol::GetIterator(isolate),
+                                   v8::FunctionTemplate::New(isolate, Iterator),
+                                   v8::DontEnum);
+
+    // Cache the template
+    TemplateCache* cache = TemplateCache::ForIsolate(isolate);
+    cache->Set(kTemplateIndex, tmpl);
+}
+
+v8::Local<v8::FunctionTemplate> ElementIteratorWrapper::GetTemplate(v8::Isolate* isolate) {
+    TemplateCache* cache = TemplateCache::ForIsolate(isolate);
+
+    if (!cache->Has(kTemplateIndex)) {
+        InstallTemplate(isolate);
+    }
+
+    return cache->Get(kTemplateIndex);
+}
+
+void ElementIteratorWrapper::RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+    registry->Register(Iterator);
+    RegisterProperties(registry, kProperties);
+}
+
+// ============================================================================
+// Methods
+// ============================================================================
+
+void ElementIteratorWrapper::Elements(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ElementIteratorWrapper::Elements");
+    v8::Isolate* isolate = args.GetIsolate();
+    DOMNode* root = UnwrapReceiver<DOMNode>(args);
+    if (!root) {
+        return;
+    }
+
+    v8::Local<v8::Object> wrapper;
+    if (!Create(isolate, isolate->GetCurrentContext(), root).ToLocal(&wrapper)) return;
+    args.GetReturnValue().Set(wrapper);
+}
+
+void ElementIteratorWrapper::Next(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("ElementIteratorWrapper::Next");
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    ScriptElementIterator* state = UnwrapReceiver<ScriptElementIterator>(args);
+    if (!state) return;
+
+    // Buffered elements may have moved or been freed since the batch
+    uint64_t version = dom_document_get_mutation_version(state->document);
+    if (state->index < state->count && version != state->version) {
+        dom_elementiterator_seek(state->iterator, state->last ? (DOMNode*)state->last : state->root);
+        state->index = state->count = 0;
+    }
+
+    if (state->index == state->count && !state->done) {
+        state->count = dom_elementiterator_nextbatch(state->iterator, state->batch,
+                                                     ScriptElementIterator::kBatchSize);
+        state->index = 0;
+        state->version = version;
+        state->done = state->count == 0;
+    }
+    if (state->done) {
+        state->last = nullptr;
+        state->last_wrapper.Reset();
+        args.GetReturnValue().Set(IteratorResult(isolate, context, v8::Undefined(isolate), true));
+        return;
+    }
+
+    DOMElement* element = state->batch[state->index++];
+    v8::Local<v8::Object> wrapper = ElementWrapper::Wrap(isolate, context, element);
+    state->last = element;
+    state->last_wrapper.Reset(isolate, wrapper);
+    args.GetReturnValue().Set(IteratorResult(isolate, context, wrapper, false));
+}
+
+void ElementIteratorWrapper::Iterator(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    args.GetReturnValue().Set(args.This());
+}
+
+} // namespace v8_dom
@@ -0,0 +1,101 @@
+/**
+ * ElementIterator Wrapper - V8 bindings for element-only iteration
+ *
+ * Non-standard: root.elements() (Element, Document, DocumentFragment)
+ * returns an iterator over the root's element descendants in tree order,
+ * usable with for...of and spread. Text and comment nodes are skipped in
+ * Zig, and elements are fetched from the C-ABI in batches of kBatchSize,
+ * so next() crosses into Zig once per batch instead of once per node.
+ * If the document mutates while a batch is buffered, the rest of the
+ * batch is dropped and iteration continues after the last element
+ * returned, at its new position.
+ */
+
+#ifndef V8_DOM_ELEMENTITERATOR_WRAPPER_H
+#define V8_DOM_ELEMENTITERATOR_WRAPPER_H
+
+#include <v8.h>
+#include "../core/wrapper_traits.h"
+#include "../core/external_references.h"
+#include "../core/property_table.h"
+#include "dom.h"
+
+namespace v8_dom {
+
+/**
+ * Binding-side state of one script element iterator.
+ */
+struct ScriptElementIterator {
+    static constexpr uint32_t kBatchSize = 64;
+
+    DOMElementIterator* iterator = nullptr;   // owned
+    DOMNode* root = nullptr;                  // referenced by iterator
+    DOMDocument* document = nullptr;          // mutation version source
+    uint64_t version = 0;                     // when batch was filled
+    DOMElement* batch[kBatchSize];
+    uint32_t index = 0;
+    uint32_t count = 0;
+    bool done = false;
+
+    // Last element returned, kept alive to continue after it
+    DOMElement* last = nullptr;
+    v8::Global<v8::Object> last_wrapper;
+};
+
+class ElementIteratorWrapper {
+public:
+    /**
+     * Create an iterator over root's element descendants and its wrapper.
+     * Returns an empty handle if an exception was thrown.
+     */
+    static v8::MaybeLocal<v8::Object> Create(v8::Isolate* isolate,
+                                             v8::Local<v8::Context> context,
+                                             DOMNode* root);
+
+    /**
+     * Unwrap a V8 object to get the iterator state.
+     */
+    static ScriptElementIterator* Unwrap(v8::Local<v8::Object> obj);
+
+    /**
+     * elements() for the ParentNode prototypes (see node_mixins.h).
+     */
+    static void Elements(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+    /**
+     * Install the ElementIterator template (called once per isolate).
+     */
+    static void InstallTemplate(v8::Isolate* isolate);
+
+    /**
+     * Get the cached ElementIterator template.
+     */
+    static v8::Local<v8::FunctionTemplate> GetTemplate(v8::Isolate* isolate);
+
+    /**
+     * Template cache index.
+     */
+    static constexpr int kTemplateIndex = WrapperTraits<ElementIteratorWrapper>::kTemplateIndex;
+
+    /**
+     * Type tag stored in the wrapper's type internal field.
+     */
+    static const WrapperTypeInfo kTypeInfo;
+
+    /**
+     * Register this wrapper's callbacks for snapshot serialization.
+     */
+    static void RegisterExternalReferences(ExternalReferenceRegistry* registry);
+
+private:
+    // Prototype members, installed by InstallTemplate()
+    static const PropertyDescriptor kProperties[];
+
+    // Methods
+    static void Next(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void Iterator(const v8::FunctionCallbackInfo<v8::Value>& args);
+};
+
+} // namespace v8_dom
+
+#endif // V8_DOM_ELEMENTITERATOR_WRAPPER_H
@@ -0,0 +1,218 @@
+#include "node_filter.h"
+#include "../core/utilities.h"
+
+namespace v8_dom {
+
+namespace {
+
+/**
+ * DOMNodeFilter callback for script filters ("call a user object's
+ * operation" with acceptNode, or the function itself).
+ */
+uint16_t AcceptNode(DOMNode* node, void* user_data) {
+    ScriptNodeFilter* state = static_cast<ScriptNodeFilter*>(user_data);
+    if (state->threw) {
+        return DOM_NODEFILTER_FILTER_REJECT;
+    }
+
+    v8::Isolate* isolate = state->isolate;
+    v8::HandleScope handle_scope(isolate);
+    v8::Local<v8::Context> context = state->context.Get(isolate);
+    v8::Context::Scope context_scope(context);
+    v8::TryCatch try_catch(isolate);
+
+    v8::Local<v8::Value> filter = state->value.Get(isolate);
+    v8::Local<v8::Value> receiver = v8::Undefined(isolate);
+    v8::Local<v8::Function> callback;
+    if (filter->IsFunction()) {
+        callback = filter.As<v8::Function>();
+    } else {
+        v8::Local<v8::Value> method;
+        if (filter.As<v8::Object>()
+                ->Get(context, v8::String::NewFromUtf8Literal(isolate, "acceptNode"))
+                .ToLocal(&method)) {
+            if (method->IsFunction()) {
+                callback = method.As<v8::Function>();
+                receiver = filter;
+            } else {
+                isolate->ThrowException(v8::Exception::TypeError(
+                    v8::String::NewFromUtf8Literal(isolate, "NodeFilter acceptNode is not a function")));
+            }
+        }
+    }
+
+    if (!callback.IsEmpty()) {
+        v8::Local<v8::Value> argv[] = {NodeWrapper::Wrap(isolate, context, node)};
+        state->active = true;
+        v8::MaybeLocal<v8::Value> maybe_result = callback->Call(context, receiver, 1, argv);
+        state->active = false;
+
+        v8::Local<v8::Value> result;
+        uint32_t value;
+        if (maybe_result.ToLocal(&result) && result->Uint32Value(context).To(&value)) {
+            // WebIDL unsigned short
+            return static_cast<uint16_t>(value);
+        }
+    }
+
+    // Leave the exception pending for the step to propagate
+    state->threw = true;
+    try_catch.ReThrow();
+    return DOM_NODEFILTER_FILTER_REJECT;
+}
+
+/**
+ * Compile a declarative { tagNames, className, reject } filter.
+ *
+ * @return false if an exception was thrown
+ */
+bool CompileElementFilter(v8::Isolate* isolate,
+                          v8::Local<v8::Context> context,
+                          v8::Local<v8::Object> filter,
+                          v8::Local<v8::Value> tag_names,
+                          v8::Local<v8::Value> class_name,
+                          ScriptNodeFilter* state) {
+    v8::Local<v8::Value> reject;
+    if (!filter->Get(context, v8::String::NewFromUtf8Literal(isolate, "reject")).ToLocal(&reject)) {
+        return false;
+    }
+
+    uint16_t miss = reject->BooleanValue(isolate) ? DOM_NODEFILTER_FILTER_REJECT
+                                                  : DOM_NODEFILTER_FILTER_SKIP;
+    state->native = dom_elementfilter_new(miss);
+    if (!state->native) {
+        isolate->ThrowException(v8::Exception::Error(
+            v8::String::NewFromUtf8Literal(isolate, "Failed to create filter")));
+        return false;
+    }
+
+    if (!tag_names->IsUndefined()) {
+        if (!tag_names->IsArray()) {
+            isolate->ThrowException(v8::Exception::TypeError(
+                v8::String::NewFromUtf8Literal(isolate, "NodeFilter tagNames must be an array")));
+            return false;
+        }
+        v8::Local<v8::Array> names = tag_names.As<v8::Array>();
+        uint32_t length = names->Length();
+        for (uint32_t i = 0; i < length; i++) {
+            v8::Local<v8::Value> name;
+            if (!names->Get(context, i).ToLocal(&name)) {
+                return false;
+            }
+            StringArgFromV8 tag(isolate, name);
+            if (!tag.data()) {
+                return false;
+            }
+            int32_t err = dom_elementfilter_add_tagname(state->native, tag.data(), tag.length());
+            if (err != 0) {
+                ThrowDOMException(isolate, err);
+                return false;
+            }
+        }
+    }
+
+    if (!class_name->IsUndefined()) {
+        StringArgFromV8 name(isolate, class_name);
+        if (!name.data()) {
+            return false;
+        }
+        int32_t err = dom_elementfilter_set_classname(state->native, name.data(), name.length());
+        if (err != 0) {
+            ThrowDOMException(isolate, err);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace
+
+ScriptNodeFilter::~ScriptNodeFilter() {
+    if (native) {
+        dom_elementfilter_release(native);
+    }
+}
+
+bool InitScriptNodeFilter(v8::Isolate* isolate,
+                          v8::Local<v8::Context> context,
+                          v8::Local<v8::Object> root,
+                          v8::Local<v8::Value> filter,
+                          ScriptNodeFilter* state) {
+    state->isolate = isolate;
+    state->context.Reset(isolate, context);
+    state->root.Reset(isolate, root);
+
+    if (IsNullOrUndefined(filter)) {
+        state->value.Reset(isolate, v8::Null(isolate));
+        return true;
+    }
+    state->value.Reset(isolate, filter);
+
+    if (filter->IsObject() && !filter->IsFunction()) {
+        v8::Local<v8::Object> object = filter.As<v8::Object>();
+        v8::Local<v8::Value> tag_names;
+        v8::Local<v8::Value> class_name;
+        if (!object->Get(context, v8::String::NewFromUtf8Literal(isolate, "tagNames")).ToLocal(&tag_names) ||
+            !object->Get(context, v8::String::NewFromUtf8Literal(isolate, "className")).ToLocal(&class_name)) {
+            return false;
+        }
+        if (!tag_names->IsUndefined() || !class_name->IsUndefined()) {
+            return CompileElementFilter(isolate, context, object, tag_names, class_name, state);
+        }
+    }
+
+    // Script filter; acceptNode is looked up on every call, as the spec does
+    state->callback.accept_node = AcceptNode;
+    state->callback.user_data = state;
+    return true;
+}
+
+bool BeginFilteredStep(v8::Isolate* isolate, ScriptNodeFilter* state) {
+    if (state->active) {
+        ThrowDOMException(isolate, DOM_ERROR_INVALID_STATE);
+        return false;
+    }
+    state->threw = false;
+    return true;
+}
+
+bool EndFilteredStep(v8::Isolate* isolate, ScriptNodeFilter* state) {
+    return !state->threw;
+}
+
+v8::Local<v8::ObjectTemplate> CreateNodeFilterTemplate(v8::Isolate* isolate) {
+    v8::Local<v8::ObjectTemplate> tmpl = v8::ObjectTemplate::New(isolate);
+
+    struct NodeFilterConstant {
+        const char* name;
+        uint32_t value;
+    };
+    static const NodeFilterConstant kConstants[] = {
+        {"FILTER_ACCEPT", DOM_NODEFILTER_FILTER_ACCEPT},
+        {"FILTER_REJECT", DOM_NODEFILTER_FILTER_REJECT},
+        {"FILTER_SKIP", DOM_NODEFILTER_FILTER_SKIP},
+        {"SHOW_ALL", DOM_NODEFILTER_SHOW_ALL},
+        {"SHOW_ELEMENT", DOM_NODEFILTER_SHOW_ELEMENT},
+        {"SHOW_ATTRIBUTE", DOM_NODEFILTER_SHOW_ATTRIBUTE},
+        {"SHOW_TEXT", DOM_NODEFILTER_SHOW_TEXT},
+        {"SHOW_CDATA_SECTION", DOM_NODEFILTER_SHOW_CDATA_SECTION},
+        {"SHOW_ENTITY_REFERENCE", DOM_NODEFILTER_SHOW_ENTITY_REFERENCE},
+        {"SHOW_ENTITY", DOM_NODEFILTER_SHOW_ENTITY},
+        {"SHOW_PROCESSING_INSTRUCTION", DOM_NODEFILTER_SHOW_PROCESSING_INSTRUCTION},
+        {"SHOW_COMMENT", DOM_NODEFILTER_SHOW_COMMENT},
+        {"SHOW_DOCUMENT", DOM_NODEFILTER_SHOW_DOCUMENT},
+        {"SHOW_DOCUMENT_TYPE", DOM_NODEFILTER_SHOW_DOCUMENT_TYPE},
+        {"SHOW_DOCUMENT_FRAGMENT", DOM_NODEFILTER_SHOW_DOCUMENT_FRAGMENT},
+        {"SHOW_NOTATION", DOM_NODEFILTER_SHOW_NOTATION},
+    };
+    for (const NodeFilterConstant& constant : kConstants) {
+        v8::Local<v8::String> name = v8::String::NewFromUtf8(isolate, constant.name).ToLocalChecked();
+        auto attributes = static_cast<v8::PropertyAttribute>(v8::ReadOnly | v8::DontDelete);
+        tmpl->Set(name, v8::Integer::NewFromUnsigned(isolate, constant.value), attributes);
+    }
+
+    return tmpl;
+}
+
+} // namespace v8_dom
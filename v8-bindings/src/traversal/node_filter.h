@@ -0,0 +1,135 @@
+/**
+ * Script NodeFilter - the filter argument of createTreeWalker / createNodeIterator
+ *
+ * The filter is resolved once, when the walker or iterator is created:
+ * - null/undefined: whatToShow alone, applied in Zig (no callback)
+ * - a function, or an object with acceptNode: called through a C-ABI
+ *   DOMNodeFilter once per node that passes whatToShow
+ * - non-standard declarative filter { tagNames: [...], className: "...",
+ *   reject: bool }: compiled to a DOMElementFilter and evaluated in Zig;
+ *   non-matching nodes are skipped (or rejected with reject: true)
+ *
+ * A script filter that throws makes the rest of the step reject every node
+ * without calling it again; the exception stays pending and propagates once
+ * the step returns.
+ */
+
+#ifndef V8_DOM_NODE_FILTER_H
+#define V8_DOM_NODE_FILTER_H
+
+#include <v8.h>
+#include <algorithm>
+#include <vector>
+#include "../nodes/node_wrapper.h"
+#include "dom.h"
+
+namespace v8_dom {
+
+/**
+ * Binding-side filter state shared by TreeWalker and NodeIterator.
+ */
+struct ScriptNodeFilter {
+    v8::Isolate* isolate = nullptr;
+    v8::Global<v8::Context> context;   // the filter's realm
+    v8::Global<v8::Value> value;       // the filter as passed (the filter attribute)
+    v8::Global<v8::Object> root;       // keeps the root node alive
+    DOMNodeFilter callback{};          // script filters; user_data is this
+    DOMElementFilter* native = nullptr;  // declarative filters (owned)
+    bool active = false;               // a script filter is running
+    bool threw = false;                // the filter threw during the current step
+
+    ScriptNodeFilter() = default;
+    ScriptNodeFilter(const ScriptNodeFilter&) = delete;
+    ScriptNodeFilter& operator=(const ScriptNodeFilter&) = delete;
+    ~ScriptNodeFilter();
+
+    /**
+     * The C-ABI callback filter, or nullptr for native and absent filters.
+     */
+    const DOMNodeFilter* Callback() const {
+        return callback.accept_node ? &callback : nullptr;
+    }
+};
+
+/**
+ * Resolve a filter argument into `state`.
+ *
+ * @return false if an exception was thrown (invalid declarative filter)
+ */
+bool InitScriptNodeFilter(v8::Isolate* isolate,
+                          v8::Local<v8::Context> context,
+                          v8::Local<v8::Object> root,
+                          v8::Local<v8::Value> filter,
+                          ScriptNodeFilter* state);
+
+/**
+ * Enter a traversal step; throws InvalidStateError and returns false if the
+ * filter is already running (a filter re-entering its own walker).
+ */
+bool BeginFilteredStep(v8::Isolate* isolate, ScriptNodeFilter* state);
+
+/**
+ * Leave a traversal step; returns false if the filter threw (its exception
+ * is pending).
+ */
+bool EndFilteredStep(v8::Isolate* isolate, ScriptNodeFilter* state);
+
+/**
+ * nextNodes(n) for TreeWalker and NodeIterator (non-standard): up to n
+ * following nodes as one array of wrappers.
+ *
+ * Without a script filter no script can run mid-batch, so nodes are
+ * fetched a buffer at a time through `next_nodes`. A script filter runs
+ * (and may mutate the tree) between nodes, so each node is fetched with
+ * `next_node` and wrapped before the next is looked up.
+ */
+template <typename Traversal>
+void NextNodesStep(const v8::FunctionCallbackInfo<v8::Value>& args,
+                   ScriptNodeFilter* state,
+                   Traversal* traversal,
+                   uint32_t (*next_nodes)(Traversal*, DOMNode**, uint32_t),
+                   DOMNode* (*next_node)(Traversal*)) {
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    if (args.Length() < 1) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Count argument required")));
+        return;
+    }
+    uint32_t count;
+    if (!args[0]->Uint32Value(context).To(&count)) return;
+    if (!BeginFilteredStep(isolate, state)) return;
+
+    std::vector<v8::Local<v8::Value>> nodes;
+    nodes.reserve(std::min<uint32_t>(count, 1024));
+
+    if (!state->Callback()) {
+        DOMNode* buffer[128];
+        while (nodes.size() < count) {
+            uint32_t wanted = std::min<uint32_t>(count - static_cast<uint32_t>(nodes.size()), 128);
+            uint32_t got = next_nodes(traversal, buffer, wanted);
+            for (uint32_t i = 0; i < got; i++) {
+                nodes.push_back(NodeWrapper::Wrap(isolate, context, buffer[i]));
+            }
+            if (got < wanted) break;
+        }
+    } else {
+        while (nodes.size() < count) {
+            DOMNode* node = next_node(traversal);
+            if (!EndFilteredStep(isolate, state)) return;
+            if (!node) break;
+            nodes.push_back(NodeWrapper::Wrap(isolate, context, node));
+        }
+    }
+
+    args.GetReturnValue().Set(v8::Array::New(isolate, nodes.data(), nodes.size()));
+}
+
+/**
+ * Template for the global NodeFilter object (FILTER_* and SHOW_* constants).
+ */
+v8::Local<v8::ObjectTemplate> CreateNodeFilterTemplate(v8::Isolate* isolate);
+
+} // namespace v8_dom
+
+#endif // V8_DOM_NODE_FILTER_H
@@ -1,72 +1,112 @@
 #include "nodeiterator_wrapper.h"
+#include "../nodes/node_wrapper.h"
 #include "../wrapper_cache.h"
 #include "../core/template_cache.h"
 #include "../core/utilities.h"
 
 namespace v8_dom {
 
-v8::Local<v8::Object> NodeIteratorWrapper::Wrap(v8::Isolate* isolate,
-                                              v8::Local<v8::Context> context,
-                                              DOMNodeIterator* obj) {
-    if (!obj) {
-        return v8::Local<v8::Object>();
+const WrapperTypeInfo NodeIteratorWrapper::kTypeInfo = {"NodeIterator", nullptr};
+
+namespace {
+
+ScriptNodeIterator* ThisIterator(v8::Isolate* isolate, v8::Local<v8::Object> receiver) {
+    ScriptNodeIterator* state = NodeIteratorWrapper::Unwrap(receiver);
+    if (!state) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Invalid NodeIterator object")));
     }
-    
-    // Check wrapper cache first
-    WrapperCache* cache = WrapperCache::ForIsolate(isolate);
-    if (cache->Has(obj)) {
-        return cache->Get(isolate, obj);
+    return state;
+}
+
+/**
+ * Run one filtered traversal step and return its node (or null).
+ */
+void Step(const v8::FunctionCallbackInfo<v8::Value>& args, DOMNode* (*step)(DOMNodeIterator*)) {
+    v8::Isolate* isolate = args.GetIsolate();
+    ScriptNodeIterator* state = ThisIterator(isolate, args.This());
+    if (!state || !BeginFilteredStep(isolate, &state->filter)) return;
+
+    DOMNode* node = step(state->iterator);
+    if (!EndFilteredStep(isolate, &state->filter)) return;
+
+    if (!node) {
+        args.GetReturnValue().SetNull();
+        return;
     }
-    
-    // Create new wrapper
+    args.GetReturnValue().Set(NodeWrapper::Wrap(isolate, isolate->GetCurrentContext(), node));
+}
+
+} // namespace
+
+v8::MaybeLocal<v8::Object> NodeIteratorWrapper::Create(v8::Isolate* isolate,
+                                                       v8::Local<v8::Context> context,
+                                                       DOMDocument* doc,
+                                                       v8::Local<v8::Object> root,
+                                                       uint32_t what_to_show,
+                                                       v8::Local<v8::Value> filter) {
     v8::EscapableHandleScope handle_scope(isolate);
-    v8::Local<v8::FunctionTemplate> tmpl = GetTemplate(isolate);
-    v8::Local<v8::Function> constructor = tmpl->GetFunction(context).ToLocalChecked();
+
+    ScriptNodeIterator* state = new ScriptNodeIterator();
+    if (!InitScriptNodeFilter(isolate, context, root, filter, &state->filter)) {
+        delete state;
+        return v8::MaybeLocal<v8::Object>();
+    }
+
+    DOMNode* root_node = NodeWrapper::Unwrap(root);
+    state->iterator = state->filter.native
+        ? dom_document_createnodeiterator_native(doc, root_node, what_to_show, state->filter.native)
+        : dom_document_createnodeiterator(doc, root_node, what_to_show, state->filter.Callback());
+    if (!state->iterator) {
+        delete state;
+        isolate->ThrowException(v8::Exception::Error(
+            v8::String::NewFromUtf8Literal(isolate, "Failed to create node iterator")));
+        return v8::MaybeLocal<v8::Object>();
+    }
+
+    v8::Local<v8::Function> constructor =
+        TemplateCache::ForIsolate(isolate)->GetConstructor(context, kTemplateIndex, GetTemplate);
     v8::Local<v8::Object> wrapper = constructor->NewInstance(context).ToLocalChecked();
-    
-    // Store C pointer in internal field
-    wrapper->SetInternalField(0, v8::External::New(isolate, obj));
-    
-    // Increment C-side reference count
-    dom_nodeiterator_addref(obj);
-    
-    // Cache with release callback
-    cache->Set(isolate, obj, wrapper, [](void* ptr) {
-        dom_nodeiterator_release(static_cast<DOMNodeIterator*>(ptr));
+    SetWrapperFields(wrapper, state, &kTypeInfo);
+
+    // The iterator goes before its filter: it reads the filter on every step
+    WrapperCache::ForIsolate(isolate)->Set(isolate, state, wrapper, [](void* ptr) {
+        ScriptNodeIterator* state = static_cast<ScriptNodeIterator*>(ptr);
+        dom_nodeiterator_release(state->iterator);
+        delete state;
     });
-    
+
     return handle_scope.Escape(wrapper);
 }
 
-DOMNodeIterator* NodeIteratorWrapper::Unwrap(v8::Local<v8::Object> obj) {
-    if (obj.IsEmpty() || obj->InternalFieldCount() < 1) {
-        return nullptr;
-    }
-    
-    v8::Local<v8::Value> ptr = obj->GetInternalField(0).As<v8::Value>();
-    if (!ptr->IsExternal()) {
-        return nullptr;
-    }
-    
-    return static_cast<DOMNodeIterator*>(v8::Local<v8::External>::Cast(ptr)->Value());
+ScriptNodeIterator* NodeIteratorWrapper::Unwrap(v8::Local<v8::Object> obj) {
+    return static_cast<ScriptNodeIterator*>(UnwrapObject(obj, &kTypeInfo));
 }
 
+const PropertyDescriptor NodeIteratorWrapper::kProperties[] = {
+    // Readonly properties
+    DataProperty("root", RootGetter),
+    DataProperty("referenceNode", ReferenceNodeGetter),
+    DataProperty("pointerBeforeReferenceNode", PointerBeforeReferenceNodeGetter),
+    DataProperty("whatToShow", WhatToShowGetter),
+    DataProperty("filter", FilterGetter),
+
+    // Methods
+    MethodProperty("nextNode", NextNode),
+    MethodProperty("previousNode", PreviousNode),
+    MethodProperty("detach", Detach),
+
+    // Non-standard methods
+    MethodProperty("nextNodes", NextNodes, kReceiverCheck | kDontEnum),
+};
+
 void NodeIteratorWrapper::InstallTemplate(v8::Isolate* isolate) {
     v8::Local<v8::FunctionTemplate> tmpl = v8::FunctionTemplate::New(isolate);
     tmpl->SetClassName(v8::String::NewFromUtf8Literal(isolate, "NodeIterator"));
-    tmpl->InstanceTemplate()->SetInternalFieldCount(1);
-    
-
-    // Get prototype template for adding properties/methods
-    v8::Local<v8::ObjectTemplate> proto = tmpl->PrototypeTemplate();
-    
-    // TODO: Add properties and methods here
-    // Example:
-    // proto->SetNativeDataProperty(v8::String::NewFromUtf8Literal(isolate, "propertyName"),
-    //                   PropertyNameGetter, PropertyNameSetter);
-    // proto->Set(v8::String::NewFromUtf8Literal(isolate, "methodName"),
-    //           v8::FunctionTemplate::New(isolate, MethodName));
-    
+    tmpl->InstanceTemplate()->SetInternalFieldCount(kWrapperFieldCount);
+
+    InstallProperties(isolate, tmpl, kProperties);
+
     // Cache the template
     TemplateCache* cache = TemplateCache::ForIsolate(isolate);
     cache->Set(kTemplateIndex, tmpl);
@@ -74,12 +114,101 @@ void NodeIteratorWrapper::InstallTemplate(v8::Isolate* isolate) {
 
 v8::Local<v8::FunctionTemplate> NodeIteratorWrapper::GetTemplate(v8::Isolate* isolate) {
     TemplateCache* cache = TemplateCache::ForIsolate(isolate);
-    
+
     if (!cache->Has(kTemplateIndex)) {
         InstallTemplate(isolate);
     }
-    
+
     return cache->Get(kTemplateIndex);
 }
 
+void NodeIteratorWrapper::RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+    RegisterProperties(registry, kProperties);
+}
+
+// ============================================================================
+// Properties
+// ============================================================================
+
+void NodeIteratorWrapper::RootGetter(v8::Local<v8::Name> property,
+                                     const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("NodeIteratorWrapper::RootGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    ScriptNodeIterator* state = ThisIterator(isolate, info.This());
+    if (!state) return;
+
+    info.GetReturnValue().Set(state->filter.root.Get(isolate));
+}
+
+void NodeIteratorWrapper::ReferenceNodeGetter(v8::Local<v8::Name> property,
+                                              const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("NodeIteratorWrapper::ReferenceNodeGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    ScriptNodeIterator* state = ThisIterator(isolate, info.This());
+    if (!state) return;
+
+    DOMNode* node = dom_nodeiterator_get_referencenode(state->iterator);
+    info.GetReturnValue().Set(NodeWrapper::Wrap(isolate, isolate->GetCurrentContext(), node));
+}
+
+void NodeIteratorWrapper::PointerBeforeReferenceNodeGetter(v8::Local<v8::Name> property,
+                                                           const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("NodeIteratorWrapper::PointerBeforeReferenceNodeGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    ScriptNodeIterator* state = ThisIterator(isolate, info.This());
+    if (!state) return;
+
+    info.GetReturnValue().Set(dom_nodeiterator_get_pointerbeforereferencenode(state->iterator) != 0);
+}
+
+void NodeIteratorWrapper::WhatToShowGetter(v8::Local<v8::Name> property,
+                                           const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("NodeIteratorWrapper::WhatToShowGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    ScriptNodeIterator* state = ThisIterator(isolate, info.This());
+    if (!state) return;
+
+    info.GetReturnValue().Set(dom_nodeiterator_get_whattoshow(state->iterator));
+}
+
+void NodeIteratorWrapper::FilterGetter(v8::Local<v8::Name> property,
+                                       const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("NodeIteratorWrapper::FilterGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    ScriptNodeIterator* state = ThisIterator(isolate, info.This());
+    if (!state) return;
+
+    info.GetReturnValue().Set(state->filter.value.Get(isolate));
+}
+
+// ============================================================================
+// Methods
+// ============================================================================
+
+void NodeIteratorWrapper::NextNode(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("NodeIteratorWrapper::NextNode");
+    Step(args, dom_nodeiterator_nextnode);
+}
+
+void NodeIteratorWrapper::NextNodes(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("NodeIteratorWrapper::NextNodes");
+    ScriptNodeIterator* state = UnwrapReceiver<ScriptNodeIterator>(args);
+    if (!state) return;
+
+    NextNodesStep(args, &state->filter, state->iterator, dom_nodeiterator_nextnodes, dom_nodeiterator_nextnode);
+}
+
+void NodeIteratorWrapper::PreviousNode(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("NodeIteratorWrapper::PreviousNode");
+    Step(args, dom_nodeiterator_previousnode);
+}
+
+void NodeIteratorWrapper::Detach(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("NodeIteratorWrapper::Detach");
+    ScriptNodeIterator* state = UnwrapReceiver<ScriptNodeIterator>(args);
+    if (!state) return;
+
+    dom_nodeiterator_detach(state->iterator);
+}
+
 } // namespace v8_dom
@@ -1,51 +1,99 @@
 /**
  * NodeIterator Wrapper - V8 bindings for NodeIterator
- * 
- * Auto-generated wrapper for DOMNodeIterator.
- * Provides JavaScript interface for NodeIterator operations.
+ *
+ * Created by document.createNodeIterator(). whatToShow is applied in Zig;
+ * the filter is a script callback or a compiled native filter (see
+ * node_filter.h), so iterating without a script filter never enters V8
+ * between the nodes it returns.
+ *
+ * Non-standard: nextNodes(n) returns up to n following nodes as an array,
+ * fetched from Zig in batches when there is no script filter.
  */
 
 #ifndef V8_DOM_NODEITERATOR_WRAPPER_H
 #define V8_DOM_NODEITERATOR_WRAPPER_H
 
 #include <v8.h>
+#include "../core/wrapper_traits.h"
+#include "../core/external_references.h"
+#include "../core/property_table.h"
+#include "node_filter.h"
 #include "dom.h"
 
 namespace v8_dom {
 
+/**
+ * Binding-side state of one script NodeIterator.
+ */
+struct ScriptNodeIterator {
+    DOMNodeIterator* iterator = nullptr;   // owned
+    ScriptNodeFilter filter;
+};
+
 class NodeIteratorWrapper {
 public:
     /**
-     * Wrap a C DOMNodeIterator pointer in a V8 object.
-     * Uses wrapper cache for identity preservation.
+     * Create a NodeIterator and its wrapper (document.createNodeIterator).
+     * Returns an empty handle if an exception was thrown.
      */
-    static v8::Local<v8::Object> Wrap(v8::Isolate* isolate,
-                                      v8::Local<v8::Context> context,
-                                      DOMNodeIterator* obj);
-    
+    static v8::MaybeLocal<v8::Object> Create(v8::Isolate* isolate,
+                                             v8::Local<v8::Context> context,
+                                             DOMDocument* doc,
+                                             v8::Local<v8::Object> root,
+                                             uint32_t what_to_show,
+                                             v8::Local<v8::Value> filter);
+
     /**
-     * Unwrap a V8 object to get the C DOMNodeIterator pointer.
+     * Unwrap a V8 object to get the iterator state.
      */
-    static DOMNodeIterator* Unwrap(v8::Local<v8::Object> obj);
-    
+    static ScriptNodeIterator* Unwrap(v8::Local<v8::Object> obj);
+
     /**
      * Install the NodeIterator template (called once per isolate).
      */
     static void InstallTemplate(v8::Isolate* isolate);
-    
+
     /**
      * Get the cached NodeIterator template.
      */
     static v8::Local<v8::FunctionTemplate> GetTemplate(v8::Isolate* isolate);
-    
+
     /**
      * Template cache index.
      */
-    static constexpr int kTemplateIndex = 22;
-    
+    static constexpr int kTemplateIndex = WrapperTraits<NodeIteratorWrapper>::kTemplateIndex;
+
+    /**
+     * Type tag stored in the wrapper's type internal field.
+     */
+    static const WrapperTypeInfo kTypeInfo;
+
+    /**
+     * Register this wrapper's callbacks for snapshot serialization.
+     */
+    static void RegisterExternalReferences(ExternalReferenceRegistry* registry);
+
 private:
-    // Property getters/setters and methods will be added here
-    // TODO: Parse dom.h to auto-generate these declarations
+    // Prototype members, installed by InstallTemplate()
+    static const PropertyDescriptor kProperties[];
+    
+    // Properties
+    static void RootGetter(v8::Local<v8::Name> property,
+                           const v8::PropertyCallbackInfo<v8::Value>& info);
+    static void WhatToShowGetter(v8::Local<v8::Name> property,
+                                 const v8::PropertyCallbackInfo<v8::Value>& info);
+    static void FilterGetter(v8::Local<v8::Name> property,
+                             const v8::PropertyCallbackInfo<v8::Value>& info);
+    static void ReferenceNodeGetter(v8::Local<v8::Name> property,
+                                    const v8::PropertyCallbackInfo<v8::Value>& info);
+    static void PointerBeforeReferenceNodeGetter(v8::Local<v8::Name> property,
+                                                 const v8::PropertyCallbackInfo<v8::Value>& info);
+
+    // Methods
+    static void NextNode(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void NextNodes(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void PreviousNode(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void Detach(const v8::FunctionCallbackInfo<v8::Value>& args);
 };
 
 } // namespace v8_dom
@@ -0,0 +1,279 @@
+#include "sliced_query_wrapper.h"
+#include <cmath>
+#include "../nodes/element_wrapper.h"
+#include "../wrapper_cache.h"
+#include "../core/template_cache.h"
+#include "../core/domexception_wrapper.h"
+#include "../core/utilities.h"
+
+namespace v8_dom {
+
+const WrapperTypeInfo SlicedQueryWrapper::kTypeInfo = {"SlicedQuery", nullptr};
+
+namespace {
+
+/**
+ * An iterator result object ({value, done}).
+ */
+v8::Local<v8::Object> IteratorResult(v8::Isolate* isolate, v8::Local<v8::Context> context,
+                                     v8::Local<v8::Value> value, bool done) {
+    v8::Local<v8::Object> result = v8::Object::New(isolate);
+    result->CreateDataProperty(context, v8::String::NewFromUtf8Literal(isolate, "value"), value).Check();
+    result->CreateDataProperty(context, v8::String::NewFromUtf8Literal(isolate, "done"),
+                               v8::Boolean::New(isolate, done)).Check();
+    return result;
+}
+
+} // namespace
+
+v8::MaybeLocal<v8::Object> SlicedQueryWrapper::Create(v8::Isolate* isolate,
+                                                      v8::Local<v8::Context> context,
+                                                      DOMDocument* doc,
+                                                      const char* selectors,
+                                                      size_t selectors_len,
+                                                      uint64_t budget_ns) {
+    v8::EscapableHandleScope handle_scope(isolate);
+
+    DOMQuery* query = dom_query_begin(doc, selectors, selectors_len);
+    if (!query) {
+        ThrowDOMException(isolate, DOM_ERROR_SYNTAX);
+        return v8::MaybeLocal<v8::Object>();
+    }
+    ScriptSlicedQuery* state = new ScriptSlicedQuery();
+    state->query = query;
+    state->document = doc;
+    state->budget_ns = budget_ns;
+    state->version = dom_document_get_mutation_version(doc);
+
+    v8::Local<v8::Function> constructor =
+        TemplateCache::ForIsolate(isolate)->GetConstructor(context, kTemplateIndex, GetTemplate);
+    v8::Local<v8::Object> wrapper = constructor->NewInstance(context).ToLocalChecked();
+    SetWrapperFields(wrapper, state, &kTypeInfo);
+
+    WrapperCache::ForIsolate(isolate)->Set(isolate, state, wrapper, [](void* ptr) {
+        ScriptSlicedQuery* state = static_cast<ScriptSlicedQuery*>(ptr);
+        if (state->query) {
+            dom_query_release(state->query);
+        }
+        delete state;
+    });
+
+    return handle_scope.Escape(wrapper);
+}
+
+ScriptSlicedQuery* SlicedQueryWrapper::Unwrap(v8::Local<v8::Object> obj) {
+    return static_cast<ScriptSlicedQuery*>(UnwrapObject(obj, &kTypeInfo));
+}
+
+const PropertyDescriptor SlicedQueryWrapper::kProperties[] = {
+    // Methods
+    MethodProperty("next", Next),
+    MethodProperty("return", Return),
+};
+
+void SlicedQueryWrapper::InstallTemplate(v8::Isolate* isolate) {
+    v8::Local<v8::FunctionTemplate> tmpl = v8::FunctionTemplate::New(isolate);
+    tmpl->SetClassName(v8::String::NewFromUtf8Literal(isolate, "SlicedQuery"));
+    tmpl->InstanceTemplate()->SetInternalFieldCount(kWrapperFieldCount);
+
+    InstallProperties(isolate, tmpl, kProperties);
+
+    // Async iterable: [Symbol.asyncIterator]() returns the query itself
+    tmpl->PrototypeTemplate()->Set(v8::Symbol::GetAsyncIterator(isolate),
+                                   v8::FunctionTemplate::New(isolate, AsyncIterator),
+                                   v8::DontEnum);
+
+    // Cache the template
+    TemplateCache* cache = TemplateCache::ForIsolate(isolate);
+    cache->Set(kTemplateIndex, tmpl);
+}
+
+v8::Local<v8::FunctionTemplate> SlicedQueryWrapper::GetTemplate(v8::Isolate* isolate) {
+    TemplateCache* cache = TemplateCache::ForIsolate(isolate);
+
+    if (!cache->Has(kTemplateIndex)) {
+        InstallTemplate(isolate);
+    }
+
+    return cache->Get(kTemplateIndex);
+}
+
+void SlicedQueryWrapper::RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+    registry->Register(AsyncIterator);
+    registry->Register(RunSlice);
+    RegisterProperties(registry, kProperties);
+}
+
+// ============================================================================
+// Slices
+// ============================================================================
+
+/**
+ * Settle waiting next() promises, oldest first, until one needs a slice.
+ */
+void SlicedQueryWrapper::Settle(v8::Isolate* isolate, v8::Local<v8::Context> context,
+                                ScriptSlicedQuery* state) {
+    while (!state->waiting.empty()) {
+        v8::Local<v8::Promise::Resolver> resolver = state->waiting.front().Get(isolate);
+        bool buffered = state->index < state->count;
+        uint8_t query_state = state->query ? dom_query_get_state(state->query) : DOM_QUERY_DONE;
+        bool stale = query_state == DOM_QUERY_INVALIDATED ||
+                     ((buffered || query_state == DOM_QUERY_RUNNING) &&
+                      dom_document_get_mutation_version(state->document) != state->version);
+
+        if (stale) {
+            state->index = state->count = 0;
+            v8::Local<v8::Object> error;
+            if (!DOMExceptionWrapper::Create(isolate, context, DOM_ERROR_INVALID_STATE,
+                    v8::String::NewFromUtf8Literal(isolate, "The document changed during the query"))
+                    .ToLocal(&error)) {
+                return;
+            }
+            resolver->Reject(context, error).Check();
+        } else if (buffered) {
+            v8::Local<v8::Object> element =
+                ElementWrapper::Wrap(isolate, context, state->batch[state->index++]);
+            resolver->Resolve(context, IteratorResult(isolate, context, element, false)).Check();
+        } else if (query_state == DOM_QUERY_DONE) {
+            resolver->Resolve(context, IteratorResult(isolate, context, v8::Undefined(isolate), true)).Check();
+        } else {
+            return;  // Running with nothing buffered: the next slice settles it
+        }
+        state->waiting.pop_front();
+    }
+}
+
+/**
+ * Run the next slice in a task of its own. The task function holds the
+ * wrapper, which keeps the query alive until the slice has run.
+ */
+void SlicedQueryWrapper::Schedule(v8::Isolate* isolate, v8::Local<v8::Context> context,
+                                  v8::Local<v8::Object> wrapper, ScriptSlicedQuery* state) {
+    if (state->scheduled) {
+        return;
+    }
+    v8::Local<v8::Function> task;
+    if (!v8::Function::New(context, RunSlice, wrapper, 0, v8::ConstructorBehavior::kThrow).ToLocal(&task)) {
+        return;
+    }
+
+    v8::Local<v8::Value> set_timeout;
+    if (context->Global()->Get(context, v8::String::NewFromUtf8Literal(isolate, "setTimeout")).ToLocal(&set_timeout) &&
+        set_timeout->IsFunction()) {
+        v8::Local<v8::Value> argv[] = {task, v8::Integer::New(isolate, 0)};
+        if (set_timeout.As<v8::Function>()->Call(context, context->Global(), 2, argv).IsEmpty()) {
+            return;
+        }
+    } else {
+        isolate->EnqueueMicrotask(task);
+    }
+    state->scheduled = true;
+}
+
+void SlicedQueryWrapper::RunSlice(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("SlicedQueryWrapper::RunSlice");
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    v8::Local<v8::Object> wrapper = args.Data().As<v8::Object>();
+    ScriptSlicedQuery* state = Unwrap(wrapper);
+    if (!state) return;
+
+    state->scheduled = false;
+    if (state->query && state->index == state->count) {
+        state->count = dom_query_step(state->query, state->budget_ns, state->batch,
+                                      ScriptSlicedQuery::kBatchSize);
+        state->index = 0;
+    }
+    Settle(isolate, context, state);
+    if (!state->waiting.empty()) {
+        Schedule(isolate, context, wrapper, state);
+    }
+}
+
+// ============================================================================
+// Methods
+// ============================================================================
+
+/**
+ * document.querySelectorAllSliced(selectors, budgetMs): see the header.
+ */
+void SlicedQueryWrapper::QuerySelectorAllSliced(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("SlicedQueryWrapper::QuerySelectorAllSliced");
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    DOMDocument* doc = UnwrapReceiver<DOMDocument>(args);
+    if (!doc) {
+        return;
+    }
+
+    if (args.Length() < 1 || !args[0]->IsString()) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Selector string required")));
+        return;
+    }
+    double budget_ms = ScriptSlicedQuery::kDefaultBudgetMs;
+    if (args.Length() > 1 && !args[1]->IsUndefined()) {
+        if (!args[1]->NumberValue(context).To(&budget_ms)) return;
+        if (!std::isfinite(budget_ms) || budget_ms < 0) {
+            isolate->ThrowException(v8::Exception::RangeError(
+                v8::String::NewFromUtf8Literal(isolate, "budgetMs must be a non-negative number")));
+            return;
+        }
+    }
+
+    v8::String::Utf8Value selectors(isolate, args[0]);
+    v8::Local<v8::Object> wrapper;
+    if (!Create(isolate, context, doc, *selectors, selectors.length(),
+                static_cast<uint64_t>(budget_ms * 1e6)).ToLocal(&wrapper)) {
+        return;
+    }
+    args.GetReturnValue().Set(wrapper);
+}
+
+void SlicedQueryWrapper::Next(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("SlicedQueryWrapper::Next");
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    ScriptSlicedQuery* state = UnwrapReceiver<ScriptSlicedQuery>(args);
+    if (!state) return;
+
+    v8::Local<v8::Promise::Resolver> resolver;
+    if (!v8::Promise::Resolver::New(context).ToLocal(&resolver)) return;
+    state->waiting.emplace_back(isolate, resolver);
+
+    Settle(isolate, context, state);
+    if (!state->waiting.empty()) {
+        Schedule(isolate, context, args.This(), state);
+    }
+    args.GetReturnValue().Set(resolver->GetPromise());
+}
+
+/**
+ * return(): called by for await on break; ends the query and releases
+ * it (and its document reference) without waiting for collection.
+ */
+void SlicedQueryWrapper::Return(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("SlicedQueryWrapper::Return");
+    v8::Isolate* isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    ScriptSlicedQuery* state = UnwrapReceiver<ScriptSlicedQuery>(args);
+    if (!state) return;
+
+    if (state->query) {
+        dom_query_release(state->query);
+        state->query = nullptr;
+    }
+    state->index = state->count = 0;
+    Settle(isolate, context, state);
+
+    v8::Local<v8::Promise::Resolver> resolver;
+    if (!v8::Promise::Resolver::New(context).ToLocal(&resolver)) return;
+    resolver->Resolve(context, IteratorResult(isolate, context, v8::Undefined(isolate), true)).Check();
+    args.GetReturnValue().Set(resolver->GetPromise());
+}
+
+void SlicedQueryWrapper::AsyncIterator(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    args.GetReturnValue().Set(args.This());
+}
+
+} // namespace v8_dom
@@ -0,0 +1,116 @@
+/**
+ * SlicedQuery Wrapper - V8 bindings for time-sliced querySelectorAll
+ *
+ * Non-standard: document.querySelectorAllSliced(selectors, budgetMs)
+ * returns an async iterator over the matching elements, for for await.
+ * Matches are found by dom_query_step() in slices of about budgetMs
+ * (default kDefaultBudgetMs) each, and every slice runs in its own task
+ * (the global setTimeout(fn, 0) when the context has one, a microtask
+ * otherwise), so a query over a large document does not block the event
+ * loop. Between slices, next() resolves from the buffered matches.
+ *
+ * Once the document mutates, the buffered matches may be stale: the
+ * pending and later next() promises reject with an InvalidStateError
+ * DOMException, and the caller starts a new query.
+ */
+
+#ifndef V8_DOM_SLICED_QUERY_WRAPPER_H
+#define V8_DOM_SLICED_QUERY_WRAPPER_H
+
+#include <deque>
+#include <v8.h>
+#include "../core/wrapper_traits.h"
+#include "../core/external_references.h"
+#include "../core/property_table.h"
+#include "dom.h"
+
+namespace v8_dom {
+
+/**
+ * Binding-side state of one script sliced query.
+ */
+struct ScriptSlicedQuery {
+    static constexpr uint32_t kBatchSize = 256;
+    static constexpr double kDefaultBudgetMs = 4;
+
+    DOMQuery* query = nullptr;           // owned, references document
+    DOMDocument* document = nullptr;     // mutation version source
+    uint64_t budget_ns = 0;
+    uint64_t version = 0;                // when the query started
+    DOMElement* batch[kBatchSize];
+    uint32_t index = 0;
+    uint32_t count = 0;
+    bool scheduled = false;              // a slice task is pending
+
+    // Promises of next() calls not settled yet, oldest first
+    std::deque<v8::Global<v8::Promise::Resolver>> waiting;
+};
+
+class SlicedQueryWrapper {
+public:
+    /**
+     * Start a query over doc and create its wrapper.
+     * Returns an empty handle if an exception was thrown.
+     */
+    static v8::MaybeLocal<v8::Object> Create(v8::Isolate* isolate,
+                                             v8::Local<v8::Context> context,
+                                             DOMDocument* doc,
+                                             const char* selectors,
+                                             size_t selectors_len,
+                                             uint64_t budget_ns);
+
+    /**
+     * Unwrap a V8 object to get the query state.
+     */
+    static ScriptSlicedQuery* Unwrap(v8::Local<v8::Object> obj);
+
+    /**
+     * querySelectorAllSliced() for the Document prototype.
+     */
+    static void QuerySelectorAllSliced(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+    /**
+     * Install the SlicedQuery template (called once per isolate).
+     */
+    static void InstallTemplate(v8::Isolate* isolate);
+
+    /**
+     * Get the cached SlicedQuery template.
+     */
+    static v8::Local<v8::FunctionTemplate> GetTemplate(v8::Isolate* isolate);
+
+    /**
+     * Template cache index.
+     */
+    static constexpr int kTemplateIndex = WrapperTraits<SlicedQueryWrapper>::kTemplateIndex;
+
+    /**
+     * Type tag stored in the wrapper's type internal field.
+     */
+    static const WrapperTypeInfo kTypeInfo;
+
+    /**
+     * Register this wrapper's callbacks for snapshot serialization.
+     */
+    static void RegisterExternalReferences(ExternalReferenceRegistry* registry);
+
+private:
+    // Prototype members, installed by InstallTemplate()
+    static const PropertyDescriptor kProperties[];
+
+    // Methods
+    static void Next(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void Return(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void AsyncIterator(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+    // Slice task; its data is the wrapper
+    static void RunSlice(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+    static void Settle(v8::Isolate* isolate, v8::Local<v8::Context> context, ScriptSlicedQuery* state);
+    static void Schedule(v8::Isolate* isolate, v8::Local<v8::Context> context,
+                         v8::Local<v8::Object> wrapper, ScriptSlicedQuery* state);
+};
+
+} // namespace v8_dom
+
+#endif // V8_DOM_SLICED_QUERY_WRAPPER_H
@@ -1,72 +1,117 @@
 #include "treewalker_wrapper.h"
+#include "../nodes/node_wrapper.h"
 #include "../wrapper_cache.h"
 #include "../core/template_cache.h"
 #include "../core/utilities.h"
 
 namespace v8_dom {
 
-v8::Local<v8::Object> TreeWalkerWrapper::Wrap(v8::Isolate* isolate,
-                                              v8::Local<v8::Context> context,
-                                              DOMTreeWalker* obj) {
-    if (!obj) {
-        return v8::Local<v8::Object>();
+const WrapperTypeInfo TreeWalkerWrapper::kTypeInfo = {"TreeWalker", nullptr};
+
+namespace {
+
+ScriptTreeWalker* ThisWalker(v8::Isolate* isolate, v8::Local<v8::Object> receiver) {
+    ScriptTreeWalker* state = TreeWalkerWrapper::Unwrap(receiver);
+    if (!state) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "Invalid TreeWalker object")));
     }
-    
-    // Check wrapper cache first
-    WrapperCache* cache = WrapperCache::ForIsolate(isolate);
-    if (cache->Has(obj)) {
-        return cache->Get(isolate, obj);
+    return state;
+}
+
+/**
+ * Run one filtered navigation step and return its node (or null).
+ */
+void Step(const v8::FunctionCallbackInfo<v8::Value>& args, DOMNode* (*step)(DOMTreeWalker*)) {
+    v8::Isolate* isolate = args.GetIsolate();
+    ScriptTreeWalker* state = ThisWalker(isolate, args.This());
+    if (!state || !BeginFilteredStep(isolate, &state->filter)) return;
+
+    DOMNode* node = step(state->walker);
+    if (!EndFilteredStep(isolate, &state->filter)) return;
+
+    if (!node) {
+        args.GetReturnValue().SetNull();
+        return;
     }
-    
-    // Create new wrapper
+    args.GetReturnValue().Set(NodeWrapper::Wrap(isolate, isolate->GetCurrentContext(), node));
+}
+
+} // namespace
+
+v8::MaybeLocal<v8::Object> TreeWalkerWrapper::Create(v8::Isolate* isolate,
+                                                     v8::Local<v8::Context> context,
+                                                     DOMDocument* doc,
+                                                     v8::Local<v8::Object> root,
+                                                     uint32_t what_to_show,
+                                                     v8::Local<v8::Value> filter) {
     v8::EscapableHandleScope handle_scope(isolate);
-    v8::Local<v8::FunctionTemplate> tmpl = GetTemplate(isolate);
-    v8::Local<v8::Function> constructor = tmpl->GetFunction(context).ToLocalChecked();
+
+    ScriptTreeWalker* state = new ScriptTreeWalker();
+    if (!InitScriptNodeFilter(isolate, context, root, filter, &state->filter)) {
+        delete state;
+        return v8::MaybeLocal<v8::Object>();
+    }
+
+    DOMNode* root_node = NodeWrapper::Unwrap(root);
+    state->walker = state->filter.native
+        ? dom_document_createtreewalker_native(doc, root_node, what_to_show, state->filter.native)
+        : dom_document_createtreewalker(doc, root_node, what_to_show, state->filter.Callback());
+    if (!state->walker) {
+        delete state;
+        isolate->ThrowException(v8::Exception::Error(
+            v8::String::NewFromUtf8Literal(isolate, "Failed to create tree walker")));
+        return v8::MaybeLocal<v8::Object>();
+    }
+
+    v8::Local<v8::Function> constructor =
+        TemplateCache::ForIsolate(isolate)->GetConstructor(context, kTemplateIndex, GetTemplate);
     v8::Local<v8::Object> wrapper = constructor->NewInstance(context).ToLocalChecked();
-    
-    // Store C pointer in internal field
-    wrapper->SetInternalField(0, v8::External::New(isolate, obj));
-    
-    // Increment C-side reference count
-    dom_treewalker_addref(obj);
-    
-    // Cache with release callback
-    cache->Set(isolate, obj, wrapper, [](void* ptr) {
-        dom_treewalker_release(static_cast<DOMTreeWalker*>(ptr));
+    SetWrapperFields(wrapper, state, &kTypeInfo);
+
+    // The walker goes before its filter: it reads the filter on every step
+    WrapperCache::ForIsolate(isolate)->Set(isolate, state, wrapper, [](void* ptr) {
+        ScriptTreeWalker* state = static_cast<ScriptTreeWalker*>(ptr);
+        dom_treewalker_release(state->walker);
+        delete state;
     });
-    
+
     return handle_scope.Escape(wrapper);
 }
 
-DOMTreeWalker* TreeWalkerWrapper::Unwrap(v8::Local<v8::Object> obj) {
-    if (obj.IsEmpty() || obj->InternalFieldCount() < 1) {
-        return nullptr;
-    }
-    
-    v8::Local<v8::Value> ptr = obj->GetInternalField(0).As<v8::Value>();
-    if (!ptr->IsExternal()) {
-        return nullptr;
-    }
-    
-    return static_cast<DOMTreeWalker*>(v8::Local<v8::External>::Cast(ptr)->Value());
+ScriptTreeWalker* TreeWalkerWrapper::Unwrap(v8::Local<v8::Object> obj) {
+    return static_cast<ScriptTreeWalker*>(UnwrapObject(obj, &kTypeInfo));
 }
 
+const PropertyDescriptor TreeWalkerWrapper::kProperties[] = {
+    // Readonly properties
+    DataProperty("root", RootGetter),
+    DataProperty("whatToShow", WhatToShowGetter),
+    DataProperty("filter", FilterGetter),
+
+    // Read-write properties
+    AccessorProperty("currentNode", CurrentNodeGetter, CurrentNodeSetter),
+
+    // Methods
+    MethodProperty("parentNode", ParentNode),
+    MethodProperty("firstChild", FirstChild),
+    MethodProperty("lastChild", LastChild),
+    MethodProperty("previousSibling", PreviousSibling),
+    MethodProperty("nextSibling", NextSibling),
+    MethodProperty("previousNode", PreviousNode),
+    MethodProperty("nextNode", NextNode),
+
+    // Non-standard methods
+    MethodProperty("nextNodes", NextNodes, kReceiverCheck | kDontEnum),
+};
+
 void TreeWalkerWrapper::InstallTemplate(v8::Isolate* isolate) {
     v8::Local<v8::FunctionTemplate> tmpl = v8::FunctionTemplate::New(isolate);
     tmpl->SetClassName(v8::String::NewFromUtf8Literal(isolate, "TreeWalker"));
-    tmpl->InstanceTemplate()->SetInternalFieldCount(1);
-    
-
-    // Get prototype template for adding properties/methods
-    v8::Local<v8::ObjectTemplate> proto = tmpl->PrototypeTemplate();
-    
-    // TODO: Add properties and methods here
-    // Example:
-    // proto->SetNativeDataProperty(v8::String::NewFromUtf8Literal(isolate, "propertyName"),
-    //                   PropertyNameGetter, PropertyNameSetter);
-    // proto->Set(v8::String::NewFromUtf8Literal(isolate, "methodName"),
-    //           v8::FunctionTemplate::New(isolate, MethodName));
-    
+    tmpl->InstanceTemplate()->SetInternalFieldCount(kWrapperFieldCount);
+
+    InstallProperties(isolate, tmpl, kProperties);
+
     // Cache the template
     TemplateCache* cache = TemplateCache::ForIsolate(isolate);
     cache->Set(kTemplateIndex, tmpl);
@@ -74,12 +119,126 @@ void TreeWalkerWrapper::InstallTemplate(v8::Isolate* isolate) {
 
 v8::Local<v8::FunctionTemplate> TreeWalkerWrapper::GetTemplate(v8::Isolate* isolate) {
     TemplateCache* cache = TemplateCache::ForIsolate(isolate);
-    
+
     if (!cache->Has(kTemplateIndex)) {
         InstallTemplate(isolate);
     }
-    
+
     return cache->Get(kTemplateIndex);
 }
 
+void TreeWalkerWrapper::RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+    RegisterProperties(registry, kProperties);
+}
+
+// ============================================================================
+// Properties
+// ============================================================================
+
+void TreeWalkerWrapper::RootGetter(v8::Local<v8::Name> property,
+                                   const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("TreeWalkerWrapper::RootGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    ScriptTreeWalker* state = ThisWalker(isolate, info.This());
+    if (!state) return;
+
+    info.GetReturnValue().Set(state->filter.root.Get(isolate));
+}
+
+void TreeWalkerWrapper::WhatToShowGetter(v8::Local<v8::Name> property,
+                                         const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("TreeWalkerWrapper::WhatToShowGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    ScriptTreeWalker* state = ThisWalker(isolate, info.This());
+    if (!state) return;
+
+    info.GetReturnValue().Set(dom_treewalker_get_whattoshow(state->walker));
+}
+
+void TreeWalkerWrapper::FilterGetter(v8::Local<v8::Name> property,
+                                     const v8::PropertyCallbackInfo<v8::Value>& info) {
+    V8_DOM_TRACE_SCOPE("TreeWalkerWrapper::FilterGetter");
+    v8::Isolate* isolate = info.GetIsolate();
+    ScriptTreeWalker* state = ThisWalker(isolate, info.This());
+    if (!state) return;
+
+    info.GetReturnValue().Set(state->filter.value.Get(isolate));
+}
+
+void TreeWalkerWrapper::CurrentNodeGetter(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("TreeWalkerWrapper::CurrentNodeGetter");
+    v8::Isolate* isolate = args.GetIsolate();
+    ScriptTreeWalker* state = UnwrapReceiver<ScriptTreeWalker>(args);
+    if (!state) return;
+
+    DOMNode* node = dom_treewalker_get_currentnode(state->walker);
+    args.GetReturnValue().Set(NodeWrapper::Wrap(isolate, isolate->GetCurrentContext(), node));
+}
+
+void TreeWalkerWrapper::CurrentNodeSetter(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("TreeWalkerWrapper::CurrentNodeSetter");
+    v8::Isolate* isolate = args.GetIsolate();
+    ScriptTreeWalker* state = UnwrapReceiver<ScriptTreeWalker>(args);
+    if (!state) return;
+
+    DOMNode* node = nullptr;
+    if (args.Length() > 0 && args[0]->IsObject()) {
+        node = NodeWrapper::Unwrap(args[0].As<v8::Object>());
+    }
+    if (!node) {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8Literal(isolate, "currentNode must be a Node")));
+        return;
+    }
+
+    dom_treewalker_set_currentnode(state->walker, node);
+}
+
+// ============================================================================
+// Methods
+// ============================================================================
+
+void TreeWalkerWrapper::ParentNode(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("TreeWalkerWrapper::ParentNode");
+    Step(args, dom_treewalker_parentnode);
+}
+
+void TreeWalkerWrapper::FirstChild(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("TreeWalkerWrapper::FirstChild");
+    Step(args, dom_treewalker_firstchild);
+}
+
+void TreeWalkerWrapper::LastChild(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("TreeWalkerWrapper::LastChild");
+    Step(args, dom_treewalker_lastchild);
+}
+
+void TreeWalkerWrapper::PreviousSibling(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("TreeWalkerWrapper::PreviousSibling");
+    Step(args, dom_treewalker_previoussibling);
+}
+
+void TreeWalkerWrapper::NextSibling(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("TreeWalkerWrapper::NextSibling");
+    Step(args, dom_treewalker_nextsibling);
+}
+
+void TreeWalkerWrapper::PreviousNode(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("TreeWalkerWrapper::PreviousNode");
+    Step(args, dom_treewalker_previousnode);
+}
+
+void TreeWalkerWrapper::NextNode(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("TreeWalkerWrapper::NextNode");
+    Step(args, dom_treewalker_nextnode);
+}
+
+void TreeWalkerWrapper::NextNodes(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    V8_DOM_TRACE_SCOPE("TreeWalkerWrapper::NextNodes");
+    ScriptTreeWalker* state = UnwrapReceiver<ScriptTreeWalker>(args);
+    if (!state) return;
+
+    NextNodesStep(args, &state->filter, state->walker, dom_treewalker_nextnodes, dom_treewalker_nextnode);
+}
+
 } // namespace v8_dom
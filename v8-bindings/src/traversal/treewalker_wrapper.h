@@ -1,51 +1,101 @@
 /**
  * TreeWalker Wrapper - V8 bindings for TreeWalker
- * 
- * Auto-generated wrapper for DOMTreeWalker.
- * Provides JavaScript interface for TreeWalker operations.
+ *
+ * Created by document.createTreeWalker(). whatToShow is applied in Zig;
+ * the filter is a script callback or a compiled native filter (see
+ * node_filter.h), so a walk without a script filter never enters V8
+ * between the nodes it returns.
+ *
+ * Non-standard: nextNodes(n) returns up to n following nodes as an array,
+ * fetched from Zig in batches when there is no script filter.
  */
 
 #ifndef V8_DOM_TREEWALKER_WRAPPER_H
 #define V8_DOM_TREEWALKER_WRAPPER_H
 
 #include <v8.h>
+#include "../core/wrapper_traits.h"
+#include "../core/external_references.h"
+#include "../core/property_table.h"
+#include "node_filter.h"
 #include "dom.h"
 
 namespace v8_dom {
 
+/**
+ * Binding-side state of one script TreeWalker.
+ */
+struct ScriptTreeWalker {
+    DOMTreeWalker* walker = nullptr;   // owned
+    ScriptNodeFilter filter;
+};
+
 class TreeWalkerWrapper {
 public:
     /**
-     * Wrap a C DOMTreeWalker pointer in a V8 object.
-     * Uses wrapper cache for identity preservation.
+     * Create a TreeWalker and its wrapper (document.createTreeWalker).
+     * Returns an empty handle if an exception was thrown.
      */
-    static v8::Local<v8::Object> Wrap(v8::Isolate* isolate,
-                                      v8::Local<v8::Context> context,
-                                      DOMTreeWalker* obj);
-    
+    static v8::MaybeLocal<v8::Object> Create(v8::Isolate* isolate,
+                                             v8::Local<v8::Context> context,
+                                             DOMDocument* doc,
+                                             v8::Local<v8::Object> root,
+                                             uint32_t what_to_show,
+                                             v8::Local<v8::Value> filter);
+
     /**
-     * Unwrap a V8 object to get the C DOMTreeWalker pointer.
+     * Unwrap a V8 object to get the walker state.
      */
-    static DOMTreeWalker* Unwrap(v8::Local<v8::Object> obj);
-    
+    static ScriptTreeWalker* Unwrap(v8::Local<v8::Object> obj);
+
     /**
      * Install the TreeWalker template (called once per isolate).
      */
     static void InstallTemplate(v8::Isolate* isolate);
-    
+
     /**
      * Get the cached TreeWalker template.
      */
     static v8::Local<v8::FunctionTemplate> GetTemplate(v8::Isolate* isolate);
-    
+
     /**
      * Template cache index.
      */
-    static constexpr int kTemplateIndex = 23;
-    
+    static constexpr int kTemplateIndex = WrapperTraits<TreeWalkerWrapper>::kTemplateIndex;
+
+    /**
+     * Type tag stored in the wrapper's type internal field.
+     */
+    static const WrapperTypeInfo kTypeInfo;
+
+    /**
+     * Register this wrapper's callbacks for snapshot serialization.
+     */
+    static void RegisterExternalReferences(ExternalReferenceRegistry* registry);
+
 private:
-    // Property getters/setters and methods will be added here
-    // TODO: Parse dom.h to auto-generate these declarations
+    // Prototype members, installed by InstallTemplate()
+    static const PropertyDescriptor kProperties[];
+    
+    // Properties
+    static void RootGetter(v8::Local<v8::Name> property,
+                           const v8::PropertyCallbackInfo<v8::Value>& info);
+    static void WhatToShowGetter(v8::Local<v8::Name> property,
+                                 const v8::PropertyCallbackInfo<v8::Value>& info);
+    static void FilterGetter(v8::Local<v8::Name> property,
+                             const v8::PropertyCallbackInfo<v8::Value>& info);
+    static void CurrentNodeGetter(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void CurrentNodeSetter(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+    // Methods
+    static void ParentNode(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void FirstChild(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void LastChild(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void PreviousSibling(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void NextSibling(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void PreviousNode(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void NextNode(const v8::FunctionCallbackInfo<v8::Value>& args);
+    static void NextNodes(const v8::FunctionCallbackInfo<v8::Value>& args);
 };
 
 } // namespace v8_dom
@@ -1,30 +1,80 @@
 #include "../include/v8_dom.h"
+#include <memory>
 #include "wrapper_cache.h"
 #include "core/template_cache.h"
+#include "core/binding_state.h"
+#include "core/binding_trace.h"
+#include "core/call_recorder.h"
+#include "core/external_references.h"
+#include "core/features.h"
+#include "core/domexception_wrapper.h"
 #include "nodes/document_wrapper.h"
+#include "nodes/eventtarget_wrapper.h"
+#include "nodes/node_wrapper.h"
+#include "nodes/element_wrapper.h"
+#include "nodes/documentfragment_wrapper.h"
+#include "nodes/characterdata_wrapper.h"
+#include "nodes/text_wrapper.h"
+#include "nodes/comment_wrapper.h"
+#include "nodes/cdatasection_wrapper.h"
+#include "nodes/processinginstruction_wrapper.h"
+#include "nodes/documenttype_wrapper.h"
+#include "nodes/attr_wrapper.h"
+#include "nodes/domimplementation_wrapper.h"
+#include "nodes/node_mixins.h"
+#include "nodes/treebuilder_wrapper.h"
+#include "collections/nodelist_wrapper.h"
+#include "collections/htmlcollection_wrapper.h"
+#include "collections/childlist_wrapper.h"
+#include "collections/namednodemap_wrapper.h"
+#include "collections/domtokenlist_wrapper.h"
+#include "collections/domstringmap_wrapper.h"
+#include "collections/listiterator_wrapper.h"
+#include "events/event_wrapper.h"
+#include "events/customevent_wrapper.h"
+#if V8_DOM_ENABLE_RANGES
+#include "ranges/abstractrange_wrapper.h"
+#include "ranges/range_wrapper.h"
+#include "ranges/staticrange_wrapper.h"
+#endif
+#if V8_DOM_ENABLE_TRAVERSAL
+#include "traversal/nodeiterator_wrapper.h"
+#include "traversal/treewalker_wrapper.h"
+#include "traversal/elementiterator_wrapper.h"
+#include "traversal/sliced_query_wrapper.h"
+#endif
+#if V8_DOM_ENABLE_OBSERVERS
+#include "observers/mutationobserver_wrapper.h"
+#include "observers/mutationrecord_wrapper.h"
+#include "observers/mutationrecordbatch_wrapper.h"
+#endif
+#if V8_DOM_ENABLE_SHADOW
+#include "shadow/shadowroot_wrapper.h"
+#endif
+#if V8_DOM_ENABLE_ABORT
+#include "abort/abortcontroller_wrapper.h"
+#include "abort/abortsignal_wrapper.h"
+#endif
+#include "custom_elements/customelementregistry_wrapper.h"
 
 namespace v8_dom {
 
-// Global document instance (one per isolate)
-static DOMDocument* g_document = nullptr;
-
 // Accessor for 'document' property
 static void DocumentGetter(v8::Local<v8::Name> property,
                            const v8::PropertyCallbackInfo<v8::Value>& info) {
     v8::Isolate* isolate = info.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     
-    // Create document on first access
-    if (!g_document) {
-        g_document = dom_document_new();
-    }
+    // Each isolate has its own document
+    DOMDocument* document = BindingState::ForIsolate(isolate)->Document();
     
-    v8::Local<v8::Object> wrapper = DocumentWrapper::Wrap(isolate, context, g_document);
+    v8::Local<v8::Object> wrapper = DocumentWrapper::Wrap(isolate, context, document);
     info.GetReturnValue().Set(wrapper);
 }
 
 void InstallDOMBindings(v8::Isolate* isolate, v8::Local<v8::ObjectTemplate> global) {
-    // 1. Initialize caches
+    // 1. Initialize per-isolate state and caches
+    BindingState::ForIsolate(isolate);
     WrapperCache::ForIsolate(isolate);
     TemplateCache::ForIsolate(isolate);
     
@@ -36,20 +86,354 @@ void InstallDOMBindings(v8::Isolate* isolate, v8::Local<v8::ObjectTemplate> glob
         v8::Local<v8::Value>(),  // No data
         v8::PropertyAttribute::None
     );
+    global->SetNativeDataProperty(
+        v8::String::NewFromUtf8Literal(isolate, "customElements"),
+        CustomElementRegistryWrapper::CustomElementsGetter,
+        nullptr,  // No setter
+        v8::Local<v8::Value>(),  // No data
+        v8::PropertyAttribute::None
+    );
+    
+    // 3. Interfaces script constructs itself
+#if V8_DOM_ENABLE_OBSERVERS
+    global->Set(v8::String::NewFromUtf8Literal(isolate, "MutationObserver"),
+                MutationObserverWrapper::GetTemplate(isolate),
+                v8::DontEnum);
+#endif
+#if V8_DOM_ENABLE_ABORT
+    global->Set(v8::String::NewFromUtf8Literal(isolate, "AbortController"),
+                AbortControllerWrapper::GetTemplate(isolate),
+                v8::DontEnum);
+#endif
+    global->Set(v8::String::NewFromUtf8Literal(isolate, "DOMException"),
+                DOMExceptionWrapper::GetTemplate(isolate),
+                v8::DontEnum);
+    global->Set(v8::String::NewFromUtf8Literal(isolate, "Event"),
+                EventWrapper::GetTemplate(isolate),
+                v8::DontEnum);
+    global->Set(v8::String::NewFromUtf8Literal(isolate, "CustomEvent"),
+                CustomEventWrapper::GetTemplate(isolate),
+                v8::DontEnum);
+    
+    // 4. Interface objects for their static methods (AbortSignal.any()) and
+    //    for custom element classes to extend (Element)
+    global->Set(v8::String::NewFromUtf8Literal(isolate, "Element"),
+                ElementWrapper::GetTemplate(isolate),
+                v8::DontEnum);
+#if V8_DOM_ENABLE_ABORT
+    global->Set(v8::String::NewFromUtf8Literal(isolate, "AbortSignal"),
+                AbortSignalWrapper::GetTemplate(isolate),
+                v8::DontEnum);
+#endif
+    
+    // 5. Namespace objects
+#if V8_DOM_ENABLE_TRAVERSAL
+    global->Set(v8::String::NewFromUtf8Literal(isolate, "NodeFilter"),
+                CreateNodeFilterTemplate(isolate),
+                v8::DontEnum);
+#endif
 }
 
-void Cleanup(v8::Isolate* isolate) {
-    // Clean up global document
-    if (g_document) {
-        dom_document_release(g_document);
-        g_document = nullptr;
+bool EnableNodeWrapperSlots(v8::Isolate* isolate) {
+    return WrapperCache::ForIsolate(isolate)->EnableNodeSlots();
+}
+
+bool EnableWrapperTreeRetention(v8::Isolate* isolate) {
+    return WrapperCache::ForIsolate(isolate)->EnableTreeRetention(isolate);
+}
+
+void EnableDeferredReleases(v8::Isolate* isolate) {
+    WrapperCache::ForIsolate(isolate)->EnableDeferredReleases(isolate);
+}
+
+size_t DrainDeferredReleases(v8::Isolate* isolate, size_t max) {
+    return WrapperCache::ForIsolate(isolate)->DrainReleases(max);
+}
+
+bool RunIdleWork(v8::Isolate* isolate, uint64_t budget_ns) {
+    return dom_document_run_idle_work(BindingState::ForIsolate(isolate)->Document(), budget_ns) != 0;
+}
+
+size_t PrewrapSubtree(v8::Isolate* isolate, v8::Local<v8::Context> context,
+                      DOMNode* node, size_t max) {
+    return NodeWrapper::PrewrapSubtree(isolate, context, node, max);
+}
+
+bool AdoptDocument(v8::Isolate* isolate, DOMDocument* doc) {
+    // DocumentGetter wraps it on first access
+    return BindingState::ForIsolate(isolate)->AdoptDocument(doc);
+}
+
+v8::Local<v8::Object> AdoptDocument(v8::Isolate* isolate, v8::Local<v8::Context> context,
+                                    DOMDocument* doc) {
+    // Partitioned before the first wrapper, so DisposeDocument() finds them all
+    WrapperCache::ForIsolate(isolate)->AddPartition(doc);
+    v8::Local<v8::Object> wrapper = DocumentWrapper::Wrap(isolate, context, doc);
+    dom_document_release(doc);
+    return wrapper;
+}
+
+v8::Local<v8::Object> CreateDocument(v8::Isolate* isolate, v8::Local<v8::Context> context) {
+    return AdoptDocument(isolate, context, BindingState::ForIsolate(isolate)->NewDocument());
+}
+
+void SetSharedNames(v8::Isolate* isolate, DOMSharedNames* shared) {
+    BindingState::ForIsolate(isolate)->SetSharedNames(shared);
+}
+
+size_t DisposeDocument(v8::Isolate* isolate, v8::Local<v8::Object> document) {
+    DOMDocument* doc = DocumentWrapper::Unwrap(document);
+    if (!doc) {
+        return 0;  // Not a document, or disposed already
     }
+    return WrapperCache::ForIsolate(isolate)->DisposePartition(isolate, doc);
+}
+
+void ReportExternalMemory(v8::Isolate* isolate) {
+    WrapperCache::ForIsolate(isolate)->RefreshExternalMemory();
+}
+
+void DrainPatchesAtTaskBoundaries(v8::Isolate* isolate, DOMDocument* doc) {
+    BindingState::ForIsolate(isolate)->DrainPatchesAtTaskBoundaries(isolate, doc);
+}
+
+size_t DrainSubmittedPatches(v8::Isolate* isolate) {
+    BindingState* state = BindingState::TryForIsolate(isolate);
+    return state ? state->DrainSubmittedPatches() : 0;
+}
+
+bool SetTraceCallback(TraceCallback callback, void* user_data, uint32_t sample_every) {
+    g_trace_config.callback.store(nullptr, std::memory_order_release);
+    g_trace_config.user_data.store(user_data, std::memory_order_relaxed);
+    g_trace_config.sample_every.store(sample_every ? sample_every : 1, std::memory_order_relaxed);
+    g_trace_config.callback.store(callback, std::memory_order_release);
+    return V8_DOM_TRACE != 0;
+}
+
+bool StartCallRecording(v8::Isolate* isolate, const char* path) {
+#if V8_DOM_RECORD
+    return CallRecorder::Start(BindingState::ForIsolate(isolate)->Document(), path);
+#else
     (void)isolate;
+    (void)path;
+    return false;
+#endif
+}
+
+uint64_t StopCallRecording() {
+    return CallRecorder::Stop();
+}
+
+Stats GetStats(v8::Isolate* isolate) {
+    Stats stats = {};
+    stats.counters_enabled = V8_DOM_STATS != 0;
+    BindingState* state = BindingState::TryForIsolate(isolate);
+    if (!state) {
+        return stats;
+    }
+    
+    const WrapperCache* cache = WrapperCache::ForIsolate(isolate);
+    stats.wrappers_live = cache->Size();
+    stats.node_slot_high_water = cache->SlotHighWaterMark();
+    stats.node_slot_capacity = cache->SlotCapacity();
+    stats.wrappers_retained = cache->RetainedCount();
+    stats.releases_pending = cache->PendingReleases();
+    stats.external_memory_reported = cache->ReportedExternalMemory();
+    
+    const BindingStats* counters = state->Stats();
+    stats.wrapper_cache_hits = counters->Get(BindingStats::kWrapperCacheHits);
+    stats.wrapper_cache_misses = counters->Get(BindingStats::kWrapperCacheMisses);
+    stats.wrappers_created = counters->Get(BindingStats::kWrappersCreated);
+    stats.wrappers_collected = counters->Get(BindingStats::kWrappersCollected);
+    stats.template_installs = counters->Get(BindingStats::kTemplateInstalls);
+    stats.string_conversions = counters->Get(BindingStats::kStringConversions);
+    stats.string_bytes_copied = counters->Get(BindingStats::kStringBytesCopied);
+    
+    stats.external_strings = state->Strings()->Size();
+    stats.atoms = state->Atoms()->Size();
+    stats.atom_hits = state->Atoms()->Hits();
+    stats.atom_misses = state->Atoms()->Misses();
+    stats.selectors = state->Selectors()->Size();
+    stats.selector_hits = state->Selectors()->Hits();
+    stats.selector_misses = state->Selectors()->Misses();
+    
+    for (size_t i = 0; i < BindingStats::kMaxInterfaces; i++) {
+        const WrapperTypeInfo* type = counters->TypeAt(i);
+        if (!type) {
+            continue;
+        }
+        stats.interfaces.push_back({
+            type->interface_name,
+            counters->GetForType(i, BindingStats::kTypeWrappersCreated),
+            counters->GetForType(i, BindingStats::kTypeWrappersCollected),
+            counters->GetForType(i, BindingStats::kTypeCalls),
+        });
+    }
+    return stats;
+}
+
+// Every template, in snapshot data order
+struct SnapshotTemplate {
+    int index;
+    v8::Local<v8::FunctionTemplate> (*get_template)(v8::Isolate*);
+};
+
+static const SnapshotTemplate kSnapshotTemplates[] = {
+    {EventTargetWrapper::kTemplateIndex, EventTargetWrapper::GetTemplate},
+    {NodeWrapper::kTemplateIndex, NodeWrapper::GetTemplate},
+    {ElementWrapper::kTemplateIndex, ElementWrapper::GetTemplate},
+    {DocumentWrapper::kTemplateIndex, DocumentWrapper::GetTemplate},
+    {DocumentFragmentWrapper::kTemplateIndex, DocumentFragmentWrapper::GetTemplate},
+    {CharacterDataWrapper::kTemplateIndex, CharacterDataWrapper::GetTemplate},
+    {TextWrapper::kTemplateIndex, TextWrapper::GetTemplate},
+    {CommentWrapper::kTemplateIndex, CommentWrapper::GetTemplate},
+    {CDATASectionWrapper::kTemplateIndex, CDATASectionWrapper::GetTemplate},
+    {ProcessingInstructionWrapper::kTemplateIndex, ProcessingInstructionWrapper::GetTemplate},
+    {DocumentTypeWrapper::kTemplateIndex, DocumentTypeWrapper::GetTemplate},
+    {AttrWrapper::kTemplateIndex, AttrWrapper::GetTemplate},
+    {DOMImplementationWrapper::kTemplateIndex, DOMImplementationWrapper::GetTemplate},
+    {NodeListWrapper::kTemplateIndex, NodeListWrapper::GetTemplate},
+    {HTMLCollectionWrapper::kTemplateIndex, HTMLCollectionWrapper::GetTemplate},
+    {NamedNodeMapWrapper::kTemplateIndex, NamedNodeMapWrapper::GetTemplate},
+    {DOMTokenListWrapper::kTemplateIndex, DOMTokenListWrapper::GetTemplate},
+    {DOMStringMapWrapper::kTemplateIndex, DOMStringMapWrapper::GetTemplate},
+    {ListIteratorWrapper::kTemplateIndex, ListIteratorWrapper::GetTemplate},
+    {EventWrapper::kTemplateIndex, EventWrapper::GetTemplate},
+    {CustomEventWrapper::kTemplateIndex, CustomEventWrapper::GetTemplate},
+#if V8_DOM_ENABLE_RANGES
+    {AbstractRangeWrapper::kTemplateIndex, AbstractRangeWrapper::GetTemplate},
+    {RangeWrapper::kTemplateIndex, RangeWrapper::GetTemplate},
+    {StaticRangeWrapper::kTemplateIndex, StaticRangeWrapper::GetTemplate},
+#endif
+#if V8_DOM_ENABLE_TRAVERSAL
+    {NodeIteratorWrapper::kTemplateIndex, NodeIteratorWrapper::GetTemplate},
+    {TreeWalkerWrapper::kTemplateIndex, TreeWalkerWrapper::GetTemplate},
+    {ElementIteratorWrapper::kTemplateIndex, ElementIteratorWrapper::GetTemplate},
+    {SlicedQueryWrapper::kTemplateIndex, SlicedQueryWrapper::GetTemplate},
+#endif
+#if V8_DOM_ENABLE_OBSERVERS
+    {MutationObserverWrapper::kTemplateIndex, MutationObserverWrapper::GetTemplate},
+    {MutationRecordWrapper::kTemplateIndex, MutationRecordWrapper::GetTemplate},
+    {MutationRecordBatchWrapper::kTemplateIndex, MutationRecordBatchWrapper::GetTemplate},
+#endif
+    {TreeBuilderWrapper::kTemplateIndex, TreeBuilderWrapper::GetTemplate},
+#if V8_DOM_ENABLE_SHADOW
+    {ShadowRootWrapper::kTemplateIndex, ShadowRootWrapper::GetTemplate},
+#endif
+#if V8_DOM_ENABLE_ABORT
+    {AbortControllerWrapper::kTemplateIndex, AbortControllerWrapper::GetTemplate},
+    {AbortSignalWrapper::kTemplateIndex, AbortSignalWrapper::GetTemplate},
+#endif
+    {CustomElementRegistryWrapper::kTemplateIndex, CustomElementRegistryWrapper::GetTemplate},
+    {DOMExceptionWrapper::kTemplateIndex, DOMExceptionWrapper::GetTemplate},
+    {ChildListWrapper::kChildNodesTemplateIndex, ChildListWrapper::GetChildNodesTemplate},
+    {ChildListWrapper::kChildrenTemplateIndex, ChildListWrapper::GetChildrenTemplate},
+};
+
+const intptr_t* GetExternalReferences() {
+    static ExternalReferenceRegistry registry;
+    static const intptr_t* table = [] {
+        registry.Register(DocumentGetter);
+        EventTargetWrapper::RegisterExternalReferences(&registry);
+        NodeWrapper::RegisterExternalReferences(&registry);
+        ElementWrapper::RegisterExternalReferences(&registry);
+        DocumentWrapper::RegisterExternalReferences(&registry);
+        DocumentFragmentWrapper::RegisterExternalReferences(&registry);
+#if V8_DOM_ENABLE_SHADOW
+        ShadowRootWrapper::RegisterExternalReferences(&registry);
+#endif
+        CharacterDataWrapper::RegisterExternalReferences(&registry);
+        TextWrapper::RegisterExternalReferences(&registry);
+        AttrWrapper::RegisterExternalReferences(&registry);
+        ParentNodeMixin::RegisterExternalReferences(&registry);
+        ChildNodeMixin::RegisterExternalReferences(&registry);
+        NodeListWrapper::RegisterExternalReferences(&registry);
+        HTMLCollectionWrapper::RegisterExternalReferences(&registry);
+        ChildListWrapper::RegisterExternalReferences(&registry);
+        NamedNodeMapWrapper::RegisterExternalReferences(&registry);
+        DOMTokenListWrapper::RegisterExternalReferences(&registry);
+        DOMStringMapWrapper::RegisterExternalReferences(&registry);
+        ListIteratorWrapper::RegisterExternalReferences(&registry);
+        EventWrapper::RegisterExternalReferences(&registry);
+        CustomEventWrapper::RegisterExternalReferences(&registry);
+#if V8_DOM_ENABLE_OBSERVERS
+        MutationObserverWrapper::RegisterExternalReferences(&registry);
+        MutationRecordWrapper::RegisterExternalReferences(&registry);
+        MutationRecordBatchWrapper::RegisterExternalReferences(&registry);
+#endif
+#if V8_DOM_ENABLE_RANGES
+        RangeWrapper::RegisterExternalReferences(&registry);
+        StaticRangeWrapper::RegisterExternalReferences(&registry);
+#endif
+#if V8_DOM_ENABLE_TRAVERSAL
+        TreeWalkerWrapper::RegisterExternalReferences(&registry);
+        NodeIteratorWrapper::RegisterExternalReferences(&registry);
+        ElementIteratorWrapper::RegisterExternalReferences(&registry);
+        SlicedQueryWrapper::RegisterExternalReferences(&registry);
+#endif
+        TreeBuilderWrapper::RegisterExternalReferences(&registry);
+#if V8_DOM_ENABLE_ABORT
+        AbortControllerWrapper::RegisterExternalReferences(&registry);
+        AbortSignalWrapper::RegisterExternalReferences(&registry);
+#endif
+        CustomElementRegistryWrapper::RegisterExternalReferences(&registry);
+        DOMExceptionWrapper::RegisterExternalReferences(&registry);
+        return registry.Table();
+    }();
+    return table;
+}
+
+v8::StartupData CreateSnapshotBlob() {
+    std::unique_ptr<v8::ArrayBuffer::Allocator> allocator(
+        v8::ArrayBuffer::Allocator::NewDefaultAllocator());
+    v8::Isolate::CreateParams params;
+    params.array_buffer_allocator = allocator.get();
+    params.external_references = GetExternalReferences();
+    
+    v8::SnapshotCreator creator(params);
+    v8::Isolate* isolate = creator.GetIsolate();
+    {
+        v8::HandleScope handle_scope(isolate);
+        
+        v8::Local<v8::ObjectTemplate> global = v8::ObjectTemplate::New(isolate);
+        InstallDOMBindings(isolate, global);
+        
+        // Build every template now instead of on first use
+        for (const SnapshotTemplate& entry : kSnapshotTemplates) {
+            creator.AddData(entry.get_template(isolate));
+        }
+        
+        v8::Local<v8::Context> context = v8::Context::New(isolate, nullptr, global);
+        creator.SetDefaultContext(context);
+        
+        // The snapshot holds the templates now; drop our persistent handles
+        BindingState::Dispose(isolate);
+    }
+    return creator.CreateBlob(v8::SnapshotCreator::FunctionCodeHandling::kClear);
+}
+
+void InitializeFromSnapshot(v8::Isolate* isolate) {
+    v8::HandleScope handle_scope(isolate);
+    BindingState::ForIsolate(isolate);
+    WrapperCache::ForIsolate(isolate);
+    TemplateCache* cache = TemplateCache::ForIsolate(isolate);
+    
+    size_t data_index = 0;
+    for (const SnapshotTemplate& entry : kSnapshotTemplates) {
+        v8::Local<v8::FunctionTemplate> tmpl;
+        if (isolate->GetDataFromSnapshotOnce<v8::FunctionTemplate>(data_index++).ToLocal(&tmpl)) {
+            cache->Set(entry.index, tmpl);
+        }
+    }
+}
+
+void Cleanup(v8::Isolate* isolate) {
+    // Only this isolate's document and caches
+    BindingState::Dispose(isolate);
 }
 
 bool IsInstalled(v8::Isolate* isolate) {
-    WrapperCache* cache = WrapperCache::ForIsolate(isolate);
-    return cache != nullptr;
+    return BindingState::TryForIsolate(isolate) != nullptr;
 }
 
 const char* GetVersion() {
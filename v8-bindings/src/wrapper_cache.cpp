@@ -1,36 +1,70 @@
 #include "wrapper_cache.h"
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
+#include "core/heap_graph.h"
 
 namespace v8_dom {
 
-// Static member initialization
-const int WrapperCache::kIsolateSlot;
-
-// CacheEntry implementation
+#if V8_DOM_STATS
+namespace {
 
-WrapperCache::CacheEntry::CacheEntry(v8::Isolate* isolate,
-                                      v8::Local<v8::Object> obj,
-                                      void (*release)(void*),
-                                      void* ptr)
-    : wrapper(isolate, obj)
-    , release_callback(release)
-    , c_ptr(ptr) {
-    // Set up weak callback for GC
-    wrapper.SetWeak(this, WeakCallback, v8::WeakCallbackType::kParameter);
-}
-
-WrapperCache::CacheEntry::~CacheEntry() {
-    // Clean up C-side reference if still alive
-    if (release_callback && c_ptr) {
-        release_callback(c_ptr);
+// Interface of a wrapper, from its type tag field
+const WrapperTypeInfo* WrapperType(v8::Local<v8::Object> wrapper) {
+    if (wrapper->InternalFieldCount() < kWrapperFieldCount) {
+        return nullptr;
     }
+    return static_cast<const WrapperTypeInfo*>(
+        wrapper->GetAlignedPointerFromInternalField(kWrapperTypeIndex));
 }
 
+} // namespace
+#endif
+
+// Static member initialization
+const int WrapperCache::kIsolateSlot;
+
 // WrapperCache implementation
 
 WrapperCache::~WrapperCache() {
-    // Entries clean themselves up in destructor
-    cache_.clear();
+    // A partitioned document may be held by its wrapper alone, and freeing
+    // it frees its nodes: release those documents after everything else
+    std::vector<PendingRelease> documents;
+    auto release = [&](void* c_ptr, void (*release_callback)(void*)) {
+        if (!release_callback) {
+            return;
+        }
+        if (partition_index_.count(static_cast<DOMDocument*>(c_ptr))) {
+            documents.push_back({c_ptr, release_callback});
+            return;
+        }
+        release_callback(c_ptr);
+    };
+    
+    // Table entries are plain structs, so release them here
+    for (TableEntry& entry : table_) {
+        if (entry.c_ptr) {
+            entry.wrapper.Reset();
+            release(entry.c_ptr, entry.release_callback);
+        }
+    }
+    table_.clear();
+    count_ = 0;
+    
+    // Same for live slab entries; their nodes still hold the slot value
+    for (uint32_t slot = 1; slot <= slot_high_water_; slot++) {
+        CacheEntry* entry = SlotAt(slot);
+        if (entry->c_ptr) {
+            dom_node_set_wrapper_slot(static_cast<DOMNode*>(entry->c_ptr), 0);
+            entry->wrapper.Reset();
+            release(entry->c_ptr, entry->release_callback);
+        }
+    }
+    slot_chunks_.clear();
+    
+    for (const PendingRelease& document : documents) {
+        document.release_callback(document.c_ptr);
+    }
 }
 
 WrapperCache* WrapperCache::ForIsolate(v8::Isolate* isolate) {
@@ -43,54 +77,670 @@ WrapperCache* WrapperCache::ForIsolate(v8::Isolate* isolate) {
     // Create new cache and store in isolate
     WrapperCache* cache = new WrapperCache();
     isolate->SetData(kIsolateSlot, cache);
+    isolate->GetHeapProfiler()->AddBuildEmbedderGraphCallback(BuildEmbedderGraph, cache);
     
-    // Note: We rely on the isolate owner to delete this cache
-    // Typically done in isolate disposal or via AddMessageListener
+    // Deleted by Dispose(), called from v8_dom::Cleanup()
     
     return cache;
 }
 
+void WrapperCache::Dispose(v8::Isolate* isolate) {
+    WrapperCache* cache = static_cast<WrapperCache*>(isolate->GetData(kIsolateSlot));
+    if (cache) {
+        isolate->GetHeapProfiler()->RemoveBuildEmbedderGraphCallback(BuildEmbedderGraph, cache);
+    }
+    if (cache && cache->retention_isolate_) {
+        isolate->RemoveGCPrologueCallback(RetentionPrologue, cache);
+    }
+    if (cache && cache->deferred_isolate_) {
+        isolate->RemoveGCEpilogueCallback(ReleaseEpilogue, cache);
+        cache->DrainReleases();
+    }
+    if (cache && !cache->documents_.empty()) {
+        isolate->AdjustAmountOfExternalAllocatedMemory(-cache->ReportedExternalMemory());
+    }
+    delete cache;
+    isolate->SetData(kIsolateSlot, nullptr);
+}
+
+// Open-addressing table
+
+size_t WrapperCache::Hash(void* c_ptr) {
+    // Pointers are aligned, so mix the bits before masking
+    uint64_t h = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(c_ptr));
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return static_cast<size_t>(h);
+}
+
+size_t WrapperCache::Find(void* c_ptr) const {
+    if (count_ == 0 || !c_ptr) {
+        return kNotFound;
+    }
+    size_t mask = table_.size() - 1;
+    for (size_t i = Hash(c_ptr) & mask;; i = (i + 1) & mask) {
+        void* key = table_[i].c_ptr;
+        if (key == c_ptr) {
+            return i;
+        }
+        if (!key) {
+            return kNotFound;
+        }
+    }
+}
+
+WrapperCache::TableEntry& WrapperCache::Insert(void* c_ptr) {
+    if ((count_ + 1) * 4 > table_.size() * 3) {
+        Grow();
+    }
+    size_t mask = table_.size() - 1;
+    size_t i = Hash(c_ptr) & mask;
+    while (table_[i].c_ptr && table_[i].c_ptr != c_ptr) {
+        i = (i + 1) & mask;
+    }
+    if (!table_[i].c_ptr) {
+        table_[i].c_ptr = c_ptr;
+        count_++;
+    }
+    return table_[i];
+}
+
+void WrapperCache::Erase(size_t index) {
+    size_t mask = table_.size() - 1;
+    size_t hole = index;
+    table_[hole].wrapper.Reset();
+    table_[hole].c_ptr = nullptr;
+    table_[hole].release_callback = nullptr;
+    LeavePartition(table_[hole].partition);
+    table_[hole].partition = 0;
+    count_--;
+    
+    // Shift back every entry whose home bucket does not lie in (hole, i]
+    for (size_t i = (hole + 1) & mask; table_[i].c_ptr; i = (i + 1) & mask) {
+        size_t home = Hash(table_[i].c_ptr) & mask;
+        if (((i - home) & mask) >= ((i - hole) & mask)) {
+            table_[hole] = std::move(table_[i]);
+            table_[i].c_ptr = nullptr;
+            table_[i].release_callback = nullptr;
+            table_[i].partition = 0;
+            hole = i;
+        }
+    }
+}
+
+void WrapperCache::Grow() {
+    size_t capacity = table_.empty() ? kMinCapacity : table_.size() * 2;
+    std::vector<TableEntry> old(capacity);
+    old.swap(table_);
+    
+    // Moving a Global keeps its weak callback and parameter
+    size_t mask = capacity - 1;
+    for (TableEntry& entry : old) {
+        if (!entry.c_ptr) {
+            continue;
+        }
+        size_t i = Hash(entry.c_ptr) & mask;
+        while (table_[i].c_ptr) {
+            i = (i + 1) & mask;
+        }
+        table_[i] = std::move(entry);
+    }
+}
+
+bool WrapperCache::Lookup(v8::Isolate* isolate, void* c_ptr, v8::Local<v8::Object>* wrapper) {
+    size_t index = Find(c_ptr);
+    if (index == kNotFound) {
+        V8_DOM_COUNT(isolate, kWrapperCacheMisses, 1);
+        return false;
+    }
+    V8_DOM_COUNT(isolate, kWrapperCacheHits, 1);
+    *wrapper = table_[index].wrapper.Get(isolate);
+    return true;
+}
+
 bool WrapperCache::Has(void* c_ptr) const {
-    return cache_.find(c_ptr) != cache_.end();
+    return Find(c_ptr) != kNotFound;
 }
 
 v8::Local<v8::Object> WrapperCache::Get(v8::Isolate* isolate, void* c_ptr) {
-    auto it = cache_.find(c_ptr);
-    if (it == cache_.end()) {
-        return v8::Local<v8::Object>();
-    }
-    return it->second->wrapper.Get(isolate);
+    v8::Local<v8::Object> wrapper;
+    Lookup(isolate, c_ptr, &wrapper);
+    return wrapper;
 }
 
 void WrapperCache::Set(v8::Isolate* isolate, 
                        void* c_ptr, 
                        v8::Local<v8::Object> wrapper,
                        void (*release_callback)(void*)) {
-    // Create cache entry (sets up weak callback)
-    auto entry = std::make_unique<CacheEntry>(isolate, wrapper, release_callback, c_ptr);
+    SetEntry(isolate, c_ptr, wrapper, release_callback);
+}
+
+WrapperCache::TableEntry& WrapperCache::SetEntry(v8::Isolate* isolate,
+                                                 void* c_ptr,
+                                                 v8::Local<v8::Object> wrapper,
+                                                 void (*release_callback)(void*)) {
+    TableEntry& entry = Insert(c_ptr);
+    
+    // Replacing an existing wrapper drops its C-side reference
+    if (!entry.wrapper.IsEmpty()) {
+        entry.wrapper.Reset();
+        LeavePartition(entry.partition);
+        entry.partition = 0;
+        if (entry.release_callback) {
+            entry.release_callback(c_ptr);
+        }
+    }
     
-    // Store in cache
-    cache_[c_ptr] = std::move(entry);
+    // The key is the weak parameter because entries move
+    entry.wrapper.Reset(isolate, wrapper);
+    entry.wrapper.SetWeak(c_ptr, WeakCallback, v8::WeakCallbackType::kParameter);
+    entry.release_callback = release_callback;
+#if V8_DOM_STATS
+    entry.type = WrapperType(wrapper);
+    V8_DOM_COUNT(isolate, kWrappersCreated, 1);
+    V8_DOM_COUNT_TYPE(isolate, entry.type, kTypeWrappersCreated);
+#endif
+    NoteWrapperCreated();
+    return entry;
 }
 
 void WrapperCache::Remove(void* c_ptr) {
-    cache_.erase(c_ptr);
+    size_t index = Find(c_ptr);
+    if (index == kNotFound) {
+        return;
+    }
+    void (*release_callback)(void*) = table_[index].release_callback;
+    Erase(index);
+    UntrackDocument(c_ptr);
+    if (release_callback) {
+        release_callback(c_ptr);
+    }
+}
+
+// Node slots
+
+bool WrapperCache::EnableNodeSlots() {
+    if (Size() != 0) {
+        return false;
+    }
+    node_slots_enabled_ = true;
+    return true;
+}
+
+WrapperCache::CacheEntry* WrapperCache::SlotEntry(DOMNode* node) const {
+    uint32_t slot = dom_node_get_wrapper_slot(node);
+    if (slot == 0 || slot > slot_high_water_) {
+        return nullptr;
+    }
+    CacheEntry* entry = SlotAt(slot);
+    // Slot may have been claimed by a cache on another isolate
+    if (entry->c_ptr != node) {
+        return nullptr;
+    }
+    return entry;
+}
+
+bool WrapperCache::LookupNode(v8::Isolate* isolate, DOMNode* node, v8::Local<v8::Object>* wrapper) {
+    if (node_slots_enabled_) {
+        if (CacheEntry* entry = SlotEntry(node)) {
+            V8_DOM_COUNT(isolate, kWrapperCacheHits, 1);
+            *wrapper = entry->wrapper.Get(isolate);
+            return true;
+        }
+        if (!has_node_fallbacks_) {
+            V8_DOM_COUNT(isolate, kWrapperCacheMisses, 1);
+            return false;
+        }
+    }
+    return Lookup(isolate, node, wrapper);
+}
+
+bool WrapperCache::HasNode(DOMNode* node) const {
+    if (!node_slots_enabled_) {
+        return Has(node);
+    }
+    return SlotEntry(node) != nullptr || (has_node_fallbacks_ && Has(node));
+}
+
+v8::Local<v8::Object> WrapperCache::GetNode(v8::Isolate* isolate, DOMNode* node) {
+    v8::Local<v8::Object> wrapper;
+    LookupNode(isolate, node, &wrapper);
+    return wrapper;
+}
+
+void WrapperCache::SetNode(v8::Isolate* isolate,
+                           DOMNode* node,
+                           v8::Local<v8::Object> wrapper,
+                           void (*release_callback)(void*)) {
+    // Fall back to the hash map if the slot already belongs to someone else
+    if (!node_slots_enabled_ || dom_node_get_wrapper_slot(node) != 0) {
+        if (node_slots_enabled_) {
+            has_node_fallbacks_ = true;
+        }
+        TableEntry& entry = SetEntry(isolate, node, wrapper, release_callback);
+        TagTableEntry(entry, PartitionOf(node));
+        return;
+    }
+    
+    uint32_t slot = AllocateSlot();
+    CacheEntry* entry = SlotAt(slot);
+    entry->c_ptr = node;
+    entry->wrapper.Reset(isolate, wrapper);
+    entry->wrapper.SetWeak(entry, SlotWeakCallback, v8::WeakCallbackType::kParameter);
+    entry->release_callback = release_callback;
+    entry->slot = slot;
+    TagSlot(entry, PartitionOf(node));
+    dom_node_set_wrapper_slot(node, slot);
+    live_slots_++;
+#if V8_DOM_STATS
+    entry->type = WrapperType(wrapper);
+    V8_DOM_COUNT(isolate, kWrappersCreated, 1);
+    V8_DOM_COUNT_TYPE(isolate, entry->type, kTypeWrappersCreated);
+#endif
+    NoteWrapperCreated();
+}
+
+void WrapperCache::ReserveNodes(size_t count) {
+    if (node_slots_enabled_) {
+        // Freed slots are taken first, the rest extends the slab
+        size_t needed = count > free_slots_.size() ? count - free_slots_.size() : 0;
+        while (SlotCapacity() < slot_high_water_ + needed) {
+            slot_chunks_.push_back(std::make_unique<CacheEntry[]>(kSlotChunkSize));
+        }
+        return;
+    }
+    while ((count_ + count) * 4 > table_.size() * 3) {
+        Grow();
+    }
+}
+
+uint32_t WrapperCache::AllocateSlot() {
+    if (!free_slots_.empty()) {
+        uint32_t slot = free_slots_.back();
+        free_slots_.pop_back();
+        return slot;
+    }
+    if (slot_high_water_ == SlotCapacity()) {
+        slot_chunks_.push_back(std::make_unique<CacheEntry[]>(kSlotChunkSize));
+    }
+    return ++slot_high_water_;
+}
+
+void WrapperCache::RemoveSlot(uint32_t slot) {
+    CacheEntry* entry = SlotAt(slot);
+    entry->wrapper.Reset();
+    entry->c_ptr = nullptr;
+    entry->release_callback = nullptr;
+    UntagSlot(entry);
+    if (entry->retained) {
+        entry->retained = false;
+        retained_count_--;
+    }
+    free_slots_.push_back(slot);
+    live_slots_--;
+}
+
+// Tree retention
+
+bool WrapperCache::EnableTreeRetention(v8::Isolate* isolate) {
+    if (!node_slots_enabled_) {
+        return false;
+    }
+    if (!retention_isolate_) {
+        retention_isolate_ = isolate;
+        isolate->AddGCPrologueCallback(RetentionPrologue, this, v8::kGCTypeMarkSweepCompact);
+    }
+    return true;
+}
+
+void WrapperCache::RetentionPrologue(v8::Isolate* isolate, v8::GCType type,
+                                     v8::GCCallbackFlags flags, void* data) {
+    static_cast<WrapperCache*>(data)->UpdateRetention();
+}
+
+void WrapperCache::UpdateRetention() {
+    for (uint32_t slot = 1; slot <= slot_high_water_; slot++) {
+        CacheEntry* entry = SlotAt(slot);
+        if (!entry->c_ptr) {
+            continue;
+        }
+        
+        // Connected nodes are kept by a document wrapper of this cache
+        DOMNode* node = static_cast<DOMNode*>(entry->c_ptr);
+        bool retain = false;
+        if (dom_node_get_isconnected(node)) {
+            DOMNode* document = reinterpret_cast<DOMNode*>(dom_node_get_ownerdocument(node));
+            retain = document && document != node && SlotEntry(document) != nullptr;
+        }
+        if (retain == entry->retained) {
+            continue;
+        }
+        
+        // A handle made strong before marking is a root for this GC; one
+        // made weak may already be marked and is collected by the next
+        if (retain) {
+            entry->wrapper.ClearWeak();
+            retained_count_++;
+        } else {
+            entry->wrapper.SetWeak(entry, SlotWeakCallback, v8::WeakCallbackType::kParameter);
+            retained_count_--;
+        }
+        entry->retained = retain;
+    }
+}
+
+// Deferred releases
+
+void WrapperCache::EnableDeferredReleases(v8::Isolate* isolate) {
+    if (!deferred_isolate_) {
+        deferred_isolate_ = isolate;
+        isolate->AddGCEpilogueCallback(ReleaseEpilogue, this);
+    }
+}
+
+void WrapperCache::ReleaseLater(void* c_ptr, void (*release_callback)(void*), bool is_node) {
+    if (!deferred_isolate_) {
+        if (release_callback) {
+            release_callback(c_ptr);
+        }
+        return;
+    }
+    if (is_node) {
+        pending_releases_.push_back({c_ptr, nullptr});
+    } else if (release_callback) {
+        pending_releases_.push_back({c_ptr, release_callback});
+    }
+}
+
+void WrapperCache::ReleaseEpilogue(v8::Isolate* isolate, v8::GCType type,
+                                   v8::GCCallbackFlags flags, void* data) {
+    static_cast<WrapperCache*>(data)->DrainReleases(kEpilogueReleaseBudget);
+}
+
+size_t WrapperCache::DrainReleases(size_t max) {
+    // Take the batch off the queue first, so a release callback that
+    // queues more (or drains) cannot disturb the loop
+    size_t count = pending_releases_.size() < max ? pending_releases_.size() : max;
+    std::vector<PendingRelease> batch(pending_releases_.end() - count, pending_releases_.end());
+    pending_releases_.resize(pending_releases_.size() - count);
+    
+    // Consecutive nodes go to Zig in one call
+    std::vector<DOMNode*> nodes;
+    nodes.reserve(count);
+    for (const PendingRelease& pending : batch) {
+        if (!pending.release_callback) {
+            nodes.push_back(static_cast<DOMNode*>(pending.c_ptr));
+            continue;
+        }
+        if (!nodes.empty()) {
+            dom_node_release_many(nodes.data(), nodes.size());
+            nodes.clear();
+        }
+        pending.release_callback(pending.c_ptr);
+    }
+    if (!nodes.empty()) {
+        dom_node_release_many(nodes.data(), nodes.size());
+    }
+    return pending_releases_.size();
 }
 
-void WrapperCache::WeakCallback(const v8::WeakCallbackInfo<CacheEntry>& data) {
+// External memory
+
+void WrapperCache::TrackDocument(v8::Isolate* isolate, DOMDocument* doc) {
+    memory_isolate_ = isolate;
+    documents_.push_back({doc, 0});
+    RefreshExternalMemory();
+}
+
+void WrapperCache::UntrackDocument(void* c_ptr) {
+    for (size_t i = 0; i < documents_.size(); i++) {
+        if (documents_[i].doc == c_ptr) {
+            // A decrease only updates V8's counter, so this is fine from
+            // a weak callback
+            memory_isolate_->AdjustAmountOfExternalAllocatedMemory(-documents_[i].reported);
+            documents_[i] = documents_.back();
+            documents_.pop_back();
+            return;
+        }
+    }
+}
+
+void WrapperCache::RefreshExternalMemory() {
+    int64_t delta = 0;
+    for (TrackedDocument& tracked : documents_) {
+        int64_t bytes = static_cast<int64_t>(dom_document_get_allocated_bytes(tracked.doc));
+        delta += bytes - tracked.reported;
+        tracked.reported = bytes;
+    }
+    if (delta != 0) {
+        memory_isolate_->AdjustAmountOfExternalAllocatedMemory(delta);
+    }
+}
+
+int64_t WrapperCache::ReportedExternalMemory() const {
+    int64_t total = 0;
+    for (const TrackedDocument& tracked : documents_) {
+        total += tracked.reported;
+    }
+    return total;
+}
+
+// Document partitions
+
+void WrapperCache::AddPartition(DOMDocument* doc) {
+    if (partition_index_.count(doc)) {
+        return;
+    }
+    uint32_t partition;
+    if (!free_partitions_.empty()) {
+        partition = free_partitions_.back();
+        free_partitions_.pop_back();
+    } else {
+        partition = static_cast<uint32_t>(partitions_.size());
+        partitions_.emplace_back();
+    }
+    partitions_[partition].doc = doc;
+    partition_index_[doc] = partition;
+}
+
+uint32_t WrapperCache::PartitionOf(DOMNode* node) const {
+    if (partition_index_.empty()) {
+        return 0;
+    }
+    // A document owns itself
+    DOMDocument* owner = dom_node_get_ownerdocument(node);
+    auto it = partition_index_.find(owner ? owner : reinterpret_cast<DOMDocument*>(node));
+    return it == partition_index_.end() ? 0 : it->second;
+}
+
+size_t WrapperCache::PartitionSize(DOMDocument* doc) const {
+    auto it = partition_index_.find(doc);
+    return it == partition_index_.end() ? 0 : partitions_[it->second].wrappers;
+}
+
+void WrapperCache::TagSlot(CacheEntry* entry, uint32_t partition) {
+    if (!partition) {
+        return;
+    }
+    Partition& list = partitions_[partition];
+    entry->partition = partition;
+    entry->partition_prev = 0;
+    entry->partition_next = list.first_slot;
+    if (list.first_slot) {
+        SlotAt(list.first_slot)->partition_prev = entry->slot;
+    }
+    list.first_slot = entry->slot;
+    list.wrappers++;
+}
+
+void WrapperCache::UntagSlot(CacheEntry* entry) {
+    if (!entry->partition) {
+        return;
+    }
+    Partition& list = partitions_[entry->partition];
+    if (entry->partition_prev) {
+        SlotAt(entry->partition_prev)->partition_next = entry->partition_next;
+    } else {
+        list.first_slot = entry->partition_next;
+    }
+    if (entry->partition_next) {
+        SlotAt(entry->partition_next)->partition_prev = entry->partition_prev;
+    }
+    list.wrappers--;
+    entry->partition = 0;
+    entry->partition_prev = 0;
+    entry->partition_next = 0;
+}
+
+void WrapperCache::TagTableEntry(TableEntry& entry, uint32_t partition) {
+    if (!partition) {
+        return;
+    }
+    entry.partition = partition;
+    EnterPartition(partition);
+    
+    // Keep stale keys from piling up in a long-lived partition
+    std::vector<void*>& keys = partitions_[partition].table_keys;
+    if (keys.size() >= 2 * partitions_[partition].wrappers + 64) {
+        std::vector<void*> live;
+        for (void* key : keys) {
+            size_t index = Find(key);
+            if (index != kNotFound && table_[index].partition == partition) {
+                live.push_back(key);
+            }
+        }
+        std::sort(live.begin(), live.end());
+        live.erase(std::unique(live.begin(), live.end()), live.end());
+        keys.swap(live);
+    }
+    keys.push_back(entry.c_ptr);
+}
+
+size_t WrapperCache::DisposePartition(v8::Isolate* isolate, DOMDocument* doc) {
+    auto it = partition_index_.find(doc);
+    if (it == partition_index_.end()) {
+        return 0;
+    }
+    uint32_t partition = it->second;
+    partition_index_.erase(it);
+    
+    v8::HandleScope handle_scope(isolate);
+    std::vector<DOMNode*> nodes;
+    nodes.reserve(partitions_[partition].wrappers);
+    bool has_document = false;
+    
+    // Detach the wrapper, so script holding it no longer reaches the node,
+    // and keep the node for the batched release (the document goes last)
+    auto drop = [&](void* c_ptr, v8::Global<v8::Object>& wrapper, void (*release_callback)(void*)) {
+        wrapper.Get(isolate)->SetAlignedPointerInInternalField(kWrapperObjectIndex, nullptr);
+        V8_DOM_COUNT(isolate, kWrappersCollected, 1);
+        if (c_ptr == doc) {
+            has_document = release_callback != nullptr;
+        } else if (release_callback) {
+            nodes.push_back(static_cast<DOMNode*>(c_ptr));
+        }
+    };
+    
+    // A node adopted elsewhere since it was listed follows its document
+    // (PartitionOf() no longer finds this partition)
+    auto owned = [doc](DOMNode* node) {
+        DOMDocument* owner = dom_node_get_ownerdocument(node);
+        return (owner ? owner : reinterpret_cast<DOMDocument*>(node)) == doc;
+    };
+    
+    size_t dropped = 0;
+    for (uint32_t slot = partitions_[partition].first_slot; slot;) {
+        CacheEntry* entry = SlotAt(slot);
+        uint32_t next = entry->partition_next;
+        DOMNode* node = static_cast<DOMNode*>(entry->c_ptr);
+        if (!owned(node)) {
+            UntagSlot(entry);
+            TagSlot(entry, PartitionOf(node));
+        } else {
+            drop(node, entry->wrapper, entry->release_callback);
+            dom_node_set_wrapper_slot(node, 0);
+            UntrackDocument(node);
+            RemoveSlot(slot);
+            dropped++;
+        }
+        slot = next;
+    }
+    
+    // Erasing shifts table entries, so go by key
+    std::vector<void*> keys;
+    keys.swap(partitions_[partition].table_keys);
+    for (void* key : keys) {
+        size_t index = Find(key);
+        if (index == kNotFound || table_[index].partition != partition) {
+            continue;  // Erased since, or the address was reused
+        }
+        TableEntry& entry = table_[index];
+        DOMNode* node = static_cast<DOMNode*>(key);
+        if (!owned(node)) {
+            LeavePartition(entry.partition);
+            entry.partition = 0;
+            TagTableEntry(entry, PartitionOf(node));
+            continue;
+        }
+        drop(key, entry.wrapper, entry.release_callback);
+        Erase(index);
+        UntrackDocument(key);
+        dropped++;
+    }
+    
+    partitions_[partition] = Partition();
+    free_partitions_.push_back(partition);
+    
+    // One call into Zig for the whole tree, the document's own reference
+    // last; with no other owner the document then frees its tree in one walk
+    if (has_document) {
+        nodes.push_back(reinterpret_cast<DOMNode*>(doc));
+    }
+    if (!nodes.empty()) {
+        dom_node_release_many(nodes.data(), nodes.size());
+    }
+    return dropped;
+}
+
+// Weak callbacks
+
+void WrapperCache::WeakCallback(const v8::WeakCallbackInfo<void>& data) {
+    // Resets the handle, erases the entry and releases the C-side reference
+    WrapperCache* cache = ForIsolate(data.GetIsolate());
+    void* c_ptr = data.GetParameter();
+    size_t index = cache->Find(c_ptr);
+    if (index == kNotFound) {
+        return;
+    }
+    void (*release_callback)(void*) = cache->table_[index].release_callback;
+#if V8_DOM_STATS
+    V8_DOM_COUNT(data.GetIsolate(), kWrappersCollected, 1);
+    V8_DOM_COUNT_TYPE(data.GetIsolate(), cache->table_[index].type, kTypeWrappersCollected);
+#endif
+    cache->Erase(index);
+    cache->UntrackDocument(c_ptr);
+    cache->ReleaseLater(c_ptr, release_callback, false);
+}
+
+void WrapperCache::SlotWeakCallback(const v8::WeakCallbackInfo<CacheEntry>& data) {
     CacheEntry* entry = data.GetParameter();
     void* c_ptr = entry->c_ptr;
+    uint32_t slot = entry->slot;
     
-    // Release C-side reference
-    if (entry->release_callback) {
-        entry->release_callback(c_ptr);
-        entry->release_callback = nullptr;  // Prevent double-free
-    }
+    // Clear the node slot while the node is guaranteed alive
+    dom_node_set_wrapper_slot(static_cast<DOMNode*>(c_ptr), 0);
     
-    // Remove from cache (this deletes the entry)
-    v8::Isolate* isolate = data.GetIsolate();
-    WrapperCache* cache = ForIsolate(isolate);
-    cache->Remove(c_ptr);
+    // Free the slot before releasing, the release may drop the last reference
+    WrapperCache* cache = ForIsolate(data.GetIsolate());
+    void (*release_callback)(void*) = entry->release_callback;
+#if V8_DOM_STATS
+    V8_DOM_COUNT(data.GetIsolate(), kWrappersCollected, 1);
+    V8_DOM_COUNT_TYPE(data.GetIsolate(), entry->type, kTypeWrappersCollected);
+#endif
+    cache->RemoveSlot(slot);
+    cache->UntrackDocument(c_ptr);
+    cache->ReleaseLater(c_ptr, release_callback, true);
 }
 
 } // namespace v8_dom
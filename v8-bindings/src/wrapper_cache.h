@@ -6,8 +6,24 @@
  * 
  * Architecture:
  * - One cache per V8 isolate (stored in isolate data)
- * - Hash map from C pointer → Persistent<Object>
+ * - Open-addressing table from C pointer → Global<Object>, entries stored
+ *   inline (no per-entry allocation), linear probing, backward-shift delete
+ * - Optional node slot mode: node wrappers are found through the slot the
+ *   Zig node reserves for embedders (dom_node_get_wrapper_slot), so the
+ *   hot Wrap path is a pointer load instead of a hash lookup
  * - Weak callbacks clean up when JS object is GC'd
+ * - Optional deferred releases: weak callbacks queue the C-side release
+ *   and a GC epilogue applies them in batches, outside weak processing
+ * - External memory: wrapped documents report their Zig-side size to V8
+ *   (dom_document_get_allocated_bytes) so large trees pace the GC
+ * - Optional tree retention (on top of node slots): wrappers of nodes
+ *   connected to a wrapped document are held strongly, so they keep their
+ *   expando properties and skip weak processing while the tree is alive
+ * - Document partitions: node wrappers of a partitioned document are
+ *   listed in its partition, so disposing the document drops them all in
+ *   one pass over that list instead of one weak callback each
+ * - Heap snapshots: each cache registers a V8 embedder graph builder
+ *   (core/heap_graph.h) that reports the nodes behind its wrappers
  * - Thread-safe within isolate (V8 guarantees single-threaded access)
  */
 
@@ -15,8 +31,12 @@
 #define V8_DOM_WRAPPER_CACHE_H
 
 #include <v8.h>
-#include <unordered_map>
 #include <memory>
+#include <unordered_map>
+#include <vector>
+#include "dom.h"
+#include "core/binding_stats.h"
+#include "core/wrapper_type_info.h"
 
 namespace v8_dom {
 
@@ -41,6 +61,22 @@ public:
      */
     static WrapperCache* ForIsolate(v8::Isolate* isolate);
     
+    /**
+     * Delete the isolate's WrapperCache, releasing every cached C object.
+     */
+    static void Dispose(v8::Isolate* isolate);
+    
+    /**
+     * Look up the cached wrapper for a C pointer in a single probe.
+     * Use this on the Wrap hot path instead of Has() followed by Get().
+     * 
+     * @param isolate V8 isolate
+     * @param c_ptr C pointer to look up
+     * @param wrapper Set to the cached wrapper if found
+     * @return true if a wrapper was found
+     */
+    bool Lookup(v8::Isolate* isolate, void* c_ptr, v8::Local<v8::Object>* wrapper);
+    
     /**
      * Check if a C pointer has a cached wrapper.
      */
@@ -67,41 +103,400 @@ public:
              void (*release_callback)(void*));
     
     /**
-     * Remove a cached wrapper.
-     * Called automatically by weak callback when GC runs.
+     * Remove a cached wrapper and release its C-side reference.
      */
     void Remove(void* c_ptr);
     
+    /**
+     * Enable node slot mode for this isolate.
+     * 
+     * Node wrappers are then stored in a slot table indexed by the value
+     * kept in the Zig node (dom_node_set_wrapper_slot), and the hash map
+     * is only used for non-node objects. Must be called before the first
+     * wrapper is cached; returns false and stays in hash mode otherwise.
+     * 
+     * The node slot has a single owner, so only enable this on one isolate
+     * per document. Slots that belong to another cache are detected and
+     * fall back to the hash map, as do nodes of documents shared between
+     * isolates (dom_document_share), whose slots stay claimed.
+     */
+    bool EnableNodeSlots();
+    
+    /**
+     * Check if node slot mode is enabled.
+     */
+    bool NodeSlotsEnabled() const { return node_slots_enabled_; }
+    
+    /**
+     * Enable tree retention for this isolate (requires node slot mode).
+     * 
+     * A node wrapper is then held strongly while its node is connected to
+     * a document whose own wrapper is alive, instead of being collectable
+     * as soon as script drops it: re-wrapping the node later returns the
+     * same object, expando properties included, and retained wrappers are
+     * plain strong handles that cost nothing in weak processing. Document
+     * wrappers and wrappers of disconnected nodes stay weak, so a retained
+     * wrapper becomes collectable once its node leaves the document or the
+     * document wrapper dies.
+     * 
+     * Retention is recomputed on the main thread before every full GC, in
+     * one pass over the node slots; changes between full GCs take effect
+     * at the next one. A retained wrapper whose expando references its
+     * document's wrapper keeps that document alive until the isolate is
+     * disposed (there is no tracing through wrapper properties).
+     * 
+     * @return false if node slots are not enabled
+     */
+    bool EnableTreeRetention(v8::Isolate* isolate);
+    
+    /**
+     * Check if tree retention is enabled.
+     */
+    bool TreeRetentionEnabled() const { return retention_isolate_ != nullptr; }
+    
+    /**
+     * Number of node wrappers currently held strongly by tree retention.
+     */
+    size_t RetainedCount() const { return retained_count_; }
+    
+    /**
+     * Enable deferred releases for this isolate.
+     * 
+     * Weak callbacks then only unlink the collected wrapper and queue its
+     * C object; the queued releases run after the GC, up to
+     * kEpilogueReleaseBudget per GC epilogue, nodes in batches through
+     * dom_node_release_many(). A collected subtree no longer tears down
+     * its Zig nodes inside the GC's weak processing. Releases left over
+     * wait for the next GC or an explicit DrainReleases() (e.g. from the
+     * embedder's idle time).
+     * 
+     * Queued objects stay alive until drained; wrapping one again in the
+     * meantime creates a new wrapper with its own reference.
+     */
+    void EnableDeferredReleases(v8::Isolate* isolate);
+    
+    /**
+     * Run up to max queued releases (all of them by default).
+     * 
+     * @return Number of releases still queued
+     */
+    size_t DrainReleases(size_t max = static_cast<size_t>(-1));
+    
+    /**
+     * Number of queued releases.
+     */
+    size_t PendingReleases() const { return pending_releases_.size(); }
+    
+    // Releases run per GC epilogue when deferred
+    static constexpr size_t kEpilogueReleaseBudget = 4096;
+    
+    /**
+     * Report a newly wrapped document's memory to V8 and keep it updated.
+     * 
+     * The document's size is added as external memory now, refreshed
+     * every kMemoryRefreshInterval wrapper creations and on
+     * RefreshExternalMemory(), and subtracted when the document's wrapper
+     * is collected. Call once, right after caching the document wrapper.
+     */
+    void TrackDocument(v8::Isolate* isolate, DOMDocument* doc);
+    
+    /**
+     * Report the size change of every tracked document to V8.
+     */
+    void RefreshExternalMemory();
+    
+    /**
+     * External memory currently reported to V8, in bytes.
+     */
+    int64_t ReportedExternalMemory() const;
+    
+    // Wrapper creations between two automatic refreshes
+    static constexpr uint32_t kMemoryRefreshInterval = 1024;
+    
+    /**
+     * Give doc's node wrappers a partition of their own.
+     * 
+     * Wrappers created afterwards for doc and the nodes it owns are listed
+     * in the partition, so DisposePartition() finds them without waiting
+     * for the GC or scanning the rest of the cache. Call before the
+     * document is first wrapped; doing it again does nothing.
+     */
+    void AddPartition(DOMDocument* doc);
+    
+    /**
+     * Drop every wrapper of doc's partition and remove the partition.
+     * 
+     * Each dropped wrapper is detached from its node (its object field is
+     * cleared, so script that still holds it gets nullptr from Unwrap) and
+     * its reference is released, all nodes in one dom_node_release_many()
+     * call with the document last. Costs O(wrappers in the partition).
+     * Wrappers of nodes adopted into another document since they were
+     * listed are moved to that document's partition (or none) instead.
+     * Call from the embedder, not from a GC callback.
+     * 
+     * @return Number of wrappers dropped (0 if doc has no partition)
+     */
+    size_t DisposePartition(v8::Isolate* isolate, DOMDocument* doc);
+    
+    /**
+     * Number of wrappers in doc's partition (0 if doc has none).
+     */
+    size_t PartitionSize(DOMDocument* doc) const;
+    
+    /**
+     * Node variants of Lookup/Has/Get/Set.
+     * Use these for every Node-derived object (Element, Text, Document, ...).
+     * They go through the node slot when enabled, the hash map otherwise.
+     */
+    bool LookupNode(v8::Isolate* isolate, DOMNode* node, v8::Local<v8::Object>* wrapper);
+    bool HasNode(DOMNode* node) const;
+    v8::Local<v8::Object> GetNode(v8::Isolate* isolate, DOMNode* node);
+    void SetNode(v8::Isolate* isolate,
+                 DOMNode* node,
+                 v8::Local<v8::Object> wrapper,
+                 void (*release_callback)(void*));
+    
+    /**
+     * Make room for count more node wrappers in one step, so creating
+     * them does not grow the slot slab or the hash table one by one.
+     */
+    void ReserveNodes(size_t count);
+    
     /**
      * Get the number of cached wrappers.
      */
-    size_t Size() const { return cache_.size(); }
+    size_t Size() const { return count_ + live_slots_; }
+    
+    /**
+     * Node slot slab statistics.
+     * The high-water mark is the peak number of node wrappers alive at
+     * once; the slab never shrinks, so capacity only grows in whole chunks.
+     */
+    size_t SlotHighWaterMark() const { return slot_high_water_; }
+    size_t SlotCapacity() const { return slot_chunks_.size() * kSlotChunkSize; }
+    
+    /**
+     * Call visit(wrapper) with every cached wrapper, hash table entries
+     * first, then node slots. visit must not create or drop wrappers.
+     */
+    template <typename Visitor>
+    void ForEachWrapper(v8::Isolate* isolate, Visitor&& visit) const {
+        for (const TableEntry& entry : table_) {
+            if (entry.c_ptr && !entry.wrapper.IsEmpty()) {
+                visit(entry.wrapper.Get(isolate));
+            }
+        }
+        for (uint32_t slot = 1; slot <= slot_high_water_; slot++) {
+            const CacheEntry* entry = SlotAt(slot);
+            if (entry->c_ptr && !entry->wrapper.IsEmpty()) {
+                visit(entry->wrapper.Get(isolate));
+            }
+        }
+    }
     
 private:
     /**
-     * Entry in the wrapper cache.
-     * Holds a weak persistent reference to the JS object.
+     * Inline entry in the open-addressing table (key == nullptr means empty).
+     * The weak callback parameter is the key, not the entry address, since
+     * entries move when the table grows or a deletion shifts them back.
+     */
+    struct TableEntry {
+        void* c_ptr = nullptr;  // Key
+        v8::Global<v8::Object> wrapper;  // Weak reference to JS object
+        void (*release_callback)(void*) = nullptr;  // Function to release C object
+        uint32_t partition = 0;  // Document partition (0: none)
+#if V8_DOM_STATS
+        const WrapperTypeInfo* type = nullptr;  // Wrapper interface (stats)
+#endif
+    };
+    
+    /**
+     * Entry in the node slot slab (c_ptr == nullptr means free).
+     * Slab entries never move, so the entry itself is the weak parameter.
      */
     struct CacheEntry {
+        void* c_ptr = nullptr;  // C pointer (for weak callback)
         v8::Global<v8::Object> wrapper;  // Weak reference to JS object
-        void (*release_callback)(void*);  // Function to release C object
-        void* c_ptr;  // C pointer (for weak callback)
-        
-        CacheEntry(v8::Isolate* isolate,
-                   v8::Local<v8::Object> obj,
-                   void (*release)(void*),
-                   void* ptr);
-        ~CacheEntry();
+        void (*release_callback)(void*) = nullptr;  // Function to release C object
+        uint32_t slot = 0;  // Node slot value
+        uint32_t partition = 0;  // Document partition (0: none)
+        uint32_t partition_prev = 0;  // Partition list neighbours (slot values)
+        uint32_t partition_next = 0;
+        bool retained = false;  // Held strongly (tree retention)
+#if V8_DOM_STATS
+        const WrapperTypeInfo* type = nullptr;  // Wrapper interface (stats)
+#endif
     };
     
     /**
-     * Weak callback invoked when JS wrapper is GC'd.
-     * Releases the C-side reference and removes from cache.
+     * Weak callbacks invoked when JS wrapper is GC'd.
+     * Release the C-side reference and remove from cache.
      */
-    static void WeakCallback(const v8::WeakCallbackInfo<CacheEntry>& data);
+    static void WeakCallback(const v8::WeakCallbackInfo<void>& data);
+    static void SlotWeakCallback(const v8::WeakCallbackInfo<CacheEntry>& data);
+    
+    /**
+     * Table primitives.
+     * Find returns kNotFound if absent; Insert grows the table as needed
+     * and returns the (possibly existing) entry for c_ptr; Erase empties an
+     * entry and shifts its probe chain back so no tombstones are left behind.
+     */
+    static size_t Hash(void* c_ptr);
+    size_t Find(void* c_ptr) const;
+    TableEntry& Insert(void* c_ptr);
+    void Erase(size_t index);
+    void Grow();
+    
+    static constexpr size_t kNotFound = static_cast<size_t>(-1);
+    
+    /**
+     * Cache a wrapper in the table and return its entry (Set() without
+     * the partition tag, which only SetNode() knows).
+     */
+    TableEntry& SetEntry(v8::Isolate* isolate,
+                         void* c_ptr,
+                         v8::Local<v8::Object> wrapper,
+                         void (*release_callback)(void*));
+    
+    /**
+     * Resolve a node's slot to its entry.
+     * Returns nullptr if the slot is empty or owned by another cache.
+     */
+    CacheEntry* SlotEntry(DOMNode* node) const;
+    
+    /**
+     * Map a slot value to its slab entry (slot must be in 1..high water).
+     */
+    CacheEntry* SlotAt(uint32_t slot) const {
+        return &slot_chunks_[(slot - 1) / kSlotChunkSize][(slot - 1) % kSlotChunkSize];
+    }
+    
+    /**
+     * Take a slot from the free list, or extend the slab.
+     */
+    uint32_t AllocateSlot();
+    
+    /**
+     * Return a node slot to the free list and clear its entry.
+     */
+    void RemoveSlot(uint32_t slot);
+    
+    /**
+     * Recompute which node wrappers tree retention holds strongly.
+     * Registered as a full GC prologue callback.
+     */
+    void UpdateRetention();
+    static void RetentionPrologue(v8::Isolate* isolate, v8::GCType type,
+                                  v8::GCCallbackFlags flags, void* data);
+    
+    /**
+     * Release a C object now, or queue it if releases are deferred.
+     * is_node selects the batched node release when draining.
+     */
+    void ReleaseLater(void* c_ptr, void (*release_callback)(void*), bool is_node);
+    static void ReleaseEpilogue(v8::Isolate* isolate, v8::GCType type,
+                                v8::GCCallbackFlags flags, void* data);
+    
+    /**
+     * Stop tracking a document whose wrapper goes away (no-op for other
+     * objects) and withdraw its reported memory.
+     */
+    void UntrackDocument(void* c_ptr);
+    
+    /**
+     * Partition of the document that owns node now (0 if it has none).
+     */
+    uint32_t PartitionOf(DOMNode* node) const;
+    
+    /**
+     * Add a slab entry to a partition's list (no-op for 0), or unlink it
+     * from its partition.
+     */
+    void TagSlot(CacheEntry* entry, uint32_t partition);
+    void UntagSlot(CacheEntry* entry);
+    
+    /**
+     * Tag a table entry with a partition (no-op for 0). The partition
+     * keeps its key; keys of erased entries are skipped when disposing
+     * and dropped when the key list is compacted.
+     */
+    void TagTableEntry(TableEntry& entry, uint32_t partition);
+    
+    /**
+     * Count a wrapper into or out of a partition (0 is no partition).
+     */
+    void EnterPartition(uint32_t partition) {
+        if (partition) {
+            partitions_[partition].wrappers++;
+        }
+    }
+    void LeavePartition(uint32_t partition) {
+        if (partition) {
+            partitions_[partition].wrappers--;
+        }
+    }
+    
+    /**
+     * Count a wrapper creation towards the next automatic refresh.
+     */
+    void NoteWrapperCreated() {
+        if (!documents_.empty() && --wraps_until_refresh_ == 0) {
+            wraps_until_refresh_ = kMemoryRefreshInterval;
+            RefreshExternalMemory();
+        }
+    }
+    
+    struct TrackedDocument {
+        DOMDocument* doc;
+        int64_t reported;  // Bytes last reported to V8
+    };
+    
+    struct PendingRelease {
+        void* c_ptr;
+        void (*release_callback)(void*);  // nullptr: node, batched
+    };
+    
+    struct Partition {
+        DOMDocument* doc = nullptr;  // nullptr: free
+        size_t wrappers = 0;
+        uint32_t first_slot = 0;  // Slab entries, linked through the entries
+        std::vector<void*> table_keys;  // Table entries, possibly stale
+    };
+    
+    // Open-addressing table (capacity is zero or a power of two)
+    std::vector<TableEntry> table_;
+    size_t count_ = 0;
+    
+    // Minimum table capacity; the table grows at 3/4 load
+    static constexpr size_t kMinCapacity = 64;
+    
+    // Node slot slab: fixed-size chunks so entries keep their address,
+    // slot value N lives at index N - 1. Freed slots are reused LIFO.
+    static constexpr uint32_t kSlotChunkSize = 1024;
+    std::vector<std::unique_ptr<CacheEntry[]>> slot_chunks_;
+    std::vector<uint32_t> free_slots_;
+    uint32_t slot_high_water_ = 0;  // Slots ever handed out
+    size_t live_slots_ = 0;
+    bool node_slots_enabled_ = false;
+    bool has_node_fallbacks_ = false;  // Some nodes live in the hash map
+    
+    // Deferred releases (isolate the epilogue callback is registered on)
+    v8::Isolate* deferred_isolate_ = nullptr;
+    std::vector<PendingRelease> pending_releases_;
+    
+    // External memory of wrapped documents
+    v8::Isolate* memory_isolate_ = nullptr;
+    std::vector<TrackedDocument> documents_;
+    uint32_t wraps_until_refresh_ = kMemoryRefreshInterval;
+    
+    // Document partitions, index 0 unused; freed indices are reused
+    std::vector<Partition> partitions_ = std::vector<Partition>(1);
+    std::vector<uint32_t> free_partitions_;
+    std::unordered_map<DOMDocument*, uint32_t> partition_index_;
     
-    // Hash map from C pointer → cache entry
-    std::unordered_map<void*, std::unique_ptr<CacheEntry>> cache_;
+    // Tree retention (isolate the prologue callback is registered on)
+    v8::Isolate* retention_isolate_ = nullptr;
+    size_t retained_count_ = 0;
     
     // Isolate data slot for storing WrapperCache
     static const int kIsolateSlot = 0;